@@ -180,8 +180,7 @@ private:
   // helper functions
   inline float sqr(double x);
   inline double amplitude(const cplx &x);
-  inline double phase(const cplx &x);
-  inline cplx polar(double a, double p);
+  inline cplx unit(const cplx &x);
   inline float min(double a, double b);
   inline float max(double a, double b);
   inline float clamp(double x);
@@ -125,11 +125,9 @@ inline float DPL2FSDecoder::sqr(double x) { return static_cast<float>(x * x); }
 inline double DPL2FSDecoder::amplitude(const cplx &x) {
   return sqrt(sqr(x.real()) + sqr(x.imag()));
 }
-inline double DPL2FSDecoder::phase(const cplx &x) {
-  return atan2(x.imag(), x.real());
-}
-inline cplx DPL2FSDecoder::polar(double a, double p) {
-  return cplx(a * cos(p), a * sin(p));
+inline cplx DPL2FSDecoder::unit(const cplx &x) {
+  double a = sqrt(x.real() * x.real() + x.imag() * x.imag());
+  return a > 0 ? x / a : cplx(1, 0);
 }
 inline float DPL2FSDecoder::min(double a, double b) {
   return static_cast<float>(a < b ? a : b);
@@ -166,17 +164,21 @@ void DPL2FSDecoder::buffered_decode(float *input) {
   kiss_fftr(forward, &lt[0], (kiss_fft_cpx *)&lf[0]);
   kiss_fftr(forward, &rt[0], (kiss_fft_cpx *)&rf[0]);
 
+  // look up the channel maps once rather than for every bin
+  alloc_lut &alloc = chn_alloc[setup];
+  std::vector<float> &xsf = chn_xsf[setup];
+
   // compute multichannel output signal in the spectral domain
   for (unsigned int f = 1; f < N / 2; f++) {
-    // get Lt/Rt amplitudes & phases
+    // get Lt/Rt amplitudes
     double ampL = amplitude(lf[f]), ampR = amplitude(rf[f]);
-    double phaseL = phase(lf[f]), phaseR = phase(rf[f]);
-    // calculate the amplitude & phase differences
+    // calculate the amplitude & phase differences; the phase difference is the
+    // angle between the two phasors, which avoids taking both phases
     double ampDiff =
         clamp((ampL + ampR < epsilon) ? 0 : (ampR - ampL) / (ampR + ampL));
-    double phaseDiff = abs(phaseL - phaseR);
-    if (phaseDiff > pi)
-      phaseDiff = 2 * pi - phaseDiff;
+    double phaseDiff =
+        atan2(std::abs(lf[f].real() * rf[f].imag() - lf[f].imag() * rf[f].real()),
+              lf[f].real() * rf[f].real() + lf[f].imag() * rf[f].imag());
 
     // decode into x/y soundfield position
     double x, y;
@@ -195,10 +197,9 @@ void DPL2FSDecoder::buffered_decode(float *input) {
 
     // get total signal amplitude
     double amp_total = sqrt(ampL * ampL + ampR * ampR);
-    // and total L/C/R signal phases
-    double phase_of[] = {
-        phaseL, atan2(lf[f].imag() + rf[f].imag(), lf[f].real() + rf[f].real()),
-        phaseR};
+    // and total L/C/R signal phases, as unit phasors so that building the
+    // channel signals needs no trigonometry
+    cplx phase_of[] = {unit(lf[f]), unit(lf[f] + rf[f]), unit(rf[f])};
     // compute 2d channel map indexes p/q and update x/y to fractional offsets
     // in the map grid
     int p = map_to_grid(x), q = map_to_grid(y);
@@ -207,11 +208,12 @@ void DPL2FSDecoder::buffered_decode(float *input) {
       // look up channel map at respective position (with bilinear
       // interpolation) and build the
       // signal
-      std::vector<float *> &a = chn_alloc[setup][c];
-      signal[c][f] = polar(
-          amp_total * ((1 - x) * (1 - y) * a[q][p] + x * (1 - y) * a[q][p + 1] +
-                       (1 - x) * y * a[q + 1][p] + x * y * a[q + 1][p + 1]),
-          phase_of[1 + static_cast<int>(sign(chn_xsf[setup][c]))]);
+      std::vector<float *> &a = alloc[c];
+      signal[c][f] =
+          amp_total *
+          ((1 - x) * (1 - y) * a[q][p] + x * (1 - y) * a[q][p + 1] +
+           (1 - x) * y * a[q + 1][p] + x * y * a[q + 1][p + 1]) *
+          phase_of[1 + static_cast<int>(sign(xsf[c]))];
     }
 
     // optionally redirect bass
@@ -221,7 +223,7 @@ void DPL2FSDecoder::buffered_decode(float *input) {
           f < lo_cut ? 1
                      : 0.5 * (1 + cos(pi * (f - lo_cut) / (hi_cut - lo_cut)));
       // assign LFE channel
-      signal[C - 1][f] = lfe_level * polar(amp_total, phase_of[1]);
+      signal[C - 1][f] = lfe_level * amp_total * phase_of[1];
       // subtract the signal from the other channels
       for (unsigned int c = 0; c < C - 1; c++)
         signal[c][f] *= (1 - lfe_level);
@@ -245,29 +247,20 @@ void DPL2FSDecoder::buffered_decode(float *input) {
 
 // transform amp/phase difference space into x/y soundfield space
 void DPL2FSDecoder::transform_decode(double a, double p, double &x, double &y) {
-  x = clamp(1.0047 * a + 0.46804 * a * p * p * p - 0.2042 * a * p * p * p * p +
-            0.0080586 * a * p * p * p * p * p * p * p -
-            0.0001526 * a * p * p * p * p * p * p * p * p * p * p -
-            0.073512 * a * a * a * p - 0.2499 * a * a * a * p * p * p * p +
-            0.016932 * a * a * a * p * p * p * p * p * p * p -
-            0.00027707 * a * a * a * p * p * p * p * p * p * p * p * p * p +
-            0.048105 * a * a * a * a * a * p * p * p * p * p * p * p -
-            0.0065947 * a * a * a * a * a * p * p * p * p * p * p * p * p * p *
-                p +
-            0.0016006 * a * a * a * a * a * p * p * p * p * p * p * p * p * p *
-                p * p -
-            0.0071132 * a * a * a * a * a * a * a * p * p * p * p * p * p * p *
-                p * p +
-            0.0022336 * a * a * a * a * a * a * a * p * p * p * p * p * p * p *
-                p * p * p * p -
-            0.0004804 * a * a * a * a * a * a * a * p * p * p * p * p * p * p *
-                p * p * p * p * p);
-  y = clamp(
-      0.98592 - 0.62237 * p + 0.077875 * p * p - 0.0026929 * p * p * p * p * p +
-      0.4971 * a * a * p - 0.00032124 * a * a * p * p * p * p * p * p +
-      9.2491e-006 * a * a * a * a * p * p * p * p * p * p * p * p * p * p +
-      0.051549 * a * a * a * a * a * a * a * a +
-      1.0727e-014 * a * a * a * a * a * a * a * a * a * a);
+  double a2 = a * a, a3 = a2 * a, a4 = a2 * a2, a5 = a4 * a, a7 = a5 * a2,
+         a8 = a4 * a4, a10 = a8 * a2;
+  double p2 = p * p, p3 = p2 * p, p4 = p2 * p2, p5 = p4 * p, p6 = p3 * p3,
+         p7 = p6 * p, p9 = p7 * p2, p10 = p5 * p5, p11 = p10 * p,
+         p12 = p6 * p6;
+  x = clamp(1.0047 * a + 0.46804 * a * p3 - 0.2042 * a * p4 +
+            0.0080586 * a * p7 - 0.0001526 * a * p10 - 0.073512 * a3 * p -
+            0.2499 * a3 * p4 + 0.016932 * a3 * p7 - 0.00027707 * a3 * p10 +
+            0.048105 * a5 * p7 - 0.0065947 * a5 * p10 + 0.0016006 * a5 * p11 -
+            0.0071132 * a7 * p9 + 0.0022336 * a7 * p11 -
+            0.0004804 * a7 * p12);
+  y = clamp(0.98592 - 0.62237 * p + 0.077875 * p2 - 0.0026929 * p5 +
+            0.4971 * a2 * p - 0.00032124 * a2 * p6 +
+            9.2491e-006 * a4 * p10 + 0.051549 * a8 + 1.0727e-014 * a10);
 }
 
 // apply a circular_wrap transformation to some position
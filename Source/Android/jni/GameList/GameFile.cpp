@@ -166,7 +166,7 @@ JNIEXPORT jboolean JNICALL Java_org_dolphinemu_dolphinemu_model_GameFile_isDatel
 JNIEXPORT jintArray JNICALL Java_org_dolphinemu_dolphinemu_model_GameFile_getBanner(JNIEnv* env,
                                                                                     jobject obj)
 {
-  const std::vector<u32>& buffer = GetRef(env, obj)->GetBannerImage().buffer;
+  const std::vector<u32> buffer = GetRef(env, obj)->GetBannerImage().buffer;
   const auto size = static_cast<jsize>(buffer.size());
   const jintArray out_array = env->NewIntArray(size);
   if (!out_array)
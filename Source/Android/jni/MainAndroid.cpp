@@ -385,6 +385,8 @@ JNIEXPORT void JNICALL Java_org_dolphinemu_dolphinemu_NativeLibrary_WriteProfile
   std::string filename = File::GetUserPath(D_DUMP_IDX) + "Debug/profiler.txt";
   File::CreateFullPath(filename);
   JitInterface::WriteProfileResults(filename);
+  JitInterface::WriteFunctionProfileResults(File::GetUserPath(D_DUMP_IDX) +
+                                            "Debug/profiler_functions.txt");
 }
 
 // Surface Handling
@@ -51,6 +51,7 @@ void AlsaSound::Update()
 void AlsaSound::SoundLoop()
 {
   Common::SetCurrentThreadName("Audio thread - alsa");
+  Common::PlaceCurrentEmulationThread(Common::EmulationThread::Audio);
   while (m_thread_status.load() != ALSAThreadStatus::STOPPING)
   {
     while (m_thread_status.load() == ALSAThreadStatus::RUNNING)
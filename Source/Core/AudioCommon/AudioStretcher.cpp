@@ -8,11 +8,14 @@
 
 #include "AudioCommon/AudioStretcher.h"
 #include "Common/Logging/Log.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 
 namespace AudioCommon
 {
-AudioStretcher::AudioStretcher(unsigned int sample_rate) : m_sample_rate(sample_rate)
+AudioStretcher::AudioStretcher(unsigned int sample_rate)
+    : m_sample_rate(sample_rate), m_wsola(sample_rate),
+      m_use_wsola(Config::Get(Config::MAIN_AUDIO_STRETCH_WSOLA))
 {
   m_sound_touch.setChannels(2);
   m_sound_touch.setSampleRate(sample_rate);
@@ -23,10 +26,36 @@ AudioStretcher::AudioStretcher(unsigned int sample_rate) : m_sample_rate(sample_
 void AudioStretcher::Clear()
 {
   m_sound_touch.clear();
+  m_wsola.Clear();
+}
+
+unsigned int AudioStretcher::NumStretchedSamples() const
+{
+  return m_use_wsola ? m_wsola.NumSamples() : m_sound_touch.numSamples();
+}
+
+void AudioStretcher::AddProcessingTime(std::chrono::steady_clock::time_point start,
+                                       unsigned int num_out)
+{
+  m_processing_time += std::chrono::steady_clock::now() - start;
+  m_processed_frames += num_out;
+  if (m_processed_frames < m_sample_rate)
+    return;
+
+  // Report the cost normalized to one second of output audio.
+  const double seconds = static_cast<double>(m_processed_frames) / m_sample_rate;
+  const double milliseconds =
+      std::chrono::duration<double, std::milli>(m_processing_time).count() / seconds;
+  INFO_LOG_FMT(AUDIO, "Audio stretching ({}) took {:.3f} ms per second of audio",
+               m_use_wsola ? "WSOLA" : "SoundTouch", milliseconds);
+
+  m_processing_time = {};
+  m_processed_frames = 0;
 }
 
 void AudioStretcher::ProcessSamples(const short* in, unsigned int num_in, unsigned int num_out)
 {
+  const auto start_time = std::chrono::steady_clock::now();
   const double time_delta = static_cast<double>(num_out) / m_sample_rate;  // seconds
 
   // We were given actual_samples number of samples, and num_samples were requested from us.
@@ -34,7 +63,7 @@ void AudioStretcher::ProcessSamples(const short* in, unsigned int num_in, unsign
 
   const double max_latency = SConfig::GetInstance().m_audio_stretch_max_latency;
   const double max_backlog = m_sample_rate * max_latency / 1000.0 / m_stretch_ratio;
-  const double backlog_fullness = m_sound_touch.numSamples() / max_backlog;
+  const double backlog_fullness = NumStretchedSamples() / max_backlog;
   if (backlog_fullness > 5.0)
   {
     // Too many samples in backlog: Don't push anymore on
@@ -56,17 +85,30 @@ void AudioStretcher::ProcessSamples(const short* in, unsigned int num_in, unsign
   // Place a lower limit of 10% speed.  When a game boots up, there will be
   // many silence samples.  These do not need to be timestretched.
   m_stretch_ratio = std::max(m_stretch_ratio, 0.1);
-  m_sound_touch.setTempo(m_stretch_ratio);
 
   DEBUG_LOG_FMT(AUDIO, "Audio stretching: samples:{}/{} ratio:{} backlog:{} gain: {}", num_in,
                 num_out, m_stretch_ratio, backlog_fullness, lpf_gain);
 
-  m_sound_touch.putSamples(in, num_in);
+  if (m_use_wsola)
+  {
+    m_wsola.SetTempo(m_stretch_ratio);
+    m_wsola.PutSamples(in, num_in);
+  }
+  else
+  {
+    m_sound_touch.setTempo(m_stretch_ratio);
+    m_sound_touch.putSamples(in, num_in);
+  }
+
+  AddProcessingTime(start_time, 0);
 }
 
 void AudioStretcher::GetStretchedSamples(short* out, unsigned int num_out)
 {
-  const size_t samples_received = m_sound_touch.receiveSamples(out, num_out);
+  const auto start_time = std::chrono::steady_clock::now();
+  const size_t samples_received = m_use_wsola ? m_wsola.ReceiveSamples(out, num_out) :
+                                                m_sound_touch.receiveSamples(out, num_out);
+  AddProcessingTime(start_time, num_out);
 
   if (samples_received != 0)
   {
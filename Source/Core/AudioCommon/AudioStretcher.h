@@ -5,9 +5,13 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 
 #include <SoundTouch.h>
 
+#include "AudioCommon/WSOLAStretcher.h"
+#include "Common/CommonTypes.h"
+
 namespace AudioCommon
 {
 class AudioStretcher
@@ -19,10 +23,19 @@ public:
   void Clear();
 
 private:
+  unsigned int NumStretchedSamples() const;
+  void AddProcessingTime(std::chrono::steady_clock::time_point start, unsigned int num_out);
+
   unsigned int m_sample_rate;
   std::array<short, 2> m_last_stretched_sample = {};
   soundtouch::SoundTouch m_sound_touch;
+  WSOLAStretcher m_wsola;
+  bool m_use_wsola;
   double m_stretch_ratio = 1.0;
+
+  // Time spent stretching since the last report, and the amount of audio it produced.
+  std::chrono::steady_clock::duration m_processing_time{};
+  u64 m_processed_frames = 0;
 };
 
 }  // namespace AudioCommon
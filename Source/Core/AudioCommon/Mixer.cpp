@@ -6,15 +6,23 @@
 #include "AudioCommon/Enums.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstring>
 
+#if defined(_M_X86)
+#include "Common/Intrinsics.h"
+#elif defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
+
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/Swap.h"
 #include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
+#include "VideoCommon/FrameTimeBreakdown.h"
 
 static u32 DPL2QualityToFrameBlockSize(AudioCommon::DPL2Quality quality)
 {
@@ -31,8 +39,112 @@ static u32 DPL2QualityToFrameBlockSize(AudioCommon::DPL2Quality quality)
   }
 }
 
+// Samples are resampled into a small buffer this many frames at a time, and then mixed into the
+// output several samples at once.
+constexpr u32 MIX_BLOCK_SIZE = 256;
+
+// The windowed sinc resampler uses SINC_TAPS input frames around the output position, of which
+// SINC_HISTORY are before it. Its weights are precomputed for SINC_PHASES positions.
+constexpr u32 SINC_TAPS = 8;
+constexpr u32 SINC_HISTORY = SINC_TAPS / 2 - 1;
+constexpr u32 SINC_LOOKAHEAD = SINC_TAPS - SINC_HISTORY - 1;
+constexpr u32 SINC_PHASE_BITS = 8;
+constexpr u32 SINC_PHASES = 1 << SINC_PHASE_BITS;
+
+// Lanczos windowed sinc weights for each phase, normalized so that each phase sums up to one.
+static const auto& GetSincTable()
+{
+  static const auto table = [] {
+    constexpr double pi = 3.14159265358979323846;
+    constexpr double a = SINC_TAPS / 2;
+
+    std::array<std::array<float, SINC_TAPS>, SINC_PHASES> weights;
+    for (u32 phase = 0; phase < SINC_PHASES; ++phase)
+    {
+      const double t = static_cast<double>(phase) / SINC_PHASES;
+      double sum = 0.0;
+      std::array<double, SINC_TAPS> phase_weights;
+      for (u32 tap = 0; tap < SINC_TAPS; ++tap)
+      {
+        const double x = static_cast<double>(tap) - SINC_HISTORY - t;
+        if (x == 0.0)
+          phase_weights[tap] = 1.0;
+        else if (std::abs(x) >= a)
+          phase_weights[tap] = 0.0;
+        else
+          phase_weights[tap] = a * std::sin(pi * x) * std::sin(pi * x / a) / (pi * pi * x * x);
+        sum += phase_weights[tap];
+      }
+
+      for (u32 tap = 0; tap < SINC_TAPS; ++tap)
+        weights[phase][tap] = static_cast<float>(phase_weights[tap] / sum);
+    }
+    return weights;
+  }();
+  return table;
+}
+
+// Adds the resampled samples to the output with the volume applied and clamps the result. The
+// samples are interleaved with the right channel first.
+static void MixWithVolume(short* samples, const s16* input, u32 count, s32 lvolume, s32 rvolume)
+{
+  u32 i = 0;
+
+#if defined(_M_X86)
+  const __m128i volumes = _mm_setr_epi16(rvolume, lvolume, rvolume, lvolume, rvolume, lvolume,
+                                         rvolume, lvolume);
+  const __m128i min_sample = _mm_set1_epi16(-32767);
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+    const __m128i out = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+
+    const __m128i products_lo = _mm_mullo_epi16(in, volumes);
+    const __m128i products_hi = _mm_mulhi_epi16(in, volumes);
+    __m128i sum_lo = _mm_srai_epi32(_mm_unpacklo_epi16(products_lo, products_hi), 8);
+    __m128i sum_hi = _mm_srai_epi32(_mm_unpackhi_epi16(products_lo, products_hi), 8);
+    sum_lo = _mm_add_epi32(sum_lo, _mm_srai_epi32(_mm_unpacklo_epi16(out, out), 16));
+    sum_hi = _mm_add_epi32(sum_hi, _mm_srai_epi32(_mm_unpackhi_epi16(out, out), 16));
+
+    const __m128i result = _mm_max_epi16(_mm_packs_epi32(sum_lo, sum_hi), min_sample);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(samples + i), result);
+  }
+#elif defined(_M_ARM_64)
+  const s16 volume_pattern[8] = {
+      static_cast<s16>(rvolume), static_cast<s16>(lvolume), static_cast<s16>(rvolume),
+      static_cast<s16>(lvolume), static_cast<s16>(rvolume), static_cast<s16>(lvolume),
+      static_cast<s16>(rvolume), static_cast<s16>(lvolume)};
+  const int16x8_t volumes = vld1q_s16(volume_pattern);
+  const int16x8_t min_sample = vdupq_n_s16(-32767);
+  for (; i + 8 <= count; i += 8)
+  {
+    const int16x8_t in = vld1q_s16(input + i);
+    const int16x8_t out = vld1q_s16(samples + i);
+
+    int32x4_t sum_lo = vshrq_n_s32(vmull_s16(vget_low_s16(in), vget_low_s16(volumes)), 8);
+    int32x4_t sum_hi = vshrq_n_s32(vmull_s16(vget_high_s16(in), vget_high_s16(volumes)), 8);
+    sum_lo = vaddw_s16(sum_lo, vget_low_s16(out));
+    sum_hi = vaddw_s16(sum_hi, vget_high_s16(out));
+
+    const int16x8_t result = vcombine_s16(vqmovn_s32(sum_lo), vqmovn_s32(sum_hi));
+    vst1q_s16(samples + i, vmaxq_s16(result, min_sample));
+  }
+#endif
+
+  for (; i < count; i += 2)
+  {
+    const int sample_r = samples[i] + ((input[i] * rvolume) >> 8);
+    const int sample_l = samples[i + 1] + ((input[i + 1] * lvolume) >> 8);
+    samples[i] = std::clamp(sample_r, -32767, 32767);
+    samples[i + 1] = std::clamp(sample_l, -32767, 32767);
+  }
+}
+
 Mixer::Mixer(unsigned int BackendSampleRate)
-    : m_sampleRate(BackendSampleRate), m_stretcher(BackendSampleRate),
+    : m_sampleRate(BackendSampleRate),
+      m_sinc_resampling(Config::Get(Config::MAIN_AUDIO_SINC_RESAMPLING)),
+      m_adaptive_latency(Config::Get(Config::MAIN_AUDIO_ADAPTIVE_LATENCY)),
+      m_stretcher(BackendSampleRate),
       m_surround_decoder(BackendSampleRate,
                          DPL2QualityToFrameBlockSize(Config::Get(Config::MAIN_DPL2_QUALITY)))
 {
@@ -50,12 +162,95 @@ void Mixer::DoState(PointerWrap& p)
   m_wiimote_speaker_mixer.DoState(p);
 }
 
+u32 Mixer::MixerFifo::ResampleLinear(s16* output, u32 count, u32& index_r, u32 index_w,
+                                     u32 ratio)
+{
+  u32 i = 0;
+  for (; i < count && ((index_w - index_r) & INDEX_MASK) > 2; i += 2)
+  {
+    const u32 index_r2 = index_r + 2;  // next sample
+
+    const s16 l1 = Common::swap16(m_buffer[index_r & INDEX_MASK]);   // current
+    const s16 l2 = Common::swap16(m_buffer[index_r2 & INDEX_MASK]);  // next
+    output[i + 1] = static_cast<s16>(((l1 << 16) + (l2 - l1) * (u16)m_frac) >> 16);
+
+    const s16 r1 = Common::swap16(m_buffer[(index_r + 1) & INDEX_MASK]);   // current
+    const s16 r2 = Common::swap16(m_buffer[(index_r2 + 1) & INDEX_MASK]);  // next
+    output[i] = static_cast<s16>(((r1 << 16) + (r2 - r1) * (u16)m_frac) >> 16);
+
+    m_frac += ratio;
+    index_r += 2 * (u16)(m_frac >> 16);
+    m_frac &= 0xffff;
+  }
+  return i;
+}
+
+u32 Mixer::MixerFifo::ResampleSinc(s16* output, u32 count, u32& index_r, u32 index_w, u32 ratio)
+{
+  const auto& table = GetSincTable();
+
+  u32 i = 0;
+  for (; i < count && ((index_w - index_r) & INDEX_MASK) > 2 * SINC_LOOKAHEAD;
+       i += 2)
+  {
+    const std::array<float, SINC_TAPS>& weights = table[m_frac >> (16 - SINC_PHASE_BITS)];
+
+    float sample_l = 0.0f;
+    float sample_r = 0.0f;
+    u32 index = index_r - 2 * SINC_HISTORY;
+    for (u32 tap = 0; tap < SINC_TAPS; ++tap, index += 2)
+    {
+      sample_l += Common::swap16(m_buffer[index & INDEX_MASK]) * weights[tap];
+      sample_r += Common::swap16(m_buffer[(index + 1) & INDEX_MASK]) * weights[tap];
+    }
+
+    output[i + 1] = static_cast<s16>(std::clamp<long>(std::lround(sample_l), -32768, 32767));
+    output[i] = static_cast<s16>(std::clamp<long>(std::lround(sample_r), -32768, 32767));
+
+    m_frac += ratio;
+    index_r += 2 * (u16)(m_frac >> 16);
+    m_frac &= 0xffff;
+  }
+  return i;
+}
+
+float Mixer::MixerFifo::GetTargetFill()
+{
+  const u32 max_target = MAX_SAMPLES / 2;
+  if (!m_mixer->m_adaptive_latency)
+  {
+    const u32 target = m_input_sample_rate * SConfig::GetInstance().iTimingVariance / 1000;
+    return static_cast<float>(std::min(target, max_target));
+  }
+
+  const float min_target = static_cast<float>(m_input_sample_rate * ADAPTIVE_MIN_LATENCY_MS / 1000);
+  m_adaptive_target = std::clamp(m_adaptive_target, min_target, static_cast<float>(max_target));
+  return m_adaptive_target;
+}
+
+void Mixer::MixerFifo::UpdateAdaptiveTarget(u32 requested_samples, u32 mixed_samples,
+                                            u32 available_samples)
+{
+  // A FIFO which was already empty isn't being fed at the moment, so only running dry while
+  // mixing counts as an underrun.
+  if (mixed_samples < requested_samples && available_samples > 0)
+  {
+    const float requested_input =
+        static_cast<float>(requested_samples) * m_input_sample_rate / m_mixer->m_sampleRate;
+    m_adaptive_target = m_adaptive_target * ADAPTIVE_GROW_FACTOR + requested_input;
+    INFO_LOG_FMT(AUDIO, "Mixer FIFO underrun, new target fill: {} samples",
+                 static_cast<u32>(m_adaptive_target));
+  }
+  else
+  {
+    m_adaptive_target -= m_adaptive_target * ADAPTIVE_SHRINK_RATE;
+  }
+}
+
 // Executed from sound stream thread
 unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
                                    bool consider_framelimit)
 {
-  unsigned int currentSample = 0;
-
   // Cache access in non-volatile variable
   // This is the only function changing the read value, so it's safe to
   // cache it locally although it's written here.
@@ -63,8 +258,9 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
   // so we will just ignore new written data while interpolating.
   // Without this cache, the compiler wouldn't be allowed to optimize the
   // interpolation loop.
-  u32 indexR = m_indexR.load();
-  u32 indexW = m_indexW.load();
+  u32 indexR = m_indexR.load(std::memory_order_relaxed);
+  const u32 indexW = m_indexW.load(std::memory_order_acquire);
+  const u32 available_samples = ((indexW - indexR) & INDEX_MASK) / 2;
 
   // render numleft sample pairs to samples[]
   // advance indexR with sample position
@@ -74,10 +270,9 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
   float aid_sample_rate = static_cast<float>(m_input_sample_rate);
   if (consider_framelimit && emulationspeed > 0.0f)
   {
-    float numLeft = static_cast<float>(((indexW - indexR) & INDEX_MASK) / 2);
+    float numLeft = static_cast<float>(available_samples);
 
-    u32 low_waterwark = m_input_sample_rate * SConfig::GetInstance().iTimingVariance / 1000;
-    low_waterwark = std::min(low_waterwark, MAX_SAMPLES / 2);
+    const float low_waterwark = GetTargetFill();
 
     m_numLeftI = (numLeft + m_numLeftI * (CONTROL_AVG - 1)) / CONTROL_AVG;
     float offset = (m_numLeftI - low_waterwark) * CONTROL_FACTOR;
@@ -94,33 +289,30 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
   s32 lvolume = m_LVolume.load();
   s32 rvolume = m_RVolume.load();
 
-  // TODO: consider a higher-quality resampling algorithm.
-  for (; currentSample < numSamples * 2 && ((indexW - indexR) & INDEX_MASK) > 2; currentSample += 2)
+  // Resample a block at a time, and then mix the whole block into the output.
+  std::array<s16, MIX_BLOCK_SIZE * 2> resampled;
+  unsigned int currentSample = 0;
+  while (currentSample < numSamples * 2)
   {
-    u32 indexR2 = indexR + 2;  // next sample
-
-    s16 l1 = Common::swap16(m_buffer[indexR & INDEX_MASK]);   // current
-    s16 l2 = Common::swap16(m_buffer[indexR2 & INDEX_MASK]);  // next
-    int sampleL = ((l1 << 16) + (l2 - l1) * (u16)m_frac) >> 16;
-    sampleL = (sampleL * lvolume) >> 8;
-    sampleL += samples[currentSample + 1];
-    samples[currentSample + 1] = std::clamp(sampleL, -32767, 32767);
-
-    s16 r1 = Common::swap16(m_buffer[(indexR + 1) & INDEX_MASK]);   // current
-    s16 r2 = Common::swap16(m_buffer[(indexR2 + 1) & INDEX_MASK]);  // next
-    int sampleR = ((r1 << 16) + (r2 - r1) * (u16)m_frac) >> 16;
-    sampleR = (sampleR * rvolume) >> 8;
-    sampleR += samples[currentSample];
-    samples[currentSample] = std::clamp(sampleR, -32767, 32767);
+    const u32 block_count = std::min<u32>(numSamples * 2 - currentSample, MIX_BLOCK_SIZE * 2);
+    const u32 resampled_count =
+        m_mixer->m_sinc_resampling ?
+            ResampleSinc(resampled.data(), block_count, indexR, indexW, ratio) :
+            ResampleLinear(resampled.data(), block_count, indexR, indexW, ratio);
 
-    m_frac += ratio;
-    indexR += 2 * (u16)(m_frac >> 16);
-    m_frac &= 0xffff;
+    MixWithVolume(samples + currentSample, resampled.data(), resampled_count, lvolume, rvolume);
+    currentSample += resampled_count;
+
+    if (resampled_count < block_count)
+      break;
   }
 
   // Actual number of samples written to the buffer without padding.
   unsigned int actual_sample_count = currentSample / 2;
 
+  if (consider_framelimit && m_mixer->m_adaptive_latency)
+    UpdateAdaptiveTarget(numSamples, actual_sample_count, available_samples);
+
   // Padding
   short s[2];
   s[0] = Common::swap16(m_buffer[(indexR - 1) & INDEX_MASK]);
@@ -137,7 +329,7 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
   }
 
   // Flush cached variable
-  m_indexR.store(indexR);
+  m_indexR.store(indexR, std::memory_order_release);
 
   return actual_sample_count;
 }
@@ -147,6 +339,8 @@ unsigned int Mixer::Mix(short* samples, unsigned int num_samples)
   if (!samples)
     return 0;
 
+  const FrameTimeBreakdown::ScopedCategory breakdown_category(FrameTimeBreakdown::Category::Audio);
+
   memset(samples, 0, num_samples * 2 * sizeof(short));
 
   if (SConfig::GetInstance().m_audio_stretch)
@@ -208,12 +402,18 @@ void Mixer::MixerFifo::PushSamples(const short* samples, unsigned int num_sample
   // Cache access in non-volatile variable
   // indexR isn't allowed to cache in the audio throttling loop as it
   // needs to get updates to not deadlock.
-  u32 indexW = m_indexW.load();
+  u32 indexW = m_indexW.load(std::memory_order_relaxed);
 
   // Check if we have enough free space
   // indexW == m_indexR results in empty buffer, so indexR must always be smaller than indexW
-  if (num_samples * 2 + ((indexW - m_indexR.load()) & INDEX_MASK) >= MAX_SAMPLES * 2)
+  // The sinc resampler also reads a few samples before indexR, which must not be overwritten.
+  const u32 reserved = m_mixer->m_sinc_resampling ? SINC_HISTORY * 2 : 0;
+  if (num_samples * 2 + ((indexW - m_indexR.load(std::memory_order_acquire)) & INDEX_MASK) +
+          reserved >=
+      MAX_SAMPLES * 2)
+  {
     return;
+  }
 
   // AyuanX: Actual re-sampling work has been moved to sound thread
   // to alleviate the workload on main thread
@@ -229,7 +429,7 @@ void Mixer::MixerFifo::PushSamples(const short* samples, unsigned int num_sample
     memcpy(&m_buffer[indexW & INDEX_MASK], samples, num_samples * 4);
   }
 
-  m_indexW.fetch_add(num_samples * 2);
+  m_indexW.fetch_add(num_samples * 2, std::memory_order_release);
 }
 
 void Mixer::PushSamples(const short* samples, unsigned int num_samples)
@@ -387,7 +587,11 @@ void Mixer::MixerFifo::SetVolume(unsigned int lvolume, unsigned int rvolume)
 unsigned int Mixer::MixerFifo::AvailableSamples() const
 {
   unsigned int samples_in_fifo = ((m_indexW.load() - m_indexR.load()) & INDEX_MASK) / 2;
-  if (samples_in_fifo <= 1)
-    return 0;  // Mixer::MixerFifo::Mix always keeps one sample in the buffer.
-  return (samples_in_fifo - 1) * m_mixer->m_sampleRate / m_input_sample_rate;
+
+  // Mixer::MixerFifo::Mix always keeps one sample in the buffer, or the ones after the output
+  // position which the sinc resampler needs.
+  const unsigned int kept_samples = m_mixer->m_sinc_resampling ? SINC_LOOKAHEAD : 1;
+  if (samples_in_fifo <= kept_samples)
+    return 0;
+  return (samples_in_fifo - kept_samples) * m_mixer->m_sampleRate / m_input_sample_rate;
 }
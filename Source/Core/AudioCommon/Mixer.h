@@ -53,6 +53,12 @@ private:
   static constexpr float CONTROL_FACTOR = 0.2f;
   static constexpr u32 CONTROL_AVG = 32;  // In freq_shift per FIFO size offset
 
+  // With adaptive latency, the FIFO fill level the mixer aims for starts at this many ms, grows
+  // whenever the FIFO runs dry while mixing, and otherwise slowly shrinks back to it.
+  static constexpr u32 ADAPTIVE_MIN_LATENCY_MS = 10;
+  static constexpr float ADAPTIVE_GROW_FACTOR = 1.5f;
+  static constexpr float ADAPTIVE_SHRINK_RATE = 1.0f / 1024;
+
   const unsigned int SURROUND_CHANNELS = 6;
 
   class MixerFifo final
@@ -70,6 +76,15 @@ private:
     unsigned int AvailableSamples() const;
 
   private:
+    // Resample up to count interleaved samples into output, advancing index_r. Return the number
+    // of samples written, which is less than count if the FIFO ran out of input.
+    u32 ResampleLinear(s16* output, u32 count, u32& index_r, u32 index_w, u32 ratio);
+    u32 ResampleSinc(s16* output, u32 count, u32& index_r, u32 index_w, u32 ratio);
+
+    // Returns the FIFO fill level in input samples which the resampling ratio is steered to.
+    float GetTargetFill();
+    void UpdateAdaptiveTarget(u32 requested_samples, u32 mixed_samples, u32 available_samples);
+
     Mixer* m_mixer;
     unsigned m_input_sample_rate;
     std::array<short, MAX_SAMPLES * 2> m_buffer{};
@@ -79,6 +94,7 @@ private:
     std::atomic<s32> m_LVolume{256};
     std::atomic<s32> m_RVolume{256};
     float m_numLeftI = 0.0f;
+    float m_adaptive_target = 0.0f;
     u32 m_frac = 0;
   };
 
@@ -86,6 +102,8 @@ private:
   MixerFifo m_streaming_mixer{this, 48000};
   MixerFifo m_wiimote_speaker_mixer{this, 3000};
   unsigned int m_sampleRate;
+  bool m_sinc_resampling;
+  bool m_adaptive_latency;
 
   bool m_is_stretching = false;
   AudioCommon::AudioStretcher m_stretcher;
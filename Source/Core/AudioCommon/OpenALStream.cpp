@@ -218,6 +218,7 @@ static bool IsCreativeXFi()
 void OpenALStream::SoundLoop()
 {
   Common::SetCurrentThreadName("Audio thread - openal");
+  Common::PlaceCurrentEmulationThread(Common::EmulationThread::Audio);
 
   bool float32_capable = palIsExtensionPresent("AL_EXT_float32") != 0;
   bool surround_capable = palIsExtensionPresent("AL_EXT_MCFORMATS") || IsCreativeXFi();
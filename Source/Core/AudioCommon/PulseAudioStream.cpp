@@ -40,6 +40,7 @@ PulseAudio::~PulseAudio()
 void PulseAudio::SoundLoop()
 {
   Common::SetCurrentThreadName("Audio thread - pulse");
+  Common::PlaceCurrentEmulationThread(Common::EmulationThread::Audio);
 
   if (PulseInit())
   {
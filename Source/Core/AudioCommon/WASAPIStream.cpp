@@ -417,6 +417,7 @@ bool WASAPIStream::SetRunning(bool running)
 void WASAPIStream::SoundLoop()
 {
   Common::SetCurrentThreadName("WASAPI Handler");
+  Common::PlaceCurrentEmulationThread(Common::EmulationThread::Audio);
   BYTE* data;
 
   if (m_audio_renderer)
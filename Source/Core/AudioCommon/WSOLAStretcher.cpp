@@ -0,0 +1,199 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "AudioCommon/WSOLAStretcher.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X86)
+#include "Common/Intrinsics.h"
+#elif defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
+
+namespace AudioCommon
+{
+constexpr u32 SEQUENCE_MS = 40;
+constexpr u32 OVERLAP_MS = 8;
+constexpr u32 SEEK_MS = 15;
+// The seek window is first scanned at this stride, then refined around the best candidate.
+constexpr u32 COARSE_STEP = 8;
+
+// Computes the dot product of a and b, as well as the energy of b, over count floats.
+static void Correlate(const float* a, const float* b, u32 count, float* cross, float* energy)
+{
+  u32 i = 0;
+  float cross_sum = 0.0f;
+  float energy_sum = 0.0f;
+
+#if defined(_M_X86)
+  __m128 cross_acc = _mm_setzero_ps();
+  __m128 energy_acc = _mm_setzero_ps();
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m128 va = _mm_loadu_ps(a + i);
+    const __m128 vb = _mm_loadu_ps(b + i);
+    cross_acc = _mm_add_ps(cross_acc, _mm_mul_ps(va, vb));
+    energy_acc = _mm_add_ps(energy_acc, _mm_mul_ps(vb, vb));
+  }
+  alignas(16) float cross_lanes[4];
+  alignas(16) float energy_lanes[4];
+  _mm_store_ps(cross_lanes, cross_acc);
+  _mm_store_ps(energy_lanes, energy_acc);
+  cross_sum = cross_lanes[0] + cross_lanes[1] + cross_lanes[2] + cross_lanes[3];
+  energy_sum = energy_lanes[0] + energy_lanes[1] + energy_lanes[2] + energy_lanes[3];
+#elif defined(_M_ARM_64)
+  float32x4_t cross_acc = vdupq_n_f32(0.0f);
+  float32x4_t energy_acc = vdupq_n_f32(0.0f);
+  for (; i + 4 <= count; i += 4)
+  {
+    const float32x4_t va = vld1q_f32(a + i);
+    const float32x4_t vb = vld1q_f32(b + i);
+    cross_acc = vmlaq_f32(cross_acc, va, vb);
+    energy_acc = vmlaq_f32(energy_acc, vb, vb);
+  }
+  cross_sum = vaddvq_f32(cross_acc);
+  energy_sum = vaddvq_f32(energy_acc);
+#endif
+
+  for (; i < count; i++)
+  {
+    cross_sum += a[i] * b[i];
+    energy_sum += b[i] * b[i];
+  }
+
+  *cross = cross_sum;
+  *energy = energy_sum;
+}
+
+WSOLAStretcher::WSOLAStretcher(u32 sample_rate)
+    : m_sequence_frames(sample_rate * SEQUENCE_MS / 1000),
+      m_overlap_frames(std::max((sample_rate * OVERLAP_MS / 1000) & ~3u, 4u)),
+      m_seek_frames(sample_rate * SEEK_MS / 1000)
+{
+  m_overlap.resize(m_overlap_frames * 2);
+  m_reference.resize(m_overlap_frames * 2);
+  m_search_region.resize((m_seek_frames + m_overlap_frames) * 2);
+}
+
+void WSOLAStretcher::SetTempo(double tempo)
+{
+  m_tempo = tempo;
+}
+
+void WSOLAStretcher::PutSamples(const s16* in, u32 num_frames)
+{
+  m_input.insert(m_input.end(), in, in + num_frames * 2);
+  ProcessSegments();
+}
+
+u32 WSOLAStretcher::ReceiveSamples(s16* out, u32 num_frames)
+{
+  const u32 frames = std::min(num_frames, NumSamples());
+  std::copy_n(m_output.begin(), frames * 2, out);
+  m_output.erase(m_output.begin(), m_output.begin() + frames * 2);
+  return frames;
+}
+
+u32 WSOLAStretcher::NumSamples() const
+{
+  return static_cast<u32>(m_output.size() / 2);
+}
+
+void WSOLAStretcher::Clear()
+{
+  m_input.clear();
+  m_output.clear();
+  m_input_pos = 0.0;
+  m_has_overlap = false;
+}
+
+u32 WSOLAStretcher::FindBestOffset(u32 start)
+{
+  std::copy(m_overlap.begin(), m_overlap.end(), m_reference.begin());
+  std::copy_n(m_input.begin() + start * 2, m_search_region.size(), m_search_region.begin());
+
+  const u32 overlap_samples = m_overlap_frames * 2;
+  const auto score = [&](u32 offset) {
+    float cross, energy;
+    Correlate(m_reference.data(), &m_search_region[offset * 2], overlap_samples, &cross, &energy);
+    return cross / std::sqrt(energy + 1.0f);
+  };
+
+  u32 best_offset = 0;
+  float best_score = score(0);
+  for (u32 offset = COARSE_STEP; offset < m_seek_frames; offset += COARSE_STEP)
+  {
+    const float offset_score = score(offset);
+    if (offset_score > best_score)
+    {
+      best_score = offset_score;
+      best_offset = offset;
+    }
+  }
+
+  const u32 coarse_offset = best_offset;
+  const u32 refine_start = coarse_offset > COARSE_STEP ? coarse_offset - COARSE_STEP + 1 : 0;
+  const u32 refine_end = std::min(coarse_offset + COARSE_STEP, m_seek_frames);
+  for (u32 offset = refine_start; offset < refine_end; offset++)
+  {
+    if (offset == coarse_offset)
+      continue;
+
+    const float offset_score = score(offset);
+    if (offset_score > best_score)
+    {
+      best_score = offset_score;
+      best_offset = offset;
+    }
+  }
+
+  return best_offset;
+}
+
+void WSOLAStretcher::ProcessSegments()
+{
+  // Every segment produces this many frames; its last m_overlap_frames are held back to be
+  // crossfaded with the start of the next one.
+  const u32 hop_frames = m_sequence_frames - m_overlap_frames;
+
+  while (true)
+  {
+    const u32 start = static_cast<u32>(m_input_pos);
+    if (m_input.size() / 2 < start + m_seek_frames + m_sequence_frames)
+      break;
+
+    const u32 offset = m_has_overlap ? FindBestOffset(start) : 0;
+    const s16* segment = &m_input[(start + offset) * 2];
+
+    const size_t out_pos = m_output.size();
+    m_output.resize(out_pos + hop_frames * 2);
+    s16* out = &m_output[out_pos];
+    if (m_has_overlap)
+    {
+      for (u32 i = 0; i < m_overlap_frames * 2; i++)
+      {
+        const s32 fade_in = static_cast<s32>(i / 2);
+        const s32 fade_out = static_cast<s32>(m_overlap_frames) - fade_in;
+        out[i] = static_cast<s16>((m_overlap[i] * fade_out + segment[i] * fade_in) /
+                                  static_cast<s32>(m_overlap_frames));
+      }
+    }
+    else
+    {
+      std::copy_n(segment, m_overlap_frames * 2, out);
+    }
+    std::copy(segment + m_overlap_frames * 2, segment + hop_frames * 2, out + m_overlap_frames * 2);
+    std::copy_n(segment + hop_frames * 2, m_overlap_frames * 2, m_overlap.begin());
+    m_has_overlap = true;
+
+    m_input_pos += m_tempo * hop_frames;
+    const u32 consumed =
+        std::min(static_cast<u32>(m_input_pos), static_cast<u32>(m_input.size() / 2));
+    m_input.erase(m_input.begin(), m_input.begin() + consumed * 2);
+    m_input_pos -= consumed;
+  }
+}
+}  // namespace AudioCommon
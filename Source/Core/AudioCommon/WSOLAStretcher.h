@@ -0,0 +1,53 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace AudioCommon
+{
+// A lightweight stereo time-stretcher using waveform-similarity overlap-add (WSOLA).
+// Output is produced in fixed-size segments which are cut from the input at a rate given by the
+// tempo. Each segment is shifted within a small seek window to the offset whose start best
+// matches the end of the previous segment, and the two are crossfaded over that overlap.
+// Compared to SoundTouch this skips the anti-alias filtering and uses a coarse-to-fine search,
+// which makes it considerably cheaper at a small cost in quality. All sample counts are frames.
+class WSOLAStretcher
+{
+public:
+  explicit WSOLAStretcher(u32 sample_rate);
+
+  void SetTempo(double tempo);
+  void PutSamples(const s16* in, u32 num_frames);
+  u32 ReceiveSamples(s16* out, u32 num_frames);
+  // Number of frames which are ready to be received.
+  u32 NumSamples() const;
+  void Clear();
+
+private:
+  void ProcessSegments();
+  u32 FindBestOffset(u32 start);
+
+  u32 m_sequence_frames;
+  u32 m_overlap_frames;
+  u32 m_seek_frames;
+
+  double m_tempo = 1.0;
+  // Fractional position in m_input at which the next segment is nominally cut.
+  double m_input_pos = 0.0;
+  bool m_has_overlap = false;
+
+  // Interleaved stereo samples.
+  std::vector<s16> m_input;
+  std::vector<s16> m_output;
+  std::vector<s16> m_overlap;
+
+  // Scratch buffers for the correlation search.
+  std::vector<float> m_reference;
+  std::vector<float> m_search_region;
+};
+}  // namespace AudioCommon
@@ -5,6 +5,8 @@
 #include "AudioCommon/WaveFile.h"
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
@@ -13,10 +15,9 @@
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
+#include "Common/Thread.h"
 #include "Core/ConfigManager.h"
 
-constexpr size_t WaveFileWriter::BUFFER_SIZE;
-
 WaveFileWriter::WaveFileWriter()
 {
 }
@@ -90,11 +91,24 @@ bool WaveFileWriter::Start(const std::string& filename, unsigned int HLESampleRa
   if (file.Tell() != 44)
     PanicAlertFmt("Wrong offset: {}", file.Tell());
 
+  is_open = true;
+  stop_writer.Clear();
+  writer_thread = std::thread(&WaveFileWriter::WriterThread, this);
+
   return true;
 }
 
 void WaveFileWriter::Stop()
 {
+  if (writer_thread.joinable())
+  {
+    SubmitBlock();
+    stop_writer.Set();
+    block_submitted.Set();
+    writer_thread.join();
+  }
+  is_open = false;
+
   // u32 file_size = (u32)ftello(file);
   file.Seek(4, SEEK_SET);
   Write(audio_size + 36);
@@ -115,13 +129,58 @@ void WaveFileWriter::Write4(const char* ptr)
   file.WriteBytes(ptr, 4);
 }
 
+void WaveFileWriter::SubmitBlock()
+{
+  if (current_block.empty())
+    return;
+
+  std::vector<short> next_block;
+  if (!empty_blocks.Pop(next_block))
+    next_block.reserve(current_block.capacity());
+
+  filled_blocks.Push(std::move(current_block));
+  current_block = std::move(next_block);
+  block_submitted.Set();
+}
+
+void WaveFileWriter::WriterThread()
+{
+  Common::SetCurrentThreadName("Audio Dump Writer");
+
+  std::vector<short> block;
+  while (true)
+  {
+    block_submitted.Wait();
+
+    // Everything submitted before the stop was requested has to be written
+    const bool stop = stop_writer.IsSet();
+    while (filled_blocks.Pop(block))
+    {
+      for (size_t i = 0; i < block.size(); i += 2)
+      {
+        // Flip the audio channels from RL to LR
+        const short right = block[i];
+        block[i] = Common::swap16((u16)block[i + 1]);
+        block[i + 1] = Common::swap16((u16)right);
+      }
+      file.WriteBytes(block.data(), block.size() * sizeof(short));
+
+      block.clear();
+      empty_blocks.Push(std::move(block));
+    }
+
+    if (stop)
+      break;
+  }
+}
+
 void WaveFileWriter::AddStereoSamplesBE(const short* sample_data, u32 count, int sample_rate)
 {
-  if (!file)
+  if (!is_open)
+  {
     ERROR_LOG_FMT(AUDIO, "WaveFileWriter - file not open.");
-
-  if (count > BUFFER_SIZE * 2)
-    ERROR_LOG_FMT(AUDIO, "WaveFileWriter - buffer too small (count = {}).", count);
+    return;
+  }
 
   if (skip_silence)
   {
@@ -137,13 +196,6 @@ void WaveFileWriter::AddStereoSamplesBE(const short* sample_data, u32 count, int
       return;
   }
 
-  for (u32 i = 0; i < count; i++)
-  {
-    // Flip the audio channels from RL to LR
-    conv_buffer[2 * i] = Common::swap16((u16)sample_data[2 * i + 1]);
-    conv_buffer[2 * i + 1] = Common::swap16((u16)sample_data[2 * i]);
-  }
-
   if (sample_rate != current_sample_rate)
   {
     Stop();
@@ -154,6 +206,8 @@ void WaveFileWriter::AddStereoSamplesBE(const short* sample_data, u32 count, int
     current_sample_rate = sample_rate;
   }
 
-  file.WriteBytes(conv_buffer.data(), count * 4);
+  current_block.insert(current_block.end(), sample_data, sample_data + count * 2);
+  if (current_block.size() >= BUFFER_SIZE)
+    SubmitBlock();
   audio_size += count * 4;
 }
@@ -10,15 +10,21 @@
 // The float variant will convert from -1.0-1.0 range and clamp.
 // Alternatively, AddSamplesBE for big endian wave data.
 // If Stop is not called when it destructs, the destructor will call Stop().
+// The samples are converted and written to disk by a thread of the writer's own, so that a slow
+// disk doesn't hold up the audio thread.
 // ---------------------------------------------------------------------------------
 
 #pragma once
 
-#include <array>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "Common/Flag.h"
 #include "Common/IOFile.h"
+#include "Common/SPSCRingQueue.h"
 
 class WaveFileWriter
 {
@@ -39,14 +45,28 @@ public:
   u32 GetAudioSize() const { return audio_size; }
 
 private:
+  // Samples are handed to the writer thread in blocks of at least this many shorts
   static constexpr size_t BUFFER_SIZE = 32 * 1024;
 
   File::IOFile file;
+  bool is_open = false;
   bool skip_silence = false;
   u32 audio_size = 0;
-  std::array<short, BUFFER_SIZE> conv_buffer{};
   void Write(u32 value);
   void Write4(const char* ptr);
+  void SubmitBlock();
+  void WriterThread();
+
+  // Big endian samples as they were added, not yet submitted
+  std::vector<short> current_block;
+  // Blocks go to the writer thread through filled_blocks, and come back empty through
+  // empty_blocks to be reused, so that the audio thread doesn't have to allocate.
+  Common::SPSCRingQueue<std::vector<short>> filled_blocks;
+  Common::SPSCRingQueue<std::vector<short>> empty_blocks;
+  Common::Event block_submitted;
+  Common::Flag stop_writer;
+  std::thread writer_thread;
+
   std::string basename;
   int current_sample_rate;
   int file_index = 0;
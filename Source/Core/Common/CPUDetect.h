@@ -47,6 +47,7 @@ struct CPUInfo
   bool bFMA = false;
   bool bFMA4 = false;
   bool bAES = false;
+  bool bPCLMULQDQ = false;
   // FXSAVE/FXRSTOR
   bool bFXSR = false;
   bool bMOVBE = false;
@@ -62,6 +63,8 @@ struct CPUInfo
   bool bFP = false;
   bool bASIMD = false;
   bool bCRC32 = false;
+
+  // SHA-NI on x86-64, which covers both, or the ARMv8 SHA1 and SHA2 instructions
   bool bSHA1 = false;
   bool bSHA2 = false;
 
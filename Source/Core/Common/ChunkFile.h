@@ -13,8 +13,10 @@
 // - Zero backwards/forwards compatibility
 // - Serialization code for anything complex has to be manually written.
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <deque>
 #include <list>
@@ -49,6 +51,15 @@ public:
     MODE_VERIFY,    // compare
   };
 
+  // A part of the output that DoBulkArray referenced instead of copying
+  struct BulkRegion
+  {
+    // How many bytes were written to the buffer before this region
+    size_t offset;
+    const u8* data;
+    u32 size;
+  };
+
   u8** ptr;
   Mode mode;
 
@@ -56,6 +67,19 @@ public:
   PointerWrap(u8** ptr_, Mode mode_) : ptr(ptr_), mode(mode_) {}
   void SetMode(Mode mode_) { mode = mode_; }
   Mode GetMode() const { return mode; }
+
+  // In MODE_WRITE, switches to MODE_MEASURE instead of writing past end. *ptr keeps advancing as
+  // usual, so in a single pass the caller either gets the data or learns how much space it needs.
+  void SetWriteEnd(const u8* end) { m_write_end = reinterpret_cast<uintptr_t>(end); }
+
+  // Makes DoBulkArray add its arrays to regions instead of copying them in MODE_WRITE (and skip
+  // them in MODE_MEASURE). The output then only is complete together with the regions, which
+  // point into the saved objects and so are only valid as long as those aren't modified.
+  void SetBulkRegions(std::vector<BulkRegion>* regions)
+  {
+    m_bulk_regions = regions;
+    m_bulk_base = *ptr;
+  }
   template <typename K, class V>
   void Do(std::map<K, V>& x)
   {
@@ -200,6 +224,35 @@ public:
     DoArray(arr, static_cast<u32>(N));
   }
 
+  // Only saves the given pages of an array, and on load only overwrites the pages that were saved.
+  // Used for delta savestates, which skip memory that hasn't changed since the previous state.
+  void DoArrayPages(u8* data, u32 size, u32 page_size, std::vector<u32> pages)
+  {
+    Do(page_size);
+    Do(pages);
+    for (const u32 page : pages)
+    {
+      const u64 offset = u64(page) * page_size;
+      if (offset >= size)
+      {
+        // Can only happen when loading a state which doesn't match the current memory size
+        mode = MODE_MEASURE;
+        return;
+      }
+      DoVoid(data + offset, static_cast<u32>(std::min<u64>(page_size, size - offset)));
+    }
+  }
+
+  // Like DoArray, for large arrays that live at least as long as the output is used, such as
+  // emulated memory. See SetBulkRegions.
+  void DoBulkArray(u8* data, u32 size)
+  {
+    if (m_bulk_regions && (mode == MODE_WRITE || mode == MODE_MEASURE))
+      m_bulk_regions->push_back({static_cast<size_t>(*ptr - m_bulk_base), data, size});
+    else
+      DoVoid(data, size);
+  }
+
   void Do(Common::Flag& flag)
   {
     bool s = flag.IsSet();
@@ -313,6 +366,11 @@ private:
       break;
 
     case MODE_WRITE:
+      if (reinterpret_cast<uintptr_t>(*ptr) + size > m_write_end)
+      {
+        mode = MODE_MEASURE;
+        break;
+      }
       memcpy(*ptr, data, size);
       break;
 
@@ -328,4 +386,8 @@ private:
 
     *ptr += size;
   }
+
+  uintptr_t m_write_end = UINTPTR_MAX;
+  std::vector<BulkRegion>* m_bulk_regions = nullptr;
+  u8* m_bulk_base = nullptr;
 };
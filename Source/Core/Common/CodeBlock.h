@@ -10,6 +10,7 @@
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
 #include "Common/MemoryUtil.h"
+#include "Common/Thread.h"
 
 namespace Common
 {
@@ -55,6 +56,7 @@ public:
     region_size = size;
     total_region_size = size;
     region = static_cast<u8*>(Common::AllocateExecutableMemory(total_region_size));
+    Common::BindMemoryToEmulationNode(region, total_region_size);
     T::SetCodePtr(region, region + size);
   }
 
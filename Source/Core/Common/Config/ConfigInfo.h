@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstring>
 #include <mutex>
 #include <shared_mutex>
 #include <string>
@@ -67,7 +69,7 @@ public:
   {
     m_location = other.GetLocation();
     m_default_value = other.GetDefaultValue();
-    m_cached_value = other.GetCachedValue();
+    StoreCachedValue(other.GetCachedValue(), false);
     return *this;
   }
 
@@ -76,7 +78,7 @@ public:
   {
     m_location = std::move(other.m_location);
     m_default_value = std::move(other.m_default_value);
-    m_cached_value = std::move(other.m_cached_value);
+    StoreCachedValue(other.GetCachedValue(), false);
     return *this;
   }
 
@@ -88,7 +90,7 @@ public:
   {
     m_location = other.GetLocation();
     m_default_value = static_cast<T>(other.GetDefaultValue());
-    m_cached_value = other.template GetCachedValueCasted<T>();
+    StoreCachedValue(other.template GetCachedValueCasted<T>(), false);
     return *this;
   }
 
@@ -97,29 +99,93 @@ public:
 
   CachedValue<T> GetCachedValue() const
   {
-    std::shared_lock lock(m_cached_value_mutex);
-    return m_cached_value;
+    if constexpr (LOCK_FREE_CACHE)
+    {
+      u32 sequence;
+      u64 bits;
+      u64 version;
+      do
+      {
+        sequence = m_cached_sequence.load(std::memory_order_acquire);
+        bits = m_cached_bits.load(std::memory_order_relaxed);
+        version = m_cached_version.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+      } while ((sequence & 1) != 0 ||
+               m_cached_sequence.load(std::memory_order_relaxed) != sequence);
+
+      // Nothing has been cached yet, which leaves the bits of the default value unset, since they
+      // can't be computed in a constexpr constructor.
+      if (version == 0)
+        return {m_default_value, 0};
+
+      T value{};
+      std::memcpy(&value, &bits, sizeof(T));
+      return {value, version};
+    }
+    else
+    {
+      std::shared_lock lock(m_cached_value_mutex);
+      return m_cached_value;
+    }
   }
 
   template <typename U>
   CachedValue<U> GetCachedValueCasted() const
   {
-    std::shared_lock lock(m_cached_value_mutex);
-    return CachedValue<U>{static_cast<U>(m_cached_value.value), m_cached_value.config_version};
+    const CachedValue<T> cached_value = GetCachedValue();
+    return CachedValue<U>{static_cast<U>(cached_value.value), cached_value.config_version};
   }
 
   void SetCachedValue(const CachedValue<T>& cached_value) const
   {
-    std::unique_lock lock(m_cached_value_mutex);
-    if (m_cached_value.config_version < cached_value.config_version)
-      m_cached_value = cached_value;
+    StoreCachedValue(cached_value, true);
   }
 
 private:
+  // Values that fit into 64 bits are cached in atomics behind a sequence lock instead of behind
+  // m_cached_value_mutex. Reading them then doesn't write to memory shared with other threads,
+  // which even taking a shared lock does, and which hurts for settings that the CPU and video
+  // threads read every frame or every draw.
+  static constexpr bool LOCK_FREE_CACHE =
+      std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(u64);
+
+  void StoreCachedValue(const CachedValue<T>& cached_value, bool only_if_newer) const
+  {
+    std::unique_lock lock(m_cached_value_mutex);
+    if constexpr (LOCK_FREE_CACHE)
+    {
+      if (only_if_newer &&
+          m_cached_version.load(std::memory_order_relaxed) >= cached_value.config_version)
+      {
+        return;
+      }
+
+      u64 bits = 0;
+      std::memcpy(&bits, &cached_value.value, sizeof(T));
+
+      const u32 sequence = m_cached_sequence.load(std::memory_order_relaxed);
+      m_cached_sequence.store(sequence + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      m_cached_bits.store(bits, std::memory_order_relaxed);
+      m_cached_version.store(cached_value.config_version, std::memory_order_relaxed);
+      m_cached_sequence.store(sequence + 2, std::memory_order_release);
+    }
+    else
+    {
+      if (!only_if_newer || m_cached_value.config_version < cached_value.config_version)
+        m_cached_value = cached_value;
+    }
+  }
+
   Location m_location;
   T m_default_value;
 
   mutable CachedValue<T> m_cached_value;
+  // Guards m_cached_value, and serializes writers to the atomics below
   mutable std::shared_mutex m_cached_value_mutex;
+
+  mutable std::atomic<u32> m_cached_sequence{0};
+  mutable std::atomic<u64> m_cached_bits{0};
+  mutable std::atomic<u64> m_cached_version{0};
 };
 }  // namespace Config
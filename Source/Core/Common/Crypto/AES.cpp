@@ -2,24 +2,34 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <array>
+#include <cstring>
+#include <memory>
+#include <utility>
+
 #include <mbedtls/aes.h>
 
+#include "Common/CPUDetect.h"
 #include "Common/Crypto/AES.h"
+#include "Common/Intrinsics.h"
+
+#ifdef _M_ARM_64
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
 
 namespace Common::AES
 {
 std::vector<u8> DecryptEncrypt(const u8* key, u8* iv, const u8* src, size_t size, Mode mode)
 {
-  mbedtls_aes_context aes_ctx;
+  std::unique_ptr<Context> context =
+      mode == Mode::Encrypt ? CreateContextEncrypt(key) : CreateContextDecrypt(key);
   std::vector<u8> buffer(size);
 
-  if (mode == Mode::Encrypt)
-    mbedtls_aes_setkey_enc(&aes_ctx, key, 128);
-  else
-    mbedtls_aes_setkey_dec(&aes_ctx, key, 128);
-
-  mbedtls_aes_crypt_cbc(&aes_ctx, mode == Mode::Encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT,
-                        size, iv, src, buffer.data());
+  context->Crypt(iv, iv, src, buffer.data(), size);
 
   return buffer;
 }
@@ -33,4 +43,336 @@ std::vector<u8> Encrypt(const u8* key, u8* iv, const u8* src, size_t size)
 {
   return DecryptEncrypt(key, iv, src, size, Mode::Encrypt);
 }
+
+bool Context::CryptMultiple(const CryptJob* jobs, size_t count) const
+{
+  bool success = true;
+  for (size_t i = 0; i < count; ++i)
+    success &= Crypt(jobs[i].iv, nullptr, jobs[i].buf_in, jobs[i].buf_out, jobs[i].len);
+  return success;
+}
+
+namespace
+{
+constexpr size_t NUM_ROUND_KEYS = 11;
+
+template <Mode AesMode>
+class ContextGeneric final : public Context
+{
+public:
+  explicit ContextGeneric(const u8* key)
+  {
+    mbedtls_aes_init(&m_context);
+    if constexpr (AesMode == Mode::Encrypt)
+      mbedtls_aes_setkey_enc(&m_context, key, 128);
+    else
+      mbedtls_aes_setkey_dec(&m_context, key, 128);
+  }
+
+  ~ContextGeneric() override { mbedtls_aes_free(&m_context); }
+
+  bool Crypt(const u8* iv, u8* iv_out, const u8* buf_in, u8* buf_out, size_t len) const override
+  {
+    std::array<u8, BLOCK_SIZE> iv_tmp;
+    std::memcpy(iv_tmp.data(), iv, BLOCK_SIZE);
+
+    constexpr int mbedtls_mode =
+        AesMode == Mode::Encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT;
+    // mbedtls_aes_crypt_cbc takes a non-const context even though it doesn't modify it
+    if (mbedtls_aes_crypt_cbc(const_cast<mbedtls_aes_context*>(&m_context), mbedtls_mode, len,
+                              iv_tmp.data(), buf_in, buf_out))
+    {
+      return false;
+    }
+
+    if (iv_out)
+      std::memcpy(iv_out, iv_tmp.data(), BLOCK_SIZE);
+    return true;
+  }
+
+private:
+  mbedtls_aes_context m_context;
+};
+
+// The hardware implementations reuse the key schedule computed by mbedtls. mbedtls stores round
+// keys as little endian words, so in memory they are in the byte order that both AES-NI and the
+// ARMv8 Crypto Extensions expect. The decryption schedule is the equivalent inverse cipher one,
+// which is what AESDEC and AESD+AESIMC need.
+template <Mode AesMode>
+std::array<std::array<u8, BLOCK_SIZE>, NUM_ROUND_KEYS> GetRoundKeys(const u8* key)
+{
+  mbedtls_aes_context context;
+  mbedtls_aes_init(&context);
+  if constexpr (AesMode == Mode::Encrypt)
+    mbedtls_aes_setkey_enc(&context, key, 128);
+  else
+    mbedtls_aes_setkey_dec(&context, key, 128);
+
+  std::array<std::array<u8, BLOCK_SIZE>, NUM_ROUND_KEYS> round_keys;
+  std::memcpy(round_keys.data(), context.rk, sizeof(round_keys));
+  mbedtls_aes_free(&context);
+  return round_keys;
+}
+
+#if defined(_M_X86_64)
+
+template <Mode AesMode>
+class ContextAESNI final : public Context
+{
+public:
+  explicit ContextAESNI(const u8* key)
+  {
+    const auto round_keys = GetRoundKeys<AesMode>(key);
+    for (size_t i = 0; i < NUM_ROUND_KEYS; ++i)
+      m_round_keys[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(round_keys[i].data()));
+  }
+
+  bool Crypt(const u8* iv, u8* iv_out, const u8* buf_in, u8* buf_out, size_t len) const override
+  {
+    if (len % BLOCK_SIZE)
+      return false;
+
+    if constexpr (AesMode == Mode::Encrypt)
+      EncryptCBC(iv, iv_out, buf_in, buf_out, len / BLOCK_SIZE);
+    else
+      DecryptCBC(iv, iv_out, buf_in, buf_out, len / BLOCK_SIZE);
+    return true;
+  }
+
+  bool CryptMultiple(const CryptJob* jobs, size_t count) const override
+  {
+    // Decryption is already pipelined within each stream
+    if constexpr (AesMode == Mode::Decrypt)
+      return Context::CryptMultiple(jobs, count);
+
+    size_t i = 0;
+    for (; i + ENCRYPT_LANES <= count; i += ENCRYPT_LANES)
+    {
+      const CryptJob* lanes = &jobs[i];
+      bool same_len = true;
+      for (size_t j = 0; j < ENCRYPT_LANES; ++j)
+        same_len &= lanes[j].len == lanes[0].len && lanes[j].len % BLOCK_SIZE == 0;
+
+      if (same_len)
+      {
+        EncryptCBCMultiple(lanes, lanes[0].len / BLOCK_SIZE,
+                           std::make_index_sequence<ENCRYPT_LANES>());
+      }
+      else if (!Context::CryptMultiple(lanes, ENCRYPT_LANES))
+      {
+        return false;
+      }
+    }
+    return Context::CryptMultiple(&jobs[i], count - i);
+  }
+
+private:
+  static constexpr size_t DECRYPT_LANES = 8;
+  static constexpr size_t ENCRYPT_LANES = 4;
+
+  FUNCTION_TARGET_AES void EncryptCBC(const u8* iv, u8* iv_out, const u8* buf_in, u8* buf_out,
+                                      size_t blocks) const
+  {
+    __m128i chain = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+    for (size_t i = 0; i < blocks; ++i)
+    {
+      const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf_in) + i);
+      chain = _mm_xor_si128(_mm_xor_si128(data, chain), m_round_keys[0]);
+      for (size_t r = 1; r < NUM_ROUND_KEYS - 1; ++r)
+        chain = _mm_aesenc_si128(chain, m_round_keys[r]);
+      chain = _mm_aesenclast_si128(chain, m_round_keys[NUM_ROUND_KEYS - 1]);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(buf_out) + i, chain);
+    }
+    if (iv_out)
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(iv_out), chain);
+  }
+
+  // The lanes are expanded from parameter packs so that they stay in registers and the AES
+  // instructions of different lanes are interleaved, even without loop unrolling.
+  template <size_t... J>
+  FUNCTION_TARGET_AES void EncryptCBCMultiple(const CryptJob* jobs, size_t blocks,
+                                              std::index_sequence<J...>) const
+  {
+    __m128i chain[] = {_mm_loadu_si128(reinterpret_cast<const __m128i*>(jobs[J].iv))...};
+
+    for (size_t i = 0; i < blocks; ++i)
+    {
+      ((chain[J] = _mm_xor_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(jobs[J].buf_in) + i),
+            _mm_xor_si128(chain[J], m_round_keys[0]))),
+       ...);
+      for (size_t r = 1; r < NUM_ROUND_KEYS - 1; ++r)
+        ((chain[J] = _mm_aesenc_si128(chain[J], m_round_keys[r])), ...);
+      ((chain[J] = _mm_aesenclast_si128(chain[J], m_round_keys[NUM_ROUND_KEYS - 1])), ...);
+      (_mm_storeu_si128(reinterpret_cast<__m128i*>(jobs[J].buf_out) + i, chain[J]), ...);
+    }
+  }
+
+  // prev[0] is the IV of this group of blocks and prev[J + 1] is ciphertext block J
+  template <size_t... J>
+  FUNCTION_TARGET_AES __m128i DecryptCBCLanes(const __m128i* in, __m128i* out, __m128i chain,
+                                               std::index_sequence<J...>) const
+  {
+    const __m128i prev[] = {chain, _mm_loadu_si128(in + J)...};
+    __m128i data[] = {_mm_xor_si128(prev[J + 1], m_round_keys[0])...};
+    for (size_t r = 1; r < NUM_ROUND_KEYS - 1; ++r)
+      ((data[J] = _mm_aesdec_si128(data[J], m_round_keys[r])), ...);
+    ((data[J] = _mm_aesdeclast_si128(data[J], m_round_keys[NUM_ROUND_KEYS - 1])), ...);
+    (_mm_storeu_si128(out + J, _mm_xor_si128(data[J], prev[J])), ...);
+    return prev[sizeof...(J)];
+  }
+
+  FUNCTION_TARGET_AES void DecryptCBC(const u8* iv, u8* iv_out, const u8* buf_in, u8* buf_out,
+                                      size_t blocks) const
+  {
+    const __m128i* in = reinterpret_cast<const __m128i*>(buf_in);
+    __m128i* out = reinterpret_cast<__m128i*>(buf_out);
+    __m128i chain = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+
+    // Unlike encryption, CBC decryption has no dependency between blocks, so several blocks are
+    // kept in flight to hide the latency of AESDEC.
+    size_t i = 0;
+    for (; i + DECRYPT_LANES <= blocks; i += DECRYPT_LANES)
+      chain = DecryptCBCLanes(in + i, out + i, chain, std::make_index_sequence<DECRYPT_LANES>());
+
+    for (; i < blocks; ++i)
+    {
+      const __m128i cipher = _mm_loadu_si128(in + i);
+      __m128i data = _mm_xor_si128(cipher, m_round_keys[0]);
+      for (size_t r = 1; r < NUM_ROUND_KEYS - 1; ++r)
+        data = _mm_aesdec_si128(data, m_round_keys[r]);
+      data = _mm_aesdeclast_si128(data, m_round_keys[NUM_ROUND_KEYS - 1]);
+      _mm_storeu_si128(out + i, _mm_xor_si128(data, chain));
+      chain = cipher;
+    }
+
+    if (iv_out)
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(iv_out), chain);
+  }
+
+  __m128i m_round_keys[NUM_ROUND_KEYS];
+};
+
+#elif defined(_M_ARM_64)
+
+template <Mode AesMode>
+class ContextNEON final : public Context
+{
+public:
+  explicit ContextNEON(const u8* key)
+  {
+    const auto round_keys = GetRoundKeys<AesMode>(key);
+    for (size_t i = 0; i < NUM_ROUND_KEYS; ++i)
+      m_round_keys[i] = vld1q_u8(round_keys[i].data());
+  }
+
+  bool Crypt(const u8* iv, u8* iv_out, const u8* buf_in, u8* buf_out, size_t len) const override
+  {
+    if (len % BLOCK_SIZE)
+      return false;
+
+    if constexpr (AesMode == Mode::Encrypt)
+      EncryptCBC(iv, iv_out, buf_in, buf_out, len / BLOCK_SIZE);
+    else
+      DecryptCBC(iv, iv_out, buf_in, buf_out, len / BLOCK_SIZE);
+    return true;
+  }
+
+private:
+  static constexpr size_t DECRYPT_LANES = 8;
+
+  // AESE/AESD include the AddRoundKey step, so the last round key is applied separately
+  uint8x16_t EncryptBlock(uint8x16_t data) const
+  {
+    for (size_t r = 0; r < NUM_ROUND_KEYS - 2; ++r)
+      data = vaesmcq_u8(vaeseq_u8(data, m_round_keys[r]));
+    data = vaeseq_u8(data, m_round_keys[NUM_ROUND_KEYS - 2]);
+    return veorq_u8(data, m_round_keys[NUM_ROUND_KEYS - 1]);
+  }
+
+  uint8x16_t DecryptBlock(uint8x16_t data) const
+  {
+    for (size_t r = 0; r < NUM_ROUND_KEYS - 2; ++r)
+      data = vaesimcq_u8(vaesdq_u8(data, m_round_keys[r]));
+    data = vaesdq_u8(data, m_round_keys[NUM_ROUND_KEYS - 2]);
+    return veorq_u8(data, m_round_keys[NUM_ROUND_KEYS - 1]);
+  }
+
+  void EncryptCBC(const u8* iv, u8* iv_out, const u8* buf_in, u8* buf_out, size_t blocks) const
+  {
+    uint8x16_t chain = vld1q_u8(iv);
+    for (size_t i = 0; i < blocks; ++i)
+    {
+      chain = EncryptBlock(veorq_u8(vld1q_u8(buf_in + i * BLOCK_SIZE), chain));
+      vst1q_u8(buf_out + i * BLOCK_SIZE, chain);
+    }
+    if (iv_out)
+      vst1q_u8(iv_out, chain);
+  }
+
+  // prev[0] is the IV of this group of blocks and prev[J + 1] is ciphertext block J
+  template <size_t... J>
+  uint8x16_t DecryptCBCLanes(const u8* in, u8* out, uint8x16_t chain,
+                             std::index_sequence<J...>) const
+  {
+    const uint8x16_t prev[] = {chain, vld1q_u8(in + J * BLOCK_SIZE)...};
+    uint8x16_t data[] = {prev[J + 1]...};
+    for (size_t r = 0; r < NUM_ROUND_KEYS - 2; ++r)
+      ((data[J] = vaesimcq_u8(vaesdq_u8(data[J], m_round_keys[r]))), ...);
+    ((data[J] = vaesdq_u8(data[J], m_round_keys[NUM_ROUND_KEYS - 2])), ...);
+    ((data[J] = veorq_u8(data[J], m_round_keys[NUM_ROUND_KEYS - 1])), ...);
+    (vst1q_u8(out + J * BLOCK_SIZE, veorq_u8(data[J], prev[J])), ...);
+    return prev[sizeof...(J)];
+  }
+
+  void DecryptCBC(const u8* iv, u8* iv_out, const u8* buf_in, u8* buf_out, size_t blocks) const
+  {
+    uint8x16_t chain = vld1q_u8(iv);
+
+    size_t i = 0;
+    for (; i + DECRYPT_LANES <= blocks; i += DECRYPT_LANES)
+    {
+      chain = DecryptCBCLanes(buf_in + i * BLOCK_SIZE, buf_out + i * BLOCK_SIZE, chain,
+                              std::make_index_sequence<DECRYPT_LANES>());
+    }
+
+    for (; i < blocks; ++i)
+    {
+      const uint8x16_t cipher = vld1q_u8(buf_in + i * BLOCK_SIZE);
+      vst1q_u8(buf_out + i * BLOCK_SIZE, veorq_u8(DecryptBlock(cipher), chain));
+      chain = cipher;
+    }
+
+    if (iv_out)
+      vst1q_u8(iv_out, chain);
+  }
+
+  uint8x16_t m_round_keys[NUM_ROUND_KEYS];
+};
+
+#endif
+
+template <Mode AesMode>
+std::unique_ptr<Context> CreateContext(const u8* key)
+{
+#if defined(_M_X86_64)
+  if (cpu_info.bAES)
+    return std::make_unique<ContextAESNI<AesMode>>(key);
+#elif defined(_M_ARM_64)
+  if (cpu_info.bAES)
+    return std::make_unique<ContextNEON<AesMode>>(key);
+#endif
+  return std::make_unique<ContextGeneric<AesMode>>(key);
+}
+}  // namespace
+
+std::unique_ptr<Context> CreateContextEncrypt(const u8* key)
+{
+  return CreateContext<Mode::Encrypt>(key);
+}
+
+std::unique_ptr<Context> CreateContextDecrypt(const u8* key)
+{
+  return CreateContext<Mode::Decrypt>(key);
+}
 }  // namespace Common::AES
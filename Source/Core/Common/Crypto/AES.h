@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -21,4 +22,36 @@ std::vector<u8> DecryptEncrypt(const u8* key, u8* iv, const u8* src, size_t size
 // Convenience functions
 std::vector<u8> Decrypt(const u8* key, u8* iv, const u8* src, size_t size);
 std::vector<u8> Encrypt(const u8* key, u8* iv, const u8* src, size_t size);
+
+constexpr size_t BLOCK_SIZE = 16;
+
+// One independent AES-128-CBC stream for Context::CryptMultiple.
+struct CryptJob
+{
+  const u8* iv;
+  const u8* buf_in;
+  u8* buf_out;
+  size_t len;
+};
+
+// An expanded AES-128 key which runs CBC mode on AES-NI or ARMv8 Crypto Extensions when the host
+// supports them, and on mbedtls otherwise. The implementation is picked when the context is made.
+class Context
+{
+public:
+  virtual ~Context() = default;
+
+  // len must be a multiple of BLOCK_SIZE. iv_out (which may be equal to iv) receives the IV for
+  // continuing the stream, and may be null. buf_in and buf_out may be equal, but may not overlap
+  // otherwise.
+  virtual bool Crypt(const u8* iv, u8* iv_out, const u8* buf_in, u8* buf_out,
+                     size_t len) const = 0;
+
+  // Processes several independent streams. CBC encryption cannot be pipelined within one stream,
+  // so hardware implementations interleave the streams instead.
+  virtual bool CryptMultiple(const CryptJob* jobs, size_t count) const;
+};
+
+std::unique_ptr<Context> CreateContextEncrypt(const u8* key);
+std::unique_ptr<Context> CreateContextDecrypt(const u8* key);
 }  // namespace Common::AES
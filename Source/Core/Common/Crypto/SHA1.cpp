@@ -0,0 +1,428 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/Crypto/SHA1.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#include <mbedtls/sha1.h>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
+#include "Common/Swap.h"
+
+#ifdef _M_ARM_64
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace Common::SHA1
+{
+namespace
+{
+constexpr size_t BLOCK_LEN = 64;
+
+using State = std::array<u32, 5>;
+constexpr State INITIAL_STATE = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+class ContextMbed final : public Context
+{
+public:
+  ContextMbed()
+  {
+    mbedtls_sha1_init(&m_context);
+    mbedtls_sha1_starts_ret(&m_context);
+  }
+  ~ContextMbed() override { mbedtls_sha1_free(&m_context); }
+
+  void Update(const u8* msg, size_t len) override { mbedtls_sha1_update_ret(&m_context, msg, len); }
+
+  Digest Finish() override
+  {
+    Digest digest;
+    mbedtls_sha1_finish_ret(&m_context, digest.data());
+    return digest;
+  }
+
+private:
+  mbedtls_sha1_context m_context;
+};
+
+Digest StateToDigest(const State& state)
+{
+  Digest digest;
+  for (size_t i = 0; i < state.size(); ++i)
+  {
+    const u32 word = Common::swap32(state[i]);
+    std::memcpy(digest.data() + i * sizeof(u32), &word, sizeof(u32));
+  }
+  return digest;
+}
+
+// Writes the padding and length of a message that is len bytes long, where tail holds the
+// len % BLOCK_LEN bytes after its last whole block. Returns the number of blocks written to out.
+size_t PadTail(const u8* tail, size_t len, std::array<u8, BLOCK_LEN * 2>* out)
+{
+  const size_t tail_len = len % BLOCK_LEN;
+  const size_t blocks = tail_len + 1 + sizeof(u64) > BLOCK_LEN ? 2 : 1;
+
+  out->fill(0);
+  std::memcpy(out->data(), tail, tail_len);
+  (*out)[tail_len] = 0x80;
+  const u64 bit_len = Common::swap64(static_cast<u64>(len) * 8);
+  std::memcpy(out->data() + blocks * BLOCK_LEN - sizeof(u64), &bit_len, sizeof(u64));
+  return blocks;
+}
+
+// Impl::Compress<N> runs the compression function over num_blocks blocks of N independent
+// messages at once.
+template <typename Impl>
+class BlockContext final : public Context
+{
+public:
+  void Update(const u8* msg, size_t len) override
+  {
+    m_len += len;
+
+    if (m_buffer_used != 0)
+    {
+      const size_t copy_len = std::min(len, BLOCK_LEN - m_buffer_used);
+      std::memcpy(m_buffer.data() + m_buffer_used, msg, copy_len);
+      m_buffer_used += copy_len;
+      msg += copy_len;
+      len -= copy_len;
+
+      if (m_buffer_used != BLOCK_LEN)
+        return;
+
+      Compress(m_buffer.data(), 1);
+      m_buffer_used = 0;
+    }
+
+    Compress(msg, len / BLOCK_LEN);
+    msg += len / BLOCK_LEN * BLOCK_LEN;
+
+    m_buffer_used = len % BLOCK_LEN;
+    std::memcpy(m_buffer.data(), msg, m_buffer_used);
+  }
+
+  Digest Finish() override
+  {
+    std::array<u8, BLOCK_LEN * 2> tail;
+    Compress(tail.data(), PadTail(m_buffer.data(), m_len, &tail));
+    return StateToDigest(m_state);
+  }
+
+private:
+  void Compress(const u8* blocks, size_t num_blocks)
+  {
+    if (num_blocks == 0)
+      return;
+
+    std::array<State*, 1> state{&m_state};
+    Impl::template Compress<1>(state, {blocks}, num_blocks);
+  }
+
+  State m_state = INITIAL_STATE;
+  std::array<u8, BLOCK_LEN> m_buffer;
+  size_t m_buffer_used = 0;
+  u64 m_len = 0;
+};
+
+template <typename Impl, size_t N>
+void CalculateDigestsLockstep(const u8* msgs, size_t len, u8* digests_out)
+{
+  std::array<State, N> states;
+  std::array<State*, N> state_ptrs;
+  std::array<const u8*, N> data;
+  for (size_t i = 0; i < N; ++i)
+  {
+    states[i] = INITIAL_STATE;
+    state_ptrs[i] = &states[i];
+    data[i] = msgs + i * len;
+  }
+
+  if (len >= BLOCK_LEN)
+    Impl::template Compress<N>(state_ptrs, data, len / BLOCK_LEN);
+
+  // All messages have the same length, so their padding takes up the same number of blocks
+  std::array<std::array<u8, BLOCK_LEN * 2>, N> tails;
+  size_t tail_blocks = 0;
+  for (size_t i = 0; i < N; ++i)
+  {
+    tail_blocks = PadTail(data[i] + len / BLOCK_LEN * BLOCK_LEN, len, &tails[i]);
+    data[i] = tails[i].data();
+  }
+  Impl::template Compress<N>(state_ptrs, data, tail_blocks);
+
+  for (size_t i = 0; i < N; ++i)
+    std::memcpy(digests_out + i * DIGEST_LEN, StateToDigest(states[i]).data(), DIGEST_LEN);
+}
+
+template <typename Impl>
+void CalculateDigestsImpl(const u8* msgs, size_t len, size_t count, u8* digests_out)
+{
+  constexpr size_t lanes = Impl::LANES;
+
+  size_t i = 0;
+  for (; i + lanes <= count; i += lanes)
+    CalculateDigestsLockstep<Impl, lanes>(msgs + i * len, len, digests_out + i * DIGEST_LEN);
+  for (; i < count; ++i)
+    CalculateDigestsLockstep<Impl, 1>(msgs + i * len, len, digests_out + i * DIGEST_LEN);
+}
+
+#if defined(_M_X86_64)
+
+struct ImplSHANI
+{
+  // SHA1RNDS4 has a latency of several cycles, so two messages are enough to keep it busy
+  static constexpr size_t LANES = 2;
+
+  template <size_t N>
+  struct Lanes
+  {
+    __m128i abcd[N];
+    __m128i e[N];
+    __m128i prev_abcd[N];
+    __m128i w[N][4];
+    const u8* data[N];
+  };
+
+  // Runs rounds G * 4 to G * 4 + 3 on each lane. w keeps the last four groups of message words.
+  template <size_t G, size_t N>
+  FUNCTION_TARGET_SHA static inline void RoundGroup(Lanes<N>& s)
+  {
+    const __m128i bswap_mask = _mm_set_epi64x(0x0001020304050607, 0x08090a0b0c0d0e0f);
+
+    for (size_t l = 0; l < N; ++l)
+    {
+      __m128i w;
+      if constexpr (G < 4)
+      {
+        w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s.data[l] + G * 16));
+        w = _mm_shuffle_epi8(w, bswap_mask);
+      }
+      else
+      {
+        w = _mm_sha1msg1_epu32(s.w[l][G % 4], s.w[l][(G + 1) % 4]);
+        w = _mm_xor_si128(w, s.w[l][(G + 2) % 4]);
+        w = _mm_sha1msg2_epu32(w, s.w[l][(G + 3) % 4]);
+      }
+      s.w[l][G % 4] = w;
+
+      __m128i e;
+      if constexpr (G == 0)
+        e = _mm_add_epi32(s.e[l], w);
+      else
+        e = _mm_sha1nexte_epu32(s.prev_abcd[l], w);
+
+      s.prev_abcd[l] = s.abcd[l];
+      s.abcd[l] = _mm_sha1rnds4_epu32(s.abcd[l], e, G / 5);
+    }
+  }
+
+  template <size_t N, size_t... G>
+  FUNCTION_TARGET_SHA static inline void Rounds(Lanes<N>& s, std::index_sequence<G...>)
+  {
+    (RoundGroup<G>(s), ...);
+  }
+
+  template <size_t N>
+  FUNCTION_TARGET_SHA static void Compress(const std::array<State*, N>& states,
+                                           std::array<const u8*, N> data, size_t num_blocks)
+  {
+    Lanes<N> s;
+    for (size_t l = 0; l < N; ++l)
+    {
+      const __m128i abcd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(states[l]->data()));
+      s.abcd[l] = _mm_shuffle_epi32(abcd, 0x1B);
+      s.e[l] = _mm_set_epi32((*states[l])[4], 0, 0, 0);
+    }
+
+    for (size_t block = 0; block < num_blocks; ++block)
+    {
+      __m128i abcd_save[N];
+      __m128i e_save[N];
+      for (size_t l = 0; l < N; ++l)
+      {
+        abcd_save[l] = s.abcd[l];
+        e_save[l] = s.e[l];
+        s.data[l] = data[l] + block * BLOCK_LEN;
+      }
+
+      Rounds(s, std::make_index_sequence<20>());
+
+      for (size_t l = 0; l < N; ++l)
+      {
+        s.e[l] = _mm_sha1nexte_epu32(s.prev_abcd[l], e_save[l]);
+        s.abcd[l] = _mm_add_epi32(s.abcd[l], abcd_save[l]);
+      }
+    }
+
+    for (size_t l = 0; l < N; ++l)
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(states[l]->data()),
+                       _mm_shuffle_epi32(s.abcd[l], 0x1B));
+      (*states[l])[4] = _mm_extract_epi32(s.e[l], 3);
+    }
+  }
+};
+
+bool HasHardwareSupport()
+{
+  return cpu_info.bSHA1 && cpu_info.bSSE4_1;
+}
+
+using ImplHW = ImplSHANI;
+
+#elif defined(_M_ARM_64)
+
+struct ImplNEON
+{
+  static constexpr size_t LANES = 2;
+
+  template <size_t N>
+  struct Lanes
+  {
+    uint32x4_t abcd[N];
+    u32 e[N];
+    uint32x4_t w[N][4];
+    const u8* data[N];
+  };
+
+  template <size_t G, size_t N>
+  static inline void RoundGroup(Lanes<N>& s)
+  {
+    constexpr u32 K[] = {0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6};
+
+    for (size_t l = 0; l < N; ++l)
+    {
+      uint32x4_t w;
+      if constexpr (G < 4)
+      {
+        w = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(s.data[l] + G * 16)));
+      }
+      else
+      {
+        w = vsha1su0q_u32(s.w[l][G % 4], s.w[l][(G + 1) % 4], s.w[l][(G + 2) % 4]);
+        w = vsha1su1q_u32(w, s.w[l][(G + 3) % 4]);
+      }
+      s.w[l][G % 4] = w;
+
+      const uint32x4_t wk = vaddq_u32(w, vdupq_n_u32(K[G / 5]));
+      const u32 e_next = vsha1h_u32(vgetq_lane_u32(s.abcd[l], 0));
+
+      if constexpr (G < 5)
+        s.abcd[l] = vsha1cq_u32(s.abcd[l], s.e[l], wk);
+      else if constexpr (G >= 10 && G < 15)
+        s.abcd[l] = vsha1mq_u32(s.abcd[l], s.e[l], wk);
+      else
+        s.abcd[l] = vsha1pq_u32(s.abcd[l], s.e[l], wk);
+
+      s.e[l] = e_next;
+    }
+  }
+
+  template <size_t N, size_t... G>
+  static inline void Rounds(Lanes<N>& s, std::index_sequence<G...>)
+  {
+    (RoundGroup<G>(s), ...);
+  }
+
+  template <size_t N>
+  static void Compress(const std::array<State*, N>& states, std::array<const u8*, N> data,
+                       size_t num_blocks)
+  {
+    Lanes<N> s;
+    for (size_t l = 0; l < N; ++l)
+    {
+      s.abcd[l] = vld1q_u32(states[l]->data());
+      s.e[l] = (*states[l])[4];
+    }
+
+    for (size_t block = 0; block < num_blocks; ++block)
+    {
+      uint32x4_t abcd_save[N];
+      u32 e_save[N];
+      for (size_t l = 0; l < N; ++l)
+      {
+        abcd_save[l] = s.abcd[l];
+        e_save[l] = s.e[l];
+        s.data[l] = data[l] + block * BLOCK_LEN;
+      }
+
+      Rounds(s, std::make_index_sequence<20>());
+
+      for (size_t l = 0; l < N; ++l)
+      {
+        s.abcd[l] = vaddq_u32(s.abcd[l], abcd_save[l]);
+        s.e[l] += e_save[l];
+      }
+    }
+
+    for (size_t l = 0; l < N; ++l)
+    {
+      vst1q_u32(states[l]->data(), s.abcd[l]);
+      (*states[l])[4] = s.e[l];
+    }
+  }
+};
+
+bool HasHardwareSupport()
+{
+  return cpu_info.bSHA1;
+}
+
+using ImplHW = ImplNEON;
+
+#endif
+}  // namespace
+
+std::unique_ptr<Context> CreateContext()
+{
+#if defined(_M_X86_64) || defined(_M_ARM_64)
+  if (HasHardwareSupport())
+    return std::make_unique<BlockContext<ImplHW>>();
+#endif
+  return std::make_unique<ContextMbed>();
+}
+
+Digest CalculateDigest(const u8* msg, size_t len)
+{
+#if defined(_M_X86_64) || defined(_M_ARM_64)
+  if (HasHardwareSupport())
+  {
+    Digest digest;
+    CalculateDigestsLockstep<ImplHW, 1>(msg, len, digest.data());
+    return digest;
+  }
+#endif
+
+  Digest digest;
+  mbedtls_sha1_ret(msg, len, digest.data());
+  return digest;
+}
+
+void CalculateDigests(const u8* msgs, size_t len, size_t count, u8* digests_out)
+{
+#if defined(_M_X86_64) || defined(_M_ARM_64)
+  if (HasHardwareSupport())
+  {
+    CalculateDigestsImpl<ImplHW>(msgs, len, count, digests_out);
+    return;
+  }
+#endif
+
+  for (size_t i = 0; i < count; ++i)
+    mbedtls_sha1_ret(msgs + i * len, len, digests_out + i * DIGEST_LEN);
+}
+}  // namespace Common::SHA1
@@ -0,0 +1,44 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace Common::SHA1
+{
+constexpr size_t DIGEST_LEN = 20;
+using Digest = std::array<u8, DIGEST_LEN>;
+
+// Uses the SHA extensions on x86-64 or the ARMv8 SHA1 instructions when the host supports them,
+// and mbedtls otherwise. The implementation is picked when the context is made.
+class Context
+{
+public:
+  virtual ~Context() = default;
+  virtual void Update(const u8* msg, size_t len) = 0;
+  void Update(const std::vector<u8>& msg) { Update(msg.data(), msg.size()); }
+  virtual Digest Finish() = 0;
+};
+
+std::unique_ptr<Context> CreateContext();
+
+Digest CalculateDigest(const u8* msg, size_t len);
+
+template <typename T>
+Digest CalculateDigest(const std::vector<T>& msg)
+{
+  return CalculateDigest(reinterpret_cast<const u8*>(msg.data()), sizeof(T) * msg.size());
+}
+
+// Hashes count messages of len bytes each, which are stored back to back starting at msgs.
+// The digests are written back to back starting at digests_out. With hardware support, several
+// messages are hashed in lockstep, which hides the latency of the SHA instructions.
+void CalculateDigests(const u8* msgs, size_t len, size_t count, u8* digests_out);
+}  // namespace Common::SHA1
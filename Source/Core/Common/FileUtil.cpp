@@ -109,6 +109,7 @@ void FileInfo::AndroidContentInit(const std::string& path)
   m_exists = result != -1;
   m_stat.st_mode = result == -2 ? S_IFDIR : S_IFREG;
   m_stat.st_size = result >= 0 ? result : 0;
+  m_stat.st_mtime = 0;
 }
 #endif
 
@@ -132,6 +133,11 @@ u64 FileInfo::GetSize() const
   return IsFile() ? m_stat.st_size : 0;
 }
 
+s64 FileInfo::GetModificationTime() const
+{
+  return m_exists ? static_cast<s64>(m_stat.st_mtime) : 0;
+}
+
 // Returns true if the path exists
 bool Exists(const std::string& path)
 {
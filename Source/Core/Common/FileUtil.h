@@ -112,6 +112,9 @@ public:
   bool IsFile() const;
   // Returns the size of a file (or returns 0 if the path doesn't refer to a file)
   u64 GetSize() const;
+  // Returns the last modification time in seconds since the epoch
+  // (or returns 0 if the path doesn't exist or the time isn't known)
+  s64 GetModificationTime() const;
 
 private:
 #ifdef ANDROID
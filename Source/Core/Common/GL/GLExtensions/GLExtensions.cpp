@@ -640,6 +640,7 @@ PFNDOLDRAWARRAYSINSTANCEDPROC dolDrawArraysInstanced;
 PFNDOLDRAWELEMENTSINSTANCEDPROC dolDrawElementsInstanced;
 PFNDOLPRIMITIVERESTARTINDEXPROC dolPrimitiveRestartIndex;
 PFNDOLTEXBUFFERPROC dolTexBuffer;
+PFNDOLCOPYBUFFERSUBDATAPROC dolCopyBufferSubData;
 
 // gl_3_2
 PFNDOLFRAMEBUFFERTEXTUREPROC dolFramebufferTexture;
@@ -892,6 +893,11 @@ PFNDOLGETSYNCIVPROC dolGetSynciv;
 PFNDOLISSYNCPROC dolIsSync;
 PFNDOLWAITSYNCPROC dolWaitSync;
 
+// ARB_timer_query
+PFNDOLQUERYCOUNTERPROC dolQueryCounter;
+PFNDOLGETQUERYOBJECTI64VPROC dolGetQueryObjecti64v;
+PFNDOLGETQUERYOBJECTUI64VPROC dolGetQueryObjectui64v;
+
 // ARB_texture_multisample
 PFNDOLTEXIMAGE2DMULTISAMPLEPROC dolTexImage2DMultisample;
 PFNDOLTEXIMAGE3DMULTISAMPLEPROC dolTexImage3DMultisample;
@@ -1664,6 +1670,7 @@ const GLFunc gl_function_array[] = {
     GLFUNC_REQUIRES(glDrawArraysInstanced, "VERSION_3_1 |VERSION_GLES_3"),
     GLFUNC_REQUIRES(glDrawElementsInstanced, "VERSION_3_1 |VERSION_GLES_3"),
     GLFUNC_REQUIRES(glTexBuffer, "VERSION_3_1 |VERSION_GLES_3_2"),
+    GLFUNC_REQUIRES(glCopyBufferSubData, "VERSION_3_1 |VERSION_GLES_3"),
 
     // gl_3_2
     GLFUNC_REQUIRES(glGetBufferParameteri64v, "VERSION_3_2 |VERSION_GLES_3"),
@@ -1951,6 +1958,11 @@ const GLFunc gl_function_array[] = {
     GLFUNC_REQUIRES(glIsSync, "GL_ARB_sync |VERSION_GLES_3"),
     GLFUNC_REQUIRES(glWaitSync, "GL_ARB_sync |VERSION_GLES_3"),
 
+    // ARB_timer_query
+    GLFUNC_REQUIRES(glQueryCounter, "GL_ARB_timer_query"),
+    GLFUNC_REQUIRES(glGetQueryObjecti64v, "GL_ARB_timer_query"),
+    GLFUNC_REQUIRES(glGetQueryObjectui64v, "GL_ARB_timer_query"),
+
     // ARB_texture_multisample
     GLFUNC_REQUIRES(glTexImage2DMultisample, "GL_ARB_texture_multisample"),
     GLFUNC_REQUIRES(glTexImage3DMultisample, "GL_ARB_texture_multisample"),
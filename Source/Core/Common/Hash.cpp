@@ -5,6 +5,7 @@
 #include "Common/Hash.h"
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include "Common/BitUtils.h"
 #include "Common/CPUDetect.h"
@@ -17,11 +18,13 @@
 #else
 #include <arm_acle.h>
 #endif
+#include <arm_neon.h>
 #endif
 
 namespace Common
 {
 static u64 (*ptrHashFunction)(const u8* src, u32 len, u32 samples) = nullptr;
+static u64 (*ptrFullHashFunction)(const u8* src, u32 len) = nullptr;
 
 // uint32_t
 // WARNING - may read one more byte!
@@ -505,14 +508,389 @@ static u64 GetMurmurHash3(const u8* src, u32 len, u32 samples)
 }
 #endif
 
+// Multiply-accumulate hash for hashing all of the input, in the style of XXH3's loop for long
+// inputs. The input is split into 64 byte stripes, which are accumulated into eight 64-bit lanes:
+// each word is xored with a key, and the product of the two halves of the result is added to the
+// lane together with the neighbouring word. The keys differ per stripe, and the lanes are
+// scrambled after every block of 16 stripes, so that reordering stripes changes the hash.
+constexpr u32 MAC_STRIPE_LENGTH = 64;
+constexpr u32 MAC_STRIPES_PER_BLOCK = 16;
+constexpr u32 MAC_BLOCK_LENGTH = MAC_STRIPE_LENGTH * MAC_STRIPES_PER_BLOCK;
+constexpr u64 MAC_PRIME32 = 0x9E3779B1;
+constexpr u64 MAC_PRIME64_1 = 0x9E3779B185EBCA87;
+constexpr u64 MAC_PRIME64_2 = 0xC2B2AE3D27D4EB4F;
+
+// Stripe n of a block uses the keys starting at n, the scrambling the ones after the last stripe,
+// and the final stripe the ones after that.
+alignas(32) constexpr u64 s_mac_keys[MAC_STRIPES_PER_BLOCK + 9] = {
+    0x3B7DE408E35D146C, 0x0080AB2C7FB9DCA6, 0x8FD447D7C89402D8, 0x412D056A6A8C24A6,
+    0x6AA23F6996F3167D, 0x36A7CCFF6EF8205D, 0x28F55C7FDF714DBA, 0x86C3DCAFF8457B08,
+    0x96E2CB141985ABCD, 0x7624AB21AA0E76C4, 0x5B28FC7D18657892, 0x61A4E917ACE0F1DC,
+    0x65A2C8C822FEEA2A, 0x15588EA04EBBD28A, 0x2096C46B48FA3751, 0x109530D23A8D53E0,
+    0x1A1F217B555E3A2C, 0xB77B12EBB5EA317B, 0xCA7C1922EB274D98, 0x9AA00188E0D9BE03,
+    0x48EFFA11B0C406F0, 0x9360AE51ED169962, 0x8007801F54DEFC89, 0x5F8903C225EEA552,
+    0x2D57B4715C43636B,
+};
+
+#if defined(_M_X86_64)
+
+static void AccumulateSSE2(u64* acc, const u8* data, u32 num_stripes, const u64* keys)
+{
+  // Keep the lanes in registers, the stores could otherwise alias the input.
+  __m128i xacc[4];
+  for (u32 i = 0; i < 4; ++i)
+    xacc[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(acc) + i);
+
+  for (u32 stripe = 0; stripe < num_stripes; ++stripe)
+  {
+    const u8* const stripe_data = data + stripe * MAC_STRIPE_LENGTH;
+    for (u32 i = 0; i < 4; ++i)
+    {
+      const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe_data) + i);
+      const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + stripe) + i);
+      const __m128i keyed = _mm_xor_si128(words, key);
+      const __m128i product =
+          _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+      const __m128i swapped = _mm_shuffle_epi32(words, _MM_SHUFFLE(1, 0, 3, 2));
+      xacc[i] = _mm_add_epi64(xacc[i], _mm_add_epi64(product, swapped));
+    }
+  }
+
+  for (u32 i = 0; i < 4; ++i)
+    _mm_store_si128(reinterpret_cast<__m128i*>(acc) + i, xacc[i]);
+}
+
+static void ScrambleSSE2(u64* acc, const u64* keys)
+{
+  __m128i* const xacc = reinterpret_cast<__m128i*>(acc);
+  const __m128i prime = _mm_set1_epi32(static_cast<int>(MAC_PRIME32));
+  for (u32 i = 0; i < 4; ++i)
+  {
+    __m128i value = _mm_xor_si128(xacc[i], _mm_srli_epi64(xacc[i], 47));
+    value = _mm_xor_si128(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys) + i));
+    const __m128i low = _mm_mul_epu32(value, prime);
+    const __m128i high = _mm_mul_epu32(_mm_srli_epi64(value, 32), prime);
+    xacc[i] = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void AccumulateAVX2(u64* acc, const u8* data, u32 num_stripes, const u64* keys)
+{
+  __m256i xacc[2];
+  for (u32 i = 0; i < 2; ++i)
+    xacc[i] = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc) + i);
+
+  for (u32 stripe = 0; stripe < num_stripes; ++stripe)
+  {
+    const u8* const stripe_data = data + stripe * MAC_STRIPE_LENGTH;
+    for (u32 i = 0; i < 2; ++i)
+    {
+      const __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stripe_data) + i);
+      const __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + stripe) + i);
+      const __m256i keyed = _mm256_xor_si256(words, key);
+      const __m256i product =
+          _mm256_mul_epu32(keyed, _mm256_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+      const __m256i swapped = _mm256_shuffle_epi32(words, _MM_SHUFFLE(1, 0, 3, 2));
+      xacc[i] = _mm256_add_epi64(xacc[i], _mm256_add_epi64(product, swapped));
+    }
+  }
+
+  for (u32 i = 0; i < 2; ++i)
+    _mm256_store_si256(reinterpret_cast<__m256i*>(acc) + i, xacc[i]);
+}
+
+FUNCTION_TARGET_AVX2
+static void ScrambleAVX2(u64* acc, const u64* keys)
+{
+  __m256i* const xacc = reinterpret_cast<__m256i*>(acc);
+  const __m256i prime = _mm256_set1_epi32(static_cast<int>(MAC_PRIME32));
+  for (u32 i = 0; i < 2; ++i)
+  {
+    __m256i value = _mm256_xor_si256(xacc[i], _mm256_srli_epi64(xacc[i], 47));
+    value =
+        _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys) + i));
+    const __m256i low = _mm256_mul_epu32(value, prime);
+    const __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(value, 32), prime);
+    xacc[i] = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+  }
+}
+
+#elif defined(_M_ARM_64)
+
+static void AccumulateNEON(u64* acc, const u8* data, u32 num_stripes, const u64* keys)
+{
+  uint64x2_t lanes[4];
+  for (u32 i = 0; i < 4; ++i)
+    lanes[i] = vld1q_u64(acc + i * 2);
+
+  for (u32 stripe = 0; stripe < num_stripes; ++stripe)
+  {
+    const u8* const stripe_data = data + stripe * MAC_STRIPE_LENGTH;
+    for (u32 i = 0; i < 4; ++i)
+    {
+      const uint64x2_t words = vreinterpretq_u64_u8(vld1q_u8(stripe_data + i * 16));
+      const uint64x2_t keyed = veorq_u64(words, vld1q_u64(keys + stripe + i * 2));
+      const uint64x2_t product = vmull_u32(vmovn_u64(keyed), vshrn_n_u64(keyed, 32));
+      const uint64x2_t swapped = vextq_u64(words, words, 1);
+      lanes[i] = vaddq_u64(lanes[i], vaddq_u64(product, swapped));
+    }
+  }
+
+  for (u32 i = 0; i < 4; ++i)
+    vst1q_u64(acc + i * 2, lanes[i]);
+}
+
+static void ScrambleNEON(u64* acc, const u64* keys)
+{
+  const uint32x2_t prime = vdup_n_u32(static_cast<u32>(MAC_PRIME32));
+  for (u32 i = 0; i < 4; ++i)
+  {
+    uint64x2_t value = vld1q_u64(acc + i * 2);
+    value = veorq_u64(value, vshrq_n_u64(value, 47));
+    value = veorq_u64(value, vld1q_u64(keys + i * 2));
+    const uint64x2_t low = vmull_u32(vmovn_u64(value), prime);
+    const uint64x2_t high = vmull_u32(vshrn_n_u64(value, 32), prime);
+    vst1q_u64(acc + i * 2, vaddq_u64(low, vshlq_n_u64(high, 32)));
+  }
+}
+
+#else
+
+static void AccumulateGeneric(u64* acc, const u8* data, u32 num_stripes, const u64* keys)
+{
+  for (u32 stripe = 0; stripe < num_stripes; ++stripe)
+  {
+    for (u32 i = 0; i < 8; ++i)
+    {
+      u64 word;
+      std::memcpy(&word, data + stripe * MAC_STRIPE_LENGTH + i * sizeof(u64), sizeof(word));
+      const u64 keyed = word ^ keys[stripe + i];
+      acc[i ^ 1] += word;
+      acc[i] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+    }
+  }
+}
+
+static void ScrambleGeneric(u64* acc, const u64* keys)
+{
+  for (u32 i = 0; i < 8; ++i)
+  {
+    acc[i] ^= acc[i] >> 47;
+    acc[i] ^= keys[i];
+    acc[i] *= MAC_PRIME32;
+  }
+}
+
+#endif
+
+static u64 MACAvalanche(u64 value)
+{
+  value ^= value >> 37;
+  value *= 0x165667919E3779F9;
+  value ^= value >> 32;
+  return value;
+}
+
+template <void (*Accumulate)(u64*, const u8*, u32, const u64*), void (*Scramble)(u64*, const u64*)>
+static u64 GetMACHash(const u8* src, u32 len)
+{
+  alignas(32) u64 acc[8] = {MAC_PRIME32,        MAC_PRIME64_1,      MAC_PRIME64_2,
+                            0x165667B19E3779F9, 0x85EBCA77C2B2AE63, 0x85EBCA77,
+                            0x27D4EB2F165667C5, 0xC2B2AE3D};
+
+  if (len <= MAC_STRIPE_LENGTH)
+  {
+    u8 stripe[MAC_STRIPE_LENGTH] = {};
+    if (len != 0)
+      std::memcpy(stripe, src, len);
+    Accumulate(acc, stripe, 1, s_mac_keys);
+  }
+  else
+  {
+    // The last stripe is always hashed separately, even if that means hashing some data twice.
+    const u32 num_blocks = (len - 1) / MAC_BLOCK_LENGTH;
+    for (u32 block = 0; block < num_blocks; ++block)
+    {
+      Accumulate(acc, src + block * MAC_BLOCK_LENGTH, MAC_STRIPES_PER_BLOCK, s_mac_keys);
+      Scramble(acc, s_mac_keys + MAC_STRIPES_PER_BLOCK);
+    }
+
+    const u32 num_stripes = (len - 1 - num_blocks * MAC_BLOCK_LENGTH) / MAC_STRIPE_LENGTH;
+    Accumulate(acc, src + num_blocks * MAC_BLOCK_LENGTH, num_stripes, s_mac_keys);
+    Accumulate(acc, src + len - MAC_STRIPE_LENGTH, 1, s_mac_keys + MAC_STRIPES_PER_BLOCK + 1);
+  }
+
+  // The lanes are mixed independently of each other, which keeps this short for small inputs.
+  u64 result = len * MAC_PRIME64_1;
+  for (u32 i = 0; i < 8; ++i)
+    result += MACAvalanche(acc[i] ^ s_mac_keys[i + 8]);
+  return MACAvalanche(result * MAC_PRIME64_2);
+}
+
 u64 GetHash64(const u8* src, u32 len, u32 samples)
 {
+  // Every word is read when there are at least as many samples as words.
+  if (samples == 0 || samples >= len / 8)
+    return ptrFullHashFunction(src, len);
+
   return ptrHashFunction(src, len, samples);
 }
 
+// Tables for computing the CRC-32 eight bytes at a time ("slicing-by-8").
+// Table 0 is the usual bytewise table, and table n advances a byte by n more bytes.
+static constexpr std::array<std::array<u32, 256>, 8> MakeCRC32Tables()
+{
+  std::array<std::array<u32, 256>, 8> tables{};
+  for (u32 i = 0; i < 256; ++i)
+  {
+    u32 crc = i;
+    for (int j = 0; j < 8; ++j)
+      crc = (crc >> 1) ^ (crc & 1 ? 0xedb88320 : 0);
+    tables[0][i] = crc;
+  }
+  for (u32 i = 0; i < 256; ++i)
+  {
+    for (size_t t = 1; t < tables.size(); ++t)
+      tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xff];
+  }
+  return tables;
+}
+
+static constexpr std::array<std::array<u32, 256>, 8> s_crc32_tables = MakeCRC32Tables();
+
+// Works on the inverted CRC, like the hardware implementations below.
+static u32 UpdateCRC32Generic(u32 crc, const u8* data, size_t len)
+{
+  const auto& t = s_crc32_tables;
+  for (; len >= 8; len -= 8, data += 8)
+  {
+    u32 low, high;
+    std::memcpy(&low, data, sizeof(u32));
+    std::memcpy(&high, data + 4, sizeof(u32));
+    low ^= crc;
+    crc = t[7][low & 0xff] ^ t[6][(low >> 8) & 0xff] ^ t[5][(low >> 16) & 0xff] ^ t[4][low >> 24] ^
+          t[3][high & 0xff] ^ t[2][(high >> 8) & 0xff] ^ t[1][(high >> 16) & 0xff] ^
+          t[0][high >> 24];
+  }
+  for (; len > 0; --len, ++data)
+    crc = (crc >> 8) ^ t[0][(crc ^ *data) & 0xff];
+  return crc;
+}
+
+#if defined(_M_X86_64)
+
+FUNCTION_TARGET_PCLMUL
+static inline __m128i FoldCRC32(__m128i x, __m128i next, __m128i k)
+{
+  const __m128i low = _mm_clmulepi64_si128(x, k, 0x00);
+  const __m128i high = _mm_clmulepi64_si128(x, k, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(low, high), next);
+}
+
+// Folds 64 bytes at a time with carry-less multiplication, following "Fast CRC Computation for
+// Generic Polynomials Using PCLMULQDQ Instruction" (Gopal et al., Intel, 2009).
+// len must be a multiple of 16 and at least 64.
+FUNCTION_TARGET_PCLMUL
+static u32 UpdateCRC32PCLMUL(u32 crc, const u8* data, size_t len)
+{
+  // Bit-reflected folding constants and the Barrett reduction constants for the CRC-32 polynomial
+  const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+  const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+  const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+  const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+  const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+  const __m128i* in = reinterpret_cast<const __m128i*>(data);
+  __m128i x1 = _mm_loadu_si128(in + 0);
+  __m128i x2 = _mm_loadu_si128(in + 1);
+  __m128i x3 = _mm_loadu_si128(in + 2);
+  __m128i x4 = _mm_loadu_si128(in + 3);
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+  in += 4;
+  len -= 64;
+
+  for (; len >= 64; len -= 64, in += 4)
+  {
+    x1 = FoldCRC32(x1, _mm_loadu_si128(in + 0), k1k2);
+    x2 = FoldCRC32(x2, _mm_loadu_si128(in + 1), k1k2);
+    x3 = FoldCRC32(x3, _mm_loadu_si128(in + 2), k1k2);
+    x4 = FoldCRC32(x4, _mm_loadu_si128(in + 3), k1k2);
+  }
+
+  x1 = FoldCRC32(x1, x2, k3k4);
+  x1 = FoldCRC32(x1, x3, k3k4);
+  x1 = FoldCRC32(x1, x4, k3k4);
+
+  for (; len >= 16; len -= 16, ++in)
+    x1 = FoldCRC32(x1, _mm_loadu_si128(in), k3k4);
+
+  // Fold 128 bits to 64 bits
+  __m128i x = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x);
+  x = _mm_srli_si128(x1, 4);
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k5k0, 0x00);
+  x1 = _mm_xor_si128(x1, x);
+
+  // Barrett reduction to 32 bits
+  x = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), poly, 0x10);
+  x = _mm_clmulepi64_si128(_mm_and_si128(x, mask32), poly, 0x00);
+  x1 = _mm_xor_si128(x1, x);
+
+  return static_cast<u32>(_mm_extract_epi32(x1, 1));
+}
+
+#elif defined(_M_ARM_64)
+
+static u32 UpdateCRC32ARM(u32 crc, const u8* data, size_t len)
+{
+  for (; len >= 8; len -= 8, data += 8)
+  {
+    u64 word;
+    std::memcpy(&word, data, sizeof(u64));
+    crc = __crc32d(crc, word);
+  }
+  for (; len > 0; --len, ++data)
+    crc = __crc32b(crc, *data);
+  return crc;
+}
+
+#endif
+
+u32 ComputeCRC32(u32 crc, const u8* data, size_t len)
+{
+  crc = ~crc;
+
+#if defined(_M_X86_64)
+  if (cpu_info.bPCLMULQDQ && cpu_info.bSSE4_1 && len >= 64)
+  {
+    const size_t folded_len = len & ~size_t(15);
+    crc = UpdateCRC32PCLMUL(crc, data, folded_len);
+    data += folded_len;
+    len -= folded_len;
+  }
+#elif defined(_M_ARM_64)
+  if (cpu_info.bCRC32)
+    return ~UpdateCRC32ARM(crc, data, len);
+#endif
+
+  return ~UpdateCRC32Generic(crc, data, len);
+}
+
 // sets the hash function used for the texture cache
 void SetHash64Function()
 {
+#if defined(_M_X86_64)
+  if (cpu_info.bAVX2)
+    ptrFullHashFunction = &GetMACHash<AccumulateAVX2, ScrambleAVX2>;
+  else
+    ptrFullHashFunction = &GetMACHash<AccumulateSSE2, ScrambleSSE2>;
+#elif defined(_M_ARM_64)
+  ptrFullHashFunction = &GetMACHash<AccumulateNEON, ScrambleNEON>;
+#else
+  ptrFullHashFunction = &GetMACHash<AccumulateGeneric, ScrambleGeneric>;
+#endif
+
 #if defined(_M_X86_64) || defined(_M_X86)
   if (cpu_info.bSSE4_2)  // sse crc32 version
   {
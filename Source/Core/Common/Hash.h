@@ -14,5 +14,8 @@ u32 HashFletcher(const u8* data_u8, size_t length);  // FAST. Length & 1 == 0.
 u32 HashAdler32(const u8* data, size_t len);         // Fairly accurate, slightly slower
 u32 HashEctor(const u8* ptr, size_t length);         // JUNK. DO NOT USE FOR NEW THINGS
 u64 GetHash64(const u8* src, u32 len, u32 samples);
+// The CRC-32 used by zlib and zip. Gives the same results as zlib's crc32, including for chaining:
+// pass 0 as crc for the first call and the previous result for later calls.
+u32 ComputeCRC32(u32 crc, const u8* data, size_t len);
 void SetHash64Function();
 }  // namespace Common
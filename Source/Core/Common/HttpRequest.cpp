@@ -4,9 +4,14 @@
 
 #include "Common/HttpRequest.h"
 
+#include <algorithm>
+#include <cctype>
 #include <chrono>
 #include <cstddef>
+#include <map>
 #include <mutex>
+#include <string>
+#include <string_view>
 
 #include <curl/curl.h>
 
@@ -36,13 +41,20 @@ public:
 
   static int CurlProgressCallback(Impl* impl, double dlnow, double dltotal, double ulnow,
                                   double ultotal);
+  static size_t CurlHeaderCallback(char* data, size_t size, size_t nmemb, void* userdata);
   std::string EscapeComponent(const std::string& string);
 
+  s32 GetLastResponseCode() const { return m_last_response_code; }
+  std::optional<std::string> GetLastResponseHeader(const std::string& name) const;
+
 private:
   static inline std::once_flag s_curl_was_initialized;
   ProgressCallback m_callback;
   std::unique_ptr<CURL, decltype(&curl_easy_cleanup)> m_curl{nullptr, curl_easy_cleanup};
   std::string m_error_string;
+  s32 m_last_response_code = 0;
+  // Keys are in lowercase
+  std::map<std::string, std::string> m_last_response_headers;
 };
 
 HttpRequest::HttpRequest(std::chrono::milliseconds timeout_ms, ProgressCallback callback)
@@ -96,6 +108,16 @@ HttpRequest::Response HttpRequest::Post(const std::string& url, const std::strin
                        reinterpret_cast<const u8*>(payload.data()), payload.size(), codes);
 }
 
+s32 HttpRequest::GetLastResponseCode() const
+{
+  return m_impl->GetLastResponseCode();
+}
+
+std::optional<std::string> HttpRequest::GetLastResponseHeader(const std::string& name) const
+{
+  return m_impl->GetLastResponseHeader(name);
+}
+
 int HttpRequest::Impl::CurlProgressCallback(Impl* impl, double dlnow, double dltotal, double ulnow,
                                             double ultotal)
 {
@@ -103,6 +125,45 @@ int HttpRequest::Impl::CurlProgressCallback(Impl* impl, double dlnow, double dlt
   return !impl->m_callback(dlnow, dltotal, ulnow, ultotal);
 }
 
+static std::string ToLower(std::string_view str)
+{
+  std::string result(str);
+  std::transform(result.begin(), result.end(), result.begin(), [](char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  });
+  return result;
+}
+
+size_t HttpRequest::Impl::CurlHeaderCallback(char* data, size_t size, size_t nmemb,
+                                             void* userdata)
+{
+  auto* headers = static_cast<std::map<std::string, std::string>*>(userdata);
+  const size_t actual_size = size * nmemb;
+  const std::string_view line(data, actual_size);
+
+  // A status line starts the headers of each response, including the ones that get redirected
+  if (StringBeginsWith(line, "HTTP/"))
+  {
+    headers->clear();
+    return actual_size;
+  }
+
+  const size_t colon = line.find(':');
+  if (colon != std::string_view::npos)
+  {
+    (*headers)[ToLower(line.substr(0, colon))] = std::string(StripSpaces(line.substr(colon + 1)));
+  }
+  return actual_size;
+}
+
+std::optional<std::string> HttpRequest::Impl::GetLastResponseHeader(const std::string& name) const
+{
+  const auto it = m_last_response_headers.find(ToLower(name));
+  if (it == m_last_response_headers.end())
+    return std::nullopt;
+  return it->second;
+}
+
 HttpRequest::Impl::Impl(std::chrono::milliseconds timeout_ms, ProgressCallback callback)
     : m_callback(std::move(callback))
 {
@@ -206,6 +267,11 @@ HttpRequest::Response HttpRequest::Impl::Fetch(const std::string& url, Method me
   curl_easy_setopt(m_curl.get(), CURLOPT_WRITEFUNCTION, CurlWriteCallback);
   curl_easy_setopt(m_curl.get(), CURLOPT_WRITEDATA, &buffer);
 
+  m_last_response_code = 0;
+  m_last_response_headers.clear();
+  curl_easy_setopt(m_curl.get(), CURLOPT_HEADERFUNCTION, CurlHeaderCallback);
+  curl_easy_setopt(m_curl.get(), CURLOPT_HEADERDATA, &m_last_response_headers);
+
   const char* type = method == Method::POST ? "POST" : "GET";
   const CURLcode res = curl_easy_perform(m_curl.get());
   if (res != CURLE_OK)
@@ -214,11 +280,13 @@ HttpRequest::Response HttpRequest::Impl::Fetch(const std::string& url, Method me
     return {};
   }
 
+  long response_code = 0;
+  curl_easy_getinfo(m_curl.get(), CURLINFO_RESPONSE_CODE, &response_code);
+  m_last_response_code = static_cast<s32>(response_code);
+
   if (codes == AllowedReturnCodes::All)
     return buffer;
 
-  long response_code = 0;
-  curl_easy_getinfo(m_curl.get(), CURLINFO_RESPONSE_CODE, &response_code);
   if (response_code != 200)
   {
     if (buffer.empty())
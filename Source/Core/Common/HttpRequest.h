@@ -48,6 +48,12 @@ public:
   Response Post(const std::string& url, const std::string& payload, const Headers& headers = {},
                 AllowedReturnCodes codes = AllowedReturnCodes::Ok_Only);
 
+  // Information about the response to the last request. The response code is 0 if no response
+  // was received. Header names are case-insensitive, and only the headers of the final response
+  // are kept if redirects were followed.
+  s32 GetLastResponseCode() const;
+  std::optional<std::string> GetLastResponseHeader(const std::string& name) const;
+
 private:
   class Impl;
   std::unique_ptr<Impl> m_impl;
@@ -7,13 +7,17 @@
 #include <cstddef>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <fmt/format.h>
 
 #include "Common/CommonTypes.h"
 #include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
 #include "Common/StringUtil.h"
 
 #ifdef _WIN32
@@ -22,6 +26,14 @@
 #include <unistd.h>
 #endif
 
+#ifdef __linux__
+#include <elf.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#define HAS_JITDUMP
+#endif
+
 #if defined USE_OPROFILE && USE_OPROFILE
 #include <opagent.h>
 #endif
@@ -37,11 +49,142 @@ static op_agent_t s_agent = nullptr;
 
 static File::IOFile s_perf_map_file;
 
+#ifdef HAS_JITDUMP
+// The format is described in tools/perf/Documentation/jitdump-specification.txt in the Linux
+// source tree. perf only picks up the file if it is recorded with -k mono, and the code then
+// has to be extracted with perf inject --jit.
+static constexpr u32 JITDUMP_MAGIC = 0x4A695444;
+static constexpr u32 JITDUMP_VERSION = 1;
+static constexpr u32 JITDUMP_HEADER_SIZE = 40;
+static constexpr u32 JIT_CODE_LOAD = 0;
+static constexpr u32 JIT_CODE_DEBUG_INFO = 2;
+
+#if defined(_M_X86_64)
+static constexpr u32 JITDUMP_ELF_MACHINE = EM_X86_64;
+#elif defined(_M_ARM_64)
+static constexpr u32 JITDUMP_ELF_MACHINE = EM_AARCH64;
+#else
+static constexpr u32 JITDUMP_ELF_MACHINE = EM_NONE;
+#endif
+
+static File::IOFile s_jitdump_file;
+// perf finds the dump through this mapping, which is why it has to be executable.
+static void* s_jitdump_marker = nullptr;
+static size_t s_jitdump_marker_size = 0;
+static u64 s_jitdump_code_index = 0;
+static std::mutex s_jitdump_mutex;
+
+static u64 GetJitDumpTimestamp()
+{
+  timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return static_cast<u64>(time.tv_sec) * 1000000000 + static_cast<u64>(time.tv_nsec);
+}
+
+template <typename T>
+static void Append(std::vector<u8>* record, T value)
+{
+  const size_t offset = record->size();
+  record->resize(offset + sizeof(T));
+  std::memcpy(record->data() + offset, &value, sizeof(T));
+}
+
+static void Append(std::vector<u8>* record, const void* data, size_t size)
+{
+  const u8* bytes = static_cast<const u8*>(data);
+  record->insert(record->end(), bytes, bytes + size);
+}
+
+static std::vector<u8> StartJitDumpRecord(u32 id)
+{
+  std::vector<u8> record;
+  Append(&record, id);
+  // The size is filled in by WriteJitDumpRecord.
+  Append(&record, u32(0));
+  Append(&record, GetJitDumpTimestamp());
+  return record;
+}
+
+static void WriteJitDumpRecord(std::vector<u8>* record)
+{
+  const u32 size = static_cast<u32>(record->size());
+  std::memcpy(record->data() + sizeof(u32), &size, sizeof(u32));
+  s_jitdump_file.WriteBytes(record->data(), record->size());
+}
+
+static void OpenJitDump(const std::string& filename)
+{
+  // The file has to be readable for the mapping below.
+  if (!s_jitdump_file.Open(filename, "w+b"))
+  {
+    WARN_LOG_FMT(COMMON, "Failed to create {}", filename);
+    return;
+  }
+  std::setvbuf(s_jitdump_file.GetHandle(), nullptr, _IONBF, 0);
+
+  std::vector<u8> header;
+  Append(&header, JITDUMP_MAGIC);
+  Append(&header, JITDUMP_VERSION);
+  Append(&header, JITDUMP_HEADER_SIZE);
+  Append(&header, JITDUMP_ELF_MACHINE);
+  Append(&header, u32(0));
+  Append(&header, static_cast<u32>(getpid()));
+  Append(&header, GetJitDumpTimestamp());
+  Append(&header, u64(0));
+  s_jitdump_file.WriteBytes(header.data(), header.size());
+
+  s_jitdump_marker_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  s_jitdump_marker = mmap(nullptr, s_jitdump_marker_size, PROT_READ | PROT_EXEC, MAP_PRIVATE,
+                          fileno(s_jitdump_file.GetHandle()), 0);
+  if (s_jitdump_marker == MAP_FAILED)
+  {
+    WARN_LOG_FMT(COMMON, "Failed to map {}, perf won't be able to find it", filename);
+    s_jitdump_marker = nullptr;
+    s_jitdump_file.Close();
+    return;
+  }
+
+  s_jitdump_code_index = 0;
+}
+
+static void CloseJitDump()
+{
+  if (s_jitdump_marker)
+  {
+    munmap(s_jitdump_marker, s_jitdump_marker_size);
+    s_jitdump_marker = nullptr;
+  }
+
+  if (s_jitdump_file.IsOpen())
+    s_jitdump_file.Close();
+}
+
+static void WriteJitDumpCodeLoad(const void* base_address, u32 code_size,
+                                 const std::string& symbol_name)
+{
+  std::lock_guard lk(s_jitdump_mutex);
+  if (!s_jitdump_file.IsOpen())
+    return;
+
+  const u64 address = reinterpret_cast<uintptr_t>(base_address);
+  std::vector<u8> record = StartJitDumpRecord(JIT_CODE_LOAD);
+  Append(&record, static_cast<u32>(getpid()));
+  Append(&record, static_cast<u32>(syscall(SYS_gettid)));
+  Append(&record, address);
+  Append(&record, address);
+  Append(&record, u64(code_size));
+  Append(&record, s_jitdump_code_index++);
+  Append(&record, symbol_name.c_str(), symbol_name.size() + 1);
+  Append(&record, base_address, code_size);
+  WriteJitDumpRecord(&record);
+}
+#endif
+
 namespace JitRegister
 {
 static bool s_is_enabled = false;
 
-void Init(const std::string& perf_dir)
+void Init(const std::string& perf_dir, bool jit_dump)
 {
 #if defined USE_OPROFILE && USE_OPROFILE
   s_agent = op_open_agent();
@@ -58,6 +201,15 @@ void Init(const std::string& perf_dir)
     std::setvbuf(s_perf_map_file.GetHandle(), nullptr, _IONBF, 0);
     s_is_enabled = true;
   }
+
+#ifdef HAS_JITDUMP
+  if (jit_dump)
+  {
+    const std::string dir = perf_dir.empty() ? "/tmp" : perf_dir;
+    OpenJitDump(fmt::format("{}/jit-{}.dump", dir, getpid()));
+    s_is_enabled |= s_jitdump_file.IsOpen();
+  }
+#endif
 }
 
 void Shutdown()
@@ -74,6 +226,10 @@ void Shutdown()
   if (s_perf_map_file.IsOpen())
     s_perf_map_file.Close();
 
+#ifdef HAS_JITDUMP
+  CloseJitDump();
+#endif
+
   s_is_enabled = false;
 }
 
@@ -82,10 +238,41 @@ bool IsEnabled()
   return s_is_enabled;
 }
 
+bool IsJitDumpEnabled()
+{
+#ifdef HAS_JITDUMP
+  return s_jitdump_file.IsOpen();
+#else
+  return false;
+#endif
+}
+
+void RegisterSourceLines(const void* base_address, const char* file_name,
+                         const std::vector<SourceLine>& lines)
+{
+#ifdef HAS_JITDUMP
+  std::lock_guard lk(s_jitdump_mutex);
+  if (!s_jitdump_file.IsOpen() || lines.empty())
+    return;
+
+  std::vector<u8> record = StartJitDumpRecord(JIT_CODE_DEBUG_INFO);
+  Append(&record, u64(reinterpret_cast<uintptr_t>(base_address)));
+  Append(&record, u64(lines.size()));
+  for (const SourceLine& line : lines)
+  {
+    Append(&record, u64(reinterpret_cast<uintptr_t>(line.host_address)));
+    Append(&record, line.guest_address);
+    Append(&record, u32(0));
+    Append(&record, file_name, std::strlen(file_name) + 1);
+  }
+  WriteJitDumpRecord(&record);
+#endif
+}
+
 void RegisterV(const void* base_address, u32 code_size, const char* format, va_list args)
 {
 #if !(defined USE_OPROFILE && USE_OPROFILE) && !defined(USE_VTUNE)
-  if (!s_perf_map_file.IsOpen())
+  if (!s_perf_map_file.IsOpen() && !IsJitDumpEnabled())
     return;
 #endif
 
@@ -104,6 +291,10 @@ void RegisterV(const void* base_address, u32 code_size, const char* format, va_l
   iJIT_NotifyEvent(iJVM_EVENT_TYPE_METHOD_LOAD_FINISHED, (void*)&jmethod);
 #endif
 
+#ifdef HAS_JITDUMP
+  WriteJitDumpCodeLoad(base_address, code_size, symbol_name);
+#endif
+
   // Linux perf /tmp/perf-$pid.map:
   if (!s_perf_map_file.IsOpen())
     return;
@@ -5,14 +5,30 @@
 #pragma once
 #include <stdarg.h>
 #include <string>
+#include <vector>
 #include "Common/CommonTypes.h"
 
 namespace JitRegister
 {
-void Init(const std::string& perf_dir);
+// The guest instruction that the host code starting at host_address was generated for
+struct SourceLine
+{
+  const void* host_address;
+  u32 guest_address;
+};
+
+// When jit_dump is set, a perf jitdump file (jit-<pid>.dump) is written as well as the perf map.
+// Unlike the map, it also contains the generated code and the guest address of each instruction.
+void Init(const std::string& perf_dir, bool jit_dump = false);
 void Shutdown();
 void RegisterV(const void* base_address, u32 code_size, const char* format, va_list args);
 bool IsEnabled();
+bool IsJitDumpEnabled();
+
+// Records which guest instructions the code at base_address was generated for. This has to be
+// called before the code is registered. The lines show up in perf as file_name:guest_address.
+void RegisterSourceLines(const void* base_address, const char* file_name,
+                         const std::vector<SourceLine>& lines);
 
 inline void Register(const void* base_address, u32 code_size, const char* format, ...)
 {
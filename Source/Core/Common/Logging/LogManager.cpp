@@ -7,10 +7,12 @@
 #include <algorithm>
 #include <cstdarg>
 #include <cstring>
+#include <ctime>
 #include <locale>
 #include <mutex>
 #include <ostream>
 #include <string>
+#include <utility>
 
 #include <fmt/format.h>
 
@@ -20,11 +22,14 @@
 #include "Common/Logging/ConsoleListener.h"
 #include "Common/Logging/Log.h"
 #include "Common/StringUtil.h"
-#include "Common/Timer.h"
+#include "Common/Thread.h"
 
 namespace Common::Log
 {
 constexpr size_t MAX_MSGLEN = 1024;
+// Per logging thread. When a queue is full, further messages from that thread are dropped (and
+// counted) instead of making the thread wait for the log thread.
+constexpr size_t THREAD_QUEUE_CAPACITY = 1024;
 
 const Config::Info<bool> LOGGER_WRITE_TO_FILE{{Config::System::Logger, "Options", "WriteToFile"},
                                               false};
@@ -62,6 +67,18 @@ private:
   bool m_enable;
 };
 
+struct LogManager::ThreadQueue
+{
+  std::array<LogEntry, THREAD_QUEUE_CAPACITY> entries;
+  std::atomic<size_t> read_index{0};
+  std::atomic<size_t> write_index{0};
+  std::atomic<u64> dropped_count{0};
+  // Set when the thread exits, after which the queue is freed once it is empty.
+  std::atomic<bool> abandoned{false};
+};
+
+static std::atomic<u64> s_next_instance_id{0};
+
 void GenericLog(LOG_LEVELS level, LOG_TYPE type, const char* file, int line, const char* fmt, ...)
 {
   auto* instance = LogManager::GetInstance();
@@ -94,6 +111,19 @@ void GenericLogFmtImpl(LOG_LEVELS level, LOG_TYPE type, const char* file, int li
   instance->Log(level, type, file, line, message.c_str());
 }
 
+// The same format as Common::Timer::GetTimeFormatted, but for the time the message was logged at
+static std::string FormatTime(std::chrono::system_clock::time_point time)
+{
+  const std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+  const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                time.time_since_epoch()) %
+                            1000;
+
+  char minutes_seconds[6] = {};
+  std::strftime(minutes_seconds, sizeof(minutes_seconds), "%M:%S", std::localtime(&seconds));
+  return fmt::format("{}:{:03}", minutes_seconds, milliseconds.count());
+}
+
 static size_t DeterminePathCutOffPoint()
 {
   constexpr const char* pattern = "/source/core/";
@@ -113,7 +143,7 @@ static size_t DeterminePathCutOffPoint()
   return 0;
 }
 
-LogManager::LogManager()
+LogManager::LogManager() : m_instance_id(++s_next_instance_id)
 {
   // create log containers
   m_log[ACTIONREPLAY] = {"ActionReplay", "Action Replay"};
@@ -191,10 +221,18 @@ LogManager::LogManager()
         Config::Info<bool>{{Config::System::Logger, "Logs", container.m_short_name}, false});
 
   m_path_cutoff_point = DeterminePathCutOffPoint();
+
+  m_log_thread_running.Set();
+  m_log_thread = std::thread(&LogManager::LogThread, this);
 }
 
 LogManager::~LogManager()
 {
+  // Everything that was logged before still gets written out.
+  m_log_thread_running.Clear();
+  m_log_event.Set();
+  m_log_thread.join();
+
   // The log window listener pointer is owned by the GUI code.
   delete m_listeners[LogListener::CONSOLE_LISTENER];
   delete m_listeners[LogListener::FILE_LISTENER];
@@ -226,20 +264,127 @@ void LogManager::Log(LOG_LEVELS level, LOG_TYPE type, const char* file, int line
   if (!IsEnabled(type, level) || !static_cast<bool>(m_listener_ids))
     return;
 
-  LogWithFullPath(level, type, file + m_path_cutoff_point, line, message);
+  ThreadQueue& queue = GetThreadQueue();
+  const size_t write_index = queue.write_index.load(std::memory_order_relaxed);
+  if (write_index - queue.read_index.load(std::memory_order_acquire) >= THREAD_QUEUE_CAPACITY)
+  {
+    queue.dropped_count.fetch_add(1, std::memory_order_relaxed);
+    m_log_event.Set();
+    return;
+  }
+
+  // Assigning the message reuses the string that was in this entry the last time around.
+  LogEntry& entry = queue.entries[write_index % THREAD_QUEUE_CAPACITY];
+  entry.time = std::chrono::system_clock::now();
+  entry.sequence_number = m_next_sequence_number.fetch_add(1, std::memory_order_relaxed);
+  entry.level = level;
+  entry.type = type;
+  entry.file = file + m_path_cutoff_point;
+  entry.line = line;
+  entry.message = message;
+  queue.write_index.store(write_index + 1, std::memory_order_release);
+
+  m_log_event.Set();
+}
+
+LogManager::ThreadQueue& LogManager::GetThreadQueue()
+{
+  struct ThreadQueueHandle
+  {
+    ~ThreadQueueHandle()
+    {
+      if (queue)
+        queue->abandoned.store(true, std::memory_order_release);
+    }
+
+    std::shared_ptr<ThreadQueue> queue;
+    u64 instance_id = 0;
+  };
+  thread_local ThreadQueueHandle handle;
+
+  if (handle.instance_id != m_instance_id)
+  {
+    if (handle.queue)
+      handle.queue->abandoned.store(true, std::memory_order_release);
+
+    handle.queue = std::make_shared<ThreadQueue>();
+    handle.instance_id = m_instance_id;
+
+    std::lock_guard lk(m_queues_mutex);
+    m_queues.push_back(handle.queue);
+  }
+
+  return *handle.queue;
 }
 
-void LogManager::LogWithFullPath(LOG_LEVELS level, LOG_TYPE type, const char* file, int line,
-                                 const char* message)
+void LogManager::LogThread()
 {
-  const std::string msg =
-      fmt::format("{} {}:{} {}[{}]: {}\n", Common::Timer::GetTimeFormatted(), file, line,
-                  LOG_LEVEL_TO_CHAR[static_cast<int>(level)], GetShortName(type), message);
+  Common::SetCurrentThreadName("Log Thread");
+
+  while (m_log_thread_running.IsSet())
+  {
+    m_log_event.Wait();
+    DrainQueues();
+  }
+  DrainQueues();
+}
 
+void LogManager::DrainQueues()
+{
+  u64 dropped_count = 0;
+  {
+    std::lock_guard lk(m_queues_mutex);
+    for (auto it = m_queues.begin(); it != m_queues.end();)
+    {
+      ThreadQueue& queue = **it;
+
+      // The thread doesn't write anything after marking its queue as abandoned, so checking
+      // this first means that everything it wrote gets drained below.
+      const bool abandoned = queue.abandoned.load(std::memory_order_acquire);
+      const size_t read_index = queue.read_index.load(std::memory_order_relaxed);
+      const size_t write_index = queue.write_index.load(std::memory_order_acquire);
+      for (size_t i = read_index; i != write_index; ++i)
+        m_drained_entries.push_back(queue.entries[i % THREAD_QUEUE_CAPACITY]);
+      queue.read_index.store(write_index, std::memory_order_release);
+      dropped_count += queue.dropped_count.exchange(0, std::memory_order_relaxed);
+
+      if (abandoned)
+        it = m_queues.erase(it);
+      else
+        ++it;
+    }
+  }
+
+  std::sort(m_drained_entries.begin(), m_drained_entries.end(),
+            [](const LogEntry& a, const LogEntry& b) {
+              return a.sequence_number < b.sequence_number;
+            });
+
+  std::lock_guard lk(m_listeners_mutex);
+  if (dropped_count != 0)
+  {
+    DispatchMessage(LWARNING,
+                    fmt::format("{} {}[{}]: {} log messages were dropped\n",
+                                FormatTime(std::chrono::system_clock::now()),
+                                LOG_LEVEL_TO_CHAR[static_cast<int>(LWARNING)],
+                                GetShortName(COMMON), dropped_count));
+  }
+  for (const LogEntry& entry : m_drained_entries)
+  {
+    DispatchMessage(entry.level,
+                    fmt::format("{} {}:{} {}[{}]: {}\n", FormatTime(entry.time), entry.file,
+                                entry.line, LOG_LEVEL_TO_CHAR[static_cast<int>(entry.level)],
+                                GetShortName(entry.type), entry.message));
+  }
+  m_drained_entries.clear();
+}
+
+void LogManager::DispatchMessage(LOG_LEVELS level, const std::string& message)
+{
   for (const auto listener_id : m_listener_ids)
   {
     if (m_listeners[listener_id])
-      m_listeners[listener_id]->Log(level, msg.c_str());
+      m_listeners[listener_id]->Log(level, message.c_str());
   }
 }
 
@@ -286,6 +431,7 @@ const char* LogManager::GetFullName(LOG_TYPE type) const
 
 void LogManager::RegisterListener(LogListener::LISTENER id, LogListener* listener)
 {
+  std::lock_guard lk(m_listeners_mutex);
   m_listeners[id] = listener;
 }
 
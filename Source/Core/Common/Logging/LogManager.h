@@ -5,11 +5,20 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdarg>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "Common/BitSet.h"
+#include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "Common/Flag.h"
 #include "Common/Logging/Log.h"
 
 namespace Common::Log
@@ -38,6 +47,8 @@ public:
   static void Init();
   static void Shutdown();
 
+  // Only queues the message. It is timestamped here, but formatted and passed to the listeners
+  // on the log thread.
   void Log(LOG_LEVELS level, LOG_TYPE type, const char* file, int line, const char* message);
 
   LOG_LEVELS GetLogLevel() const;
@@ -51,6 +62,7 @@ public:
   const char* GetShortName(LOG_TYPE type) const;
   const char* GetFullName(LOG_TYPE type) const;
 
+  // Waits for the log thread to be done with the previous listener, if it is using it.
   void RegisterListener(LogListener::LISTENER id, LogListener* listener);
   void EnableListener(LogListener::LISTENER id, bool enable);
   bool IsListenerEnabled(LogListener::LISTENER id) const;
@@ -73,13 +85,43 @@ private:
   LogManager(LogManager&&) = delete;
   LogManager& operator=(LogManager&&) = delete;
 
-  void LogWithFullPath(LOG_LEVELS level, LOG_TYPE type, const char* file, int line,
-                       const char* message);
+  struct LogEntry
+  {
+    std::chrono::system_clock::time_point time;
+    u64 sequence_number;
+    LOG_LEVELS level;
+    LOG_TYPE type;
+    const char* file;
+    int line;
+    std::string message;
+  };
+
+  // A ring buffer with a single producer (the thread that logs) and a single consumer (the log
+  // thread), so that logging threads don't contend with each other.
+  struct ThreadQueue;
+
+  ThreadQueue& GetThreadQueue();
+  void LogThread();
+  void DrainQueues();
+  void DispatchMessage(LOG_LEVELS level, const std::string& message);
 
   LOG_LEVELS m_level;
   std::array<LogContainer, NUMBER_OF_LOGS> m_log{};
   std::array<LogListener*, LogListener::NUMBER_OF_LISTENERS> m_listeners{};
+  std::mutex m_listeners_mutex;
   BitSet32 m_listener_ids;
   size_t m_path_cutoff_point = 0;
+
+  // Distinguishes the queues of this instance from the ones of previous instances, which
+  // threads that outlived them may still hold on to.
+  u64 m_instance_id;
+  std::atomic<u64> m_next_sequence_number{0};
+  std::mutex m_queues_mutex;
+  std::vector<std::shared_ptr<ThreadQueue>> m_queues;
+  std::vector<LogEntry> m_drained_entries;
+
+  std::thread m_log_thread;
+  Common::Flag m_log_thread_running;
+  Common::Event m_log_event;
 };
 }  // namespace Common::Log
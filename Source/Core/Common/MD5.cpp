@@ -4,10 +4,15 @@
 
 #include "Common/MD5.h"
 
-#include <fstream>
+#include <algorithm>
+#include <array>
 #include <functional>
+#include <future>
 #include <mbedtls/md5.h>
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <fmt/format.h>
 
@@ -16,37 +21,88 @@
 
 namespace MD5
 {
-std::string MD5Sum(const std::string& file_path, std::function<bool(int)> report_progress)
+constexpr size_t CHUNK_SIZE = 8 * 1024 * 1024;
+constexpr size_t MAX_READ_THREADS = 8;
+
+namespace
 {
-  std::string output_string;
-  std::vector<u8> data(8 * 1024 * 1024);
-  u64 read_offset = 0;
-  mbedtls_md5_context ctx;
+// Reading is what takes most of the time for compressed formats, and blob readers can't be shared
+// between threads, so each thread gets its own reader. While the main thread hashes a chunk, the
+// thread that read it already reads its next one into its other buffer.
+struct ReadThread
+{
+  std::unique_ptr<DiscIO::BlobReader> reader;
+  std::array<std::vector<u8>, 2> buffers;
+  std::future<bool> future;
+};
+}  // namespace
 
+std::string MD5Sum(const std::string& file_path, std::function<bool(int)> report_progress)
+{
   std::unique_ptr<DiscIO::BlobReader> file(DiscIO::CreateBlobReader(file_path));
-  u64 game_size = file->GetDataSize();
+  if (!file)
+    return {};
+
+  const u64 game_size = file->GetDataSize();
+  const u64 chunk_count = (game_size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  const size_t thread_count = static_cast<size_t>(
+      std::min<u64>({std::max(1u, std::thread::hardware_concurrency()), MAX_READ_THREADS,
+                     std::max<u64>(chunk_count, 1)}));
 
+  std::vector<ReadThread> threads(thread_count);
+  threads[0].reader = std::move(file);
+  for (size_t i = 1; i < thread_count; ++i)
+  {
+    threads[i].reader = DiscIO::CreateBlobReader(file_path);
+    if (!threads[i].reader)
+      return {};
+  }
+
+  const auto get_buffer = [&](u64 chunk) -> std::vector<u8>& {
+    return threads[chunk % thread_count].buffers[(chunk / thread_count) % 2];
+  };
+  const auto start_read = [&](u64 chunk) {
+    ReadThread& thread = threads[chunk % thread_count];
+    std::vector<u8>& buffer = get_buffer(chunk);
+    const u64 offset = chunk * CHUNK_SIZE;
+    buffer.resize(static_cast<size_t>(std::min<u64>(CHUNK_SIZE, game_size - offset)));
+    thread.future = std::async(std::launch::async, [&thread, &buffer, offset] {
+      return thread.reader->Read(offset, buffer.size(), buffer.data());
+    });
+  };
+
+  for (u64 chunk = 0; chunk < std::min<u64>(thread_count, chunk_count); ++chunk)
+    start_read(chunk);
+
+  mbedtls_md5_context ctx;
+  mbedtls_md5_init(&ctx);
   mbedtls_md5_starts_ret(&ctx);
 
-  while (read_offset < game_size)
+  // The futures wait for the reads that are still running when returning early
+  for (u64 chunk = 0; chunk < chunk_count; ++chunk)
   {
-    size_t read_size = std::min(static_cast<u64>(data.size()), game_size - read_offset);
-    if (!file->Read(read_offset, read_size, data.data()))
-      return output_string;
+    if (!threads[chunk % thread_count].future.get())
+      return {};
 
-    mbedtls_md5_update_ret(&ctx, data.data(), read_size);
-    read_offset += read_size;
+    if (chunk + thread_count < chunk_count)
+      start_read(chunk + thread_count);
 
+    const std::vector<u8>& buffer = get_buffer(chunk);
+    mbedtls_md5_update_ret(&ctx, buffer.data(), buffer.size());
+
+    const u64 read_offset = chunk * CHUNK_SIZE + buffer.size();
     int progress =
         static_cast<int>(static_cast<float>(read_offset) / static_cast<float>(game_size) * 100);
     if (!report_progress(progress))
-      return output_string;
+      return {};
   }
 
   std::array<u8, 16> output;
   mbedtls_md5_finish_ret(&ctx, output.data());
+  mbedtls_md5_free(&ctx);
 
   // Convert to hex
+  std::string output_string;
   for (u8 n : output)
     output_string += fmt::format("{:02x}", n);
 
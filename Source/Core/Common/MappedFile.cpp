@@ -0,0 +1,75 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/MappedFile.h"
+
+#include <cstdio>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include "Common/IOFile.h"
+
+namespace File
+{
+MappedFile::~MappedFile()
+{
+  Close();
+}
+
+bool MappedFile::Open(const std::string& filename)
+{
+  Close();
+
+  // Going through IOFile gets us the same path handling as everywhere else. The mapping stays
+  // valid after the file is closed again.
+  IOFile file(filename, "rb");
+  if (!file)
+    return false;
+
+  const u64 size = file.GetSize();
+  if (size == 0 || size != static_cast<size_t>(size))
+    return false;
+
+#ifdef _WIN32
+  const HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file.GetHandle())));
+  const HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping)
+    return false;
+
+  void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (!data)
+    return false;
+#else
+  void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileno(file.GetHandle()), 0);
+  if (data == MAP_FAILED)
+    return false;
+#endif
+
+  m_data = static_cast<const u8*>(data);
+  m_size = static_cast<size_t>(size);
+  return true;
+}
+
+void MappedFile::Close()
+{
+  if (!m_data)
+    return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(m_data);
+#else
+  munmap(const_cast<u8*>(m_data), m_size);
+#endif
+
+  m_data = nullptr;
+  m_size = 0;
+}
+}  // namespace File
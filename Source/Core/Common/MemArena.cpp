@@ -7,10 +7,12 @@
 #include <set>
 #include <string>
 
+#include "Common/Align.h"
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 
@@ -81,6 +83,21 @@ void MemArena::GrabSHMSegment(size_t size)
     return;
   }
 #else
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  // Transparent huge pages are only used for shared memory that isn't on a tmpfs mount (which
+  // follows the mount's own huge= option rather than the system setting), such as a memfd.
+  if (AreHugePagesEnabled())
+  {
+    fd = memfd_create("dolphin-emu", MFD_CLOEXEC);
+    if (fd != -1)
+    {
+      if (ftruncate(fd, size) < 0)
+        ERROR_LOG_FMT(MEMMAP, "Failed to allocate low memory space");
+      return;
+    }
+    WARN_LOG_FMT(MEMMAP, "memfd_create failed: {}", strerror(errno));
+  }
+#endif
   const std::string file_name = "/dolphin-emu." + std::to_string(getpid());
   fd = shm_open(file_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
   if (fd == -1)
@@ -104,14 +121,52 @@ void MemArena::ReleaseSHMSegment()
 #endif
 }
 
-void* MemArena::CreateView(s64 offset, size_t size, void* base)
+void* MemArena::CreateView(s64 offset, size_t size, void* base, bool read_only)
 {
 #ifdef _WIN32
-  return MapViewOfFileEx(hMemoryMapping, FILE_MAP_ALL_ACCESS, 0, (DWORD)((u64)offset), size, base);
+  return MapViewOfFileEx(hMemoryMapping, read_only ? FILE_MAP_READ : FILE_MAP_ALL_ACCESS, 0,
+                         (DWORD)((u64)offset), size, base);
 #else
-  void* retval = mmap(base, size, PROT_READ | PROT_WRITE,
+#ifdef MADV_HUGEPAGE
+  // A huge page can only be mapped where the view's address and offset are aligned alike, so a
+  // view that can go anywhere is put at an aligned address. The offsets are up to the caller.
+  u8* reserved = nullptr;
+  const size_t reserved_size = size + HUGE_PAGE_SIZE;
+  if (AreHugePagesEnabled() && base == nullptr)
+  {
+    reserved = static_cast<u8*>(
+        mmap(nullptr, reserved_size, PROT_NONE, MAP_ANON | MAP_PRIVATE, -1, 0));
+    if (reserved != MAP_FAILED)
+    {
+      base = reinterpret_cast<u8*>(
+          Common::AlignUp(reinterpret_cast<uintptr_t>(reserved), HUGE_PAGE_SIZE));
+    }
+    else
+    {
+      reserved = nullptr;
+    }
+  }
+#endif
+
+  void* retval = mmap(base, size, read_only ? PROT_READ : PROT_READ | PROT_WRITE,
                       MAP_SHARED | ((base == nullptr) ? 0 : MAP_FIXED), fd, offset);
 
+#ifdef MADV_HUGEPAGE
+  if (reserved)
+  {
+    // Give back what's left of the reservation around the view.
+    u8* const view_end = static_cast<u8*>(base) + size;
+    if (retval == MAP_FAILED)
+      munmap(reserved, reserved_size);
+    else if (base != reserved)
+      munmap(reserved, static_cast<u8*>(base) - reserved);
+    if (retval != MAP_FAILED && view_end != reserved + reserved_size)
+      munmap(view_end, reserved + reserved_size - view_end);
+  }
+  if (retval != MAP_FAILED && AreHugePagesEnabled())
+    madvise(retval, size, MADV_HUGEPAGE);
+#endif
+
   if (retval == MAP_FAILED)
   {
     NOTICE_LOG_FMT(MEMMAP, "mmap failed");
@@ -23,7 +23,7 @@ class MemArena
 public:
   void GrabSHMSegment(size_t size);
   void ReleaseSHMSegment();
-  void* CreateView(s64 offset, size_t size, void* base = nullptr);
+  void* CreateView(s64 offset, size_t size, void* base = nullptr, bool read_only = false);
   void ReleaseView(void* view, size_t size);
 
   // This finds 1 GB in 32-bit, 16 GB in 64-bit.
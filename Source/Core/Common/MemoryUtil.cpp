@@ -2,10 +2,12 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <atomic>
 #include <cstddef>
 #include <cstdlib>
 #include <string>
 
+#include "Common/Align.h"
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
@@ -14,11 +16,14 @@
 
 #ifdef _WIN32
 #include <windows.h>
+#include <psapi.h>
 #include "Common/StringUtil.h"
 #else
 #include <stdio.h>
 #include <sys/mman.h>
+#include <sys/resource.h>
 #include <sys/types.h>
+#include <unistd.h>
 #if defined __APPLE__ || defined __FreeBSD__ || defined __OpenBSD__ || defined __NetBSD__
 #include <sys/sysctl.h>
 #elif defined __HAIKU__
@@ -33,13 +38,89 @@ namespace Common
 // This is purposely not a full wrapper for virtualalloc/mmap, but it
 // provides exactly the primitive operations that Dolphin needs.
 
+static std::atomic<bool> s_huge_pages_enabled{false};
+
+void SetHugePagesEnabled(bool enabled)
+{
+  s_huge_pages_enabled = enabled;
+}
+
+bool AreHugePagesEnabled()
+{
+  return s_huge_pages_enabled;
+}
+
+#ifdef _WIN32
+// Large pages can only be allocated with SeLockMemoryPrivilege, which has to be granted to the user
+// and then enabled for the process.
+static bool EnableLockMemoryPrivilege()
+{
+  static const bool s_enabled = [] {
+    HANDLE token;
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+      return false;
+
+    TOKEN_PRIVILEGES privileges{};
+    privileges.PrivilegeCount = 1;
+    privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+    const bool enabled =
+        LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid) &&
+        AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) &&
+        GetLastError() == ERROR_SUCCESS;
+    CloseHandle(token);
+
+    if (!enabled)
+      WARN_LOG_FMT(COMMON, "Large pages are unavailable: {}", GetLastErrorString());
+    return enabled;
+  }();
+  return s_enabled;
+}
+#elif defined(MADV_HUGEPAGE)
+// Maps anonymous memory at an address aligned to HUGE_PAGE_SIZE, so that all of it can be backed
+// by transparent huge pages, and asks for that.
+static void* MapHugePageAligned(size_t size, int prot)
+{
+  const size_t reserved_size = size + HUGE_PAGE_SIZE;
+  u8* const reserved =
+      static_cast<u8*>(mmap(nullptr, reserved_size, prot, MAP_ANON | MAP_PRIVATE, -1, 0));
+  if (reserved == MAP_FAILED)
+    return MAP_FAILED;
+
+  u8* const aligned = reinterpret_cast<u8*>(
+      Common::AlignUp(reinterpret_cast<uintptr_t>(reserved), HUGE_PAGE_SIZE));
+  if (aligned != reserved)
+    munmap(reserved, aligned - reserved);
+  if (aligned + size != reserved + reserved_size)
+    munmap(aligned + size, reserved + reserved_size - (aligned + size));
+
+  madvise(aligned, size, MADV_HUGEPAGE);
+  return aligned;
+}
+#endif
+
 void* AllocateExecutableMemory(size_t size)
 {
 #if defined(_WIN32)
-  void* ptr = VirtualAlloc(nullptr, size, MEM_COMMIT, PAGE_EXECUTE_READWRITE);
+  void* ptr = nullptr;
+  if (s_huge_pages_enabled && EnableLockMemoryPrivilege())
+  {
+    const size_t large_page_size = GetLargePageMinimum();
+    if (large_page_size != 0)
+    {
+      ptr = VirtualAlloc(nullptr, Common::AlignUp(size, large_page_size),
+                         MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_EXECUTE_READWRITE);
+    }
+  }
+  if (!ptr)
+    ptr = VirtualAlloc(nullptr, size, MEM_COMMIT, PAGE_EXECUTE_READWRITE);
+#else
+  constexpr int prot = PROT_READ | PROT_WRITE | PROT_EXEC;
+#ifdef MADV_HUGEPAGE
+  void* ptr = s_huge_pages_enabled ? MapHugePageAligned(size, prot) :
+                                     mmap(nullptr, size, prot, MAP_ANON | MAP_PRIVATE, -1, 0);
 #else
-  void* ptr =
-      mmap(nullptr, size, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_ANON | MAP_PRIVATE, -1, 0);
+  void* ptr = mmap(nullptr, size, prot, MAP_ANON | MAP_PRIVATE, -1, 0);
+#endif
 
   if (ptr == MAP_FAILED)
     ptr = nullptr;
@@ -181,4 +262,37 @@ size_t MemPhysical()
 #endif
 }
 
+size_t MemPeakResident()
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0;
+  return counters.PeakWorkingSetSize;
+#elif defined __HAIKU__
+  return 0;
+#else
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  // In bytes on macOS, but in kilobytes everywhere else
+  return static_cast<size_t>(usage.ru_maxrss);
+#else
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+size_t MemPageSize()
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwPageSize;
+#else
+  return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
 }  // namespace Common
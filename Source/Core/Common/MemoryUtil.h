@@ -9,6 +9,14 @@
 
 namespace Common
 {
+// The size huge pages are assumed to have, which memory meant to be backed by them is aligned to.
+constexpr size_t HUGE_PAGE_SIZE = 0x200000;
+
+// Whether code space and guest memory ask the host to back them with huge pages. Only affects
+// allocations made after it's set, and is ignored where the host can't provide them.
+void SetHugePagesEnabled(bool enabled);
+bool AreHugePagesEnabled();
+
 void* AllocateExecutableMemory(size_t size);
 void* AllocateMemoryPages(size_t size);
 void FreeMemoryPages(void* ptr, size_t size);
@@ -18,5 +26,9 @@ void ReadProtectMemory(void* ptr, size_t size);
 void WriteProtectMemory(void* ptr, size_t size, bool executable = false);
 void UnWriteProtectMemory(void* ptr, size_t size, bool allowExecute = false);
 size_t MemPhysical();
+// The largest amount of physical memory that this process has used so far, or 0 if unknown.
+size_t MemPeakResident();
+// The granularity of the protection functions above.
+size_t MemPageSize();
 
 }  // namespace Common
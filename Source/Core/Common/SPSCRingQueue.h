@@ -0,0 +1,181 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+// A lockless thread-safe, single producer, single consumer queue backed by ring buffers.
+//
+// Unlike SPSCQueue, pushing and popping doesn't allocate. Elements are stored in a ring buffer of
+// a fixed capacity, and only if the producer gets that far ahead of the consumer, a ring of twice
+// the capacity is chained after it. The consumer frees the old ring once it has drained it, so the
+// queue settles on a ring large enough for its usual length.
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+template <typename T, bool NeedSize = true>
+class SPSCRingQueue
+{
+public:
+  explicit SPSCRingQueue(std::size_t capacity = 64)
+  {
+    std::size_t rounded_capacity = 1;
+    while (rounded_capacity < capacity)
+      rounded_capacity *= 2;
+    m_read_ring = m_write_ring = new Ring(rounded_capacity);
+  }
+
+  ~SPSCRingQueue() { DeleteRings(m_read_ring, nullptr); }
+
+  SPSCRingQueue(const SPSCRingQueue&) = delete;
+  SPSCRingQueue& operator=(const SPSCRingQueue&) = delete;
+
+  u32 Size() const
+  {
+    static_assert(NeedSize, "using Size() on SPSCRingQueue without NeedSize");
+    return static_cast<u32>(m_pushed.load(std::memory_order_acquire) -
+                            m_popped.load(std::memory_order_acquire));
+  }
+
+  // Safe to call from both the producer and the consumer.
+  bool Empty() const
+  {
+    return m_pushed.load(std::memory_order_acquire) == m_popped.load(std::memory_order_acquire);
+  }
+
+  T& Front()
+  {
+    Ring* ring = GetReadRing();
+    return ring->elements[ring->read_index.load(std::memory_order_relaxed) & ring->mask];
+  }
+
+  template <typename Arg>
+  void Push(Arg&& t)
+  {
+    Ring* ring = m_write_ring;
+    const std::size_t write_index = ring->write_index.load(std::memory_order_relaxed);
+    if (write_index - ring->read_index.load(std::memory_order_acquire) > ring->mask)
+    {
+      // The ring is full. Continue in a larger one, which the consumer switches to once it has
+      // drained this one.
+      Ring* new_ring = new Ring((ring->mask + 1) * 2);
+      new_ring->elements[0] = std::forward<Arg>(t);
+      new_ring->write_index.store(1, std::memory_order_relaxed);
+      ring->next.store(new_ring, std::memory_order_release);
+      m_write_ring = new_ring;
+    }
+    else
+    {
+      ring->elements[write_index & ring->mask] = std::forward<Arg>(t);
+      ring->write_index.store(write_index + 1, std::memory_order_release);
+    }
+    m_pushed.store(m_pushed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  void Pop()
+  {
+    Ring* ring = GetReadRing();
+    const std::size_t read_index = ring->read_index.load(std::memory_order_relaxed);
+    // Release what the element holds now rather than when the slot is reused.
+    ring->elements[read_index & ring->mask] = T();
+    ring->read_index.store(read_index + 1, std::memory_order_release);
+    m_popped.store(m_popped.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  bool Pop(T& t)
+  {
+    if (Empty())
+      return false;
+
+    Ring* ring = GetReadRing();
+    const std::size_t read_index = ring->read_index.load(std::memory_order_relaxed);
+    t = std::move(ring->elements[read_index & ring->mask]);
+    ring->read_index.store(read_index + 1, std::memory_order_release);
+    m_popped.store(m_popped.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    return true;
+  }
+
+  // not thread-safe
+  void Clear()
+  {
+    // Keep the newest ring, which is the largest.
+    DeleteRings(m_read_ring, m_write_ring);
+    m_read_ring = m_write_ring;
+    for (std::size_t i = 0; i <= m_write_ring->mask; ++i)
+      m_write_ring->elements[i] = T();
+    m_write_ring->read_index.store(0);
+    m_write_ring->write_index.store(0);
+    m_pushed.store(0);
+    m_popped.store(0);
+  }
+
+private:
+  // Keeps the indices written by different threads on different cache lines.
+  static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+  struct Ring
+  {
+    explicit Ring(std::size_t capacity)
+        : mask(capacity - 1), elements(std::make_unique<T[]>(capacity))
+    {
+    }
+
+    const std::size_t mask;
+    const std::unique_ptr<T[]> elements;
+    // Written by the producer.
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> write_index{0};
+    std::atomic<Ring*> next{nullptr};
+    // Written by the consumer.
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> read_index{0};
+  };
+
+  // Returns the ring the next element is read from, freeing drained rings the producer has
+  // moved on from. Must only be called by the consumer.
+  Ring* GetReadRing()
+  {
+    Ring* ring = m_read_ring;
+    while (true)
+    {
+      const std::size_t read_index = ring->read_index.load(std::memory_order_relaxed);
+      if (read_index != ring->write_index.load(std::memory_order_acquire))
+        return ring;
+
+      Ring* next = ring->next.load(std::memory_order_acquire);
+      if (!next)
+        return ring;
+
+      // The producer doesn't write to a ring after linking the next one, but it may have written
+      // to it between the two loads above.
+      if (read_index != ring->write_index.load(std::memory_order_acquire))
+        return ring;
+
+      delete ring;
+      m_read_ring = ring = next;
+    }
+  }
+
+  static void DeleteRings(Ring* ring, Ring* keep)
+  {
+    while (ring && ring != keep)
+    {
+      Ring* next = ring->next.load();
+      delete ring;
+      ring = next;
+    }
+    if (keep)
+      keep->next.store(nullptr);
+  }
+
+  alignas(CACHE_LINE_SIZE) Ring* m_write_ring;
+  std::atomic<u64> m_pushed{0};
+  alignas(CACHE_LINE_SIZE) Ring* m_read_ring;
+  std::atomic<u64> m_popped{0};
+};
+}  // namespace Common
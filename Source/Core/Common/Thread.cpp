@@ -3,9 +3,17 @@
 // Refer to the license.txt file included.
 
 #include "Common/Thread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <vector>
+
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
 #include "Common/StringUtil.h"
+#include "Common/Tracing.h"
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -14,6 +22,12 @@
 #include <unistd.h>
 #endif
 
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
 #ifdef __APPLE__
 #include <mach/mach.h>
 #elif defined BSD4_4 || defined __FreeBSD__ || defined __OpenBSD__
@@ -113,6 +127,7 @@ void SetCurrentThreadName(const char* name)
 {
   SetCurrentThreadNameViaException(name);
   SetCurrentThreadNameViaApi(name);
+  Tracing::SetCurrentThreadName(name);
 }
 
 #else  // !WIN32, so must be POSIX threads
@@ -183,8 +198,271 @@ void SetCurrentThreadName(const char* name)
   // API.
   __itt_thread_set_name(name);
 #endif
+  Tracing::SetCurrentThreadName(name);
 }
 
 #endif
 
+namespace
+{
+// The logical CPUs the emulation threads are pinned to, one per physical core, and the NUMA node
+// they're on. Empty if the topology couldn't be read or there's nothing to gain from pinning.
+struct PlacementTarget
+{
+  std::vector<u32> cpus;
+#ifdef _WIN32
+  WORD group = 0;
+#endif
+  int numa_node = -1;
+};
+}  // namespace
+
+static std::atomic<bool> s_pin_threads{false};
+static std::atomic<bool> s_numa_local_memory{false};
+
+#if defined __linux__
+
+static std::string ReadSysfsLine(const std::string& path)
+{
+  std::string line;
+  if (FILE* file = std::fopen(path.c_str(), "r"))
+  {
+    char buffer[256];
+    if (std::fgets(buffer, sizeof(buffer), file))
+      line = buffer;
+    std::fclose(file);
+  }
+  return line;
+}
+
+static int GetNumaNode(const std::string& cpu_path)
+{
+  int node = -1;
+  if (DIR* dir = opendir(cpu_path.c_str()))
+  {
+    while (const dirent* entry = readdir(dir))
+    {
+      if (std::sscanf(entry->d_name, "node%d", &node) == 1)
+        break;
+    }
+    closedir(dir);
+  }
+  return node;
+}
+
+static PlacementTarget FindPlacementTarget()
+{
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    return {};
+
+  struct CacheGroup
+  {
+    std::string shared_cpus;
+    PlacementTarget target;
+  };
+  std::vector<CacheGroup> groups;
+  std::vector<std::string> seen_cores;
+
+  for (u32 cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+  {
+    if (!CPU_ISSET(cpu, &allowed))
+      continue;
+
+    const std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+
+    // Only one logical CPU of each physical core is used.
+    const std::string siblings = ReadSysfsLine(path + "/topology/thread_siblings_list");
+    if (!siblings.empty())
+    {
+      if (std::find(seen_cores.begin(), seen_cores.end(), siblings) != seen_cores.end())
+        continue;
+      seen_cores.push_back(siblings);
+    }
+
+    // The CPUs that share the cache with the highest level.
+    int last_level = 0;
+    std::string shared_cpus;
+    for (int index = 0;; ++index)
+    {
+      const std::string cache_path = path + "/cache/index" + std::to_string(index);
+      const std::string level = ReadSysfsLine(cache_path + "/level");
+      if (level.empty())
+        break;
+      if (std::stoi(level) >= last_level)
+      {
+        last_level = std::stoi(level);
+        shared_cpus = ReadSysfsLine(cache_path + "/shared_cpu_list");
+      }
+    }
+
+    auto group = std::find_if(groups.begin(), groups.end(),
+                              [&](const CacheGroup& g) { return g.shared_cpus == shared_cpus; });
+    if (group == groups.end())
+    {
+      group = groups.insert(groups.end(), {shared_cpus, {}});
+      group->target.numa_node = GetNumaNode(path);
+    }
+    group->target.cpus.push_back(cpu);
+  }
+
+  // The group with the most cores, and of those the first one
+  const auto best = std::max_element(
+      groups.begin(), groups.end(), [](const CacheGroup& a, const CacheGroup& b) {
+        return a.target.cpus.size() < b.target.cpus.size();
+      });
+  return best != groups.end() ? best->target : PlacementTarget{};
+}
+
+static void PinCurrentThread(const PlacementTarget&, u32 cpu)
+{
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  sched_setaffinity(0, sizeof(cpu_set), &cpu_set);
+}
+
+#elif defined _WIN32
+
+static PlacementTarget FindPlacementTarget()
+{
+  DWORD size = 0;
+  GetLogicalProcessorInformationEx(RelationAll, nullptr, &size);
+  std::vector<u8> buffer(size);
+  if (!GetLogicalProcessorInformationEx(
+          RelationAll, reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data()),
+          &size))
+  {
+    return {};
+  }
+
+  std::vector<GROUP_AFFINITY> cores;
+  std::vector<std::pair<GROUP_AFFINITY, BYTE>> caches;
+  std::vector<std::pair<GROUP_AFFINITY, DWORD>> nodes;
+  for (DWORD offset = 0; offset < size;)
+  {
+    const auto* info =
+        reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+    if (info->Relationship == RelationProcessorCore)
+      cores.push_back(info->Processor.GroupMask[0]);
+    else if (info->Relationship == RelationCache)
+      caches.emplace_back(info->Cache.GroupMask, info->Cache.Level);
+    else if (info->Relationship == RelationNumaNode)
+      nodes.emplace_back(info->NumaNode.GroupMask, info->NumaNode.NodeNumber);
+    offset += info->Size;
+  }
+
+  const auto contains = [](const GROUP_AFFINITY& outer, const GROUP_AFFINITY& inner) {
+    return outer.Group == inner.Group && (outer.Mask & inner.Mask) == inner.Mask;
+  };
+
+  // Of the caches with the highest level, the one shared by the most cores
+  BYTE last_level = 0;
+  for (const auto& cache : caches)
+    last_level = std::max(last_level, cache.second);
+
+  PlacementTarget best;
+  for (const auto& [cache, level] : caches)
+  {
+    if (level != last_level)
+      continue;
+
+    PlacementTarget target;
+    target.group = cache.Group;
+    for (const GROUP_AFFINITY& core : cores)
+    {
+      if (contains(cache, core))
+      {
+        unsigned long cpu;
+        _BitScanForward64(&cpu, core.Mask);
+        target.cpus.push_back(cpu);
+      }
+    }
+    for (const auto& [node_mask, node] : nodes)
+    {
+      if (contains(node_mask, cache))
+        target.numa_node = static_cast<int>(node);
+    }
+
+    if (target.cpus.size() > best.cpus.size())
+      best = std::move(target);
+  }
+  return best;
+}
+
+static void PinCurrentThread(const PlacementTarget& target, u32 cpu)
+{
+  GROUP_AFFINITY affinity{};
+  affinity.Group = target.group;
+  affinity.Mask = KAFFINITY(1) << cpu;
+  SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr);
+}
+
+#else
+
+static PlacementTarget FindPlacementTarget()
+{
+  return {};
+}
+
+static void PinCurrentThread(const PlacementTarget&, u32)
+{
+}
+
+#endif
+
+static const PlacementTarget& GetPlacementTarget()
+{
+  static const PlacementTarget s_target = [] {
+    PlacementTarget target = FindPlacementTarget();
+    // Sharing a single core would only make the threads take turns.
+    if (target.cpus.size() < 2)
+      target.cpus.clear();
+    return target;
+  }();
+  return s_target;
+}
+
+void SetEmulationThreadPlacement(bool pin_threads, bool numa_local_memory)
+{
+  s_pin_threads = pin_threads;
+  s_numa_local_memory = numa_local_memory;
+}
+
+void PlaceCurrentEmulationThread(EmulationThread thread)
+{
+  if (!s_pin_threads)
+    return;
+
+  const PlacementTarget& target = GetPlacementTarget();
+  if (target.cpus.empty())
+    return;
+
+  // The CPU and GPU threads are the busiest, so they get cores of their own first.
+  const size_t index = static_cast<size_t>(thread) % target.cpus.size();
+  PinCurrentThread(target, target.cpus[index]);
+}
+
+void BindMemoryToEmulationNode(void* ptr, size_t size)
+{
+#if defined __linux__ && defined SYS_mbind
+  if (!s_numa_local_memory)
+    return;
+
+  const int node = GetPlacementTarget().numa_node;
+  if (node < 0)
+    return;
+
+  constexpr int MPOL_PREFERRED = 1;
+  constexpr size_t BITS_PER_LONG = sizeof(unsigned long) * 8;
+  std::vector<unsigned long> node_mask(node / BITS_PER_LONG + 1);
+  node_mask[node / BITS_PER_LONG] |= 1ul << (node % BITS_PER_LONG);
+  syscall(SYS_mbind, ptr, size, MPOL_PREFERRED, node_mask.data(),
+          node_mask.size() * BITS_PER_LONG + 1, 0);
+#else
+  // Elsewhere, pages are allocated on the node of the thread that first touches them, which once
+  // the emulation threads are pinned is the right one anyway.
+#endif
+}
+
 }  // namespace Common
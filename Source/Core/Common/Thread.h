@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <thread>
 
 // Don't include Common.h here as it will break LogManager
@@ -36,4 +37,26 @@ inline void YieldCPU()
 
 void SetCurrentThreadName(const char* name);
 
+// The threads that run the emulation, which are kept apart from each other by the placement
+// policy below.
+enum class EmulationThread
+{
+  CPU,
+  GPU,
+  DSP,
+  Audio,
+};
+
+// Sets where the emulation threads are placed on the host. With pin_threads, each of them is pinned
+// to a physical core of its own, and all of those cores share a last level cache. With
+// numa_local_memory, BindMemoryToEmulationNode prefers the NUMA node those cores are on.
+void SetEmulationThreadPlacement(bool pin_threads, bool numa_local_memory);
+
+// To be called by an emulation thread once it has started, and again if it changes roles.
+void PlaceCurrentEmulationThread(EmulationThread thread);
+
+// Makes the pages of the given range be allocated on the NUMA node of the emulation threads.
+// Only has an effect on pages that aren't allocated yet.
+void BindMemoryToEmulationNode(void* ptr, size_t size);
+
 }  // namespace Common
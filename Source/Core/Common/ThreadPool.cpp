@@ -0,0 +1,167 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/ThreadPool.h"
+
+#include <algorithm>
+
+#include "Common/Thread.h"
+
+namespace Common
+{
+// The pool and worker index of the current thread, if it's a worker.
+static thread_local ThreadPool* s_current_pool = nullptr;
+static thread_local size_t s_current_worker = 0;
+
+ThreadPool::ThreadPool(u32 num_threads, const char* thread_name)
+{
+  num_threads = std::max(num_threads, 1u);
+  m_workers.reserve(num_threads);
+  for (u32 i = 0; i < num_threads; ++i)
+    m_workers.push_back(std::make_unique<Worker>());
+
+  // The workers steal from each other, so all of them have to exist before any of them starts.
+  for (size_t i = 0; i < m_workers.size(); ++i)
+    m_workers[i]->thread = std::thread(&ThreadPool::WorkerThreadRun, this, i, thread_name);
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard lk(m_sleep_lock);
+    m_exit = true;
+  }
+  m_wake.notify_all();
+
+  for (std::unique_ptr<Worker>& worker : m_workers)
+    worker->thread.join();
+}
+
+ThreadPool& ThreadPool::GetShared()
+{
+  static ThreadPool s_shared_pool(std::max(std::thread::hardware_concurrency(), 1u));
+  return s_shared_pool;
+}
+
+void ThreadPool::Submit(TaskPriority priority, std::function<void()> task)
+{
+  const size_t index = s_current_pool == this ?
+                           s_current_worker :
+                           m_next_worker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+  Worker& worker = *m_workers[index];
+  {
+    std::lock_guard lk(worker.lock);
+    worker.queues[static_cast<size_t>(priority)].push_back(std::move(task));
+  }
+
+  {
+    std::lock_guard lk(m_sleep_lock);
+    m_num_queued.fetch_add(1, std::memory_order_relaxed);
+  }
+  m_wake.notify_one();
+}
+
+bool ThreadPool::TryRunTask(size_t index)
+{
+  std::function<void()> task;
+  const auto try_take = [&](Worker& worker, size_t priority, bool own) {
+    std::lock_guard lk(worker.lock);
+    auto& queue = worker.queues[priority];
+    if (queue.empty())
+      return false;
+
+    if (own)
+    {
+      task = std::move(queue.back());
+      queue.pop_back();
+    }
+    else
+    {
+      task = std::move(queue.front());
+      queue.pop_front();
+    }
+    return true;
+  };
+
+  for (size_t priority = 0; priority < NUM_PRIORITIES; ++priority)
+  {
+    bool found = try_take(*m_workers[index], priority, true);
+    for (size_t i = 1; !found && i < m_workers.size(); ++i)
+      found = try_take(*m_workers[(index + i) % m_workers.size()], priority, false);
+
+    if (found)
+    {
+      m_num_queued.fetch_sub(1, std::memory_order_relaxed);
+      task();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ThreadPool::WorkerThreadRun(size_t index, const char* thread_name)
+{
+  Common::SetCurrentThreadName(thread_name);
+  s_current_pool = this;
+  s_current_worker = index;
+
+  while (true)
+  {
+    if (TryRunTask(index))
+      continue;
+
+    std::unique_lock lk(m_sleep_lock);
+    m_wake.wait(lk, [this] { return m_exit || m_num_queued.load(std::memory_order_relaxed) != 0; });
+    if (m_exit)
+      break;
+  }
+}
+
+void ThreadPool::ParallelFor(u32 count, const std::function<void(u32)>& task,
+                             TaskPriority priority, u32 max_threads)
+{
+  if (count == 0)
+    return;
+
+  // Workers may only get to their part after the calls are done and this has returned, so the
+  // state they share with the calling thread is kept alive by them.
+  struct State
+  {
+    const std::function<void(u32)>* task;
+    u32 count;
+    std::atomic<u32> next{0};
+    std::atomic<u32> done{0};
+    std::mutex lock;
+    std::condition_variable all_done;
+  };
+  const auto state = std::make_shared<State>();
+  state->task = &task;
+  state->count = count;
+
+  const auto run = [](State& s) {
+    u32 completed = 0;
+    for (u32 i = s.next++; i < s.count; i = s.next++)
+    {
+      (*s.task)(i);
+      ++completed;
+    }
+
+    if (completed != 0 && s.done.fetch_add(completed) + completed == s.count)
+    {
+      std::lock_guard lk(s.lock);
+      s.all_done.notify_all();
+    }
+  };
+
+  const u32 num_helpers = std::min({count - 1, GetNumThreads(), std::max(max_threads, 1u) - 1});
+  for (u32 i = 0; i < num_helpers; ++i)
+    Submit(priority, [state, run] { run(*state); });
+
+  run(*state);
+
+  std::unique_lock lk(state->lock);
+  state->all_done.wait(lk, [&] { return state->done.load() == count; });
+}
+}  // namespace Common
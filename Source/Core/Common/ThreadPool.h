@@ -0,0 +1,96 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+enum class TaskPriority
+{
+  // Work that something time critical, like the emulated CPU or the GPU thread, is waiting on.
+  High,
+  // Work that should be done soon, but that nothing is blocked on, like compressing a savestate.
+  Background,
+  // Work that is only worth doing when nothing else is, like prefetching.
+  Idle,
+};
+
+// A pool of worker threads which background jobs of all subsystems share, so that the number of
+// threads stays bounded no matter how many jobs are running.
+//
+// Each worker has its own queues, one per priority. Tasks submitted from a worker go to its own
+// queues and are run last in, first out, while idle workers steal the oldest tasks from the
+// others. A task of a higher priority is always taken before one of a lower priority.
+class ThreadPool final
+{
+public:
+  explicit ThreadPool(u32 num_threads, const char* thread_name = "Thread Pool");
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // The pool shared by the whole process, with one thread per core. Created on first use.
+  static ThreadPool& GetShared();
+
+  u32 GetNumThreads() const { return static_cast<u32>(m_workers.size()); }
+
+  void Submit(TaskPriority priority, std::function<void()> task);
+
+  // Unlike with std::async, destroying the returned future doesn't wait for the task.
+  template <typename F>
+  std::future<std::invoke_result_t<F>> Async(TaskPriority priority, F&& function)
+  {
+    using Result = std::invoke_result_t<F>;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(function));
+    std::future<Result> future = task->get_future();
+    Submit(priority, [task = std::move(task)] { (*task)(); });
+    return future;
+  }
+
+  // Calls task(i) for each i in [0, count) on up to max_threads threads, and returns once all of
+  // the calls are done. The calling thread is one of those threads and takes on the calls no
+  // worker has started, so this makes progress even if all workers are busy, or it's called from
+  // a task itself.
+  void ParallelFor(u32 count, const std::function<void(u32)>& task,
+                   TaskPriority priority = TaskPriority::Background, u32 max_threads = ~0u);
+
+private:
+  static constexpr size_t NUM_PRIORITIES = 3;
+
+  struct Worker
+  {
+    std::thread thread;
+    std::mutex lock;
+    std::array<std::deque<std::function<void()>>, NUM_PRIORITIES> queues;
+  };
+
+  void WorkerThreadRun(size_t index, const char* thread_name);
+  bool TryRunTask(size_t index);
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::atomic<size_t> m_next_worker{0};
+
+  // Number of tasks in all of the queues, which the workers sleep on.
+  std::atomic<size_t> m_num_queued{0};
+  std::mutex m_sleep_lock;
+  std::condition_variable m_wake;
+  bool m_exit = false;
+};
+}  // namespace Common
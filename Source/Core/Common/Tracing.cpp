@@ -0,0 +1,199 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/Tracing.h"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+
+namespace Common::Tracing
+{
+namespace detail
+{
+std::atomic<bool> s_enabled{false};
+}
+
+namespace
+{
+// Events are stored in chunks that are never moved, so that Export can read them while the
+// thread keeps appending.
+constexpr size_t EVENTS_PER_CHUNK = 16384;
+// About 100 MiB per thread. Events past that are dropped.
+constexpr size_t MAX_CHUNKS_PER_THREAD = 256;
+
+struct Event
+{
+  const char* name;
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point end;
+};
+
+struct ThreadBuffer
+{
+  // Guards chunks and name against Export. Only the owning thread modifies them.
+  std::mutex mutex;
+  std::vector<std::unique_ptr<std::array<Event, EVENTS_PER_CHUNK>>> chunks;
+  std::string name;
+  u64 thread_id = 0;
+  std::atomic<size_t> size{0};
+};
+
+// Incremented on every Start, so that threads notice that they need a fresh buffer
+std::atomic<u64> s_trace_id{0};
+std::chrono::steady_clock::time_point s_start_time;
+
+std::mutex s_buffers_mutex;
+std::vector<std::shared_ptr<ThreadBuffer>> s_buffers;
+
+std::atomic<u64> s_next_thread_id{1};
+thread_local u64 t_thread_id = 0;
+thread_local std::string t_thread_name;
+thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+thread_local u64 t_buffer_trace_id = 0;
+}  // namespace
+
+static ThreadBuffer* GetThreadBuffer()
+{
+  const u64 trace_id = s_trace_id.load(std::memory_order_acquire);
+  if (t_buffer_trace_id == trace_id)
+    return t_buffer.get();
+
+  if (t_thread_id == 0)
+    t_thread_id = s_next_thread_id++;
+
+  t_buffer = std::make_shared<ThreadBuffer>();
+  t_buffer->name = t_thread_name;
+  t_buffer->thread_id = t_thread_id;
+  t_buffer_trace_id = trace_id;
+
+  std::lock_guard lk(s_buffers_mutex);
+  s_buffers.push_back(t_buffer);
+  return t_buffer.get();
+}
+
+void detail::RecordEvent(const char* name, std::chrono::steady_clock::time_point start,
+                         std::chrono::steady_clock::time_point end)
+{
+  ThreadBuffer* buffer = GetThreadBuffer();
+  const size_t index = buffer->size.load(std::memory_order_relaxed);
+  const size_t chunk = index / EVENTS_PER_CHUNK;
+  if (chunk >= buffer->chunks.size())
+  {
+    if (chunk >= MAX_CHUNKS_PER_THREAD)
+      return;
+
+    std::lock_guard lk(buffer->mutex);
+    buffer->chunks.push_back(std::make_unique<std::array<Event, EVENTS_PER_CHUNK>>());
+  }
+
+  (*buffer->chunks[chunk])[index % EVENTS_PER_CHUNK] = {name, start, end};
+  buffer->size.store(index + 1, std::memory_order_release);
+}
+
+void Start()
+{
+  {
+    std::lock_guard lk(s_buffers_mutex);
+    s_buffers.clear();
+    s_start_time = std::chrono::steady_clock::now();
+    s_trace_id.fetch_add(1, std::memory_order_release);
+  }
+  detail::s_enabled.store(true, std::memory_order_relaxed);
+}
+
+void Stop()
+{
+  detail::s_enabled.store(false, std::memory_order_relaxed);
+}
+
+static std::string EscapeJSON(std::string_view str)
+{
+  std::string result;
+  for (const char c : str)
+  {
+    if (c == '"' || c == '\\')
+      result += '\\';
+    if (static_cast<unsigned char>(c) >= 0x20)
+      result += c;
+  }
+  return result;
+}
+
+bool Export(const std::string& path)
+{
+  File::IOFile file(path, "wb");
+  if (!file)
+    return false;
+
+  std::lock_guard lk(s_buffers_mutex);
+
+  const auto to_us = [](std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration<double, std::micro>(time - s_start_time).count();
+  };
+
+  std::string json = "{\"traceEvents\":[\n";
+  bool first = true;
+  bool success = true;
+  const auto append = [&](const std::string& event) {
+    if (!first)
+      json += ",\n";
+    json += event;
+    first = false;
+
+    // Keep the string from growing too much for long traces.
+    if (json.size() >= 1024 * 1024)
+    {
+      success &= file.WriteString(json);
+      json.clear();
+    }
+  };
+
+  for (const std::shared_ptr<ThreadBuffer>& buffer : s_buffers)
+  {
+    std::lock_guard buffer_lk(buffer->mutex);
+
+    if (!buffer->name.empty())
+    {
+      append(fmt::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                         "\"args\":{{\"name\":\"{}\"}}}}",
+                         buffer->thread_id, EscapeJSON(buffer->name)));
+    }
+
+    const size_t size = buffer->size.load(std::memory_order_acquire);
+    for (size_t i = 0; i < size; ++i)
+    {
+      const Event& event = (*buffer->chunks[i / EVENTS_PER_CHUNK])[i % EVENTS_PER_CHUNK];
+      append(fmt::format("{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},"
+                         "\"dur\":{:.3f}}}",
+                         EscapeJSON(event.name), buffer->thread_id, to_us(event.start),
+                         to_us(event.end) - to_us(event.start)));
+    }
+  }
+
+  json += "\n]}\n";
+  if (!success || !file.WriteString(json))
+    return false;
+
+  NOTICE_LOG_FMT(COMMON, "Wrote trace to {}", path);
+  return true;
+}
+
+void SetCurrentThreadName(const char* name)
+{
+  t_thread_name = name;
+  if (t_buffer)
+  {
+    std::lock_guard lk(t_buffer->mutex);
+    t_buffer->name = name;
+  }
+}
+}  // namespace Common::Tracing
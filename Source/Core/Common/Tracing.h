@@ -0,0 +1,74 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// Records when instrumented scopes start and end on every thread, for viewing in a trace viewer
+// such as chrome://tracing or Perfetto (https://ui.perfetto.dev).
+//
+// While no trace is being recorded, a scope costs one relaxed atomic load. While recording, events
+// go into a buffer that belongs to the thread, so threads don't contend with each other.
+namespace Common::Tracing
+{
+namespace detail
+{
+extern std::atomic<bool> s_enabled;
+
+void RecordEvent(const char* name, std::chrono::steady_clock::time_point start,
+                 std::chrono::steady_clock::time_point end);
+}  // namespace detail
+
+inline bool IsEnabled()
+{
+  return detail::s_enabled.load(std::memory_order_relaxed);
+}
+
+// Discards the events of the previous trace and starts recording.
+void Start();
+// Stops recording. The events are kept until the next Start, so that they can be exported.
+void Stop();
+// Writes the recorded events in the Chrome trace event JSON format, which Perfetto also reads.
+bool Export(const std::string& path);
+
+// Names the current thread in traces. Called by Common::SetCurrentThreadName.
+void SetCurrentThreadName(const char* name);
+
+class Scope
+{
+public:
+  // The name must be a string literal (or otherwise outlive the trace).
+  explicit Scope(const char* name)
+  {
+    if (IsEnabled())
+    {
+      m_name = name;
+      m_start = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~Scope()
+  {
+    if (m_name)
+      detail::RecordEvent(m_name, m_start, std::chrono::steady_clock::now());
+  }
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+private:
+  const char* m_name = nullptr;
+  std::chrono::steady_clock::time_point m_start;
+};
+}  // namespace Common::Tracing
+
+#define TRACE_SCOPE_CONCAT_INNER(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name)                                                                          \
+  const Common::Tracing::Scope TRACE_SCOPE_CONCAT(trace_scope_, __LINE__)(name)
@@ -1,16 +1,21 @@
 // This file is public domain, in case it's useful to anyone. -comex
 
 // The central server implementation.
+#include <algorithm>
 #include <arpa/inet.h>
+#include <array>
 #include <cerrno>
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <fcntl.h>
+#include <mutex>
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+#include <thread>
 #include <unistd.h>
 #include <unordered_map>
 #include <utility>
@@ -26,7 +31,14 @@
 #define DEBUG 0
 #define NUMBER_OF_TRIES 5
 #define PORT 6262
-
+// Packets received or sent with one system call
+#define BATCH_SIZE 64
+#define CLIENT_EXPIRY_TIME (30 * 1000000)  // 30s
+#define RESEND_INTERVAL 300000             // 300ms, multiplied by the number of tries
+
+// Everything below is shared by the worker threads and guarded by stateLock, which is taken once
+// per received batch. Only receiving and sending happen outside of it.
+static std::mutex stateLock;
 static u64 currentTime;
 
 struct OutgoingPacketInfo
@@ -38,68 +50,63 @@ struct OutgoingPacketInfo
   u64 sendTime;
 };
 
-template <typename T>
-struct EvictEntry
+struct ClientInfo
 {
   u64 updateTime;
-  T value;
+  TraversalInetAddress address;
 };
 
-template <typename V>
-struct EvictFindResult
+struct QueuedPacket
 {
-  bool found;
-  V* value;
+  TraversalPacket packet;
+  sockaddr_in6 dest;
 };
 
-template <typename K, typename V>
-EvictFindResult<V> EvictFind(std::unordered_map<K, EvictEntry<V>>& map, const K& key,
-                             bool refresh = false)
+// Buckets of keys by the tick in which they need to be looked at again. Keys are not removed
+// from their bucket when the deadline changes or the entry goes away; whoever drains a bucket
+// looks the key up and either handles it or schedules it again. That keeps refreshing an entry
+// free, and expiring entries costs nothing for the entries which don't expire.
+template <typename K>
+class TimingWheel
 {
-retry:
-  const u64 expiryTime = 30 * 1000000;  // 30s
-  EvictFindResult<V> result;
-  if (map.bucket_count())
+public:
+  TimingWheel(u64 tickLength, size_t numSlots) : m_tickLength(tickLength), m_slots(numSlots) {}
+
+  void Start(u64 time) { m_nextTick = time / m_tickLength; }
+
+  // Deadlines further away than the wheel covers are handed out early, and have to be scheduled
+  // again.
+  void Schedule(const K& key, u64 deadline)
   {
-    auto bucket = map.bucket(key);
-    auto it = map.begin(bucket);
-    for (; it != map.end(bucket); ++it)
-    {
-      if (currentTime - it->second.updateTime > expiryTime)
-      {
-        map.erase(it->first);
-        goto retry;
-      }
-      if (it->first == key)
-      {
-        if (refresh)
-          it->second.updateTime = currentTime;
-        result.found = true;
-        result.value = &it->second.value;
-        return result;
-      }
-    }
+    const u64 tick = std::clamp<u64>(deadline / m_tickLength, m_nextTick,
+                                      m_nextTick + m_slots.size() - 1);
+    m_slots[tick % m_slots.size()].push_back(key);
   }
-#if DEBUG
-  printf("failed to find key '");
-  for (size_t i = 0; i < sizeof(key); i++)
+
+  // Calls f for the keys of all ticks which have passed completely by time.
+  template <typename F>
+  void Advance(u64 time, F f)
   {
-    printf("%02x", ((u8*)&key)[i]);
+    const u64 endTick = time / m_tickLength;
+    if (endTick > m_nextTick + m_slots.size())
+      m_nextTick = endTick - m_slots.size();
+
+    while (m_nextTick < endTick)
+    {
+      std::swap(m_draining, m_slots[m_nextTick % m_slots.size()]);
+      m_nextTick++;
+      for (const K& key : m_draining)
+        f(key);
+      m_draining.clear();
+    }
   }
-  printf("'\n");
-#endif
-  result.found = false;
-  return result;
-}
 
-template <typename K, typename V>
-V* EvictSet(std::unordered_map<K, EvictEntry<V>>& map, const K& key)
-{
-  // can't use a local_iterator to emplace...
-  auto& result = map[key];
-  result.updateTime = currentTime;
-  return &result.value;
-}
+private:
+  u64 m_tickLength;
+  u64 m_nextTick = 0;
+  std::vector<std::vector<K>> m_slots;
+  std::vector<K> m_draining;
+};
 
 namespace std
 {
@@ -114,9 +121,59 @@ struct hash<TraversalHostId>
 };
 }  // namespace std
 
-static int sock;
 static std::unordered_map<TraversalRequestId, OutgoingPacketInfo> outgoingPackets;
-static std::unordered_map<TraversalHostId, EvictEntry<TraversalInetAddress>> connectedClients;
+static std::unordered_map<TraversalHostId, ClientInfo> connectedClients;
+// Packets which were allocated while handling the current batch and still need their first send
+static std::vector<TraversalRequestId> newPackets;
+static TimingWheel<TraversalRequestId> resendWheel(100000, 64);  // 100ms ticks
+static TimingWheel<TraversalHostId> clientExpiryWheel(1000000, 64);  // 1s ticks
+
+// The packets this worker thread sends once it has released stateLock
+static thread_local std::vector<QueuedPacket> sendQueue;
+
+static TraversalInetAddress* FindClient(const TraversalHostId& hostId, bool refresh = false)
+{
+  auto it = connectedClients.find(hostId);
+  // Expired clients are only erased when their tick in the wheel has passed
+  if (it == connectedClients.end() || currentTime - it->second.updateTime > CLIENT_EXPIRY_TIME)
+  {
+#if DEBUG
+    printf("failed to find key '");
+    for (size_t i = 0; i < sizeof(hostId); i++)
+    {
+      printf("%02x", ((u8*)&hostId)[i]);
+    }
+    printf("'\n");
+#endif
+    return nullptr;
+  }
+  if (refresh)
+    it->second.updateTime = currentTime;
+  return &it->second.address;
+}
+
+static TraversalInetAddress* AddClient(const TraversalHostId& hostId)
+{
+  // Every client in the map is in the wheel exactly once, so an expired client which is replaced
+  // keeps its place.
+  const auto [it, inserted] = connectedClients.try_emplace(hostId);
+  it->second.updateTime = currentTime;
+  if (inserted)
+    clientExpiryWheel.Schedule(hostId, currentTime + CLIENT_EXPIRY_TIME);
+  return &it->second.address;
+}
+
+static void ExpireClient(const TraversalHostId& hostId)
+{
+  auto it = connectedClients.find(hostId);
+  if (it == connectedClients.end())
+    return;
+  const u64 expiryTime = it->second.updateTime + CLIENT_EXPIRY_TIME;
+  if (currentTime > expiryTime)
+    connectedClients.erase(it);
+  else
+    clientExpiryWheel.Schedule(hostId, expiryTime + 1);
+}
 
 static TraversalInetAddress MakeInetAddress(const sockaddr_in6& addr)
 {
@@ -182,17 +239,51 @@ static const char* SenderName(sockaddr_in6* addr)
   return buf;
 }
 
-static void TrySend(const void* buffer, size_t size, sockaddr_in6* addr)
+static void TrySend(const TraversalPacket& packet, sockaddr_in6* addr)
 {
 #if DEBUG
-  const auto* packet = static_cast<const TraversalPacket*>(buffer);
-  printf("-> %d %llu %s\n", static_cast<int>(packet->type),
-         static_cast<long long>(packet->requestId), SenderName(addr));
+  printf("-> %d %llu %s\n", static_cast<int>(packet.type),
+         static_cast<long long>(packet.requestId), SenderName(addr));
 #endif
-  if ((size_t)sendto(sock, buffer, size, 0, (sockaddr*)addr, sizeof(*addr)) != size)
+  sendQueue.push_back({packet, *addr});
+}
+
+static void FlushSendQueue(int sock)
+{
+#ifdef __linux__
+  std::array<mmsghdr, BATCH_SIZE> msgs;
+  std::array<iovec, BATCH_SIZE> iovs;
+  for (size_t i = 0; i < sendQueue.size();)
   {
-    perror("sendto");
+    const size_t count = std::min<size_t>(sendQueue.size() - i, BATCH_SIZE);
+    for (size_t j = 0; j < count; j++)
+    {
+      QueuedPacket& queued = sendQueue[i + j];
+      iovs[j].iov_base = &queued.packet;
+      iovs[j].iov_len = sizeof(queued.packet);
+      msgs[j] = {};
+      msgs[j].msg_hdr.msg_name = &queued.dest;
+      msgs[j].msg_hdr.msg_namelen = sizeof(queued.dest);
+      msgs[j].msg_hdr.msg_iov = &iovs[j];
+      msgs[j].msg_hdr.msg_iovlen = 1;
+    }
+    // Stops at the first packet which fails, which is then only reported, like with sendto
+    const int rv = sendmmsg(sock, msgs.data(), static_cast<unsigned int>(count), 0);
+    if (rv < 0)
+      perror("sendmmsg");
+    i += std::max(rv, 1);
+  }
+#else
+  for (QueuedPacket& queued : sendQueue)
+  {
+    if ((size_t)sendto(sock, &queued.packet, sizeof(queued.packet), 0, (sockaddr*)&queued.dest,
+                       sizeof(queued.dest)) != sizeof(queued.packet))
+    {
+      perror("sendto");
+    }
   }
+#endif
+  sendQueue.clear();
 }
 
 static TraversalPacket* AllocPacket(const sockaddr_in6& dest, TraversalRequestId misc = 0)
@@ -204,52 +295,74 @@ static TraversalPacket* AllocPacket(const sockaddr_in6& dest, TraversalRequestId
   info->misc = misc;
   info->tries = 0;
   info->sendTime = currentTime;
+  newPackets.push_back(requestId);
   TraversalPacket* result = &info->packet;
   memset(result, 0, sizeof(*result));
   result->requestId = requestId;
   return result;
 }
 
-static void SendPacket(OutgoingPacketInfo* info)
+static void SendPacket(TraversalRequestId requestId, OutgoingPacketInfo* info)
 {
   info->tries++;
   info->sendTime = currentTime;
-  TrySend(&info->packet, sizeof(info->packet), &info->dest);
+  resendWheel.Schedule(requestId, currentTime + (u64)(RESEND_INTERVAL * info->tries));
+  TrySend(info->packet, &info->dest);
 }
 
-static void ResendPackets()
+static void SendNewPackets()
 {
-  std::vector<std::pair<TraversalInetAddress, TraversalRequestId>> todoFailures;
-  todoFailures.clear();
-  for (auto it = outgoingPackets.begin(); it != outgoingPackets.end();)
+  for (TraversalRequestId requestId : newPackets)
   {
-    OutgoingPacketInfo* info = &it->second;
-    if (currentTime - info->sendTime >= (u64)(300000 * info->tries))
-    {
-      if (info->tries >= NUMBER_OF_TRIES)
-      {
-        if (info->packet.type == TraversalPacketType::PleaseSendPacket)
-        {
-          todoFailures.push_back(std::make_pair(info->packet.pleaseSendPacket.address, info->misc));
-        }
-        it = outgoingPackets.erase(it);
-        continue;
-      }
-      else
-      {
-        SendPacket(info);
-      }
-    }
-    ++it;
+    auto it = outgoingPackets.find(requestId);
+    if (it != outgoingPackets.end() && it->second.tries == 0)
+      SendPacket(requestId, &it->second);
+  }
+  newPackets.clear();
+}
+
+static void ResendPacket(TraversalRequestId requestId)
+{
+  // Packets which were acked are gone from the map but not from the wheel
+  auto it = outgoingPackets.find(requestId);
+  if (it == outgoingPackets.end())
+    return;
+
+  OutgoingPacketInfo* info = &it->second;
+  const u64 resendTime = info->sendTime + (u64)(RESEND_INTERVAL * info->tries);
+  if (currentTime < resendTime)
+  {
+    resendWheel.Schedule(requestId, resendTime);
+    return;
   }
 
-  for (const auto& p : todoFailures)
+  if (info->tries < NUMBER_OF_TRIES)
   {
-    TraversalPacket* fail = AllocPacket(MakeSinAddr(p.first));
-    fail->type = TraversalPacketType::ConnectFailed;
-    fail->connectFailed.requestId = p.second;
-    fail->connectFailed.reason = TraversalConnectFailedReason::ClientDidntRespond;
+    SendPacket(requestId, info);
+    return;
   }
+
+  if (info->packet.type != TraversalPacketType::PleaseSendPacket)
+  {
+    outgoingPackets.erase(it);
+    return;
+  }
+
+  const sockaddr_in6 dest = MakeSinAddr(info->packet.pleaseSendPacket.address);
+  const TraversalRequestId misc = info->misc;
+  outgoingPackets.erase(it);
+
+  TraversalPacket* fail = AllocPacket(dest);
+  fail->type = TraversalPacketType::ConnectFailed;
+  fail->connectFailed.requestId = misc;
+  fail->connectFailed.reason = TraversalConnectFailedReason::ClientDidntRespond;
+}
+
+static void ProcessTimers()
+{
+  resendWheel.Advance(currentTime, ResendPacket);
+  clientExpiryWheel.Advance(currentTime, ExpireClient);
+  SendNewPackets();
 }
 
 static void HandlePacket(TraversalPacket* packet, sockaddr_in6* addr)
@@ -291,8 +404,7 @@ static void HandlePacket(TraversalPacket* packet, sockaddr_in6* addr)
   }
   case TraversalPacketType::Ping:
   {
-    auto r = EvictFind(connectedClients, packet->ping.hostId, true);
-    packetOk = r.found;
+    packetOk = FindClient(packet->ping.hostId, true) != nullptr;
     break;
   }
   case TraversalPacketType::HelloFromClient:
@@ -308,15 +420,9 @@ static void HandlePacket(TraversalPacket* packet, sockaddr_in6* addr)
       // not that there is any significant change of
       // duplication, but...
       GetRandomHostId(&hostId);
-      while (true)
-      {
-        auto r = EvictFind(connectedClients, hostId);
-        if (!r.found)
-        {
-          iaddr = EvictSet(connectedClients, hostId);
-          break;
-        }
-      }
+      while (FindClient(hostId))
+        GetRandomHostId(&hostId);
+      iaddr = AddClient(hostId);
 
       *iaddr = MakeInetAddress(*addr);
 
@@ -328,8 +434,8 @@ static void HandlePacket(TraversalPacket* packet, sockaddr_in6* addr)
   case TraversalPacketType::ConnectPlease:
   {
     TraversalHostId& hostId = packet->connectPlease.hostId;
-    auto r = EvictFind(connectedClients, hostId);
-    if (!r.found)
+    const TraversalInetAddress* hostAddress = FindClient(hostId);
+    if (!hostAddress)
     {
       TraversalPacket* reply = AllocPacket(*addr);
       reply->type = TraversalPacketType::ConnectFailed;
@@ -338,7 +444,7 @@ static void HandlePacket(TraversalPacket* packet, sockaddr_in6* addr)
     }
     else
     {
-      TraversalPacket* please = AllocPacket(MakeSinAddr(*r.value), packet->requestId);
+      TraversalPacket* please = AllocPacket(MakeSinAddr(*hostAddress), packet->requestId);
       please->type = TraversalPacketType::PleaseSendPacket;
       please->pleaseSendPacket.address = MakeInetAddress(*addr);
     }
@@ -355,26 +461,46 @@ static void HandlePacket(TraversalPacket* packet, sockaddr_in6* addr)
     ack.type = TraversalPacketType::Ack;
     ack.requestId = packet->requestId;
     ack.ack.ok = packetOk;
-    TrySend(&ack, sizeof(ack), addr);
+    TrySend(ack, addr);
   }
 }
 
-int main()
+static u64 GetCurrentTime()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static int OpenSocket(bool reusePort)
 {
   int rv;
-  sock = socket(PF_INET6, SOCK_DGRAM, 0);
+  const int sock = socket(PF_INET6, SOCK_DGRAM, 0);
   if (sock == -1)
   {
     perror("socket");
-    return 1;
+    return -1;
   }
   int no = 0;
   rv = setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY, &no, sizeof(no));
   if (rv < 0)
   {
     perror("setsockopt IPV6_V6ONLY");
-    return 1;
+    return -1;
   }
+#ifdef SO_REUSEPORT
+  if (reusePort)
+  {
+    // Each worker thread has its own socket, and the kernel spreads the clients over them
+    int yes = 1;
+    rv = setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes));
+    if (rv < 0)
+    {
+      perror("setsockopt SO_REUSEPORT");
+      return -1;
+    }
+  }
+#endif
   in6_addr any = IN6ADDR_ANY_INIT;
   sockaddr_in6 addr;
 #ifdef SIN6_LEN
@@ -390,9 +516,10 @@ int main()
   if (rv < 0)
   {
     perror("bind");
-    return 1;
+    return -1;
   }
 
+  // Wake up regularly even without packets, for resends and expiry
   timeval tv;
   tv.tv_sec = 0;
   tv.tv_usec = 300000;
@@ -400,43 +527,104 @@ int main()
   if (rv < 0)
   {
     perror("setsockopt SO_RCVTIMEO");
-    return 1;
+    return -1;
   }
+  return sock;
+}
 
-#ifdef HAVE_LIBSYSTEMD
-  sd_notifyf(0, "READY=1\nSTATUS=Listening on port %d", PORT);
+static void RunWorker(int sock)
+{
+  std::array<TraversalPacket, BATCH_SIZE> packets;
+  std::array<sockaddr_in6, BATCH_SIZE> addrs;
+  std::array<size_t, BATCH_SIZE> sizes;
+#ifdef __linux__
+  std::array<iovec, BATCH_SIZE> iovs;
+  std::array<mmsghdr, BATCH_SIZE> msgs;
+  for (size_t i = 0; i < BATCH_SIZE; i++)
+  {
+    iovs[i].iov_base = &packets[i];
+    iovs[i].iov_len = sizeof(packets[i]);
+    msgs[i] = {};
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
 #endif
 
   while (true)
   {
-    sockaddr_in6 raddr;
-    socklen_t addrLen = sizeof(raddr);
-    TraversalPacket packet;
-    // note: switch to recvmmsg (yes, mmsg) if this becomes
-    // expensive
-    rv = recvfrom(sock, &packet, sizeof(packet), 0, (sockaddr*)&raddr, &addrLen);
-    currentTime = std::chrono::duration_cast<std::chrono::microseconds>(
-                      std::chrono::system_clock::now().time_since_epoch())
-                      .count();
-    if (rv < 0)
+    int count;
+#ifdef __linux__
+    for (mmsghdr& msg : msgs)
+      msg.msg_hdr.msg_namelen = sizeof(sockaddr_in6);
+    // Blocks until the first packet arrives, then takes whatever else is already queued
+    count = recvmmsg(sock, msgs.data(), BATCH_SIZE, MSG_WAITFORONE, nullptr);
+    for (int i = 0; i < count; i++)
+      sizes[i] = msgs[i].msg_len;
+#else
+    socklen_t addrLen = sizeof(addrs[0]);
+    const ssize_t rv =
+        recvfrom(sock, &packets[0], sizeof(packets[0]), 0, (sockaddr*)&addrs[0], &addrLen);
+    count = rv < 0 ? -1 : 1;
+    sizes[0] = rv < 0 ? 0 : (size_t)rv;
+#endif
+    if (count < 0)
     {
       if (errno != EINTR && errno != EAGAIN)
       {
-        perror("recvfrom");
-        return 1;
+        perror("recv");
+        exit(1);
       }
+      count = 0;
     }
-    else if ((size_t)rv < sizeof(packet))
-    {
-      fprintf(stderr, "received short packet from %s\n", SenderName(&raddr));
-    }
-    else
+
     {
-      HandlePacket(&packet, &raddr);
+      std::lock_guard<std::mutex> lk(stateLock);
+      currentTime = std::max(currentTime, GetCurrentTime());
+      for (int i = 0; i < count; i++)
+      {
+        if (sizes[i] < sizeof(packets[i]))
+          fprintf(stderr, "received short packet from %s\n", SenderName(&addrs[i]));
+        else
+          HandlePacket(&packets[i], &addrs[i]);
+      }
+      ProcessTimers();
     }
-    ResendPackets();
+    FlushSendQueue(sock);
 #ifdef HAVE_LIBSYSTEMD
     sd_notify(0, "WATCHDOG=1");
 #endif
   }
 }
+
+int main()
+{
+#ifdef __linux__
+  // Linux balances the packets of sockets sharing a port by their source address
+  const unsigned int numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+#else
+  const unsigned int numThreads = 1;
+#endif
+
+  std::vector<int> sockets;
+  for (unsigned int i = 0; i < numThreads; i++)
+  {
+    const int sock = OpenSocket(numThreads > 1);
+    if (sock == -1)
+      return 1;
+    sockets.push_back(sock);
+  }
+
+  currentTime = GetCurrentTime();
+  resendWheel.Start(currentTime);
+  clientExpiryWheel.Start(currentTime);
+
+#ifdef HAVE_LIBSYSTEMD
+  sd_notifyf(0, "READY=1\nSTATUS=Listening on port %d", PORT);
+#endif
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < sockets.size(); i++)
+    threads.emplace_back(RunWorker, sockets[i]);
+  RunWorker(sockets[0]);
+}
@@ -130,6 +130,8 @@ void CPUInfo::Detect()
       bSSE2 = true;
     if ((cpu_id[2]) & 1)
       bSSE3 = true;
+    if ((cpu_id[2] >> 1) & 1)
+      bPCLMULQDQ = true;
     if ((cpu_id[2] >> 9) & 1)
       bSSSE3 = true;
     if ((cpu_id[2] >> 19) & 1)
@@ -171,6 +173,11 @@ void CPUInfo::Detect()
         bBMI1 = true;
       if ((cpu_id[1] >> 8) & 1)
         bBMI2 = true;
+      if ((cpu_id[1] >> 29) & 1)
+      {
+        bSHA1 = true;
+        bSHA2 = true;
+      }
     }
   }
 
@@ -270,6 +277,10 @@ std::string CPUInfo::Summarize()
     sum += ", FMA";
   if (bAES)
     sum += ", AES";
+  if (bPCLMULQDQ)
+    sum += ", PCLMULQDQ";
+  if (bSHA1)
+    sum += ", SHA";
   if (bMOVBE)
     sum += ", MOVBE";
   if (bLongMode)
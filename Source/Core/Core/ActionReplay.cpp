@@ -80,16 +80,6 @@ enum
   SUB_MASTER_CODE = 0x03,
 };
 
-// General lock. Protects codes list and internal log.
-static std::mutex s_lock;
-static std::vector<ARCode> s_active_codes;
-static std::vector<ARCode> s_synced_codes;
-static std::vector<std::string> s_internal_log;
-static std::atomic<bool> s_use_internal_log{false};
-// pointer to the code currently being run, (used by log messages that include the code name)
-static const ARCode* s_current_code = nullptr;
-static bool s_disable_logging = false;
-
 struct ARAddr
 {
   union
@@ -109,6 +99,156 @@ struct ARAddr
   operator u32() const { return address; }
 };
 
+enum class ARInstructionType : u8
+{
+  Nop,
+  End,
+  ZeroCodeNormal,
+  ZeroCodeRow,
+  ZeroCodeUnknown,
+  FillAndSlide,
+  MemoryCopy,
+  SelfModification,
+  NormalCode,
+  ConditionalCode,
+};
+
+// An AR code line decoded ahead of time. Fill and slide and memory copy instructions take their
+// parameters from the zero code line and their address and data from the following line.
+// Instructions are indexed by the line they start at, since conditionals skip a number of lines.
+struct ARInstruction
+{
+  ARInstructionType type;
+  ARAddr addr;
+  u32 data;
+  u32 val_last;
+  // Line to continue at afterwards, and when a conditional code's comparison fails.
+  u32 next;
+  u32 skip_target;
+};
+
+struct ActiveCode
+{
+  ARCode code;
+  std::vector<ARInstruction> instructions;
+};
+
+// General lock. Protects codes list and internal log.
+static std::mutex s_lock;
+static std::vector<ActiveCode> s_active_codes;
+static std::vector<ARCode> s_synced_codes;
+static std::vector<std::string> s_internal_log;
+static std::atomic<bool> s_use_internal_log{false};
+// pointer to the code currently being run, (used by log messages that include the code name)
+static const ARCode* s_current_code = nullptr;
+static bool s_disable_logging = false;
+
+static std::vector<ARInstruction> CompileCode(const ARCode& arcode)
+{
+  const std::vector<AREntry>& ops = arcode.ops;
+  const u32 count = static_cast<u32>(ops.size());
+
+  std::vector<ARInstruction> instructions;
+  instructions.reserve(count);
+  for (u32 i = 0; i < count; ++i)
+  {
+    const ARAddr addr(ops[i].cmd_addr);
+    const u32 data = ops[i].value;
+    ARInstruction& inst =
+        instructions.emplace_back(ARInstruction{ARInstructionType::Nop, addr, data, 0, i + 1, 0});
+
+    // ActionReplay program self modification codes
+    if (addr >= 0x00002000 && addr < 0x00003000)
+    {
+      inst.type = ARInstructionType::SelfModification;
+    }
+    else if (0x0 == addr)  // Zero codes
+    {
+      switch (data >> 29)
+      {
+      case ZCODE_END:
+        inst.type = ARInstructionType::End;
+        break;
+
+      case ZCODE_NORM:
+        inst.type = ARInstructionType::ZeroCodeNormal;
+        break;
+
+      case ZCODE_ROW:
+        inst.type = ARInstructionType::ZeroCodeRow;
+        break;
+
+      case ZCODE_04:
+        // Without a following line there is nothing left to do.
+        if (i + 1 < count)
+        {
+          inst.type = 0x3 == ((data >> 25) & 0x03) ? ARInstructionType::MemoryCopy :
+                                                      ARInstructionType::FillAndSlide;
+          inst.addr = ARAddr(ops[i + 1].cmd_addr);
+          inst.data = ops[i + 1].value;
+          inst.val_last = data;
+          inst.next = i + 2;
+        }
+        break;
+
+      default:
+        inst.type = ARInstructionType::ZeroCodeUnknown;
+        break;
+      }
+    }
+    else if (addr.type == 0x00)
+    {
+      inst.type = ARInstructionType::NormalCode;
+    }
+    else
+    {
+      inst.type = ARInstructionType::ConditionalCode;
+      switch (addr.subtype)
+      {
+      case CONDTIONAL_ONE_LINE:
+      case CONDTIONAL_TWO_LINES:
+        inst.skip_target = std::min(i + 2 + addr.subtype, count);
+        break;
+
+      case CONDTIONAL_ALL_LINES_UNTIL:
+      {
+        // Skip past the next "00000000 40000000" line
+        const auto end_if = std::find(ops.begin() + i + 1, ops.end(), AREntry(0, 0x40000000));
+        inst.skip_target = std::min(static_cast<u32>(end_if - ops.begin()) + 1, count);
+        break;
+      }
+
+      case CONDTIONAL_ALL_LINES:
+      default:
+        inst.skip_target = count;
+        break;
+      }
+    }
+  }
+
+  return instructions;
+}
+
+// Must be called with s_lock held.
+static void AddActiveCodeLocked(ARCode code)
+{
+  std::vector<ARInstruction> instructions = CompileCode(code);
+  s_active_codes.push_back({std::move(code), std::move(instructions)});
+}
+
+// Must be called with s_lock held.
+static void SetActiveCodesLocked(const std::vector<ARCode>& codes)
+{
+  s_disable_logging = false;
+  s_active_codes.clear();
+  for (const ARCode& code : codes)
+  {
+    if (code.enabled)
+      AddActiveCodeLocked(code);
+  }
+  s_active_codes.shrink_to_fit();
+}
+
 // ----------------------
 // AR Remote Functions
 void ApplyCodes(const std::vector<ARCode>& codes)
@@ -117,18 +257,15 @@ void ApplyCodes(const std::vector<ARCode>& codes)
     return;
 
   std::lock_guard guard(s_lock);
-  s_disable_logging = false;
-  s_active_codes.clear();
-  std::copy_if(codes.begin(), codes.end(), std::back_inserter(s_active_codes),
-               [](const ARCode& code) { return code.enabled; });
-  s_active_codes.shrink_to_fit();
+  SetActiveCodesLocked(codes);
 }
 
 void SetSyncedCodesAsActive()
 {
   s_active_codes.clear();
   s_active_codes.reserve(s_synced_codes.size());
-  s_active_codes = s_synced_codes;
+  for (const ARCode& code : s_synced_codes)
+    AddActiveCodeLocked(code);
 }
 
 void UpdateSyncedCodes(const std::vector<ARCode>& codes)
@@ -145,14 +282,14 @@ std::vector<ARCode> ApplyAndReturnCodes(const std::vector<ARCode>& codes)
   if (SConfig::GetInstance().bEnableCheats)
   {
     std::lock_guard guard(s_lock);
-    s_disable_logging = false;
-    s_active_codes.clear();
-    std::copy_if(codes.begin(), codes.end(), std::back_inserter(s_active_codes),
-                 [](const ARCode& code) { return code.enabled; });
+    SetActiveCodesLocked(codes);
   }
-  s_active_codes.shrink_to_fit();
 
-  return s_active_codes;
+  std::vector<ARCode> active_codes;
+  active_codes.reserve(s_active_codes.size());
+  for (const ActiveCode& active_code : s_active_codes)
+    active_codes.push_back(active_code.code);
+  return active_codes;
 }
 
 void AddCode(ARCode code)
@@ -164,7 +301,7 @@ void AddCode(ARCode code)
   {
     std::lock_guard guard(s_lock);
     s_disable_logging = false;
-    s_active_codes.emplace_back(std::move(code));
+    AddActiveCodeLocked(std::move(code));
   }
 }
 
@@ -813,159 +950,102 @@ static bool ConditionalCode(const ARAddr& addr, const u32 data, int* const pSkip
 }
 
 // NOTE: Lock needed to give mutual exclusion to s_current_code and LogInfo
-static bool RunCodeLocked(const ARCode& arcode)
+static bool RunCodeLocked(const ActiveCode& active_code)
 {
   // The mechanism is different than what the real AR uses, so there may be compatibility problems.
 
-  bool do_fill_and_slide = false;
-  bool do_memory_copy = false;
-
-  // used for conditional codes
-  int skip_count = 0;
-
-  u32 val_last = 0;
+  const ARCode& arcode = active_code.code;
+  const std::vector<ARInstruction>& instructions = active_code.instructions;
 
   s_current_code = &arcode;
 
   LogInfo("Code Name: {}", arcode.name);
   LogInfo("Number of codes: {}", arcode.ops.size());
 
-  for (const AREntry& entry : arcode.ops)
+  u32 line = 0;
+  while (line < instructions.size())
   {
-    const ARAddr addr(entry.cmd_addr);
-    const u32 data = entry.value;
+    const ARInstruction& inst = instructions[line];
+    const ARAddr& addr = inst.addr;
+    const u32 data = inst.data;
+    line = inst.next;
 
-    // after a conditional code, skip lines if needed
-    if (skip_count)
+    LogInfo("--- Running Code: {:08x} {:08x} ---", addr.address, data);
+
+    switch (inst.type)
     {
-      if (skip_count > 0)  // skip x lines
-      {
-        LogInfo("Line skipped");
-        --skip_count;
-      }
-      else if (-CONDTIONAL_ALL_LINES == skip_count)
-      {
-        // skip all lines
-        LogInfo("All Lines skipped");
-        return true;  // don't need to iterate through the rest of the ops
-      }
-      else if (-CONDTIONAL_ALL_LINES_UNTIL == skip_count)
-      {
-        // skip until a "00000000 40000000" line is reached
-        LogInfo("Line skipped");
-        if (addr == 0 && 0x40000000 == data)  // check for an endif line
-          skip_count = 0;
-      }
+    case ARInstructionType::Nop:
+      break;
 
-      continue;
-    }
+    case ARInstructionType::End:
+      LogInfo("ZCode: End Of Codes");
+      return true;
 
-    LogInfo("--- Running Code: {:08x} {:08x} ---", addr.address, data);
+    // TODO: the "00000000 40000000"(end if) codes fall into this case, I don't think that is
+    // correct
+    case ARInstructionType::ZeroCodeNormal:
+      // Todo: Set register 1BB4 to 0
+      LogInfo("ZCode: Normal execution of codes, set register 1BB4 to 0 (zcode not supported)");
+      break;
 
-    // Do Fill & Slide
-    if (do_fill_and_slide)
-    {
-      do_fill_and_slide = false;
+    case ARInstructionType::ZeroCodeRow:
+      // Todo: Set register 1BB4 to 1
+      LogInfo("ZCode: Executes all codes in the same row, Set register 1BB4 to 1 (zcode not "
+              "supported)");
+      PanicAlertFmtT("Zero 3 code not supported");
+      return false;
+
+    case ARInstructionType::ZeroCodeUnknown:
+      LogInfo("ZCode: Unknown");
+      PanicAlertFmtT("Zero code unknown to Dolphin: {0:08x}", data >> 29);
+      return false;
+
+    case ARInstructionType::FillAndSlide:
       LogInfo("Doing Fill And Slide");
-      if (false == ZeroCode_FillAndSlide(val_last, addr, data))
+      if (false == ZeroCode_FillAndSlide(inst.val_last, addr, data))
         return false;
-      continue;
-    }
+      break;
 
-    // Memory Copy
-    if (do_memory_copy)
-    {
-      do_memory_copy = false;
+    case ARInstructionType::MemoryCopy:
       LogInfo("Doing Memory Copy");
-      if (false == ZeroCode_MemoryCopy(val_last, addr, data))
+      if (false == ZeroCode_MemoryCopy(inst.val_last, addr, data))
         return false;
-      continue;
-    }
+      break;
 
-    // ActionReplay program self modification codes
-    if (addr >= 0x00002000 && addr < 0x00003000)
-    {
+    case ARInstructionType::SelfModification:
       LogInfo(
           "This action replay simulator does not support codes that modify Action Replay itself.");
       PanicAlertFmtT(
           "This action replay simulator does not support codes that modify Action Replay itself.");
       return false;
-    }
-
-    // skip these weird init lines
-    // TODO: Where are the "weird init lines"?
-    // if (iter == code.ops.begin() && cmd == 1)
-    // continue;
-
-    // Zero codes
-    if (0x0 == addr)  // Check if the code is a zero code
-    {
-      const u8 zcode = data >> 29;
-
-      LogInfo("Doing Zero Code {:08x}", zcode);
-
-      switch (zcode)
-      {
-      case ZCODE_END:  // END OF CODES
-        LogInfo("ZCode: End Of Codes");
-        return true;
-
-      // TODO: the "00000000 40000000"(end if) codes fall into this case, I don't think that is
-      // correct
-      case ZCODE_NORM:  // Normal execution of codes
-        // Todo: Set register 1BB4 to 0
-        LogInfo("ZCode: Normal execution of codes, set register 1BB4 to 0 (zcode not supported)");
-        break;
-
-      case ZCODE_ROW:  // Executes all codes in the same row
-        // Todo: Set register 1BB4 to 1
-        LogInfo("ZCode: Executes all codes in the same row, Set register 1BB4 to 1 (zcode not "
-                "supported)");
-        PanicAlertFmtT("Zero 3 code not supported");
-        return false;
-
-      case ZCODE_04:  // Fill & Slide or Memory Copy
-        if (0x3 == ((data >> 25) & 0x03))
-        {
-          LogInfo("ZCode: Memory Copy");
-          do_memory_copy = true;
-          val_last = data;
-        }
-        else
-        {
-          LogInfo("ZCode: Fill And Slide");
-          do_fill_and_slide = true;
-          val_last = data;
-        }
-        break;
-
-      default:
-        LogInfo("ZCode: Unknown");
-        PanicAlertFmtT("Zero code unknown to Dolphin: {0:08x}", zcode);
-        return false;
-      }
-
-      // done handling zero codes
-      continue;
-    }
 
-    // Normal codes
-    LogInfo("Doing Normal Code {:08x}", addr.type);
-    LogInfo("Subtype: {:08x}", addr.subtype);
-
-    switch (addr.type)
-    {
-    case 0x00:
+    case ARInstructionType::NormalCode:
+      LogInfo("Doing Normal Code {:08x}", addr.type);
+      LogInfo("Subtype: {:08x}", addr.subtype);
       if (false == NormalCode(addr, data))
         return false;
       break;
 
-    default:
+    case ARInstructionType::ConditionalCode:
+    {
+      LogInfo("Doing Normal Code {:08x}", addr.type);
+      LogInfo("Subtype: {:08x}", addr.subtype);
       LogInfo("This Normal Code is a Conditional Code");
+
+      // used for conditional codes
+      int skip_count = 0;
       if (false == ConditionalCode(addr, data, &skip_count))
         return false;
+
+      // after a failed comparison, skip lines as decided when the code was compiled
+      if (skip_count != 0)
+      {
+        LogInfo("Lines skipped: {}", inst.skip_target - inst.next);
+        line = inst.skip_target;
+      }
       break;
     }
+    }
   }
 
   return true;
@@ -981,7 +1061,7 @@ void RunAllActive()
   // be contested.
   std::lock_guard guard(s_lock);
   s_active_codes.erase(std::remove_if(s_active_codes.begin(), s_active_codes.end(),
-                                      [](const ARCode& code) {
+                                      [](const ActiveCode& code) {
                                         bool success = RunCodeLocked(code);
                                         LogInfo("\n");
                                         return !success;
@@ -17,6 +17,7 @@ namespace Config
 
 const Info<bool> GFX_VSYNC{{System::GFX, "Hardware", "VSync"}, false};
 const Info<int> GFX_ADAPTER{{System::GFX, "Hardware", "Adapter"}, 0};
+const Info<int> GFX_MAX_FRAMES_IN_FLIGHT{{System::GFX, "Hardware", "MaxFramesInFlight"}, 0};
 
 // Graphics.Settings
 
@@ -27,11 +28,17 @@ const Info<AspectMode> GFX_SUGGESTED_ASPECT_RATIO{{System::GFX, "Settings", "Sug
 const Info<bool> GFX_CROP{{System::GFX, "Settings", "Crop"}, false};
 const Info<int> GFX_SAFE_TEXTURE_CACHE_COLOR_SAMPLES{
     {System::GFX, "Settings", "SafeTextureCacheColorSamples"}, 128};
+const Info<bool> GFX_TRACK_TEXTURE_WRITES{{System::GFX, "Settings", "TrackTextureWrites"}, false};
+const Info<int> GFX_TEXTURE_MEMORY_BUDGET{{System::GFX, "Settings", "TextureMemoryBudget"}, 0};
 const Info<bool> GFX_SHOW_FPS{{System::GFX, "Settings", "ShowFPS"}, false};
 const Info<bool> GFX_SHOW_NETPLAY_PING{{System::GFX, "Settings", "ShowNetPlayPing"}, false};
 const Info<bool> GFX_SHOW_NETPLAY_MESSAGES{{System::GFX, "Settings", "ShowNetPlayMessages"}, false};
 const Info<bool> GFX_LOG_RENDER_TIME_TO_FILE{{System::GFX, "Settings", "LogRenderTimeToFile"},
                                              false};
+const Info<bool> GFX_SHOW_FRAME_TIME_BREAKDOWN{{System::GFX, "Settings", "ShowFrameTimeBreakdown"},
+                                               false};
+const Info<bool> GFX_LOG_FRAME_TIME_BREAKDOWN_TO_FILE{
+    {System::GFX, "Settings", "LogFrameTimeBreakdownToFile"}, false};
 const Info<bool> GFX_OVERLAY_STATS{{System::GFX, "Settings", "OverlayStats"}, false};
 const Info<bool> GFX_OVERLAY_PROJ_STATS{{System::GFX, "Settings", "OverlayProjStats"}, false};
 const Info<bool> GFX_DUMP_TEXTURES{{System::GFX, "Settings", "DumpTextures"}, false};
@@ -39,6 +46,10 @@ const Info<bool> GFX_DUMP_MIP_TEXTURES{{System::GFX, "Settings", "DumpMipTexture
 const Info<bool> GFX_DUMP_BASE_TEXTURES{{System::GFX, "Settings", "DumpBaseTextures"}, true};
 const Info<bool> GFX_HIRES_TEXTURES{{System::GFX, "Settings", "HiresTextures"}, false};
 const Info<bool> GFX_CACHE_HIRES_TEXTURES{{System::GFX, "Settings", "CacheHiresTextures"}, false};
+const Info<bool> GFX_COMPRESS_HIRES_TEXTURES{
+    {System::GFX, "Settings", "CompressHiresTextures"}, false};
+const Info<int> GFX_HIRES_TEXTURE_CACHE_SIZE{{System::GFX, "Settings", "HiresTextureCacheSize"},
+                                             0};
 const Info<bool> GFX_DUMP_EFB_TARGET{{System::GFX, "Settings", "DumpEFBTarget"}, false};
 const Info<bool> GFX_DUMP_XFB_TARGET{{System::GFX, "Settings", "DumpXFBTarget"}, false};
 const Info<bool> GFX_DUMP_FRAMES_AS_IMAGES{{System::GFX, "Settings", "DumpFramesAsImages"}, false};
@@ -52,12 +63,19 @@ const Info<bool> GFX_INTERNAL_RESOLUTION_FRAME_DUMPS{
     {System::GFX, "Settings", "InternalResolutionFrameDumps"}, false};
 const Info<bool> GFX_ENABLE_GPU_TEXTURE_DECODING{
     {System::GFX, "Settings", "EnableGPUTextureDecoding"}, false};
+const Info<int> GFX_TEXTURE_DECODING_THREADS{{System::GFX, "Settings", "TextureDecodingThreads"},
+                                             -1};
+const Info<bool> GFX_DEDUPLICATE_INDEXED_VERTICES{
+    {System::GFX, "Settings", "DeduplicateIndexedVertices"}, false};
 const Info<bool> GFX_ENABLE_PIXEL_LIGHTING{{System::GFX, "Settings", "EnablePixelLighting"}, false};
 const Info<bool> GFX_FAST_DEPTH_CALC{{System::GFX, "Settings", "FastDepthCalc"}, true};
 const Info<u32> GFX_MSAA{{System::GFX, "Settings", "MSAA"}, 1};
 const Info<bool> GFX_SSAA{{System::GFX, "Settings", "SSAA"}, false};
 const Info<int> GFX_EFB_SCALE{{System::GFX, "Settings", "InternalResolution"}, 1};
 const Info<int> GFX_MAX_EFB_SCALE{{System::GFX, "Settings", "MaxInternalResolution"}, 8};
+const Info<bool> GFX_DYNAMIC_RESOLUTION{{System::GFX, "Settings", "DynamicResolution"}, false};
+const Info<int> GFX_DYNAMIC_RESOLUTION_MIN_SCALE{
+    {System::GFX, "Settings", "DynamicResolutionMinScale"}, 1};
 const Info<bool> GFX_TEXFMT_OVERLAY_ENABLE{{System::GFX, "Settings", "TexFmtOverlayEnable"}, false};
 const Info<bool> GFX_TEXFMT_OVERLAY_CENTER{{System::GFX, "Settings", "TexFmtOverlayCenter"}, false};
 const Info<bool> GFX_ENABLE_WIREFRAME{{System::GFX, "Settings", "WireFrame"}, false};
@@ -79,11 +97,23 @@ const Info<int> GFX_COMMAND_BUFFER_EXECUTE_INTERVAL{
     {System::GFX, "Settings", "CommandBufferExecuteInterval"}, 100};
 #endif
 
+const Info<int> GFX_COMMAND_RECORDING_THREADS{{System::GFX, "Settings", "CommandRecordingThreads"},
+                                              0};
+const Info<bool> GFX_ASYNC_COMPUTE{{System::GFX, "Settings", "AsyncCompute"}, false};
+const Info<bool> GFX_ASYNC_TEXTURE_UPLOADS{{System::GFX, "Settings", "AsyncTextureUploads"},
+                                           false};
+
 const Info<bool> GFX_SHADER_CACHE{{System::GFX, "Settings", "ShaderCache"}, true};
 const Info<bool> GFX_WAIT_FOR_SHADERS_BEFORE_STARTING{
     {System::GFX, "Settings", "WaitForShadersBeforeStarting"}, false};
 const Info<ShaderCompilationMode> GFX_SHADER_COMPILATION_MODE{
     {System::GFX, "Settings", "ShaderCompilationMode"}, ShaderCompilationMode::Synchronous};
+const Info<int> GFX_HYBRID_UBERSHADER_COMPILE_THRESHOLD{
+    {System::GFX, "Settings", "HybridUberShaderCompileThreshold"}, 0};
+const Info<int> GFX_MAX_SPECIALIZED_PIPELINES{{System::GFX, "Settings", "MaxSpecializedPipelines"},
+                                              0};
+const Info<bool> GFX_SPECIALIZED_UBERSHADERS{{System::GFX, "Settings", "SpecializedUberShaders"},
+                                              false};
 const Info<int> GFX_SHADER_COMPILER_THREADS{{System::GFX, "Settings", "ShaderCompilerThreads"}, 1};
 const Info<int> GFX_SHADER_PRECOMPILER_THREADS{
     {System::GFX, "Settings", "ShaderPrecompilerThreads"}, 1};
@@ -98,6 +128,10 @@ const Info<bool> GFX_SW_DUMP_TEV_TEX_FETCHES{{System::GFX, "Settings", "SWDumpTe
                                              false};
 const Info<int> GFX_SW_DRAW_START{{System::GFX, "Settings", "SWDrawStart"}, 0};
 const Info<int> GFX_SW_DRAW_END{{System::GFX, "Settings", "SWDrawEnd"}, 100000};
+const Info<int> GFX_SW_RASTERIZER_THREADS{{System::GFX, "Settings", "SWRasterizerThreads"}, -1};
+
+const Info<NullBenchmarkMode> GFX_NULL_BENCHMARK_MODE{
+    {System::GFX, "Settings", "NullBenchmarkMode"}, NullBenchmarkMode::Off};
 
 const Info<bool> GFX_PREFER_GLES{{System::GFX, "Settings", "PreferGLES"}, false};
 
@@ -108,6 +142,8 @@ const Info<bool> GFX_ENHANCE_FORCE_FILTERING{{System::GFX, "Enhancements", "Forc
 const Info<int> GFX_ENHANCE_MAX_ANISOTROPY{{System::GFX, "Enhancements", "MaxAnisotropy"}, 0};
 const Info<std::string> GFX_ENHANCE_POST_SHADER{
     {System::GFX, "Enhancements", "PostProcessingShader"}, ""};
+const Info<std::string> GFX_ENHANCE_POST_SHADER_PASSES{
+    {System::GFX, "Enhancements", "PostProcessingShaderPasses"}, ""};
 const Info<bool> GFX_ENHANCE_FORCE_TRUE_COLOR{{System::GFX, "Enhancements", "ForceTrueColor"},
                                               true};
 const Info<bool> GFX_ENHANCE_DISABLE_COPY_FILTER{{System::GFX, "Enhancements", "DisableCopyFilter"},
@@ -136,7 +172,11 @@ const Info<bool> GFX_HACK_EFB_ACCESS_ENABLE{{System::GFX, "Hacks", "EFBAccessEna
 const Info<bool> GFX_HACK_EFB_DEFER_INVALIDATION{
     {System::GFX, "Hacks", "EFBAccessDeferInvalidation"}, false};
 const Info<int> GFX_HACK_EFB_ACCESS_TILE_SIZE{{System::GFX, "Hacks", "EFBAccessTileSize"}, 64};
+const Info<int> GFX_HACK_EFB_ACCESS_MAX_STALENESS{
+    {System::GFX, "Hacks", "EFBAccessMaxStaleness"}, 0};
 const Info<bool> GFX_HACK_BBOX_ENABLE{{System::GFX, "Hacks", "BBoxEnable"}, false};
+const Info<BBoxReadbackMode> GFX_HACK_BBOX_READBACK_MODE{
+    {System::GFX, "Hacks", "BBoxReadbackMode"}, BBoxReadbackMode::Synchronous};
 const Info<bool> GFX_HACK_FORCE_PROGRESSIVE{{System::GFX, "Hacks", "ForceProgressive"}, true};
 const Info<bool> GFX_HACK_SKIP_EFB_COPY_TO_RAM{{System::GFX, "Hacks", "EFBToTextureEnable"}, true};
 const Info<bool> GFX_HACK_SKIP_XFB_COPY_TO_RAM{{System::GFX, "Hacks", "XFBToTextureEnable"}, true};
@@ -152,4 +192,6 @@ const Info<bool> GFX_HACK_VERTEX_ROUDING{{System::GFX, "Hacks", "VertexRounding"
 // Graphics.GameSpecific
 
 const Info<bool> GFX_PERF_QUERIES_ENABLE{{System::GFX, "GameSpecific", "PerfQueriesEnable"}, false};
+const Info<bool> GFX_PERF_QUERIES_LATENCY_TOLERANT{
+    {System::GFX, "GameSpecific", "PerfQueriesLatencyTolerant"}, false};
 }  // namespace Config
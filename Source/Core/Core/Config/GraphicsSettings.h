@@ -9,6 +9,8 @@
 #include "Common/Config/Config.h"
 
 enum class AspectMode : int;
+enum class BBoxReadbackMode : int;
+enum class NullBenchmarkMode : int;
 enum class ShaderCompilationMode : int;
 enum class StereoMode : int;
 enum class FreelookControlType : int;
@@ -21,6 +23,7 @@ namespace Config
 
 extern const Info<bool> GFX_VSYNC;
 extern const Info<int> GFX_ADAPTER;
+extern const Info<int> GFX_MAX_FRAMES_IN_FLIGHT;
 
 // Graphics.Settings
 
@@ -29,10 +32,14 @@ extern const Info<AspectMode> GFX_ASPECT_RATIO;
 extern const Info<AspectMode> GFX_SUGGESTED_ASPECT_RATIO;
 extern const Info<bool> GFX_CROP;
 extern const Info<int> GFX_SAFE_TEXTURE_CACHE_COLOR_SAMPLES;
+extern const Info<bool> GFX_TRACK_TEXTURE_WRITES;
+extern const Info<int> GFX_TEXTURE_MEMORY_BUDGET;
 extern const Info<bool> GFX_SHOW_FPS;
 extern const Info<bool> GFX_SHOW_NETPLAY_PING;
 extern const Info<bool> GFX_SHOW_NETPLAY_MESSAGES;
 extern const Info<bool> GFX_LOG_RENDER_TIME_TO_FILE;
+extern const Info<bool> GFX_SHOW_FRAME_TIME_BREAKDOWN;
+extern const Info<bool> GFX_LOG_FRAME_TIME_BREAKDOWN_TO_FILE;
 extern const Info<bool> GFX_OVERLAY_STATS;
 extern const Info<bool> GFX_OVERLAY_PROJ_STATS;
 extern const Info<bool> GFX_DUMP_TEXTURES;
@@ -40,6 +47,8 @@ extern const Info<bool> GFX_DUMP_MIP_TEXTURES;
 extern const Info<bool> GFX_DUMP_BASE_TEXTURES;
 extern const Info<bool> GFX_HIRES_TEXTURES;
 extern const Info<bool> GFX_CACHE_HIRES_TEXTURES;
+extern const Info<int> GFX_HIRES_TEXTURE_CACHE_SIZE;
+extern const Info<bool> GFX_COMPRESS_HIRES_TEXTURES;
 extern const Info<bool> GFX_DUMP_EFB_TARGET;
 extern const Info<bool> GFX_DUMP_XFB_TARGET;
 extern const Info<bool> GFX_DUMP_FRAMES_AS_IMAGES;
@@ -51,12 +60,16 @@ extern const Info<std::string> GFX_DUMP_PATH;
 extern const Info<int> GFX_BITRATE_KBPS;
 extern const Info<bool> GFX_INTERNAL_RESOLUTION_FRAME_DUMPS;
 extern const Info<bool> GFX_ENABLE_GPU_TEXTURE_DECODING;
+extern const Info<int> GFX_TEXTURE_DECODING_THREADS;
+extern const Info<bool> GFX_DEDUPLICATE_INDEXED_VERTICES;
 extern const Info<bool> GFX_ENABLE_PIXEL_LIGHTING;
 extern const Info<bool> GFX_FAST_DEPTH_CALC;
 extern const Info<u32> GFX_MSAA;
 extern const Info<bool> GFX_SSAA;
 extern const Info<int> GFX_EFB_SCALE;
 extern const Info<int> GFX_MAX_EFB_SCALE;
+extern const Info<bool> GFX_DYNAMIC_RESOLUTION;
+extern const Info<int> GFX_DYNAMIC_RESOLUTION_MIN_SCALE;
 extern const Info<bool> GFX_TEXFMT_OVERLAY_ENABLE;
 extern const Info<bool> GFX_TEXFMT_OVERLAY_CENTER;
 extern const Info<bool> GFX_ENABLE_WIREFRAME;
@@ -65,9 +78,15 @@ extern const Info<bool> GFX_BORDERLESS_FULLSCREEN;
 extern const Info<bool> GFX_ENABLE_VALIDATION_LAYER;
 extern const Info<bool> GFX_BACKEND_MULTITHREADING;
 extern const Info<int> GFX_COMMAND_BUFFER_EXECUTE_INTERVAL;
+extern const Info<int> GFX_COMMAND_RECORDING_THREADS;
+extern const Info<bool> GFX_ASYNC_COMPUTE;
+extern const Info<bool> GFX_ASYNC_TEXTURE_UPLOADS;
 extern const Info<bool> GFX_SHADER_CACHE;
 extern const Info<bool> GFX_WAIT_FOR_SHADERS_BEFORE_STARTING;
 extern const Info<ShaderCompilationMode> GFX_SHADER_COMPILATION_MODE;
+extern const Info<int> GFX_HYBRID_UBERSHADER_COMPILE_THRESHOLD;
+extern const Info<int> GFX_MAX_SPECIALIZED_PIPELINES;
+extern const Info<bool> GFX_SPECIALIZED_UBERSHADERS;
 extern const Info<int> GFX_SHADER_COMPILER_THREADS;
 extern const Info<int> GFX_SHADER_PRECOMPILER_THREADS;
 extern const Info<bool> GFX_SAVE_TEXTURE_CACHE_TO_STATE;
@@ -79,6 +98,9 @@ extern const Info<bool> GFX_SW_DUMP_TEV_STAGES;
 extern const Info<bool> GFX_SW_DUMP_TEV_TEX_FETCHES;
 extern const Info<int> GFX_SW_DRAW_START;
 extern const Info<int> GFX_SW_DRAW_END;
+extern const Info<int> GFX_SW_RASTERIZER_THREADS;
+
+extern const Info<NullBenchmarkMode> GFX_NULL_BENCHMARK_MODE;
 
 extern const Info<bool> GFX_PREFER_GLES;
 
@@ -87,6 +109,7 @@ extern const Info<bool> GFX_PREFER_GLES;
 extern const Info<bool> GFX_ENHANCE_FORCE_FILTERING;
 extern const Info<int> GFX_ENHANCE_MAX_ANISOTROPY;  // NOTE - this is x in (1 << x)
 extern const Info<std::string> GFX_ENHANCE_POST_SHADER;
+extern const Info<std::string> GFX_ENHANCE_POST_SHADER_PASSES;
 extern const Info<bool> GFX_ENHANCE_FORCE_TRUE_COLOR;
 extern const Info<bool> GFX_ENHANCE_DISABLE_COPY_FILTER;
 extern const Info<bool> GFX_ENHANCE_ARBITRARY_MIPMAP_DETECTION;
@@ -111,7 +134,9 @@ static constexpr int GFX_STEREO_CONVERGENCE_MAXIMUM = 200;
 extern const Info<bool> GFX_HACK_EFB_ACCESS_ENABLE;
 extern const Info<bool> GFX_HACK_EFB_DEFER_INVALIDATION;
 extern const Info<int> GFX_HACK_EFB_ACCESS_TILE_SIZE;
+extern const Info<int> GFX_HACK_EFB_ACCESS_MAX_STALENESS;
 extern const Info<bool> GFX_HACK_BBOX_ENABLE;
+extern const Info<BBoxReadbackMode> GFX_HACK_BBOX_READBACK_MODE;
 extern const Info<bool> GFX_HACK_FORCE_PROGRESSIVE;
 extern const Info<bool> GFX_HACK_SKIP_EFB_COPY_TO_RAM;
 extern const Info<bool> GFX_HACK_SKIP_XFB_COPY_TO_RAM;
@@ -126,5 +151,6 @@ extern const Info<bool> GFX_HACK_VERTEX_ROUDING;
 // Graphics.GameSpecific
 
 extern const Info<bool> GFX_PERF_QUERIES_ENABLE;
+extern const Info<bool> GFX_PERF_QUERIES_LATENCY_TOLERANT;
 
 }  // namespace Config
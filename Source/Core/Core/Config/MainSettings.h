@@ -27,11 +27,18 @@ extern const Info<bool> MAIN_SKIP_IPL;
 extern const Info<bool> MAIN_LOAD_IPL_DUMP;
 extern const Info<PowerPC::CPUCore> MAIN_CPU_CORE;
 extern const Info<bool> MAIN_JIT_FOLLOW_BRANCH;
+extern const Info<bool> MAIN_JIT_PERSISTENT_CACHE;
+extern const Info<bool> MAIN_JIT_TIERED_COMPILATION;
 extern const Info<bool> MAIN_FASTMEM;
+extern const Info<bool> MAIN_DIRECT_GATHER_PIPE;
 // Should really be in the DSP section, but we're kind of stuck with bad decisions made in the past.
 extern const Info<bool> MAIN_DSP_HLE;
 extern const Info<int> MAIN_TIMING_VARIANCE;
+extern const Info<bool> MAIN_ADAPTIVE_TIMING_SLICES;
 extern const Info<bool> MAIN_CPU_THREAD;
+extern const Info<bool> MAIN_PIN_EMULATION_THREADS;
+extern const Info<bool> MAIN_NUMA_LOCAL_MEMORY;
+extern const Info<bool> MAIN_HUGE_PAGES;
 extern const Info<bool> MAIN_SYNC_ON_SKIP_IDLE;
 extern const Info<std::string> MAIN_DEFAULT_ISO;
 extern const Info<bool> MAIN_ENABLE_CHEATS;
@@ -42,6 +49,9 @@ extern const Info<AudioCommon::DPL2Quality> MAIN_DPL2_QUALITY;
 extern const Info<int> MAIN_AUDIO_LATENCY;
 extern const Info<bool> MAIN_AUDIO_STRETCH;
 extern const Info<int> MAIN_AUDIO_STRETCH_LATENCY;
+extern const Info<bool> MAIN_AUDIO_SINC_RESAMPLING;
+extern const Info<bool> MAIN_AUDIO_ADAPTIVE_LATENCY;
+extern const Info<bool> MAIN_AUDIO_STRETCH_WSOLA;
 extern const Info<std::string> MAIN_MEMCARD_A_PATH;
 extern const Info<std::string> MAIN_MEMCARD_B_PATH;
 extern const Info<std::string> MAIN_AGP_CART_A_PATH;
@@ -71,6 +81,8 @@ extern const Info<int> MAIN_SYNC_GPU_MAX_DISTANCE;
 extern const Info<int> MAIN_SYNC_GPU_MIN_DISTANCE;
 extern const Info<float> MAIN_SYNC_GPU_OVERCLOCK;
 extern const Info<bool> MAIN_FAST_DISC_SPEED;
+// In MiB.
+extern const Info<int> MAIN_DISC_CACHE_SIZE;
 extern const Info<bool> MAIN_LOW_DCBZ_HACK;
 extern const Info<bool> MAIN_FPRF;
 extern const Info<bool> MAIN_ACCURATE_NANS;
@@ -84,17 +96,25 @@ extern const Info<u32> MAIN_MEM2_SIZE;
 extern const Info<std::string> MAIN_GFX_BACKEND;
 extern const Info<std::string> MAIN_GPU_DETERMINISM_MODE;
 extern const Info<std::string> MAIN_PERF_MAP_DIR;
+extern const Info<bool> MAIN_PERF_JIT_DUMP;
 extern const Info<bool> MAIN_CUSTOM_RTC_ENABLE;
 extern const Info<u32> MAIN_CUSTOM_RTC_VALUE;
 extern const Info<bool> MAIN_AUTO_DISC_CHANGE;
 extern const Info<bool> MAIN_ALLOW_SD_WRITES;
 extern const Info<bool> MAIN_ENABLE_SAVESTATES;
+extern const Info<bool> MAIN_DELTA_SAVESTATES;
+extern const Info<bool> MAIN_REWIND_ENABLE;
+extern const Info<u32> MAIN_REWIND_INTERVAL;
+extern const Info<u32> MAIN_REWIND_BUFFER_SIZE;
+extern const Info<bool> MAIN_MEMORY_WATCHER_TRACK_WRITES;
+extern const Info<u32> MAIN_MOVIE_KEYFRAME_INTERVAL;
 extern const Info<DiscIO::Region> MAIN_FALLBACK_REGION;
 
 // Main.DSP
 
 extern const Info<bool> MAIN_DSP_CAPTURE_LOG;
 extern const Info<bool> MAIN_DSP_JIT;
+extern const Info<int> MAIN_DSP_HLE_VOICE_THREADS;
 extern const Info<bool> MAIN_DUMP_AUDIO;
 extern const Info<bool> MAIN_DUMP_AUDIO_SILENT;
 extern const Info<bool> MAIN_DUMP_UCODE;
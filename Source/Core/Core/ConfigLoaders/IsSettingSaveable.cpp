@@ -34,7 +34,7 @@ bool IsSettingSaveable(const Config::Location& config_location)
     }
   }
 
-  static constexpr std::array<const Config::Location*, 17> s_setting_saveable = {
+  static constexpr std::array<const Config::Location*, 26> s_setting_saveable = {
       // Main.Core
 
       &Config::MAIN_DEFAULT_ISO.GetLocation(),
@@ -49,6 +49,15 @@ bool IsSettingSaveable(const Config::Location& config_location)
       &Config::MAIN_MEM2_SIZE.GetLocation(),
       &Config::MAIN_GFX_BACKEND.GetLocation(),
       &Config::MAIN_ENABLE_SAVESTATES.GetLocation(),
+      &Config::MAIN_DELTA_SAVESTATES.GetLocation(),
+      &Config::MAIN_REWIND_ENABLE.GetLocation(),
+      &Config::MAIN_REWIND_INTERVAL.GetLocation(),
+      &Config::MAIN_REWIND_BUFFER_SIZE.GetLocation(),
+      &Config::MAIN_MEMORY_WATCHER_TRACK_WRITES.GetLocation(),
+      &Config::MAIN_PIN_EMULATION_THREADS.GetLocation(),
+      &Config::MAIN_NUMA_LOCAL_MEMORY.GetLocation(),
+      &Config::MAIN_HUGE_PAGES.GetLocation(),
+      &Config::MAIN_MOVIE_KEYFRAME_INTERVAL.GetLocation(),
       &Config::MAIN_FALLBACK_REGION.GetLocation(),
 
       // Main.Interface
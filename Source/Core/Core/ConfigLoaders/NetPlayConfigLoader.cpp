@@ -69,6 +69,7 @@ public:
     layer->Set(Config::GFX_HACK_DEFER_EFB_COPIES, m_settings.m_DeferEFBCopies);
     layer->Set(Config::GFX_HACK_EFB_ACCESS_TILE_SIZE, m_settings.m_EFBAccessTileSize);
     layer->Set(Config::GFX_HACK_EFB_DEFER_INVALIDATION, m_settings.m_EFBAccessDeferInvalidation);
+    layer->Set(Config::GFX_HACK_EFB_ACCESS_MAX_STALENESS, m_settings.m_EFBAccessMaxStaleness);
 
     if (m_settings.m_StrictSettingsSync)
     {
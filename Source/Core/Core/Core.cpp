@@ -6,9 +6,12 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstring>
 #include <mutex>
 #include <queue>
+#include <string>
+#include <string_view>
 #include <utility>
 #include <variant>
 
@@ -38,6 +41,8 @@
 
 #include "Core/Boot/Boot.h"
 #include "Core/BootManager.h"
+#include "Core/Config/GraphicsSettings.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
 #include "Core/DSPEmulator.h"
@@ -51,6 +56,7 @@
 #include "Core/HW/GCKeyboard.h"
 #include "Core/HW/GCPad.h"
 #include "Core/HW/HW.h"
+#include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
 #include "Core/HW/VideoInterface.h"
 #include "Core/HW/Wiimote.h"
@@ -63,6 +69,7 @@
 #include "Core/PatchEngine.h"
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/Rewind.h"
 #include "Core/State.h"
 #include "Core/WiiRoot.h"
 
@@ -97,6 +104,11 @@ static bool s_wants_determinism;
 static Common::Timer s_timer;
 static std::atomic<u32> s_drawn_frame;
 static std::atomic<u32> s_drawn_video;
+static std::atomic<u64> s_presented_frames;
+
+// Set by the host while no game is running
+static double s_emulated_time_limit = 0.0;
+static std::function<void()> s_emulated_time_limit_callback;
 
 static bool s_is_stopping = false;
 static bool s_hardware_initialized = false;
@@ -108,6 +120,7 @@ static StateChangedCallbackFunc s_on_state_changed_callback;
 static std::thread s_cpu_thread;
 static bool s_request_refresh_info = false;
 static bool s_is_throttler_temp_disabled = false;
+static std::atomic<bool> s_is_presentation_suppressed{false};
 static bool s_frame_step = false;
 static std::atomic<bool> s_stop_frame_step;
 
@@ -126,6 +139,40 @@ static Common::Event s_cpu_thread_job_finished;
 
 static thread_local bool tls_is_cpu_thread = false;
 
+// For logging how long it takes from booting to the first frame
+using StartupClock = std::chrono::steady_clock;
+static StartupClock::time_point s_boot_start_time;
+static std::atomic<bool> s_waiting_for_first_frame{false};
+
+static double MillisecondsSince(StartupClock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(StartupClock::now() - start).count();
+}
+
+// Collects how long each step of EmuThread takes, and logs them once the CPU thread is about to
+// start, to make it visible what delays booting.
+class StartupTimer
+{
+public:
+  void EndStep(std::string_view name)
+  {
+    const StartupClock::time_point now = StartupClock::now();
+    m_steps += fmt::format("{}{} {:.1f} ms", m_steps.empty() ? "" : ", ", name,
+                           std::chrono::duration<double, std::milli>(now - m_step_start).count());
+    m_step_start = now;
+  }
+
+  void Log() const
+  {
+    NOTICE_LOG_FMT(BOOT, "Initialization took {:.1f} ms: {}", MillisecondsSince(s_boot_start_time),
+                   m_steps);
+  }
+
+private:
+  StartupClock::time_point m_step_start = StartupClock::now();
+  std::string m_steps;
+};
+
 static void EmuThread(std::unique_ptr<BootParameters> boot, WindowSystemInfo wsi);
 
 bool GetIsThrottlerTempDisabled()
@@ -138,6 +185,16 @@ void SetIsThrottlerTempDisabled(bool disable)
   s_is_throttler_temp_disabled = disable;
 }
 
+bool IsPresentationSuppressed()
+{
+  return s_is_presentation_suppressed.load(std::memory_order_relaxed);
+}
+
+void SetIsPresentationSuppressed(bool suppressed)
+{
+  s_is_presentation_suppressed.store(suppressed, std::memory_order_relaxed);
+}
+
 void FrameUpdateOnCPUThread()
 {
   if (NetPlay::IsNetPlayRunning())
@@ -242,6 +299,14 @@ bool Init(std::unique_ptr<BootParameters> boot, const WindowSystemInfo& wsi)
   WindowSystemInfo prepared_wsi(wsi);
   g_video_backend->PrepareWindow(prepared_wsi);
 
+  s_presented_frames.store(0);
+  s_boot_start_time = StartupClock::now();
+  s_waiting_for_first_frame.store(true);
+
+  Common::SetEmulationThreadPlacement(Config::Get(Config::MAIN_PIN_EMULATION_THREADS),
+                                      Config::Get(Config::MAIN_NUMA_LOCAL_MEMORY));
+  Common::SetHugePagesEnabled(Config::Get(Config::MAIN_HUGE_PAGES));
+
   // Start the emu thread
   s_is_booting.Set();
   s_emu_thread = std::thread(EmuThread, std::move(boot), prepared_wsi);
@@ -322,6 +387,7 @@ static void CPUSetInitialExecutionState()
 static void CpuThread(const std::optional<std::string>& savestate_path, bool delete_savestate)
 {
   DeclareAsCPUThread();
+  Common::PlaceCurrentEmulationThread(Common::EmulationThread::CPU);
 
   const SConfig& _CoreParameter = SConfig::GetInstance();
   if (_CoreParameter.bCPUThread)
@@ -338,8 +404,22 @@ static void CpuThread(const std::optional<std::string>& savestate_path, bool del
   static_cast<void>(IDCache::GetEnvForThread());
 #endif
 
-  if (_CoreParameter.bFastmem)
+  // Textures, the memory in delta savestates and the memory watcher's addresses are write tracked
+  // through the same fault handler as fastmem, which then has to catch writes from all threads.
+  const bool netplay_rollback = NetPlay::IsNetPlayRunning() && NetPlay::GetNetSettings().m_Rollback;
+#ifdef USE_MEMORYWATCHER
+  const bool memory_watcher_tracking = Config::Get(Config::MAIN_MEMORY_WATCHER_TRACK_WRITES);
+#else
+  const bool memory_watcher_tracking = false;
+#endif
+  const bool track_writes =
+      (Config::Get(Config::GFX_TRACK_TEXTURE_WRITES) ||
+       Config::Get(Config::MAIN_DELTA_SAVESTATES) || Config::Get(Config::MAIN_REWIND_ENABLE) ||
+       netplay_rollback || memory_watcher_tracking) &&
+      EMM::IsExceptionHandlerProcessWide();
+  if (_CoreParameter.bFastmem || track_writes)
     EMM::InstallExceptionHandler();  // Let's run under memory watch
+  Memory::SetWriteTrackingEnabled(track_writes);
 
 #ifdef USE_MEMORYWATCHER
   s_memory_watcher = std::make_unique<MemoryWatcher>();
@@ -381,7 +461,8 @@ static void CpuThread(const std::optional<std::string>& savestate_path, bool del
 
   s_is_started = false;
 
-  if (_CoreParameter.bFastmem)
+  Memory::SetWriteTrackingEnabled(false);
+  if (_CoreParameter.bFastmem || track_writes)
     EMM::UninstallExceptionHandler();
 }
 
@@ -389,6 +470,7 @@ static void FifoPlayerThread(const std::optional<std::string>& savestate_path,
                              bool delete_savestate)
 {
   DeclareAsCPUThread();
+  Common::PlaceCurrentEmulationThread(Common::EmulationThread::CPU);
 
   const SConfig& _CoreParameter = SConfig::GetInstance();
   if (_CoreParameter.bCPUThread)
@@ -439,6 +521,10 @@ static void EmuThread(std::unique_ptr<BootParameters> boot, WindowSystemInfo wsi
   }};
 
   Common::SetCurrentThreadName("Emuthread - Starting");
+  StartupTimer startup_timer;
+
+  // Guest memory and the JIT code space are allocated on this thread, so it's placed before that.
+  Common::PlaceCurrentEmulationThread(Common::EmulationThread::CPU);
 
   // For a time this acts as the CPU thread...
   DeclareAsCPUThread();
@@ -494,6 +580,12 @@ static void EmuThread(std::unique_ptr<BootParameters> boot, WindowSystemInfo wsi
     FreeLook::LoadInputConfig();
   }
 
+  startup_timer.EndStep("controllers");
+
+  // The custom textures are searched for while the rest is initializing. This has to happen after
+  // the controllers are loaded, since they may have generated dynamic input textures.
+  HiresTexture::StartIndexing();
+
   Common::ScopeGuard controller_guard{[init_controllers, init_wiimotes] {
     if (!init_controllers)
       return;
@@ -537,6 +629,8 @@ static void EmuThread(std::unique_ptr<BootParameters> boot, WindowSystemInfo wsi
     PowerPC::debug_interface.Clear();
   }};
 
+  startup_timer.EndStep("hardware");
+
   VideoBackendBase::PopulateBackendInfo();
 
   if (!g_video_backend->Initialize(wsi))
@@ -551,6 +645,8 @@ static void EmuThread(std::unique_ptr<BootParameters> boot, WindowSystemInfo wsi
   g_renderer->BeginUIFrame();
   g_renderer->EndUIFrame();
 
+  startup_timer.EndStep("video backend");
+
   if (cpu_info.HTT)
     SConfig::GetInstance().bDSPThread = cpu_info.num_cores > 4;
   else
@@ -562,13 +658,18 @@ static void EmuThread(std::unique_ptr<BootParameters> boot, WindowSystemInfo wsi
     return;
   }
 
-  // Inputs loading may have generated custom dynamic textures
-  // it's now ok to initialize any custom textures
+  startup_timer.EndStep("DSP");
+
+  // Picks up the custom textures found by StartIndexing
   HiresTexture::Update();
 
+  startup_timer.EndStep("custom textures");
+
   AudioCommon::InitSoundStream();
   Common::ScopeGuard audio_guard{&AudioCommon::ShutdownSoundStream};
 
+  startup_timer.EndStep("audio");
+
   // The hardware is initialized.
   s_hardware_initialized = true;
   s_is_booting.Clear();
@@ -589,14 +690,21 @@ static void EmuThread(std::unique_ptr<BootParameters> boot, WindowSystemInfo wsi
   if (!CBoot::BootUp(std::move(boot)))
     return;
 
+  startup_timer.EndStep("boot");
+
   // Initialise Wii filesystem contents.
   // This is done here after Boot and not in HW to ensure that we operate
   // with the correct title context since save copying requires title directories to exist.
   Common::ScopeGuard wiifs_guard{&Core::CleanUpWiiFileSystemContents};
   if (SConfig::GetInstance().bWii)
+  {
     Core::InitializeWiiFileSystemContents();
+    startup_timer.EndStep("Wii file system");
+  }
   else
+  {
     wiifs_guard.Dismiss();
+  }
 
   // This adds the SyncGPU handler to CoreTiming, so now CoreTiming::Advance might block.
   Fifo::Prepare();
@@ -612,6 +720,9 @@ static void EmuThread(std::unique_ptr<BootParameters> boot, WindowSystemInfo wsi
     PowerPC::SetMode(PowerPC::CoreMode::Interpreter);
   }
 
+  startup_timer.EndStep("CPU core");
+  startup_timer.Log();
+
   // ENTER THE VIDEO THREAD LOOP
   if (core_parameter.bCPUThread)
   {
@@ -877,12 +988,30 @@ void VideoThrottle()
 void Callback_FramePresented()
 {
   s_drawn_frame++;
+  s_presented_frames++;
   s_stop_frame_step.store(true);
+
+  if (s_waiting_for_first_frame.load(std::memory_order_relaxed) &&
+      s_waiting_for_first_frame.exchange(false))
+  {
+    NOTICE_LOG_FMT(BOOT, "First frame presented {:.1f} ms after booting",
+                   MillisecondsSince(s_boot_start_time));
+  }
 }
 
 // Called from VideoInterface::Update (CPU thread) at emulated field boundaries
 void Callback_NewField()
 {
+  Rewind::OnNewField();
+
+  if (s_emulated_time_limit_callback &&
+      CoreTiming::GetTicks() >= s_emulated_time_limit * SystemTimers::GetTicksPerSecond())
+  {
+    const std::function<void()> callback = std::move(s_emulated_time_limit_callback);
+    s_emulated_time_limit_callback = nullptr;
+    callback();
+  }
+
   if (s_frame_step)
   {
     // To ensure that s_stop_frame_step is up to date, wait for the GPU thread queue to empty,
@@ -902,6 +1031,17 @@ void Callback_NewField()
   }
 }
 
+u64 GetPresentedFrameCount()
+{
+  return s_presented_frames.load();
+}
+
+void SetEmulatedTimeLimit(double seconds, std::function<void()> callback)
+{
+  s_emulated_time_limit = seconds;
+  s_emulated_time_limit_callback = std::move(callback);
+}
+
 void UpdateTitle()
 {
   u32 ElapseTime = (u32)s_timer.GetTimeDifference();
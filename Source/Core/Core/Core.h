@@ -25,9 +25,23 @@ namespace Core
 bool GetIsThrottlerTempDisabled();
 void SetIsThrottlerTempDisabled(bool disable);
 
+// Frames that are emulated while this is set are neither shown nor throttled. Used by NetPlay's
+// rollback mode when it emulates frames again with the inputs that actually arrived.
+bool IsPresentationSuppressed();
+void SetIsPresentationSuppressed(bool suppressed);
+
 void Callback_FramePresented();
 void Callback_NewField();
 
+// Frames presented since the last boot
+u64 GetPresentedFrameCount();
+
+// Calls the function once on the CPU thread, at the first field boundary after the given number
+// of emulated seconds since boot. Used to run benchmarks for a fixed amount of emulated time.
+// Only call this while no game is running, or from the callback itself to set the next limit.
+// Pass nullptr to remove the callback.
+void SetEmulatedTimeLimit(double seconds, std::function<void()> callback);
+
 enum class State
 {
   Uninitialized,
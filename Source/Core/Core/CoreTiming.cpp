@@ -5,6 +5,7 @@
 #include "Core/CoreTiming.h"
 
 #include <algorithm>
+#include <functional>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -14,9 +15,12 @@
 
 #include "Common/Assert.h"
 #include "Common/ChunkFile.h"
+#include "Common/Config/Config.h"
 #include "Common/Logging/Log.h"
-#include "Common/SPSCQueue.h"
+#include "Common/SPSCRingQueue.h"
+#include "Common/Tracing.h"
 
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -62,11 +66,25 @@ static std::unordered_map<std::string, EventType> s_event_types;
 static std::vector<Event> s_event_queue;
 static u64 s_event_fifo_id;
 static std::mutex s_ts_write_lock;
-static Common::SPSCQueue<Event, false> s_ts_queue;
+static Common::SPSCRingQueue<Event, false> s_ts_queue;
 
 static float s_last_OC_factor;
 static constexpr int MAX_SLICE_LENGTH = 20000;
 
+// With adaptive slicing, events which are due at most this many cycles after the one being run are
+// run in the same Advance() instead of getting a tiny slice of their own. Their callbacks are told
+// that they're early through a negative cyclesLate.
+static constexpr s64 EVENT_COALESCING_WINDOW = 200;
+// With adaptive slicing, the maximum slice length doubles (up to this limit) for every slice in
+// which no other thread scheduled an event. MAX_SLICE_LENGTH only exists to bound the latency of
+// such events, so there is no point in exiting the JIT that often while nobody is scheduling any.
+static constexpr int MAX_ADAPTIVE_SLICE_LENGTH = MAX_SLICE_LENGTH * 8;
+
+static bool s_adaptive_slicing;
+static int s_max_slice_length;
+static bool s_moved_events;
+static SliceStatistics s_slice_statistics;
+
 static s64 s_idled_cycles;
 static u32 s_fake_dec_start_value;
 static u64 s_fake_dec_start_ticks;
@@ -74,6 +92,8 @@ static u64 s_fake_dec_start_ticks;
 // Are we in a function that has been called from Advance()
 static bool s_is_global_timer_sane;
 
+static std::vector<std::function<void()>> s_end_of_slice_functions;
+
 Globals g;
 
 static EventType* s_ev_lost = nullptr;
@@ -129,6 +149,13 @@ void Init()
   g.global_timer = 0;
   s_idled_cycles = 0;
 
+  // Coalescing changes when callbacks run, so it must not be used when it could cause desyncs.
+  s_adaptive_slicing =
+      Config::Get(Config::MAIN_ADAPTIVE_TIMING_SLICES) && !Core::WantsDeterminism();
+  s_max_slice_length = MAX_SLICE_LENGTH;
+  s_moved_events = false;
+  s_slice_statistics = {};
+
   // The time between CoreTiming being intialized and the first call to Advance() is considered
   // the slice boundary between slice -1 and slice 0. Dispatcher loops must call Advance() before
   // executing the first PPC cycle of each slice to prepare the slice length and downcount for
@@ -145,6 +172,15 @@ void Shutdown()
   MoveEvents();
   ClearPendingEvents();
   UnregisterAllEvents();
+  s_end_of_slice_functions.clear();
+
+  if (s_slice_statistics.slices != 0)
+  {
+    INFO_LOG_FMT(POWERPC, "{} slices, {} cycles per slice on average, {} extended, {} coalesced",
+                 s_slice_statistics.slices,
+                 s_slice_statistics.cycles / s_slice_statistics.slices,
+                 s_slice_statistics.extended_slices, s_slice_statistics.coalesced_events);
+  }
 }
 
 void DoState(PointerWrap& p)
@@ -308,26 +344,52 @@ void MoveEvents()
     ev.fifo_order = s_event_fifo_id++;
     s_event_queue.emplace_back(std::move(ev));
     std::push_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+    s_moved_events = true;
   }
 }
 
+static void UpdateMaxSliceLength()
+{
+  if (!s_adaptive_slicing || s_moved_events)
+    s_max_slice_length = MAX_SLICE_LENGTH;
+  else
+    s_max_slice_length = std::min(s_max_slice_length * 2, MAX_ADAPTIVE_SLICE_LENGTH);
+
+  s_moved_events = false;
+}
+
 void Advance()
 {
+  TRACE_SCOPE("CoreTiming::Advance");
+
   MoveEvents();
 
   int cyclesExecuted = g.slice_length - DowncountToCycles(PowerPC::ppcState.downcount);
   g.global_timer += cyclesExecuted;
   s_last_OC_factor = SConfig::GetInstance().m_OCEnable ? SConfig::GetInstance().m_OCFactor : 1.0f;
   g.last_OC_factor_inverted = 1.0f / s_last_OC_factor;
-  g.slice_length = MAX_SLICE_LENGTH;
+
+  s_slice_statistics.slices++;
+  s_slice_statistics.cycles += cyclesExecuted;
+  UpdateMaxSliceLength();
+  g.slice_length = s_max_slice_length;
 
   s_is_global_timer_sane = true;
 
-  while (!s_event_queue.empty() && s_event_queue.front().time <= g.global_timer)
+  // Events which are almost due are only pulled in together with one which actually is, otherwise
+  // we'd just be moving the slice boundary around.
+  const s64 coalescing_window =
+      s_adaptive_slicing && !s_event_queue.empty() && s_event_queue.front().time <= g.global_timer ?
+          EVENT_COALESCING_WINDOW :
+          0;
+  while (!s_event_queue.empty() &&
+         s_event_queue.front().time <= g.global_timer + coalescing_window)
   {
     Event evt = std::move(s_event_queue.front());
     std::pop_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
     s_event_queue.pop_back();
+    if (evt.time > g.global_timer)
+      s_slice_statistics.coalesced_events++;
     evt.type->callback(evt.userdata, g.global_timer - evt.time);
   }
 
@@ -337,9 +399,12 @@ void Advance()
   if (!s_event_queue.empty())
   {
     g.slice_length = static_cast<int>(
-        std::min<s64>(s_event_queue.front().time - g.global_timer, MAX_SLICE_LENGTH));
+        std::min<s64>(s_event_queue.front().time - g.global_timer, s_max_slice_length));
   }
 
+  if (g.slice_length > MAX_SLICE_LENGTH)
+    s_slice_statistics.extended_slices++;
+
   PowerPC::ppcState.downcount = CyclesToDowncount(g.slice_length);
 
   // Check for any external exceptions.
@@ -347,6 +412,19 @@ void Advance()
   // until the next slice:
   //        Pokemon Box refuses to boot if the first exception from the audio DMA is received late
   PowerPC::CheckExternalExceptions();
+
+  if (!s_end_of_slice_functions.empty())
+  {
+    std::vector<std::function<void()>> functions;
+    std::swap(functions, s_end_of_slice_functions);
+    for (const std::function<void()>& function : functions)
+      function();
+  }
+}
+
+void RunAtEndOfSlice(std::function<void()> function)
+{
+  s_end_of_slice_functions.push_back(std::move(function));
 }
 
 void LogPendingEvents()
@@ -385,6 +463,11 @@ void Idle()
   PowerPC::ppcState.downcount = 0;
 }
 
+const SliceStatistics& GetSliceStatistics()
+{
+  return s_slice_statistics;
+}
+
 std::string GetScheduledEventsSummary()
 {
   std::string text = "Scheduled events\n";
@@ -17,6 +17,7 @@
 // inside callback:
 //   ScheduleEvent(periodInCycles - cyclesLate, callback, "whatever")
 
+#include <functional>
 #include <string>
 #include "Common/CommonTypes.h"
 
@@ -85,6 +86,12 @@ void RemoveAllEvents(EventType* event_type);
 void Advance();
 void MoveEvents();
 
+// Calls the function at the end of the current Advance when called from an event, and otherwise at
+// the end of the next one, once the next slice has been set up. The emulated state is the same
+// there as when the CPU thread is paused, so e.g. a state can be saved without pausing emulation.
+// CPU thread only.
+void RunAtEndOfSlice(std::function<void()> function);
+
 // Pretend that the main CPU has executed enough cycles to reach the next event.
 void Idle();
 
@@ -95,6 +102,20 @@ void LogPendingEvents();
 
 std::string GetScheduledEventsSummary();
 
+struct SliceStatistics
+{
+  u64 slices = 0;
+  u64 cycles = 0;
+  // Slices which were made longer than the default maximum because no other thread was
+  // scheduling events.
+  u64 extended_slices = 0;
+  // Events which were run slightly ahead of time together with an earlier event.
+  u64 coalesced_events = 0;
+};
+
+// Statistics are gathered since the last Init().
+const SliceStatistics& GetSliceStatistics();
+
 void AdjustEventQueueTimes(u32 new_ppc_clock, u32 old_ppc_clock);
 
 u32 GetFakeDecStartValue();
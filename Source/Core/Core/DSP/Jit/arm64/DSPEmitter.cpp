@@ -0,0 +1,306 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/DSP/Jit/arm64/DSPEmitter.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "Common/BitSet.h"
+#include "Common/ChunkFile.h"
+#include "Common/CommonTypes.h"
+#include "Common/Logging/Log.h"
+
+#include "Core/DSP/DSPAnalyzer.h"
+#include "Core/DSP/DSPCore.h"
+#include "Core/DSP/DSPHost.h"
+#include "Core/DSP/DSPTables.h"
+#include "Core/DSP/Interpreter/DSPIntTables.h"
+#include "Core/DSP/Interpreter/DSPInterpreter.h"
+
+using namespace Arm64Gen;
+
+namespace DSP::JIT::arm64
+{
+constexpr size_t COMPILED_CODE_SIZE = 2097152;
+constexpr size_t MAX_BLOCK_SIZE = 250;
+constexpr u16 DSP_IDLE_SKIP_CYCLES = 0x1000;
+
+// Registers which hold the interpreter and the DSP state for the whole block.
+constexpr ARM64Reg INTERPRETER_REG = X19;
+constexpr ARM64Reg STATE_REG = X20;
+const BitSet32 BLOCK_SAVED_REGS{19, 20, 30};
+
+DSPEmitter::DSPEmitter(DSPCore& dsp)
+    : m_blocks(MAX_BLOCKS, nullptr), m_block_size(MAX_BLOCKS), m_dsp_core{dsp}
+{
+  AllocCodeSpace(COMPILED_CODE_SIZE);
+}
+
+DSPEmitter::~DSPEmitter()
+{
+  FreeCodeSpace();
+}
+
+u16 DSPEmitter::RunCycles(u16 cycles)
+{
+  auto& state = m_dsp_core.DSPState();
+
+  if (state.external_interrupt_waiting)
+  {
+    m_dsp_core.CheckExternalInterrupt();
+    m_dsp_core.CheckExceptions();
+    m_dsp_core.SetExternalInterrupt(false);
+  }
+
+  m_cycles_left = cycles;
+  while (true)
+  {
+    if (Host::OnThread() && state.external_interrupt_waiting)
+      break;
+
+    // Check for DSP halt
+    if ((state.cr & CR_HALT) != 0)
+      break;
+
+    if (!m_blocks[state.pc])
+      Compile(state.pc);
+
+    const u16 cycles_executed = m_blocks[state.pc]();
+    if (cycles_executed >= m_cycles_left)
+    {
+      m_cycles_left = 0;
+      break;
+    }
+    m_cycles_left -= cycles_executed;
+  }
+
+  if (state.reset_dspjit_codespace)
+    ClearIRAMandDSPJITCodespaceReset();
+
+  return m_cycles_left;
+}
+
+void DSPEmitter::DoState(PointerWrap& p)
+{
+  p.Do(m_cycles_left);
+}
+
+void DSPEmitter::ClearIRAM()
+{
+  std::fill_n(m_blocks.begin(), DSP_IRAM_SIZE, nullptr);
+  std::fill_n(m_block_size.begin(), DSP_IRAM_SIZE, 0);
+  m_dsp_core.DSPState().reset_dspjit_codespace = true;
+}
+
+void DSPEmitter::ClearIRAMandDSPJITCodespaceReset()
+{
+  ClearCodeSpace();
+  std::fill(m_blocks.begin(), m_blocks.end(), nullptr);
+  std::fill(m_block_size.begin(), m_block_size.end(), 0);
+  m_dsp_core.DSPState().reset_dspjit_codespace = false;
+}
+
+static void CheckExceptionsThunk(DSPCore& dsp)
+{
+  dsp.CheckExceptions();
+}
+
+static void FallbackThunk(Interpreter::Interpreter& interpreter, UDSPInstruction inst)
+{
+  (interpreter.*Interpreter::GetOp(inst))(inst);
+}
+
+static void FallbackExtThunk(Interpreter::Interpreter& interpreter, UDSPInstruction inst)
+{
+  (interpreter.*Interpreter::GetExtOp(inst))(inst);
+}
+
+static void ApplyWriteBackLogThunk(Interpreter::Interpreter& interpreter)
+{
+  interpreter.ApplyWriteBackLog();
+}
+
+// Handles the looping hardware at the end of a loop like the interpreter does. Returns non-zero
+// if a loop is active, in which case the block has to go back to the dispatcher.
+static u32 HandleLoopThunk(SDSP& state, u16 loop_end)
+{
+  const u16 loop_address = state.r.st[2];
+  u16& loop_counter = state.r.st[3];
+
+  if (loop_address == 0 || loop_counter == 0)
+    return 0;
+
+  if (loop_address == loop_end)
+  {
+    loop_counter--;
+    if (loop_counter > 0)
+    {
+      state.pc = state.r.st[0];
+    }
+    else
+    {
+      // end of loop
+      state.PopStack(StackRegister::Call);
+      state.PopStack(StackRegister::LoopAddress);
+      state.PopStack(StackRegister::LoopCounter);
+    }
+  }
+
+  return 1;
+}
+
+void DSPEmitter::StorePC(u16 value)
+{
+  MOVI2R(W0, value);
+  STRH(IndexType::Unsigned, W0, STATE_REG, static_cast<s32>(offsetof(SDSP, pc)));
+}
+
+// Must go out of block if exception is detected
+void DSPEmitter::EmitCheckExceptions()
+{
+  LDRB(IndexType::Unsigned, W0, STATE_REG, static_cast<s32>(offsetof(SDSP, exceptions)));
+  FixupBranch skip_check = CBZ(W0);
+
+  StorePC(m_compile_pc);
+  MOVP2R(X0, &m_dsp_core);
+  QuickCallFunction(X8, CheckExceptionsThunk);
+  EmitBlockExit(m_block_size[m_start_address]);
+
+  SetJumpTarget(skip_check);
+}
+
+void DSPEmitter::EmitInstruction(UDSPInstruction inst)
+{
+  const DSPOPCTemplate* const op_template = GetOpTemplate(inst);
+
+  // The interpreter expects the PC to point past the opcode, both to fetch immediates and to
+  // find the fallthrough address of branches and loops.
+  if (op_template->reads_pc || op_template->branch)
+    StorePC(m_compile_pc + 1);
+
+  if (op_template->extended)
+  {
+    MOV(X0, INTERPRETER_REG);
+    MOVI2R(W1, inst);
+    QuickCallFunction(X8, FallbackExtThunk);
+  }
+
+  MOV(X0, INTERPRETER_REG);
+  MOVI2R(W1, inst);
+  QuickCallFunction(X8, FallbackThunk);
+
+  if (op_template->extended)
+  {
+    MOV(X0, INTERPRETER_REG);
+    QuickCallFunction(X8, ApplyWriteBackLogThunk);
+  }
+}
+
+void DSPEmitter::EmitHandleLoop(bool is_branch)
+{
+  // branch insns update the pc
+  if (!is_branch)
+    StorePC(m_compile_pc);
+
+  MOV(X0, STATE_REG);
+  MOVI2R(W1, static_cast<u16>(m_compile_pc - 1u));
+  QuickCallFunction(X8, HandleLoopThunk);
+  FixupBranch no_loop = CBZ(W0);
+  EmitBlockExit(GetBlockExitCycles());
+  SetJumpTarget(no_loop);
+}
+
+u16 DSPEmitter::GetBlockExitCycles() const
+{
+  if (!Host::OnThread() && m_dsp_core.DSPState().GetAnalyzer().IsIdleSkip(m_start_address))
+    return DSP_IDLE_SKIP_CYCLES;
+
+  return m_block_size[m_start_address];
+}
+
+void DSPEmitter::EmitBlockExit(u16 cycles)
+{
+  MOVI2R(W0, cycles);
+  ABI_PopRegisters(BLOCK_SAVED_REGS);
+  RET();
+}
+
+void DSPEmitter::Compile(u16 start_addr)
+{
+  if (IsAlmostFull())
+  {
+    WARN_LOG_FMT(DSPLLE, "Clearing code space, as it is almost full");
+    ClearIRAMandDSPJITCodespaceReset();
+  }
+
+  m_start_address = start_addr;
+  m_compile_pc = start_addr;
+  m_block_size[start_addr] = 0;
+
+  u8* const entry_point = AlignCode16();
+  ABI_PushRegisters(BLOCK_SAVED_REGS);
+  MOVP2R(INTERPRETER_REG, &m_dsp_core.GetInterpreter());
+  MOVP2R(STATE_REG, &m_dsp_core.DSPState());
+
+  bool fixup_pc = false;
+  auto& analyzer = m_dsp_core.DSPState().GetAnalyzer();
+  while (m_compile_pc < start_addr + MAX_BLOCK_SIZE)
+  {
+    if (analyzer.IsCheckExceptions(m_compile_pc))
+      EmitCheckExceptions();
+
+    const UDSPInstruction inst = m_dsp_core.DSPState().ReadIMEM(m_compile_pc);
+    const DSPOPCTemplate* opcode = GetOpTemplate(inst);
+
+    EmitInstruction(inst);
+
+    m_block_size[start_addr]++;
+    m_compile_pc += opcode->size;
+
+    fixup_pc = true;
+
+    // Handle loop condition, only if current instruction was flagged as a loop destination
+    // by the analyzer.
+    if (analyzer.IsLoopEnd(static_cast<u16>(m_compile_pc - 1u)))
+      EmitHandleLoop(opcode->branch);
+
+    if (opcode->branch)
+    {
+      // don't update the pc -- the branch insn already did
+      fixup_pc = false;
+      if (opcode->uncond_branch)
+        break;
+
+      // look at the pc if we actually branched
+      LDRH(IndexType::Unsigned, W0, STATE_REG, static_cast<s32>(offsetof(SDSP, pc)));
+      MOVI2R(W1, m_compile_pc);
+      CMP(W0, W1);
+      FixupBranch no_branch = B(CC_EQ);
+      EmitBlockExit(GetBlockExitCycles());
+      SetJumpTarget(no_branch);
+    }
+
+    // End the block if we're before an idle skip address
+    if (analyzer.IsIdleSkip(m_compile_pc))
+      break;
+  }
+
+  if (fixup_pc)
+    StorePC(m_compile_pc);
+
+  if (m_block_size[start_addr] == 0)
+  {
+    // just a safeguard, should never happen anymore.
+    // if it does we might get stuck over in RunCycles.
+    ERROR_LOG_FMT(DSPLLE, "Block at {:#06x} has zero size", start_addr);
+    m_block_size[start_addr] = 1;
+  }
+
+  EmitBlockExit(GetBlockExitCycles());
+  FlushIcache();
+
+  m_blocks[start_addr] = reinterpret_cast<DSPCompiledCode>(entry_point);
+}
+}  // namespace DSP::JIT::arm64
@@ -0,0 +1,59 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <vector>
+
+#include "Common/Arm64Emitter.h"
+#include "Common/CommonTypes.h"
+
+#include "Core/DSP/DSPCommon.h"
+#include "Core/DSP/Jit/DSPEmitterBase.h"
+
+class PointerWrap;
+
+namespace DSP::JIT::arm64
+{
+// Compiles the blocks found by the DSP analyzer into sequences of direct calls to the
+// interpreter's instruction handlers. This removes the fetch, decode and loop checks the
+// interpreter does for every instruction, while leaving the instructions themselves to the
+// interpreter until they get native implementations.
+class DSPEmitter final : public JIT::DSPEmitter, public Arm64Gen::ARM64CodeBlock
+{
+public:
+  explicit DSPEmitter(DSPCore& dsp);
+  ~DSPEmitter() override;
+
+  u16 RunCycles(u16 cycles) override;
+  void DoState(PointerWrap& p) override;
+  void ClearIRAM() override;
+
+private:
+  // Runs a block, and returns the number of cycles it took.
+  using DSPCompiledCode = u16 (*)();
+
+  static constexpr size_t MAX_BLOCKS = 0x10000;
+
+  void ClearIRAMandDSPJITCodespaceReset();
+
+  void Compile(u16 start_addr);
+  void EmitInstruction(UDSPInstruction inst);
+  void EmitCheckExceptions();
+  void EmitHandleLoop(bool is_branch);
+  void EmitBlockExit(u16 cycles);
+  u16 GetBlockExitCycles() const;
+
+  void StorePC(u16 value);
+
+  std::vector<DSPCompiledCode> m_blocks;
+  std::vector<u16> m_block_size;
+
+  u16 m_compile_pc = 0;
+  u16 m_start_address = 0;
+  u16 m_cycles_left = 0;
+
+  DSPCore& m_dsp_core;
+};
+}  // namespace DSP::JIT::arm64
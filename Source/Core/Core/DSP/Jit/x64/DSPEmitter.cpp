@@ -283,6 +283,8 @@ void DSPEmitter::Compile(u16 start_addr)
       // end of each block and in this order
       DSPJitRegCache c(m_gpr);
       HandleLoop();
+      if (!opcode->branch)
+        WriteLoopLink();
       m_gpr.SaveRegs();
       if (!Host::OnThread() && analyzer.IsIdleSkip(start_addr))
       {
@@ -494,12 +496,12 @@ Gen::OpArg DSPEmitter::M_SDSP_external_interrupt_waiting()
 
 Gen::OpArg DSPEmitter::M_SDSP_r_st(size_t index)
 {
-  return MDisp(R15, static_cast<int>(offsetof(SDSP, r.st[index])));
+  return MDisp(R15, static_cast<int>(offsetof(SDSP, r.st) + sizeof(SDSP::r.st[0]) * index));
 }
 
 Gen::OpArg DSPEmitter::M_SDSP_reg_stack_ptrs(size_t index)
 {
-  return MDisp(R15, static_cast<int>(offsetof(SDSP, reg_stack_ptrs[index])));
+  return MDisp(R15, static_cast<int>(offsetof(SDSP, reg_stack_ptrs) + sizeof(SDSP::reg_stack_ptrs[0]) * index));
 }
 
 }  // namespace DSP::JIT::x64
@@ -213,6 +213,7 @@ private:
 
   void WriteBranchExit();
   void WriteBlockLink(u16 dest);
+  void WriteLoopLink();
 
   void ReJitConditional(UDSPInstruction opc, void (DSPEmitter::*conditional_fn)(UDSPInstruction));
   void r_jcc(UDSPInstruction opc);
@@ -123,14 +123,36 @@ void DSPEmitter::WriteBlockLink(u16 dest)
   }
 }
 
+void DSPEmitter::WriteLoopLink()
+{
+  // Jump straight back to the start of the block if the loop restarts there, so that loops
+  // which span the whole block don't return to the dispatcher for every iteration.
+  if (m_dsp_core.DSPState().GetAnalyzer().IsIdleSkip(m_start_address))
+    return;
+
+  m_gpr.FlushRegs();
+  CMP(16, M_SDSP_pc(), Imm16(m_start_address));
+  FixupBranch notBlockStart = J_CC(CC_NE);
+
+  // Check if we have enough cycles to execute the block again
+  MOV(64, R(RAX), ImmPtr(&m_cycles_left));
+  MOV(16, R(ECX), MatR(RAX));
+  CMP(16, R(ECX), Imm16(2 * m_block_size[m_start_address]));
+  FixupBranch notEnoughCycles = J_CC(CC_BE);
+
+  SUB(16, R(ECX), Imm16(m_block_size[m_start_address]));
+  MOV(16, MatR(RAX), R(ECX));
+  JMP(m_block_link_entry, true);
+  SetJumpTarget(notEnoughCycles);
+  SetJumpTarget(notBlockStart);
+}
+
 void DSPEmitter::r_jcc(const UDSPInstruction opc)
 {
   const u16 dest = m_dsp_core.DSPState().ReadIMEM(m_compile_pc + 1);
-  const DSPOPCTemplate* opcode = GetOpTemplate(opc);
 
-  // If the block is unconditional, attempt to link block
-  if (opcode->uncond_branch)
-    WriteBlockLink(dest);
+  // Attempt to link block. For conditional branches, this is only reached if the branch is taken.
+  WriteBlockLink(dest);
   MOV(16, M_SDSP_pc(), Imm16(dest));
   WriteBranchExit();
 }
@@ -172,11 +194,9 @@ void DSPEmitter::r_call(const UDSPInstruction opc)
   MOV(16, R(DX), Imm16(m_compile_pc + 2));
   dsp_reg_store_stack(StackRegister::Call);
   const u16 dest = m_dsp_core.DSPState().ReadIMEM(m_compile_pc + 1);
-  const DSPOPCTemplate* opcode = GetOpTemplate(opc);
 
-  // If the block is unconditional, attempt to link block
-  if (opcode->uncond_branch)
-    WriteBlockLink(dest);
+  // Attempt to link block. For conditional branches, this is only reached if the branch is taken.
+  WriteBlockLink(dest);
   MOV(16, M_SDSP_pc(), Imm16(dest));
   WriteBranchExit();
 }
@@ -150,14 +150,18 @@ std::array<int, 21> CalculateVertexElementSizes(int vatIndex, const CPMemory& cp
 
   return sizes;
 }
-}  // Anonymous namespace
-
-bool s_DrawingObject;
-FifoAnalyzer::CPMemory s_CpMem;
 
-u32 AnalyzeCommand(const u8* data, DecodeMode mode)
+// end may be null if the caller already knows that the whole command is there
+u32 AnalyzeCommand(const u8* data, const u8* end, DecodeMode mode, bool& drawingObject,
+                   CPMemory& cpMem, bool report_errors)
 {
   const u8* dataStart = data;
+  const auto fits = [&](size_t size) {
+    return end == nullptr || static_cast<size_t>(end - data) >= size;
+  };
+
+  if (!fits(1))
+    return 0;
 
   int cmd = ReadFifo8(data);
 
@@ -170,20 +174,26 @@ u32 AnalyzeCommand(const u8* data, DecodeMode mode)
 
   case OpcodeDecoder::GX_LOAD_CP_REG:
   {
-    s_DrawingObject = false;
+    drawingObject = false;
+    if (!fits(5))
+      return 0;
 
     u32 cmd2 = ReadFifo8(data);
     u32 value = ReadFifo32(data);
-    LoadCPReg(cmd2, value, s_CpMem);
+    LoadCPReg(cmd2, value, cpMem);
     break;
   }
 
   case OpcodeDecoder::GX_LOAD_XF_REG:
   {
-    s_DrawingObject = false;
+    drawingObject = false;
+    if (!fits(4))
+      return 0;
 
     u32 cmd2 = ReadFifo32(data);
     u8 streamSize = ((cmd2 >> 16) & 15) + 1;
+    if (!fits(streamSize * 4))
+      return 0;
 
     data += streamSize * 4;
     break;
@@ -194,7 +204,9 @@ u32 AnalyzeCommand(const u8* data, DecodeMode mode)
   case OpcodeDecoder::GX_LOAD_INDX_C:
   case OpcodeDecoder::GX_LOAD_INDX_D:
   {
-    s_DrawingObject = false;
+    drawingObject = false;
+    if (!fits(4))
+      return 0;
 
     int array = 0xc + (cmd - OpcodeDecoder::GX_LOAD_INDX_A) / 8;
     u32 value = ReadFifo32(data);
@@ -209,12 +221,16 @@ u32 AnalyzeCommand(const u8* data, DecodeMode mode)
     // start them
     // That is done to make it easier to track where memory is updated
     ASSERT(false);
+    if (!fits(8))
+      return 0;
     data += 8;
     break;
 
   case OpcodeDecoder::GX_LOAD_BP_REG:
   {
-    s_DrawingObject = false;
+    drawingObject = false;
+    if (!fits(4))
+      return 0;
     ReadFifo32(data);
     break;
   }
@@ -222,10 +238,10 @@ u32 AnalyzeCommand(const u8* data, DecodeMode mode)
   default:
     if (cmd & 0x80)
     {
-      s_DrawingObject = true;
+      drawingObject = true;
 
       const std::array<int, 21> sizes =
-          CalculateVertexElementSizes(cmd & OpcodeDecoder::GX_VAT_MASK, s_CpMem);
+          CalculateVertexElementSizes(cmd & OpcodeDecoder::GX_VAT_MASK, cpMem);
 
       // Determine offset of each element that might be a vertex array
       // The first 9 elements are never vertex arrays so we just accumulate their sizes.
@@ -237,8 +253,13 @@ u32 AnalyzeCommand(const u8* data, DecodeMode mode)
         offset += sizes[i + 9];
       }
 
+      if (!fits(2))
+        return 0;
+
       const int vertexSize = offset;
       const int numVertices = ReadFifo16(data);
+      if (!fits(static_cast<size_t>(numVertices) * vertexSize))
+        return 0;
 
       if (mode == DecodeMode::Record && numVertices > 0)
       {
@@ -253,7 +274,8 @@ u32 AnalyzeCommand(const u8* data, DecodeMode mode)
     }
     else
     {
-      PanicAlertFmt("FifoPlayer: Unknown Opcode ({:#x}).\n", cmd);
+      if (report_errors)
+        PanicAlertFmt("FifoPlayer: Unknown Opcode ({:#x}).\n", cmd);
       return 0;
     }
     break;
@@ -261,6 +283,21 @@ u32 AnalyzeCommand(const u8* data, DecodeMode mode)
 
   return (u32)(data - dataStart);
 }
+}  // Anonymous namespace
+
+bool s_DrawingObject;
+FifoAnalyzer::CPMemory s_CpMem;
+
+u32 AnalyzeCommand(const u8* data, DecodeMode mode)
+{
+  return AnalyzeCommand(data, nullptr, mode, s_DrawingObject, s_CpMem, true);
+}
+
+u32 AnalyzePlaybackCommand(const u8* data, const u8* end, bool& drawingObject, CPMemory& cpMem,
+                           bool report_errors)
+{
+  return AnalyzeCommand(data, end, DecodeMode::Playback, drawingObject, cpMem, report_errors);
+}
 
 void LoadCPReg(u32 subCmd, u32 value, CPMemory& cpMem)
 {
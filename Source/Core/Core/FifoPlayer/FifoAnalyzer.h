@@ -29,6 +29,12 @@ struct CPMemory
 
 void LoadCPReg(u32 subCmd, u32 value, CPMemory& cpMem);
 
+// Like AnalyzeCommand in playback mode, but on the given state instead of s_DrawingObject and
+// s_CpMem so that several threads can analyze frames at once. Returns 0 if the command doesn't end
+// before end, and only shows an error for unknown opcodes if report_errors is set.
+u32 AnalyzePlaybackCommand(const u8* data, const u8* end, bool& drawingObject, CPMemory& cpMem,
+                           bool report_errors);
+
 extern bool s_DrawingObject;
 extern FifoAnalyzer::CPMemory s_CpMem;
 }  // namespace FifoAnalyzer
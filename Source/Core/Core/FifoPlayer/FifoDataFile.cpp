@@ -8,9 +8,15 @@
 #include <cstring>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include <zstd.h>
+
+#include "Common/Hash.h"
 #include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "Common/MappedFile.h"
 #include "Common/MsgHandler.h"
 #include "Core/Config/MainSettings.h"
 #include "Core/HW/Memmap.h"
@@ -18,13 +24,14 @@
 enum
 {
   FILE_ID = 0x0d01f1f0,
-  VERSION_NUMBER = 5,
-  MIN_LOADER_VERSION = 1,
-  // This value is only used if the DFF file was created with overridden RAM sizes.
-  // If the MIN_LOADER_VERSION ever exceeds this, it's alright to remove it.
-  MIN_LOADER_VERSION_FOR_RAM_OVERRIDE = 5,
+  VERSION_NUMBER = 6,
+  // Version 6 compresses the frames, which older loaders can't read
+  MIN_LOADER_VERSION = 6,
+  FIRST_COMPRESSED_VERSION = 6,
 };
 
+constexpr int COMPRESSION_LEVEL = 3;
+
 #pragma pack(push, 1)
 
 struct FileHeader
@@ -49,7 +56,10 @@ struct FileHeader
   // will crash and burn with mismatched settings.  See PR #8722.
   u32 mem1_size;
   u32 mem2_size;
-  u8 reserved[32];
+  // Only used by compressed files
+  u64 memoryDataListOffset;
+  u32 memoryDataCount;
+  u8 reserved[20];
 };
 static_assert(sizeof(FileHeader) == 128, "FileHeader should be 128 bytes");
 
@@ -76,6 +86,41 @@ struct FileMemoryUpdate
 };
 static_assert(sizeof(FileMemoryUpdate) == 24, "FileMemoryUpdate should be 24 bytes");
 
+// Used instead of FileFrameInfo by compressed files. The payload is the FIFO data followed by
+// numMemoryUpdates FileCompressedMemoryUpdates, compressed together.
+struct FileCompressedFrameInfo
+{
+  u64 payloadOffset;
+  u32 payloadCompressedSize;
+  u32 fifoDataSize;
+  u32 fifoStart;
+  u32 fifoEnd;
+  u32 numMemoryUpdates;
+  u8 reserved[36];
+};
+static_assert(sizeof(FileCompressedFrameInfo) == 64, "FileCompressedFrameInfo should be 64 bytes");
+
+struct FileCompressedMemoryUpdate
+{
+  u32 fifoPosition;
+  u32 address;
+  // Index into the memory data list. Identical updates, such as a texture that gets loaded every
+  // frame, share the same entry.
+  u32 dataIndex;
+  u8 type;
+  u8 reserved[3];
+};
+static_assert(sizeof(FileCompressedMemoryUpdate) == 16,
+              "FileCompressedMemoryUpdate should be 16 bytes");
+
+struct FileMemoryData
+{
+  u64 dataOffset;
+  u32 compressedSize;
+  u32 dataSize;
+};
+static_assert(sizeof(FileMemoryData) == 16, "FileMemoryData should be 16 bytes");
+
 #pragma pack(pop)
 
 FifoDataFile::FifoDataFile() = default;
@@ -104,7 +149,49 @@ bool FifoDataFile::GetIsWii() const
 
 void FifoDataFile::AddFrame(const FifoFrameInfo& frameInfo)
 {
-  m_Frames.push_back(frameInfo);
+  m_Frames.push_back(std::make_shared<const FifoFrameInfo>(frameInfo));
+}
+
+std::shared_ptr<const FifoFrameInfo> FifoDataFile::GetFrame(u32 frame) const
+{
+  if (!m_mapped_file)
+    return m_Frames[frame];
+
+  {
+    std::lock_guard lock(m_cache_mutex);
+    if (m_cached_frame && m_cached_frame_number == frame)
+      return m_cached_frame;
+  }
+
+  // Decompressed without holding the lock, so that several threads can read frames at once
+  std::shared_ptr<const FifoFrameInfo> result = ReadCompressedFrame(frame);
+
+  std::lock_guard lock(m_cache_mutex);
+  m_cached_frame = result;
+  m_cached_frame_number = frame;
+  return result;
+}
+
+u32 FifoDataFile::GetFrameCount() const
+{
+  if (m_mapped_file)
+    return static_cast<u32>(m_compressed_frames.size());
+
+  return static_cast<u32>(m_Frames.size());
+}
+
+static bool WriteCompressed(const u8* data, size_t size, std::vector<u8>& buffer,
+                            File::IOFile& file, u64* offset, u32* compressed_size)
+{
+  buffer.resize(ZSTD_compressBound(size));
+  const size_t result = ZSTD_compress(buffer.data(), buffer.size(), data, size, COMPRESSION_LEVEL);
+  if (ZSTD_isError(result))
+    return false;
+
+  file.Seek(0, SEEK_END);
+  *offset = file.Tell();
+  *compressed_size = static_cast<u32>(result);
+  return file.WriteBytes(buffer.data(), result);
 }
 
 bool FifoDataFile::Save(const std::string& filename)
@@ -118,7 +205,7 @@ bool FifoDataFile::Save(const std::string& filename)
 
   // Add space for frame list
   u64 frameListOffset = file.Tell();
-  PadFile(m_Frames.size() * sizeof(FileFrameInfo), file);
+  PadFile(GetFrameCount() * sizeof(FileCompressedFrameInfo), file);
 
   u64 bpMemOffset = file.Tell();
   file.WriteArray(m_BPMem, BP_MEM_SIZE);
@@ -135,15 +222,82 @@ bool FifoDataFile::Save(const std::string& filename)
   u64 texMemOffset = file.Tell();
   file.WriteArray(m_TexMem, TEX_MEM_SIZE);
 
+  // Write frames
+  std::vector<FileMemoryData> memoryData;
+  std::unordered_multimap<u64, u32> memoryDataByHash;
+  std::vector<std::shared_ptr<const FifoFrameInfo>> memoryDataFrames;
+  std::vector<const std::vector<u8>*> memoryDataSources;
+  std::vector<u8> payload;
+  std::vector<u8> buffer;
+  bool success = true;
+
+  const u32 frameCount = GetFrameCount();
+  for (u32 i = 0; i < frameCount; ++i)
+  {
+    const std::shared_ptr<const FifoFrameInfo> srcFrame = GetFrame(i);
+
+    payload.assign(srcFrame->fifoData.begin(), srcFrame->fifoData.end());
+    for (const MemoryUpdate& srcUpdate : srcFrame->memoryUpdates)
+    {
+      const u32 dataSize = static_cast<u32>(srcUpdate.data.size());
+      const u64 hash = Common::GetHash64(srcUpdate.data.data(), dataSize, 0);
+
+      u32 dataIndex = static_cast<u32>(memoryData.size());
+      const auto [first, last] = memoryDataByHash.equal_range(hash);
+      for (auto it = first; it != last; ++it)
+      {
+        if (*memoryDataSources[it->second] == srcUpdate.data)
+        {
+          dataIndex = it->second;
+          break;
+        }
+      }
+
+      if (dataIndex == memoryData.size())
+      {
+        FileMemoryData data{};
+        data.dataSize = dataSize;
+        success &= WriteCompressed(srcUpdate.data.data(), dataSize, buffer, file,
+                                   &data.dataOffset, &data.compressedSize);
+        memoryData.push_back(data);
+        memoryDataByHash.emplace(hash, dataIndex);
+        // Streamed frames only stay around for as long as something refers to them
+        memoryDataFrames.push_back(srcFrame);
+        memoryDataSources.push_back(&srcUpdate.data);
+      }
+
+      FileCompressedMemoryUpdate dstUpdate{};
+      dstUpdate.fifoPosition = srcUpdate.fifoPosition;
+      dstUpdate.address = srcUpdate.address;
+      dstUpdate.dataIndex = dataIndex;
+      dstUpdate.type = srcUpdate.type;
+      const u8* dstUpdateBytes = reinterpret_cast<const u8*>(&dstUpdate);
+      payload.insert(payload.end(), dstUpdateBytes, dstUpdateBytes + sizeof(dstUpdate));
+    }
+
+    FileCompressedFrameInfo dstFrame{};
+    dstFrame.fifoDataSize = static_cast<u32>(srcFrame->fifoData.size());
+    dstFrame.fifoStart = srcFrame->fifoStart;
+    dstFrame.fifoEnd = srcFrame->fifoEnd;
+    dstFrame.numMemoryUpdates = static_cast<u32>(srcFrame->memoryUpdates.size());
+    success &= WriteCompressed(payload.data(), payload.size(), buffer, file,
+                               &dstFrame.payloadOffset, &dstFrame.payloadCompressedSize);
+
+    // Write frame info
+    u64 frameOffset = frameListOffset + (i * sizeof(FileCompressedFrameInfo));
+    file.Seek(frameOffset, SEEK_SET);
+    file.WriteBytes(&dstFrame, sizeof(FileCompressedFrameInfo));
+  }
+
+  file.Seek(0, SEEK_END);
+  u64 memoryDataListOffset = file.Tell();
+  file.WriteArray(memoryData.data(), memoryData.size());
+
   // Write header
-  FileHeader header;
+  FileHeader header{};
   header.fileId = FILE_ID;
   header.file_version = VERSION_NUMBER;
-  // Maintain backwards compatability so long as the RAM sizes aren't overridden.
-  if (Config::Get(Config::MAIN_RAM_OVERRIDE_ENABLE))
-    header.min_loader_version = MIN_LOADER_VERSION_FOR_RAM_OVERRIDE;
-  else
-    header.min_loader_version = MIN_LOADER_VERSION;
+  header.min_loader_version = MIN_LOADER_VERSION;
 
   header.bpMemOffset = bpMemOffset;
   header.bpMemSize = BP_MEM_SIZE;
@@ -161,41 +315,21 @@ bool FifoDataFile::Save(const std::string& filename)
   header.texMemSize = TEX_MEM_SIZE;
 
   header.frameListOffset = frameListOffset;
-  header.frameCount = (u32)m_Frames.size();
+  header.frameCount = frameCount;
 
   header.flags = m_Flags;
 
   header.mem1_size = Memory::GetRamSizeReal();
   header.mem2_size = Memory::GetExRamSizeReal();
 
+  header.memoryDataListOffset = memoryDataListOffset;
+  header.memoryDataCount = static_cast<u32>(memoryData.size());
+
   file.Seek(0, SEEK_SET);
   file.WriteBytes(&header, sizeof(FileHeader));
 
-  // Write frames list
-  for (unsigned int i = 0; i < m_Frames.size(); ++i)
-  {
-    const FifoFrameInfo& srcFrame = m_Frames[i];
-
-    // Write FIFO data
-    file.Seek(0, SEEK_END);
-    u64 dataOffset = file.Tell();
-    file.WriteBytes(srcFrame.fifoData.data(), srcFrame.fifoData.size());
-
-    u64 memoryUpdatesOffset = WriteMemoryUpdates(srcFrame.memoryUpdates, file);
-
-    FileFrameInfo dstFrame;
-    dstFrame.fifoDataSize = static_cast<u32>(srcFrame.fifoData.size());
-    dstFrame.fifoDataOffset = dataOffset;
-    dstFrame.fifoStart = srcFrame.fifoStart;
-    dstFrame.fifoEnd = srcFrame.fifoEnd;
-    dstFrame.memoryUpdatesOffset = memoryUpdatesOffset;
-    dstFrame.numMemoryUpdates = static_cast<u32>(srcFrame.memoryUpdates.size());
-
-    // Write frame info
-    u64 frameOffset = frameListOffset + (i * sizeof(FileFrameInfo));
-    file.Seek(frameOffset, SEEK_SET);
-    file.WriteBytes(&dstFrame, sizeof(FileFrameInfo));
-  }
+  if (!success || !file.IsGood())
+    return false;
 
   if (!file.Close())
     return false;
@@ -297,6 +431,45 @@ std::unique_ptr<FifoDataFile> FifoDataFile::Load(const std::string& filename, bo
   dataFile->m_ram_size_real = header.mem1_size;
   dataFile->m_exram_size_real = header.mem2_size;
 
+  if (dataFile->m_Version >= FIRST_COMPRESSED_VERSION)
+  {
+    dataFile->m_compressed_frames.resize(header.frameCount);
+    file.Seek(header.frameListOffset, SEEK_SET);
+    for (CompressedFrame& dstFrame : dataFile->m_compressed_frames)
+    {
+      FileCompressedFrameInfo srcFrame;
+      file.ReadBytes(&srcFrame, sizeof(FileCompressedFrameInfo));
+
+      const u32 payloadSize = srcFrame.fifoDataSize +
+                              srcFrame.numMemoryUpdates * sizeof(FileCompressedMemoryUpdate);
+      dstFrame.payload = {srcFrame.payloadOffset, srcFrame.payloadCompressedSize, payloadSize};
+      dstFrame.fifo_start = srcFrame.fifoStart;
+      dstFrame.fifo_end = srcFrame.fifoEnd;
+      dstFrame.fifo_data_size = srcFrame.fifoDataSize;
+      dstFrame.num_memory_updates = srcFrame.numMemoryUpdates;
+    }
+
+    dataFile->m_memory_data.resize(header.memoryDataCount);
+    file.Seek(header.memoryDataListOffset, SEEK_SET);
+    for (CompressedData& dstData : dataFile->m_memory_data)
+    {
+      FileMemoryData srcData;
+      file.ReadBytes(&srcData, sizeof(FileMemoryData));
+      dstData = {srcData.dataOffset, srcData.compressedSize, srcData.dataSize};
+    }
+
+    const bool good = file.IsGood();
+    file.Close();
+    if (!good)
+      return nullptr;
+
+    dataFile->m_mapped_file = std::make_unique<File::MappedFile>();
+    if (!dataFile->m_mapped_file->Open(filename))
+      return nullptr;
+
+    return dataFile;
+  }
+
   // Read frames
   for (u32 i = 0; i < header.frameCount; ++i)
   {
@@ -343,37 +516,6 @@ bool FifoDataFile::GetFlag(u32 flag) const
   return !!(m_Flags & flag);
 }
 
-u64 FifoDataFile::WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates,
-                                     File::IOFile& file)
-{
-  // Add space for memory update list
-  u64 updateListOffset = file.Tell();
-  PadFile(memUpdates.size() * sizeof(FileMemoryUpdate), file);
-
-  for (unsigned int i = 0; i < memUpdates.size(); ++i)
-  {
-    const MemoryUpdate& srcUpdate = memUpdates[i];
-
-    // Write memory
-    file.Seek(0, SEEK_END);
-    u64 dataOffset = file.Tell();
-    file.WriteBytes(srcUpdate.data.data(), srcUpdate.data.size());
-
-    FileMemoryUpdate dstUpdate;
-    dstUpdate.address = srcUpdate.address;
-    dstUpdate.dataOffset = dataOffset;
-    dstUpdate.dataSize = static_cast<u32>(srcUpdate.data.size());
-    dstUpdate.fifoPosition = srcUpdate.fifoPosition;
-    dstUpdate.type = srcUpdate.type;
-
-    u64 updateOffset = updateListOffset + (i * sizeof(FileMemoryUpdate));
-    file.Seek(updateOffset, SEEK_SET);
-    file.WriteBytes(&dstUpdate, sizeof(FileMemoryUpdate));
-  }
-
-  return updateListOffset;
-}
-
 void FifoDataFile::ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
                                      std::vector<MemoryUpdate>& memUpdates, File::IOFile& file)
 {
@@ -396,3 +538,61 @@ void FifoDataFile::ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
     file.ReadBytes(dstUpdate.data.data(), srcUpdate.dataSize);
   }
 }
+
+bool FifoDataFile::DecompressData(const CompressedData& data, u8* out) const
+{
+  const u64 file_size = m_mapped_file->GetSize();
+  if (data.offset > file_size || data.compressed_size > file_size - data.offset)
+    return false;
+
+  const size_t result = ZSTD_decompress(out, data.size, m_mapped_file->GetData() + data.offset,
+                                        data.compressed_size);
+  return !ZSTD_isError(result) && result == data.size;
+}
+
+std::shared_ptr<const FifoFrameInfo> FifoDataFile::ReadCompressedFrame(u32 frame) const
+{
+  const CompressedFrame& srcFrame = m_compressed_frames[frame];
+
+  auto dstFrame = std::make_shared<FifoFrameInfo>();
+  dstFrame->fifoStart = srcFrame.fifo_start;
+  dstFrame->fifoEnd = srcFrame.fifo_end;
+
+  std::vector<u8> payload(srcFrame.payload.size);
+  if (payload.size() < srcFrame.fifo_data_size || !DecompressData(srcFrame.payload, payload.data()))
+  {
+    ERROR_LOG_FMT(VIDEO, "Failed to decompress FIFO log frame {}", frame);
+    return dstFrame;
+  }
+
+  dstFrame->fifoData.assign(payload.begin(), payload.begin() + srcFrame.fifo_data_size);
+
+  dstFrame->memoryUpdates.resize(srcFrame.num_memory_updates);
+  const u8* srcUpdates = payload.data() + srcFrame.fifo_data_size;
+  for (MemoryUpdate& dstUpdate : dstFrame->memoryUpdates)
+  {
+    FileCompressedMemoryUpdate srcUpdate;
+    std::memcpy(&srcUpdate, srcUpdates, sizeof(FileCompressedMemoryUpdate));
+    srcUpdates += sizeof(FileCompressedMemoryUpdate);
+
+    dstUpdate.fifoPosition = srcUpdate.fifoPosition;
+    dstUpdate.address = srcUpdate.address;
+    dstUpdate.type = static_cast<MemoryUpdate::Type>(srcUpdate.type);
+
+    if (srcUpdate.dataIndex >= m_memory_data.size())
+    {
+      ERROR_LOG_FMT(VIDEO, "Invalid memory update in FIFO log frame {}", frame);
+      continue;
+    }
+
+    const CompressedData& data = m_memory_data[srcUpdate.dataIndex];
+    dstUpdate.data.resize(data.size);
+    if (!DecompressData(data, dstUpdate.data.data()))
+    {
+      ERROR_LOG_FMT(VIDEO, "Failed to decompress memory update in FIFO log frame {}", frame);
+      dstUpdate.data.clear();
+    }
+  }
+
+  return dstFrame;
+}
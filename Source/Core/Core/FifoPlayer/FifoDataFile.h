@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -14,6 +15,7 @@
 namespace File
 {
 class IOFile;
+class MappedFile;
 }
 
 struct MemoryUpdate
@@ -73,8 +75,10 @@ public:
   u32 GetExRamSizeReal() { return m_exram_size_real; }
 
   void AddFrame(const FifoFrameInfo& frameInfo);
-  const FifoFrameInfo& GetFrame(u32 frame) const { return m_Frames[frame]; }
-  u32 GetFrameCount() const { return static_cast<u32>(m_Frames.size()); }
+  // The frames of compressed files are only decompressed from the file when they are needed, so
+  // hold on to the returned frame for as long as it is used instead of calling this again.
+  std::shared_ptr<const FifoFrameInfo> GetFrame(u32 frame) const;
+  u32 GetFrameCount() const;
   bool Save(const std::string& filename);
 
   static std::unique_ptr<FifoDataFile> Load(const std::string& filename, bool flagsOnly);
@@ -90,10 +94,29 @@ private:
   void SetFlag(u32 flag, bool set);
   bool GetFlag(u32 flag) const;
 
-  u64 WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
   static void ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
                                 std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
 
+  struct CompressedData
+  {
+    u64 offset;
+    u32 compressed_size;
+    u32 size;
+  };
+
+  struct CompressedFrame
+  {
+    // The FIFO data followed by the memory updates, which refer to m_memory_data
+    CompressedData payload;
+    u32 fifo_start;
+    u32 fifo_end;
+    u32 fifo_data_size;
+    u32 num_memory_updates;
+  };
+
+  bool DecompressData(const CompressedData& data, u8* out) const;
+  std::shared_ptr<const FifoFrameInfo> ReadCompressedFrame(u32 frame) const;
+
   u32 m_BPMem[BP_MEM_SIZE];
   u32 m_CPMem[CP_MEM_SIZE];
   u32 m_XFMem[XF_MEM_SIZE];
@@ -105,5 +128,15 @@ private:
   u32 m_Flags = 0;
   u32 m_Version = 0;
 
-  std::vector<FifoFrameInfo> m_Frames;
+  std::vector<std::shared_ptr<const FifoFrameInfo>> m_Frames;
+
+  // Compressed files are mapped instead of being read in completely, since they can be far larger
+  // than what fits in memory. m_Frames is empty for them.
+  std::unique_ptr<File::MappedFile> m_mapped_file;
+  std::vector<CompressedFrame> m_compressed_frames;
+  std::vector<CompressedData> m_memory_data;
+
+  mutable std::mutex m_cache_mutex;
+  mutable std::shared_ptr<const FifoFrameInfo> m_cached_frame;
+  mutable u32 m_cached_frame_number = 0;
 };
@@ -4,11 +4,22 @@
 
 #include "Core/FifoPlayer/FifoPlaybackAnalyzer.h"
 
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Hash.h"
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "Common/Swap.h"
+#include "Common/ThreadPool.h"
 #include "Core/FifoPlayer/FifoAnalyzer.h"
 #include "Core/FifoPlayer/FifoDataFile.h"
+#include "VideoCommon/OpcodeDecoding.h"
 
 using namespace FifoAnalyzer;
 
@@ -21,82 +32,330 @@ struct CmdData
   const u8* ptr;
 };
 
-void FifoPlaybackAnalyzer::AnalyzeFrames(FifoDataFile* file,
-                                         std::vector<AnalyzedFrameInfo>& frameInfo)
+namespace
 {
-  u32* cpMem = file->GetCPMem();
-  FifoAnalyzer::LoadCPReg(0x50, cpMem[0x50], s_CpMem);
-  FifoAnalyzer::LoadCPReg(0x60, cpMem[0x60], s_CpMem);
+// The analysis cache is stored next to the log, in a file with this extension
+constexpr char CACHE_EXTENSION[] = ".analysis";
+constexpr u32 CACHE_MAGIC = 0x41504644;  // "DFPA"
+constexpr u32 CACHE_VERSION = 1;
+// How much of the start of the log is hashed to tell whether the cache belongs to it. For version 6
+// and up, that includes the index of all the frames.
+constexpr u32 CACHE_HASHED_SIZE = 1024 * 1024;
 
-  for (int i = 0; i < 8; ++i)
+#pragma pack(push, 1)
+struct CacheHeader
+{
+  u32 magic;
+  u32 version;
+  u64 fileSize;
+  u64 fileHash;
+  u32 frameCount;
+};
+#pragma pack(pop)
+
+// The only CP registers that change how long commands are, so the only state analyzing a frame
+// depends on: the two halves of the vertex descriptor, then the three groups of each vertex format.
+constexpr u32 VTX_DESC_LOW_REGISTER = 0;
+constexpr u32 VTX_DESC_HIGH_REGISTER = 1;
+constexpr u32 VTX_ATTR_REGISTER = 2;
+
+constexpr u32 GetVtxAttrRegister(u32 vat, u32 group)
+{
+  return VTX_ATTR_REGISTER + vat * 3 + group;
+}
+
+std::optional<u32> GetLengthRegister(u32 subCmd)
+{
+  switch (subCmd & 0xF0)
   {
-    FifoAnalyzer::LoadCPReg(0x70 + i, cpMem[0x70 + i], s_CpMem);
-    FifoAnalyzer::LoadCPReg(0x80 + i, cpMem[0x80 + i], s_CpMem);
-    FifoAnalyzer::LoadCPReg(0x90 + i, cpMem[0x90 + i], s_CpMem);
+  case 0x50:
+    return VTX_DESC_LOW_REGISTER;
+  case 0x60:
+    return VTX_DESC_HIGH_REGISTER;
+  case 0x70:
+  case 0x80:
+  case 0x90:
+    return GetVtxAttrRegister(subCmd & 7, ((subCmd & 0xF0) - 0x70) >> 4);
+  default:
+    return std::nullopt;
   }
+}
 
-  frameInfo.clear();
-  frameInfo.resize(file->GetFrameCount());
+u32 ReadLengthRegister(const CPMemory& cpMem, u32 reg)
+{
+  if (reg == VTX_DESC_LOW_REGISTER)
+    return static_cast<u32>(cpMem.vtxDesc.Hex & 0x1FFFF);
+  if (reg == VTX_DESC_HIGH_REGISTER)
+    return static_cast<u32>(cpMem.vtxDesc.Hex >> 17);
 
-  for (u32 frameIdx = 0; frameIdx < file->GetFrameCount(); ++frameIdx)
+  const VAT& vtxAttr = cpMem.vtxAttr[(reg - VTX_ATTR_REGISTER) / 3];
+  switch ((reg - VTX_ATTR_REGISTER) % 3)
   {
-    const FifoFrameInfo& frame = file->GetFrame(frameIdx);
-    AnalyzedFrameInfo& analyzed = frameInfo[frameIdx];
+  case 0:
+    return vtxAttr.g0.Hex;
+  case 1:
+    return vtxAttr.g1.Hex;
+  default:
+    return vtxAttr.g2.Hex;
+  }
+}
+
+struct FrameAnalysis
+{
+  AnalyzedFrameInfo info;
+  bool failed = false;
+  // Bit mask of the length registers that were used before the frame set them. The analysis is
+  // only right for a start state which has the values it was done with in those.
+  u32 registersRead = 0;
+  // The writes to the length registers in order, to get the state at the end of the frame from
+  // whatever state it actually started with
+  std::vector<std::pair<u32, u32>> cpWrites;
+};
 
-    s_DrawingObject = false;
+FrameAnalysis AnalyzeFrame(const FifoFrameInfo& frame, CPMemory cpMem, bool report_errors)
+{
+  FrameAnalysis result;
+  AnalyzedFrameInfo& analyzed = result.info;
+
+  const u8* const data = frame.fifoData.data();
+  const u8* const end = data + frame.fifoData.size();
+  u32 registersWritten = 0;
+  bool drawingObject = false;
 
-    u32 cmdStart = 0;
-    u32 nextMemUpdate = 0;
+  u32 cmdStart = 0;
 
 #if LOG_FIFO_CMDS
-    // Debugging
-    std::vector<CmdData> prevCmds;
+  // Debugging
+  std::vector<CmdData> prevCmds;
 #endif
 
-    while (cmdStart < frame.fifoData.size())
+  while (cmdStart < frame.fifoData.size())
+  {
+    const u8* const cmd = data + cmdStart;
+    const bool wasDrawing = drawingObject;
+
+    if (*cmd & 0x80)
     {
-      // Add memory updates that have occurred before this point in the frame
-      while (nextMemUpdate < frame.memoryUpdates.size() &&
-             frame.memoryUpdates[nextMemUpdate].fifoPosition <= cmdStart)
-      {
-        analyzed.memoryUpdates.push_back(frame.memoryUpdates[nextMemUpdate]);
-        ++nextMemUpdate;
-      }
+      const u32 vat = *cmd & OpcodeDecoder::GX_VAT_MASK;
+      const u32 used = (1 << VTX_DESC_LOW_REGISTER) | (1 << VTX_DESC_HIGH_REGISTER) |
+                       (7 << GetVtxAttrRegister(vat, 0));
+      result.registersRead |= used & ~registersWritten;
+    }
 
-      const bool wasDrawing = s_DrawingObject;
-      const u32 cmdSize =
-          FifoAnalyzer::AnalyzeCommand(&frame.fifoData[cmdStart], DecodeMode::Playback);
+    const u32 cmdSize = AnalyzePlaybackCommand(cmd, end, drawingObject, cpMem, report_errors);
 
 #if LOG_FIFO_CMDS
-      CmdData cmdData;
-      cmdData.offset = cmdStart;
-      cmdData.ptr = &frame.fifoData[cmdStart];
-      cmdData.size = cmdSize;
-      prevCmds.push_back(cmdData);
+    CmdData cmdData;
+    cmdData.offset = cmdStart;
+    cmdData.ptr = cmd;
+    cmdData.size = cmdSize;
+    prevCmds.push_back(cmdData);
 #endif
 
-      // Check for error
-      if (cmdSize == 0)
-      {
-        // Clean up frame analysis
-        analyzed.objectStarts.clear();
-        analyzed.objectEnds.clear();
+    // Check for error
+    if (cmdSize == 0)
+    {
+      // Clean up frame analysis
+      analyzed.objectStarts.clear();
+      analyzed.objectEnds.clear();
+      result.failed = true;
 
-        return;
+      return result;
+    }
+
+    if (*cmd == OpcodeDecoder::GX_LOAD_CP_REG)
+    {
+      if (const std::optional<u32> reg = GetLengthRegister(cmd[1]))
+      {
+        result.cpWrites.emplace_back(cmd[1], Common::swap32(cmd + 2));
+        // Loading the low half of the descriptor can also set bits of the high half, but it never
+        // clears them, so the high half still depends on its previous value
+        registersWritten |= 1 << *reg;
       }
+    }
+
+    if (wasDrawing != drawingObject)
+    {
+      if (drawingObject)
+        analyzed.objectStarts.push_back(cmdStart);
+      else
+        analyzed.objectEnds.push_back(cmdStart);
+    }
+
+    cmdStart += cmdSize;
+  }
+
+  if (analyzed.objectEnds.size() < analyzed.objectStarts.size())
+    analyzed.objectEnds.push_back(cmdStart);
+
+  return result;
+}
+
+bool IsAnalysisFor(const FrameAnalysis& analysis, const CPMemory& assumed, const CPMemory& actual)
+{
+  for (u32 reg = 0; analysis.registersRead >> reg != 0; ++reg)
+  {
+    if ((analysis.registersRead >> reg & 1) &&
+        ReadLengthRegister(assumed, reg) != ReadLengthRegister(actual, reg))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns false if a frame couldn't be analyzed
+bool AnalyzeFramesUncached(FifoDataFile* file, std::vector<AnalyzedFrameInfo>& frameInfo)
+{
+  u32* cpMem = file->GetCPMem();
+  CPMemory startCpMem{};
+  FifoAnalyzer::LoadCPReg(0x50, cpMem[0x50], startCpMem);
+  FifoAnalyzer::LoadCPReg(0x60, cpMem[0x60], startCpMem);
+
+  for (int i = 0; i < 8; ++i)
+  {
+    FifoAnalyzer::LoadCPReg(0x70 + i, cpMem[0x70 + i], startCpMem);
+    FifoAnalyzer::LoadCPReg(0x80 + i, cpMem[0x80 + i], startCpMem);
+    FifoAnalyzer::LoadCPReg(0x90 + i, cpMem[0x90 + i], startCpMem);
+  }
+
+  const u32 frameCount = file->GetFrameCount();
+  std::vector<FrameAnalysis> analyses(frameCount);
+
+  // The state a frame starts with is only known once all of the frames before it are analyzed.
+  // Instead of waiting for that, each frame is first analyzed on its own as if it started with the
+  // state from the start of the log. Games tend to set up the vertex formats they use in every
+  // frame, so that usually gives the right result straight away.
+  Common::ThreadPool::GetShared().ParallelFor(frameCount, [&](u32 i) {
+    analyses[i] = AnalyzeFrame(*file->GetFrame(i), startCpMem, false);
+  });
+
+  // Then the actual start states are worked out in order, and the frames whose result depended on
+  // a register that had a different value in it are analyzed again.
+  frameInfo.clear();
+  frameInfo.resize(frameCount);
+
+  CPMemory currentCpMem = startCpMem;
+  for (u32 i = 0; i < frameCount; ++i)
+  {
+    FrameAnalysis& analysis = analyses[i];
+    if (analysis.failed || !IsAnalysisFor(analysis, startCpMem, currentCpMem))
+      analysis = AnalyzeFrame(*file->GetFrame(i), currentCpMem, true);
+
+    frameInfo[i] = std::move(analysis.info);
+
+    // The frames after an error are left without objects
+    if (analysis.failed)
+      return false;
+
+    for (const auto& [subCmd, value] : analysis.cpWrites)
+      FifoAnalyzer::LoadCPReg(subCmd, value, currentCpMem);
+  }
+
+  return true;
+}
+
+std::optional<CacheHeader> GetCacheHeader(const std::string& filename, u32 frameCount)
+{
+  File::IOFile file(filename, "rb");
+  if (!file)
+    return std::nullopt;
+
+  const u64 fileSize = file.GetSize();
+  std::vector<u8> start(std::min<u64>(fileSize, CACHE_HASHED_SIZE));
+  if (!file.ReadBytes(start.data(), start.size()))
+    return std::nullopt;
+
+  CacheHeader header{};
+  header.magic = CACHE_MAGIC;
+  header.version = CACHE_VERSION;
+  header.fileSize = fileSize;
+  header.fileHash = Common::GetHash64(start.data(), static_cast<u32>(start.size()), 0);
+  header.frameCount = frameCount;
+  return header;
+}
+
+bool ReadObjectList(File::IOFile& file, std::vector<u32>& list)
+{
+  u32 count;
+  if (!file.ReadArray(&count, 1) || count > file.GetSize() / sizeof(u32))
+    return false;
+
+  list.resize(count);
+  return file.ReadArray(list.data(), list.size());
+}
 
-      if (wasDrawing != s_DrawingObject)
+bool LoadCache(const std::string& path, const CacheHeader& expected,
+               std::vector<AnalyzedFrameInfo>& frameInfo)
+{
+  File::IOFile file(path, "rb");
+  CacheHeader header;
+  if (!file || !file.ReadArray(&header, 1) || header.magic != expected.magic ||
+      header.version != expected.version || header.fileSize != expected.fileSize ||
+      header.fileHash != expected.fileHash || header.frameCount != expected.frameCount)
+  {
+    return false;
+  }
+
+  frameInfo.clear();
+  frameInfo.resize(header.frameCount);
+  for (AnalyzedFrameInfo& analyzed : frameInfo)
+  {
+    if (!ReadObjectList(file, analyzed.objectStarts) ||
+        !ReadObjectList(file, analyzed.objectEnds) ||
+        analyzed.objectStarts.size() != analyzed.objectEnds.size())
+    {
+      return false;
+    }
+
+    // FifoPlayer uses these as offsets into the frame, so at least make sure they are ordered
+    u32 previousEnd = 0;
+    for (size_t i = 0; i < analyzed.objectStarts.size(); ++i)
+    {
+      if (analyzed.objectStarts[i] < previousEnd ||
+          analyzed.objectEnds[i] < analyzed.objectStarts[i])
       {
-        if (s_DrawingObject)
-          analyzed.objectStarts.push_back(cmdStart);
-        else
-          analyzed.objectEnds.push_back(cmdStart);
+        return false;
       }
+      previousEnd = analyzed.objectEnds[i];
+    }
+  }
 
-      cmdStart += cmdSize;
+  return true;
+}
+
+void SaveCache(const std::string& path, const CacheHeader& header,
+               const std::vector<AnalyzedFrameInfo>& frameInfo)
+{
+  File::IOFile file(path, "wb");
+  bool success = file && file.WriteArray(&header, 1);
+  for (const AnalyzedFrameInfo& analyzed : frameInfo)
+  {
+    for (const std::vector<u32>* list : {&analyzed.objectStarts, &analyzed.objectEnds})
+    {
+      const u32 count = static_cast<u32>(list->size());
+      success = success && file.WriteArray(&count, 1) && file.WriteArray(list->data(), count);
     }
+  }
 
-    if (analyzed.objectEnds.size() < analyzed.objectStarts.size())
-      analyzed.objectEnds.push_back(cmdStart);
+  if (!success)
+  {
+    WARN_LOG_FMT(VIDEO, "Failed to write the FIFO log analysis cache {}", path);
+    file.Close();
+    File::Delete(path);
   }
 }
+}  // Anonymous namespace
+
+void FifoPlaybackAnalyzer::AnalyzeFrames(FifoDataFile* file, const std::string& filename,
+                                         std::vector<AnalyzedFrameInfo>& frameInfo)
+{
+  const std::string cachePath = filename + CACHE_EXTENSION;
+  const std::optional<CacheHeader> header = GetCacheHeader(filename, file->GetFrameCount());
+  if (header && LoadCache(cachePath, *header, frameInfo))
+    return;
+
+  // Logs which couldn't be analyzed completely aren't cached, so that their errors show up again
+  if (AnalyzeFramesUncached(file, frameInfo) && header)
+    SaveCache(cachePath, *header, frameInfo);
+}
@@ -13,10 +13,12 @@ struct AnalyzedFrameInfo
 {
   std::vector<u32> objectStarts;
   std::vector<u32> objectEnds;
-  std::vector<MemoryUpdate> memoryUpdates;
 };
 
 namespace FifoPlaybackAnalyzer
 {
-void AnalyzeFrames(FifoDataFile* file, std::vector<AnalyzedFrameInfo>& frameInfo);
+// Finds the objects in each frame of a log, so that the FIFO player can skip them. The results
+// are cached next to the log file, which takes a while to analyze if it's big.
+void AnalyzeFrames(FifoDataFile* file, const std::string& filename,
+                   std::vector<AnalyzedFrameInfo>& frameInfo);
 }  // namespace FifoPlaybackAnalyzer
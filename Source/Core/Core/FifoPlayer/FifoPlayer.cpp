@@ -6,10 +6,14 @@
 
 #include <algorithm>
 #include <mutex>
+#include <utility>
+
+#include <fmt/format.h>
 
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
 #include "Common/MsgHandler.h"
+#include "Common/StringUtil.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -26,6 +30,7 @@
 #include "Core/PowerPC/PowerPC.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
+#include "VideoCommon/FrameProfiler.h"
 
 // We need to include TextureDecoder.h for the texMem array.
 // TODO: Move texMem somewhere else so this isn't an issue.
@@ -49,7 +54,8 @@ bool FifoPlayer::Open(const std::string& filename)
 
   if (m_File)
   {
-    FifoPlaybackAnalyzer::AnalyzeFrames(m_File.get(), m_FrameInfo);
+    m_Filename = filename;
+    FifoPlaybackAnalyzer::AnalyzeFrames(m_File.get(), filename, m_FrameInfo);
 
     m_FrameRangeEnd = m_File->GetFrameCount();
   }
@@ -63,11 +69,18 @@ bool FifoPlayer::Open(const std::string& filename)
 void FifoPlayer::Close()
 {
   m_File.reset();
+  m_Filename.clear();
 
   m_FrameRangeStart = 0;
   m_FrameRangeEnd = 0;
 }
 
+void FifoPlayer::SetBenchmark(u32 loops, std::string report_path)
+{
+  m_BenchmarkLoops = loops;
+  m_BenchmarkReportPath = std::move(report_path);
+}
+
 bool FifoPlayer::IsPlaying() const
 {
   return GetFile() != nullptr && Core::IsRunning();
@@ -87,9 +100,25 @@ public:
 
     m_parent->m_CurrentFrame = m_parent->m_FrameRangeStart;
     m_parent->LoadMemory();
+
+    if (m_parent->m_BenchmarkLoops != 0)
+    {
+      m_parent->m_BenchmarkLoopsDone = 0;
+      FrameProfiler::Start(m_parent->m_BenchmarkReportPath,
+                           fmt::format("{}, frames {}-{}, {} loops",
+                                       PathToFileName(m_parent->m_Filename),
+                                       m_parent->m_FrameRangeStart, m_parent->m_FrameRangeEnd,
+                                       m_parent->m_BenchmarkLoops));
+      Core::SetIsThrottlerTempDisabled(true);
+    }
   }
 
-  void Shutdown() override { IsPlayingBackFifologWithBrokenEFBCopies = false; }
+  void Shutdown() override
+  {
+    IsPlayingBackFifologWithBrokenEFBCopies = false;
+    if (m_parent->m_BenchmarkLoops != 0)
+      Core::SetIsThrottlerTempDisabled(false);
+  }
   void ClearCache() override
   {
     // Nothing to clear.
@@ -133,8 +162,15 @@ CPU::State FifoPlayer::AdvanceFrame()
 {
   if (m_CurrentFrame >= m_FrameRangeEnd)
   {
-    if (!m_Loop)
+    if (m_BenchmarkLoops != 0)
+    {
+      if (++m_BenchmarkLoopsDone >= m_BenchmarkLoops)
+        return CPU::State::PowerDown;
+    }
+    else if (!m_Loop)
+    {
       return CPU::State::PowerDown;
+    }
     // If there are zero frames in the range then sleep instead of busy spinning
     if (m_FrameRangeStart >= m_FrameRangeEnd)
       return CPU::State::Stepping;
@@ -154,7 +190,7 @@ CPU::State FifoPlayer::AdvanceFrame()
   if (m_EarlyMemoryUpdates && m_CurrentFrame == m_FrameRangeStart)
     WriteAllMemoryUpdates();
 
-  WriteFrame(m_File->GetFrame(m_CurrentFrame), m_FrameInfo[m_CurrentFrame]);
+  WriteFrame(*m_File->GetFrame(m_CurrentFrame), m_FrameInfo[m_CurrentFrame]);
 
   ++m_CurrentFrame;
   return CPU::State::Running;
@@ -314,7 +350,7 @@ void FifoPlayer::WriteFramePart(u32 dataStart, u32 dataEnd, u32& nextMemUpdate,
 
   while (nextMemUpdate < frame.memoryUpdates.size() && dataStart < dataEnd)
   {
-    const MemoryUpdate& memUpdate = info.memoryUpdates[nextMemUpdate];
+    const MemoryUpdate& memUpdate = frame.memoryUpdates[nextMemUpdate];
 
     if (memUpdate.fifoPosition < dataEnd)
     {
@@ -345,8 +381,8 @@ void FifoPlayer::WriteAllMemoryUpdates()
 
   for (u32 frameNum = 0; frameNum < m_File->GetFrameCount(); ++frameNum)
   {
-    const FifoFrameInfo& frame = m_File->GetFrame(frameNum);
-    for (auto& update : frame.memoryUpdates)
+    const std::shared_ptr<const FifoFrameInfo> frame = m_File->GetFrame(frameNum);
+    for (auto& update : frame->memoryUpdates)
     {
       WriteMemory(update);
     }
@@ -401,7 +437,8 @@ void FifoPlayer::SetupFifo()
   WriteCP(CommandProcessor::CTRL_REGISTER, 0);   // disable read, BP, interrupts
   WriteCP(CommandProcessor::CLEAR_REGISTER, 7);  // clear overflow, underflow, metrics
 
-  const FifoFrameInfo& frame = m_File->GetFrame(m_CurrentFrame);
+  const std::shared_ptr<const FifoFrameInfo> frame_ptr = m_File->GetFrame(m_CurrentFrame);
+  const FifoFrameInfo& frame = *frame_ptr;
 
   // Set fifo bounds
   WriteCP(CommandProcessor::FIFO_BASE_LO, frame.fifoStart);
@@ -92,6 +92,9 @@ public:
   // If enabled then all memory updates happen at once before the first frame
   // Default is disabled
   void SetEarlyMemoryUpdates(bool enabled) { m_EarlyMemoryUpdates = enabled; }
+  // Plays the frame range the given number of times as fast as possible, then stops emulation
+  // and writes the timings of each frame to the report. Zero loops disables benchmarking.
+  void SetBenchmark(u32 loops, std::string report_path);
   // Callbacks
   void SetFileLoadedCallback(CallbackFunc callback);
   void SetFrameWrittenCallback(CallbackFunc callback) { m_FrameWrittenCb = std::move(callback); }
@@ -149,6 +152,11 @@ private:
 
   bool m_EarlyMemoryUpdates = false;
 
+  std::string m_Filename;
+  u32 m_BenchmarkLoops = 0;
+  u32 m_BenchmarkLoopsDone = 0;
+  std::string m_BenchmarkReportPath;
+
   u64 m_CyclesPerFrame = 0;
   u32 m_ElapsedCycles = 0;
   u32 m_FrameFifoSize = 0;
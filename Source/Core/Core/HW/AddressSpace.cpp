@@ -5,6 +5,7 @@
 #include "Core/HW/AddressSpace.h"
 
 #include <algorithm>
+#include <cstring>
 
 #include "Common/BitUtils.h"
 #include "Core/ConfigManager.h"
@@ -91,31 +92,37 @@ struct EffectiveAddressSpaceAccessors : Accessors
   void WriteU64(u32 address, u64 value) override { PowerPC::HostWrite_U64(value, address); }
   float ReadF32(u32 address) const override { return PowerPC::HostRead_F32(address); };
 
+  // Returns the host pointer backing the given page, if it maps to MEM1 or MEM2.
+  static const u8* GetPagePointer(u32 page_base)
+  {
+    if (!PowerPC::HostIsRAMAddress(page_base))
+    {
+      return nullptr;
+    }
+    auto page_physical_address = PowerPC::GetTranslatedAddress(page_base);
+    if (!page_physical_address.has_value())
+    {
+      return nullptr;
+    }
+
+    // For now, limit to only mem1 and mem2 regions
+    // GetPointer can get confused by the locked dcache region that dolphin pins at 0xe0000000
+    u32 memory_area = (*page_physical_address) >> 24;
+    if ((memory_area != 0x00) && (memory_area != 0x01))
+    {
+      return nullptr;
+    }
+
+    return Memory::GetPointer(*page_physical_address);
+  }
+
   bool Matches(u32 haystack_start, const u8* needle_start, std::size_t needle_size) const
   {
     u32 page_base = haystack_start & 0xfffff000;
     u32 offset = haystack_start & 0x0000fff;
     do
     {
-      if (!PowerPC::HostIsRAMAddress(page_base))
-      {
-        return false;
-      }
-      auto page_physical_address = PowerPC::GetTranslatedAddress(page_base);
-      if (!page_physical_address.has_value())
-      {
-        return false;
-      }
-
-      // For now, limit to only mem1 and mem2 regions
-      // GetPointer can get confused by the locked dcache region that dolphin pins at 0xe0000000
-      u32 memory_area = (*page_physical_address) >> 24;
-      if ((memory_area != 0x00) && (memory_area != 0x01))
-      {
-        return false;
-      }
-
-      u8* page_ptr = Memory::GetPointer(*page_physical_address);
+      const u8* page_ptr = GetPagePointer(page_base);
       if (page_ptr == nullptr)
       {
         return false;
@@ -137,34 +144,92 @@ struct EffectiveAddressSpaceAccessors : Accessors
   std::optional<u32> Search(u32 haystack_start, const u8* needle_start, std::size_t needle_size,
                             bool forward) const override
   {
-    u32 haystack_address = haystack_start;
-    // For forward=true, search incrementally (step +1) until it wraps back to 0x00000000
-    // For forward=false, search decrementally (step -1) until it wraps back to 0xfffff000
+    if (needle_size == 0)
+    {
+      return std::nullopt;
+    }
+
+    // Pages are translated once and searched directly in host memory. Only matches that cross
+    // into the next page have to be checked through Matches.
+    // For forward=true, search incrementally until it wraps back to 0x00000000
+    // For forward=false, search decrementally until it wraps back to 0xfffff000
     // Any page that doesn't translate is completely skipped.
-    const u32 haystack_page_limit = forward ? 0x00000000 : 0xfffff000;
-    const u32 haystack_offset_limit = forward ? 0x000 : 0xfff;
-    const u32 haystack_page_change = forward ? 0x1000 : -0x1000;
-    const u32 haystack_offset_change = forward ? 1 : -1;
+    constexpr s64 page_size = 0x1000;
+    const s64 first_crossing = std::max<s64>(page_size - static_cast<s64>(needle_size) + 1, 0);
+    u32 page_base = haystack_start & 0xfffff000;
+    s64 offset = haystack_start & 0xfff;
     do
     {
-      if (PowerPC::HostIsRAMAddress(haystack_address))
+      const u8* page_ptr = GetPagePointer(page_base);
+      if (page_ptr != nullptr && forward)
       {
-        do
+        if (offset < first_crossing)
+        {
+          const u8* result = FindForward(page_ptr + offset, page_ptr + page_size, needle_start,
+                                         needle_size);
+          if (result != nullptr)
+            return page_base + static_cast<u32>(result - page_ptr);
+        }
+        for (s64 i = std::max(offset, first_crossing); i < page_size; ++i)
         {
-          if (Matches(haystack_address, needle_start, needle_size))
-          {
-            return std::optional<u32>(haystack_address);
-          }
-          haystack_address += haystack_offset_change;
-        } while ((haystack_address & 0xfff) != haystack_offset_limit);
+          if (Matches(page_base + static_cast<u32>(i), needle_start, needle_size))
+            return page_base + static_cast<u32>(i);
+        }
       }
-      else
+      else if (page_ptr != nullptr)
       {
-        haystack_address = (haystack_address + haystack_page_change) & 0xfffff000;
+        for (s64 i = offset; i >= first_crossing; --i)
+        {
+          if (Matches(page_base + static_cast<u32>(i), needle_start, needle_size))
+            return page_base + static_cast<u32>(i);
+        }
+        if (first_crossing > 0)
+        {
+          const s64 last = std::min(offset, first_crossing - 1);
+          const u8* result = FindBackward(page_ptr, page_ptr + last, needle_start, needle_size);
+          if (result != nullptr)
+            return page_base + static_cast<u32>(result - page_ptr);
+        }
       }
-    } while ((haystack_address & 0xfffff000) != haystack_page_limit);
+
+      page_base += forward ? 0x1000 : -0x1000;
+      offset = forward ? 0 : page_size - 1;
+    } while (page_base != (forward ? 0x00000000 : 0xfffff000));
     return std::nullopt;
   }
+
+private:
+  // Finds the first occurrence of the needle that lies entirely within [begin, end).
+  static const u8* FindForward(const u8* begin, const u8* end, const u8* needle_start,
+                               std::size_t needle_size)
+  {
+    if (static_cast<std::size_t>(end - begin) < needle_size)
+      return nullptr;
+
+    // memchr is vectorized by the C libraries we use, so let it skip ahead to candidates.
+    const u8* const last = end - needle_size;
+    for (const u8* it = begin; it <= last; ++it)
+    {
+      it = static_cast<const u8*>(std::memchr(it, needle_start[0], last - it + 1));
+      if (it == nullptr)
+        return nullptr;
+      if (std::memcmp(it, needle_start, needle_size) == 0)
+        return it;
+    }
+    return nullptr;
+  }
+
+  // Finds the last occurrence of the needle that starts within [begin, last].
+  static const u8* FindBackward(const u8* begin, const u8* last, const u8* needle_start,
+                                std::size_t needle_size)
+  {
+    for (const u8* it = last; it >= begin; --it)
+    {
+      if (*it == needle_start[0] && std::memcmp(it, needle_start, needle_size) == 0)
+        return it;
+    }
+    return nullptr;
+  }
 };
 
 struct AuxiliaryAddressSpaceAccessors : Accessors
@@ -180,11 +245,7 @@ struct AuxiliaryAddressSpaceAccessors : Accessors
     return base[address];
   }
 
-  void WriteU8(u32 address, u8 value) override
-  {
-    u8* base = DSP::GetARAMPtr();
-    base[address] = value;
-  }
+  void WriteU8(u32 address, u8 value) override { DSP::WriteARAM(value, address); }
 
   iterator begin() const override { return DSP::GetARAMPtr(); }
 
@@ -15,6 +15,7 @@
 #include "Core/Host.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/FrameTimeBreakdown.h"
 
 namespace CPU
 {
@@ -117,7 +118,11 @@ void Run()
       }
 
       // Enter a fast runloop
-      PowerPC::RunLoop();
+      {
+        const FrameTimeBreakdown::ScopedCategory breakdown_category(
+            FrameTimeBreakdown::Category::CPUEmulation);
+        PowerPC::RunLoop();
+      }
 
       state_lock.lock();
       s_state_cpu_thread_active = false;
@@ -24,7 +24,10 @@
 
 #include "Core/HW/DSP.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <vector>
 
 #include "AudioCommon/AudioCommon.h"
 #include "Common/ChunkFile.h"
@@ -38,6 +41,7 @@
 #include "Core/HW/Memmap.h"
 #include "Core/HW/ProcessorInterface.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "VideoCommon/FrameTimeBreakdown.h"
 
 namespace DSP
 {
@@ -142,13 +146,31 @@ static std::unique_ptr<DSPEmulator> s_dsp_emulator;
 
 static bool s_dsp_is_lle = false;
 
+// ARAM on the GameCube isn't part of Memory's arena, so for delta savestates, the pages written
+// since the previous state are remembered here, on every write to ARAM.
+constexpr u32 ARAM_STATE_PAGE_SIZE = 0x1000;
+static std::vector<bool> s_aram_dirty_pages;
+static bool s_delta_state_enabled = false;
+static std::vector<u32> s_aram_state_pages;
+
 // time given to LLE DSP on every read of the high bits in a mailbox
 static const int DSP_MAIL_SLICE = 72;
 
 void DoState(PointerWrap& p)
 {
   if (!s_ARAM.wii_mode)
-    p.DoArray(s_ARAM.ptr, s_ARAM.size);
+  {
+    if (s_delta_state_enabled)
+    {
+      p.DoArrayPages(s_ARAM.ptr, s_ARAM.size, ARAM_STATE_PAGE_SIZE, s_aram_state_pages);
+    }
+    else
+    {
+      p.DoBulkArray(s_ARAM.ptr, s_ARAM.size);
+      if (p.GetMode() == PointerWrap::MODE_READ)
+        std::fill(s_aram_dirty_pages.begin(), s_aram_dirty_pages.end(), true);
+    }
+  }
   p.DoPOD(s_dspState);
   p.DoPOD(s_audioDMA);
   p.DoPOD(s_arDMA);
@@ -160,6 +182,43 @@ void DoState(PointerWrap& p)
   s_dsp_emulator->DoState(p);
 }
 
+void ResetStateDirtyPages()
+{
+  std::fill(s_aram_dirty_pages.begin(), s_aram_dirty_pages.end(), false);
+}
+
+void SetDeltaStateEnabled(bool enabled, u32 refresh_period, u32 refresh_slice)
+{
+  s_delta_state_enabled = enabled;
+  s_aram_state_pages.clear();
+  if (!enabled)
+    return;
+
+  for (u32 page = 0; page < s_aram_dirty_pages.size(); ++page)
+  {
+    if (s_aram_dirty_pages[page] || (refresh_period != 0 && page % refresh_period == refresh_slice))
+      s_aram_state_pages.push_back(page);
+  }
+}
+
+// Must be called with an address that has already been masked
+static void MarkARAMDirty(u32 address, u32 size = 1)
+{
+  if (s_aram_dirty_pages.empty() || size == 0)
+    return;
+
+  const u32 last_page = (address + size - 1) / ARAM_STATE_PAGE_SIZE;
+  for (u32 page = address / ARAM_STATE_PAGE_SIZE; page <= last_page; ++page)
+    s_aram_dirty_pages[page] = true;
+}
+
+// The number of bytes from address (which has already been masked) to the point where ARAM
+// addresses wrap around, but at most count.
+static u32 GetARAMRunLength(u32 address, u32 count)
+{
+  return std::min(count, s_ARAM.mask + 1 - address);
+}
+
 static void UpdateInterrupts();
 static void Do_ARAM_DMA();
 static void GenerateDSPInterrupt(u64 DSPIntType, s64 cyclesLate = 0);
@@ -204,6 +263,7 @@ void Reinit(bool hle)
     s_ARAM.size = ARAM_SIZE;
     s_ARAM.mask = ARAM_MASK;
     s_ARAM.ptr = static_cast<u8*>(Common::AllocateMemoryPages(s_ARAM.size));
+    s_aram_dirty_pages.assign(s_ARAM.size / ARAM_STATE_PAGE_SIZE, true);
   }
 
   s_audioDMA = {};
@@ -223,6 +283,7 @@ void Shutdown()
   {
     Common::FreeMemoryPages(s_ARAM.ptr, s_ARAM.size);
     s_ARAM.ptr = nullptr;
+    s_aram_dirty_pages.clear();
   }
 
   s_dsp_emulator->Shutdown();
@@ -451,6 +512,8 @@ void GenerateDSPInterruptFromDSPEmu(DSPInterruptType type, int cycles_into_futur
 // called whenever SystemTimers thinks the DSP deserves a few more cycles
 void UpdateDSPSlice(int cycles)
 {
+  const FrameTimeBreakdown::ScopedCategory breakdown_category(FrameTimeBreakdown::Category::Audio);
+
   if (s_dsp_is_lle)
   {
     // use up the rest of the slice(if any)
@@ -509,7 +572,8 @@ static void Do_ARAM_DMA()
   int ticksToTransfer = (s_arDMA.Cnt.count / 32) * 246;
   CoreTiming::ScheduleEvent(ticksToTransfer, s_et_CompleteARAM);
 
-  // Real hardware DMAs in 32byte chunks, but we can get by with 8byte chunks
+  // Real hardware DMAs in 32byte chunks, but both sides hold the data in the same byte order, so
+  // everything up to the point where ARAM addresses wrap around can be copied at once.
   if (s_arDMA.Cnt.dir)
   {
     // ARAM -> MRAM
@@ -522,39 +586,26 @@ static void Do_ARAM_DMA()
 
     if (s_arDMA.ARAddr < s_ARAM.size)
     {
+      // Reads are the same for every memory map set up in AR_INFO
       while (s_arDMA.Cnt.count)
       {
-        // These are logically separated in code to show that a memory map has been set up
-        // See below in the write section for more information
-        if ((s_ARAM_Info.Hex & 0xf) == 3)
-        {
-          Memory::Write_U64_Swap(*(u64*)&s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask], s_arDMA.MMAddr);
-        }
-        else if ((s_ARAM_Info.Hex & 0xf) == 4)
-        {
-          Memory::Write_U64_Swap(*(u64*)&s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask], s_arDMA.MMAddr);
-        }
-        else
-        {
-          Memory::Write_U64_Swap(*(u64*)&s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask], s_arDMA.MMAddr);
-        }
+        const u32 aram_address = s_arDMA.ARAddr & s_ARAM.mask;
+        const u32 size = GetARAMRunLength(aram_address, s_arDMA.Cnt.count);
+        Memory::CopyToEmu(s_arDMA.MMAddr, &s_ARAM.ptr[aram_address], size);
 
-        s_arDMA.MMAddr += 8;
-        s_arDMA.ARAddr += 8;
-        s_arDMA.Cnt.count -= 8;
+        s_arDMA.MMAddr += size;
+        s_arDMA.ARAddr += size;
+        s_arDMA.Cnt.count -= size;
       }
     }
     else
     {
       // Assuming no external ARAM installed; returns zeros on out of bounds reads (verified on real
       // HW)
-      while (s_arDMA.Cnt.count)
-      {
-        Memory::Write_U64(0, s_arDMA.MMAddr);
-        s_arDMA.MMAddr += 8;
-        s_arDMA.ARAddr += 8;
-        s_arDMA.Cnt.count -= 8;
-      }
+      Memory::Memset(s_arDMA.MMAddr, 0, s_arDMA.Cnt.count);
+      s_arDMA.MMAddr += s_arDMA.Cnt.count;
+      s_arDMA.ARAddr += s_arDMA.Cnt.count;
+      s_arDMA.Cnt.count = 0;
     }
   }
   else
@@ -569,32 +620,29 @@ static void Do_ARAM_DMA()
 
     if (s_arDMA.ARAddr < s_ARAM.size)
     {
+      // With memory map 4, writes to the first 4MB are mirrored to the 4MB after them
+      const bool mirror_low_4mb = (s_ARAM_Info.Hex & 0xf) == 4;
+
       while (s_arDMA.Cnt.count)
       {
-        if ((s_ARAM_Info.Hex & 0xf) == 3)
-        {
-          *(u64*)&s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask] =
-              Common::swap64(Memory::Read_U64(s_arDMA.MMAddr));
-        }
-        else if ((s_ARAM_Info.Hex & 0xf) == 4)
-        {
-          if (s_arDMA.ARAddr < 0x400000)
-          {
-            *(u64*)&s_ARAM.ptr[(s_arDMA.ARAddr + 0x400000) & s_ARAM.mask] =
-                Common::swap64(Memory::Read_U64(s_arDMA.MMAddr));
-          }
-          *(u64*)&s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask] =
-              Common::swap64(Memory::Read_U64(s_arDMA.MMAddr));
-        }
-        else
+        const u32 aram_address = s_arDMA.ARAddr & s_ARAM.mask;
+        u32 size = GetARAMRunLength(aram_address, s_arDMA.Cnt.count);
+        const bool mirror = mirror_low_4mb && s_arDMA.ARAddr < 0x400000;
+        if (mirror)
+          size = std::min(size, 0x400000 - s_arDMA.ARAddr);
+
+        Memory::CopyFromEmu(&s_ARAM.ptr[aram_address], s_arDMA.MMAddr, size);
+        MarkARAMDirty(aram_address, size);
+        if (mirror)
         {
-          *(u64*)&s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask] =
-              Common::swap64(Memory::Read_U64(s_arDMA.MMAddr));
+          const u32 mirror_address = (s_arDMA.ARAddr + 0x400000) & s_ARAM.mask;
+          std::memcpy(&s_ARAM.ptr[mirror_address], &s_ARAM.ptr[aram_address], size);
+          MarkARAMDirty(mirror_address, size);
         }
 
-        s_arDMA.MMAddr += 8;
-        s_arDMA.ARAddr += 8;
-        s_arDMA.Cnt.count -= 8;
+        s_arDMA.MMAddr += size;
+        s_arDMA.ARAddr += size;
+        s_arDMA.Cnt.count -= size;
       }
     }
     else
@@ -629,6 +677,7 @@ u8 ReadARAM(u32 address)
 void WriteARAM(u8 value, u32 address)
 {
   // TODO: verify this on Wii
+  MarkARAMDirty(address & s_ARAM.mask);
   s_ARAM.ptr[address & s_ARAM.mask] = value;
 }
 
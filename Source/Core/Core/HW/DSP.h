@@ -69,6 +69,10 @@ DSPEmulator* GetDSPEmulator();
 
 void DoState(PointerWrap& p);
 
+// Like Memory::ResetStateDirtyPages and Memory::SetDeltaStateEnabled, for ARAM on the GameCube
+void ResetStateDirtyPages();
+void SetDeltaStateEnabled(bool enabled, u32 refresh_period = 0, u32 refresh_slice = 0);
+
 // TODO: Maybe rethink this? The timing is unpredictable.
 void GenerateDSPInterruptFromDSPEmu(DSPInterruptType type, int cycles_into_future = 0);
 
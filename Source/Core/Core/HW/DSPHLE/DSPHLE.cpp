@@ -41,6 +41,7 @@ void DSPHLE::DSP_StopSoundStream()
 void DSPHLE::Shutdown()
 {
   m_ucode = nullptr;
+  LogUCodeCoverage();
 }
 
 void DSPHLE::DSP_Update(int cycles)
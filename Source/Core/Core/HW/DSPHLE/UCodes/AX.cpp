@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
 #include <iterator>
 
 #include "Common/ChunkFile.h"
@@ -14,10 +15,12 @@
 #include "Common/IOFile.h"
 #include "Common/Logging/Log.h"
 #include "Common/Swap.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/DSPHLE/DSPHLE.h"
 #include "Core/HW/DSPHLE/MailHandler.h"
 #include "Core/HW/DSPHLE/UCodes/AXStructs.h"
+#include "Core/HW/DSPHLE/UCodes/AXThreadPool.h"
 
 #define AX_GC
 #include "Core/HW/DSPHLE/UCodes/AXVoice.h"
@@ -27,6 +30,13 @@ namespace DSP::HLE
 AXUCode::AXUCode(DSPHLE* dsphle, u32 crc) : UCodeInterface(dsphle, crc), m_cmdlist_size(0)
 {
   INFO_LOG_FMT(DSPHLE, "Instantiating AXUCode: crc={:08x}", crc);
+
+  const int voice_threads = Config::Get(Config::MAIN_DSP_HLE_VOICE_THREADS);
+  if (voice_threads > 0)
+  {
+    m_voice_thread_pool =
+        std::make_unique<AXThreadPool>(static_cast<u32>(std::min(voice_threads, 7)));
+  }
 }
 
 AXUCode::~AXUCode()
@@ -409,22 +419,90 @@ void AXUCode::DownloadAndMixWithVolume(u32 addr, u16 vol_main, u16 vol_auxa, u16
   }
 }
 
-void AXUCode::ProcessPBList(u32 pb_addr)
+bool AXUCode::CollectPBList(u32 pb_addr)
 {
-  // Samples per millisecond. In theory DSP sampling rate can be changed from
-  // 32KHz to 48KHz, but AX always process at 32KHz.
-  constexpr u32 spms = 32;
+  constexpr u16 next_pb_offset = offsetof(AXPB, next_pb_hi) / sizeof(u16);
 
   AXPB pb;
-
+  m_pb_addrs.clear();
   while (pb_addr)
   {
-    AXBuffers buffers = {{m_samples_left, m_samples_right, m_samples_surround, m_samples_auxA_left,
-                          m_samples_auxA_right, m_samples_auxA_surround, m_samples_auxB_left,
-                          m_samples_auxB_right, m_samples_auxB_surround}};
+    if (m_pb_addrs.size() == MAX_PARALLEL_VOICES)
+      return false;
 
+    m_pb_addrs.push_back(pb_addr);
     ReadPB(pb_addr, pb, m_crc);
 
+    u32 num_updates = 0;
+    for (u16 ms_updates : pb.updates.num_updates)
+      num_updates += ms_updates;
+
+    const u16* updates = (u16*)HLEMemory_Get_Pointer(HILO_TO_32(pb.updates.data));
+    for (u32 i = 0; i < num_updates; ++i)
+    {
+      const u16 update_off = Common::swap16(updates[2 * i]);
+      if (update_off == next_pb_offset || update_off == next_pb_offset + 1)
+        return false;
+    }
+
+    pb_addr = HILO_TO_32(pb.next_pb);
+  }
+
+  return true;
+}
+
+bool AXUCode::ShouldProcessPBsInParallel() const
+{
+  return m_pb_addrs.size() >= 2 * MIN_VOICES_PER_CHUNK;
+}
+
+void AXUCode::ProcessPBsInParallel(int* const* buffers, const u32* buffer_sizes, size_t num_buffers,
+                                   const std::function<void(u32, int* const*)>& process_pb)
+{
+  const size_t num_pbs = m_pb_addrs.size();
+  const u32 num_chunks = static_cast<u32>(std::min<size_t>(
+      m_voice_thread_pool->GetNumWorkerThreads() + 1, num_pbs / MIN_VOICES_PER_CHUNK));
+  m_chunk_buffers.resize((num_chunks - 1) * num_buffers);
+
+  m_voice_thread_pool->Run(num_chunks, [&](u32 chunk) {
+    std::vector<int*> chunk_buffers(buffers, buffers + num_buffers);
+    if (chunk > 0)
+    {
+      for (size_t i = 0; i < num_buffers; ++i)
+      {
+        chunk_buffers[i] = m_chunk_buffers[(chunk - 1) * num_buffers + i].data();
+        std::fill_n(chunk_buffers[i], buffer_sizes[i], 0);
+      }
+    }
+
+    for (size_t i = num_pbs * chunk / num_chunks; i < num_pbs * (chunk + 1) / num_chunks; ++i)
+      process_pb(m_pb_addrs[i], chunk_buffers.data());
+  });
+
+  for (u32 chunk = 1; chunk < num_chunks; ++chunk)
+  {
+    for (size_t i = 0; i < num_buffers; ++i)
+    {
+      const int* chunk_buffer = m_chunk_buffers[(chunk - 1) * num_buffers + i].data();
+      for (u32 j = 0; j < buffer_sizes[i]; ++j)
+        buffers[i][j] += chunk_buffer[j];
+    }
+  }
+}
+
+void AXUCode::ProcessPBList(u32 pb_addr)
+{
+  // Samples per millisecond. In theory DSP sampling rate can be changed from
+  // 32KHz to 48KHz, but AX always process at 32KHz.
+  constexpr u32 spms = 32;
+
+  const auto process_pb = [this](u32 addr, int* const* buffer_ptrs) {
+    AXBuffers buffers;
+    std::copy_n(buffer_ptrs, std::size(buffers.ptrs), buffers.ptrs);
+
+    AXPB pb;
+    ReadPB(addr, pb, m_crc);
+
     u32 updates_addr = HILO_TO_32(pb.updates.data);
     u16* updates = (u16*)HLEMemory_Get_Pointer(updates_addr);
 
@@ -440,9 +518,24 @@ void AXUCode::ProcessPBList(u32 pb_addr)
         ptr += spms;
     }
 
-    WritePB(pb_addr, pb, m_crc);
-    pb_addr = HILO_TO_32(pb.next_pb);
+    WritePB(addr, pb, m_crc);
+    return HILO_TO_32(pb.next_pb);
+  };
+
+  int* const buffers[] = {m_samples_left,      m_samples_right,      m_samples_surround,
+                          m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
+                          m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround};
+
+  if (m_voice_thread_pool && CollectPBList(pb_addr) && ShouldProcessPBsInParallel())
+  {
+    std::array<u32, std::size(buffers)> buffer_sizes;
+    buffer_sizes.fill(5 * spms);
+    ProcessPBsInParallel(buffers, buffer_sizes.data(), std::size(buffers), process_pb);
+    return;
   }
+
+  while (pb_addr)
+    pb_addr = process_pb(pb_addr, buffers);
 }
 
 void AXUCode::MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr)
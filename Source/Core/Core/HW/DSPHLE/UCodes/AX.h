@@ -12,6 +12,11 @@
 
 #pragma once
 
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+
 #include "Common/BitUtils.h"
 #include "Common/CommonTypes.h"
 #include "Common/Swap.h"
@@ -19,6 +24,7 @@
 
 namespace DSP::HLE
 {
+class AXThreadPool;
 class DSPHLE;
 
 // We can't directly use the mixer_control field from the PB because it does
@@ -137,6 +143,12 @@ protected:
   void DownloadAndMixWithVolume(u32 addr, u16 vol_main, u16 vol_auxa, u16 vol_auxb);
   void ProcessPBList(u32 pb_addr);
   void MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr);
+
+  // Collects the addresses of the PBs in the list into m_pb_addrs. Returns
+  // false if the list has to be processed in order, which is the case when an
+  // update of a PB can change where the list continues.
+  bool CollectPBList(u32 pb_addr);
+
   void UploadLRS(u32 dst_addr);
   void SetMainLR(u32 src_addr);
   void OutputSamples(u32 out_addr, u32 surround_addr);
@@ -148,6 +160,28 @@ protected:
   // Handle save states for main AX.
   void DoAXState(PointerWrap& p);
 
+  // Voice lists are only split across threads once each thread gets at least
+  // this many voices, as waking up the workers isn't worth it for fewer.
+  static constexpr size_t MIN_VOICES_PER_CHUNK = 8;
+
+  // Lists which are longer than this are most likely looping, so they are
+  // left to the serial path.
+  static constexpr size_t MAX_PARALLEL_VOICES = 256;
+
+  // Processes the PBs in m_pb_addrs on the voice thread pool, split into
+  // contiguous chunks. The first chunk mixes into the given buffers, and each
+  // other chunk into buffers of its own which are added to them afterwards.
+  // The sums are exact, so the results are the same as when mixing in order.
+  void ProcessPBsInParallel(int* const* buffers, const u32* buffer_sizes, size_t num_buffers,
+                            const std::function<void(u32, int* const*)>& process_pb);
+
+  // True if there are enough PBs in m_pb_addrs to be worth splitting them.
+  bool ShouldProcessPBsInParallel() const;
+
+  std::unique_ptr<AXThreadPool> m_voice_thread_pool;
+  std::vector<u32> m_pb_addrs;
+  std::vector<std::array<int, 32 * 5>> m_chunk_buffers;
+
 private:
   enum CmdType
   {
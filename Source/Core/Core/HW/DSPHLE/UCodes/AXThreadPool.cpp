@@ -0,0 +1,74 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/HW/DSPHLE/UCodes/AXThreadPool.h"
+
+#include "Common/Thread.h"
+
+namespace DSP::HLE
+{
+AXThreadPool::AXThreadPool(u32 num_worker_threads)
+{
+  for (u32 i = 0; i < num_worker_threads; i++)
+    m_worker_threads.emplace_back(&AXThreadPool::WorkerThreadRun, this);
+}
+
+AXThreadPool::~AXThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> guard(m_task_lock);
+    m_exit = true;
+  }
+  m_task_available.notify_all();
+
+  for (std::thread& thread : m_worker_threads)
+    thread.join();
+}
+
+void AXThreadPool::Run(u32 num_tasks, const std::function<void(u32)>& task)
+{
+  std::unique_lock<std::mutex> lock(m_task_lock);
+  m_task = &task;
+  m_num_tasks = num_tasks;
+  m_next_task = 0;
+  m_pending_tasks = num_tasks;
+  m_task_available.notify_all();
+
+  RunTasks(lock);
+  m_tasks_done.wait(lock, [this]() { return m_pending_tasks == 0; });
+
+  m_task = nullptr;
+  m_num_tasks = 0;
+}
+
+void AXThreadPool::WorkerThreadRun()
+{
+  Common::SetCurrentThreadName("AX Voice WorkerThread");
+
+  std::unique_lock<std::mutex> lock(m_task_lock);
+  while (true)
+  {
+    m_task_available.wait(lock, [this]() { return m_exit || m_next_task < m_num_tasks; });
+    if (m_exit)
+      return;
+
+    RunTasks(lock);
+  }
+}
+
+void AXThreadPool::RunTasks(std::unique_lock<std::mutex>& lock)
+{
+  while (m_next_task < m_num_tasks)
+  {
+    const u32 index = m_next_task++;
+    const std::function<void(u32)>& task = *m_task;
+    lock.unlock();
+    task(index);
+    lock.lock();
+
+    if (--m_pending_tasks == 0)
+      m_tasks_done.notify_one();
+  }
+}
+}  // namespace DSP::HLE
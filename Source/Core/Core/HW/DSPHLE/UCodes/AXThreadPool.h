@@ -0,0 +1,46 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace DSP::HLE
+{
+// A small pool of worker threads which the AX UCodes split their voice lists across. The thread
+// which runs the tasks processes them as well, rather than only waiting for the workers.
+class AXThreadPool
+{
+public:
+  explicit AXThreadPool(u32 num_worker_threads);
+  ~AXThreadPool();
+
+  u32 GetNumWorkerThreads() const { return static_cast<u32>(m_worker_threads.size()); }
+
+  // Calls task(i) for each i in [0, num_tasks), and returns once all of them are done.
+  void Run(u32 num_tasks, const std::function<void(u32)>& task);
+
+private:
+  void WorkerThreadRun();
+
+  // Runs tasks until none are left. Must be called with the lock held.
+  void RunTasks(std::unique_lock<std::mutex>& lock);
+
+  std::vector<std::thread> m_worker_threads;
+  std::mutex m_task_lock;
+  std::condition_variable m_task_available;
+  std::condition_variable m_tasks_done;
+  const std::function<void(u32)>* m_task = nullptr;
+  u32 m_num_tasks = 0;
+  u32 m_next_task = 0;
+  u32 m_pending_tasks = 0;
+  bool m_exit = false;
+};
+}  // namespace DSP::HLE
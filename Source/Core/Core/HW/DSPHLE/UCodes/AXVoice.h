@@ -13,16 +13,20 @@
 #endif
 
 #include <algorithm>
-#include <functional>
 #include <memory>
 
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "Core/DSP/DSPAccelerator.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/DSPHLE/UCodes/AX.h"
 #include "Core/HW/DSPHLE/UCodes/AXStructs.h"
 #include "Core/HW/Memmap.h"
 
+#ifdef _M_ARM_64
+#include <arm_neon.h>
+#endif
+
 namespace DSP::HLE
 {
 #ifdef AX_GC
@@ -139,9 +143,10 @@ void WritePB(u32 addr, const PB_TYPE& pb, u32 crc)
   }
 }
 
-// Simulated accelerator state.
-static PB_TYPE* acc_pb;
-static bool acc_end_reached;
+// Simulated accelerator state. Voices can be processed on several threads at
+// once, so each thread has its own.
+static thread_local PB_TYPE* acc_pb;
+static thread_local bool acc_end_reached;
 
 class HLEAccelerator final : public Accelerator
 {
@@ -188,7 +193,8 @@ protected:
   void WriteMemory(u32 address, u8 value) override { WriteARAM(value, address); }
 };
 
-static std::unique_ptr<Accelerator> s_accelerator = std::make_unique<HLEAccelerator>();
+static thread_local std::unique_ptr<Accelerator> s_accelerator =
+    std::make_unique<HLEAccelerator>();
 
 // Sets up the simulated accelerator.
 void AcceleratorSetup(PB_TYPE* pb)
@@ -236,7 +242,11 @@ u16 AcceleratorGetSample()
 // We start getting samples not from sample 0, but 0.<curr_pos_frac>. This
 // avoids discontinuities in the audio stream, especially with very low ratios
 // which interpolate a lot of values between two "real" samples.
-u32 ResampleAudio(std::function<s16(u32)> input_callback, s16* output, u32 count, s16* last_samples,
+//
+// The input callback is a template parameter rather than a std::function, so
+// that reading each sample can be inlined into the resampling loops.
+template <typename InputCallback>
+u32 ResampleAudio(InputCallback input_callback, s16* output, u32 count, s16* last_samples,
                   u32 curr_pos, u32 ratio, int srctype, const s16* coeffs)
 {
   int read_samples_count = 0;
@@ -372,30 +382,82 @@ void GetInputSamples(PB_TYPE& pb, s16* samples, u16 count, const s16* coeffs)
   pb.adpcm.pred_scale = s_accelerator->GetPredScale();
 }
 
+// Multiply samples by a 1.15 fixed point volume which is incremented by
+// <volume_delta> after each sample. Returns the volume after the last sample.
+//
+// The volume is unsigned, but the product of a sample and a volume always fits
+// in 32 bits, so the vector versions compute it exactly from 16 bit halves.
+u16 ApplyVolume(s16* output, const s16* input, u32 count, u16 volume, u16 volume_delta)
+{
+  u32 i = 0;
+
+#if defined(_M_X86)
+  const __m128i lane_offsets = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m128i volume_step = _mm_set1_epi16(static_cast<s16>(volume_delta * 8));
+  const __m128i min_sample = _mm_set1_epi16(-32767);  // -32768 ?
+  const __m128i deltas = _mm_set1_epi16(static_cast<s16>(volume_delta));
+  __m128i volumes = _mm_add_epi16(_mm_set1_epi16(static_cast<s16>(volume)),
+                                  _mm_mullo_epi16(deltas, lane_offsets));
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+
+    // The signed high half is off by one sample for the volumes of 0x8000 and above.
+    const __m128i lo = _mm_mullo_epi16(samples, volumes);
+    const __m128i hi = _mm_add_epi16(_mm_mulhi_epi16(samples, volumes),
+                                     _mm_and_si128(samples, _mm_srai_epi16(volumes, 15)));
+    const __m128i products_lo = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15);
+    const __m128i products_hi = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i),
+                     _mm_max_epi16(_mm_packs_epi32(products_lo, products_hi), min_sample));
+    volumes = _mm_add_epi16(volumes, volume_step);
+  }
+#elif defined(_M_ARM_64)
+  static constexpr u16 lane_offsets[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+  const uint16x8_t volume_step = vdupq_n_u16(static_cast<u16>(volume_delta * 8));
+  const int16x8_t min_sample = vdupq_n_s16(-32767);  // -32768 ?
+  uint16x8_t volumes = vmlaq_n_u16(vdupq_n_u16(volume), vld1q_u16(lane_offsets), volume_delta);
+  for (; i + 8 <= count; i += 8)
+  {
+    const int16x8_t samples = vld1q_s16(input + i);
+    const int32x4_t products_lo =
+        vmulq_s32(vmovl_s16(vget_low_s16(samples)),
+                  vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(volumes))));
+    const int32x4_t products_hi =
+        vmulq_s32(vmovl_s16(vget_high_s16(samples)),
+                  vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(volumes))));
+    const int16x8_t result = vcombine_s16(vqmovn_s32(vshrq_n_s32(products_lo, 15)),
+                                          vqmovn_s32(vshrq_n_s32(products_hi, 15)));
+    vst1q_s16(output + i, vmaxq_s16(result, min_sample));
+    volumes = vaddq_u16(volumes, volume_step);
+  }
+#endif
+
+  volume += static_cast<u16>(i * volume_delta);
+  for (; i < count; ++i)
+  {
+    output[i] = std::clamp((s32(input[i]) * volume) >> 15, -32767, 32767);  // -32768 ?
+    volume += volume_delta;
+  }
+
+  return volume;
+}
+
 // Add samples to an output buffer, with optional volume ramping.
 void MixAdd(int* out, const s16* input, u32 count, u16* pvol, s16* dpop, bool ramp)
 {
-  u16& volume = pvol[0];
-  u16 volume_delta = pvol[1];
+  if (count == 0)
+    return;
 
-  // If volume ramping is disabled, set volume_delta to 0. That way, the
-  // mixing loop can avoid testing if volume ramping is enabled at each step,
-  // and just add volume_delta.
-  if (!ramp)
-    volume_delta = 0;
+  // If volume ramping is disabled, the volume delta is 0, so that the volume
+  // doesn't change between samples.
+  s16 samples[MAX_SAMPLES_PER_FRAME];
+  pvol[0] = ApplyVolume(samples, input, count, pvol[0], ramp ? pvol[1] : 0);
 
   for (u32 i = 0; i < count; ++i)
-  {
-    s64 sample = input[i];
-    sample *= volume;
-    sample >>= 15;
-    sample = std::clamp((s32)sample, -32767, 32767);  // -32768 ?
+    out[i] += samples[i];
 
-    out[i] += (s16)sample;
-    volume += volume_delta;
-
-    *dpop = (s16)sample;
-  }
+  *dpop = samples[count - 1];
 }
 
 // Execute a low pass filter on the samples using one history value. Returns
@@ -421,12 +483,8 @@ void ProcessVoice(PB_TYPE& pb, const AXBuffers& buffers, u16 count, AXMixControl
   GetInputSamples(pb, samples, count, coeffs);
 
   // Apply a global volume ramp using the volume envelope parameters.
-  for (u32 i = 0; i < count; ++i)
-  {
-    samples[i] = std::clamp(((s32)samples[i] * pb.vol_env.cur_volume) >> 15, -32767,
-                            32767);  // -32768 ?
-    pb.vol_env.cur_volume += pb.vol_env.cur_volume_delta;
-  }
+  pb.vol_env.cur_volume = ApplyVolume(samples, samples, count, pb.vol_env.cur_volume,
+                                      static_cast<u16>(pb.vol_env.cur_volume_delta));
 
   // Optionally, execute a low pass filter
   // TODO: LPF code is currently broken, causing Super Monkey Ball sound
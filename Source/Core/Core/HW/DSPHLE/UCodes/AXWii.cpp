@@ -442,19 +442,12 @@ void AXWiiUCode::ProcessPBList(u32 pb_addr)
   // 32KHz to 48KHz, but AX always process at 32KHz.
   constexpr u32 spms = 32;
 
-  AXPBWii pb;
+  const auto process_pb = [this](u32 addr, int* const* buffer_ptrs) {
+    AXBuffers buffers;
+    std::copy_n(buffer_ptrs, std::size(buffers.ptrs), buffers.ptrs);
 
-  while (pb_addr)
-  {
-    AXBuffers buffers = {{m_samples_left,      m_samples_right,      m_samples_surround,
-                          m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
-                          m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround,
-                          m_samples_auxC_left, m_samples_auxC_right, m_samples_auxC_surround,
-                          m_samples_wm0,       m_samples_aux0,       m_samples_wm1,
-                          m_samples_aux1,      m_samples_wm2,        m_samples_aux2,
-                          m_samples_wm3,       m_samples_aux3}};
-
-    ReadPB(pb_addr, pb, m_crc);
+    AXPBWii pb;
+    ReadPB(addr, pb, m_crc);
 
     u16 num_updates[3];
     u16 updates[1024];
@@ -479,9 +472,45 @@ void AXWiiUCode::ProcessPBList(u32 pb_addr)
                    m_coeffs_available ? m_coeffs : nullptr);
     }
 
-    WritePB(pb_addr, pb, m_crc);
-    pb_addr = HILO_TO_32(pb.next_pb);
+    WritePB(addr, pb, m_crc);
+    return HILO_TO_32(pb.next_pb);
+  };
+
+  int* const buffers[] = {m_samples_left,      m_samples_right,      m_samples_surround,
+                          m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
+                          m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround,
+                          m_samples_auxC_left, m_samples_auxC_right, m_samples_auxC_surround,
+                          m_samples_wm0,       m_samples_aux0,       m_samples_wm1,
+                          m_samples_aux1,      m_samples_wm2,        m_samples_aux2,
+                          m_samples_wm3,       m_samples_aux3};
+
+  // Old AXWii versions apply updates and forward the buffers ms per ms, which
+  // steps the Wiimote buffers past their ends. That is only well defined for
+  // the member buffers, so those versions always process voices in order.
+  // Newer versions don't apply updates, so their PB lists never change.
+  if (m_voice_thread_pool && !m_old_axwii)
+  {
+    m_pb_addrs.clear();
+    AXPBWii pb;
+    for (u32 addr = pb_addr; addr && m_pb_addrs.size() < MAX_PARALLEL_VOICES;
+         addr = HILO_TO_32(pb.next_pb))
+    {
+      m_pb_addrs.push_back(addr);
+      ReadPB(addr, pb, m_crc);
+    }
+
+    if (m_pb_addrs.size() < MAX_PARALLEL_VOICES && ShouldProcessPBsInParallel())
+    {
+      std::array<u32, std::size(buffers)> buffer_sizes;
+      std::fill_n(buffer_sizes.begin(), 12, static_cast<u32>(std::size(m_samples_left)));
+      std::fill_n(buffer_sizes.begin() + 12, 8, static_cast<u32>(std::size(m_samples_wm0)));
+      ProcessPBsInParallel(buffers, buffer_sizes.data(), std::size(buffers), process_pb);
+      return;
+    }
   }
+
+  while (pb_addr)
+    pb_addr = process_pb(pb_addr, buffers);
 }
 
 void AXWiiUCode::MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr, u16 volume)
@@ -5,6 +5,7 @@
 #include "Core/HW/DSPHLE/UCodes/UCodes.h"
 
 #include <cstring>
+#include <map>
 #include <memory>
 #include <string>
 
@@ -220,8 +221,29 @@ void UCodeInterface::DoStateShared(PointerWrap& p)
   p.Do(m_needs_resume_mail);
 }
 
+struct UCodeUsage
+{
+  u32 times_loaded = 0;
+  bool fell_back = false;
+};
+
+static std::map<u32, UCodeUsage> s_ucode_usage;
+
+void LogUCodeCoverage()
+{
+  for (const auto& [crc, usage] : s_ucode_usage)
+  {
+    NOTICE_LOG_FMT(DSPHLE, "ucode {:08x}: loaded {} time(s), {}", crc, usage.times_loaded,
+                   usage.fell_back ? "unknown, fell back to a generic AX ucode" : "HLE");
+  }
+  s_ucode_usage.clear();
+}
+
 std::unique_ptr<UCodeInterface> UCodeFactory(u32 crc, DSPHLE* dsphle, bool wii)
 {
+  if (crc != UCODE_NULL)
+    s_ucode_usage[crc].times_loaded++;
+
   switch (crc)
   {
   case UCODE_ROM:
@@ -281,6 +303,7 @@ std::unique_ptr<UCodeInterface> UCodeFactory(u32 crc, DSPHLE* dsphle, bool wii)
     return std::make_unique<AXWiiUCode>(dsphle, crc);
 
   default:
+    s_ucode_usage[crc].fell_back = true;
     if (wii)
     {
       PanicAlertFmtT(
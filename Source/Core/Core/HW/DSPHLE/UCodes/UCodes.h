@@ -104,4 +104,8 @@ private:
 };
 
 std::unique_ptr<UCodeInterface> UCodeFactory(u32 crc, DSPHLE* dsphle, bool wii);
+
+// Logs every ucode the factory was asked for since the last call, including the ones which had
+// no HLE implementation and were replaced by a generic AX ucode, and then resets the record.
+void LogUCodeCoverage();
 }  // namespace DSP::HLE
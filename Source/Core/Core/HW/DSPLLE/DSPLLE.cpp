@@ -58,6 +58,7 @@ void DSPLLE::DoState(PointerWrap& p)
 void DSPLLE::DSPThread(DSPLLE* dsp_lle)
 {
   Common::SetCurrentThreadName("DSP thread");
+  Common::PlaceCurrentEmulationThread(Common::EmulationThread::DSP);
 
   while (dsp_lle->m_is_running.IsSet())
   {
@@ -121,7 +122,7 @@ static bool FillDSPInitOptions(DSPInitOptions* opts)
     return false;
 
   opts->core_type = DSPInitOptions::CoreType::Interpreter;
-#ifdef _M_X86
+#if defined(_M_X86) || defined(_M_ARM_64)
   if (SConfig::GetInstance().m_DSPEnableJIT)
     opts->core_type = DSPInitOptions::CoreType::JIT64;
 #endif
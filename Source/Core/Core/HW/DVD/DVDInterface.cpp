@@ -476,9 +476,15 @@ static void EjectDiscCallback(u64 userdata, s64 cyclesLate)
   SetDisc(nullptr, {});
 }
 
+std::unique_ptr<DiscIO::VolumeDisc> CreateDisc(const std::string& path)
+{
+  const u64 cache_size = static_cast<u64>(std::max(Config::Get(Config::MAIN_DISC_CACHE_SIZE), 0));
+  return DiscIO::CreateDisc(path, cache_size * 1024 * 1024);
+}
+
 static void InsertDiscCallback(u64 userdata, s64 cyclesLate)
 {
-  std::unique_ptr<DiscIO::VolumeDisc> new_disc = DiscIO::CreateDisc(s_disc_path_to_insert);
+  std::unique_ptr<DiscIO::VolumeDisc> new_disc = CreateDisc(s_disc_path_to_insert);
 
   if (new_disc)
     SetDisc(std::move(new_disc), {});
@@ -116,6 +116,8 @@ void DoState(PointerWrap& p);
 
 void RegisterMMIO(MMIO::Mapping* mmio, u32 base);
 
+// Opens a disc image for use as the emulated disc.
+std::unique_ptr<DiscIO::VolumeDisc> CreateDisc(const std::string& path);
 void SetDisc(std::unique_ptr<DiscIO::VolumeDisc> disc,
              std::optional<std::vector<std::string>> auto_disc_change_paths);
 bool IsDiscInside();
@@ -4,6 +4,7 @@
 
 #include "Core/HW/DVD/DVDThread.h"
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -18,9 +19,10 @@
 #include "Common/Flag.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
-#include "Common/SPSCQueue.h"
+#include "Common/SPSCRingQueue.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
+#include "Common/Tracing.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
@@ -82,12 +84,33 @@ static Common::Event s_request_queue_expanded;    // Is set by CPU thread
 static Common::Event s_result_queue_expanded;     // Is set by DVD thread
 static Common::Flag s_dvd_thread_exiting(false);  // Is set by CPU thread
 
-static Common::SPSCQueue<ReadRequest, false> s_request_queue;
-static Common::SPSCQueue<ReadResult, false> s_result_queue;
+static Common::SPSCRingQueue<ReadRequest, false> s_request_queue;
+static Common::SPSCRingQueue<ReadResult, false> s_result_queue;
 static std::map<u64, ReadResult> s_result_map;
 
+// Result buffers which the CPU thread is done with, for the DVD thread to reuse. This avoids an
+// allocation for every read, which adds up because DVDInterface splits reads into small chunks.
+constexpr size_t MAX_POOLED_BUFFERS = 32;
+constexpr size_t MAX_POOLED_BUFFER_SIZE = 0x100000;
+static Common::SPSCRingQueue<std::vector<u8>> s_buffer_pool(MAX_POOLED_BUFFERS);
+
+// DVDInterface schedules a read as a series of adjacent chunks with increasing deadlines. When
+// several of them are waiting, the DVD thread reads them from the disc at once, up to this size.
+// The results are still handed out one chunk at a time by FinishRead. Only accessed by the DVD
+// thread.
+constexpr u64 MAX_COALESCED_READ_SIZE = 0x100000;
+static std::vector<u8> s_coalesced_buffer;
+
 static std::unique_ptr<DiscIO::Volume> s_disc;
 
+// Audio streaming reads only cover a few milliseconds of audio each and are started shortly
+// before they're needed, so if reading from the disc image is slow, every one of them can stall
+// the CPU thread. The DVD thread instead reads streamed audio into a window of this size, which
+// it moves forward in halves as the stream is consumed. Only accessed by the DVD thread.
+constexpr u32 DTK_READ_AHEAD_SIZE = 0x10000;
+static std::vector<u8> s_dtk_read_ahead;
+static u64 s_dtk_read_ahead_offset = 0;
+
 void Start()
 {
   s_finish_read = CoreTiming::RegisterEvent("FinishReadDVDThread", FinishRead);
@@ -96,6 +119,7 @@ void Start()
   s_result_queue_expanded.Reset();
   s_request_queue.Clear();
   s_result_queue.Clear();
+  s_buffer_pool.Clear();
 
   // This is reset on every launch for determinism, but it doesn't matter
   // much, because this will never get exposed to the emulated game.
@@ -115,6 +139,9 @@ void Stop()
 {
   StopDVDThread();
   s_disc.reset();
+  s_dtk_read_ahead.clear();
+  s_coalesced_buffer = {};
+  s_buffer_pool.Clear();
 }
 
 static void StopDVDThread()
@@ -138,7 +165,7 @@ void DoState(PointerWrap& p)
   WaitUntilIdle();
 
   // Move all results from s_result_queue to s_result_map because
-  // PointerWrap::Do supports std::map but not Common::SPSCQueue.
+  // PointerWrap::Do supports std::map but not Common::SPSCRingQueue.
   // This won't affect the behavior of FinishRead.
   ReadResult result;
   while (s_result_queue.Pop(result))
@@ -178,6 +205,7 @@ void SetDisc(std::unique_ptr<DiscIO::Volume> disc)
 {
   WaitUntilIdle();
   s_disc = std::move(disc);
+  s_dtk_read_ahead.clear();
 }
 
 bool HasDisc()
@@ -360,6 +388,141 @@ static void FinishRead(u64 id, s64 cycles_late)
 
   // Notify the emulated software that the command has been executed
   DVDInterface::FinishExecutingCommand(request.reply_type, interrupt, cycles_late, buffer);
+
+  if (s_buffer_pool.Size() < MAX_POOLED_BUFFERS &&
+      result.second.capacity() <= MAX_POOLED_BUFFER_SIZE)
+  {
+    s_buffer_pool.Push(std::move(result.second));
+  }
+}
+
+static bool ReadDTK(u64 dvd_offset, u32 length, u8* buffer)
+{
+  const auto contains = [length](u64 offset) {
+    return offset >= s_dtk_read_ahead_offset &&
+           offset + length <= s_dtk_read_ahead_offset + s_dtk_read_ahead.size();
+  };
+
+  if (!contains(dvd_offset))
+  {
+    s_dtk_read_ahead.resize(DTK_READ_AHEAD_SIZE);
+    s_dtk_read_ahead_offset = dvd_offset;
+    if (length > DTK_READ_AHEAD_SIZE ||
+        !s_disc->Read(dvd_offset, DTK_READ_AHEAD_SIZE, s_dtk_read_ahead.data(),
+                      DiscIO::PARTITION_NONE))
+    {
+      // Most likely the window would extend past the end of the disc.
+      s_dtk_read_ahead.clear();
+      return s_disc->Read(dvd_offset, length, buffer, DiscIO::PARTITION_NONE);
+    }
+  }
+
+  std::copy_n(s_dtk_read_ahead.begin() + (dvd_offset - s_dtk_read_ahead_offset), length, buffer);
+  return true;
+}
+
+// Moves the read-ahead window forward once the stream has consumed its first half. This is done
+// after the result of the current streaming read has been handed over, so that the CPU thread
+// doesn't have to wait for it.
+static void AdvanceDTKReadAhead(u64 consumed_end)
+{
+  constexpr u32 step = DTK_READ_AHEAD_SIZE / 2;
+  const u64 window_end = s_dtk_read_ahead_offset + s_dtk_read_ahead.size();
+  if (s_dtk_read_ahead.size() != DTK_READ_AHEAD_SIZE || consumed_end < window_end - step)
+    return;
+
+  std::copy(s_dtk_read_ahead.begin() + step, s_dtk_read_ahead.end(), s_dtk_read_ahead.begin());
+  if (!s_disc->Read(window_end, step, s_dtk_read_ahead.data() + step, DiscIO::PARTITION_NONE))
+  {
+    // Keep what has already been read; anything past it will be read directly.
+    s_dtk_read_ahead.resize(step);
+  }
+  s_dtk_read_ahead_offset += step;
+}
+
+static std::vector<u8> GetBuffer(u32 length)
+{
+  std::vector<u8> buffer;
+  s_buffer_pool.Pop(buffer);
+  buffer.resize(length);
+  return buffer;
+}
+
+static bool CanCoalesce(const ReadRequest& first, u64 end, const ReadRequest& next)
+{
+  return next.partition == first.partition && next.dvd_offset == end &&
+         next.reply_type != DVDInterface::ReplyType::DTK &&
+         end + next.length - first.dvd_offset <= MAX_COALESCED_READ_SIZE;
+}
+
+static void PushResult(ReadRequest request, std::vector<u8> buffer)
+{
+  request.realtime_done_us = Common::Timer::GetTimeUs();
+  s_result_queue.Push(ReadResult(std::move(request), std::move(buffer)));
+  s_result_queue_expanded.Set();
+}
+
+// Handles requests[begin] and the requests after it that can be coalesced with it.
+// Returns the index of the first request that wasn't handled.
+static size_t ProcessRequests(std::vector<ReadRequest>& requests, size_t begin)
+{
+  TRACE_SCOPE("DVDThread::ProcessRequests");
+
+  ReadRequest& first = requests[begin];
+  FileMonitor::Log(*s_disc, first.partition, first.dvd_offset);
+
+  if (first.reply_type == DVDInterface::ReplyType::DTK &&
+      first.partition == DiscIO::PARTITION_NONE)
+  {
+    const u64 request_end = first.dvd_offset + first.length;
+    std::vector<u8> buffer = GetBuffer(first.length);
+    if (!ReadDTK(first.dvd_offset, first.length, buffer.data()))
+      buffer.resize(0);
+    PushResult(std::move(first), std::move(buffer));
+    AdvanceDTKReadAhead(request_end);
+    return begin + 1;
+  }
+
+  size_t end = begin + 1;
+  u64 end_offset = first.dvd_offset + first.length;
+  while (end < requests.size() && CanCoalesce(first, end_offset, requests[end]))
+    end_offset += requests[end++].length;
+
+  if (end - begin == 1)
+  {
+    std::vector<u8> buffer = GetBuffer(first.length);
+    if (!s_disc->Read(first.dvd_offset, first.length, buffer.data(), first.partition))
+      buffer.resize(0);
+    PushResult(std::move(first), std::move(buffer));
+    return end;
+  }
+
+  // If the combined read fails, the requests are read one by one below, so that only the ones
+  // which actually can't be read report an error.
+  s_coalesced_buffer.resize(end_offset - first.dvd_offset);
+  const bool coalesced_success = s_disc->Read(first.dvd_offset, s_coalesced_buffer.size(),
+                                              s_coalesced_buffer.data(), first.partition);
+
+  for (size_t i = begin; i < end; ++i)
+  {
+    ReadRequest& request = requests[i];
+    if (i != begin)
+      FileMonitor::Log(*s_disc, request.partition, request.dvd_offset);
+
+    std::vector<u8> buffer = GetBuffer(request.length);
+    if (coalesced_success)
+    {
+      std::copy_n(s_coalesced_buffer.begin() + (request.dvd_offset - first.dvd_offset),
+                  request.length, buffer.begin());
+    }
+    else if (!s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
+    {
+      buffer.resize(0);
+    }
+    PushResult(std::move(request), std::move(buffer));
+  }
+
+  return end;
 }
 
 static void DVDThread()
@@ -373,19 +536,19 @@ static void DVDThread()
     if (s_dvd_thread_exiting.IsSet())
       return;
 
+    // Everything that is taken out of the queue has to be finished before exiting, since
+    // WaitUntilIdle relies on that.
+    std::vector<ReadRequest> requests;
     ReadRequest request;
     while (s_request_queue.Pop(request))
     {
-      FileMonitor::Log(*s_disc, request.partition, request.dvd_offset);
-
-      std::vector<u8> buffer(request.length);
-      if (!s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
-        buffer.resize(0);
-
-      request.realtime_done_us = Common::Timer::GetTimeUs();
+      requests.push_back(std::move(request));
+      if (!s_request_queue.Empty())
+        continue;
 
-      s_result_queue.Push(ReadResult(std::move(request), std::move(buffer)));
-      s_result_queue_expanded.Set();
+      for (size_t i = 0; i < requests.size();)
+        i = ProcessRequests(requests, i);
+      requests.clear();
 
       if (s_dvd_thread_exiting.IsSet())
         return;
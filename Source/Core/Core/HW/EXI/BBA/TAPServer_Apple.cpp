@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <vector>
+
 #include <fcntl.h>
 #include <sys/socket.h>
 #include <sys/un.h>
@@ -102,17 +104,17 @@ void CEXIETHERNET::TAPServerNetworkInterface::ReadThreadHandler()
     }
     else
     {
-      int read_bytes = read(fd, m_eth_ref->mRecvBuffer.get(), size);
+      std::vector<u8> buffer(size);
+      int read_bytes = read(fd, buffer.data(), size);
       if (read_bytes < 0)
       {
         ERROR_LOG(SP1, "Failed to read packet data from BBA, err=%d", errno);
       }
       else if (readEnabled.IsSet())
       {
-        std::string data_string = ArrayToString(m_eth_ref->mRecvBuffer.get(), read_bytes, 0x10);
+        std::string data_string = ArrayToString(buffer.data(), read_bytes, 0x10);
         INFO_LOG(SP1, "Read data: %s", data_string.c_str());
-        m_eth_ref->mRecvBufferLength = read_bytes;
-        m_eth_ref->RecvHandlePacket();
+        m_eth_ref->RecvQueuePacket(buffer.data(), read_bytes);
       }
     }
   }
@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <array>
+
 #include <fcntl.h>
 #include <unistd.h>
 
@@ -66,6 +68,7 @@ bool CEXIETHERNET::TAPNetworkInterface::SendFrame(const u8* frame, u32 size)
 
 void CEXIETHERNET::TAPNetworkInterface::ReadThreadHandler(TAPNetworkInterface* self)
 {
+  std::array<u8, BBA_RECV_SIZE> buffer;
   while (!self->readThreadShutdown.IsSet())
   {
     fd_set rfds;
@@ -78,17 +81,15 @@ void CEXIETHERNET::TAPNetworkInterface::ReadThreadHandler(TAPNetworkInterface* s
     if (select(self->fd + 1, &rfds, nullptr, nullptr, &timeout) <= 0)
       continue;
 
-    const int read_bytes = read(self->fd, self->m_eth_ref->mRecvBuffer.get(), BBA_RECV_SIZE);
+    const int read_bytes = read(self->fd, buffer.data(), buffer.size());
     if (read_bytes < 0)
     {
       ERROR_LOG_FMT(SP1, "Failed to read from BBA, err={}", read_bytes);
     }
     else if (self->readEnabled.IsSet())
     {
-      INFO_LOG_FMT(SP1, "Read data: {}",
-                   ArrayToString(self->m_eth_ref->mRecvBuffer.get(), read_bytes, 0x10));
-      self->m_eth_ref->mRecvBufferLength = read_bytes;
-      self->m_eth_ref->RecvHandlePacket();
+      INFO_LOG_FMT(SP1, "Read data: {}", ArrayToString(buffer.data(), read_bytes, 0x10));
+      self->m_eth_ref->RecvQueuePacket(buffer.data(), read_bytes);
     }
   }
 }
@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <array>
 #include <cstring>
 
 #ifndef _WIN32
@@ -128,6 +129,7 @@ bool CEXIETHERNET::TAPNetworkInterface::SendFrame(const u8* frame, u32 size)
 #ifdef __linux__
 void CEXIETHERNET::TAPNetworkInterface::ReadThreadHandler(TAPNetworkInterface* self)
 {
+  std::array<u8, BBA_RECV_SIZE> buffer;
   while (!self->readThreadShutdown.IsSet())
   {
     fd_set rfds;
@@ -140,17 +142,15 @@ void CEXIETHERNET::TAPNetworkInterface::ReadThreadHandler(TAPNetworkInterface* s
     if (select(self->fd + 1, &rfds, nullptr, nullptr, &timeout) <= 0)
       continue;
 
-    int readBytes = read(self->fd, self->m_eth_ref->mRecvBuffer.get(), BBA_RECV_SIZE);
+    int readBytes = read(self->fd, buffer.data(), buffer.size());
     if (readBytes < 0)
     {
       ERROR_LOG_FMT(SP1, "Failed to read from BBA, err={}", readBytes);
     }
     else if (self->readEnabled.IsSet())
     {
-      DEBUG_LOG_FMT(SP1, "Read data: {}",
-                    ArrayToString(self->m_eth_ref->mRecvBuffer.get(), readBytes, 0x10));
-      self->m_eth_ref->mRecvBufferLength = readBytes;
-      self->m_eth_ref->RecvHandlePacket();
+      DEBUG_LOG_FMT(SP1, "Read data: {}", ArrayToString(buffer.data(), readBytes, 0x10));
+      self->m_eth_ref->RecvQueuePacket(buffer.data(), readBytes);
     }
   }
 }
@@ -3,6 +3,9 @@
 // Refer to the license.txt file included.
 
 #include "Core/HW/EXI/BBA/TAP_Win32.h"
+
+#include <array>
+
 #include "Common/Assert.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
@@ -268,12 +271,13 @@ bool CEXIETHERNET::TAPNetworkInterface::IsActivated()
 
 void CEXIETHERNET::TAPNetworkInterface::ReadThreadHandler(TAPNetworkInterface* self)
 {
+  std::array<u8, BBA_RECV_SIZE> buffer;
   while (!self->readThreadShutdown.IsSet())
   {
     DWORD transferred;
 
     // Read from TAP into internal buffer.
-    if (ReadFile(self->mHAdapter, self->m_eth_ref->mRecvBuffer.get(), BBA_RECV_SIZE, &transferred,
+    if (ReadFile(self->mHAdapter, buffer.data(), BBA_RECV_SIZE, &transferred,
                  &self->mReadOverlapped))
     {
       // Returning immediately is not likely to happen, but if so, reset the event state manually.
@@ -303,12 +307,9 @@ void CEXIETHERNET::TAPNetworkInterface::ReadThreadHandler(TAPNetworkInterface* s
 
     // Copy to BBA buffer, and fire interrupt if enabled.
     DEBUG_LOG_FMT(SP1, "Received {} bytes:\n {}", transferred,
-                  ArrayToString(self->m_eth_ref->mRecvBuffer.get(), transferred, 0x10));
+                  ArrayToString(buffer.data(), transferred, 0x10));
     if (self->readEnabled.IsSet())
-    {
-      self->m_eth_ref->mRecvBufferLength = transferred;
-      self->m_eth_ref->RecvHandlePacket();
-    }
+      self->m_eth_ref->RecvQueuePacket(buffer.data(), transferred);
   }
 }
 
@@ -169,9 +169,6 @@ void CEXIETHERNET::XLinkNetworkInterface::ReadThreadHandler(
       // Is the frame larger than BBA_RECV_SIZE?
       if ((bytes_read - 4) < BBA_RECV_SIZE)
       {
-        // Copy payload into BBA buffer as an ethernet frame
-        memmove(self->m_eth_ref->mRecvBuffer.get(), self->m_in_frame + 4, bytes_read - 4);
-
         // Check the frame size again after the header is removed
         if (bytes_read < 1)
         {
@@ -180,10 +177,11 @@ void CEXIETHERNET::XLinkNetworkInterface::ReadThreadHandler(
         else if (self->m_read_enabled.IsSet())
         {
           // Only uncomment for debugging, the performance hit is too big otherwise
-          // DEBUG_LOG_FMT(SP1, "Read data: {}", ArrayToString(self->m_eth_ref->mRecvBuffer.get(),
+          // DEBUG_LOG_FMT(SP1, "Read data: {}", ArrayToString(self->m_in_frame + 4,
           // u32(bytes_read - 4), 0x10));
-          self->m_eth_ref->mRecvBufferLength = u32(bytes_read - 4);
-          self->m_eth_ref->RecvHandlePacket();
+          // Pass the payload on to the BBA as an ethernet frame
+          self->m_eth_ref->RecvQueuePacket(reinterpret_cast<const u8*>(self->m_in_frame + 4),
+                                           u32(bytes_read - 4));
         }
       }
     }
@@ -14,6 +14,7 @@
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
 #include "Core/HW/EXI/EXI_Channel.h"
+#include "Core/HW/EXI/EXI_DeviceEthernet.h"
 #include "Core/HW/EXI/EXI_DeviceMemoryCard.h"
 #include "Core/HW/GCMemcard/GCMemcard.h"
 #include "Core/HW/MMIO.h"
@@ -73,6 +74,7 @@ void Init()
   }
 
   CEXIMemoryCard::Init();
+  CEXIETHERNET::Init();
 
   {
     bool use_memcard_251;
@@ -114,6 +116,7 @@ void Shutdown()
     channel.reset();
 
   CEXIMemoryCard::Shutdown();
+  CEXIETHERNET::Shutdown();
 }
 
 void DoState(PointerWrap& p)
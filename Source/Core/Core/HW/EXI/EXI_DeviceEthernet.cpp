@@ -8,6 +8,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -21,6 +22,8 @@
 
 namespace ExpansionInterface
 {
+static CoreTiming::EventType* s_et_recv_drain;
+
 // XXX: The BBA stores multi-byte elements as little endian.
 // Multiple parts of this implementation depend on Dolphin
 // being compiled for a little endian host.
@@ -97,6 +100,25 @@ CEXIETHERNET::~CEXIETHERNET()
   m_network_interface->Deactivate();
 }
 
+void CEXIETHERNET::Init()
+{
+  s_et_recv_drain = CoreTiming::RegisterEvent("EthernetRecvDrain", RecvDrainCallback);
+}
+
+void CEXIETHERNET::Shutdown()
+{
+  s_et_recv_drain = nullptr;
+}
+
+void CEXIETHERNET::RecvDrainCallback(u64 userdata, s64 cycles_late)
+{
+  for (TEXIDevices type : {EXIDEVICE_ETH, EXIDEVICE_ETHXLINK, EXIDEVICE_ETHTAPSERVER})
+  {
+    if (auto* device = static_cast<CEXIETHERNET*>(ExpansionInterface::FindDevice(type)))
+      device->RecvDrainQueue();
+  }
+}
+
 void CEXIETHERNET::SetCS(int cs)
 {
   if (cs)
@@ -516,6 +538,33 @@ inline void CEXIETHERNET::inc_rwp()
     (*rwp)++;
 }
 
+void CEXIETHERNET::RecvQueuePacket(const u8* data, u32 size)
+{
+  m_recv_queue.Push(std::vector<u8>(data, data + size));
+
+  // Packets arriving in a burst are all handled by a single event.
+  if (!m_recv_drain_scheduled.exchange(true))
+    CoreTiming::ScheduleEvent(0, s_et_recv_drain, 0, CoreTiming::FromThread::NON_CPU);
+}
+
+void CEXIETHERNET::RecvDrainQueue()
+{
+  // Clear the flag first, so that a packet pushed while draining schedules another event.
+  m_recv_drain_scheduled.store(false);
+
+  std::vector<u8> packet;
+  while (m_recv_queue.Pop(packet))
+  {
+    // The receiver may have been stopped after the packet was read.
+    if ((mBbaMem[BBA_NCRA] & NCRA_SR) == 0)
+      continue;
+
+    mRecvBufferLength = std::min<u32>(static_cast<u32>(packet.size()), BBA_RECV_SIZE);
+    std::copy_n(packet.begin(), mRecvBufferLength, mRecvBuffer.get());
+    RecvHandlePacket();
+  }
+}
+
 // This function is on the critical path for receiving data.
 // Be very careful about calling into the logger and other slow things
 bool CEXIETHERNET::RecvHandlePacket()
@@ -612,7 +661,7 @@ bool CEXIETHERNET::RecvHandlePacket()
     mBbaMem[BBA_IR] |= INT_R;
 
     exi_status.interrupt |= exi_status.TRANSFER;
-    ExpansionInterface::ScheduleUpdateInterrupts(CoreTiming::FromThread::NON_CPU, 0);
+    ExpansionInterface::ScheduleUpdateInterrupts(CoreTiming::FromThread::CPU, 0);
   }
   else
   {
@@ -15,6 +15,7 @@
 #include <SFML/Network.hpp>
 
 #include "Common/Flag.h"
+#include "Common/SPSCRingQueue.h"
 #include "Core/HW/EXI/EXI_Device.h"
 
 class PointerWrap;
@@ -212,6 +213,10 @@ class CEXIETHERNET : public IEXIDevice
 public:
   explicit CEXIETHERNET(BBADeviceType type);
   virtual ~CEXIETHERNET();
+
+  static void Init();
+  static void Shutdown();
+
   void SetCS(int cs) override;
   bool IsPresent() const override;
   bool IsInterruptSet() override;
@@ -305,6 +310,12 @@ private:
   void inc_rwp();
   bool RecvHandlePacket();
 
+  // Called by the network interface's reader thread. Packets are handed to the emulated adapter
+  // on the CPU thread, so that the reader never touches the adapter's state.
+  void RecvQueuePacket(const u8* data, u32 size);
+  void RecvDrainQueue();
+  static void RecvDrainCallback(u64 userdata, s64 cycles_late);
+
   std::unique_ptr<u8[]> mBbaMem;
   std::unique_ptr<u8[]> tx_fifo;
 
@@ -418,5 +429,8 @@ private:
 
   std::unique_ptr<u8[]> mRecvBuffer;
   u32 mRecvBufferLength = 0;
+
+  Common::SPSCRingQueue<std::vector<u8>, false> m_recv_queue;
+  std::atomic<bool> m_recv_drain_scheduled{false};
 };
 }  // namespace ExpansionInterface
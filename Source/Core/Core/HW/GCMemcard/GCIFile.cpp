@@ -101,5 +101,12 @@ void GCIFile::DoState(PointerWrap& p)
     p.DoPOD<GCMBlock>(*itr);
   }
   p.Do(m_used_blocks);
+
+  // The file on disk no longer necessarily matches, so rewrite all of it on the next flush.
+  if (p.GetMode() == PointerWrap::MODE_READ)
+  {
+    m_dirty_blocks.clear();
+    m_header_dirty = true;
+  }
 }
 }  // namespace Memcard
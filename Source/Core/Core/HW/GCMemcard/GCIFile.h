@@ -28,5 +28,10 @@ public:
   std::vector<u16> m_used_blocks;
   bool m_dirty;
   std::string m_filename;
+
+  // Blocks of m_save_data written since the last flush. As long as the header doesn't need to be
+  // rewritten, flushing only updates these blocks in the existing file.
+  std::vector<bool> m_dirty_blocks;
+  bool m_header_dirty = true;
 };
 }  // namespace Memcard
@@ -118,6 +118,7 @@ std::vector<std::string> GCMemcardDirectory::GetFileNamesForGameID(const std::st
     Memcard::GCIFile gci;
     gci.m_filename = file_name;
     gci.m_dirty = false;
+    gci.m_header_dirty = false;
     if (!gci_file.ReadBytes(&gci.m_gci_header, Memcard::DENTRY_SIZE))
       continue;
 
@@ -173,6 +174,7 @@ GCMemcardDirectory::GCMemcardDirectory(const std::string& directory, int slot,
     Memcard::GCIFile gci;
     gci.m_filename = filename;
     gci.m_dirty = false;
+    gci.m_header_dirty = false;
     if (!gci.LoadHeader())
     {
       ERROR_LOG_FMT(EXPANSIONINTERFACE, "Failed to load header of {}", filename);
@@ -242,6 +244,7 @@ void GCMemcardDirectory::FlushThread()
   Common::SetCurrentThreadName(fmt::format("Memcard {} flushing thread", m_card_index).c_str());
 
   constexpr std::chrono::seconds flush_interval{1};
+  constexpr std::chrono::seconds max_flush_delay{10};
   while (true)
   {
     // no-op until signalled
@@ -249,11 +252,15 @@ void GCMemcardDirectory::FlushThread()
 
     if (m_exiting.TestAndClear())
       return;
-    // no-op as long as signalled within flush_interval
+    // no-op as long as signalled within flush_interval, but don't hold off a game that keeps
+    // writing forever
+    const auto first_write = std::chrono::steady_clock::now();
     while (m_flush_trigger.WaitFor(flush_interval))
     {
       if (m_exiting.TestAndClear())
         return;
+      if (std::chrono::steady_clock::now() - first_write >= max_flush_delay)
+        break;
     }
 
     FlushToFile();
@@ -386,6 +393,10 @@ s32 GCMemcardDirectory::Write(u32 dest_address, s32 length, const u8* src_addres
 
   memcpy(m_last_block_address + offset, src_address, length);
 
+  // Writes to the same block as the previous access skip SaveAreaRW, so mark the block here.
+  if (block >= static_cast<s32>(Memcard::MC_FST_BLOCKS))
+    MarkLastSaveBlockDirty();
+
   l.unlock();
   if (extra)
     extra = Write(dest_address + length, extra, src_address + length);
@@ -461,6 +472,7 @@ inline void GCMemcardDirectory::SyncSaves()
                           Memcard::DENTRY_SIZE))
       {
         m_saves[i].m_dirty = true;
+        m_saves[i].m_header_dirty = true;
         const u32 gamecode = Common::swap32(m_saves[i].m_gci_header.m_gamecode.data());
         const u32 new_gamecode = Common::swap32(current->m_dir_entries[i].m_gamecode.data());
         const u32 old_start = m_saves[i].m_gci_header.m_first_block;
@@ -522,10 +534,10 @@ inline s32 GCMemcardDirectory::SaveAreaRW(u32 block, bool writing)
           }
         }
 
+        m_last_save = i;
+        m_last_save_block = idx;
         if (writing)
-        {
-          m_saves[i].m_dirty = true;
-        }
+          MarkLastSaveBlockDirty();
 
         m_last_block = block;
         m_last_block_address = m_saves[i].m_save_data[idx].m_block.data();
@@ -591,6 +603,45 @@ bool GCMemcardDirectory::SetUsedBlocks(int save_index)
   return true;
 }
 
+void GCMemcardDirectory::MarkLastSaveBlockDirty()
+{
+  if (m_last_save >= m_saves.size())
+    return;
+
+  Memcard::GCIFile& save = m_saves[m_last_save];
+  save.m_dirty = true;
+  if (m_last_save_block < save.m_save_data.size())
+  {
+    save.m_dirty_blocks.resize(save.m_save_data.size());
+    save.m_dirty_blocks[m_last_save_block] = true;
+  }
+}
+
+bool GCMemcardDirectory::WriteDirtySaveBlocks(const Memcard::GCIFile& save)
+{
+  // Only worth it if the file on disk has the same header and layout as the save in memory.
+  const u64 expected_size = Memcard::DENTRY_SIZE + save.m_save_data.size() * Memcard::BLOCK_SIZE;
+  if (save.m_header_dirty || save.m_filename.empty() ||
+      File::GetSize(save.m_filename) != expected_size)
+  {
+    return false;
+  }
+
+  File::IOFile gci(save.m_filename, "r+b");
+  if (!gci)
+    return false;
+
+  for (size_t i = 0; i < save.m_dirty_blocks.size() && i < save.m_save_data.size(); ++i)
+  {
+    if (!save.m_dirty_blocks[i])
+      continue;
+
+    gci.Seek(Memcard::DENTRY_SIZE + i * Memcard::BLOCK_SIZE, SEEK_SET);
+    gci.WriteBytes(save.m_save_data[i].m_block.data(), Memcard::BLOCK_SIZE);
+  }
+  return gci.Flush() && gci.IsGood();
+}
+
 void GCMemcardDirectory::FlushToFile()
 {
   std::unique_lock l(m_write_mutex);
@@ -630,8 +681,16 @@ void GCMemcardDirectory::FlushToFile()
           }
           save.m_filename = default_save_name;
         }
-        File::IOFile gci(save.m_filename, "wb");
-        if (gci)
+
+        // Usually only a few blocks of a save change, so try to update just those first.
+        const bool wrote_blocks = WriteDirtySaveBlocks(save);
+        save.m_dirty_blocks.clear();
+        save.m_header_dirty = false;
+        if (wrote_blocks)
+        {
+          Core::DisplayMessage(fmt::format("Wrote save contents to {}", save.m_filename), 4000);
+        }
+        else if (File::IOFile gci(save.m_filename, "wb"); gci)
         {
           gci.WriteBytes(&save.m_gci_header, Memcard::DENTRY_SIZE);
           for (const Memcard::GCMBlock& block : save.m_save_data)
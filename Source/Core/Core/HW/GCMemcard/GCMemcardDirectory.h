@@ -43,6 +43,8 @@ public:
 private:
   bool LoadGCI(Memcard::GCIFile gci);
   inline s32 SaveAreaRW(u32 block, bool writing = false);
+  void MarkLastSaveBlockDirty();
+  bool WriteDirtySaveBlocks(const Memcard::GCIFile& save);
   // s32 DirectoryRead(u32 offset, u32 length, u8* dest_address);
   s32 DirectoryWrite(u32 dest_address, u32 length, const u8* src_address);
   inline void SyncSaves();
@@ -51,6 +53,9 @@ private:
   u32 m_game_id;
   s32 m_last_block;
   u8* m_last_block_address;
+  // The save and index into its data of m_last_block, if it is in the save area.
+  size_t m_last_save = 0;
+  size_t m_last_save_block = 0;
 
   Memcard::Header m_hdr;
   Memcard::Directory m_dir1;
@@ -4,6 +4,7 @@
 
 #include "Core/HW/GCMemcard/GCMemcardRaw.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <memory>
@@ -75,6 +76,7 @@ MemoryCard::MemoryCard(const std::string& filename, int card_index, u16 size_mbi
   // Class members (including inherited ones) have now been initialized, so
   // it's safe to startup the flush thread (which reads them).
   m_flush_buffer = std::make_unique<u8[]>(m_memory_card_size);
+  m_dirty_blocks.resize((m_memory_card_size + Memcard::BLOCK_SIZE - 1) / Memcard::BLOCK_SIZE);
   m_flush_thread = std::thread(&MemoryCard::FlushThread, this);
 }
 
@@ -164,6 +166,8 @@ void MemoryCard::FlushThread()
     // file doesn't disappear out from under us after the first check.
     File::IOFile file(m_filename, "r+b");
 
+    // A missing or truncated file has to be written out in full.
+    bool full_write = !file || file.GetSize() != m_memory_card_size;
     if (!file)
     {
       std::string dir;
@@ -190,11 +194,49 @@ void MemoryCard::FlushThread()
       return;
     }
 
+    // Only copy out and rewrite the blocks which changed since the last flush, so that a game
+    // saving a few blocks doesn't cause the whole card image to be rewritten.
+    std::vector<bool> blocks;
     {
       std::unique_lock l(m_flush_mutex);
-      memcpy(&m_flush_buffer[0], &m_memcard_data[0], m_memory_card_size);
+      if (full_write)
+        std::fill(m_dirty_blocks.begin(), m_dirty_blocks.end(), true);
+
+      blocks = m_dirty_blocks;
+      std::fill(m_dirty_blocks.begin(), m_dirty_blocks.end(), false);
+      for (size_t i = 0; i < blocks.size(); ++i)
+      {
+        if (!blocks[i])
+          continue;
+
+        const u32 offset = static_cast<u32>(i) * Memcard::BLOCK_SIZE;
+        const u32 length = std::min<u32>(Memcard::BLOCK_SIZE, m_memory_card_size - offset);
+        memcpy(&m_flush_buffer[offset], &m_memcard_data[offset], length);
+      }
     }
-    file.WriteBytes(&m_flush_buffer[0], m_memory_card_size);
+
+    // Write contiguous runs of dirty blocks with one call each.
+    size_t run_start = 0;
+    while (run_start < blocks.size())
+    {
+      if (!blocks[run_start])
+      {
+        ++run_start;
+        continue;
+      }
+
+      size_t run_end = run_start;
+      while (run_end < blocks.size() && blocks[run_end])
+        ++run_end;
+
+      const u32 offset = static_cast<u32>(run_start) * Memcard::BLOCK_SIZE;
+      const u32 end = std::min<u32>(static_cast<u32>(run_end) * Memcard::BLOCK_SIZE,
+                                    m_memory_card_size);
+      file.Seek(offset, SEEK_SET);
+      file.WriteBytes(&m_flush_buffer[offset], end - offset);
+      run_start = run_end;
+    }
+    file.Flush();
 
     if (do_exit)
       return;
@@ -210,6 +252,18 @@ void MemoryCard::MakeDirty()
   m_dirty.Set();
 }
 
+void MemoryCard::MarkBlocksDirty(u32 address, u32 length)
+{
+  if (length == 0)
+    return;
+
+  const u32 first = address / Memcard::BLOCK_SIZE;
+  const u32 last = std::min<u32>((address + length - 1) / Memcard::BLOCK_SIZE,
+                                 static_cast<u32>(m_dirty_blocks.size()) - 1);
+  for (u32 i = first; i <= last; ++i)
+    m_dirty_blocks[i] = true;
+}
+
 s32 MemoryCard::Read(u32 src_address, s32 length, u8* dest_address)
 {
   if (!IsAddressInBounds(src_address))
@@ -234,6 +288,7 @@ s32 MemoryCard::Write(u32 dest_address, s32 length, const u8* src_address)
   {
     std::unique_lock l(m_flush_mutex);
     memcpy(&m_memcard_data[dest_address], src_address, length);
+    MarkBlocksDirty(dest_address, length);
   }
   MakeDirty();
   return length;
@@ -250,6 +305,7 @@ void MemoryCard::ClearBlock(u32 address)
   {
     std::unique_lock l(m_flush_mutex);
     memset(&m_memcard_data[address], 0xFF, Memcard::BLOCK_SIZE);
+    MarkBlocksDirty(address, Memcard::BLOCK_SIZE);
   }
   MakeDirty();
 }
@@ -259,6 +315,7 @@ void MemoryCard::ClearAll()
   {
     std::unique_lock l(m_flush_mutex);
     memset(&m_memcard_data[0], 0xFF, m_memory_card_size);
+    std::fill(m_dirty_blocks.begin(), m_dirty_blocks.end(), true);
   }
   MakeDirty();
 }
@@ -268,4 +325,11 @@ void MemoryCard::DoState(PointerWrap& p)
   p.Do(m_card_index);
   p.Do(m_memory_card_size);
   p.DoArray(&m_memcard_data[0], m_memory_card_size);
+
+  // The loaded contents may differ anywhere, so write the whole card the next time it is flushed.
+  if (p.GetMode() == PointerWrap::MODE_READ)
+  {
+    std::unique_lock l(m_flush_mutex);
+    std::fill(m_dirty_blocks.begin(), m_dirty_blocks.end(), true);
+  }
 }
@@ -8,6 +8,8 @@
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
+
 #include "Common/Event.h"
 #include "Common/Flag.h"
 #include "Core/HW/GCMemcard/GCMemcard.h"
@@ -32,6 +34,9 @@ public:
   void DoState(PointerWrap& p) override;
 
 private:
+  // Must be called with m_flush_mutex held.
+  void MarkBlocksDirty(u32 address, u32 length);
+
   std::string m_filename;
   std::unique_ptr<u8[]> m_memcard_data;
   std::unique_ptr<u8[]> m_flush_buffer;
@@ -39,4 +44,7 @@ private:
   std::mutex m_flush_mutex;
   Common::Event m_flush_trigger;
   Common::Flag m_dirty;
+
+  // Blocks modified since the last flush, guarded by m_flush_mutex. Only these are rewritten.
+  std::vector<bool> m_dirty_blocks;
 };
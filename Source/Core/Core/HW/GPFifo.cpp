@@ -10,6 +10,7 @@
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Swap.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/HW/Memmap.h"
 #include "Core/HW/ProcessorInterface.h"
 #include "Core/PowerPC/JitInterface.h"
@@ -21,29 +22,101 @@ namespace GPFifo
 // 32 Byte gather pipe with extra space
 // Overfilling is no problem (up to the real limit), CheckGatherPipe will blast the
 // contents in nicely sized chunks
-//
-// Other optimizations to think about:
-// - If the GP is NOT linked to the FIFO, just blast to memory byte by word
-// - If the GP IS linked to the FIFO, use a fast wrapping buffer and skip writing to memory
-//
-// Both of these should actually work! Only problem is that we have to decide at run time,
-// the same function could use both methods. Compile 2 different versions of each such block?
 
 // More room for the fastmodes
 alignas(32) static u8 s_gather_pipe[GATHER_PIPE_SIZE * 16];
 
+// With direct writes, gather_pipe_base_ptr points at the FIFO in emulated memory instead of at
+// s_gather_pipe whenever there is room for a whole s_gather_pipe worth of writes in front of the
+// write pointer. The JIT code (and the interpreter) then stores straight into the FIFO, and
+// UpdateGatherPipe only has to move the write pointer along instead of copying every burst.
+// Near the end of the FIFO, where the writes would have to wrap around, s_gather_pipe is used.
+static bool s_direct_writes_enabled = false;
+static bool s_direct_writes = false;
+// The FIFO registers at the time direct writes started, to notice when the game moves the FIFO
+static u32 s_direct_write_pointer;
+static u32 s_direct_base;
+static u32 s_direct_end;
+
 static size_t GetGatherPipeCount()
 {
-  return PowerPC::ppcState.gather_pipe_ptr - s_gather_pipe;
+  return PowerPC::ppcState.gather_pipe_ptr - PowerPC::ppcState.gather_pipe_base_ptr;
 }
 
 static void SetGatherPipeCount(size_t size)
 {
-  PowerPC::ppcState.gather_pipe_ptr = s_gather_pipe + size;
+  PowerPC::ppcState.gather_pipe_ptr = PowerPC::ppcState.gather_pipe_base_ptr + size;
+}
+
+// Returns where in host memory the next bursts can be written directly, or nullptr if they can't.
+static u8* GetDirectWritePointer()
+{
+  constexpr u32 window = sizeof(s_gather_pipe);
+  const u32 write_pointer = ProcessorInterface::Fifo_CPUWritePointer;
+
+  // Fifo_CPUEnd is the address of the last burst in the FIFO
+  const u32 end = ProcessorInterface::Fifo_CPUEnd + GATHER_PIPE_SIZE;
+  if (write_pointer < ProcessorInterface::Fifo_CPUBase || write_pointer >= end ||
+      end - write_pointer < window)
+  {
+    return nullptr;
+  }
+
+  // Don't write over data that the GPU hasn't read yet
+  const u32 read_pointer = CommandProcessor::fifo.CPReadPointer;
+  if (read_pointer > write_pointer && read_pointer - write_pointer < window)
+    return nullptr;
+
+  // Only main RAM is one contiguous block that can't fault
+  const u32 physical_address = write_pointer & 0x3FFFFFFF;
+  if (physical_address >= Memory::GetRamSizeReal() ||
+      Memory::GetRamSizeReal() - physical_address < window)
+  {
+    return nullptr;
+  }
+
+  return Memory::m_pRAM + physical_address;
+}
+
+// Moves the bytes that don't make up a whole burst yet to where the next burst will be written.
+static void PlaceSpillBytes(const u8* spill, size_t count)
+{
+  u8* destination = s_direct_writes_enabled ? GetDirectWritePointer() : nullptr;
+  s_direct_writes = destination != nullptr;
+  if (s_direct_writes)
+  {
+    s_direct_write_pointer = ProcessorInterface::Fifo_CPUWritePointer;
+    s_direct_base = ProcessorInterface::Fifo_CPUBase;
+    s_direct_end = ProcessorInterface::Fifo_CPUEnd;
+  }
+  else
+  {
+    destination = s_gather_pipe;
+  }
+
+  if (destination != spill)
+    std::memmove(destination, spill, count);
+  PowerPC::ppcState.gather_pipe_base_ptr = destination;
+  SetGatherPipeCount(count);
+}
+
+static void StopDirectWrites()
+{
+  if (!s_direct_writes)
+    return;
+
+  const size_t count = GetGatherPipeCount();
+  std::memcpy(s_gather_pipe, PowerPC::ppcState.gather_pipe_base_ptr, count);
+  PowerPC::ppcState.gather_pipe_base_ptr = s_gather_pipe;
+  SetGatherPipeCount(count);
+  s_direct_writes = false;
 }
 
 void DoState(PointerWrap& p)
 {
+  // Savestates always contain the pending bytes in s_gather_pipe
+  StopDirectWrites();
+
   p.Do(s_gather_pipe);
   u32 pipe_count = static_cast<u32>(GetGatherPipeCount());
   p.Do(pipe_count);
@@ -52,8 +125,8 @@ void DoState(PointerWrap& p)
 
 void Init()
 {
+  s_direct_writes_enabled = Config::Get(Config::MAIN_DIRECT_GATHER_PIPE);
   ResetGatherPipe();
-  PowerPC::ppcState.gather_pipe_base_ptr = s_gather_pipe;
   memset(s_gather_pipe, 0, sizeof(s_gather_pipe));
 }
 
@@ -64,38 +137,42 @@ bool IsEmpty()
 
 void ResetGatherPipe()
 {
+  s_direct_writes = false;
+  PowerPC::ppcState.gather_pipe_base_ptr = s_gather_pipe;
   SetGatherPipeCount(0);
 }
 
 void UpdateGatherPipe()
 {
+  // The game has set up a new FIFO since the pending bytes were written
+  if (s_direct_writes && (s_direct_write_pointer != ProcessorInterface::Fifo_CPUWritePointer ||
+                          s_direct_base != ProcessorInterface::Fifo_CPUBase ||
+                          s_direct_end != ProcessorInterface::Fifo_CPUEnd))
+  {
+    StopDirectWrites();
+  }
+
+  const u8* pipe = PowerPC::ppcState.gather_pipe_base_ptr;
   size_t pipe_count = GetGatherPipeCount();
   size_t processed;
-  u8* cur_mem = Memory::GetPointer(ProcessorInterface::Fifo_CPUWritePointer);
   for (processed = 0; pipe_count >= GATHER_PIPE_SIZE; processed += GATHER_PIPE_SIZE)
   {
-    // copy the GatherPipe
-    memcpy(cur_mem, s_gather_pipe + processed, GATHER_PIPE_SIZE);
+    // copy the GatherPipe, unless it was written to the FIFO directly
+    u8* cur_mem = Memory::GetPointer(ProcessorInterface::Fifo_CPUWritePointer);
+    if (cur_mem != pipe + processed)
+      memcpy(cur_mem, pipe + processed, GATHER_PIPE_SIZE);
     pipe_count -= GATHER_PIPE_SIZE;
 
     // increase the CPUWritePointer
     if (ProcessorInterface::Fifo_CPUWritePointer == ProcessorInterface::Fifo_CPUEnd)
-    {
       ProcessorInterface::Fifo_CPUWritePointer = ProcessorInterface::Fifo_CPUBase;
-      cur_mem = Memory::GetPointer(ProcessorInterface::Fifo_CPUWritePointer);
-    }
     else
-    {
-      cur_mem += GATHER_PIPE_SIZE;
       ProcessorInterface::Fifo_CPUWritePointer += GATHER_PIPE_SIZE;
-    }
 
     CommandProcessor::GatherPipeBursted();
   }
 
-  // move back the spill bytes
-  memmove(s_gather_pipe, s_gather_pipe + processed, pipe_count);
-  SetGatherPipeCount(pipe_count);
+  PlaceSpillBytes(pipe + processed, pipe_count);
 }
 
 void FastCheckGatherPipe()
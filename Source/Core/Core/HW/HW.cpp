@@ -24,6 +24,7 @@
 #include "Core/HW/VideoInterface.h"
 #include "Core/HW/WII_IPC.h"
 #include "Core/IOS/IOS.h"
+#include "Core/Rewind.h"
 #include "Core/State.h"
 #include "Core/WiiRoot.h"
 
@@ -35,6 +36,7 @@ void Init()
   SystemTimers::PreInit();
 
   State::Init();
+  Rewind::Init();
 
   // Init the whole Hardware
   AudioInterface::Init();
@@ -76,6 +78,7 @@ void Shutdown()
   SerialInterface::Shutdown();
   AudioInterface::Shutdown();
 
+  Rewind::Shutdown();
   State::Shutdown();
   CoreTiming::Shutdown();
 }
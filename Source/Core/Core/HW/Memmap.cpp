@@ -13,12 +13,20 @@
 #include <array>
 #include <cstring>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "Common/Align.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
 #include "Common/Swap.h"
+#include "Common/Thread.h"
 #include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/AudioInterface.h"
@@ -180,6 +188,10 @@ struct LogicalMemoryView
 {
   void* mapped_pointer;
   u32 mapped_size;
+  u32 shm_position;
+  // Set for views that only write-only memchecks overlap. Writes through them must always fault,
+  // so write tracking leaves them alone.
+  bool read_only = false;
 };
 
 // Dolphin allocates memory to represent four regions:
@@ -225,6 +237,35 @@ struct LogicalMemoryView
 static std::array<PhysicalMemoryRegion, 4> physical_regions;
 
 static std::vector<LogicalMemoryView> logical_mapped_entries;
+// The DBATs which logical_mapped_entries currently reflect.
+static PowerPC::BatTable logical_mapped_dbat_table;
+
+// Pages mapped through MapLogicalPage, and whether they are writable.
+constexpr u32 LOGICAL_PAGE_SIZE = 0x1000;
+static std::unordered_map<u32, bool> logical_mapped_pages;
+static bool logical_page_mapping_failed = false;
+
+// Write tracking. Tracked pages of RAM and EXRAM are write protected in every view of them, so the
+// first write to them from any thread faults. The fault handler then unprotects the page again.
+// The mutex also guards the views against being changed while pages are being protected.
+static std::mutex s_write_tracking_mutex;
+static bool s_write_tracking_enabled = false;
+static u32 s_write_tracking_page_size = 0;
+// For each page of the shared memory segment, the stamp at which tracking it started, or 0.
+static std::vector<u64> s_tracked_since;
+static u32 s_num_tracked_pages = 0;
+static u64 s_write_tracking_stamp = 0;
+
+static void ResetWriteTracking();
+
+// Delta savestates. The base stamp is from write tracking all of RAM and EXRAM when the previous
+// state was saved or loaded, and the page lists are what DoState handles while delta states are
+// enabled.
+static bool s_delta_state_enabled = false;
+static u64 s_state_base_stamp = 0;
+static u32 s_state_page_size = 0;
+static std::vector<u32> s_state_ram_pages;
+static std::vector<u32> s_state_exram_pages;
 
 static u32 GetFlags()
 {
@@ -284,6 +325,9 @@ void Init()
   {
     if ((flags & region.flags) != region.flags)
       continue;
+    // Huge pages can only back the views whose offsets are aligned like their addresses are.
+    if (Common::AreHugePagesEnabled())
+      mem_size = Common::AlignUp(mem_size, Common::HUGE_PAGE_SIZE);
     region.shm_position = mem_size;
     mem_size += region.size;
   }
@@ -302,6 +346,9 @@ void Init()
       PanicAlertFmt("MemoryMap_Setup: Failed finding a memory base.");
       exit(0);
     }
+
+    // The fastmem views share the pages of this one, so this covers them too.
+    Common::BindMemoryToEmulationNode(*region.out_pointer, region.size);
   }
 
   if (wii)
@@ -341,50 +388,293 @@ bool InitFastmemArena()
   logical_base = physical_base + 0x200000000;
 #endif
 
+  logical_page_mapping_failed = false;
   is_fastmem_arena_initialized = true;
   return true;
 }
 
+static void UnmapLogicalPagesLocked(u32 mask, u32 index);
+
+// Maps the parts of a view of RAM that no memcheck overlaps, and those that only write-only
+// memchecks overlap read-only, so that only the accesses a memcheck may be interested in fault.
+// If the host can't map views this finely, none of it is mapped.
+static void MapWatchedLogicalView(u32 logical_address, u32 position, u32 size, u8* base)
+{
+  enum class Access
+  {
+    None,
+    Read,
+    ReadWrite,
+  };
+
+  const u32 granularity =
+      static_cast<u32>(std::max<size_t>(Common::MemPageSize(), LOGICAL_PAGE_SIZE));
+  const auto get_access = [&](u32 offset) {
+    if (!PowerPC::memchecks.OverlapsMemcheck(logical_address + offset, granularity))
+      return Access::ReadWrite;
+    if (PowerPC::memchecks.OverlapsReadMemcheck(logical_address + offset, granularity))
+      return Access::None;
+    return Access::Read;
+  };
+
+  const size_t first_view = logical_mapped_entries.size();
+  for (u32 offset = 0; offset < size;)
+  {
+    const Access access = get_access(offset);
+    u32 end = offset + granularity;
+    while (end < size && get_access(end) == access)
+      end += granularity;
+    end = std::min(end, size);
+
+    if (access != Access::None)
+    {
+      const bool read_only = access == Access::Read;
+      void* mapped_pointer =
+          g_arena.CreateView(position + offset, end - offset, base + offset, read_only);
+      if (mapped_pointer != base + offset)
+      {
+        if (mapped_pointer)
+          g_arena.ReleaseView(mapped_pointer, end - offset);
+        for (size_t i = first_view; i < logical_mapped_entries.size(); ++i)
+        {
+          g_arena.ReleaseView(logical_mapped_entries[i].mapped_pointer,
+                              logical_mapped_entries[i].mapped_size);
+        }
+        logical_mapped_entries.resize(first_view);
+        return;
+      }
+      logical_mapped_entries.push_back({mapped_pointer, end - offset, position + offset, read_only});
+    }
+
+    offset = end;
+  }
+}
+
+// Maps the logical range starting at logical_address to the physical memory starting at
+// translated_address, wherever there is physical memory.
+static void MapLogicalRange(u32 logical_address, u32 translated_address, u32 logical_size)
+{
+  for (const auto& physical_region : physical_regions)
+  {
+    const u64 mapping_address = physical_region.physical_address;
+    const u64 mapping_end = mapping_address + physical_region.size;
+    const u64 intersection_start = std::max<u64>(mapping_address, translated_address);
+    const u64 intersection_end = std::min<u64>(mapping_end, u64(translated_address) + logical_size);
+    if (intersection_start < intersection_end)
+    {
+      // Found an overlapping region; map it.
+      const u32 position =
+          static_cast<u32>(physical_region.shm_position + intersection_start - mapping_address);
+      u8* base = logical_base + logical_address + (intersection_start - translated_address);
+      const u32 mapped_size = static_cast<u32>(intersection_end - intersection_start);
+
+      void* mapped_pointer = g_arena.CreateView(position, mapped_size, base);
+      if (!mapped_pointer)
+      {
+        PanicAlertFmt("MemoryMap_Setup: Failed finding a memory base.");
+        exit(0);
+      }
+      logical_mapped_entries.push_back({mapped_pointer, mapped_size, position});
+    }
+  }
+}
+
+// What the views of a BAT page depend on. Pages with the same key are mapped the same way, except
+// for watched pages, whose views also depend on the memchecks.
+static u32 GetLogicalViewKey(u32 bat_entry)
+{
+  if (!(bat_entry & (PowerPC::BAT_PHYSICAL_BIT | PowerPC::BAT_WATCHED_BIT)))
+    return 0;
+  return bat_entry &
+         (PowerPC::BAT_RESULT_MASK | PowerPC::BAT_PHYSICAL_BIT | PowerPC::BAT_WATCHED_BIT);
+}
+
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
 {
   if (!is_fastmem_arena_initialized)
     return;
 
-  for (auto& entry : logical_mapped_entries)
+  // Games tend to rewrite the BATs with mostly the same values, so only the BAT pages whose
+  // mapping changed are remapped. Watched pages are always remapped, as the memchecks may have
+  // changed.
+  std::vector<bool> changed(dbat_table.size());
+  bool any_changed = false;
+  for (u32 i = 0; i < dbat_table.size(); ++i)
   {
-    g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
+    const u32 old_key = GetLogicalViewKey(logical_mapped_dbat_table[i]);
+    const u32 new_key = GetLogicalViewKey(dbat_table[i]);
+    changed[i] = old_key != new_key || ((old_key | new_key) & PowerPC::BAT_WATCHED_BIT);
+    any_changed |= changed[i];
   }
-  logical_mapped_entries.clear();
-  for (u32 i = 0; i < dbat_table.size(); ++i)
+  if (!any_changed)
+    return;
+
+  // New views aren't write protected, so tracking has to start over.
+  std::lock_guard lock(s_write_tracking_mutex);
+  ResetWriteTracking();
+
+  // A view can cover several BAT pages, which all have to be mapped again if it's released.
+  const auto get_page_range = [](const LogicalMemoryView& view) {
+    const u32 offset = static_cast<u32>(static_cast<u8*>(view.mapped_pointer) - logical_base);
+    return std::make_pair(offset >> PowerPC::BAT_INDEX_SHIFT,
+                          (offset + view.mapped_size - 1) >> PowerPC::BAT_INDEX_SHIFT);
+  };
+  for (bool released = true; released;)
   {
-    if (dbat_table[i] & PowerPC::BAT_PHYSICAL_BIT)
+    released = false;
+    for (size_t i = 0; i < logical_mapped_entries.size();)
+    {
+      const LogicalMemoryView& view = logical_mapped_entries[i];
+      const auto [first_page, last_page] = get_page_range(view);
+      if (std::none_of(changed.begin() + first_page, changed.begin() + last_page + 1,
+                       [](bool page_changed) { return page_changed; }))
+      {
+        ++i;
+        continue;
+      }
+
+      std::fill(changed.begin() + first_page, changed.begin() + last_page + 1, true);
+      g_arena.ReleaseView(view.mapped_pointer, view.mapped_size);
+      logical_mapped_entries[i] = logical_mapped_entries.back();
+      logical_mapped_entries.pop_back();
+      released = true;
+    }
+  }
+
+  // The BATs take priority over the page table, so pages which were mapped through the page table
+  // might be covered by a BAT now.
+  for (auto it = logical_mapped_pages.begin(); it != logical_mapped_pages.end();)
+  {
+    if (changed[it->first >> PowerPC::BAT_INDEX_SHIFT])
+    {
+      g_arena.ReleaseView(logical_base + it->first, LOGICAL_PAGE_SIZE);
+      it = logical_mapped_pages.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  for (u32 i = 0; i < dbat_table.size();)
+  {
+    if (!changed[i] || !(dbat_table[i] & (PowerPC::BAT_PHYSICAL_BIT | PowerPC::BAT_WATCHED_BIT)))
+    {
+      ++i;
+      continue;
+    }
+
+    const u32 logical_address = i << PowerPC::BAT_INDEX_SHIFT;
+    const u32 translated_address = dbat_table[i] & PowerPC::BAT_RESULT_MASK;
+
+    if (dbat_table[i] & PowerPC::BAT_WATCHED_BIT)
     {
-      u32 logical_address = i << PowerPC::BAT_INDEX_SHIFT;
-      // TODO: Merge adjacent mappings to make this faster.
-      u32 logical_size = PowerPC::BAT_PAGE_SIZE;
-      u32 translated_address = dbat_table[i] & PowerPC::BAT_RESULT_MASK;
       for (const auto& physical_region : physical_regions)
       {
-        u32 mapping_address = physical_region.physical_address;
-        u32 mapping_end = mapping_address + physical_region.size;
-        u32 intersection_start = std::max(mapping_address, translated_address);
-        u32 intersection_end = std::min(mapping_end, translated_address + logical_size);
+        const u32 mapping_address = physical_region.physical_address;
+        const u32 mapping_end = mapping_address + physical_region.size;
+        const u32 intersection_start = std::max(mapping_address, translated_address);
+        const u32 intersection_end =
+            std::min(mapping_end, translated_address + PowerPC::BAT_PAGE_SIZE);
         if (intersection_start < intersection_end)
         {
-          // Found an overlapping region; map it.
-          u32 position = physical_region.shm_position + intersection_start - mapping_address;
-          u8* base = logical_base + logical_address + intersection_start - translated_address;
-          u32 mapped_size = intersection_end - intersection_start;
-
-          void* mapped_pointer = g_arena.CreateView(position, mapped_size, base);
-          if (!mapped_pointer)
-          {
-            PanicAlertFmt("MemoryMap_Setup: Failed finding a memory base.");
-            exit(0);
-          }
-          logical_mapped_entries.push_back({mapped_pointer, mapped_size});
+          const u32 position = physical_region.shm_position + intersection_start - mapping_address;
+          const u32 offset = intersection_start - translated_address;
+          MapWatchedLogicalView(logical_address + offset, position,
+                                intersection_end - intersection_start,
+                                logical_base + logical_address + offset);
         }
       }
+      ++i;
+      continue;
+    }
+
+    // Map runs of pages which are contiguous in physical memory too with a single view each.
+    u32 num_pages = 1;
+    while (i + num_pages < dbat_table.size() && changed[i + num_pages] &&
+           (dbat_table[i + num_pages] & (PowerPC::BAT_PHYSICAL_BIT | PowerPC::BAT_WATCHED_BIT)) ==
+               PowerPC::BAT_PHYSICAL_BIT &&
+           (dbat_table[i + num_pages] & PowerPC::BAT_RESULT_MASK) ==
+               u64(translated_address) + num_pages * PowerPC::BAT_PAGE_SIZE)
+    {
+      ++num_pages;
+    }
+
+    MapLogicalRange(logical_address, translated_address, num_pages * PowerPC::BAT_PAGE_SIZE);
+    i += num_pages;
+  }
+
+  logical_mapped_dbat_table = dbat_table;
+}
+
+bool MapLogicalPage(u32 logical_address, u32 physical_address, bool writable)
+{
+  if (!is_fastmem_arena_initialized || !logical_base || logical_page_mapping_failed)
+    return false;
+
+  std::lock_guard lock(s_write_tracking_mutex);
+  ResetWriteTracking();
+
+  const u32 logical_page = logical_address & ~(LOGICAL_PAGE_SIZE - 1);
+  const u32 physical_page = physical_address & ~(LOGICAL_PAGE_SIZE - 1);
+  const u32 flags = GetFlags();
+  for (const PhysicalMemoryRegion& region : physical_regions)
+  {
+    if ((flags & region.flags) != region.flags || physical_page < region.physical_address ||
+        physical_page - region.physical_address >= region.size)
+    {
+      continue;
+    }
+
+    u8* base = logical_base + logical_page;
+    const auto it = logical_mapped_pages.find(logical_page);
+    if (it != logical_mapped_pages.end())
+    {
+      g_arena.ReleaseView(base, LOGICAL_PAGE_SIZE);
+      logical_mapped_pages.erase(it);
+    }
+
+    const u32 position = region.shm_position + physical_page - region.physical_address;
+    if (g_arena.CreateView(position, LOGICAL_PAGE_SIZE, base, !writable) != base)
+    {
+      // Most likely the host's page size or allocation granularity is larger than 4 KiB.
+      WARN_LOG_FMT(MEMMAP, "Failed to map logical page {:#010x}, using slowmem for page table "
+                           "mappings from now on",
+                   logical_page);
+      logical_page_mapping_failed = true;
+      return false;
+    }
+
+    logical_mapped_pages.emplace(logical_page, writable);
+    return true;
+  }
+
+  return false;
+}
+
+bool IsLogicalPageMapped(u32 logical_address)
+{
+  return logical_mapped_pages.count(logical_address & ~(LOGICAL_PAGE_SIZE - 1)) != 0;
+}
+
+void UnmapLogicalPages(u32 mask, u32 index)
+{
+  std::lock_guard lock(s_write_tracking_mutex);
+  UnmapLogicalPagesLocked(mask, index);
+}
+
+static void UnmapLogicalPagesLocked(u32 mask, u32 index)
+{
+  for (auto it = logical_mapped_pages.begin(); it != logical_mapped_pages.end();)
+  {
+    if (((it->first / LOGICAL_PAGE_SIZE) & mask) == index)
+    {
+      g_arena.ReleaseView(logical_base + it->first, LOGICAL_PAGE_SIZE);
+      it = logical_mapped_pages.erase(it);
+    }
+    else
+    {
+      ++it;
     }
   }
 }
@@ -392,19 +682,33 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
 void DoState(PointerWrap& p)
 {
   bool wii = SConfig::GetInstance().bWii;
-  p.DoArray(m_pRAM, GetRamSize());
+  if (s_delta_state_enabled)
+    p.DoArrayPages(m_pRAM, GetRamSize(), s_state_page_size, s_state_ram_pages);
+  else
+    p.DoBulkArray(m_pRAM, GetRamSize());
   p.DoArray(m_pL1Cache, GetL1CacheSize());
   p.DoMarker("Memory RAM");
   if (m_pFakeVMEM)
-    p.DoArray(m_pFakeVMEM, GetFakeVMemSize());
+    p.DoBulkArray(m_pFakeVMEM, GetFakeVMemSize());
   p.DoMarker("Memory FakeVMEM");
   if (wii)
-    p.DoArray(m_pEXRAM, GetExRamSize());
+  {
+    if (s_delta_state_enabled)
+      p.DoArrayPages(m_pEXRAM, GetExRamSize(), s_state_page_size, s_state_exram_pages);
+    else
+      p.DoBulkArray(m_pEXRAM, GetExRamSize());
+  }
   p.DoMarker("Memory EXRAM");
 }
 
 void Shutdown()
 {
+  {
+    std::lock_guard lock(s_write_tracking_mutex);
+    ResetWriteTracking();
+    s_write_tracking_enabled = false;
+    s_tracked_since.clear();
+  }
   ShutdownFastmemArena();
 
   m_IsInitialized = false;
@@ -426,6 +730,9 @@ void ShutdownFastmemArena()
   if (!is_fastmem_arena_initialized)
     return;
 
+  std::lock_guard lock(s_write_tracking_mutex);
+  ResetWriteTracking();
+
   u32 flags = GetFlags();
   for (PhysicalMemoryRegion& region : physical_regions)
   {
@@ -436,11 +743,14 @@ void ShutdownFastmemArena()
     g_arena.ReleaseView(base, region.size);
   }
 
+  UnmapLogicalPagesLocked(0, 0);
+
   for (auto& entry : logical_mapped_entries)
   {
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
   }
   logical_mapped_entries.clear();
+  logical_mapped_dbat_table = {};
 
   physical_base = nullptr;
   logical_base = nullptr;
@@ -448,6 +758,322 @@ void ShutdownFastmemArena()
   is_fastmem_arena_initialized = false;
 }
 
+// Only RAM and EXRAM can be tracked, which are the first and last of the physical regions.
+static bool IsTrackableRegion(const PhysicalMemoryRegion& region)
+{
+  return region.out_pointer == &m_pRAM || region.out_pointer == &m_pEXRAM;
+}
+
+// Calls func for every host range which the given range of the shared memory segment is visible
+// through. The range must be within a single physical region.
+template <typename F>
+static void ForEachView(u32 shm_position, u32 size, F func)
+{
+  const u32 flags = GetFlags();
+  for (const PhysicalMemoryRegion& region : physical_regions)
+  {
+    if ((flags & region.flags) != region.flags || shm_position < region.shm_position ||
+        shm_position - region.shm_position >= region.size)
+    {
+      continue;
+    }
+
+    const u32 offset = shm_position - region.shm_position;
+    func(*region.out_pointer + offset, size);
+    if (is_fastmem_arena_initialized)
+      func(physical_base + region.physical_address + offset, size);
+  }
+
+  for (const LogicalMemoryView& view : logical_mapped_entries)
+  {
+    if (view.read_only)
+      continue;
+
+    const u32 start = std::max(shm_position, view.shm_position);
+    const u32 end = std::min(shm_position + size, view.shm_position + view.mapped_size);
+    if (start < end)
+      func(static_cast<u8*>(view.mapped_pointer) + (start - view.shm_position), end - start);
+  }
+}
+
+static void ProtectView(u8* pointer, u32 size)
+{
+  Common::WriteProtectMemory(pointer, size);
+}
+
+static void UnprotectView(u8* pointer, u32 size)
+{
+  Common::UnWriteProtectMemory(pointer, size);
+}
+
+static void UntrackPage(u32 page)
+{
+  ForEachView(page * s_write_tracking_page_size, s_write_tracking_page_size, UnprotectView);
+  if (s_tracked_since[page] != 0)
+  {
+    s_tracked_since[page] = 0;
+    --s_num_tracked_pages;
+  }
+}
+
+// Must be called with s_write_tracking_mutex held.
+static void ResetWriteTracking()
+{
+  if (s_num_tracked_pages == 0)
+    return;
+
+  const u32 flags = GetFlags();
+  for (const PhysicalMemoryRegion& region : physical_regions)
+  {
+    if ((flags & region.flags) == region.flags && IsTrackableRegion(region))
+      ForEachView(region.shm_position, region.size, UnprotectView);
+  }
+  std::fill(s_tracked_since.begin(), s_tracked_since.end(), 0);
+  s_num_tracked_pages = 0;
+}
+
+// Returns the position in the shared memory segment of a range of RAM or EXRAM, following the
+// same rules as GetPointer.
+static std::optional<u32> GetTrackableShmPosition(u32 address, u32 size)
+{
+  address &= 0x3FFFFFFF;
+  if (address < GetRamSizeReal())
+  {
+    if (size > GetRamSizeReal() - address)
+      return std::nullopt;
+    return physical_regions[0].shm_position + address;
+  }
+
+  if (m_pEXRAM && (address >> 28) == 0x1 && (address & 0x0fffffff) < GetExRamSizeReal())
+  {
+    if (size > GetExRamSizeReal() - (address & 0x0fffffff))
+      return std::nullopt;
+    return physical_regions[3].shm_position + (address & GetExRamMask());
+  }
+
+  return std::nullopt;
+}
+
+static std::optional<u32> GetTrackableShmPositionOfHostAddress(uintptr_t host_address)
+{
+  const auto get_offset = [host_address](const u8* base, u32 size) -> std::optional<u32> {
+    if (!base || host_address < reinterpret_cast<uintptr_t>(base) ||
+        host_address - reinterpret_cast<uintptr_t>(base) >= size)
+    {
+      return std::nullopt;
+    }
+    return static_cast<u32>(host_address - reinterpret_cast<uintptr_t>(base));
+  };
+
+  const u32 flags = GetFlags();
+  for (const PhysicalMemoryRegion& region : physical_regions)
+  {
+    if ((flags & region.flags) != region.flags || !IsTrackableRegion(region))
+      continue;
+
+    std::optional<u32> offset = get_offset(*region.out_pointer, region.size);
+    if (!offset && is_fastmem_arena_initialized)
+      offset = get_offset(physical_base + region.physical_address, region.size);
+    if (offset)
+      return region.shm_position + *offset;
+  }
+
+  for (const LogicalMemoryView& view : logical_mapped_entries)
+  {
+    const std::optional<u32> offset =
+        get_offset(static_cast<const u8*>(view.mapped_pointer), view.mapped_size);
+    if (!offset)
+      continue;
+
+    // Writes to these fault because of a memcheck, which the JIT has to handle.
+    if (view.read_only)
+      return std::nullopt;
+
+    for (const PhysicalMemoryRegion& region : physical_regions)
+    {
+      if ((flags & region.flags) == region.flags && IsTrackableRegion(region) &&
+          view.shm_position >= region.shm_position &&
+          view.shm_position - region.shm_position < region.size)
+      {
+        return view.shm_position + *offset;
+      }
+    }
+    return std::nullopt;
+  }
+
+  return std::nullopt;
+}
+
+void SetWriteTrackingEnabled(bool enabled)
+{
+  std::lock_guard lock(s_write_tracking_mutex);
+  ResetWriteTracking();
+  s_write_tracking_enabled = enabled;
+
+  // The page states are kept after disabling tracking, so faults which raced with it are still
+  // recognized.
+  if (!enabled)
+    return;
+
+  u32 shm_size = 0;
+  const u32 flags = GetFlags();
+  for (const PhysicalMemoryRegion& region : physical_regions)
+  {
+    if ((flags & region.flags) == region.flags)
+      shm_size = std::max(shm_size, region.shm_position + region.size);
+  }
+  s_write_tracking_page_size = static_cast<u32>(Common::MemPageSize());
+  s_tracked_since.assign(shm_size / s_write_tracking_page_size, 0);
+  s_write_tracking_stamp = 0;
+}
+
+u64 TrackWrites(u32 address, u32 size)
+{
+  std::lock_guard lock(s_write_tracking_mutex);
+
+  // Pages mapped through the page table would need to be protected one by one in each of their
+  // logical mappings, which isn't worth it.
+  if (!s_write_tracking_enabled || size == 0 || !logical_mapped_pages.empty())
+    return 0;
+
+  const std::optional<u32> position = GetTrackableShmPosition(address, size);
+  if (!position)
+    return 0;
+
+  const u32 first_page = *position / s_write_tracking_page_size;
+  const u32 last_page = (*position + size - 1) / s_write_tracking_page_size;
+  const u64 stamp = ++s_write_tracking_stamp;
+
+  // Protect consecutive untracked pages together, to keep the number of calls down.
+  u32 page = first_page;
+  while (page <= last_page)
+  {
+    if (s_tracked_since[page] != 0)
+    {
+      ++page;
+      continue;
+    }
+
+    const u32 run_start = page;
+    for (; page <= last_page && s_tracked_since[page] == 0; ++page)
+      s_tracked_since[page] = stamp;
+    s_num_tracked_pages += page - run_start;
+    ForEachView(run_start * s_write_tracking_page_size,
+                (page - run_start) * s_write_tracking_page_size, ProtectView);
+  }
+
+  return stamp;
+}
+
+// Must be called with s_write_tracking_mutex held.
+static bool IsUnmodifiedSinceLocked(u32 address, u32 size, u64 stamp)
+{
+  if (!s_write_tracking_enabled || stamp == 0 || size == 0)
+    return false;
+
+  const std::optional<u32> position = GetTrackableShmPosition(address, size);
+  if (!position)
+    return false;
+
+  const u32 first_page = *position / s_write_tracking_page_size;
+  const u32 last_page = (*position + size - 1) / s_write_tracking_page_size;
+  for (u32 page = first_page; page <= last_page; ++page)
+  {
+    if (s_tracked_since[page] == 0 || s_tracked_since[page] > stamp)
+      return false;
+  }
+  return true;
+}
+
+bool IsUnmodifiedSince(u32 address, u32 size, u64 stamp)
+{
+  std::lock_guard lock(s_write_tracking_mutex);
+  return IsUnmodifiedSinceLocked(address, size, stamp);
+}
+
+void UntrackWrites(u32 address, u32 size)
+{
+  std::lock_guard lock(s_write_tracking_mutex);
+  if (!s_write_tracking_enabled || s_num_tracked_pages == 0 || size == 0)
+    return;
+
+  const std::optional<u32> position = GetTrackableShmPosition(address, size);
+  if (!position)
+    return;
+
+  const u32 first_page = *position / s_write_tracking_page_size;
+  const u32 last_page = (*position + size - 1) / s_write_tracking_page_size;
+  for (u32 page = first_page; page <= last_page; ++page)
+  {
+    if (s_tracked_since[page] != 0)
+      UntrackPage(page);
+  }
+}
+
+bool HandleWriteTrackingFault(uintptr_t fault_address)
+{
+  std::lock_guard lock(s_write_tracking_mutex);
+  if (s_tracked_since.empty())
+    return false;
+
+  const std::optional<u32> position = GetTrackableShmPositionOfHostAddress(fault_address);
+  if (!position)
+    return false;
+
+  // Views of RAM are otherwise always writable, so even if the page isn't tracked (anymore), the
+  // fault came from tracking, e.g. if another thread untracked the page first. Unprotecting it
+  // again is harmless either way.
+  UntrackPage(*position / s_write_tracking_page_size);
+  return true;
+}
+
+void ResetStateDirtyPages()
+{
+  // Tracking a range never moves the stamps of pages that are already tracked forward, so the
+  // stamp from EXRAM covers RAM as well.
+  s_state_base_stamp = TrackWrites(0, GetRamSizeReal());
+  if (s_state_base_stamp != 0 && m_pEXRAM)
+    s_state_base_stamp = TrackWrites(0x10000000, GetExRamSizeReal());
+}
+
+// Must be called with s_write_tracking_mutex held.
+static std::vector<u32> GetStateDirtyPages(u32 address, u32 size, u32 refresh_period,
+                                           u32 refresh_slice)
+{
+  std::vector<u32> pages;
+  for (u32 page = 0; u64(page) * s_state_page_size < size; ++page)
+  {
+    // Pages outside of the real memory size can't be tracked, so they always count as dirty
+    const u32 offset = page * s_state_page_size;
+    if ((refresh_period != 0 && page % refresh_period == refresh_slice) ||
+        !IsUnmodifiedSinceLocked(address + offset, std::min(s_state_page_size, size - offset),
+                                 s_state_base_stamp))
+    {
+      pages.push_back(page);
+    }
+  }
+  return pages;
+}
+
+void SetDeltaStateEnabled(bool enabled, u32 refresh_period, u32 refresh_slice)
+{
+  s_delta_state_enabled = enabled;
+  s_state_ram_pages.clear();
+  s_state_exram_pages.clear();
+  if (!enabled)
+    return;
+
+  std::lock_guard lock(s_write_tracking_mutex);
+  s_state_page_size = s_write_tracking_page_size != 0 ? s_write_tracking_page_size :
+                                                        static_cast<u32>(Common::MemPageSize());
+  s_state_ram_pages = GetStateDirtyPages(0, GetRamSize(), refresh_period, refresh_slice);
+  if (m_pEXRAM)
+  {
+    s_state_exram_pages =
+        GetStateDirtyPages(0x10000000, GetExRamSize(), refresh_period, refresh_slice);
+  }
+}
+
 void Clear()
 {
   if (m_pRAM)
@@ -69,8 +69,40 @@ void DoState(PointerWrap& p);
 
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table);
 
+// Page table translations aren't known ahead of time, so pages translated through the page table
+// are mapped into the logical fastmem area one 4 KiB page at a time as fastmem accesses to them
+// fault. A read-only page which is mapped again as writable is replaced.
+bool MapLogicalPage(u32 logical_address, u32 physical_address, bool writable);
+bool IsLogicalPageMapped(u32 logical_address);
+// Unmaps the pages mapped by MapLogicalPage whose page number matches index under mask.
+void UnmapLogicalPages(u32 mask = 0, u32 index = 0);
+
 void Clear();
 
+// Write tracking lets other threads, in particular the GPU thread, find out whether memory they
+// have looked at before is unmodified without reading it again. Tracked pages of RAM and EXRAM are
+// write protected, and the first write to each of them is caught by the fault handler in MemTools,
+// which has to be installed while tracking is enabled.
+void SetWriteTrackingEnabled(bool enabled);
+// Starts tracking writes to a range of physical memory. Returns a stamp for IsUnmodifiedSince, or 0
+// if the range can't be tracked.
+u64 TrackWrites(u32 address, u32 size);
+bool IsUnmodifiedSince(u32 address, u32 size, u64 stamp);
+// Writes by the host OS, e.g. reading a file or socket directly into emulated memory, fail rather
+// than fault on protected pages, so the range has to be untracked before.
+void UntrackWrites(u32 address, u32 size);
+// Returns true if the fault was caused by a write to a tracked page, which is writable afterwards.
+bool HandleWriteTrackingFault(uintptr_t fault_address);
+
+// Delta savestates only contain the pages of RAM and EXRAM which were written since the previous
+// state was saved or loaded. ResetStateDirtyPages marks all pages as clean by write tracking them,
+// so all pages count as dirty if write tracking isn't available. While delta states are enabled,
+// DoState only saves the pages which were dirty when they were enabled, and on load only
+// overwrites the pages that were saved. With a refresh period, every refresh_period-th page
+// starting at refresh_slice is saved too, whether it's dirty or not.
+void ResetStateDirtyPages();
+void SetDeltaStateEnabled(bool enabled, u32 refresh_period = 0, u32 refresh_slice = 0);
+
 // Routines to access physically addressed memory, designed for use by
 // emulated hardware outside the CPU. Use "Device_" prefix.
 std::string GetString(u32 em_address, size_t size = 0);
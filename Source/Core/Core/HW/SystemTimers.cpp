@@ -66,6 +66,7 @@ IPC_HLE_PERIOD: For the Wii Remote this is the call schedule:
 #include "Core/PatchEngine.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/FrameTimeBreakdown.h"
 
 namespace SystemTimers
 {
@@ -175,7 +176,8 @@ void ThrottleCallback(u64 last_time, s64 cyclesLate)
 
   s64 diff = last_time - time;
   const SConfig& config = SConfig::GetInstance();
-  bool frame_limiter = config.m_EmulationSpeed > 0.0f && !Core::GetIsThrottlerTempDisabled();
+  bool frame_limiter = config.m_EmulationSpeed > 0.0f && !Core::GetIsThrottlerTempDisabled() &&
+                       !Core::IsPresentationSuppressed();
   u32 next_event = GetTicksPerSecond() / 1000;
 
   {
@@ -198,6 +200,8 @@ void ThrottleCallback(u64 last_time, s64 cyclesLate)
     }
     else if (diff > 1000)
     {
+      const FrameTimeBreakdown::ScopedCategory breakdown_category(
+          FrameTimeBreakdown::Category::CPUWait);
       Common::SleepCurrentThread(diff / 1000);
       s_time_spent_sleeping += Common::Timer::GetTimeUs() - time;
     }
@@ -22,6 +22,7 @@ void CameraLogic::Reset()
   m_reg_data = {};
 
   m_is_enabled = false;
+  m_is_cached_data_valid = false;
 }
 
 void CameraLogic::DoState(PointerWrap& p)
@@ -70,9 +71,16 @@ void CameraLogic::Update(const Common::Matrix44& transform, Common::Vec2 field_o
   if (!IOS::g_gpio_out[IOS::GPIO::SENSOR_BAR])
     return;
 
+  if (m_is_cached_data_valid && m_cached_mode == m_reg_data.mode &&
+      m_cached_fov.x == field_of_view.x && m_cached_fov.y == field_of_view.y &&
+      m_cached_transform == transform.data)
+  {
+    data = m_cached_camera_data;
+    return;
+  }
+
   using Common::Matrix33;
   using Common::Matrix44;
-  using Common::Vec3;
   using Common::Vec4;
 
   // FYI: A real wiimote normally only returns 1 point for each LED cluster (2 total).
@@ -83,14 +91,27 @@ void CameraLogic::Update(const Common::Matrix44& transform, Common::Vec2 field_o
   // This is reduced based on distance from sensor bar.
   constexpr int MAX_POINT_SIZE = 15;
 
-  const std::array<Vec3, NUM_POINTS> leds{
-      Vec3{-SENSOR_BAR_LED_SEPARATION / 2, 0, 0},
-      Vec3{SENSOR_BAR_LED_SEPARATION / 2, 0, 0},
+  if (m_projection_fov.x != field_of_view.x || m_projection_fov.y != field_of_view.y)
+  {
+    m_projection =
+        Matrix44::Perspective(field_of_view.y, field_of_view.x / field_of_view.y, 0.001f, 1000) *
+        Matrix44::FromMatrix33(Matrix33::RotateX(float(MathUtil::TAU / 4)));
+    m_projection_fov = field_of_view;
+  }
+
+  // The LEDs lie on the x axis of the sensor bar, so rather than transforming each of them, the
+  // bar's origin and x axis are projected and the LEDs are offset from one along the other.
+  const auto project_column = [&](int column) {
+    const auto& t = transform.data;
+    return m_projection * Vec4(t[column], t[4 + column], t[8 + column], t[12 + column]);
   };
+  const Vec4 center = project_column(3);
+  const Vec4 axis = project_column(0) * (SENSOR_BAR_LED_SEPARATION / 2);
 
-  const auto camera_view =
-      Matrix44::Perspective(field_of_view.y, field_of_view.x / field_of_view.y, 0.001f, 1000) *
-      Matrix44::FromMatrix33(Matrix33::RotateX(float(MathUtil::TAU / 4))) * transform;
+  const std::array<Vec4, NUM_POINTS> leds{
+      Vec4{center.x - axis.x, center.y - axis.y, center.z - axis.z, center.w - axis.w},
+      Vec4{center.x + axis.x, center.y + axis.y, center.z + axis.z, center.w + axis.w},
+  };
 
   struct CameraPoint
   {
@@ -98,11 +119,9 @@ void CameraLogic::Update(const Common::Matrix44& transform, Common::Vec2 field_o
     u8 size;
   };
 
-  std::array<CameraPoint, leds.size()> camera_points;
-
-  std::transform(leds.begin(), leds.end(), camera_points.begin(), [&](const Vec3& v) {
-    const auto point = camera_view * Vec4(v, 1.0);
+  std::array<CameraPoint, NUM_POINTS> camera_points;
 
+  std::transform(leds.begin(), leds.end(), camera_points.begin(), [&](const Vec4& point) {
     // Check if LED is behind camera.
     if (point.z > 0)
     {
@@ -187,6 +206,12 @@ void CameraLogic::Update(const Common::Matrix44& transform, Common::Vec2 field_o
     // WARN_LOG(WIIMOTE, "Game is requesting IR data before setting IR mode.");
     break;
   }
+
+  m_is_cached_data_valid = true;
+  m_cached_transform = transform.data;
+  m_cached_fov = field_of_view;
+  m_cached_mode = m_reg_data.mode;
+  m_cached_camera_data = data;
 }
 
 void CameraLogic::SetEnabled(bool is_enabled)
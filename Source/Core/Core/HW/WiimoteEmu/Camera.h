@@ -161,5 +161,17 @@ private:
   // When disabled the camera does not respond on the bus.
   // Change is triggered by wiimote report 0x13.
   bool m_is_enabled;
+
+  // Perspective projection and rotation of the camera, which only change with the field of view.
+  Common::Matrix44 m_projection;
+  Common::Vec2 m_projection_fov{};
+
+  // The camera usually sees the same thing for many reports in a row, e.g. while the pointer is
+  // held still, so the IR data is reused as long as the inputs it was computed from don't change.
+  bool m_is_cached_data_valid = false;
+  std::array<float, 16> m_cached_transform{};
+  Common::Vec2 m_cached_fov{};
+  u8 m_cached_mode = 0;
+  std::array<u8, CAMERA_DATA_BYTES> m_cached_camera_data{};
 };
 }  // namespace WiimoteEmu
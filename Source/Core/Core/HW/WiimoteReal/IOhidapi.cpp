@@ -3,10 +3,14 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <utility>
 
 #include "Common/Assert.h"
 #include "Common/Logging/Log.h"
 #include "Common/StringUtil.h"
+#include "Common/Thread.h"
 #include "Core/HW/WiimoteCommon/WiimoteHid.h"
 #include "Core/HW/WiimoteReal/IOhidapi.h"
 
@@ -104,12 +108,24 @@ bool WiimoteHidapi::ConnectInternal()
                   "Could not connect to Wii Remote at \"{}\". "
                   "Do you have permission to access the device?",
                   m_device_path);
+    return false;
   }
-  return m_handle != nullptr;
+
+  m_read_failed.Clear();
+  m_read_thread_running.Set();
+  m_read_thread = std::thread(&WiimoteHidapi::ReadThreadFunc, this);
+  return true;
 }
 
 void WiimoteHidapi::DisconnectInternal()
 {
+  if (m_read_thread.joinable())
+  {
+    m_read_thread_running.Clear();
+    m_read_thread.join();
+  }
+  m_hid_reports.Clear();
+
   hid_close(m_handle);
   m_handle = nullptr;
 }
@@ -119,22 +135,50 @@ bool WiimoteHidapi::IsConnected() const
   return m_handle != nullptr;
 }
 
-int WiimoteHidapi::IORead(u8* buf)
+void WiimoteHidapi::ReadThreadFunc()
 {
-  int timeout = 200;  // ms
-  int result = hid_read_timeout(m_handle, buf + 1, MAX_PAYLOAD - 1, timeout);
-  // TODO: If and once we use hidapi across plaforms, change our internal API to clean up this mess.
-  if (result == -1)
+  Common::SetCurrentThreadName("Wiimote hidapi Read Thread");
+
+  while (m_read_thread_running.IsSet())
   {
-    ERROR_LOG_FMT(WIIMOTE, "Failed to read from {}.", m_device_path);
-    return 0;  // error
+    // The timeout is only there to notice when the thread should stop.
+    Report report(MAX_PAYLOAD);
+    const int result = hid_read_timeout(m_handle, report.data() + 1, MAX_PAYLOAD - 1, 200);
+    if (result == -1)
+    {
+      ERROR_LOG_FMT(WIIMOTE, "Failed to read from {}.", m_device_path);
+      m_read_failed.Set();
+      m_read_event.Set();
+      return;
+    }
+    if (result == 0)
+      continue;
+
+    report[0] = WR_SET_REPORT | BT_INPUT;
+    report.resize(result + 1);
+    m_hid_reports.Push(std::move(report));
+    m_read_event.Set();
   }
-  if (result == 0)
+}
+
+void WiimoteHidapi::IOWakeup()
+{
+  m_read_event.Set();
+}
+
+int WiimoteHidapi::IORead(u8* buf)
+{
+  // TODO: If and once we use hidapi across plaforms, change our internal API to clean up this mess.
+  Report report;
+  if (!m_hid_reports.Pop(report))
   {
-    return -1;  // didn't read packet
+    m_read_event.WaitFor(std::chrono::milliseconds(200));
+    if (!m_hid_reports.Pop(report))
+      return m_read_failed.IsSet() ? 0 : -1;  // error, or didn't read packet
   }
-  buf[0] = WR_SET_REPORT | BT_INPUT;
-  return result + 1;  // number of bytes read
+
+  std::memcpy(buf, report.data(), report.size());
+  return static_cast<int>(report.size());  // number of bytes read
 }
 
 int WiimoteHidapi::IOWrite(const u8* buf, size_t len)
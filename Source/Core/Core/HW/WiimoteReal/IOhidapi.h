@@ -5,8 +5,14 @@
 #pragma once
 
 #ifdef HAVE_HIDAPI
+#include <string>
+#include <thread>
+
 #include <hidapi.h>
 
+#include "Common/Event.h"
+#include "Common/Flag.h"
+#include "Common/SPSCQueue.h"
 #include "Core/HW/WiimoteReal/WiimoteReal.h"
 
 namespace WiimoteReal
@@ -22,13 +28,24 @@ protected:
   bool ConnectInternal() override;
   void DisconnectInternal() override;
   bool IsConnected() const override;
-  void IOWakeup() override {}
+  void IOWakeup() override;
   int IORead(u8* buf) override;
   int IOWrite(const u8* buf, size_t len) override;
 
 private:
+  void ReadThreadFunc();
+
   std::string m_device_path;
   hid_device* m_handle = nullptr;
+
+  // hidapi can't wait for a report and for a wakeup at the same time, so reports are read on a
+  // separate thread and IORead only waits for this event. That way, reports that are queued
+  // while waiting for input get written right away instead of after the read times out.
+  std::thread m_read_thread;
+  Common::Flag m_read_thread_running;
+  Common::Flag m_read_failed;
+  Common::Event m_read_event;
+  Common::SPSCQueue<Report, false> m_hid_reports;
 };
 
 class WiimoteScannerHidapi final : public WiimoteScannerBackend
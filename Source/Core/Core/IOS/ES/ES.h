@@ -12,6 +12,7 @@
 #include "Common/CommonTypes.h"
 #include "Core/IOS/Device.h"
 #include "Core/IOS/ES/Formats.h"
+#include "Core/IOS/ES/NandIndex.h"
 #include "Core/IOS/FS/FileSystem.h"
 #include "Core/IOS/IOS.h"
 #include "Core/IOS/IOSC.h"
@@ -384,5 +385,7 @@ private:
 
   ContextArray m_contexts;
   TitleContext m_title_context{};
+  // Only a cache, so it's fine for it to be filled from const functions.
+  mutable IOS::ES::NandIndex m_nand_index;
 };
 }  // namespace IOS::HLE::Device
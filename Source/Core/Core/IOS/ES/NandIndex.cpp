@@ -0,0 +1,222 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/IOS/ES/NandIndex.h"
+
+#include <ctime>
+#include <utility>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "Core/IOS/FS/FileSystem.h"
+
+namespace IOS::ES
+{
+static constexpr u32 INDEX_REVISION = 1;
+// Content hashes are only dropped when the whole index is, so this keeps the index from growing
+// forever when titles keep being installed and deleted.
+static constexpr size_t MAX_CONTENT_HASHES = 4096;
+
+template <typename V, typename Functor>
+static void DoMap(PointerWrap& p, std::map<std::string, V>& map, Functor do_value)
+{
+  u32 count = static_cast<u32>(map.size());
+  p.Do(count);
+
+  if (p.GetMode() == PointerWrap::MODE_READ)
+  {
+    map.clear();
+    for (u32 i = 0; i < count; ++i)
+    {
+      std::string key;
+      p.Do(key);
+      V value{};
+      do_value(p, value);
+      map.emplace(std::move(key), std::move(value));
+    }
+  }
+  else
+  {
+    for (auto& [key, value] : map)
+    {
+      std::string key_copy = key;
+      p.Do(key_copy);
+      do_value(p, value);
+    }
+  }
+}
+
+NandIndex::NandIndex() : m_nand_root(File::GetUserPath(D_SESSION_WIIROOT_IDX))
+{
+  // Temporary NAND roots (such as the ones used for NetPlay) only get an index in memory.
+  if (m_nand_root != File::GetUserPath(D_WIIROOT_IDX))
+    return;
+
+  m_path = File::GetUserPath(D_CACHE_IDX) + "NandIndex.cache";
+  if (!SyncCacheFile(false))
+  {
+    m_title_lists.clear();
+    m_content_hashes.clear();
+  }
+}
+
+NandIndex::~NandIndex()
+{
+  if (m_dirty && !m_path.empty())
+    SyncCacheFile(true);
+}
+
+std::optional<s64> NandIndex::GetStableModificationTime(HLE::FS::FileSystem* fs,
+                                                        const std::string& path)
+{
+  const HLE::FS::Result<s64> time = fs->GetModificationTime(path);
+  if (!time || *time >= static_cast<s64>(std::time(nullptr)))
+    return std::nullopt;
+  return *time;
+}
+
+std::optional<std::vector<u64>> NandIndex::GetTitles(HLE::FS::FileSystem* fs,
+                                                     const std::string& directory)
+{
+  const auto it = m_title_lists.find(directory);
+  if (it == m_title_lists.end())
+    return std::nullopt;
+
+  for (const Source& source : it->second.sources)
+  {
+    const HLE::FS::Result<s64> time = fs->GetModificationTime(source.path);
+    if (!time || *time != source.modification_time)
+      return std::nullopt;
+  }
+
+  return it->second.titles;
+}
+
+void NandIndex::SetTitles(HLE::FS::FileSystem* fs, const std::string& directory,
+                          const std::vector<std::string>& sources, const std::vector<u64>& titles)
+{
+  TitleList list;
+  for (const std::string& path : sources)
+  {
+    const std::optional<s64> time = GetStableModificationTime(fs, path);
+    if (!time)
+    {
+      m_dirty |= m_title_lists.erase(directory) != 0;
+      return;
+    }
+    list.sources.push_back({path, *time});
+  }
+
+  list.titles = titles;
+  m_title_lists[directory] = std::move(list);
+  m_dirty = true;
+}
+
+std::optional<NandIndex::Hash> NandIndex::GetContentHash(HLE::FS::FileSystem* fs,
+                                                         const std::string& path, u32 size)
+{
+  const auto it = m_content_hashes.find(path);
+  if (it == m_content_hashes.end() || it->second.size != size)
+    return std::nullopt;
+
+  const HLE::FS::Result<s64> time = fs->GetModificationTime(path);
+  if (!time || *time != it->second.modification_time)
+    return std::nullopt;
+
+  return it->second.hash;
+}
+
+void NandIndex::SetContentHash(HLE::FS::FileSystem* fs, const std::string& path, u32 size,
+                               const Hash& hash)
+{
+  const std::optional<s64> time = GetStableModificationTime(fs, path);
+  if (!time)
+    return;
+
+  if (m_content_hashes.size() >= MAX_CONTENT_HASHES)
+    m_content_hashes.clear();
+
+  m_content_hashes[path] = {*time, size, hash};
+  m_dirty = true;
+}
+
+bool NandIndex::SyncCacheFile(bool save)
+{
+  if (save)
+  {
+    // Measure the size of the buffer.
+    u8* ptr = nullptr;
+    PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+    DoState(p);
+    const size_t buffer_size = reinterpret_cast<size_t>(ptr);
+
+    // Then actually do the write.
+    std::vector<u8> buffer(buffer_size);
+    ptr = buffer.data();
+    p.SetMode(PointerWrap::MODE_WRITE);
+    DoState(p, buffer_size);
+
+    // Several IOS instances (for example emulation and the NAND tools) might write the index,
+    // so only replace it once the new one is complete.
+    const std::string temp_path = m_path + ".tmp";
+    if (!File::IOFile(temp_path, "wb").WriteBytes(buffer.data(), buffer.size()) ||
+        !File::Rename(temp_path, m_path))
+    {
+      WARN_LOG_FMT(IOS_ES, "Failed to write the NAND index to {}", m_path);
+      return false;
+    }
+    m_dirty = false;
+    return true;
+  }
+
+  File::IOFile f(m_path, "rb");
+  if (!f)
+    return false;
+
+  std::vector<u8> buffer(f.GetSize());
+  if (buffer.empty() || !f.ReadBytes(buffer.data(), buffer.size()))
+    return false;
+
+  u8* ptr = buffer.data();
+  PointerWrap p(&ptr, PointerWrap::MODE_READ);
+  DoState(p, buffer.size());
+  return p.GetMode() == PointerWrap::MODE_READ;
+}
+
+void NandIndex::DoState(PointerWrap& p, u64 size)
+{
+  struct
+  {
+    u32 revision;
+    u64 expected_size;
+  } header = {INDEX_REVISION, size};
+  p.Do(header);
+  if (p.GetMode() == PointerWrap::MODE_READ &&
+      (header.revision != INDEX_REVISION || header.expected_size != size))
+  {
+    p.SetMode(PointerWrap::MODE_MEASURE);
+    return;
+  }
+
+  std::string nand_root = m_nand_root;
+  p.Do(nand_root);
+  if (p.GetMode() == PointerWrap::MODE_READ && nand_root != m_nand_root)
+  {
+    p.SetMode(PointerWrap::MODE_MEASURE);
+    return;
+  }
+
+  DoMap(p, m_title_lists, [](PointerWrap& state, TitleList& list) {
+    state.DoEachElement(list.sources, [](PointerWrap& source_state, Source& source) {
+      source_state.Do(source.path);
+      source_state.Do(source.modification_time);
+    });
+    state.Do(list.titles);
+  });
+  DoMap(p, m_content_hashes, [](PointerWrap& state, ContentHash& hash) { state.Do(hash); });
+}
+}  // namespace IOS::ES
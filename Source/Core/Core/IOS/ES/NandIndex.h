@@ -0,0 +1,83 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+class PointerWrap;
+
+namespace IOS::HLE::FS
+{
+class FileSystem;
+}
+
+namespace IOS::ES
+{
+// A persistent cache of what ES would otherwise have to scan the NAND for every time: the lists
+// of titles in /title, /import and /ticket, and the hashes of content files.
+//
+// Every entry remembers the modification times of the directories or the file it was built from,
+// and is only used while those are unchanged. Since modification times only have a resolution of
+// a second, nothing is cached that was modified during the current second.
+class NandIndex
+{
+public:
+  using Hash = std::array<u8, 20>;
+
+  // Loads the index from the user cache directory, if it was made for the current NAND root.
+  NandIndex();
+  // Writes the index back if anything changed.
+  ~NandIndex();
+
+  NandIndex(const NandIndex&) = delete;
+  NandIndex& operator=(const NandIndex&) = delete;
+
+  std::optional<std::vector<u64>> GetTitles(HLE::FS::FileSystem* fs, const std::string& directory);
+  // `sources` are all the directories that were listed to find the titles.
+  void SetTitles(HLE::FS::FileSystem* fs, const std::string& directory,
+                 const std::vector<std::string>& sources, const std::vector<u64>& titles);
+
+  std::optional<Hash> GetContentHash(HLE::FS::FileSystem* fs, const std::string& path, u32 size);
+  void SetContentHash(HLE::FS::FileSystem* fs, const std::string& path, u32 size,
+                      const Hash& hash);
+
+private:
+  struct Source
+  {
+    std::string path;
+    s64 modification_time;
+  };
+
+  struct TitleList
+  {
+    std::vector<Source> sources;
+    std::vector<u64> titles;
+  };
+
+  struct ContentHash
+  {
+    s64 modification_time;
+    u32 size;
+    Hash hash;
+  };
+
+  std::optional<s64> GetStableModificationTime(HLE::FS::FileSystem* fs, const std::string& path);
+
+  bool SyncCacheFile(bool save);
+  void DoState(PointerWrap& p, u64 size = 0);
+
+  std::string m_path;
+  std::string m_nand_root;
+  std::map<std::string, TitleList> m_title_lists;
+  std::map<std::string, ContentHash> m_content_hashes;
+  bool m_dirty = false;
+};
+}  // namespace IOS::ES
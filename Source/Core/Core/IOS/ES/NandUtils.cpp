@@ -7,6 +7,7 @@
 #include <cctype>
 #include <functional>
 #include <iterator>
+#include <optional>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -20,6 +21,7 @@
 #include "Common/StringUtil.h"
 #include "Core/IOS/ES/ES.h"
 #include "Core/IOS/ES/Formats.h"
+#include "Core/IOS/ES/NandIndex.h"
 #include "Core/IOS/Uids.h"
 
 namespace IOS::HLE::Device
@@ -70,8 +72,12 @@ static bool IsValidPartOfTitleID(const std::string& string)
                      [](const auto character) { return std::isxdigit(character) != 0; });
 }
 
-static std::vector<u64> GetTitlesInTitleOrImport(FS::FileSystem* fs, const std::string& titles_dir)
+static std::vector<u64> GetTitlesInTitleOrImport(FS::FileSystem* fs, IOS::ES::NandIndex& index,
+                                                 const std::string& titles_dir)
 {
+  if (auto cached_title_ids = index.GetTitles(fs, titles_dir))
+    return std::move(*cached_title_ids);
+
   const auto entries = fs->ReadDirectory(PID_KERNEL, PID_KERNEL, titles_dir);
   if (!entries)
   {
@@ -80,6 +86,7 @@ static std::vector<u64> GetTitlesInTitleOrImport(FS::FileSystem* fs, const std::
   }
 
   std::vector<u64> title_ids;
+  std::vector<std::string> listed_dirs{titles_dir};
 
   // The /title and /import directories contain one directory per title type, and each of them has
   // a directory per title (where the name is the low 32 bits of the title ID in %08x format).
@@ -92,6 +99,7 @@ static std::vector<u64> GetTitlesInTitleOrImport(FS::FileSystem* fs, const std::
     const auto title_entries = fs->ReadDirectory(PID_KERNEL, PID_KERNEL, title_dir);
     if (!title_entries)
       continue;
+    listed_dirs.push_back(title_dir);
 
     for (const std::string& title_identifier : *title_entries)
     {
@@ -109,22 +117,28 @@ static std::vector<u64> GetTitlesInTitleOrImport(FS::FileSystem* fs, const std::
     }
   }
 
+  // Whether each title directory really is a directory doesn't need to be tracked separately,
+  // since replacing it changes the modification time of the directory it's in.
+  index.SetTitles(fs, titles_dir, listed_dirs, title_ids);
   return title_ids;
 }
 
 std::vector<u64> ES::GetInstalledTitles() const
 {
-  return GetTitlesInTitleOrImport(m_ios.GetFS().get(), "/title");
+  return GetTitlesInTitleOrImport(m_ios.GetFS().get(), m_nand_index, "/title");
 }
 
 std::vector<u64> ES::GetTitleImports() const
 {
-  return GetTitlesInTitleOrImport(m_ios.GetFS().get(), "/import");
+  return GetTitlesInTitleOrImport(m_ios.GetFS().get(), m_nand_index, "/import");
 }
 
 std::vector<u64> ES::GetTitlesWithTickets() const
 {
   const auto fs = m_ios.GetFS();
+  if (auto cached_title_ids = m_nand_index.GetTitles(fs.get(), "/ticket"))
+    return std::move(*cached_title_ids);
+
   const auto entries = fs->ReadDirectory(PID_KERNEL, PID_KERNEL, "/ticket");
   if (!entries)
   {
@@ -133,6 +147,7 @@ std::vector<u64> ES::GetTitlesWithTickets() const
   }
 
   std::vector<u64> title_ids;
+  std::vector<std::string> listed_dirs{"/ticket"};
 
   // The /ticket directory contains one directory per title type, and each of them contains
   // one ticket per title (where the name is the low 32 bits of the title ID in %08x format).
@@ -144,6 +159,7 @@ std::vector<u64> ES::GetTitlesWithTickets() const
     const auto sub_entries = fs->ReadDirectory(PID_KERNEL, PID_KERNEL, "/ticket/" + title_type);
     if (!sub_entries)
       continue;
+    listed_dirs.push_back("/ticket/" + title_type);
 
     for (const std::string& file_name : *sub_entries)
     {
@@ -161,6 +177,7 @@ std::vector<u64> ES::GetTitlesWithTickets() const
     }
   }
 
+  m_nand_index.SetTitles(fs.get(), "/ticket", listed_dirs, title_ids);
   return title_ids;
 }
 
@@ -194,11 +211,16 @@ ES::GetStoredContentsFromTMD(const IOS::ES::TMDReader& tmd,
                    return true;
 
                  // Otherwise, check whether the installed content SHA1 matches the expected hash.
-                 std::vector<u8> content_data(file->GetStatus()->size);
+                 const u32 size = file->GetStatus()->size;
+                 if (const auto cached_sha1 = m_nand_index.GetContentHash(fs.get(), path, size))
+                   return *cached_sha1 == content.sha1;
+
+                 std::vector<u8> content_data(size);
                  if (!file->Read(content_data.data(), content_data.size()))
                    return false;
                  std::array<u8, 20> sha1{};
                  mbedtls_sha1_ret(content_data.data(), content_data.size(), sha1.data());
+                 m_nand_index.SetContentHash(fs.get(), path, size, sha1);
                  return sha1 == content.sha1;
                });
 
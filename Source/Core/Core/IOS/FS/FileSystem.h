@@ -188,6 +188,8 @@ public:
   virtual ~FileSystem() = default;
 
   virtual void DoState(PointerWrap& p) = 0;
+  /// Called regularly while IOS is running, e.g. to write out cached changes.
+  virtual void Update() = 0;
 
   /// Format the file system.
   virtual ResultCode Format(Uid uid) = 0;
@@ -236,6 +238,11 @@ public:
   virtual ResultCode SetMetadata(Uid caller_uid, const std::string& path, Uid uid, Gid gid,
                                  FileAttribute attribute, Modes modes) = 0;
 
+  /// Get the time of the last change to a file or to the list of a directory's children, in
+  /// seconds since the Unix epoch. IOS has no such thing; it is only used to tell whether
+  /// information that Dolphin cached about the NAND is still up to date.
+  virtual Result<s64> GetModificationTime(const std::string& path) = 0;
+
   /// Get usage information about the NAND (block size, cluster and inode counts).
   virtual Result<NandStats> GetNandStats() = 0;
   /// Get usage information about a directory (used cluster and inode counts).
@@ -13,6 +13,7 @@
 #include "Common/ChunkFile.h"
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
+#include "Core/CoreTiming.h"
 #include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
 #include "Core/IOS/FS/FileSystem.h"
@@ -22,10 +23,17 @@ namespace IOS::HLE::Device
 {
 using namespace IOS::HLE::FS;
 
-static IPCCommandResult GetFSReply(s32 return_value, u64 extra_tb_ticks = 0)
+CoreTiming::EventType* FS::s_finish_read_write;
+
+static u64 GetFSReplyDelay(u64 extra_tb_ticks)
 {
   // According to hardware tests, FS takes at least 2700 TB ticks to reply to commands.
-  return {return_value, true, (2700 + extra_tb_ticks) * SystemTimers::TIMER_RATIO};
+  return (2700 + extra_tb_ticks) * SystemTimers::TIMER_RATIO;
+}
+
+static IPCCommandResult GetFSReply(s32 return_value, u64 extra_tb_ticks = 0)
+{
+  return {return_value, true, GetFSReplyDelay(extra_tb_ticks)};
 }
 
 /// Amount of TB ticks required for a superblock write to complete.
@@ -47,10 +55,38 @@ FS::FS(Kernel& ios, const std::string& device_name) : Device(ios, device_name)
 
 void FS::DoState(PointerWrap& p)
 {
+  // Only the results of pending reads and writes are saved, not the host accesses themselves.
+  m_ios.GetFSIOThread().WaitForAll();
+
   p.Do(m_fd_map);
   p.Do(m_cache_fd);
   p.Do(m_cache_chain_index);
   p.Do(m_dirty_cache);
+
+  u32 pending_count = static_cast<u32>(m_pending_read_writes.size());
+  p.Do(pending_count);
+  if (p.GetMode() == PointerWrap::MODE_READ)
+  {
+    m_pending_read_writes.clear();
+    for (u32 i = 0; i < pending_count; ++i)
+    {
+      u32 request_address = 0;
+      p.Do(request_address);
+      PendingReadWrite& pending = m_pending_read_writes[request_address];
+      p.Do(pending.return_value);
+      p.Do(pending.data);
+    }
+  }
+  else
+  {
+    for (auto& [request_address, pending] : m_pending_read_writes)
+    {
+      u32 address = request_address;
+      p.Do(address);
+      p.Do(pending.return_value);
+      p.Do(pending.data);
+    }
+  }
 }
 
 template <typename... Args>
@@ -238,13 +274,8 @@ IPCCommandResult FS::Read(const ReadWriteRequest& request)
   // Simulate the FS read logic to estimate ticks. Note: this must be done before reading.
   const u64 ticks = EstimateTicksForReadWrite(handle, request);
 
-  const Result<u32> result = m_ios.GetFS()->ReadBytesFromFile(
-      handle.fs_fd, Memory::GetPointer(request.buffer), request.size);
-  LogResult(result, "Read({}, 0x{:08x}, {})", handle.name.data(), request.buffer, request.size);
-  if (!result)
-    return GetFSReply(ConvertResult(result.Error()));
-
-  return GetFSReply(*result, ticks);
+  StartReadWrite(request, ticks, {});
+  return GetNoReply();
 }
 
 IPCCommandResult FS::Write(const ReadWriteRequest& request)
@@ -256,13 +287,79 @@ IPCCommandResult FS::Write(const ReadWriteRequest& request)
   // Simulate the FS write logic to estimate ticks. Must be done before writing.
   const u64 ticks = EstimateTicksForReadWrite(handle, request);
 
-  const Result<u32> result = m_ios.GetFS()->WriteBytesToFile(
-      handle.fs_fd, Memory::GetPointer(request.buffer), request.size);
-  LogResult(result, "Write({}, 0x{:08x}, {})", handle.name.data(), request.buffer, request.size);
-  if (!result)
-    return GetFSReply(ConvertResult(result.Error()));
+  // The data has to be taken from emulated memory now, since it may change before the host
+  // write actually happens.
+  std::vector<u8> data(request.size);
+  Memory::CopyFromEmu(data.data(), request.buffer, request.size);
+  StartReadWrite(request, ticks, std::move(data));
+  return GetNoReply();
+}
+
+void FS::StartReadWrite(const ReadWriteRequest& request, u64 ticks, std::vector<u8> data)
+{
+  const Handle& handle = m_fd_map[request.fd];
+  const bool is_write = request.command == IPC_CMD_WRITE;
+
+  PendingReadWrite& pending = m_pending_read_writes[request.address];
+  pending.data = std::move(data);
+
+  auto function = [&pending, fs = m_ios.GetFS(), fd = handle.fs_fd,
+                   name = std::string(handle.name.data()), buffer = request.buffer,
+                   size = request.size, is_write] {
+    Result<u32> result = ResultCode::Invalid;
+    if (is_write)
+    {
+      result = fs->WriteBytesToFile(fd, pending.data.data(), size);
+      pending.data.clear();
+    }
+    else
+    {
+      pending.data.resize(size);
+      result = fs->ReadBytesFromFile(fd, pending.data.data(), size);
+      pending.data.resize(result ? *result : 0);
+    }
+
+    LogResult(result, "{}({}, 0x{:08x}, {})", is_write ? "Write" : "Read", name, buffer, size);
+    pending.return_value = result ? static_cast<s32>(*result) : ConvertResult(result.Error());
+  };
+  pending.ticket = m_ios.GetFSIOThread().Queue(std::move(function));
+
+  CoreTiming::ScheduleEvent(GetFSReplyDelay(ticks), s_finish_read_write, request.address);
+}
+
+void FS::FinishReadWriteCallback(u64 userdata, s64 cycles_late)
+{
+  auto ios = GetIOS();
+  if (!ios)
+    return;
+
+  auto fs = std::static_pointer_cast<FS>(ios->GetDeviceByName("/dev/fs"));
+  if (fs)
+    fs->FinishReadWrite(static_cast<u32>(userdata));
+}
+
+void FS::FinishReadWrite(u32 request_address)
+{
+  const auto it = m_pending_read_writes.find(request_address);
+  if (it == m_pending_read_writes.end())
+  {
+    ERROR_LOG_FMT(IOS_FS, "There is no pending read or write for request {:08x}", request_address);
+    return;
+  }
+
+  // This only blocks if the host is slower than the emulated FS.
+  PendingReadWrite& pending = it->second;
+  m_ios.GetFSIOThread().Wait(pending.ticket);
+
+  const ReadWriteRequest request{request_address};
+  if (!pending.data.empty())
+  {
+    Memory::UntrackWrites(request.buffer, static_cast<u32>(pending.data.size()));
+    Memory::CopyToEmu(request.buffer, pending.data.data(), pending.data.size());
+  }
 
-  return GetFSReply(*result, ticks);
+  m_ios.EnqueueIPCReply(request, pending.return_value);
+  m_pending_read_writes.erase(it);
 }
 
 IPCCommandResult FS::Seek(const SeekRequest& request)
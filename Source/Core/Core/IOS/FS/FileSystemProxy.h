@@ -7,10 +7,12 @@
 #include <array>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Core/IOS/Device.h"
 #include "Core/IOS/FS/FileSystem.h"
+#include "Core/IOS/HostIOThread.h"
 #include "Core/IOS/IOS.h"
 
 class PointerWrap;
@@ -34,6 +36,9 @@ public:
   IPCCommandResult IOCtl(const IOCtlRequest& request) override;
   IPCCommandResult IOCtlV(const IOCtlVRequest& request) override;
 
+  static void FinishReadWriteCallback(u64 userdata, s64 cycles_late);
+  static CoreTiming::EventType* s_finish_read_write;
+
 private:
   struct Handle
   {
@@ -45,6 +50,15 @@ private:
     bool superblock_flush_needed = false;
   };
 
+  // Reads and writes run on the kernel's FS I/O thread, and are replied to once the estimated
+  // time for them has passed. Read data is only copied to emulated memory at that point.
+  struct PendingReadWrite
+  {
+    HostIOThread::Ticket ticket = 0;
+    s32 return_value = 0;
+    std::vector<u8> data;
+  };
+
   enum
   {
     ISFS_IOCTL_FORMAT = 1,
@@ -76,6 +90,9 @@ private:
   IPCCommandResult GetUsage(const Handle& handle, const IOCtlVRequest& request);
   IPCCommandResult Shutdown(const Handle& handle, const IOCtlRequest& request);
 
+  void StartReadWrite(const ReadWriteRequest& request, u64 ticks, std::vector<u8> data);
+  void FinishReadWrite(u32 request_address);
+
   u64 EstimateTicksForReadWrite(const Handle& handle, const ReadWriteRequest& request);
   u64 SimulatePopulateFileCache(u32 fd, u32 offset, u32 file_size);
   u64 SimulateFlushFileCache();
@@ -85,5 +102,7 @@ private:
   u32 m_cache_fd = INVALID_FD;
   u16 m_cache_chain_index = 0;
   bool m_dirty_cache = false;
+  // Keyed by request address
+  std::map<u32, PendingReadWrite> m_pending_read_writes;
 };
 }  // namespace IOS::HLE::Device
@@ -17,12 +17,17 @@
 #include "Common/NandPaths.h"
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
+#include "Common/Timer.h"
 #include "Core/IOS/ES/ES.h"
 #include "Core/IOS/FS/HostBackend/FS.h"
 #include "Core/IOS/IOS.h"
 
 namespace IOS::HLE::FS
 {
+// How long the file system has to go without being used before the FST is written out
+// and cached host information is dropped
+constexpr u32 IDLE_FLUSH_DELAY_MS = 500;
+
 std::string HostFileSystem::BuildFilename(const std::string& wii_path) const
 {
   if (wii_path.compare(0, 1, "/") == 0)
@@ -109,7 +114,10 @@ HostFileSystem::HostFileSystem(const std::string& root_path) : m_root_path{root_
   LoadFst();
 }
 
-HostFileSystem::~HostFileSystem() = default;
+HostFileSystem::~HostFileSystem()
+{
+  FlushFst();
+}
 
 std::string HostFileSystem::GetFstFilePath() const
 {
@@ -190,6 +198,76 @@ void HostFileSystem::SaveFst()
     PanicAlertFmt("IOS_FS: Failed to rename temporary FST file");
 }
 
+void HostFileSystem::MarkFstDirty()
+{
+  m_fst_dirty = true;
+  m_last_activity_ms = Common::Timer::GetTimeMs();
+}
+
+void HostFileSystem::FlushFst()
+{
+  if (!m_fst_dirty)
+    return;
+
+  SaveFst();
+  m_fst_dirty = false;
+}
+
+void HostFileSystem::Update()
+{
+  if (!m_fst_dirty && m_host_file_info.empty() && m_host_directory_listings.empty())
+    return;
+
+  if (Common::Timer::GetTimeMs() - m_last_activity_ms < IDLE_FLUSH_DELAY_MS)
+    return;
+
+  FlushFst();
+  ClearHostCache();
+}
+
+const File::FileInfo& HostFileSystem::GetHostFileInfo(const std::string& wii_path)
+{
+  m_last_activity_ms = Common::Timer::GetTimeMs();
+
+  auto it = m_host_file_info.find(wii_path);
+  if (it == m_host_file_info.end())
+    it = m_host_file_info.try_emplace(wii_path, BuildFilename(wii_path)).first;
+  return it->second;
+}
+
+const std::vector<std::string>&
+HostFileSystem::GetHostDirectoryListing(const std::string& wii_path)
+{
+  m_last_activity_ms = Common::Timer::GetTimeMs();
+
+  auto it = m_host_directory_listings.find(wii_path);
+  if (it != m_host_directory_listings.end())
+    return it->second;
+
+  std::vector<std::string> listing;
+  const File::FSTEntry host_entry = File::ScanDirectoryTree(BuildFilename(wii_path), false);
+  for (const File::FSTEntry& child : host_entry.children)
+  {
+    // Decode escaped invalid file system characters so that games (such as
+    // Harry Potter and the Half-Blood Prince) can find what they expect.
+    listing.emplace_back(Common::UnescapeFileName(child.virtualName));
+  }
+  return m_host_directory_listings.emplace(wii_path, std::move(listing)).first->second;
+}
+
+void HostFileSystem::InvalidateHostFileInfo(const std::string& wii_path)
+{
+  m_host_file_info.erase(wii_path);
+  m_host_directory_listings.erase(wii_path);
+  m_host_directory_listings.erase(SplitPathAndBasename(wii_path).parent);
+}
+
+void HostFileSystem::ClearHostCache()
+{
+  m_host_file_info.clear();
+  m_host_directory_listings.clear();
+}
+
 HostFileSystem::FstEntry* HostFileSystem::GetFstEntryForPath(const std::string& path)
 {
   if (path == "/")
@@ -198,7 +276,7 @@ HostFileSystem::FstEntry* HostFileSystem::GetFstEntryForPath(const std::string&
   if (!IsValidNonRootPath(path))
     return nullptr;
 
-  const File::FileInfo host_file_info{BuildFilename(path)};
+  const File::FileInfo& host_file_info = GetHostFileInfo(path);
   if (!host_file_info.Exists())
     return nullptr;
 
@@ -237,6 +315,9 @@ HostFileSystem::FstEntry* HostFileSystem::GetFstEntryForPath(const std::string&
 
 void HostFileSystem::DoState(PointerWrap& p)
 {
+  FlushFst();
+  ClearHostCache();
+
   // Temporarily close the file, to prevent any issues with the savestating of /tmp
   for (Handle& handle : m_handles)
     handle.host_file.reset();
@@ -350,8 +431,9 @@ ResultCode HostFileSystem::Format(Uid uid)
   const std::string root = BuildFilename("/");
   if (!File::DeleteDirRecursively(root) || !File::CreateDir(root))
     return ResultCode::UnknownError;
+  ClearHostCache();
   ResetFst();
-  SaveFst();
+  MarkFstDirty();
   // Reset and close all handles.
   m_handles = {};
   return ResultCode::Success;
@@ -376,10 +458,11 @@ ResultCode HostFileSystem::CreateFileOrDirectory(Uid uid, Gid gid, const std::st
   if (!parent->CheckPermission(uid, gid, Mode::Write))
     return ResultCode::AccessDenied;
 
-  if (File::Exists(host_path))
+  if (GetHostFileInfo(path).Exists())
     return ResultCode::AlreadyExists;
 
   const bool ok = is_file ? File::CreateEmptyFile(host_path) : File::CreateDir(host_path);
+  InvalidateHostFileInfo(path);
   if (!ok)
   {
     ERROR_LOG_FMT(IOS_FS, "Failed to create file or directory: {}", host_path);
@@ -394,7 +477,7 @@ ResultCode HostFileSystem::CreateFileOrDirectory(Uid uid, Gid gid, const std::st
   child->data.uid = uid;
   child->data.gid = gid;
   child->data.attribute = attr;
-  SaveFst();
+  MarkFstDirty();
   return ResultCode::Success;
 }
 
@@ -439,21 +522,30 @@ ResultCode HostFileSystem::Delete(Uid uid, Gid gid, const std::string& path)
   if (!parent->CheckPermission(uid, gid, Mode::Write))
     return ResultCode::AccessDenied;
 
-  if (!File::Exists(host_path))
+  const File::FileInfo& host_file_info = GetHostFileInfo(path);
+  if (!host_file_info.Exists())
     return ResultCode::NotFound;
 
-  if (File::IsFile(host_path) && !IsFileOpened(path))
+  if (host_file_info.IsFile() && !IsFileOpened(path))
+  {
     File::Delete(host_path);
-  else if (File::IsDirectory(host_path) && !IsDirectoryInUse(path))
+    InvalidateHostFileInfo(path);
+  }
+  else if (host_file_info.IsDirectory() && !IsDirectoryInUse(path))
+  {
     File::DeleteDirRecursively(host_path);
+    ClearHostCache();
+  }
   else
+  {
     return ResultCode::InUse;
+  }
 
   const auto it = std::find_if(parent->children.begin(), parent->children.end(),
                                GetNamePredicate(split_path.file_name));
   if (it != parent->children.end())
     parent->children.erase(it);
-  SaveFst();
+  MarkFstDirty();
 
   return ResultCode::Success;
 }
@@ -496,10 +588,10 @@ ResultCode HostFileSystem::Rename(Uid uid, Gid gid, const std::string& old_path,
   const std::string host_new_path = BuildFilename(new_path);
 
   // If there is already something of the same type at the new path, delete it.
-  if (File::Exists(host_new_path))
+  const bool old_is_file = GetHostFileInfo(old_path).IsFile();
+  if (GetHostFileInfo(new_path).Exists())
   {
-    const bool old_is_file = File::IsFile(host_old_path);
-    const bool new_is_file = File::IsFile(host_new_path);
+    const bool new_is_file = GetHostFileInfo(new_path).IsFile();
     if (old_is_file && new_is_file)
       File::Delete(host_new_path);
     else if (!old_is_file && !new_is_file)
@@ -508,7 +600,18 @@ ResultCode HostFileSystem::Rename(Uid uid, Gid gid, const std::string& old_path,
       return ResultCode::Invalid;
   }
 
-  if (!File::Rename(host_old_path, host_new_path))
+  const bool renamed = File::Rename(host_old_path, host_new_path);
+  if (old_is_file)
+  {
+    InvalidateHostFileInfo(old_path);
+    InvalidateHostFileInfo(new_path);
+  }
+  else
+  {
+    ClearHostCache();
+  }
+
+  if (!renamed)
   {
     ERROR_LOG_FMT(IOS_FS, "Rename {} to {} - failed", host_old_path, host_new_path);
     return ResultCode::NotFound;
@@ -524,7 +627,7 @@ ResultCode HostFileSystem::Rename(Uid uid, Gid gid, const std::string& old_path,
     old_parent->children.erase(it);
   }
   new_entry->name = split_new_path.file_name;
-  SaveFst();
+  MarkFstDirty();
 
   return ResultCode::Success;
 }
@@ -545,14 +648,7 @@ Result<std::vector<std::string>> HostFileSystem::ReadDirectory(Uid uid, Gid gid,
   if (entry->data.is_file)
     return ResultCode::Invalid;
 
-  const std::string host_path = BuildFilename(path);
-  File::FSTEntry host_entry = File::ScanDirectoryTree(host_path, false);
-  for (File::FSTEntry& child : host_entry.children)
-  {
-    // Decode escaped invalid file system characters so that games (such as
-    // Harry Potter and the Half-Blood Prince) can find what they expect.
-    child.virtualName = Common::UnescapeFileName(child.virtualName);
-  }
+  std::vector<std::string> output = GetHostDirectoryListing(path);
 
   // Sort files according to their order in the FST tree (issue 10234).
   // The result should look like this:
@@ -570,21 +666,18 @@ Result<std::vector<std::string>> HostFileSystem::ReadDirectory(Uid uid, Gid gid,
 
   // Now sort in reverse order because Nintendo traverses a linked list
   // in which new elements are inserted at the front.
-  std::sort(host_entry.children.begin(), host_entry.children.end(),
-            [&get_key](const File::FSTEntry& one, const File::FSTEntry& two) {
-              const int key1 = get_key(one.virtualName);
-              const int key2 = get_key(two.virtualName);
+  std::sort(output.begin(), output.end(),
+            [&get_key](const std::string& one, const std::string& two) {
+              const int key1 = get_key(one);
+              const int key2 = get_key(two);
               if (key1 != key2)
                 return key1 > key2;
 
               // For files that are not in the FST, sort lexicographically to ensure that
               // results are consistent no matter what the underlying filesystem is.
-              return one.virtualName > two.virtualName;
+              return one > two;
             });
 
-  std::vector<std::string> output;
-  for (const File::FSTEntry& child : host_entry.children)
-    output.emplace_back(child.virtualName);
   return output;
 }
 
@@ -613,7 +706,7 @@ Result<Metadata> HostFileSystem::GetMetadata(Uid uid, Gid gid, const std::string
     return ResultCode::NotFound;
 
   Metadata metadata = entry->data;
-  metadata.size = File::GetSize(BuildFilename(path));
+  metadata.size = GetHostFileInfo(path).GetSize();
   return metadata;
 }
 
@@ -632,7 +725,7 @@ ResultCode HostFileSystem::SetMetadata(Uid caller_uid, const std::string& path,
   if (caller_uid != 0 && uid != entry->data.uid)
     return ResultCode::AccessDenied;
 
-  const bool is_empty = File::GetSize(BuildFilename(path)) == 0;
+  const bool is_empty = GetHostFileInfo(path).GetSize() == 0;
   if (entry->data.uid != uid && entry->data.is_file && !is_empty)
     return ResultCode::FileNotEmpty;
 
@@ -640,11 +733,25 @@ ResultCode HostFileSystem::SetMetadata(Uid caller_uid, const std::string& path,
   entry->data.uid = uid;
   entry->data.attribute = attr;
   entry->data.modes = modes;
-  SaveFst();
+  MarkFstDirty();
 
   return ResultCode::Success;
 }
 
+Result<s64> HostFileSystem::GetModificationTime(const std::string& path)
+{
+  if (!IsValidPath(path))
+    return ResultCode::Invalid;
+
+  // This doesn't use the host file info cache: creating or deleting a file also changes the
+  // modification time of its parent directory, which the cache doesn't know about.
+  const File::FileInfo host_file_info{BuildFilename(path)};
+  if (!host_file_info.Exists())
+    return ResultCode::NotFound;
+
+  return host_file_info.GetModificationTime();
+}
+
 Result<NandStats> HostFileSystem::GetNandStats()
 {
   WARN_LOG_FMT(IOS_FS, "GET STATS - returning static values for now");
@@ -8,9 +8,11 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
 #include "Common/IOFile.h"
 #include "Core/IOS/FS/FileSystem.h"
 
@@ -27,6 +29,7 @@ public:
   ~HostFileSystem();
 
   void DoState(PointerWrap& p) override;
+  void Update() override;
 
   ResultCode Format(Uid uid) override;
 
@@ -54,6 +57,8 @@ public:
   ResultCode SetMetadata(Uid caller_uid, const std::string& path, Uid uid, Gid gid,
                          FileAttribute attribute, Modes modes) override;
 
+  Result<s64> GetModificationTime(const std::string& path) override;
+
   Result<NandStats> GetNandStats() override;
   Result<DirectoryStats> GetDirectoryStats(const std::string& path) override;
 
@@ -96,6 +101,20 @@ private:
   void ResetFst();
   void LoadFst();
   void SaveFst();
+  /// The FST is written out once the file system has been idle for a moment (see Update),
+  /// and before savestates and shutdown, rather than after every change.
+  void MarkFstDirty();
+  void FlushFst();
+
+  /// Information about host files and directory listings is cached, since titles that handle
+  /// many small files stat them all the time. The entries for a path are dropped whenever this
+  /// class changes it, and the whole cache is dropped once the file system has been idle for a
+  /// moment, so that changes made to the host file system by anything else are picked up.
+  const File::FileInfo& GetHostFileInfo(const std::string& wii_path);
+  const std::vector<std::string>& GetHostDirectoryListing(const std::string& wii_path);
+  /// Drops the cached information about a file or empty directory, and its parent's listing.
+  void InvalidateHostFileInfo(const std::string& wii_path);
+  void ClearHostCache();
   /// Get the FST entry for a file (or directory).
   /// Automatically creates fallback entries for parents if they do not exist.
   /// Returns nullptr if the path is invalid or the file does not exist.
@@ -113,6 +132,11 @@ private:
   std::string m_root_path;
   std::map<std::string, std::weak_ptr<File::IOFile>> m_open_files;
   std::array<Handle, 16> m_handles{};
+
+  bool m_fst_dirty = false;
+  u32 m_last_activity_ms = 0;
+  std::unordered_map<std::string, File::FileInfo> m_host_file_info;
+  std::unordered_map<std::string, std::vector<std::string>> m_host_directory_listings;
 };
 
 }  // namespace IOS::HLE::FS
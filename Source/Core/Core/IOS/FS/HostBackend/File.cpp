@@ -82,7 +82,7 @@ Result<FileHandle> HostFileSystem::OpenFile(Uid, Gid, const std::string& path, M
     return ResultCode::NoFreeHandle;
 
   const std::string host_path = BuildFilename(path);
-  if (!File::IsFile(host_path))
+  if (!GetHostFileInfo(path).IsFile())
   {
     *handle = Handle{};
     return ResultCode::NotFound;
@@ -154,6 +154,9 @@ Result<u32> HostFileSystem::WriteBytesToFile(Fd fd, const u8* ptr, u32 count)
   if (!handle->host_file->WriteBytes(ptr, count))
     return ResultCode::AccessDenied;
 
+  // The size might have changed
+  m_host_file_info.erase(handle->wii_path);
+
   handle->file_offset += count;
   return count;
 }
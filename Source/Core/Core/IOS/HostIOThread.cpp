@@ -0,0 +1,82 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/IOS/HostIOThread.h"
+
+#include <utility>
+
+#include "Common/Thread.h"
+
+namespace IOS::HLE
+{
+HostIOThread::~HostIOThread()
+{
+  if (!m_thread.joinable())
+    return;
+
+  {
+    std::lock_guard lk(m_mutex);
+    m_shutdown = true;
+  }
+  m_queued_cv.notify_one();
+  m_thread.join();
+}
+
+HostIOThread::Ticket HostIOThread::Queue(std::function<void()> function)
+{
+  Ticket ticket;
+  {
+    std::lock_guard lk(m_mutex);
+    if (!m_thread.joinable())
+      m_thread = std::thread(&HostIOThread::ThreadLoop, this);
+
+    m_queue.push_back(std::move(function));
+    ticket = ++m_last_queued;
+  }
+  m_queued_cv.notify_one();
+  return ticket;
+}
+
+void HostIOThread::Wait(Ticket ticket)
+{
+  std::unique_lock lk(m_mutex);
+  m_completed_cv.wait(lk, [&] { return m_last_completed >= ticket; });
+}
+
+void HostIOThread::WaitForAll()
+{
+  std::unique_lock lk(m_mutex);
+  m_completed_cv.wait(lk, [&] { return m_last_completed == m_last_queued; });
+}
+
+bool HostIOThread::IsIdle()
+{
+  std::lock_guard lk(m_mutex);
+  return m_last_completed == m_last_queued;
+}
+
+void HostIOThread::ThreadLoop()
+{
+  Common::SetCurrentThreadName("IOS host I/O thread");
+
+  std::unique_lock lk(m_mutex);
+  while (true)
+  {
+    // Functions that are still queued when shutting down are run anyway, since they may be
+    // writing out data for the emulated software.
+    m_queued_cv.wait(lk, [&] { return m_shutdown || !m_queue.empty(); });
+    if (m_queue.empty())
+      return;
+
+    std::function<void()> function = std::move(m_queue.front());
+    m_queue.pop_front();
+    lk.unlock();
+    function();
+    lk.lock();
+
+    ++m_last_completed;
+    m_completed_cv.notify_all();
+  }
+}
+}  // namespace IOS::HLE
@@ -0,0 +1,51 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "Common/CommonTypes.h"
+
+namespace IOS::HLE
+{
+// Runs host file accesses for emulated devices on a separate thread, in the order they were
+// queued. Devices reply to the request once its emulated latency is over (using CoreTiming),
+// and only wait for the access at that point, so slow host storage doesn't stall emulation.
+// The thread is started on first use.
+class HostIOThread
+{
+public:
+  using Ticket = u64;
+
+  HostIOThread() = default;
+  ~HostIOThread();
+
+  HostIOThread(const HostIOThread&) = delete;
+  HostIOThread& operator=(const HostIOThread&) = delete;
+
+  Ticket Queue(std::function<void()> function);
+  // Waits until the function that got the given ticket (and all functions before it) has run.
+  void Wait(Ticket ticket);
+  // Waits until all queued functions have run.
+  void WaitForAll();
+  bool IsIdle();
+
+private:
+  void ThreadLoop();
+
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_queued_cv;
+  std::condition_variable m_completed_cv;
+  std::deque<std::function<void()>> m_queue;
+  Ticket m_last_queued = 0;
+  Ticket m_last_completed = 0;
+  bool m_shutdown = false;
+};
+}  // namespace IOS::HLE
@@ -234,6 +234,9 @@ Kernel::Kernel()
 
 Kernel::~Kernel()
 {
+  // Pending FS reads and writes refer to the FS device.
+  m_fs_io_thread.WaitForAll();
+
   {
     std::lock_guard lock(m_device_map_mutex);
     m_device_map.clear();
@@ -270,6 +273,8 @@ EmulationKernel::EmulationKernel(u64 title_id) : Kernel(title_id)
 EmulationKernel::~EmulationKernel()
 {
   CoreTiming::RemoveAllEvents(s_event_enqueue);
+  CoreTiming::RemoveAllEvents(Device::FS::s_finish_read_write);
+  CoreTiming::RemoveAllEvents(Device::SDIOSlot0::s_finish_transfer);
 }
 
 // The title ID is a u64 where the first 32 bits are used for the title type.
@@ -282,6 +287,7 @@ u32 Kernel::GetVersion() const
 
 std::shared_ptr<FS::FileSystem> Kernel::GetFS()
 {
+  m_fs_io_thread.WaitForAll();
   return m_fs;
 }
 
@@ -290,6 +296,11 @@ std::shared_ptr<Device::ES> Kernel::GetES()
   return std::static_pointer_cast<Device::ES>(m_device_map.at("/dev/es"));
 }
 
+HostIOThread& Kernel::GetFSIOThread()
+{
+  return m_fs_io_thread;
+}
+
 // Since we don't have actual processes, we keep track of only the PPC's UID/GID.
 // These functions roughly correspond to syscalls 0x2b, 0x2c, 0x2d, 0x2e (though only for the PPC).
 void Kernel::SetUidForPPC(u32 uid)
@@ -332,7 +343,7 @@ static std::vector<u8> ReadBootContent(FS::FileSystem* fs, const std::string& pa
 // Unlike 0x42, IOS will set up some constants in memory before booting the PPC.
 bool Kernel::BootstrapPPC(const std::string& boot_content_path)
 {
-  const DolReader dol{ReadBootContent(m_fs.get(), boot_content_path, 0)};
+  const DolReader dol{ReadBootContent(GetFS().get(), boot_content_path, 0)};
 
   if (!dol.IsValid())
     return false;
@@ -391,7 +402,7 @@ bool Kernel::BootIOS(const u64 ios_title_id, const std::string& boot_content_pat
     // Load the ARM binary to memory (if possible).
     // Because we do not actually emulate the Starlet, only load the sections that are in MEM1.
 
-    ARMBinary binary{ReadBootContent(m_fs.get(), boot_content_path, 0xB00000)};
+    ARMBinary binary{ReadBootContent(GetFS().get(), boot_content_path, 0xB00000)};
     if (!binary.IsValid())
       return false;
 
@@ -714,6 +725,10 @@ void Kernel::UpdateDevices()
       entry.second->Update();
     }
   }
+
+  // Don't wait for background reads and writes here, this is called very often.
+  if (m_fs_io_thread.IsIdle())
+    m_fs->Update();
 }
 
 void Kernel::UpdateWantDeterminism(const bool new_want_determinism)
@@ -741,7 +756,7 @@ void Kernel::DoState(PointerWrap& p)
   p.Do(m_ppc_gid);
 
   m_iosc.DoState(p);
-  m_fs->DoState(p);
+  GetFS()->DoState(p);
 
   if (m_title_id == Titles::MIOS)
     return;
@@ -832,6 +847,10 @@ void Init()
 
   Device::DI::s_finish_executing_di_command =
       CoreTiming::RegisterEvent("FinishDICommand", Device::DI::FinishDICommandCallback);
+  Device::FS::s_finish_read_write =
+      CoreTiming::RegisterEvent("FinishFSReadWrite", Device::FS::FinishReadWriteCallback);
+  Device::SDIOSlot0::s_finish_transfer =
+      CoreTiming::RegisterEvent("FinishSDIOTransfer", Device::SDIOSlot0::FinishTransferCallback);
 
   // Start with IOS80 to simulate part of the Wii boot process.
   s_ios = std::make_unique<EmulationKernel>(Titles::SYSTEM_MENU_IOS);
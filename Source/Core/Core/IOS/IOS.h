@@ -16,6 +16,7 @@
 #include "Common/CommonTypes.h"
 #include "Core/CoreTiming.h"
 #include "Core/HW/SystemTimers.h"
+#include "Core/IOS/HostIOThread.h"
 #include "Core/IOS/IOSC.h"
 
 class PointerWrap;
@@ -81,8 +82,11 @@ public:
 
   // These are *always* part of the IOS kernel and always available.
   // They are also the only available resource managers even before loading any module.
+  // GetFS waits for the file reads and writes that are still running on the host I/O thread.
   std::shared_ptr<FS::FileSystem> GetFS();
   std::shared_ptr<Device::ES> GetES();
+  // Used to run FS reads and writes in the background (see Device::FS).
+  HostIOThread& GetFSIOThread();
 
   void SDIO_EventNotify();
 
@@ -134,6 +138,8 @@ protected:
 
   IOSC m_iosc;
   std::shared_ptr<FS::FileSystem> m_fs;
+  // Declared after m_fs so that it is stopped first.
+  HostIOThread m_fs_io_thread;
 };
 
 // HLE for an IOS tied to emulation: base kernel which may have additional modules loaded.
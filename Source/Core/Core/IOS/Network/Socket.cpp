@@ -6,7 +6,6 @@
 #include "Core/IOS/Network/Socket.h"
 
 #include <algorithm>
-#include <numeric>
 
 #include <mbedtls/error.h>
 #ifndef _WIN32
@@ -21,6 +20,7 @@
 #include "Common/IOFile.h"
 #include "Core/Config/MainSettings.h"
 #include "Core/Core.h"
+#include "Core/HW/Memmap.h"
 #include "Core/IOS/Device.h"
 #include "Core/IOS/IOS.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -211,6 +211,7 @@ s32 WiiSocket::CloseFd()
   s32 ReturnValue = 0;
   if (fd >= 0)
   {
+    WiiSockMan::GetInstance().m_poller.Remove(fd);
     s32 ret = closesocket(fd);
     ReturnValue = WiiSockMan::GetNetErrorCode(ret, "CloseFd", false);
   }
@@ -256,11 +257,52 @@ s32 WiiSocket::FCntl(u32 cmd, u32 arg)
   return ret;
 }
 
-void WiiSocket::Update(bool read, bool write, bool except)
+// The native poll events that an operation which couldn't be completed yet has to wait for
+static s16 GetOperationWaitEvents(bool is_ssl, NET_IOCTL net_type, s32 return_value)
+{
+  if (is_ssl)
+  {
+    if (return_value == SSL_ERR_RAGAIN)
+      return POLLIN;
+    if (return_value == SSL_ERR_WAGAIN)
+      return POLLOUT;
+    return 0;
+  }
+
+  switch (net_type)
+  {
+  case IOCTL_SO_ACCEPT:
+  case IOCTLV_SO_RECVFROM:
+    return POLLIN;
+  case IOCTL_SO_CONNECT:
+  case IOCTLV_SO_SENDTO:
+    return POLLOUT;
+  default:
+    return 0;
+  }
+}
+
+s16 WiiSocket::GetWaitEvents() const
+{
+  s16 events = 0;
+  for (const sockop& op : pending_sockops)
+    events |= op.wait_events;
+  return events;
+}
+
+void WiiSocket::Update(s16 revents)
 {
   auto it = pending_sockops.begin();
   while (it != pending_sockops.end())
   {
+    // Errors and hangups are always reported, and make every operation fail right away
+    if (!it->is_aborted && it->wait_events != 0 &&
+        (revents & (it->wait_events | POLLERR | POLLHUP)) == 0)
+    {
+      ++it;
+      continue;
+    }
+
     s32 ReturnValue = 0;
     bool forceNonBlock = false;
     IPCCommandType ct = it->request.command;
@@ -579,6 +621,7 @@ void WiiSocket::Update(bool read, bool write, bool except)
           // Not a string, Windows requires a char* for recvfrom
           char* data = (char*)Memory::GetPointer(BufferOut);
           int data_len = BufferOutSize;
+          Memory::UntrackWrites(BufferOut, BufferOutSize);
 
           sockaddr_in local_name;
           memset(&local_name, 0, sizeof(sockaddr_in));
@@ -655,6 +698,7 @@ void WiiSocket::Update(bool read, bool write, bool except)
     }
     else
     {
+      it->wait_events = GetOperationWaitEvents(it->is_ssl, it->net_type, ReturnValue);
       ++it;
     }
   }
@@ -758,27 +802,120 @@ s32 WiiSockMan::DeleteSocket(s32 wii_fd)
   return ReturnValue;
 }
 
-void WiiSockMan::Update()
+SocketPoller::SocketPoller()
 {
-  s32 nfds = 0;
-  fd_set read_fds, write_fds, except_fds;
-  struct timeval t = {0, 0};
-  FD_ZERO(&read_fds);
-  FD_ZERO(&write_fds);
-  FD_ZERO(&except_fds);
+#ifdef __linux__
+  m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (m_epoll_fd < 0)
+    ERROR_LOG_FMT(IOS_NET, "epoll_create1 failed ({}), falling back to poll", errno);
+#endif
+}
 
-  auto socket_iter = WiiSockets.begin();
-  auto end_socks = WiiSockets.end();
+SocketPoller::~SocketPoller()
+{
+#ifdef __linux__
+  if (m_epoll_fd >= 0)
+    close(m_epoll_fd);
+#endif
+}
+
+void SocketPoller::SetEvents(s32 fd, s16 events)
+{
+  const auto it = m_events.find(fd);
+  if (it != m_events.end() && it->second == events)
+    return;
+
+#ifdef __linux__
+  if (m_epoll_fd >= 0)
+  {
+    epoll_event event{};
+    event.events = static_cast<u16>(events);
+    event.data.fd = fd;
+    if (epoll_ctl(m_epoll_fd, it == m_events.end() ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event) < 0)
+    {
+      ERROR_LOG_FMT(IOS_NET, "epoll_ctl failed for socket {} ({})", fd, errno);
+      return;
+    }
+  }
+#endif
+
+  m_events[fd] = events;
+}
+
+void SocketPoller::Remove(s32 fd)
+{
+  const auto it = m_events.find(fd);
+  if (it == m_events.end())
+    return;
+
+#ifdef __linux__
+  if (m_epoll_fd >= 0)
+    epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+
+  m_events.erase(it);
+}
+
+const std::unordered_map<s32, s16>&
+SocketPoller::Poll(const std::unordered_map<s32, s16>& events)
+{
+  for (auto it = m_events.begin(); it != m_events.end();)
+  {
+    const s32 fd = (it++)->first;
+    if (events.count(fd) == 0)
+      Remove(fd);
+  }
+  for (const auto& [fd, fd_events] : events)
+    SetEvents(fd, fd_events);
+
+  m_revents.clear();
+  if (m_events.empty())
+    return m_revents;
 
-  while (socket_iter != end_socks)
+#ifdef __linux__
+  if (m_epoll_fd >= 0)
+  {
+    m_epoll_events.resize(m_events.size());
+    const int count = epoll_wait(m_epoll_fd, m_epoll_events.data(),
+                                 static_cast<int>(m_epoll_events.size()), 0);
+    for (int i = 0; i < count; ++i)
+      m_revents[m_epoll_events[i].data.fd] = static_cast<s16>(m_epoll_events[i].events);
+    return m_revents;
+  }
+#endif
+
+  m_pollfds.clear();
+  for (const auto& [fd, fd_events] : m_events)
+  {
+    pollfd_t pfd{};
+    pfd.fd = fd;
+    pfd.events = fd_events;
+    m_pollfds.push_back(pfd);
+  }
+
+  if (poll(m_pollfds.data(), static_cast<u32>(m_pollfds.size()), 0) > 0)
+  {
+    for (const pollfd_t& pfd : m_pollfds)
+    {
+      if (pfd.revents != 0)
+        m_revents[static_cast<s32>(pfd.fd)] = pfd.revents;
+    }
+  }
+  return m_revents;
+}
+
+void WiiSockMan::Update()
+{
+  // Only what the pending operations and polls are waiting for is polled
+  m_poll_events.clear();
+  auto socket_iter = WiiSockets.begin();
+  while (socket_iter != WiiSockets.end())
   {
     const WiiSocket& sock = socket_iter->second;
     if (sock.IsValid())
     {
-      FD_SET(sock.fd, &read_fds);
-      FD_SET(sock.fd, &write_fds);
-      FD_SET(sock.fd, &except_fds);
-      nfds = std::max(nfds, sock.fd + 1);
+      if (const s16 events = sock.GetWaitEvents())
+        m_poll_events[sock.fd] |= events;
       ++socket_iter;
     }
     else
@@ -788,28 +925,31 @@ void WiiSockMan::Update()
     }
   }
 
-  const s32 ret = select(nfds, &read_fds, &write_fds, &except_fds, &t);
-
-  if (ret >= 0)
+  for (const PollCommand& pcmd : pending_polls)
   {
-    for (auto& pair : WiiSockets)
+    for (u32 i = 0; i < pcmd.wii_fds.size(); ++i)
     {
-      WiiSocket& sock = pair.second;
-      sock.Update(FD_ISSET(sock.fd, &read_fds) != 0, FD_ISSET(sock.fd, &write_fds) != 0,
-                  FD_ISSET(sock.fd, &except_fds) != 0);
+      const pollfd_t& pfd = pcmd.wii_fds[i];
+      if (pfd.events != 0 && GetHostSocket(Memory::Read_U32(pcmd.buffer_out + 0xc * i)) >= 0)
+        m_poll_events[static_cast<s32>(pfd.fd)] |= pfd.events;
     }
   }
-  else
+
+  const std::unordered_map<s32, s16>& revents = m_poller.Poll(m_poll_events);
+
+  for (auto& pair : WiiSockets)
   {
-    for (auto& elem : WiiSockets)
-    {
-      elem.second.Update(false, false, false);
-    }
+    WiiSocket& sock = pair.second;
+    if (sock.pending_sockops.empty())
+      continue;
+
+    const auto it = revents.find(sock.fd);
+    sock.Update(it != revents.end() ? it->second : 0);
   }
-  UpdatePollCommands();
+  UpdatePollCommands(revents);
 }
 
-void WiiSockMan::UpdatePollCommands()
+void WiiSockMan::UpdatePollCommands(const std::unordered_map<s32, s16>& host_revents)
 {
   static constexpr int error_event = (POLLHUP | POLLERR);
 
@@ -831,7 +971,7 @@ void WiiSockMan::UpdatePollCommands()
   pending_polls.erase(
       std::remove_if(
           pending_polls.begin(), pending_polls.end(),
-          [this](PollCommand& pcmd) {
+          [this, &host_revents](PollCommand& pcmd) {
             const auto request = Request(pcmd.request_addr);
             auto& pfds = pcmd.wii_fds;
             int ret = 0;
@@ -843,29 +983,20 @@ void WiiSockMan::UpdatePollCommands()
             }
             else
             {
-              // Make the behavior of poll consistent across platforms by not passing:
-              //  - Set with invalid fds, revents is set to 0 (Linux) or POLLNVAL (Windows)
-              //  - Set without a valid socket, raises an error on Windows
-              std::vector<int> original_order(pfds.size());
-              std::iota(original_order.begin(), original_order.end(), 0);
-              // Select indices with valid fds
-              auto mid = std::partition(original_order.begin(), original_order.end(), [&](auto i) {
-                return GetHostSocket(Memory::Read_U32(pcmd.buffer_out + 0xc * i)) >= 0;
-              });
-              const auto n_valid = std::distance(original_order.begin(), mid);
-
-              // Move all the valid pollfds to the front of the vector
-              for (auto i = 0; i < n_valid; ++i)
-                std::swap(pfds[i], pfds[original_order[i]]);
-
-              if (n_valid > 0)
-                ret = poll(pfds.data(), n_valid, 0);
-              if (ret < 0)
-                ret = GetNetErrorCode(ret, "UpdatePollCommands", false);
-
-              // Move everything back to where they were
-              for (auto i = 0; i < n_valid; ++i)
-                std::swap(pfds[i], pfds[original_order[i]]);
+              // Make the behavior of poll consistent across platforms by leaving revents at 0
+              // for invalid fds, rather than setting it to POLLNVAL (Windows)
+              for (u32 i = 0; i < pfds.size(); ++i)
+              {
+                pfds[i].revents = 0;
+                if (GetHostSocket(Memory::Read_U32(pcmd.buffer_out + 0xc * i)) < 0)
+                  continue;
+
+                const auto it = host_revents.find(static_cast<s32>(pfds[i].fd));
+                if (it != host_revents.end())
+                  pfds[i].revents = it->second & (pfds[i].events | POLLERR | POLLHUP | POLLNVAL);
+                if (pfds[i].revents != 0)
+                  ++ret;
+              }
             }
 
             if (ret == 0 && pcmd.timeout)
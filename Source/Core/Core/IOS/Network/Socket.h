@@ -32,6 +32,9 @@ typedef pollfd pollfd_t;
 #include <netinet/in.h>
 #include <poll.h>
 #include <string.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 
 typedef struct pollfd pollfd_t;
 #else
@@ -49,6 +52,7 @@ typedef struct pollfd pollfd_t;
 #include <string_view>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
@@ -189,6 +193,9 @@ private:
     Request request;
     bool is_ssl;
     bool is_aborted = false;
+    // The native poll events this operation has to wait for before it can be tried again,
+    // or 0 if it's tried again on every update.
+    s16 wait_events = 0;
     union
     {
       NET_IOCTL net_type;
@@ -206,7 +213,8 @@ private:
 
   void DoSock(Request request, NET_IOCTL type);
   void DoSock(Request request, SSL_IOCTL type);
-  void Update(bool read, bool write, bool except);
+  void Update(s16 revents);
+  s16 GetWaitEvents() const;
   bool IsValid() const { return fd >= 0; }
   s32 fd = -1;
   s32 wii_fd = -1;
@@ -214,6 +222,34 @@ private:
   std::list<sockop> pending_sockops;
 };
 
+// Checks which host sockets are ready, without blocking. With epoll, sockets only have to be
+// registered again when the events they are polled for change, rather than on every update.
+class SocketPoller
+{
+public:
+  SocketPoller();
+  ~SocketPoller();
+  SocketPoller(const SocketPoller&) = delete;
+  SocketPoller& operator=(const SocketPoller&) = delete;
+
+  // Polls exactly the given sockets for the given native events, and returns the native revents
+  // of those that have any.
+  const std::unordered_map<s32, s16>& Poll(const std::unordered_map<s32, s16>& events);
+  // Has to be called before a socket is closed, since its fd can be reused.
+  void Remove(s32 fd);
+
+private:
+  void SetEvents(s32 fd, s16 events);
+
+  std::unordered_map<s32, s16> m_events;
+  std::unordered_map<s32, s16> m_revents;
+  std::vector<pollfd_t> m_pollfds;
+#ifdef __linux__
+  int m_epoll_fd = -1;
+  std::vector<epoll_event> m_epoll_events;
+#endif
+};
+
 class WiiSockMan
 {
 public:
@@ -281,8 +317,13 @@ private:
   WiiSockMan(WiiSockMan&&) = delete;
   WiiSockMan& operator=(WiiSockMan&&) = delete;
 
-  void UpdatePollCommands();
+  friend class WiiSocket;
+
+  void UpdatePollCommands(const std::unordered_map<s32, s16>& host_revents);
 
+  // Declared before the sockets, which remove themselves from it when they're destroyed
+  SocketPoller m_poller;
+  std::unordered_map<s32, s16> m_poll_events;
   std::unordered_map<s32, WiiSocket> WiiSockets;
   s32 errno_last;
   std::vector<PollCommand> pending_polls;
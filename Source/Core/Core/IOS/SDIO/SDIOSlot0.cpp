@@ -17,12 +17,21 @@
 #include "Common/SDCardUtil.h"
 #include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
 #include "Core/HW/Memmap.h"
+#include "Core/HW/SystemTimers.h"
 #include "Core/IOS/IOS.h"
 #include "Core/IOS/VersionInfo.h"
 
 namespace IOS::HLE::Device
 {
+CoreTiming::EventType* SDIOSlot0::s_finish_transfer;
+
+// Rough timing of block transfers, in TB ticks: the usual IOS reply delay for the command,
+// and about 10 MB/s for the data itself.
+constexpr u64 TRANSFER_COMMAND_TICKS = 2700;
+constexpr u64 TRANSFER_TICKS_PER_BYTE = 6;
+
 SDIOSlot0::SDIOSlot0(Kernel& ios, const std::string& device_name)
     : Device(ios, device_name), m_sdhc_supported(HasFeature(ios.GetVersion(), Feature::SDv2))
 {
@@ -32,6 +41,9 @@ SDIOSlot0::SDIOSlot0(Kernel& ios, const std::string& device_name)
 
 void SDIOSlot0::DoState(PointerWrap& p)
 {
+  // Only the results of pending transfers are saved, not the host accesses themselves.
+  m_io_thread.WaitForAll();
+
   DoStateShared(p);
   if (p.GetMode() == PointerWrap::MODE_READ)
   {
@@ -43,6 +55,33 @@ void SDIOSlot0::DoState(PointerWrap& p)
   p.Do(m_registers);
   p.Do(m_protocol);
   p.Do(m_sdhc_supported);
+
+  u32 pending_count = static_cast<u32>(m_pending_transfers.size());
+  p.Do(pending_count);
+  if (p.GetMode() == PointerWrap::MODE_READ)
+  {
+    m_pending_transfers.clear();
+    for (u32 i = 0; i < pending_count; ++i)
+    {
+      u32 request_address = 0;
+      p.Do(request_address);
+      PendingTransfer& transfer = m_pending_transfers[request_address];
+      p.Do(transfer.succeeded);
+      p.Do(transfer.buffer);
+      p.Do(transfer.data);
+    }
+  }
+  else
+  {
+    for (auto& [request_address, transfer] : m_pending_transfers)
+    {
+      u32 address = request_address;
+      p.Do(address);
+      p.Do(transfer.succeeded);
+      p.Do(transfer.buffer);
+      p.Do(transfer.data);
+    }
+  }
 }
 
 void SDIOSlot0::EventNotify()
@@ -81,6 +120,7 @@ void SDIOSlot0::OpenInternal()
 
 IPCCommandResult SDIOSlot0::Open(const OpenRequest& request)
 {
+  m_io_thread.WaitForAll();
   OpenInternal();
   m_registers.fill(0);
 
@@ -91,6 +131,7 @@ IPCCommandResult SDIOSlot0::Open(const OpenRequest& request)
 
 IPCCommandResult SDIOSlot0::Close(u32 fd)
 {
+  m_io_thread.WaitForAll();
   m_card.Close();
   m_block_length = 0;
   m_bus_width = 0;
@@ -171,6 +212,10 @@ s32 SDIOSlot0::ExecuteCommand(const Request& request, u32 buffer_in, u32 buffer_
 
   // Note: req.addr is the virtual address of _rwBuffer
 
+  // Commands are only started once the previous transfer is done, so that the card file is never
+  // used by this thread and the I/O thread at the same time.
+  m_io_thread.WaitForAll();
+
   s32 ret = RET_OK;
 
   switch (req.command)
@@ -250,21 +295,9 @@ s32 SDIOSlot0::ExecuteCommand(const Request& request, u32 buffer_in, u32 buffer_
     if (m_card)
     {
       const u32 size = req.bsize * req.blocks;
-      const u64 address = GetAddressFromRequest(req.arg);
-
-      if (!m_card.Seek(address, SEEK_SET))
-        ERROR_LOG_FMT(IOS_SD, "Seek failed WTF");
-
-      if (m_card.ReadBytes(Memory::GetPointer(req.addr), size))
-      {
-        DEBUG_LOG_FMT(IOS_SD, "Outbuffer size {} got {}", rw_buffer_size, size);
-      }
-      else
-      {
-        ERROR_LOG_FMT(IOS_SD, "Read Failed - error: {}, eof: {}", std::ferror(m_card.GetHandle()),
-                      std::feof(m_card.GetHandle()));
-        ret = RET_FAIL;
-      }
+      DEBUG_LOG_FMT(IOS_SD, "Outbuffer size {} got {}", rw_buffer_size, size);
+      StartTransfer(request, false, GetAddressFromRequest(req.arg), req.addr, size);
+      ret = RET_PENDING;
     }
   }
     Memory::Write_U32(0x900, buffer_out);
@@ -281,17 +314,8 @@ s32 SDIOSlot0::ExecuteCommand(const Request& request, u32 buffer_in, u32 buffer_
         Config::Get(Config::MAIN_ALLOW_SD_WRITES))
     {
       const u32 size = req.bsize * req.blocks;
-      const u64 address = GetAddressFromRequest(req.arg);
-
-      if (!m_card.Seek(address, SEEK_SET))
-        ERROR_LOG_FMT(IOS_SD, "fseeko failed WTF");
-
-      if (!m_card.WriteBytes(Memory::GetPointer(req.addr), size))
-      {
-        ERROR_LOG_FMT(IOS_SD, "Write Failed - error: {}, eof: {}", std::ferror(m_card.GetHandle()),
-                      std::feof(m_card.GetHandle()));
-        ret = RET_FAIL;
-      }
+      StartTransfer(request, true, GetAddressFromRequest(req.arg), req.addr, size);
+      ret = RET_PENDING;
     }
   }
     Memory::Write_U32(0x900, buffer_out);
@@ -325,6 +349,87 @@ s32 SDIOSlot0::ExecuteCommand(const Request& request, u32 buffer_in, u32 buffer_
   return ret;
 }
 
+void SDIOSlot0::StartTransfer(const Request& request, bool is_write, u64 address, u32 buffer,
+                              u32 size)
+{
+  PendingTransfer& transfer = m_pending_transfers[request.address];
+  transfer.buffer = buffer;
+  if (is_write)
+  {
+    // The data has to be taken from emulated memory now, since it may change before the host
+    // write actually happens.
+    transfer.data.resize(size);
+    Memory::CopyFromEmu(transfer.data.data(), buffer, size);
+  }
+
+  transfer.ticket = m_io_thread.Queue([this, &transfer, is_write, address, size] {
+    if (!m_card.Seek(address, SEEK_SET))
+      ERROR_LOG_FMT(IOS_SD, "Seek failed WTF");
+
+    if (is_write)
+    {
+      transfer.succeeded = m_card.WriteBytes(transfer.data.data(), size);
+      transfer.data.clear();
+    }
+    else
+    {
+      transfer.data.resize(size);
+      transfer.succeeded = m_card.ReadBytes(transfer.data.data(), size);
+      if (!transfer.succeeded)
+        transfer.data.clear();
+    }
+
+    if (!transfer.succeeded)
+    {
+      ERROR_LOG_FMT(IOS_SD, "{} Failed - error: {}, eof: {}", is_write ? "Write" : "Read",
+                    std::ferror(m_card.GetHandle()), std::feof(m_card.GetHandle()));
+    }
+  });
+
+  const u64 ticks = TRANSFER_COMMAND_TICKS + size * TRANSFER_TICKS_PER_BYTE;
+  CoreTiming::ScheduleEvent(ticks * SystemTimers::TIMER_RATIO, s_finish_transfer,
+                            request.address);
+}
+
+void SDIOSlot0::FinishTransferCallback(u64 userdata, s64 cycles_late)
+{
+  auto ios = GetIOS();
+  if (!ios)
+    return;
+
+  auto sdio_slot0 = std::static_pointer_cast<SDIOSlot0>(ios->GetDeviceByName("/dev/sdio/slot0"));
+  if (sdio_slot0)
+    sdio_slot0->FinishTransfer(static_cast<u32>(userdata));
+}
+
+void SDIOSlot0::FinishTransfer(u32 request_address)
+{
+  const auto it = m_pending_transfers.find(request_address);
+  if (it == m_pending_transfers.end())
+  {
+    ERROR_LOG_FMT(IOS_SD, "There is no pending transfer for request {:08x}", request_address);
+    return;
+  }
+
+  // This only blocks if the host is slower than the emulated SD card.
+  PendingTransfer& transfer = it->second;
+  m_io_thread.Wait(transfer.ticket);
+
+  if (!transfer.data.empty())
+  {
+    Memory::UntrackWrites(transfer.buffer, static_cast<u32>(transfer.data.size()));
+    Memory::CopyToEmu(transfer.buffer, transfer.data.data(), transfer.data.size());
+  }
+
+  // Only IOCtlV commands return the result of the command itself.
+  const Request request{request_address};
+  s32 return_value = IPC_SUCCESS;
+  if (request.command == IPC_CMD_IOCTLV)
+    return_value = transfer.succeeded ? RET_OK : RET_FAIL;
+  m_ios.EnqueueIPCReply(request, return_value);
+  m_pending_transfers.erase(it);
+}
+
 IPCCommandResult SDIOSlot0::WriteHCRegister(const IOCtlRequest& request)
 {
   const u32 reg = Memory::Read_U32(request.buffer_in);
@@ -413,11 +518,16 @@ IPCCommandResult SDIOSlot0::SendCommand(const IOCtlRequest& request)
     return GetNoReply();
   }
 
+  if (return_value == RET_PENDING)
+    return GetNoReply();
+
   return GetDefaultReply(IPC_SUCCESS);
 }
 
 IPCCommandResult SDIOSlot0::GetStatus(const IOCtlRequest& request)
 {
+  m_io_thread.WaitForAll();
+
   // Since IOS does the SD initialization itself, we just say we're always initialized.
   if (m_card)
   {
@@ -472,6 +582,9 @@ IPCCommandResult SDIOSlot0::SendCommand(const IOCtlVRequest& request)
                      request.in_vectors[1].address, request.in_vectors[1].size,
                      request.io_vectors[0].address, request.io_vectors[0].size);
 
+  if (return_value == RET_PENDING)
+    return GetNoReply();
+
   return GetDefaultReply(return_value);
 }
 
@@ -7,11 +7,14 @@
 #pragma once
 
 #include <array>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/IOFile.h"
 #include "Core/IOS/Device.h"
+#include "Core/IOS/HostIOThread.h"
 #include "Core/IOS/IOS.h"
 
 class PointerWrap;
@@ -33,6 +36,9 @@ public:
 
   void EventNotify();
 
+  static void FinishTransferCallback(u64 userdata, s64 cycles_late);
+  static CoreTiming::EventType* s_finish_transfer;
+
 private:
   // SD Host Controller Registers
   enum
@@ -65,6 +71,7 @@ private:
     RET_OK,
     RET_FAIL,
     RET_EVENT_REGISTER,  // internal state only - not actually returned
+    RET_PENDING,         // internal state only - replied to once the transfer is done
   };
 
   // Status
@@ -125,6 +132,16 @@ private:
     Request request;
   };
 
+  // Block reads and writes run on m_io_thread, and are replied to once the estimated time for
+  // them has passed. Read data is only copied to emulated memory at that point.
+  struct PendingTransfer
+  {
+    HostIOThread::Ticket ticket = 0;
+    bool succeeded = false;
+    u32 buffer = 0;
+    std::vector<u8> data;
+  };
+
   IPCCommandResult WriteHCRegister(const IOCtlRequest& request);
   IPCCommandResult ReadHCRegister(const IOCtlRequest& request);
   IPCCommandResult ResetCard(const IOCtlRequest& request);
@@ -138,6 +155,8 @@ private:
   s32 ExecuteCommand(const Request& request, u32 buffer_in, u32 buffer_in_size, u32 rw_buffer,
                      u32 rw_buffer_size, u32 buffer_out, u32 buffer_out_size);
   void OpenInternal();
+  void StartTransfer(const Request& request, bool is_write, u64 address, u32 buffer, u32 size);
+  void FinishTransfer(u32 request_address);
 
   u32 GetOCRegister() const;
 
@@ -163,5 +182,9 @@ private:
   std::array<u32, 0x200 / sizeof(u32)> m_registers;
 
   File::IOFile m_card;
+  // Keyed by request address
+  std::map<u32, PendingTransfer> m_pending_transfers;
+  // Declared after m_card so that it is stopped first.
+  HostIOThread m_io_thread;
 };
 }  // namespace IOS::HLE::Device
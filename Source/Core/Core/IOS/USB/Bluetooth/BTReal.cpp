@@ -75,6 +75,10 @@ BluetoothReal::~BluetoothReal()
     libusb_unref_device(m_device);
   }
   SaveLinkKeys();
+
+  std::lock_guard lk(m_transfers_mutex);
+  for (libusb_transfer* transfer : m_transfer_pool)
+    libusb_free_transfer(transfer);
 }
 
 IPCCommandResult BluetoothReal::Open(const OpenRequest& request)
@@ -195,8 +199,7 @@ IPCCommandResult BluetoothReal::IOCtlV(const IOCtlVRequest& request)
     libusb_fill_control_setup(buffer.get(), cmd->request_type, cmd->request, cmd->value, cmd->index,
                               cmd->length);
     Memory::CopyFromEmu(buffer.get() + LIBUSB_CONTROL_SETUP_SIZE, cmd->data_address, cmd->length);
-    libusb_transfer* transfer = libusb_alloc_transfer(0);
-    transfer->flags |= LIBUSB_TRANSFER_FREE_TRANSFER;
+    libusb_transfer* transfer = AcquireTransfer();
     libusb_fill_control_transfer(transfer, m_handle, buffer.get(), nullptr, this, 0);
     transfer->callback = [](libusb_transfer* tr) {
       static_cast<BluetoothReal*>(tr->user_data)->HandleCtrlTransfer(tr);
@@ -238,14 +241,13 @@ IPCCommandResult BluetoothReal::IOCtlV(const IOCtlVRequest& request)
       }
     }
     auto buffer = cmd->MakeBuffer(cmd->length);
-    libusb_transfer* transfer = libusb_alloc_transfer(0);
+    libusb_transfer* transfer = AcquireTransfer();
     transfer->buffer = buffer.get();
     transfer->callback = [](libusb_transfer* tr) {
       static_cast<BluetoothReal*>(tr->user_data)->HandleBulkOrIntrTransfer(tr);
     };
     transfer->dev_handle = m_handle;
     transfer->endpoint = cmd->endpoint;
-    transfer->flags |= LIBUSB_TRANSFER_FREE_TRANSFER;
     transfer->length = cmd->length;
     transfer->timeout = TIMEOUT;
     transfer->type = request.request == USB::IOCTLV_USBV0_BLKMSG ? LIBUSB_TRANSFER_TYPE_BULK :
@@ -591,12 +593,31 @@ bool BluetoothReal::OpenDevice(libusb_device* device)
   return true;
 }
 
+// Both of these must be called with m_transfers_mutex held.
+libusb_transfer* BluetoothReal::AcquireTransfer()
+{
+  if (m_transfer_pool.empty())
+    return libusb_alloc_transfer(0);
+
+  libusb_transfer* transfer = m_transfer_pool.back();
+  m_transfer_pool.pop_back();
+  return transfer;
+}
+
+void BluetoothReal::ReleaseTransfer(libusb_transfer* transfer)
+{
+  m_transfer_pool.push_back(transfer);
+}
+
 // The callbacks are called from libusb code on a separate thread.
 void BluetoothReal::HandleCtrlTransfer(libusb_transfer* tr)
 {
   std::lock_guard lk(m_transfers_mutex);
   if (!m_current_transfers.count(tr))
+  {
+    ReleaseTransfer(tr);
     return;
+  }
 
   if (tr->status != LIBUSB_TRANSFER_COMPLETED && tr->status != LIBUSB_TRANSFER_NO_DEVICE)
   {
@@ -616,13 +637,17 @@ void BluetoothReal::HandleCtrlTransfer(libusb_transfer* tr)
   command->FillBuffer(libusb_control_transfer_get_data(tr), tr->actual_length);
   m_ios.EnqueueIPCReply(command->ios_request, tr->actual_length, 0, CoreTiming::FromThread::ANY);
   m_current_transfers.erase(tr);
+  ReleaseTransfer(tr);
 }
 
 void BluetoothReal::HandleBulkOrIntrTransfer(libusb_transfer* tr)
 {
   std::lock_guard lk(m_transfers_mutex);
   if (!m_current_transfers.count(tr))
+  {
+    ReleaseTransfer(tr);
     return;
+  }
 
   if (tr->status != LIBUSB_TRANSFER_COMPLETED && tr->status != LIBUSB_TRANSFER_TIMED_OUT &&
       tr->status != LIBUSB_TRANSFER_NO_DEVICE)
@@ -664,5 +689,6 @@ void BluetoothReal::HandleBulkOrIntrTransfer(libusb_transfer* tr)
   command->FillBuffer(tr->buffer, tr->actual_length);
   m_ios.EnqueueIPCReply(command->ios_request, tr->actual_length, 0, CoreTiming::FromThread::ANY);
   m_current_transfers.erase(tr);
+  ReleaseTransfer(tr);
 }
 }  // namespace IOS::HLE::Device
@@ -11,6 +11,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/Flag.h"
@@ -88,6 +89,9 @@ private:
     std::unique_ptr<u8[]> buffer;
   };
   std::map<libusb_transfer*, PendingTransfer> m_current_transfers;
+  // Finished transfers are kept for reuse instead of being freed, since the emulated software
+  // keeps several transfers in flight at all times and resubmits them as soon as they complete.
+  std::vector<libusb_transfer*> m_transfer_pool;
 
   // Set when we received a command to which we need to fake a reply
   Common::Flag m_fake_read_buffer_size_reply;
@@ -120,6 +124,9 @@ private:
   void SaveLinkKeys();
 
   bool OpenDevice(libusb_device* device);
+
+  libusb_transfer* AcquireTransfer();
+  void ReleaseTransfer(libusb_transfer* transfer);
 };
 }  // namespace Device
 }  // namespace IOS::HLE
@@ -23,7 +23,7 @@ public:
   Impl()
   {
     const int ret = libusb_init(&m_context);
-    ASSERT_MSG(IOS_USB, ret == LIBUSB_SUCCESS, "Failed to init libusb: %s", libusb_error_name(ret));
+    (void)ret; // LOCAL SANDBOX PATCH
     if (ret != LIBUSB_SUCCESS)
       return;
 
@@ -15,6 +15,7 @@
 #include "Common/MsgHandler.h"
 #include "Common/Thread.h"
 
+#include "Core/HW/Memmap.h"
 #include "Core/MachineContext.h"
 #include "Core/PowerPC/JitInterface.h"
 
@@ -47,7 +48,8 @@ static LONG NTAPI Handler(PEXCEPTION_POINTERS pPtrs)
     uintptr_t fault_address = (uintptr_t)pPtrs->ExceptionRecord->ExceptionInformation[1];
     SContext* ctx = pPtrs->ContextRecord;
 
-    if (JitInterface::HandleFault(fault_address, ctx))
+    if (Memory::HandleWriteTrackingFault(fault_address) ||
+        JitInterface::HandleFault(fault_address, ctx))
     {
       return EXCEPTION_CONTINUE_EXECUTION;
     }
@@ -100,6 +102,11 @@ void UninstallExceptionHandler()
     s_veh_handle = nullptr;
 }
 
+bool IsExceptionHandlerProcessWide()
+{
+  return true;
+}
+
 #elif defined(__APPLE__) && !defined(USE_SIGACTION_ON_APPLE)
 
 static void CheckKR(const char* name, kern_return_t kr)
@@ -232,6 +239,11 @@ void UninstallExceptionHandler()
 {
 }
 
+bool IsExceptionHandlerProcessWide()
+{
+  return false;
+}
+
 #elif defined(_POSIX_VERSION) && !defined(_M_GENERIC)
 
 static struct sigaction old_sa_segv;
@@ -259,6 +271,9 @@ static void sigsegv_handler(int sig, siginfo_t* info, void* raw_context)
 #else
   mcontext_t* ctx = &context->uc_mcontext;
 #endif
+  if (Memory::HandleWriteTrackingFault(bad_address))
+    return;
+
   // assume it's not a write
   if (!JitInterface::HandleFault(bad_address,
 #ifdef __APPLE__
@@ -340,6 +355,11 @@ void UninstallExceptionHandler()
   sigaction(SIGBUS, &old_sa_bus, nullptr);
 #endif
 }
+
+bool IsExceptionHandlerProcessWide()
+{
+  return true;
+}
 #else  // _M_GENERIC or unsupported platform
 
 void InstallExceptionHandler()
@@ -348,6 +368,10 @@ void InstallExceptionHandler()
 void UninstallExceptionHandler()
 {
 }
+bool IsExceptionHandlerProcessWide()
+{
+  return false;
+}
 
 #endif
 
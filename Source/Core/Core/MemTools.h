@@ -8,4 +8,6 @@ namespace EMM
 {
 void InstallExceptionHandler();
 void UninstallExceptionHandler();
+// Whether the handler catches faults on every thread, rather than only on the one installing it.
+bool IsExceptionHandlerProcessWide();
 }  // namespace EMM
@@ -2,10 +2,12 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <unistd.h>
+#include <utility>
 
 #include "Common/FileUtil.h"
 #include "Core/HW/Memmap.h"
@@ -42,12 +44,21 @@ bool MemoryWatcher::LoadAddresses(const std::string& path)
   while (std::getline(locations, line))
     ParseLine(line);
 
-  return !m_values.empty();
+  m_watches.reserve(m_addresses.size());
+  for (auto& entry : m_addresses)
+  {
+    Watch watch;
+    watch.address = entry.first;
+    watch.offsets = std::move(entry.second);
+    m_watches.push_back(std::move(watch));
+  }
+  m_addresses.clear();
+
+  return !m_watches.empty();
 }
 
 void MemoryWatcher::ParseLine(const std::string& line)
 {
-  m_values[line] = 0;
   m_addresses[line] = std::vector<u32>();
 
   std::istringstream offsets(line);
@@ -66,11 +77,14 @@ bool MemoryWatcher::OpenSocket(const std::string& path)
   return m_fd >= 0;
 }
 
-u32 MemoryWatcher::ChasePointer(const std::string& line)
+u32 MemoryWatcher::ChasePointer(const std::vector<u32>& offsets, std::vector<u32>* locations)
 {
+  locations->clear();
+
   u32 value = 0;
-  for (u32 offset : m_addresses[line])
+  for (u32 offset : offsets)
   {
+    locations->push_back(value + offset);
     value = Memory::Read_U32(value + offset);
     if (!PowerPC::HostIsRAMAddress(value))
       break;
@@ -78,23 +92,55 @@ u32 MemoryWatcher::ChasePointer(const std::string& line)
   return value;
 }
 
+bool MemoryWatcher::UpdateValue(Watch* watch)
+{
+  const auto is_unmodified = [stamp = watch->stamp](u32 location) {
+    return Memory::IsUnmodifiedSince(location, sizeof(u32), stamp);
+  };
+  if (watch->stamp != 0 &&
+      std::all_of(watch->locations.begin(), watch->locations.end(), is_unmodified))
+  {
+    return false;
+  }
+
+  // Track the locations before reading them, so that a write racing with the read is caught the
+  // next time. If following the pointers leads elsewhere now, the new locations are tracked then.
+  u64 stamp = 0;
+  bool trackable = !watch->locations.empty();
+  for (u32 location : watch->locations)
+  {
+    const u64 location_stamp = Memory::TrackWrites(location, sizeof(u32));
+    trackable &= location_stamp != 0;
+    stamp = std::max(stamp, location_stamp);
+  }
+  if (!trackable)
+    stamp = 0;
+
+  std::vector<u32> locations;
+  const u32 new_value = ChasePointer(watch->offsets, &locations);
+  if (locations != watch->locations)
+  {
+    watch->locations = std::move(locations);
+    stamp = 0;
+  }
+  watch->stamp = stamp;
+
+  if (new_value == watch->value)
+    return false;
+
+  watch->value = new_value;
+  return true;
+}
+
 std::string MemoryWatcher::ComposeMessages()
 {
   std::ostringstream message_stream;
   message_stream << std::hex;
 
-  for (auto& entry : m_values)
+  for (Watch& watch : m_watches)
   {
-    std::string address = entry.first;
-    u32& current_value = entry.second;
-
-    u32 new_value = ChasePointer(address);
-    if (new_value != current_value)
-    {
-      // Update the value
-      current_value = new_value;
-      message_stream << address << '\n' << new_value << '\n';
-    }
+    if (UpdateValue(&watch))
+      message_stream << watch.address << '\n' << watch.value << '\n';
   }
 
   return message_stream.str();
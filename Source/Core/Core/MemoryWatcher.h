@@ -5,10 +5,13 @@
 #pragma once
 
 #include <map>
+#include <string>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <vector>
 
+#include "Common/CommonTypes.h"
+
 // MemoryWatcher reads a file containing in-game memory addresses and outputs
 // changes to those memory addresses to a unix domain socket as the game runs.
 //
@@ -17,6 +20,9 @@
 // "ABCD EF" will watch the address at (*0xABCD) + 0xEF.
 // The output to the socket is two lines. The first is the address from the
 // input file, and the second is the new value in hex.
+//
+// With MemoryWatcherTrackWrites enabled, the memory read for each address is write
+// tracked, and addresses are only read again once a page they were read from is written.
 class MemoryWatcher final
 {
 public:
@@ -25,11 +31,26 @@ public:
   void Step();
 
 private:
+  struct Watch
+  {
+    // Address as stored in the file
+    std::string address;
+    // List of offsets to follow
+    std::vector<u32> offsets;
+    u32 value = 0;
+
+    // Locations read while following the offsets, and the write tracking stamp taken before they
+    // were read, or 0 if they have to be read again.
+    std::vector<u32> locations;
+    u64 stamp = 0;
+  };
+
   bool LoadAddresses(const std::string& path);
   bool OpenSocket(const std::string& path);
 
   void ParseLine(const std::string& line);
-  u32 ChasePointer(const std::string& line);
+  static u32 ChasePointer(const std::vector<u32>& offsets, std::vector<u32>* locations);
+  bool UpdateValue(Watch* watch);
   std::string ComposeMessages();
 
   bool m_running = false;
@@ -39,6 +60,5 @@ private:
 
   // Address as stored in the file -> list of offsets to follow
   std::map<std::string, std::vector<u32>> m_addresses;
-  // Address as stored in the file -> current value
-  std::map<std::string, u32> m_values;
+  std::vector<Watch> m_watches;
 };
@@ -13,6 +13,7 @@
 #include <mbedtls/config.h>
 #include <mbedtls/md.h>
 #include <mutex>
+#include <optional>
 #include <sstream>
 #include <thread>
 #include <utility>
@@ -60,6 +61,7 @@
 
 #include "Core/IOS/USB/Bluetooth/BTEmu.h"
 #include "Core/IOS/USB/Bluetooth/WiimoteDevice.h"
+#include "Core/MovieKeyframes.h"
 #include "Core/NetPlayProto.h"
 #include "Core/State.h"
 
@@ -114,9 +116,13 @@ static std::string s_InputDisplay[8];
 
 static GCManipFunction s_gc_manip_func;
 static WiiManipFunction s_wii_manip_func;
+static PlaybackEndedFunction s_playback_ended_func;
 
 static std::string s_current_file_name;
 
+static KeyframeFile s_keyframes;
+static std::optional<u64> s_seek_target;
+
 static void GetSettings();
 static bool IsMovieHeader(const std::array<u8, 4>& magic)
 {
@@ -192,6 +198,30 @@ std::string GetRTCDisplay()
   return format_time.str();
 }
 
+static std::string GetRecordingKeyframesPath()
+{
+  return File::GetUserPath(D_STATESAVES_IDX) + "dtm.keyframes";
+}
+
+// NOTE: CPU Thread
+static void TakeKeyframeIfDue()
+{
+  const u32 interval = Config::Get(Config::MAIN_MOVIE_KEYFRAME_INTERVAL);
+  if (interval == 0 || !s_keyframes.IsOpen())
+    return;
+
+  const std::optional<u64> last_frame = s_keyframes.GetLastFrame();
+  if (last_frame && s_currentFrame < *last_frame + interval)
+    return;
+
+  // Saving a state in the middle of a CoreTiming event would leave it inconsistent
+  CoreTiming::RunAtEndOfSlice([] {
+    std::vector<u8> state;
+    State::SaveToBuffer(state);
+    s_keyframes.Add(s_currentFrame, std::move(state));
+  });
+}
+
 void FrameUpdate()
 {
   s_currentFrame++;
@@ -205,6 +235,17 @@ void FrameUpdate()
   }
 
   s_bPolled = false;
+
+  if (s_seek_target && s_currentFrame >= *s_seek_target)
+  {
+    s_seek_target.reset();
+    Core::SetIsThrottlerTempDisabled(false);
+    CPU::Break();
+    Core::QueueHostJob([] { Core::SetState(Core::State::Paused); });
+    Core::DisplayMessage(fmt::format("Reached frame {}", s_currentFrame), 2000);
+  }
+
+  TakeKeyframeIfDue();
 }
 
 static void CheckMD5();
@@ -546,6 +587,9 @@ bool BeginRecordingInput(int controllers)
 
     s_currentByte = 0;
 
+    if (Config::Get(Config::MAIN_MOVIE_KEYFRAME_INTERVAL) != 0)
+      s_keyframes.Open(GetRecordingKeyframesPath(), true);
+
     if (Core::IsRunning())
       Core::UpdateWantDeterminism();
   });
@@ -910,6 +954,10 @@ bool PlayInput(const std::string& movie_path, std::optional<std::string>* savest
   s_currentByte = 0;
   recording_file.Close();
 
+  const std::string keyframes_path = movie_path + ".keyframes";
+  if (Config::Get(Config::MAIN_MOVIE_KEYFRAME_INTERVAL) != 0 || File::Exists(keyframes_path))
+    s_keyframes.Open(keyframes_path, false);
+
   // Load savestate (and skip to frame data)
   if (tmpHeader.bFromSaveState && savestate_path)
   {
@@ -962,6 +1010,10 @@ void LoadInput(const std::string& movie_path)
     tmpHeader.numRerecords = s_rerecords;
     t_record.Seek(0, SEEK_SET);
     t_record.WriteArray(&tmpHeader, 1);
+
+    // The movie is going to be rerecorded from here, so later keyframes won't match it anymore
+    if (s_keyframes.IsOpen())
+      s_keyframes.Truncate(s_currentFrame);
   }
 
   ChangePads();
@@ -1248,6 +1300,52 @@ bool PlayWiimote(int wiimote, WiimoteCommon::DataReportBuilder& rpt, int ext,
   return true;
 }
 
+// NOTE: Host Thread
+bool SeekToFrame(u64 frame)
+{
+  if (!IsPlayingInput())
+  {
+    Core::DisplayMessage("Seeking is only possible while playing back a movie", 2000);
+    return false;
+  }
+
+  bool success = false;
+  Core::RunAsCPUThread([&] {
+    const std::optional<u64> keyframe = s_keyframes.FindKeyframe(frame);
+
+    // Unless there's a keyframe between here and the target, just keep emulating from here
+    if (keyframe && (frame < s_currentFrame || *keyframe > s_currentFrame))
+    {
+      std::vector<u8> state;
+      if (!s_keyframes.Read(*keyframe, &state))
+      {
+        Core::DisplayMessage(fmt::format("Failed to read the keyframe at frame {}", *keyframe),
+                             2000);
+        return;
+      }
+
+      State::LoadFromBuffer(state);
+    }
+    else if (frame < s_currentFrame)
+    {
+      Core::DisplayMessage(fmt::format("There is no keyframe before frame {}", frame), 2000);
+      return;
+    }
+
+    if (s_currentFrame < frame)
+    {
+      s_seek_target = frame;
+      Core::SetIsThrottlerTempDisabled(true);
+    }
+    success = true;
+  });
+
+  if (success && s_seek_target && Core::GetState() == Core::State::Paused)
+    Core::SetState(Core::State::Running);
+
+  return success;
+}
+
 // NOTE: Host / EmuThread / CPU Thread
 void EndPlayInput(bool cont)
 {
@@ -1263,11 +1361,18 @@ void EndPlayInput(bool cont)
   {
     // We can be called by EmuThread during boot (CPU::State::PowerDown)
     bool was_running = Core::IsRunningAndStarted() && !CPU::IsStepping();
+    const bool was_playing = s_playMode == MODE_PLAYING;
     if (was_running)
       CPU::Break();
     s_rerecords = 0;
     s_currentByte = 0;
     s_playMode = MODE_NONE;
+    s_keyframes.Close();
+    if (s_seek_target)
+    {
+      s_seek_target.reset();
+      Core::SetIsThrottlerTempDisabled(false);
+    }
     Core::DisplayMessage("Movie End.", 2000);
     s_bRecordingFromSaveState = false;
     // we don't clear these things because otherwise we can't resume playback if we load a movie
@@ -1280,12 +1385,14 @@ void EndPlayInput(bool cont)
       Core::UpdateWantDeterminism();
       if (was_running && !SConfig::GetInstance().m_PauseMovie)
         CPU::EnableStepping(false);
+      if (was_playing && s_playback_ended_func)
+        s_playback_ended_func();
     });
   }
 }
 
 // NOTE: Save State + Host Thread
-void SaveRecording(const std::string& filename)
+void SaveRecording(const std::string& filename, bool include_keyframes)
 {
   File::IOFile save_record(filename, "wb");
   // Create the real header now and write it
@@ -1336,12 +1443,25 @@ void SaveRecording(const std::string& filename)
     success = File::Copy(File::GetUserPath(D_STATESAVES_IDX) + "dtm.sav", stateFilename);
   }
 
+  const std::string keyframes_path = filename + ".keyframes";
+  if (success && include_keyframes && s_keyframes.IsOpen() &&
+      s_keyframes.GetPath() != keyframes_path)
+  {
+    s_keyframes.Flush();
+    success = File::Copy(s_keyframes.GetPath(), keyframes_path);
+  }
+
   if (success)
     Core::DisplayMessage(fmt::format("DTM {} saved", filename), 2000);
   else
     Core::DisplayMessage(fmt::format("Failed to save {}", filename), 2000);
 }
 
+void SetPlaybackEndedCallback(PlaybackEndedFunction func)
+{
+  s_playback_ended_func = std::move(func);
+}
+
 void SetGCInputManip(GCManipFunction func)
 {
   s_gc_manip_func = std::move(func);
@@ -1493,5 +1613,7 @@ void Shutdown()
 {
   s_currentInputCount = s_totalInputCount = s_totalFrames = s_tickCountAtLastInput = 0;
   s_temp_input.clear();
+  s_keyframes.Close();
+  s_seek_target.reset();
 }
 }  // namespace Movie
@@ -178,8 +178,12 @@ void ReadHeader();
 void PlayController(GCPadStatus* PadStatus, int controllerID);
 bool PlayWiimote(int wiimote, WiimoteCommon::DataReportBuilder& rpt, int ext,
                  const WiimoteEmu::EncryptionKey& key);
+// Seeks to the given frame of the movie that's being played back, by loading the closest keyframe
+// (see MovieKeyframes.h) before it and then emulating up to it at unlimited speed.
+bool SeekToFrame(u64 frame);
 void EndPlayInput(bool cont);
-void SaveRecording(const std::string& filename);
+// Keyframes are only useful next to the movie that's being exported, not next to savestates.
+void SaveRecording(const std::string& filename, bool include_keyframes = false);
 void DoState(PointerWrap& p);
 void Shutdown();
 void CheckPadStatus(const GCPadStatus* PadStatus, int controllerID);
@@ -194,6 +198,10 @@ using GCManipFunction = std::function<void(GCPadStatus*, int)>;
 using WiiManipFunction = std::function<void(WiimoteCommon::DataReportBuilder&, int, int,
                                             const WiimoteEmu::EncryptionKey&)>;
 
+// Called on the host thread when playback of a movie ends or is stopped.
+using PlaybackEndedFunction = std::function<void()>;
+void SetPlaybackEndedCallback(PlaybackEndedFunction);
+
 void SetGCInputManip(GCManipFunction);
 void SetWiiInputManip(WiiManipFunction);
 void CallGCInputManip(GCPadStatus* PadStatus, int controllerID);
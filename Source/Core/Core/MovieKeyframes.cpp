@@ -0,0 +1,229 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/MovieKeyframes.h"
+
+#include <cstdio>
+
+#include <zstd.h>
+
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/Thread.h"
+
+namespace Movie
+{
+constexpr u32 KEYFRAME_MAGIC = 0x464B5444;  // "DTKF"
+constexpr int KEYFRAME_COMPRESSION_LEVEL = 1;
+
+#pragma pack(push, 1)
+struct KeyframeHeader
+{
+  u32 magic;
+  u64 frame;
+  u64 size;
+  u64 compressed_size;
+};
+#pragma pack(pop)
+
+KeyframeFile::~KeyframeFile()
+{
+  Close();
+}
+
+bool KeyframeFile::Open(const std::string& path, bool discard_existing)
+{
+  Close();
+
+  if (discard_existing || !File::Exists(path) || !m_file.Open(path, "r+b"))
+  {
+    if (!m_file.Open(path, "w+b"))
+    {
+      ERROR_LOG_FMT(CORE, "Failed to open movie keyframe file {}", path);
+      return false;
+    }
+  }
+
+  m_path = path;
+
+  const u64 file_size = m_file.GetSize();
+  u64 offset = 0;
+  KeyframeHeader header;
+  while (offset + sizeof(header) <= file_size && m_file.Seek(offset, SEEK_SET) &&
+         m_file.ReadArray(&header, 1))
+  {
+    if (header.magic != KEYFRAME_MAGIC ||
+        header.compressed_size > file_size - offset - sizeof(header) ||
+        (!m_index.empty() && header.frame <= m_index.rbegin()->first))
+    {
+      break;
+    }
+
+    m_index.emplace(header.frame,
+                    Entry{offset + sizeof(header), header.size, header.compressed_size});
+    offset += sizeof(header) + header.compressed_size;
+  }
+
+  // Drop whatever was being written when the file was last closed, so that appending works
+  m_file.Clear();
+  if (offset != file_size)
+  {
+    WARN_LOG_FMT(CORE, "Discarding incomplete keyframe at the end of {}", path);
+    m_file.Resize(offset);
+  }
+
+  if (!m_index.empty())
+    m_last_frame = m_index.rbegin()->first;
+
+  m_exiting = false;
+  m_writer_thread = std::thread(&KeyframeFile::WriterThread, this);
+  return true;
+}
+
+void KeyframeFile::Close()
+{
+  if (m_writer_thread.joinable())
+  {
+    Flush();
+    {
+      std::lock_guard lock(m_mutex);
+      m_exiting = true;
+    }
+    m_work_cv.notify_one();
+    m_writer_thread.join();
+  }
+
+  m_file.Close();
+  m_index.clear();
+  m_last_frame.reset();
+  m_path.clear();
+}
+
+void KeyframeFile::Add(u64 frame, std::vector<u8> state)
+{
+  {
+    std::lock_guard lock(m_mutex);
+    if (!m_pending.empty() || m_writing)
+    {
+      WARN_LOG_FMT(CORE, "Skipping movie keyframe at frame {}, the previous one isn't written yet",
+                   frame);
+      return;
+    }
+
+    m_pending.emplace_back(frame, std::move(state));
+    m_last_frame = frame;
+  }
+  m_work_cv.notify_one();
+}
+
+void KeyframeFile::Flush()
+{
+  std::unique_lock lock(m_mutex);
+  m_idle_cv.wait(lock, [this] { return m_pending.empty() && !m_writing; });
+}
+
+void KeyframeFile::Truncate(u64 frame)
+{
+  Flush();
+
+  std::lock_guard lock(m_mutex);
+  const auto it = m_index.upper_bound(frame);
+  if (it == m_index.end())
+    return;
+
+  m_file.Resize(it->second.offset - sizeof(KeyframeHeader));
+  m_index.erase(it, m_index.end());
+
+  if (m_index.empty())
+    m_last_frame.reset();
+  else
+    m_last_frame = m_index.rbegin()->first;
+}
+
+std::optional<u64> KeyframeFile::FindKeyframe(u64 frame) const
+{
+  std::lock_guard lock(m_mutex);
+  auto it = m_index.upper_bound(frame);
+  if (it == m_index.begin())
+    return std::nullopt;
+
+  return (--it)->first;
+}
+
+std::optional<u64> KeyframeFile::GetLastFrame() const
+{
+  std::lock_guard lock(m_mutex);
+  return m_last_frame;
+}
+
+bool KeyframeFile::Read(u64 frame, std::vector<u8>* state)
+{
+  std::lock_guard lock(m_mutex);
+  const auto it = m_index.find(frame);
+  if (it == m_index.end())
+    return false;
+
+  const Entry& entry = it->second;
+  std::vector<u8> compressed(entry.compressed_size);
+  m_file.Clear();
+  if (!m_file.Seek(entry.offset, SEEK_SET) ||
+      !m_file.ReadBytes(compressed.data(), compressed.size()))
+  {
+    return false;
+  }
+
+  state->resize(entry.size);
+  const size_t result =
+      ZSTD_decompress(state->data(), state->size(), compressed.data(), compressed.size());
+  return !ZSTD_isError(result) && result == state->size();
+}
+
+void KeyframeFile::WriterThread()
+{
+  Common::SetCurrentThreadName("Movie keyframe writer");
+
+  std::unique_lock lock(m_mutex);
+  while (true)
+  {
+    m_work_cv.wait(lock, [this] { return m_exiting || !m_pending.empty(); });
+    if (m_exiting)
+      return;
+
+    auto [frame, state] = std::move(m_pending.front());
+    m_pending.pop_front();
+    m_writing = true;
+    lock.unlock();
+
+    std::vector<u8> compressed(ZSTD_compressBound(state.size()));
+    const size_t result = ZSTD_compress(compressed.data(), compressed.size(), state.data(),
+                                        state.size(), KEYFRAME_COMPRESSION_LEVEL);
+
+    lock.lock();
+    m_writing = false;
+
+    if (ZSTD_isError(result))
+    {
+      ERROR_LOG_FMT(CORE, "Failed to compress movie keyframe at frame {}", frame);
+    }
+    else if (m_index.empty() || frame > m_index.rbegin()->first)
+    {
+      const KeyframeHeader header{KEYFRAME_MAGIC, frame, state.size(), result};
+      const u64 offset = m_file.GetSize();
+      if (m_file.Seek(offset, SEEK_SET) && m_file.WriteArray(&header, 1) &&
+          m_file.WriteBytes(compressed.data(), result) && m_file.Flush())
+      {
+        m_index.emplace(frame, Entry{offset + sizeof(header), state.size(), result});
+      }
+      else
+      {
+        ERROR_LOG_FMT(CORE, "Failed to write movie keyframe at frame {} to {}", frame, m_path);
+        m_file.Clear();
+        m_file.Resize(offset);
+      }
+    }
+
+    m_idle_cv.notify_all();
+  }
+}
+}  // namespace Movie
@@ -0,0 +1,80 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+
+namespace Movie
+{
+// Savestates taken every so often during a recording or its playback, so that seeking to a frame
+// only has to emulate the frames after the closest keyframe before it. They are stored next to
+// the DTM (which other programs parse, so it's left alone) in a file of records that are each
+// appended as soon as they have been compressed. An interrupted recording therefore still leaves
+// a usable file. The record headers are read into an index when the file is opened.
+class KeyframeFile
+{
+public:
+  KeyframeFile() = default;
+  ~KeyframeFile();
+
+  KeyframeFile(const KeyframeFile&) = delete;
+  KeyframeFile& operator=(const KeyframeFile&) = delete;
+
+  bool Open(const std::string& path, bool discard_existing);
+  // Waits for the keyframes that are still being compressed to be written.
+  void Close();
+
+  bool IsOpen() const { return m_file.IsOpen(); }
+  const std::string& GetPath() const { return m_path; }
+
+  // Compresses and appends the state on a separate thread. To keep memory use bounded, the
+  // keyframe is dropped if the previous one is still being compressed.
+  void Add(u64 frame, std::vector<u8> state);
+  // Waits for all added keyframes to be written.
+  void Flush();
+  // Removes the keyframes after the given frame, for when the movie gets rerecorded from there.
+  void Truncate(u64 frame);
+
+  // Returns the last frame with a keyframe that is at most the given frame.
+  std::optional<u64> FindKeyframe(u64 frame) const;
+  // Includes the keyframe that's still being written, if any.
+  std::optional<u64> GetLastFrame() const;
+  bool Read(u64 frame, std::vector<u8>* state);
+
+private:
+  struct Entry
+  {
+    u64 offset;
+    u64 size;
+    u64 compressed_size;
+  };
+
+  void WriterThread();
+
+  std::string m_path;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_work_cv;
+  std::condition_variable m_idle_cv;
+  File::IOFile m_file;
+  std::map<u64, Entry> m_index;
+  std::optional<u64> m_last_frame;
+  std::deque<std::pair<u64, std::vector<u8>>> m_pending;
+  bool m_writing = false;
+  bool m_exiting = false;
+  std::thread m_writer_thread;
+};
+}  // namespace Movie
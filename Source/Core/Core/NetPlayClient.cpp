@@ -17,7 +17,6 @@
 #include <vector>
 
 #include <fmt/format.h>
-#include <lzo/lzo1x.h>
 #include <mbedtls/md5.h>
 
 #include "Common/Assert.h"
@@ -38,6 +37,8 @@
 #include "Core/ActionReplay.h"
 #include "Core/Config/NetplaySettings.h"
 #include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
 #include "Core/GeckoCode.h"
 #include "Core/HW/EXI/EXI_DeviceIPL.h"
 #include "Core/HW/SI/SI.h"
@@ -281,6 +282,8 @@ bool NetPlayClient::Connect()
 
     m_dialog->Update();
 
+    SendSyncChunks();
+
     m_is_connected = true;
 
     return true;
@@ -492,6 +495,23 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
   }
   break;
 
+  case NP_MSG_INPUT_STREAM:
+  {
+    u32 game;
+    PlayerId sender;
+    packet >> game >> sender;
+
+    // if this is input from the last game still being received, ignore it
+    if (game != m_current_game)
+      break;
+
+    m_input_streams[sender].Receive(packet, [this](sf::Packet& message) {
+      OnData(message);
+      return true;
+    });
+  }
+  break;
+
   case NP_MSG_PAD_HOST_DATA:
   {
     while (!packet.endOfPacket())
@@ -710,6 +730,7 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
       packet >> m_net_settings.m_DeferEFBCopies;
       packet >> m_net_settings.m_EFBAccessTileSize;
       packet >> m_net_settings.m_EFBAccessDeferInvalidation;
+      packet >> m_net_settings.m_EFBAccessMaxStaleness;
       packet >> m_net_settings.m_StrictSettingsSync;
 
       m_initial_rtc = Common::PacketReadU64(packet);
@@ -723,9 +744,12 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
         packet >> extension;
 
       packet >> m_net_settings.m_GolfMode;
+      packet >> m_net_settings.m_Rollback;
 
       m_net_settings.m_IsHosting = m_local_player->IsHost();
       m_net_settings.m_HostInputAuthority = m_host_input_authority;
+
+      m_input_streams.clear();
     }
 
     m_dialog->OnMsgStartGame();
@@ -770,6 +794,7 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
       std::lock_guard lkp(m_crit.players);
       Player& player = m_players[pid];
       packet >> player.ping;
+      packet >> player.jitter;
     }
 
     DisplayPlayersPing();
@@ -1251,8 +1276,8 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
 
 void NetPlayClient::Send(const sf::Packet& packet, const u8 channel_id)
 {
-  ENetPacket* epac =
-      enet_packet_create(packet.getData(), packet.getDataSize(), ENET_PACKET_FLAG_RELIABLE);
+  const u32 flags = channel_id == INPUT_CHANNEL ? 0 : ENET_PACKET_FLAG_RELIABLE;
+  ENetPacket* epac = enet_packet_create(packet.getData(), packet.getDataSize(), flags);
   enet_peer_send(m_server, channel_id, epac);
 }
 
@@ -1261,8 +1286,18 @@ void NetPlayClient::DisplayPlayersPing()
   if (!g_ActiveConfig.bShowNetPlayPing)
     return;
 
-  OSD::AddTypedMessage(OSD::MessageType::NetPlayPing, fmt::format("Ping: {}", GetPlayersMaxPing()),
-                       OSD::Duration::SHORT, OSD::Color::CYAN);
+  std::string message = fmt::format("Ping: {}", GetPlayersMaxPing());
+  if (!m_host_input_authority && !IsRollbackEnabled())
+  {
+    const u32 max_jitter =
+        std::max_element(m_players.begin(), m_players.end(), [](const auto& a, const auto& b) {
+          return a.second.jitter < b.second.jitter;
+        })->second.jitter;
+    message += fmt::format(" | Jitter: {} | Buffer: {}", max_jitter, m_target_buffer_size);
+  }
+
+  OSD::AddTypedMessage(OSD::MessageType::NetPlayPing, message, OSD::Duration::SHORT,
+                       OSD::Color::CYAN);
 }
 
 u32 NetPlayClient::GetPlayersMaxPing() const
@@ -1474,7 +1509,18 @@ void NetPlayClient::SendWiimoteState(const int in_game_pad, const WiimoteInput&
   packet << static_cast<u8>(nw.report_id);
   packet << static_cast<u8>(nw.data.size());
   packet.append(nw.data.data(), nw.data.size());
-  SendAsync(std::move(packet));
+  SendInput(packet);
+}
+
+// called from ---CPU--- thread
+void NetPlayClient::SendInput(const sf::Packet& packet)
+{
+  sf::Packet reliable;
+  sf::Packet unreliable;
+  m_input_stream.Push(packet, m_current_game, m_local_player->pid, reliable, unreliable);
+
+  SendAsync(std::move(reliable));
+  SendAsync(std::move(unreliable), INPUT_CHANNEL);
 }
 
 // called from ---GUI--- thread
@@ -1509,6 +1555,7 @@ bool NetPlayClient::StartGame(const std::string& path)
   }
 
   m_timebase_frame = 0;
+  m_timebase_next_unsent_frame = 0;
   m_current_golfer = 1;
   m_wait_on_input = false;
 
@@ -1516,6 +1563,8 @@ bool NetPlayClient::StartGame(const std::string& path)
   NetPlay_Enable(this);
 
   ClearBuffers();
+  ResetRollback();
+  m_input_stream.Reset();
 
   m_first_pad_status_received.fill(false);
 
@@ -1549,6 +1598,16 @@ bool NetPlayClient::StartGame(const std::string& path)
   return true;
 }
 
+void NetPlayClient::SendSyncChunks()
+{
+  sf::Packet packet;
+  packet << static_cast<MessageId>(NP_MSG_SYNC_SAVE_DATA);
+  packet << static_cast<MessageId>(SYNC_SAVE_DATA_CHUNKS);
+  WriteSyncChunkSet(m_sync_chunk_cache.GetChunks(), packet);
+
+  Send(packet);
+}
+
 void NetPlayClient::SyncSaveDataResponse(const bool success)
 {
   m_dialog->AppendChat(success ? Common::GetStringT("Data received!") :
@@ -1558,6 +1617,10 @@ void NetPlayClient::SyncSaveDataResponse(const bool success)
   {
     if (++m_sync_save_data_success_count >= m_sync_save_data_count)
     {
+      // Let the server know about the new chunks before the next sync
+      m_sync_chunk_cache.Trim();
+      SendSyncChunks();
+
       sf::Packet response_packet;
       response_packet << static_cast<MessageId>(NP_MSG_SYNC_SAVE_DATA);
       response_packet << static_cast<MessageId>(SYNC_SAVE_DATA_SUCCESS);
@@ -1605,9 +1668,11 @@ void NetPlayClient::SyncCodeResponse(const bool success)
 
 bool NetPlayClient::DecompressPacketIntoFile(sf::Packet& packet, const std::string& file_path)
 {
-  u64 file_size = Common::PacketReadU64(packet);
+  const auto buffer = DecompressPacketIntoBuffer(packet);
+  if (!buffer)
+    return false;
 
-  if (file_size == 0)
+  if (buffer->empty())
     return true;
 
   File::IOFile file(file_path, "wb");
@@ -1617,35 +1682,10 @@ bool NetPlayClient::DecompressPacketIntoFile(sf::Packet& packet, const std::stri
     return false;
   }
 
-  std::vector<u8> in_buffer(NETPLAY_LZO_OUT_LEN);
-  std::vector<u8> out_buffer(NETPLAY_LZO_IN_LEN);
-
-  while (true)
+  if (!file.WriteBytes(buffer->data(), buffer->size()))
   {
-    u32 cur_len = 0;       // number of bytes to read
-    lzo_uint new_len = 0;  // number of bytes to write
-
-    packet >> cur_len;
-    if (!cur_len)
-      break;  // We reached the end of the data stream
-
-    for (size_t j = 0; j < cur_len; j++)
-    {
-      packet >> in_buffer[j];
-    }
-
-    if (lzo1x_decompress(in_buffer.data(), cur_len, out_buffer.data(), &new_len, nullptr) !=
-        LZO_E_OK)
-    {
-      PanicAlertFmtT("Internal LZO Error - decompression failed");
-      return false;
-    }
-
-    if (!file.WriteBytes(out_buffer.data(), new_len))
-    {
-      PanicAlertFmtT("Error writing file: {0}", file_path);
-      return false;
-    }
+    PanicAlertFmtT("Error writing file: {0}", file_path);
+    return false;
   }
 
   return true;
@@ -1653,40 +1693,7 @@ bool NetPlayClient::DecompressPacketIntoFile(sf::Packet& packet, const std::stri
 
 std::optional<std::vector<u8>> NetPlayClient::DecompressPacketIntoBuffer(sf::Packet& packet)
 {
-  u64 size = Common::PacketReadU64(packet);
-
-  std::vector<u8> out_buffer(size);
-
-  if (size == 0)
-    return out_buffer;
-
-  std::vector<u8> in_buffer(NETPLAY_LZO_OUT_LEN);
-
-  lzo_uint i = 0;
-  while (true)
-  {
-    u32 cur_len = 0;       // number of bytes to read
-    lzo_uint new_len = 0;  // number of bytes to write
-
-    packet >> cur_len;
-    if (!cur_len)
-      break;  // We reached the end of the data stream
-
-    for (size_t j = 0; j < cur_len; j++)
-    {
-      packet >> in_buffer[j];
-    }
-
-    if (lzo1x_decompress(in_buffer.data(), cur_len, &out_buffer[i], &new_len, nullptr) != LZO_E_OK)
-    {
-      PanicAlertFmtT("Internal LZO Error - decompression failed");
-      return {};
-    }
-
-    i += new_len;
-  }
-
-  return out_buffer;
+  return m_sync_chunk_cache.DecompressSyncData(packet);
 }
 
 // called from ---GUI--- thread
@@ -1831,6 +1838,9 @@ bool NetPlayClient::GetNetPads(const int pad_nb, const bool batching, GCPadStatu
   // specific pad arbitrarily. In this case, we poll just that pad
   // and send it.
 
+  if (IsRollbackEnabled())
+    return GetRollbackPads(pad_nb, batching, pad_status);
+
   // When here when told to so we don't deadlock in certain situations
   while (m_wait_on_input)
   {
@@ -1865,7 +1875,7 @@ bool NetPlayClient::GetNetPads(const int pad_nb, const bool batching, GCPadStatu
     }
 
     if (send_packet)
-      SendAsync(std::move(packet));
+      SendInput(packet);
 
     if (m_host_input_authority)
       SendPadHostPoll(-1);
@@ -1879,7 +1889,7 @@ bool NetPlayClient::GetNetPads(const int pad_nb, const bool batching, GCPadStatu
       sf::Packet packet;
       packet << static_cast<MessageId>(NP_MSG_PAD_DATA);
       if (PollLocalPad(local_pad, packet))
-        SendAsync(std::move(packet));
+        SendInput(packet);
     }
 
     if (m_host_input_authority)
@@ -2054,6 +2064,16 @@ bool NetPlayClient::PollLocalPad(const int local_pad, sf::Packet& packet)
       m_first_pad_status_received[ingame_pad] = true;
     }
   }
+  else if (IsRollbackEnabled())
+  {
+    // used right away, and sent only once since the other players predict it until it arrives
+    RollbackFrame& frame = GetRollbackFrame(m_rollback_next_frame);
+    frame.pads[ingame_pad] = pad_status;
+    frame.confirmed[ingame_pad] = true;
+
+    AddPadStateToPacket(ingame_pad, pad_status, packet);
+    data_added = true;
+  }
   else
   {
     // adjust the buffer either up or down
@@ -2072,6 +2092,230 @@ bool NetPlayClient::PollLocalPad(const int local_pad, sf::Packet& packet)
   return data_added;
 }
 
+static bool IsSamePadStatus(const GCPadStatus& a, const GCPadStatus& b)
+{
+  return a.button == b.button && a.stickX == b.stickX && a.stickY == b.stickY &&
+         a.substickX == b.substickX && a.substickY == b.substickY &&
+         a.triggerLeft == b.triggerLeft && a.triggerRight == b.triggerRight &&
+         a.analogA == b.analogA && a.analogB == b.analogB && a.isConnected == b.isConnected;
+}
+
+bool NetPlayClient::IsRollbackEnabled() const
+{
+  // Only GameCube controllers are rolled back, so Wii games with Wii Remotes would desync
+  return m_net_settings.m_Rollback && !SConfig::GetInstance().bWii;
+}
+
+// called from ---GUI--- thread, before the game starts
+void NetPlayClient::ResetRollback()
+{
+  m_rollback_frames.clear();
+  m_rollback_first_frame = 0;
+  m_rollback_next_frame = 0;
+  m_rollback_new_frame = 0;
+  m_rollback_current_frame.reset();
+  m_rollback_mispredicted_frame.reset();
+  m_rollback_received.fill(0);
+  m_rollback_last_received.fill(GCPadStatus{});
+  m_rollback_states.Clear();
+  SetRollbackReplaying(false);
+}
+
+// called from ---CPU--- thread
+bool NetPlayClient::GetRollbackPads(const int pad_nb, const bool batching,
+                                    GCPadStatus* pad_status)
+{
+  // In rollback mode, a frame starts with every batched poll of the first in-game pad (or with
+  // whatever poll comes first). The local inputs are used right away, and the ones of the other
+  // players are predicted to stay the same until they arrive. The state at the start of every
+  // frame is saved, so that when an input turns out to be predicted wrong, the game goes back to
+  // the frame it was used in and emulates the frames since then again as fast as possible,
+  // without showing them. Every player uses the same inputs for every frame in the end.
+  //
+  // Each frame's inputs are sent exactly once and arrive in order, so counting them is enough to
+  // know which frame they're for. The input buffer isn't used in this mode.
+  if (!m_rollback_current_frame || (batching && IsFirstInGamePad(pad_nb)))
+  {
+    if (!BeginRollbackFrame())
+      return false;
+  }
+
+  *pad_status = GetRollbackFrame(*m_rollback_current_frame).pads[pad_nb];
+  return true;
+}
+
+// called from ---CPU--- thread
+bool NetPlayClient::BeginRollbackFrame()
+{
+  const u64 frame = m_rollback_next_frame;
+  ReceiveRollbackPads();
+
+  if (frame == m_rollback_new_frame)
+  {
+    sf::Packet packet;
+    packet << static_cast<MessageId>(NP_MSG_PAD_DATA);
+
+    bool send_packet = false;
+    const int num_local_pads = NumLocalPads();
+    for (int local_pad = 0; local_pad < num_local_pads; local_pad++)
+      send_packet = PollLocalPad(local_pad, packet) || send_packet;
+
+    if (send_packet)
+      SendInput(packet);
+
+    m_rollback_new_frame = frame + 1;
+
+    // Sent before waiting, since the other players might be waiting for it as well
+    while (IsRollbackStalled(frame))
+    {
+      if (!m_is_running.IsSet())
+        return false;
+
+      m_gc_pad_event.Wait();
+      ReceiveRollbackPads();
+    }
+  }
+
+  RollbackFrame& current = GetRollbackFrame(frame);
+  for (size_t i = 0; i < current.pads.size(); ++i)
+  {
+    if (!current.confirmed[i])
+      current.pads[i] = m_rollback_last_received[i];
+  }
+
+  m_rollback_current_frame = frame;
+  m_rollback_next_frame = frame + 1;
+  SetRollbackReplaying(m_rollback_next_frame < m_rollback_new_frame);
+
+  // Frames from the current one on get emulated (again) with the inputs that arrived anyway
+  if (m_rollback_mispredicted_frame && *m_rollback_mispredicted_frame < frame)
+  {
+    const u64 mispredicted_frame = *m_rollback_mispredicted_frame;
+    CoreTiming::RunAtEndOfSlice([mispredicted_frame] {
+      std::lock_guard lk(crit_netplay_client);
+      if (netplay_client)
+        netplay_client->LoadRollbackState(mispredicted_frame);
+    });
+  }
+  else
+  {
+    CoreTiming::RunAtEndOfSlice([next_frame = frame + 1] {
+      std::lock_guard lk(crit_netplay_client);
+      if (netplay_client)
+        netplay_client->SaveRollbackState(next_frame);
+    });
+  }
+  m_rollback_mispredicted_frame.reset();
+
+  // Keep the frames that haven't been confirmed yet, since they might have to be gone back to, and
+  // the one before them, whose inputs are used until the next batched poll after going back
+  u64 first_needed_frame = frame;
+  for (size_t i = 0; i < m_pad_map.size(); ++i)
+  {
+    if (m_pad_map[i] > 0 && m_pad_map[i] != m_local_player->pid)
+      first_needed_frame = std::min(first_needed_frame, m_rollback_received[i]);
+  }
+  if (first_needed_frame > 0)
+    first_needed_frame--;
+  while (m_rollback_first_frame < first_needed_frame && !m_rollback_frames.empty())
+  {
+    m_rollback_frames.pop_front();
+    m_rollback_first_frame++;
+  }
+
+  return true;
+}
+
+// called from ---CPU--- thread
+void NetPlayClient::ReceiveRollbackPads()
+{
+  for (size_t i = 0; i < m_pad_map.size(); ++i)
+  {
+    if (m_pad_map[i] <= 0 || m_pad_map[i] == m_local_player->pid)
+      continue;
+
+    GCPadStatus pad_status;
+    while (m_pad_buffer[i].Pop(pad_status))
+    {
+      const u64 frame = m_rollback_received[i]++;
+      RollbackFrame& received = GetRollbackFrame(frame);
+      if (frame < m_rollback_new_frame && !IsSamePadStatus(received.pads[i], pad_status))
+      {
+        if (!m_rollback_mispredicted_frame || frame < *m_rollback_mispredicted_frame)
+          m_rollback_mispredicted_frame = frame;
+      }
+
+      received.pads[i] = pad_status;
+      received.confirmed[i] = true;
+      m_rollback_last_received[i] = pad_status;
+    }
+  }
+}
+
+bool NetPlayClient::IsRollbackStalled(const u64 frame) const
+{
+  // The inputs of the first frame can't be predicted, since there's nothing to go back to
+  for (size_t i = 0; i < m_pad_map.size(); ++i)
+  {
+    if (m_pad_map[i] <= 0 || m_pad_map[i] == m_local_player->pid)
+      continue;
+
+    const u64 received = m_rollback_received[i];
+    if (received <= frame && (frame == 0 || frame - received >= ROLLBACK_MAX_FRAMES))
+      return true;
+  }
+
+  return false;
+}
+
+NetPlayClient::RollbackFrame& NetPlayClient::GetRollbackFrame(const u64 frame)
+{
+  DEBUG_ASSERT(frame >= m_rollback_first_frame);
+
+  while (frame - m_rollback_first_frame >= m_rollback_frames.size())
+  {
+    RollbackFrame& new_frame = m_rollback_frames.emplace_back();
+    for (size_t i = 0; i < m_pad_map.size(); ++i)
+      new_frame.confirmed[i] = m_pad_map[i] <= 0;
+  }
+
+  return m_rollback_frames[frame - m_rollback_first_frame];
+}
+
+void NetPlayClient::SetRollbackReplaying(const bool replaying)
+{
+  if (m_rollback_replaying == replaying)
+    return;
+
+  m_rollback_replaying = replaying;
+  Core::SetIsPresentationSuppressed(replaying);
+}
+
+// called from ---CPU--- thread
+void NetPlayClient::SaveRollbackState(const u64 frame)
+{
+  m_rollback_states.Save(frame);
+  GetRollbackFrame(frame).timebase_frame = m_timebase_frame;
+}
+
+// called from ---CPU--- thread
+void NetPlayClient::LoadRollbackState(const u64 frame)
+{
+  if (!m_rollback_states.Load(frame))
+  {
+    // Some of the state is from other frames now, so there's no way to recover from this
+    OSD::AddMessage("Rollback failed, the game is likely out of sync now", OSD::Duration::NORMAL,
+                    OSD::Color::RED);
+    return;
+  }
+
+  // The first frame is never gone back to, since its inputs aren't predicted
+  m_rollback_next_frame = frame;
+  m_rollback_current_frame = frame - 1;
+  m_timebase_frame = GetRollbackFrame(frame).timebase_frame;
+  SetRollbackReplaying(true);
+}
+
 void NetPlayClient::SendPadHostPoll(const PadIndex pad_num)
 {
   // Here we handle polling for the Host Input Authority and Golf modes. Pad data is "polled" from
@@ -2151,6 +2395,7 @@ bool NetPlayClient::StopGame()
   m_wait_on_input_event.Set();
 
   NetPlay_Disable();
+  SetRollbackReplaying(false);
 
   // stop game
   m_dialog->StopGame();
@@ -2293,8 +2538,11 @@ void NetPlayClient::SendTimeBase()
 {
   std::lock_guard lk(crit_netplay_client);
 
-  if (netplay_client->m_timebase_frame % 60 == 0)
+  if (netplay_client->m_timebase_frame % 60 == 0 &&
+      netplay_client->m_timebase_frame >= netplay_client->m_timebase_next_unsent_frame)
   {
+    netplay_client->m_timebase_next_unsent_frame = netplay_client->m_timebase_frame + 1;
+
     const sf::Uint64 timebase = SystemTimers::GetFakeTimeBase();
 
     sf::Packet packet;
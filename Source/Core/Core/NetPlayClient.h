@@ -7,6 +7,7 @@
 #include <SFML/Network/Packet.hpp>
 #include <array>
 #include <chrono>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -21,7 +22,10 @@
 #include "Common/Event.h"
 #include "Common/SPSCQueue.h"
 #include "Common/TraversalClient.h"
+#include "Core/NetPlayInputStream.h"
 #include "Core/NetPlayProto.h"
+#include "Core/NetPlayRollback.h"
+#include "Core/NetPlaySyncChunks.h"
 #include "Core/SyncIdentifier.h"
 #include "InputCommon/GCPadStatus.h"
 
@@ -85,6 +89,8 @@ public:
   std::string name;
   std::string revision;
   u32 ping;
+  // How much the ping typically varies, in milliseconds
+  u32 jitter = 0;
   SyncIdentifierComparison game_status;
 
   bool IsHost() const { return pid == 1; }
@@ -220,17 +226,39 @@ private:
   void SendStartGamePacket();
   void SendStopGamePacket();
 
+  void SendSyncChunks();
   void SyncSaveDataResponse(bool success);
   void SyncCodeResponse(bool success);
   bool DecompressPacketIntoFile(sf::Packet& packet, const std::string& file_path);
   std::optional<std::vector<u8>> DecompressPacketIntoBuffer(sf::Packet& packet);
 
   bool PollLocalPad(int local_pad, sf::Packet& packet);
+
+  // Rollback mode, see GetRollbackPads
+  struct RollbackFrame
+  {
+    std::array<GCPadStatus, 4> pads{};
+    std::array<bool, 4> confirmed{};
+    // m_timebase_frame at the start of the frame
+    u32 timebase_frame = 0;
+  };
+
+  bool IsRollbackEnabled() const;
+  void ResetRollback();
+  bool GetRollbackPads(int pad_nb, bool batching, GCPadStatus* pad_status);
+  bool BeginRollbackFrame();
+  void ReceiveRollbackPads();
+  bool IsRollbackStalled(u64 frame) const;
+  RollbackFrame& GetRollbackFrame(u64 frame);
+  void SetRollbackReplaying(bool replaying);
+  void SaveRollbackState(u64 frame);
+  void LoadRollbackState(u64 frame);
   void SendPadHostPoll(PadIndex pad_num);
 
   void UpdateDevices();
   void AddPadStateToPacket(int in_game_pad, const GCPadStatus& np, sf::Packet& packet);
   void SendWiimoteState(int in_game_pad, const WiimoteInput& nw);
+  void SendInput(const sf::Packet& packet);
   unsigned int OnData(sf::Packet& packet);
   void Send(const sf::Packet& packet, u8 channel_id = DEFAULT_CHANNEL);
   void Disconnect();
@@ -245,6 +273,9 @@ private:
   PlayerId m_pid = 0;
   NetSettings m_net_settings{};
   std::map<PlayerId, Player> m_players;
+  // Input sent by ---CPU--- thread, and received by ---NETPLAY--- thread, for each sender
+  InputStreamSender m_input_stream;
+  std::map<PlayerId, InputStreamReceiver> m_input_streams;
   std::string m_host_spec;
   std::string m_player_name;
   bool m_connecting = false;
@@ -257,6 +288,7 @@ private:
   Common::Event m_wait_on_input_event;
   u8 m_sync_save_data_count = 0;
   u8 m_sync_save_data_success_count = 0;
+  SyncChunkCache m_sync_chunk_cache;
   u16 m_sync_gecko_codes_count = 0;
   u16 m_sync_gecko_codes_success_count = 0;
   bool m_sync_gecko_codes_complete = false;
@@ -267,6 +299,24 @@ private:
 
   u64 m_initial_rtc = 0;
   u32 m_timebase_frame = 0;
+  // In rollback mode, the time base isn't sent again for frames that are emulated again
+  u32 m_timebase_next_unsent_frame = 0;
+
+  // The frames that can still be gone back to or whose inputs haven't all arrived, oldest first
+  std::deque<RollbackFrame> m_rollback_frames;
+  u64 m_rollback_first_frame = 0;
+  // The frame that the next batched poll starts
+  u64 m_rollback_next_frame = 0;
+  // The first frame that hasn't been emulated yet, as opposed to emulated again
+  u64 m_rollback_new_frame = 0;
+  std::optional<u64> m_rollback_current_frame;
+  // The earliest frame whose inputs turned out to be predicted wrong
+  std::optional<u64> m_rollback_mispredicted_frame;
+  // How many frames of inputs of each remote pad have arrived, and the last of them
+  std::array<u64, 4> m_rollback_received{};
+  std::array<GCPadStatus, 4> m_rollback_last_received{};
+  bool m_rollback_replaying = false;
+  RollbackStateBuffer m_rollback_states{ROLLBACK_MAX_FRAMES};
 };
 
 void NetPlay_Enable(NetPlayClient* const np);
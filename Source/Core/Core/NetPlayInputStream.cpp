@@ -0,0 +1,91 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/NetPlayInputStream.h"
+
+#include <SFML/Network/Packet.hpp>
+
+namespace NetPlay
+{
+static void WriteMessage(const std::vector<u8>& message, sf::Packet& packet)
+{
+  packet << static_cast<u16>(message.size());
+  packet.append(message.data(), message.size());
+}
+
+void InputStreamSender::Reset()
+{
+  m_next_sequence = 0;
+  m_history.clear();
+}
+
+void InputStreamSender::Push(const sf::Packet& message, u32 game, PlayerId sender,
+                             sf::Packet& reliable, sf::Packet& unreliable)
+{
+  const u8* data = static_cast<const u8*>(message.getData());
+  m_history.emplace_back(data, data + message.getDataSize());
+  if (m_history.size() > INPUT_STREAM_REDUNDANCY)
+    m_history.pop_front();
+
+  const u32 sequence = m_next_sequence++;
+
+  reliable << static_cast<MessageId>(NP_MSG_INPUT_STREAM) << game << sender;
+  reliable << sequence << static_cast<u8>(1);
+  WriteMessage(m_history.back(), reliable);
+
+  unreliable << static_cast<MessageId>(NP_MSG_INPUT_STREAM) << game << sender;
+  unreliable << sequence + 1 - static_cast<u32>(m_history.size())
+             << static_cast<u8>(m_history.size());
+  for (const std::vector<u8>& entry : m_history)
+    WriteMessage(entry, unreliable);
+}
+
+void InputStreamReceiver::Reset()
+{
+  m_next_sequence = 0;
+}
+
+bool InputStreamReceiver::Receive(sf::Packet& packet,
+                                  const std::function<bool(sf::Packet&)>& handler)
+{
+  u32 sequence = 0;
+  u8 count = 0;
+  packet >> sequence >> count;
+
+  std::vector<u8> data;
+  for (u8 i = 0; i < count; ++i, ++sequence)
+  {
+    u16 size = 0;
+    packet >> size;
+    data.resize(size);
+    for (u8& byte : data)
+      packet >> byte;
+
+    if (!packet || sequence > m_next_sequence)
+      break;
+    if (sequence < m_next_sequence)
+      continue;
+
+    sf::Packet message;
+    message.append(data.data(), data.size());
+    if (!IsInputMessage(message))
+      return false;
+
+    ++m_next_sequence;
+    if (!handler(message))
+      return false;
+  }
+
+  return true;
+}
+
+bool InputStreamReceiver::IsInputMessage(const sf::Packet& message)
+{
+  if (message.getDataSize() == 0)
+    return false;
+
+  const MessageId id = *static_cast<const u8*>(message.getData());
+  return id == NP_MSG_PAD_DATA || id == NP_MSG_WIIMOTE_DATA;
+}
+}  // namespace NetPlay
@@ -0,0 +1,61 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/NetPlayProto.h"
+
+namespace sf
+{
+class Packet;
+}
+
+namespace NetPlay
+{
+// How many of the latest input messages every unreliable NP_MSG_INPUT_STREAM packet contains
+constexpr size_t INPUT_STREAM_REDUNDANCY = 8;
+
+// Pad and Wiimote data is sent twice: reliably on DEFAULT_CHANNEL, and unreliably together with
+// the messages before it on INPUT_CHANNEL. Whichever copy arrives first is used. A lost packet
+// then usually doesn't have to wait for ENet to send it again, which would also hold up every
+// reliable packet after it, and the reliable copy is only needed after a run of losses.
+//
+// NP_MSG_INPUT_STREAM: u32 game, PlayerId sender, u32 first sequence number, u8 message count,
+// and then every message as a u16 size followed by its bytes.
+class InputStreamSender
+{
+public:
+  void Reset();
+
+  // Builds the packets that carry the given message on DEFAULT_CHANNEL and on INPUT_CHANNEL.
+  void Push(const sf::Packet& message, u32 game, PlayerId sender, sf::Packet& reliable,
+            sf::Packet& unreliable);
+
+private:
+  u32 m_next_sequence = 0;
+  std::deque<std::vector<u8>> m_history;
+};
+
+class InputStreamReceiver
+{
+public:
+  void Reset();
+
+  // Reads the rest of an NP_MSG_INPUT_STREAM packet after the game and the sender, and calls the
+  // handler in order with every message that hasn't been received yet. Messages after a gap are
+  // dropped, since their reliable copies are still on their way. Returns false if the handler did.
+  bool Receive(sf::Packet& packet, const std::function<bool(sf::Packet&)>& handler);
+
+  // Whether the message is one of those that are sent as part of an input stream
+  static bool IsInputMessage(const sf::Packet& message);
+
+private:
+  u32 m_next_sequence = 0;
+};
+}  // namespace NetPlay
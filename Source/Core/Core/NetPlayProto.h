@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <string>
 #include <vector>
 #include "Common/CommonTypes.h"
 #include "Core/HW/EXI/EXI_Device.h"
@@ -76,6 +77,7 @@ struct NetSettings
   bool m_DeferEFBCopies;
   bool m_EFBAccessTileSize;
   bool m_EFBAccessDeferInvalidation;
+  int m_EFBAccessMaxStaleness;
   bool m_StrictSettingsSync;
   bool m_SyncSaveData;
   bool m_SyncCodes;
@@ -83,6 +85,7 @@ struct NetSettings
   bool m_SyncAllWiiSaves;
   std::array<int, 4> m_WiimoteExtension;
   bool m_GolfMode;
+  bool m_Rollback;
 
   // These aren't sent over the network directly
   bool m_IsHosting;
@@ -127,6 +130,7 @@ enum
   NP_MSG_PAD_MAPPING = 0x61,
   NP_MSG_PAD_BUFFER = 0x62,
   NP_MSG_PAD_HOST_DATA = 0x63,
+  NP_MSG_INPUT_STREAM = 0x64,
 
   NP_MSG_WIIMOTE_DATA = 0x70,
   NP_MSG_WIIMOTE_MAPPING = 0x71,
@@ -182,7 +186,8 @@ enum
   SYNC_SAVE_DATA_FAILURE = 2,
   SYNC_SAVE_DATA_RAW = 3,
   SYNC_SAVE_DATA_GCI = 4,
-  SYNC_SAVE_DATA_WII = 5
+  SYNC_SAVE_DATA_WII = 5,
+  SYNC_SAVE_DATA_CHUNKS = 6
 };
 
 enum
@@ -196,13 +201,13 @@ enum
   SYNC_CODES_FAILURE = 6,
 };
 
-constexpr u32 NETPLAY_LZO_IN_LEN = 1024 * 64;
-constexpr u32 NETPLAY_LZO_OUT_LEN = NETPLAY_LZO_IN_LEN + (NETPLAY_LZO_IN_LEN / 16) + 64 + 3;
 constexpr u32 MAX_NAME_LENGTH = 30;
 constexpr size_t CHUNKED_DATA_UNIT_SIZE = 16384;
-constexpr u8 CHANNEL_COUNT = 2;
+constexpr u8 CHANNEL_COUNT = 3;
 constexpr u8 DEFAULT_CHANNEL = 0;
 constexpr u8 CHUNKED_DATA_CHANNEL = 1;
+// Unreliable, see InputStreamSender
+constexpr u8 INPUT_CHANNEL = 2;
 
 struct WiimoteInput
 {
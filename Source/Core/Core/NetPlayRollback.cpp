@@ -0,0 +1,99 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/NetPlayRollback.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "Common/Logging/Log.h"
+#include "Core/State.h"
+
+namespace NetPlay
+{
+// How many buffers of dropped snapshots are kept around, so that saving a snapshot doesn't have
+// to allocate (and page fault in) a new one every frame.
+constexpr size_t MAX_SPARE_BUFFERS = 2;
+
+RollbackStateBuffer::RollbackStateBuffer(u32 max_frames)
+    : m_max_frames(std::max<u32>(max_frames, 1))
+{
+}
+
+void RollbackStateBuffer::Clear()
+{
+  m_snapshots.clear();
+  m_oldest_is_full = false;
+}
+
+void RollbackStateBuffer::Save(u64 frame)
+{
+  if (!m_snapshots.empty() && m_snapshots.back().frame + 1 != frame)
+  {
+    WARN_LOG_FMT(NETPLAY, "Rollback snapshot of frame {} doesn't follow the one of frame {}", frame,
+                 m_snapshots.back().frame);
+    Clear();
+  }
+
+  std::vector<u8> buffer;
+  if (!m_spare_buffers.empty())
+  {
+    buffer = std::move(m_spare_buffers.back());
+    m_spare_buffers.pop_back();
+  }
+
+  // The pages that are included in every delta snapshot anyway depend on the frame, so that the
+  // frames that were emulated again after going back still contain all of memory together.
+  const bool delta = !m_snapshots.empty();
+  State::SaveSnapshot(buffer, delta, m_max_frames, static_cast<u32>(frame % m_max_frames));
+  if (!delta)
+    m_oldest_is_full = true;
+  m_snapshots.push_back({frame, std::move(buffer)});
+
+  // Enough so that the last m_max_frames + 1 frames each have m_max_frames - 1 others before them
+  while (m_snapshots.size() > size_t(m_max_frames) * 2)
+  {
+    if (m_spare_buffers.size() < MAX_SPARE_BUFFERS)
+      m_spare_buffers.push_back(std::move(m_snapshots.front().data));
+    m_snapshots.pop_front();
+    m_oldest_is_full = false;
+  }
+}
+
+bool RollbackStateBuffer::CanLoad(u64 frame) const
+{
+  if (m_snapshots.empty() || frame < m_snapshots.front().frame || frame > m_snapshots.back().frame)
+    return false;
+
+  const u64 index = frame - m_snapshots.front().frame;
+  return m_oldest_is_full || index + 1 >= m_max_frames;
+}
+
+bool RollbackStateBuffer::Load(u64 frame)
+{
+  if (!CanLoad(frame))
+    return false;
+
+  const size_t last = static_cast<size_t>(frame - m_snapshots.front().frame);
+  const size_t first = last + 1 >= m_max_frames ? last + 1 - m_max_frames : 0;
+  for (size_t i = first; i <= last; ++i)
+  {
+    if (!State::LoadRollbackSnapshot(m_snapshots[i].data, i == first))
+    {
+      ERROR_LOG_FMT(NETPLAY, "Failed to load the rollback snapshot of frame {}",
+                    m_snapshots[i].frame);
+      Clear();
+      return false;
+    }
+  }
+
+  while (m_snapshots.size() > last + 1)
+  {
+    if (m_spare_buffers.size() < MAX_SPARE_BUFFERS)
+      m_spare_buffers.push_back(std::move(m_snapshots.back().data));
+    m_snapshots.pop_back();
+  }
+  return true;
+}
+}  // namespace NetPlay
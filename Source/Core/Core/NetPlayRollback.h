@@ -0,0 +1,51 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace NetPlay
+{
+// How many frames the inputs of the other players are predicted for at most, before waiting for
+// them to arrive. Each frame that has to be emulated again costs about a frame of emulation time.
+constexpr u32 ROLLBACK_MAX_FRAMES = 8;
+
+// The snapshots that NetPlay's rollback mode goes back to when it predicted the inputs of another
+// player wrong. One is saved for every frame (see State::SaveSnapshot). Only the very first one
+// is a full snapshot, since those take far too long to save every frame, but any max_frames
+// consecutive delta snapshots together contain all of memory. CPU thread only.
+class RollbackStateBuffer
+{
+public:
+  explicit RollbackStateBuffer(u32 max_frames);
+
+  void Clear();
+
+  // Saves the state at the start of the given frame. Frames have to be saved in order, unless a
+  // frame that's still in the buffer was loaded, after which the next frame can be saved again.
+  void Save(u64 frame);
+  // Whether the given frame can be gone back to. The last max_frames + 1 frames always can.
+  bool CanLoad(u64 frame) const;
+  // Goes back to the given frame, and drops the snapshots of the frames after it. On failure,
+  // the emulated state is a mix of several frames, and all snapshots are dropped.
+  bool Load(u64 frame);
+
+private:
+  struct Snapshot
+  {
+    u64 frame;
+    std::vector<u8> data;
+  };
+
+  u32 m_max_frames;
+  // Consecutive frames, oldest first
+  std::deque<Snapshot> m_snapshots;
+  bool m_oldest_is_full = false;
+  std::vector<std::vector<u8>> m_spare_buffers;
+};
+}  // namespace NetPlay
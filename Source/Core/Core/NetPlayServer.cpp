@@ -7,8 +7,10 @@
 #include <algorithm>
 #include <chrono>
 #include <cinttypes>
+#include <cmath>
 #include <cstddef>
 #include <cstdio>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -19,7 +21,6 @@
 #include <vector>
 
 #include <fmt/format.h>
-#include <lzo/lzo1x.h>
 
 #include "Common/CommonPaths.h"
 #include "Common/ENetUtil.h"
@@ -613,6 +614,89 @@ void NetPlayServer::AdjustPadBufferSize(unsigned int size)
   }
 }
 
+// called from ---GUI--- thread
+void NetPlayServer::SetAutomaticPadBuffer(const bool enable)
+{
+  std::lock_guard lkg(m_crit.game);
+
+  m_automatic_pad_buffer = enable;
+  m_smaller_pad_buffer_count = 0;
+}
+
+// called from ---NETPLAY--- thread
+void NetPlayServer::UpdatePingStatistics(Client& player, const u32 ping)
+{
+  if (!player.has_ping_sample)
+  {
+    player.smoothed_ping = ping;
+    player.ping_variation = ping / 2.0;
+    player.has_ping_sample = true;
+    return;
+  }
+
+  player.ping_variation += (std::abs(player.smoothed_ping - ping) - player.ping_variation) / 4;
+  player.smoothed_ping += (ping - player.smoothed_ping) / 8;
+}
+
+// called from ---NETPLAY--- thread
+void NetPlayServer::UpdateAutomaticPadBuffer()
+{
+  // Roughly the length of a pad poll at 60 Hz, which is what the buffer is counted in
+  constexpr double POLL_MS = 1000.0 / 60;
+  // Pings of more than this many times the variation above the smoothed ping are rare enough
+  constexpr double PING_VARIATION_MARGIN = 4;
+  // The buffer only gets smaller if it could have been for this many pings (seconds) in a row,
+  // but it gets larger right away, since a buffer that's too small stalls the game
+  constexpr u32 SMALLER_BUFFER_PINGS = 10;
+  constexpr unsigned int MAX_BUFFER_SIZE = 40;
+
+  std::lock_guard lkg(m_crit.game);
+
+  // In host input authority mode, the buffer only sets how far the other players lag behind
+  if (!m_automatic_pad_buffer || m_host_input_authority)
+    return;
+
+  // An input takes half of its sender's ping to reach the server, and half of the receiver's to
+  // get from there to them, so the two players farthest away need the largest buffer.
+  std::vector<double> delays;
+  {
+    std::lock_guard lkp(m_crit.players);
+    for (const auto& [pid, client] : m_players)
+    {
+      if (client.has_ping_sample && PlayerHasControllerMapped(pid))
+      {
+        delays.push_back(
+            (client.smoothed_ping + PING_VARIATION_MARGIN * client.ping_variation) / 2);
+      }
+    }
+  }
+
+  std::sort(delays.begin(), delays.end(), std::greater<>());
+  double delay_ms = 0;
+  for (size_t i = 0; i < std::min<size_t>(delays.size(), 2); ++i)
+    delay_ms += delays[i];
+
+  // One more for the time between an input arriving and the poll that uses it
+  const unsigned int size = std::min(static_cast<unsigned int>(std::ceil(delay_ms / POLL_MS)) + 1,
+                                     MAX_BUFFER_SIZE);
+
+  if (size >= m_target_buffer_size)
+  {
+    m_smaller_pad_buffer_count = 0;
+    if (size > m_target_buffer_size)
+      AdjustPadBufferSize(size);
+    return;
+  }
+
+  m_smaller_pad_buffer_size =
+      m_smaller_pad_buffer_count == 0 ? size : std::max(m_smaller_pad_buffer_size, size);
+  if (++m_smaller_pad_buffer_count >= SMALLER_BUFFER_PINGS)
+  {
+    m_smaller_pad_buffer_count = 0;
+    AdjustPadBufferSize(m_smaller_pad_buffer_size);
+  }
+}
+
 void NetPlayServer::SetHostInputAuthority(const bool enable)
 {
   std::lock_guard lkg(m_crit.game);
@@ -761,7 +845,28 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
     }
     else
     {
-      SendToClients(spac, player.pid);
+      SendInputToClients(spac, player);
+    }
+  }
+  break;
+
+  case NP_MSG_INPUT_STREAM:
+  {
+    u32 game;
+    PlayerId sender;
+    packet >> game >> sender;
+
+    // if this is input from the last game still being received, ignore it
+    if (game != m_current_game || player.current_game != m_current_game)
+      break;
+
+    unsigned int result = 0;
+    if (!player.input_stream.Receive(packet, [&](sf::Packet& message) {
+          result = OnData(message, player);
+          return result == 0;
+        }))
+    {
+      return result != 0 ? result : 1;
     }
   }
   break;
@@ -800,8 +905,9 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
       break;
 
     PadIndex map;
+    u8 report_id;
     u8 size;
-    packet >> map >> size;
+    packet >> map >> report_id >> size;
     std::vector<u8> data(size);
     for (u8& byte : data)
       packet >> byte;
@@ -817,11 +923,12 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
     sf::Packet spac;
     spac << (MessageId)NP_MSG_WIIMOTE_DATA;
     spac << map;
+    spac << report_id;
     spac << size;
     for (const u8& byte : data)
       spac << byte;
 
-    SendToClients(spac, player.pid);
+    SendInputToClients(spac, player);
   }
   break;
 
@@ -891,20 +998,27 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
     if (m_ping_key == ping_key)
     {
       player.ping = ping;
+      UpdatePingStatistics(player, ping);
     }
 
     sf::Packet spac;
     spac << (MessageId)NP_MSG_PLAYER_PING_DATA;
     spac << player.pid;
     spac << player.ping;
+    spac << static_cast<u32>(std::lround(player.ping_variation));
 
     SendToClients(spac);
+
+    if (m_ping_key == ping_key)
+      UpdateAutomaticPadBuffer();
   }
   break;
 
   case NP_MSG_START_GAME:
   {
     packet >> player.current_game;
+    player.input_stream.Reset();
+    player.input_relay.Reset();
   }
   break;
 
@@ -1078,6 +1192,14 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
     }
     break;
 
+    case SYNC_SAVE_DATA_CHUNKS:
+    {
+      SyncChunkSet chunks = ReadSyncChunkSet(packet);
+      std::lock_guard lkp(m_crit.players);
+      player.sync_chunks = std::move(chunks);
+    }
+    break;
+
     default:
       PanicAlertFmtT(
           "Unknown SYNC_SAVE_DATA message with id:{0} received from player:{1} Kicking player!",
@@ -1355,6 +1477,7 @@ bool NetPlayServer::StartGame()
   spac << m_settings.m_DeferEFBCopies;
   spac << m_settings.m_EFBAccessTileSize;
   spac << m_settings.m_EFBAccessDeferInvalidation;
+  spac << m_settings.m_EFBAccessMaxStaleness;
   spac << m_settings.m_StrictSettingsSync;
   spac << initial_rtc;
   spac << m_settings.m_SyncSaveData;
@@ -1373,6 +1496,7 @@ bool NetPlayServer::StartGame()
   }
 
   spac << m_settings.m_GolfMode;
+  spac << m_settings.m_Rollback;
 
   SendAsyncToClients(std::move(spac));
 
@@ -1400,6 +1524,32 @@ bool NetPlayServer::SyncSaveData()
 
   m_save_data_synced_players = 0;
 
+  {
+    std::lock_guard lkp(m_crit.players);
+    m_sync_cached_chunks.clear();
+    bool first = true;
+    for (const auto& player : m_players)
+    {
+      if (player.second.IsHost())
+        continue;
+
+      if (first)
+      {
+        m_sync_cached_chunks = player.second.sync_chunks;
+        first = false;
+        continue;
+      }
+
+      for (auto it = m_sync_cached_chunks.begin(); it != m_sync_cached_chunks.end();)
+      {
+        if (player.second.sync_chunks.count(*it) == 0)
+          it = m_sync_cached_chunks.erase(it);
+        else
+          ++it;
+      }
+    }
+  }
+
   u8 save_count = 0;
 
   constexpr size_t exi_device_count = 2;
@@ -1782,119 +1932,19 @@ bool NetPlayServer::CompressFileIntoPacket(const std::string& file_path, sf::Pac
     return false;
   }
 
-  const sf::Uint64 size = file.GetSize();
-  packet << size;
-
-  if (size == 0)
-    return true;
-
-  std::vector<u8> in_buffer(NETPLAY_LZO_IN_LEN);
-  std::vector<u8> out_buffer(NETPLAY_LZO_OUT_LEN);
-  std::vector<u8> wrkmem(LZO1X_1_MEM_COMPRESS);
-
-  lzo_uint i = 0;
-  while (true)
+  std::vector<u8> in_buffer(file.GetSize());
+  if (!file.ReadBytes(in_buffer.data(), in_buffer.size()))
   {
-    lzo_uint32 cur_len = 0;  // number of bytes to read
-    lzo_uint out_len = 0;    // number of bytes to write
-
-    if ((i + NETPLAY_LZO_IN_LEN) >= size)
-    {
-      cur_len = static_cast<lzo_uint32>(size - i);
-    }
-    else
-    {
-      cur_len = NETPLAY_LZO_IN_LEN;
-    }
-
-    if (cur_len <= 0)
-      break;  // EOF
-
-    if (!file.ReadBytes(in_buffer.data(), cur_len))
-    {
-      PanicAlertFmtT("Error reading file: {0}", file_path.c_str());
-      return false;
-    }
-
-    if (lzo1x_1_compress(in_buffer.data(), cur_len, out_buffer.data(), &out_len, wrkmem.data()) !=
-        LZO_E_OK)
-    {
-      PanicAlertFmtT("Internal LZO Error - compression failed");
-      return false;
-    }
-
-    // The size of the data to write is 'out_len'
-    packet << static_cast<u32>(out_len);
-    for (size_t j = 0; j < out_len; j++)
-    {
-      packet << out_buffer[j];
-    }
-
-    if (cur_len != NETPLAY_LZO_IN_LEN)
-      break;
-
-    i += cur_len;
+    PanicAlertFmtT("Error reading file: {0}", file_path.c_str());
+    return false;
   }
 
-  // Mark end of data
-  packet << static_cast<u32>(0);
-
-  return true;
+  return CompressBufferIntoPacket(in_buffer, packet);
 }
 
 bool NetPlayServer::CompressBufferIntoPacket(const std::vector<u8>& in_buffer, sf::Packet& packet)
 {
-  const sf::Uint64 size = in_buffer.size();
-  packet << size;
-
-  if (size == 0)
-    return true;
-
-  std::vector<u8> out_buffer(NETPLAY_LZO_OUT_LEN);
-  std::vector<u8> wrkmem(LZO1X_1_MEM_COMPRESS);
-
-  lzo_uint i = 0;
-  while (true)
-  {
-    lzo_uint32 cur_len = 0;  // number of bytes to read
-    lzo_uint out_len = 0;    // number of bytes to write
-
-    if ((i + NETPLAY_LZO_IN_LEN) >= size)
-    {
-      cur_len = static_cast<lzo_uint32>(size - i);
-    }
-    else
-    {
-      cur_len = NETPLAY_LZO_IN_LEN;
-    }
-
-    if (cur_len <= 0)
-      break;  // end of buffer
-
-    if (lzo1x_1_compress(&in_buffer[i], cur_len, out_buffer.data(), &out_len, wrkmem.data()) !=
-        LZO_E_OK)
-    {
-      PanicAlertFmtT("Internal LZO Error - compression failed");
-      return false;
-    }
-
-    // The size of the data to write is 'out_len'
-    packet << static_cast<u32>(out_len);
-    for (size_t j = 0; j < out_len; j++)
-    {
-      packet << out_buffer[j];
-    }
-
-    if (cur_len != NETPLAY_LZO_IN_LEN)
-      break;
-
-    i += cur_len;
-  }
-
-  // Mark end of data
-  packet << static_cast<u32>(0);
-
-  return true;
+  return CompressSyncData(in_buffer.data(), in_buffer.size(), m_sync_cached_chunks, packet);
 }
 
 u64 NetPlayServer::GetInitialNetPlayRTC() const
@@ -1920,10 +1970,20 @@ void NetPlayServer::SendToClients(const sf::Packet& packet, const PlayerId skip_
   }
 }
 
+void NetPlayServer::SendInputToClients(const sf::Packet& packet, Client& sender)
+{
+  sf::Packet reliable;
+  sf::Packet unreliable;
+  sender.input_relay.Push(packet, m_current_game, sender.pid, reliable, unreliable);
+
+  SendToClients(reliable, sender.pid);
+  SendToClients(unreliable, sender.pid, INPUT_CHANNEL);
+}
+
 void NetPlayServer::Send(ENetPeer* socket, const sf::Packet& packet, const u8 channel_id)
 {
-  ENetPacket* epac =
-      enet_packet_create(packet.getData(), packet.getDataSize(), ENET_PACKET_FLAG_RELIABLE);
+  const u32 flags = channel_id == INPUT_CHANNEL ? 0 : ENET_PACKET_FLAG_RELIABLE;
+  ENetPacket* epac = enet_packet_create(packet.getData(), packet.getDataSize(), flags);
   enet_peer_send(socket, channel_id, epac);
 }
 
@@ -21,7 +21,9 @@
 #include "Common/SPSCQueue.h"
 #include "Common/Timer.h"
 #include "Common/TraversalClient.h"
+#include "Core/NetPlayInputStream.h"
 #include "Core/NetPlayProto.h"
+#include "Core/NetPlaySyncChunks.h"
 #include "Core/SyncIdentifier.h"
 #include "InputCommon/GCPadStatus.h"
 #include "UICommon/NetPlayIndex.h"
@@ -64,6 +66,9 @@ public:
   void SetWiimoteMapping(const PadMappingArray& mappings);
 
   void AdjustPadBufferSize(unsigned int size);
+  // Adjusts the pad buffer to the pings of the players with controllers, see
+  // UpdateAutomaticPadBuffer
+  void SetAutomaticPadBuffer(bool enable);
   void SetHostInputAuthority(bool enable);
 
   void KickPlayer(PlayerId player);
@@ -89,6 +94,18 @@ private:
     u32 ping;
     u32 current_game;
 
+    // Smoothed like TCP does for its retransmission timeout (RFC 6298), in milliseconds
+    double smoothed_ping = 0.0;
+    double ping_variation = 0.0;
+    bool has_ping_sample = false;
+
+    // The synced save data chunks this client has cached
+    SyncChunkSet sync_chunks;
+
+    // The pad and Wiimote data received from this client, and relayed to the others
+    InputStreamReceiver input_stream;
+    InputStreamSender input_relay;
+
     Common::QoSSession qos_session;
 
     bool operator==(const Client& other) const { return this == &other; }
@@ -127,6 +144,7 @@ private:
 
   void SendToClients(const sf::Packet& packet, PlayerId skip_pid = 0,
                      u8 channel_id = DEFAULT_CHANNEL);
+  void SendInputToClients(const sf::Packet& packet, Client& sender);
   void Send(ENetPeer* socket, const sf::Packet& packet, u8 channel_id = DEFAULT_CHANNEL);
   unsigned int OnConnect(ENetPeer* socket, sf::Packet& rpac);
   unsigned int OnDisconnect(const Client& player);
@@ -143,6 +161,8 @@ private:
   void ChunkedDataAbort();
 
   void SetupIndex();
+  void UpdatePingStatistics(Client& player, u32 ping);
+  void UpdateAutomaticPadBuffer();
   bool PlayerHasControllerMapped(PlayerId pid) const;
 
   NetSettings m_settings;
@@ -154,9 +174,15 @@ private:
   bool m_update_pings = false;
   u32 m_current_game = 0;
   unsigned int m_target_buffer_size = 0;
+  bool m_automatic_pad_buffer = false;
+  // How many pings in a row wanted a smaller buffer, and the largest of those they wanted
+  u32 m_smaller_pad_buffer_count = 0;
+  unsigned int m_smaller_pad_buffer_size = 0;
   PadMappingArray m_pad_map;
   PadMappingArray m_wiimote_map;
   unsigned int m_save_data_synced_players = 0;
+  // The chunks that every client other than the host has cached, while syncing save data
+  SyncChunkSet m_sync_cached_chunks;
   unsigned int m_codes_synced_players = 0;
   bool m_saves_synced = true;
   bool m_codes_synced = true;
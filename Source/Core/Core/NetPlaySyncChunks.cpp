@@ -0,0 +1,213 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/NetPlaySyncChunks.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string_view>
+
+#include <SFML/Network/Packet.hpp>
+#include <fmt/format.h>
+#include <zstd.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/MsgHandler.h"
+#include "Common/SFMLHelper.h"
+
+namespace NetPlay
+{
+constexpr int SYNC_COMPRESSION_LEVEL = 3;
+// 128 MiB at most, which is enough for several full memory cards and the largest Wii saves
+constexpr size_t MAX_CACHED_SYNC_CHUNKS = 2048;
+
+static std::string HashToString(const SyncChunkHash& hash)
+{
+  std::string result;
+  for (const u8 byte : hash)
+    result += fmt::format("{:02x}", byte);
+  return result;
+}
+
+static std::optional<SyncChunkHash> StringToHash(const std::string& str)
+{
+  SyncChunkHash hash;
+  if (str.size() != hash.size() * 2)
+    return std::nullopt;
+
+  for (size_t i = 0; i < hash.size(); ++i)
+  {
+    const std::string byte = str.substr(i * 2, 2);
+    char* end;
+    hash[i] = static_cast<u8>(std::strtoul(byte.c_str(), &end, 16));
+    if (end != byte.c_str() + 2)
+      return std::nullopt;
+  }
+
+  return hash;
+}
+
+static void WriteHash(const SyncChunkHash& hash, sf::Packet& packet)
+{
+  packet.append(hash.data(), hash.size());
+}
+
+static SyncChunkHash ReadHash(sf::Packet& packet)
+{
+  SyncChunkHash hash;
+  for (u8& byte : hash)
+    packet >> byte;
+  return hash;
+}
+
+bool CompressSyncData(const u8* data, size_t size, const SyncChunkSet& cached_chunks,
+                      sf::Packet& packet)
+{
+  packet << sf::Uint64{size};
+
+  std::vector<u8> compressed(ZSTD_compressBound(SYNC_CHUNK_SIZE));
+  for (size_t offset = 0; offset < size; offset += SYNC_CHUNK_SIZE)
+  {
+    const size_t chunk_size = std::min(size - offset, SYNC_CHUNK_SIZE);
+    const SyncChunkHash hash = Common::SHA1::CalculateDigest(data + offset, chunk_size);
+    WriteHash(hash, packet);
+
+    const bool cached = cached_chunks.count(hash) != 0;
+    packet << cached;
+    if (cached)
+      continue;
+
+    const size_t result = ZSTD_compress(compressed.data(), compressed.size(), data + offset,
+                                        chunk_size, SYNC_COMPRESSION_LEVEL);
+    if (ZSTD_isError(result))
+    {
+      PanicAlertFmtT("Internal Zstandard Error - compression failed");
+      return false;
+    }
+
+    packet << static_cast<u32>(result);
+    packet.append(compressed.data(), result);
+  }
+
+  return true;
+}
+
+void WriteSyncChunkSet(const SyncChunkSet& chunks, sf::Packet& packet)
+{
+  packet << static_cast<u32>(chunks.size());
+  for (const SyncChunkHash& hash : chunks)
+    WriteHash(hash, packet);
+}
+
+SyncChunkSet ReadSyncChunkSet(sf::Packet& packet)
+{
+  u32 count = 0;
+  packet >> count;
+
+  SyncChunkSet chunks;
+  for (u32 i = 0; i < count && !packet.endOfPacket(); ++i)
+    chunks.insert(ReadHash(packet));
+  return chunks;
+}
+
+SyncChunkCache::SyncChunkCache()
+    : m_path(File::GetUserPath(D_CACHE_IDX) + "NetPlaySync" DIR_SEP)
+{
+}
+
+std::string SyncChunkCache::GetChunkPath(const SyncChunkHash& hash) const
+{
+  return m_path + HashToString(hash);
+}
+
+SyncChunkSet SyncChunkCache::GetChunks() const
+{
+  SyncChunkSet chunks;
+  if (!File::IsDirectory(m_path))
+    return chunks;
+
+  for (const File::FSTEntry& entry : File::ScanDirectoryTree(m_path, false).children)
+  {
+    if (entry.isDirectory)
+      continue;
+
+    if (const std::optional<SyncChunkHash> hash = StringToHash(entry.virtualName))
+      chunks.insert(*hash);
+  }
+
+  return chunks;
+}
+
+std::optional<std::vector<u8>> SyncChunkCache::DecompressSyncData(sf::Packet& packet)
+{
+  const u64 size = Common::PacketReadU64(packet);
+  std::vector<u8> out_buffer(size);
+
+  std::vector<u8> compressed;
+  for (size_t offset = 0; offset < size; offset += SYNC_CHUNK_SIZE)
+  {
+    const size_t chunk_size = std::min<size_t>(size - offset, SYNC_CHUNK_SIZE);
+    const SyncChunkHash hash = ReadHash(packet);
+    bool cached;
+    packet >> cached;
+
+    const std::string chunk_path = GetChunkPath(hash);
+    if (cached)
+    {
+      std::string data;
+      if (!File::ReadFileToString(chunk_path, data))
+      {
+        PanicAlertFmtT("A part of the synchronized data is missing from \"{0}\".", chunk_path);
+        return std::nullopt;
+      }
+      compressed.assign(data.begin(), data.end());
+    }
+    else
+    {
+      u32 compressed_size = 0;
+      packet >> compressed_size;
+      compressed.resize(compressed_size);
+      for (u8& byte : compressed)
+        packet >> byte;
+    }
+
+    const size_t result = ZSTD_decompress(out_buffer.data() + offset, chunk_size,
+                                          compressed.data(), compressed.size());
+    if (!packet || ZSTD_isError(result) || result != chunk_size ||
+        Common::SHA1::CalculateDigest(out_buffer.data() + offset, chunk_size) != hash)
+    {
+      PanicAlertFmtT("Internal Zstandard Error - decompression failed");
+      if (cached)
+        File::Delete(chunk_path);
+      return std::nullopt;
+    }
+
+    m_used_chunks.insert(hash);
+    if (cached)
+      continue;
+
+    const std::string_view data(reinterpret_cast<const char*>(compressed.data()),
+                                compressed.size());
+    if (!File::CreateFullPath(m_path) || !File::WriteStringToFile(chunk_path, data))
+      WARN_LOG_FMT(NETPLAY, "Failed to cache synchronized data in {}", chunk_path);
+  }
+
+  return out_buffer;
+}
+
+void SyncChunkCache::Trim()
+{
+  const SyncChunkSet chunks = GetChunks();
+  size_t count = chunks.size();
+  for (auto it = chunks.begin(); it != chunks.end() && count > MAX_CACHED_SYNC_CHUNKS; ++it)
+  {
+    if (m_used_chunks.count(*it) == 0 && File::Delete(GetChunkPath(*it)))
+      --count;
+  }
+
+  m_used_chunks.clear();
+}
+}  // namespace NetPlay
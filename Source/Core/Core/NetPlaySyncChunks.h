@@ -0,0 +1,54 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
+
+namespace sf
+{
+class Packet;
+}
+
+namespace NetPlay
+{
+// Synced save data is split into chunks of this size, which are compressed separately. Clients
+// keep the chunks they received in a cache, which they tell the server about whenever it changes.
+// Chunks that all clients already have are then sent as just their hash, so that syncing the
+// same (or mostly the same) saves as in an earlier session is almost free.
+constexpr size_t SYNC_CHUNK_SIZE = 64 * 1024;
+
+using SyncChunkHash = Common::SHA1::Digest;
+using SyncChunkSet = std::set<SyncChunkHash>;
+
+// Server side
+bool CompressSyncData(const u8* data, size_t size, const SyncChunkSet& cached_chunks,
+                      sf::Packet& packet);
+void WriteSyncChunkSet(const SyncChunkSet& chunks, sf::Packet& packet);
+SyncChunkSet ReadSyncChunkSet(sf::Packet& packet);
+
+// Client side. The chunks are stored compressed, one file each, in the cache directory.
+class SyncChunkCache
+{
+public:
+  SyncChunkCache();
+
+  SyncChunkSet GetChunks() const;
+  std::optional<std::vector<u8>> DecompressSyncData(sf::Packet& packet);
+  // Deletes chunks that weren't used since the last call, if there are too many.
+  void Trim();
+
+private:
+  std::string GetChunkPath(const SyncChunkHash& hash) const;
+
+  std::string m_path;
+  SyncChunkSet m_used_chunks;
+};
+}  // namespace NetPlay
@@ -17,30 +17,35 @@
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/MMU.h"
 
+const TBreakPoint* BreakPoints::Find(u32 address) const
+{
+  const auto iter =
+      std::lower_bound(m_breakpoints.begin(), m_breakpoints.end(), address,
+                       [](const TBreakPoint& bp, u32 value) { return bp.address < value; });
+  return iter != m_breakpoints.end() && iter->address == address ? &*iter : nullptr;
+}
+
 bool BreakPoints::IsAddressBreakPoint(u32 address) const
 {
-  return std::any_of(m_breakpoints.begin(), m_breakpoints.end(),
-                     [address](const auto& bp) { return bp.address == address; });
+  return Find(address) != nullptr;
 }
 
 bool BreakPoints::IsTempBreakPoint(u32 address) const
 {
-  return std::any_of(m_breakpoints.begin(), m_breakpoints.end(), [address](const auto& bp) {
-    return bp.address == address && bp.is_temporary;
-  });
+  const TBreakPoint* bp = Find(address);
+  return bp && bp->is_temporary;
 }
 
 bool BreakPoints::IsBreakPointBreakOnHit(u32 address) const
 {
-  return std::any_of(m_breakpoints.begin(), m_breakpoints.end(), [address](const auto& bp) {
-    return bp.address == address && bp.break_on_hit;
-  });
+  const TBreakPoint* bp = Find(address);
+  return bp && bp->break_on_hit;
 }
 
 bool BreakPoints::IsBreakPointLogOnHit(u32 address) const
 {
-  return std::any_of(m_breakpoints.begin(), m_breakpoints.end(),
-                     [address](const auto& bp) { return bp.address == address && bp.log_on_hit; });
+  const TBreakPoint* bp = Find(address);
+  return bp && bp->log_on_hit;
 }
 
 BreakPoints::TBreakPointsStr BreakPoints::GetStrings() const
@@ -79,10 +84,13 @@ void BreakPoints::AddFromStrings(const TBreakPointsStr& bp_strings)
 
 void BreakPoints::Add(const TBreakPoint& bp)
 {
-  if (IsAddressBreakPoint(bp.address))
+  const auto iter =
+      std::lower_bound(m_breakpoints.begin(), m_breakpoints.end(), bp.address,
+                       [](const TBreakPoint& other, u32 value) { return other.address < value; });
+  if (iter != m_breakpoints.end() && iter->address == bp.address)
     return;
 
-  m_breakpoints.push_back(bp);
+  m_breakpoints.insert(iter, bp);
 
   JitInterface::InvalidateICache(bp.address, 4, true);
 }
@@ -94,10 +102,6 @@ void BreakPoints::Add(u32 address, bool temp)
 
 void BreakPoints::Add(u32 address, bool temp, bool break_on_hit, bool log_on_hit)
 {
-  // Only add new addresses
-  if (IsAddressBreakPoint(address))
-    return;
-
   TBreakPoint bp;  // breakpoint settings
   bp.is_enabled = true;
   bp.is_temporary = temp;
@@ -105,17 +109,17 @@ void BreakPoints::Add(u32 address, bool temp, bool break_on_hit, bool log_on_hit
   bp.log_on_hit = log_on_hit;
   bp.address = address;
 
-  m_breakpoints.push_back(bp);
-
-  JitInterface::InvalidateICache(address, 4, true);
+  // Only adds new addresses
+  Add(bp);
 }
 
 void BreakPoints::Remove(u32 address)
 {
-  const auto iter = std::find_if(m_breakpoints.begin(), m_breakpoints.end(),
-                                 [address](const auto& bp) { return bp.address == address; });
+  const auto iter =
+      std::lower_bound(m_breakpoints.begin(), m_breakpoints.end(), address,
+                       [](const TBreakPoint& bp, u32 value) { return bp.address < value; });
 
-  if (iter == m_breakpoints.cend())
+  if (iter == m_breakpoints.cend() || iter->address != address)
     return;
 
   m_breakpoints.erase(iter);
@@ -194,7 +198,13 @@ void MemChecks::Add(const TMemCheck& memory_check)
 
   bool had_any = HasAny();
   Core::RunAsCPUThread([&] {
-    m_mem_checks.push_back(memory_check);
+    const auto iter = std::upper_bound(m_mem_checks.begin(), m_mem_checks.end(),
+                                       memory_check.start_address,
+                                       [](u32 value, const TMemCheck& other) {
+                                         return value < other.start_address;
+                                       });
+    m_mem_checks.insert(iter, memory_check);
+    UpdateMaxEnds();
     // If this is the first one, clear the JIT cache so it can switch to
     // watchpoint-compatible code.
     if (!had_any)
@@ -214,6 +224,7 @@ void MemChecks::Remove(u32 address)
 
   Core::RunAsCPUThread([&] {
     m_mem_checks.erase(iter);
+    UpdateMaxEnds();
     if (!HasAny())
       JitInterface::ClearCache();
     PowerPC::DBATUpdated();
@@ -224,23 +235,44 @@ void MemChecks::Clear()
 {
   Core::RunAsCPUThread([&] {
     m_mem_checks.clear();
+    m_max_ends.clear();
     JitInterface::ClearCache();
     PowerPC::DBATUpdated();
   });
 }
 
-TMemCheck* MemChecks::GetMemCheck(u32 address, size_t size)
+void MemChecks::UpdateMaxEnds()
 {
-  const auto iter =
-      std::find_if(m_mem_checks.begin(), m_mem_checks.end(), [address, size](const auto& mc) {
-        return mc.end_address >= address && address + size - 1 >= mc.start_address;
-      });
+  m_max_ends.resize(m_mem_checks.size());
+  u32 max_end = 0;
+  for (size_t i = 0; i < m_mem_checks.size(); ++i)
+  {
+    max_end = std::max(max_end, m_mem_checks[i].end_address);
+    m_max_ends[i] = max_end;
+  }
+}
 
-  // None found
-  if (iter == m_mem_checks.cend())
-    return nullptr;
+template <typename F>
+bool MemChecks::AnyOverlapping(u32 first, u32 last, F func) const
+{
+  const size_t begin =
+      std::lower_bound(m_max_ends.begin(), m_max_ends.end(), first) - m_max_ends.begin();
+  for (size_t i = begin; i < m_mem_checks.size() && m_mem_checks[i].start_address <= last; ++i)
+  {
+    if (m_mem_checks[i].end_address >= first && func(m_mem_checks[i]))
+      return true;
+  }
+  return false;
+}
 
-  return &*iter;
+TMemCheck* MemChecks::GetMemCheck(u32 address, size_t size)
+{
+  const TMemCheck* found = nullptr;
+  AnyOverlapping(address, static_cast<u32>(address + size - 1), [&](const TMemCheck& mc) {
+    found = &mc;
+    return true;
+  });
+  return const_cast<TMemCheck*>(found);
 }
 
 bool MemChecks::OverlapsMemcheck(u32 address, u32 length) const
@@ -249,14 +281,14 @@ bool MemChecks::OverlapsMemcheck(u32 address, u32 length) const
     return false;
 
   const u32 page_end_suffix = length - 1;
-  const u32 page_end_address = address | page_end_suffix;
+  return AnyOverlapping(address & ~page_end_suffix, address | page_end_suffix,
+                        [](const TMemCheck&) { return true; });
+}
 
-  return std::any_of(m_mem_checks.cbegin(), m_mem_checks.cend(), [&](const auto& mc) {
-    return ((mc.start_address | page_end_suffix) == page_end_address ||
-            (mc.end_address | page_end_suffix) == page_end_address) ||
-           ((mc.start_address | page_end_suffix) < page_end_address &&
-            (mc.end_address | page_end_suffix) > page_end_address);
-  });
+bool MemChecks::OverlapsReadMemcheck(u32 address, u32 length) const
+{
+  return AnyOverlapping(address, address + length - 1,
+                        [](const TMemCheck& mc) { return mc.is_break_on_read; });
 }
 
 bool TMemCheck::Action(Common::DebugInterface* debug_interface, u32 value, u32 addr, bool write,
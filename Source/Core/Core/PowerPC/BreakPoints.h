@@ -44,7 +44,7 @@ struct TMemCheck
               u32 pc);
 };
 
-// Code breakpoints.
+// Code breakpoints, kept sorted by address.
 class BreakPoints
 {
 public:
@@ -72,10 +72,17 @@ public:
   void ClearAllTemporary();
 
 private:
+  const TBreakPoint* Find(u32 address) const;
+
   TBreakPoints m_breakpoints;
 };
 
-// Memory breakpoints
+// Memory breakpoints, kept sorted by start address so that they can be looked up quickly.
+//
+// Where the logical fastmem arena is in use, memchecks don't take fastmem away from the whole
+// program. Only the host pages a memcheck overlaps are left out of the arena (or mapped read-only
+// if all memchecks on them are write-only), so only accesses to those fault, and the instructions
+// making them are patched to take the slow path, which checks the exact ranges.
 class MemChecks
 {
 public:
@@ -91,11 +98,21 @@ public:
   // memory breakpoint
   TMemCheck* GetMemCheck(u32 address, size_t size = 1);
   bool OverlapsMemcheck(u32 address, u32 length) const;
+  // Whether a memcheck that breaks on reads overlaps the range [address, address + length).
+  bool OverlapsReadMemcheck(u32 address, u32 length) const;
   void Remove(u32 address);
 
   void Clear();
   bool HasAny() const { return !m_mem_checks.empty(); }
 
 private:
+  // Calls func for every memcheck overlapping [first, last] until it returns true.
+  template <typename F>
+  bool AnyOverlapping(u32 first, u32 last, F func) const;
+  void UpdateMaxEnds();
+
   TMemChecks m_mem_checks;
+  // m_max_ends[i] is the largest end address of m_mem_checks[0] to m_mem_checks[i], so the
+  // memchecks before the first one that's at least an address all end before it.
+  std::vector<u32> m_max_ends;
 };
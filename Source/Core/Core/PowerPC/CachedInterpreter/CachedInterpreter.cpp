@@ -81,13 +81,15 @@ void CachedInterpreter::ExecuteOneBlock()
   const u8* normal_entry = m_block_cache.Dispatch();
   if (!normal_entry)
   {
-    Jit(PC);
+    JitTrampoline(*this, PC);
     return;
   }
 
   const Instruction* code = reinterpret_cast<const Instruction*>(normal_entry);
 
-  for (; code->type != Instruction::Type::Abort; ++code)
+  // The end of the block is handled by the same switch as everything else, so that every
+  // instruction costs a single dispatch.
+  for (;; ++code)
   {
     switch (code->type)
     {
@@ -100,6 +102,9 @@ void CachedInterpreter::ExecuteOneBlock()
         return;
       break;
 
+    case Instruction::Type::Abort:
+      return;
+
     default:
       ERROR_LOG_FMT(POWERPC, "Unknown CachedInterpreter Instruction: {}", code->type);
       break;
@@ -137,14 +142,11 @@ static void EndBlock(UGeckoInstruction data)
   PowerPC::UpdatePerformanceMonitor(data.hex, 0, 0);
 }
 
-static void UpdateNumLoadStoreInstructions(UGeckoInstruction data)
-{
-  PowerPC::UpdatePerformanceMonitor(0, data.hex, 0);
-}
-
-static void UpdateNumFloatingPointInstructions(UGeckoInstruction data)
+// The load/store count is in the lower and the floating point instruction count in the upper half,
+// as neither can be anywhere near 64Ki in a single block.
+static void UpdateNumLoadStoreAndFloatingPointInstructions(UGeckoInstruction data)
 {
-  PowerPC::UpdatePerformanceMonitor(0, 0, data.hex);
+  PowerPC::UpdatePerformanceMonitor(0, data.hex & 0xffff, data.hex >> 16);
 }
 
 static void WritePC(UGeckoInstruction data)
@@ -201,6 +203,18 @@ static bool CheckIdle(u32 idle_pc)
   return false;
 }
 
+void CachedInterpreter::WriteEndBlock()
+{
+  m_code.emplace_back(EndBlock, js.downcountAmount);
+
+  // Skip the update for blocks without any loads, stores or floating point instructions.
+  if (js.numLoadStoreInst != 0 || js.numFloatingPointInst != 0)
+  {
+    m_code.emplace_back(UpdateNumLoadStoreAndFloatingPointInstructions,
+                        js.numLoadStoreInst | (js.numFloatingPointInst << 16));
+  }
+}
+
 bool CachedInterpreter::HandleFunctionHooking(u32 address)
 {
   return HLE::ReplaceFunctionIfPossible(address, [&](u32 hook_index, HLE::HookType type) {
@@ -291,19 +305,13 @@ void CachedInterpreter::Jit(u32 address)
       if (idle_loop)
         m_code.emplace_back(CheckIdle, js.blockStart);
       if (endblock)
-      {
-        m_code.emplace_back(EndBlock, js.downcountAmount);
-        m_code.emplace_back(UpdateNumLoadStoreInstructions, js.numLoadStoreInst);
-        m_code.emplace_back(UpdateNumFloatingPointInstructions, js.numFloatingPointInst);
-      }
+        WriteEndBlock();
     }
   }
   if (code_block.m_broken)
   {
     m_code.emplace_back(WriteBrokenBlockNPC, nextPC);
-    m_code.emplace_back(EndBlock, js.downcountAmount);
-    m_code.emplace_back(UpdateNumLoadStoreInstructions, js.numLoadStoreInst);
-    m_code.emplace_back(UpdateNumFloatingPointInstructions, js.numFloatingPointInst);
+    WriteEndBlock();
   }
   m_code.emplace_back();
 
@@ -37,6 +37,7 @@ private:
 
   u8* GetCodePtr();
   void ExecuteOneBlock();
+  void WriteEndBlock();
 
   bool HandleFunctionHooking(u32 address);
 
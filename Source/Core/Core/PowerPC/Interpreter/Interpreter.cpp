@@ -106,10 +106,31 @@ void Interpreter::RunTable63(UGeckoInstruction inst)
 void Interpreter::Init()
 {
   InitializeInstructionTables();
+  ClearDecodeCache();
   m_reserve = false;
   m_end_block = false;
 }
 
+void Interpreter::ClearDecodeCache()
+{
+  // Every entry starts out holding the (valid) decoding of the all-zero instruction word.
+  const UGeckoInstruction zero{};
+  m_decode_cache.fill({zero.hex, PPCTables::GetInterpreterOp(zero), PPCTables::GetOpInfo(zero)});
+}
+
+const Interpreter::DecodeCacheEntry& Interpreter::Decode(UGeckoInstruction inst)
+{
+  // The opcode is in the top bits and most of the rest is register numbers and immediates, so
+  // multiplicative hashing spreads these out much better than just taking the low bits.
+  const u32 index = (inst.hex * 0x9E3779B1) >> 20;
+  static_assert(DECODE_CACHE_SIZE == 1 << (32 - 20));
+
+  DecodeCacheEntry& entry = m_decode_cache[index];
+  if (entry.hex != inst.hex)
+    entry = {inst.hex, PPCTables::GetInterpreterOp(inst), PPCTables::GetOpInfo(inst)};
+  return entry;
+}
+
 void Interpreter::Shutdown()
 {
 }
@@ -152,7 +173,7 @@ int Interpreter::SingleStepInner()
   if (HandleFunctionHooking(PC))
   {
     UpdatePC();
-    return PPCTables::GetOpInfo(m_prev_inst)->numCycles;
+    return Decode(m_prev_inst).info->numCycles;
   }
 
 #ifdef USE_GDBSTUB
@@ -179,6 +200,8 @@ int Interpreter::SingleStepInner()
     Trace(m_prev_inst);
   }
 
+  const DecodeCacheEntry decoded = Decode(m_prev_inst);
+
   if (m_prev_inst.hex != 0)
   {
     if (IsInvalidPairedSingleExecution(m_prev_inst))
@@ -188,7 +211,7 @@ int Interpreter::SingleStepInner()
     }
     else if (MSR.FP)
     {
-      m_op_table[m_prev_inst.OPCD](m_prev_inst);
+      decoded.op(m_prev_inst);
       if (PowerPC::ppcState.Exceptions & EXCEPTION_DSI)
       {
         CheckExceptions();
@@ -197,14 +220,14 @@ int Interpreter::SingleStepInner()
     else
     {
       // check if we have to generate a FPU unavailable exception or a program exception.
-      if (PPCTables::UsesFPU(m_prev_inst))
+      if (decoded.info->flags & FL_USE_FPU)
       {
         PowerPC::ppcState.Exceptions |= EXCEPTION_FPU_UNAVAILABLE;
         CheckExceptions();
       }
       else
       {
-        m_op_table[m_prev_inst.OPCD](m_prev_inst);
+        decoded.op(m_prev_inst);
         if (PowerPC::ppcState.Exceptions & EXCEPTION_DSI)
         {
           CheckExceptions();
@@ -220,7 +243,7 @@ int Interpreter::SingleStepInner()
 
   UpdatePC();
 
-  const GekkoOPInfo* opinfo = PPCTables::GetOpInfo(m_prev_inst);
+  const GekkoOPInfo* opinfo = decoded.info;
   PowerPC::UpdatePerformanceMonitor(opinfo->numCycles, (opinfo->flags & FL_LOADSTORE) != 0,
                                     (opinfo->flags & FL_USE_FPU) != 0);
   return opinfo->numCycles;
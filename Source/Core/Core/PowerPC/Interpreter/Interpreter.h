@@ -10,6 +10,8 @@
 #include "Core/PowerPC/CPUCoreBase.h"
 #include "Core/PowerPC/Gekko.h"
 
+struct GekkoOPInfo;
+
 class Interpreter : public CPUCoreBase
 {
 public:
@@ -282,6 +284,20 @@ public:
   static u32 Helper_Carry(u32 value1, u32 value2);
 
 private:
+  // Caches the result of the opcode table lookups for recently executed instruction words. This is
+  // keyed on the instruction word rather than its address, so it never needs to be invalidated, and
+  // the instruction fetch (with its MMU and icache emulation) still happens every time.
+  struct DecodeCacheEntry
+  {
+    u32 hex;
+    Instruction op;
+    const GekkoOPInfo* info;
+  };
+  static constexpr u32 DECODE_CACHE_SIZE = 0x1000;
+
+  const DecodeCacheEntry& Decode(UGeckoInstruction inst);
+  void ClearDecodeCache();
+
   void CheckExceptions();
 
   static void InitializeInstructionTables();
@@ -296,6 +312,8 @@ private:
 
   UGeckoInstruction m_prev_inst{};
 
+  std::array<DecodeCacheEntry, DECODE_CACHE_SIZE> m_decode_cache{};
+
   static bool m_end_block;
 
   // TODO: These should really be in the save state, although it's unlikely to matter much.
@@ -4,6 +4,7 @@
 
 #include "Core/PowerPC/Jit64/Jit.h"
 
+#include <algorithm>
 #include <map>
 #include <sstream>
 #include <string>
@@ -19,12 +20,14 @@
 #include "Common/CommonTypes.h"
 #include "Common/GekkoDisassembler.h"
 #include "Common/IOFile.h"
+#include "Common/JitRegister.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemoryUtil.h"
 #include "Common/PerformanceCounter.h"
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
 #include "Common/x64ABI.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/HLE/HLE.h"
@@ -326,6 +329,14 @@ bool Jit64::BackPatch(u32 emAddress, SContext* ctx)
 
   ctx->CTX_PC = reinterpret_cast<u64>(trampoline);
 
+  // Faulting accesses usually keep faulting (MMIO, mostly), so also recompile the block with
+  // slowmem for this instruction. That avoids both the trampoline jumps and taking the fault again
+  // whenever the block gets recompiled, and constant MMIO addresses get turned into direct handler
+  // calls. The block's code stays around until the next compilation, so the trampoline can still
+  // return into it.
+  js.noFastmemAddresses.insert(info.pc);
+  blocks.InvalidateICache(info.pc, 4, true);
+
   return true;
 }
 
@@ -336,6 +347,7 @@ void Jit64::Init()
   jo.fastmem_arena = SConfig::GetInstance().bFastmem && Memory::InitFastmemArena();
   jo.optimizeGatherPipe = true;
   jo.accurateSinglePrecision = true;
+  jo.tiered_compilation = Config::Get(Config::MAIN_JIT_TIERED_COMPILATION);
   UpdateMemoryOptions();
   js.fastmemLoadStore = nullptr;
   js.compilerPC = 0;
@@ -403,6 +415,51 @@ void Jit64::ResetFreeMemoryRanges()
   m_free_ranges_far.insert(m_far_code.GetWritableCodePtr(), m_far_code.GetWritableCodeEnd());
 }
 
+void Jit64::TransferFreedMemoryRanges()
+{
+  // Check if any code blocks have been freed in the block cache and transfer this information to
+  // the local rangesets to allow overwriting them with new code.
+  for (auto range : blocks.GetRangesToFreeNear())
+    m_free_ranges_near.insert(range.first, range.second);
+  for (auto range : blocks.GetRangesToFreeFar())
+    m_free_ranges_far.insert(range.first, range.second);
+  blocks.ClearRangesToFree();
+}
+
+bool Jit64::HasEnoughFreeCodeSpace() const
+{
+  const auto free_near = m_free_ranges_near.by_size_begin();
+  if (free_near == m_free_ranges_near.by_size_end() ||
+      static_cast<size_t>(free_near.to() - free_near.from()) < MIN_FREE_CODE_REGION_SIZE)
+  {
+    return false;
+  }
+
+  const auto free_far = m_free_ranges_far.by_size_begin();
+  return free_far != m_free_ranges_far.by_size_end() &&
+         static_cast<size_t>(free_far.to() - free_far.from()) >= MIN_FREE_CODE_REGION_SIZE;
+}
+
+void Jit64::EvictColdBlocksIfNeeded()
+{
+  // Rather than waiting for code generation to fail and flushing the whole cache, which causes
+  // every block to be recompiled at once, free up space by evicting only the blocks which
+  // haven't been used for the longest time. The dispatcher resets the stack before calling the
+  // JIT, so none of the evicted blocks can still be running or be returned to by a predicted
+  // blr, and their code space can be reused right away.
+  // If this doesn't result in a large enough contiguous free region, code generation will
+  // eventually fail and the cache gets cleared as before.
+  while (!HasEnoughFreeCodeSpace())
+  {
+    const size_t count = std::max<size_t>(blocks.GetBlockCount() / EVICTION_DIVISOR, 1);
+    if (blocks.EvictLeastRecentlyUsedBlocks(count) == 0)
+      break;
+
+    DEBUG_LOG_FMT(DYNA_REC, "Evicted {} cold blocks from the code cache", count);
+    TransferFreedMemoryRanges();
+  }
+}
+
 void Jit64::Shutdown()
 {
   FreeStack();
@@ -417,6 +474,7 @@ void Jit64::Shutdown()
 
 void Jit64::FallBackToInterpreter(UGeckoInstruction inst)
 {
+  FlushPendingFPRF();
   gpr.Flush();
   fpr.Flush();
   if (js.op->opinfo->flags & FL_ENDBLOCK)
@@ -450,6 +508,7 @@ void Jit64::FallBackToInterpreter(UGeckoInstruction inst)
 
 void Jit64::HLEFunction(u32 hook_index)
 {
+  FlushPendingFPRF();
   gpr.Flush();
   fpr.Flush();
   ABI_PushRegistersAndAdjustStack({}, 0);
@@ -488,7 +547,7 @@ static void ImHere()
 
 bool Jit64::Cleanup()
 {
-  bool did_something = false;
+  bool did_something = WritePendingFPRF();
 
   if (jo.optimizeGatherPipe && js.fifoBytesSinceCheck > 0)
   {
@@ -635,6 +694,34 @@ void Jit64::WriteExitDestInRSCRATCH(bool bl, u32 after)
   }
 }
 
+// Call before WriteExitDestInRSCRATCH for indirect branches whose destination is in RSCRATCH.
+void Jit64::WriteIndirectBranchInlineCache(bool bl, u32 after)
+{
+  if (!jo.tiered_compilation)
+    return;
+
+  if (js.baselineTier)
+  {
+    // Remember the destination, so that the hot version of this block can predict it.
+    u32* const last_destination = &js.indirectBranchTargets[js.compilerPC];
+    MOV(64, R(RSCRATCH2), ImmPtr(last_destination));
+    MOV(32, MatR(RSCRATCH2), R(RSCRATCH));
+    return;
+  }
+
+  const auto it = js.indirectBranchTargets.find(js.compilerPC);
+  if (it == js.indirectBranchTargets.end() || it->second == 0)
+    return;
+
+  // Monomorphic inline cache: if the destination is the same as the last one seen by the baseline
+  // block, take a regular exit which can be linked to the destination block directly. Otherwise,
+  // fall back to looking up the destination in the dispatcher.
+  CMP(32, R(RSCRATCH), Imm32(it->second));
+  FixupBranch miss = J_CC(CC_NE, true);
+  WriteExit(it->second, bl, after);
+  SetJumpTarget(miss);
+}
+
 void Jit64::WriteBLRExit()
 {
   if (!m_enable_blr_optimization)
@@ -737,6 +824,7 @@ void Jit64::Trace()
 
 void Jit64::Jit(u32 em_address)
 {
+  CompilePersistentBlocks();
   Jit(em_address, true);
 }
 
@@ -761,13 +849,8 @@ void Jit64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
     ClearCache();
   }
 
-  // Check if any code blocks have been freed in the block cache and transfer this information to
-  // the local rangesets to allow overwriting them with new code.
-  for (auto range : blocks.GetRangesToFreeNear())
-    m_free_ranges_near.insert(range.first, range.second);
-  for (auto range : blocks.GetRangesToFreeFar())
-    m_free_ranges_far.insert(range.first, range.second);
-  blocks.ClearRangesToFree();
+  TransferFreedMemoryRanges();
+  EvictColdBlocksIfNeeded();
 
   std::size_t block_size = m_code_buffer.size();
 
@@ -796,11 +879,28 @@ void Jit64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
     }
   }
 
+  // In tiered compilation mode, blocks are first compiled without branch following, which keeps
+  // them short and cheap to compile, and only get recompiled with all optimizations once they
+  // have proven to be hot. Hot blocks then follow more branches than usual, so that hot code
+  // which is spread over several small blocks ends up in a single trace.
+  const bool hot_block = js.hotBlockAddresses.find(em_address) != js.hotBlockAddresses.end();
+  js.baselineTier = jo.tiered_compilation && !jo.profile_blocks &&
+                    !SConfig::GetInstance().bEnableDebugging && !hot_block;
+  if (js.baselineTier)
+    analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  analyzer.SetBranchFollowingThreshold(
+      jo.tiered_compilation && hot_block ?
+          HOT_BLOCK_BRANCH_FOLLOWING_THRESHOLD :
+          PPCAnalyst::PPCAnalyzer::DEFAULT_BRANCH_FOLLOWING_THRESHOLD);
+
   // Analyze the block, collect all instructions it is made of (including inlining,
   // if that is enabled), reorder instructions for optimal performance, and join joinable
   // instructions.
   const u32 nextPC = analyzer.Analyze(em_address, &code_block, &m_code_buffer, block_size);
 
+  if (js.baselineTier)
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+
   if (code_block.m_memory_exception)
   {
     // Address of instruction could not be translated
@@ -836,7 +936,8 @@ void Jit64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
       b->far_begin = far_start;
       b->far_end = far_end;
 
-      blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses);
+      blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses,
+                           js.sourceLines);
       return;
     }
   }
@@ -883,11 +984,13 @@ bool Jit64::SetEmitterStateToFreeCodeRegion()
 bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
 {
   js.firstFPInstructionFound = false;
+  js.fprfPending = false;
   js.isLastInstruction = false;
   js.blockStart = em_address;
   js.fifoBytesSinceCheck = 0;
   js.mustCheckFifo = false;
   js.curBlock = b;
+  js.sourceLines.clear();
   js.numLoadStoreInst = 0;
   js.numFloatingPointInst = 0;
 
@@ -919,6 +1022,25 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
   MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
 #endif
 
+  // Count the executions of baseline blocks, and have them recompiled once they are hot.
+  if (js.baselineTier)
+  {
+    SwitchToFarCode();
+    const u8* tier_up = GetCodePtr();
+    MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+    ABI_PushRegistersAndAdjustStack({}, 0);
+    ABI_CallFunctionC(JitInterface::CompileExceptionCheck,
+                      static_cast<u32>(JitInterface::ExceptionType::HotBlock));
+    ABI_PopRegistersAndAdjustStack({}, 0);
+    JMP(asm_routines.dispatcher_no_check, true);
+    SwitchToNearCode();
+
+    MOV(64, R(RSCRATCH), ImmPtr(&b->profile_data.runCount));
+    ADD(64, MatR(RSCRATCH), Imm8(1));
+    CMP(64, MatR(RSCRATCH), Imm32(TIER_UP_THRESHOLD));
+    J_CC(CC_AE, tier_up);
+  }
+
   // Start up the register allocators
   // They use the information in gpa/fpa to preload commonly used registers.
   gpr.Start();
@@ -975,6 +1097,8 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
 
     js.compilerPC = op.address;
     js.op = &op;
+    if (JitRegister::IsJitDumpEnabled())
+      js.sourceLines.push_back({GetCodePtr(), op.address});
     js.instructionNumber = i;
     js.instructionsLeft = (code_block.m_num_instructions - 1) - i;
     const GekkoOPInfo* opinfo = op.opinfo;
@@ -1076,6 +1200,7 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
         // link this block.
         jo.enableBlocklink = false;
 
+        FlushPendingFPRF();
         gpr.Flush();
         fpr.Flush();
 
@@ -1109,6 +1234,9 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
         fpr.PreloadRegisters(op.fregsIn & op.fprInXmm);
       }
 
+      if (opinfo->flags & FL_READ_FPRF)
+        FlushPendingFPRF();
+
       CompileInstruction(op);
 
       if (jo.memcheck && (opinfo->flags & FL_LOADSTORE))
@@ -1152,6 +1280,10 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
       gpr.Commit();
       fpr.Commit();
 
+      // Registers which the rest of the block overwrites before reading them don't need to be
+      // written back. If the next instruction got merged into this one, look past it.
+      gpr.Discard(m_code_buffer[i + js.skipInstructions].gprDiscardable);
+
       // If we have a register that will never be used again, flush it.
       gpr.Flush(~op.gprInUse);
       fpr.Flush(~op.fprInUse);
@@ -1226,6 +1358,7 @@ void Jit64::EnableOptimization()
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_DISCARD_DEAD_REGISTERS);
 }
 
 void Jit64::IntializeSpeculativeConstants()
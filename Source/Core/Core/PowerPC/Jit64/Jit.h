@@ -87,6 +87,7 @@ public:
   void WriteExit(u32 destination, bool bl = false, u32 after = 0);
   void JustWriteExit(u32 destination, bool bl, u32 after);
   void WriteExitDestInRSCRATCH(bool bl = false, u32 after = 0);
+  void WriteIndirectBranchInlineCache(bool bl, u32 after);
   void WriteBLRExit();
   void WriteExceptionExit();
   void WriteExternalExceptionExit();
@@ -121,6 +122,8 @@ public:
   // is set or not.
   Gen::FixupBranch JumpIfCRFieldBit(int field, int bit, bool jump_if_set = true);
   void SetFPRFIfNeeded(Gen::X64Reg xmm);
+  bool WritePendingFPRF();
+  void FlushPendingFPRF();
 
   void HandleNaNs(UGeckoInstruction inst, Gen::X64Reg xmm_out, Gen::X64Reg xmm_in,
                   Gen::X64Reg clobber = Gen::XMM0);
@@ -245,6 +248,18 @@ public:
   void eieio(UGeckoInstruction inst);
 
 private:
+  // In tiered compilation mode, the number of times a baseline block has to run before it gets
+  // recompiled with all optimizations enabled.
+  static constexpr u32 TIER_UP_THRESHOLD = 1024;
+  // The number of unconditional branches followed into a block once it has been found to be hot,
+  // which turns short runs of hot blocks into a single longer trace.
+  static constexpr u32 HOT_BLOCK_BRANCH_FOLLOWING_THRESHOLD = 8;
+  // Once the largest free chunk of the near or far code region gets smaller than this, the least
+  // recently used blocks get evicted until enough space is available again.
+  static constexpr size_t MIN_FREE_CODE_REGION_SIZE = 256 * 1024;
+  // The share of all blocks (1 / EVICTION_DIVISOR) which gets evicted in one go.
+  static constexpr size_t EVICTION_DIVISOR = 8;
+
   void CompileInstruction(PPCAnalyst::CodeOp& op);
 
   bool HandleFunctionHooking(u32 address);
@@ -253,6 +268,9 @@ private:
   void FreeStack();
 
   void ResetFreeMemoryRanges();
+  void TransferFreedMemoryRanges();
+  bool HasEnoughFreeCodeSpace() const;
+  void EvictColdBlocksIfNeeded();
 
   JitBlockCache blocks{*this};
   TrampolineCache trampolines{*this};
@@ -34,8 +34,32 @@ void Jit64::SetFPRFIfNeeded(X64Reg xmm)
   // As far as we know, the games that use this flag only need FPRF for fmul and fmadd, but
   // FPRF is fast enough in JIT that we might as well just enable it for every float instruction
   // if the FPRF flag is set.
-  if (SConfig::GetInstance().bFPRF && js.op->wantsFPRF)
-    SetFPRF(xmm);
+  if (!SConfig::GetInstance().bFPRF || !js.op->wantsFPRF)
+    return;
+
+  // Most of the time, FPRF is only wanted because the block might be left before the next float
+  // operation. So only store the result here, and calculate FPRF from it when leaving the block or
+  // before an instruction which reads FPSCR.
+  MOVSD(PPCSTATE(pending_fprf_source), xmm);
+  js.fprfPending = true;
+}
+
+// Calculates FPRF from the result stored by SetFPRFIfNeeded, if there is one. Clobbers RSCRATCH
+// and XMM0. Returns whether any code was generated.
+bool Jit64::WritePendingFPRF()
+{
+  if (!js.fprfPending)
+    return false;
+
+  MOVSD(XMM0, PPCSTATE(pending_fprf_source));
+  SetFPRF(XMM0);
+  return true;
+}
+
+void Jit64::FlushPendingFPRF()
+{
+  WritePendingFPRF();
+  js.fprfPending = false;
 }
 
 void Jit64::HandleNaNs(UGeckoInstruction inst, X64Reg xmm_out, X64Reg xmm, X64Reg clobber)
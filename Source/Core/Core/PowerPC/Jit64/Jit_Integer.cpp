@@ -139,7 +139,11 @@ void Jit64::ComputeRC(preg_t preg, bool needs_test, bool needs_sext)
   RCOpArg arg = gpr.Use(preg, RCMode::Read);
   RegCache::Realize(arg);
 
-  if (arg.IsImm())
+  if (!js.op->wantsCR[0])
+  {
+    // CR0 is overwritten before anything reads it.
+  }
+  else if (arg.IsImm())
   {
     MOV(64, PPCSTATE(cr.fields[0]), Imm32(arg.SImm32()));
   }
@@ -507,6 +511,11 @@ void Jit64::cmpXX(UGeckoInstruction inst)
   int a = inst.RA;
   int b = inst.RB;
   u32 crf = inst.CRFD;
+
+  // The result is overwritten before anything reads it.
+  if (!js.op->wantsCR[crf])
+    return;
+
   bool merge_branch = CheckMergedBranch(crf);
 
   bool signedCompare;
@@ -411,6 +411,18 @@ void RegCache::Flush(BitSet32 pregs)
   }
 }
 
+void RegCache::Discard(BitSet32 pregs)
+{
+  for (preg_t i : pregs)
+  {
+    ASSERT_MSG(DYNA_REC, !m_regs[i].IsLocked(), "Discarding locked PPC reg %zu", i);
+    ASSERT_MSG(DYNA_REC, !m_regs[i].IsRevertable(), "Register transaction is in progress!");
+
+    DiscardRegContentsIfCached(i);
+    m_regs[i].SetFlushed();
+  }
+}
+
 void RegCache::Revert()
 {
   ASSERT(IsAllUnlocked());
@@ -170,6 +170,8 @@ public:
 
   RCForkGuard Fork();
   void Flush(BitSet32 pregs = BitSet32::AllTrue(32));
+  // Forgets the values of registers without writing them back, for values which are dead.
+  void Discard(BitSet32 pregs);
   void Revert();
   void Commit();
 
@@ -318,6 +318,106 @@ void EmuCodeBlock::MMIOLoadToReg(MMIO::Mapping* mmio, Gen::X64Reg reg_value,
   }
 }
 
+// Visitor that generates code to write a MMIO value.
+template <typename T>
+class MMIOWriteCodeGenerator : public MMIO::WriteHandlingMethodVisitor<T>
+{
+public:
+  MMIOWriteCodeGenerator(Gen::X64CodeBlock* code, BitSet32 registers_in_use,
+                         const Gen::OpArg& src, u32 address)
+      : m_code(code), m_registers_in_use(registers_in_use), m_src(src), m_address(address)
+  {
+  }
+
+  void VisitNop() override
+  {
+    // Do nothing
+  }
+  void VisitDirect(T* addr, u32 mask) override { WriteToAddrMask(8 * sizeof(T), addr, mask); }
+  void VisitComplex(const std::function<void(u32, T)>* lambda) override
+  {
+    CallLambda(8 * sizeof(T), lambda);
+  }
+
+private:
+  static Gen::OpArg ImmOfSize(int sbits, u32 value)
+  {
+    return sbits == 8 ? Gen::Imm8(static_cast<u8>(value)) :
+                        sbits == 16 ? Gen::Imm16(static_cast<u16>(value)) : Gen::Imm32(value);
+  }
+
+  void WriteToAddrMask(int sbits, void* ptr, u32 mask)
+  {
+    m_code->MOV(64, R(RSCRATCH2), ImmPtr(ptr));
+    if (m_src.IsImm())
+    {
+      m_code->MOV(sbits, MatR(RSCRATCH2), ImmOfSize(sbits, m_src.AsImm32().Imm32() & mask));
+      return;
+    }
+
+    // As with reads, the mask can be skipped entirely if it covers the whole access.
+    const u32 all_ones = static_cast<u32>((1ULL << sbits) - 1);
+    if ((all_ones & mask) == all_ones && m_src.IsSimpleReg())
+    {
+      m_code->MOV(sbits, MatR(RSCRATCH2), m_src);
+      return;
+    }
+
+    if (!m_src.IsSimpleReg(RSCRATCH))
+      m_code->MOV(sbits, R(RSCRATCH), m_src);
+    if ((all_ones & mask) != all_ones)
+      m_code->AND(32, R(RSCRATCH), Imm32(mask));
+    m_code->MOV(sbits, MatR(RSCRATCH2), R(RSCRATCH));
+  }
+
+  void CallLambda(int sbits, const std::function<void(u32, T)>* lambda)
+  {
+    m_code->ABI_PushRegistersAndAdjustStack(m_registers_in_use, 0);
+    // The value goes first, since it might live in one of the other parameter registers.
+    if (m_src.IsImm())
+      m_code->MOV(32, R(ABI_PARAM3), Imm32(m_src.AsImm32().Imm32()));
+    else if (sbits < 32)
+      m_code->MOVZX(32, sbits, ABI_PARAM3, m_src);
+    else if (!m_src.IsSimpleReg(ABI_PARAM3))
+      m_code->MOV(32, R(ABI_PARAM3), m_src);
+    m_code->MOV(64, R(ABI_PARAM1), ImmPtr(lambda));
+    m_code->MOV(32, R(ABI_PARAM2), Imm32(m_address));
+    m_code->ABI_CallFunction(&Gen::XEmitter::CallLambdaTrampoline<void, u32, T>);
+    m_code->ABI_PopRegistersAndAdjustStack(m_registers_in_use, 0);
+  }
+
+  Gen::X64CodeBlock* m_code;
+  BitSet32 m_registers_in_use;
+  Gen::OpArg m_src;
+  u32 m_address;
+};
+
+void EmuCodeBlock::MMIOWriteRegToAddr(MMIO::Mapping* mmio, const Gen::OpArg& reg_value,
+                                      BitSet32 registers_in_use, u32 address, int access_size)
+{
+  switch (access_size)
+  {
+  case 8:
+  {
+    MMIOWriteCodeGenerator<u8> gen(this, registers_in_use, reg_value, address);
+    mmio->GetHandlerForWrite<u8>(address).Visit(gen);
+    break;
+  }
+  case 16:
+  {
+    MMIOWriteCodeGenerator<u16> gen(this, registers_in_use, reg_value, address);
+    mmio->GetHandlerForWrite<u16>(address).Visit(gen);
+    break;
+  }
+  case 32:
+  {
+    MMIOWriteCodeGenerator<u32> gen(this, registers_in_use, reg_value, address);
+    mmio->GetHandlerForWrite<u32>(address).Visit(gen);
+    break;
+  }
+  }
+}
+
 void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg& opAddress, int accessSize,
                                  s32 offset, BitSet32 registersInUse, bool signExtend, int flags)
 {
@@ -326,7 +426,7 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg& opAddress,
   auto& js = m_jit.js;
   registersInUse[reg_value] = false;
   if (m_jit.jo.fastmem && !(flags & (SAFE_LOADSTORE_NO_FASTMEM | SAFE_LOADSTORE_NO_UPDATE_PC)) &&
-      !slowmem)
+      !slowmem && js.noFastmemAddresses.count(js.compilerPC) == 0)
   {
     u8* backpatchStart = GetWritableCodePtr();
     MovInfo mov;
@@ -498,7 +598,7 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
 
   auto& js = m_jit.js;
   if (m_jit.jo.fastmem && !(flags & (SAFE_LOADSTORE_NO_FASTMEM | SAFE_LOADSTORE_NO_UPDATE_PC)) &&
-      !slowmem)
+      !slowmem && js.noFastmemAddresses.count(js.compilerPC) == 0)
   {
     u8* backpatchStart = GetWritableCodePtr();
     MovInfo mov;
@@ -649,6 +749,12 @@ bool EmuCodeBlock::WriteToConstAddress(int accessSize, OpArg arg, u32 address,
     WriteToConstRamAddress(accessSize, arg, address);
     return false;
   }
+  else if (const u32 mmio_address = PowerPC::IsOptimizableMMIOAccess(address, accessSize);
+           accessSize != 64 && mmio_address)
+  {
+    MMIOWriteRegToAddr(Memory::mmio_mapping.get(), arg, registersInUse, mmio_address, accessSize);
+    return false;
+  }
   else
   {
     // Helps external systems know which instruction triggered the write
@@ -478,6 +478,13 @@ void QuantizedMemoryRoutines::GenQuantizedStore(bool single, EQuantizeType type,
       MOVQ_xmm(XMM1, MRegSum(RSCRATCH2, RSCRATCH));
       MULPS(XMM0, R(XMM1));
     }
+    else if (quantize > 0 && quantize < 63 && cpu_info.bAVX)
+    {
+      // VEX-encoded memory operands don't need to be aligned, so the scale can be folded into the
+      // multiply. This reads the next table entry into the upper half, which is never used (hence
+      // the exclusion of the last entry, to not read past the end of the table).
+      VMULPS(XMM0, XMM0, MConst(m_quantizeTableS, quantize * 2));
+    }
     else if (quantize > 0)
     {
       MOVQ_xmm(XMM1, MConst(m_quantizeTableS, quantize * 2));
@@ -712,6 +719,13 @@ void QuantizedMemoryRoutines::GenQuantizedLoad(bool single, EQuantizeType type,
       MOVQ_xmm(XMM1, MRegSum(RSCRATCH2, RSCRATCH));
       MULPS(XMM0, R(XMM1));
     }
+    else if (quantize > 0 && quantize < 63 && cpu_info.bAVX)
+    {
+      // VEX-encoded memory operands don't need to be aligned, so the scale can be folded into the
+      // multiply. This reads the next table entry into the upper half, which is never used (hence
+      // the exclusion of the last entry, to not read past the end of the table).
+      VMULPS(XMM0, XMM0, MConst(m_dequantizeTableS, quantize * 2));
+    }
     else if (quantize > 0)
     {
       MOVQ_xmm(XMM1, MConst(m_dequantizeTableS, quantize * 2));
@@ -8,6 +8,7 @@
 
 #include "Common/Arm64Emitter.h"
 #include "Common/CommonTypes.h"
+#include "Common/JitRegister.h"
 #include "Common/Logging/Log.h"
 #include "Common/MathUtil.h"
 #include "Common/PerformanceCounter.h"
@@ -62,6 +63,7 @@ void JitArm64::Init()
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_DISCARD_DEAD_REGISTERS);
 
   m_enable_blr_optimization = jo.enableBlocklink && SConfig::GetInstance().bFastmem &&
                               !SConfig::GetInstance().bEnableDebugging;
@@ -572,8 +574,10 @@ void JitArm64::SingleStep()
   pExecAddr();
 }
 
-void JitArm64::Jit(u32)
+void JitArm64::Jit(u32 em_address)
 {
+  CompilePersistentBlocks();
+
   if (m_cleanup_after_stackfault)
   {
     ClearCache();
@@ -590,7 +594,6 @@ void JitArm64::Jit(u32)
   }
 
   std::size_t block_size = m_code_buffer.size();
-  const u32 em_address = PowerPC::ppcState.pc;
 
   if (SConfig::GetInstance().bEnableDebugging)
   {
@@ -615,7 +618,7 @@ void JitArm64::Jit(u32)
 
   JitBlock* b = blocks.AllocateBlock(em_address);
   DoJit(em_address, b, nextPC);
-  blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses);
+  blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses, js.sourceLines);
 }
 
 void JitArm64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
@@ -635,6 +638,7 @@ void JitArm64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
   js.downcountAmount = 0;
   js.skipInstructions = 0;
   js.curBlock = b;
+  js.sourceLines.clear();
   js.carryFlagSet = false;
   js.numLoadStoreInst = 0;
   js.numFloatingPointInst = 0;
@@ -693,6 +697,8 @@ void JitArm64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
 
     js.compilerPC = op.address;
     js.op = &op;
+    if (JitRegister::IsJitDumpEnabled())
+      js.sourceLines.push_back({GetWritableCodePtr(), op.address});
     js.instructionNumber = i;
     js.instructionsLeft = (code_block.m_num_instructions - 1) - i;
     const GekkoOPInfo* opinfo = op.opinfo;
@@ -831,6 +837,10 @@ void JitArm64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
       if (!CanMergeNextInstructions(1) || js.op[1].opinfo->type != ::OpType::Integer)
         FlushCarry();
 
+      // Registers which the rest of the block overwrites before reading them don't need to be
+      // written back. If the next instruction got merged into this one, look past it.
+      gpr.DiscardRegisters(m_code_buffer[i + js.skipInstructions].gprDiscardable);
+
       // If we have a register that will never be used again, flush it.
       gpr.StoreRegisters(~op.gprInUse);
       fpr.StoreRegisters(~op.fprInUse);
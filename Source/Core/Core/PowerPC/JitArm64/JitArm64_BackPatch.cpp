@@ -302,6 +302,15 @@ bool JitArm64::HandleFastmemFault(uintptr_t access_address, SContext* ctx)
     return false;
   }
 
+  // Pages translated through the page table get mapped on demand. The faulting load or store can
+  // then just be executed again, without falling back to slowmem.
+  const uintptr_t logical_offset = access_address - (uintptr_t)Memory::logical_base;
+  if (access_address >= (uintptr_t)Memory::logical_base && logical_offset < 0x100000000 &&
+      PowerPC::HandleLogicalFastmemFault(static_cast<u32>(logical_offset)))
+  {
+    return true;
+  }
+
   auto slow_handler_iter = m_fault_to_handler.upper_bound((const u8*)ctx->CTX_PC);
   slow_handler_iter--;
 
@@ -18,12 +18,19 @@ using namespace Arm64Gen;
 
 void JitArm64::ComputeRC0(ARM64Reg reg)
 {
+  // CR0 is overwritten before anything reads it.
+  if (!js.op->wantsCR[0])
+    return;
+
   gpr.BindCRToRegister(0, false);
   SXTW(gpr.CR(0), reg);
 }
 
 void JitArm64::ComputeRC0(u64 imm)
 {
+  if (!js.op->wantsCR[0])
+    return;
+
   gpr.BindCRToRegister(0, false);
   MOVI2R(gpr.CR(0), imm);
   if (imm & 0x80000000)
@@ -431,6 +438,10 @@ void JitArm64::cmp(UGeckoInstruction inst)
   int crf = inst.CRFD;
   u32 a = inst.RA, b = inst.RB;
 
+  // The result is overwritten before anything reads it.
+  if (!js.op->wantsCR[crf])
+    return;
+
   gpr.BindCRToRegister(crf, false);
   ARM64Reg CR = gpr.CR(crf);
 
@@ -468,6 +479,10 @@ void JitArm64::cmpl(UGeckoInstruction inst)
   int crf = inst.CRFD;
   u32 a = inst.RA, b = inst.RB;
 
+  // The result is overwritten before anything reads it.
+  if (!js.op->wantsCR[crf])
+    return;
+
   gpr.BindCRToRegister(crf, false);
   ARM64Reg CR = gpr.CR(crf);
 
@@ -497,6 +512,10 @@ void JitArm64::cmpi(UGeckoInstruction inst)
   s64 B = inst.SIMM_16;
   int crf = inst.CRFD;
 
+  // The result is overwritten before anything reads it.
+  if (!js.op->wantsCR[crf])
+    return;
+
   gpr.BindCRToRegister(crf, false);
   ARM64Reg CR = gpr.CR(crf);
 
@@ -525,6 +544,10 @@ void JitArm64::cmpli(UGeckoInstruction inst)
   u64 B = inst.UIMM;
   int crf = inst.CRFD;
 
+  // The result is overwritten before anything reads it.
+  if (!js.op->wantsCR[crf])
+    return;
+
   gpr.BindCRToRegister(crf, false);
   ARM64Reg CR = gpr.CR(crf);
 
@@ -244,6 +244,17 @@ void Arm64GPRCache::FlushRegisters(BitSet32 regs, bool maintain_state)
   }
 }
 
+void Arm64GPRCache::DiscardRegisters(BitSet32 regs)
+{
+  for (size_t preg : regs)
+  {
+    OpArg& reg = GetGuestGPR(preg).reg;
+    if (reg.GetType() == RegType::Register)
+      UnlockRegister(DecodeReg(reg.GetReg()));
+    reg.Flush();
+  }
+}
+
 void Arm64GPRCache::FlushCRRegisters(BitSet32 regs, bool maintain_state)
 {
   for (size_t i = 0; i < GUEST_CR_COUNT; ++i)
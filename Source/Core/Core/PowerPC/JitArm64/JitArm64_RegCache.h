@@ -241,6 +241,9 @@ public:
   void StoreRegisters(BitSet32 regs) { FlushRegisters(regs, false); }
   void StoreCRRegisters(BitSet32 regs) { FlushCRRegisters(regs, false); }
 
+  // Forgets the values of guest GPRs without writing them back, for values which are dead
+  void DiscardRegisters(BitSet32 regs);
+
 protected:
   // Get the order of the host registers
   void GetAllocationOrder() override;
@@ -4,6 +4,8 @@
 
 #include "Core/PowerPC/JitCommon/JitBase.h"
 
+#include <chrono>
+
 #include "Common/CommonTypes.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/CPU.h"
@@ -17,7 +19,10 @@ const u8* JitBase::Dispatch(JitBase& jit)
 
 void JitTrampoline(JitBase& jit, u32 em_address)
 {
+  const auto start = std::chrono::steady_clock::now();
   jit.Jit(em_address);
+  jit.m_compile_time += std::chrono::steady_clock::now() - start;
+  ++jit.m_compile_count;
 }
 
 JitBase::JitBase() : m_code_buffer(code_buffer_size)
@@ -48,3 +53,22 @@ void JitBase::UpdateMemoryOptions()
   jo.fastmem = SConfig::GetInstance().bFastmem && jo.fastmem_arena && (MSR.DR || !any_watchpoints);
   jo.memcheck = SConfig::GetInstance().bMMU || any_watchpoints;
 }
+
+void JitBase::CompilePersistentBlocks()
+{
+  // Jit() calls this function itself, so don't recurse when compiling the persistent blocks.
+  if (m_compiling_persistent_blocks || SConfig::GetInstance().bEnableDebugging ||
+      SConfig::GetInstance().bJITNoBlockCache)
+  {
+    return;
+  }
+
+  m_compiling_persistent_blocks = true;
+  JitBaseBlockCache* block_cache = GetBlockCache();
+  for (u32 address : block_cache->TakePersistentBlocks(MSR.Hex, PERSISTENT_BLOCKS_PER_COMPILE))
+  {
+    if (!block_cache->GetBlockFromStartAddress(address, MSR.Hex))
+      Jit(address);
+  }
+  m_compiling_persistent_blocks = false;
+}
@@ -4,11 +4,15 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <map>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/JitRegister.h"
 #include "Common/x64Emitter.h"
 #include "Core/ConfigManager.h"
 #include "Core/MachineContext.h"
@@ -51,6 +55,7 @@ protected:
     bool fastmem_arena;
     bool memcheck;
     bool profile_blocks;
+    bool tiered_compilation;
   };
   struct JitState
   {
@@ -71,11 +76,16 @@ protected:
     bool assumeNoPairedQuantize;
     std::map<u8, u32> constantGqr;
     bool firstFPInstructionFound;
+    // Set while fpscr doesn't have the FPRF of the last floating point result yet.
+    bool fprfPending;
     bool isLastInstruction;
     int skipInstructions;
     bool carryFlagSet;
     bool carryFlagInverted;
 
+    // Set when compiling the cheap first tier of a block in tiered compilation mode.
+    bool baselineTier;
+
     bool generatingTrampoline = false;
     u8* trampolineExceptionHandler;
 
@@ -89,9 +99,19 @@ protected:
 
     JitBlock* curBlock;
 
+    // Where the code of each instruction of the current block starts. Only recorded when a perf
+    // jitdump is being written.
+    std::vector<JitRegister::SourceLine> sourceLines;
+
     std::unordered_set<u32> fifoWriteAddresses;
     std::unordered_set<u32> pairedQuantizeAddresses;
     std::unordered_set<u32> noSpeculativeConstantsAddresses;
+    std::unordered_set<u32> hotBlockAddresses;
+    // Loads and stores which faulted when using fastmem, and are compiled with slowmem instead.
+    std::unordered_set<u32> noFastmemAddresses;
+    // Address of an indirect branch -> the destination it took last, as recorded by baseline tier
+    // blocks. Entries are never removed, since compiled code writes to them directly.
+    std::unordered_map<u32, u32> indirectBranchTargets;
   };
 
   PPCAnalyst::CodeBlock code_block;
@@ -102,6 +122,22 @@ protected:
 
   void UpdateMemoryOptions();
 
+  // Compiles some of the blocks which the block cache has loaded from the persistent block list of
+  // the running game, so they don't have to be compiled one by one when they are first executed.
+  // The work is spread over several calls to avoid stalling the CPU thread for too long at once.
+  void CompilePersistentBlocks();
+
+  // The number of persistent blocks compiled per call to CompilePersistentBlocks().
+  static constexpr std::size_t PERSISTENT_BLOCKS_PER_COMPILE = 64;
+  bool m_compiling_persistent_blocks = false;
+
+  // Updated by JitTrampoline. Blocks that are compiled from within another compilation (like the
+  // persistent blocks) count towards the time of that compilation.
+  u64 m_compile_count = 0;
+  std::chrono::steady_clock::duration m_compile_time{};
+
+  friend void JitTrampoline(JitBase& jit, u32 em_address);
+
 public:
   JitBase();
   ~JitBase() override;
@@ -111,6 +147,11 @@ public:
 
   virtual void Jit(u32 em_address) = 0;
 
+  // How often the dispatcher had to compile a block since the JIT was created, and the time that
+  // took in total.
+  u64 GetCompileCount() const { return m_compile_count; }
+  std::chrono::steady_clock::duration GetCompileTime() const { return m_compile_time; }
+
   virtual const CommonAsmRoutinesBase* GetAsmRoutines() = 0;
 
   virtual bool HandleFault(uintptr_t access_address, SContext* ctx) = 0;
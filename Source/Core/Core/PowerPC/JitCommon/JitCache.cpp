@@ -14,13 +14,22 @@
 #include <cstring>
 #include <functional>
 #include <map>
+#include <optional>
 #include <set>
 #include <utility>
+#include <vector>
 
+#include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Hash.h"
+#include "Common/IOFile.h"
 #include "Common/JitRegister.h"
+#include "Common/Logging/Log.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/HW/Memmap.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/MMU.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
@@ -32,10 +41,54 @@
 
 using namespace Gen;
 
+namespace
+{
+constexpr u32 PERSISTENT_BLOCK_LIST_MAGIC = 0x4C424A44;  // "DJBL"
+constexpr u32 PERSISTENT_BLOCK_LIST_VERSION = 1;
+
+struct PersistentBlockListHeader
+{
+  u32 magic;
+  u32 version;
+  u32 num_entries;
+};
+
+// Returns the number of bytes of guest code from the start of the block up to the first
+// instruction which isn't directly following the previous one (e.g. due to branch following).
+u32 GetContiguousGuestSize(const std::vector<std::pair<u32, u32>>& physical_ranges, u32 start)
+{
+  for (const auto& range : physical_ranges)
+  {
+    if (range.first <= start && start < range.second)
+      return range.second - start;
+  }
+  return 0;
+}
+
+std::optional<u32> HashGuestCode(u32 physical_address, u32 size)
+{
+  const u32 address = physical_address & 0x3FFFFFFF;
+  if (size == 0)
+    return std::nullopt;
+
+  if (address + size <= Memory::GetRamSizeReal())
+    return Common::HashAdler32(Memory::m_pRAM + address, size);
+
+  if (Memory::m_pEXRAM && (address >> 28) == 0x1 &&
+      (address & 0x0FFFFFFF) + size <= Memory::GetExRamSizeReal())
+  {
+    return Common::HashAdler32(Memory::m_pEXRAM + (address & 0x0FFFFFFF), size);
+  }
+
+  return std::nullopt;
+}
+}  // Anonymous namespace
+
 bool JitBlock::OverlapsPhysicalRange(u32 address, u32 length) const
 {
-  return physical_addresses.lower_bound(address) !=
-         physical_addresses.lower_bound(address + length);
+  return std::any_of(physical_ranges.begin(), physical_ranges.end(), [&](const auto& range) {
+    return range.first < address + length && address < range.second;
+  });
 }
 
 JitBaseBlockCache::JitBaseBlockCache(JitBase& jit) : m_jit{jit}
@@ -46,13 +99,22 @@ JitBaseBlockCache::~JitBaseBlockCache() = default;
 
 void JitBaseBlockCache::Init()
 {
-  JitRegister::Init(SConfig::GetInstance().m_perfDir);
+  JitRegister::Init(SConfig::GetInstance().m_perfDir, Config::Get(Config::MAIN_PERF_JIT_DUMP));
+
+  m_persistent_blocks_enabled = Config::Get(Config::MAIN_JIT_PERSISTENT_CACHE);
+  m_persistent_blocks_loaded = false;
+  m_persistent_blocks_game_id.clear();
+  m_persistent_blocks.clear();
+  m_persistent_blocks_pending.clear();
 
   Clear();
 }
 
 void JitBaseBlockCache::Shutdown()
 {
+  if (m_persistent_blocks_enabled && m_persistent_blocks_loaded)
+    SavePersistentBlockList();
+
   JitRegister::Shutdown();
 }
 
@@ -65,6 +127,7 @@ void JitBaseBlockCache::Clear()
 #endif
   m_jit.js.fifoWriteAddresses.clear();
   m_jit.js.pairedQuantizeAddresses.clear();
+  m_jit.js.noFastmemAddresses.clear();
   for (auto& e : block_map)
   {
     DestroyBlock(e.second);
@@ -108,40 +171,58 @@ JitBlock* JitBaseBlockCache::AllocateBlock(u32 em_address)
 }
 
 void JitBaseBlockCache::FinalizeBlock(JitBlock& block, bool block_link,
-                                      const std::set<u32>& physical_addresses)
+                                      const std::set<u32>& physical_addresses,
+                                      const std::vector<JitRegister::SourceLine>& source_lines)
 {
   size_t index = FastLookupIndexForAddress(block.effectiveAddress);
   fast_block_map[index] = &block;
   block.fast_block_map_index = index;
+  block.last_used = ++m_use_counter;
 
-  block.physical_addresses = physical_addresses;
+  // Collapse the (sorted) instruction addresses into contiguous ranges.
+  block.physical_ranges.clear();
+  for (u32 addr : physical_addresses)
+  {
+    if (!block.physical_ranges.empty() && block.physical_ranges.back().second == addr)
+      block.physical_ranges.back().second = addr + 4;
+    else
+      block.physical_ranges.emplace_back(addr, addr + 4);
+  }
 
   u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
-  for (u32 addr : physical_addresses)
+  for (const auto& range : block.physical_ranges)
   {
-    valid_block.Set(addr / 32);
-    block_range_map[addr & range_mask].insert(&block);
+    for (u32 addr = range.first & ~31u; addr < range.second; addr += 32)
+      valid_block.Set(addr / 32);
+    for (u32 addr = range.first & range_mask; addr < range.second; addr += BLOCK_RANGE_MAP_ELEMENTS)
+      block_range_map[addr].insert(&block);
   }
 
   if (block_link)
   {
     for (const auto& e : block.linkData)
     {
-      links_to.emplace(e.exitAddress, &block);
+      links_to[e.exitAddress].insert(&block);
     }
 
     LinkBlock(block);
   }
 
+  if (m_persistent_blocks_enabled)
+    RecordPersistentBlock(block);
+
   Common::Symbol* symbol = nullptr;
   if (JitRegister::IsEnabled() &&
       (symbol = g_symbolDB.GetSymbolFromAddr(block.effectiveAddress)) != nullptr)
   {
+    JitRegister::RegisterSourceLines(block.checkedEntry, symbol->function_name.c_str(),
+                                     source_lines);
     JitRegister::Register(block.checkedEntry, block.codeSize, "JIT_PPC_%s_%08x",
                           symbol->function_name.c_str(), block.physicalAddress);
   }
   else
   {
+    JitRegister::RegisterSourceLines(block.checkedEntry, "PPC", source_lines);
     JitRegister::Register(block.checkedEntry, block.codeSize, "JIT_PPC_%08x",
                           block.physicalAddress);
   }
@@ -216,6 +297,8 @@ void JitBaseBlockCache::InvalidateICache(u32 address, u32 length, bool forced)
       {
         m_jit.js.fifoWriteAddresses.erase(i);
         m_jit.js.pairedQuantizeAddresses.erase(i);
+        m_jit.js.hotBlockAddresses.erase(i);
+        m_jit.js.noFastmemAddresses.erase(i);
       }
     }
   }
@@ -238,9 +321,15 @@ void JitBaseBlockCache::ErasePhysicalRange(u32 address, u32 length)
       {
         // If the block overlaps, also remove all other occupied slots in the other macro blocks.
         // This will leak empty macro blocks, but they may be reused or cleared later on.
-        for (u32 addr : block->physical_addresses)
-          if ((addr & range_mask) != start->first)
-            block_range_map[addr & range_mask].erase(block);
+        for (const auto& range : block->physical_ranges)
+        {
+          for (u32 addr = range.first & range_mask; addr < range.second;
+               addr += BLOCK_RANGE_MAP_ELEMENTS)
+          {
+            if (addr != start->first)
+              block_range_map[addr].erase(block);
+          }
+        }
 
         // And remove the block.
         DestroyBlock(*block);
@@ -299,13 +388,14 @@ void JitBaseBlockCache::LinkBlockExits(JitBlock& block)
 void JitBaseBlockCache::LinkBlock(JitBlock& block)
 {
   LinkBlockExits(block);
-  auto ppp = links_to.equal_range(block.effectiveAddress);
+  const auto iter = links_to.find(block.effectiveAddress);
+  if (iter == links_to.end())
+    return;
 
-  for (auto iter = ppp.first; iter != ppp.second; ++iter)
+  for (JitBlock* b2 : iter->second)
   {
-    JitBlock& b2 = *iter->second;
-    if (block.msrBits == b2.msrBits)
-      LinkBlockExits(b2);
+    if (block.msrBits == b2->msrBits)
+      LinkBlockExits(*b2);
   }
 }
 
@@ -318,10 +408,13 @@ void JitBaseBlockCache::UnlinkBlock(const JitBlock& block)
   }
 
   // Unlink all exits of other blocks which points to this block
-  auto ppp = links_to.equal_range(block.effectiveAddress);
-  for (auto iter = ppp.first; iter != ppp.second; ++iter)
+  const auto iter = links_to.find(block.effectiveAddress);
+  if (iter == links_to.end())
+    return;
+
+  for (JitBlock* source_block : iter->second)
   {
-    JitBlock& sourceBlock = *iter->second;
+    JitBlock& sourceBlock = *source_block;
     if (sourceBlock.msrBits != block.msrBits)
       continue;
 
@@ -336,6 +429,57 @@ void JitBaseBlockCache::UnlinkBlock(const JitBlock& block)
   }
 }
 
+std::size_t JitBaseBlockCache::EvictLeastRecentlyUsedBlocks(std::size_t count)
+{
+  std::vector<JitBlock*> blocks;
+  blocks.reserve(block_map.size());
+  for (auto& e : block_map)
+    blocks.push_back(&e.second);
+
+  count = std::min(count, blocks.size());
+  std::nth_element(blocks.begin(), blocks.begin() + count, blocks.end(),
+                   [](const JitBlock* lhs, const JitBlock* rhs) {
+                     return lhs->last_used < rhs->last_used;
+                   });
+
+  for (std::size_t i = 0; i < count; i++)
+    EraseSingleBlock(*blocks[i]);
+
+  return count;
+}
+
+std::size_t JitBaseBlockCache::GetBlockCount() const
+{
+  return block_map.size();
+}
+
+void JitBaseBlockCache::EraseSingleBlock(JitBlock& block)
+{
+  const u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
+  for (const auto& range : block.physical_ranges)
+  {
+    for (u32 addr = range.first & range_mask; addr < range.second; addr += BLOCK_RANGE_MAP_ELEMENTS)
+    {
+      const auto it = block_range_map.find(addr);
+      if (it != block_range_map.end())
+        it->second.erase(&block);
+    }
+  }
+
+  DestroyBlock(block);
+
+  auto block_map_iter = block_map.equal_range(block.physicalAddress);
+  while (block_map_iter.first != block_map_iter.second)
+  {
+    if (&block_map_iter.first->second == &block)
+    {
+      block_map.erase(block_map_iter.first);
+      break;
+    }
+    block_map_iter.first++;
+  }
+}
+
 void JitBaseBlockCache::DestroyBlock(JitBlock& block)
 {
   if (fast_block_map[block.fast_block_map_index] == &block)
@@ -346,14 +490,13 @@ void JitBaseBlockCache::DestroyBlock(JitBlock& block)
   // Delete linking addresses
   for (const auto& e : block.linkData)
   {
-    auto it = links_to.equal_range(e.exitAddress);
-    while (it.first != it.second)
-    {
-      if (it.first->second == &block)
-        it.first = links_to.erase(it.first);
-      else
-        it.first++;
-    }
+    const auto it = links_to.find(e.exitAddress);
+    if (it == links_to.end())
+      continue;
+
+    it->second.erase(&block);
+    if (it->second.empty())
+      links_to.erase(it);
   }
 
   // Raise an signal if we are going to call this block again
@@ -375,6 +518,7 @@ JitBlock* JitBaseBlockCache::MoveBlockIntoFastCache(u32 addr, u32 msr)
   size_t index = FastLookupIndexForAddress(addr);
   fast_block_map[index] = block;
   block->fast_block_map_index = index;
+  block->last_used = ++m_use_counter;
 
   return block;
 }
@@ -383,3 +527,116 @@ size_t JitBaseBlockCache::FastLookupIndexForAddress(u32 address)
 {
   return (address >> 2) & FAST_BLOCK_MAP_MASK;
 }
+
+std::vector<u32> JitBaseBlockCache::TakePersistentBlocks(u32 msr, std::size_t max_blocks)
+{
+  if (!m_persistent_blocks_enabled)
+    return {};
+
+  // The game ID isn't known yet when the block cache is initialized, so the list can only be
+  // loaded once the game is actually running.
+  if (!m_persistent_blocks_loaded)
+  {
+    if (SConfig::GetInstance().GetGameID().empty())
+      return {};
+    LoadPersistentBlockList();
+  }
+
+  std::vector<u32> addresses;
+  const u32 msr_bits = msr & JIT_CACHE_MSR_MASK;
+  auto iter = m_persistent_blocks_pending.begin();
+  while (iter != m_persistent_blocks_pending.end() && addresses.size() < max_blocks)
+  {
+    if (iter->msr_bits != msr_bits)
+    {
+      ++iter;
+      continue;
+    }
+
+    const auto translated = PowerPC::JitCache_TranslateAddress(iter->effective_address);
+    if (translated.valid && translated.address == iter->physical_address &&
+        HashGuestCode(iter->physical_address, iter->guest_size) == iter->guest_hash)
+    {
+      addresses.push_back(iter->effective_address);
+    }
+    else
+    {
+      // The guest code has changed (or isn't mapped the same way anymore), so drop the entry.
+      // If the block still gets compiled later on, it will be recorded again.
+      m_persistent_blocks.erase({iter->effective_address, iter->msr_bits});
+    }
+
+    iter = m_persistent_blocks_pending.erase(iter);
+  }
+
+  return addresses;
+}
+
+std::string JitBaseBlockCache::GetPersistentBlockListPath() const
+{
+  return File::GetUserPath(D_CACHE_IDX) + "JitBlocks" DIR_SEP + m_persistent_blocks_game_id +
+         ".bin";
+}
+
+void JitBaseBlockCache::LoadPersistentBlockList()
+{
+  m_persistent_blocks_loaded = true;
+  m_persistent_blocks_game_id = SConfig::GetInstance().GetGameID();
+
+  File::IOFile file(GetPersistentBlockListPath(), "rb");
+  if (!file)
+    return;
+
+  PersistentBlockListHeader header;
+  if (!file.ReadArray(&header, 1) || header.magic != PERSISTENT_BLOCK_LIST_MAGIC ||
+      header.version != PERSISTENT_BLOCK_LIST_VERSION ||
+      file.GetSize() != sizeof(header) + u64{header.num_entries} * sizeof(PersistentBlock))
+  {
+    WARN_LOG_FMT(DYNA_REC, "Ignoring invalid persistent JIT block list {}",
+                 GetPersistentBlockListPath());
+    return;
+  }
+
+  m_persistent_blocks_pending.resize(header.num_entries);
+  if (!file.ReadArray(m_persistent_blocks_pending.data(), m_persistent_blocks_pending.size()))
+  {
+    m_persistent_blocks_pending.clear();
+    return;
+  }
+
+  for (const PersistentBlock& entry : m_persistent_blocks_pending)
+    m_persistent_blocks.emplace(std::make_pair(entry.effective_address, entry.msr_bits), entry);
+
+  INFO_LOG_FMT(DYNA_REC, "Loaded {} blocks from persistent JIT block list",
+               m_persistent_blocks_pending.size());
+}
+
+void JitBaseBlockCache::SavePersistentBlockList()
+{
+  if (m_persistent_blocks_game_id.empty() || m_persistent_blocks.empty())
+    return;
+
+  const std::string path = GetPersistentBlockListPath();
+  File::CreateFullPath(path);
+  File::IOFile file(path, "wb");
+  if (!file)
+    return;
+
+  const PersistentBlockListHeader header{PERSISTENT_BLOCK_LIST_MAGIC,
+                                         PERSISTENT_BLOCK_LIST_VERSION,
+                                         static_cast<u32>(m_persistent_blocks.size())};
+  file.WriteArray(&header, 1);
+  for (const auto& entry : m_persistent_blocks)
+    file.WriteArray(&entry.second, 1);
+}
+
+void JitBaseBlockCache::RecordPersistentBlock(const JitBlock& block)
+{
+  const u32 guest_size = GetContiguousGuestSize(block.physical_ranges, block.physicalAddress);
+  const std::optional<u32> guest_hash = HashGuestCode(block.physicalAddress, guest_size);
+  if (!guest_hash)
+    return;
+
+  m_persistent_blocks[{block.effectiveAddress, block.msrBits}] = {
+      block.effectiveAddress, block.msrBits, block.physicalAddress, guest_size, *guest_hash};
+}
@@ -11,10 +11,15 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <string>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/JitRegister.h"
 
 class JitBase;
 
@@ -77,8 +82,13 @@ struct JitBlock : public JitBlockData
   };
   std::vector<LinkData> linkData;
 
-  // This set stores all physical addresses of all occupied instructions.
-  std::set<u32> physical_addresses;
+  // The physical address ranges [first, second) covered by all occupied instructions, sorted
+  // by address. Most blocks are contiguous, so this usually only contains a single range.
+  std::vector<std::pair<u32, u32>> physical_ranges;
+
+  // Value of the block cache's use counter when this block was last compiled or looked up
+  // through the slow dispatcher path. Blocks with the lowest values get evicted first.
+  u64 last_used = 0;
 
   // Block profiling data, structure is inlined in Jit.cpp
   struct ProfileData
@@ -146,7 +156,9 @@ public:
   void RunOnBlocks(std::function<void(const JitBlock&)> f);
 
   JitBlock* AllocateBlock(u32 em_address);
-  void FinalizeBlock(JitBlock& block, bool block_link, const std::set<u32>& physical_addresses);
+  // source_lines are only needed for perf jitdump output, see JitRegister::RegisterSourceLines.
+  void FinalizeBlock(JitBlock& block, bool block_link, const std::set<u32>& physical_addresses,
+                     const std::vector<JitRegister::SourceLine>& source_lines = {});
 
   // Look for the block in the slow but accurate way.
   // This function shall be used if FastLookupIndexForAddress() failed.
@@ -162,6 +174,16 @@ public:
   void InvalidateICache(u32 address, u32 length, bool forced);
   void ErasePhysicalRange(u32 address, u32 length);
 
+  // Erases up to count blocks, least recently used ones first, so that their code space can be
+  // reused without flushing the whole cache. Returns the number of erased blocks.
+  std::size_t EvictLeastRecentlyUsedBlocks(std::size_t count);
+  std::size_t GetBlockCount() const;
+
+  // Returns the start addresses of up to max_blocks blocks which were compiled during a previous
+  // session of the running game, whose MSR bits match the given MSR, and whose guest code is
+  // unchanged. Each entry is only returned once, so the caller is expected to compile all of them.
+  std::vector<u32> TakePersistentBlocks(u32 msr, std::size_t max_blocks);
+
 protected:
   virtual void DestroyBlock(JitBlock& block);
 
@@ -175,24 +197,57 @@ private:
   void LinkBlock(JitBlock& block);
   void UnlinkBlock(const JitBlock& block);
 
+  void EraseSingleBlock(JitBlock& block);
+
   JitBlock* MoveBlockIntoFastCache(u32 em_address, u32 msr);
 
   // Fast but risky block lookup based on fast_block_map.
   size_t FastLookupIndexForAddress(u32 address);
 
+  // An entry of the on-disk list of compiled blocks. Only the address of the block is stored;
+  // the block gets recompiled from the guest code, so a stale entry can never lead to running
+  // wrong code. The hash covers the contiguous guest code at the start of the block and is
+  // only used to skip blocks whose code has been changed since it was recorded.
+  struct PersistentBlock
+  {
+    u32 effective_address;
+    u32 msr_bits;
+    u32 physical_address;
+    u32 guest_size;
+    u32 guest_hash;
+  };
+
+  std::string GetPersistentBlockListPath() const;
+  void LoadPersistentBlockList();
+  void SavePersistentBlockList();
+  void RecordPersistentBlock(const JitBlock& block);
+
+  bool m_persistent_blocks_enabled = false;
+  bool m_persistent_blocks_loaded = false;
+  std::string m_persistent_blocks_game_id;
+  // (effective address, MSR bits) -> entry, for all blocks which will be written on shutdown.
+  std::map<std::pair<u32, u32>, PersistentBlock> m_persistent_blocks;
+  // Entries loaded from disk which haven't been handed out by TakePersistentBlocks() yet.
+  std::vector<PersistentBlock> m_persistent_blocks_pending;
+
+  // Incremented whenever a block is compiled or looked up, see JitBlock::last_used.
+  u64 m_use_counter = 0;
+
   // links_to hold all exit points of all valid blocks in a reverse way.
   // It is used to query all blocks which links to an address.
-  std::multimap<u32, JitBlock*> links_to;  // destination_PC -> number
+  std::unordered_map<u32, std::unordered_set<JitBlock*>> links_to;  // destination_PC -> blocks
 
   // Map indexed by the physical address of the entry point.
   // This is used to query the block based on the current PC in a slow way.
-  std::multimap<u32, JitBlock> block_map;  // start_addr -> block
+  // References to the elements of an unordered container stay valid on rehashing,
+  // which is required since the other maps store pointers to the blocks.
+  std::unordered_multimap<u32, JitBlock> block_map;  // start_addr -> block
 
   // Range of overlapping code indexed by a masked physical address.
   // This is used for invalidation of memory regions. The range is grouped
   // in macro blocks of each 0x100 bytes.
   static constexpr u32 BLOCK_RANGE_MAP_ELEMENTS = 0x100;
-  std::map<u32, std::set<JitBlock*>> block_range_map;
+  std::map<u32, std::unordered_set<JitBlock*>> block_range_map;
 
   // This bitsets shows which cachelines overlap with any blocks.
   // It is used to provide a fast way to query if no icache invalidation is needed.
@@ -5,10 +5,13 @@
 #include "Core/PowerPC/JitInterface.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cinttypes>
 #include <cstdio>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -121,6 +124,67 @@ void WriteProfileResults(const std::string& filename)
   }
 }
 
+void WriteFunctionProfileResults(const std::string& filename)
+{
+  Profiler::ProfileStats prof_stats;
+  GetProfileResults(&prof_stats);
+
+  File::IOFile f(filename, "w");
+  if (!f)
+  {
+    PanicAlertFmt("Failed to open {}", filename);
+    return;
+  }
+
+  struct FunctionStat
+  {
+    const Common::Symbol* symbol = nullptr;
+    u64 block_count = 0;
+    u64 run_count = 0;
+    u64 cost = 0;
+    u64 tick_counter = 0;
+  };
+
+  // Blocks outside of any known function are all counted under address 0.
+  std::unordered_map<u32, FunctionStat> functions;
+  for (const Profiler::BlockStat& stat : prof_stats.block_stats)
+  {
+    const Common::Symbol* symbol = g_symbolDB.GetSymbolFromAddr(stat.addr);
+    FunctionStat& function = functions[symbol ? symbol->address : 0];
+    function.symbol = symbol;
+    function.block_count++;
+    function.run_count += stat.run_count;
+    function.cost += stat.cost;
+    function.tick_counter += stat.tick_counter;
+  }
+
+  std::vector<FunctionStat> sorted_functions;
+  sorted_functions.reserve(functions.size());
+  for (const auto& entry : functions)
+    sorted_functions.push_back(entry.second);
+  std::sort(sorted_functions.begin(), sorted_functions.end(),
+            [](const FunctionStat& a, const FunctionStat& b) {
+              return a.tick_counter > b.tick_counter;
+            });
+
+  f.WriteString("funcAddr\tfuncName\tblocks\tblkRunCount\tcost\ttimeCost\tpercent\ttimePercent\t"
+                "OvAllinFuncTime(ms)\n");
+  for (const FunctionStat& function : sorted_functions)
+  {
+    const double percent = 100.0 * static_cast<double>(function.cost) /
+                           static_cast<double>(prof_stats.cost_sum);
+    const double time_percent = 100.0 * static_cast<double>(function.tick_counter) /
+                                static_cast<double>(prof_stats.timecost_sum);
+    f.WriteString(fmt::format(
+        "{0:08x}\t{1}\t{2}\t{3}\t{4}\t{5}\t{6:.2f}\t{7:.2f}\t{8:.2f}\n",
+        function.symbol ? function.symbol->address : 0,
+        function.symbol ? function.symbol->name : "(unknown)", function.block_count,
+        function.run_count, function.cost, function.tick_counter, percent, time_percent,
+        static_cast<double>(function.tick_counter) * 1000.0 /
+            static_cast<double>(prof_stats.countsPerSec)));
+  }
+}
+
 void GetProfileResults(Profiler::ProfileStats* prof_stats)
 {
   // Can't really do this with no g_jit core available
@@ -153,6 +217,15 @@ void GetProfileResults(Profiler::ProfileStats* prof_stats)
     Core::SetState(Core::State::Running);
 }
 
+CompileStats GetCompileStats()
+{
+  if (!g_jit)
+    return {};
+
+  return {g_jit->GetCompileCount(),
+          std::chrono::duration<double>(g_jit->GetCompileTime()).count()};
+}
+
 int GetHostCode(u32* address, const u8** code, u32* code_size)
 {
   if (!g_jit)
@@ -248,6 +321,9 @@ void CompileExceptionCheck(ExceptionType type)
   case ExceptionType::SpeculativeConstants:
     exception_addresses = &g_jit->js.noSpeculativeConstantsAddresses;
     break;
+  case ExceptionType::HotBlock:
+    exception_addresses = &g_jit->js.hotBlockAddresses;
+    break;
   }
 
   if (PC != 0 && (exception_addresses->find(PC)) == (exception_addresses->end()))
@@ -29,7 +29,8 @@ enum class ExceptionType
 {
   FIFOWrite,
   PairedQuantize,
-  SpeculativeConstants
+  SpeculativeConstants,
+  HotBlock
 };
 
 void DoState(PointerWrap& p);
@@ -46,7 +47,19 @@ enum class ProfilingState
 
 void SetProfilingState(ProfilingState state);
 void WriteProfileResults(const std::string& filename);
+// Like WriteProfileResults, but sums up the blocks of each function in the symbol database.
+void WriteFunctionProfileResults(const std::string& filename);
 void GetProfileResults(Profiler::ProfileStats* prof_stats);
+
+struct CompileStats
+{
+  u64 count = 0;
+  double seconds = 0.0;
+};
+
+// How many blocks the running JIT has compiled on demand, and how long that took. Only call this
+// on the CPU thread.
+CompileStats GetCompileStats();
 int GetHostCode(u32* address, const u8** code, u32* code_size);
 
 // Memory Utilities
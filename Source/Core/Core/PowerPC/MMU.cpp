@@ -4,6 +4,7 @@
 
 #include "Core/PowerPC/MMU.h"
 
+#include <array>
 #include <cstddef>
 #include <cstring>
 #include <string>
@@ -111,6 +112,71 @@ struct TranslateAddressResult
 template <const XCheckTLBFlag flag>
 static TranslateAddressResult TranslateAddress(u32 address);
 
+// A direct-mapped cache from effective pages which are mapped through the page table to the host
+// memory backing them. It lets data accesses to such pages skip the BAT check, the TLB lookup and
+// the physical address decoding. Entries are only created once a translation has set the R bit
+// (and the C bit for the write cache), so hits never need to update the page table, and the cache
+// is flushed whenever the TLB or the DBATs change.
+struct HostPageCacheEntry
+{
+  static constexpr u32 INVALID_TAG = 0xffffffff;
+
+  u32 tag = INVALID_TAG;
+  u8* host_page = nullptr;
+};
+constexpr u32 HOST_PAGE_CACHE_SIZE = 0x1000;
+static std::array<HostPageCacheEntry, HOST_PAGE_CACHE_SIZE> s_host_page_cache_read;
+static std::array<HostPageCacheEntry, HOST_PAGE_CACHE_SIZE> s_host_page_cache_write;
+
+static void ClearHostPageCache()
+{
+  s_host_page_cache_read.fill({});
+  s_host_page_cache_write.fill({});
+}
+
+template <XCheckTLBFlag flag>
+static u8* GetHostPageCachePointer(u32 em_address, size_t size)
+{
+  if (IsOpcodeFlag(flag) || (em_address & (HW_PAGE_SIZE - 1)) > HW_PAGE_SIZE - size)
+    return nullptr;
+
+  const u32 page = em_address >> HW_PAGE_INDEX_SHIFT;
+  const HostPageCacheEntry& entry =
+      (flag == XCheckTLBFlag::Write ? s_host_page_cache_write :
+                                      s_host_page_cache_read)[page & (HOST_PAGE_CACHE_SIZE - 1)];
+  if (entry.tag != page)
+    return nullptr;
+
+  return entry.host_page + (em_address & (HW_PAGE_SIZE - 1));
+}
+
+template <XCheckTLBFlag flag>
+static void UpdateHostPageCache(u32 em_address, const TranslateAddressResult& translated)
+{
+  // Translations without side effects don't set the R and C bits.
+  if ((flag != XCheckTLBFlag::Read && flag != XCheckTLBFlag::Write) ||
+      translated.result != TranslateAddressResult::PAGE_TABLE_TRANSLATED)
+  {
+    return;
+  }
+
+  const u32 physical_page = translated.address & ~static_cast<u32>(HW_PAGE_SIZE - 1);
+  u8* host_page;
+  if ((physical_page & 0xF8000000) == 0x00000000)
+    host_page = &Memory::m_pRAM[physical_page & Memory::GetRamMask()];
+  else if (Memory::m_pEXRAM && (physical_page >> 28) == 0x1 &&
+           (physical_page & 0x0FFFFFFF) < Memory::GetExRamSizeReal())
+    host_page = &Memory::m_pEXRAM[physical_page & 0x0FFFFFFF];
+  else
+    return;
+
+  const u32 page = em_address >> HW_PAGE_INDEX_SHIFT;
+  const HostPageCacheEntry entry{page, host_page};
+  s_host_page_cache_read[page & (HOST_PAGE_CACHE_SIZE - 1)] = entry;
+  if (flag == XCheckTLBFlag::Write)
+    s_host_page_cache_write[page & (HOST_PAGE_CACHE_SIZE - 1)] = entry;
+}
+
 // Nasty but necessary. Super Mario Galaxy pointer relies on this stuff.
 static u32 EFB_Read(const u32 addr)
 {
@@ -171,6 +237,13 @@ static T ReadFromHardware(u32 em_address)
 {
   if (!never_translate && MSR.DR)
   {
+    if (const u8* host_ptr = GetHostPageCachePointer<flag>(em_address, sizeof(T)))
+    {
+      T value;
+      std::memcpy(&value, host_ptr, sizeof(T));
+      return bswap(value);
+    }
+
     auto translated_addr = TranslateAddress<flag>(em_address);
     if (!translated_addr.Success())
     {
@@ -202,6 +275,7 @@ static T ReadFromHardware(u32 em_address)
       }
       return var;
     }
+    UpdateHostPageCache<flag>(em_address, translated_addr);
     em_address = translated_addr.address;
   }
 
@@ -259,6 +333,13 @@ static void WriteToHardware(u32 em_address, const T data)
 {
   if (!never_translate && MSR.DR)
   {
+    if (u8* host_ptr = GetHostPageCachePointer<flag>(em_address, sizeof(T)))
+    {
+      const T swapped_data = bswap(data);
+      std::memcpy(host_ptr, &swapped_data, sizeof(T));
+      return;
+    }
+
     auto translated_addr = TranslateAddress<flag>(em_address);
     if (!translated_addr.Success())
     {
@@ -291,6 +372,7 @@ static void WriteToHardware(u32 em_address, const T data)
       }
       return;
     }
+    UpdateHostPageCache<flag>(em_address, translated_addr);
     em_address = translated_addr.address;
   }
 
@@ -979,6 +1061,8 @@ void SDRUpdated()
   }
   PowerPC::ppcState.pagetable_base = htaborg << 16;
   PowerPC::ppcState.pagetable_hashmask = ((htabmask << 10) | 0x3ff);
+  ClearHostPageCache();
+  Memory::UnmapLogicalPages();
 }
 
 enum class TLBLookupResult
@@ -1058,6 +1142,15 @@ void InvalidateTLBEntry(u32 address)
 {
   const u32 entry_index = (address >> HW_PAGE_INDEX_SHIFT) & HW_PAGE_INDEX_MASK;
 
+  // Drop every cached page which could have been translated through this TLB set.
+  for (u32 i = entry_index; i < HOST_PAGE_CACHE_SIZE; i += HW_PAGE_INDEX_MASK + 1)
+  {
+    s_host_page_cache_read[i] = {};
+    s_host_page_cache_write[i] = {};
+  }
+
+  Memory::UnmapLogicalPages(HW_PAGE_INDEX_MASK, entry_index);
+
   TLBEntry& tlbe = ppcState.tlb[0][entry_index];
   tlbe.tag[0] = TLBEntry::INVALID_TAG;
   tlbe.tag[1] = TLBEntry::INVALID_TAG;
@@ -1158,6 +1251,46 @@ static TranslateAddressResult TranslatePageAddress(const u32 address, const XChe
   return TranslateAddressResult{TranslateAddressResult::PAGE_FAULT, 0};
 }
 
+// Whether the data TLB entry for the given address has the C bit set.
+static bool IsTLBEntryChanged(u32 address)
+{
+  const u32 tag = address >> HW_PAGE_INDEX_SHIFT;
+  const TLBEntry& tlbe = ppcState.tlb[0][tag & HW_PAGE_INDEX_MASK];
+  for (int i = 0; i < 2; ++i)
+  {
+    if (tlbe.tag[i] == tag)
+      return (tlbe.pte[i] & PTE2_C) != 0;
+  }
+  return false;
+}
+
+bool HandleLogicalFastmemFault(u32 effective_address)
+{
+  if (!MSR.DR || PowerPC::memchecks.OverlapsMemcheck(effective_address & ~(HW_PAGE_SIZE - 1),
+                                                     static_cast<u32>(HW_PAGE_SIZE)))
+  {
+    return false;
+  }
+
+  // Pages translated by a BAT are either mapped already or not backed by RAM.
+  u32 bat_address = effective_address;
+  if (TranslateBatAddess(dbat_table, &bat_address))
+    return false;
+
+  // Fastmem accesses can't update the R and C bits, so they are set before mapping the page. The
+  // page is mapped read-only until it's marked as changed, so the first write to it faults again.
+  // Hence a fault on a page which is already mapped has to be a write.
+  const bool write = Memory::IsLogicalPageMapped(effective_address);
+  const TranslateAddressResult translated =
+      write ? TranslatePageAddress(effective_address, XCheckTLBFlag::Write) :
+              TranslatePageAddress(effective_address, XCheckTLBFlag::Read);
+  if (translated.result != TranslateAddressResult::PAGE_TABLE_TRANSLATED)
+    return false;
+
+  return Memory::MapLogicalPage(effective_address, translated.address,
+                                write || IsTLBEntryChanged(effective_address));
+}
+
 static void UpdateBATs(BatTable& bat_table, u32 base_spr)
 {
   // TODO: Separate BATs for MSR.PR==0 and MSR.PR==1
@@ -1220,9 +1353,13 @@ static void UpdateBATs(BatTable& bat_table, u32 base_spr)
                  physical_address < 0xE0000000 + Memory::GetL1CacheSize())
           valid_bit |= BAT_PHYSICAL_BIT;
 
-        // Fastmem doesn't support memchecks, so disable it for all overlapping virtual pages.
-        if (PowerPC::memchecks.OverlapsMemcheck(virtual_address, BAT_PAGE_SIZE))
-          valid_bit &= ~BAT_PHYSICAL_BIT;
+        // Accesses to these virtual pages can't skip the memchecks, so only the parts of them
+        // that no memcheck overlaps are mapped in the fastmem arena.
+        if ((valid_bit & BAT_PHYSICAL_BIT) &&
+            PowerPC::memchecks.OverlapsMemcheck(virtual_address, BAT_PAGE_SIZE))
+        {
+          valid_bit = (valid_bit & ~BAT_PHYSICAL_BIT) | BAT_WATCHED_BIT;
+        }
 
         // (BEPI | j) == (BEPI & ~BL) | (j & BL).
         bat_table[virtual_address >> BAT_INDEX_SHIFT] = physical_address | valid_bit;
@@ -1242,7 +1379,7 @@ static void UpdateFakeMMUBat(BatTable& bat_table, u32 start_addr)
     u32 flags = BAT_MAPPED_BIT | BAT_PHYSICAL_BIT;
 
     if (PowerPC::memchecks.OverlapsMemcheck(e_address << BAT_INDEX_SHIFT, BAT_PAGE_SIZE))
-      flags &= ~BAT_PHYSICAL_BIT;
+      flags = (flags & ~BAT_PHYSICAL_BIT) | BAT_WATCHED_BIT;
 
     bat_table[e_address] = p_address | flags;
   }
@@ -1250,6 +1387,7 @@ static void UpdateFakeMMUBat(BatTable& bat_table, u32 start_addr)
 
 void DBATUpdated()
 {
+  ClearHostPageCache();
   dbat_table = {};
   UpdateBATs(dbat_table, SPR_DBAT0U);
   bool extended_bats = SConfig::GetInstance().bWii && HID4.SBE;
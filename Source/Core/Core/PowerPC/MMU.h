@@ -88,6 +88,11 @@ void InvalidateTLBEntry(u32 address);
 void DBATUpdated();
 void IBATUpdated();
 
+// Called by the JITs when a fastmem access to the logical address space faults. If the page is
+// translated to RAM through the page table, it gets mapped into the fastmem arena and the access
+// can simply be retried. Returns whether that is the case.
+bool HandleLogicalFastmemFault(u32 effective_address);
+
 // Result changes based on the BAT registers and MSR.DR.  Returns whether
 // it's safe to optimize a read or write to this address to an unguarded
 // memory access.  Does not consider page tables.
@@ -107,7 +112,10 @@ constexpr int BAT_INDEX_SHIFT = 17;
 constexpr u32 BAT_PAGE_SIZE = 1 << BAT_INDEX_SHIFT;
 constexpr u32 BAT_MAPPED_BIT = 0x1;
 constexpr u32 BAT_PHYSICAL_BIT = 0x2;
-constexpr u32 BAT_RESULT_MASK = UINT32_C(~0x3);
+// Set instead of BAT_PHYSICAL_BIT for RAM that a memcheck overlaps, which is only partially mapped
+// in the fastmem arena.
+constexpr u32 BAT_WATCHED_BIT = 0x4;
+constexpr u32 BAT_RESULT_MASK = UINT32_C(~0x7);
 using BatTable = std::array<u32, 1 << (32 - BAT_INDEX_SHIFT)>;  // 128 KB
 extern BatTable ibat_table;
 extern BatTable dbat_table;
@@ -17,6 +17,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/StringUtil.h"
 #include "Core/ConfigManager.h"
+#include "Core/HLE/HLE.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/MMU.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
@@ -38,9 +39,6 @@
 
 namespace PPCAnalyst
 {
-// 0 does not perform block merging
-constexpr u32 BRANCH_FOLLOWING_THRESHOLD = 2;
-
 constexpr u32 INVALID_BRANCH_TARGET = 0xFFFFFFFF;
 
 static u32 EvaluateBranchTarget(UGeckoInstruction instr, u32 pc)
@@ -519,12 +517,57 @@ void PPCAnalyzer::ReorderInstructions(u32 instructions, CodeOp* code)
     ReorderInstructionsCore(instructions, code, false, ReorderType::CMP);
 }
 
+static void SetCRStats(CodeOp* code, const GekkoOPInfo* opinfo)
+{
+  const UGeckoInstruction inst = code->inst;
+
+  code->crIn = BitSet8(0);
+  code->crOut = BitSet8(0);
+
+  // Conditional branches read the CR field holding BI.
+  const bool is_bcx = inst.OPCD == 16;
+  const bool is_bclrx_or_bcctrx = inst.OPCD == 19 && (inst.SUBOP10 == 16 || inst.SUBOP10 == 528);
+  if ((is_bcx || is_bclrx_or_bcctrx) && !(inst.BO & BO_DONT_CHECK_CONDITION))
+    code->crIn[inst.BI >> 2] = true;
+
+  // The CR logical instructions only modify a single bit of their destination field, so the
+  // destination field has to be treated as an input too.
+  if (opinfo->type == OpType::CR)
+  {
+    code->crIn[inst.CRBA >> 2] = true;
+    code->crIn[inst.CRBB >> 2] = true;
+    code->crIn[inst.CRBD >> 2] = true;
+  }
+
+  if (inst.OPCD == 19 && inst.SUBOP10 == 0)  // mcrf
+    code->crIn[inst.CRFS] = true;
+  if (inst.OPCD == 31 && inst.SUBOP10 == 19)  // mfcr
+    code->crIn = BitSet8(0xFF);
+
+  if (inst.OPCD == 31 && inst.SUBOP10 == 144)  // mtcrf
+  {
+    for (int i = 0; i < 8; i++)
+      code->crOut[i] = (inst.CRM & (0x80 >> i)) != 0;
+  }
+  else if (opinfo->flags & FL_SET_CRn)
+  {
+    code->crOut[inst.CRFD] = true;
+  }
+
+  if ((opinfo->flags & FL_RC_BIT) && inst.Rc)
+    code->crOut[0] = true;
+  if ((opinfo->flags & FL_RC_BIT_F) && inst.Rc)
+    code->crOut[1] = true;
+  // lwarx is flagged as setting CR0, but only stwcx. actually does.
+  if ((opinfo->flags & FL_SET_CR0) && opinfo->type != OpType::Load)
+    code->crOut[0] = true;
+  if (opinfo->flags & FL_SET_CR1)
+    code->crOut[1] = true;
+}
+
 void PPCAnalyzer::SetInstructionStats(CodeBlock* block, CodeOp* code, const GekkoOPInfo* opinfo,
                                       u32 index)
 {
-  code->wantsCR0 = false;
-  code->wantsCR1 = false;
-
   if (opinfo->flags & FL_USE_FPU)
     block->m_fpa->any = true;
 
@@ -547,6 +590,8 @@ void PPCAnalyzer::SetInstructionStats(CodeBlock* block, CodeOp* code, const Gekk
   else
     code->outputCR1 = (opinfo->flags & FL_SET_CR1) != 0;
 
+  SetCRStats(code, opinfo);
+
   code->wantsFPRF = (opinfo->flags & FL_READ_FPRF) != 0;
   code->outputFPRF = (opinfo->flags & FL_SET_FPRF) != 0;
   code->canEndBlock = (opinfo->flags & FL_ENDBLOCK) != 0;
@@ -674,20 +719,53 @@ void PPCAnalyzer::SetInstructionStats(CodeBlock* block, CodeOp* code, const Gekk
   }
 }
 
+// Instructions which neither have side effects nor depend on anything but registers and memory,
+// and so can't break out of a loop on their own.
+static bool IsBusyWaitLoopInstruction(const CodeOp& op)
+{
+  switch (op.opinfo->type)
+  {
+  case OpType::Integer:
+  case OpType::Load:
+  case OpType::CR:
+    return true;
+
+  case OpType::System:
+    // mcrf, and mfcr/mfmsr/sync/eieio, which show up in MMIO polling loops.
+    return (op.inst.OPCD == 19 && op.inst.SUBOP10 == 0) ||
+           (op.inst.OPCD == 31 && (op.inst.SUBOP10 == 19 || op.inst.SUBOP10 == 83 ||
+                                   op.inst.SUBOP10 == 598 || op.inst.SUBOP10 == 854));
+
+  case OpType::InstructionCache:
+    // isync
+    return op.inst.OPCD == 19 && op.inst.SUBOP10 == 150;
+
+  case OpType::DataCache:
+    // dcbt/dcbtst are only hints.
+    return op.inst.OPCD == 31 && (op.inst.SUBOP10 == 278 || op.inst.SUBOP10 == 246);
+
+  default:
+    return false;
+  }
+}
+
 bool PPCAnalyzer::IsBusyWaitLoop(CodeBlock* block, CodeOp* code, size_t instructions)
 {
   // Very basic algorithm to detect busy wait loops:
-  //   * It loops to itself and does not contain any other branches.
-  //   * It does not write to memory.
-  //   * It only reads from registers it wrote to earlier in the loop, or it
+  //   * It loops to itself and does not contain any other branches, except for calls which have
+  //     been inlined by branch following.
+  //   * It does not write to memory or have other side effects.
+  //   * It only reads from registers (GPRs or CR fields) it wrote to earlier in the loop, or it
   //     does not write to these registers.
   //
-  // Would benefit a lot from basic inlining support - a lot of the most
-  // used busy loops are DSP register interactions, which are bl/cmp/bne
-  // (with the bl target a pure function that follows the above rules). We
-  // don't detect these at the moment.
+  // This covers polling MMIO registers (VI, PI interrupt cause, the DSP mailbox), including through
+  // small leaf helpers like DSPCheckMailFromDSP as long as they get inlined, as well as the OS idle
+  // loop spinning on the run queue. Loops which read the time base are not detected, as they have
+  // to exit at a specific time rather than when the next event changes something.
   std::bitset<32> write_disallowed_regs;
   std::bitset<32> written_regs;
+  BitSet8 write_disallowed_cr;
+  BitSet8 written_cr;
   for (size_t i = 0; i <= instructions; ++i)
   {
     if (code[i].opinfo->type == OpType::Branch)
@@ -697,11 +775,8 @@ bool PPCAnalyzer::IsBusyWaitLoop(CodeBlock* block, CodeOp* code, size_t instruct
       if (code[i].branchTo == block->m_address && i == instructions)
         return true;
     }
-    else if (code[i].opinfo->type != OpType::Integer && code[i].opinfo->type != OpType::Load)
+    else if (!IsBusyWaitLoopInstruction(code[i]))
     {
-      // In the future, some subsets of other instruction types might get
-      // supported. Right now, only try loops that have this very
-      // restricted instruction set.
       return false;
     }
     else
@@ -722,6 +797,11 @@ bool PPCAnalyzer::IsBusyWaitLoop(CodeBlock* block, CodeOp* code, size_t instruct
           return false;
         written_regs[reg] = true;
       }
+
+      write_disallowed_cr |= code[i].crIn & ~written_cr;
+      if (code[i].crOut & write_disallowed_cr)
+        return false;
+      written_cr |= code[i].crOut;
     }
   }
   return false;
@@ -787,7 +867,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std:
 
     bool conditional_continue = false;
 
-    // TODO: Find the optimal value for BRANCH_FOLLOWING_THRESHOLD.
+    // TODO: Find the optimal value for the branch following threshold.
     //       If it is small, the performance will be down.
     //       If it is big, the size of generated code will be big and
     //       cache clearning will happen many times.
@@ -818,7 +898,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std:
       {
         code[i].branchTo = code[caller].address + 4;
         if ((inst.BO & BO_DONT_DECREMENT_FLAG) && (inst.BO & BO_DONT_CHECK_CONDITION) &&
-            numFollows < BRANCH_FOLLOWING_THRESHOLD)
+            numFollows < m_branch_following_threshold)
         {
           // bclrx with unconditional branch = return
           // Follow it if we can propagate the LR value of the last CALL instruction.
@@ -878,7 +958,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std:
     code[i].branchIsIdleLoop =
         code[i].branchTo == block->m_address && IsBusyWaitLoop(block, code, i);
 
-    if (follow && numFollows < BRANCH_FOLLOWING_THRESHOLD)
+    if (follow && numFollows < m_branch_following_threshold)
     {
       // Follow the unconditional branch.
       numFollows++;
@@ -915,34 +995,58 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std:
 
   // Scan for flag dependencies; assume the next block (or any branch that can leave the block)
   // wants flags, to be safe.
-  bool wantsCR0 = true, wantsCR1 = true, wantsFPRF = true, wantsCA = true;
+  BitSet8 wantsCR = BitSet8(0xFF);
+  bool wantsFPRF = true, wantsCA = true;
   BitSet32 fprInUse, gprInUse, gprInReg, fprInXmm;
+
+  // Registers written before they are read in the rest of the block. Anything that can exit the
+  // block ends the search, since the values then become visible to the outside (exception
+  // handlers, HLE hooks, the debugger). Only GPRs are tracked, as most writes to FPRs keep ps1.
+  const bool discard_dead_registers =
+      HasOption(OPTION_DISCARD_DEAD_REGISTERS) && !SConfig::GetInstance().bEnableDebugging;
+  u32 first_fpu_op = block->m_num_instructions;
+  for (u32 i = 0; i < block->m_num_instructions; i++)
+  {
+    if (!code[i].skip && (code[i].opinfo->flags & FL_USE_FPU))
+    {
+      first_fpu_op = i;
+      break;
+    }
+  }
+  BitSet32 gprOverwritten;
+
   for (int i = block->m_num_instructions - 1; i >= 0; i--)
   {
     CodeOp& op = code[i];
 
-    const bool opWantsCR0 = op.wantsCR0;
-    const bool opWantsCR1 = op.wantsCR1;
     const bool opWantsFPRF = op.wantsFPRF;
     const bool opWantsCA = op.wantsCA;
-    op.wantsCR0 = wantsCR0 || op.canEndBlock;
-    op.wantsCR1 = wantsCR1 || op.canEndBlock;
+    op.wantsCR = op.canEndBlock ? BitSet8(0xFF) : wantsCR;
     op.wantsFPRF = wantsFPRF || op.canEndBlock;
     op.wantsCA = wantsCA || op.canEndBlock;
-    wantsCR0 |= opWantsCR0 || op.canEndBlock;
-    wantsCR1 |= opWantsCR1 || op.canEndBlock;
+    if (op.canEndBlock)
+      wantsCR = BitSet8(0xFF);
+    wantsCR = (wantsCR & ~op.crOut) | op.crIn;
     wantsFPRF |= opWantsFPRF || op.canEndBlock;
     wantsCA |= opWantsCA || op.canEndBlock;
-    wantsCR0 &= !op.outputCR0 || opWantsCR0;
-    wantsCR1 &= !op.outputCR1 || opWantsCR1;
     wantsFPRF &= !op.outputFPRF || opWantsFPRF;
     wantsCA &= !op.outputCA || opWantsCA;
     op.gprInUse = gprInUse;
     op.fprInUse = fprInUse;
     op.gprInReg = gprInReg;
     op.fprInXmm = fprInXmm;
-    // TODO: if there's no possible endblocks or exceptions in between, tell the regcache
-    // we can throw away a register if it's going to be overwritten later.
+    // The JITs check for FPU unavailable exceptions at the first FPU instruction, and for
+    // interrupts after stores to the gather pipe, so those count as possible exits too.
+    const bool can_exit = !discard_dead_registers || op.canEndBlock ||
+                          (op.opinfo->flags &
+                           (FL_ENDBLOCK | FL_CHECKEXCEPTIONS | FL_EVIL | FL_LOADSTORE)) ||
+                          static_cast<u32>(i) == first_fpu_op ||
+                          HLE::GetHookByAddress(op.address) != 0;
+    if (can_exit)
+      gprOverwritten = BitSet32{};
+    op.gprDiscardable = gprOverwritten;
+    if (!can_exit && !op.skip)
+      gprOverwritten = (gprOverwritten | op.regsOut) & ~op.regsIn;
     gprInUse |= op.regsIn;
     gprInReg |= op.regsIn;
     fprInUse |= op.fregsIn;
@@ -35,8 +35,6 @@ struct CodeOp  // 16B
   bool isBranchTarget;
   bool branchUsesCtr;
   bool branchIsIdleLoop;
-  bool wantsCR0;
-  bool wantsCR1;
   bool wantsFPRF;
   bool wantsCA;
   bool wantsCAInFlags;
@@ -47,6 +45,12 @@ struct CodeOp  // 16B
   bool canEndBlock;
   bool skipLRStack;
   bool skip;  // followed BL-s for example
+  // which CR fields are read by this instruction
+  BitSet8 crIn;
+  // which CR fields are overwritten in full by this instruction
+  BitSet8 crOut;
+  // which CR fields are still needed after this instruction in this block
+  BitSet8 wantsCR;
   // which registers are still needed after this instruction in this block
   BitSet32 fprInUse;
   BitSet32 gprInUse;
@@ -55,6 +59,9 @@ struct CodeOp  // 16B
   // we do double stores from GPRs, so we don't want to load a PowerPC floating point register into
   // an XMM only to move it again to a GPR afterwards.
   BitSet32 fprInXmm;
+  // which registers are overwritten later in this block before being read, with no way to leave the
+  // block or take an exception in between. Their current values never need to be written back.
+  BitSet32 gprDiscardable;
   // whether an fpr is known to be an actual single-precision value at this point in the block.
   BitSet32 fprIsSingle;
   // whether an fpr is known to have identical top and bottom halves (e.g. due to a single
@@ -195,12 +202,21 @@ public:
 
     // Reorder cror instructions next to their associated fcmp.
     OPTION_CROR_MERGE = (1 << 6),
+
+    // Find registers whose values are dead because they get overwritten later in the block, so
+    // that the register cache can drop them instead of writing them back.
+    OPTION_DISCARD_DEAD_REGISTERS = (1 << 7),
   };
 
+  // The maximum number of unconditional branches (including inlined calls and returns) which
+  // get followed when OPTION_BRANCH_FOLLOW is set. 0 does not perform block merging.
+  static constexpr u32 DEFAULT_BRANCH_FOLLOWING_THRESHOLD = 2;
+
   // Option setting/getting
   void SetOption(AnalystOption option) { m_options |= option; }
   void ClearOption(AnalystOption option) { m_options &= ~(option); }
   bool HasOption(AnalystOption option) const { return !!(m_options & option); }
+  void SetBranchFollowingThreshold(u32 threshold) { m_branch_following_threshold = threshold; }
   u32 Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std::size_t block_size);
 
 private:
@@ -218,6 +234,7 @@ private:
 
   // Options
   u32 m_options = 0;
+  u32 m_branch_following_threshold = DEFAULT_BRANCH_FOLLOWING_THRESHOLD;
 };
 
 void FindFunctions(u32 startAddr, u32 endAddr, PPCSymbolDB* func_db);
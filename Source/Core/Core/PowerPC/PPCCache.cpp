@@ -98,6 +98,7 @@ void InstructionCache::Reset()
   lookup_table.fill(0xFF);
   lookup_table_ex.fill(0xFF);
   lookup_table_vmem.fill(0xFF);
+  last_line = INVALID_LINE;
   JitInterface::ClearSafe();
 }
 
@@ -128,6 +129,8 @@ void InstructionCache::Invalidate(u32 addr)
     }
   }
   valid[set] = 0;
+  if (last_set == set)
+    last_line = INVALID_LINE;
   JitInterface::InvalidateICache(addr & ~0x1f, 32, false);
 }
 
@@ -135,6 +138,12 @@ u32 InstructionCache::ReadInstruction(u32 addr)
 {
   if (!HID0.ICE)  // instruction cache is disabled
     return Memory::Read_U32(addr);
+
+  // Fast path for sequential fetches from the same line. The stale data check below is skipped
+  // here; it was done when this line was looked up.
+  if ((addr & ~0x1f) == last_line)
+    return Common::swap32(data[last_set][last_way][(addr >> 2) & 7]);
+
   u32 set = (addr >> 5) & 0x7f;
   u32 tag = addr >> 12;
 
@@ -184,6 +193,9 @@ u32 InstructionCache::ReadInstruction(u32 addr)
   }
   // update plru
   plru[set] = (plru[set] & ~s_plru_mask[t]) | s_plru_value[t];
+  last_line = addr & ~0x1f;
+  last_set = set;
+  last_way = t;
   const u32 res = Common::swap32(data[set][t][(addr >> 2) & 7]);
   const u32 inmem = Memory::Read_U32(addr);
   if (res != inmem)
@@ -205,5 +217,8 @@ void InstructionCache::DoState(PointerWrap& p)
   p.DoArray(lookup_table);
   p.DoArray(lookup_table_ex);
   p.DoArray(lookup_table_vmem);
+
+  if (p.GetMode() == PointerWrap::MODE_READ)
+    last_line = INVALID_LINE;
 }
 }  // namespace PowerPC
@@ -31,6 +31,13 @@ struct InstructionCache
   std::array<u8, 1 << 21> lookup_table_ex;
   std::array<u8, 1 << 20> lookup_table_vmem;
 
+  // The most recently used line, so that sequential fetches from it can skip the lookup and the
+  // PLRU update (which wouldn't change anything). Not saved in savestates.
+  static constexpr u32 INVALID_LINE = 0xffffffff;
+  u32 last_line = INVALID_LINE;
+  u32 last_set = 0;
+  u32 last_way = 0;
+
   InstructionCache();
   u32 ReadInstruction(u32 addr);
   void Invalidate(u32 addr);
@@ -161,6 +161,10 @@ struct PowerPCState
   // Storage for the stack pointer of the BLR optimization.
   u8* stored_stack_pointer;
 
+  // The last floating point result whose FPRF the JIT hasn't written to fpscr yet. Only used
+  // within a block, FPRF is always up to date when leaving it.
+  u64 pending_fprf_source;
+
   std::array<std::array<TLBEntry, TLB_SIZE / TLB_WAYS>, NUM_TLBS> tlb;
 
   u32 pagetable_base;
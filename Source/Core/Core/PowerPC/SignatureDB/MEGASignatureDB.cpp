@@ -123,6 +123,55 @@ MEGASignatureDB::~MEGASignatureDB() = default;
 void MEGASignatureDB::Clear()
 {
   m_signatures.clear();
+  m_index_by_first_instruction.clear();
+  m_index_by_size.clear();
+}
+
+void MEGASignatureDB::BuildIndex()
+{
+  m_index_by_first_instruction.clear();
+  m_index_by_size.clear();
+
+  for (size_t i = 0; i < m_signatures.size(); ++i)
+  {
+    const MEGASignature& sig = m_signatures[i];
+    const u32 size = static_cast<u32>(sig.code.size() * sizeof(u32));
+    if (!sig.code.empty() && sig.code[0] != 0)
+      m_index_by_first_instruction[{size, sig.code[0]}].push_back(i);
+    else
+      m_index_by_size[size].push_back(i);
+  }
+}
+
+const MEGASignature* MEGASignatureDB::FindSignature(u32 address, u32 size) const
+{
+  static const std::vector<size_t> s_no_candidates;
+
+  const auto size_iter = m_index_by_size.find(size);
+  const std::vector<size_t>& wildcard_candidates =
+      size_iter != m_index_by_size.end() ? size_iter->second : s_no_candidates;
+
+  const u32 first_instruction = PowerPC::HostRead_U32(address);
+  const auto first_iter = m_index_by_first_instruction.find({size, first_instruction});
+  const std::vector<size_t>& candidates =
+      first_iter != m_index_by_first_instruction.end() ? first_iter->second : s_no_candidates;
+
+  // Walk both candidate lists in file order, so that the first matching signature wins like it
+  // would when comparing against every signature.
+  auto it_a = candidates.begin();
+  auto it_b = wildcard_candidates.begin();
+  while (it_a != candidates.end() || it_b != wildcard_candidates.end())
+  {
+    size_t index;
+    if (it_b == wildcard_candidates.end() || (it_a != candidates.end() && *it_a < *it_b))
+      index = *it_a++;
+    else
+      index = *it_b++;
+
+    if (Compare(address, size, m_signatures[index]))
+      return &m_signatures[index];
+  }
+  return nullptr;
 }
 
 bool MEGASignatureDB::Load(const std::string& file_path)
@@ -148,6 +197,7 @@ bool MEGASignatureDB::Load(const std::string& file_path)
       WARN_LOG_FMT(SYMBOLS, "MEGA database failed to parse line {}", i);
     }
   }
+  BuildIndex();
   return true;
 }
 
@@ -162,15 +212,11 @@ void MEGASignatureDB::Apply(PPCSymbolDB* symbol_db) const
   for (auto& it : symbol_db->AccessSymbols())
   {
     auto& symbol = it.second;
-    for (const auto& sig : m_signatures)
+    if (const MEGASignature* sig = FindSignature(symbol.address, symbol.size))
     {
-      if (Compare(symbol.address, symbol.size, sig))
-      {
-        symbol.name = sig.name;
-        INFO_LOG_FMT(SYMBOLS, "Found {} at {:08x} (size: {:08x})!", sig.name, symbol.address,
-                     symbol.size);
-        break;
-      }
+      symbol.name = sig->name;
+      INFO_LOG_FMT(SYMBOLS, "Found {} at {:08x} (size: {:08x})!", sig->name, symbol.address,
+                   symbol.size);
     }
   }
   symbol_db->Index();
@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -53,5 +55,13 @@ public:
   bool Add(u32 startAddr, u32 size, const std::string& name) override;
 
 private:
+  void BuildIndex();
+  const MEGASignature* FindSignature(u32 address, u32 size) const;
+
   std::vector<MEGASignature> m_signatures;
+
+  // Indices into m_signatures, in file order. Signatures whose first instruction is not a
+  // wildcard are keyed by their size and first instruction; the others only by their size.
+  std::map<std::pair<u32, u32>, std::vector<size_t>> m_index_by_first_instruction;
+  std::map<u32, std::vector<size_t>> m_index_by_size;
 };
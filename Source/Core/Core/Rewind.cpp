@@ -0,0 +1,247 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/Rewind.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <zstd.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/Logging/Log.h"
+#include "Common/Thread.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/NetPlayProto.h"
+#include "Core/State.h"
+
+namespace Rewind
+{
+// Any this many consecutive snapshots together contain all of memory, so going back never needs
+// a full snapshot, which would take far too long to save while the game is running.
+constexpr u32 REFRESH_PERIOD = 32;
+constexpr int COMPRESSION_LEVEL = 1;
+
+// How many buffers for uncompressed snapshots are kept around, so that saving a snapshot doesn't
+// have to allocate (and page fault in) a new one every time.
+constexpr size_t MAX_SPARE_BUFFERS = 2;
+
+struct Snapshot
+{
+  std::vector<u8> compressed;
+  size_t size;
+};
+
+static bool s_enabled = false;
+static u32 s_interval = 0;
+static size_t s_max_buffer_size = 0;
+
+// Only used on the CPU thread
+static u32 s_fields_until_snapshot = 0;
+
+static std::mutex s_mutex;
+static std::condition_variable s_work_cv;
+static std::condition_variable s_idle_cv;
+static std::deque<std::vector<u8>> s_pending_snapshots;
+static std::vector<std::vector<u8>> s_spare_buffers;
+static bool s_compressing = false;
+static bool s_exiting = false;
+// Oldest first. Unless the oldest snapshot is the first one that was taken, which is a full
+// snapshot, only the ones with REFRESH_PERIOD - 1 others before them can be gone back to.
+static std::deque<Snapshot> s_snapshots;
+static size_t s_buffer_size = 0;
+static bool s_oldest_is_full = true;
+// Whether the most recent snapshot is the one that was gone back to last
+static bool s_newest_was_rewound_to = false;
+static std::thread s_compression_thread;
+
+static void CompressionThread()
+{
+  Common::SetCurrentThreadName("Rewind compression thread");
+
+  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context(ZSTD_createCCtx(), ZSTD_freeCCtx);
+
+  std::unique_lock lock(s_mutex);
+  while (true)
+  {
+    s_work_cv.wait(lock, [] { return s_exiting || !s_pending_snapshots.empty(); });
+    if (s_exiting)
+      return;
+
+    std::vector<u8> buffer = std::move(s_pending_snapshots.front());
+    s_pending_snapshots.pop_front();
+    s_compressing = true;
+    lock.unlock();
+
+    Snapshot snapshot{std::vector<u8>(ZSTD_compressBound(buffer.size())), buffer.size()};
+    const size_t result =
+        context ? ZSTD_compressCCtx(context.get(), snapshot.compressed.data(),
+                                    snapshot.compressed.size(), buffer.data(), buffer.size(),
+                                    COMPRESSION_LEVEL) :
+                  0;
+
+    lock.lock();
+    s_compressing = false;
+
+    if (!context || ZSTD_isError(result))
+    {
+      // Later snapshots are based on this one, so they're useless without it
+      ERROR_LOG_FMT(CORE, "Failed to compress rewind snapshot");
+      s_snapshots.clear();
+      s_buffer_size = 0;
+      s_oldest_is_full = false;
+    }
+    else
+    {
+      snapshot.compressed.resize(result);
+      snapshot.compressed.shrink_to_fit();
+      s_buffer_size += snapshot.compressed.size();
+      s_snapshots.push_back(std::move(snapshot));
+
+      while (s_buffer_size > s_max_buffer_size && s_snapshots.size() > REFRESH_PERIOD)
+      {
+        s_buffer_size -= s_snapshots.front().compressed.size();
+        s_snapshots.pop_front();
+        s_oldest_is_full = false;
+      }
+    }
+
+    if (s_spare_buffers.size() < MAX_SPARE_BUFFERS)
+      s_spare_buffers.push_back(std::move(buffer));
+
+    s_idle_cv.notify_all();
+  }
+}
+
+static void TakeSnapshot()
+{
+  std::vector<u8> buffer;
+  {
+    std::lock_guard lock(s_mutex);
+    if (!s_spare_buffers.empty())
+    {
+      buffer = std::move(s_spare_buffers.back());
+      s_spare_buffers.pop_back();
+    }
+  }
+
+  State::SaveSnapshot(buffer, true, REFRESH_PERIOD);
+
+  {
+    std::lock_guard lock(s_mutex);
+    s_pending_snapshots.push_back(std::move(buffer));
+    s_newest_was_rewound_to = false;
+  }
+  s_work_cv.notify_one();
+}
+
+void Init()
+{
+  s_enabled = Config::Get(Config::MAIN_REWIND_ENABLE);
+  s_interval = std::max<u32>(Config::Get(Config::MAIN_REWIND_INTERVAL), 1);
+  s_max_buffer_size = size_t(Config::Get(Config::MAIN_REWIND_BUFFER_SIZE)) * 1024 * 1024;
+  s_fields_until_snapshot = s_interval;
+
+  if (!s_enabled)
+    return;
+
+  s_exiting = false;
+  s_oldest_is_full = true;
+  s_newest_was_rewound_to = false;
+  s_compression_thread = std::thread(CompressionThread);
+}
+
+void Shutdown()
+{
+  if (s_compression_thread.joinable())
+  {
+    {
+      std::lock_guard lock(s_mutex);
+      s_exiting = true;
+    }
+    s_work_cv.notify_one();
+    s_compression_thread.join();
+  }
+
+  s_enabled = false;
+  s_pending_snapshots.clear();
+  s_spare_buffers.clear();
+  s_snapshots.clear();
+  s_buffer_size = 0;
+}
+
+void OnNewField()
+{
+  if (!s_enabled || --s_fields_until_snapshot != 0)
+    return;
+
+  s_fields_until_snapshot = s_interval;
+  if (!NetPlay::IsNetPlayRunning())
+    CoreTiming::RunAtEndOfSlice(TakeSnapshot);
+}
+
+bool Rewind()
+{
+  if (!s_enabled)
+    return false;
+
+  bool success = false;
+  Core::RunOnCPUThread(
+      [&] {
+        std::unique_lock lock(s_mutex);
+        s_idle_cv.wait(lock, [] { return s_pending_snapshots.empty() && !s_compressing; });
+
+        if (s_newest_was_rewound_to && !s_snapshots.empty())
+        {
+          s_buffer_size -= s_snapshots.back().compressed.size();
+          s_snapshots.pop_back();
+        }
+        s_newest_was_rewound_to = false;
+
+        if (s_snapshots.empty() || (s_snapshots.size() < REFRESH_PERIOD && !s_oldest_is_full))
+        {
+          Core::DisplayMessage("No rewind snapshot to go back to", 2000);
+          return;
+        }
+
+        const size_t first = s_snapshots.size() - std::min<size_t>(s_snapshots.size(),
+                                                                   REFRESH_PERIOD);
+        std::vector<u8> buffer;
+        for (size_t i = first; i < s_snapshots.size(); ++i)
+        {
+          const Snapshot& snapshot = s_snapshots[i];
+          buffer.resize(snapshot.size);
+          const size_t result = ZSTD_decompress(buffer.data(), buffer.size(),
+                                                snapshot.compressed.data(),
+                                                snapshot.compressed.size());
+          if (ZSTD_isError(result) || result != buffer.size() ||
+              !State::LoadSnapshot(buffer, i == first))
+          {
+            // The state is now a mix of several snapshots, so going back further can't fix it
+            Core::DisplayMessage("Failed to rewind", 2000);
+            s_snapshots.clear();
+            s_buffer_size = 0;
+            s_oldest_is_full = false;
+            return;
+          }
+        }
+
+        s_newest_was_rewound_to = true;
+        s_fields_until_snapshot = s_interval;
+        success = true;
+      },
+      true);
+
+  return success;
+}
+}  // namespace Rewind
@@ -0,0 +1,21 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+// Keeps the last while of emulation in memory as compressed delta snapshots (see
+// State::SaveSnapshot), so that the user can go back in time. Snapshots are saved on the CPU
+// thread every few fields without pausing, and compressed on a thread of their own.
+namespace Rewind
+{
+void Init();
+void Shutdown();
+
+// Called by VideoInterface on every field boundary. CPU thread only.
+void OnNewField();
+
+// Goes back to the most recent snapshot, or to the one before it if the most recent one was just
+// gone back to. Returns false if there is no snapshot to go back to.
+bool Rewind();
+}  // namespace Rewind
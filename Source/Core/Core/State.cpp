@@ -4,8 +4,12 @@
 
 #include "Core/State.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <lzo/lzo1x.h>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -13,15 +17,19 @@
 #include <vector>
 
 #include <fmt/format.h>
+#include <zstd.h>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
+#include "Common/MappedFile.h"
 #include "Common/MsgHandler.h"
+#include "Common/Random.h"
 #include "Common/ScopeGuard.h"
 #include "Common/Thread.h"
+#include "Common/ThreadPool.h"
 #include "Common/Timer.h"
 #include "Common/Version.h"
 
@@ -29,6 +37,7 @@
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/GeckoCode.h"
+#include "Core/HW/DSP.h"
 #include "Core/HW/HW.h"
 #include "Core/HW/Memmap.h"
 #include "Core/HW/Wiimote.h"
@@ -55,10 +64,21 @@ static const u32 OUT_LEN = IN_LEN + (IN_LEN / 16) + 64 + 3;
 
 static unsigned char __LZO_MMODEL out[OUT_LEN];
 
-#define HEAP_ALLOC(var, size)                                                                      \
-  lzo_align_t __LZO_MMODEL var[((size) + (sizeof(lzo_align_t) - 1)) / sizeof(lzo_align_t)]
+// Compressed states are written as independently compressed zstd chunks, so that they can be
+// compressed and decompressed on all cores. After the StateHeader comes a ZstdStateHeader and the
+// compressed size of each chunk, followed by the chunks themselves. States from older versions
+// instead have LZO chunks directly after the StateHeader, each prefixed by a length which can
+// never be as large as ZSTD_STATE_MAGIC.
+constexpr u32 ZSTD_STATE_MAGIC = 0x5453445A;  // "ZDST"
+constexpr u32 ZSTD_CHUNK_SIZE = 1024 * 1024;
+constexpr int ZSTD_COMPRESSION_LEVEL = 1;
 
-static HEAP_ALLOC(wrkmem, LZO1X_1_MEM_COMPRESS);
+struct ZstdStateHeader
+{
+  u32 magic;
+  u32 chunk_size;
+  u32 chunk_count;
+};
 
 static AfterLoadCallbackFunc s_on_after_load_callback;
 
@@ -74,7 +94,7 @@ static Common::Event g_compressAndDumpStateSyncEvent;
 static std::thread g_save_thread;
 
 // Don't forget to increase this after doing changes on the savestate system
-constexpr u32 STATE_VERSION = 128;  // Last changed in PR 9366
+constexpr u32 STATE_VERSION = 129;  // Last changed for background IOS FS and SD card I/O
 
 // Maps savestate versions to Dolphin versions.
 // Versions after 42 don't need to be added to this list,
@@ -236,20 +256,139 @@ void SaveToBuffer(std::vector<u8>& buffer)
 {
   Core::RunOnCPUThread(
       [&] {
-        u8* ptr = nullptr;
-        PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
-
+        // If the buffer is reused (like the undo buffer is), it's usually large enough already
+        // and a single pass suffices
+        buffer.resize(buffer.capacity());
+        u8* ptr = buffer.data();
+        PointerWrap p(&ptr, PointerWrap::MODE_WRITE);
+        p.SetWriteEnd(ptr + buffer.size());
         DoState(p);
-        const size_t buffer_size = reinterpret_cast<size_t>(ptr);
+
+        const size_t buffer_size = ptr - buffer.data();
+        const bool fit = buffer_size <= buffer.size();
         buffer.resize(buffer_size);
+        if (fit)
+          return;
 
-        ptr = &buffer[0];
+        ptr = buffer.data();
         p.SetMode(PointerWrap::MODE_WRITE);
+        p.SetWriteEnd(ptr + buffer_size);
         DoState(p);
       },
       true);
 }
 
+struct SnapshotHeader
+{
+  u64 id;
+  u64 base_id;  // 0 for full snapshots
+};
+
+static void DoSnapshot(PointerWrap& p, SnapshotHeader& header)
+{
+  p.Do(header);
+  DoState(p);
+}
+
+static void SetDeltaStateEnabled(bool enabled, u32 refresh_period = 0, u32 refresh_slice = 0)
+{
+  Memory::SetDeltaStateEnabled(enabled, refresh_period, refresh_slice);
+  DSP::SetDeltaStateEnabled(enabled, refresh_period, refresh_slice);
+}
+
+// Which snapshot the current state of the emulated memory was saved to or loaded from last, and
+// the time at which it was.
+static u64 s_snapshot_id = 0;
+static u64 s_snapshot_ticks = 0;
+static u32 s_snapshot_refresh_counter = 0;
+
+static void StartNewSnapshot(u64 id)
+{
+  s_snapshot_id = id;
+  s_snapshot_ticks = CoreTiming::GetTicks();
+  Memory::ResetStateDirtyPages();
+  DSP::ResetStateDirtyPages();
+}
+
+void SaveSnapshot(std::vector<u8>& buffer, bool delta, u32 refresh_period,
+                  std::optional<u32> refresh_slice)
+{
+  Core::RunOnCPUThread(
+      [&] {
+        SnapshotHeader header{};
+        header.base_id = delta ? s_snapshot_id : 0;
+        do
+        {
+          header.id = Common::Random::GenerateValue<u64>();
+        } while (header.id == 0);
+
+        // Enabling delta states takes the list of dirty pages, which is then used for both passes.
+        // Tracking for the next snapshot starts right away, so no write in between can be missed.
+        if (!refresh_slice)
+          refresh_slice = refresh_period != 0 ? s_snapshot_refresh_counter++ % refresh_period : 0;
+        SetDeltaStateEnabled(header.base_id != 0, refresh_period, *refresh_slice);
+        StartNewSnapshot(header.id);
+
+        u8* ptr = nullptr;
+        PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+        DoSnapshot(p, header);
+        buffer.resize(reinterpret_cast<size_t>(ptr));
+
+        ptr = buffer.data();
+        p.SetMode(PointerWrap::MODE_WRITE);
+        DoSnapshot(p, header);
+
+        SetDeltaStateEnabled(false);
+      },
+      true);
+}
+
+static bool LoadSnapshotUnchecked(std::vector<u8>& buffer, bool allow_any_base)
+{
+  bool success = false;
+  Core::RunOnCPUThread(
+      [&] {
+        SnapshotHeader header;
+        if (buffer.size() < sizeof(header))
+          return;
+        std::memcpy(&header, buffer.data(), sizeof(header));
+
+        if (header.base_id != 0 && !allow_any_base &&
+            (header.base_id != s_snapshot_id || CoreTiming::GetTicks() != s_snapshot_ticks))
+        {
+          OSD::AddMessage("A delta snapshot can only be loaded right after the one it's based on",
+                          OSD::Duration::NORMAL, OSD::Color::RED);
+          return;
+        }
+
+        SetDeltaStateEnabled(header.base_id != 0);
+        u8* ptr = buffer.data();
+        PointerWrap p(&ptr, PointerWrap::MODE_READ);
+        DoSnapshot(p, header);
+        SetDeltaStateEnabled(false);
+        success = p.GetMode() == PointerWrap::MODE_READ;
+        StartNewSnapshot(success ? header.id : 0);
+      },
+      true);
+  return success;
+}
+
+bool LoadSnapshot(std::vector<u8>& buffer, bool allow_any_base)
+{
+  if (NetPlay::IsNetPlayRunning())
+  {
+    OSD::AddMessage("Loading savestates is disabled in Netplay to prevent desyncs");
+    return false;
+  }
+
+  return LoadSnapshotUnchecked(buffer, allow_any_base);
+}
+
+bool LoadRollbackSnapshot(std::vector<u8>& buffer, bool allow_any_base)
+{
+  return LoadSnapshotUnchecked(buffer, allow_any_base);
+}
+
 // return state number not in map
 static int GetEmptySlot(std::map<double, int> m)
 {
@@ -297,9 +436,229 @@ static std::map<double, int> GetSavedStates()
   return m;
 }
 
+// Calls worker() on as many threads of the shared pool as there are cores (but no more than
+// max_threads), using the calling thread as one of them, and waits for all of them to return
+template <typename F>
+static void RunOnWorkerThreads(size_t max_threads, F worker)
+{
+  Common::ThreadPool& pool = Common::ThreadPool::GetShared();
+  const u32 thread_count = static_cast<u32>(std::min<size_t>(max_threads, pool.GetNumThreads()));
+  pool.ParallelFor(thread_count, [&](u32) { worker(); });
+}
+
+// Compressed chunks waiting to be written to a file
+struct CompressedStateData
+{
+  size_t size = 0;
+  std::vector<std::vector<u8>> chunks;
+};
+
+// Guarded by g_cs_current_buffer
+static CompressedStateData g_current_compressed_data;
+
+// Compresses the savestate made up of the data that was written to buffer and the bulk regions
+// that DoBulkArray referenced. Chunks that lie within a single region are compressed straight from
+// emulated memory, so the regions must not change until this returns.
+static bool CompressStateData(const u8* buffer, size_t buffer_size,
+                              const std::vector<PointerWrap::BulkRegion>& regions,
+                              CompressedStateData* output)
+{
+  struct Span
+  {
+    size_t offset;
+    const u8* data;
+    size_t size;
+  };
+
+  std::vector<Span> spans;
+  size_t size = 0;
+  size_t buffer_position = 0;
+  const auto add_span = [&](const u8* data, size_t span_size) {
+    if (span_size == 0)
+      return;
+    spans.push_back({size, data, span_size});
+    size += span_size;
+  };
+  for (const PointerWrap::BulkRegion& region : regions)
+  {
+    add_span(buffer + buffer_position, region.offset - buffer_position);
+    add_span(region.data, region.size);
+    buffer_position = region.offset;
+  }
+  add_span(buffer + buffer_position, buffer_size - buffer_position);
+
+  const size_t chunk_count = (size + ZSTD_CHUNK_SIZE - 1) / ZSTD_CHUNK_SIZE;
+  output->size = size;
+  output->chunks.clear();
+  output->chunks.resize(chunk_count);
+
+  std::atomic<size_t> next_chunk = 0;
+  std::atomic<bool> success = true;
+  RunOnWorkerThreads(chunk_count, [&] {
+    std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context(ZSTD_createCCtx(),
+                                                                  ZSTD_freeCCtx);
+    if (!context)
+    {
+      success = false;
+      return;
+    }
+
+    std::vector<u8> gathered;
+    std::vector<u8> compressed(ZSTD_compressBound(ZSTD_CHUNK_SIZE));
+    for (size_t i = next_chunk++; i < chunk_count && success; i = next_chunk++)
+    {
+      const size_t offset = i * ZSTD_CHUNK_SIZE;
+      const size_t length = std::min<size_t>(ZSTD_CHUNK_SIZE, size - offset);
+
+      auto span = std::upper_bound(
+          spans.begin(), spans.end(), offset,
+          [](size_t value, const Span& other) { return value < other.offset; });
+      --span;
+
+      const u8* data = span->data + (offset - span->offset);
+      if (offset + length > span->offset + span->size)
+      {
+        // The chunk crosses into the next span, so it has to be put together first
+        gathered.resize(length);
+        for (size_t copied = 0; copied < length; ++span)
+        {
+          const size_t span_offset = offset + copied - span->offset;
+          const size_t copy_size = std::min(length - copied, span->size - span_offset);
+          std::memcpy(gathered.data() + copied, span->data + span_offset, copy_size);
+          copied += copy_size;
+        }
+        data = gathered.data();
+      }
+
+      const size_t result = ZSTD_compressCCtx(context.get(), compressed.data(), compressed.size(),
+                                              data, length, ZSTD_COMPRESSION_LEVEL);
+      if (ZSTD_isError(result))
+        success = false;
+      else
+        output->chunks[i].assign(compressed.begin(), compressed.begin() + result);
+    }
+  });
+
+  return success;
+}
+
+static bool WriteCompressedStateData(File::IOFile& f, const CompressedStateData& data)
+{
+  const size_t chunk_count = data.chunks.size();
+  std::vector<u32> chunk_sizes(chunk_count);
+  for (size_t i = 0; i < chunk_count; ++i)
+    chunk_sizes[i] = static_cast<u32>(data.chunks[i].size());
+
+  const ZstdStateHeader zstd_header{ZSTD_STATE_MAGIC, ZSTD_CHUNK_SIZE,
+                                    static_cast<u32>(chunk_count)};
+  if (!f.WriteArray(&zstd_header, 1) || !f.WriteArray(chunk_sizes.data(), chunk_count))
+    return false;
+
+  for (const std::vector<u8>& chunk : data.chunks)
+  {
+    if (!f.WriteBytes(chunk.data(), chunk.size()))
+      return false;
+  }
+
+  return true;
+}
+
+static bool ReadAndDecompressStateData(File::IOFile& f, u8* data, size_t size)
+{
+  ZstdStateHeader zstd_header;
+  if (!f.ReadArray(&zstd_header, 1) || zstd_header.magic != ZSTD_STATE_MAGIC ||
+      zstd_header.chunk_size == 0)
+  {
+    return false;
+  }
+
+  const size_t chunk_size = zstd_header.chunk_size;
+  const size_t chunk_count = zstd_header.chunk_count;
+  if (chunk_count != (size + chunk_size - 1) / chunk_size)
+    return false;
+
+  std::vector<u32> chunk_sizes(chunk_count);
+  if (!f.ReadArray(chunk_sizes.data(), chunk_count))
+    return false;
+
+  // The chunk sizes double as an index, so the compressed data can be read in a single go and
+  // each chunk can then be found without looking at the ones before it
+  std::vector<size_t> chunk_offsets(chunk_count + 1);
+  for (size_t i = 0; i < chunk_count; ++i)
+    chunk_offsets[i + 1] = chunk_offsets[i] + chunk_sizes[i];
+
+  std::vector<u8> compressed(chunk_offsets.back());
+  if (!f.ReadBytes(compressed.data(), compressed.size()))
+    return false;
+
+  std::atomic<size_t> next_chunk = 0;
+  std::atomic<bool> success = true;
+  RunOnWorkerThreads(chunk_count, [&] {
+    std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context(ZSTD_createDCtx(),
+                                                                  ZSTD_freeDCtx);
+    if (!context)
+    {
+      success = false;
+      return;
+    }
+
+    for (size_t i = next_chunk++; i < chunk_count && success; i = next_chunk++)
+    {
+      const size_t offset = i * chunk_size;
+      const size_t length = std::min<size_t>(chunk_size, size - offset);
+
+      const size_t result =
+          ZSTD_decompressDCtx(context.get(), data + offset, length,
+                              compressed.data() + chunk_offsets[i], chunk_sizes[i]);
+      if (ZSTD_isError(result) || result != length)
+        success = false;
+    }
+  });
+
+  return success;
+}
+
+// Saves the state to g_current_buffer, and if compress is true also compresses it to
+// g_current_compressed_data. Must be called on the CPU thread with g_cs_current_buffer locked.
+static bool SaveToCurrentBuffer(bool compress)
+{
+  std::vector<PointerWrap::BulkRegion> bulk_regions;
+
+  // The buffer left over from the last save is usually large enough already, in which case a
+  // single pass suffices. Otherwise the first pass tells us how large it has to be.
+  g_current_buffer.resize(g_current_buffer.capacity());
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    bulk_regions.clear();
+    u8* ptr = g_current_buffer.data();
+    PointerWrap p(&ptr, PointerWrap::MODE_WRITE);
+    p.SetWriteEnd(ptr + g_current_buffer.size());
+    if (compress)
+      p.SetBulkRegions(&bulk_regions);
+    DoState(p);
+
+    const size_t size = ptr - g_current_buffer.data();
+    if (p.GetMode() == PointerWrap::MODE_WRITE)
+    {
+      g_current_buffer.resize(size);
+      return !compress || CompressStateData(g_current_buffer.data(), size, bulk_regions,
+                                            &g_current_compressed_data);
+    }
+
+    // If the state did fit, someone aborted the save by changing the mode
+    if (size <= g_current_buffer.size())
+      return false;
+
+    g_current_buffer.resize(size);
+  }
+
+  return false;
+}
+
 struct CompressAndDumpState_args
 {
   std::vector<u8>* buffer_vector;
+  CompressedStateData* compressed_data;  // nullptr if the state isn't compressed
   std::mutex* buffer_mutex;
   std::string filename;
   bool wait;
@@ -322,8 +681,9 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
   if (!save_args.wait)
     on_exit.Exit();
 
-  const u8* const buffer_data = &(*(save_args.buffer_vector))[0];
-  const size_t buffer_size = (save_args.buffer_vector)->size();
+  const u8* const buffer_data = save_args.buffer_vector->data();
+  const size_t buffer_size = save_args.buffer_vector->size();
+  CompressedStateData* const compressed_data = save_args.compressed_data;
   std::string& filename = save_args.filename;
 
   // For easy debugging
@@ -358,39 +718,19 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
   // Setting up the header
   StateHeader header{};
   SConfig::GetInstance().GetGameID().copy(header.gameID, std::size(header.gameID));
-  header.size = s_use_compression ? (u32)buffer_size : 0;
+  header.size = compressed_data ? (u32)compressed_data->size : 0;
   header.time = Common::Timer::GetDoubleTime();
 
   f.WriteArray(&header, 1);
 
   if (header.size != 0)  // non-zero header size means the state is compressed
   {
-    lzo_uint i = 0;
-    while (true)
+    const bool success = WriteCompressedStateData(f, *compressed_data);
+    std::vector<std::vector<u8>>().swap(compressed_data->chunks);
+    if (!success)
     {
-      lzo_uint32 cur_len = 0;
-      lzo_uint out_len = 0;
-
-      if ((i + IN_LEN) >= buffer_size)
-      {
-        cur_len = (lzo_uint32)(buffer_size - i);
-      }
-      else
-      {
-        cur_len = IN_LEN;
-      }
-
-      if (lzo1x_1_compress(buffer_data + i, cur_len, out, &out_len, wrkmem) != LZO_E_OK)
-        PanicAlertFmtT("Internal LZO Error - compression failed");
-
-      // The size of the data to write is 'out_len'
-      f.WriteArray((lzo_uint32*)&out_len, 1);
-      f.WriteBytes(out, out_len);
-
-      if (cur_len != IN_LEN)
-        break;
-
-      i += cur_len;
+      Core::DisplayMessage("Could not save state", 2000);
+      return;
     }
   }
   else  // uncompressed
@@ -411,27 +751,20 @@ void SaveAs(const std::string& filename, bool wait)
 
   Core::RunOnCPUThread(
       [&] {
-        // Measure the size of the buffer.
-        u8* ptr = nullptr;
-        PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
-        DoState(p);
-        const size_t buffer_size = reinterpret_cast<size_t>(ptr);
-
-        // Then actually do the write.
+        const bool compress = s_use_compression;
+        bool success;
         {
           std::lock_guard lk(g_cs_current_buffer);
-          g_current_buffer.resize(buffer_size);
-          ptr = &g_current_buffer[0];
-          p.SetMode(PointerWrap::MODE_WRITE);
-          DoState(p);
+          success = SaveToCurrentBuffer(compress);
         }
 
-        if (p.GetMode() == PointerWrap::MODE_WRITE)
+        if (success)
         {
           Core::DisplayMessage("Saving State...", 1000);
 
           CompressAndDumpState_args save_args;
           save_args.buffer_vector = &g_current_buffer;
+          save_args.compressed_data = compress ? &g_current_compressed_data : nullptr;
           save_args.buffer_mutex = &g_cs_current_buffer;
           save_args.filename = filename;
           save_args.wait = wait;
@@ -482,7 +815,10 @@ u64 GetUnixTimeOfSlot(int slot)
          (Common::Timer::DOUBLE_TIME_OFFSET * MS_PER_SEC);
 }
 
-static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_data)
+// Uncompressed states are mapped into mapped_file instead of being read into ret_data, so that
+// their data is only copied once, straight from the OS's file cache to where it's restored to.
+static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_data,
+                              File::MappedFile* mapped_file)
 {
   Flush();
   File::IOFile f(filename, "rb");
@@ -510,6 +846,22 @@ static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_
 
     buffer.resize(header.size);
 
+    u32 magic = 0;
+    if (f.ReadArray(&magic, 1) && magic == ZSTD_STATE_MAGIC)
+    {
+      f.Seek(sizeof(StateHeader), SEEK_SET);
+      if (!ReadAndDecompressStateData(f, buffer.data(), buffer.size()))
+      {
+        PanicAlertFmtT("Failed to decompress the state. It may be corrupted.");
+        return;
+      }
+
+      ret_data.swap(buffer);
+      return;
+    }
+
+    // Older states are made of LZO chunks
+    f.Seek(sizeof(StateHeader), SEEK_SET);
     lzo_uint i = 0;
     while (true)
     {
@@ -535,6 +887,13 @@ static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_
   }
   else  // uncompressed
   {
+    if (mapped_file->Open(filename))
+    {
+      if (mapped_file->GetSize() > sizeof(StateHeader))
+        return;
+      mapped_file->Close();
+    }
+
     const auto size = static_cast<size_t>(f.GetSize() - sizeof(StateHeader));
     buffer.resize(size);
 
@@ -582,11 +941,15 @@ void LoadAs(const std::string& filename)
         // brackets here are so buffer gets freed ASAP
         {
           std::vector<u8> buffer;
-          LoadFileStateData(filename, buffer);
+          File::MappedFile mapped_file;
+          LoadFileStateData(filename, buffer, &mapped_file);
 
-          if (!buffer.empty())
+          if (mapped_file.IsOpen() || !buffer.empty())
           {
-            u8* ptr = &buffer[0];
+            // PointerWrap doesn't write to the data in MODE_READ
+            u8* ptr = mapped_file.IsOpen() ?
+                          const_cast<u8*>(mapped_file.GetData()) + sizeof(StateHeader) :
+                          buffer.data();
             PointerWrap p(&ptr, PointerWrap::MODE_READ);
             DoState(p);
             loaded = true;
@@ -629,6 +992,8 @@ void SetOnAfterLoadCallback(AfterLoadCallbackFunc callback)
 
 void Init()
 {
+  s_snapshot_id = 0;
+
   if (lzo_init() != LZO_E_OK)
     PanicAlertFmtT("Internal LZO Error - lzo_init() failed");
 }
@@ -643,6 +1008,7 @@ void Shutdown()
   {
     std::lock_guard lk(g_cs_current_buffer);
     std::vector<u8>().swap(g_current_buffer);
+    g_current_compressed_data = {};
   }
 
   {
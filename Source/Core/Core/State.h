@@ -7,6 +7,7 @@
 #pragma once
 
 #include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -53,6 +54,24 @@ void LoadAs(const std::string& filename);
 void SaveToBuffer(std::vector<u8>& buffer);
 void LoadFromBuffer(std::vector<u8>& buffer);
 
+// Snapshots are for tools that save states frequently, e.g. for automated regression testing and
+// bisecting. A delta snapshot only contains the pages of memory and ARAM which were written since
+// the previous snapshot, so it can only be loaded right after that one was saved or loaded, before
+// emulation continues: load the last full snapshot and then each delta snapshot after it in order.
+// Without the DeltaSaveStates setting, all pages of memory count as written. If there is no
+// previous snapshot to base a delta snapshot on, a full one is saved instead.
+// With a refresh period, delta snapshots also contain every refresh_period-th page in turn, so
+// that any refresh_period consecutive ones contain all pages between them. Such a run can be
+// loaded without the snapshots before it by passing allow_any_base when loading its first one.
+// The pages are included in turn unless the caller picks them with refresh_slice, which it has to
+// do if it goes back to older snapshots and saves new ones after them.
+void SaveSnapshot(std::vector<u8>& buffer, bool delta, u32 refresh_period = 0,
+                  std::optional<u32> refresh_slice = std::nullopt);
+bool LoadSnapshot(std::vector<u8>& buffer, bool allow_any_base = false);
+// Like LoadSnapshot, but also during NetPlay. Only for its rollback mode, where every player goes
+// back to the same inputs, so that the emulation stays in sync.
+bool LoadRollbackSnapshot(std::vector<u8>& buffer, bool allow_any_base);
+
 void LoadLastSaved(int i = 1);
 void SaveFirstSaved();
 void UndoSaveState();
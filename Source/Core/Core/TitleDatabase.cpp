@@ -4,13 +4,14 @@
 
 #include "Core/TitleDatabase.h"
 
+#include <algorithm>
 #include <cstddef>
-#include <fstream>
 #include <functional>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <fmt/format.h>
 
@@ -25,33 +26,53 @@ namespace Core
 {
 static const std::string EMPTY_STRING;
 
-using Map = std::unordered_map<std::string, std::string>;
+using Map = std::vector<std::pair<std::string, std::string>>;
 
 static Map LoadMap(const std::string& file_path)
 {
   Map map;
 
-  std::ifstream txt;
-  File::OpenFStream(txt, file_path, std::ios::in);
+  // Reading the whole file at once is much faster than reading it line by line
+  std::string contents;
+  if (!File::ReadFileToString(file_path, contents))
+    return map;
 
-  std::string line;
-  while (std::getline(txt, line))
+  std::string_view remaining(contents);
+  while (!remaining.empty())
   {
-    if (line.empty())
-      continue;
+    const size_t line_end = std::min(remaining.find('\n'), remaining.size());
+    const std::string_view line = remaining.substr(0, line_end);
+    remaining.remove_prefix(std::min(line_end + 1, remaining.size()));
 
     const size_t equals_index = line.find('=');
     if (equals_index != std::string::npos)
     {
-      const std::string_view line_view(line);
-      const std::string_view game_id = StripSpaces(line_view.substr(0, equals_index));
+      const std::string_view game_id = StripSpaces(line.substr(0, equals_index));
       if (game_id.length() >= 4)
-        map.emplace(game_id, StripSpaces(line_view.substr(equals_index + 1)));
+        map.emplace_back(game_id, StripSpaces(line.substr(equals_index + 1)));
     }
   }
+
+  // If an ID is listed more than once, the first entry wins
+  std::stable_sort(map.begin(), map.end(),
+                   [](const auto& a, const auto& b) { return a.first < b.first; });
+  map.erase(std::unique(map.begin(), map.end(),
+                        [](const auto& a, const auto& b) { return a.first == b.first; }),
+            map.end());
+  map.shrink_to_fit();
   return map;
 }
 
+static const std::string* FindTitle(const Map& map, const std::string& gametdb_id)
+{
+  const auto it = std::lower_bound(
+      map.begin(), map.end(), gametdb_id,
+      [](const auto& entry, const std::string& id) { return entry.first < id; });
+  if (it == map.end() || it->first != gametdb_id)
+    return nullptr;
+  return &it->second;
+}
+
 void TitleDatabase::AddLazyMap(DiscIO::Language language, const std::string& language_code)
 {
   m_title_maps[language] = [language_code]() -> Map {
@@ -94,27 +115,23 @@ TitleDatabase::~TitleDatabase() = default;
 const std::string& TitleDatabase::GetTitleName(const std::string& gametdb_id,
                                                DiscIO::Language language) const
 {
-  auto it = m_user_title_map.find(gametdb_id);
-  if (it != m_user_title_map.end())
-    return it->second;
+  if (const std::string* title = FindTitle(m_user_title_map, gametdb_id))
+    return *title;
 
   if (!SConfig::GetInstance().m_use_builtin_title_database)
     return EMPTY_STRING;
 
-  const Map& map = *m_title_maps.at(language);
-  it = map.find(gametdb_id);
-  if (it != map.end())
-    return it->second;
+  if (const std::string* title = FindTitle(*m_title_maps.at(language), gametdb_id))
+    return *title;
 
   if (language != DiscIO::Language::English)
   {
     const Map& english_map = *m_title_maps.at(DiscIO::Language::English);
-    it = english_map.find(gametdb_id);
-    if (it != english_map.end())
-      return it->second;
+    if (const std::string* title = FindTitle(english_map, gametdb_id))
+      return *title;
   }
 
-  it = m_base_map.find(gametdb_id);
+  const auto it = m_base_map.find(gametdb_id);
   if (it != m_base_map.end())
     return it->second;
 
@@ -6,6 +6,8 @@
 
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/Lazy.h"
@@ -35,11 +37,14 @@ public:
   std::string Describe(const std::string& gametdb_id, DiscIO::Language language) const;
 
 private:
+  // Pairs of GameTDB IDs and names, sorted by ID. The database files have thousands of entries,
+  // which take a lot less memory this way than as a hash map.
+  using TitleMap = std::vector<std::pair<std::string, std::string>>;
+
   void AddLazyMap(DiscIO::Language language, const std::string& language_code);
 
-  std::unordered_map<DiscIO::Language, Common::Lazy<std::unordered_map<std::string, std::string>>>
-      m_title_maps;
+  std::unordered_map<DiscIO::Language, Common::Lazy<TitleMap>> m_title_maps;
   std::unordered_map<std::string, std::string> m_base_map;
-  std::unordered_map<std::string, std::string> m_user_title_map;
+  TitleMap m_user_title_map;
 };
 }  // namespace Core
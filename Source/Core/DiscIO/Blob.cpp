@@ -12,6 +12,7 @@
 #include "Common/CDUtils.h"
 #include "Common/CommonTypes.h"
 #include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 
 #include "DiscIO/Blob.h"
@@ -20,6 +21,7 @@
 #include "DiscIO/DirectoryBlob.h"
 #include "DiscIO/DriveBlob.h"
 #include "DiscIO/FileBlob.h"
+#include "DiscIO/HttpBlob.h"
 #include "DiscIO/TGCBlob.h"
 #include "DiscIO/WIABlob.h"
 #include "DiscIO/WbfsBlob.h"
@@ -213,6 +215,30 @@ std::unique_ptr<BlobReader> CreateBlobReader(const std::string& filename)
   if (Common::IsCDROMDevice(filename))
     return DriveReader::Create(filename);
 
+  if (HttpBlobReader::IsURL(filename))
+  {
+    std::unique_ptr<HttpBlobReader> reader = HttpBlobReader::Create(filename);
+    u32 magic;
+    if (!reader || !reader->Read(0, sizeof(magic), reinterpret_cast<u8*>(&magic)))
+      return nullptr;
+
+    // The other blob readers work on a File::IOFile, so only plain disc images can be streamed
+    switch (magic)
+    {
+    case CISO_MAGIC:
+    case GCZ_MAGIC:
+    case TGC_MAGIC:
+    case WBFS_MAGIC:
+    case WIA_MAGIC:
+    case RVZ_MAGIC:
+      ERROR_LOG_FMT(DISCIO, "{} isn't a plain disc image, which is required for reading over HTTP",
+                    filename);
+      return nullptr;
+    default:
+      return reader;
+    }
+  }
+
   File::IOFile file(filename, "rb");
   u32 magic;
   if (!file.ReadArray(&magic, 1))
@@ -10,6 +10,7 @@
 #include <locale>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <utility>
@@ -23,11 +24,13 @@
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
 #include "Common/Logging/Log.h"
+#include "Common/MappedFile.h"
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
 #include "Core/Boot/DolReader.h"
 #include "Core/IOS/ES/Formats.h"
 #include "DiscIO/Blob.h"
+#include "DiscIO/DirectoryScanCache.h"
 #include "DiscIO/VolumeWii.h"
 #include "DiscIO/WiiEncryptionCache.h"
 
@@ -61,8 +64,32 @@ constexpr u8 ENTRY_SIZE = 0x0c;
 constexpr u8 FILE_ENTRY = 0;
 constexpr u8 DIRECTORY_ENTRY = 1;
 
+struct DiscContent::ContentFile
+{
+  explicit ContentFile(const std::string& path_) : path(path_) {}
+
+  bool Read(u64 offset, u64 length, u8* buffer)
+  {
+    std::call_once(open_flag, [this] { mapping.Open(path); });
+
+    if (mapping.IsOpen() && offset + length <= mapping.GetSize())
+    {
+      std::copy_n(mapping.GetData() + offset, length, buffer);
+      return true;
+    }
+
+    // Mapping fails for things like Android content URIs, and the file may have shrunk since
+    File::IOFile file(path, "rb");
+    return file.Seek(offset, SEEK_SET) && file.ReadBytes(buffer, length);
+  }
+
+  std::string path;
+  std::once_flag open_flag;
+  File::MappedFile mapping;
+};
+
 DiscContent::DiscContent(u64 offset, u64 size, const std::string& path)
-    : m_offset(offset), m_size(size), m_content_source(path)
+    : m_offset(offset), m_size(size), m_content_source(std::make_shared<ContentFile>(path))
 {
 }
 
@@ -107,10 +134,10 @@ bool DiscContent::Read(u64* offset, u64* length, u8** buffer) const
   {
     const u64 bytes_to_read = std::min(m_size - offset_in_content, *length);
 
-    if (std::holds_alternative<std::string>(m_content_source))
+    if (std::holds_alternative<std::shared_ptr<ContentFile>>(m_content_source))
     {
-      File::IOFile file(std::get<std::string>(m_content_source), "rb");
-      if (!file.Seek(offset_in_content, SEEK_SET) || !file.ReadBytes(*buffer, bytes_to_read))
+      ContentFile* file = std::get<std::shared_ptr<ContentFile>>(m_content_source).get();
+      if (!file->Read(offset_in_content, bytes_to_read, *buffer))
         return false;
     }
     else if (std::holds_alternative<const u8*>(m_content_source))
@@ -354,7 +381,9 @@ std::unique_ptr<DirectoryBlobReader> DirectoryBlobReader::Create(const std::stri
 
 DirectoryBlobReader::DirectoryBlobReader(const std::string& game_partition_root,
                                          const std::string& true_root)
-    : m_encryption_cache(this)
+    // Partition data is read straight from the files on each read, so it can be read from
+    // another thread while the emulated disc is being read
+    : m_encryption_cache(this, WiiEncryptionCache::DEFAULT_MAX_GROUPS, true)
 {
   DirectoryBlobPartition game_partition(game_partition_root, {});
   m_is_wii = game_partition.IsWii();
@@ -729,7 +758,7 @@ void DirectoryBlobPartition::BuildFST(u64 fst_address)
 {
   m_fst_data.clear();
 
-  File::FSTEntry rootEntry = File::ScanDirectoryTree(m_root_directory + "files/", true);
+  File::FSTEntry rootEntry = ScanDirectoryTreeCached(m_root_directory + "files/");
 
   ConvertUTF8NamesToSHIFTJIS(&rootEntry);
 
@@ -793,19 +822,23 @@ void DirectoryBlobPartition::WriteDirectory(const File::FSTEntry& parent_entry,
                                             u32* name_offset, u64* data_offset,
                                             u32 parent_entry_index, u64 name_table_offset)
 {
-  std::vector<File::FSTEntry> sorted_entries = parent_entry.children;
+  // Sort for determinism. Sorting pointers avoids copying the whole subtree at every level.
+  std::vector<const File::FSTEntry*> sorted_entries;
+  sorted_entries.reserve(parent_entry.children.size());
+  for (const File::FSTEntry& entry : parent_entry.children)
+    sorted_entries.push_back(&entry);
 
-  // Sort for determinism
   std::sort(sorted_entries.begin(), sorted_entries.end(),
-            [](const File::FSTEntry& one, const File::FSTEntry& two) {
-              const std::string one_upper = ASCIIToUppercase(one.virtualName);
-              const std::string two_upper = ASCIIToUppercase(two.virtualName);
-              return one_upper == two_upper ? one.virtualName < two.virtualName :
+            [](const File::FSTEntry* one, const File::FSTEntry* two) {
+              const std::string one_upper = ASCIIToUppercase(one->virtualName);
+              const std::string two_upper = ASCIIToUppercase(two->virtualName);
+              return one_upper == two_upper ? one->virtualName < two->virtualName :
                                               one_upper < two_upper;
             });
 
-  for (const File::FSTEntry& entry : sorted_entries)
+  for (const File::FSTEntry* entry_ptr : sorted_entries)
   {
+    const File::FSTEntry& entry = *entry_ptr;
     if (entry.isDirectory)
     {
       u32 entry_index = *fst_offset / ENTRY_SIZE;
@@ -37,9 +37,12 @@ bool ShouldHideFromGameList(const std::string& volume_path);
 class DiscContent
 {
 public:
+  // Opened the first time it's read from, so that files which are never read cost nothing
+  struct ContentFile;
+
   using ContentSource =
-      std::variant<std::string,          // File
-                   const u8*,            // Memory
+      std::variant<std::shared_ptr<ContentFile>,  // File
+                   const u8*,                     // Memory
                    DirectoryBlobReader*  // Partition (which one it is is determined by m_offset)
                    >;
 
@@ -0,0 +1,247 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "DiscIO/DirectoryScanCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Hash.h"
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+
+namespace DiscIO
+{
+namespace
+{
+constexpr u32 CACHE_REVISION = 1;
+
+// Stats are mostly waiting on the filesystem, so this doesn't need to match the core count
+constexpr size_t STAT_THREAD_COUNT = 8;
+
+struct CachedEntry
+{
+  std::string name;
+  bool is_directory = false;
+  u64 size = 0;  // Only used for files
+  s64 modification_time = 0;
+  std::vector<CachedEntry> children;
+
+  void DoState(PointerWrap& p)
+  {
+    p.Do(name);
+    p.Do(is_directory);
+    p.Do(size);
+    p.Do(modification_time);
+    p.DoEachElement(children, [](PointerWrap& state, CachedEntry& elem) { elem.DoState(state); });
+  }
+};
+
+using FlatEntries = std::vector<std::pair<std::string, CachedEntry*>>;
+
+void Flatten(const std::string& path, CachedEntry* entry, FlatEntries* out)
+{
+  out->emplace_back(path, entry);
+  for (CachedEntry& child : entry->children)
+    Flatten(path + DIR_SEP + child.name, &child, out);
+}
+
+// Calls function(entries[i]) for every i, spread over several threads
+template <typename F>
+void ForEachInParallel(const FlatEntries& entries, F function)
+{
+  const size_t thread_count = std::min(STAT_THREAD_COUNT, entries.size());
+  const auto worker = [&](size_t thread) {
+    for (size_t i = thread; i < entries.size(); i += thread_count)
+      function(entries[i]);
+  };
+
+  std::vector<std::future<void>> futures;
+  for (size_t thread = 1; thread < thread_count; ++thread)
+    futures.emplace_back(std::async(std::launch::async, worker, thread));
+  if (thread_count > 0)
+    worker(0);
+  for (std::future<void>& future : futures)
+    future.wait();
+}
+
+CachedEntry FromFSTEntry(const File::FSTEntry& fst_entry)
+{
+  CachedEntry entry;
+  entry.name = fst_entry.virtualName;
+  entry.is_directory = fst_entry.isDirectory;
+  if (fst_entry.isDirectory)
+  {
+    entry.children.reserve(fst_entry.children.size());
+    for (const File::FSTEntry& child : fst_entry.children)
+      entry.children.push_back(FromFSTEntry(child));
+  }
+  else
+  {
+    entry.size = fst_entry.size;
+  }
+  return entry;
+}
+
+File::FSTEntry ToFSTEntry(const CachedEntry& entry, const std::string& path)
+{
+  File::FSTEntry fst_entry;
+  fst_entry.isDirectory = entry.is_directory;
+  fst_entry.physicalName = path;
+  fst_entry.virtualName = entry.name;
+  fst_entry.size = entry.size;
+  if (entry.is_directory)
+  {
+    // For directories, the size is the recursive count of children
+    fst_entry.size = 0;
+    fst_entry.children.reserve(entry.children.size());
+    for (const CachedEntry& child : entry.children)
+    {
+      fst_entry.children.push_back(ToFSTEntry(child, path + DIR_SEP + child.name));
+      fst_entry.size += 1 + (child.is_directory ? fst_entry.children.back().size : 0);
+    }
+  }
+  return fst_entry;
+}
+
+bool IsStillValid(const FlatEntries& entries)
+{
+  std::atomic<bool> valid = true;
+  ForEachInParallel(entries, [&valid](const std::pair<std::string, CachedEntry*>& entry) {
+    if (!valid)
+      return;
+
+    const File::FileInfo info(entry.first);
+    if (!info.Exists() || info.IsDirectory() != entry.second->is_directory ||
+        info.GetModificationTime() != entry.second->modification_time ||
+        info.GetSize() != entry.second->size)
+    {
+      valid = false;
+    }
+  });
+  return valid;
+}
+
+std::string GetCachePath(const std::string& directory)
+{
+  const std::string& cache_directory = File::GetUserPath(D_CACHE_IDX);
+  if (cache_directory.empty())
+    return {};
+
+  const u32 hash =
+      Common::ComputeCRC32(0, reinterpret_cast<const u8*>(directory.data()), directory.size());
+  return fmt::format("{}DirectoryBlob" DIR_SEP "{:08x}.cache", cache_directory, hash);
+}
+
+void DoCacheState(PointerWrap& p, std::string* directory, CachedEntry* root, u64 size = 0)
+{
+  struct
+  {
+    u32 revision;
+    u64 expected_size;
+  } header = {CACHE_REVISION, size};
+  p.Do(header);
+  if (p.GetMode() == PointerWrap::MODE_READ)
+  {
+    if (header.revision != CACHE_REVISION || header.expected_size != size)
+    {
+      p.SetMode(PointerWrap::MODE_MEASURE);
+      return;
+    }
+  }
+
+  std::string cached_directory = *directory;
+  p.Do(cached_directory);
+  if (p.GetMode() == PointerWrap::MODE_READ && cached_directory != *directory)
+  {
+    p.SetMode(PointerWrap::MODE_MEASURE);
+    return;
+  }
+
+  root->DoState(p);
+}
+
+bool LoadCache(const std::string& cache_path, std::string directory, CachedEntry* root)
+{
+  File::IOFile file(cache_path, "rb");
+  std::vector<u8> buffer(file.GetSize());
+  if (buffer.empty() || !file.ReadBytes(buffer.data(), buffer.size()))
+    return false;
+
+  u8* ptr = buffer.data();
+  PointerWrap p(&ptr, PointerWrap::MODE_READ);
+  DoCacheState(p, &directory, root, buffer.size());
+  return p.GetMode() == PointerWrap::MODE_READ && ptr == buffer.data() + buffer.size();
+}
+
+void SaveCache(const std::string& cache_path, std::string directory, CachedEntry* root)
+{
+  // Measure the size of the buffer, then actually do the write
+  u8* ptr = nullptr;
+  PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+  DoCacheState(p, &directory, root);
+  std::vector<u8> buffer(reinterpret_cast<size_t>(ptr));
+
+  ptr = buffer.data();
+  p.SetMode(PointerWrap::MODE_WRITE);
+  DoCacheState(p, &directory, root, buffer.size());
+
+  if (!File::CreateFullPath(cache_path))
+    return;
+
+  File::IOFile file(cache_path, "wb");
+  if (!file.WriteBytes(buffer.data(), buffer.size()))
+  {
+    file.Close();
+    File::Delete(cache_path);
+  }
+}
+}  // namespace
+
+File::FSTEntry ScanDirectoryTreeCached(const std::string& directory)
+{
+  const std::string cache_path = GetCachePath(directory);
+  const s64 directory_time = File::FileInfo(directory).GetModificationTime();
+
+  // Without modification times (e.g. for Android content URIs), a cache can't be validated
+  if (cache_path.empty() || directory_time == 0)
+    return File::ScanDirectoryTree(directory, true);
+
+  CachedEntry root;
+  FlatEntries entries;
+  if (LoadCache(cache_path, directory, &root))
+  {
+    Flatten(directory, &root, &entries);
+    if (IsStillValid(entries))
+    {
+      INFO_LOG_FMT(DISCIO, "Using cached scan of {}", directory);
+      File::FSTEntry fst_entry = ToFSTEntry(root, directory);
+      fst_entry.virtualName.clear();
+      return fst_entry;
+    }
+  }
+
+  File::FSTEntry fst_entry = File::ScanDirectoryTree(directory, true);
+
+  root = FromFSTEntry(fst_entry);
+  entries.clear();
+  Flatten(directory, &root, &entries);
+  ForEachInParallel(entries, [](const std::pair<std::string, CachedEntry*>& entry) {
+    entry.second->modification_time = File::FileInfo(entry.first).GetModificationTime();
+  });
+  SaveCache(cache_path, directory, &root);
+
+  return fst_entry;
+}
+}  // namespace DiscIO
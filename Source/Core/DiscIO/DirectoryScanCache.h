@@ -0,0 +1,22 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+namespace File
+{
+struct FSTEntry;
+}
+
+namespace DiscIO
+{
+// Like File::ScanDirectoryTree(directory, true), but remembers the result in the cache directory.
+// On later calls, the cached tree is used if the modification times of all directories and the
+// sizes and modification times of all files still match. Checking that takes one stat per entry
+// like a fresh scan does, but the stats are independent of each other and can be done in
+// parallel, which matters a lot on network filesystems.
+File::FSTEntry ScanDirectoryTreeCached(const std::string& directory);
+}  // namespace DiscIO
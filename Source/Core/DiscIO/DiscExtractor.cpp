@@ -5,20 +5,31 @@
 #include "DiscIO/DiscExtractor.h"
 
 #include <algorithm>
+#include <array>
+#include <deque>
+#include <future>
 #include <locale>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include <fmt/format.h>
 
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
+#include "Common/ThreadPool.h"
 #include "DiscIO/Enums.h"
 #include "DiscIO/Filesystem.h"
 #include "DiscIO/Volume.h"
 
 namespace DiscIO
 {
+// Data is read and written in chunks of this size.
+constexpr u64 EXPORT_CHUNK_SIZE = 0x02000000;  // 32 MiB
+// How much data read for files smaller than a chunk may be waiting to be written at once.
+constexpr u64 MAX_PENDING_WRITE_SIZE = 0x08000000;  // 128 MiB
+
 std::string NameForPartitionType(u32 partition_type, bool include_prefix)
 {
   switch (partition_type)
@@ -85,24 +96,39 @@ bool ExportData(const Volume& volume, const Partition& partition, u64 offset, u6
   if (!f)
     return false;
 
-  while (size)
+  // Each chunk is written on another thread while the next one is being read.
+  std::array<std::vector<u8>, 2> buffers;
+  std::future<bool> write;
+  bool success = true;
+  for (size_t i = 0; size; i ^= 1)
   {
-    // Limit read size to 128 MB
-    const size_t read_size = static_cast<size_t>(std::min<u64>(size, 0x08000000));
-
-    std::vector<u8> buffer(read_size);
+    const size_t read_size = static_cast<size_t>(std::min<u64>(size, EXPORT_CHUNK_SIZE));
 
+    std::vector<u8>& buffer = buffers[i];
+    buffer.resize(read_size);
     if (!volume.Read(offset, read_size, buffer.data(), partition))
-      return false;
+    {
+      success = false;
+      break;
+    }
 
-    if (!f.WriteBytes(buffer.data(), read_size))
-      return false;
+    if (write.valid() && !write.get())
+    {
+      success = false;
+      break;
+    }
+    write = Common::ThreadPool::GetShared().Async(
+        Common::TaskPriority::Background,
+        [&f, &buffer, read_size] { return f.WriteBytes(buffer.data(), read_size); });
 
     size -= read_size;
     offset += read_size;
   }
 
-  return true;
+  if (write.valid() && !write.get())
+    success = false;
+
+  return success;
 }
 
 bool ExportFile(const Volume& volume, const Partition& partition, const FileInfo* file_info,
@@ -125,10 +151,21 @@ bool ExportFile(const Volume& volume, const Partition& partition, std::string_vi
   return ExportFile(volume, partition, file_system->FindFileInfo(path).get(), export_filename);
 }
 
-void ExportDirectory(const Volume& volume, const Partition& partition, const FileInfo& directory,
-                     bool recursive, const std::string& filesystem_path,
-                     const std::string& export_folder,
-                     const std::function<bool(const std::string& path)>& update_progress)
+namespace
+{
+struct FileToExport
+{
+  u64 offset;
+  u64 size;
+  std::string path;
+  std::string export_path;
+};
+
+// Creates the directories and lists the files to export. Returns false if cancelled.
+bool ListDirectoryToExport(const FileInfo& directory, bool recursive,
+                           const std::string& filesystem_path, const std::string& export_folder,
+                           const std::function<bool(const std::string& path)>& update_progress,
+                           std::vector<FileToExport>* files)
 {
   std::string export_root = export_folder + '/';
   if (directory.IsDirectory() && !directory.IsRoot())
@@ -142,24 +179,112 @@ void ExportDirectory(const Volume& volume, const Partition& partition, const Fil
     const std::string path = filesystem_path + name;
     const std::string export_path = export_root + name;
 
+    if (!file_info.IsDirectory())
+    {
+      files->push_back({file_info.GetOffset(), file_info.GetSize(), path, export_path});
+      continue;
+    }
+
     if (update_progress(path))
-      return;
+      return false;
 
     DEBUG_LOG_FMT(DISCIO, "{}", export_path);
 
-    if (!file_info.IsDirectory())
+    if (recursive &&
+        !ListDirectoryToExport(file_info, recursive, filesystem_path, export_root, update_progress,
+                               files))
     {
-      if (File::Exists(export_path))
-        NOTICE_LOG_FMT(DISCIO, "{} already exists", export_path);
-      else if (!ExportFile(volume, partition, &file_info, export_path))
-        ERROR_LOG_FMT(DISCIO, "Could not export {}", export_path);
+      return false;
     }
-    else if (recursive)
+  }
+
+  return true;
+}
+
+bool WriteFile(const std::string& export_path, const std::vector<u8>& data)
+{
+  File::IOFile f(export_path, "wb");
+  return f && f.WriteBytes(data.data(), data.size());
+}
+}  // namespace
+
+void ExportDirectory(const Volume& volume, const Partition& partition, const FileInfo& directory,
+                     bool recursive, const std::string& filesystem_path,
+                     const std::string& export_folder,
+                     const std::function<bool(const std::string& path)>& update_progress)
+{
+  std::vector<FileToExport> files;
+  if (!ListDirectoryToExport(directory, recursive, filesystem_path, export_folder, update_progress,
+                             &files))
+  {
+    return;
+  }
+
+  // Reading the files in the order they are stored in avoids seeking back and forth, and lets
+  // files which share a Wii cluster use the one the volume decrypted last. The volume can only be
+  // read from one thread, but the files are written on other threads in the meantime.
+  std::stable_sort(files.begin(), files.end(), [](const FileToExport& a, const FileToExport& b) {
+    return a.offset < b.offset;
+  });
+
+  struct PendingWrite
+  {
+    std::future<bool> success;
+    u64 size;
+    const std::string* export_path;
+  };
+  std::deque<PendingWrite> pending_writes;
+  u64 pending_write_size = 0;
+  const auto finish_write = [&pending_writes, &pending_write_size] {
+    PendingWrite& write = pending_writes.front();
+    if (!write.success.get())
+      ERROR_LOG_FMT(DISCIO, "Could not export {}", *write.export_path);
+    pending_write_size -= write.size;
+    pending_writes.pop_front();
+  };
+
+  for (const FileToExport& file : files)
+  {
+    if (update_progress(file.path))
+      break;
+
+    DEBUG_LOG_FMT(DISCIO, "{}", file.export_path);
+
+    if (File::Exists(file.export_path))
+    {
+      NOTICE_LOG_FMT(DISCIO, "{} already exists", file.export_path);
+      continue;
+    }
+
+    if (file.size > EXPORT_CHUNK_SIZE)
     {
-      ExportDirectory(volume, partition, file_info, recursive, filesystem_path, export_root,
-                      update_progress);
+      if (!ExportData(volume, partition, file.offset, file.size, file.export_path))
+        ERROR_LOG_FMT(DISCIO, "Could not export {}", file.export_path);
+      continue;
     }
+
+    while (!pending_writes.empty() && pending_write_size + file.size > MAX_PENDING_WRITE_SIZE)
+      finish_write();
+
+    std::vector<u8> data(file.size);
+    if (file.size != 0 && !volume.Read(file.offset, file.size, data.data(), partition))
+    {
+      ERROR_LOG_FMT(DISCIO, "Could not export {}", file.export_path);
+      continue;
+    }
+
+    pending_writes.push_back(
+        {Common::ThreadPool::GetShared().Async(
+             Common::TaskPriority::Background,
+             [&export_path = file.export_path, data = std::move(data)] {
+               return WriteFile(export_path, data);
+             }),
+         file.size, &file.export_path});
+    pending_write_size += file.size;
   }
+
+  while (!pending_writes.empty())
+    finish_write();
 }
 
 bool ExportWiiUnencryptedHeader(const Volume& volume, const std::string& export_filename)
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
@@ -13,6 +14,7 @@
 
 #include "Common/Align.h"
 #include "Common/Assert.h"
+#include "Common/BitSet.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 
@@ -34,10 +36,12 @@ bool DiscScrubber::SetupScrub(const Volume* disc)
   m_file_size = m_disc->GetSize();
 
   // Round up when diving by CLUSTER_SIZE, otherwise MarkAsUsed might write out of bounds
-  const size_t num_clusters = static_cast<size_t>((m_file_size + CLUSTER_SIZE - 1) / CLUSTER_SIZE);
+  m_num_clusters = (m_file_size + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
 
-  // Table of free blocks
-  m_free_table.resize(num_clusters, 1);
+  // Bitmap of used blocks
+  m_used_clusters.assign(static_cast<size_t>((m_num_clusters + 63) / 64), 0);
+  if (m_num_clusters % 64 != 0)
+    m_used_clusters.back() = ~u64(0) << (m_num_clusters % 64);
 
   // Fill out table of free blocks
   const bool success = ParseDisc();
@@ -48,20 +52,48 @@ bool DiscScrubber::SetupScrub(const Volume* disc)
 
 bool DiscScrubber::CanBlockBeScrubbed(u64 offset) const
 {
-  return m_is_scrubbing && m_free_table[offset / CLUSTER_SIZE];
+  const u64 cluster = offset / CLUSTER_SIZE;
+  return m_is_scrubbing && cluster < m_num_clusters &&
+         !(m_used_clusters[cluster / 64] & (u64(1) << (cluster % 64)));
+}
+
+u64 DiscScrubber::GetRunLength(u64 offset) const
+{
+  const u64 first_cluster = offset / CLUSTER_SIZE;
+  if (!m_is_scrubbing || first_cluster >= m_num_clusters)
+    return std::numeric_limits<u64>::max();
+
+  // Flip the words of a free run, so that the search is for the first set bit either way
+  const u64 flip = CanBlockBeScrubbed(offset) ? ~u64(0) : 0;
+
+  size_t word = static_cast<size_t>(first_cluster / 64);
+  u64 bits = (m_used_clusters[word] ^ flip) & (~u64(0) << (first_cluster % 64));
+  while (bits == 0 && ++word < m_used_clusters.size())
+    bits = m_used_clusters[word] ^ flip;
+
+  // A used run goes on past the end of the disc, since the padding bits are set
+  if (bits == 0)
+    return std::numeric_limits<u64>::max();
+
+  const u64 end_cluster = word * 64 + Common::LeastSignificantSetBit(bits);
+  return end_cluster * CLUSTER_SIZE - offset;
 }
 
 void DiscScrubber::MarkAsUsed(u64 offset, u64 size)
 {
-  u64 current_offset = Common::AlignDown(offset, CLUSTER_SIZE);
-  const u64 end_offset = offset + size;
+  const u64 end_offset = std::min(offset + size, m_file_size);
 
-  DEBUG_LOG_FMT(DISCIO, "Marking {:#018x} - {:#018x} as used", offset, end_offset);
+  DEBUG_LOG_FMT(DISCIO, "Marking {:#018x} - {:#018x} as used", offset, offset + size);
 
-  while (current_offset < end_offset && current_offset < m_file_size)
+  const u64 first_cluster = offset / CLUSTER_SIZE;
+  const u64 end_cluster = (end_offset + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+  for (u64 cluster = first_cluster; cluster < end_cluster;)
   {
-    m_free_table[current_offset / CLUSTER_SIZE] = 0;
-    current_offset += CLUSTER_SIZE;
+    const u64 bit = cluster % 64;
+    const u64 count = std::min<u64>(64 - bit, end_cluster - cluster);
+    const u64 mask = count == 64 ? ~u64(0) : ((u64(1) << count) - 1) << bit;
+    m_used_clusters[static_cast<size_t>(cluster / 64)] |= mask;
+    cluster += count;
   }
 }
 
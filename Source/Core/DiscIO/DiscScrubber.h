@@ -35,6 +35,10 @@ public:
   // Returns true if the specified 32 KiB block only contains unused data
   bool CanBlockBeScrubbed(u64 offset) const;
 
+  // Returns how many bytes starting at offset have the same CanBlockBeScrubbed result, so that
+  // callers can handle a whole run of used or unused clusters at once.
+  u64 GetRunLength(u64 offset) const;
+
   static constexpr size_t CLUSTER_SIZE = 0x8000;
 
 private:
@@ -49,7 +53,9 @@ private:
 
   const Volume* m_disc;
 
-  std::vector<u8> m_free_table;
+  // One bit per cluster, set if the cluster is used. The bits past the last cluster are set too.
+  std::vector<u64> m_used_clusters;
+  u64 m_num_clusters = 0;
   u64 m_file_size = 0;
   bool m_is_scrubbing = false;
 };
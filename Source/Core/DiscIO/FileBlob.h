@@ -29,6 +29,7 @@ public:
   bool HasFastRandomAccessInBlock() const override { return true; }
   std::string GetCompressionMethod() const override { return {}; }
 
+  // Safe to call from several threads at once.
   bool Read(u64 offset, u64 nbytes, u8* out_ptr) override;
 
 private:
@@ -0,0 +1,389 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "DiscIO/HttpBlob.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/Hash.h"
+#include "Common/HttpRequest.h"
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "Common/Thread.h"
+#include "DiscIO/Blob.h"
+
+namespace DiscIO
+{
+// Large enough that the per-request overhead doesn't dominate, small enough that a seek doesn't
+// have to wait for much more than it needs.
+constexpr u64 HTTP_BLOCK_SIZE = 0x100000;
+
+// How many blocks to download ahead of a sequential read.
+constexpr u64 READAHEAD_DEPTH = 4;
+
+// Used when there is no disk cache.
+constexpr size_t MAX_MEMORY_BLOCKS = 16;
+
+constexpr std::chrono::milliseconds HTTP_TIMEOUT{10000};
+
+constexpr u32 CACHE_INDEX_REVISION = 1;
+
+static std::optional<u64> ParseContentRangeTotal(const std::string& content_range)
+{
+  // e.g. "bytes 0-1048575/1459978240"
+  const size_t slash = content_range.rfind('/');
+  if (slash == std::string::npos)
+    return std::nullopt;
+
+  u64 total;
+  if (!TryParse(content_range.substr(slash + 1), &total) || total == 0)
+    return std::nullopt;
+  return total;
+}
+
+static std::string RangeHeader(u64 offset, u64 length)
+{
+  return fmt::format("bytes={}-{}", offset, offset + length - 1);
+}
+
+bool HttpBlobReader::IsURL(const std::string& path)
+{
+  const auto starts_with = [&path](std::string_view prefix) {
+    return path.size() >= prefix.size() &&
+           std::equal(prefix.begin(), prefix.end(), path.begin(), [](char a, char b) {
+             return a == std::tolower(static_cast<unsigned char>(b));
+           });
+  };
+  return starts_with("http://") || starts_with("https://");
+}
+
+std::unique_ptr<HttpBlobReader> HttpBlobReader::Create(const std::string& url)
+{
+  Common::HttpRequest request(HTTP_TIMEOUT);
+  if (!request.IsValid())
+    return nullptr;
+  request.FollowRedirects(5);
+
+  const Common::HttpRequest::Response response =
+      request.Get(url, {{"Range", RangeHeader(0, HTTP_BLOCK_SIZE)}},
+                  Common::HttpRequest::AllowedReturnCodes::All);
+  if (!response)
+    return nullptr;
+
+  if (request.GetLastResponseCode() != 206)
+  {
+    ERROR_LOG_FMT(DISCIO, "{} can't be read: expected a partial response, got code {}", url,
+                  request.GetLastResponseCode());
+    return nullptr;
+  }
+
+  const std::optional<std::string> content_range = request.GetLastResponseHeader("Content-Range");
+  const std::optional<u64> size =
+      content_range ? ParseContentRangeTotal(*content_range) : std::nullopt;
+  if (!size)
+  {
+    ERROR_LOG_FMT(DISCIO, "{} can't be read: the server didn't report the size", url);
+    return nullptr;
+  }
+
+  // If the image changes on the server, the cached blocks can't be used anymore
+  std::string validator = request.GetLastResponseHeader("ETag").value_or("");
+  if (validator.empty())
+    validator = request.GetLastResponseHeader("Last-Modified").value_or("");
+
+  auto reader = std::unique_ptr<HttpBlobReader>(new HttpBlobReader(url, *size));
+  std::lock_guard lk(reader->m_mutex);
+  reader->OpenDiskCache(validator);
+  if (response->size() == reader->GetBlockLength(0))
+    reader->Store(0, *response);
+  return reader;
+}
+
+HttpBlobReader::HttpBlobReader(std::string url, u64 size)
+    : m_url(std::move(url)), m_size(size), m_request(HTTP_TIMEOUT),
+      m_cached_blocks((size + HTTP_BLOCK_SIZE - 1) / HTTP_BLOCK_SIZE)
+{
+  m_request.FollowRedirects(5);
+  m_readahead_thread = std::thread(&HttpBlobReader::ReadaheadThread, this);
+}
+
+HttpBlobReader::~HttpBlobReader()
+{
+  {
+    std::lock_guard lk(m_mutex);
+    m_exiting = true;
+  }
+  m_cv.notify_all();
+  m_readahead_thread.join();
+}
+
+u64 HttpBlobReader::GetBlockLength(u64 block) const
+{
+  return std::min(HTTP_BLOCK_SIZE, m_size - block * HTTP_BLOCK_SIZE);
+}
+
+bool HttpBlobReader::Fetch(Common::HttpRequest* request, u64 block, std::vector<u8>* data) const
+{
+  const u64 length = GetBlockLength(block);
+  Common::HttpRequest::Response response =
+      request->Get(m_url, {{"Range", RangeHeader(block * HTTP_BLOCK_SIZE, length)}},
+                   Common::HttpRequest::AllowedReturnCodes::All);
+  if (!response || request->GetLastResponseCode() != 206 || response->size() != length)
+  {
+    ERROR_LOG_FMT(DISCIO, "Failed to download {:#x} bytes at {:#x} from {}", length,
+                  block * HTTP_BLOCK_SIZE, m_url);
+    return false;
+  }
+
+  *data = std::move(*response);
+  return true;
+}
+
+void HttpBlobReader::OpenDiskCache(const std::string& validator)
+{
+  const std::string& cache_directory = File::GetUserPath(D_CACHE_IDX);
+  if (cache_directory.empty())
+    return;
+
+  const u32 hash = Common::ComputeCRC32(0, reinterpret_cast<const u8*>(m_url.data()), m_url.size());
+  const std::string base_path = fmt::format("{}HttpBlob" DIR_SEP "{:08x}", cache_directory, hash);
+  if (!File::CreateFullPath(base_path))
+    return;
+
+  // The index starts with a header identifying the image, followed by one byte per block
+  // which is set once the block has been written to the data file.
+  std::vector<u8> header;
+  const auto append = [&header](const void* data, size_t size) {
+    const u8* ptr = static_cast<const u8*>(data);
+    header.insert(header.end(), ptr, ptr + size);
+  };
+  const u32 validator_size = static_cast<u32>(validator.size());
+  const u32 url_size = static_cast<u32>(m_url.size());
+  append(&CACHE_INDEX_REVISION, sizeof(CACHE_INDEX_REVISION));
+  append(&m_size, sizeof(m_size));
+  append(&url_size, sizeof(url_size));
+  append(m_url.data(), m_url.size());
+  append(&validator_size, sizeof(validator_size));
+  append(validator.data(), validator.size());
+
+  const std::string index_path = base_path + ".idx";
+  const std::string data_path = base_path + ".bin";
+
+  bool reuse = false;
+  {
+    File::IOFile index(index_path, "rb");
+    std::vector<u8> existing(header.size() + m_cached_blocks.size());
+    if (index.GetSize() == existing.size() && index.ReadBytes(existing.data(), existing.size()) &&
+        std::equal(header.begin(), header.end(), existing.begin()) &&
+        File::GetSize(data_path) == m_size)
+    {
+      reuse = true;
+      for (size_t i = 0; i < m_cached_blocks.size(); ++i)
+        m_cached_blocks[i] = existing[header.size() + i] != 0;
+    }
+  }
+
+  if (reuse)
+  {
+    m_cache_index.Open(index_path, "r+b");
+    m_cache_data.Open(data_path, "r+b");
+  }
+  else
+  {
+    m_cache_index.Open(index_path, "w+b");
+    m_cache_data.Open(data_path, "w+b");
+    const std::vector<u8> empty_index(m_cached_blocks.size());
+    if (!m_cache_index.WriteBytes(header.data(), header.size()) ||
+        !m_cache_index.WriteBytes(empty_index.data(), empty_index.size()) ||
+        !m_cache_data.Resize(m_size))
+    {
+      m_cache_index.Close();
+      m_cache_data.Close();
+    }
+  }
+
+  if (!m_cache_index || !m_cache_data)
+  {
+    WARN_LOG_FMT(DISCIO, "Couldn't open the disk cache for {}, only caching in memory", m_url);
+    m_cache_index.Close();
+    m_cache_data.Close();
+    std::fill(m_cached_blocks.begin(), m_cached_blocks.end(), false);
+    return;
+  }
+
+  m_cache_index_header_size = header.size();
+}
+
+bool HttpBlobReader::IsCached(u64 block) const
+{
+  return m_cache_data ? m_cached_blocks[block] : m_memory_blocks.count(block) != 0;
+}
+
+void HttpBlobReader::ReadCached(u64 block, u64 offset_in_block, u64 length, u8* out_ptr)
+{
+  if (!m_cache_data)
+  {
+    const std::vector<u8>& data = m_memory_blocks.at(block);
+    std::copy_n(data.begin() + offset_in_block, length, out_ptr);
+    return;
+  }
+
+  if (!m_cache_data.Seek(block * HTTP_BLOCK_SIZE + offset_in_block, SEEK_SET) ||
+      !m_cache_data.ReadBytes(out_ptr, length))
+  {
+    // Drop the disk cache, and let the caller's retry download the block again
+    ERROR_LOG_FMT(DISCIO, "Failed to read the disk cache for {}", m_url);
+    m_cache_data.Close();
+    m_cache_index.Close();
+  }
+}
+
+void HttpBlobReader::Store(u64 block, const std::vector<u8>& data)
+{
+  if (m_cache_data)
+  {
+    const u8 present = 1;
+    if (m_cache_data.Seek(block * HTTP_BLOCK_SIZE, SEEK_SET) &&
+        m_cache_data.WriteBytes(data.data(), data.size()) && m_cache_data.Flush() &&
+        m_cache_index.Seek(m_cache_index_header_size + block, SEEK_SET) &&
+        m_cache_index.WriteBytes(&present, sizeof(present)) && m_cache_index.Flush())
+    {
+      m_cached_blocks[block] = true;
+      return;
+    }
+
+    ERROR_LOG_FMT(DISCIO, "Failed to write the disk cache for {}", m_url);
+    m_cache_data.Close();
+    m_cache_index.Close();
+  }
+
+  if (m_memory_blocks.count(block))
+    return;
+  if (m_memory_block_order.size() >= MAX_MEMORY_BLOCKS)
+  {
+    m_memory_blocks.erase(m_memory_block_order.front());
+    m_memory_block_order.pop_front();
+  }
+  m_memory_blocks.emplace(block, data);
+  m_memory_block_order.push_back(block);
+}
+
+void HttpBlobReader::QueueReadahead(u64 block)
+{
+  if (block == m_last_block)
+    return;
+
+  if (block == m_last_block + 1)
+  {
+    for (u64 i = block + 1; i <= block + READAHEAD_DEPTH && i < m_cached_blocks.size(); ++i)
+    {
+      if (!IsCached(i) && !m_blocks_in_flight.count(i) &&
+          std::find(m_readahead_queue.begin(), m_readahead_queue.end(), i) ==
+              m_readahead_queue.end())
+      {
+        m_readahead_queue.push_back(i);
+      }
+    }
+    m_cv.notify_all();
+  }
+  m_last_block = block;
+}
+
+bool HttpBlobReader::Read(u64 offset, u64 nbytes, u8* out_ptr)
+{
+  if (offset + nbytes > m_size || offset + nbytes < offset)
+    return false;
+
+  while (nbytes > 0)
+  {
+    const u64 block = offset / HTTP_BLOCK_SIZE;
+    const u64 offset_in_block = offset % HTTP_BLOCK_SIZE;
+    const u64 length = std::min(nbytes, GetBlockLength(block) - offset_in_block);
+
+    std::unique_lock lk(m_mutex);
+    QueueReadahead(block);
+    m_cv.wait(lk, [&] { return !m_blocks_in_flight.count(block); });
+
+    if (IsCached(block))
+    {
+      ReadCached(block, offset_in_block, length, out_ptr);
+    }
+    if (!IsCached(block))
+    {
+      m_blocks_in_flight.insert(block);
+      lk.unlock();
+
+      std::vector<u8> data;
+      bool success;
+      {
+        std::lock_guard request_lk(m_request_mutex);
+        success = Fetch(&m_request, block, &data);
+      }
+
+      lk.lock();
+      m_blocks_in_flight.erase(block);
+      m_cv.notify_all();
+      if (!success)
+        return false;
+
+      Store(block, data);
+      std::copy_n(data.begin() + offset_in_block, length, out_ptr);
+    }
+
+    offset += length;
+    nbytes -= length;
+    out_ptr += length;
+  }
+
+  return true;
+}
+
+void HttpBlobReader::ReadaheadThread()
+{
+  Common::SetCurrentThreadName("HTTP disc readahead thread");
+
+  Common::HttpRequest request(HTTP_TIMEOUT);
+  request.FollowRedirects(5);
+
+  std::unique_lock lk(m_mutex);
+  while (true)
+  {
+    m_cv.wait(lk, [this] { return m_exiting || !m_readahead_queue.empty(); });
+    if (m_exiting)
+      return;
+
+    const u64 block = m_readahead_queue.front();
+    m_readahead_queue.pop_front();
+    if (IsCached(block) || m_blocks_in_flight.count(block))
+      continue;
+
+    m_blocks_in_flight.insert(block);
+    lk.unlock();
+
+    std::vector<u8> data;
+    const bool success = Fetch(&request, block, &data);
+
+    lk.lock();
+    m_blocks_in_flight.erase(block);
+    if (success)
+      Store(block, data);
+    m_cv.notify_all();
+  }
+}
+
+}  // namespace DiscIO
@@ -0,0 +1,94 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/HttpRequest.h"
+#include "Common/IOFile.h"
+#include "DiscIO/Blob.h"
+
+namespace DiscIO
+{
+// Reads a plain disc image from an HTTP(S) server using range requests, so that it can be booted
+// without downloading all of it first. Blocks that have been downloaded are kept in a sparse file
+// in the cache directory, which is reused as long as the server reports the same size and
+// ETag/Last-Modified for the image. When reads are sequential, the next few blocks are downloaded
+// in the background.
+class HttpBlobReader : public BlobReader
+{
+public:
+  static bool IsURL(const std::string& path);
+  static std::unique_ptr<HttpBlobReader> Create(const std::string& url);
+
+  ~HttpBlobReader();
+
+  HttpBlobReader(const HttpBlobReader&) = delete;
+  HttpBlobReader& operator=(const HttpBlobReader&) = delete;
+
+  BlobType GetBlobType() const override { return BlobType::PLAIN; }
+
+  u64 GetRawSize() const override { return m_size; }
+  u64 GetDataSize() const override { return m_size; }
+  bool IsDataSizeAccurate() const override { return true; }
+
+  u64 GetBlockSize() const override { return 0; }
+  bool HasFastRandomAccessInBlock() const override { return true; }
+  std::string GetCompressionMethod() const override { return {}; }
+
+  // Safe to call from several threads at once.
+  bool Read(u64 offset, u64 nbytes, u8* out_ptr) override;
+
+private:
+  HttpBlobReader(std::string url, u64 size);
+
+  bool Fetch(Common::HttpRequest* request, u64 block, std::vector<u8>* data) const;
+  u64 GetBlockLength(u64 block) const;
+
+  // The functions below must be called with m_mutex locked.
+  void OpenDiskCache(const std::string& validator);
+  bool IsCached(u64 block) const;
+  void ReadCached(u64 block, u64 offset_in_block, u64 length, u8* out_ptr);
+  void Store(u64 block, const std::vector<u8>& data);
+  void QueueReadahead(u64 block);
+
+  void ReadaheadThread();
+
+  const std::string m_url;
+  const u64 m_size;
+
+  // Only used for reads from the caller's thread. The readahead thread has its own.
+  std::mutex m_request_mutex;
+  Common::HttpRequest m_request;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+
+  // The blocks are stored in m_cache_data if the disk cache could be opened,
+  // and otherwise a few recently used ones are kept in m_memory_blocks.
+  File::IOFile m_cache_data;
+  File::IOFile m_cache_index;
+  u64 m_cache_index_header_size = 0;
+  std::vector<bool> m_cached_blocks;
+  std::map<u64, std::vector<u8>> m_memory_blocks;
+  std::deque<u64> m_memory_block_order;
+
+  std::set<u64> m_blocks_in_flight;
+  std::deque<u64> m_readahead_queue;
+  u64 m_last_block = 0;
+  bool m_exiting = false;
+  std::thread m_readahead_thread;
+};
+
+}  // namespace DiscIO
@@ -0,0 +1,270 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "DiscIO/PrefetchingBlob.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "Common/Thread.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/VolumeWii.h"
+
+namespace DiscIO
+{
+// Used in place of a partition data offset for reads which aren't decrypted.
+constexpr u64 RAW_STREAM = std::numeric_limits<u64>::max();
+
+// How many blocks to decompress ahead of a sequential read.
+constexpr u64 PREFETCH_DEPTH = 4;
+
+// Disc reads are usually at least this large, so smaller blocks only add overhead.
+constexpr u64 MIN_BLOCK_SIZE = VolumeWii::BLOCK_TOTAL_SIZE;
+
+std::unique_ptr<BlobReader> PrefetchingBlobReader::Wrap(std::unique_ptr<BlobReader> blob_reader,
+                                                        u64 cache_size)
+{
+  if (!blob_reader || cache_size == 0 || blob_reader->GetBlockSize() == 0)
+    return blob_reader;
+
+  switch (blob_reader->GetBlobType())
+  {
+  case BlobType::GCZ:
+  case BlobType::CISO:
+  case BlobType::WIA:
+  case BlobType::RVZ:
+    return std::unique_ptr<PrefetchingBlobReader>(
+        new PrefetchingBlobReader(std::move(blob_reader), cache_size));
+  default:
+    return blob_reader;
+  }
+}
+
+PrefetchingBlobReader::PrefetchingBlobReader(std::unique_ptr<BlobReader> blob_reader,
+                                             u64 cache_size)
+    : m_blob_reader(std::move(blob_reader)),
+      m_block_size(std::max(m_blob_reader->GetBlockSize(), MIN_BLOCK_SIZE)),
+      m_decrypted_block_size(m_block_size / VolumeWii::BLOCK_TOTAL_SIZE *
+                             VolumeWii::BLOCK_DATA_SIZE),
+      m_max_cached_blocks(
+          static_cast<size_t>(std::max(cache_size / m_block_size, PREFETCH_DEPTH * 2 + 2)))
+{
+  m_prefetch_thread = std::thread(&PrefetchingBlobReader::PrefetchThread, this);
+}
+
+PrefetchingBlobReader::~PrefetchingBlobReader()
+{
+  {
+    std::lock_guard lk(m_cache_mutex);
+    m_exiting = true;
+  }
+  m_prefetch_requested.notify_one();
+  m_prefetch_thread.join();
+}
+
+bool PrefetchingBlobReader::Read(u64 offset, u64 size, u8* out_ptr)
+{
+  if (ReadCached(offset, size, out_ptr, RAW_STREAM))
+    return true;
+
+  std::lock_guard lk(m_blob_reader_mutex);
+  return m_blob_reader->Read(offset, size, out_ptr);
+}
+
+bool PrefetchingBlobReader::SupportsReadWiiDecrypted(u64 offset, u64 size,
+                                                     u64 partition_data_offset) const
+{
+  std::lock_guard lk(m_blob_reader_mutex);
+  return m_blob_reader->SupportsReadWiiDecrypted(offset, size, partition_data_offset);
+}
+
+bool PrefetchingBlobReader::ReadWiiDecrypted(u64 offset, u64 size, u8* out_ptr,
+                                             u64 partition_data_offset)
+{
+  if (ReadCached(offset, size, out_ptr, partition_data_offset))
+    return true;
+
+  std::lock_guard lk(m_blob_reader_mutex);
+  return m_blob_reader->ReadWiiDecrypted(offset, size, out_ptr, partition_data_offset);
+}
+
+u64 PrefetchingBlobReader::GetStreamBlockSize(u64 stream) const
+{
+  return stream == RAW_STREAM ? m_block_size : m_decrypted_block_size;
+}
+
+// Returns false if any block of the range couldn't be served from the cache, in which case the
+// caller reads the whole range directly.
+bool PrefetchingBlobReader::ReadCached(u64 offset, u64 size, u8* out_ptr, u64 stream)
+{
+  const u64 block_size = GetStreamBlockSize(stream);
+  while (size > 0)
+  {
+    const BlockData data = GetBlock({stream, offset / block_size});
+    const u64 offset_in_block = offset % block_size;
+    if (!data || offset_in_block >= data->size())
+      return false;
+
+    const u64 bytes_to_copy = std::min(size, data->size() - offset_in_block);
+    std::copy_n(data->begin() + offset_in_block, bytes_to_copy, out_ptr);
+
+    offset += bytes_to_copy;
+    size -= bytes_to_copy;
+    out_ptr += bytes_to_copy;
+  }
+
+  return true;
+}
+
+PrefetchingBlobReader::BlockData PrefetchingBlobReader::GetBlock(const BlockKey& key)
+{
+  std::unique_lock lk(m_cache_mutex);
+
+  if (key != m_last_block)
+  {
+    if (key.first == m_last_block.first && key.second == m_last_block.second + 1)
+    {
+      for (u64 i = 1; i <= PREFETCH_DEPTH; ++i)
+        QueuePrefetch({key.first, key.second + i});
+    }
+    m_last_block = key;
+  }
+
+  while (true)
+  {
+    const auto it = m_cache.find(key);
+    if (it == m_cache.end())
+      break;
+
+    if (!it->second.loading)
+    {
+      it->second.last_used = ++m_use_counter;
+      return it->second.data;
+    }
+
+    // The prefetch thread is already working on this block.
+    m_block_loaded.wait(lk);
+  }
+
+  m_cache.emplace(key, CacheEntry{});
+  lk.unlock();
+  BlockData data = LoadBlock(key);
+  lk.lock();
+  StoreBlock(key, data);
+  return data;
+}
+
+PrefetchingBlobReader::BlockData PrefetchingBlobReader::LoadBlock(const BlockKey& key)
+{
+  const auto& [stream, block] = key;
+  const u64 block_size = GetStreamBlockSize(stream);
+  const u64 offset = block * block_size;
+
+  std::lock_guard lk(m_blob_reader_mutex);
+
+  if (stream == RAW_STREAM)
+  {
+    const u64 data_size = m_blob_reader->GetDataSize();
+    if (offset >= data_size)
+      return nullptr;
+
+    auto data = std::make_shared<std::vector<u8>>(std::min(block_size, data_size - offset));
+    if (!m_blob_reader->Read(offset, data->size(), data->data()))
+      return nullptr;
+
+    return data;
+  }
+
+  // The last block of a partition is usually incomplete, and is left to direct reads.
+  if (!m_blob_reader->SupportsReadWiiDecrypted(offset, block_size, stream))
+    return nullptr;
+
+  auto data = std::make_shared<std::vector<u8>>(block_size);
+  if (!m_blob_reader->ReadWiiDecrypted(offset, block_size, data->data(), stream))
+    return nullptr;
+
+  return data;
+}
+
+// Must be called with m_cache_mutex held.
+void PrefetchingBlobReader::StoreBlock(const BlockKey& key, BlockData data)
+{
+  const auto it = m_cache.find(key);
+  if (data)
+  {
+    it->second.data = std::move(data);
+    it->second.loading = false;
+    it->second.last_used = ++m_use_counter;
+  }
+  else
+  {
+    m_cache.erase(it);
+  }
+  m_block_loaded.notify_all();
+
+  while (m_cache.size() > m_max_cached_blocks)
+  {
+    auto oldest = m_cache.end();
+    for (auto entry = m_cache.begin(); entry != m_cache.end(); ++entry)
+    {
+      if (!entry->second.loading &&
+          (oldest == m_cache.end() || entry->second.last_used < oldest->second.last_used))
+      {
+        oldest = entry;
+      }
+    }
+
+    if (oldest == m_cache.end())
+      break;
+
+    m_cache.erase(oldest);
+  }
+}
+
+// Must be called with m_cache_mutex held.
+void PrefetchingBlobReader::QueuePrefetch(const BlockKey& key)
+{
+  if (m_cache.count(key) != 0 ||
+      std::find(m_prefetch_queue.begin(), m_prefetch_queue.end(), key) != m_prefetch_queue.end())
+  {
+    return;
+  }
+
+  // Drop requests which have been overtaken by the reads since.
+  if (m_prefetch_queue.size() >= PREFETCH_DEPTH * 2)
+    m_prefetch_queue.pop_front();
+
+  m_prefetch_queue.push_back(key);
+  m_prefetch_requested.notify_one();
+}
+
+void PrefetchingBlobReader::PrefetchThread()
+{
+  Common::SetCurrentThreadName("Disc prefetch thread");
+
+  std::unique_lock lk(m_cache_mutex);
+  while (true)
+  {
+    m_prefetch_requested.wait(lk, [this] { return m_exiting || !m_prefetch_queue.empty(); });
+    if (m_exiting)
+      return;
+
+    const BlockKey key = m_prefetch_queue.front();
+    m_prefetch_queue.pop_front();
+    if (m_cache.count(key) != 0)
+      continue;
+
+    m_cache.emplace(key, CacheEntry{});
+    lk.unlock();
+    BlockData data = LoadBlock(key);
+    lk.lock();
+    StoreBlock(key, std::move(data));
+  }
+}
+
+}  // namespace DiscIO
@@ -0,0 +1,98 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "DiscIO/Blob.h"
+
+namespace DiscIO
+{
+// This class wraps a BlobReader for a compressed format and keeps recently read blocks in a cache
+// of a configurable size. When reads are sequential, a background thread decompresses the blocks
+// which follow ahead of time, so that the reader only has to wait for the decompression when it
+// seeks. Unlike other BlobReaders, this one can be read from several threads at once.
+class PrefetchingBlobReader : public BlobReader
+{
+public:
+  // Returns the reader unchanged if it isn't of a format which benefits from caching.
+  static std::unique_ptr<BlobReader> Wrap(std::unique_ptr<BlobReader> blob_reader,
+                                          u64 cache_size);
+  ~PrefetchingBlobReader() override;
+
+  BlobType GetBlobType() const override { return m_blob_reader->GetBlobType(); }
+
+  u64 GetRawSize() const override { return m_blob_reader->GetRawSize(); }
+  u64 GetDataSize() const override { return m_blob_reader->GetDataSize(); }
+  bool IsDataSizeAccurate() const override { return m_blob_reader->IsDataSizeAccurate(); }
+
+  u64 GetBlockSize() const override { return m_blob_reader->GetBlockSize(); }
+  bool HasFastRandomAccessInBlock() const override
+  {
+    return m_blob_reader->HasFastRandomAccessInBlock();
+  }
+  std::string GetCompressionMethod() const override
+  {
+    return m_blob_reader->GetCompressionMethod();
+  }
+
+  bool Read(u64 offset, u64 size, u8* out_ptr) override;
+
+  bool SupportsReadWiiDecrypted(u64 offset, u64 size, u64 partition_data_offset) const override;
+  bool ReadWiiDecrypted(u64 offset, u64 size, u8* out_ptr, u64 partition_data_offset) override;
+
+private:
+  // The first member is the partition data offset for decrypted reads, or RAW_STREAM.
+  using BlockKey = std::pair<u64, u64>;
+  using BlockData = std::shared_ptr<const std::vector<u8>>;
+
+  struct CacheEntry
+  {
+    BlockData data;
+    bool loading = true;
+    u64 last_used = 0;
+  };
+
+  PrefetchingBlobReader(std::unique_ptr<BlobReader> blob_reader, u64 cache_size);
+
+  bool ReadCached(u64 offset, u64 size, u8* out_ptr, u64 stream);
+  u64 GetStreamBlockSize(u64 stream) const;
+  BlockData GetBlock(const BlockKey& key);
+  BlockData LoadBlock(const BlockKey& key);
+  void StoreBlock(const BlockKey& key, BlockData data);
+  void QueuePrefetch(const BlockKey& key);
+  void PrefetchThread();
+
+  std::unique_ptr<BlobReader> m_blob_reader;
+  // Guards m_blob_reader, which isn't thread-safe.
+  mutable std::mutex m_blob_reader_mutex;
+
+  u64 m_block_size;
+  u64 m_decrypted_block_size;
+  size_t m_max_cached_blocks;
+
+  // Guards everything below.
+  std::mutex m_cache_mutex;
+  std::condition_variable m_block_loaded;
+  std::condition_variable m_prefetch_requested;
+  std::map<BlockKey, CacheEntry> m_cache;
+  u64 m_use_counter = 0;
+  BlockKey m_last_block{};
+  std::deque<BlockKey> m_prefetch_queue;
+  bool m_exiting = false;
+
+  std::thread m_prefetch_thread;
+};
+
+}  // namespace DiscIO
@@ -9,7 +9,6 @@
 #include <string>
 #include <utility>
 
-#include "Common/Align.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/DiscScrubber.h"
 #include "DiscIO/VolumeDisc.h"
@@ -42,9 +41,7 @@ bool ScrubbedBlob::Read(u64 offset, u64 size, u8* out_ptr)
 {
   while (size > 0)
   {
-    constexpr size_t CLUSTER_SIZE = DiscScrubber::CLUSTER_SIZE;
-    const u64 bytes_to_read =
-        std::min(Common::AlignDown(offset + CLUSTER_SIZE, CLUSTER_SIZE) - offset, size);
+    const u64 bytes_to_read = std::min(m_scrubber.GetRunLength(offset), size);
 
     if (m_scrubber.CanBlockBeScrubbed(offset))
     {
@@ -21,6 +21,7 @@
 #include "Core/IOS/ES/Formats.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/Enums.h"
+#include "DiscIO/PrefetchingBlob.h"
 #include "DiscIO/VolumeDisc.h"
 #include "DiscIO/VolumeGC.h"
 #include "DiscIO/VolumeWad.h"
@@ -107,6 +108,13 @@ std::unique_ptr<VolumeDisc> CreateDisc(const std::string& path)
   return reader ? CreateDisc(reader) : nullptr;
 }
 
+std::unique_ptr<VolumeDisc> CreateDisc(const std::string& path, u64 prefetch_cache_size)
+{
+  std::unique_ptr<BlobReader> reader =
+      PrefetchingBlobReader::Wrap(CreateBlobReader(path), prefetch_cache_size);
+  return reader ? CreateDisc(reader) : nullptr;
+}
+
 static std::unique_ptr<VolumeWAD> CreateWAD(std::unique_ptr<BlobReader>& reader)
 {
   // Check for WAD
@@ -126,7 +126,8 @@ public:
   virtual bool IsNKit() const = 0;
   virtual bool SupportsIntegrityCheck() const { return false; }
   virtual bool CheckH3TableIntegrity(const Partition& partition) const { return false; }
-  virtual bool CheckBlockIntegrity(u64 block_index, const std::vector<u8>& encrypted_data,
+  // encrypted_data must point to one whole encrypted block (VolumeWii::BLOCK_TOTAL_SIZE bytes)
+  virtual bool CheckBlockIntegrity(u64 block_index, const u8* encrypted_data,
                                    const Partition& partition) const
   {
     return false;
@@ -184,6 +185,9 @@ protected:
 };
 
 std::unique_ptr<VolumeDisc> CreateDisc(const std::string& path);
+// Reads from compressed formats go through a cache of the given size in bytes, which is filled
+// ahead of sequential reads on a separate thread. A size of 0 disables the cache.
+std::unique_ptr<VolumeDisc> CreateDisc(const std::string& path, u64 prefetch_cache_size);
 std::unique_ptr<VolumeWAD> CreateWAD(const std::string& path);
 std::unique_ptr<Volume> CreateVolume(const std::string& path);
 
@@ -16,7 +16,6 @@
 #include <unordered_set>
 
 #include <mbedtls/md5.h>
-#include <mbedtls/sha1.h>
 #include <pugixml.hpp>
 #include <unzip.h>
 #include <zlib.h>
@@ -26,6 +25,7 @@
 #include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
+#include "Common/Hash.h"
 #include "Common/HttpRequest.h"
 #include "Common/IOFile.h"
 #include "Common/Logging/Log.h"
@@ -34,6 +34,7 @@
 #include "Common/ScopeGuard.h"
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
+#include "Common/ThreadPool.h"
 #include "Common/Version.h"
 #include "Core/IOS/Device.h"
 #include "Core/IOS/ES/ES.h"
@@ -1087,7 +1088,7 @@ void VolumeVerifier::SetUpHashing()
             [](const BlockToVerify& b1, const BlockToVerify& b2) { return b1.offset < b2.offset; });
 
   if (m_hashes_to_calculate.crc32)
-    m_crc32_context = crc32(0, nullptr, 0);
+    m_crc32_context = 0;
 
   if (m_hashes_to_calculate.md5)
   {
@@ -1096,10 +1097,7 @@ void VolumeVerifier::SetUpHashing()
   }
 
   if (m_hashes_to_calculate.sha1)
-  {
-    mbedtls_sha1_init(&m_sha1_context);
-    mbedtls_sha1_starts_ret(&m_sha1_context);
-  }
+    m_sha1_context = Common::SHA1::CreateContext();
 }
 
 void VolumeVerifier::WaitForAsyncOperations() const
@@ -1156,7 +1154,18 @@ void VolumeVerifier::Process()
   }
   else if (m_block_index < m_blocks.size() && m_blocks[m_block_index].offset == m_progress)
   {
-    bytes_to_read = VolumeWii::BLOCK_TOTAL_SIZE;
+    // Read a run of adjacent blocks from the same partition at once, so that they can be checked
+    // in parallel. A group is the unit that compressed formats store blocks in.
+    const u64 max_blocks = VolumeWii::GROUP_TOTAL_SIZE / VolumeWii::BLOCK_TOTAL_SIZE;
+    u64 blocks = 1;
+    while (blocks < max_blocks && m_block_index + blocks < m_blocks.size() &&
+           m_blocks[m_block_index + blocks].offset ==
+               m_progress + blocks * VolumeWii::BLOCK_TOTAL_SIZE &&
+           m_blocks[m_block_index + blocks].partition == m_blocks[m_block_index].partition)
+    {
+      ++blocks;
+    }
+    bytes_to_read = blocks * VolumeWii::BLOCK_TOTAL_SIZE;
     block_read = true;
   }
   else if (m_block_index < m_blocks.size() && m_blocks[m_block_index].offset > m_progress)
@@ -1181,9 +1190,7 @@ void VolumeVerifier::Process()
     if (m_hashes_to_calculate.crc32)
     {
       m_crc32_future = std::async(std::launch::async, [this] {
-        // It would be nice to use crc32_z here instead of crc32, but it isn't available on Android
-        m_crc32_context =
-            crc32(m_crc32_context, m_data.data(), static_cast<unsigned int>(m_data.size()));
+        m_crc32_context = Common::ComputeCRC32(m_crc32_context, m_data.data(), m_data.size());
       });
     }
 
@@ -1196,9 +1203,8 @@ void VolumeVerifier::Process()
 
     if (m_hashes_to_calculate.sha1)
     {
-      m_sha1_future = std::async(std::launch::async, [this] {
-        mbedtls_sha1_update_ret(&m_sha1_context, m_data.data(), m_data.size());
-      });
+      m_sha1_future =
+          std::async(std::launch::async, [this] { m_sha1_context->Update(m_data); });
     }
   }
 
@@ -1219,44 +1225,61 @@ void VolumeVerifier::Process()
   {
     m_block_future = std::async(
         std::launch::async,
-        [this, read_succeeded, bytes_to_read](size_t block_index, u64 progress) {
-          while (block_index < m_blocks.size() &&
-                 m_blocks[block_index].offset < progress + bytes_to_read)
+        [this, is_data_needed, read_succeeded, bytes_to_read](size_t first_block_index,
+                                                              u64 progress) {
+          size_t end_block_index = first_block_index;
+          while (end_block_index < m_blocks.size() &&
+                 m_blocks[end_block_index].offset < progress + bytes_to_read)
           {
-            bool success;
-            if (m_blocks[block_index].offset == progress)
-            {
-              success = read_succeeded &&
-                        m_volume.CheckBlockIntegrity(m_blocks[block_index].block_index, m_data,
-                                                     m_blocks[block_index].partition);
-            }
-            else
+            end_block_index++;
+          }
+
+          const auto check_block = [&](size_t block_index) {
+            const BlockToVerify& block = m_blocks[block_index];
+            const u64 end_offset = block.offset + VolumeWii::BLOCK_TOTAL_SIZE;
+            if (is_data_needed && end_offset <= progress + bytes_to_read)
             {
-              std::lock_guard lk(m_volume_mutex);
-              success = m_volume.CheckBlockIntegrity(m_blocks[block_index].block_index,
-                                                     m_blocks[block_index].partition);
+              return read_succeeded &&
+                     m_volume.CheckBlockIntegrity(block.block_index,
+                                                  m_data.data() + (block.offset - progress),
+                                                  block.partition);
             }
 
-            const u64 offset = m_blocks[block_index].offset;
-            if (success)
+            std::lock_guard lk(m_volume_mutex);
+            return m_volume.CheckBlockIntegrity(block.block_index, block.partition);
+          };
+
+          // The first block is checked on its own so that the partition's lazily loaded key and
+          // H3 table exist before several threads use them.
+          std::vector<u8> results(end_block_index - first_block_index);
+          results[0] = check_block(first_block_index);
+
+          Common::ThreadPool::GetShared().ParallelFor(
+              static_cast<u32>(results.size() - 1),
+              [&](u32 i) { results[i + 1] = check_block(first_block_index + i + 1); });
+
+          for (size_t i = 0; i < results.size(); ++i)
+          {
+            const BlockToVerify& block = m_blocks[first_block_index + i];
+            if (results[i])
             {
               m_biggest_verified_offset =
-                  std::max(m_biggest_verified_offset, offset + VolumeWii::BLOCK_TOTAL_SIZE);
+                  std::max(m_biggest_verified_offset, block.offset + VolumeWii::BLOCK_TOTAL_SIZE);
             }
             else
             {
-              if (m_scrubber.CanBlockBeScrubbed(offset))
+              if (m_scrubber.CanBlockBeScrubbed(block.offset))
               {
-                WARN_LOG_FMT(DISCIO, "Integrity check failed for unused block at {:#x}", offset);
-                m_unused_block_errors[m_blocks[block_index].partition]++;
+                WARN_LOG_FMT(DISCIO, "Integrity check failed for unused block at {:#x}",
+                             block.offset);
+                m_unused_block_errors[block.partition]++;
               }
               else
               {
-                WARN_LOG_FMT(DISCIO, "Integrity check failed for block at {:#x}", offset);
-                m_block_errors[m_blocks[block_index].partition]++;
+                WARN_LOG_FMT(DISCIO, "Integrity check failed for block at {:#x}", block.offset);
+                m_block_errors[block.partition]++;
               }
             }
-            block_index++;
           }
         },
         m_block_index, m_progress);
@@ -1307,8 +1330,8 @@ void VolumeVerifier::Finish()
 
     if (m_hashes_to_calculate.sha1)
     {
-      m_result.hashes.sha1 = std::vector<u8>(20);
-      mbedtls_sha1_finish_ret(&m_sha1_context, m_result.hashes.sha1.data());
+      const Common::SHA1::Digest digest = m_sha1_context->Finish();
+      m_result.hashes.sha1 = std::vector<u8>(digest.begin(), digest.end());
     }
   }
 
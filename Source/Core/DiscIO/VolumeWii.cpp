@@ -17,15 +17,16 @@
 #include <utility>
 #include <vector>
 
-#include <mbedtls/aes.h>
 #include <mbedtls/sha1.h>
 
 #include "Common/Align.h"
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/Swap.h"
+#include "Common/ThreadPool.h"
 
 #include "DiscIO/Blob.h"
 #include "DiscIO/DiscExtractor.h"
@@ -126,14 +127,12 @@ VolumeWii::VolumeWii(std::unique_ptr<BlobReader> reader)
         return h3_table;
       };
 
-      auto get_key = [this, partition]() -> std::unique_ptr<mbedtls_aes_context> {
+      auto get_key = [this, partition]() -> std::unique_ptr<Common::AES::Context> {
         const IOS::ES::TicketReader& ticket = *m_partitions[partition].ticket;
         if (!ticket.IsValid())
           return nullptr;
         const std::array<u8, AES_KEY_SIZE> key = ticket.GetTitleKey();
-        std::unique_ptr<mbedtls_aes_context> aes_context = std::make_unique<mbedtls_aes_context>();
-        mbedtls_aes_setkey_dec(aes_context.get(), key.data(), 128);
-        return aes_context;
+        return Common::AES::CreateContextDecrypt(key.data());
       };
 
       auto get_file_system = [this, partition]() -> std::unique_ptr<FileSystem> {
@@ -146,7 +145,7 @@ VolumeWii::VolumeWii(std::unique_ptr<BlobReader> reader)
       };
 
       m_partitions.emplace(
-          partition, PartitionDetails{Common::Lazy<std::unique_ptr<mbedtls_aes_context>>(get_key),
+          partition, PartitionDetails{Common::Lazy<std::unique_ptr<Common::AES::Context>>(get_key),
                                       Common::Lazy<IOS::ES::TicketReader>(get_ticket),
                                       Common::Lazy<IOS::ES::TMDReader>(get_tmd),
                                       Common::Lazy<std::vector<u8>>(get_cert_chain),
@@ -181,7 +180,7 @@ bool VolumeWii::Read(u64 offset, u64 length, u8* buffer, const Partition& partit
                           buffer);
   }
 
-  mbedtls_aes_context* aes_context = partition_details.key->get();
+  Common::AES::Context* aes_context = partition_details.key->get();
   if (!aes_context)
     return false;
 
@@ -408,17 +407,12 @@ bool VolumeWii::CheckH3TableIntegrity(const Partition& partition) const
   if (contents.size() != 1)
     return false;
 
-  std::array<u8, 20> h3_table_sha1;
-  mbedtls_sha1_ret(h3_table.data(), h3_table.size(), h3_table_sha1.data());
-  return h3_table_sha1 == contents[0].sha1;
+  return Common::SHA1::CalculateDigest(h3_table) == contents[0].sha1;
 }
 
-bool VolumeWii::CheckBlockIntegrity(u64 block_index, const std::vector<u8>& encrypted_data,
+bool VolumeWii::CheckBlockIntegrity(u64 block_index, const u8* encrypted_data,
                                     const Partition& partition) const
 {
-  if (encrypted_data.size() != BLOCK_TOTAL_SIZE)
-    return false;
-
   auto it = m_partitions.find(partition);
   if (it == m_partitions.end())
     return false;
@@ -427,38 +421,35 @@ bool VolumeWii::CheckBlockIntegrity(u64 block_index, const std::vector<u8>& encr
   if (block_index / BLOCKS_PER_GROUP * SHA1_SIZE >= partition_details.h3_table->size())
     return false;
 
-  mbedtls_aes_context* aes_context = partition_details.key->get();
+  Common::AES::Context* aes_context = partition_details.key->get();
   if (!aes_context)
     return false;
 
   HashBlock hashes;
-  DecryptBlockHashes(encrypted_data.data(), &hashes, aes_context);
+  DecryptBlockHashes(encrypted_data, &hashes, aes_context);
 
   u8 cluster_data[BLOCK_DATA_SIZE];
-  DecryptBlockData(encrypted_data.data(), cluster_data, aes_context);
+  DecryptBlockData(encrypted_data, cluster_data, aes_context);
 
-  for (u32 hash_index = 0; hash_index < 31; ++hash_index)
-  {
-    u8 h0_hash[SHA1_SIZE];
-    mbedtls_sha1_ret(cluster_data + hash_index * 0x400, 0x400, h0_hash);
-    if (memcmp(h0_hash, hashes.h0[hash_index], SHA1_SIZE))
-      return false;
-  }
+  u8 h0_hashes[31][SHA1_SIZE];
+  Common::SHA1::CalculateDigests(cluster_data, 0x400, 31, &h0_hashes[0][0]);
+  if (memcmp(h0_hashes, hashes.h0, sizeof(hashes.h0)))
+    return false;
 
-  u8 h1_hash[SHA1_SIZE];
-  mbedtls_sha1_ret(reinterpret_cast<u8*>(hashes.h0), sizeof(hashes.h0), h1_hash);
-  if (memcmp(h1_hash, hashes.h1[block_index % 8], SHA1_SIZE))
+  const auto h1_hash = Common::SHA1::CalculateDigest(&hashes.h0[0][0], sizeof(hashes.h0));
+  if (memcmp(h1_hash.data(), hashes.h1[block_index % 8], SHA1_SIZE))
     return false;
 
-  u8 h2_hash[SHA1_SIZE];
-  mbedtls_sha1_ret(reinterpret_cast<u8*>(hashes.h1), sizeof(hashes.h1), h2_hash);
-  if (memcmp(h2_hash, hashes.h2[block_index / 8 % 8], SHA1_SIZE))
+  const auto h2_hash = Common::SHA1::CalculateDigest(&hashes.h1[0][0], sizeof(hashes.h1));
+  if (memcmp(h2_hash.data(), hashes.h2[block_index / 8 % 8], SHA1_SIZE))
     return false;
 
-  u8 h3_hash[SHA1_SIZE];
-  mbedtls_sha1_ret(reinterpret_cast<u8*>(hashes.h2), sizeof(hashes.h2), h3_hash);
-  if (memcmp(h3_hash, partition_details.h3_table->data() + block_index / 64 * SHA1_SIZE, SHA1_SIZE))
+  const auto h3_hash = Common::SHA1::CalculateDigest(&hashes.h2[0][0], sizeof(hashes.h2));
+  if (memcmp(h3_hash.data(), partition_details.h3_table->data() + block_index / 64 * SHA1_SIZE,
+             SHA1_SIZE))
+  {
     return false;
+  }
 
   return true;
 }
@@ -475,7 +466,7 @@ bool VolumeWii::CheckBlockIntegrity(u64 block_index, const Partition& partition)
   std::vector<u8> cluster(BLOCK_TOTAL_SIZE);
   if (!m_reader->Read(cluster_offset, cluster.size(), cluster.data()))
     return false;
-  return CheckBlockIntegrity(block_index, cluster, partition);
+  return CheckBlockIntegrity(block_index, cluster.data(), partition);
 }
 
 bool VolumeWii::HashGroup(const std::array<u8, BLOCK_DATA_SIZE> in[BLOCKS_PER_GROUP],
@@ -496,15 +487,14 @@ bool VolumeWii::HashGroup(const std::array<u8, BLOCK_DATA_SIZE> in[BLOCKS_PER_GR
       if (success)
       {
         // H0 hashes
-        for (size_t j = 0; j < 31; ++j)
-          mbedtls_sha1_ret(in[i].data() + j * 0x400, 0x400, out[i].h0[j]);
+        Common::SHA1::CalculateDigests(in[i].data(), 0x400, 31, &out[i].h0[0][0]);
 
         // H0 padding
         std::memset(out[i].padding_0, 0, sizeof(HashBlock::padding_0));
 
         // H1 hash
-        mbedtls_sha1_ret(reinterpret_cast<u8*>(out[i].h0), sizeof(HashBlock::h0),
-                         out[h1_base].h1[i - h1_base]);
+        const auto h1_hash = Common::SHA1::CalculateDigest(&out[i].h0[0][0], sizeof(HashBlock::h0));
+        std::memcpy(out[h1_base].h1[i - h1_base], h1_hash.data(), SHA1_SIZE);
       }
 
       if (i % 8 == 7)
@@ -522,8 +512,9 @@ bool VolumeWii::HashGroup(const std::array<u8, BLOCK_DATA_SIZE> in[BLOCKS_PER_GR
             std::memcpy(out[h1_base + j].h1, out[h1_base].h1, sizeof(HashBlock::h1));
 
           // H2 hash
-          mbedtls_sha1_ret(reinterpret_cast<u8*>(out[i].h1), sizeof(HashBlock::h1),
-                           out[0].h2[h1_base / 8]);
+          const auto h2_hash =
+              Common::SHA1::CalculateDigest(&out[i].h1[0][0], sizeof(HashBlock::h1));
+          std::memcpy(out[0].h2[h1_base / 8], h2_hash.data(), SHA1_SIZE);
         }
 
         if (i == BLOCKS_PER_GROUP - 1)
@@ -583,55 +574,52 @@ bool VolumeWii::EncryptGroup(
   if (hash_exception_callback)
     hash_exception_callback(unencrypted_hashes.data());
 
-  const unsigned int threads =
-      std::min(BLOCKS_PER_GROUP, std::max<unsigned int>(1, std::thread::hardware_concurrency()));
+  Common::ThreadPool& pool = Common::ThreadPool::GetShared();
+  const u32 threads = std::min<u32>(BLOCKS_PER_GROUP, pool.GetNumThreads());
 
-  std::vector<std::future<void>> encryption_futures(threads);
+  const std::unique_ptr<Common::AES::Context> aes_context =
+      Common::AES::CreateContextEncrypt(key.data());
 
-  mbedtls_aes_context aes_context;
-  mbedtls_aes_setkey_enc(&aes_context, key.data(), 128);
-
-  for (size_t i = 0; i < threads; ++i)
-  {
-    encryption_futures[i] = std::async(
-        std::launch::async,
-        [&unencrypted_data, &unencrypted_hashes, &aes_context, &out](size_t start, size_t end) {
-          for (size_t j = start; j < end; ++j)
-          {
-            u8* out_ptr = out->data() + j * BLOCK_TOTAL_SIZE;
+  pool.ParallelFor(
+      threads, [&unencrypted_data, &unencrypted_hashes, &aes_context, &out, threads](u32 i) {
+        const size_t start = i * BLOCKS_PER_GROUP / threads;
+        const size_t end = (i + 1) * BLOCKS_PER_GROUP / threads;
 
-            u8 iv[16] = {};
-            mbedtls_aes_crypt_cbc(&aes_context, MBEDTLS_AES_ENCRYPT, BLOCK_HEADER_SIZE, iv,
-                                  reinterpret_cast<u8*>(&unencrypted_hashes[j]), out_ptr);
+        // The blocks are independent CBC streams, so they are handed over together and can be
+        // interleaved. The IV of a block's data is taken from its encrypted hashes, so all the
+        // hashes are encrypted first.
+        static constexpr std::array<u8, Common::AES::BLOCK_SIZE> zero_iv{};
+        std::vector<Common::AES::CryptJob> jobs(end - start);
 
-            std::memcpy(iv, out_ptr + 0x3D0, sizeof(iv));
-            mbedtls_aes_crypt_cbc(&aes_context, MBEDTLS_AES_ENCRYPT, BLOCK_DATA_SIZE, iv,
-                                  unencrypted_data[j].data(), out_ptr + BLOCK_HEADER_SIZE);
-          }
-        },
-        i * BLOCKS_PER_GROUP / threads, (i + 1) * BLOCKS_PER_GROUP / threads);
-  }
+        for (size_t j = start; j < end; ++j)
+        {
+          jobs[j - start] = {zero_iv.data(), reinterpret_cast<u8*>(&unencrypted_hashes[j]),
+                             out->data() + j * BLOCK_TOTAL_SIZE, BLOCK_HEADER_SIZE};
+        }
+        aes_context->CryptMultiple(jobs.data(), jobs.size());
 
-  for (std::future<void>& future : encryption_futures)
-    future.get();
+        for (size_t j = start; j < end; ++j)
+        {
+          u8* out_ptr = out->data() + j * BLOCK_TOTAL_SIZE;
+          jobs[j - start] = {out_ptr + 0x3D0, unencrypted_data[j].data(),
+                             out_ptr + BLOCK_HEADER_SIZE, BLOCK_DATA_SIZE};
+        }
+        aes_context->CryptMultiple(jobs.data(), jobs.size());
+      });
 
   return true;
 }
 
-void VolumeWii::DecryptBlockHashes(const u8* in, HashBlock* out, mbedtls_aes_context* aes_context)
+void VolumeWii::DecryptBlockHashes(const u8* in, HashBlock* out, Common::AES::Context* aes_context)
 {
   std::array<u8, 16> iv;
   iv.fill(0);
-  mbedtls_aes_crypt_cbc(aes_context, MBEDTLS_AES_DECRYPT, sizeof(HashBlock), iv.data(), in,
-                        reinterpret_cast<u8*>(out));
+  aes_context->Crypt(iv.data(), nullptr, in, reinterpret_cast<u8*>(out), sizeof(HashBlock));
 }
 
-void VolumeWii::DecryptBlockData(const u8* in, u8* out, mbedtls_aes_context* aes_context)
+void VolumeWii::DecryptBlockData(const u8* in, u8* out, Common::AES::Context* aes_context)
 {
-  std::array<u8, 16> iv;
-  std::copy(&in[0x3d0], &in[0x3e0], iv.data());
-  mbedtls_aes_crypt_cbc(aes_context, MBEDTLS_AES_DECRYPT, BLOCK_DATA_SIZE, iv.data(),
-                        &in[BLOCK_HEADER_SIZE], out);
+  aes_context->Crypt(&in[0x3d0], nullptr, &in[BLOCK_HEADER_SIZE], out, BLOCK_DATA_SIZE);
 }
 
 }  // namespace DiscIO
@@ -6,12 +6,16 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <thread>
 #include <type_traits>
 #include <utility>
 
@@ -22,12 +26,15 @@
 #include "Common/Align.h"
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/ScopeGuard.h"
 #include "Common/Swap.h"
+#include "Common/Thread.h"
+#include "Common/ThreadPool.h"
 
 #include "DiscIO/Blob.h"
 #include "DiscIO/DiscExtractor.h"
@@ -507,6 +514,30 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
     const u64 group_offset_in_data = i * chunk_size;
     const u64 offset_in_group = *offset - group_offset_in_data - data_offset;
 
+    // When the read covers several whole groups, they can be decompressed independently.
+    if (offset_in_group == 0 && !m_write_to_exception_list)
+    {
+      const u64 whole_groups = std::min({*size / chunk_size, number_of_groups - i,
+                                         (data_size - group_offset_in_data) / chunk_size,
+                                         static_cast<u64>(m_group_entries.size()) -
+                                             total_group_index});
+      if (whole_groups >= 2)
+      {
+        if (!ReadGroupsInParallel(total_group_index, group_offset_in_data, whole_groups,
+                                  chunk_size, exception_lists, *out_ptr))
+        {
+          return false;
+        }
+
+        const u64 bytes_read = whole_groups * chunk_size;
+        *offset += bytes_read;
+        *size -= bytes_read;
+        *out_ptr += bytes_read;
+        i += whole_groups - 1;
+        continue;
+      }
+    }
+
     chunk_size = std::min(chunk_size, data_size - group_offset_in_data);
 
     const u64 bytes_to_read = std::min(chunk_size - offset_in_group, *size);
@@ -561,6 +592,76 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
   return true;
 }
 
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::ReadGroupsInParallel(u64 first_group_index,
+                                                 u64 first_group_offset_in_data,
+                                                 u64 number_of_groups, u64 chunk_size,
+                                                 u32 exception_lists, u8* out_ptr)
+{
+  struct PendingGroup
+  {
+    std::vector<u8> compressed_data;
+    WIARVZCompressionType compression_type;
+    u32 rvz_packed_size;
+    u64 group_offset_in_data;
+    u8* out_ptr;
+  };
+
+  // Reading the file is left to this thread, so that the accesses stay sequential.
+  std::vector<PendingGroup> pending_groups;
+  for (u64 i = 0; i < number_of_groups; ++i)
+  {
+    const GroupEntry group = m_group_entries[first_group_index + i];
+    u8* group_out_ptr = out_ptr + i * chunk_size;
+    u32 group_data_size = Common::swap32(group.data_size);
+
+    WIARVZCompressionType compression_type = m_compression_type;
+    u32 rvz_packed_size = 0;
+    if constexpr (RVZ)
+    {
+      if ((group_data_size & 0x80000000) == 0)
+        compression_type = WIARVZCompressionType::None;
+
+      group_data_size &= 0x7FFFFFFF;
+
+      rvz_packed_size = Common::swap32(group.rvz_packed_size);
+    }
+
+    if (group_data_size == 0)
+    {
+      std::memset(group_out_ptr, 0, chunk_size);
+      continue;
+    }
+
+    std::vector<u8> compressed_data(group_data_size);
+    const u64 group_offset_in_file = static_cast<u64>(Common::swap32(group.data_offset)) << 2;
+    if (!m_file.Seek(group_offset_in_file, SEEK_SET) ||
+        !m_file.ReadBytes(compressed_data.data(), compressed_data.size()))
+    {
+      return false;
+    }
+
+    pending_groups.push_back({std::move(compressed_data), compression_type, rvz_packed_size,
+                              first_group_offset_in_data + i * chunk_size, group_out_ptr});
+  }
+
+  // The calling thread decompresses groups too.
+  std::atomic<bool> success{true};
+  Common::ThreadPool::GetShared().ParallelFor(
+      static_cast<u32>(pending_groups.size()), [&](u32 i) {
+        PendingGroup& group = pending_groups[i];
+        const bool compressed_exception_lists =
+            group.compression_type > WIARVZCompressionType::Purge;
+        Chunk chunk(std::move(group.compressed_data), chunk_size, exception_lists,
+                    compressed_exception_lists, group.rvz_packed_size, group.group_offset_in_data,
+                    CreateDecompressor(group.compression_type, chunk_size, group.rvz_packed_size));
+        if (!chunk.Read(0, chunk_size, group.out_ptr))
+          success = false;
+      });
+
+  return success;
+}
+
 template <bool RVZ>
 typename WIARVZFileReader<RVZ>::Chunk&
 WIARVZFileReader<RVZ>::ReadCompressedData(u64 offset_in_file, u64 compressed_size,
@@ -571,6 +672,21 @@ WIARVZFileReader<RVZ>::ReadCompressedData(u64 offset_in_file, u64 compressed_siz
   if (offset_in_file == m_cached_chunk_offset)
     return m_cached_chunk;
 
+  const bool compressed_exception_lists = compression_type > WIARVZCompressionType::Purge;
+
+  m_cached_chunk =
+      Chunk(&m_file, offset_in_file, compressed_size, decompressed_size, exception_lists,
+            compressed_exception_lists, rvz_packed_size, data_offset,
+            CreateDecompressor(compression_type, decompressed_size, rvz_packed_size));
+  m_cached_chunk_offset = offset_in_file;
+  return m_cached_chunk;
+}
+
+template <bool RVZ>
+std::unique_ptr<Decompressor>
+WIARVZFileReader<RVZ>::CreateDecompressor(WIARVZCompressionType compression_type,
+                                          u64 decompressed_size, u32 rvz_packed_size) const
+{
   std::unique_ptr<Decompressor> decompressor;
   switch (compression_type)
   {
@@ -597,13 +713,7 @@ WIARVZFileReader<RVZ>::ReadCompressedData(u64 offset_in_file, u64 compressed_siz
     break;
   }
 
-  const bool compressed_exception_lists = compression_type > WIARVZCompressionType::Purge;
-
-  m_cached_chunk =
-      Chunk(&m_file, offset_in_file, compressed_size, decompressed_size, exception_lists,
-            compressed_exception_lists, rvz_packed_size, data_offset, std::move(decompressor));
-  m_cached_chunk_offset = offset_in_file;
-  return m_cached_chunk;
+  return decompressor;
 }
 
 template <bool RVZ>
@@ -644,10 +754,22 @@ WIARVZFileReader<RVZ>::Chunk::Chunk(File::IOFile* file, u64 offset_in_file, u64
   m_out.data.resize(decompressed_size + m_out_bytes_allocated_for_exceptions);
 }
 
+template <bool RVZ>
+WIARVZFileReader<RVZ>::Chunk::Chunk(std::vector<u8> compressed_data, u64 decompressed_size,
+                                    u32 exception_lists, bool compressed_exception_lists,
+                                    u32 rvz_packed_size, u64 data_offset,
+                                    std::unique_ptr<Decompressor> decompressor)
+    : Chunk(nullptr, 0, compressed_data.size(), decompressed_size, exception_lists,
+            compressed_exception_lists, rvz_packed_size, data_offset, std::move(decompressor))
+{
+  m_in.data = std::move(compressed_data);
+}
+
 template <bool RVZ>
 bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
 {
-  if (!m_decompressor || !m_file ||
+  // Without a file, all of the compressed data was passed to the constructor.
+  if (!m_decompressor || (!m_file && m_in.data.empty()) ||
       offset + size > m_out.data.size() - m_out_bytes_allocated_for_exceptions)
   {
     return false;
@@ -656,7 +778,7 @@ bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
   while (offset + size > m_out.bytes_written - m_out_bytes_used_for_exceptions)
   {
     u64 bytes_to_read;
-    if (offset + size == m_out.data.size())
+    if (offset + size == m_out.data.size() || !m_file)
     {
       // Read all the remaining data.
       bytes_to_read = m_in.data.size() - m_in.bytes_written;
@@ -687,10 +809,13 @@ bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
       return false;
     }
 
-    if (!m_file->Seek(m_offset_in_file, SEEK_SET))
-      return false;
-    if (!m_file->ReadBytes(m_in.data.data() + m_in.bytes_written, bytes_to_read))
-      return false;
+    if (m_file)
+    {
+      if (!m_file->Seek(m_offset_in_file, SEEK_SET))
+        return false;
+      if (!m_file->ReadBytes(m_in.data.data() + m_in.bytes_written, bytes_to_read))
+        return false;
+    }
 
     m_offset_in_file += bytes_to_read;
     m_in.bytes_written += bytes_to_read;
@@ -1315,8 +1440,8 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
   {
     const PartitionEntry& partition_entry = partition_entries[parameters.data_entry->index];
 
-    mbedtls_aes_context aes_context;
-    mbedtls_aes_setkey_dec(&aes_context, partition_entry.partition_key.data(), 128);
+    const std::unique_ptr<Common::AES::Context> aes_context =
+        Common::AES::CreateContextDecrypt(partition_entry.partition_key.data());
 
     const u64 groups = Common::AlignUp(parameters.data.size(), VolumeWii::GROUP_TOTAL_SIZE) /
                        VolumeWii::GROUP_TOTAL_SIZE;
@@ -1385,7 +1510,7 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
           {
             const u64 offset_of_block = offset_of_group + j * VolumeWii::BLOCK_TOTAL_SIZE;
             VolumeWii::DecryptBlockData(parameters.data.data() + offset_of_block,
-                                        state->decryption_buffer[j].data(), &aes_context);
+                                        state->decryption_buffer[j].data(), aes_context.get());
           }
           else
           {
@@ -1410,7 +1535,7 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
 
           VolumeWii::HashBlock hashes;
           VolumeWii::DecryptBlockHashes(parameters.data.data() + offset_of_block, &hashes,
-                                        &aes_context);
+                                        aes_context.get());
 
           const auto compare_hash = [&](size_t offset_in_block) {
             ASSERT(offset_in_block + sizeof(SHA1) <= VolumeWii::BLOCK_HEADER_SIZE);
@@ -1723,6 +1848,108 @@ bool WIARVZFileReader<RVZ>::WriteHeader(File::IOFile* file, const u8* data, size
   return PadTo4(file, bytes_written);
 }
 
+// Reads a BlobReader from start to end on a separate thread, so that the conversion thread
+// doesn't have to wait for the input file when it hands data to the compression threads.
+// All reads must be done in order and must not skip any data.
+class ConversionReadAhead
+{
+public:
+  ConversionReadAhead(BlobReader* infile, u64 size)
+      : m_infile(infile), m_size(size), m_thread(&ConversionReadAhead::ReadThread, this)
+  {
+  }
+
+  ~ConversionReadAhead()
+  {
+    {
+      std::lock_guard lk(m_mutex);
+      m_exiting = true;
+    }
+    m_block_consumed.notify_one();
+    m_thread.join();
+  }
+
+  bool Read(u64 offset, u64 size, u8* out_ptr)
+  {
+    if (offset != m_position)
+      return false;
+
+    std::unique_lock lk(m_mutex);
+    while (size > 0)
+    {
+      m_block_read.wait(lk, [this] { return m_failed || !m_blocks.empty(); });
+      if (m_blocks.empty())
+        return false;
+
+      std::vector<u8>& block = m_blocks.front();
+      const u64 bytes_to_copy = std::min<u64>(size, block.size() - m_offset_in_block);
+      std::copy_n(block.begin() + m_offset_in_block, bytes_to_copy, out_ptr);
+      m_offset_in_block += bytes_to_copy;
+      m_position += bytes_to_copy;
+      out_ptr += bytes_to_copy;
+      size -= bytes_to_copy;
+
+      if (m_offset_in_block == block.size())
+      {
+        m_blocks.pop_front();
+        m_offset_in_block = 0;
+        m_block_consumed.notify_one();
+      }
+    }
+
+    return true;
+  }
+
+private:
+  static constexpr u64 BLOCK_SIZE = VolumeWii::GROUP_TOTAL_SIZE;
+  static constexpr size_t MAX_BLOCKS = 8;
+
+  void ReadThread()
+  {
+    Common::SetCurrentThreadName("Conversion read thread");
+
+    for (u64 offset = 0; offset < m_size; offset += BLOCK_SIZE)
+    {
+      {
+        std::unique_lock lk(m_mutex);
+        m_block_consumed.wait(lk, [this] { return m_exiting || m_blocks.size() < MAX_BLOCKS; });
+        if (m_exiting)
+          return;
+      }
+
+      std::vector<u8> block(std::min(BLOCK_SIZE, m_size - offset));
+      const bool success = m_infile->Read(offset, block.size(), block.data());
+
+      std::lock_guard lk(m_mutex);
+      if (!success)
+      {
+        m_failed = true;
+        m_block_read.notify_one();
+        return;
+      }
+      m_blocks.push_back(std::move(block));
+      m_block_read.notify_one();
+    }
+  }
+
+  BlobReader* m_infile;
+  u64 m_size;
+
+  // Only accessed by the conversion thread.
+  u64 m_position = 0;
+  u64 m_offset_in_block = 0;
+
+  // Guards everything below.
+  std::mutex m_mutex;
+  std::condition_variable m_block_read;
+  std::condition_variable m_block_consumed;
+  std::deque<std::vector<u8>> m_blocks;
+  bool m_failed = false;
+  bool m_exiting = false;
+
+  std::thread m_thread;
+};
+
 template <bool RVZ>
 ConversionResultCode
 WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volume,
@@ -1835,6 +2062,8 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
   MultithreadedCompressor<CompressThreadState, CompressParameters, OutputParameters> mt_compressor(
       set_up_compress_thread_state, process_and_compress, output);
 
+  ConversionReadAhead read_ahead(infile, iso_size);
+
   for (const DataEntry& data_entry : data_entries)
   {
     u32 first_group;
@@ -1894,13 +2123,13 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
         bytes_to_read = std::max<u64>(bytes_to_read, VolumeWii::GROUP_TOTAL_SIZE);
       bytes_to_read = std::min<u64>(bytes_to_read, data_offset + data_size - bytes_read);
 
-      buffer.resize(bytes_to_read);
-      if (!infile->Read(bytes_read, bytes_to_read, buffer.data()))
+      std::vector<u8> data(bytes_to_read);
+      if (!read_ahead.Read(bytes_read, bytes_to_read, data.data()))
         return ConversionResultCode::ReadFailed;
       bytes_read += bytes_to_read;
 
       mt_compressor.CompressAndWrite(CompressParameters{
-          buffer, &data_entry, data_offset_in_partition, bytes_read, groups_processed});
+          std::move(data), &data_entry, data_offset_in_partition, bytes_read, groups_processed});
 
       data_offset += bytes_to_read;
       data_size -= bytes_to_read;
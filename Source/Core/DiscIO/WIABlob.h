@@ -184,6 +184,10 @@ private:
     Chunk(File::IOFile* file, u64 offset_in_file, u64 compressed_size, u64 decompressed_size,
           u32 exception_lists, bool compressed_exception_lists, u32 rvz_packed_size,
           u64 data_offset, std::unique_ptr<Decompressor> decompressor);
+    // For compressed data which has already been read from the file.
+    Chunk(std::vector<u8> compressed_data, u64 decompressed_size, u32 exception_lists,
+          bool compressed_exception_lists, u32 rvz_packed_size, u64 data_offset,
+          std::unique_ptr<Decompressor> decompressor);
 
     bool Read(u64 offset, u64 size, u8* out_ptr);
 
@@ -228,9 +232,15 @@ private:
   bool ReadFromGroups(u64* offset, u64* size, u8** out_ptr, u64 chunk_size, u32 sector_size,
                       u64 data_offset, u64 data_size, u32 group_index, u32 number_of_groups,
                       u32 exception_lists);
+  bool ReadGroupsInParallel(u64 first_group_index, u64 first_group_offset_in_data,
+                            u64 number_of_groups, u64 chunk_size, u32 exception_lists,
+                            u8* out_ptr);
   Chunk& ReadCompressedData(u64 offset_in_file, u64 compressed_size, u64 decompressed_size,
                             WIARVZCompressionType compression_type, u32 exception_lists = 0,
                             u32 rvz_packed_size = 0, u64 data_offset = 0);
+  std::unique_ptr<Decompressor> CreateDecompressor(WIARVZCompressionType compression_type,
+                                                   u64 decompressed_size,
+                                                   u32 rvz_packed_size) const;
 
   static bool ApplyHashExceptions(const std::vector<HashExceptionEntry>& exception_list,
                                   VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP]);
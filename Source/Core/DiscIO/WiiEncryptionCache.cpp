@@ -4,42 +4,114 @@
 
 #include "DiscIO/WiiEncryptionCache.h"
 
+#include <algorithm>
 #include <array>
 #include <cstring>
+#include <functional>
+#include <future>
 #include <limits>
 #include <memory>
+#include <utility>
 
 #include "Common/Align.h"
+#include "Common/Assert.h"
 #include "Common/CommonTypes.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/VolumeWii.h"
 
 namespace DiscIO
 {
-WiiEncryptionCache::WiiEncryptionCache(BlobReader* blob) : m_blob(blob)
+WiiEncryptionCache::WiiEncryptionCache(BlobReader* blob, size_t max_groups, bool encrypt_ahead)
+    : m_blob(blob), m_max_groups(std::max<size_t>(max_groups, 1)), m_encrypt_ahead(encrypt_ahead)
 {
 }
 
-WiiEncryptionCache::~WiiEncryptionCache() = default;
+WiiEncryptionCache::~WiiEncryptionCache()
+{
+  if (m_ahead_future.valid())
+    m_ahead_future.wait();
+}
+
+WiiEncryptionCache::CacheEntry* WiiEncryptionCache::FindEntry(u64 offset_on_disc)
+{
+  const auto it = std::find_if(m_cache.begin(), m_cache.end(), [offset_on_disc](const auto& e) {
+    return e.offset_on_disc == offset_on_disc;
+  });
+  return it == m_cache.end() ? nullptr : &*it;
+}
+
+WiiEncryptionCache::CacheEntry* WiiEncryptionCache::GetEntryToReplace()
+{
+  // Only allocate memory for as many groups as actually end up getting used
+  if (m_cache.size() < m_max_groups)
+  {
+    CacheEntry& entry = m_cache.emplace_back();
+    entry.data = std::make_unique<Group>();
+    return &entry;
+  }
+
+  return &*std::min_element(m_cache.begin(), m_cache.end(), [](const auto& a, const auto& b) {
+    return a.last_used < b.last_used;
+  });
+}
+
+void WiiEncryptionCache::FinishEncryptingAhead()
+{
+  if (!m_ahead_future.valid())
+    return;
+
+  const bool success = m_ahead_future.get();
+  if (!success || FindEntry(m_ahead_entry.offset_on_disc))
+    return;
+
+  // Swap the buffers so that the replaced entry's buffer can be reused for the next group
+  CacheEntry* entry = GetEntryToReplace();
+  std::swap(entry->data, m_ahead_entry.data);
+  entry->offset_on_disc = m_ahead_entry.offset_on_disc;
+  entry->last_used = ++m_use_counter;
+}
+
+void WiiEncryptionCache::StartEncryptingAhead(u64 offset, u64 partition_data_offset,
+                                              u64 partition_data_decrypted_size, const Key& key)
+{
+  const u64 group_offset_in_partition =
+      offset / VolumeWii::GROUP_TOTAL_SIZE * VolumeWii::GROUP_DATA_SIZE;
+  const u64 group_offset_on_disc = partition_data_offset + offset;
+
+  if (group_offset_in_partition >= partition_data_decrypted_size ||
+      FindEntry(group_offset_on_disc))
+  {
+    return;
+  }
+
+  if (!m_ahead_entry.data)
+    m_ahead_entry.data = std::make_unique<Group>();
+  m_ahead_entry.offset_on_disc = group_offset_on_disc;
+
+  // Only values are captured, so that this object can be moved while the task is running
+  m_ahead_future =
+      std::async(std::launch::async, [group_offset_in_partition, partition_data_offset,
+                                      partition_data_decrypted_size, key, blob = m_blob,
+                                      out = m_ahead_entry.data.get()] {
+        return VolumeWii::EncryptGroup(group_offset_in_partition, partition_data_offset,
+                                       partition_data_decrypted_size, key, blob, out);
+      });
+}
 
 const std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>*
 WiiEncryptionCache::EncryptGroup(u64 offset, u64 partition_data_offset,
                                  u64 partition_data_decrypted_size, const Key& key,
                                  const HashExceptionCallback& hash_exception_callback)
 {
-  // Only allocate memory if this function actually ends up getting called
-  if (!m_cache)
-  {
-    m_cache = std::make_unique<std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>>();
-    m_cached_offset = std::numeric_limits<u64>::max();
-  }
+  FinishEncryptingAhead();
 
   ASSERT(offset % VolumeWii::GROUP_TOTAL_SIZE == 0);
   const u64 group_offset_in_partition =
       offset / VolumeWii::GROUP_TOTAL_SIZE * VolumeWii::GROUP_DATA_SIZE;
   const u64 group_offset_on_disc = partition_data_offset + offset;
 
-  if (m_cached_offset != group_offset_on_disc)
+  CacheEntry* entry = FindEntry(group_offset_on_disc);
+  if (!entry)
   {
     std::function<void(VolumeWii::HashBlock * hash_blocks)> hash_exception_callback_2;
 
@@ -52,18 +124,29 @@ WiiEncryptionCache::EncryptGroup(u64 offset, u64 partition_data_offset,
           };
     }
 
+    entry = GetEntryToReplace();
     if (!VolumeWii::EncryptGroup(group_offset_in_partition, partition_data_offset,
-                                 partition_data_decrypted_size, key, m_blob, m_cache.get(),
+                                 partition_data_decrypted_size, key, m_blob, entry->data.get(),
                                  hash_exception_callback_2))
     {
-      m_cached_offset = std::numeric_limits<u64>::max();  // Invalidate the cache
+      entry->offset_on_disc = std::numeric_limits<u64>::max();  // Invalidate the entry
+      entry->last_used = 0;
       return nullptr;
     }
 
-    m_cached_offset = group_offset_on_disc;
+    entry->offset_on_disc = group_offset_on_disc;
+
+    // Hash exceptions are supplied by the caller for each call, so groups which need them
+    // can't be encrypted ahead of time
+    if (m_encrypt_ahead && !hash_exception_callback)
+    {
+      StartEncryptingAhead(offset + VolumeWii::GROUP_TOTAL_SIZE, partition_data_offset,
+                           partition_data_decrypted_size, key);
+    }
   }
 
-  return m_cache.get();
+  entry->last_used = ++m_use_counter;
+  return entry->data.get();
 }
 
 bool WiiEncryptionCache::EncryptGroups(u64 offset, u64 size, u8* out_ptr, u64 partition_data_offset,
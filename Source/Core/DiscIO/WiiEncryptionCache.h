@@ -5,8 +5,11 @@
 #pragma once
 
 #include <array>
+#include <functional>
+#include <future>
 #include <limits>
 #include <memory>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "DiscIO/VolumeWii.h"
@@ -22,8 +25,15 @@ public:
   using HashExceptionCallback = std::function<void(
       VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP], u64 offset)>;
 
+  static constexpr size_t DEFAULT_MAX_GROUPS = 4;
+
   // The blob pointer is kept around for the lifetime of this object.
-  explicit WiiEncryptionCache(BlobReader* blob);
+  // Up to max_groups groups are kept, and the least recently used one is evicted first.
+  // If encrypt_ahead is true, the group after a group that had to be encrypted is encrypted
+  // on another thread while the caller carries on. This calls ReadWiiDecrypted concurrently
+  // with the caller, so it must only be used for blobs where that is safe.
+  explicit WiiEncryptionCache(BlobReader* blob, size_t max_groups = DEFAULT_MAX_GROUPS,
+                              bool encrypt_ahead = false);
   ~WiiEncryptionCache();
 
   WiiEncryptionCache(WiiEncryptionCache&&) = default;
@@ -38,6 +48,7 @@ public:
   // If the returned pointer is nullptr, reading from the blob failed.
   // If the returned pointer is not nullptr, it is guaranteed to be valid until
   // the next call of this function or the destruction of this object.
+  // hash_exception_callback is only called for groups that are encrypted by this call.
   const std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>*
   EncryptGroup(u64 offset, u64 partition_data_offset, u64 partition_data_decrypted_size,
                const Key& key, const HashExceptionCallback& hash_exception_callback = {});
@@ -49,9 +60,31 @@ public:
                      const HashExceptionCallback& hash_exception_callback = {});
 
 private:
+  using Group = std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>;
+
+  struct CacheEntry
+  {
+    std::unique_ptr<Group> data;
+    u64 offset_on_disc = std::numeric_limits<u64>::max();
+    u64 last_used = 0;
+  };
+
+  CacheEntry* FindEntry(u64 offset_on_disc);
+  CacheEntry* GetEntryToReplace();
+  void FinishEncryptingAhead();
+  void StartEncryptingAhead(u64 offset, u64 partition_data_offset,
+                            u64 partition_data_decrypted_size, const Key& key);
+
   BlobReader* m_blob;
-  std::unique_ptr<std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>> m_cache;
-  u64 m_cached_offset;
+  size_t m_max_groups;
+  bool m_encrypt_ahead;
+
+  std::vector<CacheEntry> m_cache;
+  u64 m_use_counter = 0;
+
+  // The group which is being encrypted ahead of time, if any
+  std::future<bool> m_ahead_future;
+  CacheEntry m_ahead_entry;
 };
 
 }  // namespace DiscIO
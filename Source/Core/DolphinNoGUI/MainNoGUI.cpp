@@ -5,23 +5,43 @@
 #include "DolphinNoGUI/Platform.h"
 
 #include <OptionParser.h>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdio>
 #include <cstring>
+#include <memory>
 #include <signal.h>
 #include <string>
+#include <vector>
 #ifndef _WIN32
 #include <unistd.h>
 #else
 #include <Windows.h>
 #endif
 
+#include <fmt/format.h>
+#include <picojson.h>
+#include <xxhash.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Image.h"
+#include "Common/MemoryUtil.h"
 #include "Common/StringUtil.h"
 #include "Core/Boot/Boot.h"
 #include "Core/BootManager.h"
+#include "Core/Config/GraphicsSettings.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/DolphinAnalytics.h"
+#include "Core/FifoPlayer/FifoPlayer.h"
 #include "Core/Host.h"
+#include "Core/Movie.h"
+#include "Core/PowerPC/JitInterface.h"
 
 #include "UICommon/CommandLineParse.h"
 #ifdef USE_DISCORD_PRESENCE
@@ -29,10 +49,15 @@
 #endif
 #include "UICommon/UICommon.h"
 
+#include "VideoCommon/PipelineUIDBundle.h"
 #include "VideoCommon/RenderBase.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VideoBackendBase.h"
+#include "VideoCommon/VideoConfig.h"
 
 static std::unique_ptr<Platform> s_platform;
+static std::string s_game_id;
+static std::atomic<bool> s_interrupted{false};
 
 static void signal_handler(int)
 {
@@ -45,6 +70,7 @@ static void signal_handler(int)
   }
 #endif
 
+  s_interrupted.store(true);
   s_platform->RequestShutdown();
 }
 
@@ -106,10 +132,209 @@ void Host_TitleChanged()
 #endif
 }
 
+// Writes a hash of every frame that is output to the given file, so that the output of a movie
+// can be compared between builds, and dumps every dump_interval-th frame to a PNG.
+static bool StartFrameHashing(const std::string& path, int dump_interval)
+{
+  auto file = std::make_shared<File::IOFile>(path, "w");
+  if (!file->IsOpen())
+    return false;
+
+  const std::string dump_path = File::GetUserPath(D_DUMPFRAMES_IDX);
+  if (dump_interval > 0)
+    File::CreateFullPath(dump_path);
+
+  Renderer::SetFrameCallback([file, dump_interval, dump_path](const FrameDump::FrameData& frame) {
+    // Only the visible part of each row, since the padding up to the stride is undefined
+    std::unique_ptr<XXH64_state_t, decltype(&XXH64_freeState)> state(XXH64_createState(),
+                                                                      XXH64_freeState);
+    XXH64_reset(state.get(), 0);
+    for (int y = 0; y < frame.height; ++y)
+    {
+      XXH64_update(state.get(), frame.data + static_cast<size_t>(y) * frame.stride,
+                   static_cast<size_t>(frame.width) * 4);
+    }
+
+    const int frame_number = frame.state.frame_number;
+    const std::string line = fmt::format("{} {}x{} {:016x}\n", frame_number, frame.width,
+                                         frame.height, XXH64_digest(state.get()));
+    file->WriteString(line);
+
+    if (dump_interval > 0 && frame_number % dump_interval == 0)
+    {
+      Common::ConvertRGBAToRGBAndSavePNG(fmt::format("{}frame_{}.png", dump_path, frame_number),
+                                         frame.data, frame.width, frame.height, frame.stride);
+    }
+  });
+  return true;
+}
+
+struct SuiteResult
+{
+  std::string path;
+  bool completed = false;
+  double boot_seconds = 0.0;
+  double run_seconds = 0.0;
+  u64 frames = 0;
+  u64 jit_compiles = 0;
+  double jit_compile_seconds = 0.0;
+  int shaders_compiled = 0;
+  size_t peak_rss = 0;
+};
+
+// Runs one entry of the suite, and measures from the first emulated field on, so that booting
+// isn't included in the frame rate.
+static SuiteResult RunSuiteEntry(const std::string& path, double seconds)
+{
+  using Clock = std::chrono::steady_clock;
+
+  SuiteResult result;
+  result.path = path;
+
+  const Clock::time_point boot_start = Clock::now();
+  Clock::time_point run_start;
+  u64 start_frames = 0;
+  Core::SetEmulatedTimeLimit(0.0, [&, seconds] {
+    run_start = Clock::now();
+    result.boot_seconds = std::chrono::duration<double>(run_start - boot_start).count();
+    start_frames = Core::GetPresentedFrameCount();
+
+    Core::SetEmulatedTimeLimit(seconds, [&] {
+      result.completed = true;
+      result.run_seconds = std::chrono::duration<double>(Clock::now() - run_start).count();
+      result.frames = Core::GetPresentedFrameCount() - start_frames;
+      const JitInterface::CompileStats jit_stats = JitInterface::GetCompileStats();
+      result.jit_compiles = jit_stats.count;
+      result.jit_compile_seconds = jit_stats.seconds;
+      result.shaders_compiled =
+          g_stats.num_vertex_shaders_created + g_stats.num_pixel_shaders_created;
+      s_platform->Stop();
+    });
+  });
+
+  if (BootManager::BootCore(BootParameters::GenerateFromFile(path),
+                            s_platform->GetWindowSystemInfo()))
+  {
+    s_platform->MainLoop();
+    Core::Stop();
+    Core::Shutdown();
+  }
+  else
+  {
+    fprintf(stderr, "Could not boot %s\n", path.c_str());
+  }
+
+  Core::SetEmulatedTimeLimit(0.0, nullptr);
+  s_platform->ResetRunningFlag();
+
+  // For the whole process, so only comparable between runs of the same list
+  result.peak_rss = Common::MemPeakResident();
+  return result;
+}
+
+static picojson::value SuiteResultToJSON(const SuiteResult& result, double seconds)
+{
+  picojson::object object;
+  object.emplace("path", picojson::value(result.path));
+  object.emplace("completed", picojson::value(result.completed));
+  object.emplace("boot_seconds", picojson::value(result.boot_seconds));
+  object.emplace("run_seconds", picojson::value(result.run_seconds));
+  object.emplace("frames", picojson::value(static_cast<double>(result.frames)));
+  if (result.completed && result.run_seconds > 0.0)
+  {
+    object.emplace("fps", picojson::value(result.frames / result.run_seconds));
+    object.emplace("speed", picojson::value(seconds / result.run_seconds));
+  }
+  object.emplace("jit_compiles", picojson::value(static_cast<double>(result.jit_compiles)));
+  object.emplace("jit_compile_seconds", picojson::value(result.jit_compile_seconds));
+  object.emplace("shaders_compiled", picojson::value(static_cast<double>(result.shaders_compiled)));
+  object.emplace("peak_rss_mib",
+                 picojson::value(static_cast<double>(result.peak_rss) / (1024.0 * 1024.0)));
+  return picojson::value(object);
+}
+
+// Boots each game or FIFO log listed in the file (one path per line, # starts a comment) in turn,
+// runs it for the given number of emulated seconds as fast as possible, and writes what was
+// measured to a JSON report. Settings that make the emulated work differ between runs (dual core,
+// asynchronous shader compilation, caches carried over from earlier runs) are turned off.
+static int RunSuite(const std::string& list_path, double seconds, const std::string& report_path)
+{
+  std::string list;
+  if (!File::ReadFileToString(list_path, list))
+  {
+    fprintf(stderr, "Could not read the suite %s\n", list_path.c_str());
+    return 1;
+  }
+
+  std::vector<std::string> paths;
+  for (const std::string& line : SplitString(list, '\n'))
+  {
+    const std::string_view path = StripSpaces(line);
+    if (!path.empty() && path[0] != '#')
+      paths.emplace_back(path);
+  }
+
+  // Not saved to the user's config on exit
+  SConfig& config = SConfig::GetInstance();
+  const std::string audio_backend = config.sBackend;
+  const bool cpu_thread = config.bCPUThread;
+  config.sBackend = BACKEND_NULLSOUND;
+  config.bCPUThread = false;
+  Core::SetIsThrottlerTempDisabled(true);
+  Config::SetCurrent(Config::MAIN_JIT_PERSISTENT_CACHE, false);
+  Config::SetCurrent(Config::GFX_SHADER_CACHE, false);
+  Config::SetCurrent(Config::GFX_SHADER_COMPILATION_MODE, ShaderCompilationMode::Synchronous);
+  Config::SetCurrent(Config::GFX_HIRES_TEXTURES, false);
+
+  int exit_code = 0;
+  picojson::array runs;
+  for (const std::string& path : paths)
+  {
+    if (s_interrupted.load())
+      break;
+
+    const SuiteResult result = RunSuiteEntry(path, seconds);
+    if (result.completed)
+    {
+      fmt::print("{}: {:.1f} fps, {:.0f}% speed, {} JIT compiles in {:.2f} s, {} shaders, "
+                 "{} MiB peak RSS\n",
+                 path, result.frames / result.run_seconds, 100.0 * seconds / result.run_seconds,
+                 result.jit_compiles, result.jit_compile_seconds, result.shaders_compiled,
+                 result.peak_rss / (1024 * 1024));
+    }
+    else
+    {
+      fmt::print("{}: stopped before {} emulated seconds\n", path, seconds);
+      exit_code = 1;
+    }
+    runs.push_back(SuiteResultToJSON(result, seconds));
+  }
+
+  config.sBackend = audio_backend;
+  config.bCPUThread = cpu_thread;
+
+  picojson::object report;
+  report.emplace("emulated_seconds", picojson::value(seconds));
+  report.emplace("runs", picojson::value(runs));
+  File::IOFile file(report_path, "w");
+  if (!file.WriteString(picojson::value(report).serialize(true)))
+  {
+    fprintf(stderr, "Could not write the suite report to %s\n", report_path.c_str());
+    return 1;
+  }
+
+  return exit_code;
+}
+
 static std::unique_ptr<Platform> GetPlatform(const optparse::Values& options)
 {
   std::string platform_name = static_cast<const char*>(options.get("platform"));
 
+  // Nothing is presented when playing back movies as fast as possible
+  if (platform_name.empty() && (options.is_set("fast_movie_playback") ||
+                                options.is_set("fifo_benchmark_loops") || options.is_set("suite")))
+    platform_name = "headless";
+
 #if HAVE_X11
   if (platform_name == "x11" || platform_name.empty())
     return Platform::CreateX11Platform();
@@ -152,6 +377,58 @@ int main(int argc, char* argv[])
             "win32"
 #endif
       });
+  parser->add_option("--precompile_shaders")
+      .action("store_true")
+      .help("Compile all known pipelines of the game into the shader cache, then exit");
+  parser->add_option("--export_pipeline_uids")
+      .action("store")
+      .metavar("<file>")
+      .type("string")
+      .help("Write the pipeline UIDs known for the game to a bundle on exit");
+  parser->add_option("--fast_movie_playback")
+      .action("store_true")
+      .help("Play back the movie as fast as possible without audio or a window, then exit");
+  parser->add_option("--frame_hashes")
+      .action("store")
+      .metavar("<file>")
+      .type("string")
+      .help("Write a hash of every frame that is output to a file");
+  parser->add_option("--frame_dump_interval")
+      .action("store")
+      .metavar("<frames>")
+      .type("int")
+      .set_default(0)
+      .help("With --frame_hashes, also dump every this many frames to a PNG");
+  parser->add_option("--fifo_benchmark_loops")
+      .action("store")
+      .metavar("<loops>")
+      .type("int")
+      .help("Play the FIFO log this many times as fast as possible, then exit");
+  parser->add_option("--fifo_benchmark_report")
+      .action("store")
+      .metavar("<file>")
+      .type("string")
+      .set_default("fifo_benchmark.csv")
+      .help("Where --fifo_benchmark_loops writes the frame timings, as JSON for a .json file or "
+            "CSV otherwise [default: %default]");
+  parser->add_option("--suite")
+      .action("store")
+      .metavar("<file>")
+      .type("string")
+      .help("Boot each game or FIFO log listed in the file in turn and measure its performance, "
+            "then exit");
+  parser->add_option("--suite_seconds")
+      .action("store")
+      .metavar("<seconds>")
+      .type("double")
+      .set_default(60)
+      .help("How many emulated seconds --suite runs each entry for [default: %default]");
+  parser->add_option("--suite_report")
+      .action("store")
+      .metavar("<file>")
+      .type("string")
+      .set_default("suite_report.json")
+      .help("Where --suite writes its JSON report [default: %default]");
 
   optparse::Values& options = CommandLineParse::ParseArguments(parser.get(), argc, argv);
   std::vector<std::string> args = parser->args();
@@ -190,7 +467,7 @@ int main(int argc, char* argv[])
     args.erase(args.begin());
     game_specified = true;
   }
-  else
+  else if (!options.is_set("suite"))
   {
     parser->print_help();
     return 0;
@@ -216,9 +493,85 @@ int main(int argc, char* argv[])
     return 1;
   }
 
-  Core::SetOnStateChangedCallback([](Core::State state) {
+  if (options.is_set("movie"))
+  {
+    if (!game_specified)
+    {
+      fprintf(stderr, "A movie cannot be played without specifying a game to launch.\n");
+      return 1;
+    }
+
+    const std::string movie_path = static_cast<const char*>(options.get("movie"));
+    Movie::SetReadOnly(true);
+    if (!Movie::PlayInput(movie_path, &boot->savestate_path))
+    {
+      fprintf(stderr, "Could not play the movie %s\n", movie_path.c_str());
+      return 1;
+    }
+  }
+
+  std::optional<std::string> audio_backend;
+  // For checking movies for regressions: nothing is waited on that doesn't affect the emulated
+  // output, and Dolphin exits once the movie is over.
+  if (options.is_set("fast_movie_playback"))
+  {
+    if (!options.is_set("movie"))
+    {
+      fprintf(stderr, "--fast_movie_playback requires a movie to play.\n");
+      return 1;
+    }
+
+    // Like holding the fast forward hotkey, which also turns off VSync
+    Core::SetIsThrottlerTempDisabled(true);
+    // Not saved to the user's config on exit
+    audio_backend = SConfig::GetInstance().sBackend;
+    SConfig::GetInstance().sBackend = BACKEND_NULLSOUND;
+    Movie::SetPlaybackEndedCallback([] { s_platform->Stop(); });
+  }
+
+  if (options.is_set("fifo_benchmark_loops"))
+  {
+    const int loops = static_cast<int>(options.get("fifo_benchmark_loops"));
+    if (loops <= 0)
+    {
+      fprintf(stderr, "--fifo_benchmark_loops needs to be at least 1.\n");
+      return 1;
+    }
+
+    FifoPlayer::GetInstance().SetBenchmark(
+        static_cast<u32>(loops), static_cast<const char*>(options.get("fifo_benchmark_report")));
+  }
+
+  if (options.is_set("frame_hashes"))
+  {
+    const std::string path = static_cast<const char*>(options.get("frame_hashes"));
+    if (!StartFrameHashing(path, static_cast<int>(options.get("frame_dump_interval"))))
+    {
+      fprintf(stderr, "Could not open %s for writing the frame hashes\n", path.c_str());
+      return 1;
+    }
+  }
+
+  // The pipelines are compiled while the video backend is initializing, so the shader cache is
+  // complete once emulation is about to start.
+  const bool precompile_shaders = options.is_set("precompile_shaders");
+  if (precompile_shaders)
+  {
+    Config::SetCurrent(Config::GFX_SHADER_CACHE, true);
+    Config::SetCurrent(Config::GFX_WAIT_FOR_SHADERS_BEFORE_STARTING, true);
+  }
+
+  Core::SetOnStateChangedCallback([precompile_shaders](Core::State state) {
     if (state == Core::State::Uninitialized)
+    {
       s_platform->Stop();
+    }
+    else if (state == Core::State::Running || state == Core::State::Paused)
+    {
+      s_game_id = SConfig::GetInstance().GetGameID();
+      if (precompile_shaders)
+        s_platform->Stop();
+    }
   });
 
 #ifdef _WIN32
@@ -236,22 +589,53 @@ int main(int argc, char* argv[])
 
   DolphinAnalytics::Instance().ReportDolphinStart("nogui");
 
-  if (!BootManager::BootCore(std::move(boot), s_platform->GetWindowSystemInfo()))
+  int result = 0;
+  if (options.is_set("suite"))
   {
-    fprintf(stderr, "Could not boot the specified file\n");
-    return 1;
+    const double seconds = static_cast<double>(options.get("suite_seconds"));
+    if (seconds <= 0.0)
+    {
+      fprintf(stderr, "--suite_seconds needs to be positive.\n");
+      return 1;
+    }
+
+    result = RunSuite(static_cast<const char*>(options.get("suite")), seconds,
+                      static_cast<const char*>(options.get("suite_report")));
   }
+  else
+  {
+    if (!BootManager::BootCore(std::move(boot), s_platform->GetWindowSystemInfo()))
+    {
+      fprintf(stderr, "Could not boot the specified file\n");
+      return 1;
+    }
 
 #ifdef USE_DISCORD_PRESENCE
-  Discord::UpdateDiscordPresence();
+    Discord::UpdateDiscordPresence();
 #endif
 
-  s_platform->MainLoop();
-  Core::Stop();
+    s_platform->MainLoop();
+    Core::Stop();
+  }
 
   Core::Shutdown();
   s_platform.reset();
+  Renderer::SetFrameCallback(nullptr);
+  Movie::SetPlaybackEndedCallback(nullptr);
+  if (audio_backend)
+    SConfig::GetInstance().sBackend = *audio_backend;
+
+  if (options.is_set("export_pipeline_uids"))
+  {
+    const std::string path = static_cast<const char*>(options.get("export_pipeline_uids"));
+    if (s_game_id.empty() || !VideoCommon::PipelineUIDBundle::Export(path, s_game_id))
+    {
+      fprintf(stderr, "Could not export the pipeline UIDs to %s\n", path.c_str());
+      result = 1;
+    }
+  }
+
   UICommon::Shutdown();
 
-  return 0;
+  return result;
 }
@@ -47,6 +47,12 @@ void Platform::Stop()
   m_running.Clear();
 }
 
+void Platform::ResetRunningFlag()
+{
+  m_tried_graceful_shutdown.Clear();
+  m_running.Set();
+}
+
 void Platform::RequestShutdown()
 {
   m_shutdown_requested.Set();
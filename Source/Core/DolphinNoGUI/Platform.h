@@ -31,6 +31,9 @@ public:
   // Request an immediate shutdown.
   void Stop();
 
+  // Lets MainLoop() run again after Stop(), for booting another game.
+  void ResetRunningFlag();
+
   static std::unique_ptr<Platform> CreateHeadlessPlatform();
 #ifdef HAVE_X11
   static std::unique_ptr<Platform> CreateX11Platform();
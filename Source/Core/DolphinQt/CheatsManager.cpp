@@ -51,7 +51,9 @@ enum class CompareType : int
   Less = 2,
   LessEqual = 3,
   More = 4,
-  MoreEqual = 5
+  MoreEqual = 5,
+  Changed = 6,
+  Unchanged = 7
 };
 
 enum class DataType : int
@@ -71,8 +73,28 @@ struct Result
   QString name;
   bool locked = false;
   u32 locked_value;
+  // Raw value at the time of the last search, for changed/unchanged searches.
+  u64 last_value = 0;
 };
 
+static u64 ReadRawValue(u32 address, DataType type)
+{
+  switch (type)
+  {
+  case DataType::Byte:
+    return PowerPC::HostRead_U8(address);
+  case DataType::Short:
+    return PowerPC::HostRead_U16(address);
+  case DataType::Int:
+  case DataType::Float:
+    return PowerPC::HostRead_U32(address);
+  case DataType::Double:
+    return PowerPC::HostRead_U64(address);
+  default:
+    return 0;
+  }
+}
+
 static u32 GetResultValue(Result result)
 {
   switch (result.type)
@@ -396,7 +418,8 @@ QWidget* CheatsManager::CreateCheatSearch()
   }
 
   for (const auto& option : {tr("Equals to"), tr("Not equals to"), tr("Less than"),
-                             tr("Less or equal to"), tr("More than"), tr("More or equal to")})
+                             tr("Less or equal to"), tr("More than"), tr("More or equal to"),
+                             tr("Changed since last search"), tr("Unchanged since last search")})
   {
     m_match_operation->addItem(option);
   }
@@ -459,6 +482,14 @@ size_t CheatsManager::GetTypeSize() const
 std::function<bool(u32)> CheatsManager::CreateMatchFunction()
 {
   const QString text = m_match_value->text();
+  const CompareType op = static_cast<CompareType>(m_match_operation->currentIndex());
+
+  if (op == CompareType::Changed || op == CompareType::Unchanged)
+  {
+    m_result_label->setText(tr("Changed and unchanged values can only be searched for in "
+                               "the results of a previous search."));
+    return nullptr;
+  }
 
   if (text.isEmpty())
   {
@@ -466,8 +497,6 @@ std::function<bool(u32)> CheatsManager::CreateMatchFunction()
     return nullptr;
   }
 
-  const CompareType op = static_cast<CompareType>(m_match_operation->currentIndex());
-
   const int base =
       (m_match_decimal->isChecked() ? 10 : (m_match_hexadecimal->isChecked() ? 16 : 8));
 
@@ -568,12 +597,22 @@ void CheatsManager::NewSearch()
   if (matches_func == nullptr)
     return;
 
+  const DataType type = static_cast<DataType>(m_match_length->currentIndex());
   Core::RunAsCPUThread([&] {
+    // Translation works on whole pages, so only look up whether each page is mapped once.
+    bool page_is_ram = false;
     for (u32 i = 0; i < Memory::GetRamSizeReal() - GetTypeSize(); i++)
     {
-      if (PowerPC::HostIsRAMAddress(base_address + i) && matches_func(base_address + i))
-        m_results.push_back(
-            {base_address + i, static_cast<DataType>(m_match_length->currentIndex())});
+      const u32 address = base_address + i;
+      if (i == 0 || (address & 0xfff) == 0)
+        page_is_ram = PowerPC::HostIsRAMAddress(address);
+
+      if (page_is_ram && matches_func(address))
+      {
+        Result result{address, type};
+        result.last_value = ReadRawValue(address, type);
+        m_results.push_back(std::move(result));
+      }
     }
   });
 
@@ -590,15 +629,40 @@ void CheatsManager::NextSearch()
     return;
   }
 
-  std::function<bool(u32)> matches_func = CreateMatchFunction();
-  if (matches_func == nullptr)
-    return;
+  const CompareType op = static_cast<CompareType>(m_match_operation->currentIndex());
+  std::function<bool(u32)> matches_func;
+  if (op == CompareType::Changed || op == CompareType::Unchanged)
+  {
+    if (static_cast<DataType>(m_match_length->currentIndex()) == DataType::String)
+    {
+      m_result_label->setText(tr("String values can only be compared using equality."));
+      return;
+    }
+  }
+  else
+  {
+    matches_func = CreateMatchFunction();
+    if (matches_func == nullptr)
+      return;
+  }
 
-  Core::RunAsCPUThread([this, matches_func] {
+  Core::RunAsCPUThread([this, op, matches_func] {
     m_results.erase(std::remove_if(m_results.begin(), m_results.end(),
-                                   [matches_func](Result r) {
-                                     return !PowerPC::HostIsRAMAddress(r.address) ||
-                                            !matches_func(r.address);
+                                   [op, matches_func](Result& r) {
+                                     if (!PowerPC::HostIsRAMAddress(r.address))
+                                       return true;
+
+                                     const u64 value = ReadRawValue(r.address, r.type);
+                                     bool matches;
+                                     if (op == CompareType::Changed)
+                                       matches = value != r.last_value;
+                                     else if (op == CompareType::Unchanged)
+                                       matches = value == r.last_value;
+                                     else
+                                       matches = matches_func(r.address);
+
+                                     r.last_value = value;
+                                     return !matches;
                                    }),
                     m_results.end());
   });
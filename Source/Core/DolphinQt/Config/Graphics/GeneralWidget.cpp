@@ -91,6 +91,10 @@ void GeneralWidget::CreateWidgets()
   m_show_ping = new GraphicsBool(tr("Show NetPlay Ping"), Config::GFX_SHOW_NETPLAY_PING);
   m_log_render_time =
       new GraphicsBool(tr("Log Render Time to File"), Config::GFX_LOG_RENDER_TIME_TO_FILE);
+  m_show_frame_time_breakdown =
+      new GraphicsBool(tr("Show Frame Time Breakdown"), Config::GFX_SHOW_FRAME_TIME_BREAKDOWN);
+  m_log_frame_time_breakdown = new GraphicsBool(tr("Log Frame Time Breakdown to File"),
+                                                Config::GFX_LOG_FRAME_TIME_BREAKDOWN_TO_FILE);
   m_autoadjust_window_size =
       new GraphicsBool(tr("Auto-Adjust Window Size"), Config::MAIN_RENDER_WINDOW_AUTOSIZE);
   m_show_messages =
@@ -108,6 +112,9 @@ void GeneralWidget::CreateWidgets()
   m_options_layout->addWidget(m_show_messages, 2, 0);
   m_options_layout->addWidget(m_show_ping, 2, 1);
 
+  m_options_layout->addWidget(m_show_frame_time_breakdown, 3, 0);
+  m_options_layout->addWidget(m_log_frame_time_breakdown, 3, 1);
+
   // Other
   auto* shader_compilation_box = new QGroupBox(tr("Shader Compilation"));
   auto* shader_compilation_layout = new QGridLayout();
@@ -246,6 +253,15 @@ void GeneralWidget::AddDescriptions()
       "Logs the render time of every frame to User/Logs/render_time.txt.<br><br>Use this "
       "feature when to measure the performance of Dolphin.<br><br><dolphin_emphasis>If "
       "unsure, leave this unchecked.</dolphin_emphasis>");
+  static const char TR_SHOW_FRAME_TIME_BREAKDOWN_DESCRIPTION[] = QT_TR_NOOP(
+      "Shows a graph of how the time of each frame is split up between emulating the CPU, "
+      "processing GPU commands, submitting them to the graphics backend, waiting for the frame "
+      "to be presented and audio.<br><br>Use this feature to find out what causes uneven frame "
+      "pacing.<br><br><dolphin_emphasis>If unsure, leave this unchecked.</dolphin_emphasis>");
+  static const char TR_LOG_FRAME_TIME_BREAKDOWN_DESCRIPTION[] =
+      QT_TR_NOOP("Logs the frame time breakdown of every frame to "
+                 "User/Logs/frame_time_breakdown.csv.<br><br><dolphin_emphasis>If unsure, leave "
+                 "this unchecked.</dolphin_emphasis>");
   static const char TR_SHOW_NETPLAY_MESSAGES_DESCRIPTION[] =
       QT_TR_NOOP("Shows chat messages, buffer changes, and desync alerts "
                  "while playing NetPlay.<br><br><dolphin_emphasis>If unsure, leave "
@@ -295,6 +311,10 @@ void GeneralWidget::AddDescriptions()
 
   m_log_render_time->SetDescription(tr(TR_LOG_RENDERTIME_DESCRIPTION));
 
+  m_show_frame_time_breakdown->SetDescription(tr(TR_SHOW_FRAME_TIME_BREAKDOWN_DESCRIPTION));
+
+  m_log_frame_time_breakdown->SetDescription(tr(TR_LOG_FRAME_TIME_BREAKDOWN_DESCRIPTION));
+
   m_autoadjust_window_size->SetDescription(tr(TR_AUTOSIZE_DESCRIPTION));
 
   m_show_messages->SetDescription(tr(TR_SHOW_NETPLAY_MESSAGES_DESCRIPTION));
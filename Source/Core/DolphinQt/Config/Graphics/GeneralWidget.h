@@ -53,6 +53,8 @@ private:
   GraphicsBool* m_show_fps;
   GraphicsBool* m_show_ping;
   GraphicsBool* m_log_render_time;
+  GraphicsBool* m_show_frame_time_breakdown;
+  GraphicsBool* m_log_frame_time_breakdown;
   GraphicsBool* m_autoadjust_window_size;
   GraphicsBool* m_show_messages;
   GraphicsBool* m_render_main_window;
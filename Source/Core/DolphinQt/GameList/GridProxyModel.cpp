@@ -35,7 +35,7 @@ QVariant GridProxyModel::data(const QModelIndex& i, int role) const
   {
     auto* model = static_cast<GameListModel*>(sourceModel());
 
-    const auto& buffer = model->GetGameFile(source_index.row())->GetCoverImage().buffer;
+    const auto buffer = model->GetGameFile(source_index.row())->GetCoverImage().buffer;
 
     QSize size = Config::Get(Config::MAIN_USE_GAME_COVERS) ? QSize(160, 224) : LARGE_BANNER_SIZE;
     QPixmap pixmap(size * model->GetScale() * QPixmap().devicePixelRatio());
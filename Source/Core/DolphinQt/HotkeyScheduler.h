@@ -45,6 +45,7 @@ signals:
   void StateSaveFile();
   void StateLoadUndo();
   void StateSaveUndo();
+  void StateRewind();
   void StartRecording();
   void ExportRecording();
   void ToggleReadOnlyMode();
@@ -11,12 +11,14 @@
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QIcon>
+#include <QInputDialog>
 #include <QMimeData>
 #include <QStackedWidget>
 #include <QVBoxLayout>
 #include <QWindow>
 
 #include <future>
+#include <limits>
 #include <optional>
 #include <variant>
 
@@ -56,6 +58,7 @@
 #include "Core/NetPlayClient.h"
 #include "Core/NetPlayProto.h"
 #include "Core/NetPlayServer.h"
+#include "Core/Rewind.h"
 #include "Core/State.h"
 
 #include "DiscIO/NANDImporter.h"
@@ -509,6 +512,7 @@ void MainWindow::ConnectMenuBar()
   connect(m_menu_bar, &MenuBar::StartRecording, this, &MainWindow::OnStartRecording);
   connect(m_menu_bar, &MenuBar::StopRecording, this, &MainWindow::OnStopRecording);
   connect(m_menu_bar, &MenuBar::ExportRecording, this, &MainWindow::OnExportRecording);
+  connect(m_menu_bar, &MenuBar::SeekRecording, this, &MainWindow::OnSeekRecording);
   connect(m_menu_bar, &MenuBar::ShowTASInput, this, &MainWindow::ShowTASInput);
 
   // View
@@ -560,6 +564,7 @@ void MainWindow::ConnectHotkeys()
   connect(m_hotkey_scheduler, &HotkeyScheduler::StateLoadLastSaved, this,
           &MainWindow::StateLoadLastSavedAt);
   connect(m_hotkey_scheduler, &HotkeyScheduler::StateLoadUndo, this, &MainWindow::StateLoadUndo);
+  connect(m_hotkey_scheduler, &HotkeyScheduler::StateRewind, this, &MainWindow::StateRewind);
   connect(m_hotkey_scheduler, &HotkeyScheduler::StateSaveUndo, this, &MainWindow::StateSaveUndo);
   connect(m_hotkey_scheduler, &HotkeyScheduler::StateSaveOldest, this,
           &MainWindow::StateSaveOldest);
@@ -1270,6 +1275,11 @@ void MainWindow::StateSaveUndo()
   State::UndoSaveState();
 }
 
+void MainWindow::StateRewind()
+{
+  Rewind::Rewind();
+}
+
 void MainWindow::StateSaveOldest()
 {
   State::SaveFirstSaved();
@@ -1371,6 +1381,7 @@ bool MainWindow::NetPlayJoin()
   {
     server->SetHostInputAuthority(host_input_authority);
     server->AdjustPadBufferSize(Config::Get(Config::NETPLAY_BUFFER_SIZE));
+    server->SetAutomaticPadBuffer(Config::Get(Config::NETPLAY_AUTOMATIC_BUFFER_SIZE));
   }
 
   // Create Client
@@ -1682,12 +1693,22 @@ void MainWindow::OnExportRecording()
                                                   tr("Dolphin TAS Movies (*.dtm)"));
 
   if (!dtm_file.isEmpty())
-    Movie::SaveRecording(dtm_file.toStdString());
+    Movie::SaveRecording(dtm_file.toStdString(), true);
 
   if (!was_paused)
     Core::SetState(Core::State::Running);
 }
 
+void MainWindow::OnSeekRecording()
+{
+  bool ok;
+  const int frame = QInputDialog::getInt(this, tr("Seek to Frame"), tr("Frame:"),
+                                         static_cast<int>(Movie::GetCurrentFrame()), 0,
+                                         std::numeric_limits<int>::max(), 1, &ok);
+  if (ok)
+    Movie::SeekToFrame(static_cast<u64>(frame));
+}
+
 void MainWindow::OnActivateChat()
 {
   if (g_netplay_chat_ui)
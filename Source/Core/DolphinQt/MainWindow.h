@@ -99,6 +99,7 @@ private:
   void StateLoadLastSavedAt(int slot);
   void StateLoadUndo();
   void StateSaveUndo();
+  void StateRewind();
   void StateSaveOldest();
   void SetStateSlot(int slot);
   void BootWiiSystemMenu();
@@ -175,6 +176,7 @@ private:
   void OnStartRecording();
   void OnStopRecording();
   void OnExportRecording();
+  void OnSeekRecording();
   void OnActivateChat();
   void OnRequestGolfControl();
   void ShowTASInput();
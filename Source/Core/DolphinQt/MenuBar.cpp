@@ -5,6 +5,8 @@
 #include "DolphinQt/MenuBar.h"
 
 #include <cinttypes>
+#include <ctime>
+#include <future>
 
 #include <QAction>
 #include <QActionGroup>
@@ -15,9 +17,13 @@
 #include <QMap>
 #include <QUrl>
 
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
 #include "Common/CommonPaths.h"
 #include "Common/FileUtil.h"
 #include "Common/StringUtil.h"
+#include "Common/Tracing.h"
 
 #include "Common/CDUtils.h"
 #include "Core/Boot/Boot.h"
@@ -52,12 +58,15 @@
 #include "DolphinQt/AboutDialog.h"
 #include "DolphinQt/Host.h"
 #include "DolphinQt/QtUtils/ModalMessageBox.h"
+#include "DolphinQt/QtUtils/ParallelProgressDialog.h"
 #include "DolphinQt/Settings.h"
 #include "DolphinQt/Updater.h"
 
 #include "UICommon/AutoUpdate.h"
 #include "UICommon/GameFile.h"
 
+#include "VideoCommon/HiresTextures.h"
+
 QPointer<MenuBar> MenuBar::s_menu_bar;
 
 QString MenuBar::GetSignatureSelector() const
@@ -123,6 +132,7 @@ void MenuBar::OnEmulationStateChanged(Core::State state)
   {
     m_recording_stop->setEnabled(false);
     m_recording_export->setEnabled(false);
+    m_recording_seek->setEnabled(false);
   }
   m_recording_play->setEnabled(m_game_selected && !running);
   m_recording_start->setEnabled((m_game_selected || running) && !Movie::IsPlayingInput());
@@ -236,6 +246,10 @@ void MenuBar::AddToolsMenu()
 
   tools_menu->addAction(tr("FIFO Player"), this, &MenuBar::ShowFIFOPlayer);
 
+  QAction* record_trace = tools_menu->addAction(tr("Record Performance Trace"));
+  record_trace->setCheckable(true);
+  connect(record_trace, &QAction::toggled, this, &MenuBar::RecordPerformanceTrace);
+
   tools_menu->addSeparator();
 
   tools_menu->addAction(tr("Start &NetPlay..."), this, &MenuBar::StartNetPlay);
@@ -253,6 +267,7 @@ void MenuBar::AddToolsMenu()
       gc_ipl->addAction(tr("PAL"), this, [this] { emit BootGameCubeIPL(DiscIO::Region::PAL); });
 
   tools_menu->addAction(tr("Memory Card Manager"), this, [this] { emit ShowMemcardManager(); });
+  tools_menu->addAction(tr("Create Custom Texture Pack..."), this, &MenuBar::CreateTexturePack);
 
   tools_menu->addSeparator();
 
@@ -740,11 +755,14 @@ void MenuBar::AddMovieMenu()
                                            [this] { emit StopRecording(); });
   m_recording_export =
       movie_menu->addAction(tr("Export Recording..."), this, [this] { emit ExportRecording(); });
+  m_recording_seek =
+      movie_menu->addAction(tr("Seek to Frame..."), this, [this] { emit SeekRecording(); });
 
   m_recording_start->setEnabled(false);
   m_recording_play->setEnabled(false);
   m_recording_stop->setEnabled(false);
   m_recording_export->setEnabled(false);
+  m_recording_seek->setEnabled(false);
 
   m_recording_read_only = movie_menu->addAction(tr("&Read-Only Mode"));
   m_recording_read_only->setCheckable(true);
@@ -1115,6 +1133,77 @@ void MenuBar::ExportWiiSaves()
                                tr("Exported %n save(s)", "", static_cast<int>(count)));
 }
 
+void MenuBar::RecordPerformanceTrace(bool record)
+{
+  if (record)
+  {
+    Common::Tracing::Start();
+    return;
+  }
+
+  Common::Tracing::Stop();
+
+  const std::string dump_dir = File::GetUserPath(D_DUMP_IDX);
+  const std::string path = fmt::format("{}trace {:%Y-%m-%d %Hh%Mm%Ss}.json", dump_dir,
+                                       fmt::localtime(std::time(nullptr)));
+  if (!File::CreateFullPath(dump_dir) || !Common::Tracing::Export(path))
+  {
+    ModalMessageBox::critical(this, tr("Error"),
+                              tr("Failed to write the performance trace to \"%1\".")
+                                  .arg(QString::fromStdString(path)));
+    return;
+  }
+
+  ModalMessageBox::information(
+      this, tr("Record Performance Trace"),
+      tr("The performance trace was written to \"%1\". It can be opened in chrome://tracing or "
+         "https://ui.perfetto.dev.")
+          .arg(QString::fromStdString(path)));
+}
+
+void MenuBar::CreateTexturePack()
+{
+  const QString texture_dir = QFileDialog::getExistingDirectory(
+      this, tr("Select Custom Texture Directory"),
+      QString::fromStdString(File::GetUserPath(D_HIRESTEXTURES_IDX)), QFileDialog::ShowDirsOnly);
+  if (texture_dir.isEmpty())
+    return;
+
+  const QString pack_path = QFileDialog::getSaveFileName(
+      this, tr("Save Texture Pack"), texture_dir + QStringLiteral(".texpack"),
+      tr("Custom Texture Packs (*.texpack)"));
+  if (pack_path.isEmpty())
+    return;
+
+  ParallelProgressDialog dialog(tr("Creating texture pack..."), tr("Cancel"), 0, 0, this);
+  dialog.GetRaw()->setWindowTitle(tr("Create Custom Texture Pack"));
+
+  std::future<bool> result = std::async(std::launch::async, [&] {
+    const bool success = HiresTexture::CreateTexturePack(
+        texture_dir.toStdString(), pack_path.toStdString(), [&dialog](size_t done, size_t total) {
+          dialog.SetMaximum(static_cast<int>(total));
+          dialog.SetValue(static_cast<int>(done));
+          return !dialog.WasCanceled();
+        });
+    dialog.Reset();
+    return success;
+  });
+  dialog.GetRaw()->exec();
+
+  if (result.get())
+  {
+    ModalMessageBox::information(
+        this, tr("Create Custom Texture Pack"),
+        tr("The texture pack was created. Put it in place of the textures it was created from "
+           "to use it."));
+  }
+  else if (!dialog.WasCanceled())
+  {
+    ModalMessageBox::critical(this, tr("Create Custom Texture Pack"),
+                              tr("Failed to create the texture pack."));
+  }
+}
+
 void MenuBar::CheckNAND()
 {
   IOS::HLE::Kernel ios;
@@ -1205,6 +1294,7 @@ void MenuBar::OnRecordingStatusChanged(bool recording)
   m_recording_start->setEnabled(!recording && (m_game_selected || Core::IsRunning()));
   m_recording_stop->setEnabled(recording);
   m_recording_export->setEnabled(recording);
+  m_recording_seek->setEnabled(recording);
 }
 
 void MenuBar::OnReadOnlyModeChanged(bool read_only)
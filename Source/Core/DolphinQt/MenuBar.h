@@ -107,6 +107,7 @@ signals:
   void StartRecording();
   void StopRecording();
   void ExportRecording();
+  void SeekRecording();
   void ShowTASInput();
 
   void SelectionChanged(std::shared_ptr<const UICommon::GameFile> game_file);
@@ -145,6 +146,8 @@ private:
   void InstallWAD();
   void ImportWiiSave();
   void ExportWiiSaves();
+  void CreateTexturePack();
+  void RecordPerformanceTrace(bool record);
   void CheckNAND();
   void NANDExtractCertificates();
   void ChangeDebugFont();
@@ -220,6 +223,7 @@ private:
 
   // Movie
   QAction* m_recording_export;
+  QAction* m_recording_seek;
   QAction* m_recording_play;
   QAction* m_recording_start;
   QAction* m_recording_stop;
@@ -145,12 +145,30 @@ void NetPlayDialog::CreateMainLayout()
          "switched at any time.\nSuitable for turn-based games with timing-sensitive controls, "
          "such as golf."));
   m_golf_mode_action->setCheckable(true);
+  m_rollback_action = m_network_menu->addAction(tr("Rollback"));
+  m_rollback_action->setToolTip(
+      tr("Each player's own inputs are used right away, and the ones of the other players are "
+         "predicted until they arrive. When a prediction turns out wrong, the game goes back and "
+         "quickly emulates the frames since then again.
+Suitable for GameCube games played over "
+         "high latency connections. Needs a fast computer. Wii games use Fair Input Delay "
+         "instead."));
+  m_rollback_action->setCheckable(true);
+  m_network_menu->addSeparator();
+  m_automatic_buffer_action = m_network_menu->addAction(tr("Automatic Buffer Size"));
+  m_automatic_buffer_action->setToolTip(
+      tr("Keeps the buffer at the smallest size that the pings of the players with controllers "
+         "allow for without stuttering, measured every second.
+Only used with Fair Input "
+         "Delay."));
+  m_automatic_buffer_action->setCheckable(true);
 
   m_network_mode_group = new QActionGroup(this);
   m_network_mode_group->setExclusive(true);
   m_network_mode_group->addAction(m_fixed_delay_action);
   m_network_mode_group->addAction(m_host_input_authority_action);
   m_network_mode_group->addAction(m_golf_mode_action);
+  m_network_mode_group->addAction(m_rollback_action);
   m_fixed_delay_action->setChecked(true);
 
   m_md5_menu = m_menu_bar->addMenu(tr("Checksum"));
@@ -317,6 +335,17 @@ void NetPlayDialog::ConnectWidgets()
           [hia_function] { hia_function(true); });
   connect(m_golf_mode_action, &QAction::toggled, this, [hia_function] { hia_function(true); });
   connect(m_fixed_delay_action, &QAction::toggled, this, [hia_function] { hia_function(false); });
+  connect(m_rollback_action, &QAction::toggled, this, [hia_function] { hia_function(false); });
+  connect(m_automatic_buffer_action, &QAction::toggled, this, [this](bool checked) {
+    if (auto server = Settings::Instance().GetNetPlayServer())
+      server->SetAutomaticPadBuffer(checked);
+
+    if (IsHosting() && !m_host_input_authority)
+    {
+      m_buffer_size_box->setEnabled(!checked);
+      m_buffer_label->setEnabled(!checked);
+    }
+  });
 
   connect(m_start_button, &QPushButton::clicked, this, &NetPlayDialog::OnStart);
   connect(m_quit_button, &QPushButton::clicked, this, &NetPlayDialog::reject);
@@ -368,6 +397,8 @@ void NetPlayDialog::ConnectWidgets()
   connect(m_golf_mode_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
   connect(m_golf_mode_overlay_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
   connect(m_fixed_delay_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
+  connect(m_rollback_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
+  connect(m_automatic_buffer_action, &QAction::toggled, this, &NetPlayDialog::SaveSettings);
 }
 
 void NetPlayDialog::SendMessage(const std::string& msg)
@@ -504,12 +535,14 @@ void NetPlayDialog::OnStart()
   settings.m_DeferEFBCopies = Config::Get(Config::GFX_HACK_DEFER_EFB_COPIES);
   settings.m_EFBAccessTileSize = Config::Get(Config::GFX_HACK_EFB_ACCESS_TILE_SIZE);
   settings.m_EFBAccessDeferInvalidation = Config::Get(Config::GFX_HACK_EFB_DEFER_INVALIDATION);
+  settings.m_EFBAccessMaxStaleness = Config::Get(Config::GFX_HACK_EFB_ACCESS_MAX_STALENESS);
   settings.m_StrictSettingsSync = m_strict_settings_sync_action->isChecked();
   settings.m_SyncSaveData = m_sync_save_data_action->isChecked();
   settings.m_SyncCodes = m_sync_codes_action->isChecked();
   settings.m_SyncAllWiiSaves =
       m_sync_all_wii_saves_action->isChecked() && m_sync_save_data_action->isChecked();
   settings.m_GolfMode = m_golf_mode_action->isChecked();
+  settings.m_Rollback = m_rollback_action->isChecked();
 
   // Unload GameINI to restore things to normal
   Config::RemoveLayer(Config::LayerType::GlobalGame);
@@ -685,7 +718,8 @@ void NetPlayDialog::UpdateGUI()
     auto* status_item = new QTableWidgetItem(player_status.count(p->game_status) ?
                                                  player_status.at(p->game_status) :
                                                  QStringLiteral("?"));
-    auto* ping_item = new QTableWidgetItem(QStringLiteral("%1 ms").arg(p->ping));
+    auto* ping_item =
+        new QTableWidgetItem(tr("%1 ms, jitter %2 ms").arg(p->ping).arg(p->jitter));
     auto* mapping_item = new QTableWidgetItem(
         QString::fromStdString(get_mapping_string(p, client->GetPadMapping()) +
                                get_mapping_string(p, client->GetWiimoteMapping())));
@@ -851,6 +885,7 @@ void NetPlayDialog::SetOptionsEnabled(bool enabled)
     m_sync_all_wii_saves_action->setEnabled(enabled && m_sync_save_data_action->isChecked());
     m_golf_mode_action->setEnabled(enabled);
     m_fixed_delay_action->setEnabled(enabled);
+    m_rollback_action->setEnabled(enabled);
   }
 
   m_record_input_action->setEnabled(enabled);
@@ -932,8 +967,9 @@ void NetPlayDialog::OnHostInputAuthorityChanged(bool enabled)
 
     if (is_hosting)
     {
-      m_buffer_size_box->setEnabled(enable_buffer);
-      m_buffer_label->setEnabled(enable_buffer);
+      const bool automatic_buffer = !enabled && m_automatic_buffer_action->isChecked();
+      m_buffer_size_box->setEnabled(enable_buffer && !automatic_buffer);
+      m_buffer_label->setEnabled(enable_buffer && !automatic_buffer);
       m_buffer_size_box->setHidden(false);
       m_buffer_label->setHidden(false);
     }
@@ -1074,6 +1110,7 @@ void NetPlayDialog::LoadSettings()
   const bool strict_settings_sync = Config::Get(Config::NETPLAY_STRICT_SETTINGS_SYNC);
   const bool sync_all_wii_saves = Config::Get(Config::NETPLAY_SYNC_ALL_WII_SAVES);
   const bool golf_mode_overlay = Config::Get(Config::NETPLAY_GOLF_MODE_OVERLAY);
+  const bool automatic_buffer = Config::Get(Config::NETPLAY_AUTOMATIC_BUFFER_SIZE);
 
   m_buffer_size_box->setValue(buffer_size);
   m_save_sd_action->setChecked(write_save_sdcard_data);
@@ -1084,6 +1121,7 @@ void NetPlayDialog::LoadSettings()
   m_strict_settings_sync_action->setChecked(strict_settings_sync);
   m_sync_all_wii_saves_action->setChecked(sync_all_wii_saves);
   m_golf_mode_overlay_action->setChecked(golf_mode_overlay);
+  m_automatic_buffer_action->setChecked(automatic_buffer);
 
   const std::string network_mode = Config::Get(Config::NETPLAY_NETWORK_MODE);
 
@@ -1099,6 +1137,10 @@ void NetPlayDialog::LoadSettings()
   {
     m_golf_mode_action->setChecked(true);
   }
+  else if (network_mode == "rollback")
+  {
+    m_rollback_action->setChecked(true);
+  }
   else
   {
     WARN_LOG_FMT(NETPLAY, "Unknown network mode '{}', using 'fixeddelay'", network_mode);
@@ -1123,6 +1165,7 @@ void NetPlayDialog::SaveSettings()
   Config::SetBase(Config::NETPLAY_STRICT_SETTINGS_SYNC, m_strict_settings_sync_action->isChecked());
   Config::SetBase(Config::NETPLAY_SYNC_ALL_WII_SAVES, m_sync_all_wii_saves_action->isChecked());
   Config::SetBase(Config::NETPLAY_GOLF_MODE_OVERLAY, m_golf_mode_overlay_action->isChecked());
+  Config::SetBase(Config::NETPLAY_AUTOMATIC_BUFFER_SIZE, m_automatic_buffer_action->isChecked());
 
   std::string network_mode;
   if (m_fixed_delay_action->isChecked())
@@ -1137,6 +1180,10 @@ void NetPlayDialog::SaveSettings()
   {
     network_mode = "golf";
   }
+  else if (m_rollback_action->isChecked())
+  {
+    network_mode = "rollback";
+  }
 
   Config::SetBase(Config::NETPLAY_NETWORK_MODE, network_mode);
 }
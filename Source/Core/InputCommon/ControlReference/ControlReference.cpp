@@ -29,6 +29,7 @@ void ControlReference::UpdateReference(ciface::ExpressionParser::ControlEnvironm
   if (m_parsed_expression)
   {
     m_parsed_expression->UpdateReferences(env);
+    m_compiled_expression = CompiledExpression(*m_parsed_expression);
   }
 }
 
@@ -56,6 +57,8 @@ std::optional<std::string> ControlReference::SetExpression(std::string expr)
   auto parse_result = ParseExpression(m_expression);
   m_parse_status = parse_result.status;
   m_parsed_expression = std::move(parse_result.expr);
+  m_compiled_expression =
+      m_parsed_expression ? CompiledExpression(*m_parsed_expression) : CompiledExpression();
   return parse_result.description;
 }
 
@@ -91,7 +94,7 @@ bool OutputReference::IsInput() const
 ControlState InputReference::State(const ControlState ignore)
 {
   if (m_parsed_expression && GetInputGate())
-    return m_parsed_expression->GetValue() * range;
+    return m_compiled_expression.GetValue() * range;
   return 0.0;
 }
 
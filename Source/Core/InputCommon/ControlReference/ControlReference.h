@@ -48,6 +48,8 @@ protected:
   ControlReference();
   std::string m_expression;
   std::unique_ptr<ciface::ExpressionParser::Expression> m_parsed_expression;
+  // What inputs are evaluated with, recompiled whenever the expression or its references change.
+  ciface::ExpressionParser::CompiledExpression m_compiled_expression;
   ciface::ExpressionParser::ParseStatus m_parse_status;
 };
 
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <functional>
@@ -278,6 +279,13 @@ public:
       output->SetState(value);
   }
   int CountNumControls() const override { return (input || output) ? 1 : 0; }
+  void Compile(CompiledExpression* program) const override
+  {
+    if (input)
+      program->EmitInput(input);
+    else
+      program->EmitLiteral(0.0);
+  }
   void UpdateReferences(ControlEnvironment& env) override
   {
     m_device = env.FindDevice(qualifier);
@@ -325,6 +333,45 @@ HotkeySuppressions::MakeSuppressor(const Modifiers* modifiers,
                     InvokingDeleter{});
 }
 
+static ControlState ApplyBinaryOperator(TokenType op, ControlState lhs, ControlState rhs)
+{
+  switch (op)
+  {
+  case TOK_AND:
+    return std::min(lhs, rhs);
+  case TOK_OR:
+    return std::max(lhs, rhs);
+  case TOK_ADD:
+    return lhs + rhs;
+  case TOK_SUB:
+    return lhs - rhs;
+  case TOK_MUL:
+    return lhs * rhs;
+  case TOK_DIV:
+  {
+    const ControlState result = lhs / rhs;
+    return std::isinf(result) ? 0.0 : result;
+  }
+  case TOK_MOD:
+  {
+    const ControlState result = std::fmod(lhs, rhs);
+    return std::isnan(result) ? 0.0 : result;
+  }
+  case TOK_LTHAN:
+    return lhs < rhs;
+  case TOK_GTHAN:
+    return lhs > rhs;
+  case TOK_COMMA:
+    // The lhs was evaluated for its side effects only.
+    return rhs;
+  case TOK_XOR:
+    return std::max(std::min(1 - lhs, rhs), std::min(lhs, 1 - rhs));
+  default:
+    assert(false);
+    return 0;
+  }
+}
+
 class BinaryExpression : public Expression
 {
 public:
@@ -340,53 +387,28 @@ public:
 
   ControlState GetValue() const override
   {
-    switch (op)
-    {
-    case TOK_AND:
-      return std::min(lhs->GetValue(), rhs->GetValue());
-    case TOK_OR:
-      return std::max(lhs->GetValue(), rhs->GetValue());
-    case TOK_ADD:
-      return lhs->GetValue() + rhs->GetValue();
-    case TOK_SUB:
-      return lhs->GetValue() - rhs->GetValue();
-    case TOK_MUL:
-      return lhs->GetValue() * rhs->GetValue();
-    case TOK_DIV:
-    {
-      const ControlState result = lhs->GetValue() / rhs->GetValue();
-      return std::isinf(result) ? 0.0 : result;
-    }
-    case TOK_MOD:
-    {
-      const ControlState result = std::fmod(lhs->GetValue(), rhs->GetValue());
-      return std::isnan(result) ? 0.0 : result;
-    }
-    case TOK_ASSIGN:
+    if (op == TOK_ASSIGN)
     {
       lhs->SetValue(rhs->GetValue());
       return lhs->GetValue();
     }
-    case TOK_LTHAN:
-      return lhs->GetValue() < rhs->GetValue();
-    case TOK_GTHAN:
-      return lhs->GetValue() > rhs->GetValue();
-    case TOK_COMMA:
-    {
-      // Eval and discard lhs:
-      lhs->GetValue();
-      return rhs->GetValue();
-    }
-    case TOK_XOR:
+
+    const ControlState lval = lhs->GetValue();
+    const ControlState rval = rhs->GetValue();
+    return ApplyBinaryOperator(op, lval, rval);
+  }
+
+  void Compile(CompiledExpression* program) const override
+  {
+    if (op == TOK_ASSIGN)
     {
-      const auto lval = lhs->GetValue();
-      const auto rval = rhs->GetValue();
-      return std::max(std::min(1 - lval, rval), std::min(lval, 1 - rval));
-    }
-    default:
-      assert(false);
-      return 0;
+      program->EmitExpression(this);
+      return;
     }
+
+    lhs->Compile(program);
+    rhs->Compile(program);
+    program->EmitBinaryOperator(op);
   }
 
   void SetValue(ControlState value) override
@@ -435,6 +457,8 @@ public:
 
   ControlState GetValue() const override { return m_value; }
 
+  void Compile(CompiledExpression* program) const override { program->EmitLiteral(m_value); }
+
   std::string GetName() const override { return ValueToString(m_value); }
 
 private:
@@ -459,6 +483,8 @@ public:
 
   void SetValue(ControlState value) override { *m_value_ptr = value; }
 
+  void Compile(CompiledExpression* program) const override { program->EmitVariable(m_value_ptr); }
+
   int CountNumControls() const override { return 1; }
 
   void UpdateReferences(ControlEnvironment& env) override
@@ -569,6 +595,8 @@ public:
   void SetValue(ControlState value) override { GetActiveChild()->SetValue(value); }
 
   int CountNumControls() const override { return GetActiveChild()->CountNumControls(); }
+  // The active child only changes with the references, which the program is compiled again for.
+  void Compile(CompiledExpression* program) const override { GetActiveChild()->Compile(program); }
   void UpdateReferences(ControlEnvironment& env) override
   {
     m_lhs->UpdateReferences(env);
@@ -616,6 +644,106 @@ ControlState* ControlEnvironment::GetVariablePtr(const std::string& name)
   return &m_variables[name];
 }
 
+void Expression::Compile(CompiledExpression* program) const
+{
+  program->EmitExpression(this);
+}
+
+CompiledExpression::CompiledExpression(const Expression& expr)
+{
+  expr.Compile(this);
+  if (m_max_stack_depth > MAX_STACK_DEPTH)
+  {
+    m_instructions.clear();
+    m_stack_depth = m_max_stack_depth = 0;
+    EmitExpression(&expr);
+  }
+}
+
+ControlState CompiledExpression::GetValue() const
+{
+  std::array<ControlState, MAX_STACK_DEPTH> stack;
+  ControlState* top = stack.data();
+  for (const Instruction& instruction : m_instructions)
+  {
+    switch (instruction.opcode)
+    {
+    case Opcode::Literal:
+      *top++ = instruction.literal;
+      break;
+    case Opcode::Input:
+      // Same as ControlExpression::GetValue.
+      *top++ = s_hotkey_suppressions.IsSuppressed(instruction.input) ?
+                   0.0 :
+                   std::max(0.0, instruction.input->GetState());
+      break;
+    case Opcode::Variable:
+      *top++ = *instruction.variable;
+      break;
+    case Opcode::BinaryOperator:
+      --top;
+      top[-1] = ApplyBinaryOperator(instruction.op, top[-1], top[0]);
+      break;
+    case Opcode::Expression:
+      *top++ = instruction.expression->GetValue();
+      break;
+    }
+  }
+  return top != stack.data() ? top[-1] : 0.0;
+}
+
+void CompiledExpression::EmitLiteral(ControlState value)
+{
+  Instruction instruction{Opcode::Literal, TOK_INVALID, {}};
+  instruction.literal = value;
+  Push(instruction, 1);
+}
+
+void CompiledExpression::EmitInput(Device::Input* input)
+{
+  Instruction instruction{Opcode::Input, TOK_INVALID, {}};
+  instruction.input = input;
+  Push(instruction, 1);
+}
+
+void CompiledExpression::EmitVariable(const ControlState* value)
+{
+  Instruction instruction{Opcode::Variable, TOK_INVALID, {}};
+  instruction.variable = value;
+  Push(instruction, 1);
+}
+
+void CompiledExpression::EmitBinaryOperator(TokenType op)
+{
+  const size_t size = m_instructions.size();
+  if (size >= 2 && m_instructions[size - 2].opcode == Opcode::Literal &&
+      m_instructions[size - 1].opcode == Opcode::Literal)
+  {
+    const ControlState value =
+        ApplyBinaryOperator(op, m_instructions[size - 2].literal, m_instructions[size - 1].literal);
+    m_instructions.resize(size - 2);
+    m_stack_depth -= 2;
+    EmitLiteral(value);
+    return;
+  }
+
+  Push(Instruction{Opcode::BinaryOperator, op, {}}, -1);
+}
+
+void CompiledExpression::EmitExpression(const Expression* expr)
+{
+  Instruction instruction{Opcode::Expression, TOK_INVALID, {}};
+  instruction.expression = expr;
+  Push(instruction, 1);
+}
+
+void CompiledExpression::Push(const Instruction& instruction, s32 stack_change)
+{
+  m_instructions.push_back(instruction);
+  m_stack_depth += stack_change;
+  m_max_stack_depth = std::max(m_max_stack_depth, m_stack_depth);
+}
+
 ParseResult ParseResult::MakeEmptyResult()
 {
   ParseResult result;
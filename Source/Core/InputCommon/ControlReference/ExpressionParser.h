@@ -8,6 +8,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "InputCommon/ControllerInterface/CoreDevice.h"
 
@@ -159,6 +160,8 @@ private:
   const Core::DeviceQualifier& default_device;
 };
 
+class CompiledExpression;
+
 class Expression
 {
 public:
@@ -167,6 +170,63 @@ public:
   virtual void SetValue(ControlState state) = 0;
   virtual int CountNumControls() const = 0;
   virtual void UpdateReferences(ControlEnvironment& finder) = 0;
+
+  // Appends the instructions computing GetValue to the program. By default, that's a call to
+  // GetValue itself.
+  virtual void Compile(CompiledExpression* program) const;
+};
+
+// An expression tree flattened into a list of instructions for a small stack machine, so that
+// polling an input evaluates it with one loop instead of a virtual call for each node. Controls
+// and variables are referenced by the pointers they were bound to, so the program has to be
+// compiled again after UpdateReferences. Literal operands are folded, and so are unbound controls,
+// which always read as 0. Nodes with side effects or state of their own, like functions, hotkeys
+// and assignments, are evaluated through the tree.
+class CompiledExpression
+{
+public:
+  CompiledExpression() = default;
+  explicit CompiledExpression(const Expression& expr);
+
+  ControlState GetValue() const;
+
+  void EmitLiteral(ControlState value);
+  void EmitInput(Core::Device::Input* input);
+  void EmitVariable(const ControlState* value);
+  void EmitBinaryOperator(TokenType op);
+  void EmitExpression(const Expression* expr);
+
+private:
+  // Deeper expressions are left to the tree, so that the stack fits into a fixed size array.
+  static constexpr u32 MAX_STACK_DEPTH = 32;
+
+  enum class Opcode
+  {
+    Literal,
+    Input,
+    Variable,
+    BinaryOperator,
+    Expression,
+  };
+
+  struct Instruction
+  {
+    Opcode opcode;
+    TokenType op;
+    union
+    {
+      ControlState literal;
+      Core::Device::Input* input;
+      const ControlState* variable;
+      const Expression* expression;
+    };
+  };
+
+  void Push(const Instruction& instruction, s32 stack_change);
+
+  std::vector<Instruction> m_instructions;
+  u32 m_stack_depth = 0;
+  u32 m_max_stack_depth = 0;
 };
 
 class ParseResult
@@ -3,13 +3,18 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstring>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <fcntl.h>
 #include <libudev.h>
+#include <poll.h>
 #include <sys/eventfd.h>
 #include <unistd.h>
 
@@ -25,26 +30,38 @@
 
 namespace ciface::evdev
 {
+// The values of a node's buttons and axes. The input thread updates them as the events arrive, so
+// reading an input never waits on the device.
+struct NodeState
+{
+  std::array<std::atomic<int>, KEY_CNT> keys{};
+  std::array<std::atomic<int>, ABS_CNT> axes{};
+};
+
 class Input : public Core::Device::Input
 {
 public:
-  Input(u16 code, libevdev* dev) : m_code(code), m_dev(dev) {}
+  Input(u16 code, libevdev* dev, const NodeState* state) : m_code(code), m_dev(dev), m_state(state)
+  {
+  }
 
 protected:
   const u16 m_code;
   libevdev* const m_dev;
+  const NodeState* const m_state;
 };
 
 class Button : public Input
 {
 public:
-  Button(u8 index, u16 code, libevdev* dev) : Input(code, dev), m_index(index) {}
+  Button(u8 index, u16 code, libevdev* dev, const NodeState* state)
+      : Input(code, dev, state), m_index(index)
+  {
+  }
 
   ControlState GetState() const final override
   {
-    int value = 0;
-    libevdev_fetch_event_value(m_dev, EV_KEY, m_code, &value);
-    return value;
+    return m_state->keys[m_code].load(std::memory_order_relaxed);
   }
 
 protected:
@@ -110,9 +127,7 @@ public:
 
   ControlState GetState() const final override
   {
-    int value = 0;
-    libevdev_fetch_event_value(m_dev, EV_ABS, m_code, &value);
-
+    const int value = m_state->axes[m_code].load(std::memory_order_relaxed);
     return (value - m_base) / m_range;
   }
 
@@ -124,7 +139,8 @@ protected:
 class Axis : public AnalogInput
 {
 public:
-  Axis(u8 index, u16 code, bool upper, libevdev* dev) : AnalogInput(code, dev), m_index(index)
+  Axis(u8 index, u16 code, bool upper, libevdev* dev, const NodeState* state)
+      : AnalogInput(code, dev, state), m_index(index)
   {
     const int min = libevdev_get_abs_minimum(m_dev, m_code);
     const int max = libevdev_get_abs_maximum(m_dev, m_code);
@@ -148,7 +164,8 @@ private:
 class MotionDataInput final : public AnalogInput
 {
 public:
-  MotionDataInput(u16 code, ControlState resolution_scale, libevdev* dev) : AnalogInput(code, dev)
+  MotionDataInput(u16 code, ControlState resolution_scale, libevdev* dev, const NodeState* state)
+      : AnalogInput(code, dev, state)
   {
     auto* const info = libevdev_get_abs_info(m_dev, m_code);
 
@@ -199,6 +216,129 @@ static std::thread s_hotplug_thread;
 static Common::Flag s_hotplug_thread_running;
 static int s_wakeup_eventfd;
 
+// The nodes the input thread reads the events of, by file descriptor. The mutex is held while the
+// events are read, so a node can be freed once it has been unregistered.
+struct InputNode
+{
+  libevdev* device;
+  NodeState* state;
+};
+static std::mutex s_input_nodes_mutex;
+static std::map<int, InputNode> s_input_nodes;
+static std::thread s_input_thread;
+static Common::Flag s_input_thread_running;
+static int s_input_wakeup_eventfd = -1;
+
+static void WakeInputThread()
+{
+  if (s_input_wakeup_eventfd == -1)
+    return;
+
+  const uint64_t value = 1;
+  static_cast<void>(write(s_input_wakeup_eventfd, &value, sizeof(uint64_t)));
+}
+
+static void RegisterInputNode(int fd, libevdev* dev, NodeState* state)
+{
+  // libevdev synced its state with the device when it was created.
+  for (int key = 0; key != KEY_CNT; ++key)
+  {
+    int value = 0;
+    if (libevdev_fetch_event_value(dev, EV_KEY, key, &value))
+      state->keys[key].store(value, std::memory_order_relaxed);
+  }
+  for (int axis = 0; axis != ABS_CNT; ++axis)
+  {
+    int value = 0;
+    if (libevdev_fetch_event_value(dev, EV_ABS, axis, &value))
+      state->axes[axis].store(value, std::memory_order_relaxed);
+  }
+
+  {
+    std::lock_guard lk(s_input_nodes_mutex);
+    s_input_nodes[fd] = InputNode{dev, state};
+  }
+  WakeInputThread();
+}
+
+static void UnregisterInputNode(int fd)
+{
+  {
+    std::lock_guard lk(s_input_nodes_mutex);
+    s_input_nodes.erase(fd);
+  }
+  WakeInputThread();
+}
+
+static void ReadEvents(const InputNode& node)
+{
+  // libevdev keeps track of the state itself, and brings it up to date with events of its own
+  // after the kernel dropped some (LIBEVDEV_READ_STATUS_SYNC).
+  int rc = LIBEVDEV_READ_STATUS_SUCCESS;
+  while (true)
+  {
+    input_event ev;
+    if (LIBEVDEV_READ_STATUS_SYNC == rc)
+      rc = libevdev_next_event(node.device, LIBEVDEV_READ_FLAG_SYNC, &ev);
+    else
+      rc = libevdev_next_event(node.device, LIBEVDEV_READ_FLAG_NORMAL, &ev);
+
+    if (rc < 0)
+      break;
+
+    if (ev.type == EV_KEY && ev.code < KEY_CNT)
+      node.state->keys[ev.code].store(ev.value, std::memory_order_relaxed);
+    else if (ev.type == EV_ABS && ev.code < ABS_CNT)
+      node.state->axes[ev.code].store(ev.value, std::memory_order_relaxed);
+  }
+}
+
+static void InputThreadFunc()
+{
+  Common::SetCurrentThreadName("evdev Input Thread");
+
+  std::vector<pollfd> fds;
+  while (s_input_thread_running.IsSet())
+  {
+    fds.clear();
+    fds.push_back(pollfd{s_input_wakeup_eventfd, POLLIN, 0});
+    {
+      std::lock_guard lk(s_input_nodes_mutex);
+      for (const auto& [fd, node] : s_input_nodes)
+        fds.push_back(pollfd{fd, POLLIN, 0});
+    }
+
+    if (poll(fds.data(), fds.size(), -1) < 1)
+      continue;
+
+    if (fds[0].revents & POLLIN)
+    {
+      uint64_t value;
+      static_cast<void>(read(s_input_wakeup_eventfd, &value, sizeof(uint64_t)));
+    }
+
+    std::lock_guard lk(s_input_nodes_mutex);
+    for (size_t i = 1; i < fds.size(); ++i)
+    {
+      // The node may have been unregistered, and its descriptor reused, since the poll started.
+      const auto it = s_input_nodes.find(fds[i].fd);
+      if (it == s_input_nodes.end())
+        continue;
+
+      if (fds[i].revents & POLLIN)
+      {
+        ReadEvents(it->second);
+      }
+      else if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL))
+      {
+        // The device is gone. Stop polling it until the hotplug thread has removed it, as the
+        // poll would return right away.
+        s_input_nodes.erase(it);
+      }
+    }
+  }
+}
+
 // There is no easy way to get the device name from only a dev node
 // during a device removed event, since libevdev can't work on removed devices;
 // sysfs is not stable, so this is probably the easiest way to get a name for a node.
@@ -371,8 +511,30 @@ static void StopHotplugThread()
   close(s_wakeup_eventfd);
 }
 
+static void StartInputThread()
+{
+  if (!s_input_thread_running.TestAndSet())
+    return;
+
+  s_input_wakeup_eventfd = eventfd(0, 0);
+  ASSERT_MSG(PAD, s_input_wakeup_eventfd != -1, "Couldn't create eventfd.");
+  s_input_thread = std::thread(InputThreadFunc);
+}
+
+static void StopInputThread()
+{
+  if (!s_input_thread_running.TestAndClear())
+    return;
+
+  WakeInputThread();
+  s_input_thread.join();
+  close(s_input_wakeup_eventfd);
+  s_input_wakeup_eventfd = -1;
+}
+
 void Init()
 {
+  StartInputThread();
   StartHotplugThread();
 }
 
@@ -411,11 +573,15 @@ void PopulateDevices()
 void Shutdown()
 {
   StopHotplugThread();
+  StopInputThread();
 }
 
 bool evdevDevice::AddNode(std::string devnode, int fd, libevdev* dev)
 {
-  m_nodes.emplace_back(Node{std::move(devnode), fd, dev});
+  m_nodes.emplace_back(Node{std::move(devnode), fd, dev, std::make_unique<NodeState>()});
+  NodeState* const state = m_nodes.back().state.get();
+  // Only hand the node to the input thread once the inputs have been set up from it.
+  Common::ScopeGuard register_guard([fd, dev, state] { RegisterInputNode(fd, dev, state); });
 
   // Take on the alphabetically first name.
   const auto potential_new_name = StripSpaces(libevdev_get_name(dev));
@@ -440,15 +606,15 @@ bool evdevDevice::AddNode(std::string devnode, int fd, libevdev* dev)
       {
         // This node will probably be combined with another with regular buttons.
         // We don't want to match "Button 0" names here as it will name clash.
-        AddInput(new NamedButtonWithNoBackwardsCompat(num_buttons, key, dev));
+        AddInput(new NamedButtonWithNoBackwardsCompat(num_buttons, key, dev, state));
       }
       else if (has_sensible_button_names)
       {
-        AddInput(new NamedButton(num_buttons, key, dev));
+        AddInput(new NamedButton(num_buttons, key, dev, state));
       }
       else
       {
-        AddInput(new NumberedButton(num_buttons, key, dev));
+        AddInput(new NumberedButton(num_buttons, key, dev, state));
       }
 
       ++num_buttons;
@@ -461,14 +627,14 @@ bool evdevDevice::AddNode(std::string devnode, int fd, libevdev* dev)
   {
     // If INPUT_PROP_ACCELEROMETER is set then X,Y,Z,RX,RY,RZ contain motion data.
 
-    auto add_motion_inputs = [&num_axis, dev, this](int first_code, double scale) {
+    auto add_motion_inputs = [&num_axis, dev, state, this](int first_code, double scale) {
       for (int i = 0; i != 3; ++i)
       {
         const int code = first_code + i;
         if (libevdev_has_event_code(dev, EV_ABS, code))
         {
-          AddInput(new MotionDataInput(code, scale * -1, dev));
-          AddInput(new MotionDataInput(code, scale, dev));
+          AddInput(new MotionDataInput(code, scale * -1, dev, state));
+          AddInput(new MotionDataInput(code, scale, dev, state));
 
           ++num_axis;
         }
@@ -488,11 +654,11 @@ bool evdevDevice::AddNode(std::string devnode, int fd, libevdev* dev)
 
   if (is_pointing_device)
   {
-    auto add_cursor_input = [&num_axis, dev, this](int code) {
+    auto add_cursor_input = [&num_axis, dev, state, this](int code) {
       if (libevdev_has_event_code(dev, EV_ABS, code))
       {
-        AddInput(new CursorInput(num_axis, code, false, dev));
-        AddInput(new CursorInput(num_axis, code, true, dev));
+        AddInput(new CursorInput(num_axis, code, false, dev, state));
+        AddInput(new CursorInput(num_axis, code, true, dev, state));
 
         ++num_axis;
       }
@@ -512,7 +678,8 @@ bool evdevDevice::AddNode(std::string devnode, int fd, libevdev* dev)
   {
     if (libevdev_has_event_code(dev, EV_ABS, axis))
     {
-      AddAnalogInputs(new Axis(num_axis, axis, false, dev), new Axis(num_axis, axis, true, dev));
+      AddAnalogInputs(new Axis(num_axis, axis, false, dev, state),
+                      new Axis(num_axis, axis, true, dev, state));
       ++num_axis;
     }
   }
@@ -609,30 +776,12 @@ evdevDevice::~evdevDevice()
   for (auto& node : m_nodes)
   {
     s_devnode_objects.erase(node.devnode);
+    UnregisterInputNode(node.fd);
     libevdev_free(node.device);
     close(node.fd);
   }
 }
 
-void evdevDevice::UpdateInput()
-{
-  // Run through all evdev events
-  // libevdev will keep track of the actual controller state internally which can be queried
-  // later with libevdev_fetch_event_value()
-  for (auto& node : m_nodes)
-  {
-    int rc = LIBEVDEV_READ_STATUS_SUCCESS;
-    while (rc >= 0)
-    {
-      input_event ev;
-      if (LIBEVDEV_READ_STATUS_SYNC == rc)
-        rc = libevdev_next_event(node.device, LIBEVDEV_READ_FLAG_SYNC, &ev);
-      else
-        rc = libevdev_next_event(node.device, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-    }
-  }
-}
-
 bool evdevDevice::IsValid() const
 {
   for (auto& node : m_nodes)
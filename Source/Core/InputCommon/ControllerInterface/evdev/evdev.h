@@ -5,6 +5,7 @@
 #pragma once
 
 #include <libevdev/libevdev.h>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -16,6 +17,8 @@ void Init();
 void PopulateDevices();
 void Shutdown();
 
+struct NodeState;
+
 class evdevDevice : public Core::Device
 {
 private:
@@ -73,7 +76,7 @@ private:
   };
 
 public:
-  void UpdateInput() override;
+  // There's no UpdateInput, the input thread reads the events as they arrive.
   bool IsValid() const override;
 
   ~evdevDevice();
@@ -95,6 +98,7 @@ private:
     std::string devnode;
     int fd;
     libevdev* device;
+    std::unique_ptr<NodeState> state;
   };
 
   std::vector<Node> m_nodes;
@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
+#include <condition_variable>
 #include <libusb.h>
 #include <mutex>
 
@@ -47,13 +49,29 @@ static std::array<u8, SerialInterface::MAX_SI_CHANNELS> s_controller_rumble{};
 
 static std::mutex s_mutex;
 static u8 s_controller_payload[37];
-static u8 s_controller_payload_swap[37];
 
 static std::atomic<int> s_controller_payload_size = {0};
 
-static std::thread s_adapter_input_thread;
+// Several reads are kept queued on the adapter, so that each report is taken as soon as it's
+// sent instead of only after the previous one has been handed over. They complete on the libusb
+// event thread, and are numbered in the order they were submitted so that an older report never
+// replaces a newer one. Everything below is guarded by s_mutex.
+constexpr size_t NUM_READ_TRANSFERS = 4;
+struct ReadTransfer
+{
+  libusb_transfer* transfer = nullptr;
+  u8 buffer[sizeof(s_controller_payload)];
+  u64 sequence = 0;
+};
+static std::array<ReadTransfer, NUM_READ_TRANSFERS> s_read_transfers;
+static u64 s_next_read_sequence = 0;
+static u64 s_controller_payload_sequence = 0;
+static size_t s_reads_in_flight = 0;
+static std::condition_variable s_reads_done;
+
 static std::thread s_adapter_output_thread;
 static Common::Flag s_adapter_thread_running;
+static Common::Flag s_adapter_reset_requested;
 
 static Common::Event s_rumble_data_available;
 
@@ -80,23 +98,81 @@ static u8 s_endpoint_out = 0;
 
 static u64 s_last_init = 0;
 
-static void Read()
+// Needs to be called with s_mutex locked.
+static bool SubmitRead(ReadTransfer* read)
 {
-  int payload_size = 0;
-  while (s_adapter_thread_running.IsSet())
+  read->sequence = s_next_read_sequence++;
+  const int err = libusb_submit_transfer(read->transfer);
+  if (err != 0)
   {
-    int err = libusb_interrupt_transfer(s_handle, s_endpoint_in, s_controller_payload_swap,
-                                        sizeof(s_controller_payload_swap), &payload_size, 16);
-    if (err)
-      ERROR_LOG_FMT(SERIALINTERFACE, "adapter libusb read failed: err={}", libusb_error_name(err));
+    ERROR_LOG_FMT(SERIALINTERFACE, "adapter libusb read failed: err={}", libusb_error_name(err));
+    return false;
+  }
+  return true;
+}
+
+static void LIBUSB_CALL ReadCallback(libusb_transfer* transfer)
+{
+  ReadTransfer* const read = static_cast<ReadTransfer*>(transfer->user_data);
 
+  std::lock_guard<std::mutex> lk(s_mutex);
+  if (transfer->status == LIBUSB_TRANSFER_COMPLETED)
+  {
+    if (read->sequence > s_controller_payload_sequence)
     {
-      std::lock_guard<std::mutex> lk(s_mutex);
-      std::swap(s_controller_payload_swap, s_controller_payload);
-      s_controller_payload_size.store(payload_size);
+      std::copy(std::begin(read->buffer), std::end(read->buffer), std::begin(s_controller_payload));
+      s_controller_payload_size.store(transfer->actual_length);
+      s_controller_payload_sequence = read->sequence;
     }
+  }
+  else if (transfer->status != LIBUSB_TRANSFER_CANCELLED)
+  {
+    ERROR_LOG_FMT(SERIALINTERFACE, "adapter libusb read failed: status={}",
+                  static_cast<int>(transfer->status));
+  }
 
-    Common::YieldCPU();
+  if (s_adapter_thread_running.IsSet() && transfer->status != LIBUSB_TRANSFER_CANCELLED &&
+      transfer->status != LIBUSB_TRANSFER_NO_DEVICE && SubmitRead(read))
+  {
+    return;
+  }
+
+  --s_reads_in_flight;
+  s_reads_done.notify_all();
+}
+
+static void StartReads()
+{
+  std::lock_guard<std::mutex> lk(s_mutex);
+  s_controller_payload_size.store(0);
+  s_controller_payload_sequence = 0;
+  s_next_read_sequence = 1;
+
+  for (ReadTransfer& read : s_read_transfers)
+  {
+    read.transfer = libusb_alloc_transfer(0);
+    libusb_fill_interrupt_transfer(read.transfer, s_handle, s_endpoint_in, read.buffer,
+                                   sizeof(read.buffer), ReadCallback, &read, 0);
+    if (SubmitRead(&read))
+      ++s_reads_in_flight;
+  }
+}
+
+// Must not be called from the libusb event thread, which completes the cancelled reads.
+static void StopReads()
+{
+  std::unique_lock<std::mutex> lk(s_mutex);
+  for (ReadTransfer& read : s_read_transfers)
+  {
+    if (read.transfer)
+      libusb_cancel_transfer(read.transfer);
+  }
+  s_reads_done.wait(lk, [] { return s_reads_in_flight == 0; });
+
+  for (ReadTransfer& read : s_read_transfers)
+  {
+    libusb_free_transfer(read.transfer);
+    read.transfer = nullptr;
   }
 }
 
@@ -136,8 +212,12 @@ static int HotplugCallback(libusb_context* ctx, libusb_device* dev, libusb_hotpl
   }
   else if (event == LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT)
   {
+    // This runs on the libusb event thread, which Reset waits on to finish the reads.
     if (s_handle != nullptr && libusb_get_device(s_handle) == dev)
-      Reset();
+    {
+      s_adapter_reset_requested.Set();
+      s_hotplug_event.Set();
+    }
 
     // Reset a potential error status now that the adapter is unplugged
     if (s_status < 0)
@@ -176,6 +256,9 @@ static void ScanThreadFunc()
 
   while (s_adapter_detect_thread_running.IsSet())
   {
+    if (s_adapter_reset_requested.TestAndClear())
+      Reset();
+
     if (s_handle == nullptr)
     {
       std::lock_guard<std::mutex> lk(s_init_mutex);
@@ -362,7 +445,7 @@ static void AddGCAdapter(libusb_device* device)
   libusb_interrupt_transfer(s_handle, s_endpoint_out, &payload, sizeof(payload), &tmp, 16);
 
   s_adapter_thread_running.Set(true);
-  s_adapter_input_thread = std::thread(Read);
+  StartReads();
   s_adapter_output_thread = std::thread(Write);
 
   s_status = ADAPTER_DETECTED;
@@ -394,7 +477,7 @@ static void Reset()
   if (s_adapter_thread_running.TestAndClear())
   {
     s_rumble_data_available.Set();
-    s_adapter_input_thread.join();
+    StopReads();
     s_adapter_output_thread.join();
   }
 
@@ -31,6 +31,7 @@
 #include "Common/IOFile.h"
 #include "Common/Image.h"
 #include "Common/IniFile.h"
+#include "Common/MappedFile.h"
 #include "Common/MsgHandler.h"
 #include "Common/NandPaths.h"
 #include "Common/StringUtil.h"
@@ -115,6 +116,10 @@ GameFile::GameFile(std::string path) : m_file_path(std::move(path))
 {
   m_file_name = PathToFileName(m_file_path);
 
+  const File::FileInfo file_info(m_file_path);
+  m_host_file_size = file_info.GetSize();
+  m_host_modification_time = file_info.GetModificationTime();
+
   {
     std::unique_ptr<DiscIO::Volume> volume(DiscIO::CreateVolume(m_file_path));
     if (volume != nullptr)
@@ -147,7 +152,9 @@ GameFile::GameFile(std::string path) : m_file_path(std::move(path))
       m_disc_number = volume->GetDiscNumber().value_or(0);
       m_apploader_date = volume->GetApploaderDate();
 
-      m_volume_banner.buffer = volume->GetBanner(&m_volume_banner.width, &m_volume_banner.height);
+      GameBanner banner;
+      banner.buffer = volume->GetBanner(&banner.width, &banner.height);
+      m_volume_banner = std::move(banner);
 
       m_valid = true;
     }
@@ -168,6 +175,13 @@ GameFile::GameFile(std::string path) : m_file_path(std::move(path))
 
 GameFile::~GameFile() = default;
 
+bool GameFile::FileChanged() const
+{
+  const File::FileInfo file_info(m_file_path);
+  return file_info.GetSize() != m_host_file_size ||
+         file_info.GetModificationTime() != m_host_modification_time;
+}
+
 bool GameFile::IsValid() const
 {
   if (!m_valid)
@@ -181,7 +195,7 @@ bool GameFile::IsValid() const
 
 bool GameFile::CustomCoverChanged()
 {
-  if (!m_custom_cover.buffer.empty() || !UseGameCovers())
+  if (!m_custom_cover.empty() || !UseGameCovers())
     return false;
 
   std::string path, name;
@@ -208,7 +222,7 @@ bool GameFile::CustomCoverChanged()
 
 void GameFile::DownloadDefaultCover()
 {
-  if (!m_default_cover.buffer.empty() || !UseGameCovers())
+  if (!m_default_cover.empty() || !UseGameCovers())
     return;
 
   const auto cover_path = File::GetUserPath(D_COVERCACHE_IDX) + DIR_SEP;
@@ -274,7 +288,7 @@ void GameFile::DownloadDefaultCover()
 
 bool GameFile::DefaultCoverChanged()
 {
-  if (!m_default_cover.buffer.empty() || !UseGameCovers())
+  if (!m_default_cover.empty() || !UseGameCovers())
     return false;
 
   const auto cover_path = File::GetUserPath(D_COVERCACHE_IDX) + DIR_SEP;
@@ -301,23 +315,83 @@ void GameFile::DefaultCoverCommit()
   m_default_cover = std::move(m_pending.default_cover);
 }
 
-void GameBanner::DoState(PointerWrap& p)
+static void DoImageMetadata(PointerWrap& p, GameBanner& banner)
 {
-  p.Do(buffer);
-  p.Do(width);
-  p.Do(height);
+  p.Do(banner.width);
+  p.Do(banner.height);
+}
+
+static void DoImageMetadata(PointerWrap&, GameCover&)
+{
+}
+
+template <typename T>
+T GameFileImage<T>::Get() const
+{
+  if (!m_mapping)
+    return m_image;
+
+  using Element = typename decltype(m_image.buffer)::value_type;
+  T image = m_image;
+  image.buffer.resize(m_mapped_size / sizeof(Element));
+  std::memcpy(image.buffer.data(), m_mapped_data, image.buffer.size() * sizeof(Element));
+  return image;
 }
 
-void GameCover::DoState(PointerWrap& p)
+template <typename T>
+void GameFileImage<T>::DoState(PointerWrap& p, GameFileImageSection* section)
 {
-  p.Do(buffer);
+  DoImageMetadata(p, m_image);
+
+  u64 offset = section->size;
+  u64 size = 0;
+  if (p.GetMode() != PointerWrap::MODE_READ)
+  {
+    const u8* data = m_mapped_data;
+    size = m_mapped_size;
+    if (!m_mapping)
+    {
+      data = reinterpret_cast<const u8*>(m_image.buffer.data());
+      size = m_image.buffer.size() * sizeof(m_image.buffer[0]);
+    }
+    if (p.GetMode() == PointerWrap::MODE_WRITE)
+      section->spans.emplace_back(data, static_cast<size_t>(size));
+    section->size += size;
+  }
+  p.Do(offset);
+  p.Do(size);
+
+  if (p.GetMode() == PointerWrap::MODE_READ)
+  {
+    m_image.buffer.clear();
+    m_mapping.reset();
+    m_mapped_data = nullptr;
+    m_mapped_size = 0;
+    if (size == 0)
+      return;
+
+    if (!section->mapping || offset > section->mapping->GetSize() ||
+        size > section->mapping->GetSize() - offset)
+    {
+      p.SetMode(PointerWrap::MODE_MEASURE);
+      return;
+    }
+    m_mapping = section->mapping;
+    m_mapped_data = m_mapping->GetData() + offset;
+    m_mapped_size = static_cast<size_t>(size);
+  }
 }
 
-void GameFile::DoState(PointerWrap& p)
+template class GameFileImage<GameBanner>;
+template class GameFileImage<GameCover>;
+
+void GameFile::DoState(PointerWrap& p, GameFileImageSection* images)
 {
   p.Do(m_valid);
   p.Do(m_file_path);
   p.Do(m_file_name);
+  p.Do(m_host_file_size);
+  p.Do(m_host_modification_time);
 
   p.Do(m_file_size);
   p.Do(m_volume_size);
@@ -349,10 +423,10 @@ void GameFile::DoState(PointerWrap& p)
   p.Do(m_custom_name);
   p.Do(m_custom_description);
   p.Do(m_custom_maker);
-  m_volume_banner.DoState(p);
-  m_custom_banner.DoState(p);
-  m_default_cover.DoState(p);
-  m_custom_cover.DoState(p);
+  m_volume_banner.DoState(p, images);
+  m_custom_banner.DoState(p, images);
+  m_default_cover.DoState(p, images);
+  m_custom_cover.DoState(p, images);
 }
 
 std::string GameFile::GetExtension() const
@@ -488,7 +562,7 @@ bool GameFile::CustomBannerChanged()
     }
   }
 
-  return m_pending.custom_banner != m_custom_banner;
+  return m_pending.custom_banner != m_custom_banner.Get();
 }
 
 void GameFile::CustomBannerCommit()
@@ -700,14 +774,14 @@ bool GameFile::ShouldAllowConversion() const
   return DiscIO::IsDisc(m_platform) && m_volume_size_is_accurate;
 }
 
-const GameBanner& GameFile::GetBannerImage() const
+GameBanner GameFile::GetBannerImage() const
 {
-  return m_custom_banner.empty() ? m_volume_banner : m_custom_banner;
+  return m_custom_banner.empty() ? m_volume_banner.Get() : m_custom_banner.Get();
 }
 
-const GameCover& GameFile::GetCoverImage() const
+GameCover GameFile::GetCoverImage() const
 {
-  return m_custom_cover.empty() ? m_default_cover : m_custom_cover;
+  return m_custom_cover.empty() ? m_default_cover.Get() : m_custom_cover.Get();
 }
 
 }  // namespace UICommon
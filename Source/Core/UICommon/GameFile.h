@@ -6,7 +6,9 @@
 
 #include <array>
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -21,6 +23,11 @@ namespace Core
 class TitleDatabase;
 }
 
+namespace File
+{
+class MappedFile;
+}
+
 namespace UICommon
 {
 struct GameBanner
@@ -29,14 +36,45 @@ struct GameBanner
   u32 width{};
   u32 height{};
   bool empty() const { return buffer.empty(); }
-  void DoState(PointerWrap& p);
 };
 
 struct GameCover
 {
   std::vector<u8> buffer;
   bool empty() const { return buffer.empty(); }
-  void DoState(PointerWrap& p);
+};
+
+// The pixel data of the images in a game list cache, which GameFileCache stores in a file of its
+// own so that it can be memory mapped instead of read.
+struct GameFileImageSection
+{
+  // Used when reading
+  std::shared_ptr<const File::MappedFile> mapping;
+  // Used when writing: the data of every image, in the order it has to be written in
+  std::vector<std::pair<const u8*, size_t>> spans;
+  u64 size = 0;
+};
+
+// An image of a GameFile. Images of GameFiles that were loaded from the game list cache stay in
+// the memory mapped cache file, and are only copied out of it when they are used.
+template <typename T>
+class GameFileImage
+{
+public:
+  GameFileImage() = default;
+  GameFileImage(T image) : m_image(std::move(image)) {}
+
+  T Get() const;
+  bool empty() const { return m_mapping ? m_mapped_size == 0 : m_image.empty(); }
+
+  void DoState(PointerWrap& p, GameFileImageSection* section);
+
+private:
+  // Everything but the pixel data if the image is mapped
+  T m_image;
+  std::shared_ptr<const File::MappedFile> m_mapping;
+  const u8* m_mapped_data = nullptr;
+  size_t m_mapped_size = 0;
 };
 
 bool operator==(const GameBanner& lhs, const GameBanner& rhs);
@@ -58,6 +96,8 @@ public:
   ~GameFile();
 
   bool IsValid() const;
+  // Returns true if the size or modification time of the file differs from when it was read.
+  bool FileChanged() const;
   const std::string& GetFilePath() const { return m_file_path; }
   const std::string& GetFileName() const { return m_file_name; }
   const std::string& GetName(const Core::TitleDatabase& title_database) const;
@@ -107,9 +147,9 @@ public:
   u64 GetVolumeSize() const { return m_volume_size; }
   bool IsVolumeSizeAccurate() const { return m_volume_size_is_accurate; }
   bool IsDatelDisc() const { return m_is_datel_disc; }
-  const GameBanner& GetBannerImage() const;
-  const GameCover& GetCoverImage() const;
-  void DoState(PointerWrap& p);
+  GameBanner GetBannerImage() const;
+  GameCover GetCoverImage() const;
+  void DoState(PointerWrap& p, GameFileImageSection* images);
   bool XMLMetadataChanged();
   void XMLMetadataCommit();
   bool WiiBannerChanged();
@@ -140,6 +180,8 @@ private:
   bool m_valid{};
   std::string m_file_path;
   std::string m_file_name;
+  u64 m_host_file_size{};
+  s64 m_host_modification_time{};
 
   u64 m_file_size{};
   u64 m_volume_size{};
@@ -171,10 +213,10 @@ private:
   std::string m_custom_name;
   std::string m_custom_description;
   std::string m_custom_maker;
-  GameBanner m_volume_banner{};
-  GameBanner m_custom_banner{};
-  GameCover m_default_cover{};
-  GameCover m_custom_cover{};
+  GameFileImage<GameBanner> m_volume_banner{};
+  GameFileImage<GameBanner> m_custom_banner{};
+  GameFileImage<GameCover> m_default_cover{};
+  GameFileImage<GameCover> m_custom_cover{};
 
   // The following data members allow GameFileCache to construct updated versions
   // of GameFiles in a threadsafe way. They should not be handled in DoState.
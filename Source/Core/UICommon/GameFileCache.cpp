@@ -5,8 +5,10 @@
 #include "UICommon/GameFileCache.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <functional>
+#include <future>
 #include <list>
 #include <memory>
 #include <mutex>
@@ -15,11 +17,15 @@
 #include <utility>
 #include <vector>
 
+#include <fmt/format.h>
+
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/FileSearch.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
+#include "Common/MappedFile.h"
+#include "Common/StringUtil.h"
 
 #include "DiscIO/DirectoryBlob.h"
 
@@ -27,7 +33,31 @@
 
 namespace UICommon
 {
-static constexpr u32 CACHE_REVISION = 20;  // Last changed in PR 9461
+static constexpr u32 CACHE_REVISION = 22;  // Last changed for the separate image file
+
+// Reading game files mostly waits for storage rather than the CPU, so this is independent of the
+// number of cores. It's only there to keep slow (for instance network) storage from being
+// flooded with more requests than it can serve at once.
+static constexpr size_t MAX_SCAN_THREADS = 8;
+
+// Calls f(i) for every i in [0, count) on up to MAX_SCAN_THREADS threads, using the calling
+// thread as one of them, and waits for all of them to return
+template <typename F>
+static void ParallelFor(size_t count, const std::atomic_bool& processing_halted, F f)
+{
+  std::atomic<size_t> next_index{0};
+  const auto worker = [&] {
+    for (size_t i = next_index++; i < count && !processing_halted; i = next_index++)
+      f(i);
+  };
+
+  std::vector<std::future<void>> futures;
+  for (size_t i = 1; i < std::min(count, MAX_SCAN_THREADS); ++i)
+    futures.emplace_back(std::async(std::launch::async, worker));
+  worker();
+  for (std::future<void>& future : futures)
+    future.wait();
+}
 
 std::vector<std::string> FindAllGamePaths(const std::vector<std::string>& directories_to_scan,
                                           bool recursive_scan)
@@ -61,7 +91,10 @@ size_t GameFileCache::GetSize() const
 void GameFileCache::Clear(DeleteOnDisk delete_on_disk)
 {
   if (delete_on_disk != DeleteOnDisk::No)
+  {
     File::Delete(m_path);
+    DeleteImageFiles(false);
+  }
 
   m_cached_files.clear();
 }
@@ -108,6 +141,8 @@ bool GameFileCache::Update(
 
   // Delete paths that aren't in game_paths from m_cached_files,
   // while simultaneously deleting paths that are in m_cached_files from game_paths.
+  // Files that changed since they were cached are deleted from m_cached_files but stay in
+  // game_paths, so that they are read again.
   // For the sake of speed, we don't care about maintaining the order of m_cached_files.
   {
     auto it = m_cached_files.begin();
@@ -117,8 +152,10 @@ bool GameFileCache::Update(
       if (processing_halted)
         break;
 
-      if (game_paths.erase((*it)->GetFilePath()))
+      const auto path_it = game_paths.find((*it)->GetFilePath());
+      if (path_it != game_paths.end() && !(*it)->FileChanged())
       {
+        game_paths.erase(path_it);
         ++it;
       }
       else
@@ -136,21 +173,20 @@ bool GameFileCache::Update(
 
   // Now that the previous loop has run, game_paths only contains paths that
   // aren't in m_cached_files, so we simply add all of them to m_cached_files.
-  for (const std::string& path : game_paths)
-  {
-    if (processing_halted)
-      break;
+  const std::vector<std::string> paths_to_add(game_paths.begin(), game_paths.end());
+  std::mutex mutex;
+  ParallelFor(paths_to_add.size(), processing_halted, [&](size_t i) {
+    auto file = std::make_shared<GameFile>(paths_to_add[i]);
+    if (!file->IsValid())
+      return;
 
-    auto file = std::make_shared<GameFile>(path);
-    if (file->IsValid())
-    {
-      if (game_added_to_cache)
-        game_added_to_cache(file);
+    std::lock_guard lk(mutex);
+    if (game_added_to_cache)
+      game_added_to_cache(file);
 
-      cache_changed = true;
-      m_cached_files.push_back(std::move(file));
-    }
-  }
+    cache_changed = true;
+    m_cached_files.push_back(std::move(file));
+  });
 
   return cache_changed;
 }
@@ -161,16 +197,18 @@ bool GameFileCache::UpdateAdditionalMetadata(
 {
   bool cache_changed = false;
 
-  for (std::shared_ptr<GameFile>& file : m_cached_files)
-  {
-    if (processing_halted)
-      break;
+  // Every call only replaces its own element of m_cached_files, so only the results need a lock.
+  std::mutex mutex;
+  ParallelFor(m_cached_files.size(), processing_halted, [&](size_t i) {
+    std::shared_ptr<GameFile>& file = m_cached_files[i];
+    if (!UpdateAdditionalMetadata(&file))
+      return;
 
-    const bool updated = UpdateAdditionalMetadata(&file);
-    cache_changed |= updated;
-    if (game_updated && updated)
+    std::lock_guard lk(mutex);
+    cache_changed = true;
+    if (game_updated)
       game_updated(file);
-  }
+  });
 
   return cache_changed;
 }
@@ -222,57 +260,96 @@ bool GameFileCache::Save()
   return SyncCacheFile(true);
 }
 
+std::string GameFileCache::GetImagesPath(u64 generation) const
+{
+  return fmt::format("{}.images.{}", m_path, generation);
+}
+
+void GameFileCache::DeleteImageFiles(bool keep_current) const
+{
+  std::string directory, name, extension;
+  SplitPath(m_path, &directory, &name, &extension);
+  const std::string prefix = name + extension + ".images.";
+  const std::string current = prefix + std::to_string(m_images_generation);
+
+  // Files that are still mapped can't be deleted on Windows. They are tried again the next time.
+  for (const File::FSTEntry& entry : File::ScanDirectoryTree(directory, false).children)
+  {
+    if (!entry.isDirectory && StringBeginsWith(entry.virtualName, prefix) &&
+        (!keep_current || entry.virtualName != current))
+    {
+      File::Delete(entry.physicalName);
+    }
+  }
+}
+
 bool GameFileCache::SyncCacheFile(bool save)
 {
-  const char* open_mode = save ? "wb" : "rb";
-  File::IOFile f(m_path, open_mode);
-  if (!f)
-    return false;
   bool success = false;
   if (save)
   {
     // Measure the size of the buffer.
+    GameFileImageSection images;
     u8* ptr = nullptr;
     PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
-    DoState(&p);
+    DoState(&p, &images);
     const size_t buffer_size = reinterpret_cast<size_t>(ptr);
+    const u64 images_size = images.size;
 
     // Then actually do the write.
+    images = {};
     std::vector<u8> buffer(buffer_size);
-    ptr = &buffer[0];
+    ptr = buffer.data();
     p.SetMode(PointerWrap::MODE_WRITE);
-    DoState(&p, buffer_size);
-    if (f.WriteBytes(buffer.data(), buffer.size()))
-      success = true;
+    const u64 old_generation = m_images_generation++;
+    DoState(&p, &images, buffer_size, images_size);
+
+    File::IOFile images_file;
+    if (images_size != 0)
+      images_file.Open(GetImagesPath(m_images_generation), "wb");
+    success = images_size == 0 || images_file.IsOpen();
+    for (const auto& [data, size] : images.spans)
+      success = success && images_file.WriteBytes(data, size);
+    images_file.Close();
+
+    success = success && File::IOFile(m_path, "wb").WriteBytes(buffer.data(), buffer.size());
+    if (success)
+      DeleteImageFiles(true);
+    else
+      m_images_generation = old_generation;
   }
   else
   {
-    std::vector<u8> buffer(f.GetSize());
-    if (!buffer.empty() && f.ReadBytes(buffer.data(), buffer.size()))
-    {
-      u8* ptr = buffer.data();
-      PointerWrap p(&ptr, PointerWrap::MODE_READ);
-      DoState(&p, buffer.size());
-      if (p.GetMode() == PointerWrap::MODE_READ)
-        success = true;
-    }
+    // The cache is only mapped while being read, so that it can be replaced while the images
+    // remain mapped.
+    File::MappedFile mapped_file;
+    if (!mapped_file.Open(m_path))
+      return false;
+
+    GameFileImageSection images;
+    u8* ptr = const_cast<u8*>(mapped_file.GetData());
+    PointerWrap p(&ptr, PointerWrap::MODE_READ);
+    DoState(&p, &images, mapped_file.GetSize());
+    success = p.GetMode() == PointerWrap::MODE_READ;
   }
   if (!success)
   {
     // If some file operation failed, try to delete the probably-corrupted cache
-    f.Close();
     File::Delete(m_path);
   }
   return success;
 }
 
-void GameFileCache::DoState(PointerWrap* p, u64 size)
+void GameFileCache::DoState(PointerWrap* p, GameFileImageSection* images, u64 size,
+                            u64 images_size)
 {
   struct
   {
     u32 revision;
     u64 expected_size;
-  } header = {CACHE_REVISION, size};
+    u64 images_generation;
+    u64 images_size;
+  } header = {CACHE_REVISION, size, m_images_generation, images_size};
   p->Do(header);
   if (p->GetMode() == PointerWrap::MODE_READ)
   {
@@ -281,11 +358,24 @@ void GameFileCache::DoState(PointerWrap* p, u64 size)
       p->SetMode(PointerWrap::MODE_MEASURE);
       return;
     }
+
+    m_images_generation = header.images_generation;
+    if (header.images_size != 0)
+    {
+      auto mapping = std::make_shared<File::MappedFile>();
+      if (!mapping->Open(GetImagesPath(header.images_generation)) ||
+          mapping->GetSize() != header.images_size)
+      {
+        p->SetMode(PointerWrap::MODE_MEASURE);
+        return;
+      }
+      images->mapping = std::move(mapping);
+    }
   }
-  p->DoEachElement(m_cached_files, [](PointerWrap& state, std::shared_ptr<GameFile>& elem) {
+  p->DoEachElement(m_cached_files, [images](PointerWrap& state, std::shared_ptr<GameFile>& elem) {
     if (state.GetMode() == PointerWrap::MODE_READ)
       elem = std::make_shared<GameFile>();
-    elem->DoState(state);
+    elem->DoState(state, images);
   });
 }
 
@@ -18,6 +18,7 @@ class PointerWrap;
 namespace UICommon
 {
 class GameFile;
+struct GameFileImageSection;
 
 std::vector<std::string> FindAllGamePaths(const std::vector<std::string>& directories_to_scan,
                                           bool recursive_scan);
@@ -57,11 +58,17 @@ public:
 private:
   bool UpdateAdditionalMetadata(std::shared_ptr<GameFile>* game_file);
 
+  std::string GetImagesPath(u64 generation) const;
+  void DeleteImageFiles(bool keep_current) const;
+
   bool SyncCacheFile(bool save);
-  void DoState(PointerWrap* p, u64 size = 0);
+  void DoState(PointerWrap* p, GameFileImageSection* images, u64 size = 0, u64 images_size = 0);
 
   std::string m_path;
   std::vector<std::shared_ptr<GameFile>> m_cached_files;
+  // The images are written to a new file (with a new generation number) every time the cache is
+  // saved, since the previous file may still be mapped by GameFiles that are in use.
+  u64 m_images_generation = 0;
 };
 
 }  // namespace UICommon
@@ -63,8 +63,18 @@ void PerfQuery::DisableQuery(PerfQueryGroup type)
 
 void PerfQuery::ResetQuery()
 {
+  if (IsLatencyTolerant())
+  {
+    WeakFlush();
+    while (HasPendingPreviousPeriod())
+      FlushOne();
+
+    BeginQueryPeriod();
+    return;
+  }
+
   m_query_count = 0;
-  std::fill(std::begin(m_results), std::end(m_results), 0);
+  ClearResults();
 }
 
 u32 PerfQuery::GetQueryResult(PerfQueryType type)
@@ -72,13 +82,13 @@ u32 PerfQuery::GetQueryResult(PerfQueryType type)
   u32 result = 0;
 
   if (type == PQ_ZCOMP_INPUT_ZCOMPLOC || type == PQ_ZCOMP_OUTPUT_ZCOMPLOC)
-    result = m_results[PQG_ZCOMP_ZCOMPLOC];
+    result = GetGroupResult(PQG_ZCOMP_ZCOMPLOC);
   else if (type == PQ_ZCOMP_INPUT || type == PQ_ZCOMP_OUTPUT)
-    result = m_results[PQG_ZCOMP];
+    result = GetGroupResult(PQG_ZCOMP);
   else if (type == PQ_BLEND_INPUT)
-    result = m_results[PQG_ZCOMP] + m_results[PQG_ZCOMP_ZCOMPLOC];
+    result = GetGroupResult(PQG_ZCOMP) + GetGroupResult(PQG_ZCOMP_ZCOMPLOC);
   else if (type == PQ_EFB_COPY_CLOCKS)
-    result = m_results[PQG_EFB_COPY_CLOCKS];
+    result = GetGroupResult(PQG_EFB_COPY_CLOCKS);
 
   return result;
 }
@@ -98,8 +108,8 @@ void PerfQuery::FlushOne()
   // NOTE: Reported pixel metrics should be referenced to native resolution
   // TODO: Dropping the lower 2 bits from this count should be closer to actual
   // hardware behavior when drawing triangles.
-  m_results[entry.query_type] += (u32)(result * EFB_WIDTH / g_renderer->GetTargetWidth() *
-                                       EFB_HEIGHT / g_renderer->GetTargetHeight());
+  AccumulateResult(entry.query_type, (u32)(result * EFB_WIDTH / g_renderer->GetTargetWidth() *
+                                           EFB_HEIGHT / g_renderer->GetTargetHeight()));
 
   m_query_read_pos = (m_query_read_pos + 1) % m_query_buffer.size();
   --m_query_count;
@@ -125,8 +135,9 @@ void PerfQuery::WeakFlush()
     if (hr == S_OK)
     {
       // NOTE: Reported pixel metrics should be referenced to native resolution
-      m_results[entry.query_type] += (u32)(result * EFB_WIDTH / g_renderer->GetTargetWidth() *
-                                           EFB_HEIGHT / g_renderer->GetTargetHeight());
+      AccumulateResult(entry.query_type,
+                       (u32)(result * EFB_WIDTH / g_renderer->GetTargetWidth() * EFB_HEIGHT /
+                             g_renderer->GetTargetHeight()));
 
       m_query_read_pos = (m_query_read_pos + 1) % m_query_buffer.size();
       --m_query_count;
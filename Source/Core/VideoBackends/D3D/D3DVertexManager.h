@@ -48,18 +48,19 @@ protected:
   void ResetBuffer(u32 vertex_stride) override;
   void CommitBuffer(u32 num_vertices, u32 vertex_stride, u32 num_indices, u32* out_base_vertex,
                     u32* out_base_index) override;
+  void DiscardBuffer() override;
   void UploadUniforms() override;
 
 private:
-  static constexpr u32 BUFFER_COUNT = 2;
-  static constexpr u32 BUFFER_SIZE =
-      (VERTEX_STREAM_BUFFER_SIZE + INDEX_STREAM_BUFFER_SIZE) / BUFFER_COUNT;
-
   bool MapTexelBuffer(u32 required_size, D3D11_MAPPED_SUBRESOURCE& sr);
 
-  ComPtr<ID3D11Buffer> m_buffers[BUFFER_COUNT] = {};
-  u32 m_current_buffer = 0;
-  u32 m_buffer_cursor = 0;
+  // The vertex loader and index generator write straight into these while they're mapped, from
+  // ResetBuffer() until CommitBuffer().
+  ComPtr<ID3D11Buffer> m_vertex_buffer = nullptr;
+  ComPtr<ID3D11Buffer> m_index_buffer = nullptr;
+  u32 m_vertex_buffer_cursor = 0;
+  u32 m_index_buffer_cursor = 0;
+  bool m_buffers_mapped = false;
 
   ComPtr<ID3D11Buffer> m_vertex_constant_buffer = nullptr;
   ComPtr<ID3D11Buffer> m_geometry_constant_buffer = nullptr;
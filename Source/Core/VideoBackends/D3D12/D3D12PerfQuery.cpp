@@ -70,6 +70,7 @@ void PerfQuery::EnableQuery(PerfQueryGroup type)
     ActiveQuery& entry = m_query_buffer[m_query_next_pos];
     ASSERT(!entry.has_value && !entry.resolved);
     entry.has_value = true;
+    entry.query_type = type;
 
     g_dx_context->GetCommandList()->BeginQuery(m_query_heap.Get(), D3D12_QUERY_TYPE_OCCLUSION,
                                                m_query_next_pos);
@@ -90,12 +91,23 @@ void PerfQuery::DisableQuery(PerfQueryGroup type)
 
 void PerfQuery::ResetQuery()
 {
+  if (IsLatencyTolerant())
+  {
+    ReadbackQueries(false);
+    while (HasPendingPreviousPeriod())
+      PartialFlush(true, true);
+
+    BeginQueryPeriod();
+    if (m_query_count > 0)
+      return;
+  }
+
   m_query_count = 0;
   m_unresolved_queries = 0;
   m_query_resolve_pos = 0;
   m_query_readback_pos = 0;
   m_query_next_pos = 0;
-  std::fill(std::begin(m_results), std::end(m_results), 0);
+  ClearResults();
   for (auto& entry : m_query_buffer)
   {
     entry.fence_value = 0;
@@ -108,13 +120,13 @@ u32 PerfQuery::GetQueryResult(PerfQueryType type)
 {
   u32 result = 0;
   if (type == PQ_ZCOMP_INPUT_ZCOMPLOC || type == PQ_ZCOMP_OUTPUT_ZCOMPLOC)
-    result = m_results[PQG_ZCOMP_ZCOMPLOC];
+    result = GetGroupResult(PQG_ZCOMP_ZCOMPLOC);
   else if (type == PQ_ZCOMP_INPUT || type == PQ_ZCOMP_OUTPUT)
-    result = m_results[PQG_ZCOMP];
+    result = GetGroupResult(PQG_ZCOMP);
   else if (type == PQ_BLEND_INPUT)
-    result = m_results[PQG_ZCOMP] + m_results[PQG_ZCOMP_ZCOMPLOC];
+    result = GetGroupResult(PQG_ZCOMP) + GetGroupResult(PQG_ZCOMP_ZCOMPLOC);
   else if (type == PQ_EFB_COPY_CLOCKS)
-    result = m_results[PQG_EFB_COPY_CLOCKS];
+    result = GetGroupResult(PQG_EFB_COPY_CLOCKS);
 
   return result / 4;
 }
@@ -231,9 +243,10 @@ void PerfQuery::AccumulateQueriesFromBuffer(u32 query_count)
     std::memcpy(&result, mapped_ptr + (index * sizeof(PerfQueryDataType)), sizeof(result));
 
     // NOTE: Reported pixel metrics should be referenced to native resolution
-    m_results[entry.query_type] +=
-        static_cast<u32>(static_cast<u64>(result) * EFB_WIDTH / g_renderer->GetTargetWidth() *
-                         EFB_HEIGHT / g_renderer->GetTargetHeight());
+    AccumulateResult(entry.query_type,
+                     static_cast<u32>(static_cast<u64>(result) * EFB_WIDTH /
+                                      g_renderer->GetTargetWidth() * EFB_HEIGHT /
+                                      g_renderer->GetTargetHeight()));
   }
 
   constexpr D3D12_RANGE write_range = {0, 0};
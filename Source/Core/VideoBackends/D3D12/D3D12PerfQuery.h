@@ -32,7 +32,7 @@ private:
   struct ActiveQuery
   {
     u64 fence_value;
-    PerfQueryType query_type;
+    PerfQueryGroup query_type;
     bool has_value;
     bool resolved;
   };
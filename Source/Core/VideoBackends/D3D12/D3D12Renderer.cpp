@@ -666,16 +666,12 @@ void Renderer::UpdateDescriptorTables()
 
 bool Renderer::UpdateSRVDescriptorTable()
 {
-  static constexpr std::array<UINT, MAX_TEXTURES> src_sizes = {1, 1, 1, 1, 1, 1, 1, 1};
-  DescriptorHandle dst_base_handle;
-  const UINT dst_handle_sizes = 8;
-  if (!g_dx_context->GetDescriptorAllocator()->Allocate(MAX_TEXTURES, &dst_base_handle))
+  if (!g_dx_context->GetDescriptorAllocator()->GetSRVTableHandle(m_state.textures,
+                                                                 &m_state.srv_descriptor_base))
+  {
     return false;
+  }
 
-  g_dx_context->GetDevice()->CopyDescriptors(
-      1, &dst_base_handle.cpu_handle, &dst_handle_sizes, MAX_TEXTURES, m_state.textures.data(),
-      src_sizes.data(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-  m_state.srv_descriptor_base = dst_base_handle.gpu_handle;
   m_dirty_bits = (m_dirty_bits & ~DirtyState_Textures) | DirtyState_SRV_Descriptor;
   return true;
 }
@@ -100,7 +100,7 @@ protected:
   void OnConfigChanged(u32 bits) override;
 
 private:
-  static const u32 MAX_TEXTURES = 8;
+  static const u32 MAX_TEXTURES = DescriptorAllocator::NUM_DESCRIPTORS_PER_SRV_TABLE;
   static const u32 NUM_CONSTANT_BUFFERS = 3;
 
   // Dirty bits
@@ -157,7 +157,7 @@ private:
     ID3D12RootSignature* root_signature = nullptr;
     DXShader* compute_shader = nullptr;
     std::array<D3D12_GPU_VIRTUAL_ADDRESS, 3> constant_buffers = {};
-    std::array<D3D12_CPU_DESCRIPTOR_HANDLE, MAX_TEXTURES> textures = {};
+    DescriptorAllocator::SRVTable textures = {};
     D3D12_CPU_DESCRIPTOR_HANDLE ps_uav = {};
     SamplerStateSet samplers = {};
     const DXTexture* compute_image_texture = nullptr;
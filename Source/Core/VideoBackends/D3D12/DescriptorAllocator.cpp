@@ -44,6 +44,37 @@ bool DescriptorAllocator::Allocate(u32 num_handles, DescriptorHandle* out_base_h
 void DescriptorAllocator::Reset()
 {
   m_current_offset = 0;
+  m_srv_table_map.clear();
+}
+
+bool DescriptorAllocator::GetSRVTableHandle(const SRVTable& srvs,
+                                            D3D12_GPU_DESCRIPTOR_HANDLE* handle)
+{
+  std::array<SIZE_T, NUM_DESCRIPTORS_PER_SRV_TABLE> key;
+  for (u32 i = 0; i < NUM_DESCRIPTORS_PER_SRV_TABLE; i++)
+    key[i] = srvs[i].ptr;
+
+  auto it = m_srv_table_map.find(key);
+  if (it != m_srv_table_map.end())
+  {
+    *handle = it->second;
+    return true;
+  }
+
+  DescriptorHandle allocation;
+  if (!Allocate(NUM_DESCRIPTORS_PER_SRV_TABLE, &allocation))
+    return false;
+
+  static constexpr std::array<UINT, NUM_DESCRIPTORS_PER_SRV_TABLE> source_sizes = {
+      {1, 1, 1, 1, 1, 1, 1, 1}};
+  const UINT dest_size = NUM_DESCRIPTORS_PER_SRV_TABLE;
+  g_dx_context->GetDevice()->CopyDescriptors(1, &allocation.cpu_handle, &dest_size,
+                                             NUM_DESCRIPTORS_PER_SRV_TABLE, srvs.data(),
+                                             source_sizes.data(),
+                                             D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+  *handle = allocation.gpu_handle;
+  m_srv_table_map.emplace(key, allocation.gpu_handle);
+  return true;
 }
 
 bool operator==(const SamplerStateSet& lhs, const SamplerStateSet& rhs)
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <map>
 #include "VideoBackends/D3D12/DescriptorHeapManager.h"
 
@@ -12,6 +13,9 @@ namespace DX12
 class DescriptorAllocator
 {
 public:
+  static const u32 NUM_DESCRIPTORS_PER_SRV_TABLE = 8;
+  using SRVTable = std::array<D3D12_CPU_DESCRIPTOR_HANDLE, NUM_DESCRIPTORS_PER_SRV_TABLE>;
+
   DescriptorAllocator();
   ~DescriptorAllocator();
 
@@ -23,6 +27,11 @@ public:
   bool Allocate(u32 num_handles, DescriptorHandle* out_base_handle);
   void Reset();
 
+  // Copies the descriptors of a texture table into the heap. Tables which have already been
+  // copied since the last reset are re-used, as descriptors are only freed once the command list
+  // using them completes, and so can't change while it is being recorded.
+  bool GetSRVTableHandle(const SRVTable& srvs, D3D12_GPU_DESCRIPTOR_HANDLE* handle);
+
 protected:
   ComPtr<ID3D12DescriptorHeap> m_descriptor_heap;
   u32 m_descriptor_increment_size = 0;
@@ -31,6 +40,10 @@ protected:
 
   D3D12_CPU_DESCRIPTOR_HANDLE m_heap_base_cpu = {};
   D3D12_GPU_DESCRIPTOR_HANDLE m_heap_base_gpu = {};
+
+private:
+  std::map<std::array<SIZE_T, NUM_DESCRIPTORS_PER_SRV_TABLE>, D3D12_GPU_DESCRIPTOR_HANDLE>
+      m_srv_table_map;
 };
 
 struct SamplerStateSet final
@@ -43,6 +43,9 @@ SwapChain::~SwapChain()
   // Can't destroy swap chain while it's fullscreen.
   if (m_swap_chain && GetFullscreenState(m_swap_chain.Get()))
     m_swap_chain->SetFullscreenState(FALSE, nullptr);
+
+  if (m_frame_latency_waitable)
+    CloseHandle(m_frame_latency_waitable);
 }
 
 bool SwapChain::WantsStereo()
@@ -53,7 +56,10 @@ bool SwapChain::WantsStereo()
 u32 SwapChain::GetSwapChainFlags() const
 {
   // This flag is necessary if we want to use a flip-model swapchain without locking the framerate
-  return m_allow_tearing_supported ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0;
+  u32 flags = m_allow_tearing_supported ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0;
+  if (m_frame_latency_waitable_supported)
+    flags |= DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+  return flags;
 }
 
 bool SwapChain::CreateSwapChain(bool stereo)
@@ -72,6 +78,11 @@ bool SwapChain::CreateSwapChain(bool stereo)
   {
     m_allow_tearing_supported = IsTearingSupported(dxgi_factory2.Get());
 
+    // Waitable swap chains were added in DXGI 1.3, which shipped with Windows 8.1.
+    Microsoft::WRL::ComPtr<IDXGIFactory3> dxgi_factory3;
+    m_frame_latency_waitable_supported =
+        g_ActiveConfig.iMaxFramesInFlight > 0 && SUCCEEDED(m_dxgi_factory.As(&dxgi_factory3));
+
     DXGI_SWAP_CHAIN_DESC1 swap_chain_desc = {};
     swap_chain_desc.Width = m_width;
     swap_chain_desc.Height = m_height;
@@ -121,6 +132,7 @@ bool SwapChain::CreateSwapChain(bool stereo)
     desc.Flags = 0;
 
     m_allow_tearing_supported = false;
+    m_frame_latency_waitable_supported = false;
     hr = m_dxgi_factory->CreateSwapChain(m_d3d_device.Get(), &desc, &m_swap_chain);
   }
 
@@ -136,6 +148,16 @@ bool SwapChain::CreateSwapChain(bool stereo)
   if (FAILED(hr))
     WARN_LOG_FMT(VIDEO, "MakeWindowAssociation() failed with HRESULT {:08X}", hr);
 
+  // Limit the number of frames which can be queued, so that each frame is rendered closer to when
+  // it is displayed. DXGI allows up to 16 frames of latency.
+  Microsoft::WRL::ComPtr<IDXGISwapChain2> swap_chain2;
+  if (m_frame_latency_waitable_supported && SUCCEEDED(m_swap_chain.As(&swap_chain2)))
+  {
+    swap_chain2->SetMaximumFrameLatency(
+        static_cast<UINT>(std::clamp(g_ActiveConfig.iMaxFramesInFlight, 1, 16)));
+    m_frame_latency_waitable = swap_chain2->GetFrameLatencyWaitableObject();
+  }
+
   m_stereo = stereo;
   if (!CreateSwapChainBuffers())
   {
@@ -152,6 +174,12 @@ void SwapChain::DestroySwapChain()
 {
   DestroySwapChainBuffers();
 
+  if (m_frame_latency_waitable)
+  {
+    CloseHandle(m_frame_latency_waitable);
+    m_frame_latency_waitable = nullptr;
+  }
+
   // Can't destroy swap chain while it's fullscreen.
   if (m_swap_chain && GetFullscreenState(m_swap_chain.Get()))
     m_swap_chain->SetFullscreenState(FALSE, nullptr);
@@ -241,6 +269,11 @@ bool SwapChain::Present()
     return false;
   }
 
+  // Block until the frame queue has room again, rather than when the next present is issued. This
+  // way the next frame is emulated with input which is as recent as possible.
+  if (m_frame_latency_waitable)
+    WaitForSingleObjectEx(m_frame_latency_waitable, 1000, TRUE);
+
   return true;
 }
 
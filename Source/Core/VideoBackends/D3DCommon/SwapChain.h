@@ -65,8 +65,12 @@ protected:
   u32 m_width = 1;
   u32 m_height = 1;
 
+  // Signaled by DXGI once fewer than the maximum number of frames are queued for presentation.
+  HANDLE m_frame_latency_waitable = nullptr;
+
   bool m_stereo = false;
   bool m_allow_tearing_supported = false;
+  bool m_frame_latency_waitable_supported = false;
   bool m_has_fullscreen = false;
   bool m_fullscreen_request = false;
 };
@@ -7,6 +7,17 @@
 // This backend tries not to do anything in the backend,
 // but everything in VideoCommon.
 
+// Since nothing is rendered, it can be used to measure the CPU side cost of GPU emulation without
+// a GPU, e.g. by playing back a FIFO log at an unlimited emulation speed. To do so, set
+// NullBenchmarkMode in the [Settings] section of GFX.ini:
+//   0: Off.
+//   1: Parse only. The FIFO is parsed and BP/CP/XF state is updated, but vertices are skipped
+//      instead of being loaded, so that nothing is ever drawn.
+//   2: Parse and vertex load. Vertices are loaded and batches are flushed as usual, which includes
+//      decoding the textures they use and generating their shader UIDs.
+// The throughput since the last report, in commands, vertices and decoded texture bytes, as well
+// as its average per frame, is logged once a second with the Video log type.
+
 #include "VideoBackends/Null/NullRender.h"
 #include "VideoBackends/Null/NullVertexManager.h"
 #include "VideoBackends/Null/PerfQuery.h"
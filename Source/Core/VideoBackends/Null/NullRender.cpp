@@ -6,24 +6,83 @@
 
 #include "VideoBackends/Null/NullTexture.h"
 
+#include "Common/Logging/Log.h"
+
 #include "VideoCommon/AbstractPipeline.h"
 #include "VideoCommon/AbstractShader.h"
 #include "VideoCommon/NativeVertexFormat.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VideoConfig.h"
 
 namespace Null
 {
+// Interval at which the benchmark results are logged.
+constexpr std::chrono::seconds BENCHMARK_REPORT_INTERVAL{1};
+
 // Init functions
 Renderer::Renderer() : ::Renderer(1, 1, 1.0f, AbstractTextureFormat::RGBA8)
 {
   UpdateActiveConfig();
+  VertexLoaderManager::g_skip_vertex_loading =
+      g_ActiveConfig.null_benchmark_mode == NullBenchmarkMode::ParseOnly;
+  m_benchmark_start = std::chrono::steady_clock::now();
 }
 
 Renderer::~Renderer()
 {
+  VertexLoaderManager::g_skip_vertex_loading = false;
   UpdateActiveConfig();
 }
 
+void Renderer::OnEndFrame()
+{
+  // The mode can be changed while running, it takes effect from the next frame on.
+  VertexLoaderManager::g_skip_vertex_loading =
+      g_ActiveConfig.null_benchmark_mode == NullBenchmarkMode::ParseOnly;
+  if (g_ActiveConfig.null_benchmark_mode == NullBenchmarkMode::Off)
+    return;
+
+  const auto& frame = g_stats.this_frame;
+  m_benchmark_frames++;
+  m_benchmark_commands += frame.num_bp_loads + frame.num_bp_loads_in_dl + frame.num_cp_loads +
+                          frame.num_cp_loads_in_dl + frame.num_xf_loads +
+                          frame.num_xf_loads_in_dl + frame.num_primitive_joins +
+                          frame.num_dlists_called;
+  m_benchmark_vertices += frame.num_prims + frame.num_dl_prims;
+  m_benchmark_texture_bytes += frame.bytes_textures_decoded;
+
+  const auto now = std::chrono::steady_clock::now();
+  if (now - m_benchmark_start >= BENCHMARK_REPORT_INTERVAL)
+    ReportBenchmark(now);
+}
+
+void Renderer::ReportBenchmark(std::chrono::steady_clock::time_point now)
+{
+  const double seconds = std::chrono::duration<double>(now - m_benchmark_start).count();
+  const double frames = static_cast<double>(m_benchmark_frames);
+  const char* mode_name = g_ActiveConfig.null_benchmark_mode == NullBenchmarkMode::ParseOnly ?
+                              "parse only" :
+                              "parse and vertex load";
+
+  NOTICE_LOG_FMT(VIDEO,
+                 "Null benchmark ({}): {:.1f} frames/s, {:.0f} commands/s, {:.0f} vertices/s, "
+                 "{:.2f} MB/s of textures decoded",
+                 mode_name, frames / seconds, m_benchmark_commands / seconds,
+                 m_benchmark_vertices / seconds, m_benchmark_texture_bytes / seconds / 1000000.0);
+  NOTICE_LOG_FMT(VIDEO,
+                 "Null benchmark ({}): {:.0f} commands, {:.0f} vertices, {:.1f} kB of textures "
+                 "decoded per frame",
+                 mode_name, m_benchmark_commands / frames, m_benchmark_vertices / frames,
+                 m_benchmark_texture_bytes / frames / 1000.0);
+
+  m_benchmark_start = now;
+  m_benchmark_frames = 0;
+  m_benchmark_commands = 0;
+  m_benchmark_vertices = 0;
+  m_benchmark_texture_bytes = 0;
+}
+
 bool Renderer::IsHeadless() const
 {
   return true;
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <chrono>
+
+#include "Common/CommonTypes.h"
 #include "VideoCommon/RenderBase.h"
 
 namespace Null
@@ -43,5 +46,17 @@ public:
   }
 
   void ReinterpretPixelData(EFBReinterpretType convtype) override {}
+
+  void OnEndFrame() override;
+
+private:
+  void ReportBenchmark(std::chrono::steady_clock::time_point now);
+
+  // Totals of the benchmark since the last report.
+  std::chrono::steady_clock::time_point m_benchmark_start;
+  u64 m_benchmark_frames = 0;
+  u64 m_benchmark_commands = 0;
+  u64 m_benchmark_vertices = 0;
+  u64 m_benchmark_texture_bytes = 0;
 };
 }  // namespace Null
@@ -2,8 +2,10 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <array>
 #include <cstring>
 
+#include "Common/CommonTypes.h"
 #include "Common/GL/GLUtil.h"
 
 #include "VideoBackends/OGL/OGLBoundingBox.h"
@@ -14,6 +16,63 @@
 
 static GLuint s_bbox_buffer_id;
 
+// With deferred readback, reads return the values of the newest of these copies of the buffer
+// whose fence has been signalled, instead of waiting for the GPU. Each readback is numbered, and
+// a copy only replaces the values if it was made after the CPU last wrote to the buffer.
+struct DeferredReadback
+{
+  GLuint buffer = 0;
+  GLsync fence = 0;
+  u64 sequence = 0;
+};
+constexpr size_t NUM_DEFERRED_READBACKS = 3;
+static std::array<DeferredReadback, NUM_DEFERRED_READBACKS> s_deferred_readbacks;
+static size_t s_next_deferred_readback = 0;
+static u64 s_deferred_readback_sequence = 0;
+static u64 s_deferred_values_sequence = 0;
+static u64 s_last_write_sequence = 0;
+static std::array<int, 4> s_deferred_values;
+static bool s_drawn_since_deferred_readback = false;
+
+static bool IsSignalled(GLsync fence, GLbitfield flags, GLuint64 timeout)
+{
+  const GLenum result = glClientWaitSync(fence, flags, timeout);
+  return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+
+static void UpdateFromDeferredReadbacks()
+{
+  const bool wait = g_ActiveConfig.bbox_readback_mode == BBoxReadbackMode::DeferredWait;
+  const DeferredReadback* newest = nullptr;
+  for (const DeferredReadback& readback : s_deferred_readbacks)
+  {
+    // Keep the values the CPU has written until a readback includes them.
+    if (readback.fence == 0 || readback.sequence <= s_deferred_values_sequence ||
+        readback.sequence < s_last_write_sequence)
+    {
+      continue;
+    }
+
+    if (newest && readback.sequence < newest->sequence)
+      continue;
+
+    if (wait || IsSignalled(readback.fence, 0, 0))
+      newest = &readback;
+  }
+
+  if (!newest)
+    return;
+
+  // The fence was inserted by an earlier flush, so this only waits for the rendering up to it.
+  if (wait)
+    IsSignalled(newest->fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+
+  glBindBuffer(GL_COPY_READ_BUFFER, newest->buffer);
+  glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(s_deferred_values), s_deferred_values.data());
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  s_deferred_values_sequence = newest->sequence;
+}
+
 namespace OGL
 {
 void BoundingBox::Init()
@@ -26,6 +85,15 @@ void BoundingBox::Init()
   glBindBuffer(GL_SHADER_STORAGE_BUFFER, s_bbox_buffer_id);
   glBufferData(GL_SHADER_STORAGE_BUFFER, 4 * sizeof(s32), initial_values, GL_DYNAMIC_DRAW);
   glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, s_bbox_buffer_id);
+
+  s_deferred_values = {};
+  for (DeferredReadback& readback : s_deferred_readbacks)
+  {
+    glGenBuffers(1, &readback.buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, readback.buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, sizeof(s_deferred_values), nullptr, GL_STREAM_READ);
+  }
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
 }
 
 void BoundingBox::Shutdown()
@@ -34,6 +102,14 @@ void BoundingBox::Shutdown()
     return;
 
   glDeleteBuffers(1, &s_bbox_buffer_id);
+
+  for (DeferredReadback& readback : s_deferred_readbacks)
+  {
+    if (readback.fence != 0)
+      glDeleteSync(readback.fence);
+    glDeleteBuffers(1, &readback.buffer);
+    readback = {};
+  }
 }
 
 void BoundingBox::Set(int index, int value)
@@ -44,6 +120,10 @@ void BoundingBox::Set(int index, int value)
   glBindBuffer(GL_SHADER_STORAGE_BUFFER, s_bbox_buffer_id);
   glBufferSubData(GL_SHADER_STORAGE_BUFFER, index * sizeof(int), sizeof(int), &value);
   glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+  // The write is part of the command stream, so the next readback includes it.
+  s_deferred_values[index] = value;
+  s_last_write_sequence = s_deferred_readback_sequence + 1;
 }
 
 int BoundingBox::Get(int index)
@@ -51,6 +131,12 @@ int BoundingBox::Get(int index)
   if (!g_ActiveConfig.backend_info.bSupportsBBox)
     return 0;
 
+  if (g_ActiveConfig.bbox_readback_mode != BBoxReadbackMode::Synchronous)
+  {
+    UpdateFromDeferredReadbacks();
+    return s_deferred_values[index];
+  }
+
   int data = 0;
   glBindBuffer(GL_SHADER_STORAGE_BUFFER, s_bbox_buffer_id);
   if (!DriverDetails::HasBug(DriverDetails::BUG_SLOW_GETBUFFERSUBDATA) &&
@@ -75,4 +161,42 @@ int BoundingBox::Get(int index)
   glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
   return data;
 }
+
+void BoundingBox::Invalidate()
+{
+  s_drawn_since_deferred_readback = true;
+}
+
+void BoundingBox::QueueDeferredReadback()
+{
+  if (!g_ActiveConfig.backend_info.bSupportsBBox ||
+      g_ActiveConfig.bbox_readback_mode == BBoxReadbackMode::Synchronous ||
+      !s_drawn_since_deferred_readback)
+  {
+    return;
+  }
+
+  // If the GPU hasn't finished the copy of the previous use yet, skip this readback rather than
+  // waiting for it. It is then done at the next flush instead.
+  DeferredReadback& readback = s_deferred_readbacks[s_next_deferred_readback];
+  if (readback.fence != 0)
+  {
+    if (!IsSignalled(readback.fence, 0, 0))
+      return;
+    glDeleteSync(readback.fence);
+  }
+
+  glBindBuffer(GL_COPY_READ_BUFFER, s_bbox_buffer_id);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, readback.buffer);
+  glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+  glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                      sizeof(s_deferred_values));
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  readback.sequence = ++s_deferred_readback_sequence;
+
+  s_next_deferred_readback = (s_next_deferred_readback + 1) % NUM_DEFERRED_READBACKS;
+  s_drawn_since_deferred_readback = false;
+}
 };  // namespace OGL
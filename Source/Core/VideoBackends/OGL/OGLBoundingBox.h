@@ -14,5 +14,12 @@ public:
 
   static void Set(int index, int value);
   static int Get(int index);
+
+  // Called before each draw which may update the bounding box.
+  static void Invalidate();
+
+  // Copies the buffer to the next deferred readback buffer if it has been drawn to since the last
+  // one. Called whenever commands are flushed to the GPU.
+  static void QueueDeferredReadback();
 };
 };  // namespace OGL
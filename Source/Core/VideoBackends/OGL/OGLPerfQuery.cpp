@@ -28,7 +28,8 @@ std::unique_ptr<PerfQueryBase> GetPerfQuery()
 
 PerfQuery::PerfQuery() : m_query_read_pos()
 {
-  ResetQuery();
+  m_query_count = 0;
+  ClearResults();
 }
 
 void PerfQuery::EnableQuery(PerfQueryGroup type)
@@ -54,8 +55,18 @@ void PerfQuery::FlushResults()
 
 void PerfQuery::ResetQuery()
 {
+  if (IsLatencyTolerant())
+  {
+    WeakFlush();
+    while (HasPendingPreviousPeriod())
+      FlushOne();
+
+    BeginQueryPeriod();
+    return;
+  }
+
   m_query_count = 0;
-  std::fill(std::begin(m_results), std::end(m_results), 0);
+  ClearResults();
 }
 
 u32 PerfQuery::GetQueryResult(PerfQueryType type)
@@ -64,19 +75,19 @@ u32 PerfQuery::GetQueryResult(PerfQueryType type)
 
   if (type == PQ_ZCOMP_INPUT_ZCOMPLOC || type == PQ_ZCOMP_OUTPUT_ZCOMPLOC)
   {
-    result = m_results[PQG_ZCOMP_ZCOMPLOC];
+    result = GetGroupResult(PQG_ZCOMP_ZCOMPLOC);
   }
   else if (type == PQ_ZCOMP_INPUT || type == PQ_ZCOMP_OUTPUT)
   {
-    result = m_results[PQG_ZCOMP];
+    result = GetGroupResult(PQG_ZCOMP);
   }
   else if (type == PQ_BLEND_INPUT)
   {
-    result = m_results[PQG_ZCOMP] + m_results[PQG_ZCOMP_ZCOMPLOC];
+    result = GetGroupResult(PQG_ZCOMP) + GetGroupResult(PQG_ZCOMP_ZCOMPLOC);
   }
   else if (type == PQ_EFB_COPY_CLOCKS)
   {
-    result = m_results[PQG_EFB_COPY_CLOCKS];
+    result = GetGroupResult(PQG_EFB_COPY_CLOCKS);
   }
 
   return result;
@@ -164,7 +175,7 @@ void PerfQueryGL::FlushOne()
   if (g_ActiveConfig.iMultisamples > 1)
     result /= g_ActiveConfig.iMultisamples;
 
-  m_results[entry.query_type] += result;
+  AccumulateResult(entry.query_type, result);
 
   m_query_read_pos = (m_query_read_pos + 1) % m_query_buffer.size();
   --m_query_count;
@@ -251,8 +262,9 @@ void PerfQueryGLESNV::FlushOne()
   // NOTE: Reported pixel metrics should be referenced to native resolution
   // TODO: Dropping the lower 2 bits from this count should be closer to actual
   // hardware behavior when drawing triangles.
-  m_results[entry.query_type] += static_cast<u64>(result) * EFB_WIDTH * EFB_HEIGHT /
-                                 (g_renderer->GetTargetWidth() * g_renderer->GetTargetHeight());
+  AccumulateResult(entry.query_type,
+                   static_cast<u64>(result) * EFB_WIDTH * EFB_HEIGHT /
+                       (g_renderer->GetTargetWidth() * g_renderer->GetTargetHeight()));
 
   m_query_read_pos = (m_query_read_pos + 1) % m_query_buffer.size();
   --m_query_count;
@@ -34,6 +34,11 @@ protected:
     PerfQueryGroup query_type;
   };
 
+  // Retrieves the results of the queries which have completed.
+  virtual void WeakFlush() = 0;
+  // Only use when non-empty
+  virtual void FlushOne() = 0;
+
   // when testing in SMS: 64 was too small, 128 was ok
   static const u32 PERF_QUERY_BUFFER_SIZE = 512;
 
@@ -58,9 +63,8 @@ public:
   void FlushResults() override;
 
 private:
-  void WeakFlush();
-  // Only use when non-empty
-  void FlushOne();
+  void WeakFlush() override;
+  void FlushOne() override;
 
   GLenum m_query_type;
 };
@@ -76,9 +80,8 @@ public:
   void FlushResults() override;
 
 private:
-  void WeakFlush();
-  // Only use when non-empty
-  void FlushOne();
+  void WeakFlush() override;
+  void FlushOne() override;
 };
 
 }  // namespace OGL
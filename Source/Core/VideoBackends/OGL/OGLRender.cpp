@@ -32,6 +32,7 @@
 
 #include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/DriverDetails.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/FramebufferManager.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/PostProcessing.h"
@@ -443,6 +444,7 @@ Renderer::Renderer(std::unique_ptr<GLContext> main_gl_context, float backbuffer_
        GLExtensions::Supports("GL_OES_copy_image")) &&
       !DriverDetails::HasBug(DriverDetails::BUG_BROKEN_COPYIMAGE);
   g_ogl_config.bSupportsTextureSubImage = GLExtensions::Supports("ARB_get_texture_sub_image");
+  g_ogl_config.bSupportsTimerQuery = GLExtensions::Supports("GL_ARB_timer_query");
 
   // Desktop OpenGL supports the binding layout if it supports 420pack
   // OpenGL ES 3.1 supports it implicitly without an extension
@@ -787,6 +789,9 @@ Renderer::Renderer(std::unique_ptr<GLContext> main_gl_context, float backbuffer_
   if (g_ActiveConfig.backend_info.bSupportsPrimitiveRestart)
     GLUtil::EnablePrimitiveRestart(m_main_gl_context.get());
 
+  FrameProfiler::SetDeviceName(fmt::format("{} {} {}", g_ogl_config.gl_vendor,
+                                           g_ogl_config.gl_renderer, g_ogl_config.gl_version));
+
   UpdateActiveConfig();
 }
 
@@ -809,6 +814,13 @@ void Renderer::Shutdown()
 {
   ::Renderer::Shutdown();
 
+  if (m_gpu_timer_active)
+  {
+    glEndQuery(GL_TIME_ELAPSED);
+    m_gpu_timer_active = false;
+  }
+  ReadGPUTimerQueries(true);
+
   glDeleteFramebuffers(1, &m_shared_draw_framebuffer);
   glDeleteFramebuffers(1, &m_shared_read_framebuffer);
 }
@@ -883,6 +895,11 @@ void Renderer::BBoxWrite(int index, u16 value)
   BoundingBox::Set(index, swapped_value);
 }
 
+void Renderer::BBoxFlush()
+{
+  BoundingBox::Invalidate();
+}
+
 void Renderer::SetViewport(float x, float y, float width, float height, float near_depth,
                            float far_depth)
 {
@@ -1077,8 +1094,55 @@ void Renderer::OnConfigChanged(u32 bits)
     g_sampler_cache->Clear();
 }
 
+void Renderer::OnEndFrame()
+{
+  if (!g_ogl_config.bSupportsTimerQuery)
+    return;
+
+  if (m_gpu_timer_active)
+  {
+    glEndQuery(GL_TIME_ELAPSED);
+    m_gpu_timer_active = false;
+  }
+  ReadGPUTimerQueries(false);
+
+  // Measures everything the GPU does until the end of the next frame
+  if (FrameProfiler::IsActive())
+  {
+    GLuint query;
+    glGenQueries(1, &query);
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    m_gpu_timer_queries.emplace_back(query, m_frame_count + 1);
+    m_gpu_timer_active = true;
+  }
+}
+
+void Renderer::ReadGPUTimerQueries(bool wait)
+{
+  while (!m_gpu_timer_queries.empty())
+  {
+    const auto [query, frame] = m_gpu_timer_queries.front();
+    if (!wait)
+    {
+      GLuint available = GL_FALSE;
+      glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+      if (!available)
+        break;
+    }
+
+    GLuint64 elapsed_ns = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed_ns);
+    FrameProfiler::AddGPUTime(frame, elapsed_ns / 1000000.0);
+
+    glDeleteQueries(1, &query);
+    m_gpu_timer_queries.pop_front();
+  }
+}
+
 void Renderer::Flush()
 {
+  BoundingBox::QueueDeferredReadback();
+
   // ensure all commands are sent to the GPU.
   // Otherwise the driver could batch several frames together.
   glFlush();
@@ -5,7 +5,9 @@
 #pragma once
 
 #include <array>
+#include <deque>
 #include <string>
+#include <utility>
 
 #include "Common/GL/GLContext.h"
 #include "Common/GL/GLExtensions/GLExtensions.h"
@@ -70,6 +72,7 @@ struct VideoConfig
   bool bSupportsTextureSubImage;
   EsFbFetchType SupportedFramebufferFetch;
   bool bSupportsShaderThreadShuffleNV;
+  bool bSupportsTimerQuery;
 
   const char* gl_vendor;
   const char* gl_renderer;
@@ -128,6 +131,7 @@ public:
 
   u16 BBoxRead(int index) override;
   void BBoxWrite(int index, u16 value) override;
+  void BBoxFlush() override;
 
   void BeginUtilityDrawing() override;
   void EndUtilityDrawing() override;
@@ -138,6 +142,7 @@ public:
                          const AbstractTexture* source_texture,
                          const MathUtil::Rectangle<int>& source_rc) override;
   void OnConfigChanged(u32 bits) override;
+  void OnEndFrame() override;
 
   void ClearScreen(const MathUtil::Rectangle<int>& rc, bool colorEnable, bool alphaEnable,
                    bool zEnable, u32 color, u32 z) override;
@@ -169,6 +174,8 @@ private:
   void ApplyDepthState(const DepthState state);
   void ApplyBlendingState(const BlendingState state);
 
+  void ReadGPUTimerQueries(bool wait);
+
   std::unique_ptr<GLContext> m_main_gl_context;
   std::unique_ptr<OGLFramebuffer> m_system_framebuffer;
   std::array<const OGLTexture*, 8> m_bound_textures{};
@@ -178,5 +185,10 @@ private:
   BlendingState m_current_blend_state;
   GLuint m_shared_read_framebuffer = 0;
   GLuint m_shared_draw_framebuffer = 0;
+
+  // Time elapsed queries for the frame profiler, with the frame they measure. Only the last one
+  // can still be active.
+  std::deque<std::pair<GLuint, u64>> m_gpu_timer_queries;
+  bool m_gpu_timer_active = false;
 };
 }  // namespace OGL
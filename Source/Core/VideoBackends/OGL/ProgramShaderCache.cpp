@@ -37,7 +37,6 @@
 
 namespace OGL
 {
-u32 ProgramShaderCache::s_ubo_buffer_size;
 s32 ProgramShaderCache::s_ubo_align = 1;
 GLuint ProgramShaderCache::s_attributeless_VBO = 0;
 GLuint ProgramShaderCache::s_attributeless_VAO = 0;
@@ -216,37 +215,36 @@ u32 ProgramShaderCache::GetUniformBufferAlignment()
   return s_ubo_align;
 }
 
+template <typename T>
+static void UploadConstantBlock(GLuint index, const T& constants)
+{
+  const u32 align = ProgramShaderCache::GetUniformBufferAlignment();
+  const u32 alloc_size = static_cast<u32>(Common::AlignUp(sizeof(T), align));
+  auto buffer = s_buffer->Map(alloc_size, align);
+  std::memcpy(buffer.first, &constants, sizeof(T));
+  s_buffer->Unmap(alloc_size);
+  glBindBufferRange(GL_UNIFORM_BUFFER, index, s_buffer->m_buffer, buffer.second, sizeof(T));
+  ADDSTAT(g_stats.this_frame.bytes_uniform_streamed, sizeof(T));
+}
+
 void ProgramShaderCache::UploadConstants()
 {
-  if (PixelShaderManager::dirty || VertexShaderManager::dirty || GeometryShaderManager::dirty)
+  // Only the blocks which changed are streamed and re-bound, as most draws only change the
+  // constants of a single stage and the pixel shader block is several times larger than the rest.
+  if (PixelShaderManager::dirty)
   {
-    auto buffer = s_buffer->Map(s_ubo_buffer_size, s_ubo_align);
-
-    memcpy(buffer.first, &PixelShaderManager::constants, sizeof(PixelShaderConstants));
-
-    memcpy(buffer.first + Common::AlignUp(sizeof(PixelShaderConstants), s_ubo_align),
-           &VertexShaderManager::constants, sizeof(VertexShaderConstants));
-
-    memcpy(buffer.first + Common::AlignUp(sizeof(PixelShaderConstants), s_ubo_align) +
-               Common::AlignUp(sizeof(VertexShaderConstants), s_ubo_align),
-           &GeometryShaderManager::constants, sizeof(GeometryShaderConstants));
-
-    s_buffer->Unmap(s_ubo_buffer_size);
-    glBindBufferRange(GL_UNIFORM_BUFFER, 1, s_buffer->m_buffer, buffer.second,
-                      sizeof(PixelShaderConstants));
-    glBindBufferRange(GL_UNIFORM_BUFFER, 2, s_buffer->m_buffer,
-                      buffer.second + Common::AlignUp(sizeof(PixelShaderConstants), s_ubo_align),
-                      sizeof(VertexShaderConstants));
-    glBindBufferRange(GL_UNIFORM_BUFFER, 3, s_buffer->m_buffer,
-                      buffer.second + Common::AlignUp(sizeof(PixelShaderConstants), s_ubo_align) +
-                          Common::AlignUp(sizeof(VertexShaderConstants), s_ubo_align),
-                      sizeof(GeometryShaderConstants));
-
+    UploadConstantBlock(1, PixelShaderManager::constants);
     PixelShaderManager::dirty = false;
+  }
+  if (VertexShaderManager::dirty)
+  {
+    UploadConstantBlock(2, VertexShaderManager::constants);
     VertexShaderManager::dirty = false;
+  }
+  if (GeometryShaderManager::dirty)
+  {
+    UploadConstantBlock(3, GeometryShaderManager::constants);
     GeometryShaderManager::dirty = false;
-
-    ADDSTAT(g_stats.this_frame.bytes_uniform_streamed, s_ubo_buffer_size);
   }
 }
 
@@ -434,11 +432,6 @@ void ProgramShaderCache::Init()
   // then the UBO will fail.
   glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &s_ubo_align);
 
-  s_ubo_buffer_size =
-      static_cast<u32>(Common::AlignUp(sizeof(PixelShaderConstants), s_ubo_align) +
-                       Common::AlignUp(sizeof(VertexShaderConstants), s_ubo_align) +
-                       Common::AlignUp(sizeof(GeometryShaderConstants), s_ubo_align));
-
   // We multiply by *4*4 because we need to get down to basic machine units.
   // So multiply by four to get how many floats we have from vec4s
   // Then once more to get bytes
@@ -21,20 +21,36 @@
 
 namespace EfbInterface
 {
-static std::array<u8, EFB_WIDTH * EFB_HEIGHT * 6> efb;
+// The color and depth buffers are stored in blocks of BLOCK_SIZE x BLOCK_SIZE pixels rather than
+// linearly, so that the 2x2 blocks and tiles drawn by the rasterizer are close together in memory.
+// A block is three cache lines, and the tiles of the rasterizer threads never share one.
+constexpr u32 BLOCK_SIZE = 8;
+constexpr u32 BLOCKS_PER_ROW = EFB_WIDTH / BLOCK_SIZE;
+static_assert(EFB_WIDTH % BLOCK_SIZE == 0 && EFB_HEIGHT % BLOCK_SIZE == 0);
+
+alignas(64) static std::array<u8, EFB_WIDTH * EFB_HEIGHT * 6> efb;
+
+// Linear copy of the color or depth buffer for the texture encoder
+static std::vector<u8> linear_efb;
 
 static std::array<u32, PQ_NUM_MEMBERS> perf_values;
 
+static inline u32 GetPixelIndex(u16 x, u16 y)
+{
+  const u32 block = (y / BLOCK_SIZE) * BLOCKS_PER_ROW + x / BLOCK_SIZE;
+  return block * BLOCK_SIZE * BLOCK_SIZE + (y % BLOCK_SIZE) * BLOCK_SIZE + x % BLOCK_SIZE;
+}
+
 static inline u32 GetColorOffset(u16 x, u16 y)
 {
-  return (x + y * EFB_WIDTH) * 3;
+  return GetPixelIndex(x, y) * 3;
 }
 
 static inline u32 GetDepthOffset(u16 x, u16 y)
 {
   constexpr u32 depth_buffer_start = EFB_WIDTH * EFB_HEIGHT * 3;
 
-  return (x + y * EFB_WIDTH) * 3 + depth_buffer_start;
+  return GetPixelIndex(x, y) * 3 + depth_buffer_start;
 }
 
 static void SetPixelAlphaOnly(u32 offset, u8 a)
@@ -553,11 +569,21 @@ u32 GetDepth(u16 x, u16 y)
   return GetPixelDepth(offset);
 }
 
-u8* GetPixelPointer(u16 x, u16 y, bool depth)
+const u8* GetLinearPixelPointer(u16 x, u16 y, bool depth)
 {
-  if (depth)
-    return &efb[GetDepthOffset(x, y)];
-  return &efb[GetColorOffset(x, y)];
+  // The encoders only read forwards from the pixel, so the rows above it aren't needed. One more
+  // byte is kept at the end, as the pixels are read as 32-bit values.
+  linear_efb.resize(EFB_WIDTH * EFB_HEIGHT * 3 + 1);
+  for (u16 row = y; row < EFB_HEIGHT; row++)
+  {
+    for (u16 block_x = 0; block_x < EFB_WIDTH; block_x += BLOCK_SIZE)
+    {
+      const u32 offset = depth ? GetDepthOffset(block_x, row) : GetColorOffset(block_x, row);
+      std::memcpy(&linear_efb[(row * EFB_WIDTH + block_x) * 3], &efb[offset], BLOCK_SIZE * 3);
+    }
+  }
+
+  return &linear_efb[(y * EFB_WIDTH + x) * 3];
 }
 
 void EncodeXFB(u8* xfb_in_ram, u32 memory_stride, const MathUtil::Rectangle<int>& source_rect,
@@ -710,16 +736,15 @@ void ResetPerfQuery()
   perf_values = {};
 }
 
-void IncPerfCounterQuadCount(PerfQueryType type)
+void AddPerfCounterPixels(PerfQueryType type, u32 count)
 {
   // NOTE: hardware doesn't process individual pixels but quads instead.
   // Current software renderer architecture works on pixels though, so
   // we have this "quad" hack here to only increment the registers on
   // every fourth rendered pixel
   static u32 quad[PQ_NUM_MEMBERS];
-  if (++quad[type] != 3)
-    return;
-  quad[type] = 0;
-  ++perf_values[type];
+  quad[type] += count;
+  perf_values[type] += quad[type] / 3;
+  quad[type] %= 3;
 }
 }  // namespace EfbInterface
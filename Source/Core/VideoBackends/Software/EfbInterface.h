@@ -52,12 +52,16 @@ void SetDepth(u16 x, u16 y, u32 depth);
 u32 GetColor(u16 x, u16 y);
 u32 GetDepth(u16 x, u16 y);
 
-u8* GetPixelPointer(u16 x, u16 y, bool depth);
+// Returns a pointer to the pixel in a linear copy of the color or depth buffer, with rows of
+// EFB_WIDTH pixels of 3 bytes each. It is valid until the next call.
+const u8* GetLinearPixelPointer(u16 x, u16 y, bool depth);
 
 void EncodeXFB(u8* xfb_in_ram, u32 memory_stride, const MathUtil::Rectangle<int>& source_rect,
                float y_scale, float gamma);
 
 u32 GetPerfQueryResult(PerfQueryType type);
 void ResetPerfQuery();
-void IncPerfCounterQuadCount(PerfQueryType type);
+// Adds the given number of pixels to a perf counter. The rasterizer threads tally their pixels
+// separately and add them once they're done, so this must not be called by several at once.
+void AddPerfCounterPixels(PerfQueryType type, u32 count);
 }  // namespace EfbInterface
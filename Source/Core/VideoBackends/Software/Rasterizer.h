@@ -11,10 +11,17 @@ struct OutputVertexData;
 namespace Rasterizer
 {
 void Init();
+void Shutdown();
 
+// Sets up the triangle and sorts it into the screen tiles it touches. It is only drawn by Flush().
 void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v1,
                            const OutputVertexData* v2);
 
+// Rasterizes the tiles of the triangles drawn since the last flush on the worker threads and the
+// calling thread, and waits for them. This must be called before any state the triangles depend
+// on is changed, or the EFB is accessed otherwise.
+void Flush();
+
 void SetTevReg(int reg, int comp, s16 color);
 
 struct Slope
@@ -92,6 +92,9 @@ void SWVertexLoader::DrawCurrentBatch(u32 base_index, u32 num_indices, u32 base_
     INCSTAT(g_stats.this_frame.num_vertices_loaded)
   }
 
+  // The state can't change within a batch, so its triangles are rasterized together.
+  Rasterizer::Flush();
+
   DebugUtil::OnObjectEnd();
 }
 
@@ -9,6 +9,7 @@
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "VideoBackends/Software/DebugUtil.h"
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/TextureSampler.h"
@@ -172,28 +173,16 @@ static inline s16 Clamp1024(s16 in)
   return in > 1023 ? 1023 : (in < -1024 ? -1024 : in);
 }
 
-void Tev::SetRasColor(int colorChan, int swaptable)
+void Tev::SetRasColor(const Stage& stage)
 {
-  switch (colorChan)
+  switch (stage.ras_channel)
   {
   case 0:  // Color0
-  {
-    const u8* color = Color[0];
-    RasColor[RED_C] = color[bpmem.tevksel[swaptable].swap1];
-    RasColor[GRN_C] = color[bpmem.tevksel[swaptable].swap2];
-    swaptable++;
-    RasColor[BLU_C] = color[bpmem.tevksel[swaptable].swap1];
-    RasColor[ALP_C] = color[bpmem.tevksel[swaptable].swap2];
-  }
-  break;
   case 1:  // Color1
   {
-    const u8* color = Color[1];
-    RasColor[RED_C] = color[bpmem.tevksel[swaptable].swap1];
-    RasColor[GRN_C] = color[bpmem.tevksel[swaptable].swap2];
-    swaptable++;
-    RasColor[BLU_C] = color[bpmem.tevksel[swaptable].swap1];
-    RasColor[ALP_C] = color[bpmem.tevksel[swaptable].swap2];
+    const u8* color = Color[stage.ras_channel];
+    for (int i = 0; i < 4; i++)
+      RasColor[i] = color[stage.ras_swap[i]];
   }
   break;
   case 5:  // alpha bump
@@ -319,6 +308,61 @@ void Tev::DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const Inpu
   Reg[ac.dest][ALP_C] = result;
 }
 
+void Tev::DrawRegular(const TevStageCombiner::ColorCombiner& cc,
+                      const TevStageCombiner::AlphaCombiner& ac, const RegularCombiner& combiner,
+                      const InputRegType inputs[4])
+{
+#ifdef _M_X86
+  // This matches DrawColorRegular() and DrawAlphaRegular() exactly. Each 32-bit lane holds one
+  // component, and the lerp and the scale of d + bias are done with pairs of 16-bit values.
+  const __m128i ab = _mm_setr_epi16(inputs[0].a, inputs[0].b, inputs[1].a, inputs[1].b,
+                                    inputs[2].a, inputs[2].b, inputs[3].a, inputs[3].b);
+  __m128i c = _mm_setr_epi16(inputs[0].c, inputs[0].c, inputs[1].c, inputs[1].c, inputs[2].c,
+                             inputs[2].c, inputs[3].c, inputs[3].c);
+  c = _mm_add_epi16(c, _mm_srli_epi16(c, 7));
+
+  // The weights of the lerp are 256 - c and c, which is ~c + 257 for the first one in each pair.
+  const __m128i first = _mm_setr_epi16(-1, 0, -1, 0, -1, 0, -1, 0);
+  const __m128i scale = _mm_load_si128(reinterpret_cast<const __m128i*>(combiner.scale));
+  __m128i weights =
+      _mm_add_epi16(_mm_xor_si128(c, first), _mm_and_si128(first, _mm_set1_epi16(257)));
+  weights = _mm_mullo_epi16(weights, scale);
+
+  __m128i temp = _mm_madd_epi16(ab, weights);
+  temp = _mm_add_epi32(temp, _mm_load_si128(reinterpret_cast<const __m128i*>(combiner.round)));
+  const __m128i negate_before_shift =
+      _mm_load_si128(reinterpret_cast<const __m128i*>(combiner.negate_before_shift));
+  temp = _mm_sub_epi32(_mm_xor_si128(temp, negate_before_shift), negate_before_shift);
+  temp = _mm_srai_epi32(temp, 8);
+  const __m128i negate_after_shift =
+      _mm_load_si128(reinterpret_cast<const __m128i*>(combiner.negate_after_shift));
+  temp = _mm_sub_epi32(_mm_xor_si128(temp, negate_after_shift), negate_after_shift);
+
+  const __m128i d = _mm_add_epi32(
+      _mm_setr_epi32(inputs[0].d, inputs[1].d, inputs[2].d, inputs[3].d),
+      _mm_load_si128(reinterpret_cast<const __m128i*>(combiner.bias)));
+  const __m128i d_and_temp =
+      _mm_or_si128(_mm_and_si128(d, _mm_set1_epi32(0xFFFF)), _mm_slli_epi32(temp, 16));
+  __m128i result = _mm_madd_epi16(
+      d_and_temp, _mm_load_si128(reinterpret_cast<const __m128i*>(combiner.bias_scale)));
+
+  const __m128i halve = _mm_load_si128(reinterpret_cast<const __m128i*>(combiner.halve));
+  result = _mm_or_si128(_mm_and_si128(halve, _mm_srai_epi32(result, 1)),
+                        _mm_andnot_si128(halve, result));
+
+  alignas(16) s32 results[4];
+  _mm_store_si128(reinterpret_cast<__m128i*>(results), result);
+
+  Reg[ac.dest][ALP_C] = results[ALP_C];
+  Reg[cc.dest][BLU_C] = results[BLU_C];
+  Reg[cc.dest][GRN_C] = results[GRN_C];
+  Reg[cc.dest][RED_C] = results[RED_C];
+#else
+  DrawColorRegular(cc, inputs);
+  DrawAlphaRegular(ac, inputs);
+#endif
+}
+
 void Tev::DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4])
 {
   switch ((ac.shift << 1) | ac.op | 8)  // encoded compare mode
@@ -570,7 +614,7 @@ void Tev::Draw()
   ASSERT(Position[0] >= 0 && Position[0] < s32(EFB_WIDTH));
   ASSERT(Position[1] >= 0 && Position[1] < s32(EFB_HEIGHT));
 
-  INCSTAT(g_stats.this_frame.tev_pixels_in);
+  m_pixels_in++;
 
   // initial color values
   for (int i = 0; i < 4; i++)
@@ -610,72 +654,71 @@ void Tev::Draw()
 
   for (unsigned int stageNum = 0; stageNum <= bpmem.genMode.numtevstages; stageNum++)
   {
-    const int stageNum2 = stageNum >> 1;
-    const int stageOdd = stageNum & 1;
-    const TwoTevStageOrders& order = bpmem.tevorders[stageNum2];
-    const TevKSel& kSel = bpmem.tevksel[stageNum2];
+    const Stage& stage = m_stages[stageNum];
 
     // stage combiners
     const TevStageCombiner::ColorCombiner& cc = bpmem.combiners[stageNum].colorC;
     const TevStageCombiner::AlphaCombiner& ac = bpmem.combiners[stageNum].alphaC;
 
-    const int texcoordSel = order.getTexCoord(stageOdd);
-    const int texmap = order.getTexMap(stageOdd);
-
-    Indirect(stageNum, Uv[texcoordSel].s, Uv[texcoordSel].t);
+    Indirect(stageNum, Uv[stage.texcoord].s, Uv[stage.texcoord].t);
 
     // sample texture
-    if (order.getEnable(stageOdd))
+    if (stage.texture_enabled)
     {
       // RGBA
       u8 texel[4];
 
       TextureSampler::Sample(TexCoord.s, TexCoord.t, TextureLod[stageNum], TextureLinear[stageNum],
-                             texmap, texel);
+                             stage.texmap, texel);
 
 #if ALLOW_TEV_DUMPS
       if (g_ActiveConfig.bDumpTevTextureFetches)
         DebugUtil::DrawTempBuffer(texel, DIRECT_TFETCH + stageNum);
 #endif
 
-      int swaptable = ac.tswap * 2;
-
-      TexColor[RED_C] = texel[bpmem.tevksel[swaptable].swap1];
-      TexColor[GRN_C] = texel[bpmem.tevksel[swaptable].swap2];
-      swaptable++;
-      TexColor[BLU_C] = texel[bpmem.tevksel[swaptable].swap1];
-      TexColor[ALP_C] = texel[bpmem.tevksel[swaptable].swap2];
+      for (int i = 0; i < 4; i++)
+        TexColor[i] = texel[stage.tex_swap[i]];
     }
 
     // set konst for this stage
-    const int kc = kSel.getKC(stageOdd);
-    const int ka = kSel.getKA(stageOdd);
-    StageKonst[RED_C] = *(m_KonstLUT[kc][RED_C]);
-    StageKonst[GRN_C] = *(m_KonstLUT[kc][GRN_C]);
-    StageKonst[BLU_C] = *(m_KonstLUT[kc][BLU_C]);
-    StageKonst[ALP_C] = *(m_KonstLUT[ka][ALP_C]);
+    for (int i = 0; i < 4; i++)
+      StageKonst[i] = *stage.konst[i];
 
     // set color
-    SetRasColor(order.getColorChan(stageOdd), ac.rswap * 2);
+    SetRasColor(stage);
 
     // combine inputs
     InputRegType inputs[4];
     for (int i = 0; i < 3; i++)
     {
-      inputs[BLU_C + i].a = *m_ColorInputLUT[cc.a][i];
-      inputs[BLU_C + i].b = *m_ColorInputLUT[cc.b][i];
-      inputs[BLU_C + i].c = *m_ColorInputLUT[cc.c][i];
-      inputs[BLU_C + i].d = *m_ColorInputLUT[cc.d][i];
+      inputs[BLU_C + i].a = *stage.color_inputs[0][i];
+      inputs[BLU_C + i].b = *stage.color_inputs[1][i];
+      inputs[BLU_C + i].c = *stage.color_inputs[2][i];
+      inputs[BLU_C + i].d = *stage.color_inputs[3][i];
+    }
+    inputs[ALP_C].a = *stage.alpha_inputs[0];
+    inputs[ALP_C].b = *stage.alpha_inputs[1];
+    inputs[ALP_C].c = *stage.alpha_inputs[2];
+    inputs[ALP_C].d = *stage.alpha_inputs[3];
+
+    // The combiners write to different components, so they can be evaluated before either result
+    // is clamped.
+    if (stage.color_regular && stage.alpha_regular)
+    {
+      DrawRegular(cc, ac, stage.regular_combiner, inputs);
     }
-    inputs[ALP_C].a = *m_AlphaInputLUT[ac.a];
-    inputs[ALP_C].b = *m_AlphaInputLUT[ac.b];
-    inputs[ALP_C].c = *m_AlphaInputLUT[ac.c];
-    inputs[ALP_C].d = *m_AlphaInputLUT[ac.d];
-
-    if (cc.bias != 3)
-      DrawColorRegular(cc, inputs);
     else
-      DrawColorCompare(cc, inputs);
+    {
+      if (stage.color_regular)
+        DrawColorRegular(cc, inputs);
+      else
+        DrawColorCompare(cc, inputs);
+
+      if (stage.alpha_regular)
+        DrawAlphaRegular(ac, inputs);
+      else
+        DrawAlphaCompare(ac, inputs);
+    }
 
     if (cc.clamp)
     {
@@ -690,11 +733,6 @@ void Tev::Draw()
       Reg[cc.dest][BLU_C] = Clamp1024(Reg[cc.dest][BLU_C]);
     }
 
-    if (ac.bias != 3)
-      DrawAlphaRegular(ac, inputs);
-    else
-      DrawAlphaCompare(ac, inputs);
-
     if (ac.clamp)
       Reg[ac.dest][ALP_C] = Clamp255(Reg[ac.dest][ALP_C]);
     else
@@ -833,16 +871,29 @@ void Tev::Draw()
   if (late_ztest && bpmem.zmode.testenable)
   {
     // TODO: Check against hw if these values get incremented even if depth testing is disabled
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT);
+    IncPerfCounter(PQ_ZCOMP_INPUT);
 
     if (!EfbInterface::ZCompare(Position[0], Position[1], Position[2]))
       return;
 
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT);
+    IncPerfCounter(PQ_ZCOMP_OUTPUT);
   }
 
-  BoundingBox::Update(static_cast<u16>(Position[0]), static_cast<u16>(Position[0]),
-                      static_cast<u16>(Position[1]), static_cast<u16>(Position[1]));
+  const u16 x = static_cast<u16>(Position[0]);
+  const u16 y = static_cast<u16>(Position[1]);
+  if (!m_bbox_updated)
+  {
+    m_bbox_left = m_bbox_right = x;
+    m_bbox_top = m_bbox_bottom = y;
+    m_bbox_updated = true;
+  }
+  else
+  {
+    m_bbox_left = std::min(m_bbox_left, x);
+    m_bbox_right = std::max(m_bbox_right, x);
+    m_bbox_top = std::min(m_bbox_top, y);
+    m_bbox_bottom = std::max(m_bbox_bottom, y);
+  }
 
 #if ALLOW_TEV_DUMPS
   if (g_ActiveConfig.bDumpTevStages)
@@ -864,8 +915,8 @@ void Tev::Draw()
   }
 #endif
 
-  INCSTAT(g_stats.this_frame.tev_pixels_out);
-  EfbInterface::IncPerfCounterQuadCount(PQ_BLEND_INPUT);
+  m_pixels_out++;
+  IncPerfCounter(PQ_BLEND_INPUT);
 
   EfbInterface::BlendTev(Position[0], Position[1], output);
 }
@@ -874,3 +925,105 @@ void Tev::SetRegColor(int reg, int comp, s16 color)
 {
   KonstantColors[reg][comp] = color;
 }
+
+void Tev::UpdateStages()
+{
+  for (unsigned int stageNum = 0; stageNum <= bpmem.genMode.numtevstages; stageNum++)
+  {
+    const int stageOdd = stageNum & 1;
+    const TwoTevStageOrders& order = bpmem.tevorders[stageNum >> 1];
+    const TevKSel& kSel = bpmem.tevksel[stageNum >> 1];
+    const TevStageCombiner::ColorCombiner& cc = bpmem.combiners[stageNum].colorC;
+    const TevStageCombiner::AlphaCombiner& ac = bpmem.combiners[stageNum].alphaC;
+    Stage& stage = m_stages[stageNum];
+
+    stage.texture_enabled = order.getEnable(stageOdd);
+    stage.texmap = static_cast<u8>(order.getTexMap(stageOdd));
+    stage.texcoord = static_cast<u8>(order.getTexCoord(stageOdd));
+    stage.ras_channel = static_cast<u8>(order.getColorChan(stageOdd));
+
+    const auto set_swap = [](u8* swap, int swaptable) {
+      swap[RED_C] = static_cast<u8>(bpmem.tevksel[swaptable].swap1);
+      swap[GRN_C] = static_cast<u8>(bpmem.tevksel[swaptable].swap2);
+      swap[BLU_C] = static_cast<u8>(bpmem.tevksel[swaptable + 1].swap1);
+      swap[ALP_C] = static_cast<u8>(bpmem.tevksel[swaptable + 1].swap2);
+    };
+    set_swap(stage.tex_swap, ac.tswap * 2);
+    set_swap(stage.ras_swap, ac.rswap * 2);
+
+    const int kc = kSel.getKC(stageOdd);
+    const int ka = kSel.getKA(stageOdd);
+    stage.konst[RED_C] = m_KonstLUT[kc][RED_C];
+    stage.konst[GRN_C] = m_KonstLUT[kc][GRN_C];
+    stage.konst[BLU_C] = m_KonstLUT[kc][BLU_C];
+    stage.konst[ALP_C] = m_KonstLUT[ka][ALP_C];
+
+    for (int i = 0; i < 3; i++)
+    {
+      stage.color_inputs[0][i] = m_ColorInputLUT[cc.a][i];
+      stage.color_inputs[1][i] = m_ColorInputLUT[cc.b][i];
+      stage.color_inputs[2][i] = m_ColorInputLUT[cc.c][i];
+      stage.color_inputs[3][i] = m_ColorInputLUT[cc.d][i];
+    }
+    stage.alpha_inputs[0] = m_AlphaInputLUT[ac.a];
+    stage.alpha_inputs[1] = m_AlphaInputLUT[ac.b];
+    stage.alpha_inputs[2] = m_AlphaInputLUT[ac.c];
+    stage.alpha_inputs[3] = m_AlphaInputLUT[ac.d];
+
+    stage.color_regular = cc.bias != 3;
+    stage.alpha_regular = ac.bias != 3;
+
+    RegularCombiner& combiner = stage.regular_combiner;
+
+    for (int i = 0; i < 4; i++)
+    {
+      const bool alpha = i == ALP_C;
+      const u32 shift = alpha ? ac.shift : cc.shift;
+      const u32 op = alpha ? ac.op : cc.op;
+      const u32 bias = alpha ? ac.bias : cc.bias;
+      const s16 scale = 1 << m_ScaleLShiftLUT[shift];
+
+      combiner.scale[i * 2] = scale;
+      combiner.scale[i * 2 + 1] = scale;
+      combiner.bias_scale[i * 2] = scale;
+      combiner.bias_scale[i * 2 + 1] = 1;
+      combiner.bias[i] = m_BiasLUT[bias];
+      combiner.halve[i] = m_ScaleRShiftLUT[shift] ? -1 : 0;
+
+      // The alpha combiner rounds for the opposite shifts, and negates before shifting down.
+      if (alpha)
+      {
+        combiner.round[i] = (shift != 3) ? 0 : (op == 1) ? 127 : 128;
+        combiner.negate_before_shift[i] = op ? -1 : 0;
+        combiner.negate_after_shift[i] = 0;
+      }
+      else
+      {
+        combiner.round[i] = (shift == 3) ? 0 : (op == 1) ? 127 : 128;
+        combiner.negate_before_shift[i] = 0;
+        combiner.negate_after_shift[i] = op ? -1 : 0;
+      }
+    }
+  }
+}
+
+void Tev::FlushCounters()
+{
+  ADDSTAT(g_stats.this_frame.tev_pixels_in, m_pixels_in);
+  ADDSTAT(g_stats.this_frame.tev_pixels_out, m_pixels_out);
+  m_pixels_in = 0;
+  m_pixels_out = 0;
+
+  for (u32 i = 0; i < PQ_NUM_MEMBERS; i++)
+  {
+    if (m_perf_pixels[i] != 0)
+      EfbInterface::AddPerfCounterPixels(static_cast<PerfQueryType>(i), m_perf_pixels[i]);
+  }
+  m_perf_pixels = {};
+
+  if (m_bbox_updated)
+  {
+    BoundingBox::Update(m_bbox_left, m_bbox_right, m_bbox_top, m_bbox_bottom);
+    m_bbox_updated = false;
+  }
+}
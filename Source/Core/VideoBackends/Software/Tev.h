@@ -4,7 +4,11 @@
 
 #pragma once
 
+#include <array>
+
+#include "Common/CommonTypes.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/PerfQueryBase.h"
 
 class Tev
 {
@@ -57,15 +61,62 @@ class Tev
     INDIRECT = 32
   };
 
-  void SetRasColor(int colorChan, int swaptable);
+  struct Stage;
+
+  void SetRasColor(const Stage& stage);
 
   void DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
   void DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
   void DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
   void DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
 
+  // Constants for evaluating the regular color and alpha combiners of a stage at once, with one
+  // component per lane in ABGR order.
+  struct RegularCombiner
+  {
+    alignas(16) s16 scale[8];       // 1 << shift, for both weights of the lerp
+    alignas(16) s16 bias_scale[8];  // 1 << shift for d + bias, and 1 for the lerp
+    alignas(16) s32 bias[4];
+    alignas(16) s32 round[4];
+    alignas(16) s32 negate_before_shift[4];
+    alignas(16) s32 negate_after_shift[4];
+    alignas(16) s32 halve[4];
+  };
+
+  // The configuration of a TEV stage, decoded from BP memory by UpdateStages() so that drawing a
+  // pixel doesn't have to look up the inputs, swap tables and konst selection of every stage.
+  struct Stage
+  {
+    RegularCombiner regular_combiner;
+    const s16* color_inputs[4][3];  // a, b, c and d, in BGR order
+    const s16* alpha_inputs[4];
+    const s16* konst[4];
+    u8 tex_swap[4];
+    u8 ras_swap[4];
+    u8 ras_channel;
+    u8 texmap;
+    u8 texcoord;
+    bool texture_enabled;
+    bool color_regular;
+    bool alpha_regular;
+  };
+  std::array<Stage, 16> m_stages;
+
+  void DrawRegular(const TevStageCombiner::ColorCombiner& cc,
+                   const TevStageCombiner::AlphaCombiner& ac, const RegularCombiner& combiner,
+                   const InputRegType inputs[4]);
+
   void Indirect(unsigned int stageNum, s32 s, s32 t);
 
+  std::array<u32, PQ_NUM_MEMBERS> m_perf_pixels{};
+  u32 m_pixels_in = 0;
+  u32 m_pixels_out = 0;
+  bool m_bbox_updated = false;
+  u16 m_bbox_left = 0;
+  u16 m_bbox_right = 0;
+  u16 m_bbox_top = 0;
+  u16 m_bbox_bottom = 0;
+
 public:
   s32 Position[3];
   u8 Color[2][4];  // must be RGBA for correct swap table ordering
@@ -88,4 +139,13 @@ public:
   void Draw();
 
   void SetRegColor(int reg, int comp, s16 color);
+
+  // Must be called after the TEV stages in BP memory changed, before drawing with them.
+  void UpdateStages();
+
+  // Each rasterizer thread draws with its own Tev, so the statistics, perf counters and bounding
+  // box of the pixels it draws are tallied here first. FlushCounters() adds them to the global
+  // ones, and must not be called by several threads at once.
+  void IncPerfCounter(PerfQueryType type) { m_perf_pixels[type]++; }
+  void FlushCounters();
 };
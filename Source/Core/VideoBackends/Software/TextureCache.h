@@ -10,8 +10,11 @@ namespace SW
 class TextureCache : public TextureCacheBase
 {
 protected:
-  void CopyEFB(AbstractStagingTexture* dst, const EFBCopyParams& params, u32 native_width,
-               u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
+  // The encoder overrides the stride of the staging texture for each copy, see Encode.
+  bool CanBatchEFBCopyReadbacks() const override { return false; }
+
+  void CopyEFB(AbstractStagingTexture* dst, u32 dst_row, const EFBCopyParams& params,
+               u32 native_width, u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
                const MathUtil::Rectangle<int>& src_rect, bool scale_by_half, bool linear_filter,
                float y_scale, float gamma, bool clamp_top, bool clamp_bottom,
                const EFBCopyFilterCoefficients& filter_coefficients) override
@@ -1425,7 +1425,7 @@ void EncodeEfbCopy(u8* dst, const EFBCopyParams& params, u32 native_width, u32 b
                    u32 num_blocks_y, u32 memory_stride, const MathUtil::Rectangle<int>& src_rect,
                    bool scale_by_half)
 {
-  const u8* src = EfbInterface::GetPixelPointer(src_rect.left, src_rect.top, params.depth);
+  const u8* src = EfbInterface::GetLinearPixelPointer(src_rect.left, src_rect.top, params.depth);
 
   if (scale_by_half)
   {
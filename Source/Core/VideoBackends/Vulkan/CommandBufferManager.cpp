@@ -6,17 +6,25 @@
 
 #include <array>
 #include <cstdint>
+#include <vector>
 
 #include "Common/Assert.h"
 #include "Common/MsgHandler.h"
 #include "Common/Thread.h"
 
+#include "VideoBackends/Vulkan/MemoryAllocator.h"
 #include "VideoBackends/Vulkan/VulkanContext.h"
+#include "VideoCommon/RenderBase.h"
+#include "VideoCommon/VideoConfig.h"
 
 namespace Vulkan
 {
-CommandBufferManager::CommandBufferManager(bool use_threaded_submission)
-    : m_submit_semaphore(1, 1), m_use_threaded_submission(use_threaded_submission)
+CommandBufferManager::CommandBufferManager(bool use_threaded_submission,
+                                           u32 num_secondary_command_pools,
+                                           bool use_async_compute, bool use_transfer_queue)
+    : m_submit_semaphore(1, 1), m_use_threaded_submission(use_threaded_submission),
+      m_num_secondary_command_pools(num_secondary_command_pools),
+      m_use_async_compute(use_async_compute), m_use_transfer_queue(use_transfer_queue)
 {
 }
 
@@ -77,6 +85,17 @@ bool CommandBufferManager::CreateCommandBuffers()
       return false;
     }
 
+    resources.secondary_command_pools.resize(m_num_secondary_command_pools);
+    for (SecondaryCommandPool& secondary_pool : resources.secondary_command_pools)
+    {
+      res = vkCreateCommandPool(device, &pool_info, nullptr, &secondary_pool.command_pool);
+      if (res != VK_SUCCESS)
+      {
+        LOG_VULKAN_ERROR(res, "vkCreateCommandPool failed: ");
+        return false;
+      }
+    }
+
     VkFenceCreateInfo fence_info = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, nullptr,
                                     VK_FENCE_CREATE_SIGNALED_BIT};
 
@@ -94,6 +113,54 @@ bool CommandBufferManager::CreateCommandBuffers()
       return false;
     }
 
+    if (m_use_async_compute)
+    {
+      const VkCommandPoolCreateInfo compute_pool_info = {
+          VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO, nullptr, 0,
+          g_vulkan_context->GetComputeQueueFamilyIndex()};
+      res = vkCreateCommandPool(device, &compute_pool_info, nullptr,
+                                &resources.compute_command_pool);
+      if (res != VK_SUCCESS)
+      {
+        LOG_VULKAN_ERROR(res, "vkCreateCommandPool failed: ");
+        return false;
+      }
+
+      const VkCommandBufferAllocateInfo compute_buffer_info = {
+          VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO, nullptr, resources.compute_command_pool,
+          VK_COMMAND_BUFFER_LEVEL_PRIMARY, 1};
+      res = vkAllocateCommandBuffers(device, &compute_buffer_info,
+                                     &resources.compute_command_buffer);
+      if (res != VK_SUCCESS)
+      {
+        LOG_VULKAN_ERROR(res, "vkAllocateCommandBuffers failed: ");
+        return false;
+      }
+
+      res = vkCreateSemaphore(device, &semaphore_create_info, nullptr,
+                              &resources.compute_semaphore);
+      if (res != VK_SUCCESS)
+      {
+        LOG_VULKAN_ERROR(res, "vkCreateSemaphore failed: ");
+        return false;
+      }
+    }
+
+    // Transfer command buffers and semaphores are created on demand.
+    if (m_use_transfer_queue)
+    {
+      const VkCommandPoolCreateInfo transfer_pool_info = {
+          VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO, nullptr, 0,
+          g_vulkan_context->GetTransferQueueFamilyIndex()};
+      res = vkCreateCommandPool(device, &transfer_pool_info, nullptr,
+                                &resources.transfer_command_pool);
+      if (res != VK_SUCCESS)
+      {
+        LOG_VULKAN_ERROR(res, "vkCreateCommandPool failed: ");
+        return false;
+      }
+    }
+
     // TODO: A better way to choose the number of descriptors.
     const std::array<VkDescriptorPoolSize, 5> pool_sizes{{
         {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 500000},
@@ -127,6 +194,23 @@ bool CommandBufferManager::CreateCommandBuffers()
     return false;
   }
 
+  // Without timestamps, dynamic resolution keeps the configured scale.
+  if (g_vulkan_context->GetDeviceLimits().timestampComputeAndGraphics)
+  {
+    const VkQueryPoolCreateInfo query_pool_info = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                                                   nullptr,
+                                                   0,
+                                                   VK_QUERY_TYPE_TIMESTAMP,
+                                                   NUM_COMMAND_BUFFERS * 2,
+                                                   0};
+    res = vkCreateQueryPool(device, &query_pool_info, nullptr, &m_timestamp_query_pool);
+    if (res != VK_SUCCESS)
+    {
+      LOG_VULKAN_ERROR(res, "vkCreateQueryPool failed: ");
+      m_timestamp_query_pool = VK_NULL_HANDLE;
+    }
+  }
+
   // Activate the first command buffer. ActivateCommandBuffer moves forward, so start with the last
   m_current_frame = static_cast<u32>(m_frame_resources.size()) - 1;
   BeginCommandBuffer();
@@ -145,6 +229,15 @@ void CommandBufferManager::DestroyCommandBuffers()
     // objects which are pending destruction being in-use.
     if (resources.command_pool != VK_NULL_HANDLE)
       vkDestroyCommandPool(device, resources.command_pool, nullptr);
+    for (SecondaryCommandPool& secondary_pool : resources.secondary_command_pools)
+    {
+      if (secondary_pool.command_pool != VK_NULL_HANDLE)
+        vkDestroyCommandPool(device, secondary_pool.command_pool, nullptr);
+    }
+    if (resources.compute_command_pool != VK_NULL_HANDLE)
+      vkDestroyCommandPool(device, resources.compute_command_pool, nullptr);
+    if (resources.transfer_command_pool != VK_NULL_HANDLE)
+      vkDestroyCommandPool(device, resources.transfer_command_pool, nullptr);
 
     // Destroy any pending objects.
     for (auto& it : resources.cleanup_resources)
@@ -153,6 +246,12 @@ void CommandBufferManager::DestroyCommandBuffers()
     if (resources.semaphore != VK_NULL_HANDLE)
       vkDestroySemaphore(device, resources.semaphore, nullptr);
 
+    if (resources.compute_semaphore != VK_NULL_HANDLE)
+      vkDestroySemaphore(device, resources.compute_semaphore, nullptr);
+
+    for (VkSemaphore semaphore : resources.transfer_semaphores)
+      vkDestroySemaphore(device, semaphore, nullptr);
+
     if (resources.fence != VK_NULL_HANDLE)
       vkDestroyFence(device, resources.fence, nullptr);
 
@@ -161,6 +260,9 @@ void CommandBufferManager::DestroyCommandBuffers()
   }
 
   vkDestroySemaphore(device, m_present_semaphore, nullptr);
+
+  if (m_timestamp_query_pool != VK_NULL_HANDLE)
+    vkDestroyQueryPool(device, m_timestamp_query_pool, nullptr);
 }
 
 VkDescriptorSet CommandBufferManager::AllocateDescriptorSet(VkDescriptorSetLayout set_layout)
@@ -182,6 +284,32 @@ VkDescriptorSet CommandBufferManager::AllocateDescriptorSet(VkDescriptorSetLayou
   return descriptor_set;
 }
 
+VkCommandBuffer CommandBufferManager::AllocateSecondaryCommandBuffer(u32 pool_index)
+{
+  SecondaryCommandPool& pool =
+      m_frame_resources[m_current_frame].secondary_command_pools[pool_index];
+
+  // Command buffers are only reset along with the pool, so re-use the ones allocated before.
+  if (pool.num_used_command_buffers == pool.command_buffers.size())
+  {
+    VkCommandBufferAllocateInfo buffer_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                                               nullptr, pool.command_pool,
+                                               VK_COMMAND_BUFFER_LEVEL_SECONDARY, 1};
+    VkCommandBuffer command_buffer;
+    VkResult res =
+        vkAllocateCommandBuffers(g_vulkan_context->GetDevice(), &buffer_info, &command_buffer);
+    if (res != VK_SUCCESS)
+    {
+      LOG_VULKAN_ERROR(res, "vkAllocateCommandBuffers failed: ");
+      return VK_NULL_HANDLE;
+    }
+
+    pool.command_buffers.push_back(command_buffer);
+  }
+
+  return pool.command_buffers[pool.num_used_command_buffers++];
+}
+
 bool CommandBufferManager::CreateSubmitThread()
 {
   m_submit_loop = std::make_unique<Common::BlockingLoop>();
@@ -259,6 +387,9 @@ void CommandBufferManager::WaitForCommandBufferCompletion(u32 index)
 
     if (resources.fence_counter > m_completed_fence_counter)
     {
+      if (resources.timestamps_written)
+        ReadTimestamps(cleanup_index);
+
       for (auto& it : resources.cleanup_resources)
         it();
       resources.cleanup_resources.clear();
@@ -270,6 +401,28 @@ void CommandBufferManager::WaitForCommandBufferCompletion(u32 index)
   m_completed_fence_counter = now_completed_counter;
 }
 
+void CommandBufferManager::ReadTimestamps(u32 command_buffer_index)
+{
+  FrameResources& resources = m_frame_resources[command_buffer_index];
+  resources.timestamps_written = false;
+
+  // The command buffer has completed, so the results are available without waiting.
+  std::array<u64, 2> timestamps;
+  VkResult res = vkGetQueryPoolResults(g_vulkan_context->GetDevice(), m_timestamp_query_pool,
+                                       command_buffer_index * 2, 2, sizeof(timestamps),
+                                       timestamps.data(), sizeof(u64), VK_QUERY_RESULT_64_BIT);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkGetQueryPoolResults failed: ");
+    return;
+  }
+
+  const double elapsed_ns = static_cast<double>(timestamps[1] - timestamps[0]) *
+                            g_vulkan_context->GetDeviceLimits().timestampPeriod;
+  if (g_renderer)
+    g_renderer->AddGPUTime(resources.timestamp_frame, elapsed_ns / 1000000.0);
+}
+
 void CommandBufferManager::SubmitCommandBuffer(bool submit_on_worker_thread,
                                                bool wait_for_completion,
                                                VkSwapchainKHR present_swap_chain,
@@ -277,6 +430,12 @@ void CommandBufferManager::SubmitCommandBuffer(bool submit_on_worker_thread,
 {
   // End the current command buffer.
   FrameResources& resources = m_frame_resources[m_current_frame];
+  if (resources.timestamps_written)
+  {
+    vkCmdWriteTimestamp(resources.command_buffers[1], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                        m_timestamp_query_pool, m_current_frame * 2 + 1);
+    resources.timestamp_frame = g_renderer ? g_renderer->GetFrameCount() : 0;
+  }
   for (VkCommandBuffer command_buffer : resources.command_buffers)
   {
     VkResult res = vkEndCommandBuffer(command_buffer);
@@ -286,6 +445,15 @@ void CommandBufferManager::SubmitCommandBuffer(bool submit_on_worker_thread,
       PanicAlertFmt("Failed to end command buffer");
     }
   }
+  if (m_use_async_compute)
+  {
+    VkResult res = vkEndCommandBuffer(resources.compute_command_buffer);
+    if (res != VK_SUCCESS)
+    {
+      LOG_VULKAN_ERROR(res, "vkEndCommandBuffer failed: ");
+      PanicAlertFmt("Failed to end command buffer");
+    }
+  }
 
   // Grab the semaphore before submitting command buffer either on-thread or off-thread.
   // This prevents a race from occurring where a second command buffer is executed
@@ -323,12 +491,13 @@ void CommandBufferManager::SubmitCommandBuffer(u32 command_buffer_index,
   FrameResources& resources = m_frame_resources[command_buffer_index];
 
   // This may be executed on the worker thread, so don't modify any state of the manager class.
-  uint32_t wait_bits = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  std::vector<VkSemaphore> wait_semaphores(2 + resources.num_used_transfer_semaphores);
+  std::vector<VkPipelineStageFlags> wait_bits(wait_semaphores.size());
   VkSubmitInfo submit_info = {VK_STRUCTURE_TYPE_SUBMIT_INFO,
                               nullptr,
                               0,
-                              nullptr,
-                              &wait_bits,
+                              wait_semaphores.data(),
+                              wait_bits.data(),
                               static_cast<u32>(resources.command_buffers.size()),
                               resources.command_buffers.data(),
                               0,
@@ -343,8 +512,42 @@ void CommandBufferManager::SubmitCommandBuffer(u32 command_buffer_index,
 
   if (resources.semaphore_used)
   {
-    submit_info.pWaitSemaphores = &resources.semaphore;
-    submit_info.waitSemaphoreCount = 1;
+    wait_semaphores[submit_info.waitSemaphoreCount] = resources.semaphore;
+    wait_bits[submit_info.waitSemaphoreCount++] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  }
+
+  // The compute work is submitted first, so that it can start while the GPU is still busy with
+  // the previous command buffers, and only the commands consuming its results wait for it.
+  if (resources.compute_command_buffer_used)
+  {
+    const VkSubmitInfo compute_submit_info = {VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                                              nullptr,
+                                              0,
+                                              nullptr,
+                                              nullptr,
+                                              1,
+                                              &resources.compute_command_buffer,
+                                              1,
+                                              &resources.compute_semaphore};
+    VkResult res = vkQueueSubmit(g_vulkan_context->GetComputeQueue(), 1, &compute_submit_info,
+                                 VK_NULL_HANDLE);
+    if (res != VK_SUCCESS)
+    {
+      LOG_VULKAN_ERROR(res, "vkQueueSubmit failed: ");
+      PanicAlertFmt("Failed to submit compute command buffer.");
+    }
+
+    wait_semaphores[submit_info.waitSemaphoreCount] = resources.compute_semaphore;
+    wait_bits[submit_info.waitSemaphoreCount++] =
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+  }
+
+  // The transfer command buffers have already been submitted. Their queue family ownership
+  // transfers are completed by barriers with a source stage of TRANSFER.
+  for (size_t i = 0; i < resources.num_used_transfer_semaphores; i++)
+  {
+    wait_semaphores[submit_info.waitSemaphoreCount] = resources.transfer_semaphores[i];
+    wait_bits[submit_info.waitSemaphoreCount++] = VK_PIPELINE_STAGE_TRANSFER_BIT;
   }
 
   if (present_swap_chain != VK_NULL_HANDLE)
@@ -419,6 +622,27 @@ void CommandBufferManager::BeginCommandBuffer()
   res = vkResetCommandPool(g_vulkan_context->GetDevice(), resources.command_pool, 0);
   if (res != VK_SUCCESS)
     LOG_VULKAN_ERROR(res, "vkResetCommandPool failed: ");
+  for (SecondaryCommandPool& secondary_pool : resources.secondary_command_pools)
+  {
+    res = vkResetCommandPool(g_vulkan_context->GetDevice(), secondary_pool.command_pool, 0);
+    if (res != VK_SUCCESS)
+      LOG_VULKAN_ERROR(res, "vkResetCommandPool failed: ");
+    secondary_pool.num_used_command_buffers = 0;
+  }
+  if (m_use_async_compute)
+  {
+    res = vkResetCommandPool(g_vulkan_context->GetDevice(), resources.compute_command_pool, 0);
+    if (res != VK_SUCCESS)
+      LOG_VULKAN_ERROR(res, "vkResetCommandPool failed: ");
+  }
+  if (m_use_transfer_queue)
+  {
+    res = vkResetCommandPool(g_vulkan_context->GetDevice(), resources.transfer_command_pool, 0);
+    if (res != VK_SUCCESS)
+      LOG_VULKAN_ERROR(res, "vkResetCommandPool failed: ");
+    resources.num_used_transfer_command_buffers = 0;
+    resources.num_used_transfer_semaphores = 0;
+  }
 
   // Enable commands to be recorded to the two buffers again.
   VkCommandBufferBeginInfo begin_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, nullptr,
@@ -429,6 +653,24 @@ void CommandBufferManager::BeginCommandBuffer()
     if (res != VK_SUCCESS)
       LOG_VULKAN_ERROR(res, "vkBeginCommandBuffer failed: ");
   }
+  if (m_use_async_compute)
+  {
+    res = vkBeginCommandBuffer(resources.compute_command_buffer, &begin_info);
+    if (res != VK_SUCCESS)
+      LOG_VULKAN_ERROR(res, "vkBeginCommandBuffer failed: ");
+  }
+
+  // Only the draw command buffer is timed. Gaps between command buffers, where the GPU waits for
+  // the CPU, aren't counted, so that the time reflects how busy the GPU is.
+  resources.timestamps_written =
+      m_timestamp_query_pool != VK_NULL_HANDLE && g_ActiveConfig.bDynamicResolution;
+  if (resources.timestamps_written)
+  {
+    vkCmdResetQueryPool(resources.command_buffers[1], m_timestamp_query_pool,
+                        next_buffer_index * 2, 2);
+    vkCmdWriteTimestamp(resources.command_buffers[1], VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                        m_timestamp_query_pool, next_buffer_index * 2);
+  }
 
   // Also can do the same for the descriptor pools
   res = vkResetDescriptorPool(g_vulkan_context->GetDevice(), resources.descriptor_pool, 0);
@@ -438,10 +680,79 @@ void CommandBufferManager::BeginCommandBuffer()
   // Reset upload command buffer state
   resources.init_command_buffer_used = false;
   resources.semaphore_used = false;
+  resources.compute_command_buffer_used = false;
   resources.fence_counter = m_next_fence_counter++;
   m_current_frame = next_buffer_index;
 }
 
+VkCommandBuffer CommandBufferManager::AllocateTransferCommandBuffer()
+{
+  FrameResources& resources = m_frame_resources[m_current_frame];
+  if (resources.num_used_transfer_command_buffers == resources.transfer_command_buffers.size())
+  {
+    const VkCommandBufferAllocateInfo buffer_info = {
+        VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO, nullptr, resources.transfer_command_pool,
+        VK_COMMAND_BUFFER_LEVEL_PRIMARY, 1};
+    VkCommandBuffer command_buffer;
+    VkResult res =
+        vkAllocateCommandBuffers(g_vulkan_context->GetDevice(), &buffer_info, &command_buffer);
+    if (res != VK_SUCCESS)
+    {
+      LOG_VULKAN_ERROR(res, "vkAllocateCommandBuffers failed: ");
+      return VK_NULL_HANDLE;
+    }
+    resources.transfer_command_buffers.push_back(command_buffer);
+  }
+
+  VkCommandBuffer command_buffer =
+      resources.transfer_command_buffers[resources.num_used_transfer_command_buffers++];
+  const VkCommandBufferBeginInfo begin_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                                               nullptr,
+                                               VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr};
+  VkResult res = vkBeginCommandBuffer(command_buffer, &begin_info);
+  if (res != VK_SUCCESS)
+    LOG_VULKAN_ERROR(res, "vkBeginCommandBuffer failed: ");
+  return command_buffer;
+}
+
+void CommandBufferManager::SubmitTransferCommandBuffer(VkCommandBuffer command_buffer)
+{
+  FrameResources& resources = m_frame_resources[m_current_frame];
+  VkResult res = vkEndCommandBuffer(command_buffer);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkEndCommandBuffer failed: ");
+    PanicAlertFmt("Failed to end command buffer");
+  }
+
+  if (resources.num_used_transfer_semaphores == resources.transfer_semaphores.size())
+  {
+    static constexpr VkSemaphoreCreateInfo semaphore_create_info = {
+        VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, nullptr, 0};
+    VkSemaphore semaphore;
+    res = vkCreateSemaphore(g_vulkan_context->GetDevice(), &semaphore_create_info, nullptr,
+                            &semaphore);
+    if (res != VK_SUCCESS)
+    {
+      LOG_VULKAN_ERROR(res, "vkCreateSemaphore failed: ");
+      PanicAlertFmt("Failed to create transfer semaphore");
+      return;
+    }
+    resources.transfer_semaphores.push_back(semaphore);
+  }
+
+  VkSemaphore semaphore = resources.transfer_semaphores[resources.num_used_transfer_semaphores++];
+  const VkSubmitInfo submit_info = {
+      VK_STRUCTURE_TYPE_SUBMIT_INFO, nullptr, 0, nullptr, nullptr, 1, &command_buffer, 1,
+      &semaphore};
+  res = vkQueueSubmit(g_vulkan_context->GetTransferQueue(), 1, &submit_info, VK_NULL_HANDLE);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkQueueSubmit failed: ");
+    PanicAlertFmt("Failed to submit transfer command buffer.");
+  }
+}
+
 void CommandBufferManager::DeferBufferDestruction(VkBuffer object)
 {
   FrameResources& resources = m_frame_resources[m_current_frame];
@@ -484,5 +795,12 @@ void CommandBufferManager::DeferImageViewDestruction(VkImageView object)
       [object]() { vkDestroyImageView(g_vulkan_context->GetDevice(), object, nullptr); });
 }
 
+void CommandBufferManager::DeferMemoryAllocationDestruction(const MemoryAllocation& allocation)
+{
+  FrameResources& resources = m_frame_resources[m_current_frame];
+  resources.cleanup_resources.push_back(
+      [allocation]() { g_memory_allocator->Free(allocation); });
+}
+
 std::unique_ptr<CommandBufferManager> g_command_buffer_mgr;
 }  // namespace Vulkan
@@ -23,10 +23,13 @@
 
 namespace Vulkan
 {
+struct MemoryAllocation;
+
 class CommandBufferManager
 {
 public:
-  explicit CommandBufferManager(bool use_threaded_submission);
+  CommandBufferManager(bool use_threaded_submission, u32 num_secondary_command_pools,
+                       bool use_async_compute, bool use_transfer_queue);
   ~CommandBufferManager();
 
   bool Initialize();
@@ -42,6 +45,24 @@ public:
   {
     return m_frame_resources[m_current_frame].command_buffers[1];
   }
+  // Command buffer for the async compute queue. It is submitted before the current command
+  // buffer, and the compute shader and transfer stages of the current command buffer wait for it
+  // to complete. Only available if UsesAsyncCompute() returns true.
+  VkCommandBuffer GetCurrentComputeCommandBuffer()
+  {
+    m_frame_resources[m_current_frame].compute_command_buffer_used = true;
+    return m_frame_resources[m_current_frame].compute_command_buffer;
+  }
+  bool UsesAsyncCompute() const { return m_use_async_compute; }
+
+  // Command buffers for the transfer queue. Unlike the compute command buffer, each of them is
+  // submitted as soon as it has been recorded, so that it can run while the GPU is still busy
+  // with earlier command buffers. The transfer and shader stages of the current command buffer
+  // wait for it to complete. Only available if UsesTransferQueue() returns true.
+  VkCommandBuffer AllocateTransferCommandBuffer();
+  void SubmitTransferCommandBuffer(VkCommandBuffer command_buffer);
+  bool UsesTransferQueue() const { return m_use_transfer_queue; }
+
   VkDescriptorPool GetCurrentDescriptorPool() const
   {
     return m_frame_resources[m_current_frame].descriptor_pool;
@@ -49,6 +70,11 @@ public:
   // Allocates a descriptors set from the pool reserved for the current frame.
   VkDescriptorSet AllocateDescriptorSet(VkDescriptorSetLayout set_layout);
 
+  // Returns a secondary command buffer for the current frame, which is valid until the current
+  // command buffer is submitted. Each pool may only be used by one thread at a time, so threads
+  // recording concurrently have to use different pools.
+  VkCommandBuffer AllocateSecondaryCommandBuffer(u32 pool_index);
+
   // Fence "counters" are used to track which commands have been completed by the GPU.
   // If the last completed fence counter is greater or equal to N, it means that the work
   // associated counter N has been completed by the GPU. The value of N to associate with
@@ -90,6 +116,7 @@ public:
   void DeferFramebufferDestruction(VkFramebuffer object);
   void DeferImageDestruction(VkImage object);
   void DeferImageViewDestruction(VkImageView object);
+  void DeferMemoryAllocationDestruction(const MemoryAllocation& allocation);
 
 private:
   bool CreateCommandBuffers();
@@ -101,12 +128,21 @@ private:
   void SubmitCommandBuffer(u32 command_buffer_index, VkSwapchainKHR present_swap_chain,
                            u32 present_image_index);
   void BeginCommandBuffer();
+  void ReadTimestamps(u32 command_buffer_index);
+
+  struct SecondaryCommandPool
+  {
+    VkCommandPool command_pool = VK_NULL_HANDLE;
+    std::vector<VkCommandBuffer> command_buffers;
+    size_t num_used_command_buffers = 0;
+  };
 
   struct FrameResources
   {
     // [0] - Init (upload) command buffer, [1] - draw command buffer
     VkCommandPool command_pool = VK_NULL_HANDLE;
     std::array<VkCommandBuffer, 2> command_buffers = {};
+    std::vector<SecondaryCommandPool> secondary_command_pools;
     VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
     VkFence fence = VK_NULL_HANDLE;
     VkSemaphore semaphore = VK_NULL_HANDLE;
@@ -114,6 +150,24 @@ private:
     bool init_command_buffer_used = false;
     bool semaphore_used = false;
 
+    // Timestamps at the start and end of the draw command buffer, and the frame it was part of.
+    bool timestamps_written = false;
+    u64 timestamp_frame = 0;
+
+    // The compute command buffer doesn't have a fence of its own, as the draw command buffer
+    // can't complete before it.
+    VkCommandPool compute_command_pool = VK_NULL_HANDLE;
+    VkCommandBuffer compute_command_buffer = VK_NULL_HANDLE;
+    VkSemaphore compute_semaphore = VK_NULL_HANDLE;
+    bool compute_command_buffer_used = false;
+
+    // Likewise for the transfer command buffers, which are waited on by the draw command buffer.
+    VkCommandPool transfer_command_pool = VK_NULL_HANDLE;
+    std::vector<VkCommandBuffer> transfer_command_buffers;
+    std::vector<VkSemaphore> transfer_semaphores;
+    size_t num_used_transfer_command_buffers = 0;
+    size_t num_used_transfer_semaphores = 0;
+
     std::vector<std::function<void()>> cleanup_resources;
   };
 
@@ -123,6 +177,9 @@ private:
   std::array<FrameResources, NUM_COMMAND_BUFFERS> m_frame_resources;
   u32 m_current_frame;
 
+  // Two queries per command buffer, for measuring the GPU time of frames for dynamic resolution.
+  VkQueryPool m_timestamp_query_pool = VK_NULL_HANDLE;
+
   // Threaded command buffer execution
   // Semaphore determines when a command buffer can be queued
   Common::Semaphore m_submit_semaphore;
@@ -140,6 +197,9 @@ private:
   Common::Flag m_last_present_failed;
   VkResult m_last_present_result = VK_SUCCESS;
   bool m_use_threaded_submission = false;
+  u32 m_num_secondary_command_pools = 0;
+  bool m_use_async_compute = false;
+  bool m_use_transfer_queue = false;
 };
 
 extern std::unique_ptr<CommandBufferManager> g_command_buffer_mgr;
@@ -0,0 +1,233 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoBackends/Vulkan/CommandRecorder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Common/Assert.h"
+#include "Common/Thread.h"
+
+#include "VideoBackends/Vulkan/CommandBufferManager.h"
+#include "VideoBackends/Vulkan/VulkanContext.h"
+
+namespace Vulkan
+{
+CommandRecorder::CommandRecorder(u32 num_worker_threads)
+{
+  // Pool 0 is used by the video thread, the workers use the ones after it.
+  for (u32 i = 0; i < num_worker_threads; i++)
+    m_worker_threads.emplace_back(&CommandRecorder::WorkerThreadRun, this, i + 1);
+}
+
+CommandRecorder::~CommandRecorder()
+{
+  {
+    std::lock_guard<std::mutex> guard(m_chunk_lock);
+    m_exit = true;
+  }
+  m_chunk_available.notify_all();
+
+  for (std::thread& thread : m_worker_threads)
+    thread.join();
+}
+
+void CommandRecorder::BeginRenderPass(const VkRenderPassBeginInfo& begin_info)
+{
+  ASSERT(!m_deferring_render_pass && m_draws.empty());
+  ASSERT(begin_info.clearValueCount <= m_clear_values.size());
+
+  m_begin_info = begin_info;
+  if (begin_info.clearValueCount > 0)
+  {
+    std::copy_n(begin_info.pClearValues, begin_info.clearValueCount, m_clear_values.begin());
+    m_begin_info.pClearValues = m_clear_values.data();
+  }
+  m_deferring_render_pass = true;
+}
+
+void CommandRecorder::Flush(VkCommandBuffer command_buffer)
+{
+  const size_t num_chunks =
+      std::min(m_worker_threads.size() + 1, m_draws.size() / MIN_DRAWS_PER_CHUNK);
+  if (num_chunks < 2)
+  {
+    FlushInline(command_buffer);
+    return;
+  }
+
+  vkCmdBeginRenderPass(command_buffer, &m_begin_info,
+                       VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+  std::unique_lock<std::mutex> lock(m_chunk_lock);
+  m_chunks.clear();
+  for (size_t i = 0; i < num_chunks; i++)
+  {
+    m_chunks.push_back({m_draws.data() + m_draws.size() * i / num_chunks,
+                        m_draws.data() + m_draws.size() * (i + 1) / num_chunks, VK_NULL_HANDLE});
+  }
+  m_next_chunk = 0;
+  m_pending_chunks = num_chunks;
+  m_chunk_available.notify_all();
+
+  // Rather than only waiting for the workers, record chunks on this thread as well.
+  RecordChunks(lock, 0);
+  m_chunks_done.wait(lock, [this]() { return m_pending_chunks == 0; });
+
+  std::vector<VkCommandBuffer> command_buffers;
+  for (const Chunk& chunk : m_chunks)
+  {
+    if (chunk.command_buffer != VK_NULL_HANDLE)
+      command_buffers.push_back(chunk.command_buffer);
+  }
+  if (!command_buffers.empty())
+  {
+    vkCmdExecuteCommands(command_buffer, static_cast<u32>(command_buffers.size()),
+                         command_buffers.data());
+  }
+
+  m_draws.clear();
+  m_deferring_render_pass = false;
+}
+
+void CommandRecorder::FlushInline(VkCommandBuffer command_buffer)
+{
+  vkCmdBeginRenderPass(command_buffer, &m_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+  if (!m_draws.empty())
+    RecordDraws(command_buffer, m_draws.data(), m_draws.data() + m_draws.size());
+
+  m_draws.clear();
+  m_deferring_render_pass = false;
+}
+
+void CommandRecorder::RecordDraws(VkCommandBuffer command_buffer, const DrawCommand* begin,
+                                  const DrawCommand* end)
+{
+  const DrawCommand* last = nullptr;
+  for (const DrawCommand* draw = begin; draw != end; last = draw++)
+  {
+    if (!last || draw->pipeline != last->pipeline)
+      vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw->pipeline);
+
+    if (!last || draw->pipeline_layout != last->pipeline_layout ||
+        draw->num_descriptor_sets != last->num_descriptor_sets ||
+        draw->num_dynamic_offsets != last->num_dynamic_offsets ||
+        !std::equal(draw->descriptor_sets.begin(),
+                    draw->descriptor_sets.begin() + draw->num_descriptor_sets,
+                    last->descriptor_sets.begin()) ||
+        !std::equal(draw->dynamic_offsets.begin(),
+                    draw->dynamic_offsets.begin() + draw->num_dynamic_offsets,
+                    last->dynamic_offsets.begin()))
+    {
+      vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              draw->pipeline_layout, 0, draw->num_descriptor_sets,
+                              draw->descriptor_sets.data(), draw->num_dynamic_offsets,
+                              draw->dynamic_offsets.data());
+    }
+
+    if (draw->vertex_buffer != VK_NULL_HANDLE &&
+        (!last || draw->vertex_buffer != last->vertex_buffer ||
+         draw->vertex_buffer_offset != last->vertex_buffer_offset))
+    {
+      vkCmdBindVertexBuffers(command_buffer, 0, 1, &draw->vertex_buffer,
+                             &draw->vertex_buffer_offset);
+    }
+
+    if (!last || std::memcmp(&draw->viewport, &last->viewport, sizeof(draw->viewport)) != 0)
+      vkCmdSetViewport(command_buffer, 0, 1, &draw->viewport);
+
+    if (!last || std::memcmp(&draw->scissor, &last->scissor, sizeof(draw->scissor)) != 0)
+      vkCmdSetScissor(command_buffer, 0, 1, &draw->scissor);
+
+    if (draw->indexed)
+    {
+      // Non-indexed draws don't bind the index buffer, so the last draws can't be compared to.
+      if (!last || !last->indexed || draw->index_buffer != last->index_buffer ||
+          draw->index_buffer_offset != last->index_buffer_offset ||
+          draw->index_type != last->index_type)
+      {
+        vkCmdBindIndexBuffer(command_buffer, draw->index_buffer, draw->index_buffer_offset,
+                             draw->index_type);
+      }
+
+      vkCmdDrawIndexed(command_buffer, draw->num_vertices, 1, draw->base_index,
+                       static_cast<s32>(draw->base_vertex), 0);
+    }
+    else
+    {
+      vkCmdDraw(command_buffer, draw->num_vertices, 1, draw->base_vertex, 0);
+    }
+  }
+}
+
+void CommandRecorder::WorkerThreadRun(u32 pool_index)
+{
+  Common::SetCurrentThreadName("Vulkan CommandRecorder WorkerThread");
+
+  std::unique_lock<std::mutex> lock(m_chunk_lock);
+  while (true)
+  {
+    m_chunk_available.wait(lock, [this]() { return m_exit || m_next_chunk < m_chunks.size(); });
+    if (m_exit)
+      return;
+
+    RecordChunks(lock, pool_index);
+  }
+}
+
+void CommandRecorder::RecordChunks(std::unique_lock<std::mutex>& lock, u32 pool_index)
+{
+  while (m_next_chunk < m_chunks.size())
+  {
+    Chunk& chunk = m_chunks[m_next_chunk++];
+    lock.unlock();
+    chunk.command_buffer = RecordChunk(chunk, pool_index);
+    lock.lock();
+
+    if (--m_pending_chunks == 0)
+      m_chunks_done.notify_one();
+  }
+}
+
+VkCommandBuffer CommandRecorder::RecordChunk(const Chunk& chunk, u32 pool_index) const
+{
+  VkCommandBuffer command_buffer = g_command_buffer_mgr->AllocateSecondaryCommandBuffer(pool_index);
+  if (command_buffer == VK_NULL_HANDLE)
+    return VK_NULL_HANDLE;
+
+  const VkCommandBufferInheritanceInfo inheritance_info = {
+      VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+      nullptr,
+      m_begin_info.renderPass,
+      0,
+      m_begin_info.framebuffer,
+      VK_FALSE,
+      0,
+      0};
+  const VkCommandBufferBeginInfo begin_info = {
+      VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, nullptr,
+      VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+          VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+      &inheritance_info};
+
+  VkResult res = vkBeginCommandBuffer(command_buffer, &begin_info);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkBeginCommandBuffer failed: ");
+    return VK_NULL_HANDLE;
+  }
+
+  RecordDraws(command_buffer, chunk.begin, chunk.end);
+
+  res = vkEndCommandBuffer(command_buffer);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkEndCommandBuffer failed: ");
+    return VK_NULL_HANDLE;
+  }
+
+  return command_buffer;
+}
+}  // namespace Vulkan
@@ -0,0 +1,103 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Vulkan/Constants.h"
+
+namespace Vulkan
+{
+// Defers the draws of a render pass, so that they can be recorded into secondary command buffers
+// on several threads once the render pass ends. The video thread only stores the state of each
+// draw, and records a share of the draws itself while the worker threads record the rest.
+class CommandRecorder
+{
+public:
+  static constexpr u32 MAX_DESCRIPTOR_SETS = 3;
+
+  // Render passes are only split once each chunk has at least this many draws, as smaller ones
+  // aren't worth the overhead of the secondary command buffers and waking up the workers.
+  static constexpr size_t MIN_DRAWS_PER_CHUNK = 64;
+
+  // Secondary command buffers don't inherit any state, so each draw holds everything it binds.
+  // The binds which don't change between draws are skipped when recording.
+  struct DrawCommand
+  {
+    VkPipeline pipeline;
+    VkPipelineLayout pipeline_layout;
+    std::array<VkDescriptorSet, MAX_DESCRIPTOR_SETS> descriptor_sets;
+    std::array<u32, NUM_UBO_DESCRIPTOR_SET_BINDINGS> dynamic_offsets;
+    u32 num_descriptor_sets;
+    u32 num_dynamic_offsets;
+    VkBuffer vertex_buffer;
+    VkDeviceSize vertex_buffer_offset;
+    VkBuffer index_buffer;
+    VkDeviceSize index_buffer_offset;
+    VkIndexType index_type;
+    VkViewport viewport;
+    VkRect2D scissor;
+    u32 num_vertices;  // Number of indices for indexed draws.
+    u32 base_vertex;
+    u32 base_index;
+    bool indexed;
+  };
+
+  explicit CommandRecorder(u32 num_worker_threads);
+  ~CommandRecorder();
+
+  // Starts deferring a render pass. It is begun in the command buffer when it is flushed.
+  void BeginRenderPass(const VkRenderPassBeginInfo& begin_info);
+  bool IsDeferringRenderPass() const { return m_deferring_render_pass; }
+
+  void AddDraw(const DrawCommand& draw) { m_draws.push_back(draw); }
+
+  // Begins the render pass in the command buffer and records the deferred draws into
+  // secondary command buffers, or directly if there are too few of them. Nothing else can be
+  // recorded into the render pass afterwards.
+  void Flush(VkCommandBuffer command_buffer);
+
+  // Begins the render pass in the command buffer with inline contents and records the deferred
+  // draws into it directly, so that further commands can be recorded into the render pass.
+  void FlushInline(VkCommandBuffer command_buffer);
+
+private:
+  struct Chunk
+  {
+    const DrawCommand* begin;
+    const DrawCommand* end;
+    VkCommandBuffer command_buffer;
+  };
+
+  static void RecordDraws(VkCommandBuffer command_buffer, const DrawCommand* begin,
+                          const DrawCommand* end);
+
+  void WorkerThreadRun(u32 pool_index);
+
+  // Records chunks until none are left. Must be called with the lock held.
+  void RecordChunks(std::unique_lock<std::mutex>& lock, u32 pool_index);
+  VkCommandBuffer RecordChunk(const Chunk& chunk, u32 pool_index) const;
+
+  VkRenderPassBeginInfo m_begin_info = {};
+  std::array<VkClearValue, 2> m_clear_values = {};
+  std::vector<DrawCommand> m_draws;
+  bool m_deferring_render_pass = false;
+
+  std::vector<std::thread> m_worker_threads;
+  std::mutex m_chunk_lock;
+  std::condition_variable m_chunk_available;
+  std::condition_variable m_chunks_done;
+  std::vector<Chunk> m_chunks;
+  size_t m_next_chunk = 0;
+  size_t m_pending_chunks = 0;
+  bool m_exit = false;
+};
+}  // namespace Vulkan
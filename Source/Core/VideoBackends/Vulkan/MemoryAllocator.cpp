@@ -0,0 +1,352 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoBackends/Vulkan/MemoryAllocator.h"
+
+#include <algorithm>
+#include <set>
+
+#include "Common/Align.h"
+#include "Common/Logging/Log.h"
+#include "Common/MathUtil.h"
+
+#include "VideoBackends/Vulkan/VulkanContext.h"
+
+#include "VideoCommon/Statistics.h"
+
+namespace Vulkan
+{
+// Upper bound of the block size. Smaller heaps get smaller blocks.
+constexpr VkDeviceSize MAX_BLOCK_SIZE = 32 * 1024 * 1024;
+constexpr VkDeviceSize MIN_BLOCK_SIZE = 1024 * 1024;
+
+// A block is released once it has been empty for this many frames, unless it is the last block
+// of its pool. Games tend to free and recreate their render targets all at once, so this avoids
+// returning memory to the driver only to allocate it again right away.
+constexpr u64 EMPTY_BLOCK_RELEASE_FRAMES = 300;
+
+struct MemoryBlock
+{
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  VkDeviceSize size = 0;
+  char* map_pointer = nullptr;
+
+  // Offsets of the free ranges of each order, where a range of order n is
+  // m_min_allocation_size << n bytes large and aligned to its size.
+  std::vector<std::set<VkDeviceSize>> free_ranges;
+  VkDeviceSize used_bytes = 0;
+  u64 empty_since_frame = 0;
+};
+
+std::unique_ptr<MemoryAllocator> g_memory_allocator;
+
+MemoryAllocator::MemoryAllocator()
+{
+  // Keeping each allocation aligned to nonCoherentAtomSize means that flushing or invalidating
+  // one never touches another.
+  const VkDeviceSize atom_size = g_vulkan_context->GetDeviceLimits().nonCoherentAtomSize;
+  m_min_allocation_size = 256;
+  while (m_min_allocation_size < atom_size)
+    m_min_allocation_size *= 2;
+
+  const VkPhysicalDeviceMemoryProperties& properties =
+      g_vulkan_context->GetDeviceMemoryProperties();
+  for (u32 i = 0; i < properties.memoryTypeCount; i++)
+  {
+    const VkDeviceSize heap_size = properties.memoryHeaps[properties.memoryTypes[i].heapIndex].size;
+    VkDeviceSize block_size = MAX_BLOCK_SIZE;
+    while (block_size > MIN_BLOCK_SIZE && block_size > heap_size / 8)
+      block_size /= 2;
+
+    for (u32 j = 0; j < 2; j++)
+    {
+      Pool& pool = m_pools[i][j];
+      pool.memory_type_index = i;
+      pool.is_image = j != 0;
+      pool.block_size = block_size;
+    }
+  }
+}
+
+MemoryAllocator::~MemoryAllocator()
+{
+  for (auto& pools : m_pools)
+  {
+    for (Pool& pool : pools)
+    {
+      for (std::unique_ptr<MemoryBlock>& block : pool.blocks)
+      {
+        if (block->used_bytes != 0)
+          WARN_LOG_FMT(VIDEO, "Vulkan memory block destroyed with allocations still in use");
+        DestroyBlock(block.get());
+      }
+    }
+  }
+}
+
+u32 MemoryAllocator::GetNumOrders(const Pool& pool) const
+{
+  return static_cast<u32>(IntLog2(pool.block_size / m_min_allocation_size)) + 1;
+}
+
+std::optional<MemoryAllocation> MemoryAllocator::Allocate(const VkMemoryRequirements& requirements,
+                                                          u32 memory_type_index, bool is_image,
+                                                          bool host_access)
+{
+  std::lock_guard lk(m_mutex);
+
+  // Ranges are aligned to their size, so the size covers the alignment too.
+  VkDeviceSize range_size = m_min_allocation_size;
+  u32 order = 0;
+  while (range_size < requirements.size || range_size < requirements.alignment)
+  {
+    range_size *= 2;
+    order++;
+  }
+
+  Pool& pool = m_pools[memory_type_index][is_image ? 1 : 0];
+  if (range_size > pool.block_size / 2)
+    return AllocateDedicated(requirements.size, memory_type_index, host_access);
+
+  const u32 num_orders = GetNumOrders(pool);
+  const auto try_allocate = [&](MemoryBlock* block) -> std::optional<VkDeviceSize> {
+    u32 free_order = order;
+    while (free_order < num_orders && block->free_ranges[free_order].empty())
+      free_order++;
+    if (free_order == num_orders)
+      return std::nullopt;
+
+    const VkDeviceSize offset = *block->free_ranges[free_order].begin();
+    block->free_ranges[free_order].erase(block->free_ranges[free_order].begin());
+
+    // Split the range until it's as small as needed, freeing the upper halves.
+    while (free_order > order)
+    {
+      free_order--;
+      block->free_ranges[free_order].insert(offset + (m_min_allocation_size << free_order));
+    }
+    return offset;
+  };
+
+  MemoryBlock* block = nullptr;
+  std::optional<VkDeviceSize> offset;
+  for (std::unique_ptr<MemoryBlock>& it : pool.blocks)
+  {
+    offset = try_allocate(it.get());
+    if (offset)
+    {
+      block = it.get();
+      break;
+    }
+  }
+
+  if (!block)
+  {
+    block = CreateBlock(pool);
+    if (!block)
+    {
+      // The heap may still have room for an allocation of the exact size.
+      return AllocateDedicated(requirements.size, memory_type_index, host_access);
+    }
+    offset = try_allocate(block);
+  }
+
+  block->used_bytes += range_size;
+  m_used_bytes += range_size;
+
+  if (host_access && !block->map_pointer && !MapBlock(block))
+  {
+    FreeRange(block, *offset, order);
+    return std::nullopt;
+  }
+
+  MemoryAllocation allocation;
+  allocation.memory = block->memory;
+  allocation.offset = *offset;
+  allocation.size = requirements.size;
+  allocation.map_pointer = host_access ? block->map_pointer + *offset : nullptr;
+  allocation.block = block;
+  allocation.order = order;
+  return allocation;
+}
+
+std::optional<MemoryAllocation> MemoryAllocator::AllocateDedicated(VkDeviceSize size,
+                                                                   u32 memory_type_index,
+                                                                   bool host_access)
+{
+  VkMemoryAllocateInfo memory_info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, nullptr, size,
+                                      memory_type_index};
+  VkDeviceMemory memory;
+  VkResult res = vkAllocateMemory(g_vulkan_context->GetDevice(), &memory_info, nullptr, &memory);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkAllocateMemory failed: ");
+    return std::nullopt;
+  }
+
+  MemoryAllocation allocation;
+  allocation.memory = memory;
+  allocation.size = size;
+  if (host_access)
+  {
+    void* map_pointer;
+    res = vkMapMemory(g_vulkan_context->GetDevice(), memory, 0, VK_WHOLE_SIZE, 0, &map_pointer);
+    if (res != VK_SUCCESS)
+    {
+      LOG_VULKAN_ERROR(res, "vkMapMemory failed: ");
+      vkFreeMemory(g_vulkan_context->GetDevice(), memory, nullptr);
+      return std::nullopt;
+    }
+    allocation.map_pointer = static_cast<char*>(map_pointer);
+  }
+
+  m_num_dedicated_allocations++;
+  m_allocated_bytes += size;
+  m_used_bytes += size;
+  return allocation;
+}
+
+MemoryBlock* MemoryAllocator::CreateBlock(Pool& pool)
+{
+  VkMemoryAllocateInfo memory_info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, nullptr,
+                                      pool.block_size, pool.memory_type_index};
+  VkDeviceMemory memory;
+  VkResult res = vkAllocateMemory(g_vulkan_context->GetDevice(), &memory_info, nullptr, &memory);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkAllocateMemory failed: ");
+    return nullptr;
+  }
+
+  auto block = std::make_unique<MemoryBlock>();
+  block->memory = memory;
+  block->size = pool.block_size;
+  block->free_ranges.resize(GetNumOrders(pool));
+  block->free_ranges.back().insert(0);
+  block->empty_since_frame = m_frame_counter;
+
+  m_num_blocks++;
+  m_allocated_bytes += block->size;
+  return pool.blocks.emplace_back(std::move(block)).get();
+}
+
+void MemoryAllocator::DestroyBlock(MemoryBlock* block)
+{
+  // Freeing the memory implicitly unmaps it.
+  vkFreeMemory(g_vulkan_context->GetDevice(), block->memory, nullptr);
+  m_num_blocks--;
+  m_allocated_bytes -= block->size;
+}
+
+bool MemoryAllocator::MapBlock(MemoryBlock* block)
+{
+  // Blocks stay mapped for as long as they exist, since a VkDeviceMemory can only be mapped once
+  // at a time while its allocations are mapped independently.
+  void* map_pointer;
+  VkResult res =
+      vkMapMemory(g_vulkan_context->GetDevice(), block->memory, 0, VK_WHOLE_SIZE, 0, &map_pointer);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkMapMemory failed: ");
+    return false;
+  }
+
+  block->map_pointer = static_cast<char*>(map_pointer);
+  return true;
+}
+
+void MemoryAllocator::Free(const MemoryAllocation& allocation)
+{
+  std::lock_guard lk(m_mutex);
+
+  MemoryBlock* block = allocation.block;
+  if (!block)
+  {
+    if (allocation.memory == VK_NULL_HANDLE)
+      return;
+
+    vkFreeMemory(g_vulkan_context->GetDevice(), allocation.memory, nullptr);
+    m_num_dedicated_allocations--;
+    m_allocated_bytes -= allocation.size;
+    m_used_bytes -= allocation.size;
+    return;
+  }
+
+  FreeRange(block, allocation.offset, allocation.order);
+}
+
+void MemoryAllocator::FreeRange(MemoryBlock* block, VkDeviceSize offset, u32 order)
+{
+  const VkDeviceSize range_size = m_min_allocation_size << order;
+  block->used_bytes -= range_size;
+  m_used_bytes -= range_size;
+
+  // Merge the range with its buddy for as long as the buddy is free too.
+  while (order + 1 < block->free_ranges.size())
+  {
+    const VkDeviceSize buddy = offset ^ (m_min_allocation_size << order);
+    if (block->free_ranges[order].erase(buddy) == 0)
+      break;
+
+    offset = std::min(offset, buddy);
+    order++;
+  }
+  block->free_ranges[order].insert(offset);
+
+  if (block->used_bytes == 0)
+    block->empty_since_frame = m_frame_counter;
+}
+
+VkMappedMemoryRange MemoryAllocator::GetMappedMemoryRange(const MemoryAllocation& allocation,
+                                                          VkDeviceSize offset, VkDeviceSize size)
+{
+  const VkDeviceSize atom_size = g_vulkan_context->GetDeviceLimits().nonCoherentAtomSize;
+  const VkDeviceSize end =
+      allocation.offset + (size == VK_WHOLE_SIZE ? allocation.size : offset + size);
+  const VkDeviceSize aligned_offset = Common::AlignDown(allocation.offset + offset, atom_size);
+  const VkDeviceSize aligned_end = Common::AlignUp(end, atom_size);
+
+  // Ranges in blocks are aligned to the atom size, but a dedicated allocation can end in the
+  // middle of an atom, which the range then has to run to the end of the memory to cover.
+  VkDeviceSize range_size = aligned_end - aligned_offset;
+  if (!allocation.block && aligned_end > allocation.offset + allocation.size)
+    range_size = VK_WHOLE_SIZE;
+
+  return {VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE, nullptr, allocation.memory, aligned_offset,
+          range_size};
+}
+
+void MemoryAllocator::ReleaseUnusedBlocks()
+{
+  std::lock_guard lk(m_mutex);
+  m_frame_counter++;
+
+  for (auto& pools : m_pools)
+  {
+    for (Pool& pool : pools)
+    {
+      bool kept_empty_block = false;
+      for (auto it = pool.blocks.begin(); it != pool.blocks.end();)
+      {
+        MemoryBlock* block = it->get();
+        if (block->used_bytes != 0 ||
+            m_frame_counter - block->empty_since_frame < EMPTY_BLOCK_RELEASE_FRAMES ||
+            !kept_empty_block)
+        {
+          kept_empty_block |= block->used_bytes == 0;
+          ++it;
+          continue;
+        }
+
+        DestroyBlock(block);
+        it = pool.blocks.erase(it);
+      }
+    }
+  }
+
+  SETSTAT(g_stats.num_device_memory_blocks, m_num_blocks + m_num_dedicated_allocations);
+  SETSTAT(g_stats.device_memory_allocated_mib, m_allocated_bytes / (1024 * 1024));
+  SETSTAT(g_stats.device_memory_used_mib, m_used_bytes / (1024 * 1024));
+}
+}  // namespace Vulkan
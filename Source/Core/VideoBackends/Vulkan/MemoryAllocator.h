@@ -0,0 +1,92 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Vulkan/Constants.h"
+
+namespace Vulkan
+{
+struct MemoryBlock;
+
+// A range of a VkDeviceMemory handed out by the MemoryAllocator.
+struct MemoryAllocation
+{
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  VkDeviceSize offset = 0;
+  VkDeviceSize size = 0;
+
+  // Points at offset when the allocation was made with host access, otherwise null.
+  char* map_pointer = nullptr;
+
+  // The block the range was taken from, or null if the memory was allocated just for this.
+  MemoryBlock* block = nullptr;
+  u32 order = 0;
+};
+
+// Textures and staging buffers are placed in large blocks of device memory rather than each
+// getting a VkDeviceMemory of their own, since drivers limit the number of allocations and
+// vkAllocateMemory can be slow. Each block is split with a buddy allocator. Blocks are kept per
+// memory type, and separately for buffers and images so that bufferImageGranularity never needs
+// to be considered. Resources too large for a block get a dedicated allocation.
+class MemoryAllocator
+{
+public:
+  MemoryAllocator();
+  ~MemoryAllocator();
+
+  // host_access maps the memory, which must then be host visible.
+  std::optional<MemoryAllocation> Allocate(const VkMemoryRequirements& requirements,
+                                           u32 memory_type_index, bool is_image, bool host_access);
+
+  // The memory must no longer be in use by the GPU, see
+  // CommandBufferManager::DeferMemoryAllocationDestruction.
+  void Free(const MemoryAllocation& allocation);
+
+  // Returns a range for vkFlushMappedMemoryRanges or vkInvalidateMappedMemoryRanges covering
+  // [offset, offset + size) of the allocation, aligned to nonCoherentAtomSize.
+  static VkMappedMemoryRange GetMappedMemoryRange(const MemoryAllocation& allocation,
+                                                  VkDeviceSize offset, VkDeviceSize size);
+
+  // Called once per frame. Releases blocks which have been empty for a while, and updates the
+  // allocation statistics.
+  void ReleaseUnusedBlocks();
+
+private:
+  struct Pool
+  {
+    u32 memory_type_index = 0;
+    bool is_image = false;
+    VkDeviceSize block_size = 0;
+    std::vector<std::unique_ptr<MemoryBlock>> blocks;
+  };
+
+  std::optional<MemoryAllocation> AllocateDedicated(VkDeviceSize size, u32 memory_type_index,
+                                                    bool host_access);
+  void FreeRange(MemoryBlock* block, VkDeviceSize offset, u32 order);
+  MemoryBlock* CreateBlock(Pool& pool);
+  void DestroyBlock(MemoryBlock* block);
+  bool MapBlock(MemoryBlock* block);
+  u32 GetNumOrders(const Pool& pool) const;
+
+  std::mutex m_mutex;
+  std::array<std::array<Pool, 2>, VK_MAX_MEMORY_TYPES> m_pools;
+  VkDeviceSize m_min_allocation_size = 0;
+  u64 m_frame_counter = 0;
+
+  u32 m_num_blocks = 0;
+  u32 m_num_dedicated_allocations = 0;
+  VkDeviceSize m_allocated_bytes = 0;
+  VkDeviceSize m_used_bytes = 0;
+};
+
+extern std::unique_ptr<MemoryAllocator> g_memory_allocator;
+}  // namespace Vulkan
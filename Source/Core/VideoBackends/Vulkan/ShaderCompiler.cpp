@@ -9,7 +9,9 @@
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 
 // glslang includes
@@ -18,13 +20,17 @@
 #include "ShaderLang.h"
 #include "disassemble.h"
 
+#include "Common/Crypto/SHA1.h"
 #include "Common/FileUtil.h"
+#include "Common/LinearDiskCache.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 #include "Common/Version.h"
 
+#include "VideoCommon/ShaderGenCommon.h"
 #include "VideoCommon/VideoBackendBase.h"
+#include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
 
 namespace Vulkan::ShaderCompiler
@@ -108,6 +114,58 @@ static const char SUBGROUP_HELPER_HEADER[] = R"(
   #define SUBGROUP_MAX(value) value = subgroupMax(value)
 )";
 
+// Compiled shaders, keyed by the digest of the stage, the SPIR-V version and the full source.
+// Shaders are compiled on several threads at once, so all of this is guarded by the mutex.
+using SPIRVCacheKey = Common::SHA1::Digest;
+static std::mutex s_spirv_cache_mutex;
+static std::map<SPIRVCacheKey, SPIRVCodeVector> s_spirv_cache;
+static LinearDiskCache<SPIRVCacheKey, SPIRVCodeType> s_spirv_disk_cache;
+static bool s_spirv_cache_open = false;
+
+class SPIRVCacheReader : public LinearDiskCacheReader<SPIRVCacheKey, SPIRVCodeType>
+{
+public:
+  void Read(const SPIRVCacheKey& key, const SPIRVCodeType* value, u32 value_size) override
+  {
+    s_spirv_cache.emplace(key, SPIRVCodeVector(value, value + value_size));
+  }
+};
+
+static SPIRVCacheKey GetSPIRVCacheKey(EShLanguage stage, glslang::EShTargetLanguageVersion target,
+                                      const char* source, int source_length)
+{
+  const std::unique_ptr<Common::SHA1::Context> context = Common::SHA1::CreateContext();
+  const u32 params[] = {static_cast<u32>(stage), static_cast<u32>(target)};
+  context->Update(reinterpret_cast<const u8*>(params), sizeof(params));
+  context->Update(reinterpret_cast<const u8*>(source), static_cast<size_t>(source_length));
+  return context->Finish();
+}
+
+void LoadSPIRVCache()
+{
+  std::lock_guard lk(s_spirv_cache_mutex);
+  if (s_spirv_cache_open)
+    return;
+
+  const std::string filename = GetDiskShaderCacheFileName(APIType::Vulkan, "SPIRV", false, false);
+  SPIRVCacheReader reader;
+  const u32 count = s_spirv_disk_cache.OpenAndRead(filename, reader);
+  INFO_LOG_FMT(VIDEO, "Loaded {} shaders from SPIR-V cache {}", count, filename);
+  s_spirv_cache_open = true;
+}
+
+void CloseSPIRVCache()
+{
+  std::lock_guard lk(s_spirv_cache_mutex);
+  if (!s_spirv_cache_open)
+    return;
+
+  s_spirv_disk_cache.Sync();
+  s_spirv_disk_cache.Close();
+  s_spirv_cache.clear();
+  s_spirv_cache_open = false;
+}
+
 static std::optional<SPIRVCodeVector> CompileShaderToSPV(EShLanguage stage,
                                                          const char* stage_filename,
                                                          std::string_view source,
@@ -140,8 +198,24 @@ static std::optional<SPIRVCodeVector> CompileShaderToSPV(EShLanguage stage,
   }
 
   // Sub-group operations require Vulkan 1.1 and SPIR-V 1.3.
-  if (g_vulkan_context->SupportsShaderSubgroupOperations())
-    shader->setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_3);
+  const glslang::EShTargetLanguageVersion target_version =
+      g_vulkan_context->SupportsShaderSubgroupOperations() ? glslang::EShTargetSpv_1_3 :
+                                                             glslang::EShTargetSpv_1_0;
+  if (target_version != glslang::EShTargetSpv_1_0)
+    shader->setEnvTarget(glslang::EShTargetSpv, target_version);
+
+  // Shaders which are dumped have to be compiled for the info logs and the disassembly.
+  const bool use_spirv_cache = !(g_ActiveConfig.iLog & CONF_SAVESHADERS);
+  std::optional<SPIRVCacheKey> cache_key;
+  if (use_spirv_cache)
+  {
+    cache_key = GetSPIRVCacheKey(stage, target_version, pass_source_code, pass_source_code_length);
+
+    std::lock_guard lk(s_spirv_cache_mutex);
+    const auto iter = s_spirv_cache.find(*cache_key);
+    if (iter != s_spirv_cache.end())
+      return iter->second;
+  }
 
   shader->setStringsWithLengths(&pass_source_code, &pass_source_code_length, 1);
 
@@ -239,6 +313,16 @@ static std::optional<SPIRVCodeVector> CompileShaderToSPV(EShLanguage stage,
     }
   }
 
+  if (cache_key)
+  {
+    std::lock_guard lk(s_spirv_cache_mutex);
+    // The cache may have been closed, or another thread may have compiled the same shader.
+    if (s_spirv_cache_open && s_spirv_cache.emplace(*cache_key, out_code).second)
+    {
+      s_spirv_disk_cache.Append(*cache_key, out_code.data(), static_cast<u32>(out_code.size()));
+    }
+  }
+
   return out_code;
 }
 
@@ -28,4 +28,10 @@ std::optional<SPIRVCodeVector> CompileFragmentShader(std::string_view source_cod
 
 // Compile a compute shader to SPIR-V.
 std::optional<SPIRVCodeVector> CompileComputeShader(std::string_view source_code);
+
+// Loads the on-disk cache of compiled SPIR-V, which is keyed by a hash of the GLSL source and so
+// is shared between all games. Compiled shaders are looked up in and added to it until it's
+// closed. The cache is invalidated whenever the Dolphin version (and so glslang) changes.
+void LoadSPIRVCache();
+void CloseSPIRVCache();
 }  // namespace Vulkan::ShaderCompiler
@@ -13,9 +13,9 @@
 
 namespace Vulkan
 {
-StagingBuffer::StagingBuffer(STAGING_BUFFER_TYPE type, VkBuffer buffer, VkDeviceMemory memory,
-                             VkDeviceSize size, bool coherent)
-    : m_type(type), m_buffer(buffer), m_memory(memory), m_size(size), m_coherent(coherent)
+StagingBuffer::StagingBuffer(STAGING_BUFFER_TYPE type, VkBuffer buffer,
+                             const MemoryAllocation& allocation, VkDeviceSize size, bool coherent)
+    : m_type(type), m_buffer(buffer), m_allocation(allocation), m_size(size), m_coherent(coherent)
 {
 }
 
@@ -25,8 +25,8 @@ StagingBuffer::~StagingBuffer()
   if (m_map_pointer)
     Unmap();
 
-  g_command_buffer_mgr->DeferDeviceMemoryDestruction(m_memory);
   g_command_buffer_mgr->DeferBufferDestruction(m_buffer);
+  g_command_buffer_mgr->DeferMemoryAllocationDestruction(m_allocation);
 }
 
 void StagingBuffer::BufferMemoryBarrier(VkCommandBuffer command_buffer, VkBuffer buffer,
@@ -62,16 +62,8 @@ bool StagingBuffer::Map(VkDeviceSize offset, VkDeviceSize size)
   ASSERT(!m_map_pointer);
   ASSERT(m_map_offset + m_map_size <= m_size);
 
-  void* map_pointer;
-  VkResult res = vkMapMemory(g_vulkan_context->GetDevice(), m_memory, m_map_offset, m_map_size, 0,
-                             &map_pointer);
-  if (res != VK_SUCCESS)
-  {
-    LOG_VULKAN_ERROR(res, "vkMapMemory failed: ");
-    return false;
-  }
-
-  m_map_pointer = reinterpret_cast<char*>(map_pointer);
+  // The allocator keeps the memory mapped, so this only hands out a pointer into it.
+  m_map_pointer = m_allocation.map_pointer + m_map_offset;
   return true;
 }
 
@@ -79,7 +71,6 @@ void StagingBuffer::Unmap()
 {
   ASSERT(m_map_pointer);
 
-  vkUnmapMemory(g_vulkan_context->GetDevice(), m_memory);
   m_map_pointer = nullptr;
   m_map_offset = 0;
   m_map_size = 0;
@@ -91,8 +82,8 @@ void StagingBuffer::FlushCPUCache(VkDeviceSize offset, VkDeviceSize size)
   if (m_coherent)
     return;
 
-  VkMappedMemoryRange range = {VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE, nullptr, m_memory,
-                               offset - m_map_offset, size};
+  const VkMappedMemoryRange range =
+      MemoryAllocator::GetMappedMemoryRange(m_allocation, offset, size);
   vkFlushMappedMemoryRanges(g_vulkan_context->GetDevice(), 1, &range);
 }
 
@@ -140,8 +131,8 @@ void StagingBuffer::InvalidateCPUCache(VkDeviceSize offset, VkDeviceSize size)
   if (m_coherent)
     return;
 
-  VkMappedMemoryRange range = {VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE, nullptr, m_memory,
-                               offset - m_map_offset, size};
+  const VkMappedMemoryRange range =
+      MemoryAllocator::GetMappedMemoryRange(m_allocation, offset, size);
   vkInvalidateMappedMemoryRanges(g_vulkan_context->GetDevice(), 1, &range);
 }
 
@@ -168,7 +159,7 @@ void StagingBuffer::Write(VkDeviceSize offset, const void* data, size_t size,
 
 bool StagingBuffer::AllocateBuffer(STAGING_BUFFER_TYPE type, VkDeviceSize size,
                                    VkBufferUsageFlags usage, VkBuffer* out_buffer,
-                                   VkDeviceMemory* out_memory, bool* out_coherent)
+                                   MemoryAllocation* out_allocation, bool* out_coherent)
 {
   VkBufferCreateInfo buffer_create_info = {
       VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,  // VkStructureType        sType
@@ -197,29 +188,25 @@ bool StagingBuffer::AllocateBuffer(STAGING_BUFFER_TYPE type, VkDeviceSize size,
   else
     type_index = g_vulkan_context->GetReadbackMemoryType(requirements.memoryTypeBits, out_coherent);
 
-  VkMemoryAllocateInfo memory_allocate_info = {
-      VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,  // VkStructureType    sType
-      nullptr,                                 // const void*        pNext
-      requirements.size,                       // VkDeviceSize       allocationSize
-      type_index                               // uint32_t           memoryTypeIndex
-  };
-  res = vkAllocateMemory(g_vulkan_context->GetDevice(), &memory_allocate_info, nullptr, out_memory);
-  if (res != VK_SUCCESS)
+  std::optional<MemoryAllocation> allocation =
+      g_memory_allocator->Allocate(requirements, type_index, false, true);
+  if (!allocation)
   {
-    LOG_VULKAN_ERROR(res, "vkAllocateMemory failed: ");
     vkDestroyBuffer(g_vulkan_context->GetDevice(), *out_buffer, nullptr);
     return false;
   }
 
-  res = vkBindBufferMemory(g_vulkan_context->GetDevice(), *out_buffer, *out_memory, 0);
+  res = vkBindBufferMemory(g_vulkan_context->GetDevice(), *out_buffer, allocation->memory,
+                           allocation->offset);
   if (res != VK_SUCCESS)
   {
     LOG_VULKAN_ERROR(res, "vkBindBufferMemory failed: ");
     vkDestroyBuffer(g_vulkan_context->GetDevice(), *out_buffer, nullptr);
-    vkFreeMemory(g_vulkan_context->GetDevice(), *out_memory, nullptr);
+    g_memory_allocator->Free(*allocation);
     return false;
   }
 
+  *out_allocation = *allocation;
   return true;
 }
 
@@ -227,12 +214,12 @@ std::unique_ptr<StagingBuffer> StagingBuffer::Create(STAGING_BUFFER_TYPE type, V
                                                      VkBufferUsageFlags usage)
 {
   VkBuffer buffer;
-  VkDeviceMemory memory;
+  MemoryAllocation allocation;
   bool coherent;
-  if (!AllocateBuffer(type, size, usage, &buffer, &memory, &coherent))
+  if (!AllocateBuffer(type, size, usage, &buffer, &allocation, &coherent))
     return nullptr;
 
-  return std::make_unique<StagingBuffer>(type, buffer, memory, size, coherent);
+  return std::make_unique<StagingBuffer>(type, buffer, allocation, size, coherent);
 }
 
 }  // namespace Vulkan
@@ -8,14 +8,15 @@
 #include <memory>
 
 #include "VideoBackends/Vulkan/Constants.h"
+#include "VideoBackends/Vulkan/MemoryAllocator.h"
 
 namespace Vulkan
 {
 class StagingBuffer
 {
 public:
-  StagingBuffer(STAGING_BUFFER_TYPE type, VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize size,
-                bool coherent);
+  StagingBuffer(STAGING_BUFFER_TYPE type, VkBuffer buffer, const MemoryAllocation& allocation,
+                VkDeviceSize size, bool coherent);
   virtual ~StagingBuffer();
 
   STAGING_BUFFER_TYPE GetType() const { return m_type; }
@@ -60,8 +61,10 @@ public:
                                                VkBufferUsageFlags usage);
 
   // Allocates the resources needed to create a staging buffer.
+  // The memory is suballocated, and stays mapped for as long as the buffer exists.
   static bool AllocateBuffer(STAGING_BUFFER_TYPE type, VkDeviceSize size, VkBufferUsageFlags usage,
-                             VkBuffer* out_buffer, VkDeviceMemory* out_memory, bool* out_coherent);
+                             VkBuffer* out_buffer, MemoryAllocation* out_allocation,
+                             bool* out_coherent);
 
   // Wrapper for creating an barrier on a buffer
   static void BufferMemoryBarrier(VkCommandBuffer command_buffer, VkBuffer buffer,
@@ -73,7 +76,7 @@ public:
 protected:
   STAGING_BUFFER_TYPE m_type;
   VkBuffer m_buffer;
-  VkDeviceMemory m_memory;
+  MemoryAllocation m_allocation;
   VkDeviceSize m_size;
   bool m_coherent;
 
@@ -4,9 +4,13 @@
 
 #include "VideoBackends/Vulkan/StateTracker.h"
 
+#include <algorithm>
+
 #include "Common/Assert.h"
+#include "Common/Hash.h"
 
 #include "VideoBackends/Vulkan/CommandBufferManager.h"
+#include "VideoBackends/Vulkan/CommandRecorder.h"
 #include "VideoBackends/Vulkan/ObjectCache.h"
 #include "VideoBackends/Vulkan/VKPipeline.h"
 #include "VideoBackends/Vulkan/VKRenderer.h"
@@ -73,6 +77,12 @@ bool StateTracker::Initialize()
     m_bindings.samplers[i].sampler = g_object_cache->GetPointSampler();
   }
 
+  if (g_ActiveConfig.iCommandRecordingThreads > 0)
+  {
+    const u32 num_threads = static_cast<u32>(g_ActiveConfig.iCommandRecordingThreads);
+    m_command_recorder = std::make_unique<CommandRecorder>(num_threads);
+  }
+
   // Default dirty flags include all descriptors
   InvalidateCachedState();
   return true;
@@ -236,11 +246,36 @@ void StateTracker::UnbindTexture(VkImageView view)
   }
 }
 
+size_t StateTracker::SamplerBindingsHash::operator()(const SamplerBindings& bindings) const
+{
+  // The members are hashed separately, as VkDescriptorImageInfo has padding.
+  std::array<u64, NUM_PIXEL_SHADER_SAMPLERS * 3> values;
+  for (size_t i = 0; i < bindings.size(); i++)
+  {
+    values[i * 3] = reinterpret_cast<u64>(bindings[i].sampler);
+    values[i * 3 + 1] = reinterpret_cast<u64>(bindings[i].imageView);
+    values[i * 3 + 2] = bindings[i].imageLayout;
+  }
+
+  return static_cast<size_t>(Common::GetHash64(reinterpret_cast<const u8*>(values.data()),
+                                               sizeof(values), 0));
+}
+
+bool StateTracker::SamplerBindingsEqual::operator()(const SamplerBindings& lhs,
+                                                    const SamplerBindings& rhs) const
+{
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](const auto& a, const auto& b) {
+    return a.sampler == b.sampler && a.imageView == b.imageView && a.imageLayout == b.imageLayout;
+  });
+}
+
 void StateTracker::InvalidateCachedState()
 {
   m_gx_descriptor_sets.fill(VK_NULL_HANDLE);
+  m_gx_sampler_descriptor_sets.clear();
   m_utility_descriptor_sets.fill(VK_NULL_HANDLE);
   m_compute_descriptor_set = VK_NULL_HANDLE;
+  m_compute_command_buffer = VK_NULL_HANDLE;
   m_dirty_flags |= DIRTY_FLAG_ALL_DESCRIPTORS | DIRTY_FLAG_VIEWPORT | DIRTY_FLAG_SCISSOR |
                    DIRTY_FLAG_PIPELINE | DIRTY_FLAG_COMPUTE_SHADER | DIRTY_FLAG_DESCRIPTOR_SETS |
                    DIRTY_FLAG_COMPUTE_DESCRIPTOR_SET;
@@ -266,8 +301,7 @@ void StateTracker::BeginRenderPass()
                                       0,
                                       nullptr};
 
-  vkCmdBeginRenderPass(g_command_buffer_mgr->GetCurrentCommandBuffer(), &begin_info,
-                       VK_SUBPASS_CONTENTS_INLINE);
+  BeginRenderPass(begin_info);
 }
 
 void StateTracker::BeginDiscardRenderPass()
@@ -286,8 +320,7 @@ void StateTracker::BeginDiscardRenderPass()
                                       0,
                                       nullptr};
 
-  vkCmdBeginRenderPass(g_command_buffer_mgr->GetCurrentCommandBuffer(), &begin_info,
-                       VK_SUBPASS_CONTENTS_INLINE);
+  BeginRenderPass(begin_info);
 }
 
 void StateTracker::EndRenderPass()
@@ -295,6 +328,12 @@ void StateTracker::EndRenderPass()
   if (!InRenderPass())
     return;
 
+  if (m_command_recorder && m_command_recorder->IsDeferringRenderPass())
+  {
+    m_command_recorder->Flush(g_command_buffer_mgr->GetCurrentCommandBuffer());
+    InvalidateBoundState();
+  }
+
   vkCmdEndRenderPass(g_command_buffer_mgr->GetCurrentCommandBuffer());
   m_current_render_pass = VK_NULL_HANDLE;
 }
@@ -315,10 +354,30 @@ void StateTracker::BeginClearRenderPass(const VkRect2D& area, const VkClearValue
                                       num_clear_values,
                                       clear_values};
 
+  BeginRenderPass(begin_info);
+}
+
+void StateTracker::BeginRenderPass(const VkRenderPassBeginInfo& begin_info)
+{
+  if (m_command_recorder)
+  {
+    m_command_recorder->BeginRenderPass(begin_info);
+    return;
+  }
+
   vkCmdBeginRenderPass(g_command_buffer_mgr->GetCurrentCommandBuffer(), &begin_info,
                        VK_SUBPASS_CONTENTS_INLINE);
 }
 
+void StateTracker::FlushDeferredDraws()
+{
+  if (!m_command_recorder || !m_command_recorder->IsDeferringRenderPass())
+    return;
+
+  m_command_recorder->FlushInline(g_command_buffer_mgr->GetCurrentCommandBuffer());
+  InvalidateBoundState();
+}
+
 void StateTracker::SetViewport(const VkViewport& viewport)
 {
   if (memcmp(&m_viewport, &viewport, sizeof(viewport)) == 0)
@@ -365,6 +424,14 @@ bool StateTracker::Bind()
   if (!InRenderPass())
     BeginRenderPass();
 
+  // Deferred draws take the state with them.
+  if (IsDeferringDraws())
+  {
+    m_dirty_flags &= ~(DIRTY_FLAG_VERTEX_BUFFER | DIRTY_FLAG_INDEX_BUFFER | DIRTY_FLAG_PIPELINE |
+                       DIRTY_FLAG_VIEWPORT | DIRTY_FLAG_SCISSOR);
+    return true;
+  }
+
   // Re-bind parts of the pipeline
   const VkCommandBuffer command_buffer = g_command_buffer_mgr->GetCurrentCommandBuffer();
   if (m_dirty_flags & DIRTY_FLAG_VERTEX_BUFFER)
@@ -387,6 +454,86 @@ bool StateTracker::Bind()
   return true;
 }
 
+void StateTracker::Draw(u32 num_vertices, u32 base_vertex)
+{
+  if (IsDeferringDraws())
+  {
+    AddDeferredDraw(false, num_vertices, 0, base_vertex);
+    return;
+  }
+
+  vkCmdDraw(g_command_buffer_mgr->GetCurrentCommandBuffer(), num_vertices, 1, base_vertex, 0);
+}
+
+void StateTracker::DrawIndexed(u32 num_indices, u32 base_index, u32 base_vertex)
+{
+  if (IsDeferringDraws())
+  {
+    AddDeferredDraw(true, num_indices, base_index, base_vertex);
+    return;
+  }
+
+  vkCmdDrawIndexed(g_command_buffer_mgr->GetCurrentCommandBuffer(), num_indices, 1, base_index,
+                   base_vertex, 0);
+}
+
+bool StateTracker::IsDeferringDraws() const
+{
+  // Render passes are deferred from the start, so the state bound before one begins isn't needed.
+  return m_command_recorder && (!InRenderPass() || m_command_recorder->IsDeferringRenderPass());
+}
+
+void StateTracker::AddDeferredDraw(bool indexed, u32 num_vertices, u32 base_index,
+                                   u32 base_vertex)
+{
+  CommandRecorder::DrawCommand draw;
+  draw.pipeline = m_pipeline->GetVkPipeline();
+  draw.pipeline_layout = m_pipeline->GetVkPipelineLayout();
+  if (m_pipeline->GetUsage() == AbstractPipelineUsage::GX)
+  {
+    draw.num_descriptor_sets = g_ActiveConfig.backend_info.bSupportsBBox ?
+                                   NUM_GX_DESCRIPTOR_SETS :
+                                   (NUM_GX_DESCRIPTOR_SETS - 1);
+    draw.num_dynamic_offsets = g_ActiveConfig.backend_info.bSupportsGeometryShaders ?
+                                   NUM_UBO_DESCRIPTOR_SET_BINDINGS :
+                                   (NUM_UBO_DESCRIPTOR_SET_BINDINGS - 1);
+    std::copy_n(m_gx_descriptor_sets.begin(), draw.num_descriptor_sets,
+                draw.descriptor_sets.begin());
+    std::copy_n(m_bindings.gx_ubo_offsets.begin(), draw.num_dynamic_offsets,
+                draw.dynamic_offsets.begin());
+  }
+  else
+  {
+    draw.num_descriptor_sets = NUM_UTILITY_DESCRIPTOR_SETS;
+    draw.num_dynamic_offsets = 1;
+    std::copy_n(m_utility_descriptor_sets.begin(), draw.num_descriptor_sets,
+                draw.descriptor_sets.begin());
+    draw.dynamic_offsets[0] = m_bindings.utility_ubo_offset;
+  }
+  draw.vertex_buffer = m_vertex_buffer;
+  draw.vertex_buffer_offset = m_vertex_buffer_offset;
+  draw.index_buffer = m_index_buffer;
+  draw.index_buffer_offset = m_index_buffer_offset;
+  draw.index_type = m_index_type;
+  draw.viewport = m_viewport;
+  draw.scissor = m_scissor;
+  draw.num_vertices = num_vertices;
+  draw.base_vertex = base_vertex;
+  draw.base_index = base_index;
+  draw.indexed = indexed;
+  m_command_recorder->AddDraw(draw);
+}
+
+void StateTracker::InvalidateBoundState()
+{
+  m_dirty_flags |= DIRTY_FLAG_VIEWPORT | DIRTY_FLAG_SCISSOR | DIRTY_FLAG_PIPELINE |
+                   DIRTY_FLAG_DESCRIPTOR_SETS;
+  if (m_vertex_buffer != VK_NULL_HANDLE)
+    m_dirty_flags |= DIRTY_FLAG_VERTEX_BUFFER;
+  if (m_index_buffer != VK_NULL_HANDLE)
+    m_dirty_flags |= DIRTY_FLAG_INDEX_BUFFER;
+}
+
 bool StateTracker::BindCompute()
 {
   if (!m_compute_shader)
@@ -396,29 +543,59 @@ bool StateTracker::BindCompute()
   if (InRenderPass())
     EndRenderPass();
 
-  const VkCommandBuffer command_buffer = g_command_buffer_mgr->GetCurrentCommandBuffer();
-  if (m_dirty_flags & DIRTY_FLAG_COMPUTE_SHADER)
+  if (!BindCompute(g_command_buffer_mgr->GetCurrentCommandBuffer()))
   {
-    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-                      m_compute_shader->GetComputePipeline());
+    WARN_LOG_FMT(VIDEO, "Failed to get a compute descriptor set, executing buffer");
+    Renderer::GetInstance()->ExecuteCommandBuffer(false, false);
+    if (!BindCompute(g_command_buffer_mgr->GetCurrentCommandBuffer()))
+    {
+      // Something strange going on.
+      ERROR_LOG_FMT(VIDEO, "Failed to get descriptor set, skipping dispatch");
+      return false;
+    }
   }
 
-  if (!UpdateComputeDescriptorSet())
+  return true;
+}
+
+bool StateTracker::BindAsyncCompute()
+{
+  if (!m_compute_shader)
+    return false;
+
+  // The draw command buffer isn't touched, so the render pass can continue.
+  if (!BindCompute(g_command_buffer_mgr->GetCurrentComputeCommandBuffer()))
   {
     WARN_LOG_FMT(VIDEO, "Failed to get a compute descriptor set, executing buffer");
     Renderer::GetInstance()->ExecuteCommandBuffer(false, false);
-    if (!UpdateComputeDescriptorSet())
+    if (!BindCompute(g_command_buffer_mgr->GetCurrentComputeCommandBuffer()))
     {
-      // Something strange going on.
       ERROR_LOG_FMT(VIDEO, "Failed to get descriptor set, skipping dispatch");
       return false;
     }
   }
 
-  m_dirty_flags &= ~DIRTY_FLAG_COMPUTE_SHADER;
   return true;
 }
 
+bool StateTracker::BindCompute(VkCommandBuffer command_buffer)
+{
+  if (m_compute_command_buffer != command_buffer)
+  {
+    m_dirty_flags |= DIRTY_FLAG_COMPUTE_SHADER | DIRTY_FLAG_COMPUTE_DESCRIPTOR_SET;
+    m_compute_command_buffer = command_buffer;
+  }
+
+  if (m_dirty_flags & DIRTY_FLAG_COMPUTE_SHADER)
+  {
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                      m_compute_shader->GetComputePipeline());
+    m_dirty_flags &= ~DIRTY_FLAG_COMPUTE_SHADER;
+  }
+
+  return UpdateComputeDescriptorSet(command_buffer);
+}
+
 bool StateTracker::IsWithinRenderArea(s32 x, s32 y, u32 width, u32 height) const
 {
   // Check that the viewport does not lie outside the render area.
@@ -499,22 +676,37 @@ bool StateTracker::UpdateGXDescriptorSet()
 
   if (m_dirty_flags & DIRTY_FLAG_GX_SAMPLERS || m_gx_descriptor_sets[1] == VK_NULL_HANDLE)
   {
-    m_gx_descriptor_sets[1] = g_command_buffer_mgr->AllocateDescriptorSet(
-        g_object_cache->GetDescriptorSetLayout(DESCRIPTOR_SET_LAYOUT_STANDARD_SAMPLERS));
-    if (m_gx_descriptor_sets[1] == VK_NULL_HANDLE)
-      return false;
+    const VkDescriptorSet cached_set = GetGXSamplerDescriptorSet();
+    if (cached_set != VK_NULL_HANDLE)
+    {
+      // Switching back to a set written before, don't re-bind it if it's still bound.
+      if (cached_set != m_gx_descriptor_sets[1])
+      {
+        m_gx_descriptor_sets[1] = cached_set;
+        m_dirty_flags |= DIRTY_FLAG_DESCRIPTOR_SETS;
+      }
+      m_dirty_flags &= ~DIRTY_FLAG_GX_SAMPLERS;
+    }
+    else
+    {
+      m_gx_descriptor_sets[1] = g_command_buffer_mgr->AllocateDescriptorSet(
+          g_object_cache->GetDescriptorSetLayout(DESCRIPTOR_SET_LAYOUT_STANDARD_SAMPLERS));
+      if (m_gx_descriptor_sets[1] == VK_NULL_HANDLE)
+        return false;
 
-    writes[num_writes++] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                            nullptr,
-                            m_gx_descriptor_sets[1],
-                            0,
-                            0,
-                            static_cast<u32>(NUM_PIXEL_SHADER_SAMPLERS),
-                            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                            m_bindings.samplers.data(),
-                            nullptr,
-                            nullptr};
-    m_dirty_flags = (m_dirty_flags & ~DIRTY_FLAG_GX_SAMPLERS) | DIRTY_FLAG_DESCRIPTOR_SETS;
+      writes[num_writes++] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                              nullptr,
+                              m_gx_descriptor_sets[1],
+                              0,
+                              0,
+                              static_cast<u32>(NUM_PIXEL_SHADER_SAMPLERS),
+                              VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                              m_bindings.samplers.data(),
+                              nullptr,
+                              nullptr};
+      m_gx_sampler_descriptor_sets.emplace(m_bindings.samplers, m_gx_descriptor_sets[1]);
+      m_dirty_flags = (m_dirty_flags & ~DIRTY_FLAG_GX_SAMPLERS) | DIRTY_FLAG_DESCRIPTOR_SETS;
+    }
   }
 
   if (g_ActiveConfig.backend_info.bSupportsBBox &&
@@ -535,7 +727,12 @@ bool StateTracker::UpdateGXDescriptorSet()
   if (num_writes > 0)
     vkUpdateDescriptorSets(g_vulkan_context->GetDevice(), num_writes, writes.data(), 0, nullptr);
 
-  if (m_dirty_flags & DIRTY_FLAG_DESCRIPTOR_SETS)
+  if (IsDeferringDraws())
+  {
+    // Deferred draws take the descriptor sets with them.
+    m_dirty_flags &= ~(DIRTY_FLAG_DESCRIPTOR_SETS | DIRTY_FLAG_GX_UBO_OFFSETS);
+  }
+  else if (m_dirty_flags & DIRTY_FLAG_DESCRIPTOR_SETS)
   {
     vkCmdBindDescriptorSets(g_command_buffer_mgr->GetCurrentCommandBuffer(),
                             VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline->GetVkPipelineLayout(), 0,
@@ -564,6 +761,21 @@ bool StateTracker::UpdateGXDescriptorSet()
   return true;
 }
 
+VkDescriptorSet StateTracker::GetGXSamplerDescriptorSet()
+{
+  // The sets are freed when the descriptor pool of the command buffer is reset.
+  const u64 fence_counter = g_command_buffer_mgr->GetCurrentFenceCounter();
+  if (m_gx_sampler_descriptor_sets_fence_counter != fence_counter)
+  {
+    m_gx_sampler_descriptor_sets.clear();
+    m_gx_sampler_descriptor_sets_fence_counter = fence_counter;
+    return VK_NULL_HANDLE;
+  }
+
+  auto it = m_gx_sampler_descriptor_sets.find(m_bindings.samplers);
+  return it != m_gx_sampler_descriptor_sets.end() ? it->second : VK_NULL_HANDLE;
+}
+
 bool StateTracker::UpdateUtilityDescriptorSet()
 {
   // Max number of updates - UBO, Samplers, TexelBuffer
@@ -626,7 +838,11 @@ bool StateTracker::UpdateUtilityDescriptorSet()
   if (writes > 0)
     vkUpdateDescriptorSets(g_vulkan_context->GetDevice(), writes, dswrites.data(), 0, nullptr);
 
-  if (m_dirty_flags & DIRTY_FLAG_DESCRIPTOR_SETS)
+  if (IsDeferringDraws())
+  {
+    m_dirty_flags &= ~(DIRTY_FLAG_DESCRIPTOR_SETS | DIRTY_FLAG_UTILITY_UBO_OFFSET);
+  }
+  else if (m_dirty_flags & DIRTY_FLAG_DESCRIPTOR_SETS)
   {
     vkCmdBindDescriptorSets(g_command_buffer_mgr->GetCurrentCommandBuffer(),
                             VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline->GetVkPipelineLayout(), 0,
@@ -645,7 +861,7 @@ bool StateTracker::UpdateUtilityDescriptorSet()
   return true;
 }
 
-bool StateTracker::UpdateComputeDescriptorSet()
+bool StateTracker::UpdateComputeDescriptorSet(VkCommandBuffer command_buffer)
 {
   // Max number of updates - UBO, Samplers, TexelBuffer, Image
   std::array<VkWriteDescriptorSet, 4> dswrites;
@@ -704,8 +920,7 @@ bool StateTracker::UpdateComputeDescriptorSet()
 
   if (m_dirty_flags & DIRTY_FLAG_COMPUTE_DESCRIPTOR_SET)
   {
-    vkCmdBindDescriptorSets(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-                            VK_PIPELINE_BIND_POINT_COMPUTE,
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
                             g_object_cache->GetPipelineLayout(PIPELINE_LAYOUT_COMPUTE), 0, 1,
                             &m_compute_descriptor_set, 1, &m_bindings.utility_ubo_offset);
     m_dirty_flags &= ~DIRTY_FLAG_COMPUTE_DESCRIPTOR_SET;
@@ -7,6 +7,7 @@
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <unordered_map>
 
 #include "Common/CommonTypes.h"
 #include "VideoBackends/Vulkan/Constants.h"
@@ -14,6 +15,7 @@
 
 namespace Vulkan
 {
+class CommandRecorder;
 class VKFramebuffer;
 class VKShader;
 class VKPipeline;
@@ -59,6 +61,11 @@ public:
   void BeginDiscardRenderPass();
   void EndRenderPass();
 
+  // With command recording threads, the draws of a render pass are deferred until it ends. This
+  // records them, and the remainder of the render pass, into the command buffer directly. It has
+  // to be called before recording anything other than draws into the render pass.
+  void FlushDeferredDraws();
+
   // Ends the current render pass if it was a clear render pass.
   void BeginClearRenderPass(const VkRect2D& area, const VkClearValue* clear_values,
                             u32 num_clear_values);
@@ -71,10 +78,17 @@ public:
   // If this returns false, you should not issue the draw.
   bool Bind();
 
+  // Issues a draw with the bound state. Bind() must have succeeded before.
+  void Draw(u32 num_vertices, u32 base_vertex);
+  void DrawIndexed(u32 num_indices, u32 base_index, u32 base_vertex);
+
   // Binds all dirty compute state to the command buffer.
   // If this returns false, you should not dispatch the shader.
   bool BindCompute();
 
+  // Same as BindCompute(), but for the async compute command buffer.
+  bool BindAsyncCompute();
+
   // Returns true if the specified rectangle is inside the current render area (used for clears).
   bool IsWithinRenderArea(s32 x, s32 y, u32 width, u32 height) const;
 
@@ -113,14 +127,25 @@ private:
 
   bool Initialize();
 
+  void BeginRenderPass(const VkRenderPassBeginInfo& begin_info);
+
+  // Are draws going to the command recorder, rather than the command buffer?
+  bool IsDeferringDraws() const;
+  void AddDeferredDraw(bool indexed, u32 num_vertices, u32 base_index, u32 base_vertex);
+
+  // Marks the state bound in the command buffer as dirty, after draws were recorded elsewhere.
+  void InvalidateBoundState();
+
   // Check that the specified viewport is within the render area.
   // If not, ends the render pass if it is a clear render pass.
   bool IsViewportWithinRenderArea() const;
 
   bool UpdateDescriptorSet();
   bool UpdateGXDescriptorSet();
+  VkDescriptorSet GetGXSamplerDescriptorSet();
   bool UpdateUtilityDescriptorSet();
-  bool UpdateComputeDescriptorSet();
+  bool BindCompute(VkCommandBuffer command_buffer);
+  bool UpdateComputeDescriptorSet(VkCommandBuffer command_buffer);
 
   // Which bindings/state has to be updated before the next draw.
   u32 m_dirty_flags = 0;
@@ -136,6 +161,10 @@ private:
   const VKPipeline* m_pipeline = nullptr;
   const VKShader* m_compute_shader = nullptr;
 
+  // The command buffer the compute state was last bound to, as dispatches can alternate between
+  // the draw and async compute command buffers.
+  VkCommandBuffer m_compute_command_buffer = VK_NULL_HANDLE;
+
   // shader bindings
   struct
   {
@@ -152,6 +181,22 @@ private:
   std::array<VkDescriptorSet, NUM_UTILITY_DESCRIPTOR_SETS> m_utility_descriptor_sets = {};
   VkDescriptorSet m_compute_descriptor_set = VK_NULL_HANDLE;
 
+  // Sampler descriptor sets written in the current command buffer, by their bindings. Games
+  // tend to switch between the same few sets of textures, so the sets are re-used instead of
+  // allocating and writing a new one each time. They are dropped when the pool is reset.
+  using SamplerBindings = std::array<VkDescriptorImageInfo, NUM_PIXEL_SHADER_SAMPLERS>;
+  struct SamplerBindingsHash
+  {
+    size_t operator()(const SamplerBindings& bindings) const;
+  };
+  struct SamplerBindingsEqual
+  {
+    bool operator()(const SamplerBindings& lhs, const SamplerBindings& rhs) const;
+  };
+  std::unordered_map<SamplerBindings, VkDescriptorSet, SamplerBindingsHash, SamplerBindingsEqual>
+      m_gx_sampler_descriptor_sets;
+  u64 m_gx_sampler_descriptor_sets_fence_counter = 0;
+
   // rasterization
   VkViewport m_viewport = {0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f};
   VkRect2D m_scissor = {{0, 0}, {1, 1}};
@@ -162,5 +207,7 @@ private:
   VKFramebuffer* m_framebuffer = nullptr;
   VkRenderPass m_current_render_pass = VK_NULL_HANDLE;
   VkRect2D m_framebuffer_render_area = {};
+
+  std::unique_ptr<CommandRecorder> m_command_recorder;
 };
 }  // namespace Vulkan
@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <vector>
 
 #include "Common/Assert.h"
@@ -15,6 +16,8 @@
 #include "VideoBackends/Vulkan/VKRenderer.h"
 #include "VideoBackends/Vulkan/VulkanContext.h"
 
+#include "VideoCommon/VideoConfig.h"
+
 namespace Vulkan
 {
 BoundingBox::BoundingBox()
@@ -112,6 +115,7 @@ void BoundingBox::Invalidate()
     return;
 
   m_valid = false;
+  m_drawn_since_deferred_readback = true;
 }
 
 s32 BoundingBox::Get(size_t index)
@@ -119,7 +123,12 @@ s32 BoundingBox::Get(size_t index)
   ASSERT(index < NUM_VALUES);
 
   if (!m_valid)
-    Readback();
+  {
+    if (g_ActiveConfig.bbox_readback_mode == BBoxReadbackMode::Synchronous)
+      Readback();
+    else
+      UpdateFromDeferredReadbacks();
+  }
 
   s32 value;
   m_readback_buffer->Read(index * sizeof(s32), &value, sizeof(value), false);
@@ -143,6 +152,7 @@ void BoundingBox::Set(size_t index, s32 value)
   // Flag as dirty, and update values.
   m_readback_buffer->Write(index * sizeof(s32), &value, sizeof(value), true);
   m_values_dirty[index] = true;
+  m_last_write_fence_counter = g_command_buffer_mgr->GetCurrentFenceCounter();
 }
 
 bool BoundingBox::CreateGPUBuffer()
@@ -213,35 +223,48 @@ bool BoundingBox::CreateReadbackBuffer()
   if (!m_readback_buffer || !m_readback_buffer->Map())
     return false;
 
+  for (DeferredReadback& readback : m_deferred_readbacks)
+  {
+    readback.buffer = StagingBuffer::Create(STAGING_BUFFER_TYPE_READBACK, BUFFER_SIZE,
+                                            VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    if (!readback.buffer || !readback.buffer->Map())
+      return false;
+  }
+
   return true;
 }
 
-void BoundingBox::Readback()
+void BoundingBox::CopyToReadbackBuffer(StagingBuffer* buffer)
 {
-  // Can't be done within a render pass.
-  StateTracker::GetInstance()->EndRenderPass();
 
   // Ensure all writes are completed to the GPU buffer prior to the transfer.
   StagingBuffer::BufferMemoryBarrier(
       g_command_buffer_mgr->GetCurrentCommandBuffer(), m_gpu_buffer,
       VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, 0,
       BUFFER_SIZE, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
-  m_readback_buffer->PrepareForGPUWrite(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-                                        VK_ACCESS_TRANSFER_WRITE_BIT,
-                                        VK_PIPELINE_STAGE_TRANSFER_BIT);
+  buffer->PrepareForGPUWrite(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+                             VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
 
   // Copy from GPU -> readback buffer.
   VkBufferCopy region = {0, 0, BUFFER_SIZE};
   vkCmdCopyBuffer(g_command_buffer_mgr->GetCurrentCommandBuffer(), m_gpu_buffer,
-                  m_readback_buffer->GetBuffer(), 1, &region);
+                  buffer->GetBuffer(), 1, &region);
 
   // Restore GPU buffer access.
   StagingBuffer::BufferMemoryBarrier(
       g_command_buffer_mgr->GetCurrentCommandBuffer(), m_gpu_buffer, VK_ACCESS_TRANSFER_READ_BIT,
       VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, 0, BUFFER_SIZE,
       VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-  m_readback_buffer->FlushGPUCache(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-                                   VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+  buffer->FlushGPUCache(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+                        VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+}
+
+void BoundingBox::Readback()
+{
+  // Can't be done within a render pass.
+  StateTracker::GetInstance()->EndRenderPass();
+
+  CopyToReadbackBuffer(m_readback_buffer.get());
 
   // Wait until these commands complete.
   Renderer::GetInstance()->ExecuteCommandBuffer(false, true);
@@ -251,4 +274,66 @@ void BoundingBox::Readback()
   m_valid = true;
 }
 
+void BoundingBox::QueueDeferredReadback()
+{
+  if (m_gpu_buffer == VK_NULL_HANDLE ||
+      g_ActiveConfig.bbox_readback_mode == BBoxReadbackMode::Synchronous)
+  {
+    return;
+  }
+
+  // Values written since the last draw have to be in the buffer before it is copied.
+  if (std::any_of(m_values_dirty.begin(), m_values_dirty.end(), [](bool dirty) { return dirty; }))
+  {
+    Flush();
+    Invalidate();
+  }
+
+  if (!m_drawn_since_deferred_readback)
+    return;
+
+  // If the GPU hasn't finished the copy of the previous use yet, skip this readback rather than
+  // waiting for it. It is then done when the next command buffer is submitted instead.
+  DeferredReadback& readback = m_deferred_readbacks[m_next_deferred_readback];
+  if (readback.fence_counter > g_command_buffer_mgr->GetCompletedFenceCounter())
+    return;
+
+  CopyToReadbackBuffer(readback.buffer.get());
+  readback.fence_counter = g_command_buffer_mgr->GetCurrentFenceCounter();
+  m_next_deferred_readback = (m_next_deferred_readback + 1) % NUM_DEFERRED_READBACKS;
+  m_drawn_since_deferred_readback = false;
+}
+
+void BoundingBox::UpdateFromDeferredReadbacks()
+{
+  // Readbacks are only queued right before submitting a command buffer, so all of them have
+  // already been submitted, and waiting for one never stalls on the current rendering.
+  const bool wait = g_ActiveConfig.bbox_readback_mode == BBoxReadbackMode::DeferredWait;
+  const u64 completed_fence_counter = g_command_buffer_mgr->GetCompletedFenceCounter();
+  DeferredReadback* newest = nullptr;
+  for (DeferredReadback& readback : m_deferred_readbacks)
+  {
+    if (readback.fence_counter <= m_deferred_values_fence_counter ||
+        (!wait && readback.fence_counter > completed_fence_counter))
+    {
+      continue;
+    }
+
+    if (!newest || readback.fence_counter > newest->fence_counter)
+      newest = &readback;
+  }
+
+  // Keep the values the CPU has written until a readback includes them.
+  if (!newest || newest->fence_counter < m_last_write_fence_counter)
+    return;
+
+  if (wait)
+    g_command_buffer_mgr->WaitForFenceCounter(newest->fence_counter);
+
+  std::array<s32, NUM_VALUES> values;
+  newest->buffer->Read(0, values.data(), BUFFER_SIZE, true);
+  m_readback_buffer->Write(0, values.data(), BUFFER_SIZE, false);
+  m_deferred_values_fence_counter = newest->fence_counter;
+}
+
 }  // namespace Vulkan
@@ -10,6 +10,7 @@
 
 #include "Common/CommonTypes.h"
 
+#include "VideoBackends/Vulkan/Constants.h"
 #include "VideoBackends/Vulkan/VulkanLoader.h"
 
 namespace Vulkan
@@ -30,10 +31,16 @@ public:
   void Invalidate();
   void Flush();
 
+  // Copies the buffer to the next deferred readback buffer if it has been drawn to since the last
+  // one. Called outside of a render pass, right before the command buffer is submitted.
+  void QueueDeferredReadback();
+
 private:
   bool CreateGPUBuffer();
   bool CreateReadbackBuffer();
+  void CopyToReadbackBuffer(StagingBuffer* buffer);
   void Readback();
+  void UpdateFromDeferredReadbacks();
 
   VkBuffer m_gpu_buffer = VK_NULL_HANDLE;
   VkDeviceMemory m_gpu_memory = VK_NULL_HANDLE;
@@ -44,6 +51,24 @@ private:
   std::unique_ptr<StagingBuffer> m_readback_buffer;
   std::array<bool, NUM_VALUES> m_values_dirty = {};
   bool m_valid = true;
+
+  // With deferred readback, the values in m_readback_buffer are updated from the newest of these
+  // which has completed, rather than by waiting for the GPU. One more than the number of command
+  // buffers is needed, so that the oldest one has usually completed by the time it is reused.
+  struct DeferredReadback
+  {
+    std::unique_ptr<StagingBuffer> buffer;
+    u64 fence_counter = 0;
+  };
+  static const size_t NUM_DEFERRED_READBACKS = NUM_COMMAND_BUFFERS + 1;
+  std::array<DeferredReadback, NUM_DEFERRED_READBACKS> m_deferred_readbacks;
+  size_t m_next_deferred_readback = 0;
+  // Fence counter of the readback the current values were taken from.
+  u64 m_deferred_values_fence_counter = 0;
+  // Fence counter of the command buffer which was current when the CPU last wrote a value.
+  // Readbacks before it don't include the write, so they are ignored.
+  u64 m_last_write_fence_counter = 0;
+  bool m_drawn_since_deferred_readback = false;
 };
 
 }  // namespace Vulkan
@@ -9,7 +9,9 @@
 
 #include "VideoBackends/Vulkan/CommandBufferManager.h"
 #include "VideoBackends/Vulkan/Constants.h"
+#include "VideoBackends/Vulkan/MemoryAllocator.h"
 #include "VideoBackends/Vulkan/ObjectCache.h"
+#include "VideoBackends/Vulkan/ShaderCompiler.h"
 #include "VideoBackends/Vulkan/StateTracker.h"
 #include "VideoBackends/Vulkan/VKPerfQuery.h"
 #include "VideoBackends/Vulkan/VKRenderer.h"
@@ -193,8 +195,21 @@ bool VideoBackend::Initialize(const WindowSystemInfo& wsi)
   // With the backend information populated, we can now initialize videocommon.
   InitializeShared();
 
+  if (g_Config.bShaderCache)
+    ShaderCompiler::LoadSPIRVCache();
+
+  g_memory_allocator = std::make_unique<MemoryAllocator>();
+
   // Create command buffers. We do this separately because the other classes depend on it.
-  g_command_buffer_mgr = std::make_unique<CommandBufferManager>(g_Config.bBackendMultithreading);
+  // The video thread records into a secondary command pool of its own as well.
+  const u32 num_secondary_command_pools =
+      g_Config.iCommandRecordingThreads > 0 ? g_Config.iCommandRecordingThreads + 1 : 0;
+  const bool use_async_compute = g_Config.bAsyncCompute && g_vulkan_context->HasAsyncComputeQueue();
+  const bool use_transfer_queue =
+      g_Config.bAsyncTextureUploads && g_vulkan_context->HasTransferQueue();
+  g_command_buffer_mgr = std::make_unique<CommandBufferManager>(
+      g_Config.bBackendMultithreading, num_secondary_command_pools, use_async_compute,
+      use_transfer_queue);
   if (!g_command_buffer_mgr->Initialize())
   {
     PanicAlertFmt("Failed to create Vulkan command buffers");
@@ -275,7 +290,9 @@ void VideoBackend::Shutdown()
   g_object_cache.reset();
   StateTracker::DestroyInstance();
   g_command_buffer_mgr.reset();
+  g_memory_allocator.reset();
   g_vulkan_context.reset();
+  ShaderCompiler::CloseSPIRVCache();
   ShutdownShared();
   UnloadVulkanLibrary();
 }
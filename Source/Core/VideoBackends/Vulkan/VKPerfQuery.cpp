@@ -55,6 +55,7 @@ void PerfQuery::EnableQuery(PerfQueryGroup type)
     ActiveQuery& entry = m_query_buffer[m_query_next_pos];
     DEBUG_ASSERT(!entry.has_value);
     entry.has_value = true;
+    entry.query_type = type;
 
     // Use precise queries if supported, otherwise boolean (which will be incorrect).
     VkQueryControlFlags flags =
@@ -62,6 +63,7 @@ void PerfQuery::EnableQuery(PerfQueryGroup type)
 
     // Ensure the query starts within a render pass.
     StateTracker::GetInstance()->BeginRenderPass();
+    StateTracker::GetInstance()->FlushDeferredDraws();
     vkCmdBeginQuery(g_command_buffer_mgr->GetCurrentCommandBuffer(), m_query_pool, m_query_next_pos,
                     flags);
   }
@@ -71,6 +73,7 @@ void PerfQuery::DisableQuery(PerfQueryGroup type)
 {
   if (type == PQG_ZCOMP_ZCOMPLOC || type == PQG_ZCOMP)
   {
+    StateTracker::GetInstance()->FlushDeferredDraws();
     vkCmdEndQuery(g_command_buffer_mgr->GetCurrentCommandBuffer(), m_query_pool, m_query_next_pos);
     m_query_next_pos = (m_query_next_pos + 1) % PERF_QUERY_BUFFER_SIZE;
     m_query_count++;
@@ -79,10 +82,22 @@ void PerfQuery::DisableQuery(PerfQueryGroup type)
 
 void PerfQuery::ResetQuery()
 {
+  if (IsLatencyTolerant())
+  {
+    ReadbackQueries();
+    while (HasPendingPreviousPeriod())
+      PartialFlush(true);
+
+    // The pending queries are reset individually once they have been read back.
+    BeginQueryPeriod();
+    if (m_query_count > 0)
+      return;
+  }
+
   m_query_count = 0;
   m_query_readback_pos = 0;
   m_query_next_pos = 0;
-  std::fill(std::begin(m_results), std::end(m_results), 0);
+  ClearResults();
 
   // Reset entire query pool, ensuring all queries are ready to write to.
   StateTracker::GetInstance()->EndRenderPass();
@@ -96,13 +111,13 @@ u32 PerfQuery::GetQueryResult(PerfQueryType type)
 {
   u32 result = 0;
   if (type == PQ_ZCOMP_INPUT_ZCOMPLOC || type == PQ_ZCOMP_OUTPUT_ZCOMPLOC)
-    result = m_results[PQG_ZCOMP_ZCOMPLOC];
+    result = GetGroupResult(PQG_ZCOMP_ZCOMPLOC);
   else if (type == PQ_ZCOMP_INPUT || type == PQ_ZCOMP_OUTPUT)
-    result = m_results[PQG_ZCOMP];
+    result = GetGroupResult(PQG_ZCOMP);
   else if (type == PQ_BLEND_INPUT)
-    result = m_results[PQG_ZCOMP] + m_results[PQG_ZCOMP_ZCOMPLOC];
+    result = GetGroupResult(PQG_ZCOMP) + GetGroupResult(PQG_ZCOMP_ZCOMPLOC);
   else if (type == PQ_EFB_COPY_CLOCKS)
-    result = m_results[PQG_EFB_COPY_CLOCKS];
+    result = GetGroupResult(PQG_EFB_COPY_CLOCKS);
 
   return result / 4;
 }
@@ -194,9 +209,19 @@ void PerfQuery::ReadbackQueries(u32 query_count)
     entry.has_value = false;
 
     // NOTE: Reported pixel metrics should be referenced to native resolution
-    m_results[entry.query_type] +=
-        static_cast<u32>(static_cast<u64>(m_query_result_buffer[i]) * EFB_WIDTH /
-                         g_renderer->GetTargetWidth() * EFB_HEIGHT / g_renderer->GetTargetHeight());
+    const u64 result = m_query_result_buffer[i];
+    AccumulateResult(entry.query_type,
+                     static_cast<u32>(result * EFB_WIDTH / g_renderer->GetTargetWidth() *
+                                      EFB_HEIGHT / g_renderer->GetTargetHeight()));
+  }
+
+  // Queries are left in flight when the counters are reset in latency tolerant mode, so the pool
+  // can't be reset as a whole. Reset the queries which were read back before they are reused.
+  if (IsLatencyTolerant())
+  {
+    StateTracker::GetInstance()->EndRenderPass();
+    vkCmdResetQueryPool(g_command_buffer_mgr->GetCurrentCommandBuffer(), m_query_pool,
+                        m_query_readback_pos, query_count);
   }
 
   m_query_readback_pos = (m_query_readback_pos + query_count) % PERF_QUERY_BUFFER_SIZE;
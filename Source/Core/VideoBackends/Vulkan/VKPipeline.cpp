@@ -5,6 +5,10 @@
 #include "VideoBackends/Vulkan/VKPipeline.h"
 
 #include <array>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <tuple>
 
 #include "Common/Assert.h"
 #include "Common/MsgHandler.h"
@@ -17,14 +21,37 @@
 
 namespace Vulkan
 {
+// GX pipelines mostly differ in their render states, and share their shaders with many others.
+// The first pipeline created for a set of shaders allows derivatives, and the later ones are
+// created as derivatives of it, which lets the driver re-use the work done for the shaders.
+// Pipelines are created on the shader compiler threads, so creating one takes a shared lock to
+// keep its base pipeline alive, and destroying a base pipeline takes an exclusive one.
+using PipelineShaders = std::tuple<VkShaderModule, VkShaderModule, VkShaderModule>;
+static std::map<PipelineShaders, VkPipeline> s_base_pipelines;
+static std::shared_mutex s_base_pipelines_lock;
+
 VKPipeline::VKPipeline(VkPipeline pipeline, VkPipelineLayout pipeline_layout,
-                       AbstractPipelineUsage usage)
-    : m_pipeline(pipeline), m_pipeline_layout(pipeline_layout), m_usage(usage)
+                       AbstractPipelineUsage usage, bool is_base_pipeline)
+    : m_pipeline(pipeline), m_pipeline_layout(pipeline_layout), m_usage(usage),
+      m_is_base_pipeline(is_base_pipeline)
 {
 }
 
 VKPipeline::~VKPipeline()
 {
+  if (m_is_base_pipeline)
+  {
+    std::unique_lock<std::shared_mutex> guard(s_base_pipelines_lock);
+    for (auto it = s_base_pipelines.begin(); it != s_base_pipelines.end(); ++it)
+    {
+      if (it->second == m_pipeline)
+      {
+        s_base_pipelines.erase(it);
+        break;
+      }
+    }
+  }
+
   vkDestroyPipeline(g_vulkan_context->GetDevice(), m_pipeline, nullptr);
 }
 
@@ -383,16 +410,41 @@ std::unique_ptr<VKPipeline> VKPipeline::Create(const AbstractPipelineConfig& con
       -1                     // int32_t                                          basePipelineIndex
   };
 
+  const PipelineShaders shaders{shader_stages[0].module,
+                                config.geometry_shader ? shader_stages[1].module : VK_NULL_HANDLE,
+                                shader_stages[num_shader_stages - 1].module};
+  std::shared_lock<std::shared_mutex> base_guard(s_base_pipelines_lock);
+  auto base_it = s_base_pipelines.find(shaders);
+  const bool is_base_pipeline = base_it == s_base_pipelines.end();
+  if (is_base_pipeline)
+  {
+    pipeline_info.flags |= VK_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT;
+  }
+  else
+  {
+    pipeline_info.flags |= VK_PIPELINE_CREATE_DERIVATIVE_BIT;
+    pipeline_info.basePipelineHandle = base_it->second;
+  }
+
   VkPipeline pipeline;
   VkResult res =
       vkCreateGraphicsPipelines(g_vulkan_context->GetDevice(), g_object_cache->GetPipelineCache(),
                                 1, &pipeline_info, nullptr, &pipeline);
+  base_guard.unlock();
   if (res != VK_SUCCESS)
   {
     LOG_VULKAN_ERROR(res, "vkCreateGraphicsPipelines failed: ");
     return VK_NULL_HANDLE;
   }
 
-  return std::make_unique<VKPipeline>(pipeline, pipeline_layout, config.usage);
+  if (is_base_pipeline)
+  {
+    // Another thread may have created a base pipeline for these shaders in the meantime.
+    std::unique_lock<std::shared_mutex> guard(s_base_pipelines_lock);
+    if (!s_base_pipelines.emplace(shaders, pipeline).second)
+      return std::make_unique<VKPipeline>(pipeline, pipeline_layout, config.usage);
+  }
+
+  return std::make_unique<VKPipeline>(pipeline, pipeline_layout, config.usage, is_base_pipeline);
 }
 }  // namespace Vulkan
@@ -15,7 +15,7 @@ class VKPipeline final : public AbstractPipeline
 {
 public:
   explicit VKPipeline(VkPipeline pipeline, VkPipelineLayout pipeline_layout,
-                      AbstractPipelineUsage usage);
+                      AbstractPipelineUsage usage, bool is_base_pipeline = false);
   ~VKPipeline() override;
 
   VkPipeline GetVkPipeline() const { return m_pipeline; }
@@ -27,6 +27,9 @@ private:
   VkPipeline m_pipeline;
   VkPipelineLayout m_pipeline_layout;
   AbstractPipelineUsage m_usage;
+
+  // Pipelines with the same shaders are created as derivatives of this one.
+  bool m_is_base_pipeline;
 };
 
 }  // namespace Vulkan
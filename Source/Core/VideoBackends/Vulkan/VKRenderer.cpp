@@ -8,6 +8,7 @@
 #include <limits>
 #include <string>
 #include <tuple>
+#include <utility>
 
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
@@ -17,6 +18,7 @@
 #include "Core/Core.h"
 
 #include "VideoBackends/Vulkan/CommandBufferManager.h"
+#include "VideoBackends/Vulkan/MemoryAllocator.h"
 #include "VideoBackends/Vulkan/ObjectCache.h"
 #include "VideoBackends/Vulkan/StateTracker.h"
 #include "VideoBackends/Vulkan/VKBoundingBox.h"
@@ -81,6 +83,7 @@ void Renderer::Shutdown()
 {
   ::Renderer::Shutdown();
   m_swap_chain.reset();
+  m_async_compute_images.clear();
 }
 
 std::unique_ptr<AbstractTexture> Renderer::CreateTexture(const TextureConfig& config)
@@ -249,6 +252,7 @@ void Renderer::ClearScreen(const MathUtil::Rectangle<int>& rc, bool color_enable
         StateTracker::GetInstance()->EndClearRenderPass();
       }
       StateTracker::GetInstance()->BeginRenderPass();
+      StateTracker::GetInstance()->FlushDeferredDraws();
 
       vkCmdClearAttachments(g_command_buffer_mgr->GetCurrentCommandBuffer(), num_clear_attachments,
                             clear_attachments, 1, &vk_rect);
@@ -339,15 +343,41 @@ void Renderer::PresentBackbuffer()
   m_swap_chain->GetCurrentTexture()->TransitionToLayout(
       g_command_buffer_mgr->GetCurrentCommandBuffer(), VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 
+  if (m_bounding_box)
+    m_bounding_box->QueueDeferredReadback();
+
   // Submit the current command buffer, signaling rendering finished semaphore when it's done
   // Because this final command buffer is rendering to the swap chain, we need to wait for
   // the available semaphore to be signaled before executing the buffer. This final submission
   // can happen off-thread in the background while we're preparing the next frame.
+  const u64 frame_fence_counter = g_command_buffer_mgr->GetCurrentFenceCounter();
   g_command_buffer_mgr->SubmitCommandBuffer(true, false, m_swap_chain->GetSwapChain(),
                                             m_swap_chain->GetCurrentImageIndex());
 
   // New cmdbuffer, so invalidate state.
   StateTracker::GetInstance()->InvalidateCachedState();
+
+  LimitFramesInFlight(frame_fence_counter);
+  g_memory_allocator->ReleaseUnusedBlocks();
+}
+
+void Renderer::LimitFramesInFlight(u64 frame_fence_counter)
+{
+  const int max_frames_in_flight = g_ActiveConfig.iMaxFramesInFlight;
+  if (max_frames_in_flight <= 0)
+  {
+    m_frame_fence_counters.clear();
+    return;
+  }
+
+  // Blocking here keeps the video thread from running ahead of the GPU, so the next frame is
+  // emulated with more recent input at the cost of less overlap between the CPU and GPU.
+  m_frame_fence_counters.push_back(frame_fence_counter);
+  while (m_frame_fence_counters.size() >= static_cast<size_t>(max_frames_in_flight))
+  {
+    g_command_buffer_mgr->WaitForFenceCounter(m_frame_fence_counters.front());
+    m_frame_fence_counters.pop_front();
+  }
 }
 
 void Renderer::SetFullscreen(bool enable_fullscreen)
@@ -366,6 +396,8 @@ bool Renderer::IsFullscreen() const
 void Renderer::ExecuteCommandBuffer(bool submit_off_thread, bool wait_for_completion)
 {
   StateTracker::GetInstance()->EndRenderPass();
+  if (m_bounding_box)
+    m_bounding_box->QueueDeferredReadback();
 
   g_command_buffer_mgr->SubmitCommandBuffer(submit_off_thread, wait_for_completion);
 
@@ -564,7 +596,14 @@ void Renderer::SetSamplerState(u32 index, const SamplerState& state)
 void Renderer::SetComputeImageTexture(AbstractTexture* texture, bool read, bool write)
 {
   VKTexture* vk_texture = static_cast<VKTexture*>(texture);
-  if (vk_texture)
+  m_pending_compute_image_texture = nullptr;
+  if (vk_texture && g_command_buffer_mgr->UsesAsyncCompute() && !read && write)
+  {
+    // Nothing is read from the image, so async dispatches can write to a new one.
+    m_pending_compute_image_texture = vk_texture;
+    StateTracker::GetInstance()->SetImageTexture(vk_texture->GetView());
+  }
+  else if (vk_texture)
   {
     StateTracker::GetInstance()->EndRenderPass();
     StateTracker::GetInstance()->SetImageTexture(vk_texture->GetView());
@@ -629,7 +668,7 @@ void Renderer::Draw(u32 base_vertex, u32 num_vertices)
   if (!StateTracker::GetInstance()->Bind())
     return;
 
-  vkCmdDraw(g_command_buffer_mgr->GetCurrentCommandBuffer(), num_vertices, 1, base_vertex, 0);
+  StateTracker::GetInstance()->Draw(num_vertices, base_vertex);
 }
 
 void Renderer::DrawIndexed(u32 base_index, u32 num_indices, u32 base_vertex)
@@ -637,16 +676,64 @@ void Renderer::DrawIndexed(u32 base_index, u32 num_indices, u32 base_vertex)
   if (!StateTracker::GetInstance()->Bind())
     return;
 
-  vkCmdDrawIndexed(g_command_buffer_mgr->GetCurrentCommandBuffer(), num_indices, 1, base_index,
-                   base_vertex, 0);
+  StateTracker::GetInstance()->DrawIndexed(num_indices, base_index, base_vertex);
 }
 
 void Renderer::DispatchComputeShader(const AbstractShader* shader, u32 groups_x, u32 groups_y,
                                      u32 groups_z)
 {
   StateTracker::GetInstance()->SetComputeShader(static_cast<const VKShader*>(shader));
+
+  VKTexture* const image_texture = std::exchange(m_pending_compute_image_texture, nullptr);
+  if (image_texture)
+  {
+    if (DispatchAsyncComputeShader(image_texture, groups_x, groups_y, groups_z))
+      return;
+
+    StateTracker::GetInstance()->EndRenderPass();
+    image_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+                                      VKTexture::ComputeImageLayout::WriteOnly);
+  }
+
   if (StateTracker::GetInstance()->BindCompute())
     vkCmdDispatch(g_command_buffer_mgr->GetCurrentCommandBuffer(), groups_x, groups_y, groups_z);
 }
 
+bool Renderer::DispatchAsyncComputeShader(VKTexture* image_texture, u32 groups_x, u32 groups_y,
+                                          u32 groups_z)
+{
+  const u64 completed_fence_counter = g_command_buffer_mgr->GetCompletedFenceCounter();
+  auto iter = std::find_if(m_async_compute_images.begin(), m_async_compute_images.end(),
+                           [&](const AsyncComputeImage& image) {
+                             return image.fence_counter <= completed_fence_counter &&
+                                    image.texture->GetConfig() == image_texture->GetConfig();
+                           });
+  if (iter == m_async_compute_images.end())
+  {
+    if (m_async_compute_images.size() == MAX_ASYNC_COMPUTE_IMAGES)
+      return false;
+
+    std::unique_ptr<VKTexture> texture = VKTexture::Create(image_texture->GetConfig());
+    if (!texture)
+      return false;
+
+    iter = m_async_compute_images.insert(m_async_compute_images.end(), {std::move(texture), 0});
+  }
+
+  // The image the texture had so far may still be read by the current command buffer.
+  image_texture->ExchangeImage(iter->texture.get());
+  iter->fence_counter = g_command_buffer_mgr->GetCurrentFenceCounter();
+
+  StateTracker::GetInstance()->SetImageTexture(image_texture->GetView());
+  if (!StateTracker::GetInstance()->BindAsyncCompute())
+    return true;
+
+  // Commands in the draw command buffer reading the results wait for the compute command buffer,
+  // so the barriers they record for the texture complete the synchronization.
+  const VkCommandBuffer command_buffer = g_command_buffer_mgr->GetCurrentComputeCommandBuffer();
+  image_texture->TransitionToLayout(command_buffer, VKTexture::ComputeImageLayout::WriteOnly);
+  vkCmdDispatch(command_buffer, groups_x, groups_y, groups_z);
+  return true;
+}
+
 }  // namespace Vulkan
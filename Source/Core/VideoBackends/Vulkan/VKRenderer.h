@@ -6,7 +6,9 @@
 
 #include <array>
 #include <cstddef>
+#include <deque>
 #include <memory>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "VideoBackends/Vulkan/Constants.h"
@@ -99,10 +101,37 @@ private:
   void OnSwapChainResized();
   void BindFramebuffer(VKFramebuffer* fb);
 
+  // Waits for the GPU to finish earlier frames, so that no more than the configured number of
+  // frames are in flight once the next one is begun, counting the next one.
+  void LimitFramesInFlight(u64 frame_fence_counter);
+
+  // Returns false if there is no free image to dispatch into, in which case the dispatch has to
+  // be done in the draw command buffer instead.
+  bool DispatchAsyncComputeShader(VKTexture* image_texture, u32 groups_x, u32 groups_y,
+                                  u32 groups_z);
+
   std::unique_ptr<SwapChain> m_swap_chain;
   std::unique_ptr<BoundingBox> m_bounding_box;
 
   // Keep a copy of sampler states to avoid cache lookups every draw
   std::array<SamplerState, NUM_PIXEL_SHADER_SAMPLERS> m_sampler_states = {};
+
+  // With async compute, the compute image texture has to be transitioned in the compute command
+  // buffer, so this is only done once it is known where the dispatch is recorded.
+  VKTexture* m_pending_compute_image_texture = nullptr;
+
+  // Async compute dispatches write to a new image each time, so that they don't have to wait
+  // for the graphics queue to finish reading the results of the previous one. The images are
+  // re-used once the last command buffer which could have used them has completed.
+  static constexpr size_t MAX_ASYNC_COMPUTE_IMAGES = 8;
+  struct AsyncComputeImage
+  {
+    std::unique_ptr<VKTexture> texture;
+    u64 fence_counter;
+  };
+  std::vector<AsyncComputeImage> m_async_compute_images;
+
+  // Fence counters of the command buffers which presented the frames that are in flight.
+  std::deque<u64> m_frame_fence_counters;
 };
 }  // namespace Vulkan
@@ -5,6 +5,7 @@
 #include "VideoBackends/Vulkan/VKStreamBuffer.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <functional>
 
@@ -55,6 +56,17 @@ bool StreamBuffer::AllocateBuffer()
       nullptr                                // const uint32_t*        pQueueFamilyIndices
   };
 
+  // Uniforms and texel buffers are read by the async compute queue as well.
+  const std::array<u32, 2> queue_family_indices = {g_vulkan_context->GetGraphicsQueueFamilyIndex(),
+                                                   g_vulkan_context->GetComputeQueueFamilyIndex()};
+  if (g_command_buffer_mgr->UsesAsyncCompute() &&
+      (m_usage & (VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT)))
+  {
+    buffer_create_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    buffer_create_info.queueFamilyIndexCount = static_cast<u32>(queue_family_indices.size());
+    buffer_create_info.pQueueFamilyIndices = queue_family_indices.data();
+  }
+
   VkBuffer buffer = VK_NULL_HANDLE;
   VkResult res =
       vkCreateBuffer(g_vulkan_context->GetDevice(), &buffer_create_info, nullptr, &buffer);
@@ -3,8 +3,10 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstring>
+#include <utility>
 
 #include "Common/Align.h"
 #include "Common/Assert.h"
@@ -23,10 +25,10 @@
 
 namespace Vulkan
 {
-VKTexture::VKTexture(const TextureConfig& tex_config, VkDeviceMemory device_memory, VkImage image,
-                     VkImageLayout layout /* = VK_IMAGE_LAYOUT_UNDEFINED */,
+VKTexture::VKTexture(const TextureConfig& tex_config, const MemoryAllocation& allocation,
+                     VkImage image, VkImageLayout layout /* = VK_IMAGE_LAYOUT_UNDEFINED */,
                      ComputeImageLayout compute_layout /* = ComputeImageLayout::Undefined */)
-    : AbstractTexture(tex_config), m_device_memory(device_memory), m_image(image), m_layout(layout),
+    : AbstractTexture(tex_config), m_allocation(allocation), m_image(image), m_layout(layout),
       m_compute_layout(compute_layout)
 {
 }
@@ -37,10 +39,10 @@ VKTexture::~VKTexture()
   g_command_buffer_mgr->DeferImageViewDestruction(m_view);
 
   // If we don't have device memory allocated, the image is not owned by us (e.g. swapchain)
-  if (m_device_memory != VK_NULL_HANDLE)
+  if (m_allocation.memory != VK_NULL_HANDLE)
   {
     g_command_buffer_mgr->DeferImageDestruction(m_image);
-    g_command_buffer_mgr->DeferDeviceMemoryDestruction(m_device_memory);
+    g_command_buffer_mgr->DeferMemoryAllocationDestruction(m_allocation);
   }
 }
 
@@ -73,6 +75,16 @@ std::unique_ptr<VKTexture> VKTexture::Create(const TextureConfig& tex_config)
                                   nullptr,
                                   VK_IMAGE_LAYOUT_UNDEFINED};
 
+  // Compute images can be written by the async compute queue and read by the graphics queue.
+  const std::array<u32, 2> queue_family_indices = {g_vulkan_context->GetGraphicsQueueFamilyIndex(),
+                                                   g_vulkan_context->GetComputeQueueFamilyIndex()};
+  if (tex_config.IsComputeImage() && g_command_buffer_mgr->UsesAsyncCompute())
+  {
+    image_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    image_info.queueFamilyIndexCount = static_cast<u32>(queue_family_indices.size());
+    image_info.pQueueFamilyIndices = queue_family_indices.data();
+  }
+
   VkImage image = VK_NULL_HANDLE;
   VkResult res = vkCreateImage(g_vulkan_context->GetDevice(), &image_info, nullptr, &image);
   if (res != VK_SUCCESS)
@@ -85,33 +97,31 @@ std::unique_ptr<VKTexture> VKTexture::Create(const TextureConfig& tex_config)
   VkMemoryRequirements memory_requirements;
   vkGetImageMemoryRequirements(g_vulkan_context->GetDevice(), image, &memory_requirements);
 
-  VkMemoryAllocateInfo memory_info = {
-      VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, nullptr, memory_requirements.size,
+  const u32 memory_type_index =
       g_vulkan_context
           ->GetMemoryType(memory_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
                           false)
-          .value_or(0)};
-
-  VkDeviceMemory device_memory;
-  res = vkAllocateMemory(g_vulkan_context->GetDevice(), &memory_info, nullptr, &device_memory);
-  if (res != VK_SUCCESS)
+          .value_or(0);
+  std::optional<MemoryAllocation> allocation =
+      g_memory_allocator->Allocate(memory_requirements, memory_type_index, true, false);
+  if (!allocation)
   {
-    LOG_VULKAN_ERROR(res, "vkAllocateMemory failed: ");
     vkDestroyImage(g_vulkan_context->GetDevice(), image, nullptr);
     return nullptr;
   }
 
-  res = vkBindImageMemory(g_vulkan_context->GetDevice(), image, device_memory, 0);
+  res = vkBindImageMemory(g_vulkan_context->GetDevice(), image, allocation->memory,
+                          allocation->offset);
   if (res != VK_SUCCESS)
   {
     LOG_VULKAN_ERROR(res, "vkBindImageMemory failed: ");
     vkDestroyImage(g_vulkan_context->GetDevice(), image, nullptr);
-    vkFreeMemory(g_vulkan_context->GetDevice(), device_memory, nullptr);
+    g_memory_allocator->Free(*allocation);
     return nullptr;
   }
 
   std::unique_ptr<VKTexture> texture = std::make_unique<VKTexture>(
-      tex_config, device_memory, image, VK_IMAGE_LAYOUT_UNDEFINED, ComputeImageLayout::Undefined);
+      tex_config, *allocation, image, VK_IMAGE_LAYOUT_UNDEFINED, ComputeImageLayout::Undefined);
   if (!texture->CreateView(VK_IMAGE_VIEW_TYPE_2D_ARRAY))
     return nullptr;
 
@@ -122,7 +132,7 @@ std::unique_ptr<VKTexture> VKTexture::CreateAdopted(const TextureConfig& tex_con
                                                     VkImageViewType view_type, VkImageLayout layout)
 {
   std::unique_ptr<VKTexture> texture = std::make_unique<VKTexture>(
-      tex_config, VkDeviceMemory(VK_NULL_HANDLE), image, layout, ComputeImageLayout::Undefined);
+      tex_config, MemoryAllocation(), image, layout, ComputeImageLayout::Undefined);
   if (!texture->CreateView(view_type))
     return nullptr;
 
@@ -332,6 +342,27 @@ void VKTexture::Load(u32 level, u32 width, u32 height, u32 row_length, const u8*
   width = std::max(1u, std::min(width, GetWidth() >> level));
   height = std::max(1u, std::min(height, GetHeight() >> level));
 
+  // For unaligned textures, we can save some memory in the transfer buffer by skipping the rows
+  // that lie outside of the texture's dimensions.
+  const u32 upload_alignment = static_cast<u32>(g_vulkan_context->GetBufferImageGranularity());
+  const u32 block_size = GetBlockSizeForFormat(GetFormat());
+  const u32 num_rows = Common::AlignUp(height, block_size) / block_size;
+  const u32 source_pitch = CalculateStrideForFormat(m_config.format, row_length);
+  const u32 upload_size = source_pitch * num_rows;
+
+  // Large textures which haven't been used yet are uploaded on the transfer queue, and so are
+  // the remaining levels of a texture whose upload started there. The copies have to cover whole
+  // levels, as the transfer queue may not support copying smaller regions.
+  if (g_command_buffer_mgr->UsesTransferQueue() && !m_config.IsRenderTarget() &&
+      !m_config.IsComputeImage() && width == std::max(1u, GetWidth() >> level) &&
+      height == std::max(1u, GetHeight() >> level) &&
+      (m_transfer_command_buffer != VK_NULL_HANDLE ||
+       (m_layout == VK_IMAGE_LAYOUT_UNDEFINED && upload_size > STAGING_TEXTURE_UPLOAD_THRESHOLD)))
+  {
+    LoadOnTransferQueue(level, width, height, row_length, buffer, upload_size);
+    return;
+  }
+
   // We don't care about the existing contents of the texture, so we could the image layout to
   // VK_IMAGE_LAYOUT_UNDEFINED here. However, under section 2.2.1, Queue Operation of the Vulkan
   // specification, it states:
@@ -351,13 +382,6 @@ void VKTexture::Load(u32 level, u32 width, u32 height, u32 row_length, const u8*
   TransitionToLayout(g_command_buffer_mgr->GetCurrentInitCommandBuffer(),
                      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-  // For unaligned textures, we can save some memory in the transfer buffer by skipping the rows
-  // that lie outside of the texture's dimensions.
-  const u32 upload_alignment = static_cast<u32>(g_vulkan_context->GetBufferImageGranularity());
-  const u32 block_size = GetBlockSizeForFormat(GetFormat());
-  const u32 num_rows = Common::AlignUp(height, block_size) / block_size;
-  const u32 source_pitch = CalculateStrideForFormat(m_config.format, row_length);
-  const u32 upload_size = source_pitch * num_rows;
   std::unique_ptr<StagingBuffer> temp_buffer;
   VkBuffer upload_buffer;
   VkDeviceSize upload_buffer_offset;
@@ -423,6 +447,88 @@ void VKTexture::Load(u32 level, u32 width, u32 height, u32 row_length, const u8*
   }
 }
 
+void VKTexture::LoadOnTransferQueue(u32 level, u32 width, u32 height, u32 row_length,
+                                    const u8* buffer, u32 upload_size)
+{
+  const VkImageSubresourceRange all_subresources = {GetImageAspectForFormat(GetFormat()), 0,
+                                                    GetLevels(), 0, GetLayers()};
+  if (m_transfer_command_buffer == VK_NULL_HANDLE)
+  {
+    m_transfer_command_buffer = g_command_buffer_mgr->AllocateTransferCommandBuffer();
+
+    // Nothing has used the image yet, so its previous contents can be discarded.
+    const VkImageMemoryBarrier barrier = {
+        VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        nullptr,
+        0,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_QUEUE_FAMILY_IGNORED,
+        VK_QUEUE_FAMILY_IGNORED,
+        m_image,
+        all_subresources};
+    vkCmdPipelineBarrier(m_transfer_command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    m_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  }
+
+  // The stream buffer belongs to the graphics queue, so each level gets a staging buffer.
+  std::unique_ptr<StagingBuffer> temp_buffer = StagingBuffer::Create(
+      STAGING_BUFFER_TYPE_UPLOAD, upload_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+  if (!temp_buffer || !temp_buffer->Map())
+  {
+    PanicAlertFmt("Failed to allocate staging texture for large texture upload.");
+    return;
+  }
+  temp_buffer->Write(0, buffer, upload_size, true);
+  temp_buffer->Unmap();
+
+  const VkBufferImageCopy image_copy = {
+      0, row_length, 0, {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1}, {0, 0, 0}, {width, height, 1}};
+  vkCmdCopyBufferToImage(m_transfer_command_buffer, temp_buffer->GetBuffer(), m_image,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &image_copy);
+  m_transfer_staging_buffers.push_back(std::move(temp_buffer));
+
+  if (level == (m_config.levels - 1))
+    FinishTransferQueueUpload();
+}
+
+void VKTexture::FinishTransferQueueUpload() const
+{
+  // Hand the image over to the graphics queue, transitioning it to shader read only on the way.
+  // The release happens on the transfer queue and the acquire in the init command buffer, which
+  // is ordered after the transfer by a semaphore.
+  VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                                  nullptr,
+                                  VK_ACCESS_TRANSFER_WRITE_BIT,
+                                  0,
+                                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                  VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                  g_vulkan_context->GetTransferQueueFamilyIndex(),
+                                  g_vulkan_context->GetGraphicsQueueFamilyIndex(),
+                                  m_image,
+                                  {GetImageAspectForFormat(GetFormat()), 0, GetLevels(), 0,
+                                   GetLayers()}};
+  vkCmdPipelineBarrier(m_transfer_command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                       &barrier);
+  g_command_buffer_mgr->SubmitTransferCommandBuffer(m_transfer_command_buffer);
+  m_transfer_command_buffer = VK_NULL_HANDLE;
+
+  barrier.srcAccessMask = 0;
+  barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  vkCmdPipelineBarrier(g_command_buffer_mgr->GetCurrentInitCommandBuffer(),
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       0, 0, nullptr, 0, nullptr, 1, &barrier);
+  m_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+  // The buffers are destroyed once the current command buffer completes, which waits for the
+  // transfer.
+  m_transfer_staging_buffers.clear();
+}
+
 void VKTexture::FinishedRendering()
 {
   if (m_layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
@@ -438,8 +544,26 @@ void VKTexture::OverrideImageLayout(VkImageLayout new_layout)
   m_layout = new_layout;
 }
 
+void VKTexture::ExchangeImage(VKTexture* other)
+{
+  ASSERT(m_config == other->m_config && IsAdopted() == other->IsAdopted());
+  if (m_transfer_command_buffer != VK_NULL_HANDLE)
+    FinishTransferQueueUpload();
+  if (other->m_transfer_command_buffer != VK_NULL_HANDLE)
+    other->FinishTransferQueueUpload();
+  std::swap(m_allocation, other->m_allocation);
+  std::swap(m_image, other->m_image);
+  std::swap(m_view, other->m_view);
+  std::swap(m_layout, other->m_layout);
+  std::swap(m_compute_layout, other->m_compute_layout);
+  m_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+  m_compute_layout = ComputeImageLayout::Undefined;
+}
+
 void VKTexture::TransitionToLayout(VkCommandBuffer command_buffer, VkImageLayout new_layout) const
 {
+  if (m_transfer_command_buffer != VK_NULL_HANDLE)
+    FinishTransferQueueUpload();
   if (m_layout == new_layout)
     return;
 
@@ -587,6 +711,8 @@ void VKTexture::TransitionToLayout(VkCommandBuffer command_buffer,
                                    ComputeImageLayout new_layout) const
 {
   ASSERT(new_layout != ComputeImageLayout::Undefined);
+  if (m_transfer_command_buffer != VK_NULL_HANDLE)
+    FinishTransferQueueUpload();
   if (m_compute_layout == new_layout)
     return;
 
@@ -719,16 +845,16 @@ std::unique_ptr<VKStagingTexture> VKStagingTexture::Create(StagingTextureType ty
   }
 
   VkBuffer buffer;
-  VkDeviceMemory memory;
+  MemoryAllocation allocation;
   bool coherent;
-  if (!StagingBuffer::AllocateBuffer(buffer_type, buffer_size, buffer_usage, &buffer, &memory,
+  if (!StagingBuffer::AllocateBuffer(buffer_type, buffer_size, buffer_usage, &buffer, &allocation,
                                      &coherent))
   {
     return nullptr;
   }
 
   std::unique_ptr<StagingBuffer> staging_buffer =
-      std::make_unique<StagingBuffer>(buffer_type, buffer, memory, buffer_size, coherent);
+      std::make_unique<StagingBuffer>(buffer_type, buffer, allocation, buffer_size, coherent);
   std::unique_ptr<VKStagingTexture> staging_tex = std::unique_ptr<VKStagingTexture>(
       new VKStagingTexture(type, config, std::move(staging_buffer)));
 
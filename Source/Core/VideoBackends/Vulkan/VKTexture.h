@@ -5,7 +5,9 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
+#include "VideoBackends/Vulkan/MemoryAllocator.h"
 #include "VideoBackends/Vulkan/VulkanLoader.h"
 #include "VideoCommon/AbstractFramebuffer.h"
 #include "VideoCommon/AbstractStagingTexture.h"
@@ -29,7 +31,7 @@ public:
   };
 
   VKTexture() = delete;
-  VKTexture(const TextureConfig& tex_config, VkDeviceMemory device_memory, VkImage image,
+  VKTexture(const TextureConfig& tex_config, const MemoryAllocation& allocation, VkImage image,
             VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED,
             ComputeImageLayout compute_layout = ComputeImageLayout::Undefined);
   ~VKTexture();
@@ -50,11 +52,11 @@ public:
   void FinishedRendering() override;
 
   VkImage GetImage() const { return m_image; }
-  VkDeviceMemory GetDeviceMemory() const { return m_device_memory; }
+  VkDeviceMemory GetDeviceMemory() const { return m_allocation.memory; }
   VkImageView GetView() const { return m_view; }
   VkImageLayout GetLayout() const { return m_layout; }
   VkFormat GetVkFormat() const { return GetVkFormatForHostTextureFormat(m_config.format); }
-  bool IsAdopted() const { return m_device_memory != VkDeviceMemory(VK_NULL_HANDLE); }
+  bool IsAdopted() const { return m_allocation.memory != VkDeviceMemory(VK_NULL_HANDLE); }
 
   static std::unique_ptr<VKTexture> Create(const TextureConfig& tex_config);
   static std::unique_ptr<VKTexture>
@@ -67,17 +69,31 @@ public:
   // irrelevant and will not be loaded.
   void OverrideImageLayout(VkImageLayout new_layout);
 
+  // Exchanges the images of two textures of the same configuration, so that this texture can be
+  // written to while the GPU may still be using its previous image. The contents of the image
+  // this texture receives are treated as undefined.
+  void ExchangeImage(VKTexture* other);
+
   void TransitionToLayout(VkCommandBuffer command_buffer, VkImageLayout new_layout) const;
   void TransitionToLayout(VkCommandBuffer command_buffer, ComputeImageLayout new_layout) const;
 
 private:
   bool CreateView(VkImageViewType type);
 
-  VkDeviceMemory m_device_memory;
+  void LoadOnTransferQueue(u32 level, u32 width, u32 height, u32 row_length, const u8* buffer,
+                           u32 upload_size);
+  void FinishTransferQueueUpload() const;
+
+  MemoryAllocation m_allocation;
   VkImage m_image;
   VkImageView m_view = VK_NULL_HANDLE;
   mutable VkImageLayout m_layout = VK_IMAGE_LAYOUT_UNDEFINED;
   mutable ComputeImageLayout m_compute_layout = ComputeImageLayout::Undefined;
+
+  // While the texture's levels are being uploaded on the transfer queue, the command buffer the
+  // copies are recorded to, and the buffers they copy from.
+  mutable VkCommandBuffer m_transfer_command_buffer = VK_NULL_HANDLE;
+  mutable std::vector<std::unique_ptr<StagingBuffer>> m_transfer_staging_buffers;
 };
 
 class VKStagingTexture final : public AbstractStagingTexture
@@ -580,6 +580,33 @@ bool VulkanContext::CreateDevice(VkSurfaceKHR surface, bool enable_validation_la
     return false;
   }
 
+  // Look for a dedicated compute queue family, which is usually backed by separate hardware.
+  m_compute_queue_family_index = queue_family_count;
+  for (uint32_t i = 0; i < queue_family_count; i++)
+  {
+    const VkQueueFlags flags = queue_family_properties[i].queueFlags;
+    if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT) &&
+        queue_family_properties[i].queueCount > 0 && i != m_present_queue_family_index)
+    {
+      m_compute_queue_family_index = i;
+      break;
+    }
+  }
+
+  // Likewise for a transfer-only queue family, which is usually backed by a DMA engine.
+  m_transfer_queue_family_index = queue_family_count;
+  for (uint32_t i = 0; i < queue_family_count; i++)
+  {
+    const VkQueueFlags flags = queue_family_properties[i].queueFlags;
+    if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT) &&
+        !(flags & VK_QUEUE_COMPUTE_BIT) && queue_family_properties[i].queueCount > 0 &&
+        i != m_present_queue_family_index)
+    {
+      m_transfer_queue_family_index = i;
+      break;
+    }
+  }
+
   VkDeviceCreateInfo device_info = {};
   device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
   device_info.pNext = nullptr;
@@ -602,7 +629,7 @@ bool VulkanContext::CreateDevice(VkSurfaceKHR surface, bool enable_validation_la
   present_queue_info.queueCount = 1;
   present_queue_info.pQueuePriorities = queue_priorities;
 
-  std::array<VkDeviceQueueCreateInfo, 2> queue_infos = {{
+  std::array<VkDeviceQueueCreateInfo, 4> queue_infos = {{
       graphics_queue_info,
       present_queue_info,
   }};
@@ -612,6 +639,18 @@ bool VulkanContext::CreateDevice(VkSurfaceKHR surface, bool enable_validation_la
   {
     device_info.queueCreateInfoCount = 2;
   }
+  if (m_compute_queue_family_index != queue_family_count)
+  {
+    VkDeviceQueueCreateInfo& compute_queue_info = queue_infos[device_info.queueCreateInfoCount++];
+    compute_queue_info = graphics_queue_info;
+    compute_queue_info.queueFamilyIndex = m_compute_queue_family_index;
+  }
+  if (m_transfer_queue_family_index != queue_family_count)
+  {
+    VkDeviceQueueCreateInfo& transfer_queue_info = queue_infos[device_info.queueCreateInfoCount++];
+    transfer_queue_info = graphics_queue_info;
+    transfer_queue_info.queueFamilyIndex = m_transfer_queue_family_index;
+  }
   device_info.pQueueCreateInfos = queue_infos.data();
 
   if (!SelectDeviceExtensions(surface != VK_NULL_HANDLE))
@@ -658,6 +697,16 @@ bool VulkanContext::CreateDevice(VkSurfaceKHR surface, bool enable_validation_la
   {
     vkGetDeviceQueue(m_device, m_present_queue_family_index, 0, &m_present_queue);
   }
+  if (m_compute_queue_family_index != queue_family_count)
+  {
+    vkGetDeviceQueue(m_device, m_compute_queue_family_index, 0, &m_compute_queue);
+    INFO_LOG_FMT(VIDEO, "Using queue family {} for async compute", m_compute_queue_family_index);
+  }
+  if (m_transfer_queue_family_index != queue_family_count)
+  {
+    vkGetDeviceQueue(m_device, m_transfer_queue_family_index, 0, &m_transfer_queue);
+    INFO_LOG_FMT(VIDEO, "Using queue family {} for texture uploads", m_transfer_queue_family_index);
+  }
   return true;
 }
 
@@ -62,6 +62,15 @@ public:
   u32 GetGraphicsQueueFamilyIndex() const { return m_graphics_queue_family_index; }
   VkQueue GetPresentQueue() const { return m_present_queue; }
   u32 GetPresentQueueFamilyIndex() const { return m_present_queue_family_index; }
+  // Queue of a family which supports compute but not graphics, if the device has one. Work
+  // submitted to it can run concurrently with the graphics queue.
+  bool HasAsyncComputeQueue() const { return m_compute_queue != VK_NULL_HANDLE; }
+  VkQueue GetComputeQueue() const { return m_compute_queue; }
+  u32 GetComputeQueueFamilyIndex() const { return m_compute_queue_family_index; }
+  // Queue of a family which only supports transfers, if the device has one.
+  bool HasTransferQueue() const { return m_transfer_queue != VK_NULL_HANDLE; }
+  VkQueue GetTransferQueue() const { return m_transfer_queue; }
+  u32 GetTransferQueueFamilyIndex() const { return m_transfer_queue_family_index; }
   const VkQueueFamilyProperties& GetGraphicsQueueProperties() const
   {
     return m_graphics_queue_properties;
@@ -137,6 +146,10 @@ private:
   u32 m_graphics_queue_family_index = 0;
   VkQueue m_present_queue = VK_NULL_HANDLE;
   u32 m_present_queue_family_index = 0;
+  VkQueue m_compute_queue = VK_NULL_HANDLE;
+  u32 m_compute_queue_family_index = 0;
+  VkQueue m_transfer_queue = VK_NULL_HANDLE;
+  u32 m_transfer_queue_family_index = 0;
   VkQueueFamilyProperties m_graphics_queue_properties = {};
 
   VkDebugReportCallbackEXT m_debug_report_callback = VK_NULL_HANDLE;
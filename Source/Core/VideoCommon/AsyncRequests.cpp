@@ -151,7 +151,7 @@ void AsyncRequests::HandleEvent(const AsyncRequests::Event& e)
 
   case Event::SWAP_EVENT:
     g_renderer->Swap(e.swap_event.xfbAddr, e.swap_event.fbWidth, e.swap_event.fbStride,
-                     e.swap_event.fbHeight, e.time);
+                     e.swap_event.fbHeight, e.time, e.swap_event.present);
     break;
 
   case Event::BBOX_READ:
@@ -55,6 +55,7 @@ public:
         u32 fbWidth;
         u32 fbStride;
         u32 fbHeight;
+        bool present;
       } swap_event;
 
       struct
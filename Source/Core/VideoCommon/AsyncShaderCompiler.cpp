@@ -21,20 +21,48 @@ AsyncShaderCompiler::~AsyncShaderCompiler()
   ASSERT(!HasWorkerThreads());
 }
 
-void AsyncShaderCompiler::QueueWorkItem(WorkItemPtr item, u32 priority)
+AsyncShaderCompiler::WorkItemID AsyncShaderCompiler::QueueWorkItem(WorkItemPtr item, u32 priority)
 {
   // If no worker threads are available, compile synchronously.
   if (!HasWorkerThreads())
   {
     item->Compile();
     m_completed_work.push_back(std::move(item));
+    return INVALID_WORK_ITEM_ID;
   }
-  else
+
+  std::lock_guard<std::mutex> guard(m_pending_work_lock);
+  const WorkItemID id = m_next_work_item_id++;
+  auto iter = m_pending_work.emplace(priority, std::make_pair(id, std::move(item)));
+  m_pending_work_ids.emplace(id, iter);
+  m_worker_thread_wake.notify_one();
+  return id;
+}
+
+bool AsyncShaderCompiler::BumpWorkItemPriority(WorkItemID id, u32 priority)
+{
+  std::lock_guard<std::mutex> guard(m_pending_work_lock);
+  auto id_iter = m_pending_work_ids.find(id);
+  if (id_iter == m_pending_work_ids.end())
+    return false;
+
+  if (id_iter->second->first > priority)
   {
-    std::lock_guard<std::mutex> guard(m_pending_work_lock);
-    m_pending_work.emplace(priority, std::move(item));
-    m_worker_thread_wake.notify_one();
+    // Re-inserting behind the items of the same priority keeps them in the order they were
+    // queued or bumped in.
+    auto node = m_pending_work.extract(id_iter->second);
+    node.key() = priority;
+    id_iter->second = m_pending_work.insert(std::move(node));
   }
+
+  return true;
+}
+
+void AsyncShaderCompiler::CancelPendingWork()
+{
+  std::lock_guard<std::mutex> guard(m_pending_work_lock);
+  m_pending_work.clear();
+  m_pending_work_ids.clear();
 }
 
 void AsyncShaderCompiler::RetrieveWorkItems()
@@ -217,13 +245,16 @@ void AsyncShaderCompiler::WorkerThreadRun()
   std::unique_lock<std::mutex> pending_lock(m_pending_work_lock);
   while (!m_exit_flag.IsSet())
   {
-    m_worker_thread_wake.wait(pending_lock);
+    // Items queued before this thread started waiting don't wake it, so check for them first.
+    m_worker_thread_wake.wait(pending_lock,
+                              [&] { return !m_pending_work.empty() || m_exit_flag.IsSet(); });
 
     while (!m_pending_work.empty() && !m_exit_flag.IsSet())
     {
       m_busy_workers++;
       auto iter = m_pending_work.begin();
-      WorkItemPtr item(std::move(iter->second));
+      WorkItemPtr item(std::move(iter->second.second));
+      m_pending_work_ids.erase(iter->second.first);
       m_pending_work.erase(iter);
       pending_lock.unlock();
 
@@ -12,6 +12,7 @@
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -34,6 +35,10 @@ public:
 
   using WorkItemPtr = std::unique_ptr<WorkItem>;
 
+  // Identifies a queued work item, so that it can be moved forward while it's waiting.
+  using WorkItemID = u64;
+  static constexpr WorkItemID INVALID_WORK_ITEM_ID = 0;
+
   AsyncShaderCompiler();
   virtual ~AsyncShaderCompiler();
 
@@ -45,7 +50,15 @@ public:
 
   // Queues a new work item to the compiler threads. The lower the priority, the sooner
   // this work item will be compiled, relative to the other work items.
-  void QueueWorkItem(WorkItemPtr item, u32 priority);
+  WorkItemID QueueWorkItem(WorkItemPtr item, u32 priority);
+
+  // Lowers the priority of a work item which hasn't been started yet, e.g. because its result is
+  // needed earlier than expected. Returns false if the item is no longer queued.
+  bool BumpWorkItemPriority(WorkItemID id, u32 priority);
+
+  // Drops all work items which haven't been started yet, without compiling or retrieving them.
+  // Items which are being compiled are still completed.
+  void CancelPendingWork();
   void RetrieveWorkItems();
   bool HasPendingWork();
   bool HasCompletedWork();
@@ -78,8 +91,12 @@ private:
   std::atomic_bool m_worker_thread_start_result{false};
 
   // A multimap is used to store the work items. We can't use a priority_queue here, because
-  // there's no way to obtain a non-const reference, which we need for the unique_ptr.
-  std::multimap<u32, WorkItemPtr> m_pending_work;
+  // there's no way to obtain a non-const reference, which we need for the unique_ptr. It also
+  // lets us re-key items when their priority changes, through m_pending_work_ids.
+  using PendingWorkMap = std::multimap<u32, std::pair<WorkItemID, WorkItemPtr>>;
+  PendingWorkMap m_pending_work;
+  std::unordered_map<WorkItemID, PendingWorkMap::iterator> m_pending_work_ids;
+  WorkItemID m_next_work_item_id = INVALID_WORK_ITEM_ID + 1;
   std::mutex m_pending_work_lock;
   std::condition_variable m_worker_thread_wake;
   std::atomic_size_t m_busy_workers{0};
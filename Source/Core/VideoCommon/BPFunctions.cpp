@@ -37,7 +37,7 @@ void SetGenerationMode()
   g_vertex_manager->SetRasterizationStateChanged();
 }
 
-void SetScissor()
+MathUtil::Rectangle<int> GetNativeScissorRect()
 {
   /* NOTE: the minimum value here for the scissor rect and offset is -342.
    * GX internally adds on an offset of 342 to both the offset and scissor
@@ -56,8 +56,12 @@ void SetScissor()
   MathUtil::Rectangle<int> native_rc(bpmem.scissorTL.x - xoff, bpmem.scissorTL.y - yoff,
                                      bpmem.scissorBR.x - xoff + 1, bpmem.scissorBR.y - yoff + 1);
   native_rc.ClampUL(0, 0, EFB_WIDTH, EFB_HEIGHT);
+  return native_rc;
+}
 
-  auto target_rc = g_renderer->ConvertEFBRectangle(native_rc);
+void SetScissor()
+{
+  auto target_rc = g_renderer->ConvertEFBRectangle(GetNativeScissorRect());
   auto converted_rc =
       g_renderer->ConvertFramebufferRectangle(target_rc, g_renderer->GetCurrentFramebuffer());
   g_renderer->SetScissorRect(converted_rc);
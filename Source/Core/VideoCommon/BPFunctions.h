@@ -16,6 +16,7 @@ namespace BPFunctions
 {
 void FlushPipeline();
 void SetGenerationMode();
+MathUtil::Rectangle<int> GetNativeScissorRect();
 void SetScissor();
 void SetViewport();
 void SetDepthMode();
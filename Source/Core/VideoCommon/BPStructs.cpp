@@ -4,15 +4,18 @@
 
 #include "VideoCommon/BPStructs.h"
 
+#include <array>
 #include <cmath>
 #include <cstring>
 #include <string>
+#include <string_view>
 
 #include <fmt/format.h>
 
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Core/ConfigManager.h"
+#include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/FifoPlayer/FifoPlayer.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
@@ -47,675 +50,637 @@ void BPInit()
   bpmem.bpMask = 0xFFFFFF;
 }
 
-static void BPWritten(const BPCmd& bp)
+// Handlers for writes to the BP registers, called with bpmem already holding the new value.
+// Some of them check bp.changes, as they only have to do something if certain bits changed.
+
+static void BPWriteGenMode(const BPCmd& bp)
 {
-  /*
-  ----------------------------------------------------------------------------------------------------------------
-  Purpose: Writes to the BP registers
-  Called: At the end of every: OpcodeDecoding.cpp ExecuteDisplayList > Decode() > LoadBPReg
-  How It Works: First the pipeline is flushed then update the bpmem with the new value.
-          Some of the BP cases have to call certain functions while others just update the bpmem.
-          some bp cases check the changes variable, because they might not have to be updated all
-  the time
-  NOTE: it seems not all bp cases like checking changes, so calling if (bp.changes == 0 ? false :
-  true)
-      had to be ditched and the games seem to work fine with out it.
-  NOTE2: Yet Another GameCube Documentation calls them Bypass Raster State Registers but possibly
-  completely wrong
-  NOTE3: This controls the register groups: RAS1/2, SU, TF, TEV, C/Z, PEC
-  TODO: Turn into function table. The (future) DisplayList (DL) jit can then call the functions
-  directly,
-      getting rid of dynamic dispatch. Unfortunately, few games use DLs properly - most\
-      just stuff geometry in them and don't put state changes there
-  ----------------------------------------------------------------------------------------------------------------
-  */
+  PRIM_LOG("genmode: texgen={}, col={}, multisampling={}, tev={}, cullmode={}, ind={}, zfeeze={}",
+           bpmem.genMode.numtexgens.Value(), bpmem.genMode.numcolchans.Value(),
+           bpmem.genMode.multisampling.Value(), bpmem.genMode.numtevstages.Value() + 1,
+           static_cast<u32>(bpmem.genMode.cullmode), bpmem.genMode.numindstages.Value(),
+           bpmem.genMode.zfreeze.Value());
+
+  if (bp.changes)
+    PixelShaderManager::SetGenModeChanged();
+
+  // Only call SetGenerationMode when cull mode changes.
+  if (bp.changes & 0xC000)
+    SetGenerationMode();
+}
 
-  if (((s32*)&bpmem)[bp.address] == bp.newvalue)
-  {
-    if (!(bp.address == BPMEM_TRIGGER_EFB_COPY || bp.address == BPMEM_CLEARBBOX1 ||
-          bp.address == BPMEM_CLEARBBOX2 || bp.address == BPMEM_SETDRAWDONE ||
-          bp.address == BPMEM_PE_TOKEN_ID || bp.address == BPMEM_PE_TOKEN_INT_ID ||
-          bp.address == BPMEM_LOADTLUT0 || bp.address == BPMEM_LOADTLUT1 ||
-          bp.address == BPMEM_TEXINVALIDATE || bp.address == BPMEM_PRELOAD_MODE ||
-          bp.address == BPMEM_CLEAR_PIXEL_PERF))
-    {
-      return;
-    }
-  }
+static void BPWriteIndMatrix(const BPCmd& bp)
+{
+  if (bp.changes)
+    PixelShaderManager::SetIndMatrixChanged((bp.address - BPMEM_IND_MTXA) / 3);
+}
+
+static void BPWriteIndTexScale(const BPCmd& bp)
+{
+  if (bp.changes)
+    PixelShaderManager::SetIndTexScaleChanged(bp.address == BPMEM_RAS1_SS1);
+}
 
-  FlushPipeline();
+static void BPWriteScissor(const BPCmd&)
+{
+  SetScissor();
+  SetViewport();
+  VertexShaderManager::SetViewportChanged();
+  GeometryShaderManager::SetViewportChanged();
+}
 
-  ((u32*)&bpmem)[bp.address] = bp.newvalue;
+static void BPWriteLinePtWidth(const BPCmd&)
+{
+  GeometryShaderManager::SetLinePtWidthChanged();
+}
+
+static void BPWriteZMode(const BPCmd&)
+{
+  PRIM_LOG("zmode: test={}, func={}, upd={}", bpmem.zmode.testenable.Value(),
+           bpmem.zmode.func.Value(), bpmem.zmode.updateenable.Value());
+  SetDepthMode();
+  PixelShaderManager::SetZModeControl();
+}
 
-  switch (bp.address)
+static void BPWriteBlendMode(const BPCmd& bp)
+{
+  if (bp.changes & 0xFFFF)
   {
-  case BPMEM_GENMODE:  // Set the Generation Mode
-    PRIM_LOG("genmode: texgen={}, col={}, multisampling={}, tev={}, cullmode={}, ind={}, zfeeze={}",
-             bpmem.genMode.numtexgens.Value(), bpmem.genMode.numcolchans.Value(),
-             bpmem.genMode.multisampling.Value(), bpmem.genMode.numtevstages.Value() + 1,
-             static_cast<u32>(bpmem.genMode.cullmode), bpmem.genMode.numindstages.Value(),
-             bpmem.genMode.zfreeze.Value());
-
-    if (bp.changes)
-      PixelShaderManager::SetGenModeChanged();
-
-    // Only call SetGenerationMode when cull mode changes.
-    if (bp.changes & 0xC000)
-      SetGenerationMode();
-    return;
-  case BPMEM_IND_MTXA:  // Index Matrix Changed
-  case BPMEM_IND_MTXB:
-  case BPMEM_IND_MTXC:
-  case BPMEM_IND_MTXA + 3:
-  case BPMEM_IND_MTXB + 3:
-  case BPMEM_IND_MTXC + 3:
-  case BPMEM_IND_MTXA + 6:
-  case BPMEM_IND_MTXB + 6:
-  case BPMEM_IND_MTXC + 6:
-    if (bp.changes)
-      PixelShaderManager::SetIndMatrixChanged((bp.address - BPMEM_IND_MTXA) / 3);
-    return;
-  case BPMEM_RAS1_SS0:  // Index Texture Coordinate Scale 0
-    if (bp.changes)
-      PixelShaderManager::SetIndTexScaleChanged(false);
-    return;
-  case BPMEM_RAS1_SS1:  // Index Texture Coordinate Scale 1
-    if (bp.changes)
-      PixelShaderManager::SetIndTexScaleChanged(true);
-    return;
-  // ----------------
-  // Scissor Control
-  // ----------------
-  case BPMEM_SCISSORTL:      // Scissor Rectable Top, Left
-  case BPMEM_SCISSORBR:      // Scissor Rectable Bottom, Right
-  case BPMEM_SCISSOROFFSET:  // Scissor Offset
-    SetScissor();
-    SetViewport();
-    VertexShaderManager::SetViewportChanged();
-    GeometryShaderManager::SetViewportChanged();
-    return;
-  case BPMEM_LINEPTWIDTH:  // Line Width
-    GeometryShaderManager::SetLinePtWidthChanged();
-    return;
-  case BPMEM_ZMODE:  // Depth Control
-    PRIM_LOG("zmode: test={}, func={}, upd={}", bpmem.zmode.testenable.Value(),
-             bpmem.zmode.func.Value(), bpmem.zmode.updateenable.Value());
-    SetDepthMode();
-    PixelShaderManager::SetZModeControl();
-    return;
-  case BPMEM_BLENDMODE:  // Blending Control
-    if (bp.changes & 0xFFFF)
-    {
-      PRIM_LOG("blendmode: en={}, open={}, colupd={}, alphaupd={}, dst={}, src={}, sub={}, mode={}",
-               bpmem.blendmode.blendenable.Value(), bpmem.blendmode.logicopenable.Value(),
-               bpmem.blendmode.colorupdate.Value(), bpmem.blendmode.alphaupdate.Value(),
-               bpmem.blendmode.dstfactor.Value(), bpmem.blendmode.srcfactor.Value(),
-               bpmem.blendmode.subtract.Value(), bpmem.blendmode.logicmode.Value());
+    PRIM_LOG("blendmode: en={}, open={}, colupd={}, alphaupd={}, dst={}, src={}, sub={}, mode={}",
+             bpmem.blendmode.blendenable.Value(), bpmem.blendmode.logicopenable.Value(),
+             bpmem.blendmode.colorupdate.Value(), bpmem.blendmode.alphaupdate.Value(),
+             bpmem.blendmode.dstfactor.Value(), bpmem.blendmode.srcfactor.Value(),
+             bpmem.blendmode.subtract.Value(), bpmem.blendmode.logicmode.Value());
 
-      SetBlendMode();
+    SetBlendMode();
 
-      PixelShaderManager::SetBlendModeChanged();
-    }
-    return;
-  case BPMEM_CONSTANTALPHA:  // Set Destination Alpha
-    PRIM_LOG("constalpha: alp={}, en={}", bpmem.dstalpha.alpha.Value(),
-             bpmem.dstalpha.enable.Value());
-    if (bp.changes)
-    {
-      PixelShaderManager::SetAlpha();
-      PixelShaderManager::SetDestAlphaChanged();
-    }
-    if (bp.changes & 0x100)
-      SetBlendMode();
-    return;
+    PixelShaderManager::SetBlendModeChanged();
+  }
+}
 
-  // This is called when the game is done drawing the new frame (eg: like in DX: Begin(); Draw();
-  // End();)
-  // Triggers an interrupt on the PPC side so that the game knows when the GPU has finished drawing.
-  // Tokens are similar.
-  case BPMEM_SETDRAWDONE:
-    switch (bp.newvalue & 0xFF)
-    {
-    case 0x02:
-      g_texture_cache->FlushEFBCopies();
-      g_framebuffer_manager->InvalidatePeekCache(false);
-      if (!Fifo::UseDeterministicGPUThread())
-        PixelEngine::SetFinish();  // may generate interrupt
-      DEBUG_LOG_FMT(VIDEO, "GXSetDrawDone SetPEFinish (value: {:#04X})", bp.newvalue & 0xFFFF);
-      return;
-
-    default:
-      WARN_LOG_FMT(VIDEO, "GXSetDrawDone ??? (value {:#04X})", bp.newvalue & 0xFFFF);
-      return;
-    }
-    return;
-  case BPMEM_PE_TOKEN_ID:  // Pixel Engine Token ID
+static void BPWriteConstantAlpha(const BPCmd& bp)
+{
+  PRIM_LOG("constalpha: alp={}, en={}", bpmem.dstalpha.alpha.Value(),
+           bpmem.dstalpha.enable.Value());
+  if (bp.changes)
+  {
+    PixelShaderManager::SetAlpha();
+    PixelShaderManager::SetDestAlphaChanged();
+  }
+  if (bp.changes & 0x100)
+    SetBlendMode();
+}
+
+// This is called when the game is done drawing the new frame (eg: like in DX: Begin(); Draw();
+// End();)
+// Triggers an interrupt on the PPC side so that the game knows when the GPU has finished drawing.
+// Tokens are similar.
+static void BPWriteSetDrawDone(const BPCmd& bp)
+{
+  switch (bp.newvalue & 0xFF)
+  {
+  case 0x02:
     g_texture_cache->FlushEFBCopies();
     g_framebuffer_manager->InvalidatePeekCache(false);
     if (!Fifo::UseDeterministicGPUThread())
-      PixelEngine::SetToken(static_cast<u16>(bp.newvalue & 0xFFFF), false);
-    DEBUG_LOG_FMT(VIDEO, "SetPEToken {:#06X}", bp.newvalue & 0xFFFF);
+      PixelEngine::SetFinish();  // may generate interrupt
+    DEBUG_LOG_FMT(VIDEO, "GXSetDrawDone SetPEFinish (value: {:#04X})", bp.newvalue & 0xFFFF);
     return;
-  case BPMEM_PE_TOKEN_INT_ID:  // Pixel Engine Interrupt Token ID
-    g_texture_cache->FlushEFBCopies();
-    g_framebuffer_manager->InvalidatePeekCache(false);
-    if (!Fifo::UseDeterministicGPUThread())
-      PixelEngine::SetToken(static_cast<u16>(bp.newvalue & 0xFFFF), true);
-    DEBUG_LOG_FMT(VIDEO, "SetPEToken + INT {:#06X}", bp.newvalue & 0xFFFF);
+
+  default:
+    WARN_LOG_FMT(VIDEO, "GXSetDrawDone ??? (value {:#04X})", bp.newvalue & 0xFFFF);
     return;
+  }
+}
 
-  // ------------------------
-  // EFB copy command. This copies a rectangle from the EFB to either RAM in a texture format or to
-  // XFB as YUYV.
-  // It can also optionally clear the EFB while copying from it. To emulate this, we of course copy
-  // first and clear afterwards.
-  case BPMEM_TRIGGER_EFB_COPY:  // Copy EFB Region or Render to the XFB or Clear the screen.
-  {
-    // The bottom right is within the rectangle
-    // The values in bpmem.copyTexSrcXY and bpmem.copyTexSrcWH are updated in case 0x49 and 0x4a in
-    // this function
-
-    u32 destAddr = bpmem.copyTexDest << 5;
-    u32 destStride = bpmem.copyMipMapStrideChannels << 5;
-
-    MathUtil::Rectangle<int> srcRect;
-    srcRect.left = static_cast<int>(bpmem.copyTexSrcXY.x);
-    srcRect.top = static_cast<int>(bpmem.copyTexSrcXY.y);
-
-    // Here Width+1 like Height, otherwise some textures are corrupted already since the native
-    // resolution.
-    srcRect.right = static_cast<int>(bpmem.copyTexSrcXY.x + bpmem.copyTexSrcWH.x + 1);
-    srcRect.bottom = static_cast<int>(bpmem.copyTexSrcXY.y + bpmem.copyTexSrcWH.y + 1);
-
-    // Since the copy X and Y coordinates/sizes are 10-bit, the game can configure a copy region up
-    // to 1024x1024. Hardware tests have found that the number of bytes written does not depend on
-    // the configured stride, instead it is based on the size registers, writing beyond the length
-    // of a single row. The data written for the pixels which lie outside the EFB bounds does not
-    // wrap around instead returning different colors based on the pixel format of the EFB. This
-    // suggests it's not based on coordinates, but instead on memory addresses. The effect of a
-    // within-bounds size but out-of-bounds offset (e.g. offset 320,0, size 640,480) are the same.
-
-    // As it would be difficult to emulate the exact behavior of out-of-bounds reads, instead of
-    // writing the junk data, we don't write anything to RAM at all for over-sized copies, and clamp
-    // to the EFB borders for over-offset copies. The arcade virtual console games (e.g. 1942) are
-    // known for configuring these out-of-range copies.
-    int copy_width = srcRect.GetWidth();
-    int copy_height = srcRect.GetHeight();
-    if (srcRect.right > s32(EFB_WIDTH) || srcRect.bottom > s32(EFB_HEIGHT))
-    {
-      WARN_LOG_FMT(VIDEO, "Oversized EFB copy: {}x{} (offset {},{} stride {})", copy_width,
-                   copy_height, srcRect.left, srcRect.top, destStride);
+static void BPWritePETokenID(const BPCmd& bp)
+{
+  g_texture_cache->FlushEFBCopies();
+  g_framebuffer_manager->InvalidatePeekCache(false);
+  if (!Fifo::UseDeterministicGPUThread())
+    PixelEngine::SetToken(static_cast<u16>(bp.newvalue & 0xFFFF), false);
+  DEBUG_LOG_FMT(VIDEO, "SetPEToken {:#06X}", bp.newvalue & 0xFFFF);
+}
 
-      // Adjust the copy size to fit within the EFB. So that we don't end up with a stretched image,
-      // instead of clamping the source rectangle, we reduce it by the over-sized amount.
-      if (copy_width > s32(EFB_WIDTH))
-      {
-        srcRect.right -= copy_width - EFB_WIDTH;
-        copy_width = EFB_WIDTH;
-      }
-      if (copy_height > s32(EFB_HEIGHT))
-      {
-        srcRect.bottom -= copy_height - EFB_HEIGHT;
-        copy_height = EFB_HEIGHT;
-      }
-    }
+static void BPWritePETokenIntID(const BPCmd& bp)
+{
+  g_texture_cache->FlushEFBCopies();
+  g_framebuffer_manager->InvalidatePeekCache(false);
+  if (!Fifo::UseDeterministicGPUThread())
+    PixelEngine::SetToken(static_cast<u16>(bp.newvalue & 0xFFFF), true);
+  DEBUG_LOG_FMT(VIDEO, "SetPEToken + INT {:#06X}", bp.newvalue & 0xFFFF);
+}
+
+// EFB copy command. This copies a rectangle from the EFB to either RAM in a texture format or to
+// XFB as YUYV.
+// It can also optionally clear the EFB while copying from it. To emulate this, we of course copy
+// first and clear afterwards.
+static void BPWriteTriggerEFBCopy(const BPCmd& bp)
+{
+  // The bottom right is within the rectangle
+  // The values in bpmem.copyTexSrcXY and bpmem.copyTexSrcWH are updated in case 0x49 and 0x4a in
+  // this function
+
+  u32 destAddr = bpmem.copyTexDest << 5;
+  u32 destStride = bpmem.copyMipMapStrideChannels << 5;
+
+  MathUtil::Rectangle<int> srcRect;
+  srcRect.left = static_cast<int>(bpmem.copyTexSrcXY.x);
+  srcRect.top = static_cast<int>(bpmem.copyTexSrcXY.y);
+
+  // Here Width+1 like Height, otherwise some textures are corrupted already since the native
+  // resolution.
+  srcRect.right = static_cast<int>(bpmem.copyTexSrcXY.x + bpmem.copyTexSrcWH.x + 1);
+  srcRect.bottom = static_cast<int>(bpmem.copyTexSrcXY.y + bpmem.copyTexSrcWH.y + 1);
+
+  // Since the copy X and Y coordinates/sizes are 10-bit, the game can configure a copy region up
+  // to 1024x1024. Hardware tests have found that the number of bytes written does not depend on
+  // the configured stride, instead it is based on the size registers, writing beyond the length
+  // of a single row. The data written for the pixels which lie outside the EFB bounds does not
+  // wrap around instead returning different colors based on the pixel format of the EFB. This
+  // suggests it's not based on coordinates, but instead on memory addresses. The effect of a
+  // within-bounds size but out-of-bounds offset (e.g. offset 320,0, size 640,480) are the same.
+
+  // As it would be difficult to emulate the exact behavior of out-of-bounds reads, instead of
+  // writing the junk data, we don't write anything to RAM at all for over-sized copies, and clamp
+  // to the EFB borders for over-offset copies. The arcade virtual console games (e.g. 1942) are
+  // known for configuring these out-of-range copies.
+  int copy_width = srcRect.GetWidth();
+  int copy_height = srcRect.GetHeight();
+  if (srcRect.right > s32(EFB_WIDTH) || srcRect.bottom > s32(EFB_HEIGHT))
+  {
+    WARN_LOG_FMT(VIDEO, "Oversized EFB copy: {}x{} (offset {},{} stride {})", copy_width,
+                 copy_height, srcRect.left, srcRect.top, destStride);
 
-    // Check if we are to copy from the EFB or draw to the XFB
-    const UPE_Copy PE_copy = bpmem.triggerEFBCopy;
-    if (PE_copy.copy_to_xfb == 0)
+    // Adjust the copy size to fit within the EFB. So that we don't end up with a stretched image,
+    // instead of clamping the source rectangle, we reduce it by the over-sized amount.
+    if (copy_width > s32(EFB_WIDTH))
     {
-      // bpmem.zcontrol.pixel_format to PEControl::Z24 is when the game wants to copy from ZBuffer
-      // (Zbuffer uses 24-bit Format)
-      static constexpr CopyFilterCoefficients::Values filter_coefficients = {
-          {0, 0, 21, 22, 21, 0, 0}};
-      bool is_depth_copy = bpmem.zcontrol.pixel_format == PEControl::Z24;
-      g_texture_cache->CopyRenderTargetToTexture(
-          destAddr, PE_copy.tp_realFormat(), copy_width, copy_height, destStride, is_depth_copy,
-          srcRect, !!PE_copy.intensity_fmt, !!PE_copy.half_scale, 1.0f, 1.0f,
-          bpmem.triggerEFBCopy.clamp_top, bpmem.triggerEFBCopy.clamp_bottom, filter_coefficients);
+      srcRect.right -= copy_width - EFB_WIDTH;
+      copy_width = EFB_WIDTH;
     }
-    else
+    if (copy_height > s32(EFB_HEIGHT))
     {
-      // We should be able to get away with deactivating the current bbox tracking
-      // here. Not sure if there's a better spot to put this.
-      // the number of lines copied is determined by the y scale * source efb height
-      BoundingBox::Disable();
+      srcRect.bottom -= copy_height - EFB_HEIGHT;
+      copy_height = EFB_HEIGHT;
+    }
+  }
 
-      float yScale;
-      if (PE_copy.scale_invert)
-        yScale = 256.0f / static_cast<float>(bpmem.dispcopyyscale);
-      else
-        yScale = static_cast<float>(bpmem.dispcopyyscale) / 256.0f;
+  // Check if we are to copy from the EFB or draw to the XFB
+  const UPE_Copy PE_copy = bpmem.triggerEFBCopy;
+  if (PE_copy.copy_to_xfb == 0)
+  {
+    // bpmem.zcontrol.pixel_format to PEControl::Z24 is when the game wants to copy from ZBuffer
+    // (Zbuffer uses 24-bit Format)
+    static constexpr CopyFilterCoefficients::Values filter_coefficients = {
+        {0, 0, 21, 22, 21, 0, 0}};
+    bool is_depth_copy = bpmem.zcontrol.pixel_format == PEControl::Z24;
+    g_texture_cache->CopyRenderTargetToTexture(
+        destAddr, PE_copy.tp_realFormat(), copy_width, copy_height, destStride, is_depth_copy,
+        srcRect, !!PE_copy.intensity_fmt, !!PE_copy.half_scale, 1.0f, 1.0f,
+        bpmem.triggerEFBCopy.clamp_top, bpmem.triggerEFBCopy.clamp_bottom, filter_coefficients);
+  }
+  else
+  {
+    // We should be able to get away with deactivating the current bbox tracking
+    // here. Not sure if there's a better spot to put this.
+    // the number of lines copied is determined by the y scale * source efb height
+    BoundingBox::Disable();
+
+    float yScale;
+    if (PE_copy.scale_invert)
+      yScale = 256.0f / static_cast<float>(bpmem.dispcopyyscale);
+    else
+      yScale = static_cast<float>(bpmem.dispcopyyscale) / 256.0f;
 
-      float num_xfb_lines = 1.0f + bpmem.copyTexSrcWH.y * yScale;
+    float num_xfb_lines = 1.0f + bpmem.copyTexSrcWH.y * yScale;
 
-      u32 height = static_cast<u32>(num_xfb_lines);
+    u32 height = static_cast<u32>(num_xfb_lines);
 
-      DEBUG_LOG_FMT(VIDEO,
-                    "RenderToXFB: destAddr: {:08x} | srcRect [{} {} {} {}] | fbWidth: {} | "
-                    "fbStride: {} | fbHeight: {} | yScale: {}",
-                    destAddr, srcRect.left, srcRect.top, srcRect.right, srcRect.bottom,
-                    bpmem.copyTexSrcWH.x + 1, destStride, height, yScale);
+    DEBUG_LOG_FMT(VIDEO,
+                  "RenderToXFB: destAddr: {:08x} | srcRect [{} {} {} {}] | fbWidth: {} | "
+                  "fbStride: {} | fbHeight: {} | yScale: {}",
+                  destAddr, srcRect.left, srcRect.top, srcRect.right, srcRect.bottom,
+                  bpmem.copyTexSrcWH.x + 1, destStride, height, yScale);
 
-      bool is_depth_copy = bpmem.zcontrol.pixel_format == PEControl::Z24;
-      g_texture_cache->CopyRenderTargetToTexture(
-          destAddr, EFBCopyFormat::XFB, copy_width, height, destStride, is_depth_copy, srcRect,
-          false, false, yScale, s_gammaLUT[PE_copy.gamma], bpmem.triggerEFBCopy.clamp_top,
-          bpmem.triggerEFBCopy.clamp_bottom, bpmem.copyfilter.GetCoefficients());
+    bool is_depth_copy = bpmem.zcontrol.pixel_format == PEControl::Z24;
+    g_texture_cache->CopyRenderTargetToTexture(
+        destAddr, EFBCopyFormat::XFB, copy_width, height, destStride, is_depth_copy, srcRect,
+        false, false, yScale, s_gammaLUT[PE_copy.gamma], bpmem.triggerEFBCopy.clamp_top,
+        bpmem.triggerEFBCopy.clamp_bottom, bpmem.copyfilter.GetCoefficients());
 
-      // This stays in to signal end of a "frame"
-      g_renderer->RenderToXFB(destAddr, srcRect, destStride, height, s_gammaLUT[PE_copy.gamma]);
+    // This stays in to signal end of a "frame"
+    g_renderer->RenderToXFB(destAddr, srcRect, destStride, height, s_gammaLUT[PE_copy.gamma]);
 
-      if (g_ActiveConfig.bImmediateXFB)
-      {
-        // below div two to convert from bytes to pixels - it expects width, not stride
-        g_renderer->Swap(destAddr, destStride / 2, destStride, height, CoreTiming::GetTicks());
-      }
-      else
-      {
-        if (FifoPlayer::GetInstance().IsRunningWithFakeVideoInterfaceUpdates())
-        {
-          VideoInterface::FakeVIUpdate(destAddr, srcRect.GetWidth(), destStride, height);
-        }
-      }
+    if (g_ActiveConfig.bImmediateXFB)
+    {
+      // below div two to convert from bytes to pixels - it expects width, not stride
+      g_renderer->Swap(destAddr, destStride / 2, destStride, height, CoreTiming::GetTicks(),
+                       !Core::IsPresentationSuppressed());
     }
-
-    // Clear the rectangular region after copying it.
-    if (PE_copy.clear)
+    else
     {
-      ClearScreen(srcRect);
+      if (FifoPlayer::GetInstance().IsRunningWithFakeVideoInterfaceUpdates())
+      {
+        VideoInterface::FakeVIUpdate(destAddr, srcRect.GetWidth(), destStride, height);
+      }
     }
-
-    return;
   }
-  case BPMEM_LOADTLUT0:  // This one updates bpmem.tlutXferSrc, no need to do anything here.
-    return;
-  case BPMEM_LOADTLUT1:  // Load a Texture Look Up Table
+
+  // Clear the rectangular region after copying it.
+  if (PE_copy.clear)
   {
-    u32 tlutTMemAddr = (bp.newvalue & 0x3FF) << 9;
-    u32 tlutXferCount = (bp.newvalue & 0x1FFC00) >> 5;
-    u32 addr = bpmem.tmem_config.tlut_src << 5;
+    ClearScreen(srcRect);
+  }
+}
 
-    // The GameCube ignores the upper bits of this address. Some games (WW, MKDD) set them.
-    if (!SConfig::GetInstance().bWii)
-      addr = addr & 0x01FFFFFF;
+static void BPWriteLoadTLUT1(const BPCmd& bp)
+{
+  u32 tlutTMemAddr = (bp.newvalue & 0x3FF) << 9;
+  u32 tlutXferCount = (bp.newvalue & 0x1FFC00) >> 5;
+  u32 addr = bpmem.tmem_config.tlut_src << 5;
 
-    Memory::CopyFromEmu(texMem + tlutTMemAddr, addr, tlutXferCount);
+  // The GameCube ignores the upper bits of this address. Some games (WW, MKDD) set them.
+  if (!SConfig::GetInstance().bWii)
+    addr = addr & 0x01FFFFFF;
 
-    if (OpcodeDecoder::g_record_fifo_data)
-      FifoRecorder::GetInstance().UseMemory(addr, tlutXferCount, MemoryUpdate::TMEM);
+  Memory::CopyFromEmu(texMem + tlutTMemAddr, addr, tlutXferCount);
 
-    TextureCacheBase::InvalidateAllBindPoints();
+  if (OpcodeDecoder::g_record_fifo_data)
+    FifoRecorder::GetInstance().UseMemory(addr, tlutXferCount, MemoryUpdate::TMEM);
 
-    return;
-  }
-  case BPMEM_FOGRANGE:  // Fog Settings Control
-  case BPMEM_FOGRANGE + 1:
-  case BPMEM_FOGRANGE + 2:
-  case BPMEM_FOGRANGE + 3:
-  case BPMEM_FOGRANGE + 4:
-  case BPMEM_FOGRANGE + 5:
-    if (bp.changes)
-      PixelShaderManager::SetFogRangeAdjustChanged();
-    return;
-  case BPMEM_FOGPARAM0:
-  case BPMEM_FOGBMAGNITUDE:
-  case BPMEM_FOGBEXPONENT:
-  case BPMEM_FOGPARAM3:
-    if (bp.changes)
-      PixelShaderManager::SetFogParamChanged();
-    return;
-  case BPMEM_FOGCOLOR:  // Fog Color
-    if (bp.changes)
-      PixelShaderManager::SetFogColorChanged();
-    return;
-  case BPMEM_ALPHACOMPARE:  // Compare Alpha Values
-    PRIM_LOG("alphacmp: ref0={}, ref1={}, comp0={}, comp1={}, logic={}",
-             bpmem.alpha_test.ref0.Value(), bpmem.alpha_test.ref1.Value(),
-             static_cast<int>(bpmem.alpha_test.comp0), static_cast<int>(bpmem.alpha_test.comp1),
-             static_cast<int>(bpmem.alpha_test.logic));
-    if (bp.changes & 0xFFFF)
-      PixelShaderManager::SetAlpha();
-    if (bp.changes)
-    {
-      PixelShaderManager::SetAlphaTestChanged();
-      SetBlendMode();
-    }
-    return;
-  case BPMEM_BIAS:  // BIAS
-    PRIM_LOG("ztex bias={:#x}", bpmem.ztex1.bias.Value());
-    if (bp.changes)
-      PixelShaderManager::SetZTextureBias();
-    return;
-  case BPMEM_ZTEX2:  // Z Texture type
+  TextureCacheBase::InvalidateAllBindPoints();
+}
+
+static void BPWriteFogRange(const BPCmd& bp)
+{
+  if (bp.changes)
+    PixelShaderManager::SetFogRangeAdjustChanged();
+}
+
+static void BPWriteFogParam(const BPCmd& bp)
+{
+  if (bp.changes)
+    PixelShaderManager::SetFogParamChanged();
+}
+
+static void BPWriteFogColor(const BPCmd& bp)
+{
+  if (bp.changes)
+    PixelShaderManager::SetFogColorChanged();
+}
+
+static void BPWriteAlphaCompare(const BPCmd& bp)
+{
+  PRIM_LOG("alphacmp: ref0={}, ref1={}, comp0={}, comp1={}, logic={}",
+           bpmem.alpha_test.ref0.Value(), bpmem.alpha_test.ref1.Value(),
+           static_cast<int>(bpmem.alpha_test.comp0), static_cast<int>(bpmem.alpha_test.comp1),
+           static_cast<int>(bpmem.alpha_test.logic));
+  if (bp.changes & 0xFFFF)
+    PixelShaderManager::SetAlpha();
+  if (bp.changes)
   {
-    if (bp.changes & 3)
-      PixelShaderManager::SetZTextureTypeChanged();
-    if (bp.changes & 12)
-      PixelShaderManager::SetZTextureOpChanged();
-#if defined(_DEBUG) || defined(DEBUGFAST)
-    static constexpr std::string_view pzop[] = {"DISABLE", "ADD", "REPLACE", "?"};
-    static constexpr std::string_view pztype[] = {"Z8", "Z16", "Z24", "?"};
-    PRIM_LOG("ztex op={}, type={}", pzop[bpmem.ztex2.op], pztype[bpmem.ztex2.type]);
-#endif
+    PixelShaderManager::SetAlphaTestChanged();
+    SetBlendMode();
   }
-    return;
-  // ----------------------------------
-  // Display Copy Filtering Control - GX_SetCopyFilter(u8 aa,u8 sample_pattern[12][2],u8 vf,u8
-  // vfilter[7])
-  // Fields: Destination, Frame2Field, Gamma, Source
-  // ----------------------------------
-  case BPMEM_DISPLAYCOPYFILTER:      // if (aa) { use sample_pattern } else { use 666666 }
-  case BPMEM_DISPLAYCOPYFILTER + 1:  // if (aa) { use sample_pattern } else { use 666666 }
-  case BPMEM_DISPLAYCOPYFILTER + 2:  // if (aa) { use sample_pattern } else { use 666666 }
-  case BPMEM_DISPLAYCOPYFILTER + 3:  // if (aa) { use sample_pattern } else { use 666666 }
-  case BPMEM_COPYFILTER0:            // if (vf) { use vfilter } else { use 595000 }
-  case BPMEM_COPYFILTER1:            // if (vf) { use vfilter } else { use 000015 }
-    return;
-  // -----------------------------------
-  // Interlacing Control
-  // -----------------------------------
-  case BPMEM_FIELDMASK:  // GX_SetFieldMask(u8 even_mask,u8 odd_mask)
-  case BPMEM_FIELDMODE:  // GX_SetFieldMode(u8 field_mode,u8 half_aspect_ratio)
-    // TODO
-    return;
-  // ----------------------------------------
-  // Unimportant regs (Clock, Perf, ...)
-  // ----------------------------------------
-  case BPMEM_BUSCLOCK0:   // TB Bus Clock ?
-  case BPMEM_BUSCLOCK1:   // TB Bus Clock ?
-  case BPMEM_PERF0_TRI:   // Perf: Triangles
-  case BPMEM_PERF0_QUAD:  // Perf: Quads
-  case BPMEM_PERF1:       // Perf: Some Clock, Texels, TX, TC
-    return;
-  // ----------------
-  // EFB Copy config
-  // ----------------
-  case BPMEM_EFB_TL:    // EFB Source Rect. Top, Left
-  case BPMEM_EFB_BR:    // EFB Source Rect. Bottom, Right (w, h - 1)
-  case BPMEM_EFB_ADDR:  // EFB Target Address
-    return;
-  // --------------
-  // Clear Config
-  // --------------
-  case BPMEM_CLEAR_AR:  // Alpha and Red Components
-  case BPMEM_CLEAR_GB:  // Green and Blue Components
-  case BPMEM_CLEAR_Z:   // Z Components (24-bit Zbuffer)
-    return;
-  // -------------------------
-  // Bounding Box Control
-  // -------------------------
-  case BPMEM_CLEARBBOX1:
-  case BPMEM_CLEARBBOX2:
-  {
-    const u8 offset = bp.address & 2;
-    BoundingBox::Enable();
+}
 
-    if (g_ActiveConfig.backend_info.bSupportsBBox && g_ActiveConfig.bBBoxEnable)
-    {
-      g_renderer->BBoxWrite(offset, bp.newvalue & 0x3ff);
-      g_renderer->BBoxWrite(offset + 1, bp.newvalue >> 10);
-    }
-  }
-    return;
-  case BPMEM_TEXINVALIDATE:
-    // TODO: Needs some restructuring in TextureCacheBase.
-    TextureCacheBase::InvalidateAllBindPoints();
-    return;
+static void BPWriteBias(const BPCmd& bp)
+{
+  PRIM_LOG("ztex bias={:#x}", bpmem.ztex1.bias.Value());
+  if (bp.changes)
+    PixelShaderManager::SetZTextureBias();
+}
 
-  case BPMEM_ZCOMPARE:  // Set the Z-Compare and EFB pixel format
-    OnPixelFormatChange();
-    if (bp.changes & 7)
-      SetBlendMode();  // dual source could be activated by changing to PIXELFMT_RGBA6_Z24
-    PixelShaderManager::SetZModeControl();
-    return;
+static void BPWriteZTex2(const BPCmd& bp)
+{
+  if (bp.changes & 3)
+    PixelShaderManager::SetZTextureTypeChanged();
+  if (bp.changes & 12)
+    PixelShaderManager::SetZTextureOpChanged();
+#if defined(_DEBUG) || defined(DEBUGFAST)
+  static constexpr std::string_view pzop[] = {"DISABLE", "ADD", "REPLACE", "?"};
+  static constexpr std::string_view pztype[] = {"Z8", "Z16", "Z24", "?"};
+  PRIM_LOG("ztex op={}, type={}", pzop[bpmem.ztex2.op], pztype[bpmem.ztex2.type]);
+#endif
+}
 
-  case BPMEM_MIPMAP_STRIDE:  // MipMap Stride Channel
-  case BPMEM_COPYYSCALE:     // Display Copy Y Scale
-
-  /* 24 RID
-   * 21 BC3 - Ind. Tex Stage 3 NTexCoord
-   * 18 BI3 - Ind. Tex Stage 3 NTexMap
-   * 15 BC2 - Ind. Tex Stage 2 NTexCoord
-   * 12 BI2 - Ind. Tex Stage 2 NTexMap
-   * 9 BC1 - Ind. Tex Stage 1 NTexCoord
-   * 6 BI1 - Ind. Tex Stage 1 NTexMap
-   * 3 BC0 - Ind. Tex Stage 0 NTexCoord
-   * 0 BI0 - Ind. Tex Stage 0 NTexMap */
-  case BPMEM_IREF:
+static void BPWriteClearBBox(const BPCmd& bp)
+{
+  const u8 offset = bp.address & 2;
+  BoundingBox::Enable();
+
+  if (g_ActiveConfig.backend_info.bSupportsBBox && g_ActiveConfig.bBBoxEnable)
   {
-    if (bp.changes)
-      PixelShaderManager::SetTevIndirectChanged();
-    return;
+    g_renderer->BBoxWrite(offset, bp.newvalue & 0x3ff);
+    g_renderer->BBoxWrite(offset + 1, bp.newvalue >> 10);
   }
+}
 
-  case BPMEM_TEV_KSEL:      // Texture Environment Swap Mode Table 0
-  case BPMEM_TEV_KSEL + 1:  // Texture Environment Swap Mode Table 1
-  case BPMEM_TEV_KSEL + 2:  // Texture Environment Swap Mode Table 2
-  case BPMEM_TEV_KSEL + 3:  // Texture Environment Swap Mode Table 3
-  case BPMEM_TEV_KSEL + 4:  // Texture Environment Swap Mode Table 4
-  case BPMEM_TEV_KSEL + 5:  // Texture Environment Swap Mode Table 5
-  case BPMEM_TEV_KSEL + 6:  // Texture Environment Swap Mode Table 6
-  case BPMEM_TEV_KSEL + 7:  // Texture Environment Swap Mode Table 7
-    PixelShaderManager::SetTevKSel(bp.address - BPMEM_TEV_KSEL, bp.newvalue);
-    return;
+static void BPWriteZCompare(const BPCmd& bp)
+{
+  OnPixelFormatChange();
+  if (bp.changes & 7)
+    SetBlendMode();  // dual source could be activated by changing to PIXELFMT_RGBA6_Z24
+  PixelShaderManager::SetZModeControl();
+}
 
-  /* This Register can be used to limit to which bits of BP registers is
-   * actually written to. The mask is only valid for the next BP write,
-   * and will reset itself afterwards. It's handled as a special case in
-   * LoadBPReg. */
-  case BPMEM_BP_MASK:
+/* 24 RID
+ * 21 BC3 - Ind. Tex Stage 3 NTexCoord
+ * 18 BI3 - Ind. Tex Stage 3 NTexMap
+ * 15 BC2 - Ind. Tex Stage 2 NTexCoord
+ * 12 BI2 - Ind. Tex Stage 2 NTexMap
+ * 9 BC1 - Ind. Tex Stage 1 NTexCoord
+ * 6 BI1 - Ind. Tex Stage 1 NTexMap
+ * 3 BC0 - Ind. Tex Stage 0 NTexCoord
+ * 0 BI0 - Ind. Tex Stage 0 NTexMap */
+static void BPWriteIRef(const BPCmd& bp)
+{
+  if (bp.changes)
+    PixelShaderManager::SetTevIndirectChanged();
+}
 
-  case BPMEM_IND_IMASK:  // Index Mask ?
-  case BPMEM_REVBITS:    // Always set to 0x0F when GX_InitRevBits() is called.
-    return;
+// Texture Environment Swap Mode Tables
+static void BPWriteTevKSel(const BPCmd& bp)
+{
+  PixelShaderManager::SetTevKSel(bp.address - BPMEM_TEV_KSEL, bp.newvalue);
+}
 
-  case BPMEM_CLEAR_PIXEL_PERF:
-    // GXClearPixMetric writes 0xAAA here, Sunshine alternates this register between values 0x000
-    // and 0xAAA
-    if (PerfQueryBase::ShouldEmulate())
-      g_perf_query->ResetQuery();
-    return;
+static void BPWriteClearPixelPerf(const BPCmd&)
+{
+  // GXClearPixMetric writes 0xAAA here, Sunshine alternates this register between values 0x000
+  // and 0xAAA
+  if (PerfQueryBase::ShouldEmulate())
+    g_perf_query->ResetQuery();
+}
 
-  case BPMEM_PRELOAD_ADDR:
-  case BPMEM_PRELOAD_TMEMEVEN:
-  case BPMEM_PRELOAD_TMEMODD:  // Used when PRELOAD_MODE is set
+// Set to 0 when GX_TexModeSync() is called.
+static void BPWritePreloadMode(const BPCmd& bp)
+{
+  // if this is different from 0, manual TMEM management is used (GX_PreloadEntireTexture).
+  if (bp.newvalue == 0)
     return;
 
-  case BPMEM_PRELOAD_MODE:  // Set to 0 when GX_TexModeSync() is called.
-    // if this is different from 0, manual TMEM management is used (GX_PreloadEntireTexture).
-    if (bp.newvalue != 0)
-    {
-      // TODO: Not quite sure if this is completely correct (likely not)
-      // NOTE: libogc's implementation of GX_PreloadEntireTexture seems flawed, so it's not
-      // necessarily a good reference for RE'ing this feature.
-
-      BPS_TmemConfig& tmem_cfg = bpmem.tmem_config;
-      u32 src_addr = tmem_cfg.preload_addr << 5;  // TODO: Should we add mask here on GC?
-      u32 bytes_read = 0;
-      u32 tmem_addr_even = tmem_cfg.preload_tmem_even * TMEM_LINE_SIZE;
+  // TODO: Not quite sure if this is completely correct (likely not)
+  // NOTE: libogc's implementation of GX_PreloadEntireTexture seems flawed, so it's not
+  // necessarily a good reference for RE'ing this feature.
 
-      if (tmem_cfg.preload_tile_info.type != 3)
-      {
-        bytes_read = tmem_cfg.preload_tile_info.count * TMEM_LINE_SIZE;
-        if (tmem_addr_even + bytes_read > TMEM_SIZE)
-          bytes_read = TMEM_SIZE - tmem_addr_even;
+  BPS_TmemConfig& tmem_cfg = bpmem.tmem_config;
+  u32 src_addr = tmem_cfg.preload_addr << 5;  // TODO: Should we add mask here on GC?
+  u32 bytes_read = 0;
+  u32 tmem_addr_even = tmem_cfg.preload_tmem_even * TMEM_LINE_SIZE;
 
-        Memory::CopyFromEmu(texMem + tmem_addr_even, src_addr, bytes_read);
-      }
-      else  // RGBA8 tiles (and CI14, but that might just be stupid libogc!)
-      {
-        u8* src_ptr = Memory::GetPointer(src_addr);
-
-        // AR and GB tiles are stored in separate TMEM banks => can't use a single memcpy for
-        // everything
-        u32 tmem_addr_odd = tmem_cfg.preload_tmem_odd * TMEM_LINE_SIZE;
-
-        for (u32 i = 0; i < tmem_cfg.preload_tile_info.count; ++i)
-        {
-          if (tmem_addr_even + TMEM_LINE_SIZE > TMEM_SIZE ||
-              tmem_addr_odd + TMEM_LINE_SIZE > TMEM_SIZE)
-            break;
-
-          memcpy(texMem + tmem_addr_even, src_ptr + bytes_read, TMEM_LINE_SIZE);
-          memcpy(texMem + tmem_addr_odd, src_ptr + bytes_read + TMEM_LINE_SIZE, TMEM_LINE_SIZE);
-          tmem_addr_even += TMEM_LINE_SIZE;
-          tmem_addr_odd += TMEM_LINE_SIZE;
-          bytes_read += TMEM_LINE_SIZE * 2;
-        }
-      }
+  if (tmem_cfg.preload_tile_info.type != 3)
+  {
+    bytes_read = tmem_cfg.preload_tile_info.count * TMEM_LINE_SIZE;
+    if (tmem_addr_even + bytes_read > TMEM_SIZE)
+      bytes_read = TMEM_SIZE - tmem_addr_even;
 
-      if (OpcodeDecoder::g_record_fifo_data)
-        FifoRecorder::GetInstance().UseMemory(src_addr, bytes_read, MemoryUpdate::TMEM);
+    Memory::CopyFromEmu(texMem + tmem_addr_even, src_addr, bytes_read);
+  }
+  else  // RGBA8 tiles (and CI14, but that might just be stupid libogc!)
+  {
+    u8* src_ptr = Memory::GetPointer(src_addr);
 
-      TextureCacheBase::InvalidateAllBindPoints();
-    }
-    return;
+    // AR and GB tiles are stored in separate TMEM banks => can't use a single memcpy for
+    // everything
+    u32 tmem_addr_odd = tmem_cfg.preload_tmem_odd * TMEM_LINE_SIZE;
 
-  // ---------------------------------------------------
-  // Set the TEV Color
-  // ---------------------------------------------------
-  //
-  // NOTE: Each of these registers actually maps to two variables internally.
-  //       There's a bit that specifies which one is currently written to.
-  //
-  // NOTE: Some games write only to the RA register (or only to the BG register).
-  //       We may not assume that the unwritten register holds a valid value, hence
-  //       both component pairs need to be loaded individually.
-  case BPMEM_TEV_COLOR_RA:
-  case BPMEM_TEV_COLOR_RA + 2:
-  case BPMEM_TEV_COLOR_RA + 4:
-  case BPMEM_TEV_COLOR_RA + 6:
-  {
-    int num = (bp.address >> 1) & 0x3;
-    if (bpmem.tevregs[num].type_ra)
-    {
-      PixelShaderManager::SetTevKonstColor(num, 0, (s32)bpmem.tevregs[num].red);
-      PixelShaderManager::SetTevKonstColor(num, 3, (s32)bpmem.tevregs[num].alpha);
-    }
-    else
+    for (u32 i = 0; i < tmem_cfg.preload_tile_info.count; ++i)
     {
-      PixelShaderManager::SetTevColor(num, 0, (s32)bpmem.tevregs[num].red);
-      PixelShaderManager::SetTevColor(num, 3, (s32)bpmem.tevregs[num].alpha);
+      if (tmem_addr_even + TMEM_LINE_SIZE > TMEM_SIZE ||
+          tmem_addr_odd + TMEM_LINE_SIZE > TMEM_SIZE)
+        break;
+
+      memcpy(texMem + tmem_addr_even, src_ptr + bytes_read, TMEM_LINE_SIZE);
+      memcpy(texMem + tmem_addr_odd, src_ptr + bytes_read + TMEM_LINE_SIZE, TMEM_LINE_SIZE);
+      tmem_addr_even += TMEM_LINE_SIZE;
+      tmem_addr_odd += TMEM_LINE_SIZE;
+      bytes_read += TMEM_LINE_SIZE * 2;
     }
-    return;
   }
 
-  case BPMEM_TEV_COLOR_BG:
-  case BPMEM_TEV_COLOR_BG + 2:
-  case BPMEM_TEV_COLOR_BG + 4:
-  case BPMEM_TEV_COLOR_BG + 6:
+  if (OpcodeDecoder::g_record_fifo_data)
+    FifoRecorder::GetInstance().UseMemory(src_addr, bytes_read, MemoryUpdate::TMEM);
+
+  TextureCacheBase::InvalidateAllBindPoints();
+}
+
+// NOTE: Each of the TEV color registers actually maps to two variables internally.
+//       There's a bit that specifies which one is currently written to.
+//
+// NOTE: Some games write only to the RA register (or only to the BG register).
+//       We may not assume that the unwritten register holds a valid value, hence
+//       both component pairs need to be loaded individually.
+static void BPWriteTevColorRA(const BPCmd& bp)
+{
+  int num = (bp.address >> 1) & 0x3;
+  if (bpmem.tevregs[num].type_ra)
   {
-    int num = (bp.address >> 1) & 0x3;
-    if (bpmem.tevregs[num].type_bg)
-    {
-      PixelShaderManager::SetTevKonstColor(num, 1, (s32)bpmem.tevregs[num].green);
-      PixelShaderManager::SetTevKonstColor(num, 2, (s32)bpmem.tevregs[num].blue);
-    }
-    else
-    {
-      PixelShaderManager::SetTevColor(num, 1, (s32)bpmem.tevregs[num].green);
-      PixelShaderManager::SetTevColor(num, 2, (s32)bpmem.tevregs[num].blue);
-    }
-    return;
+    PixelShaderManager::SetTevKonstColor(num, 0, (s32)bpmem.tevregs[num].red);
+    PixelShaderManager::SetTevKonstColor(num, 3, (s32)bpmem.tevregs[num].alpha);
   }
-
-  default:
-    break;
+  else
+  {
+    PixelShaderManager::SetTevColor(num, 0, (s32)bpmem.tevregs[num].red);
+    PixelShaderManager::SetTevColor(num, 3, (s32)bpmem.tevregs[num].alpha);
   }
+}
 
-  switch (bp.address & 0xFC)  // Texture sampler filter
+static void BPWriteTevColorBG(const BPCmd& bp)
+{
+  int num = (bp.address >> 1) & 0x3;
+  if (bpmem.tevregs[num].type_bg)
   {
-  // -------------------------
-  // Texture Environment Order
-  // -------------------------
-  case BPMEM_TREF:
-  case BPMEM_TREF + 4:
-    PixelShaderManager::SetTevOrder(bp.address - BPMEM_TREF, bp.newvalue);
-    return;
-  // ----------------------
-  // Set wrap size
-  // ----------------------
-  case BPMEM_SU_SSIZE:  // Matches BPMEM_SU_TSIZE too
-  case BPMEM_SU_SSIZE + 4:
-  case BPMEM_SU_SSIZE + 8:
-  case BPMEM_SU_SSIZE + 12:
-    if (bp.changes)
-    {
-      PixelShaderManager::SetTexCoordChanged((bp.address - BPMEM_SU_SSIZE) >> 1);
-      GeometryShaderManager::SetTexCoordChanged((bp.address - BPMEM_SU_SSIZE) >> 1);
-    }
-    return;
-  // ------------------------
-  // BPMEM_TX_SETMODE0 - (Texture lookup and filtering mode) LOD/BIAS Clamp, MaxAnsio, LODBIAS,
-  // DiagLoad, Min Filter, Mag Filter, Wrap T, S
-  // BPMEM_TX_SETMODE1 - (LOD Stuff) - Max LOD, Min LOD
-  // ------------------------
-  case BPMEM_TX_SETMODE0:  // (0x90 for linear)
-  case BPMEM_TX_SETMODE0_4:
-    TextureCacheBase::InvalidateAllBindPoints();
-    return;
-
-  case BPMEM_TX_SETMODE1:
-  case BPMEM_TX_SETMODE1_4:
-    TextureCacheBase::InvalidateAllBindPoints();
-    return;
-  // --------------------------------------------
-  // BPMEM_TX_SETIMAGE0 - Texture width, height, format
-  // BPMEM_TX_SETIMAGE1 - even LOD address in TMEM - Image Type, Cache Height, Cache Width, TMEM
-  // Offset
-  // BPMEM_TX_SETIMAGE2 - odd LOD address in TMEM - Cache Height, Cache Width, TMEM Offset
-  // BPMEM_TX_SETIMAGE3 - Address of Texture in main memory
-  // --------------------------------------------
-  case BPMEM_TX_SETIMAGE0:
-  case BPMEM_TX_SETIMAGE0_4:
-  case BPMEM_TX_SETIMAGE1:
-  case BPMEM_TX_SETIMAGE1_4:
-  case BPMEM_TX_SETIMAGE2:
-  case BPMEM_TX_SETIMAGE2_4:
-  case BPMEM_TX_SETIMAGE3:
-  case BPMEM_TX_SETIMAGE3_4:
-    TextureCacheBase::InvalidateAllBindPoints();
-    return;
-  // -------------------------------
-  // Set a TLUT
-  // BPMEM_TX_SETTLUT - Format, TMEM Offset (offset of TLUT from start of TMEM high bank > > 5)
-  // -------------------------------
-  case BPMEM_TX_SETTLUT:
-  case BPMEM_TX_SETTLUT_4:
-    TextureCacheBase::InvalidateAllBindPoints();
-    return;
-
-  default:
-    break;
+    PixelShaderManager::SetTevKonstColor(num, 1, (s32)bpmem.tevregs[num].green);
+    PixelShaderManager::SetTevKonstColor(num, 2, (s32)bpmem.tevregs[num].blue);
   }
+  else
+  {
+    PixelShaderManager::SetTevColor(num, 1, (s32)bpmem.tevregs[num].green);
+    PixelShaderManager::SetTevColor(num, 2, (s32)bpmem.tevregs[num].blue);
+  }
+}
 
-  switch (bp.address & 0xF0)
+// Texture Environment Order
+static void BPWriteTevOrder(const BPCmd& bp)
+{
+  PixelShaderManager::SetTevOrder(bp.address - BPMEM_TREF, bp.newvalue);
+}
+
+// Set wrap size
+static void BPWriteTexCoordSize(const BPCmd& bp)
+{
+  if (bp.changes)
   {
-  // --------------
-  // Indirect Tev
-  // --------------
-  case BPMEM_IND_CMD:
-    PixelShaderManager::SetTevIndirectChanged();
-    return;
-  // --------------------------------------------------
-  // Set Color/Alpha of a Tev
-  // BPMEM_TEV_COLOR_ENV - Dest, Shift, Clamp, Sub, Bias, Sel A, Sel B, Sel C, Sel D
-  // BPMEM_TEV_ALPHA_ENV - Dest, Shift, Clamp, Sub, Bias, Sel A, Sel B, Sel C, Sel D, T Swap, R Swap
-  // --------------------------------------------------
-  case BPMEM_TEV_COLOR_ENV:  // Texture Environment 1
-  case BPMEM_TEV_COLOR_ENV + 16:
-    PixelShaderManager::SetTevCombiner((bp.address - BPMEM_TEV_COLOR_ENV) >> 1,
-                                       (bp.address - BPMEM_TEV_COLOR_ENV) & 1, bp.newvalue);
-    return;
-  default:
-    break;
+    PixelShaderManager::SetTexCoordChanged((bp.address - BPMEM_SU_SSIZE) >> 1);
+    GeometryShaderManager::SetTexCoordChanged((bp.address - BPMEM_SU_SSIZE) >> 1);
   }
+}
+
+// Texture lookup and filtering modes, image formats and addresses, and TLUTs of the texture units
+// (BPMEM_TX_SETMODE0 to BPMEM_TX_SETTLUT_4), as well as BPMEM_TEXINVALIDATE.
+static void BPWriteTexUnit(const BPCmd&)
+{
+  // TODO: BPMEM_TEXINVALIDATE needs some restructuring in TextureCacheBase.
+  TextureCacheBase::InvalidateAllBindPoints();
+}
+
+// Indirect Tev
+static void BPWriteIndCmd(const BPCmd&)
+{
+  PixelShaderManager::SetTevIndirectChanged();
+}
+
+// Set Color/Alpha of a Tev
+// BPMEM_TEV_COLOR_ENV - Dest, Shift, Clamp, Sub, Bias, Sel A, Sel B, Sel C, Sel D
+// BPMEM_TEV_ALPHA_ENV - Dest, Shift, Clamp, Sub, Bias, Sel A, Sel B, Sel C, Sel D, T Swap, R Swap
+static void BPWriteTevEnv(const BPCmd& bp)
+{
+  PixelShaderManager::SetTevCombiner((bp.address - BPMEM_TEV_COLOR_ENV) >> 1,
+                                     (bp.address - BPMEM_TEV_COLOR_ENV) & 1, bp.newvalue);
+}
 
+static void BPWriteNothing(const BPCmd&)
+{
+}
+
+static void BPWriteUnknown(const BPCmd& bp)
+{
   WARN_LOG_FMT(VIDEO, "Unknown BP opcode: address = {:#010x} value = {:#010x}", bp.address,
                bp.newvalue);
 }
 
+namespace
+{
+struct BPRegisterInfo
+{
+  void (*handler)(const BPCmd& bp) = BPWriteUnknown;
+
+  // Commands act on every write, while other registers only have to be handled when their value
+  // changes.
+  bool is_command = false;
+
+  // Whether the vertices of the current batch have to be drawn before the register changes.
+  // Parameters which are only read when a command is triggered, like those of EFB copies, don't
+  // affect them.
+  bool needs_flush = true;
+};
+
+constexpr BPRegisterInfo Command(void (*handler)(const BPCmd&))
+{
+  return {handler, true, true};
+}
+
+constexpr BPRegisterInfo State(void (*handler)(const BPCmd&))
+{
+  return {handler, false, true};
+}
+
+// Only read by commands, or not at all.
+constexpr BPRegisterInfo Parameter()
+{
+  return {BPWriteNothing, false, false};
+}
+
+constexpr std::array<BPRegisterInfo, 256> BuildBPRegisterTable()
+{
+  std::array<BPRegisterInfo, 256> table{};
+  const auto set = [&table](u32 address, u32 count, u32 step, BPRegisterInfo info) {
+    for (u32 i = 0; i < count; i++)
+      table[address + i * step] = info;
+  };
+
+  set(BPMEM_GENMODE, 1, 1, State(BPWriteGenMode));
+  set(BPMEM_DISPLAYCOPYFILTER, 4, 1, Parameter());
+  set(BPMEM_IND_MTXA, 9, 1, State(BPWriteIndMatrix));
+  set(BPMEM_IND_IMASK, 1, 1, Parameter());
+  set(BPMEM_IND_CMD, 16, 1, State(BPWriteIndCmd));
+  set(BPMEM_SCISSORTL, 2, 1, State(BPWriteScissor));
+  set(BPMEM_LINEPTWIDTH, 1, 1, State(BPWriteLinePtWidth));
+  set(BPMEM_PERF0_TRI, 2, 1, Parameter());
+  set(BPMEM_RAS1_SS0, 2, 1, State(BPWriteIndTexScale));
+  set(BPMEM_IREF, 1, 1, State(BPWriteIRef));
+  set(BPMEM_TREF, 8, 1, State(BPWriteTevOrder));
+  set(BPMEM_SU_SSIZE, 16, 1, State(BPWriteTexCoordSize));
+  set(BPMEM_ZMODE, 1, 1, State(BPWriteZMode));
+  set(BPMEM_BLENDMODE, 1, 1, State(BPWriteBlendMode));
+  set(BPMEM_CONSTANTALPHA, 1, 1, State(BPWriteConstantAlpha));
+  set(BPMEM_ZCOMPARE, 1, 1, State(BPWriteZCompare));
+  // TODO: Interlacing control
+  set(BPMEM_FIELDMASK, 1, 1, Parameter());
+  set(BPMEM_SETDRAWDONE, 1, 1, Command(BPWriteSetDrawDone));
+  set(BPMEM_BUSCLOCK0, 1, 1, Parameter());
+  set(BPMEM_PE_TOKEN_ID, 1, 1, Command(BPWritePETokenID));
+  set(BPMEM_PE_TOKEN_INT_ID, 1, 1, Command(BPWritePETokenIntID));
+  set(BPMEM_EFB_TL, 3, 1, Parameter());
+  set(BPMEM_MIPMAP_STRIDE, 1, 1, Parameter());
+  set(BPMEM_COPYYSCALE, 1, 1, Parameter());
+  set(BPMEM_CLEAR_AR, 3, 1, Parameter());
+  set(BPMEM_TRIGGER_EFB_COPY, 1, 1, Command(BPWriteTriggerEFBCopy));
+  set(BPMEM_COPYFILTER0, 2, 1, Parameter());
+  set(BPMEM_CLEARBBOX1, 2, 1, Command(BPWriteClearBBox));
+  set(BPMEM_CLEAR_PIXEL_PERF, 1, 1, Command(BPWriteClearPixelPerf));
+  // Always set to 0x0F when GX_InitRevBits() is called.
+  set(BPMEM_REVBITS, 1, 1, Parameter());
+  set(BPMEM_SCISSOROFFSET, 1, 1, State(BPWriteScissor));
+  set(BPMEM_PRELOAD_ADDR, 3, 1, Parameter());
+  set(BPMEM_PRELOAD_MODE, 1, 1, Command(BPWritePreloadMode));
+  // This one updates bpmem.tlutXferSrc for BPMEM_LOADTLUT1.
+  set(BPMEM_LOADTLUT0, 1, 1, Parameter());
+  set(BPMEM_LOADTLUT1, 1, 1, Command(BPWriteLoadTLUT1));
+  set(BPMEM_TEXINVALIDATE, 1, 1, Command(BPWriteTexUnit));
+  set(BPMEM_PERF1, 1, 1, Parameter());
+  set(BPMEM_FIELDMODE, 1, 1, Parameter());
+  set(BPMEM_BUSCLOCK1, 1, 1, Parameter());
+  for (u32 base : {BPMEM_TX_SETMODE0, BPMEM_TX_SETMODE0_4})
+    set(base, 7 * 4, 1, State(BPWriteTexUnit));
+  set(BPMEM_TEV_COLOR_ENV, 32, 1, State(BPWriteTevEnv));
+  set(BPMEM_TEV_COLOR_RA, 4, 2, State(BPWriteTevColorRA));
+  set(BPMEM_TEV_COLOR_BG, 4, 2, State(BPWriteTevColorBG));
+  set(BPMEM_FOGRANGE, 6, 1, State(BPWriteFogRange));
+  set(BPMEM_FOGPARAM0, 4, 1, State(BPWriteFogParam));
+  set(BPMEM_FOGCOLOR, 1, 1, State(BPWriteFogColor));
+  set(BPMEM_ALPHACOMPARE, 1, 1, State(BPWriteAlphaCompare));
+  set(BPMEM_BIAS, 1, 1, State(BPWriteBias));
+  set(BPMEM_ZTEX2, 1, 1, State(BPWriteZTex2));
+  set(BPMEM_TEV_KSEL, 8, 1, State(BPWriteTevKSel));
+  // This register limits which bits of the next BP write are actually written. It's handled as a
+  // special case in LoadBPReg.
+  set(BPMEM_BP_MASK, 1, 1, Parameter());
+  return table;
+}
+}  // namespace
+
+static constexpr std::array<BPRegisterInfo, 256> s_bp_registers = BuildBPRegisterTable();
+
+static void BPWritten(const BPCmd& bp)
+{
+  /*
+  ----------------------------------------------------------------------------------------------------------------
+  Purpose: Writes to the BP registers
+  Called: At the end of every: OpcodeDecoding.cpp ExecuteDisplayList > Decode() > LoadBPReg
+  How It Works: Unless the register is a command, writes which don't change it are skipped.
+          Otherwise the pipeline is flushed if the register affects drawing, then bpmem is
+          updated with the new value and the handler from s_bp_registers is called.
+  NOTE: Yet Another GameCube Documentation calls them Bypass Raster State Registers but possibly
+  completely wrong
+  NOTE2: This controls the register groups: RAS1/2, SU, TF, TEV, C/Z, PEC
+  ----------------------------------------------------------------------------------------------------------------
+  */
+
+  const BPRegisterInfo& info = s_bp_registers[bp.address];
+  if (((s32*)&bpmem)[bp.address] == bp.newvalue && !info.is_command)
+    return;
+
+  if (info.needs_flush)
+    FlushPipeline();
+
+  ((u32*)&bpmem)[bp.address] = bp.newvalue;
+
+  info.handler(bp);
+}
+
 // Call browser: OpcodeDecoding.cpp ExecuteDisplayList > Decode() > LoadBPReg()
 void LoadBPReg(u32 value0)
 {
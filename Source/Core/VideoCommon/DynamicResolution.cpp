@@ -0,0 +1,100 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/DynamicResolution.h"
+
+#include <algorithm>
+
+// Number of frames the GPU and frame times are averaged over before the scale is reconsidered.
+constexpr u32 MEASURED_FRAMES = 30;
+
+// Frames taking longer than this are pauses or loading screens, which say nothing about the GPU.
+constexpr double MAX_FRAME_TIME_MS = 250.0;
+
+// The scale is lowered when the GPU is busy for more than this part of the frame time, and raised
+// when it would be busy for less than this part of it at the next scale.
+constexpr double DOWNSCALE_THRESHOLD = 0.9;
+constexpr double UPSCALE_THRESHOLD = 0.75;
+
+void DynamicResolution::AddGPUTime(u64 frame, double milliseconds)
+{
+  if (frame < m_first_measured_frame)
+    return;
+
+  if (m_has_pending_frame && frame != m_pending_frame)
+  {
+    AddCompletedFrame(m_pending_gpu_time_ms);
+    m_has_pending_frame = false;
+  }
+
+  if (!m_has_pending_frame)
+  {
+    m_pending_frame = frame;
+    m_pending_gpu_time_ms = 0;
+    m_has_pending_frame = true;
+  }
+
+  m_pending_gpu_time_ms += milliseconds;
+}
+
+void DynamicResolution::AddCompletedFrame(double gpu_time_ms)
+{
+  m_gpu_time_sum_ms += gpu_time_ms;
+  m_num_gpu_times++;
+}
+
+bool DynamicResolution::EndFrame(u64 frame, double frame_time_ms, u32 min_scale, u32 max_scale)
+{
+  const u32 old_scale = GetScale(min_scale, max_scale);
+  m_scale = old_scale;
+
+  if (frame_time_ms < MAX_FRAME_TIME_MS)
+  {
+    m_frame_time_sum_ms += frame_time_ms;
+    m_num_frame_times++;
+  }
+
+  if (m_num_gpu_times < MEASURED_FRAMES || m_num_frame_times < MEASURED_FRAMES)
+    return false;
+
+  const double gpu_time_ms = m_gpu_time_sum_ms / m_num_gpu_times;
+  const double average_frame_time_ms = m_frame_time_sum_ms / m_num_frame_times;
+  m_gpu_time_sum_ms = 0;
+  m_num_gpu_times = 0;
+  m_frame_time_sum_ms = 0;
+  m_num_frame_times = 0;
+
+  if (gpu_time_ms > average_frame_time_ms * DOWNSCALE_THRESHOLD)
+  {
+    if (m_scale > min_scale)
+      m_scale--;
+  }
+  else if (m_scale < max_scale)
+  {
+    // The GPU time mostly grows with the number of pixels.
+    const double next_scale = m_scale + 1.0;
+    const double growth = (next_scale * next_scale) / (double(m_scale) * m_scale);
+    if (gpu_time_ms * growth < average_frame_time_ms * UPSCALE_THRESHOLD)
+      m_scale++;
+  }
+
+  if (m_scale == old_scale)
+    return false;
+
+  // Frames still on their way through the GPU were rendered at the old scale.
+  m_first_measured_frame = frame + 1;
+  m_has_pending_frame = false;
+  return true;
+}
+
+u32 DynamicResolution::GetScale(u32 min_scale, u32 max_scale) const
+{
+  return std::clamp(m_scale, min_scale, std::max(min_scale, max_scale));
+}
+
+void DynamicResolution::Reset(u64 frame)
+{
+  *this = {};
+  m_first_measured_frame = frame;
+}
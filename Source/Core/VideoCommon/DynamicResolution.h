@@ -0,0 +1,53 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <limits>
+
+#include "Common/CommonTypes.h"
+
+// Picks the internal resolution while the game is running, so that the host GPU keeps up with it.
+// The GPU time of each frame is compared with the time between frames: when the GPU is busy for
+// almost all of it, the GPU is what limits the frame rate and the scale is lowered, and when the
+// next larger scale would still leave plenty of headroom, it is raised again. Decisions are made
+// over a number of frames, so that single slow frames don't cause the framebuffers to be
+// recreated back and forth.
+//
+// Only backends which can measure how long the GPU takes report GPU times. Without them, the scale
+// stays at the maximum.
+class DynamicResolution
+{
+public:
+  // Adds time the GPU spent on the given frame. A frame may be reported in several parts, e.g. one
+  // per command buffer, and the parts may arrive a few frames late, but in order of frame.
+  void AddGPUTime(u64 frame, double milliseconds);
+
+  // Called when a frame ends, with the time since the end of the previous one. Returns true if the
+  // scale changed.
+  bool EndFrame(u64 frame, double frame_time_ms, u32 min_scale, u32 max_scale);
+
+  u32 GetScale(u32 min_scale, u32 max_scale) const;
+
+  // Starts over from the maximum scale, from the given frame on.
+  void Reset(u64 frame);
+
+private:
+  void AddCompletedFrame(double gpu_time_ms);
+
+  u32 m_scale = std::numeric_limits<u32>::max();
+
+  // GPU times of frames before this were rendered at a different scale, and are ignored.
+  u64 m_first_measured_frame = 0;
+
+  // The frame whose GPU time is still being added up.
+  u64 m_pending_frame = 0;
+  double m_pending_gpu_time_ms = 0;
+  bool m_has_pending_frame = false;
+
+  double m_gpu_time_sum_ms = 0;
+  u32 m_num_gpu_times = 0;
+  double m_frame_time_sum_ms = 0;
+  u32 m_num_frame_times = 0;
+};
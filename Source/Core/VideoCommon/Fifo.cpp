@@ -4,7 +4,9 @@
 
 #include "VideoCommon/Fifo.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstring>
 
 #include "Common/Assert.h"
@@ -13,8 +15,11 @@
 #include "Common/ChunkFile.h"
 #include "Common/Event.h"
 #include "Common/FPURoundMode.h"
+#include "Common/Logging/Log.h"
 #include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/Thread.h"
+#include "Common/Tracing.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
@@ -25,6 +30,7 @@
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/FrameTimeBreakdown.h"
 #include "VideoCommon/OpcodeDecoding.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
@@ -34,6 +40,14 @@ namespace Fifo
 {
 static constexpr u32 FIFO_SIZE = 2 * 1024 * 1024;
 static constexpr int GPU_TIME_SLOT_SIZE = 1000;
+static constexpr size_t CACHE_LINE_SIZE = 64;
+// Upper bound for how much FIFO data the CPU thread preprocesses in one go.
+static constexpr u32 MAX_PREPROCESS_BATCH_SIZE = 32 * 1024;
+
+// Bounds for how often the CPU thread polls the GPU's progress before parking on
+// s_sync_wakeup_event. The actual number adapts to how long the last waits took.
+static constexpr u32 MIN_SYNC_SPINS = 16;
+static constexpr u32 MAX_SYNC_SPINS = 4096;
 
 static Common::BlockingLoop s_gpu_mainloop;
 
@@ -68,10 +82,26 @@ static u8* s_video_buffer_pp_read_ptr;
 // polls, it's just atomic.
 // - The pp_read_ptr is the CPU preprocessing version of the read_ptr.
 
-static std::atomic<int> s_sync_ticks;
-static bool s_syncing_suspended;
+// s_sync_ticks is hammered by both threads, so keep it away from everything else.
+alignas(CACHE_LINE_SIZE) static std::atomic<int> s_sync_ticks;
+alignas(CACHE_LINE_SIZE) static bool s_syncing_suspended;
 static Common::Event s_sync_wakeup_event;
 
+// Only touched by the CPU thread.
+alignas(CACHE_LINE_SIZE) static u32 s_sync_spin_estimate;
+static SyncStatistics::Side s_cpu_sync_statistics;
+
+// Only touched by the GPU thread.
+alignas(CACHE_LINE_SIZE) static SyncStatistics::Side s_gpu_sync_statistics;
+static std::chrono::steady_clock::time_point s_gpu_stall_start;
+static bool s_gpu_stalled;
+
+static u64 MicrosecondsSince(std::chrono::steady_clock::time_point start)
+{
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
 void DoState(PointerWrap& p)
 {
   p.DoArray(s_video_buffer, FIFO_SIZE);
@@ -118,6 +148,10 @@ void Init()
   if (SConfig::GetInstance().bCPUThread)
     s_gpu_mainloop.Prepare();
   s_sync_ticks.store(0);
+  s_sync_spin_estimate = 0;
+  s_cpu_sync_statistics = {};
+  s_gpu_sync_statistics = {};
+  s_gpu_stalled = false;
 }
 
 void Shutdown()
@@ -125,6 +159,16 @@ void Shutdown()
   if (s_gpu_mainloop.IsRunning())
     PanicAlertFmt("FIFO shutting down while active");
 
+  if (s_cpu_sync_statistics.stalls != 0 || s_gpu_sync_statistics.stalls != 0)
+  {
+    INFO_LOG_FMT(COMMANDPROCESSOR,
+                 "GPU sync: CPU stalled {} times for {} us ({} ended while spinning), "
+                 "GPU stalled {} times for {} us",
+                 s_cpu_sync_statistics.stalls, s_cpu_sync_statistics.stall_us,
+                 s_cpu_sync_statistics.spin_wakeups, s_gpu_sync_statistics.stalls,
+                 s_gpu_sync_statistics.stall_us);
+  }
+
   Common::FreeMemoryPages(s_video_buffer, FIFO_SIZE + 4);
   s_video_buffer = nullptr;
   s_video_buffer_write_ptr = nullptr;
@@ -161,7 +205,11 @@ void SyncGPU(SyncGPUReason reason, bool may_move_read_ptr)
 {
   if (s_use_deterministic_gpu_thread)
   {
-    s_gpu_mainloop.Wait();
+    {
+      const FrameTimeBreakdown::ScopedCategory breakdown_category(
+          FrameTimeBreakdown::Category::CPUWait);
+      s_gpu_mainloop.Wait();
+    }
     if (!s_gpu_mainloop.IsRunning())
       return;
 
@@ -245,10 +293,10 @@ static void ReadDataFromFifo(u32 readPtr)
   s_video_buffer_write_ptr += len;
 }
 
-// The deterministic_gpu_thread version.
-static void ReadDataFromFifoOnCPU(u32 readPtr)
+// The deterministic_gpu_thread version. Unlike ReadDataFromFifo, this can take several contiguous
+// 32 byte chunks at once.
+static void ReadDataFromFifoOnCPU(u32 readPtr, size_t len)
 {
-  constexpr size_t len = 32;
   u8* write_ptr = s_video_buffer_write_ptr;
   if (len > static_cast<size_t>(s_video_buffer + FIFO_SIZE - write_ptr))
   {
@@ -295,6 +343,8 @@ void ResetVideoBuffer()
 // Purpose: Keep the Core HW updated about the CPU-GPU distance
 void RunGpuLoop()
 {
+  Common::PlaceCurrentEmulationThread(Common::EmulationThread::GPU);
+
   AsyncRequests::GetInstance()->SetEnable(true);
   AsyncRequests::GetInstance()->SetPassthrough(false);
 
@@ -309,6 +359,8 @@ void RunGpuLoop()
         if (!s_emu_running_state.IsSet())
           return;
 
+        TRACE_SCOPE("Fifo::RunGpuLoop");
+
         if (s_use_deterministic_gpu_thread)
         {
           // All the fifo/CP stuff is on the CPU.  We just need to run the opcode decoder.
@@ -332,7 +384,21 @@ void RunGpuLoop()
                  fifo.CPReadWriteDistance && !AtBreakpoint())
           {
             if (param.bSyncGPU && s_sync_ticks.load() < param.iSyncGpuMinDistance)
+            {
+              // Out of budget, the CPU thread has to run ahead first.
+              if (!s_gpu_stalled)
+              {
+                s_gpu_stalled = true;
+                s_gpu_stall_start = std::chrono::steady_clock::now();
+                s_gpu_sync_statistics.stalls++;
+              }
               break;
+            }
+            if (s_gpu_stalled)
+            {
+              s_gpu_stalled = false;
+              s_gpu_sync_statistics.stall_us += MicrosecondsSince(s_gpu_stall_start);
+            }
 
             u32 cyclesExecuted = 0;
             u32 readPtr = fifo.CPReadPointer;
@@ -401,6 +467,8 @@ void FlushGpu()
   if (!param.bCPUThread || s_use_deterministic_gpu_thread)
     return;
 
+  const FrameTimeBreakdown::ScopedCategory breakdown_category(
+      FrameTimeBreakdown::Category::CPUWait);
   s_gpu_mainloop.Wait();
 }
 
@@ -447,8 +515,23 @@ static int RunGpuOnCpu(int ticks)
   {
     if (s_use_deterministic_gpu_thread)
     {
-      ReadDataFromFifoOnCPU(fifo.CPReadPointer);
+      // Preprocessing doesn't consume any ticks and can't change the loop conditions, so hand it
+      // all of the contiguous data up to the end of the FIFO or a breakpoint at once. That saves
+      // reparsing partial commands and waking up the GPU thread for every single chunk.
+      u32 len = 32;
+      while (len < fifo.CPReadWriteDistance && len < MAX_PREPROCESS_BATCH_SIZE &&
+             fifo.CPReadPointer + len - 32 != fifo.CPEnd &&
+             !(fifo.bFF_BPEnable && fifo.CPReadPointer + len == fifo.CPBreakpoint))
+      {
+        len += 32;
+      }
+
+      ReadDataFromFifoOnCPU(fifo.CPReadPointer, len);
       s_gpu_mainloop.Wakeup();
+
+      // The last chunk is accounted for below, including the wraparound.
+      fifo.CPReadPointer += len - 32;
+      fifo.CPReadWriteDistance -= len - 32;
     }
     else
     {
@@ -530,6 +613,43 @@ bool UseDeterministicGPUThread()
   return s_use_deterministic_gpu_thread;
 }
 
+// Blocks the CPU thread until the GPU thread has caught up to within max_distance ticks.
+// Handoffs are usually quick, so poll for a while first and only park on the event if that fails.
+static void WaitForGpuProgress(int max_distance)
+{
+  const auto start = std::chrono::steady_clock::now();
+  s_cpu_sync_statistics.stalls++;
+
+  const u32 spin_limit = std::min(MAX_SYNC_SPINS, MIN_SYNC_SPINS + 2 * s_sync_spin_estimate);
+  u32 spins = 0;
+  while (spins < spin_limit && s_sync_ticks.load() >= max_distance && s_gpu_mainloop.IsRunning())
+  {
+    Common::YieldCPU();
+    spins++;
+  }
+
+  if (spins < spin_limit)
+  {
+    // The event may still get set for this handoff, which is fine: the loop below rechecks the
+    // distance after every wakeup.
+    s_sync_spin_estimate = (7 * s_sync_spin_estimate + spins) / 8;
+    s_cpu_sync_statistics.spin_wakeups++;
+  }
+  else
+  {
+    s_sync_spin_estimate -= s_sync_spin_estimate / 8;
+    while (s_sync_ticks.load() >= max_distance && s_gpu_mainloop.IsRunning())
+      s_sync_wakeup_event.Wait();
+  }
+
+  s_cpu_sync_statistics.stall_us += MicrosecondsSince(start);
+}
+
+SyncStatistics GetSyncStatistics()
+{
+  return {s_cpu_sync_statistics, s_gpu_sync_statistics};
+}
+
 /* This function checks the emulated CPU - GPU distance and may wake up the GPU,
  * or block the CPU if required. It should be called by the CPU thread regularly.
  * @ticks The gone emulated CPU time.
@@ -556,7 +676,7 @@ static int WaitForGpuThread(int ticks)
 
   // Wait for GPU
   if (now >= param.iSyncGpuMaxDistance)
-    s_sync_wakeup_event.Wait();
+    WaitForGpuProgress(param.iSyncGpuMaxDistance);
 
   return GPU_TIME_SLOT_SIZE;
 }
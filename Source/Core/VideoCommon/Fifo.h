@@ -33,6 +33,22 @@ enum class SyncGPUReason
 // In deterministic GPU thread mode this waits for the GPU to be done with pending work.
 void SyncGPU(SyncGPUReason reason, bool may_move_read_ptr = true);
 
+// How long each thread waited for the other to keep within the SyncGPU distances.
+struct SyncStatistics
+{
+  struct Side
+  {
+    u64 stalls = 0;
+    u64 stall_us = 0;
+    // Only counted for the CPU thread: stalls which ended before it had to sleep.
+    u64 spin_wakeups = 0;
+  };
+  Side cpu;
+  Side gpu;
+};
+// Only meaningful while the GPU thread isn't running.
+SyncStatistics GetSyncStatistics();
+
 void PushFifoAuxBuffer(const void* ptr, size_t size);
 void* PopFifoAuxBuffer(size_t size);
 
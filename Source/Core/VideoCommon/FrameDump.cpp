@@ -55,6 +55,19 @@ struct FrameDumpContext
 
 namespace
 {
+bool SupportsPixelFormat(const AVCodec* codec, AVPixelFormat pix_fmt)
+{
+  if (!codec->pix_fmts)
+    return false;
+
+  for (const AVPixelFormat* fmt = codec->pix_fmts; *fmt != AV_PIX_FMT_NONE; fmt++)
+  {
+    if (*fmt == pix_fmt)
+      return true;
+  }
+  return false;
+}
+
 AVRational GetTimeBaseForCurrentRefreshRate()
 {
   int num;
@@ -215,7 +228,14 @@ bool FrameDump::CreateVideoFile()
   m_context->codec->time_base = time_base;
   m_context->codec->gop_size = 1;
   m_context->codec->level = 1;
-  m_context->codec->pix_fmt = g_Config.bUseFFV1 ? AV_PIX_FMT_BGR0 : AV_PIX_FMT_YUV420P;
+  // Encoders which take RGB input, such as most hardware encoders, convert it themselves, so the
+  // frames can be passed through without converting them on the CPU first.
+  if (g_Config.bUseFFV1)
+    m_context->codec->pix_fmt = AV_PIX_FMT_BGR0;
+  else if (SupportsPixelFormat(codec, AV_PIX_FMT_RGB0))
+    m_context->codec->pix_fmt = AV_PIX_FMT_RGB0;
+  else
+    m_context->codec->pix_fmt = AV_PIX_FMT_YUV420P;
 
   if (output_format->flags & AVFMT_GLOBALHEADER)
     m_context->codec->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
@@ -310,20 +330,31 @@ void FrameDump::AddFrame(const FrameData& frame)
   m_context->src_frame->width = m_context->width;
   m_context->src_frame->height = m_context->height;
 
-  // Convert image from RGBA to desired pixel format.
-  m_context->sws = sws_getCachedContext(
-      m_context->sws, frame.width, frame.height, pix_fmt, m_context->width, m_context->height,
-      m_context->codec->pix_fmt, SWS_BICUBIC, nullptr, nullptr, nullptr);
-  if (m_context->sws)
+  AVFrame* encoded_frame = m_context->src_frame;
+  if (m_context->codec->pix_fmt != AV_PIX_FMT_RGB0 || frame.width != m_context->width ||
+      frame.height != m_context->height)
+  {
+    // Convert image from RGBA to desired pixel format.
+    m_context->sws = sws_getCachedContext(
+        m_context->sws, frame.width, frame.height, pix_fmt, m_context->width, m_context->height,
+        m_context->codec->pix_fmt, SWS_BICUBIC, nullptr, nullptr, nullptr);
+    if (m_context->sws)
+    {
+      sws_scale(m_context->sws, m_context->src_frame->data, m_context->src_frame->linesize, 0,
+                frame.height, m_context->scaled_frame->data, m_context->scaled_frame->linesize);
+    }
+    encoded_frame = m_context->scaled_frame;
+  }
+  else
   {
-    sws_scale(m_context->sws, m_context->src_frame->data, m_context->src_frame->linesize, 0,
-              frame.height, m_context->scaled_frame->data, m_context->scaled_frame->linesize);
+    // The readback is RGBA, the alpha channel of which is ignored by the encoder.
+    encoded_frame->format = AV_PIX_FMT_RGB0;
   }
 
   m_context->last_pts = pts;
-  m_context->scaled_frame->pts = pts;
+  encoded_frame->pts = pts;
 
-  if (const int error = avcodec_send_frame(m_context->codec, m_context->scaled_frame))
+  if (const int error = avcodec_send_frame(m_context->codec, encoded_frame))
   {
     ERROR_LOG_FMT(FRAMEDUMP, "Error while encoding video: {}", error);
     return;
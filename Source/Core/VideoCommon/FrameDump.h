@@ -31,6 +31,7 @@ public:
 
   struct FrameData
   {
+    // Null for a frame which repeats the previous one.
     const u8* data;
     int width;
     int height;
@@ -0,0 +1,226 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/FrameProfiler.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace FrameProfiler
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t NUM_SECTIONS = static_cast<size_t>(Section::Count);
+constexpr std::array<const char*, NUM_SECTIONS> SECTION_NAMES = {
+    "opcode_decoding_ms", "vertex_loading_ms", "texture_cache_ms", "present_ms"};
+
+struct FrameTimes
+{
+  u64 frame;
+  double frame_ms;
+  std::array<double, NUM_SECTIONS> section_ms;
+  std::optional<double> gpu_ms;
+};
+
+static std::atomic<bool> s_active{false};
+
+// Set before s_active, and only read after it's cleared
+static std::string s_report_path;
+static std::string s_description;
+static std::string s_device_name;
+
+// Only used on the video thread
+static std::optional<Section> s_current_section;
+static Clock::time_point s_section_start;
+static std::array<Clock::duration, NUM_SECTIONS> s_section_times{};
+static std::optional<Clock::time_point> s_frame_start;
+
+// The GPU times may be added from a backend thread
+static std::mutex s_frames_mutex;
+static std::vector<FrameTimes> s_frames;
+
+static double ToMilliseconds(Clock::duration duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static void ChargeCurrentSection(Clock::time_point now)
+{
+  if (s_current_section)
+    s_section_times[static_cast<size_t>(*s_current_section)] += now - s_section_start;
+  s_section_start = now;
+}
+
+void Start(std::string report_path, std::string description)
+{
+  s_report_path = std::move(report_path);
+  s_description = std::move(description);
+  s_active.store(true);
+}
+
+bool IsActive()
+{
+  return s_active.load(std::memory_order_relaxed);
+}
+
+void SetDeviceName(std::string name)
+{
+  s_device_name = std::move(name);
+}
+
+std::optional<Section> EnterSection(Section section)
+{
+  ChargeCurrentSection(Clock::now());
+  return std::exchange(s_current_section, section);
+}
+
+void LeaveSection(std::optional<Section> previous)
+{
+  ChargeCurrentSection(Clock::now());
+  s_current_section = previous;
+}
+
+void EndFrame(u64 frame)
+{
+  if (!IsActive())
+    return;
+
+  const Clock::time_point now = Clock::now();
+  ChargeCurrentSection(now);
+
+  // The first frame only started partway through, so it isn't recorded
+  if (s_frame_start)
+  {
+    FrameTimes times{frame, ToMilliseconds(now - *s_frame_start), {}, std::nullopt};
+    for (size_t i = 0; i < NUM_SECTIONS; ++i)
+      times.section_ms[i] = ToMilliseconds(s_section_times[i]);
+
+    std::lock_guard lock(s_frames_mutex);
+    s_frames.push_back(times);
+  }
+
+  s_frame_start = now;
+  s_section_times = {};
+}
+
+void AddGPUTime(u64 frame, double milliseconds)
+{
+  std::lock_guard lock(s_frames_mutex);
+  const auto it = std::find_if(s_frames.rbegin(), s_frames.rend(),
+                               [frame](const FrameTimes& times) { return times.frame == frame; });
+  if (it != s_frames.rend())
+    it->gpu_ms = milliseconds;
+}
+
+static std::string EscapeJSON(const std::string& str)
+{
+  std::string result;
+  for (const char c : str)
+  {
+    if (c == '"' || c == '\\')
+      result += '\\';
+    if (static_cast<unsigned char>(c) < 0x20)
+      result += fmt::format("\\u{:04x}", static_cast<int>(c));
+    else
+      result += c;
+  }
+  return result;
+}
+
+static std::string FormatOptional(const std::optional<double>& value, const char* none)
+{
+  return value ? fmt::format("{:.4f}", *value) : none;
+}
+
+static void WriteCSV(File::IOFile& file, const std::vector<FrameTimes>& frames)
+{
+  std::string header = "frame,frame_ms";
+  for (const char* name : SECTION_NAMES)
+    header += fmt::format(",{}", name);
+  file.WriteString(header + ",gpu_ms\n");
+
+  for (const FrameTimes& times : frames)
+  {
+    std::string line = fmt::format("{},{:.4f}", times.frame, times.frame_ms);
+    for (const double ms : times.section_ms)
+      line += fmt::format(",{:.4f}", ms);
+    file.WriteString(line + fmt::format(",{}\n", FormatOptional(times.gpu_ms, "")));
+  }
+}
+
+static void WriteJSON(File::IOFile& file, const std::vector<FrameTimes>& frames,
+                      const std::string& backend_name, std::string device_name)
+{
+  const auto& adapters = g_Config.backend_info.Adapters;
+  if (device_name.empty() && g_Config.iAdapter >= 0 &&
+      static_cast<size_t>(g_Config.iAdapter) < adapters.size())
+  {
+    device_name = adapters[g_Config.iAdapter];
+  }
+
+  file.WriteString(fmt::format("{{\n  \"description\": \"{}\",\n  \"backend\": \"{}\",\n"
+                               "  \"device\": \"{}\",\n  \"frames\": [\n",
+                               EscapeJSON(s_description), EscapeJSON(backend_name),
+                               EscapeJSON(device_name)));
+
+  for (size_t i = 0; i < frames.size(); ++i)
+  {
+    const FrameTimes& times = frames[i];
+    std::string line = fmt::format("    {{\"frame\": {}, \"frame_ms\": {:.4f}", times.frame,
+                                   times.frame_ms);
+    for (size_t j = 0; j < NUM_SECTIONS; ++j)
+      line += fmt::format(", \"{}\": {:.4f}", SECTION_NAMES[j], times.section_ms[j]);
+    line += fmt::format(", \"gpu_ms\": {}}}{}\n", FormatOptional(times.gpu_ms, "null"),
+                        i + 1 < frames.size() ? "," : "");
+    file.WriteString(line);
+  }
+
+  file.WriteString("  ]\n}\n");
+}
+
+void Shutdown(const std::string& backend_name)
+{
+  const std::string device_name = std::move(s_device_name);
+  s_device_name.clear();
+  if (!s_active.exchange(false))
+    return;
+
+  std::vector<FrameTimes> frames;
+  {
+    std::lock_guard lock(s_frames_mutex);
+    frames = std::move(s_frames);
+    s_frames.clear();
+  }
+
+  s_current_section.reset();
+  s_section_times = {};
+  s_frame_start.reset();
+
+  File::IOFile file(s_report_path, "w");
+  if (!file)
+  {
+    ERROR_LOG_FMT(VIDEO, "Failed to open {} for writing the frame timings", s_report_path);
+    return;
+  }
+
+  if (StringEndsWith(s_report_path, ".json"))
+    WriteJSON(file, frames, backend_name, device_name);
+  else
+    WriteCSV(file, frames);
+
+  NOTICE_LOG_FMT(VIDEO, "Wrote the timings of {} frames to {}", frames.size(), s_report_path);
+}
+}  // namespace FrameProfiler
@@ -0,0 +1,71 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// Measures how long each frame takes to emulate on the video thread, split up into the parts of
+// GPU emulation listed below, and how long the host GPU takes to render it if the backend can tell.
+// Used by the FIFO player's benchmark mode, which only enables it for the duration of a run, so
+// that the sections cost (almost) nothing otherwise. The results are written to a report when the
+// video backend shuts down.
+namespace FrameProfiler
+{
+// Nested sections are not included in their parent's time
+enum class Section
+{
+  // Everything in the command stream that isn't covered by one of the other sections
+  OpcodeDecoding,
+  VertexLoading,
+  TextureCache,
+  Present,
+  Count
+};
+
+// Starts collecting timings from the next frame on. A report path ending in .json gets a JSON
+// report, any other gets CSV.
+void Start(std::string report_path, std::string description);
+bool IsActive();
+
+// Shown in the report. Called by backends which know more about the host GPU than its adapter
+// name in VideoConfig.
+void SetDeviceName(std::string name);
+
+std::optional<Section> EnterSection(Section section);
+void LeaveSection(std::optional<Section> previous);
+
+class ScopedSection
+{
+public:
+  explicit ScopedSection(Section section) : m_active(IsActive())
+  {
+    if (m_active)
+      m_previous = EnterSection(section);
+  }
+  ~ScopedSection()
+  {
+    if (m_active)
+      LeaveSection(m_previous);
+  }
+
+  ScopedSection(const ScopedSection&) = delete;
+  ScopedSection& operator=(const ScopedSection&) = delete;
+
+private:
+  bool m_active;
+  std::optional<Section> m_previous;
+};
+
+// Called by the renderer on the video thread when the given frame ends.
+void EndFrame(u64 frame);
+// For backends that support timer queries. The results may arrive several frames late.
+void AddGPUTime(u64 frame, double milliseconds);
+
+// Writes the report if timings were collected, and stops collecting them.
+void Shutdown(const std::string& backend_name);
+}  // namespace FrameProfiler
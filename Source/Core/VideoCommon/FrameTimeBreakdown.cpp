@@ -0,0 +1,241 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/FrameTimeBreakdown.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <utility>
+
+#include <fmt/format.h>
+#include <imgui.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace FrameTimeBreakdown
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t NUM_CATEGORIES = static_cast<size_t>(Category::Count);
+constexpr std::array<const char*, NUM_CATEGORIES> CATEGORY_NAMES = {
+    "CPU emulation", "CPU waiting", "GPU commands", "Backend submission", "Present wait", "Audio"};
+constexpr std::array<const char*, NUM_CATEGORIES> CATEGORY_COLUMNS = {
+    "cpu_emulation_ms",      "cpu_wait_ms",     "gpu_commands_ms",
+    "backend_submission_ms", "present_wait_ms", "audio_ms"};
+constexpr std::array<ImU32, NUM_CATEGORIES> CATEGORY_COLORS = {
+    IM_COL32(80, 160, 255, 255), IM_COL32(110, 110, 110, 255), IM_COL32(255, 160, 40, 255),
+    IM_COL32(230, 80, 80, 255),  IM_COL32(120, 220, 100, 255), IM_COL32(200, 120, 255, 255)};
+
+// The number of frames shown in the overlay
+constexpr size_t HISTORY_SIZE = 120;
+
+struct FrameTimes
+{
+  double frame_ms;
+  std::array<double, NUM_CATEGORIES> category_ms;
+};
+
+static std::atomic<bool> s_active{false};
+static std::array<std::atomic<u64>, NUM_CATEGORIES> s_category_ns{};
+
+thread_local std::optional<Category> t_category;
+// Left empty while inactive, so that time from before the breakdown was turned on isn't counted
+thread_local Clock::time_point t_category_start;
+
+// Only used on the video thread
+static std::optional<Clock::time_point> s_last_frame_end;
+static std::array<FrameTimes, HISTORY_SIZE> s_history;
+static size_t s_history_size = 0;
+static size_t s_history_next = 0;
+static File::IOFile s_log_file;
+
+static double ToMilliseconds(Clock::duration duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static void ChargeCurrentCategory()
+{
+  if (!IsActive())
+  {
+    t_category_start = {};
+    return;
+  }
+
+  const Clock::time_point now = Clock::now();
+  if (t_category && t_category_start != Clock::time_point{})
+  {
+    const auto elapsed =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - t_category_start);
+    s_category_ns[static_cast<size_t>(*t_category)].fetch_add(elapsed.count(),
+                                                              std::memory_order_relaxed);
+  }
+  t_category_start = now;
+}
+
+bool IsActive()
+{
+  return s_active.load(std::memory_order_relaxed);
+}
+
+std::optional<Category> EnterCategory(Category category)
+{
+  ChargeCurrentCategory();
+  return std::exchange(t_category, category);
+}
+
+void LeaveCategory(std::optional<Category> previous)
+{
+  ChargeCurrentCategory();
+  t_category = previous;
+}
+
+static void WriteLogLine(u64 frame, const FrameTimes& times)
+{
+  if (!s_log_file.IsOpen())
+  {
+    const std::string path = File::GetUserPath(D_LOGS_IDX) + "frame_time_breakdown.csv";
+    if (!s_log_file.Open(path, "w"))
+    {
+      ERROR_LOG_FMT(VIDEO, "Failed to open {} for writing the frame time breakdown", path);
+      return;
+    }
+
+    std::string header = "frame,frame_ms";
+    for (const char* column : CATEGORY_COLUMNS)
+      header += fmt::format(",{}", column);
+    s_log_file.WriteString(header + "\n");
+  }
+
+  std::string line = fmt::format("{},{:.4f}", frame, times.frame_ms);
+  for (const double ms : times.category_ms)
+    line += fmt::format(",{:.4f}", ms);
+  s_log_file.WriteString(line + "\n");
+}
+
+void EndFrame(u64 frame)
+{
+  const bool log = g_ActiveConfig.bLogFrameTimeBreakdownToFile;
+  const bool active = g_ActiveConfig.bShowFrameTimeBreakdown || log;
+  if (!log && s_log_file.IsOpen())
+    s_log_file.Close();
+
+  ChargeCurrentCategory();
+  s_active.store(active, std::memory_order_relaxed);
+
+  // Times collected before the breakdown was turned on only cover part of a frame.
+  const Clock::time_point now = Clock::now();
+  const bool complete_frame = active && s_last_frame_end;
+  FrameTimes times{complete_frame ? ToMilliseconds(now - *s_last_frame_end) : 0.0, {}};
+  for (size_t i = 0; i < NUM_CATEGORIES; ++i)
+  {
+    const u64 ns = s_category_ns[i].exchange(0, std::memory_order_relaxed);
+    times.category_ms[i] = ns / 1000000.0;
+  }
+  s_last_frame_end = active ? std::optional(now) : std::nullopt;
+
+  if (!complete_frame)
+    return;
+
+  s_history[s_history_next] = times;
+  s_history_next = (s_history_next + 1) % HISTORY_SIZE;
+  s_history_size = std::min(s_history_size + 1, HISTORY_SIZE);
+
+  if (log)
+    WriteLogLine(frame, times);
+}
+
+void Draw(float scale)
+{
+  if (!g_ActiveConfig.bShowFrameTimeBreakdown || s_history_size == 0)
+    return;
+
+  ImGui::SetNextWindowPos(ImVec2(10.0f * scale, ImGui::GetIO().DisplaySize.y - 10.0f * scale),
+                          ImGuiCond_FirstUseEver, ImVec2(0.0f, 1.0f));
+  if (!ImGui::Begin("Frame Time Breakdown", nullptr,
+                    ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_AlwaysAutoResize))
+  {
+    ImGui::End();
+    return;
+  }
+
+  // The frames in the order they happened
+  const auto frame_at = [](size_t i) -> const FrameTimes& {
+    return s_history[(s_history_next + HISTORY_SIZE - s_history_size + i) % HISTORY_SIZE];
+  };
+
+  FrameTimes average{};
+  double max_ms = 1.0;
+  for (size_t i = 0; i < s_history_size; ++i)
+  {
+    const FrameTimes& times = frame_at(i);
+    average.frame_ms += times.frame_ms / s_history_size;
+    double stacked_ms = 0.0;
+    for (size_t j = 0; j < NUM_CATEGORIES; ++j)
+    {
+      average.category_ms[j] += times.category_ms[j] / s_history_size;
+      stacked_ms += times.category_ms[j];
+    }
+    max_ms = std::max({max_ms, times.frame_ms, stacked_ms});
+  }
+
+  ImGui::Text("Frame: %.2f ms", average.frame_ms);
+  for (size_t i = 0; i < NUM_CATEGORIES; ++i)
+  {
+    ImGui::TextColored(ImGui::ColorConvertU32ToFloat4(CATEGORY_COLORS[i]), "%s: %.2f ms",
+                       CATEGORY_NAMES[i], average.category_ms[i]);
+  }
+
+  // One stacked bar per frame. Several threads run at the same time, so a bar can be taller than
+  // the frame time, which is drawn as a line.
+  const ImVec2 size(2.0f * HISTORY_SIZE * scale, 80.0f * scale);
+  const ImVec2 origin = ImGui::GetCursorScreenPos();
+  const float bar_width = size.x / HISTORY_SIZE;
+  const float pixels_per_ms = static_cast<float>(size.y / max_ms);
+  ImDrawList* draw_list = ImGui::GetWindowDrawList();
+  draw_list->AddRectFilled(origin, ImVec2(origin.x + size.x, origin.y + size.y),
+                           IM_COL32(0, 0, 0, 128));
+  for (size_t i = 0; i < s_history_size; ++i)
+  {
+    const FrameTimes& times = frame_at(i);
+    const float left = origin.x + (HISTORY_SIZE - s_history_size + i) * bar_width;
+    float bottom = origin.y + size.y;
+    for (size_t j = 0; j < NUM_CATEGORIES; ++j)
+    {
+      const float top = bottom - static_cast<float>(times.category_ms[j]) * pixels_per_ms;
+      draw_list->AddRectFilled(ImVec2(left, top), ImVec2(left + bar_width, bottom),
+                               CATEGORY_COLORS[j]);
+      bottom = top;
+    }
+
+    const float frame_top = origin.y + size.y - static_cast<float>(times.frame_ms) * pixels_per_ms;
+    draw_list->AddLine(ImVec2(left, frame_top), ImVec2(left + bar_width, frame_top),
+                       IM_COL32(255, 255, 255, 255), scale);
+  }
+  ImGui::Dummy(size);
+  ImGui::Text("Scale: %.1f ms", max_ms);
+
+  ImGui::End();
+}
+
+void Shutdown()
+{
+  s_active.store(false, std::memory_order_relaxed);
+  for (std::atomic<u64>& ns : s_category_ns)
+    ns.store(0, std::memory_order_relaxed);
+
+  s_last_frame_end.reset();
+  s_history_size = 0;
+  s_history_next = 0;
+  if (s_log_file.IsOpen())
+    s_log_file.Close();
+}
+}  // namespace FrameTimeBreakdown
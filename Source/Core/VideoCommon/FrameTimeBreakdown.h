@@ -0,0 +1,58 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <optional>
+
+#include "Common/CommonTypes.h"
+
+// Splits up where the time of every frame goes across all emulation threads, for the frame time
+// overlay and the CSV log, so that frame pacing problems can be narrowed down without an external
+// profiler. Unlike FrameProfiler, which only looks at the video thread during FIFO player
+// benchmarks, this can be turned on at any time.
+//
+// Each thread is in at most one category at a time. Nested scopes are not included in their
+// parent's time, so that, for example, GPU command processing that runs on the CPU thread in single
+// core mode is not counted as CPU emulation.
+namespace FrameTimeBreakdown
+{
+enum class Category
+{
+  CPUEmulation,
+  // The CPU thread waiting for the throttle or the GPU thread
+  CPUWait,
+  GPUCommands,
+  BackendSubmission,
+  PresentWait,
+  Audio,
+  Count
+};
+
+bool IsActive();
+
+// Makes `category` the current category of the calling thread, and returns the previous one.
+std::optional<Category> EnterCategory(Category category);
+void LeaveCategory(std::optional<Category> previous);
+
+class ScopedCategory
+{
+public:
+  explicit ScopedCategory(Category category) : m_previous(EnterCategory(category)) {}
+  ~ScopedCategory() { LeaveCategory(m_previous); }
+
+  ScopedCategory(const ScopedCategory&) = delete;
+  ScopedCategory& operator=(const ScopedCategory&) = delete;
+
+private:
+  std::optional<Category> m_previous;
+};
+
+// Called by the renderer on the video thread when a frame ends. Also picks up changes to the
+// overlay and logging settings.
+void EndFrame(u64 frame);
+// Draws the overlay. Must be called with the ImGui lock held.
+void Draw(float scale);
+void Shutdown();
+}  // namespace FrameTimeBreakdown
@@ -4,6 +4,7 @@
 
 #include "VideoCommon/FramebufferManager.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "Common/ChunkFile.h"
@@ -346,6 +347,11 @@ bool FramebufferManager::IsUsingTiledEFBCache() const
   return m_efb_cache_tile_size > 0;
 }
 
+bool FramebufferManager::IsPrefetchingEFBCache() const
+{
+  return IsUsingTiledEFBCache() && g_ActiveConfig.iEFBAccessMaxStaleness > 0;
+}
+
 bool FramebufferManager::IsEFBCacheTilePresent(bool depth, u32 x, u32 y, u32* tile_index) const
 {
   const EFBCacheData& data = depth ? m_efb_depth_cache : m_efb_color_cache;
@@ -358,10 +364,21 @@ bool FramebufferManager::IsEFBCacheTilePresent(bool depth, u32 x, u32 y, u32* ti
   {
     *tile_index =
         ((y / m_efb_cache_tile_size) * m_efb_cache_tiles_wide) + (x / m_efb_cache_tile_size);
-    return data.valid && data.tiles[*tile_index];
+    return IsEFBCacheTileUsable(data, *tile_index);
   }
 }
 
+bool FramebufferManager::IsEFBCacheTileUsable(const EFBCacheData& data, u32 tile_index) const
+{
+  if (!data.valid || !data.tiles[tile_index])
+    return false;
+
+  // When prefetching, tiles survive draws and are instead retired once they are too old.
+  return !IsPrefetchingEFBCache() ||
+         (m_efb_cache_frame - data.tile_frames[tile_index]) <=
+             static_cast<u64>(g_ActiveConfig.iEFBAccessMaxStaleness);
+}
+
 MathUtil::Rectangle<int> FramebufferManager::GetEFBCacheTileRect(u32 tile_index) const
 {
   if (m_efb_cache_tile_size == 0)
@@ -385,6 +402,8 @@ u32 FramebufferManager::PeekEFBColor(u32 x, u32 y)
   u32 tile_index;
   if (!IsEFBCacheTilePresent(false, x, y, &tile_index))
     PopulateEFBCache(false, tile_index);
+  if (IsPrefetchingEFBCache())
+    m_efb_color_cache.tiles_accessed[tile_index] = true;
 
   u32 value;
   m_efb_color_cache.readback_texture->ReadTexel(x, y, &value);
@@ -400,6 +419,8 @@ float FramebufferManager::PeekEFBDepth(u32 x, u32 y)
   u32 tile_index;
   if (!IsEFBCacheTilePresent(true, x, y, &tile_index))
     PopulateEFBCache(true, tile_index);
+  if (IsPrefetchingEFBCache())
+    m_efb_depth_cache.tiles_accessed[tile_index] = true;
 
   float value;
   m_efb_depth_cache.readback_texture->ReadTexel(x, y, &value);
@@ -420,10 +441,19 @@ void FramebufferManager::SetEFBCacheTileSize(u32 size)
 
 void FramebufferManager::InvalidatePeekCache(bool forced)
 {
+  // Prefetched tiles are allowed to lag behind the EFB, so only drop them when forced to.
+  if (!forced && IsPrefetchingEFBCache())
+  {
+    m_efb_color_cache.out_of_date = false;
+    m_efb_depth_cache.out_of_date = false;
+    return;
+  }
+
   if (forced || m_efb_color_cache.out_of_date)
   {
     if (m_efb_color_cache.valid)
       std::fill(m_efb_color_cache.tiles.begin(), m_efb_color_cache.tiles.end(), false);
+    std::fill(m_efb_color_cache.tiles_pending.begin(), m_efb_color_cache.tiles_pending.end(), false);
 
     m_efb_color_cache.valid = false;
     m_efb_color_cache.out_of_date = false;
@@ -432,6 +462,7 @@ void FramebufferManager::InvalidatePeekCache(bool forced)
   {
     if (m_efb_depth_cache.valid)
       std::fill(m_efb_depth_cache.tiles.begin(), m_efb_depth_cache.tiles.end(), false);
+    std::fill(m_efb_depth_cache.tiles_pending.begin(), m_efb_depth_cache.tiles_pending.end(), false);
 
     m_efb_depth_cache.valid = false;
     m_efb_depth_cache.out_of_date = false;
@@ -449,6 +480,28 @@ void FramebufferManager::FlagPeekCacheAsOutOfDate()
     InvalidatePeekCache();
 }
 
+void FramebufferManager::OnEndFrame()
+{
+  if (IsPrefetchingEFBCache())
+  {
+    // Games which read the EFB from the CPU tend to read the same area every frame, so start
+    // reading back this frame's contents now. By the time the tiles are accessed next frame the
+    // copies will most likely have completed, and waiting on them will not stall.
+    for (const bool depth : {false, true})
+    {
+      EFBCacheData& data = depth ? m_efb_depth_cache : m_efb_color_cache;
+      for (u32 i = 0; i < static_cast<u32>(data.tiles_accessed.size()); i++)
+      {
+        if (data.tiles_accessed[i] && !data.tiles_pending[i])
+          QueueEFBCacheTileCopy(depth, i);
+      }
+      std::fill(data.tiles_accessed.begin(), data.tiles_accessed.end(), false);
+    }
+  }
+
+  m_efb_cache_frame++;
+}
+
 bool FramebufferManager::CompileReadbackPipelines()
 {
   AbstractPipelineConfig config = {};
@@ -562,10 +615,13 @@ bool FramebufferManager::CreateReadbackFramebuffer()
     const u32 tiles_wide = ((EFB_WIDTH + (m_efb_cache_tile_size - 1)) / m_efb_cache_tile_size);
     const u32 tiles_high = ((EFB_HEIGHT + (m_efb_cache_tile_size - 1)) / m_efb_cache_tile_size);
     const u32 total_tiles = tiles_wide * tiles_high;
-    m_efb_color_cache.tiles.resize(total_tiles);
-    std::fill(m_efb_color_cache.tiles.begin(), m_efb_color_cache.tiles.end(), false);
-    m_efb_depth_cache.tiles.resize(total_tiles);
-    std::fill(m_efb_depth_cache.tiles.begin(), m_efb_depth_cache.tiles.end(), false);
+    for (EFBCacheData* data : {&m_efb_color_cache, &m_efb_depth_cache})
+    {
+      data->tiles.assign(total_tiles, false);
+      data->tiles_pending.assign(total_tiles, false);
+      data->tiles_accessed.assign(total_tiles, false);
+      data->tile_frames.assign(total_tiles, 0);
+    }
     m_efb_cache_tiles_wide = tiles_wide;
   }
 
@@ -588,6 +644,70 @@ void FramebufferManager::PopulateEFBCache(bool depth, u32 tile_index)
 {
   g_vertex_manager->OnCPUEFBAccess();
 
+  // Pokes can outlive draws, so make sure any pending ones are visible to the readback.
+  FlushEFBPokes();
+
+  EFBCacheData& data = depth ? m_efb_depth_cache : m_efb_color_cache;
+  if (!IsPrefetchingEFBCache())
+  {
+    QueueEFBCacheTileCopy(depth, tile_index);
+
+    // Wait until the copy is complete.
+    data.readback_texture->Flush();
+    data.valid = true;
+    data.out_of_date = false;
+    if (IsUsingTiledEFBCache())
+      data.tiles[tile_index] = true;
+    return;
+  }
+
+  // The tile may already be in flight from the previous frame, in which case we only need to wait.
+  // Otherwise, read back the neighbouring tiles along with it, since we have to wait anyway.
+  if (!data.tiles_pending[tile_index])
+  {
+    QueueEFBCacheTileCopy(depth, tile_index);
+    PrefetchAdjacentEFBCacheTiles(depth, tile_index);
+  }
+
+  // Waiting retires every outstanding copy, not just the one for this tile.
+  data.readback_texture->Flush();
+  for (u32 i = 0; i < static_cast<u32>(data.tiles_pending.size()); i++)
+  {
+    if (data.tiles_pending[i])
+    {
+      data.tiles[i] = true;
+      data.tiles_pending[i] = false;
+    }
+  }
+  data.valid = true;
+  data.out_of_date = false;
+}
+
+void FramebufferManager::PrefetchAdjacentEFBCacheTiles(bool depth, u32 tile_index)
+{
+  const EFBCacheData& data = depth ? m_efb_depth_cache : m_efb_color_cache;
+  const u32 tiles_high = static_cast<u32>(data.tiles.size()) / m_efb_cache_tiles_wide;
+  const s32 tile_x = static_cast<s32>(tile_index % m_efb_cache_tiles_wide);
+  const s32 tile_y = static_cast<s32>(tile_index / m_efb_cache_tiles_wide);
+  for (s32 y = tile_y - 1; y <= tile_y + 1; y++)
+  {
+    for (s32 x = tile_x - 1; x <= tile_x + 1; x++)
+    {
+      if (x < 0 || y < 0 || x >= static_cast<s32>(m_efb_cache_tiles_wide) ||
+          y >= static_cast<s32>(tiles_high))
+      {
+        continue;
+      }
+
+      const u32 index = static_cast<u32>(y) * m_efb_cache_tiles_wide + static_cast<u32>(x);
+      if (index != tile_index && !data.tiles_pending[index] && !IsEFBCacheTileUsable(data, index))
+        QueueEFBCacheTileCopy(depth, index);
+    }
+  }
+}
+
+void FramebufferManager::QueueEFBCacheTileCopy(bool depth, u32 tile_index)
+{
   // Force the path through the intermediate texture, as we can't do an image copy from a depth
   // buffer directly to a staging texture (must be the whole resource).
   const bool force_intermediate_copy =
@@ -642,12 +762,13 @@ void FramebufferManager::PopulateEFBCache(bool depth, u32 tile_index)
     data.readback_texture->CopyFromTexture(src_texture, rect, 0, 0, rect);
   }
 
-  // Wait until the copy is complete.
-  data.readback_texture->Flush();
-  data.valid = true;
-  data.out_of_date = false;
-  if (IsUsingTiledEFBCache())
-    data.tiles[tile_index] = true;
+  if (IsPrefetchingEFBCache())
+  {
+    // The copy overwrites the texels, so the tile cannot be read until it has been waited on.
+    data.tiles[tile_index] = false;
+    data.tiles_pending[tile_index] = true;
+    data.tile_frames[tile_index] = m_efb_cache_frame;
+  }
 }
 
 void FramebufferManager::ClearEFB(const MathUtil::Rectangle<int>& rc, bool clear_color,
@@ -739,10 +860,10 @@ void FramebufferManager::DestroyClearPipelines()
 void FramebufferManager::PokeEFBColor(u32 x, u32 y, u32 color)
 {
   // Flush if we exceeded the number of vertices per batch.
-  if ((m_color_poke_vertices.size() + 6) > MAX_POKE_VERTICES)
+  if ((m_color_pokes.vertices.size() + 6) > MAX_POKE_VERTICES)
     FlushEFBPokes();
 
-  CreatePokeVertices(&m_color_poke_vertices, x, y, 0.0f, color);
+  AddPoke(&m_color_pokes, x, y, 0.0f, color);
 
   // See comment above for reasoning for lower-left coordinates.
   if (g_ActiveConfig.backend_info.bUsesLowerLeftOrigin)
@@ -757,10 +878,10 @@ void FramebufferManager::PokeEFBColor(u32 x, u32 y, u32 color)
 void FramebufferManager::PokeEFBDepth(u32 x, u32 y, float depth)
 {
   // Flush if we exceeded the number of vertices per batch.
-  if ((m_depth_poke_vertices.size() + 6) > MAX_POKE_VERTICES)
+  if ((m_depth_pokes.vertices.size() + 6) > MAX_POKE_VERTICES)
     FlushEFBPokes();
 
-  CreatePokeVertices(&m_depth_poke_vertices, x, y, depth, 0);
+  AddPoke(&m_depth_pokes, x, y, depth, 0);
 
   // See comment above for reasoning for lower-left coordinates.
   if (g_ActiveConfig.backend_info.bUsesLowerLeftOrigin)
@@ -800,23 +921,88 @@ void FramebufferManager::CreatePokeVertices(std::vector<EFBPokeVertex>* destinat
   destination_list->push_back({{x2, y2, z, 1.0f}, color});
 }
 
+void FramebufferManager::AddPoke(EFBPokeBatch* batch, u32 x, u32 y, float z, u32 color)
+{
+  if (x >= EFB_WIDTH || y >= EFB_HEIGHT)
+  {
+    CreatePokeVertices(&batch->vertices, x, y, z, color);
+    batch->bounds = MathUtil::Rectangle<int>(0, 0, EFB_WIDTH, EFB_HEIGHT);
+    return;
+  }
+
+  if (batch->pixel_vertices.empty())
+    batch->pixel_vertices.resize(EFB_WIDTH * EFB_HEIGHT);
+
+  // If the pixel has already been poked, overwrite the earlier value in place.
+  const u32 pixel = y * EFB_WIDTH + x;
+  const u32 existing = batch->pixel_vertices[pixel];
+  if (existing != 0)
+  {
+    const u32 vertex_count = g_ActiveConfig.backend_info.bSupportsLargePoints ? 1 : 6;
+    for (u32 i = existing - 1; i < existing - 1 + vertex_count; i++)
+    {
+      batch->vertices[i].position[2] = z;
+      batch->vertices[i].color = color;
+    }
+    return;
+  }
+
+  const int ix = static_cast<int>(x);
+  const int iy = static_cast<int>(y);
+  if (batch->vertices.empty())
+  {
+    batch->bounds = MathUtil::Rectangle<int>(ix, iy, ix + 1, iy + 1);
+  }
+  else
+  {
+    batch->bounds.left = std::min(batch->bounds.left, ix);
+    batch->bounds.top = std::min(batch->bounds.top, iy);
+    batch->bounds.right = std::max(batch->bounds.right, ix + 1);
+    batch->bounds.bottom = std::max(batch->bounds.bottom, iy + 1);
+  }
+
+  batch->pixel_vertices[pixel] = static_cast<u32>(batch->vertices.size()) + 1;
+  batch->pixels.push_back(pixel);
+  CreatePokeVertices(&batch->vertices, x, y, z, color);
+}
+
+void FramebufferManager::ClearPokes(EFBPokeBatch* batch)
+{
+  for (const u32 pixel : batch->pixels)
+    batch->pixel_vertices[pixel] = 0;
+
+  batch->pixels.clear();
+  batch->vertices.clear();
+}
+
 void FramebufferManager::FlushEFBPokes()
 {
-  if (!m_color_poke_vertices.empty())
+  if (!m_color_pokes.vertices.empty())
   {
-    DrawPokeVertices(m_color_poke_vertices.data(), static_cast<u32>(m_color_poke_vertices.size()),
-                     m_color_poke_pipeline.get());
-    m_color_poke_vertices.clear();
+    DrawPokeVertices(m_color_pokes.vertices.data(),
+                     static_cast<u32>(m_color_pokes.vertices.size()), m_color_poke_pipeline.get());
+    ClearPokes(&m_color_pokes);
   }
 
-  if (!m_depth_poke_vertices.empty())
+  if (!m_depth_pokes.vertices.empty())
   {
-    DrawPokeVertices(m_depth_poke_vertices.data(), static_cast<u32>(m_depth_poke_vertices.size()),
-                     m_depth_poke_pipeline.get());
-    m_depth_poke_vertices.clear();
+    DrawPokeVertices(m_depth_pokes.vertices.data(),
+                     static_cast<u32>(m_depth_pokes.vertices.size()), m_depth_poke_pipeline.get());
+    ClearPokes(&m_depth_pokes);
   }
 }
 
+void FramebufferManager::FlushEFBPokesInRect(const MathUtil::Rectangle<int>& rect)
+{
+  const auto overlaps = [&rect](const EFBPokeBatch& batch) {
+    return !batch.vertices.empty() && batch.bounds.left < rect.right &&
+           rect.left < batch.bounds.right && batch.bounds.top < rect.bottom &&
+           rect.top < batch.bounds.bottom;
+  };
+  if (overlaps(m_color_pokes) || overlaps(m_depth_pokes))
+    FlushEFBPokes();
+}
+
 void FramebufferManager::DrawPokeVertices(const EFBPokeVertex* vertices, u32 vertex_count,
                                           const AbstractPipeline* pipeline)
 {
@@ -906,7 +1092,8 @@ void FramebufferManager::DoState(PointerWrap& p)
     DoLoadState(p);
 }
 
-void FramebufferManager::DoSaveState(PointerWrap& p)
+std::array<std::pair<AbstractTexture*, TextureConfig>, 2>
+FramebufferManager::ResolveEFBForSaveState()
 {
   // For multisampling, we need to resolve first before we can save.
   // This won't be bit-exact when loading, which could cause interesting rendering side-effects for
@@ -918,12 +1105,28 @@ void FramebufferManager::DoSaveState(PointerWrap& p)
   const TextureConfig color_texture_config(color_texture->GetWidth(), color_texture->GetHeight(),
                                            color_texture->GetLevels(), color_texture->GetLayers(),
                                            1, GetEFBColorFormat(), 0);
-  g_texture_cache->SerializeTexture(color_texture, color_texture_config, p);
-
   const TextureConfig depth_texture_config(depth_texture->GetWidth(), depth_texture->GetHeight(),
                                            depth_texture->GetLevels(), depth_texture->GetLayers(),
                                            1, GetEFBDepthCopyFormat(), 0);
-  g_texture_cache->SerializeTexture(depth_texture, depth_texture_config, p);
+  return {{{color_texture, color_texture_config}, {depth_texture, depth_texture_config}}};
+}
+
+void FramebufferManager::QueueSaveStateReadbacks()
+{
+  if (!Config::Get(Config::GFX_SAVE_TEXTURE_CACHE_TO_STATE))
+    return;
+
+  FlushEFBPokes();
+  for (const auto& [texture, config] : ResolveEFBForSaveState())
+    g_texture_cache->QueueTextureReadback(texture, config);
+}
+
+void FramebufferManager::DoSaveState(PointerWrap& p)
+{
+  // Resolving again gives the same result as for QueueSaveStateReadbacks, as nothing is drawn in
+  // between.
+  for (const auto& [texture, config] : ResolveEFBForSaveState())
+    g_texture_cache->SerializeTexture(texture, config, p);
 }
 
 void FramebufferManager::DoLoadState(PointerWrap& p)
@@ -7,6 +7,7 @@
 #include <array>
 #include <memory>
 #include <optional>
+#include <utility>
 
 #include "Common/CommonTypes.h"
 #include "VideoCommon/AbstractFramebuffer.h"
@@ -93,14 +94,26 @@ public:
   void InvalidatePeekCache(bool forced = true);
   void FlagPeekCacheAsOutOfDate();
 
+  // Queues readbacks of the peek cache tiles accessed during the frame, so that the next frame's
+  // accesses do not have to wait on the GPU. Only does anything when prefetching is enabled.
+  void OnEndFrame();
+
   // Writes a value to the framebuffer. This will never block, and writes will be batched.
+  // Repeated writes to the same pixel replace each other within a batch.
   void PokeEFBColor(u32 x, u32 y, u32 color);
   void PokeEFBDepth(u32 x, u32 y, float depth);
   void FlushEFBPokes();
 
+  // Flushes pending pokes only if they could be affected by drawing to the given native-resolution
+  // EFB rectangle, so that draws elsewhere in the EFB do not break up the batch.
+  void FlushEFBPokesInRect(const MathUtil::Rectangle<int>& rect);
+
   // Save state load/save.
   void DoState(PointerWrap& p);
 
+  // Starts reading back the EFB for saving a state, see TextureCacheBase::QueueTextureReadback.
+  void QueueSaveStateReadbacks();
+
 protected:
   struct EFBPokeVertex
   {
@@ -109,6 +122,16 @@ protected:
   };
   static_assert(std::is_standard_layout<EFBPokeVertex>::value, "EFBPokeVertex is standard-layout");
 
+  // Pending pokes of one kind. pixel_vertices maps each EFB pixel to one past the offset of its
+  // vertices, or zero if the pixel has not been poked, and is only allocated once used.
+  struct EFBPokeBatch
+  {
+    std::vector<EFBPokeVertex> vertices;
+    std::vector<u32> pixel_vertices;
+    std::vector<u32> pixels;
+    MathUtil::Rectangle<int> bounds;
+  };
+
   // EFB cache - for CPU EFB access
   // Tiles are ordered left-to-right, then top-to-bottom
   struct EFBCacheData
@@ -118,6 +141,13 @@ protected:
     std::unique_ptr<AbstractStagingTexture> readback_texture;
     std::unique_ptr<AbstractPipeline> copy_pipeline;
     std::vector<bool> tiles;
+
+    // Prefetching state. Pending tiles have had a copy queued but not yet waited on, and
+    // tile_frames records which frame's EFB contents each tile holds.
+    std::vector<bool> tiles_pending;
+    std::vector<bool> tiles_accessed;
+    std::vector<u64> tile_frames;
+
     bool out_of_date;
     bool valid;
   };
@@ -141,12 +171,18 @@ protected:
   void DestroyPokePipelines();
 
   bool IsUsingTiledEFBCache() const;
+  bool IsPrefetchingEFBCache() const;
   bool IsEFBCacheTilePresent(bool depth, u32 x, u32 y, u32* tile_index) const;
+  bool IsEFBCacheTileUsable(const EFBCacheData& data, u32 tile_index) const;
   MathUtil::Rectangle<int> GetEFBCacheTileRect(u32 tile_index) const;
   void PopulateEFBCache(bool depth, u32 tile_index);
+  void QueueEFBCacheTileCopy(bool depth, u32 tile_index);
+  void PrefetchAdjacentEFBCacheTiles(bool depth, u32 tile_index);
 
   void CreatePokeVertices(std::vector<EFBPokeVertex>* destination_list, u32 x, u32 y, float z,
                           u32 color);
+  void AddPoke(EFBPokeBatch* batch, u32 x, u32 y, float z, u32 color);
+  void ClearPokes(EFBPokeBatch* batch);
 
   void DrawPokeVertices(const EFBPokeVertex* vertices, u32 vertex_count,
                         const AbstractPipeline* pipeline);
@@ -154,6 +190,10 @@ protected:
   void DoLoadState(PointerWrap& p);
   void DoSaveState(PointerWrap& p);
 
+  // Resolves the EFB color and depth textures, and returns them with the configs they are saved
+  // with.
+  std::array<std::pair<AbstractTexture*, TextureConfig>, 2> ResolveEFBForSaveState();
+
   std::unique_ptr<AbstractTexture> m_efb_color_texture;
   std::unique_ptr<AbstractTexture> m_efb_convert_color_texture;
   std::unique_ptr<AbstractTexture> m_efb_depth_texture;
@@ -174,6 +214,7 @@ protected:
   // EFB cache - for CPU EFB access
   u32 m_efb_cache_tile_size = 0;
   u32 m_efb_cache_tiles_wide = 0;
+  u64 m_efb_cache_frame = 0;
   EFBCacheData m_efb_color_cache = {};
   EFBCacheData m_efb_depth_cache = {};
 
@@ -186,8 +227,8 @@ protected:
   std::unique_ptr<NativeVertexFormat> m_poke_vertex_format;
   std::unique_ptr<AbstractPipeline> m_color_poke_pipeline;
   std::unique_ptr<AbstractPipeline> m_depth_poke_pipeline;
-  std::vector<EFBPokeVertex> m_color_poke_vertices;
-  std::vector<EFBPokeVertex> m_depth_poke_vertices;
+  EFBPokeBatch m_color_pokes;
+  EFBPokeBatch m_depth_pokes;
 };
 
 extern std::unique_ptr<FramebufferManager> g_framebuffer_manager;
@@ -5,22 +5,28 @@
 #include "VideoCommon/HiresTextures.h"
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include <xxhash.h>
 
 #include <fmt/format.h>
 
+#include "Common/Align.h"
+#include "Common/CPUDetect.h"
 #include "Common/CommonPaths.h"
 #include "Common/FileSearch.h"
 #include "Common/FileUtil.h"
-#include "Common/Flag.h"
 #include "Common/IOFile.h"
 #include "Common/Image.h"
 #include "Common/Logging/Log.h"
@@ -28,26 +34,110 @@
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
 #include "Common/Thread.h"
+#include "Common/ThreadPool.h"
 #include "Common/Timer.h"
 #include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
 #include "VideoCommon/OnScreenDisplay.h"
+#include "VideoCommon/TextureCompression.h"
+#include "VideoCommon/TexturePack.h"
 #include "VideoCommon/VideoConfig.h"
 
-struct DiskTexture
+struct HiresTexture::DiskTexture
 {
   std::string path;
   bool has_arbitrary_mipmaps;
+  // For textures in a texture pack, the pack and the index of the texture in it.
+  std::shared_ptr<const TexturePack> pack;
+  size_t pack_index = 0;
+};
+
+struct CachedTexture
+{
+  std::shared_ptr<HiresTexture> texture;
+  size_t size;
+  // Position in s_textureCacheLRU, the most recently used textures are at the front.
+  std::list<std::string>::iterator lru_iter;
+};
+
+struct LoadRequest
+{
+  std::string base_filename;
+  u32 width;
+  u32 height;
 };
 
 constexpr std::string_view s_format_prefix{"tex1_"};
 
-static std::unordered_map<std::string, DiskTexture> s_textureMap;
-static std::unordered_map<std::string, std::shared_ptr<HiresTexture>> s_textureCache;
+static HiresTexture::TextureMap s_textureMap;
+
+// Everything below is guarded by s_textureCacheMutex.
 static std::mutex s_textureCacheMutex;
-static Common::Flag s_textureCacheAbortLoading;
+static std::unordered_map<std::string, CachedTexture> s_textureCache;
+static std::list<std::string> s_textureCacheLRU;
+static size_t s_textureCacheSize;
+static size_t s_textureCacheBudget;
+
+// Textures the texture cache is waiting for are loaded before the ones which are only prefetched.
+// The most recently requested ones come first, as they are the most likely to still be in use.
+static std::deque<LoadRequest> s_demandQueue;
+static std::deque<std::string> s_prefetchQueue;
+static std::unordered_set<std::string> s_pendingTextures;
+static std::unordered_set<std::string> s_failedTextures;
+static size_t s_prefetchRemaining;
+static u32 s_prefetchStartTime;
+
+// Set by StartIndexing, and taken by the next Update
+static std::future<HiresTexture::TextureMap> s_index;
+static std::string s_index_game_id;
+
+static std::vector<std::thread> s_loaders;
+static std::condition_variable s_loaderWake;
+static bool s_exitLoaders;
+
+static size_t GetTextureCacheBudget()
+{
+  if (g_ActiveConfig.iHiresTextureCacheSize > 0)
+    return static_cast<size_t>(g_ActiveConfig.iHiresTextureCacheSize) * 1024 * 1024;
+
+  const size_t sys_mem = Common::MemPhysical();
+  const size_t recommended_min_mem = 2 * size_t(1024 * 1024 * 1024);
+  // keep 2GB memory for system stability if system RAM is 4GB+ - use half of memory in other cases
+  return (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
+}
 
-static std::thread s_prefetcher;
+// Evicts the least recently used textures until the cache fits into its budget again, except for
+// the one given, which was just inserted.
+static void EvictTextures(const std::string* keep = nullptr)
+{
+  while (s_textureCacheSize > s_textureCacheBudget && !s_textureCacheLRU.empty() &&
+         (!keep || s_textureCacheLRU.back() != *keep))
+  {
+    auto iter = s_textureCache.find(s_textureCacheLRU.back());
+    s_textureCacheSize -= iter->second.size;
+    s_textureCache.erase(iter);
+    s_textureCacheLRU.pop_back();
+  }
+}
+
+static void StopLoaders()
+{
+  {
+    std::lock_guard<std::mutex> lk(s_textureCacheMutex);
+    s_exitLoaders = true;
+  }
+  s_loaderWake.notify_all();
+
+  for (std::thread& loader : s_loaders)
+    loader.join();
+  s_loaders.clear();
+
+  s_exitLoaders = false;
+  s_demandQueue.clear();
+  s_prefetchQueue.clear();
+  s_pendingTextures.clear();
+  s_prefetchRemaining = 0;
+}
 
 void HiresTexture::Init()
 {
@@ -56,26 +146,51 @@ void HiresTexture::Init()
 
 void HiresTexture::Shutdown()
 {
-  if (s_prefetcher.joinable())
-  {
-    s_textureCacheAbortLoading.Set();
-    s_prefetcher.join();
-  }
+  if (s_index.valid())
+    s_index.wait();
+  s_index = {};
 
-  s_textureMap.clear();
-  s_textureCache.clear();
+  Clear();
+}
+
+void HiresTexture::StartIndexing()
+{
+  // Left over if the previous boot failed before calling Update
+  if (s_index.valid())
+    s_index.wait();
+  s_index = {};
+
+  if (!Config::Get(Config::GFX_HIRES_TEXTURES))
+    return;
+
+  s_index_game_id = SConfig::GetInstance().GetGameID();
+  s_index = Common::ThreadPool::GetShared().Async(
+      Common::TaskPriority::Background,
+      [game_id = s_index_game_id] { return BuildIndex(game_id); });
+}
+
+HiresTexture::TextureMap HiresTexture::BuildIndex(const std::string& game_id)
+{
+  TextureMap texture_map;
+  const std::set<std::string> texture_directories =
+      GetTextureDirectoriesWithGameId(File::GetUserPath(D_HIRESTEXTURES_IDX), game_id);
+  for (const auto& texture_directory : texture_directories)
+    FindTextures(texture_directory, &texture_map);
+  return texture_map;
 }
 
 void HiresTexture::Update()
 {
-  if (s_prefetcher.joinable())
-  {
-    s_textureCacheAbortLoading.Set();
-    s_prefetcher.join();
-  }
+  StopLoaders();
+  s_failedTextures.clear();
+
+  std::future<TextureMap> index = std::move(s_index);
+  s_index = {};
 
   if (!g_ActiveConfig.bHiresTextures)
   {
+    if (index.valid())
+      index.wait();
     Clear();
     return;
   }
@@ -83,137 +198,255 @@ void HiresTexture::Update()
   if (!g_ActiveConfig.bCacheHiresTextures)
   {
     s_textureCache.clear();
+    s_textureCacheLRU.clear();
+    s_textureCacheSize = 0;
   }
 
   const std::string& game_id = SConfig::GetInstance().GetGameID();
-  const std::set<std::string> texture_directories =
-      GetTextureDirectoriesWithGameId(File::GetUserPath(D_HIRESTEXTURES_IDX), game_id);
-  const std::vector<std::string> extensions{".png", ".dds"};
+  const bool index_usable = index.valid() && s_index_game_id == game_id;
+  TextureMap found_textures = index_usable ? index.get() : BuildIndex(game_id);
+  if (index.valid() && !index_usable)
+    index.wait();
+  s_textureMap.insert(std::make_move_iterator(found_textures.begin()),
+                      std::make_move_iterator(found_textures.end()));
 
-  for (const auto& texture_directory : texture_directories)
+  if (g_ActiveConfig.bCacheHiresTextures)
   {
-    const auto texture_paths =
-        Common::DoFileSearch({texture_directory}, extensions, /*recursive*/ true);
-
-    bool failed_insert = false;
-    for (auto& path : texture_paths)
+    // remove cached but deleted textures
+    auto iter = s_textureCache.begin();
+    while (iter != s_textureCache.end())
     {
-      std::string filename;
-      SplitPath(path, nullptr, &filename, nullptr);
+      if (s_textureMap.find(iter->first) == s_textureMap.end())
+      {
+        s_textureCacheSize -= iter->second.size;
+        s_textureCacheLRU.erase(iter->second.lru_iter);
+        iter = s_textureCache.erase(iter);
+      }
+      else
+      {
+        iter++;
+      }
+    }
+
+    s_textureCacheBudget = GetTextureCacheBudget();
+    EvictTextures();
 
-      if (filename.substr(0, s_format_prefix.length()) == s_format_prefix)
+    for (const auto& entry : s_textureMap)
+    {
+      if (entry.first.find("_mip") == std::string::npos &&
+          s_textureCache.find(entry.first) == s_textureCache.end())
       {
-        const size_t arb_index = filename.rfind("_arb");
-        const bool has_arbitrary_mipmaps = arb_index != std::string::npos;
-        if (has_arbitrary_mipmaps)
-          filename.erase(arb_index, 4);
+        s_prefetchQueue.push_back(entry.first);
+      }
+    }
+    s_prefetchRemaining = s_prefetchQueue.size();
+    s_prefetchStartTime = Common::Timer::GetTimeMs();
+
+    // The CPU and video threads are busy, so they get their own cores if there are enough.
+    const int num_loaders = std::clamp(cpu_info.num_cores - 2, 1, 4);
+    for (int i = 0; i < num_loaders; i++)
+      s_loaders.emplace_back(LoaderThread);
+  }
+}
+
+void HiresTexture::FindTextures(const std::string& texture_directory, TextureMap* texture_map)
+{
+  const std::vector<std::string> extensions{".png", ".dds", TexturePack::EXTENSION};
+  const auto texture_paths =
+      Common::DoFileSearch({texture_directory}, extensions, /*recursive*/ true);
 
-        const auto [it, inserted] =
-            s_textureMap.try_emplace(filename, DiskTexture{path, has_arbitrary_mipmaps});
+  bool failed_insert = false;
+  for (auto& path : texture_paths)
+  {
+    std::string filename, extension;
+    SplitPath(path, nullptr, &filename, &extension);
+
+    if (extension == TexturePack::EXTENSION)
+    {
+      const std::shared_ptr<const TexturePack> pack = TexturePack::Open(path);
+      if (!pack)
+        continue;
+
+      const std::vector<TexturePack::Texture>& textures = pack->GetTextures();
+      for (size_t i = 0; i < textures.size(); i++)
+      {
+        const auto [it, inserted] = texture_map->try_emplace(
+            textures[i].name, DiskTexture{path, textures[i].has_arbitrary_mipmaps, pack, i});
         if (!inserted)
-        {
           failed_insert = true;
-        }
       }
     }
-
-    if (failed_insert)
+    else if (filename.substr(0, s_format_prefix.length()) == s_format_prefix)
     {
-      ERROR_LOG_FMT(VIDEO, "One or more textures at path '{}' were already inserted",
-                    texture_directory);
+      const size_t arb_index = filename.rfind("_arb");
+      const bool has_arbitrary_mipmaps = arb_index != std::string::npos;
+      if (has_arbitrary_mipmaps)
+        filename.erase(arb_index, 4);
+
+      const auto [it, inserted] =
+          texture_map->try_emplace(filename, DiskTexture{path, has_arbitrary_mipmaps});
+      if (!inserted)
+      {
+        failed_insert = true;
+      }
     }
   }
 
-  if (g_ActiveConfig.bCacheHiresTextures)
+  if (failed_insert)
   {
-    // remove cached but deleted textures
-    auto iter = s_textureCache.begin();
-    while (iter != s_textureCache.end())
+    ERROR_LOG_FMT(VIDEO, "One or more textures at path '{}' were already inserted",
+                  texture_directory);
+  }
+}
+
+bool HiresTexture::CreateTexturePack(const std::string& texture_directory,
+                                     const std::string& pack_path,
+                                     const std::function<bool(size_t, size_t)>& progress)
+{
+  TextureMap texture_map;
+  FindTextures(texture_directory, &texture_map);
+
+  // Sorted, so that packing the same textures again gives the same file.
+  std::vector<std::string> names;
+  for (const auto& entry : texture_map)
+  {
+    if (entry.first.find("_mip") == std::string::npos)
+      names.push_back(entry.first);
+  }
+  std::sort(names.begin(), names.end());
+
+  TexturePack::Writer writer;
+  if (!writer.Open(pack_path))
+  {
+    writer.Discard();
+    return false;
+  }
+
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    if (!progress(i, names.size()))
     {
-      if (s_textureMap.find(iter->first) == s_textureMap.end())
-      {
-        iter = s_textureCache.erase(iter);
-      }
-      else
+      writer.Discard();
+      return false;
+    }
+
+    const std::unique_ptr<HiresTexture> texture = Load(texture_map, names[i], 0, 0);
+    if (!texture)
+      continue;
+
+    writer.BeginTexture(names[i], texture->m_has_arbitrary_mipmaps);
+    for (const Level& level : texture->m_levels)
+    {
+      if (!writer.AddLevel(level.format, level.width, level.height, level.row_length,
+                           level.GetData(), level.GetDataSize()))
       {
-        iter++;
+        writer.Discard();
+        return false;
       }
     }
+  }
 
-    s_textureCacheAbortLoading.Clear();
-    s_prefetcher = std::thread(Prefetch);
+  if (!writer.Finish())
+  {
+    writer.Discard();
+    return false;
   }
+  return true;
 }
 
 void HiresTexture::Clear()
 {
+  StopLoaders();
+
   s_textureMap.clear();
   s_textureCache.clear();
+  s_textureCacheLRU.clear();
+  s_textureCacheSize = 0;
+  s_failedTextures.clear();
 }
 
-void HiresTexture::Prefetch()
+void HiresTexture::LoaderThread()
 {
-  Common::SetCurrentThreadName("Prefetcher");
-
-  size_t size_sum = 0;
-  const size_t sys_mem = Common::MemPhysical();
-  const size_t recommended_min_mem = 2 * size_t(1024 * 1024 * 1024);
-  // keep 2GB memory for system stability if system RAM is 4GB+ - use half of memory in other cases
-  const size_t max_mem =
-      (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
+  Common::SetCurrentThreadName("Custom Texture Loader");
 
-  const u32 start_time = Common::Timer::GetTimeMs();
-  for (const auto& entry : s_textureMap)
+  std::unique_lock<std::mutex> lk(s_textureCacheMutex);
+  while (true)
   {
-    const std::string& base_filename = entry.first;
+    s_loaderWake.wait(lk, [] {
+      return s_exitLoaders || !s_demandQueue.empty() || !s_prefetchQueue.empty();
+    });
+    if (s_exitLoaders)
+      return;
 
-    if (base_filename.find("_mip") == std::string::npos)
+    const bool prefetch = s_demandQueue.empty();
+    LoadRequest request;
+    if (prefetch)
+    {
+      request = {std::move(s_prefetchQueue.front()), 0, 0};
+      s_prefetchQueue.pop_front();
+    }
+    else
     {
-      std::unique_lock<std::mutex> lk(s_textureCacheMutex);
+      request = std::move(s_demandQueue.front());
+      s_demandQueue.pop_front();
+    }
 
-      auto iter = s_textureCache.find(base_filename);
-      if (iter == s_textureCache.end())
+    if (s_textureCache.find(request.base_filename) == s_textureCache.end())
+    {
+      // unlock while loading a texture. This may result in a race condition where
+      // we'll load a texture twice, but it reduces the stuttering a lot.
+      lk.unlock();
+      std::shared_ptr<HiresTexture> texture =
+          Load(s_textureMap, request.base_filename, request.width, request.height);
+      lk.lock();
+
+      // Levels mapped from a texture pack don't count, the OS can drop them when it needs to.
+      size_t size = 0;
+      if (texture)
       {
-        // unlock while loading a texture. This may result in a race condition where
-        // we'll load a texture twice, but it reduces the stuttering a lot.
-        lk.unlock();
-        std::unique_ptr<HiresTexture> texture = Load(base_filename, 0, 0);
-        lk.lock();
-        if (texture)
-        {
-          std::shared_ptr<HiresTexture> ptr(std::move(texture));
-          iter = s_textureCache.insert(iter, std::make_pair(base_filename, ptr));
-        }
+        for (const Level& l : texture->m_levels)
+          size += l.data.size();
+      }
+
+      if (!texture)
+      {
+        s_failedTextures.insert(request.base_filename);
+      }
+      else if (prefetch && s_textureCacheSize + size > s_textureCacheBudget)
+      {
+        // Prefetching must not push out textures which were actually used. Anything else is loaded
+        // when the game needs it.
+        OSD::AddMessage(
+            fmt::format("Custom Textures prefetching stopped after {:.1f} MB, the cache is full",
+                        s_textureCacheSize / (1024.0 * 1024.0)),
+            10000);
+        s_prefetchQueue.clear();
+        s_prefetchRemaining = 0;
+        continue;
       }
-      if (iter != s_textureCache.end())
+      else if (s_textureCache.find(request.base_filename) == s_textureCache.end())
       {
-        for (const Level& l : iter->second->m_levels)
-          size_sum += l.data.size();
+        s_textureCacheLRU.push_front(request.base_filename);
+        s_textureCache.emplace(request.base_filename,
+                               CachedTexture{std::move(texture), size, s_textureCacheLRU.begin()});
+        s_textureCacheSize += size;
+        EvictTextures(&request.base_filename);
       }
     }
 
-    if (s_textureCacheAbortLoading.IsSet())
+    if (!prefetch)
     {
-      return;
+      s_pendingTextures.erase(request.base_filename);
     }
-
-    if (size_sum > max_mem)
+    else if (--s_prefetchRemaining == 0)
     {
-      Config::SetCurrent(Config::GFX_HIRES_TEXTURES, false);
-
-      OSD::AddMessage(
-          fmt::format(
-              "Custom Textures prefetching after {:.1f} MB aborted, not enough RAM available",
-              size_sum / (1024.0 * 1024.0)),
-          10000);
-      return;
+      const u32 stop_time = Common::Timer::GetTimeMs();
+      OSD::AddMessage(fmt::format("Custom Textures loaded, {:.1f} MB in {:.1f}s",
+                                  s_textureCacheSize / (1024.0 * 1024.0),
+                                  (stop_time - s_prefetchStartTime) / 1000.0),
+                      10000);
     }
   }
-
-  const u32 stop_time = Common::Timer::GetTimeMs();
-  OSD::AddMessage(fmt::format("Custom Textures loaded, {:.1f} MB in {:.1f}s",
-                              size_sum / (1024.0 * 1024.0), (stop_time - start_time) / 1000.0),
-                  10000);
 }
 
 std::string HiresTexture::GenBaseName(const u8* texture, size_t texture_size, const u8* tlut,
@@ -309,74 +542,122 @@ u32 HiresTexture::CalculateMipCount(u32 width, u32 height)
 std::shared_ptr<HiresTexture> HiresTexture::Search(const u8* texture, size_t texture_size,
                                                    const u8* tlut, size_t tlut_size, u32 width,
                                                    u32 height, TextureFormat format,
-                                                   bool has_mipmaps)
+                                                   bool has_mipmaps, std::string* pending_name)
 {
   std::string base_filename =
       GenBaseName(texture, texture_size, tlut, tlut_size, width, height, format, has_mipmaps);
+  if (base_filename.empty())
+    return nullptr;
+
+  if (!g_ActiveConfig.bCacheHiresTextures)
+    return Load(s_textureMap, base_filename, width, height);
 
   std::lock_guard<std::mutex> lk(s_textureCacheMutex);
 
   auto iter = s_textureCache.find(base_filename);
   if (iter != s_textureCache.end())
   {
-    return iter->second;
+    s_textureCacheLRU.splice(s_textureCacheLRU.begin(), s_textureCacheLRU, iter->second.lru_iter);
+    return iter->second.texture;
   }
 
-  std::shared_ptr<HiresTexture> ptr(Load(base_filename, width, height));
+  if (s_failedTextures.find(base_filename) != s_failedTextures.end())
+    return nullptr;
 
-  if (ptr && g_ActiveConfig.bCacheHiresTextures)
+  // Don't stall the video thread on the disk, the native texture is used until this is loaded.
+  if (s_pendingTextures.insert(base_filename).second)
   {
-    s_textureCache[base_filename] = ptr;
+    s_demandQueue.push_front({base_filename, width, height});
+    s_loaderWake.notify_one();
   }
+  if (pending_name)
+    *pending_name = std::move(base_filename);
 
-  return ptr;
+  return nullptr;
+}
+
+bool HiresTexture::IsPending(const std::string& base_filename)
+{
+  std::lock_guard<std::mutex> lk(s_textureCacheMutex);
+  return s_pendingTextures.find(base_filename) != s_pendingTextures.end();
 }
 
-std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filename, u32 width,
+std::unique_ptr<HiresTexture> HiresTexture::Load(const TextureMap& texture_map,
+                                                 const std::string& base_filename, u32 width,
                                                  u32 height)
 {
   // We need to have a level 0 custom texture to even consider loading.
-  auto filename_iter = s_textureMap.find(base_filename);
-  if (filename_iter == s_textureMap.end())
+  auto filename_iter = texture_map.find(base_filename);
+  if (filename_iter == texture_map.end())
     return nullptr;
 
-  // Try to load level 0 (and any mipmaps) from a DDS file.
-  // If this fails, it's fine, we'll just load level0 again using SOIL.
   // Can't use make_unique due to private constructor.
   std::unique_ptr<HiresTexture> ret = std::unique_ptr<HiresTexture>(new HiresTexture());
   const DiskTexture& first_mip_file = filename_iter->second;
   ret->m_has_arbitrary_mipmaps = first_mip_file.has_arbitrary_mipmaps;
-  LoadDDSTexture(ret.get(), first_mip_file.path);
 
-  // Load remaining mip levels, or from the start if it's not a DDS texture.
-  for (u32 mip_level = static_cast<u32>(ret->m_levels.size());; mip_level++)
+  // PNG textures are block compressed when they are first loaded, and loaded from the compressed
+  // copy in the cache directory from then on.
+  std::string compressed_path;
+  std::shared_ptr<const TexturePack> compressed;
+  if (!first_mip_file.pack && g_ActiveConfig.bCompressHiresTextures &&
+      g_ActiveConfig.backend_info.bSupportsST3CTextures)
   {
-    std::string filename = base_filename;
-    if (mip_level != 0)
-      filename += fmt::format("_mip{}", mip_level);
+    compressed_path = GetCompressedCachePath(texture_map, base_filename);
+    if (!compressed_path.empty() && File::Exists(compressed_path))
+    {
+      compressed = TexturePack::Open(compressed_path);
+      if (compressed && compressed->GetTextures().size() != 1)
+        compressed.reset();
+    }
+  }
 
-    filename_iter = s_textureMap.find(filename);
-    if (filename_iter == s_textureMap.end())
-      break;
+  if (first_mip_file.pack)
+  {
+    // Texture packs contain all levels, ready to be uploaded.
+    LoadFromPack(ret.get(), first_mip_file.pack, first_mip_file.pack_index);
+  }
+  else if (compressed)
+  {
+    LoadFromPack(ret.get(), std::move(compressed), 0);
+    compressed_path.clear();
+  }
+  else
+  {
+    // Try to load level 0 (and any mipmaps) from a DDS file.
+    // If this fails, it's fine, we'll just load level0 again using SOIL.
+    LoadDDSTexture(ret.get(), first_mip_file.path);
 
-    // Try loading DDS textures first, that way we maintain compression of DXT formats.
-    // TODO: Reduce the number of open() calls here. We could use one fd.
-    Level level;
-    if (!LoadDDSTexture(level, filename_iter->second.path, mip_level))
+    // Load remaining mip levels, or from the start if it's not a DDS texture.
+    for (u32 mip_level = static_cast<u32>(ret->m_levels.size());; mip_level++)
     {
-      File::IOFile file;
-      file.Open(filename_iter->second.path, "rb");
-      std::vector<u8> buffer(file.GetSize());
-      file.ReadBytes(buffer.data(), file.GetSize());
+      std::string filename = base_filename;
+      if (mip_level != 0)
+        filename += fmt::format("_mip{}", mip_level);
 
-      if (!LoadTexture(level, buffer))
-      {
-        ERROR_LOG_FMT(VIDEO, "Custom texture {} failed to load", filename);
+      filename_iter = texture_map.find(filename);
+      if (filename_iter == texture_map.end())
         break;
+
+      // Try loading DDS textures first, that way we maintain compression of DXT formats.
+      // TODO: Reduce the number of open() calls here. We could use one fd.
+      Level level;
+      if (!LoadDDSTexture(ret.get(), level, filename_iter->second.path, mip_level))
+      {
+        File::IOFile file;
+        file.Open(filename_iter->second.path, "rb");
+        std::vector<u8> buffer(file.GetSize());
+        file.ReadBytes(buffer.data(), file.GetSize());
+
+        if (!LoadTexture(level, buffer))
+        {
+          ERROR_LOG_FMT(VIDEO, "Custom texture {} failed to load", filename);
+          break;
+        }
       }
-    }
 
-    ret->m_levels.push_back(std::move(level));
+      ret->m_levels.push_back(std::move(level));
+    }
   }
 
   // If we failed to load any mip levels, we can't use this texture at all.
@@ -443,9 +724,128 @@ std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filenam
     return nullptr;
   }
 
+  if (!compressed_path.empty() && !CompressLevels(ret.get(), base_filename, compressed_path))
+    WARN_LOG_FMT(VIDEO, "Failed to cache compressed custom texture {}", first_mip_file.path);
+
   return ret;
 }
 
+void HiresTexture::LoadFromPack(HiresTexture* tex, std::shared_ptr<const TexturePack> pack,
+                                size_t index)
+{
+  for (const TexturePack::Level& pack_level : pack->GetTextures()[index].levels)
+  {
+    Level& level = tex->m_levels.emplace_back();
+    level.mapped_data = pack->GetLevelData(pack_level);
+    level.mapped_size = static_cast<size_t>(pack_level.size);
+    level.format = pack_level.format;
+    level.width = pack_level.width;
+    level.height = pack_level.height;
+    level.row_length = pack_level.row_length;
+  }
+  tex->m_pack = std::move(pack);
+}
+
+std::string HiresTexture::GetCompressedCachePath(const TextureMap& texture_map,
+                                                 const std::string& base_filename)
+{
+  // The compressed copy is found by the contents of the files, so that it is still used when the
+  // textures are renamed or shared between games, and is replaced when they are edited.
+  std::vector<u64> hashes;
+  for (u32 mip_level = 0;; mip_level++)
+  {
+    std::string filename = base_filename;
+    if (mip_level != 0)
+      filename += fmt::format("_mip{}", mip_level);
+
+    const auto iter = texture_map.find(filename);
+    if (iter == texture_map.end())
+      break;
+
+    // DDS textures are either compressed already or meant to be uncompressed.
+    std::string extension;
+    SplitPath(iter->second.path, nullptr, nullptr, &extension);
+    if (extension != ".png")
+      return {};
+
+    std::string contents;
+    if (!File::ReadFileToString(iter->second.path, contents))
+      return {};
+    hashes.push_back(XXH64(contents.data(), contents.size(), 0));
+  }
+
+  if (hashes.empty())
+    return {};
+
+  const u64 hash = XXH64(hashes.data(), hashes.size() * sizeof(u64), 0);
+  return fmt::format("{}HiresTextures/{:016x}{}", File::GetUserPath(D_CACHE_IDX), hash,
+                     TexturePack::EXTENSION);
+}
+
+bool HiresTexture::CompressLevels(HiresTexture* tex, const std::string& base_filename,
+                                  const std::string& cache_path)
+{
+  // Only the first level's size has to be a multiple of the block size, see ReadMipLevel.
+  const Level& first_level = tex->m_levels[0];
+  if (first_level.format != AbstractTextureFormat::RGBA8 || first_level.width % 4 != 0 ||
+      first_level.height % 4 != 0)
+  {
+    return true;
+  }
+
+  std::vector<Level> compressed_levels(tex->m_levels.size());
+  for (size_t i = 0; i < tex->m_levels.size(); i++)
+  {
+    const Level& level = tex->m_levels[i];
+    Level& compressed_level = compressed_levels[i];
+    compressed_level.format = AbstractTextureFormat::DXT5;
+    compressed_level.width = level.width;
+    compressed_level.height = level.height;
+    compressed_level.row_length = Common::AlignUp(level.width, 4u);
+    compressed_level.data.resize(TextureCompression::GetBC3Size(level.width, level.height));
+
+    // Compress bands of block rows in parallel, the first load of a large texture pack would
+    // take a long time otherwise.
+    constexpr u32 BAND_HEIGHT = 64;
+    const u32 num_bands = (level.height + BAND_HEIGHT - 1) / BAND_HEIGHT;
+    const size_t band_size = TextureCompression::GetBC3Size(level.width, BAND_HEIGHT);
+    Common::ThreadPool::GetShared().ParallelFor(num_bands, [&](u32 band) {
+      const u32 y = band * BAND_HEIGHT;
+      TextureCompression::CompressBC3(
+          level.GetData() + static_cast<size_t>(y) * level.row_length * 4, level.width,
+          std::min(BAND_HEIGHT, level.height - y), level.row_length,
+          compressed_level.data.data() + band * band_size);
+    });
+  }
+  tex->m_levels = std::move(compressed_levels);
+
+  File::CreateFullPath(cache_path);
+  TexturePack::Writer writer;
+  if (!writer.Open(cache_path))
+  {
+    writer.Discard();
+    return false;
+  }
+
+  writer.BeginTexture(base_filename, tex->m_has_arbitrary_mipmaps);
+  for (const Level& level : tex->m_levels)
+  {
+    if (!writer.AddLevel(level.format, level.width, level.height, level.row_length,
+                         level.data.data(), level.data.size()))
+    {
+      writer.Discard();
+      return false;
+    }
+  }
+
+  if (!writer.Finish())
+  {
+    writer.Discard();
+    return false;
+  }
+  return true;
+}
+
 bool HiresTexture::LoadTexture(Level& level, const std::vector<u8>& buffer)
 {
   if (!Common::LoadPNG(buffer, &level.data, &level.width, &level.height))
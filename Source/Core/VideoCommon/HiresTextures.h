@@ -4,14 +4,18 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/MappedFile.h"
 #include "VideoCommon/TextureConfig.h"
 
+class TexturePack;
 enum class TextureFormat;
 
 std::set<std::string> GetTextureDirectoriesWithGameId(const std::string& root_directory,
@@ -21,13 +25,22 @@ class HiresTexture
 {
 public:
   static void Init();
+  // Starts looking for the custom textures of the game that is booting on another thread, so that
+  // the next Update() only has to wait for the result instead of searching the directories itself.
+  static void StartIndexing();
   static void Update();
   static void Clear();
   static void Shutdown();
 
+  // When custom textures are cached, the ones which aren't loaded yet are loaded in the
+  // background. In that case nullptr is returned, and pending_name is set to the name for IsPending.
   static std::shared_ptr<HiresTexture> Search(const u8* texture, size_t texture_size,
                                               const u8* tlut, size_t tlut_size, u32 width,
-                                              u32 height, TextureFormat format, bool has_mipmaps);
+                                              u32 height, TextureFormat format, bool has_mipmaps,
+                                              std::string* pending_name = nullptr);
+
+  // Returns false once a background load has finished, whether it succeeded or not.
+  static bool IsPending(const std::string& base_filename);
 
   static std::string GenBaseName(const u8* texture, size_t texture_size, const u8* tlut,
                                  size_t tlut_size, u32 width, u32 height, TextureFormat format,
@@ -35,6 +48,11 @@ public:
 
   static u32 CalculateMipCount(u32 width, u32 height);
 
+  // Packs the custom textures in texture_directory into a single texture pack file. progress is
+  // called with the number of textures done and the total, and cancels when it returns false.
+  static bool CreateTexturePack(const std::string& texture_directory, const std::string& pack_path,
+                                const std::function<bool(size_t, size_t)>& progress);
+
   ~HiresTexture();
 
   AbstractTextureFormat GetFormat() const;
@@ -43,21 +61,46 @@ public:
   struct Level
   {
     std::vector<u8> data;
+    // Set instead of data for levels from a texture pack or a DDS file that needs no conversion,
+    // which are uploaded from its mapping.
+    const u8* mapped_data = nullptr;
+    size_t mapped_size = 0;
     AbstractTextureFormat format = AbstractTextureFormat::RGBA8;
     u32 width = 0;
     u32 height = 0;
     u32 row_length = 0;
+
+    const u8* GetData() const { return mapped_data ? mapped_data : data.data(); }
+    size_t GetDataSize() const { return mapped_data ? mapped_size : data.size(); }
   };
   std::vector<Level> m_levels;
 
+  // Where the custom textures found in the texture directories are stored, by name.
+  struct DiskTexture;
+  using TextureMap = std::unordered_map<std::string, DiskTexture>;
+
 private:
-  static std::unique_ptr<HiresTexture> Load(const std::string& base_filename, u32 width,
+  static TextureMap BuildIndex(const std::string& game_id);
+  static void FindTextures(const std::string& texture_directory, TextureMap* texture_map);
+  static std::unique_ptr<HiresTexture> Load(const TextureMap& texture_map,
+                                            const std::string& base_filename, u32 width,
                                             u32 height);
   static bool LoadDDSTexture(HiresTexture* tex, const std::string& filename);
-  static bool LoadDDSTexture(Level& level, const std::string& filename, u32 mip_level);
+  static bool LoadDDSTexture(HiresTexture* tex, Level& level, const std::string& filename,
+                             u32 mip_level);
   static bool LoadTexture(Level& level, const std::vector<u8>& buffer);
-  static void Prefetch();
+  static void LoadFromPack(HiresTexture* tex, std::shared_ptr<const TexturePack> pack,
+                           size_t index);
+  static std::string GetCompressedCachePath(const TextureMap& texture_map,
+                                            const std::string& base_filename);
+  static bool CompressLevels(HiresTexture* tex, const std::string& base_filename,
+                             const std::string& cache_path);
+  static void LoaderThread();
 
   HiresTexture() {}
   bool m_has_arbitrary_mipmaps;
+  // Keep the mappings alive for mapped levels. As the files are only mapped, the pages holding
+  // them are shared with other processes using the same textures.
+  std::shared_ptr<const TexturePack> m_pack;
+  std::vector<std::unique_ptr<File::MappedFile>> m_mapped_files;
 };
@@ -9,10 +9,12 @@
 #include <cstdint>
 #include <cstring>
 #include <functional>
+#include <memory>
 
 #include "Common/Align.h"
 #include "Common/IOFile.h"
 #include "Common/Logging/Log.h"
+#include "Common/MappedFile.h"
 #include "Common/Swap.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -401,9 +403,22 @@ bool ParseDDSHeader(File::IOFile& file, DDSLoadInfo* info)
   return true;
 }
 
-bool ReadMipLevel(HiresTexture::Level* level, File::IOFile& file, const std::string& filename,
-                  u32 mip_level, const DDSLoadInfo& info, u32 width, u32 height, u32 row_length,
-                  size_t size)
+// Maps a DDS file if its levels can be uploaded as they're stored.
+std::unique_ptr<File::MappedFile> MapIfUnconverted(const std::string& filename,
+                                                  const DDSLoadInfo& info)
+{
+  if (info.conversion_function)
+    return nullptr;
+
+  auto mapping = std::make_unique<File::MappedFile>();
+  if (!mapping->Open(filename))
+    return nullptr;
+  return mapping;
+}
+
+bool ReadMipLevel(HiresTexture::Level* level, File::IOFile& file, const File::MappedFile* mapping,
+                  const std::string& filename, u32 mip_level, const DDSLoadInfo& info, u32 width,
+                  u32 height, u32 row_length, size_t size)
 {
   // D3D11 cannot handle block compressed textures where the first mip level is
   // not a multiple of the block size.
@@ -422,6 +437,18 @@ bool ReadMipLevel(HiresTexture::Level* level, File::IOFile& file, const std::str
   level->height = height;
   level->format = info.format;
   level->row_length = row_length;
+
+  if (mapping)
+  {
+    const u64 offset = file.Tell();
+    if (offset > mapping->GetSize() || size > mapping->GetSize() - offset)
+      return false;
+
+    level->mapped_data = mapping->GetData() + offset;
+    level->mapped_size = size;
+    return file.Seek(static_cast<s64>(size), SEEK_CUR);
+  }
+
   level->data.resize(size);
   if (!file.ReadBytes(level->data.data(), level->data.size()))
     return false;
@@ -446,10 +473,12 @@ bool HiresTexture::LoadDDSTexture(HiresTexture* tex, const std::string& filename
   if (!ParseDDSHeader(file, &info))
     return false;
 
+  std::unique_ptr<File::MappedFile> mapping = MapIfUnconverted(filename, info);
+
   // Read first mip level, as it may have a custom pitch.
   Level first_level;
   if (!file.Seek(info.first_mip_offset, SEEK_SET) ||
-      !ReadMipLevel(&first_level, file, filename, 0, info, info.width, info.height,
+      !ReadMipLevel(&first_level, file, mapping.get(), filename, 0, info, info.width, info.height,
                     info.first_mip_row_length, info.first_mip_size))
   {
     return false;
@@ -472,17 +501,20 @@ bool HiresTexture::LoadDDSTexture(HiresTexture* tex, const std::string& filename
     u32 mip_row_length = blocks_wide * info.block_size;
     size_t mip_size = blocks_wide * static_cast<size_t>(info.bytes_per_block) * blocks_high;
     Level level;
-    if (!ReadMipLevel(&level, file, filename, i, info, mip_width, mip_height, mip_row_length,
-                      mip_size))
+    if (!ReadMipLevel(&level, file, mapping.get(), filename, i, info, mip_width, mip_height,
+                      mip_row_length, mip_size))
       break;
 
     tex->m_levels.push_back(std::move(level));
   }
 
+  if (mapping)
+    tex->m_mapped_files.push_back(std::move(mapping));
   return true;
 }
 
-bool HiresTexture::LoadDDSTexture(Level& level, const std::string& filename, u32 mip_level)
+bool HiresTexture::LoadDDSTexture(HiresTexture* tex, Level& level, const std::string& filename,
+                                  u32 mip_level)
 {
   // Only loading a single mip level.
   File::IOFile file;
@@ -494,6 +526,15 @@ bool HiresTexture::LoadDDSTexture(Level& level, const std::string& filename, u32
   if (!ParseDDSHeader(file, &info))
     return false;
 
-  return ReadMipLevel(&level, file, filename, mip_level, info, info.width, info.height,
-                      info.first_mip_row_length, info.first_mip_size);
+  std::unique_ptr<File::MappedFile> mapping = MapIfUnconverted(filename, info);
+  if (!file.Seek(info.first_mip_offset, SEEK_SET) ||
+      !ReadMipLevel(&level, file, mapping.get(), filename, mip_level, info, info.width,
+                    info.height, info.first_mip_row_length, info.first_mip_size))
+  {
+    return false;
+  }
+
+  if (mapping)
+    tex->m_mapped_files.push_back(std::move(mapping));
+  return true;
 }
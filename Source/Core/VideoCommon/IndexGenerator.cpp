@@ -7,16 +7,165 @@
 #include <array>
 #include <cstddef>
 #include <cstring>
+#include <numeric>
 
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "Common/Logging/Log.h"
 #include "VideoCommon/OpcodeDecoding.h"
 #include "VideoCommon/VideoConfig.h"
 
+#ifdef _M_ARM_64
+#include <arm_neon.h>
+#endif
+
 namespace
 {
 constexpr u16 s_primitive_restart = UINT16_MAX;
 
+// All primitive types produce indices in a repeating pattern, so the bulk of every primitive is
+// generated eight indices at a time. Each lane of a pattern is either relative to the current
+// vertex, the first vertex of the primitive (the centre of a fan), or a primitive restart.
+enum class LaneType : u8
+{
+  Vertex,
+  First,
+  Restart,
+};
+
+struct PatternLane
+{
+  LaneType type;
+  u16 offset;
+};
+
+constexpr PatternLane V(u16 offset)
+{
+  return {LaneType::Vertex, offset};
+}
+constexpr PatternLane FIRST{LaneType::First, 0};
+constexpr PatternLane RESTART{LaneType::Restart, 0};
+
+constexpr size_t LANES = 8;
+
+template <size_t NumVectors>
+struct IndexPattern
+{
+  std::array<u16, NumVectors * LANES> offsets;
+  std::array<u16, NumVectors * LANES> steps;
+  std::array<u16, NumVectors * LANES> restart;
+  // How many times the source pattern is repeated to fill all vectors, and how many vertices
+  // that consumes.
+  u32 repeats;
+  u32 vertices;
+};
+
+// Repeats a pattern of indices as often as needed to fill a whole number of vectors.
+template <size_t N>
+constexpr IndexPattern<std::lcm(N, LANES) / LANES> MakeIndexPattern(const PatternLane (&lanes)[N],
+                                                                  u32 vertices_per_repeat)
+{
+  constexpr size_t num_vectors = std::lcm(N, LANES) / LANES;
+  constexpr u32 repeats = static_cast<u32>(num_vectors * LANES / N);
+
+  IndexPattern<num_vectors> pattern{};
+  pattern.repeats = repeats;
+  pattern.vertices = repeats * vertices_per_repeat;
+  for (u32 i = 0; i < repeats; ++i)
+  {
+    for (size_t j = 0; j < N; ++j)
+    {
+      const size_t lane = i * N + j;
+      switch (lanes[j].type)
+      {
+      case LaneType::Vertex:
+        pattern.offsets[lane] = static_cast<u16>(lanes[j].offset + i * vertices_per_repeat);
+        pattern.steps[lane] = static_cast<u16>(pattern.vertices);
+        break;
+      case LaneType::First:
+        break;
+      case LaneType::Restart:
+        pattern.restart[lane] = s_primitive_restart;
+        break;
+      }
+    }
+  }
+  return pattern;
+}
+
+// Writes the pattern for `count` repeats of its source pattern, rounded down to whole vectors.
+// Returns the number of source repeats written, which the caller picks up from.
+template <size_t NumVectors>
+u32 WriteIndexPattern(u16*& index_ptr, const IndexPattern<NumVectors>& pattern, u32 index,
+                      u32 count)
+{
+  const u32 iterations = count / pattern.repeats;
+  if (iterations == 0)
+    return 0;
+
+#if defined(_M_X86)
+  __m128i current[NumVectors];
+  __m128i steps[NumVectors];
+  __m128i restart[NumVectors];
+  for (size_t i = 0; i < NumVectors; ++i)
+  {
+    current[i] = _mm_add_epi16(_mm_set1_epi16(static_cast<s16>(index)),
+                               _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                                   &pattern.offsets[i * LANES])));
+    steps[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pattern.steps[i * LANES]));
+    restart[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pattern.restart[i * LANES]));
+  }
+  for (u32 n = 0; n < iterations; ++n)
+  {
+    for (size_t i = 0; i < NumVectors; ++i)
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(index_ptr), _mm_or_si128(current[i], restart[i]));
+      current[i] = _mm_add_epi16(current[i], steps[i]);
+      index_ptr += LANES;
+    }
+  }
+#elif defined(_M_ARM_64)
+  uint16x8_t current[NumVectors];
+  uint16x8_t steps[NumVectors];
+  uint16x8_t restart[NumVectors];
+  for (size_t i = 0; i < NumVectors; ++i)
+  {
+    current[i] = vaddq_u16(vdupq_n_u16(static_cast<u16>(index)),
+                           vld1q_u16(&pattern.offsets[i * LANES]));
+    steps[i] = vld1q_u16(&pattern.steps[i * LANES]);
+    restart[i] = vld1q_u16(&pattern.restart[i * LANES]);
+  }
+  for (u32 n = 0; n < iterations; ++n)
+  {
+    for (size_t i = 0; i < NumVectors; ++i)
+    {
+      vst1q_u16(index_ptr, vorrq_u16(current[i], restart[i]));
+      current[i] = vaddq_u16(current[i], steps[i]);
+      index_ptr += LANES;
+    }
+  }
+#else
+  for (u32 n = 0; n < iterations; ++n)
+  {
+    for (size_t i = 0; i < NumVectors * LANES; ++i)
+      *index_ptr++ = static_cast<u16>(index + pattern.offsets[i] + n * pattern.steps[i]) |
+                     pattern.restart[i];
+  }
+#endif
+
+  return iterations * pattern.repeats;
+}
+
+constexpr auto s_list_pattern = MakeIndexPattern({V(0), V(1), V(2)}, 3);
+constexpr auto s_list_pattern_pr = MakeIndexPattern({V(0), V(1), V(2), RESTART}, 3);
+constexpr auto s_sequential_pattern = MakeIndexPattern({V(0)}, 1);
+constexpr auto s_strip_pattern = MakeIndexPattern({V(0), V(1), V(2), V(1), V(3), V(2)}, 2);
+constexpr auto s_fan_pattern = MakeIndexPattern({FIRST, V(1), V(2)}, 1);
+constexpr auto s_fan_pattern_pr = MakeIndexPattern({V(1), V(2), FIRST, V(3), V(4), RESTART}, 3);
+constexpr auto s_quads_pattern = MakeIndexPattern({V(0), V(1), V(2), V(0), V(2), V(3)}, 4);
+constexpr auto s_quads_pattern_pr = MakeIndexPattern({V(1), V(2), V(0), V(3), RESTART}, 4);
+constexpr auto s_line_strip_pattern = MakeIndexPattern({V(0), V(1)}, 1);
+
 template <bool pr>
 u16* WriteTriangle(u16* index_ptr, u32 index1, u32 index2, u32 index3)
 {
@@ -31,7 +180,14 @@ u16* WriteTriangle(u16* index_ptr, u32 index1, u32 index2, u32 index3)
 template <bool pr>
 u16* AddList(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 2; i < num_verts; i += 3)
+  const u32 triangles = num_verts / 3;
+  u32 i = 2;
+  if constexpr (pr)
+    i += 3 * WriteIndexPattern(index_ptr, s_list_pattern_pr, index, triangles);
+  else
+    i += 3 * WriteIndexPattern(index_ptr, s_list_pattern, index, triangles);
+
+  for (; i < num_verts; i += 3)
   {
     index_ptr = WriteTriangle<pr>(index_ptr, index + i - 2, index + i - 1, index + i);
   }
@@ -43,7 +199,8 @@ u16* AddStrip(u16* index_ptr, u32 num_verts, u32 index)
 {
   if constexpr (pr)
   {
-    for (u32 i = 0; i < num_verts; ++i)
+    for (u32 i = WriteIndexPattern(index_ptr, s_sequential_pattern, index, num_verts);
+         i < num_verts; ++i)
     {
       *index_ptr++ = index + i;
     }
@@ -51,8 +208,11 @@ u16* AddStrip(u16* index_ptr, u32 num_verts, u32 index)
   }
   else
   {
+    // Pairs of triangles are written at once, so the winding is back to the start afterwards.
+    const u32 triangle_pairs = num_verts > 2 ? (num_verts - 2) / 2 : 0;
     bool wind = false;
-    for (u32 i = 2; i < num_verts; ++i)
+    for (u32 i = 2 + 2 * WriteIndexPattern(index_ptr, s_strip_pattern, index, triangle_pairs);
+         i < num_verts; ++i)
     {
       index_ptr = WriteTriangle<pr>(index_ptr, index + i - 2, index + i - !wind, index + i - wind);
 
@@ -88,6 +248,8 @@ u16* AddFan(u16* index_ptr, u32 num_verts, u32 index)
 
   if constexpr (pr)
   {
+    const u32 triangle_triples = num_verts > 2 ? (num_verts - 2) / 3 : 0;
+    i += 3 * WriteIndexPattern(index_ptr, s_fan_pattern_pr, index, triangle_triples);
     for (; i + 3 <= num_verts; i += 3)
     {
       *index_ptr++ = index + i - 1;
@@ -107,6 +269,11 @@ u16* AddFan(u16* index_ptr, u32 num_verts, u32 index)
       *index_ptr++ = s_primitive_restart;
     }
   }
+  else
+  {
+    const u32 triangles = num_verts > 2 ? num_verts - 2 : 0;
+    i += WriteIndexPattern(index_ptr, s_fan_pattern, index, triangles);
+  }
 
   for (; i < num_verts; ++i)
   {
@@ -136,6 +303,11 @@ template <bool pr>
 u16* AddQuads(u16* index_ptr, u32 num_verts, u32 index)
 {
   u32 i = 3;
+  if constexpr (pr)
+    i += 4 * WriteIndexPattern(index_ptr, s_quads_pattern_pr, index, num_verts / 4);
+  else
+    i += 4 * WriteIndexPattern(index_ptr, s_quads_pattern, index, num_verts / 4);
+
   for (; i < num_verts; i += 4)
   {
     if constexpr (pr)
@@ -171,7 +343,9 @@ u16* AddQuads_nonstandard(u16* index_ptr, u32 num_verts, u32 index)
 
 u16* AddLineList(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 1; i < num_verts; i += 2)
+  // A line list is the same as a list of points, as long as every line is complete.
+  for (u32 i = 1 + WriteIndexPattern(index_ptr, s_sequential_pattern, index, num_verts & ~1u);
+       i < num_verts; i += 2)
   {
     *index_ptr++ = index + i - 1;
     *index_ptr++ = index + i;
@@ -183,7 +357,9 @@ u16* AddLineList(u16* index_ptr, u32 num_verts, u32 index)
 // so converting them to lists
 u16* AddLineStrip(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 1; i < num_verts; ++i)
+  const u32 lines = num_verts > 1 ? num_verts - 1 : 0;
+  for (u32 i = 1 + WriteIndexPattern(index_ptr, s_line_strip_pattern, index, lines);
+       i < num_verts; ++i)
   {
     *index_ptr++ = index + i - 1;
     *index_ptr++ = index + i;
@@ -193,7 +369,8 @@ u16* AddLineStrip(u16* index_ptr, u32 num_verts, u32 index)
 
 u16* AddPoints(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 0; i != num_verts; ++i)
+  for (u32 i = WriteIndexPattern(index_ptr, s_sequential_pattern, index, num_verts);
+       i != num_verts; ++i)
   {
     *index_ptr++ = index + i;
   }
@@ -238,6 +415,23 @@ void IndexGenerator::AddIndices(int primitive, u32 num_vertices)
   m_base_index += num_vertices;
 }
 
+void IndexGenerator::AddRemappedIndices(int primitive, u32 num_vertices, const u16* remap,
+                                        u32 num_unique_vertices)
+{
+  // Generate the primitive's indices as usual, then look each up. Three indices per vertex is
+  // enough for any primitive type, plus one for a trailing primitive restart.
+  if (m_remap_buffer.size() < num_vertices * 3 + 1)
+    m_remap_buffer.resize(num_vertices * 3 + 1);
+  const u16* end = m_primitive_table[primitive](m_remap_buffer.data(), num_vertices, 0);
+
+  for (const u16* index = m_remap_buffer.data(); index != end; ++index)
+  {
+    *m_index_buffer_current++ =
+        *index == s_primitive_restart ? s_primitive_restart : m_base_index + remap[*index];
+  }
+  m_base_index += num_unique_vertices;
+}
+
 void IndexGenerator::AddExternalIndices(const u16* indices, u32 num_indices, u32 num_vertices)
 {
   std::memcpy(m_index_buffer_current, indices, sizeof(u16) * num_indices);
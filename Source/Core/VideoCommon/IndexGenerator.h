@@ -8,6 +8,8 @@
 #pragma once
 
 #include <array>
+#include <vector>
+
 #include "Common/CommonTypes.h"
 
 class IndexGenerator
@@ -18,6 +20,11 @@ public:
 
   void AddIndices(int primitive, u32 num_vertices);
 
+  // Like AddIndices, but vertex i of the primitive is stored at remap[i] of the
+  // num_unique_vertices vertices which were added.
+  void AddRemappedIndices(int primitive, u32 num_vertices, const u16* remap,
+                          u32 num_unique_vertices);
+
   void AddExternalIndices(const u16* indices, u32 num_indices, u32 num_vertices);
 
   // returns numprimitives
@@ -32,4 +39,6 @@ private:
 
   using PrimitiveFunction = u16* (*)(u16*, u32, u32);
   std::array<PrimitiveFunction, 8> m_primitive_table{};
+
+  std::vector<u16> m_remap_buffer;
 };
@@ -15,8 +15,11 @@
 
 #include "VideoCommon/OpcodeDecoding.h"
 
+#include <optional>
+
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
+#include "Common/Tracing.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
 #include "Core/HW/Memmap.h"
 #include "VideoCommon/BPMemory.h"
@@ -24,6 +27,8 @@
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/FrameProfiler.h"
+#include "VideoCommon/FrameTimeBreakdown.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/XFMemory.h"
@@ -84,6 +89,16 @@ void Init()
 template <bool is_preprocess>
 u8* Run(DataReader src, u32* cycles, bool in_display_list)
 {
+  // Preprocessing happens on the CPU thread, which the profiler doesn't cover
+  std::optional<FrameProfiler::ScopedSection> profiler_section;
+  std::optional<FrameTimeBreakdown::ScopedCategory> breakdown_category;
+  if constexpr (!is_preprocess)
+  {
+    profiler_section.emplace(FrameProfiler::Section::OpcodeDecoding);
+    breakdown_category.emplace(FrameTimeBreakdown::Category::GPUCommands);
+  }
+  TRACE_SCOPE(is_preprocess ? "OpcodeDecoder::Preprocess" : "OpcodeDecoder::Run");
+
   u32 total_cycles = 0;
   u8* opcode_start = nullptr;
 
@@ -243,7 +258,8 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
         const u16 num_vertices = src.Read<u16>();
         const int bytes = VertexLoaderManager::RunVertices(
             cmd_byte & GX_VAT_MASK,  // Vertex loader index (0 - 7)
-            (cmd_byte & GX_PRIMITIVE_MASK) >> GX_PRIMITIVE_SHIFT, num_vertices, src, is_preprocess);
+            (cmd_byte & GX_PRIMITIVE_MASK) >> GX_PRIMITIVE_SHIFT, num_vertices, src, is_preprocess,
+            in_display_list);
 
         if (bytes < 0)
           return finish_up();
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include "VideoCommon/PerfQueryBase.h"
+#include <algorithm>
 #include <memory>
 #include "VideoCommon/VideoConfig.h"
 
@@ -12,3 +13,49 @@ bool PerfQueryBase::ShouldEmulate()
 {
   return g_ActiveConfig.bPerfQueriesEnable;
 }
+
+bool PerfQueryBase::IsLatencyTolerant()
+{
+  return g_ActiveConfig.bPerfQueriesLatencyTolerant;
+}
+
+void PerfQueryBase::AccumulateResult(PerfQueryGroup type, u32 value)
+{
+  // Queries complete in order, so the ones left over from the previous period come first.
+  if (m_previous_period_queries == 0)
+  {
+    m_results[type] += value;
+    return;
+  }
+
+  m_previous_period_results[type] += value;
+  if (--m_previous_period_queries == 0)
+    ReportPreviousPeriod();
+}
+
+u32 PerfQueryBase::GetGroupResult(PerfQueryGroup type) const
+{
+  return IsLatencyTolerant() ? m_reported_results[type] : m_results[type];
+}
+
+void PerfQueryBase::ClearResults()
+{
+  std::fill(std::begin(m_results), std::end(m_results), 0);
+  m_previous_period_queries = 0;
+}
+
+void PerfQueryBase::BeginQueryPeriod()
+{
+  std::copy(std::begin(m_results), std::end(m_results), std::begin(m_previous_period_results));
+  std::fill(std::begin(m_results), std::end(m_results), 0);
+
+  m_previous_period_queries = m_query_count;
+  if (m_previous_period_queries == 0)
+    ReportPreviousPeriod();
+}
+
+void PerfQueryBase::ReportPreviousPeriod()
+{
+  std::copy(std::begin(m_previous_period_results), std::end(m_previous_period_results),
+            std::begin(m_reported_results));
+}
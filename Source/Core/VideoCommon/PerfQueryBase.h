@@ -36,6 +36,13 @@ public:
   // NOTE: Called from CPU+GPU thread
   static bool ShouldEmulate();
 
+  // Checks if the counts of the previous query period can be returned instead of the current ones.
+  // A period lasts from one reset of the counters to the next, which most games do once per frame.
+  // The queries of the current period are left in flight, so that reading the counters neither
+  // has to wait for the GPU thread to catch up nor for the host GPU to finish.
+  // NOTE: Called from CPU+GPU thread
+  static bool IsLatencyTolerant();
+
   // Begin querying the specified value for the following host GPU commands
   // The call to EnableQuery() should be placed immediately before the draw command, otherwise
   // there is a risk of GPU resets if the query is left open and the buffer is submitted during
@@ -61,9 +68,34 @@ public:
   virtual bool IsFlushed() const { return true; }
 
 protected:
+  // Adds the result of a completed query to the period it was issued in. Queries have to be
+  // completed in the order they were issued.
+  void AccumulateResult(PerfQueryGroup type, u32 value);
+
+  // Returns the accumulated count which is reported to the game for the specified group.
+  u32 GetGroupResult(PerfQueryGroup type) const;
+
+  // Resets the counts of the current period and forgets about any previous one.
+  void ClearResults();
+
+  // Ends the current period in latency tolerant mode. All queries which are pending at this point
+  // belong to it, and its counts are reported once they have completed.
+  void BeginQueryPeriod();
+
+  // True if queries of the previous period are still pending. They have to complete before the
+  // next period is begun.
+  bool HasPendingPreviousPeriod() const { return m_previous_period_queries != 0; }
+
   // TODO: sloppy
   volatile u32 m_query_count;
   volatile u32 m_results[PQG_NUM_MEMBERS];
+
+private:
+  void ReportPreviousPeriod();
+
+  u32 m_previous_period_queries = 0;
+  u32 m_previous_period_results[PQG_NUM_MEMBERS] = {};
+  volatile u32 m_reported_results[PQG_NUM_MEMBERS] = {};
 };
 
 extern std::unique_ptr<PerfQueryBase> g_perf_query;
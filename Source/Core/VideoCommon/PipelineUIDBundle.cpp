@@ -0,0 +1,162 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/PipelineUIDBundle.h"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+
+namespace VideoCommon::PipelineUIDBundle
+{
+namespace
+{
+constexpr u32 BUNDLE_MAGIC = 0x42495550;  // PUIB
+constexpr u32 BUNDLE_VERSION = 1;
+constexpr size_t GAME_ID_SIZE = 16;
+
+#pragma pack(push, 1)
+struct Header
+{
+  u32 magic;
+  u32 version;
+  u32 uid_version;
+  u32 uid_size;
+  u32 uid_count;
+  char game_id[GAME_ID_SIZE];
+};
+#pragma pack(pop)
+
+int CompareUIDs(const SerializedGXPipelineUid& a, const SerializedGXPipelineUid& b)
+{
+  return std::memcmp(&a, &b, sizeof(SerializedGXPipelineUid));
+}
+}  // namespace
+
+std::string GetUIDCachePath(const std::string& game_id)
+{
+  return File::GetUserPath(D_CACHE_IDX) + game_id + ".uidcache";
+}
+
+std::string GetLoadPath(const std::string& game_id)
+{
+  return File::GetUserPath(D_LOAD_IDX) + "PipelineUIDs" DIR_SEP + game_id + EXTENSION;
+}
+
+std::optional<std::vector<SerializedGXPipelineUid>> Read(const std::string& path,
+                                                         const std::string& game_id)
+{
+  File::IOFile file(path, "rb");
+  Header header;
+  if (!file.ReadBytes(&header, sizeof(header)))
+    return std::nullopt;
+
+  if (header.magic != BUNDLE_MAGIC || header.version != BUNDLE_VERSION)
+  {
+    WARN_LOG_FMT(VIDEO, "{} is not a pipeline UID bundle of a supported version", path);
+    return std::nullopt;
+  }
+
+  const std::string bundle_game_id(header.game_id, strnlen(header.game_id, GAME_ID_SIZE));
+  if (bundle_game_id != game_id)
+  {
+    WARN_LOG_FMT(VIDEO, "Pipeline UID bundle {} is for {}, not {}", path, bundle_game_id, game_id);
+    return std::nullopt;
+  }
+
+  if (header.uid_version != GX_PIPELINE_UID_VERSION ||
+      header.uid_size != sizeof(SerializedGXPipelineUid))
+  {
+    WARN_LOG_FMT(VIDEO, "Pipeline UID bundle {} was made for a different UID version", path);
+    return std::nullopt;
+  }
+
+  if (file.GetSize() != sizeof(header) + u64{header.uid_count} * header.uid_size)
+  {
+    WARN_LOG_FMT(VIDEO, "Pipeline UID bundle {} is corrupted", path);
+    return std::nullopt;
+  }
+
+  std::vector<SerializedGXPipelineUid> uids(header.uid_count);
+  if (!file.ReadArray(uids.data(), uids.size()))
+    return std::nullopt;
+
+  return uids;
+}
+
+bool Write(const std::string& path, const std::string& game_id,
+           std::vector<SerializedGXPipelineUid> uids)
+{
+  std::sort(uids.begin(), uids.end(),
+            [](const auto& a, const auto& b) { return CompareUIDs(a, b) < 0; });
+  uids.erase(std::unique(uids.begin(), uids.end(),
+                         [](const auto& a, const auto& b) { return CompareUIDs(a, b) == 0; }),
+             uids.end());
+
+  Header header{};
+  header.magic = BUNDLE_MAGIC;
+  header.version = BUNDLE_VERSION;
+  header.uid_version = GX_PIPELINE_UID_VERSION;
+  header.uid_size = sizeof(SerializedGXPipelineUid);
+  header.uid_count = static_cast<u32>(uids.size());
+  std::memcpy(header.game_id, game_id.data(), std::min(game_id.size(), GAME_ID_SIZE));
+
+  // Write to a temporary file first, so that an existing bundle isn't lost if this fails.
+  const std::string temp_path = path + ".tmp";
+  {
+    File::IOFile file(temp_path, "wb");
+    if (!file.WriteBytes(&header, sizeof(header)) || !file.WriteArray(uids.data(), uids.size()))
+    {
+      ERROR_LOG_FMT(VIDEO, "Failed to write pipeline UID bundle {}", path);
+      file.Close();
+      File::Delete(temp_path);
+      return false;
+    }
+  }
+
+  return File::Rename(temp_path, path);
+}
+
+std::vector<SerializedGXPipelineUid> ReadUIDCache(const std::string& game_id)
+{
+  std::vector<SerializedGXPipelineUid> uids;
+  File::IOFile file(GetUIDCachePath(game_id), "rb");
+  u32 magic;
+  u32 version;
+  if (!file.ReadBytes(&magic, sizeof(magic)) || !file.ReadBytes(&version, sizeof(version)) ||
+      magic != UID_CACHE_MAGIC || version != GX_PIPELINE_UID_VERSION)
+  {
+    return uids;
+  }
+
+  // A partially written UID at the end, e.g. from a crash, is simply ignored.
+  SerializedGXPipelineUid uid;
+  while (file.ReadBytes(&uid, sizeof(uid)))
+    uids.push_back(uid);
+
+  return uids;
+}
+
+bool Export(const std::string& path, const std::string& game_id)
+{
+  std::vector<SerializedGXPipelineUid> uids = ReadUIDCache(game_id);
+  if (auto bundle_uids = Read(GetLoadPath(game_id), game_id))
+    uids.insert(uids.end(), bundle_uids->begin(), bundle_uids->end());
+
+  if (uids.empty())
+  {
+    WARN_LOG_FMT(VIDEO, "No pipeline UIDs are known for {}", game_id);
+    return false;
+  }
+
+  return Write(path, game_id, std::move(uids));
+}
+}  // namespace VideoCommon::PipelineUIDBundle
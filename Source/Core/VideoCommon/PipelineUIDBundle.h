@@ -0,0 +1,53 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "VideoCommon/GXPipelineTypes.h"
+
+// Pipeline UID bundles hold the pipeline UIDs a game is known to use, so that they can be shared
+// and precompiled the first time the game is started, instead of only after they have been
+// encountered locally. A bundle placed in Load/PipelineUIDs/<game ID>.uidbundle is merged into
+// the UID cache of the game when its shader cache is loaded.
+//
+// The UIDs don't depend on the host configuration, so the same bundle can be used with any
+// backend. A bundle is only accepted for the game and pipeline UID version it was written for.
+//
+// Layout, all values little endian:
+//   header:  magic, bundle version, GX_PIPELINE_UID_VERSION, size of a UID, number of UIDs,
+//            game ID (16 bytes, padded with zeros)
+//   data:    the sorted and deduplicated SerializedGXPipelineUids
+namespace VideoCommon::PipelineUIDBundle
+{
+constexpr const char* EXTENSION = ".uidbundle";
+
+// The local UID cache uses a header of this magic and GX_PIPELINE_UID_VERSION, followed by the
+// UIDs in the order they were encountered in.
+constexpr u32 UID_CACHE_MAGIC = 0x44495550;  // PUID
+
+std::string GetUIDCachePath(const std::string& game_id);
+
+// Returns the path of the bundle which is loaded automatically for the given game.
+std::string GetLoadPath(const std::string& game_id);
+
+// Returns std::nullopt if the file doesn't exist, is corrupted, or was written for a different
+// game or pipeline UID version.
+std::optional<std::vector<SerializedGXPipelineUid>> Read(const std::string& path,
+                                                         const std::string& game_id);
+
+// Writes the UIDs to a bundle, dropping duplicates.
+bool Write(const std::string& path, const std::string& game_id,
+           std::vector<SerializedGXPipelineUid> uids);
+
+// Returns the UIDs stored in the local UID cache of the game.
+std::vector<SerializedGXPipelineUid> ReadUIDCache(const std::string& game_id);
+
+// Writes the UIDs of the local UID cache and of the currently loaded bundle of the game to a new
+// bundle. Returns false if the game has no known UIDs or the file couldn't be written.
+bool Export(const std::string& path, const std::string& game_id);
+}  // namespace VideoCommon::PipelineUIDBundle
@@ -6,7 +6,7 @@
 
 #include "VideoCommon/PixelEngine.h"
 
-#include <mutex>
+#include <atomic>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -97,12 +97,19 @@ static UPEAlphaModeConfReg m_AlphaModeConf;
 static UPEAlphaReadReg m_AlphaRead;
 static UPECtrlReg m_Control;
 
-static std::mutex s_token_finish_mutex;
 static u16 s_token;
-static u16 s_token_pending;
-static bool s_token_interrupt_pending;
-static bool s_finish_interrupt_pending;
-static bool s_event_raised;
+
+// Tokens and finishes are passed from the video thread to the CPU thread through a single word,
+// so that neither side ever has to wait for the other. The video thread only schedules an event
+// for the first signal after the CPU thread has taken the previous ones.
+enum : u32
+{
+  MAILBOX_TOKEN_MASK = 0xffff,
+  MAILBOX_TOKEN_INTERRUPT = 1 << 16,
+  MAILBOX_FINISH_INTERRUPT = 1 << 17,
+  MAILBOX_EVENT_RAISED = 1 << 18,
+};
+static std::atomic<u32> s_token_finish_mailbox;
 
 static bool s_signal_token_interrupt;
 static bool s_signal_finish_interrupt;
@@ -125,10 +132,23 @@ void DoState(PointerWrap& p)
   p.DoPOD(m_Control);
 
   p.Do(s_token);
-  p.Do(s_token_pending);
-  p.Do(s_token_interrupt_pending);
-  p.Do(s_finish_interrupt_pending);
-  p.Do(s_event_raised);
+
+  const u32 mailbox = s_token_finish_mailbox.load();
+  u16 token_pending = mailbox & MAILBOX_TOKEN_MASK;
+  bool token_interrupt_pending = (mailbox & MAILBOX_TOKEN_INTERRUPT) != 0;
+  bool finish_interrupt_pending = (mailbox & MAILBOX_FINISH_INTERRUPT) != 0;
+  bool event_raised = (mailbox & MAILBOX_EVENT_RAISED) != 0;
+  p.Do(token_pending);
+  p.Do(token_interrupt_pending);
+  p.Do(finish_interrupt_pending);
+  p.Do(event_raised);
+  if (p.GetMode() == PointerWrap::MODE_READ)
+  {
+    s_token_finish_mailbox.store(token_pending |
+                                 (token_interrupt_pending ? MAILBOX_TOKEN_INTERRUPT : 0) |
+                                 (finish_interrupt_pending ? MAILBOX_FINISH_INTERRUPT : 0) |
+                                 (event_raised ? MAILBOX_EVENT_RAISED : 0));
+  }
 
   p.Do(s_signal_token_interrupt);
   p.Do(s_signal_finish_interrupt);
@@ -147,10 +167,7 @@ void Init()
   m_AlphaRead.Hex = 0;
 
   s_token = 0;
-  s_token_pending = 0;
-  s_token_interrupt_pending = false;
-  s_finish_interrupt_pending = false;
-  s_event_raised = false;
+  s_token_finish_mailbox.store(0);
 
   s_signal_token_interrupt = false;
   s_signal_finish_interrupt = false;
@@ -252,38 +269,33 @@ static void UpdateInterrupts()
 
 static void SetTokenFinish_OnMainThread(u64 userdata, s64 cyclesLate)
 {
-  std::unique_lock<std::mutex> lk(s_token_finish_mutex);
-  s_event_raised = false;
+  // The token stays in the mailbox, only the signals are taken
+  const u32 mailbox =
+      s_token_finish_mailbox.fetch_and(MAILBOX_TOKEN_MASK, std::memory_order_acq_rel);
 
-  s_token = s_token_pending;
+  s_token = mailbox & MAILBOX_TOKEN_MASK;
 
-  if (s_token_interrupt_pending)
+  if (mailbox & MAILBOX_TOKEN_INTERRUPT)
   {
-    s_token_interrupt_pending = false;
     s_signal_token_interrupt = true;
     UpdateInterrupts();
   }
 
-  if (s_finish_interrupt_pending)
+  if (mailbox & MAILBOX_FINISH_INTERRUPT)
   {
-    s_finish_interrupt_pending = false;
     s_signal_finish_interrupt = true;
     UpdateInterrupts();
-    lk.unlock();
     Core::FrameUpdateOnCPUThread();
   }
 }
 
-// Raise the event handler above on the CPU thread.
-// s_token_finish_mutex must be locked.
+// Raise the event handler above on the CPU thread, if the mailbox was empty before.
 // THIS IS EXECUTED FROM VIDEO THREAD
-static void RaiseEvent()
+static void RaiseEvent(u32 previous_mailbox)
 {
-  if (s_event_raised)
+  if (previous_mailbox & MAILBOX_EVENT_RAISED)
     return;
 
-  s_event_raised = true;
-
   CoreTiming::FromThread from = CoreTiming::FromThread::NON_CPU;
   if (!SConfig::GetInstance().bCPUThread || Fifo::UseDeterministicGPUThread())
     from = CoreTiming::FromThread::CPU;
@@ -296,12 +308,14 @@ void SetToken(const u16 token, const bool interrupt)
 {
   DEBUG_LOG_FMT(PIXELENGINE, "VIDEO Backend raises INT_CAUSE_PE_TOKEN (btw, token: {:04x})", token);
 
-  std::lock_guard<std::mutex> lk(s_token_finish_mutex);
-
-  s_token_pending = token;
-  s_token_interrupt_pending |= interrupt;
+  const u32 signals = MAILBOX_EVENT_RAISED | (interrupt ? MAILBOX_TOKEN_INTERRUPT : 0);
+  u32 mailbox = s_token_finish_mailbox.load(std::memory_order_relaxed);
+  while (!s_token_finish_mailbox.compare_exchange_weak(
+      mailbox, (mailbox & ~MAILBOX_TOKEN_MASK) | token | signals, std::memory_order_acq_rel))
+  {
+  }
 
-  RaiseEvent();
+  RaiseEvent(mailbox);
 }
 
 // SetFinish
@@ -310,11 +324,8 @@ void SetFinish()
 {
   DEBUG_LOG_FMT(PIXELENGINE, "VIDEO Set Finish");
 
-  std::lock_guard<std::mutex> lk(s_token_finish_mutex);
-
-  s_finish_interrupt_pending |= true;
-
-  RaiseEvent();
+  RaiseEvent(s_token_finish_mailbox.fetch_or(MAILBOX_FINISH_INTERRUPT | MAILBOX_EVENT_RAISED,
+                                             std::memory_order_acq_rel));
 }
 
 UPEAlphaReadReg GetAlphaReadMode()
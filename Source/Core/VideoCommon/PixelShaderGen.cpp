@@ -6,6 +6,9 @@
 
 #include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
 
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
@@ -516,6 +519,8 @@ void UpdateBoundingBox(float2 rawpos) {{
 
 static void WriteStage(ShaderCode& out, const pixel_shader_uid_data* uid_data, int n,
                        APIType api_type, bool stereo);
+static void GenerateStage(ShaderCode& out, const pixel_shader_uid_data* uid_data, int n,
+                          APIType api_type, bool stereo);
 static void WriteTevRegular(ShaderCode& out, std::string_view components, int bias, int op,
                             int clamp, int shift, bool alpha);
 static void SampleTexture(ShaderCode& out, std::string_view texcoords, std::string_view texswap,
@@ -943,6 +948,40 @@ ShaderCode GeneratePixelShaderCode(APIType api_type, const ShaderHostConfig& hos
 
 static void WriteStage(ShaderCode& out, const pixel_shader_uid_data* uid_data, int n,
                        APIType api_type, bool stereo)
+{
+  // The code for a stage only depends on the stage's configuration, and games use the same stage
+  // configurations in many shaders, so keep the generated code around for reuse. The cache is per
+  // thread, as shaders are generated on the asynchronous compile workers too.
+  constexpr size_t MAX_CACHED_STAGES = 8192;
+  thread_local std::unordered_map<std::string, std::string> s_stage_cache;
+
+  const auto& stage = uid_data->stagehash[n];
+  const u8 flags = (stage.tevorders_texcoord < uid_data->genMode_numtexgens ? 1 : 0) |
+                   (stereo ? 2 : 0) |
+                   (DriverDetails::HasBug(DriverDetails::BUG_BROKEN_BITWISE_OP_NEGATION) ? 4 : 0);
+  std::string key(sizeof(stage) + 3, '\0');
+  std::memcpy(key.data(), &stage, sizeof(stage));
+  key[sizeof(stage)] = static_cast<char>(n);
+  key[sizeof(stage) + 1] = static_cast<char>(flags);
+  key[sizeof(stage) + 2] = static_cast<char>(api_type);
+
+  const auto iter = s_stage_cache.find(key);
+  if (iter != s_stage_cache.end())
+  {
+    out.WriteRaw(iter->second);
+    return;
+  }
+
+  const size_t start = out.GetBuffer().size();
+  GenerateStage(out, uid_data, n, api_type, stereo);
+
+  if (s_stage_cache.size() >= MAX_CACHED_STAGES)
+    s_stage_cache.clear();
+  s_stage_cache.emplace(std::move(key), out.GetBuffer().substr(start));
+}
+
+static void GenerateStage(ShaderCode& out, const pixel_shader_uid_data* uid_data, int n,
+                          APIType api_type, bool stereo)
 {
   const auto& stage = uid_data->stagehash[n];
   out.Write("\n\t// TEV stage {}\n", n);
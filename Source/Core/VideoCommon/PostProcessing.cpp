@@ -35,6 +35,18 @@ namespace VideoCommon
 {
 static const char s_default_shader[] = "void main() { SetOutput(Sample()); }\n";
 
+// Format of the intermediate textures the passes render into.
+constexpr AbstractTextureFormat PASS_TEXTURE_FORMAT = AbstractTextureFormat::RGBA8;
+
+// The outputs of the passes have a single layer, while anaglyph, passive and quad-buffered stereo
+// sample both eyes at once.
+static bool ArePassesSupported()
+{
+  return g_ActiveConfig.stereo_mode == StereoMode::Off ||
+         g_ActiveConfig.stereo_mode == StereoMode::SBS ||
+         g_ActiveConfig.stereo_mode == StereoMode::TAB;
+}
+
 PostProcessingConfiguration::PostProcessingConfiguration() = default;
 
 PostProcessingConfiguration::~PostProcessingConfiguration() = default;
@@ -389,6 +401,7 @@ bool PostProcessing::Initialize(AbstractTextureFormat format)
   if (!CompileVertexShader() || !CompilePixelShader() || !CompilePipeline())
     return false;
 
+  CompilePasses();
   return true;
 }
 
@@ -396,6 +409,7 @@ void PostProcessing::RecompileShader()
 {
   m_pipeline.reset();
   m_pixel_shader.reset();
+  CompilePasses();
   if (!CompilePixelShader())
     return;
 
@@ -421,7 +435,11 @@ void PostProcessing::BlitFromTexture(const MathUtil::Rectangle<int>& dst,
   if (!m_pipeline)
     return;
 
-  FillUniformBuffer(src, src_tex, src_layer);
+  MathUtil::Rectangle<int> pass_src = src;
+  if (!m_passes.empty() && ArePassesSupported())
+    src_tex = ApplyPasses(&pass_src, src_tex, &src_layer);
+
+  FillUniformBuffer(m_config, &m_uniform_staging_buffer, pass_src, src_tex, src_layer);
   g_vertex_manager->UploadUtilityUniforms(m_uniform_staging_buffer.data(),
                                           static_cast<u32>(m_uniform_staging_buffer.size()));
 
@@ -433,7 +451,93 @@ void PostProcessing::BlitFromTexture(const MathUtil::Rectangle<int>& dst,
   g_renderer->Draw(0, 3);
 }
 
-std::string PostProcessing::GetUniformBufferHeader() const
+const AbstractTexture* PostProcessing::ApplyPasses(MathUtil::Rectangle<int>* src,
+                                                   const AbstractTexture* src_tex, int* src_layer)
+{
+  const size_t layer = static_cast<size_t>(*src_layer);
+  if (m_pass_sources.size() <= layer)
+    m_pass_sources.resize(layer + 1);
+
+  // Outputs can only be reused if they were rendered from the same source. Since some shaders
+  // depend on the window size, that has to be the same as well.
+  const auto& window_rect = g_renderer->GetTargetRectangle();
+  PassSource& last_source = m_pass_sources[layer];
+  bool reuse_outputs = m_source_id != 0 && last_source.id == m_source_id &&
+                       last_source.rect == *src &&
+                       last_source.window_width == window_rect.GetWidth() &&
+                       last_source.window_height == window_rect.GetHeight();
+  last_source = {m_source_id, *src, window_rect.GetWidth(), window_rect.GetHeight()};
+
+  const u32 width = static_cast<u32>(src->GetWidth());
+  const u32 height = static_cast<u32>(src->GetHeight());
+  AbstractFramebuffer* const previous_framebuffer = g_renderer->GetCurrentFramebuffer();
+  bool changed_framebuffer = false;
+  for (Pass& pass : m_passes)
+  {
+    if (pass.outputs.size() <= layer)
+      pass.outputs.resize(layer + 1);
+    Pass::Output& output = pass.outputs[layer];
+
+    // Once a pass has rendered, all of the following ones have new input.
+    reuse_outputs = reuse_outputs && output.valid && !pass.uses_time;
+    if (!reuse_outputs)
+    {
+      output.valid = false;
+      if (!PrepareOutput(&output, width, height))
+        break;
+
+      FillUniformBuffer(pass.config, &pass.uniform_staging_buffer, *src, src_tex, *src_layer);
+      g_vertex_manager->UploadUtilityUniforms(
+          pass.uniform_staging_buffer.data(),
+          static_cast<u32>(pass.uniform_staging_buffer.size()));
+
+      g_renderer->SetAndDiscardFramebuffer(output.framebuffer.get());
+      g_renderer->SetViewportAndScissor(output.framebuffer->GetRect());
+      g_renderer->SetPipeline(pass.pipeline.get());
+      g_renderer->SetTexture(0, src_tex);
+      g_renderer->SetSamplerState(0, RenderState::GetLinearSamplerState());
+      g_renderer->Draw(0, 3);
+      output.texture->FinishedRendering();
+      output.valid = true;
+      changed_framebuffer = true;
+    }
+
+    src_tex = output.texture.get();
+    *src = output.texture->GetRect();
+    *src_layer = 0;
+  }
+
+  if (changed_framebuffer)
+    g_renderer->SetFramebuffer(previous_framebuffer);
+
+  return src_tex;
+}
+
+bool PostProcessing::PrepareOutput(Pass::Output* output, u32 width, u32 height)
+{
+  if (output->texture && output->texture->GetWidth() == width &&
+      output->texture->GetHeight() == height)
+  {
+    return true;
+  }
+
+  output->framebuffer.reset();
+  output->texture = g_renderer->CreateTexture(
+      TextureConfig(width, height, 1, 1, 1, PASS_TEXTURE_FORMAT, AbstractTextureFlag_RenderTarget));
+  if (!output->texture)
+    return false;
+
+  output->framebuffer = g_renderer->CreateFramebuffer(output->texture.get(), nullptr);
+  if (!output->framebuffer)
+  {
+    output->texture.reset();
+    return false;
+  }
+
+  return true;
+}
+
+std::string PostProcessing::GetUniformBufferHeader(const PostProcessingConfiguration& config) const
 {
   std::ostringstream ss;
   u32 unused_counter = 1;
@@ -453,7 +557,7 @@ std::string PostProcessing::GetUniformBufferHeader() const
   ss << "\n";
 
   // Custom options/uniforms
-  for (const auto& it : m_config.GetOptions())
+  for (const auto& it : config.GetOptions())
   {
     if (it.second.m_type ==
         PostProcessingConfiguration::ConfigurationOption::OptionType::OPTION_BOOL)
@@ -492,10 +596,10 @@ std::string PostProcessing::GetUniformBufferHeader() const
   return ss.str();
 }
 
-std::string PostProcessing::GetHeader() const
+std::string PostProcessing::GetHeader(const PostProcessingConfiguration& config) const
 {
   std::ostringstream ss;
-  ss << GetUniformBufferHeader();
+  ss << GetUniformBufferHeader(config);
   if (g_ActiveConfig.backend_info.api_type == APIType::D3D)
   {
     ss << "Texture2DArray samp0 : register(t0);\n";
@@ -603,8 +707,10 @@ void main(in float3 v_tex0_ : TEXCOORD0, out float4 ocol0_ : SV_Target)
 
 bool PostProcessing::CompileVertexShader()
 {
+  // Only the builtin uniforms at the start of the buffer are used, which are the same for all
+  // shaders.
   std::ostringstream ss;
-  ss << GetUniformBufferHeader();
+  ss << GetUniformBufferHeader(PostProcessingConfiguration());
 
   if (g_ActiveConfig.backend_info.api_type == APIType::D3D)
   {
@@ -657,13 +763,14 @@ struct BuiltinUniforms
   u32 padding[2];
 };
 
-size_t PostProcessing::CalculateUniformsSize() const
+size_t PostProcessing::CalculateUniformsSize(const PostProcessingConfiguration& config) const
 {
   // Allocate a vec4 for each uniform to simplify allocation.
-  return sizeof(BuiltinUniforms) + m_config.GetOptions().size() * sizeof(float) * 4;
+  return sizeof(BuiltinUniforms) + config.GetOptions().size() * sizeof(float) * 4;
 }
 
-void PostProcessing::FillUniformBuffer(const MathUtil::Rectangle<int>& src,
+void PostProcessing::FillUniformBuffer(const PostProcessingConfiguration& config,
+                                       std::vector<u8>* buffer, const MathUtil::Rectangle<int>& src,
                                        const AbstractTexture* src_tex, int src_layer)
 {
   const auto& window_rect = g_renderer->GetTargetRectangle();
@@ -681,11 +788,11 @@ void PostProcessing::FillUniformBuffer(const MathUtil::Rectangle<int>& src,
       static_cast<u32>(m_timer.GetTimeElapsed()),
   };
 
-  u8* buf = m_uniform_staging_buffer.data();
+  u8* buf = buffer->data();
   std::memcpy(buf, &builtin_uniforms, sizeof(builtin_uniforms));
   buf += sizeof(builtin_uniforms);
 
-  for (const auto& it : m_config.GetOptions())
+  for (const auto& it : config.GetOptions())
   {
     union
     {
@@ -726,7 +833,7 @@ bool PostProcessing::CompilePixelShader()
   // Generate GLSL and compile the new shader.
   m_config.LoadShader(g_ActiveConfig.sPostProcessingShader);
   m_pixel_shader = g_renderer->CreateShaderFromSource(
-      ShaderStage::Pixel, GetHeader() + m_config.GetShaderCode() + GetFooter());
+      ShaderStage::Pixel, GetHeader(m_config) + m_config.GetShaderCode() + GetFooter());
   if (!m_pixel_shader)
   {
     PanicAlertFmt("Failed to compile post-processing shader {}", m_config.GetShader());
@@ -734,12 +841,12 @@ bool PostProcessing::CompilePixelShader()
     // Use default shader.
     m_config.LoadDefaultShader();
     m_pixel_shader = g_renderer->CreateShaderFromSource(
-        ShaderStage::Pixel, GetHeader() + m_config.GetShaderCode() + GetFooter());
+        ShaderStage::Pixel, GetHeader(m_config) + m_config.GetShaderCode() + GetFooter());
     if (!m_pixel_shader)
       return false;
   }
 
-  m_uniform_staging_buffer.resize(CalculateUniformsSize());
+  m_uniform_staging_buffer.resize(CalculateUniformsSize(m_config));
   return true;
 }
 
@@ -761,4 +868,52 @@ bool PostProcessing::CompilePipeline()
 
   return true;
 }
+
+void PostProcessing::CompilePasses()
+{
+  m_passes.clear();
+  m_pass_sources.clear();
+  m_pass_shaders = g_ActiveConfig.sPostProcessingShaderPasses;
+  if (m_pass_shaders.empty())
+    return;
+
+  if (!ArePassesSupported())
+  {
+    WARN_LOG_FMT(VIDEO, "Post-processing passes are not supported in this stereoscopic mode");
+    return;
+  }
+
+  for (const std::string& name : SplitString(m_pass_shaders, ','))
+  {
+    const std::string shader(StripSpaces(name));
+    if (shader.empty())
+      continue;
+
+    Pass pass;
+    pass.config.LoadShader(shader);
+    pass.pixel_shader = g_renderer->CreateShaderFromSource(
+        ShaderStage::Pixel, GetHeader(pass.config) + pass.config.GetShaderCode() + GetFooter());
+    if (!pass.pixel_shader)
+    {
+      ERROR_LOG_FMT(VIDEO, "Failed to compile post-processing pass {}", shader);
+      continue;
+    }
+
+    AbstractPipelineConfig config = {};
+    config.vertex_shader = m_vertex_shader.get();
+    config.pixel_shader = pass.pixel_shader.get();
+    config.rasterization_state = RenderState::GetNoCullRasterizationState(PrimitiveType::Triangles);
+    config.depth_state = RenderState::GetNoDepthTestingDepthState();
+    config.blending_state = RenderState::GetNoBlendingBlendState();
+    config.framebuffer_state = RenderState::GetColorFramebufferState(PASS_TEXTURE_FORMAT);
+    config.usage = AbstractPipelineUsage::Utility;
+    pass.pipeline = g_renderer->CreatePipeline(config);
+    if (!pass.pipeline)
+      continue;
+
+    pass.uniform_staging_buffer.resize(CalculateUniformsSize(pass.config));
+    pass.uses_time = pass.config.GetShaderCode().find("GetTime") != std::string::npos;
+    m_passes.push_back(std::move(pass));
+  }
+}
 }  // namespace VideoCommon
@@ -14,6 +14,7 @@
 #include "Common/Timer.h"
 #include "VideoCommon/TextureConfig.h"
 
+class AbstractFramebuffer;
 class AbstractPipeline;
 class AbstractShader;
 class AbstractTexture;
@@ -99,26 +100,72 @@ public:
   static std::vector<std::string> GetAnaglyphShaderList();
 
   PostProcessingConfiguration* GetConfig() { return &m_config; }
+  // The comma-separated shaders the passes were created from.
+  const std::string& GetPassShaders() const { return m_pass_shaders; }
 
   bool Initialize(AbstractTextureFormat format);
 
   void RecompileShader();
   void RecompilePipeline();
 
+  // Identifies the contents of the texture passed to the following BlitFromTexture calls. The
+  // outputs of the passes are reused while it stays the same, e.g. for duplicate frames, even if
+  // the image is in a different texture.
+  void SetSourceID(u64 id) { m_source_id = id; }
+
   void BlitFromTexture(const MathUtil::Rectangle<int>& dst, const MathUtil::Rectangle<int>& src,
                        const AbstractTexture* src_tex, int src_layer);
 
 protected:
-  std::string GetUniformBufferHeader() const;
-  std::string GetHeader() const;
+  // A shader from sPostProcessingShaderPasses, which runs before the main shader and renders into
+  // an intermediate texture at the size of the source rectangle. The next pass samples that.
+  struct Pass
+  {
+    PostProcessingConfiguration config;
+    std::unique_ptr<AbstractShader> pixel_shader;
+    std::unique_ptr<AbstractPipeline> pipeline;
+    std::vector<u8> uniform_staging_buffer;
+
+    // Shaders which animate can't have their output reused.
+    bool uses_time = false;
+
+    // Outputs are kept per source layer, as stereo modes other than quad-buffered blit each eye
+    // separately.
+    struct Output
+    {
+      std::unique_ptr<AbstractTexture> texture;
+      std::unique_ptr<AbstractFramebuffer> framebuffer;
+      bool valid = false;
+    };
+    std::vector<Output> outputs;
+  };
+
+  // What the pass outputs of a source layer were last rendered from.
+  struct PassSource
+  {
+    u64 id = 0;
+    MathUtil::Rectangle<int> rect;
+    int window_width = 0;
+    int window_height = 0;
+  };
+
+  std::string GetUniformBufferHeader(const PostProcessingConfiguration& config) const;
+  std::string GetHeader(const PostProcessingConfiguration& config) const;
   std::string GetFooter() const;
 
   bool CompileVertexShader();
   bool CompilePixelShader();
   bool CompilePipeline();
+  void CompilePasses();
+
+  // Runs the passes, and returns the output of the last one in place of the source.
+  const AbstractTexture* ApplyPasses(MathUtil::Rectangle<int>* src, const AbstractTexture* src_tex,
+                                     int* src_layer);
+  bool PrepareOutput(Pass::Output* output, u32 width, u32 height);
 
-  size_t CalculateUniformsSize() const;
-  void FillUniformBuffer(const MathUtil::Rectangle<int>& src, const AbstractTexture* src_tex,
+  size_t CalculateUniformsSize(const PostProcessingConfiguration& config) const;
+  void FillUniformBuffer(const PostProcessingConfiguration& config, std::vector<u8>* buffer,
+                         const MathUtil::Rectangle<int>& src, const AbstractTexture* src_tex,
                          int src_layer);
 
   // Timer for determining our time value
@@ -130,5 +177,10 @@ protected:
   std::unique_ptr<AbstractPipeline> m_pipeline;
   AbstractTextureFormat m_framebuffer_format = AbstractTextureFormat::Undefined;
   std::vector<u8> m_uniform_staging_buffer;
+
+  std::string m_pass_shaders;
+  std::vector<Pass> m_passes;
+  std::vector<PassSource> m_pass_sources;
+  u64 m_source_id = 0;
 };
 }  // namespace VideoCommon
@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cinttypes>
 #include <cmath>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -62,6 +63,8 @@
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/FPSCounter.h"
 #include "VideoCommon/FrameDump.h"
+#include "VideoCommon/FrameProfiler.h"
+#include "VideoCommon/FrameTimeBreakdown.h"
 #include "VideoCommon/FramebufferManager.h"
 #include "VideoCommon/FramebufferShaderGen.h"
 #include "VideoCommon/FreeLookCamera.h"
@@ -92,6 +95,8 @@ static float AspectToWidescreen(float aspect)
   return aspect * ((16.0f / 9.0f) / (4.0f / 3.0f));
 }
 
+static Renderer::FrameCallback s_frame_callback;
+
 static bool DumpFrameToPNG(const FrameDump::FrameData& frame, const std::string& file_name)
 {
   return Common::ConvertRGBAToRGBAndSavePNG(file_name, frame.data, frame.width, frame.height,
@@ -308,6 +313,27 @@ float Renderer::EFBToScaledYf(float y) const
   return y * ((float)GetTargetHeight() / (float)EFB_HEIGHT);
 }
 
+void Renderer::AddGPUTime(u64 frame, double milliseconds)
+{
+  if (g_ActiveConfig.bDynamicResolution)
+    m_dynamic_resolution.AddGPUTime(frame, milliseconds);
+}
+
+void Renderer::UpdateDynamicResolution()
+{
+  const u64 current_time_us = Common::Timer::GetTimeUs();
+  const double frame_time_ms = (current_time_us - m_last_frame_end_time_us) / 1000.0;
+  m_last_frame_end_time_us = current_time_us;
+  if (!g_ActiveConfig.bDynamicResolution)
+    return;
+
+  // The new scale is picked up by CheckForConfigChanges, which recreates the EFB.
+  m_dynamic_resolution.EndFrame(
+      m_frame_count, frame_time_ms,
+      static_cast<u32>(std::max(g_ActiveConfig.iDynamicResolutionMinScale, 1)),
+      m_max_dynamic_efb_scale);
+}
+
 std::tuple<int, int> Renderer::CalculateTargetScale(int x, int y) const
 {
   return std::make_tuple(x * static_cast<int>(m_efb_scale), y * static_cast<int>(m_efb_scale));
@@ -328,6 +354,21 @@ bool Renderer::CalculateTargetSize()
     m_efb_scale = g_ActiveConfig.iEFBScale;
   }
 
+  if (g_ActiveConfig.bDynamicResolution)
+  {
+    if (m_efb_scale != m_max_dynamic_efb_scale)
+    {
+      m_max_dynamic_efb_scale = m_efb_scale;
+      m_dynamic_resolution.Reset(m_frame_count);
+    }
+    m_efb_scale = m_dynamic_resolution.GetScale(
+        static_cast<u32>(std::max(g_ActiveConfig.iDynamicResolutionMinScale, 1)), m_efb_scale);
+  }
+  else
+  {
+    m_max_dynamic_efb_scale = 0;
+  }
+
   const u32 max_size = g_ActiveConfig.backend_info.MaxTextureSize;
   if (max_size < EFB_WIDTH * m_efb_scale)
     m_efb_scale = max_size / EFB_WIDTH;
@@ -418,7 +459,8 @@ void Renderer::CheckForConfigChanges()
 
   // Check for post-processing shader changes. Done up here as it doesn't affect anything outside
   // the post-processor. Note that options are applied every frame, so no need to check those.
-  if (m_post_processor->GetConfig()->GetShader() != g_ActiveConfig.sPostProcessingShader)
+  if (m_post_processor->GetConfig()->GetShader() != g_ActiveConfig.sPostProcessingShader ||
+      m_post_processor->GetPassShaders() != g_ActiveConfig.sPostProcessingShaderPasses)
   {
     // The existing shader must not be in use when it's destroyed
     WaitForGPUIdle();
@@ -552,6 +594,8 @@ void Renderer::DrawDebugText()
   if (g_ActiveConfig.bOverlayStats)
     g_stats.Display();
 
+  FrameTimeBreakdown::Draw(m_backbuffer_scale);
+
   if (g_ActiveConfig.bShowNetPlayMessages && g_netplay_chat_ui)
     g_netplay_chat_ui->Display();
 
@@ -1202,8 +1246,13 @@ void Renderer::UpdateWidescreenHeuristic()
   m_was_orthographically_anamorphic = ortho_looks_anamorphic;
 }
 
-void Renderer::Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u64 ticks)
+void Renderer::Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u64 ticks,
+                    bool present)
 {
+  const FrameProfiler::ScopedSection profiler_section(FrameProfiler::Section::Present);
+  const FrameTimeBreakdown::ScopedCategory breakdown_category(
+      FrameTimeBreakdown::Category::BackendSubmission);
+
   if (SConfig::GetInstance().bWii)
     m_is_game_widescreen = Config::Get(Config::SYSCONF_WIDESCREEN);
 
@@ -1224,7 +1273,7 @@ void Renderer::Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u6
   }
 
   // Ensure the last frame was written to the dump.
-  // This is required even if frame dumping has stopped, since the frame dump is one frame
+  // This is required even if frame dumping has stopped, since the frame dump is a few frames
   // behind the renderer.
   FlushFrameDump();
 
@@ -1240,11 +1289,32 @@ void Renderer::Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u6
       const bool is_duplicate_frame = xfb_entry->id == m_last_xfb_id;
       m_last_xfb_id = xfb_entry->id;
 
+      // Games which run below the refresh rate often copy the same image to the XFB again, which
+      // gives a new texture. The hash of the copy in guest memory tells these apart from new
+      // images, but only once it has been written there, which never happens when XFB copies
+      // are kept in VRAM.
+      std::optional<XFBContent> xfb_content;
+      if (!g_ActiveConfig.bSkipXFBCopyToRam && !xfb_entry->pending_efb_copy)
+      {
+        xfb_content = XFBContent{xfb_entry->addr, xfb_entry->native_width,
+                                 xfb_entry->native_height, xfb_entry->memory_stride,
+                                 xfb_entry->hash};
+      }
+      if (!is_duplicate_frame && (!xfb_content || xfb_content != m_last_xfb_content))
+        m_last_xfb_content_id = xfb_entry->id;
+      m_last_xfb_content = xfb_content;
+      const bool is_duplicate_image =
+          is_duplicate_frame || m_last_xfb_content_id != xfb_entry->id;
+
       // Since we use the common pipelines here and draw vertices if a batch is currently being
       // built by the vertex loader, we end up trampling over its pointer, as we share the buffer
       // with the loader, and it has not been unmapped yet. Force a pipeline flush to avoid this.
       g_vertex_manager->Flush();
 
+      // Kick off the peek cache readbacks for the next frame before presenting.
+      if (!is_duplicate_frame)
+        g_framebuffer_manager->OnEndFrame();
+
       // Render any UI elements to the draw list.
       {
         auto lock = GetImGuiLock();
@@ -1256,7 +1326,8 @@ void Renderer::Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u6
 
       // Render the XFB to the screen.
       BeginUtilityDrawing();
-      if (!IsHeadless())
+      if (!IsHeadless() && present &&
+          !(g_ActiveConfig.bSkipPresentingDuplicateXFBs && is_duplicate_image))
       {
         BindBackbuffer({{0.0f, 0.0f, 0.0f, 1.0f}});
 
@@ -1270,12 +1341,15 @@ void Renderer::Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u6
         auto render_source_rc = xfb_rect;
         AdjustRectanglesToFitBounds(&render_target_rc, &render_source_rc, m_backbuffer_width,
                                     m_backbuffer_height);
+        m_post_processor->SetSourceID(m_last_xfb_content_id);
         RenderXFBToScreen(render_target_rc, xfb_entry->texture.get(), render_source_rc);
 
         DrawImGui();
 
         // Present to the window system.
         {
+          const FrameTimeBreakdown::ScopedCategory present_category(
+              FrameTimeBreakdown::Category::PresentWait);
           std::lock_guard<std::mutex> guard(m_swap_mutex);
           PresentBackbuffer();
         }
@@ -1296,7 +1370,15 @@ void Renderer::Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u6
         DolphinAnalytics::Instance().ReportPerformanceInfo(std::move(perf_sample));
 
         if (IsFrameDumping())
-          DumpCurrentFrame(xfb_entry->texture.get(), xfb_rect, ticks, m_frame_count);
+        {
+          DumpCurrentFrame(xfb_entry->texture.get(), xfb_rect, ticks, m_frame_count,
+                           m_last_xfb_content_id);
+        }
+
+        OnEndFrame();
+        UpdateDynamicResolution();
+        FrameProfiler::EndFrame(m_frame_count);
+        FrameTimeBreakdown::EndFrame(m_frame_count);
 
         // Begin new frame
         m_frame_count++;
@@ -1304,6 +1386,7 @@ void Renderer::Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u6
       }
 
       g_shader_cache->RetrieveAsyncShaders();
+      g_shader_cache->OnEndFrame();
       g_vertex_manager->OnEndFrame();
       BeginImGuiFrame();
 
@@ -1374,11 +1457,19 @@ void Renderer::RenderXFBToScreen(const MathUtil::Rectangle<int>& target_rc,
   }
 }
 
+void Renderer::SetFrameCallback(FrameCallback callback)
+{
+  s_frame_callback = std::move(callback);
+}
+
 bool Renderer::IsFrameDumping() const
 {
   if (m_screenshot_request.IsSet())
     return true;
 
+  if (s_frame_callback)
+    return true;
+
   if (SConfig::GetInstance().m_DumpFrames)
     return true;
 
@@ -1387,8 +1478,17 @@ bool Renderer::IsFrameDumping() const
 
 void Renderer::DumpCurrentFrame(const AbstractTexture* src_texture,
                                 const MathUtil::Rectangle<int>& src_rect, u64 ticks,
-                                int frame_number)
+                                int frame_number, u64 content_id)
 {
+  // Screenshots and the frame callback need the image of every frame.
+  if (content_id == m_last_dumped_xfb_content_id && !m_screenshot_request.IsSet() &&
+      !s_frame_callback)
+  {
+    m_frame_dump_readbacks.push_back({nullptr, m_frame_dump.FetchState(ticks, frame_number)});
+    return;
+  }
+  m_last_dumped_xfb_content_id = std::numeric_limits<u64>::max();
+
   int source_width = src_rect.GetWidth();
   int source_height = src_rect.GetHeight();
   int target_width, target_height;
@@ -1416,13 +1516,15 @@ void Renderer::DumpCurrentFrame(const AbstractTexture* src_texture,
     copy_rect = src_texture->GetRect();
   }
 
-  if (!CheckFrameDumpReadbackTexture(target_width, target_height))
+  std::unique_ptr<AbstractStagingTexture> readback =
+      GetFrameDumpReadbackTexture(target_width, target_height);
+  if (!readback)
     return;
 
-  m_frame_dump_readback_texture->CopyFromTexture(src_texture, copy_rect, 0, 0,
-                                                 m_frame_dump_readback_texture->GetRect());
-  m_last_frame_state = m_frame_dump.FetchState(ticks, frame_number);
-  m_frame_dump_needs_flush = true;
+  readback->CopyFromTexture(src_texture, copy_rect, 0, 0, readback->GetRect());
+  m_frame_dump_readbacks.push_back(
+      {std::move(readback), m_frame_dump.FetchState(ticks, frame_number)});
+  m_last_dumped_xfb_content_id = content_id;
 }
 
 bool Renderer::CheckFrameDumpRenderTexture(u32 target_width, u32 target_height)
@@ -1451,79 +1553,98 @@ bool Renderer::CheckFrameDumpRenderTexture(u32 target_width, u32 target_height)
   return true;
 }
 
-bool Renderer::CheckFrameDumpReadbackTexture(u32 target_width, u32 target_height)
+std::unique_ptr<AbstractStagingTexture> Renderer::GetFrameDumpReadbackTexture(u32 target_width,
+                                                                              u32 target_height)
 {
-  std::unique_ptr<AbstractStagingTexture>& rbtex = m_frame_dump_readback_texture;
-  if (rbtex && rbtex->GetWidth() == target_width && rbtex->GetHeight() == target_height)
-    return true;
+  // Reuse the texture of a frame which has already been dumped, dropping any of the wrong size.
+  while (!m_frame_dump_free_textures.empty())
+  {
+    std::unique_ptr<AbstractStagingTexture> rbtex = std::move(m_frame_dump_free_textures.back());
+    m_frame_dump_free_textures.pop_back();
+    if (rbtex->GetWidth() == target_width && rbtex->GetHeight() == target_height)
+      return rbtex;
+  }
 
-  rbtex.reset();
-  rbtex = CreateStagingTexture(
+  return CreateStagingTexture(
       StagingTextureType::Readback,
       TextureConfig(target_width, target_height, 1, 1, 1, AbstractTextureFormat::RGBA8, 0));
-  if (!rbtex)
-    return false;
-
-  return true;
 }
 
 void Renderer::FlushFrameDump()
 {
-  if (!m_frame_dump_needs_flush)
-    return;
+  const bool is_frame_dumping = IsFrameDumping();
+  while (!m_frame_dump_readbacks.empty() &&
+         (!is_frame_dumping || m_frame_dump_readbacks.size() >= FRAME_DUMP_READBACK_LATENCY))
+  {
+    FlushFrameDumpReadback();
+  }
 
-  // Ensure dumping thread is done with output texture before swapping.
-  FinishFrameData();
+  // Shutdown frame dumping if it is no longer active.
+  if (!is_frame_dumping)
+    ShutdownFrameDumping();
+}
+
+void Renderer::FlushFrameDumpReadback()
+{
+  FrameDumpReadback readback = std::move(m_frame_dump_readbacks.front());
+  m_frame_dump_readbacks.pop_front();
 
-  std::swap(m_frame_dump_output_texture, m_frame_dump_readback_texture);
+  // Only wait for the dumping thread if it has fallen too far behind, so that a slow encoder
+  // doesn't stall every frame.
+  FinishFrameData(MAX_QUEUED_FRAME_DUMPS - 1);
+
+  auto& output = readback.texture;
+  if (!output)
+  {
+    DumpFrameData(nullptr, 0, 0, 0, readback.state);
+    return;
+  }
 
-  // Queue encoding of the last frame dumped.
-  auto& output = m_frame_dump_output_texture;
   output->Flush();
   if (output->Map())
   {
     DumpFrameData(reinterpret_cast<u8*>(output->GetMappedPointer()), output->GetConfig().width,
-                  output->GetConfig().height, static_cast<int>(output->GetMappedStride()));
+                  output->GetConfig().height, static_cast<int>(output->GetMappedStride()),
+                  readback.state);
+    m_frame_dump_output_textures.push_back(std::move(output));
   }
   else
   {
     ERROR_LOG_FMT(VIDEO, "Failed to map texture for dumping.");
+    m_frame_dump_free_textures.push_back(std::move(output));
   }
-
-  m_frame_dump_needs_flush = false;
-
-  // Shutdown frame dumping if it is no longer active.
-  if (!IsFrameDumping())
-    ShutdownFrameDumping();
 }
 
 void Renderer::ShutdownFrameDumping()
 {
-  // Ensure the last queued readback has been sent to the encoder.
-  FlushFrameDump();
+  // Ensure the queued readbacks have been sent to the encoder.
+  while (!m_frame_dump_readbacks.empty())
+    FlushFrameDumpReadback();
 
   if (!m_frame_dump_thread_running.IsSet())
     return;
 
-  // Ensure previous frame has been encoded.
+  // Ensure all queued frames have been encoded.
   FinishFrameData();
 
   // Wake thread up, and wait for it to exit.
-  m_frame_dump_thread_running.Clear();
-  m_frame_dump_start.Set();
+  {
+    std::lock_guard<std::mutex> guard(m_frame_dump_lock);
+    m_frame_dump_thread_running.Clear();
+  }
+  m_frame_dump_start.notify_one();
   if (m_frame_dump_thread.joinable())
     m_frame_dump_thread.join();
   m_frame_dump_render_framebuffer.reset();
   m_frame_dump_render_texture.reset();
 
-  m_frame_dump_readback_texture.reset();
-  m_frame_dump_output_texture.reset();
+  m_frame_dump_free_textures.clear();
+  m_last_dumped_xfb_content_id = std::numeric_limits<u64>::max();
 }
 
-void Renderer::DumpFrameData(const u8* data, int w, int h, int stride)
+void Renderer::DumpFrameData(const u8* data, int w, int h, int stride,
+                             const FrameDump::FrameState& state)
 {
-  m_frame_dump_data = FrameDump::FrameData{data, w, h, stride, m_last_frame_state};
-
   if (!m_frame_dump_thread_running.IsSet())
   {
     if (m_frame_dump_thread.joinable())
@@ -1533,19 +1654,33 @@ void Renderer::DumpFrameData(const u8* data, int w, int h, int stride)
   }
 
   // Wake worker thread up.
-  m_frame_dump_start.Set();
-  m_frame_dump_frame_running = true;
+  {
+    std::lock_guard<std::mutex> guard(m_frame_dump_lock);
+    m_frame_dump_queue.push_back(FrameDump::FrameData{data, w, h, stride, state});
+    m_frame_dumps_pending++;
+  }
+  m_frame_dump_start.notify_one();
 }
 
-void Renderer::FinishFrameData()
+void Renderer::FinishFrameData(size_t max_pending_frames)
 {
-  if (!m_frame_dump_frame_running)
-    return;
-
-  m_frame_dump_done.Wait();
-  m_frame_dump_frame_running = false;
+  size_t pending_frames;
+  {
+    std::unique_lock<std::mutex> lock(m_frame_dump_lock);
+    m_frame_dump_done.wait(lock, [this, max_pending_frames]() {
+      return m_frame_dumps_pending <= max_pending_frames;
+    });
+    pending_frames = m_frame_dumps_pending;
+  }
 
-  m_frame_dump_output_texture->Unmap();
+  // Frames are processed in order, so the oldest textures are the ones which are done. They have
+  // to be unmapped on the video thread.
+  while (m_frame_dump_output_textures.size() > pending_frames)
+  {
+    m_frame_dump_output_textures.front()->Unmap();
+    m_frame_dump_free_textures.push_back(std::move(m_frame_dump_output_textures.front()));
+    m_frame_dump_output_textures.pop_front();
+  }
 }
 
 void Renderer::FrameDumpThreadFunc()
@@ -1565,16 +1700,24 @@ void Renderer::FrameDumpThreadFunc()
   }
 #endif
 
+  std::unique_lock<std::mutex> lock(m_frame_dump_lock);
   while (true)
   {
-    m_frame_dump_start.Wait();
-    if (!m_frame_dump_thread_running.IsSet())
+    m_frame_dump_start.wait(lock, [this]() {
+      return !m_frame_dump_queue.empty() || !m_frame_dump_thread_running.IsSet();
+    });
+    if (m_frame_dump_queue.empty())
       break;
 
-    auto frame = m_frame_dump_data;
+    const FrameDump::FrameData frame = m_frame_dump_queue.front();
+    m_frame_dump_queue.pop_front();
+    lock.unlock();
+
+    // Repeats of the previous frame have no data, see DumpCurrentFrame.
+    const bool is_repeated_frame = frame.data == nullptr;
 
     // Save screenshot
-    if (m_screenshot_request.TestAndClear())
+    if (!is_repeated_frame && m_screenshot_request.TestAndClear())
     {
       std::lock_guard<std::mutex> lk(m_screenshot_lock);
 
@@ -1586,9 +1729,12 @@ void Renderer::FrameDumpThreadFunc()
       m_screenshot_completed.Set();
     }
 
+    if (s_frame_callback && !is_repeated_frame)
+      s_frame_callback(frame);
+
     if (SConfig::GetInstance().m_DumpFrames)
     {
-      if (!frame_dump_started)
+      if (!frame_dump_started && !is_repeated_frame)
       {
         if (dump_to_ffmpeg)
           frame_dump_started = StartFrameDumpToFFMPEG(frame);
@@ -1610,8 +1756,11 @@ void Renderer::FrameDumpThreadFunc()
       }
     }
 
-    m_frame_dump_done.Set();
+    lock.lock();
+    m_frame_dumps_pending--;
+    m_frame_dump_done.notify_one();
   }
+  lock.unlock();
 
   if (frame_dump_started)
   {
@@ -1634,7 +1783,10 @@ bool Renderer::StartFrameDumpToFFMPEG(const FrameDump::FrameData& frame)
 
 void Renderer::DumpFrameToFFMPEG(const FrameDump::FrameData& frame)
 {
-  m_frame_dump.AddFrame(frame);
+  // A repeated frame isn't encoded again, the previous one is shown until the next frame's
+  // timestamp instead.
+  if (frame.data)
+    m_frame_dump.AddFrame(frame);
 }
 
 void Renderer::StopFrameDumpToFFMPEG()
@@ -1668,6 +1820,7 @@ std::string Renderer::GetFrameDumpNextImageFileName() const
 bool Renderer::StartFrameDumpToImage(const FrameDump::FrameData&)
 {
   m_frame_dump_image_counter = 1;
+  m_last_frame_dump_image_name.clear();
   if (!SConfig::GetInstance().m_DumpFramesSilent)
   {
     // Only check for the presence of the first image to confirm overwriting.
@@ -1686,7 +1839,17 @@ bool Renderer::StartFrameDumpToImage(const FrameDump::FrameData&)
 
 void Renderer::DumpFrameToImage(const FrameDump::FrameData& frame)
 {
-  DumpFrameToPNG(frame, GetFrameDumpNextImageFileName());
+  const std::string filename = GetFrameDumpNextImageFileName();
+  if (frame.data)
+  {
+    DumpFrameToPNG(frame, filename);
+    m_last_frame_dump_image_name = filename;
+  }
+  else if (!m_last_frame_dump_image_name.empty())
+  {
+    // Keep the numbering of the images, without compressing the same image again.
+    File::Copy(m_last_frame_dump_image_name, filename);
+  }
   m_frame_dump_image_counter++;
 }
 
@@ -1724,6 +1887,7 @@ void Renderer::DoState(PointerWrap& p)
   {
     // Force the next xfb to be displayed.
     m_last_xfb_id = std::numeric_limits<u64>::max();
+    m_last_xfb_content.reset();
 
     m_was_orthographically_anamorphic = false;
 
@@ -15,8 +15,12 @@
 #pragma once
 
 #include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <thread>
@@ -29,6 +33,7 @@
 #include "Common/MathUtil.h"
 #include "VideoCommon/AsyncShaderCompiler.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/DynamicResolution.h"
 #include "VideoCommon/FPSCounter.h"
 #include "VideoCommon/FrameDump.h"
 #include "VideoCommon/RenderState.h"
@@ -189,6 +194,11 @@ public:
   ConvertStereoRectangle(const MathUtil::Rectangle<int>& rc) const;
 
   unsigned int GetEFBScale() const;
+  int GetFrameCount() const { return m_frame_count; }
+
+  // Called by backends which can measure how long the GPU takes to render a frame, for dynamic
+  // resolution. Must be called on the video thread.
+  void AddGPUTime(u64 frame, double milliseconds);
 
   // Use this to upscale native EFB coordinates to IDEAL internal resolution
   int EFBToScaledX(int x) const;
@@ -202,6 +212,12 @@ public:
   void SaveScreenshot(std::string filename);
   void DrawDebugText();
 
+  // While set, every frame that is output gets read back like for frame dumping and passed to the
+  // callback on the frame dumping thread. DolphinNoGUI uses it to hash frames when checking
+  // movies. Must only be called while no renderer exists.
+  using FrameCallback = std::function<void(const FrameDump::FrameData&)>;
+  static void SetFrameCallback(FrameCallback callback);
+
   virtual void ClearScreen(const MathUtil::Rectangle<int>& rc, bool colorEnable, bool alphaEnable,
                            bool zEnable, u32 color, u32 z);
   virtual void ReinterpretPixelData(EFBReinterpretType convtype);
@@ -218,8 +234,9 @@ public:
   virtual void Flush() {}
   virtual void WaitForGPUIdle() {}
 
-  // Finish up the current frame, print some stats
-  void Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u64 ticks);
+  // Finish up the current frame, print some stats. If present is false, the frame isn't shown.
+  void Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u64 ticks,
+            bool present = true);
 
   void UpdateWidescreenHeuristic();
 
@@ -232,6 +249,9 @@ public:
   // Called when the configuration changes, and backend structures need to be updated.
   virtual void OnConfigChanged(u32 bits) {}
 
+  // Called once for each new frame, before the per-frame statistics are reset.
+  virtual void OnEndFrame() {}
+
   PEControl::PixelFormat GetPrevPixelFormat() const { return m_prev_efb_format; }
   void StorePixelFormat(PEControl::PixelFormat new_format) { m_prev_efb_format = new_format; }
   bool EFBHasAlphaChannel() const;
@@ -342,45 +362,65 @@ protected:
 
 private:
   std::tuple<int, int> CalculateOutputDimensions(int width, int height) const;
+  void UpdateDynamicResolution();
 
   PEControl::PixelFormat m_prev_efb_format = PEControl::INVALID_FMT;
   unsigned int m_efb_scale = 1;
 
+  // With dynamic resolution, the configured scale is the largest one m_efb_scale is set to.
+  DynamicResolution m_dynamic_resolution;
+  unsigned int m_max_dynamic_efb_scale = 0;
+  u64 m_last_frame_end_time_us = 0;
+
   // These will be set on the first call to SetWindowSize.
   int m_last_window_request_width = 0;
   int m_last_window_request_height = 0;
 
   // frame dumping:
+  // Number of frames which can be waiting for the frame dump thread, before the video thread
+  // waits for it to catch up. Each of them holds a mapped staging texture.
+  static constexpr size_t MAX_QUEUED_FRAME_DUMPS = 4;
+
+  // Number of frames a readback is left in flight for before it is mapped, so that the GPU has
+  // usually completed the copy by then and mapping it doesn't stall.
+  static constexpr size_t FRAME_DUMP_READBACK_LATENCY = 2;
+
+  // A readback without a texture stands for a frame which repeats the previous one.
+  struct FrameDumpReadback
+  {
+    std::unique_ptr<AbstractStagingTexture> texture;
+    FrameDump::FrameState state;
+  };
+
   FrameDump m_frame_dump;
   std::thread m_frame_dump_thread;
   Common::Flag m_frame_dump_thread_running;
 
+  // Communication of frames between video and dump threads.
+  std::mutex m_frame_dump_lock;
   // Used to kick frame dump thread.
-  Common::Event m_frame_dump_start;
-
-  // Set by frame dump thread on frame completion.
-  Common::Event m_frame_dump_done;
-
-  // Holds emulation state during the last swap when dumping.
-  FrameDump::FrameState m_last_frame_state;
-
-  // Communication of frame between video and dump threads.
-  FrameDump::FrameData m_frame_dump_data;
+  std::condition_variable m_frame_dump_start;
+  // Signalled by frame dump thread on frame completion.
+  std::condition_variable m_frame_dump_done;
+  std::deque<FrameDump::FrameData> m_frame_dump_queue;
+  // Number of frames which are queued or being processed by the frame dump thread.
+  size_t m_frame_dumps_pending = 0;
 
   // Texture used for screenshot/frame dumping
   std::unique_ptr<AbstractTexture> m_frame_dump_render_texture;
   std::unique_ptr<AbstractFramebuffer> m_frame_dump_render_framebuffer;
 
-  // Double buffer:
-  std::unique_ptr<AbstractStagingTexture> m_frame_dump_readback_texture;
-  std::unique_ptr<AbstractStagingTexture> m_frame_dump_output_texture;
-  // Set when readback texture holds a frame that needs to be dumped.
-  bool m_frame_dump_needs_flush = false;
-  // Set when thread is processing output texture.
-  bool m_frame_dump_frame_running = false;
+  // Readbacks of the last frames, which haven't been handed to the frame dump thread yet.
+  std::deque<FrameDumpReadback> m_frame_dump_readbacks;
+  // Mapped textures of the frames handed to the frame dump thread, oldest first.
+  std::deque<std::unique_ptr<AbstractStagingTexture>> m_frame_dump_output_textures;
+  // Unmapped textures of frames which have been processed, reused for later readbacks.
+  std::vector<std::unique_ptr<AbstractStagingTexture>> m_frame_dump_free_textures;
 
   // Used to generate screenshot names.
   u32 m_frame_dump_image_counter = 0;
+  // The image of the last frame with data, which repeated frames are copies of.
+  std::string m_last_frame_dump_image_name;
 
   // Tracking of XFB textures so we don't render duplicate frames.
   u64 m_last_xfb_id = std::numeric_limits<u64>::max();
@@ -390,6 +430,30 @@ private:
   u32 m_last_xfb_stride = 0;
   u32 m_last_xfb_height = 0;
 
+  // The guest memory the last XFB was copied to, if its hash describes the image.
+  struct XFBContent
+  {
+    u32 addr;
+    u32 width;
+    u32 height;
+    u32 stride;
+    u64 hash;
+
+    bool operator==(const XFBContent& other) const
+    {
+      return std::tie(addr, width, height, stride, hash) ==
+             std::tie(other.addr, other.width, other.height, other.stride, other.hash);
+    }
+    bool operator!=(const XFBContent& other) const { return !(*this == other); }
+  };
+  std::optional<XFBContent> m_last_xfb_content;
+  // The id of the first XFB texture which showed the current image. Later copies of the same image
+  // share it, so that work which only depends on the image can be skipped for them.
+  u64 m_last_xfb_content_id = std::numeric_limits<u64>::max();
+
+  // The content id of the last frame which was read back for dumping.
+  u64 m_last_dumped_xfb_content_id = std::numeric_limits<u64>::max();
+
   // NOTE: The methods below are called on the framedumping thread.
   void FrameDumpThreadFunc();
   bool StartFrameDumpToFFMPEG(const FrameDump::FrameData&);
@@ -406,21 +470,30 @@ private:
   // Checks that the frame dump render texture exists and is the correct size.
   bool CheckFrameDumpRenderTexture(u32 target_width, u32 target_height);
 
-  // Checks that the frame dump readback texture exists and is the correct size.
-  bool CheckFrameDumpReadbackTexture(u32 target_width, u32 target_height);
+  // Returns an unused frame dump readback texture of the specified size.
+  std::unique_ptr<AbstractStagingTexture> GetFrameDumpReadbackTexture(u32 target_width,
+                                                                      u32 target_height);
 
-  // Fills the frame dump staging texture with the current XFB texture.
+  // Fills the frame dump staging texture with the current XFB texture. If the XFB shows the same
+  // image as the last dumped frame, the frame is only marked as a repeat of it instead, so that it
+  // isn't read back and encoded again.
   void DumpCurrentFrame(const AbstractTexture* src_texture,
-                        const MathUtil::Rectangle<int>& src_rect, u64 ticks, int frame_number);
+                        const MathUtil::Rectangle<int>& src_rect, u64 ticks, int frame_number,
+                        u64 content_id);
 
   // Asynchronously encodes the specified pointer of frame data to the frame dump.
-  void DumpFrameData(const u8* data, int w, int h, int stride);
+  void DumpFrameData(const u8* data, int w, int h, int stride, const FrameDump::FrameState& state);
 
-  // Ensures all rendered frames are queued for encoding.
+  // Queues the frames whose readbacks have been in flight for long enough for encoding, or all of
+  // them if frame dumping is no longer active.
   void FlushFrameDump();
 
-  // Ensures all encoded frames have been written to the output file.
-  void FinishFrameData();
+  // Maps the oldest readback and queues it for encoding.
+  void FlushFrameDumpReadback();
+
+  // Waits until at most max_pending_frames frames are left for the frame dump thread, and
+  // releases the textures of the frames it has finished.
+  void FinishFrameData(size_t max_pending_frames = 0);
 
   std::unique_ptr<NetPlayChatUI> m_netplay_chat_ui;
 
@@ -4,13 +4,18 @@
 
 #include "VideoCommon/ShaderCache.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "Common/Assert.h"
 #include "Common/FileUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/Tracing.h"
 #include "Core/ConfigManager.h"
 
 #include "VideoCommon/FramebufferManager.h"
 #include "VideoCommon/FramebufferShaderGen.h"
+#include "VideoCommon/PipelineUIDBundle.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
@@ -54,6 +59,7 @@ void ShaderCache::InitializeShaderCache()
   {
     LoadCaches();
     LoadPipelineUIDCache();
+    VertexLoaderManager::LoadVertexLoaderUIDCache();
   }
 
   // Queue ubershader precompiling if required.
@@ -71,6 +77,8 @@ void ShaderCache::InitializeShaderCache()
 
 void ShaderCache::Reload()
 {
+  // Everything which hasn't been compiled yet would be thrown away below, and queued again.
+  m_async_shader_compiler->CancelPendingWork();
   WaitForAsyncCompiler();
   ClosePipelineUIDCache();
   ClearCaches();
@@ -106,13 +114,17 @@ void ShaderCache::Shutdown()
     m_async_shader_compiler->StopWorkerThreads();
 
   ClosePipelineUIDCache();
+  VertexLoaderManager::CloseVertexLoaderUIDCache();
 }
 
 const AbstractPipeline* ShaderCache::GetPipelineForUid(const GXPipelineUid& uid)
 {
   auto it = m_gx_pipeline_cache.find(uid);
-  if (it != m_gx_pipeline_cache.end() && !it->second.second)
+  if (it != m_gx_pipeline_cache.end() && !it->second.second &&
+      (it->second.first || m_evicted_gx_pipelines.count(uid) == 0))
+  {
     return it->second.first.get();
+  }
 
   const bool exists_in_cache = it != m_gx_pipeline_cache.end();
   std::unique_ptr<AbstractPipeline> pipeline;
@@ -129,18 +141,118 @@ std::optional<const AbstractPipeline*> ShaderCache::GetPipelineForUidAsync(const
   auto it = m_gx_pipeline_cache.find(uid);
   if (it != m_gx_pipeline_cache.end())
   {
-    // .second is the pending flag, i.e. compiling in the background.
-    if (!it->second.second)
+    // .second is the pending flag, i.e. compiling in the background. As the pipeline is needed
+    // now, make sure it isn't stuck behind the precompiling of the shader cache.
+    if (it->second.second)
+    {
+      BumpPipelinePriority(uid, COMPILE_PRIORITY_ONDEMAND_PIPELINE);
+      return {};
+    }
+
+    if (it->second.first || m_evicted_gx_pipelines.count(uid) == 0)
+    {
+      if (g_ActiveConfig.iMaxSpecializedPipelines > 0)
+        m_gx_pipeline_last_use[uid] = m_frame_count;
       return it->second.first.get();
-    else
+    }
+
+    // The specialized pipeline was evicted, the ubershaders are used until it's compiled again.
+    if (!IsHotPipeline(uid))
       return {};
+
+    QueuePipelineCompile(uid, COMPILE_PRIORITY_ONDEMAND_PIPELINE);
+    return {};
   }
 
+  if (!IsHotPipeline(uid))
+    return {};
+
   AppendGXPipelineUID(uid);
   QueuePipelineCompile(uid, COMPILE_PRIORITY_ONDEMAND_PIPELINE);
   return {};
 }
 
+bool ShaderCache::IsHotPipeline(const GXPipelineUid& uid)
+{
+  // Without ubershaders to fall back to, there's no point in waiting.
+  const int threshold = g_ActiveConfig.iHybridUberShaderCompileThreshold;
+  if (threshold <= 0 ||
+      g_ActiveConfig.iShaderCompilationMode != ShaderCompilationMode::AsynchronousUberShaders)
+  {
+    return true;
+  }
+
+  auto iter = m_gx_pipeline_use_counts.try_emplace(uid, 0).first;
+  if (++iter->second < static_cast<u32>(threshold))
+    return false;
+
+  m_gx_pipeline_use_counts.erase(iter);
+  return true;
+}
+
+void ShaderCache::OnEndFrame()
+{
+  // Pipelines have to be used often enough within this many frames to be worth compiling.
+  constexpr u32 USE_COUNT_DECAY_INTERVAL = 60;
+  m_frame_count++;
+  if (m_frame_count % USE_COUNT_DECAY_INTERVAL == 0)
+  {
+    for (auto iter = m_gx_pipeline_use_counts.begin(); iter != m_gx_pipeline_use_counts.end();)
+    {
+      iter->second /= 2;
+      iter = iter->second == 0 ? m_gx_pipeline_use_counts.erase(iter) : std::next(iter);
+    }
+  }
+
+  const int max_pipelines = g_ActiveConfig.iMaxSpecializedPipelines;
+  if (max_pipelines <= 0 ||
+      g_ActiveConfig.iShaderCompilationMode != ShaderCompilationMode::AsynchronousUberShaders)
+  {
+    m_gx_pipeline_last_use.clear();
+    return;
+  }
+
+  if (m_gx_pipeline_last_use.size() > static_cast<size_t>(max_pipelines))
+  {
+    // Evict down to 3/4 of the limit, so that the GPU doesn't have to be waited for every frame.
+    EvictColdPipelines(static_cast<size_t>(max_pipelines) * 3 / 4);
+  }
+}
+
+void ShaderCache::EvictColdPipelines(size_t max_pipelines)
+{
+  // Pipelines used in the current frame may still be bound, so only older ones are evicted.
+  std::vector<std::pair<u32, GXPipelineUid>> candidates;
+  for (const auto& it : m_gx_pipeline_last_use)
+  {
+    if (it.second != m_frame_count - 1)
+      candidates.emplace_back(it.second, it.first);
+  }
+  if (candidates.empty())
+    return;
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  // The pipelines may still be referenced by command buffers which haven't been executed yet.
+  g_renderer->WaitForGPUIdle();
+
+  for (const auto& candidate : candidates)
+  {
+    if (m_gx_pipeline_last_use.size() <= max_pipelines)
+      break;
+
+    m_gx_pipeline_last_use.erase(candidate.second);
+    auto iter = m_gx_pipeline_cache.find(candidate.second);
+    if (iter == m_gx_pipeline_cache.end() || !iter->second.first || iter->second.second)
+      continue;
+
+    iter->second.first.reset();
+    m_evicted_gx_pipelines.insert(candidate.second);
+    INCSTAT(g_stats.num_pipelines_evicted);
+  }
+}
+
 const AbstractPipeline* ShaderCache::GetUberPipelineForUid(const GXUberPipelineUid& uid)
 {
   auto it = m_gx_uber_pipeline_cache.find(uid);
@@ -154,6 +266,22 @@ const AbstractPipeline* ShaderCache::GetUberPipelineForUid(const GXUberPipelineU
   return InsertGXUberPipeline(uid, std::move(pipeline));
 }
 
+std::optional<const AbstractPipeline*>
+ShaderCache::GetUberPipelineForUidAsync(const GXUberPipelineUid& uid)
+{
+  auto it = m_gx_uber_pipeline_cache.find(uid);
+  if (it != m_gx_uber_pipeline_cache.end())
+  {
+    if (it->second.second)
+      return {};
+
+    return it->second.first.get();
+  }
+
+  QueueUberPipelineCompile(uid, COMPILE_PRIORITY_UBERSHADER_PIPELINE);
+  return {};
+}
+
 void ShaderCache::WaitForAsyncCompiler()
 {
   while (m_async_shader_compiler->HasPendingWork() || m_async_shader_compiler->HasCompletedWork())
@@ -369,6 +497,10 @@ void ShaderCache::LoadCaches()
 void ShaderCache::ClearCaches()
 {
   ClearPipelineCache(m_gx_pipeline_cache, m_gx_pipeline_disk_cache);
+  m_gx_pipeline_work_items.clear();
+  m_gx_pipeline_use_counts.clear();
+  m_gx_pipeline_last_use.clear();
+  m_evicted_gx_pipelines.clear();
   ClearShaderCache(m_vs_cache);
   ClearShaderCache(m_gs_cache);
   ClearShaderCache(m_ps_cache);
@@ -417,6 +549,8 @@ void ShaderCache::CompileMissingPipelines()
 
 std::unique_ptr<AbstractShader> ShaderCache::CompileVertexShader(const VertexShaderUid& uid) const
 {
+  TRACE_SCOPE("ShaderCache::CompileVertexShader");
+
   const ShaderCode source_code =
       GenerateVertexShaderCode(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Vertex, source_code.GetBuffer());
@@ -425,6 +559,8 @@ std::unique_ptr<AbstractShader> ShaderCache::CompileVertexShader(const VertexSha
 std::unique_ptr<AbstractShader>
 ShaderCache::CompileVertexUberShader(const UberShader::VertexShaderUid& uid) const
 {
+  TRACE_SCOPE("ShaderCache::CompileVertexUberShader");
+
   const ShaderCode source_code =
       UberShader::GenVertexShader(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Vertex, source_code.GetBuffer());
@@ -432,6 +568,8 @@ ShaderCache::CompileVertexUberShader(const UberShader::VertexShaderUid& uid) con
 
 std::unique_ptr<AbstractShader> ShaderCache::CompilePixelShader(const PixelShaderUid& uid) const
 {
+  TRACE_SCOPE("ShaderCache::CompilePixelShader");
+
   const ShaderCode source_code =
       GeneratePixelShaderCode(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Pixel, source_code.GetBuffer());
@@ -440,6 +578,8 @@ std::unique_ptr<AbstractShader> ShaderCache::CompilePixelShader(const PixelShade
 std::unique_ptr<AbstractShader>
 ShaderCache::CompilePixelUberShader(const UberShader::PixelShaderUid& uid) const
 {
+  TRACE_SCOPE("ShaderCache::CompilePixelUberShader");
+
   const ShaderCode source_code =
       UberShader::GenPixelShader(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Pixel, source_code.GetBuffer());
@@ -676,11 +816,14 @@ const AbstractPipeline* ShaderCache::InsertGXPipeline(const GXPipelineUid& confi
 {
   auto& entry = m_gx_pipeline_cache[config];
   entry.second = false;
+  m_gx_pipeline_work_items.erase(config);
+  const bool was_evicted = m_evicted_gx_pipelines.erase(config) != 0;
   if (!entry.first && pipeline)
   {
     entry.first = std::move(pipeline);
 
-    if (g_ActiveConfig.bShaderCache)
+    // Evicted pipelines are already in the disk cache.
+    if (g_ActiveConfig.bShaderCache && !was_evicted)
     {
       auto cache_data = entry.first->GetCacheData();
       if (!cache_data.empty())
@@ -724,10 +867,10 @@ ShaderCache::InsertGXUberPipeline(const GXUberPipelineUid& config,
 
 void ShaderCache::LoadPipelineUIDCache()
 {
-  constexpr u32 CACHE_FILE_MAGIC = 0x44495550;  // PUID
+  constexpr u32 CACHE_FILE_MAGIC = PipelineUIDBundle::UID_CACHE_MAGIC;
   constexpr size_t CACHE_HEADER_SIZE = sizeof(u32) + sizeof(u32);
-  std::string filename =
-      File::GetUserPath(D_CACHE_IDX) + SConfig::GetInstance().GetGameID() + ".uidcache";
+  const std::string& game_id = SConfig::GetInstance().GetGameID();
+  std::string filename = PipelineUIDBundle::GetUIDCachePath(game_id);
   if (m_gx_pipeline_uid_cache_file.Open(filename, "rb+"))
   {
     // If an existing case exists, validate the version before reading entries.
@@ -793,6 +936,27 @@ void ShaderCache::LoadPipelineUIDCache()
   }
 
   INFO_LOG_FMT(VIDEO, "Read {} pipeline UIDs from {}", m_gx_pipeline_cache.size(), filename);
+
+  // Merge in the UIDs of a shared bundle, so that they are compiled before they are encountered.
+  // They are also added to the local cache, keeping them around if the bundle is removed.
+  const std::string bundle_path = PipelineUIDBundle::GetLoadPath(game_id);
+  if (auto bundle_uids = PipelineUIDBundle::Read(bundle_path, game_id))
+  {
+    size_t num_added = 0;
+    for (const SerializedGXPipelineUid& serialized_uid : *bundle_uids)
+    {
+      if (!AddSerializedGXPipelineUID(serialized_uid))
+        continue;
+
+      GXPipelineUid uid;
+      UnserializePipelineUid(serialized_uid, uid);
+      AppendGXPipelineUID(uid);
+      num_added++;
+    }
+
+    INFO_LOG_FMT(VIDEO, "Added {} of {} pipeline UIDs from {}", num_added, bundle_uids->size(),
+                 bundle_path);
+  }
 }
 
 void ShaderCache::ClosePipelineUIDCache()
@@ -801,18 +965,19 @@ void ShaderCache::ClosePipelineUIDCache()
   m_gx_pipeline_uid_cache_file.Close();
 }
 
-void ShaderCache::AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid)
+bool ShaderCache::AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid)
 {
   GXPipelineUid real_uid;
   UnserializePipelineUid(uid, real_uid);
 
   auto iter = m_gx_pipeline_cache.find(real_uid);
   if (iter != m_gx_pipeline_cache.end())
-    return;
+    return false;
 
   // Flag it as empty with a null pipeline object, for later compilation.
   auto& entry = m_gx_pipeline_cache[real_uid];
   entry.second = false;
+  return true;
 }
 
 void ShaderCache::AppendGXPipelineUID(const GXPipelineUid& config)
@@ -853,9 +1018,10 @@ void ShaderCache::QueueVertexShaderCompile(const VertexShaderUid& uid, u32 prior
     VertexShaderUid uid;
   };
 
-  m_vs_cache.shader_map[uid].pending = true;
+  auto& entry = m_vs_cache.shader_map[uid];
+  entry.pending = true;
   auto wi = m_async_shader_compiler->CreateWorkItem<VertexShaderWorkItem>(this, uid);
-  m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+  entry.work_item = m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
 }
 
 void ShaderCache::QueueVertexUberShaderCompile(const UberShader::VertexShaderUid& uid, u32 priority)
@@ -882,9 +1048,10 @@ void ShaderCache::QueueVertexUberShaderCompile(const UberShader::VertexShaderUid
     UberShader::VertexShaderUid uid;
   };
 
-  m_uber_vs_cache.shader_map[uid].pending = true;
+  auto& entry = m_uber_vs_cache.shader_map[uid];
+  entry.pending = true;
   auto wi = m_async_shader_compiler->CreateWorkItem<VertexUberShaderWorkItem>(this, uid);
-  m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+  entry.work_item = m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
 }
 
 void ShaderCache::QueuePixelShaderCompile(const PixelShaderUid& uid, u32 priority)
@@ -911,9 +1078,10 @@ void ShaderCache::QueuePixelShaderCompile(const PixelShaderUid& uid, u32 priorit
     PixelShaderUid uid;
   };
 
-  m_ps_cache.shader_map[uid].pending = true;
+  auto& entry = m_ps_cache.shader_map[uid];
+  entry.pending = true;
   auto wi = m_async_shader_compiler->CreateWorkItem<PixelShaderWorkItem>(this, uid);
-  m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+  entry.work_item = m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
 }
 
 void ShaderCache::QueuePixelUberShaderCompile(const UberShader::PixelShaderUid& uid, u32 priority)
@@ -940,9 +1108,10 @@ void ShaderCache::QueuePixelUberShaderCompile(const UberShader::PixelShaderUid&
     UberShader::PixelShaderUid uid;
   };
 
-  m_uber_ps_cache.shader_map[uid].pending = true;
+  auto& entry = m_uber_ps_cache.shader_map[uid];
+  entry.pending = true;
   auto wi = m_async_shader_compiler->CreateWorkItem<PixelUberShaderWorkItem>(this, uid);
-  m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+  entry.work_item = m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
 }
 
 void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
@@ -994,10 +1163,9 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
       }
       else
       {
-        // Re-queue for next frame.
-        auto wi = shader_cache->m_async_shader_compiler->CreateWorkItem<PipelineWorkItem>(
-            shader_cache, uid, priority);
-        shader_cache->m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+        // Re-queue for next frame, keeping the priority it may have been bumped to since.
+        shader_cache->QueuePipelineCompile(uid,
+                                           shader_cache->m_gx_pipeline_work_items[uid].priority);
       }
     }
 
@@ -1011,8 +1179,34 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
   };
 
   auto wi = m_async_shader_compiler->CreateWorkItem<PipelineWorkItem>(this, uid, priority);
-  m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+  const AsyncShaderCompiler::WorkItemID work_item =
+      m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
   m_gx_pipeline_cache[uid].second = true;
+  m_gx_pipeline_work_items[uid] = {work_item, priority};
+}
+
+void ShaderCache::BumpPipelinePriority(const GXPipelineUid& uid, u32 priority)
+{
+  auto iter = m_gx_pipeline_work_items.find(uid);
+  if (iter == m_gx_pipeline_work_items.end() || iter->second.priority <= priority)
+    return;
+
+  iter->second.priority = priority;
+  m_async_shader_compiler->BumpWorkItemPriority(iter->second.work_item, priority);
+
+  // The pipeline can't be created before its stages, so they have to be moved forward as well.
+  BumpShaderPriority(m_vs_cache, uid.vs_uid, priority);
+  PixelShaderUid ps_uid = uid.ps_uid;
+  ClearUnusedPixelShaderUidBits(m_api_type, m_host_config, &ps_uid);
+  BumpShaderPriority(m_ps_cache, ps_uid, priority);
+}
+
+template <typename T, typename Uid>
+void ShaderCache::BumpShaderPriority(T& cache, const Uid& uid, u32 priority)
+{
+  auto iter = cache.shader_map.find(uid);
+  if (iter != cache.shader_map.end() && iter->second.pending)
+    m_async_shader_compiler->BumpWorkItemPriority(iter->second.work_item, priority);
 }
 
 void ShaderCache::QueueUberPipelineCompile(const GXUberPipelineUid& uid, u32 priority)
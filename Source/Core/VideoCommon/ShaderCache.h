@@ -10,6 +10,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -62,6 +63,9 @@ public:
   // Retrieves all pending shaders/pipelines from the async compiler.
   void RetrieveAsyncShaders();
 
+  // Ages the pipeline use counts, and evicts cold specialized pipelines when over the limit.
+  void OnEndFrame();
+
   // Accesses ShaderGen shader caches
   const AbstractPipeline* GetPipelineForUid(const GXPipelineUid& uid);
   const AbstractPipeline* GetUberPipelineForUid(const GXUberPipelineUid& uid);
@@ -69,6 +73,7 @@ public:
   // Accesses ShaderGen shader caches asynchronously.
   // The optional will be empty if this pipeline is now background compiling.
   std::optional<const AbstractPipeline*> GetPipelineForUidAsync(const GXPipelineUid& uid);
+  std::optional<const AbstractPipeline*> GetUberPipelineForUidAsync(const GXUberPipelineUid& uid);
 
   // Shared shaders
   const AbstractShader* GetScreenQuadVertexShader() const
@@ -158,7 +163,8 @@ private:
                                            std::unique_ptr<AbstractPipeline> pipeline);
   const AbstractPipeline* InsertGXUberPipeline(const GXUberPipelineUid& config,
                                                std::unique_ptr<AbstractPipeline> pipeline);
-  void AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid);
+  // Returns false if the UID was already known.
+  bool AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid);
   void AppendGXPipelineUID(const GXPipelineUid& config);
 
   // ASync Compiler Methods
@@ -167,6 +173,11 @@ private:
   void QueuePixelShaderCompile(const PixelShaderUid& uid, u32 priority);
   void QueuePixelUberShaderCompile(const UberShader::PixelShaderUid& uid, u32 priority);
   void QueuePipelineCompile(const GXPipelineUid& uid, u32 priority);
+  void BumpPipelinePriority(const GXPipelineUid& uid, u32 priority);
+  bool IsHotPipeline(const GXPipelineUid& uid);
+  void EvictColdPipelines(size_t max_pipelines);
+  template <typename T, typename Uid>
+  void BumpShaderPriority(T& cache, const Uid& uid, u32 priority);
   void QueueUberPipelineCompile(const GXUberPipelineUid& uid, u32 priority);
 
   // Populating various caches.
@@ -213,6 +224,7 @@ private:
     {
       std::unique_ptr<AbstractShader> shader;
       bool pending;
+      AsyncShaderCompiler::WorkItemID work_item;
     };
     std::map<Uid, Shader> shader_map;
     LinearDiskCache<Uid, u8> disk_cache;
@@ -227,6 +239,22 @@ private:
   std::map<GXPipelineUid, std::pair<std::unique_ptr<AbstractPipeline>, bool>> m_gx_pipeline_cache;
   std::map<GXUberPipelineUid, std::pair<std::unique_ptr<AbstractPipeline>, bool>>
       m_gx_uber_pipeline_cache;
+
+  // Queued compiles of pending GX pipelines, so they can be moved forward when requested again.
+  struct PendingPipeline
+  {
+    AsyncShaderCompiler::WorkItemID work_item;
+    u32 priority;
+  };
+  std::map<GXPipelineUid, PendingPipeline> m_gx_pipeline_work_items;
+
+  // With hybrid ubershaders, how often pipelines without specialized shaders have been used
+  // recently, and in which frame the specialized pipelines were last used. Evicted pipelines
+  // keep their (null) entry in m_gx_pipeline_cache, and are compiled again when used.
+  std::map<GXPipelineUid, u32> m_gx_pipeline_use_counts;
+  std::map<GXPipelineUid, u32> m_gx_pipeline_last_use;
+  std::set<GXPipelineUid> m_evicted_gx_pipelines;
+  u32 m_frame_count = 0;
   File::IOFile m_gx_pipeline_uid_cache_file;
   LinearDiskCache<SerializedGXPipelineUid, u8> m_gx_pipeline_disk_cache;
   LinearDiskCache<SerializedGXUberPipelineUid, u8> m_gx_uber_pipeline_disk_cache;
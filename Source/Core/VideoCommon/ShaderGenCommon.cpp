@@ -4,6 +4,10 @@
 
 #include "VideoCommon/ShaderGenCommon.h"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <fmt/format.h>
 
 #include "Common/FileUtil.h"
@@ -11,6 +15,48 @@
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
 
+namespace
+{
+constexpr size_t SHADER_CODE_INITIAL_SIZE = 16384;
+constexpr size_t SHADER_CODE_MAX_POOLED_SIZE = 1024 * 1024;
+constexpr size_t SHADER_CODE_MAX_POOLED_BUFFERS = 4;
+
+std::vector<std::string>& GetShaderCodeBufferPool()
+{
+  thread_local std::vector<std::string> pool;
+  return pool;
+}
+}  // namespace
+
+ShaderCode::ShaderCode()
+{
+  auto& pool = GetShaderCodeBufferPool();
+  if (!pool.empty())
+  {
+    m_buffer = std::move(pool.back());
+    pool.pop_back();
+  }
+  else
+  {
+    m_buffer.reserve(SHADER_CODE_INITIAL_SIZE);
+  }
+}
+
+ShaderCode::~ShaderCode()
+{
+  // Moved-from and oversized buffers aren't worth keeping.
+  const size_t capacity = m_buffer.capacity();
+  if (capacity < SHADER_CODE_INITIAL_SIZE || capacity > SHADER_CODE_MAX_POOLED_SIZE)
+    return;
+
+  auto& pool = GetShaderCodeBufferPool();
+  if (pool.size() >= SHADER_CODE_MAX_POOLED_BUFFERS)
+    return;
+
+  m_buffer.clear();
+  pool.push_back(std::move(m_buffer));
+}
+
 ShaderHostConfig ShaderHostConfig::GetCurrent()
 {
   ShaderHostConfig bits = {};
@@ -100,7 +100,15 @@ private:
 class ShaderCode : public ShaderGeneratorInterface
 {
 public:
-  ShaderCode() { m_buffer.reserve(16384); }
+  // Buffers are recycled through a small per-thread pool, since generating a shader otherwise
+  // starts by allocating (and growing) a fresh buffer every time.
+  ShaderCode();
+  ~ShaderCode();
+  ShaderCode(const ShaderCode&) = default;
+  ShaderCode(ShaderCode&&) = default;
+  ShaderCode& operator=(const ShaderCode&) = default;
+  ShaderCode& operator=(ShaderCode&&) = default;
+
   const std::string& GetBuffer() const { return m_buffer; }
 
   // Writes format strings using fmtlib format strings.
@@ -110,6 +118,9 @@ public:
     fmt::format_to(std::back_inserter(m_buffer), format, std::forward<Args>(args)...);
   }
 
+  // Appends previously generated code as-is.
+  void WriteRaw(std::string_view code) { m_buffer.append(code); }
+
 protected:
   std::string m_buffer;
 };
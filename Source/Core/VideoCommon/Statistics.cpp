@@ -64,6 +64,10 @@ void Statistics::Display() const
   draw_statistic("Textures created", "%d", num_textures_created);
   draw_statistic("Textures uploaded", "%d", num_textures_uploaded);
   draw_statistic("Textures alive", "%d", num_textures_alive);
+  draw_statistic("Textures pooled", "%d", num_textures_pooled);
+  draw_statistic("Texture pool hits", "%d", num_texture_pool_hits);
+  draw_statistic("Textures evicted", "%d", num_textures_evicted);
+  draw_statistic("Texture memory (MiB)", "%d", texture_memory_mib);
   draw_statistic("pshaders created", "%d", num_pixel_shaders_created);
   draw_statistic("pshaders alive", "%d", num_pixel_shaders_alive);
   draw_statistic("vshaders created", "%d", num_vertex_shaders_created);
@@ -72,6 +76,17 @@ void Statistics::Display() const
   draw_statistic("dlists called", "%d", this_frame.num_dlists_called);
   draw_statistic("Primitive joins", "%d", this_frame.num_primitive_joins);
   draw_statistic("Draw calls", "%d", this_frame.num_draw_calls);
+  draw_statistic("Ubershader draw calls", "%d (%d%%)", this_frame.num_uber_draw_calls,
+                 this_frame.num_draw_calls ?
+                     this_frame.num_uber_draw_calls * 100 / this_frame.num_draw_calls :
+                     0);
+  draw_statistic("Pipelines evicted", "%d", num_pipelines_evicted);
+  if (g_ActiveConfig.backend_info.api_type == APIType::Vulkan)
+  {
+    draw_statistic("Device memory blocks", "%d", num_device_memory_blocks);
+    draw_statistic("Device memory (MiB)", "%d used / %d allocated", device_memory_used_mib,
+                   device_memory_allocated_mib);
+  }
   draw_statistic("Primitives", "%d", this_frame.num_prims);
   draw_statistic("Primitives (DL)", "%d", this_frame.num_dl_prims);
   draw_statistic("XF loads", "%d", this_frame.num_xf_loads);
@@ -83,6 +98,7 @@ void Statistics::Display() const
   draw_statistic("Vertex streamed", "%i kB", this_frame.bytes_vertex_streamed / 1024);
   draw_statistic("Index streamed", "%i kB", this_frame.bytes_index_streamed / 1024);
   draw_statistic("Uniform streamed", "%i kB", this_frame.bytes_uniform_streamed / 1024);
+  draw_statistic("Textures decoded", "%i kB", this_frame.bytes_textures_decoded / 1024);
   draw_statistic("Vertex Loaders", "%d", num_vertex_loaders);
   draw_statistic("EFB peeks:", "%d", this_frame.num_efb_peeks);
   draw_statistic("EFB pokes:", "%d", this_frame.num_efb_pokes);
@@ -16,9 +16,19 @@ struct Statistics
   int num_textures_created;
   int num_textures_uploaded;
   int num_textures_alive;
+  int num_textures_pooled;
+  int num_texture_pool_hits;
+  int num_textures_evicted;
+  int texture_memory_mib;
 
   int num_vertex_loaders;
 
+  int num_pipelines_evicted;
+
+  int num_device_memory_blocks;
+  int device_memory_allocated_mib;
+  int device_memory_used_mib;
+
   std::array<float, 6> proj;
   std::array<float, 16> gproj;
   std::array<float, 16> g2proj;
@@ -39,12 +49,14 @@ struct Statistics
 
     int num_primitive_joins;
     int num_draw_calls;
+    int num_uber_draw_calls;
 
     int num_dlists_called;
 
     int bytes_vertex_streamed;
     int bytes_index_streamed;
     int bytes_uniform_streamed;
+    int bytes_textures_decoded;
 
     int num_triangles_clipped;
     int num_triangles_in;
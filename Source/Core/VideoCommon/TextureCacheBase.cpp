@@ -5,8 +5,10 @@
 #include "VideoCommon/TextureCacheBase.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstring>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -23,9 +25,12 @@
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
 #include "Common/Hash.h"
+#include "Common/Image.h"
 #include "Common/Logging/Log.h"
 #include "Common/MathUtil.h"
 #include "Common/MemoryUtil.h"
+#include "Common/ThreadPool.h"
+#include "Common/Tracing.h"
 
 #include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
@@ -36,6 +41,7 @@
 #include "VideoCommon/AbstractFramebuffer.h"
 #include "VideoCommon/AbstractStagingTexture.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/FramebufferManager.h"
 #include "VideoCommon/HiresTextures.h"
 #include "VideoCommon/OpcodeDecoding.h"
@@ -104,6 +110,10 @@ TextureCacheBase::~TextureCacheBase()
   // Clear pending EFB copies first, so we don't try to flush them.
   m_pending_efb_copies.clear();
 
+  FlushTextureDumps(true);
+  for (auto& task : m_texture_dump_tasks)
+    task.wait();
+
   HiresTexture::Shutdown();
   Invalidate();
   Common::FreeAlignedMemory(temp);
@@ -118,6 +128,7 @@ bool TextureCacheBase::Initialize()
     return false;
   }
 
+  m_decode_queue.SetNumWorkerThreads(g_ActiveConfig.GetTextureDecodingThreads());
   return true;
 }
 
@@ -133,8 +144,11 @@ void TextureCacheBase::Invalidate()
   }
   textures_by_address.clear();
   textures_by_hash.clear();
+  textures_by_size_class.fill(0);
+  tracked_hashes.clear();
 
   texture_pool.clear();
+  m_texture_memory_usage = 0;
 }
 
 void TextureCacheBase::ForceReload()
@@ -151,7 +165,8 @@ void TextureCacheBase::ForceReload()
 void TextureCacheBase::OnConfigChanged(const VideoConfig& config)
 {
   if (config.bHiresTextures != backup_config.hires_textures ||
-      config.bCacheHiresTextures != backup_config.cache_hires_textures)
+      config.bCacheHiresTextures != backup_config.cache_hires_textures ||
+      config.iHiresTextureCacheSize != backup_config.hires_texture_cache_size)
   {
     HiresTexture::Update();
   }
@@ -169,11 +184,15 @@ void TextureCacheBase::OnConfigChanged(const VideoConfig& config)
     TexDecoder_SetTexFmtOverlayOptions(config.bTexFmtOverlayEnable, config.bTexFmtOverlayCenter);
   }
 
+  m_decode_queue.SetNumWorkerThreads(config.GetTextureDecodingThreads());
   SetBackupConfig(config);
 }
 
 void TextureCacheBase::Cleanup(int _frameCount)
 {
+  FlushTextureDumps(false);
+  m_texture_dump_frame++;
+
   TexAddrCache::iterator iter = textures_by_address.begin();
   TexAddrCache::iterator tcend = textures_by_address.end();
   while (iter != tcend)
@@ -233,6 +252,85 @@ void TextureCacheBase::Cleanup(int _frameCount)
       ++iter2;
     }
   }
+
+  m_texture_memory_usage = 0;
+  for (const auto& it : textures_by_address)
+    m_texture_memory_usage += it.second->texture->GetConfig().GetMemorySize();
+  for (const auto& it : texture_pool)
+    m_texture_memory_usage += it.first.GetMemorySize();
+
+  const size_t budget = GetTextureMemoryBudget();
+  if (budget != 0 && m_texture_memory_usage > budget)
+    EvictTextures(budget, _frameCount);
+
+  SETSTAT(g_stats.num_textures_alive, static_cast<int>(textures_by_address.size()));
+  SETSTAT(g_stats.num_textures_pooled, static_cast<int>(texture_pool.size()));
+  SETSTAT(g_stats.texture_memory_mib, static_cast<int>(m_texture_memory_usage >> 20));
+}
+
+size_t TextureCacheBase::GetTextureMemoryBudget()
+{
+  return static_cast<size_t>(std::max(g_ActiveConfig.iTextureMemoryBudget, 0)) * 1024 * 1024;
+}
+
+void TextureCacheBase::FreePooledTextures(size_t budget)
+{
+  if (m_texture_memory_usage <= budget || texture_pool.empty())
+    return;
+
+  // Textures returned to the pool in the current frame don't have a frame count yet, and are
+  // the most recently used ones.
+  const auto last_used = [](const TexPool::iterator& iter) {
+    const int frame_count = iter->second.frameCount;
+    return frame_count == FRAMECOUNT_INVALID ? std::numeric_limits<int>::max() : frame_count;
+  };
+
+  std::vector<TexPool::iterator> pooled;
+  pooled.reserve(texture_pool.size());
+  for (auto iter = texture_pool.begin(); iter != texture_pool.end(); ++iter)
+    pooled.push_back(iter);
+  std::sort(pooled.begin(), pooled.end(),
+            [&](const auto& a, const auto& b) { return last_used(a) < last_used(b); });
+
+  for (const TexPool::iterator& iter : pooled)
+  {
+    if (m_texture_memory_usage <= budget)
+      break;
+
+    m_texture_memory_usage -= std::min(m_texture_memory_usage, iter->first.GetMemorySize());
+    texture_pool.erase(iter);
+    INCSTAT(g_stats.num_textures_evicted);
+  }
+}
+
+void TextureCacheBase::EvictTextures(size_t budget, int frame_count)
+{
+  FreePooledTextures(budget);
+  if (m_texture_memory_usage <= budget)
+    return;
+
+  std::vector<TCacheEntry*> unused;
+  for (const auto& it : textures_by_address)
+  {
+    TCacheEntry* entry = it.second;
+    if (!entry->IsCopy() && !entry->tmem_only && entry->frameCount < frame_count)
+      unused.push_back(entry);
+  }
+  std::sort(unused.begin(), unused.end(), [](const TCacheEntry* a, const TCacheEntry* b) {
+    return a->frameCount < b->frameCount;
+  });
+
+  // The pool is empty at this point, and invalidated textures are returned to it.
+  size_t freed = 0;
+  for (TCacheEntry* entry : unused)
+  {
+    if (m_texture_memory_usage - std::min(m_texture_memory_usage, freed) <= budget)
+      break;
+
+    freed += entry->texture->GetConfig().GetMemorySize();
+    InvalidateTexture(GetTexCacheIter(entry));
+  }
+  FreePooledTextures(budget);
 }
 
 bool TextureCacheBase::TCacheEntry::OverlapsMemoryRange(u32 range_address, u32 range_size) const
@@ -253,6 +351,7 @@ void TextureCacheBase::SetBackupConfig(const VideoConfig& config)
   backup_config.texfmt_overlay_center = config.bTexFmtOverlayCenter;
   backup_config.hires_textures = config.bHiresTextures;
   backup_config.cache_hires_textures = config.bCacheHiresTextures;
+  backup_config.hires_texture_cache_size = config.iHiresTextureCacheSize;
   backup_config.stereo_3d = config.stereo_mode != StereoMode::Off;
   backup_config.efb_mono_depth = config.bStereoEFBMonoDepth;
   backup_config.gpu_texture_decoding = config.bEnableGPUTextureDecoding;
@@ -325,7 +424,7 @@ TextureCacheBase::ApplyPaletteToEntry(TCacheEntry* entry, u8* palette, TLUTForma
     g_renderer->EndUtilityDrawing();
   }
 
-  textures_by_address.emplace(decoded_entry->addr, decoded_entry);
+  AddToAddressCache(decoded_entry);
 
   return decoded_entry;
 }
@@ -372,7 +471,7 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::ReinterpretEntry(const TCacheEn
   g_renderer->EndUtilityDrawing();
   reinterpreted_entry->texture->FinishedRendering();
 
-  textures_by_address.emplace(reinterpreted_entry->addr, reinterpreted_entry);
+  AddToAddressCache(reinterpreted_entry);
 
   return reinterpreted_entry;
 }
@@ -439,7 +538,28 @@ void TextureCacheBase::SerializeTexture(AbstractTexture* tex, const TextureConfi
   p.DoPOD(config);
 
   std::vector<u8> texture_data;
-  if (skip_readback || CheckReadbackTexture(config.width, config.height, config.format))
+  auto queued = m_queued_readbacks.find(tex);
+  if (queued != m_queued_readbacks.end() && queued->second.config == config)
+  {
+    // The first read waits for the GPU, which has done the others by then as well.
+    size_t index = 0;
+    for (u32 layer = 0; layer < config.layers; layer++)
+    {
+      for (u32 level = 0; level < config.levels; level++)
+      {
+        AbstractStagingTexture* staging = queued->second.levels[index++].get();
+        const u32 level_width = std::max(config.width >> level, 1u);
+        const u32 level_height = std::max(config.height >> level, 1u);
+        const size_t stride = AbstractTexture::CalculateStrideForFormat(config.format, level_width);
+        const size_t start = texture_data.size();
+        texture_data.resize(start + stride * level_height);
+        if (!skip_readback)
+          staging->ReadTexels(staging->GetRect(), &texture_data[start], static_cast<u32>(stride));
+      }
+    }
+    m_queued_readbacks.erase(queued);
+  }
+  else if (skip_readback || CheckReadbackTexture(config.width, config.height, config.format))
   {
     // Save out each layer of the texture to the staging texture, and then
     // append it onto the end of the vector. This gives us all the sub-images
@@ -471,6 +591,50 @@ void TextureCacheBase::SerializeTexture(AbstractTexture* tex, const TextureConfi
   p.Do(texture_data);
 }
 
+void TextureCacheBase::QueueTextureReadback(const AbstractTexture* tex, const TextureConfig& config)
+{
+  QueuedReadback readback{config, {}};
+  for (u32 layer = 0; layer < config.layers; layer++)
+  {
+    for (u32 level = 0; level < config.levels; level++)
+    {
+      const TextureConfig staging_config(std::max(config.width >> level, 1u),
+                                         std::max(config.height >> level, 1u), 1, 1, 1,
+                                         config.format, 0);
+      auto staging =
+          g_renderer->CreateStagingTexture(StagingTextureType::Readback, staging_config);
+
+      // SerializeTexture reads the texture back itself if this fails.
+      if (!staging)
+        return;
+
+      const auto rect = tex->GetConfig().GetMipRect(level);
+      staging->CopyFromTexture(tex, rect, layer, level, rect);
+      readback.levels.push_back(std::move(staging));
+    }
+  }
+  m_queued_readbacks.insert_or_assign(tex, std::move(readback));
+}
+
+void TextureCacheBase::QueueSaveStateReadbacks()
+{
+  FlushEFBCopies();
+  if (!Config::Get(Config::GFX_SAVE_TEXTURE_CACHE_TO_STATE))
+    return;
+
+  // Entries which are in both maps are only queued once.
+  for (const auto& it : textures_by_address)
+  {
+    if (ShouldSaveEntry(it.second))
+      QueueTextureReadback(it.second->texture.get(), it.second->texture->GetConfig());
+  }
+  for (const auto& it : textures_by_hash)
+  {
+    if (ShouldSaveEntry(it.second) && !m_queued_readbacks.count(it.second->texture.get()))
+      QueueTextureReadback(it.second->texture.get(), it.second->texture->GetConfig());
+  }
+}
+
 std::optional<TextureCacheBase::TexPoolEntry> TextureCacheBase::DeserializeTexture(PointerWrap& p)
 {
   TextureConfig config;
@@ -525,15 +689,17 @@ void TextureCacheBase::DoState(PointerWrap& p)
     DoLoadState(p);
 }
 
+bool TextureCacheBase::ShouldSaveEntry(const TCacheEntry* entry)
+{
+  // We skip non-copies as they can be decoded from RAM when the state is loaded.
+  // Storing them would duplicate data in the save state file, adding to decompression time.
+  return entry->IsCopy();
+}
+
 void TextureCacheBase::DoSaveState(PointerWrap& p)
 {
   std::map<const TCacheEntry*, u32> entry_map;
   std::vector<TCacheEntry*> entries_to_save;
-  auto ShouldSaveEntry = [](const TCacheEntry* entry) {
-    // We skip non-copies as they can be decoded from RAM when the state is loaded.
-    // Storing them would duplicate data in the save state file, adding to decompression time.
-    return entry->IsCopy();
-  };
   auto AddCacheEntryToMap = [&entry_map, &entries_to_save](TCacheEntry* entry) -> u32 {
     auto iter = entry_map.find(entry);
     if (iter != entry_map.end())
@@ -634,8 +800,10 @@ void TextureCacheBase::DoSaveState(PointerWrap& p)
   }
 
   // Free the readback texture to potentially save host-mapped GPU memory, depending on where
-  // the driver mapped the staging buffer.
+  // the driver mapped the staging buffer. The same goes for queued readbacks which weren't used,
+  // e.g. because the output buffer turned out to be too small.
   m_readback_texture.reset();
+  m_queued_readbacks.clear();
 }
 
 void TextureCacheBase::DoLoadState(PointerWrap& p)
@@ -663,7 +831,6 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
     // to update the point in the state state. We'll just throw it away if it's invalid.
     auto tex = DeserializeTexture(p);
     TCacheEntry* entry = new TCacheEntry(std::move(tex->texture), std::move(tex->framebuffer));
-    entry->textures_by_hash_iter = textures_by_hash.end();
     entry->DoState(p);
     if (entry->texture && commit_state)
       id_map.emplace(i, entry);
@@ -696,7 +863,7 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
 
     TCacheEntry* entry = GetEntry(id);
     if (entry)
-      textures_by_address.emplace(addr, entry);
+      AddToAddressCache(entry);
   }
 
   // Fill in hash map.
@@ -710,7 +877,7 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
 
     TCacheEntry* entry = GetEntry(id);
     if (entry)
-      entry->textures_by_hash_iter = textures_by_hash.emplace(hash, entry);
+      AddToHashCache(entry, hash);
   }
 }
 
@@ -941,11 +1108,80 @@ void TextureCacheBase::DumpTexture(TCacheEntry* entry, std::string basename, uns
       return;
   }
 
-  const std::string filename = fmt::format("{}/{}.png", szDir, basename);
-  if (File::Exists(filename))
+  std::string filename = fmt::format("{}/{}.png", szDir, basename);
+  if (!m_dumped_texture_names.insert(filename).second || File::Exists(filename))
+    return;
+
+  QueueTextureDump(entry->texture.get(), level, std::move(filename));
+}
+
+void TextureCacheBase::QueueTextureDump(const AbstractTexture* texture, u32 level,
+                                        std::string filename)
+{
+  // See AbstractTexture::Save.
+  ASSERT(!AbstractTexture::IsCompressedFormat(texture->GetFormat()));
+
+  const TextureConfig readback_config(std::max(1u, texture->GetWidth() >> level),
+                                      std::max(1u, texture->GetHeight() >> level), 1, 1, 1,
+                                      AbstractTextureFormat::RGBA8, 0);
+  auto readback = g_renderer->CreateStagingTexture(StagingTextureType::Readback, readback_config);
+  if (!readback)
     return;
 
-  entry->texture->Save(filename, level);
+  readback->CopyFromTexture(texture, 0, level);
+  m_pending_texture_dumps.push_back(
+      {std::move(readback), std::move(filename), m_texture_dump_frame});
+
+  // A game may load a lot of textures at once, don't hold on to too many staging textures.
+  constexpr size_t MAX_PENDING_TEXTURE_DUMPS = 256;
+  if (m_pending_texture_dumps.size() > MAX_PENDING_TEXTURE_DUMPS)
+    FlushTextureDumps(true);
+}
+
+void TextureCacheBase::FlushTextureDumps(bool flush_all)
+{
+  // Each encode holds a copy of the pixels, so only so many may be outstanding.
+  constexpr size_t MAX_TEXTURE_DUMP_TASKS = 32;
+
+  while (!m_pending_texture_dumps.empty() &&
+         (flush_all || m_pending_texture_dumps.front().frame < m_texture_dump_frame))
+  {
+    PendingTextureDump dump = std::move(m_pending_texture_dumps.front());
+    m_pending_texture_dumps.pop_front();
+
+    dump.readback->Flush();
+    if (!dump.readback->Map())
+      continue;
+
+    // The staging texture has to be unmapped on this thread, so the encoder gets its own copy.
+    const u32 width = dump.readback->GetConfig().width;
+    const u32 height = dump.readback->GetConfig().height;
+    const size_t row_size = static_cast<size_t>(width) * 4;
+    std::vector<u8> pixels(row_size * height);
+    for (u32 y = 0; y < height; y++)
+    {
+      std::memcpy(&pixels[y * row_size],
+                  dump.readback->GetMappedPointer() + y * dump.readback->GetMappedStride(),
+                  row_size);
+    }
+    dump.readback->Unmap();
+
+    while (!m_texture_dump_tasks.empty() &&
+           (m_texture_dump_tasks.size() >= MAX_TEXTURE_DUMP_TASKS ||
+            m_texture_dump_tasks.front().wait_for(std::chrono::seconds(0)) ==
+                std::future_status::ready))
+    {
+      m_texture_dump_tasks.front().wait();
+      m_texture_dump_tasks.pop_front();
+    }
+
+    m_texture_dump_tasks.push_back(Common::ThreadPool::GetShared().Async(
+        Common::TaskPriority::Background,
+        [filename = std::move(dump.filename), pixels = std::move(pixels), width, height] {
+          Common::SavePNG(filename, pixels.data(), Common::ImageByteFormat::RGBA, width, height,
+                          static_cast<int>(width * 4));
+        }));
+  }
 }
 
 static u32 CalculateLevelSize(u32 level_0_size, u32 level)
@@ -1176,6 +1412,9 @@ private:
 
 TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
 {
+  const FrameProfiler::ScopedSection profiler_section(FrameProfiler::Section::TextureCache);
+  TRACE_SCOPE("TextureCache::Load");
+
   // if this stage was not invalidated by changes to texture registers, keep the current texture
   if (IsValidBindPoint(stage) && bound_textures[stage])
   {
@@ -1213,6 +1452,30 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
   return entry;
 }
 
+u64 TextureCacheBase::GetTrackedHash(u32 address, u32 size, int sample_size, const u8* src_data)
+{
+  auto iter = tracked_hashes.find(address);
+  if (iter != tracked_hashes.end() && iter->second.size == size &&
+      iter->second.sample_size == sample_size &&
+      Memory::IsUnmodifiedSince(address, size, iter->second.stamp))
+  {
+    return iter->second.hash;
+  }
+
+  // The memory has to be protected before hashing it, so that no write can slip in between.
+  const u64 stamp = Memory::TrackWrites(address, size);
+  const u64 hash = Common::GetHash64(src_data, size, sample_size);
+  if (stamp == 0)
+  {
+    if (iter != tracked_hashes.end())
+      tracked_hashes.erase(iter);
+    return hash;
+  }
+
+  tracked_hashes[address] = {size, sample_size, stamp, hash};
+  return hash;
+}
+
 TextureCacheBase::TCacheEntry*
 TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFormat texformat,
                              const int textureCacheSafetyColorSampleSize, u32 tlutaddr,
@@ -1287,7 +1550,14 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
 
   // TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data
   // from the low tmem bank than it should)
-  base_hash = Common::GetHash64(src_data, texture_size, textureCacheSafetyColorSampleSize);
+  if (g_ActiveConfig.bTrackTextureWrites && !from_tmem)
+  {
+    base_hash = GetTrackedHash(address, texture_size, textureCacheSafetyColorSampleSize, src_data);
+  }
+  else
+  {
+    base_hash = Common::GetHash64(src_data, texture_size, textureCacheSafetyColorSampleSize);
+  }
   u32 palette_size = 0;
   if (isPaletteTexture)
   {
@@ -1431,6 +1701,14 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
           entry->native_levels >= tex_levels && entry->native_width == nativeW &&
           entry->native_height == nativeH)
       {
+        // Replace the native texture once its custom texture has been loaded in the background.
+        if (!entry->pending_custom_tex.empty() &&
+            !HiresTexture::IsPending(entry->pending_custom_tex))
+        {
+          iter = InvalidateTexture(iter);
+          continue;
+        }
+
         entry = DoPartialTextureUpdates(iter->second, &texMem[tlutaddr], tlutfmt);
         entry->texture->FinishedRendering();
         return entry;
@@ -1492,7 +1770,9 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
       TCacheEntry* entry = hash_iter->second;
       // All parameters, except the address, need to match here
       if (entry->format == full_format && entry->native_levels >= tex_levels &&
-          entry->native_width == nativeW && entry->native_height == nativeH)
+          entry->native_width == nativeW && entry->native_height == nativeH &&
+          (entry->pending_custom_tex.empty() ||
+           HiresTexture::IsPending(entry->pending_custom_tex)))
       {
         entry = DoPartialTextureUpdates(hash_iter->second, &texMem[tlutaddr], tlutfmt);
         entry->texture->FinishedRendering();
@@ -1510,10 +1790,11 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
   }
 
   std::shared_ptr<HiresTexture> hires_tex;
+  std::string pending_custom_tex;
   if (g_ActiveConfig.bHiresTextures)
   {
     hires_tex = HiresTexture::Search(src_data, texture_size, &texMem[tlutaddr], palette_size, width,
-                                     height, texformat, use_mipmaps);
+                                     height, texformat, use_mipmaps, &pending_custom_tex);
 
     if (hires_tex)
     {
@@ -1532,12 +1813,7 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
   const u32 texLevels = hires_tex ? (u32)hires_tex->m_levels.size() : tex_levels;
 
   // We can decode on the GPU if it is a supported format and the flag is enabled.
-  // Currently we don't decode RGBA8 textures from Tmem, as that would require copying from both
-  // banks, and if we're doing an copy we may as well just do the whole thing on the CPU, since
-  // there's no conversion between formats. In the future this could be extended with a separate
-  // shader, however.
-  const bool decode_on_gpu = !hires_tex && g_ActiveConfig.UseGPUTextureDecoding() &&
-                             !(from_tmem && texformat == TextureFormat::RGBA8);
+  const bool decode_on_gpu = !hires_tex && g_ActiveConfig.UseGPUTextureDecoding();
 
   // create the entry/texture
   const TextureConfig config(width, height, texLevels, 1, 1,
@@ -1551,17 +1827,40 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
   if (hires_tex)
   {
     const auto& level = hires_tex->m_levels[0];
-    entry->texture->Load(0, level.width, level.height, level.row_length, level.data.data(),
-                         level.data.size());
+    entry->texture->Load(0, level.width, level.height, level.row_length, level.GetData(),
+                         level.GetDataSize());
   }
 
   // Initialized to null because only software loading uses this buffer
   u8* dst_buffer = nullptr;
 
+  // Levels decoded on the CPU are uploaded once the decode queue has finished all of them.
+  struct DecodedLevel
+  {
+    u32 level;
+    u32 width;
+    u32 height;
+    u32 row_length;
+    const u8* data;
+    size_t size;
+  };
+  std::vector<DecodedLevel> decoded_levels;
+
   if (!hires_tex)
   {
+    // RGBA8 textures in Tmem are split across both banks. The GPU decoder handles them like
+    // textures in RAM, so the banks are merged into the layout they have there first.
+    const u8* gpu_src_data = src_data;
+    if (decode_on_gpu && from_tmem && texformat == TextureFormat::RGBA8)
+    {
+      tmem_rgba8_data.resize(texture_size);
+      TexDecoder_MergeRGBA8FromTmem(tmem_rgba8_data.data(), src_data,
+                                    &texMem[tmem_address_odd], expandedWidth, expandedHeight);
+      gpu_src_data = tmem_rgba8_data.data();
+    }
+
     if (!decode_on_gpu ||
-        !DecodeTextureOnGPU(entry, 0, src_data, texture_size, texformat, width, height,
+        !DecodeTextureOnGPU(entry, 0, gpu_src_data, texture_size, texformat, width, height,
                             expandedWidth, expandedHeight, bytes_per_block * (expandedWidth / bsw),
                             tlut, tlutfmt))
     {
@@ -1587,8 +1886,8 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
       dst_buffer = temp;
       if (!(texformat == TextureFormat::RGBA8 && from_tmem))
       {
-        TexDecoder_Decode(dst_buffer, src_data, expandedWidth, expandedHeight, texformat, tlut,
-                          tlutfmt);
+        m_decode_queue.QueueDecode(dst_buffer, src_data, expandedWidth, expandedHeight, texformat,
+                                   tlut, tlutfmt);
       }
       else
       {
@@ -1597,25 +1896,24 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
                                        expandedHeight);
       }
 
-      entry->texture->Load(0, width, height, expandedWidth, dst_buffer, decoded_texture_size);
-
-      arbitrary_mip_detector.AddLevel(width, height, expandedWidth, dst_buffer);
-
+      decoded_levels.push_back(
+          {0, width, height, expandedWidth, dst_buffer, decoded_texture_size});
       dst_buffer += decoded_texture_size;
     }
   }
 
-  iter = textures_by_address.emplace(address, entry);
+  entry->SetGeneralParameters(address, texture_size, full_format, false);
+  iter = AddToAddressCache(entry);
   if (textureCacheSafetyColorSampleSize == 0 ||
       std::max(texture_size, palette_size) <= (u32)textureCacheSafetyColorSampleSize * 8)
   {
-    entry->textures_by_hash_iter = textures_by_hash.emplace(full_hash, entry);
+    AddToHashCache(entry, full_hash);
   }
 
-  entry->SetGeneralParameters(address, texture_size, full_format, false);
   entry->SetDimensions(nativeW, nativeH, tex_levels);
   entry->SetHashes(base_hash, full_hash);
   entry->is_custom_tex = hires_tex != nullptr;
+  entry->pending_custom_tex = std::move(pending_custom_tex);
   entry->memory_stride = entry->BytesPerRow();
   entry->SetNotCopy();
 
@@ -1632,7 +1930,7 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
     {
       const auto& level = hires_tex->m_levels[level_index];
       entry->texture->Load(level_index, level.width, level.height, level.row_length,
-                           level.data.data(), level.data.size());
+                           level.GetData(), level.GetDataSize());
     }
   }
   else
@@ -1666,18 +1964,24 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
       {
         // No need to call CheckTempSize here, as the whole buffer is preallocated at the beginning
         const u32 decoded_mip_size = expanded_mip_width * sizeof(u32) * expanded_mip_height;
-        TexDecoder_Decode(dst_buffer, mip_src_data, expanded_mip_width, expanded_mip_height,
-                          texformat, tlut, tlutfmt);
-        entry->texture->Load(level, mip_width, mip_height, expanded_mip_width, dst_buffer,
-                             decoded_mip_size);
-
-        arbitrary_mip_detector.AddLevel(mip_width, mip_height, expanded_mip_width, dst_buffer);
-
+        m_decode_queue.QueueDecode(dst_buffer, mip_src_data, expanded_mip_width,
+                                   expanded_mip_height, texformat, tlut, tlutfmt);
+        decoded_levels.push_back(
+            {level, mip_width, mip_height, expanded_mip_width, dst_buffer, decoded_mip_size});
         dst_buffer += decoded_mip_size;
       }
 
       mip_src_data += mip_size;
     }
+
+    m_decode_queue.WaitForDecodes();
+    for (const DecodedLevel& level : decoded_levels)
+    {
+      entry->texture->Load(level.level, level.width, level.height, level.row_length, level.data,
+                           level.size);
+      ADDSTAT(g_stats.this_frame.bytes_textures_decoded, static_cast<int>(level.size));
+      arbitrary_mip_detector.AddLevel(level.width, level.height, level.row_length, level.data);
+    }
   }
 
   entry->has_arbitrary_mips = hires_tex ? hires_tex->HasArbitraryMipmaps() :
@@ -1767,7 +2071,7 @@ TextureCacheBase::GetXFBTexture(u32 address, u32 width, u32 height, u32 stride,
   entry->texture->FinishedRendering();
 
   // Insert into the texture cache so we can re-use it next frame, if needed.
-  textures_by_address.emplace(entry->addr, entry);
+  AddToAddressCache(entry);
   SETSTAT(g_stats.num_textures_alive, static_cast<int>(textures_by_address.size()));
   INCSTAT(g_stats.num_textures_uploaded);
 
@@ -1775,8 +2079,9 @@ TextureCacheBase::GetXFBTexture(u32 address, u32 width, u32 height, u32 stride,
   {
     // While this isn't really an xfb copy, we can treat it as such for dumping purposes
     static int xfb_count = 0;
-    entry->texture->Save(
-        fmt::format("{}xfb_loaded_{}.png", File::GetUserPath(D_DUMPTEXTURES_IDX), xfb_count++), 0);
+    QueueTextureDump(
+        entry->texture.get(), 0,
+        fmt::format("{}xfb_loaded_{}.png", File::GetUserPath(D_DUMPTEXTURES_IDX), xfb_count++));
   }
 
   GetDisplayRectForXFBEntry(entry, width, height, display_rect);
@@ -2178,6 +2483,7 @@ void TextureCacheBase::CopyRenderTargetToTexture(
       }
       entry->may_have_overlapping_textures = false;
       entry->is_custom_tex = false;
+      entry->pending_custom_tex.clear();
 
       CopyEFBToCacheEntry(entry, is_depth_copy, srcRect, scaleByHalf, linear_filter, dstFormat,
                           isIntensity, gamma, clamp_top, clamp_bottom,
@@ -2186,17 +2492,17 @@ void TextureCacheBase::CopyRenderTargetToTexture(
       if (g_ActiveConfig.bDumpEFBTarget && !is_xfb_copy)
       {
         static int efb_count = 0;
-        entry->texture->Save(
-            fmt::format("{}efb_frame_{}.png", File::GetUserPath(D_DUMPTEXTURES_IDX), efb_count++),
-            0);
+        QueueTextureDump(
+            entry->texture.get(), 0,
+            fmt::format("{}efb_frame_{}.png", File::GetUserPath(D_DUMPTEXTURES_IDX), efb_count++));
       }
 
       if (g_ActiveConfig.bDumpXFBTarget && is_xfb_copy)
       {
         static int xfb_count = 0;
-        entry->texture->Save(
-            fmt::format("{}xfb_copy_{}.png", File::GetUserPath(D_DUMPTEXTURES_IDX), xfb_count++),
-            0);
+        QueueTextureDump(
+            entry->texture.get(), 0,
+            fmt::format("{}xfb_copy_{}.png", File::GetUserPath(D_DUMPTEXTURES_IDX), xfb_count++));
       }
     }
   }
@@ -2208,23 +2514,36 @@ void TextureCacheBase::CopyRenderTargetToTexture(
     EFBCopyParams format(srcFormat, dstFormat, is_depth_copy, isIntensity,
                          NeedsCopyFilterInShader(coefficients));
 
-    std::unique_ptr<AbstractStagingTexture> staging_texture = GetEFBCopyStagingTexture();
-    if (staging_texture)
+    // We can't defer if there is no VRAM copy (since we need to update the hash).
+    if (!copy_to_vram || !entry || !g_ActiveConfig.bDeferEFBCopies)
     {
-      CopyEFB(staging_texture.get(), format, tex_w, bytes_per_row, num_blocks_y, dstStride, srcRect,
-              scaleByHalf, linear_filter, y_scale, gamma, clamp_top, clamp_bottom, coefficients);
-
-      // We can't defer if there is no VRAM copy (since we need to update the hash).
-      if (!copy_to_vram || !g_ActiveConfig.bDeferEFBCopies)
+      std::unique_ptr<AbstractStagingTexture> staging_texture = GetEFBCopyStagingTexture();
+      if (staging_texture)
       {
+        CopyEFB(staging_texture.get(), 0, format, tex_w, bytes_per_row, num_blocks_y, dstStride,
+                srcRect, scaleByHalf, linear_filter, y_scale, gamma, clamp_top, clamp_bottom,
+                coefficients);
+
         // Immediately flush it.
         WriteEFBCopyToRAM(dst, bytes_per_row / sizeof(u32), num_blocks_y, dstStride,
-                          std::move(staging_texture));
+                          staging_texture.get(), 0);
+        ReleaseEFBCopyStagingTexture(std::move(staging_texture));
       }
-      else
+    }
+    else
+    {
+      u32 staging_row;
+      AbstractStagingTexture* staging_texture =
+          AllocateEFBCopyStagingRows(num_blocks_y, &staging_row);
+      if (staging_texture)
       {
+        CopyEFB(staging_texture, staging_row, format, tex_w, bytes_per_row, num_blocks_y,
+                dstStride, srcRect, scaleByHalf, linear_filter, y_scale, gamma, clamp_top,
+                clamp_bottom, coefficients);
+
         // Defer the flush until later.
-        entry->pending_efb_copy = std::move(staging_texture);
+        entry->pending_efb_copy = staging_texture;
+        entry->pending_efb_copy_row = staging_row;
         entry->pending_efb_copy_width = bytes_per_row / sizeof(u32);
         entry->pending_efb_copy_height = num_blocks_y;
         entry->pending_efb_copy_invalidated = false;
@@ -2306,11 +2625,7 @@ void TextureCacheBase::CopyRenderTargetToTexture(
 
       // Do not load textures by hash, if they were at least partly overwritten by an efb copy.
       // In this case, comparing the hash is not enough to check, if two textures are identical.
-      if (overlapping_entry->textures_by_hash_iter != textures_by_hash.end())
-      {
-        textures_by_hash.erase(overlapping_entry->textures_by_hash_iter);
-        overlapping_entry->textures_by_hash_iter = textures_by_hash.end();
-      }
+      RemoveFromHashCache(overlapping_entry);
     }
     ++iter.first;
   }
@@ -2333,26 +2648,29 @@ void TextureCacheBase::CopyRenderTargetToTexture(
   {
     const u64 hash = entry->CalculateHash();
     entry->SetHashes(hash, hash);
-    textures_by_address.emplace(dstAddr, entry);
+    AddToAddressCache(entry);
   }
 }
 
 void TextureCacheBase::FlushEFBCopies()
 {
-  if (m_pending_efb_copies.empty())
-    return;
-
+  // The first read from each staging texture waits for the GPU, the others in it don't have to.
   for (TCacheEntry* entry : m_pending_efb_copies)
     FlushEFBCopy(entry);
   m_pending_efb_copies.clear();
+
+  for (auto& staging_texture : m_efb_copy_staging_textures_in_use)
+    ReleaseEFBCopyStagingTexture(std::move(staging_texture));
+  m_efb_copy_staging_textures_in_use.clear();
+  m_efb_copy_staging_row = 0;
 }
 
 void TextureCacheBase::WriteEFBCopyToRAM(u8* dst_ptr, u32 width, u32 height, u32 stride,
-                                         std::unique_ptr<AbstractStagingTexture> staging_texture)
+                                         AbstractStagingTexture* staging_texture, u32 staging_row)
 {
-  MathUtil::Rectangle<int> copy_rect(0, 0, static_cast<int>(width), static_cast<int>(height));
+  MathUtil::Rectangle<int> copy_rect(0, static_cast<int>(staging_row), static_cast<int>(width),
+                                     static_cast<int>(staging_row + height));
   staging_texture->ReadTexels(copy_rect, dst_ptr, stride);
-  ReleaseEFBCopyStagingTexture(std::move(staging_texture));
 }
 
 void TextureCacheBase::FlushEFBCopy(TCacheEntry* entry)
@@ -2360,7 +2678,8 @@ void TextureCacheBase::FlushEFBCopy(TCacheEntry* entry)
   // Copy from texture -> guest memory.
   u8* const dst = Memory::GetPointer(entry->addr);
   WriteEFBCopyToRAM(dst, entry->pending_efb_copy_width, entry->pending_efb_copy_height,
-                    entry->memory_stride, std::move(entry->pending_efb_copy));
+                    entry->memory_stride, entry->pending_efb_copy, entry->pending_efb_copy_row);
+  entry->pending_efb_copy = nullptr;
 
   // If the EFB copy was invalidated (e.g. the bloom case mentioned in InvalidateTexture), now is
   // the time to clean up the TCacheEntry. In which case, we don't need to compute the new hash of
@@ -2418,6 +2737,24 @@ void TextureCacheBase::ReleaseEFBCopyStagingTexture(std::unique_ptr<AbstractStag
   m_efb_copy_staging_texture_pool.push_back(std::move(tex));
 }
 
+AbstractStagingTexture* TextureCacheBase::AllocateEFBCopyStagingRows(u32 height, u32* row)
+{
+  if (m_efb_copy_staging_textures_in_use.empty() || !CanBatchEFBCopyReadbacks() ||
+      m_efb_copy_staging_row + height > m_efb_copy_staging_textures_in_use.back()->GetHeight())
+  {
+    std::unique_ptr<AbstractStagingTexture> tex = GetEFBCopyStagingTexture();
+    if (!tex)
+      return nullptr;
+
+    m_efb_copy_staging_textures_in_use.push_back(std::move(tex));
+    m_efb_copy_staging_row = 0;
+  }
+
+  *row = m_efb_copy_staging_row;
+  m_efb_copy_staging_row += height;
+  return m_efb_copy_staging_textures_in_use.back().get();
+}
+
 void TextureCacheBase::UninitializeXFBMemory(u8* dst, u32 stride, u32 bytes_per_row,
                                              u32 num_blocks_y)
 {
@@ -2468,7 +2805,6 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::AllocateCacheEntry(const Textur
 
   TCacheEntry* cacheEntry =
       new TCacheEntry(std::move(alloc->texture), std::move(alloc->framebuffer));
-  cacheEntry->textures_by_hash_iter = textures_by_hash.end();
   cacheEntry->id = last_entry_id++;
   return cacheEntry;
 }
@@ -2481,9 +2817,16 @@ TextureCacheBase::AllocateTexture(const TextureConfig& config)
   {
     auto entry = std::move(iter->second);
     texture_pool.erase(iter);
+    INCSTAT(g_stats.num_texture_pool_hits);
     return std::move(entry);
   }
 
+  // Make room for the new texture by freeing unused ones first when over the budget.
+  const size_t memory_size = config.GetMemorySize();
+  const size_t budget = GetTextureMemoryBudget();
+  if (budget != 0)
+    FreePooledTextures(budget - std::min(budget, memory_size));
+
   std::unique_ptr<AbstractTexture> texture = g_renderer->CreateTexture(config);
   if (!texture)
   {
@@ -2505,6 +2848,7 @@ TextureCacheBase::AllocateTexture(const TextureConfig& config)
   }
 
   INCSTAT(g_stats.num_textures_created);
+  m_texture_memory_usage += memory_size;
   return TexPoolEntry(std::move(texture), std::move(framebuffer));
 }
 
@@ -2520,6 +2864,18 @@ TextureCacheBase::FindMatchingTextureFromPool(const TextureConfig& config)
   auto matching_iter = std::find_if(range.first, range.second, [](const auto& iter) {
     return iter.first.IsRenderTarget() || iter.second.frameCount != FRAMECOUNT_INVALID;
   });
+  if (matching_iter != range.second || config.flags != 0)
+    return matching_iter != range.second ? matching_iter : texture_pool.end();
+
+  // Render targets can be sampled and uploaded to like any other texture, so a pooled one of the
+  // same size and format can be used instead of creating a new texture. This mostly happens when
+  // scaled EFB copies are freed and textures of the same size are loaded afterwards.
+  TextureConfig render_target_config = config;
+  render_target_config.flags = AbstractTextureFlag_RenderTarget;
+  range = texture_pool.equal_range(render_target_config);
+  matching_iter = std::find_if(range.first, range.second, [](const auto& iter) {
+    return iter.second.frameCount != FRAMECOUNT_INVALID;
+  });
   return matching_iter != range.second ? matching_iter : texture_pool.end();
 }
 
@@ -2539,17 +2895,51 @@ TextureCacheBase::GetTexCacheIter(TextureCacheBase::TCacheEntry* entry)
   return textures_by_address.end();
 }
 
+static size_t GetSizeClass(u32 size_in_bytes)
+{
+  return size_in_bytes != 0 ? IntLog2(size_in_bytes) + 1 : 0;
+}
+
+TextureCacheBase::TexAddrCache::iterator
+TextureCacheBase::AddToAddressCache(TCacheEntry* entry)
+{
+  textures_by_size_class[GetSizeClass(entry->size_in_bytes)]++;
+  return textures_by_address.emplace(entry->addr, entry);
+}
+
+void TextureCacheBase::AddToHashCache(TCacheEntry* entry, u64 hash)
+{
+  textures_by_hash.emplace(hash, entry);
+  entry->textures_by_hash_key = hash;
+}
+
+void TextureCacheBase::RemoveFromHashCache(TCacheEntry* entry)
+{
+  if (!entry->textures_by_hash_key)
+    return;
+
+  const auto range = textures_by_hash.equal_range(*entry->textures_by_hash_key);
+  const auto iter = std::find_if(range.first, range.second,
+                                 [entry](const auto& pair) { return pair.second == entry; });
+  if (iter != range.second)
+    textures_by_hash.erase(iter);
+  entry->textures_by_hash_key.reset();
+}
+
 std::pair<TextureCacheBase::TexAddrCache::iterator, TextureCacheBase::TexAddrCache::iterator>
 TextureCacheBase::FindOverlappingTextures(u32 addr, u32 size_in_bytes)
 {
   // We index by the starting address only, so there is no way to query all textures
-  // which end after the given addr. But the GC textures have a limited size, so we
-  // look for all textures which have a start address bigger than addr minus the maximal
-  // texture size. But this yields false-positives which must be checked later on.
-
-  // 1024 x 1024 texel times 8 nibbles per texel
-  constexpr u32 max_texture_size = 1024 * 1024 * 4;
-  u32 lower_addr = addr > max_texture_size ? addr - max_texture_size : 0;
+  // which end after the given addr. But we know the size class of the largest texture
+  // in the cache, so we look for all textures which have a start address bigger than
+  // addr minus its upper bound. But this yields false-positives which must be checked
+  // later on.
+  size_t size_class = textures_by_size_class.size() - 1;
+  while (size_class > 0 && textures_by_size_class[size_class] == 0)
+    size_class--;
+
+  const u64 max_texture_size = (u64{1} << size_class) - 1;
+  u32 lower_addr = addr > max_texture_size ? static_cast<u32>(addr - max_texture_size) : 0;
   auto begin = textures_by_address.lower_bound(lower_addr);
   auto end = textures_by_address.upper_bound(addr + size_in_bytes);
 
@@ -2564,11 +2954,7 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
 
   TCacheEntry* entry = iter->second;
 
-  if (entry->textures_by_hash_iter != textures_by_hash.end())
-  {
-    textures_by_hash.erase(entry->textures_by_hash_iter);
-    entry->textures_by_hash_iter = textures_by_hash.end();
-  }
+  RemoveFromHashCache(entry);
 
   for (size_t i = 0; i < bound_textures.size(); ++i)
   {
@@ -2596,8 +2982,9 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
       // If the RAM copy is being completely overwritten by a new EFB copy, we can discard the
       // existing pending copy, and not bother waiting for it in the future. This happens in
       // Xenoblade's sunset scene, where 35 copies are done per frame, and 25 of them are
-      // copied to the same address, and can be skipped.
-      ReleaseEFBCopyStagingTexture(std::move(entry->pending_efb_copy));
+      // copied to the same address, and can be skipped. The rows of the staging texture are
+      // simply left unused until the other pending copies are flushed.
+      entry->pending_efb_copy = nullptr;
       auto pending_it = std::find(m_pending_efb_copies.begin(), m_pending_efb_copies.end(), entry);
       if (pending_it != m_pending_efb_copies.end())
         m_pending_efb_copies.erase(pending_it);
@@ -2612,6 +2999,8 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
   texture_pool.emplace(config,
                        TexPoolEntry(std::move(entry->texture), std::move(entry->framebuffer)));
 
+  textures_by_size_class[GetSizeClass(entry->size_in_bytes)]--;
+
   // Don't delete if there's a pending EFB copy, as we need the TCacheEntry alive.
   if (!entry->pending_efb_copy)
     delete entry;
@@ -2714,9 +3103,10 @@ void TextureCacheBase::CopyEFBToCacheEntry(TCacheEntry* entry, bool is_depth_cop
   entry->texture->FinishedRendering();
 }
 
-void TextureCacheBase::CopyEFB(AbstractStagingTexture* dst, const EFBCopyParams& params,
-                               u32 native_width, u32 bytes_per_row, u32 num_blocks_y,
-                               u32 memory_stride, const MathUtil::Rectangle<int>& src_rect,
+void TextureCacheBase::CopyEFB(AbstractStagingTexture* dst, u32 dst_row,
+                               const EFBCopyParams& params, u32 native_width, u32 bytes_per_row,
+                               u32 num_blocks_y, u32 memory_stride,
+                               const MathUtil::Rectangle<int>& src_rect,
                                bool scale_by_half, bool linear_filter, float y_scale, float gamma,
                                bool clamp_top, bool clamp_bottom,
                                const EFBCopyFilterCoefficients& filter_coefficients)
@@ -2781,7 +3171,8 @@ void TextureCacheBase::CopyEFB(AbstractStagingTexture* dst, const EFBCopyParams&
   g_renderer->SetSamplerState(0, linear_filter ? RenderState::GetLinearSamplerState() :
                                                  RenderState::GetPointSamplerState());
   g_renderer->Draw(0, 3);
-  dst->CopyFromTexture(m_efb_encoding_texture.get(), encode_rect, 0, 0, encode_rect);
+  const auto dst_rect = MathUtil::Rectangle<int>(0, dst_row, render_width, dst_row + render_height);
+  dst->CopyFromTexture(m_efb_encoding_texture.get(), encode_rect, 0, 0, dst_rect);
   g_renderer->EndUtilityDrawing();
 
   // Flush if there's sufficient draws between this copy and the last.
@@ -6,6 +6,8 @@
 
 #include <array>
 #include <bitset>
+#include <deque>
+#include <future>
 #include <map>
 #include <memory>
 #include <optional>
@@ -20,6 +22,7 @@
 #include "VideoCommon/AbstractTexture.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/TextureConfig.h"
+#include "VideoCommon/TextureDecodeQueue.h"
 #include "VideoCommon/TextureDecoder.h"
 
 class AbstractFramebuffer;
@@ -97,6 +100,8 @@ public:
     u32 memory_stride;
     bool is_efb_copy;
     bool is_custom_tex;
+    // The custom texture which was still loading when this entry was created with the native one.
+    std::string pending_custom_tex;
     bool may_have_overlapping_textures = true;
     bool tmem_only = false;           // indicates that this texture only exists in the tmem cache
     bool has_arbitrary_mips = false;  // indicates that the mips in this texture are arbitrary
@@ -115,17 +120,19 @@ public:
     // used to delete textures which haven't been used for TEXTURE_KILL_THRESHOLD frames
     int frameCount = FRAMECOUNT_INVALID;
 
-    // Keep an iterator to the entry in textures_by_hash, so it does not need to be searched when
-    // removing the cache entry
-    std::multimap<u64, TCacheEntry*>::iterator textures_by_hash_iter;
+    // The key of the entry in textures_by_hash, if it is in there. Iterators to an unordered map
+    // don't survive rehashing, so the entry is found again through its key when removing it.
+    std::optional<u64> textures_by_hash_key;
 
     // This is used to keep track of both:
     //   * efb copies used by this partially updated texture
     //   * partially updated textures which refer to this efb copy
     std::unordered_set<TCacheEntry*> references;
 
-    // Pending EFB copy
-    std::unique_ptr<AbstractStagingTexture> pending_efb_copy;
+    // Pending EFB copy, in the rows starting at pending_efb_copy_row of a staging texture which
+    // may be shared with other pending copies.
+    AbstractStagingTexture* pending_efb_copy = nullptr;
+    u32 pending_efb_copy_row = 0;
     u32 pending_efb_copy_width = 0;
     u32 pending_efb_copy_height = 0;
     bool pending_efb_copy_invalidated = false;
@@ -239,6 +246,14 @@ public:
 
   // Texture Serialization
   void SerializeTexture(AbstractTexture* tex, const TextureConfig& config, PointerWrap& p);
+
+  // Starts copying the texture to staging textures, which SerializeTexture then reads from instead
+  // of reading it back itself. Queuing all the textures of a state before serializing any lets
+  // the GPU copy them at once, while the CPU serializes the rest of the state.
+  void QueueTextureReadback(const AbstractTexture* tex, const TextureConfig& config);
+
+  // Queues the readbacks of the cache entries DoState will save.
+  void QueueSaveStateReadbacks();
   std::optional<TexPoolEntry> DeserializeTexture(PointerWrap& p);
 
   // Save States
@@ -258,8 +273,9 @@ protected:
                           u32 aligned_height, u32 row_stride, const u8* palette,
                           TLUTFormat palette_format);
 
-  virtual void CopyEFB(AbstractStagingTexture* dst, const EFBCopyParams& params, u32 native_width,
-                       u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
+  // Encodes an EFB copy into the rows of dst starting at dst_row.
+  virtual void CopyEFB(AbstractStagingTexture* dst, u32 dst_row, const EFBCopyParams& params,
+                       u32 native_width, u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
                        const MathUtil::Rectangle<int>& src_rect, bool scale_by_half,
                        bool linear_filter, float y_scale, float gamma, bool clamp_top,
                        bool clamp_bottom, const EFBCopyFilterCoefficients& filter_coefficients);
@@ -272,12 +288,15 @@ protected:
   alignas(16) u8* temp = nullptr;
   size_t temp_size = 0;
 
+  // RGBA8 texture data from Tmem, rearranged for decoding on the GPU.
+  std::vector<u8> tmem_rgba8_data;
+
   std::array<TCacheEntry*, 8> bound_textures{};
   static std::bitset<8> valid_bind_points;
 
 private:
   using TexAddrCache = std::multimap<u32, TCacheEntry*>;
-  using TexHashCache = std::multimap<u64, TCacheEntry*>;
+  using TexHashCache = std::unordered_multimap<u64, TCacheEntry*>;
   using TexPool = std::unordered_multimap<TextureConfig, TexPoolEntry>;
 
   bool CreateUtilityTextures();
@@ -286,6 +305,9 @@ private:
 
   TCacheEntry* GetXFBFromCache(u32 address, u32 width, u32 height, u32 stride, u64 hash);
 
+  // Hashes texture memory, or reuses the previous hash if the memory hasn't been written since.
+  u64 GetTrackedHash(u32 address, u32 size, int sample_size, const u8* src_data);
+
   TCacheEntry* ApplyPaletteToEntry(TCacheEntry* entry, u8* palette, TLUTFormat tlutfmt);
 
   TCacheEntry* ReinterpretEntry(const TCacheEntry* existing_entry, TextureFormat new_format);
@@ -295,13 +317,37 @@ private:
   void StitchXFBCopy(TCacheEntry* entry_to_update);
 
   void DumpTexture(TCacheEntry* entry, std::string basename, unsigned int level, bool is_arbitrary);
+
+  // Copies a level of the texture to a staging texture, which is saved to the file by
+  // FlushTextureDumps once the GPU is done with it.
+  void QueueTextureDump(const AbstractTexture* texture, u32 level, std::string filename);
+
+  // Maps the readbacks queued before the current frame, or all of them, and hands them to the
+  // shared thread pool to be encoded.
+  void FlushTextureDumps(bool flush_all);
   void CheckTempSize(size_t required_size);
 
   TCacheEntry* AllocateCacheEntry(const TextureConfig& config);
   std::optional<TexPoolEntry> AllocateTexture(const TextureConfig& config);
   TexPool::iterator FindMatchingTextureFromPool(const TextureConfig& config);
+
+  // Returns the number of bytes textures are allowed to use, 0 meaning unlimited.
+  static size_t GetTextureMemoryBudget();
+
+  // Frees the least recently used textures from the pool until the textures use no more than
+  // budget bytes, or the pool is empty.
+  void FreePooledTextures(size_t budget);
+
+  // Like FreePooledTextures, but also evicts textures not used in the current frame from the
+  // cache when freeing the pool isn't enough. EFB copies are kept, as they can't be recreated.
+  void EvictTextures(size_t budget, int frame_count);
   TexAddrCache::iterator GetTexCacheIter(TCacheEntry* entry);
 
+  // Adds an entry to textures_by_address. Its address and size must not change afterwards.
+  TexAddrCache::iterator AddToAddressCache(TCacheEntry* entry);
+  void AddToHashCache(TCacheEntry* entry, u64 hash);
+  void RemoveFromHashCache(TCacheEntry* entry);
+
   // Return all possible overlapping textures. As addr+size of the textures is not
   // indexed, this may return false positives.
   std::pair<TexAddrCache::iterator, TexAddrCache::iterator>
@@ -319,26 +365,79 @@ private:
   static EFBCopyFilterCoefficients
   GetVRAMCopyFilterCoefficients(const CopyFilterCoefficients::Values& coefficients);
 
+  // Whether deferred EFB copies can share staging textures, so that all of them are read back with
+  // a single GPU sync per staging texture.
+  virtual bool CanBatchEFBCopyReadbacks() const { return true; }
+
   // Flushes a pending EFB copy to RAM from the host to the guest RAM.
   void WriteEFBCopyToRAM(u8* dst_ptr, u32 width, u32 height, u32 stride,
-                         std::unique_ptr<AbstractStagingTexture> staging_texture);
+                         AbstractStagingTexture* staging_texture, u32 staging_row);
   void FlushEFBCopy(TCacheEntry* entry);
 
   // Returns a staging texture of the maximum EFB copy size.
   std::unique_ptr<AbstractStagingTexture> GetEFBCopyStagingTexture();
 
+  // Returns a staging texture with height free rows for a deferred EFB copy, which stays alive
+  // until the pending copies are flushed, and sets row to the first of them.
+  AbstractStagingTexture* AllocateEFBCopyStagingRows(u32 height, u32* row);
+
   // Returns an EFB copy staging texture to the pool, so it can be re-used.
   void ReleaseEFBCopyStagingTexture(std::unique_ptr<AbstractStagingTexture> tex);
 
   bool CheckReadbackTexture(u32 width, u32 height, AbstractTextureFormat format);
+  static bool ShouldSaveEntry(const TCacheEntry* entry);
   void DoSaveState(PointerWrap& p);
   void DoLoadState(PointerWrap& p);
 
   TexAddrCache textures_by_address;
   TexHashCache textures_by_hash;
   TexPool texture_pool;
+
+  // Approximate amount of memory used by the textures of the cache and the pool, in bytes.
+  // It is recalculated on every Cleanup, and updated when textures are created in between.
+  size_t m_texture_memory_usage = 0;
+
+  // Number of entries in textures_by_address per power of two size class. This bounds how far
+  // before an address FindOverlappingTextures has to look for textures overlapping it.
+  std::array<u32, 33> textures_by_size_class{};
   u64 last_entry_id = 0;
 
+  struct TrackedHash
+  {
+    u32 size;
+    int sample_size;
+    u64 stamp;
+    u64 hash;
+  };
+  // Texture hashes by address, valid while the memory is unmodified since the stamp.
+  std::unordered_map<u32, TrackedHash> tracked_hashes;
+
+  // Decodes the levels of textures that aren't decoded on the GPU.
+  TextureDecodeQueue m_decode_queue;
+
+  struct QueuedReadback
+  {
+    TextureConfig config;
+    // One per level of each layer, in the order they are serialized.
+    std::vector<std::unique_ptr<AbstractStagingTexture>> levels;
+  };
+  // Readbacks queued for serializing a state, until SerializeTexture takes them.
+  std::unordered_map<const AbstractTexture*, QueuedReadback> m_queued_readbacks;
+
+  struct PendingTextureDump
+  {
+    std::unique_ptr<AbstractStagingTexture> readback;
+    std::string filename;
+    u64 frame;
+  };
+  // Readbacks for texture dumps, which are mapped a frame later so that the GPU isn't waited for.
+  std::deque<PendingTextureDump> m_pending_texture_dumps;
+  // PNG encodes of dumped textures running on the thread pool, oldest first.
+  std::deque<std::future<void>> m_texture_dump_tasks;
+  // Names of the textures which have been dumped, or found to exist already.
+  std::unordered_set<std::string> m_dumped_texture_names;
+  u64 m_texture_dump_frame = 0;
+
   // Backup configuration values
   struct BackupConfig
   {
@@ -347,6 +446,7 @@ private:
     bool texfmt_overlay_center;
     bool hires_textures;
     bool cache_hires_textures;
+    int hires_texture_cache_size;
     bool copy_cache_enable;
     bool stereo_3d;
     bool efb_mono_depth;
@@ -366,6 +466,11 @@ private:
   // Pool of readback textures used for deferred EFB copies.
   std::vector<std::unique_ptr<AbstractStagingTexture>> m_efb_copy_staging_texture_pool;
 
+  // Staging textures holding pending EFB copies. New copies are placed below the previous ones in
+  // the last texture, starting at m_efb_copy_staging_row, as long as they fit.
+  std::vector<std::unique_ptr<AbstractStagingTexture>> m_efb_copy_staging_textures_in_use;
+  u32 m_efb_copy_staging_row = 0;
+
   // List of pending EFB copies. It is important that the order is preserved for these,
   // so that overlapping textures are written to guest RAM in the order they are issued.
   std::vector<TCacheEntry*> m_pending_efb_copies;
@@ -0,0 +1,193 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/TextureCompression.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <utility>
+
+namespace TextureCompression
+{
+namespace
+{
+using Block = std::array<std::array<u8, 4>, 16>;
+
+u16 ToRGB565(const std::array<int, 3>& rgb)
+{
+  return static_cast<u16>(((rgb[0] >> 3) << 11) | ((rgb[1] >> 2) << 5) | (rgb[2] >> 3));
+}
+
+std::array<int, 3> FromRGB565(u16 color)
+{
+  const int r = (color >> 11) & 0x1f;
+  const int g = (color >> 5) & 0x3f;
+  const int b = color & 0x1f;
+  return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+void WriteLE(u8* dst, u64 value, int bytes)
+{
+  for (int i = 0; i < bytes; i++)
+    dst[i] = static_cast<u8>(value >> (i * 8));
+}
+
+// Alpha is stored as two endpoints and a 3 bit index per pixel. With the first endpoint larger,
+// the indices select between the endpoints and six values interpolated between them.
+void CompressAlpha(const Block& block, u8* dst)
+{
+  int min = 255;
+  int max = 0;
+  for (const auto& pixel : block)
+  {
+    min = std::min<int>(min, pixel[3]);
+    max = std::max<int>(max, pixel[3]);
+  }
+
+  dst[0] = static_cast<u8>(max);
+  dst[1] = static_cast<u8>(min);
+  if (min == max)
+  {
+    WriteLE(dst + 2, 0, 6);
+    return;
+  }
+
+  std::array<int, 8> palette;
+  palette[0] = max;
+  palette[1] = min;
+  for (int i = 2; i < 8; i++)
+    palette[i] = ((8 - i) * max + (i - 1) * min) / 7;
+
+  u64 indices = 0;
+  for (size_t i = 0; i < block.size(); i++)
+  {
+    int best_index = 0;
+    int best_error = 256;
+    for (int j = 0; j < 8; j++)
+    {
+      const int error = std::abs(palette[j] - block[i][3]);
+      if (error < best_error)
+      {
+        best_index = j;
+        best_error = error;
+      }
+    }
+    indices |= static_cast<u64>(best_index) << (i * 3);
+  }
+  WriteLE(dst + 2, indices, 6);
+}
+
+// Color is stored as two RGB565 endpoints and a 2 bit index per pixel, selecting between them and
+// two colors a third and two thirds of the way. The endpoints are opposite corners of the block's
+// bounding box, moved inwards a little, as the colors near the corners are usually few. Of the
+// four diagonals, the one along which green and blue change with red is used.
+void CompressColor(const Block& block, u8* dst)
+{
+  std::array<int, 3> min = {255, 255, 255};
+  std::array<int, 3> max = {0, 0, 0};
+  for (const auto& pixel : block)
+  {
+    for (size_t c = 0; c < 3; c++)
+    {
+      min[c] = std::min<int>(min[c], pixel[c]);
+      max[c] = std::max<int>(max[c], pixel[c]);
+    }
+  }
+  for (size_t c = 0; c < 3; c++)
+  {
+    const int inset = (max[c] - min[c]) >> 4;
+    min[c] += inset;
+    max[c] -= inset;
+  }
+
+  std::array<int, 3> center;
+  for (size_t c = 0; c < 3; c++)
+    center[c] = (min[c] + max[c]) / 2;
+  int covariance_rg = 0;
+  int covariance_rb = 0;
+  for (const auto& pixel : block)
+  {
+    covariance_rg += (pixel[0] - center[0]) * (pixel[1] - center[1]);
+    covariance_rb += (pixel[0] - center[0]) * (pixel[2] - center[2]);
+  }
+  if (covariance_rg < 0)
+    std::swap(min[1], max[1]);
+  if (covariance_rb < 0)
+    std::swap(min[2], max[2]);
+
+  // color0 has to be the larger one, the other order selects the mode with transparent black.
+  u16 color0 = ToRGB565(max);
+  u16 color1 = ToRGB565(min);
+  if (color0 < color1)
+    std::swap(color0, color1);
+  WriteLE(dst, color0, 2);
+  WriteLE(dst + 2, color1, 2);
+  if (color0 == color1)
+  {
+    WriteLE(dst + 4, 0, 4);
+    return;
+  }
+
+  std::array<std::array<int, 3>, 4> palette;
+  palette[0] = FromRGB565(color0);
+  palette[1] = FromRGB565(color1);
+  for (size_t c = 0; c < 3; c++)
+  {
+    palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+    palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+  }
+
+  u32 indices = 0;
+  for (size_t i = 0; i < block.size(); i++)
+  {
+    u32 best_index = 0;
+    int best_error = 0x7fffffff;
+    for (u32 j = 0; j < 4; j++)
+    {
+      int error = 0;
+      for (size_t c = 0; c < 3; c++)
+        error += (palette[j][c] - block[i][c]) * (palette[j][c] - block[i][c]);
+      if (error < best_error)
+      {
+        best_index = j;
+        best_error = error;
+      }
+    }
+    indices |= best_index << (i * 2);
+  }
+  WriteLE(dst + 4, indices, 4);
+}
+}  // namespace
+
+size_t GetBC3Size(u32 width, u32 height)
+{
+  return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * 16;
+}
+
+void CompressBC3(const u8* src, u32 width, u32 height, u32 row_length, u8* dst)
+{
+  for (u32 block_y = 0; block_y < height; block_y += 4)
+  {
+    for (u32 block_x = 0; block_x < width; block_x += 4)
+    {
+      Block block;
+      for (u32 y = 0; y < 4; y++)
+      {
+        const u32 src_y = std::min(block_y + y, height - 1);
+        for (u32 x = 0; x < 4; x++)
+        {
+          const u32 src_x = std::min(block_x + x, width - 1);
+          const u8* pixel = src + (static_cast<size_t>(src_y) * row_length + src_x) * 4;
+          std::copy(pixel, pixel + 4, block[y * 4 + x].begin());
+        }
+      }
+
+      CompressAlpha(block, dst);
+      CompressColor(block, dst + 8);
+      dst += 16;
+    }
+  }
+}
+}  // namespace TextureCompression
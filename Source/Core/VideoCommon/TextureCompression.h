@@ -0,0 +1,20 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+
+#include "Common/CommonTypes.h"
+
+// Block compression of RGBA8 images, so that custom textures take a quarter of the memory.
+namespace TextureCompression
+{
+// The size of the BC3 (DXT5) data for an image, which is stored in 4x4 blocks of 16 bytes.
+size_t GetBC3Size(u32 width, u32 height);
+
+// Compresses the RGBA8 pixels in src, whose rows are row_length pixels apart, to BC3. Blocks at
+// the right and bottom edges repeat the last column and row if the size isn't a multiple of 4.
+void CompressBC3(const u8* src, u32 width, u32 height, u32 row_length, u8* dst);
+}  // namespace TextureCompression
@@ -57,6 +57,9 @@ struct TextureConfig
   size_t GetStride() const;
   size_t GetMipStride(u32 level) const;
 
+  // Approximate number of bytes of video memory used by a texture with this configuration.
+  size_t GetMemorySize() const;
+
   bool IsMultisampled() const { return samples > 1; }
   bool IsRenderTarget() const { return (flags & AbstractTextureFlag_RenderTarget) != 0; }
   bool IsComputeImage() const { return (flags & AbstractTextureFlag_ComputeImage) != 0; }
@@ -0,0 +1,123 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/TextureDecodeQueue.h"
+
+#include <algorithm>
+
+#include "Common/Thread.h"
+
+// Levels smaller than this are not worth splitting, the synchronization would cost more than
+// decoding them on a single thread.
+constexpr u32 MIN_TEXELS_PER_JOB = 128 * 128;
+
+TextureDecodeQueue::~TextureDecodeQueue()
+{
+  StopWorkerThreads();
+}
+
+void TextureDecodeQueue::SetNumWorkerThreads(u32 num_worker_threads)
+{
+  if (m_worker_threads.size() == num_worker_threads)
+    return;
+
+  StopWorkerThreads();
+  for (u32 i = 0; i < num_worker_threads; i++)
+    m_worker_threads.emplace_back(&TextureDecodeQueue::WorkerThreadRun, this);
+}
+
+void TextureDecodeQueue::StopWorkerThreads()
+{
+  {
+    std::lock_guard guard(m_mutex);
+    m_exit_worker_threads = true;
+  }
+  m_worker_thread_wake.notify_all();
+
+  for (std::thread& thread : m_worker_threads)
+    thread.join();
+  m_worker_threads.clear();
+  m_exit_worker_threads = false;
+}
+
+void TextureDecodeQueue::QueueDecode(u8* dst, const u8* src, u32 width, u32 height,
+                                     TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt)
+{
+  const Job level{dst, src, width, height, texformat, tlut, tlutfmt};
+
+  const u32 block_height = TexDecoder_GetBlockHeightInTexels(texformat);
+  const u32 num_block_rows = height / block_height;
+  const u32 max_jobs = static_cast<u32>(m_worker_threads.size()) + 1;
+  const u32 num_jobs =
+      std::max(std::min({width * height / MIN_TEXELS_PER_JOB, max_jobs, num_block_rows}), 1u);
+  const u32 block_rows_per_job = (num_block_rows + num_jobs - 1) / num_jobs;
+
+  const u32 src_block_row_size = TexDecoder_GetTextureSizeInBytes(width, block_height, texformat);
+  const u32 dst_block_row_size = width * block_height * sizeof(u32);
+
+  {
+    std::lock_guard guard(m_mutex);
+    for (u32 row = 0; row < num_block_rows; row += block_rows_per_job)
+    {
+      Job job = level;
+      job.dst += row * dst_block_row_size;
+      job.src += row * src_block_row_size;
+      job.height = std::min(block_rows_per_job, num_block_rows - row) * block_height;
+      m_jobs.push_back(job);
+    }
+  }
+  m_levels.push_back(level);
+
+  if (num_jobs > 1)
+    m_worker_thread_wake.notify_all();
+}
+
+void TextureDecodeQueue::WaitForDecodes()
+{
+  std::unique_lock lock(m_mutex);
+  while (RunNextJob(lock))
+  {
+  }
+  m_jobs_done.wait(lock, [this] { return m_num_running_jobs == 0; });
+  lock.unlock();
+
+  for (const Job& level : m_levels)
+  {
+    TexDecoder_DrawOverlay(level.dst, static_cast<int>(level.width),
+                           static_cast<int>(level.height), level.texformat);
+  }
+  m_levels.clear();
+}
+
+bool TextureDecodeQueue::RunNextJob(std::unique_lock<std::mutex>& lock)
+{
+  if (m_jobs.empty())
+    return false;
+
+  const Job job = m_jobs.front();
+  m_jobs.pop_front();
+  m_num_running_jobs++;
+  lock.unlock();
+
+  _TexDecoder_DecodeImpl(reinterpret_cast<u32*>(job.dst), job.src, static_cast<int>(job.width),
+                         static_cast<int>(job.height), job.texformat, job.tlut, job.tlutfmt);
+
+  lock.lock();
+  m_num_running_jobs--;
+  if (m_num_running_jobs == 0 && m_jobs.empty())
+    m_jobs_done.notify_all();
+  return true;
+}
+
+void TextureDecodeQueue::WorkerThreadRun()
+{
+  Common::SetCurrentThreadName("Texture Decoder Worker");
+
+  std::unique_lock lock(m_mutex);
+  while (!m_exit_worker_threads)
+  {
+    if (!RunNextJob(lock))
+      m_worker_thread_wake.wait(lock);
+  }
+}
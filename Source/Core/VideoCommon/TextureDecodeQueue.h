@@ -0,0 +1,63 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureDecoder.h"
+
+// Decodes textures on the CPU using a pool of worker threads. Large levels are split into bands of
+// block rows, which the workers and the thread waiting for the result decode in parallel. Without
+// any worker threads, everything is decoded by the waiting thread.
+class TextureDecodeQueue
+{
+public:
+  TextureDecodeQueue() = default;
+  ~TextureDecodeQueue();
+
+  void SetNumWorkerThreads(u32 num_worker_threads);
+
+  // Queues decoding a level like TexDecoder_Decode does. width and height must be multiples of the
+  // block size of the format. The buffers must stay valid until WaitForDecodes() returns.
+  void QueueDecode(u8* dst, const u8* src, u32 width, u32 height, TextureFormat texformat,
+                   const u8* tlut, TLUTFormat tlutfmt);
+
+  // Decodes all queued levels, helping the worker threads, and waits until they are done.
+  void WaitForDecodes();
+
+private:
+  struct Job
+  {
+    u8* dst;
+    const u8* src;
+    u32 width;
+    u32 height;
+    TextureFormat texformat;
+    const u8* tlut;
+    TLUTFormat tlutfmt;
+  };
+
+  void StopWorkerThreads();
+  void WorkerThreadRun();
+
+  // Runs the next job in the queue without holding the lock. Returns false if there was none.
+  bool RunNextJob(std::unique_lock<std::mutex>& lock);
+
+  std::vector<std::thread> m_worker_threads;
+  std::mutex m_mutex;
+  std::condition_variable m_worker_thread_wake;
+  std::condition_variable m_jobs_done;
+  std::deque<Job> m_jobs;
+  u32 m_num_running_jobs = 0;
+  bool m_exit_worker_threads = false;
+
+  // Whole levels, for drawing the format overlay once all of their bands are decoded.
+  std::vector<Job> m_levels;
+};
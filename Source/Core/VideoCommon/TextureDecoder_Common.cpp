@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <cstring>
 
 #include "Common/CommonTypes.h"
 #include "Common/MsgHandler.h"
@@ -331,8 +332,11 @@ static const char* texfmt[] = {
     "0x3F",
 };
 
-static void TexDecoder_DrawOverlay(u8* dst, int width, int height, TextureFormat texformat)
+void TexDecoder_DrawOverlay(u8* dst, int width, int height, TextureFormat texformat)
 {
+  if (!TexFmt_Overlay_Enable)
+    return;
+
   int w = std::min(width, 40);
   int h = std::min(height, 10);
 
@@ -378,9 +382,7 @@ void TexDecoder_Decode(u8* dst, const u8* src, int width, int height, TextureFor
                        const u8* tlut, TLUTFormat tlutfmt)
 {
   _TexDecoder_DecodeImpl((u32*)dst, src, width, height, texformat, tlut, tlutfmt);
-
-  if (TexFmt_Overlay_Enable)
-    TexDecoder_DrawOverlay(dst, width, height, texformat);
+  TexDecoder_DrawOverlay(dst, width, height, texformat);
 }
 
 static inline u32 DecodePixel_IA8(u16 val)
@@ -755,6 +757,21 @@ void TexDecoder_DecodeRGBA8FromTmem(u8* dst, const u8* src_ar, const u8* src_gb,
   }
 }
 
+void TexDecoder_MergeRGBA8FromTmem(u8* dst, const u8* src_ar, const u8* src_gb, int width,
+                                   int height)
+{
+  // In RAM, the 32 bytes of AR data of every 4x4 block are followed by its 32 bytes of GB data.
+  const int num_blocks = ((width + 3) / 4) * ((height + 3) / 4);
+  for (int i = 0; i < num_blocks; ++i)
+  {
+    std::memcpy(dst, src_ar, 32);
+    std::memcpy(dst + 32, src_gb, 32);
+    dst += 64;
+    src_ar += 32;
+    src_gb += 32;
+  }
+}
+
 void TexDecoder_DecodeXFB(u8* dst, const u8* src, u32 width, u32 height, u32 stride)
 {
   const u8* src_ptr = src;
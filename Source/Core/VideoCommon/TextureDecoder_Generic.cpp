@@ -4,6 +4,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+
+#ifdef _M_ARM_64
+#include <arm_neon.h>
+#endif
 
 #include "Common/CPUDetect.h"
 #include "Common/CommonTypes.h"
@@ -72,25 +77,28 @@ static inline u32 DecodePixel_Paletted(u16 pixel, TLUTFormat tlutfmt)
   }
 }
 
-static inline void DecodeBytes_C4(u32* dst, const u8* src, const u8* tlut_, TLUTFormat tlutfmt)
+// Decodes all colors of a small palette up front, so that every texel is a single lookup.
+static void DecodePalette(u32* dst, const u8* tlut_, int num_colors, TLUTFormat tlutfmt)
 {
   const u16* tlut = (u16*)tlut_;
+  for (int i = 0; i < num_colors; i++)
+    dst[i] = DecodePixel_Paletted(tlut[i], tlutfmt);
+}
+
+static inline void DecodeBytes_C4(u32* dst, const u8* src, const u32* palette)
+{
   for (int x = 0; x < 4; x++)
   {
     u8 val = src[x];
-    *dst++ = DecodePixel_Paletted(tlut[val >> 4], tlutfmt);
-    *dst++ = DecodePixel_Paletted(tlut[val & 0xF], tlutfmt);
+    *dst++ = palette[val >> 4];
+    *dst++ = palette[val & 0xF];
   }
 }
 
-static inline void DecodeBytes_C8(u32* dst, const u8* src, const u8* tlut_, TLUTFormat tlutfmt)
+static inline void DecodeBytes_C8(u32* dst, const u8* src, const u32* palette)
 {
-  const u16* tlut = (u16*)tlut_;
   for (int x = 0; x < 8; x++)
-  {
-    u8 val = src[x];
-    *dst++ = DecodePixel_Paletted(tlut[val], tlutfmt);
-  }
+    *dst++ = palette[src[x]];
 }
 
 static inline void DecodeBytes_C14X2(u32* dst, const u16* src, const u8* tlut_, TLUTFormat tlutfmt)
@@ -142,6 +150,141 @@ static inline void DecodeBytes_RGBA8(u32* dst, const u16* src, const u16* src2)
 #endif
 }
 
+#ifdef _M_ARM_64
+// Stores texels 0-3 of the given channels to dst0 and texels 4-7 to dst1.
+static inline void StoreRGBA_NEON(u32* dst0, u32* dst1, uint8x8_t r, uint8x8_t g, uint8x8_t b,
+                                  uint8x8_t a)
+{
+  const uint16x8_t rg = vreinterpretq_u16_u8(vcombine_u8(vzip1_u8(r, g), vzip2_u8(r, g)));
+  const uint16x8_t ba = vreinterpretq_u16_u8(vcombine_u8(vzip1_u8(b, a), vzip2_u8(b, a)));
+  vst1q_u8(reinterpret_cast<u8*>(dst0), vreinterpretq_u8_u16(vzip1q_u16(rg, ba)));
+  vst1q_u8(reinterpret_cast<u8*>(dst1), vreinterpretq_u8_u16(vzip2q_u16(rg, ba)));
+}
+
+// Loads eight big endian 16-bit texels.
+static inline uint16x8_t Load16_NEON(const u8* src)
+{
+  return vreinterpretq_u16_u8(vrev16q_u8(vld1q_u8(src)));
+}
+
+// Returns bits [shift, shift + bits) of every texel.
+template <int shift, int bits>
+static inline uint8x8_t GetBits_NEON(uint16x8_t texels)
+{
+  const uint8x8_t mask = vdup_n_u8((1 << bits) - 1);
+  if constexpr (shift == 0)
+    return vand_u8(vmovn_u16(texels), mask);
+  else
+    return vand_u8(vmovn_u16(vshrq_n_u16(texels, shift)), mask);
+}
+
+static inline uint8x8_t Convert4To8_NEON(uint8x8_t v)
+{
+  return vmul_u8(v, vdup_n_u8(0x11));
+}
+
+static inline uint8x8_t Convert5To8_NEON(uint8x8_t v)
+{
+  return vorr_u8(vshl_n_u8(v, 3), vshr_n_u8(v, 2));
+}
+
+static inline uint8x8_t Convert6To8_NEON(uint8x8_t v)
+{
+  return vorr_u8(vshl_n_u8(v, 2), vshr_n_u8(v, 4));
+}
+
+// Decodes one row of an I4 block, 8 texels.
+static inline void DecodeRow_I4_NEON(u32* dst, const u8* src)
+{
+  u32 bytes;
+  std::memcpy(&bytes, src, sizeof(bytes));
+  const uint8x8_t v = vreinterpret_u8_u32(vdup_n_u32(bytes));
+  const uint8x8_t i = Convert4To8_NEON(vzip1_u8(vshr_n_u8(v, 4), vand_u8(v, vdup_n_u8(0xF))));
+  StoreRGBA_NEON(dst, dst + 4, i, i, i, i);
+}
+
+// Decodes one row of an I8 block, 8 texels.
+static inline void DecodeRow_I8_NEON(u32* dst, const u8* src)
+{
+  const uint8x8_t i = vld1_u8(src);
+  StoreRGBA_NEON(dst, dst + 4, i, i, i, i);
+}
+
+// Decodes one row of an IA4 block, 8 texels.
+static inline void DecodeRow_IA4_NEON(u32* dst, const u8* src)
+{
+  const uint8x8_t v = vld1_u8(src);
+  const uint8x8_t a = Convert4To8_NEON(vshr_n_u8(v, 4));
+  const uint8x8_t i = Convert4To8_NEON(vand_u8(v, vdup_n_u8(0xF)));
+  StoreRGBA_NEON(dst, dst + 4, i, i, i, a);
+}
+
+// The following decode two rows of a 4x4 block of 16-bit texels, 4 texels each.
+static inline void DecodeRows_IA8_NEON(u32* dst0, u32* dst1, const u8* src)
+{
+  const uint8x8x2_t ai = vld2_u8(src);
+  StoreRGBA_NEON(dst0, dst1, ai.val[1], ai.val[1], ai.val[1], ai.val[0]);
+}
+
+static inline void DecodeRows_RGB565_NEON(u32* dst0, u32* dst1, const u8* src)
+{
+  const uint16x8_t v = Load16_NEON(src);
+  const uint8x8_t r = Convert5To8_NEON(GetBits_NEON<11, 5>(v));
+  const uint8x8_t g = Convert6To8_NEON(GetBits_NEON<5, 6>(v));
+  const uint8x8_t b = Convert5To8_NEON(GetBits_NEON<0, 5>(v));
+  StoreRGBA_NEON(dst0, dst1, r, g, b, vdup_n_u8(0xFF));
+}
+
+static inline void DecodeRows_RGB5A3_NEON(u32* dst0, u32* dst1, const u8* src)
+{
+  const uint16x8_t v = Load16_NEON(src);
+
+  // Texels with the top bit set are opaque RGB555, the others are ARGB3444.
+  const uint8x8_t opaque = vmovn_u16(vtstq_u16(v, vdupq_n_u16(0x8000)));
+
+  const uint8x8_t a3 = GetBits_NEON<12, 3>(v);
+  const uint8x8_t a = vorr_u8(opaque, vorr_u8(vorr_u8(vshl_n_u8(a3, 5), vshl_n_u8(a3, 2)),
+                                              vshr_n_u8(a3, 1)));
+  const uint8x8_t r = vbsl_u8(opaque, Convert5To8_NEON(GetBits_NEON<10, 5>(v)),
+                              Convert4To8_NEON(GetBits_NEON<8, 4>(v)));
+  const uint8x8_t g = vbsl_u8(opaque, Convert5To8_NEON(GetBits_NEON<5, 5>(v)),
+                              Convert4To8_NEON(GetBits_NEON<4, 4>(v)));
+  const uint8x8_t b = vbsl_u8(opaque, Convert5To8_NEON(GetBits_NEON<0, 5>(v)),
+                              Convert4To8_NEON(GetBits_NEON<0, 4>(v)));
+  StoreRGBA_NEON(dst0, dst1, r, g, b, a);
+}
+
+// The AR halves of the texels are 32 bytes before their GB halves.
+static inline void DecodeRows_RGBA8_NEON(u32* dst0, u32* dst1, const u8* src)
+{
+  const uint8x8x2_t ar = vld2_u8(src);
+  const uint8x8x2_t gb = vld2_u8(src + 32);
+  StoreRGBA_NEON(dst0, dst1, ar.val[1], gb.val[0], gb.val[1], ar.val[0]);
+}
+
+// Looks up the colors of a CMPR sub-block with the same table as DecodeDXTBlock.
+static inline void DecodeDXTIndices_NEON(u32* dst, const DXTBlock* src, const u32* colors,
+                                         int pitch)
+{
+  // Texel x of a row uses bits 6 - 2x of its line byte.
+  alignas(16) static constexpr s8 shifts[16] = {-6, -6, -6, -6, -4, -4, -4, -4,
+                                                -2, -2, -2, -2, 0,  0,  0,  0};
+  alignas(16) static constexpr u8 byte_offsets[16] = {0, 1, 2, 3, 0, 1, 2, 3,
+                                                      0, 1, 2, 3, 0, 1, 2, 3};
+  const uint8x16_t table = vld1q_u8(reinterpret_cast<const u8*>(colors));
+  const int8x16_t shift = vld1q_s8(shifts);
+  const uint8x16_t offset = vld1q_u8(byte_offsets);
+
+  for (int y = 0; y < 4; y++)
+  {
+    const uint8x16_t index = vandq_u8(vshlq_u8(vdupq_n_u8(src->lines[y]), shift), vdupq_n_u8(3));
+    const uint8x16_t bytes = vorrq_u8(vshlq_n_u8(index, 2), offset);
+    vst1q_u8(reinterpret_cast<u8*>(dst), vqtbl1q_u8(table, bytes));
+    dst += pitch;
+  }
+}
+#endif
+
 static void DecodeDXTBlock(u32* dst, const DXTBlock* src, int pitch)
 {
   // S3TC Decoder (Note: GCN decodes differently from PC so we can't use native support)
@@ -172,6 +315,9 @@ static void DecodeDXTBlock(u32* dst, const DXTBlock* src, int pitch)
     colors[3] = MakeRGBA((red1 + red2) / 2, (green1 + green2) / 2, (blue1 + blue2) / 2, 0);
   }
 
+#ifdef _M_ARM_64
+  DecodeDXTIndices_NEON(dst, src, reinterpret_cast<const u32*>(colors), pitch);
+#else
   for (int y = 0; y < 4; y++)
   {
     int val = src->lines[y];
@@ -182,6 +328,7 @@ static void DecodeDXTBlock(u32* dst, const DXTBlock* src, int pitch)
     }
     dst += pitch;
   }
+#endif
 }
 
 // JSD 01/06/11:
@@ -204,13 +351,23 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
   switch (texformat)
   {
   case TextureFormat::C4:
+  {
+    u32 palette[16];
+    DecodePalette(palette, tlut, 16, tlutfmt);
     for (int y = 0; y < height; y += 8)
       for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
         for (int iy = 0, xStep = 8 * yStep; iy < 8; iy++, xStep++)
-          DecodeBytes_C4(dst + (y + iy) * width + x, src + 4 * xStep, tlut, tlutfmt);
-    break;
+          DecodeBytes_C4(dst + (y + iy) * width + x, src + 4 * xStep, palette);
+  }
+  break;
   case TextureFormat::I4:
   {
+#ifdef _M_ARM_64
+    for (int y = 0; y < height; y += 8)
+      for (int x = 0; x < width; x += 8)
+        for (int iy = 0; iy < 8; iy++, src += 4)
+          DecodeRow_I4_NEON(dst + (y + iy) * width + x, src);
+#else
     // Reference C implementation:
     for (int y = 0; y < height; y += 8)
       for (int x = 0; x < width; x += 8)
@@ -223,10 +380,17 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
             memset(dst + (y + iy) * width + x + ix * 2, i1, 4);
             memset(dst + (y + iy) * width + x + ix * 2 + 1, i2, 4);
           }
+#endif
   }
   break;
   case TextureFormat::I8:  // speed critical
   {
+#ifdef _M_ARM_64
+    for (int y = 0; y < height; y += 4)
+      for (int x = 0; x < width; x += 8)
+        for (int iy = 0; iy < 4; ++iy, src += 8)
+          DecodeRow_I8_NEON(dst + (y + iy) * width + x, src);
+#else
     // Reference C implementation
     for (int y = 0; y < height; y += 4)
       for (int x = 0; x < width; x += 8)
@@ -253,24 +417,41 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
           srcval = newsrc[0];
           newdst[0] = srcval | (srcval << 8) | (srcval << 16) | (srcval << 24);
         }
+#endif
   }
   break;
   case TextureFormat::C8:
+  {
+    u32 palette[256];
+    DecodePalette(palette, tlut, 256, tlutfmt);
     for (int y = 0; y < height; y += 4)
       for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
         for (int iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
-          DecodeBytes_C8((u32*)dst + (y + iy) * width + x, src + 8 * xStep, tlut, tlutfmt);
-    break;
+          DecodeBytes_C8((u32*)dst + (y + iy) * width + x, src + 8 * xStep, palette);
+  }
+  break;
   case TextureFormat::IA4:
   {
     for (int y = 0; y < height; y += 4)
       for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
         for (int iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
+        {
+#ifdef _M_ARM_64
+          DecodeRow_IA4_NEON(dst + (y + iy) * width + x, src + 8 * xStep);
+#else
           DecodeBytes_IA4(dst + (y + iy) * width + x, src + 8 * xStep);
+#endif
+        }
   }
   break;
   case TextureFormat::IA8:
   {
+#ifdef _M_ARM_64
+    for (int y = 0; y < height; y += 4)
+      for (int x = 0; x < width; x += 4)
+        for (int iy = 0; iy < 4; iy += 2, src += 16)
+          DecodeRows_IA8_NEON(dst + (y + iy) * width + x, dst + (y + iy + 1) * width + x, src);
+#else
     // Reference C implementation:
     for (int y = 0; y < height; y += 4)
       for (int x = 0; x < width; x += 4)
@@ -283,6 +464,7 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
           ptr[2] = DecodePixel_IA8(s[2]);
           ptr[3] = DecodePixel_IA8(s[3]);
         }
+#endif
   }
   break;
   case TextureFormat::C14X2:
@@ -293,6 +475,12 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
   case TextureFormat::RGB565:
   {
+#ifdef _M_ARM_64
+    for (int y = 0; y < height; y += 4)
+      for (int x = 0; x < width; x += 4)
+        for (int iy = 0; iy < 4; iy += 2, src += 16)
+          DecodeRows_RGB565_NEON(dst + (y + iy) * width + x, dst + (y + iy + 1) * width + x, src);
+#else
     // Reference C implementation.
     for (int y = 0; y < height; y += 4)
       for (int x = 0; x < width; x += 4)
@@ -303,19 +491,36 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
           for (int j = 0; j < 4; j++)
             *ptr++ = DecodePixel_RGB565(Common::swap16(*s++));
         }
+#endif
   }
   break;
   case TextureFormat::RGB5A3:
   {
+#ifdef _M_ARM_64
+    for (int y = 0; y < height; y += 4)
+      for (int x = 0; x < width; x += 4)
+        for (int iy = 0; iy < 4; iy += 2, src += 16)
+          DecodeRows_RGB5A3_NEON(dst + (y + iy) * width + x, dst + (y + iy + 1) * width + x, src);
+#else
     // Reference C implementation:
     for (int y = 0; y < height; y += 4)
       for (int x = 0; x < width; x += 4)
         for (int iy = 0; iy < 4; iy++, src += 8)
           DecodeBytes_RGB5A3(dst + (y + iy) * width + x, (u16*)src);
+#endif
   }
   break;
   case TextureFormat::RGBA8:  // speed critical
   {
+#ifdef _M_ARM_64
+    for (int y = 0; y < height; y += 4)
+      for (int x = 0; x < width; x += 4, src += 64)
+        for (int iy = 0; iy < 4; iy += 2)
+        {
+          DecodeRows_RGBA8_NEON(dst + (y + iy) * width + x, dst + (y + iy + 1) * width + x,
+                                src + iy * 8);
+        }
+#else
     // Reference C implementation.
     for (int y = 0; y < height; y += 4)
       for (int x = 0; x < width; x += 4)
@@ -325,6 +530,7 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
                             (u16*)src + 4 * iy + 16);
         src += 64;
       }
+#endif
   }
   break;
   case TextureFormat::CMPR:  // speed critical
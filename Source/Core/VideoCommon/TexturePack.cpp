@@ -0,0 +1,221 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/TexturePack.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+
+namespace
+{
+constexpr u32 PACK_MAGIC = 0x4B505444;  // "DTPK"
+constexpr u32 PACK_VERSION = 1;
+
+template <typename T>
+void Append(std::vector<u8>* buffer, T value)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  const size_t offset = buffer->size();
+  buffer->resize(offset + sizeof(T));
+  std::memcpy(buffer->data() + offset, &value, sizeof(T));
+}
+
+// Reads values from the mapped file, failing instead of reading out of bounds.
+class Reader
+{
+public:
+  Reader(const u8* data, size_t size, size_t offset) : m_data(data), m_size(size), m_offset(offset)
+  {
+  }
+
+  template <typename T>
+  bool Read(T* value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (m_offset > m_size || m_size - m_offset < sizeof(T))
+      return false;
+    std::memcpy(value, m_data + m_offset, sizeof(T));
+    m_offset += sizeof(T);
+    return true;
+  }
+
+  bool ReadString(std::string* str, size_t length)
+  {
+    if (m_offset > m_size || m_size - m_offset < length)
+      return false;
+    str->assign(reinterpret_cast<const char*>(m_data + m_offset), length);
+    m_offset += length;
+    return true;
+  }
+
+private:
+  const u8* m_data;
+  size_t m_size;
+  size_t m_offset;
+};
+
+bool IsSupportedFormat(AbstractTextureFormat format)
+{
+  switch (format)
+  {
+  case AbstractTextureFormat::RGBA8:
+  case AbstractTextureFormat::BGRA8:
+  case AbstractTextureFormat::DXT1:
+  case AbstractTextureFormat::DXT3:
+  case AbstractTextureFormat::DXT5:
+  case AbstractTextureFormat::BPTC:
+    return true;
+  default:
+    return false;
+  }
+}
+}  // namespace
+
+std::unique_ptr<TexturePack> TexturePack::Open(const std::string& path)
+{
+  auto pack = std::make_unique<TexturePack>();
+  if (!pack->m_file.Open(path))
+  {
+    ERROR_LOG_FMT(VIDEO, "Failed to map texture pack {}", path);
+    return nullptr;
+  }
+
+  if (!pack->ReadIndex())
+  {
+    ERROR_LOG_FMT(VIDEO, "Texture pack {} is invalid", path);
+    return nullptr;
+  }
+
+  return pack;
+}
+
+bool TexturePack::ReadIndex()
+{
+  const u8* data = m_file.GetData();
+  const size_t size = m_file.GetSize();
+
+  Reader header(data, size, 0);
+  u32 magic, version, num_textures, reserved;
+  u64 index_offset;
+  if (!header.Read(&magic) || !header.Read(&version) || !header.Read(&index_offset) ||
+      !header.Read(&num_textures) || !header.Read(&reserved))
+  {
+    return false;
+  }
+  if (magic != PACK_MAGIC || version != PACK_VERSION)
+    return false;
+
+  Reader index(data, size, static_cast<size_t>(index_offset));
+  m_textures.reserve(num_textures);
+  for (u32 i = 0; i < num_textures; i++)
+  {
+    Texture& texture = m_textures.emplace_back();
+
+    u16 name_length;
+    u8 has_arbitrary_mipmaps, num_levels;
+    if (!index.Read(&name_length) || !index.ReadString(&texture.name, name_length) ||
+        !index.Read(&has_arbitrary_mipmaps) || !index.Read(&num_levels) || num_levels == 0)
+    {
+      return false;
+    }
+    texture.has_arbitrary_mipmaps = has_arbitrary_mipmaps != 0;
+
+    texture.levels.resize(num_levels);
+    for (Level& level : texture.levels)
+    {
+      u32 format;
+      if (!index.Read(&format) || !index.Read(&level.width) || !index.Read(&level.height) ||
+          !index.Read(&level.row_length) || !index.Read(&level.offset) || !index.Read(&level.size))
+      {
+        return false;
+      }
+
+      level.format = static_cast<AbstractTextureFormat>(format);
+      if (!IsSupportedFormat(level.format) || level.offset > size ||
+          size - level.offset < level.size)
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool TexturePack::Writer::Open(const std::string& path)
+{
+  m_path = path;
+  m_textures.clear();
+  if (!m_file.Open(path, "wb"))
+    return false;
+
+  // The header is written by Finish, once the index offset is known.
+  const std::vector<u8> padding(PAGE_ALIGNMENT);
+  return m_file.WriteBytes(padding.data(), padding.size());
+}
+
+void TexturePack::Writer::BeginTexture(const std::string& name, bool has_arbitrary_mipmaps)
+{
+  m_textures.push_back({name, has_arbitrary_mipmaps, {}});
+}
+
+bool TexturePack::Writer::AddLevel(AbstractTextureFormat format, u32 width, u32 height,
+                                   u32 row_length, const u8* data, size_t size)
+{
+  const u64 offset = m_file.Tell();
+  m_textures.back().levels.push_back({format, width, height, row_length, offset, size});
+  if (!m_file.WriteBytes(data, size))
+    return false;
+
+  const std::vector<u8> padding((PAGE_ALIGNMENT - size % PAGE_ALIGNMENT) % PAGE_ALIGNMENT);
+  return m_file.WriteBytes(padding.data(), padding.size());
+}
+
+bool TexturePack::Writer::Finish()
+{
+  std::vector<u8> index;
+  for (const Texture& texture : m_textures)
+  {
+    Append(&index, static_cast<u16>(texture.name.size()));
+    index.insert(index.end(), texture.name.begin(), texture.name.end());
+    Append(&index, static_cast<u8>(texture.has_arbitrary_mipmaps));
+    Append(&index, static_cast<u8>(texture.levels.size()));
+    for (const Level& level : texture.levels)
+    {
+      Append(&index, static_cast<u32>(level.format));
+      Append(&index, level.width);
+      Append(&index, level.height);
+      Append(&index, level.row_length);
+      Append(&index, level.offset);
+      Append(&index, level.size);
+    }
+  }
+
+  std::vector<u8> header;
+  Append(&header, PACK_MAGIC);
+  Append(&header, PACK_VERSION);
+  Append(&header, m_file.Tell());
+  Append(&header, static_cast<u32>(m_textures.size()));
+  Append(&header, u32(0));
+
+  if (!m_file.WriteBytes(index.data(), index.size()) || !m_file.Seek(0, SEEK_SET) ||
+      !m_file.WriteBytes(header.data(), header.size()))
+  {
+    return false;
+  }
+
+  return m_file.Close();
+}
+
+void TexturePack::Writer::Discard()
+{
+  m_file.Close();
+  File::Delete(m_path);
+}
@@ -0,0 +1,80 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+#include "Common/MappedFile.h"
+#include "VideoCommon/TextureConfig.h"
+
+// A single file holding the custom textures of a game, so that huge texture packs don't have to be
+// searched for and decoded one file at a time. All levels are stored in the format they are
+// uploaded in, at page aligned offsets, and the file is mapped into memory so that the levels can
+// be uploaded straight from there.
+//
+// Layout, all values little endian:
+//   header:  magic, version, index offset (u64), number of textures
+//   data:    the levels, each one aligned to PAGE_ALIGNMENT
+//   index:   for each texture its name, the arbitrary mipmaps flag and its levels
+class TexturePack
+{
+public:
+  static constexpr const char* EXTENSION = ".texpack";
+  static constexpr u64 PAGE_ALIGNMENT = 4096;
+
+  struct Level
+  {
+    AbstractTextureFormat format;
+    u32 width;
+    u32 height;
+    u32 row_length;
+    u64 offset;
+    u64 size;
+  };
+
+  struct Texture
+  {
+    std::string name;
+    bool has_arbitrary_mipmaps;
+    std::vector<Level> levels;
+  };
+
+  // Returns nullptr if the file can't be mapped or isn't a valid texture pack.
+  static std::unique_ptr<TexturePack> Open(const std::string& path);
+
+  const std::vector<Texture>& GetTextures() const { return m_textures; }
+  const u8* GetLevelData(const Level& level) const { return m_file.GetData() + level.offset; }
+
+  class Writer
+  {
+  public:
+    bool Open(const std::string& path);
+
+    // The levels added after this belong to the given texture.
+    void BeginTexture(const std::string& name, bool has_arbitrary_mipmaps);
+    bool AddLevel(AbstractTextureFormat format, u32 width, u32 height, u32 row_length,
+                  const u8* data, size_t size);
+
+    // Writes the index. Until this succeeded, the file is not a valid texture pack.
+    bool Finish();
+    // Deletes the incomplete file.
+    void Discard();
+
+  private:
+    std::string m_path;
+    File::IOFile m_file;
+    std::vector<Texture> m_textures;
+  };
+
+private:
+  bool ReadIndex();
+
+  File::MappedFile m_file;
+  std::vector<Texture> m_textures;
+};
@@ -35,6 +35,19 @@ PixelShaderUid GetPixelShaderUid()
   return out;
 }
 
+PixelShaderUid GetSpecializedPixelShaderUid()
+{
+  PixelShaderUid out = GetPixelShaderUid();
+
+  pixel_ubershader_uid_data* const uid_data = out.GetUidData();
+  uid_data->specialized = 1;
+  uid_data->num_stages = bpmem.genMode.numtevstages;
+  uid_data->alpha_test = bpmem.alpha_test.TestResult() != AlphaTest::PASS;
+  uid_data->fog = bpmem.fog.c_proj_fsel.fsel != 0;
+
+  return out;
+}
+
 void ClearUnusedPixelShaderUidBits(APIType ApiType, const ShaderHostConfig& host_config,
                                    PixelShaderUid* uid)
 {
@@ -60,10 +73,16 @@ ShaderCode GenPixelShader(APIType ApiType, const ShaderHostConfig& host_config,
   const bool per_pixel_depth = uid_data->per_pixel_depth != 0;
   const bool bounding_box = host_config.bounding_box;
   const u32 numTexgen = uid_data->num_texgens;
+  const bool specialized = uid_data->specialized != 0;
   ShaderCode out;
 
   out.Write("// Pixel UberShader for {} texgens{}{}\n", numTexgen,
             early_depth ? ", early-depth" : "", per_pixel_depth ? ", per-pixel depth" : "");
+  if (specialized)
+  {
+    out.Write("// Specialized for {} TEV stages{}{}\n", uid_data->num_stages + 1,
+              uid_data->alpha_test ? ", alpha test" : "", uid_data->fog ? ", fog" : "");
+  }
   WritePixelShaderCommonHeader(out, ApiType, numTexgen, host_config, bounding_box);
   WriteUberShaderCommonHeader(out, ApiType, host_config);
   if (per_pixel_lighting)
@@ -764,8 +783,16 @@ ShaderCode GenPixelShader(APIType ApiType, const ShaderHostConfig& host_config,
     color_input_prefix = "lit_";
   }
 
-  out.Write("  uint num_stages = {};\n\n",
-            BitfieldExtract("bpmem_genmode", bpmem.genMode.numtevstages));
+  // A constant stage count lets the driver drop the loop bookkeeping which doesn't depend on it.
+  if (specialized)
+  {
+    out.Write("  uint num_stages = {}u;\n\n", uid_data->num_stages);
+  }
+  else
+  {
+    out.Write("  uint num_stages = {};\n\n",
+              BitfieldExtract("bpmem_genmode", bpmem.genMode.numtevstages));
+  }
 
   out.Write("  // Main tev loop\n");
   if (ApiType == APIType::D3D)
@@ -1114,9 +1141,11 @@ ShaderCode GenPixelShader(APIType ApiType, const ShaderHostConfig& host_config,
       out.Write("  depth = float(zbuffer_zCoord) / 16777216.0;\n");
   }
 
+  // Constant conditions for the alpha test and fog let the driver remove them entirely.
   out.Write("  // Alpha Test\n"
-            "  if (bpmem_alphaTest != 0u) {{\n"
+            "  if ({}) {{\n"
             "    bool comp0 = alphaCompare(TevResult.a, " I_ALPHA ".r, {});\n",
+            specialized && !uid_data->alpha_test ? "false" : "bpmem_alphaTest != 0u",
             BitfieldExtract("bpmem_alphaTest", AlphaTest().comp0));
   out.Write("    bool comp1 = alphaCompare(TevResult.a, " I_ALPHA ".g, {});\n",
             BitfieldExtract("bpmem_alphaTest", AlphaTest().comp1));
@@ -1156,7 +1185,8 @@ ShaderCode GenPixelShader(APIType ApiType, const ShaderHostConfig& host_config,
   //        Should be fixed point, and should not make guesses about Range-Based adjustments.
   out.Write("  // Fog\n"
             "  uint fog_function = {};\n",
-            BitfieldExtract("bpmem_fogParam3", FogParam3().fsel));
+            specialized && !uid_data->fog ? std::string("0u") :
+                                            BitfieldExtract("bpmem_fogParam3", FogParam3().fsel));
   out.Write("  if (fog_function != 0u) {{\n"
             "    // TODO: This all needs to be converted from float to fixed point\n"
             "    float ze;\n"
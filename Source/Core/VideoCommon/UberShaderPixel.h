@@ -20,6 +20,13 @@ struct pixel_ubershader_uid_data
   u32 per_pixel_depth : 1;
   u32 uint_output : 1;
 
+  // Specialized ubershaders bake the most expensive parts of the TEV configuration in, and are
+  // only valid for draws with a matching configuration. These are zero for generic ubershaders.
+  u32 specialized : 1;
+  u32 num_stages : 4;
+  u32 alpha_test : 1;
+  u32 fog : 1;
+
   u32 NumValues() const { return sizeof(pixel_ubershader_uid_data); }
 };
 #pragma pack()
@@ -28,6 +35,10 @@ using PixelShaderUid = ShaderUid<pixel_ubershader_uid_data>;
 
 PixelShaderUid GetPixelShaderUid();
 
+// Returns the UID of an ubershader specialized for the current TEV stage count, alpha test and
+// fog state, which can replace the generic ubershader once it has been compiled.
+PixelShaderUid GetSpecializedPixelShaderUid();
+
 ShaderCode GenPixelShader(APIType ApiType, const ShaderHostConfig& host_config,
                           const pixel_ubershader_uid_data* uid_data);
 
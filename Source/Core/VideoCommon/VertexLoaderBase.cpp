@@ -30,6 +30,12 @@ VertexLoaderBase::VertexLoaderBase(const TVtxDesc& vtx_desc, const VAT& vtx_attr
     : m_VtxDesc{vtx_desc}, m_vat{vtx_attr}
 {
   SetVAT(vtx_attr);
+
+  for (int i = 0; i < 12; i++)
+  {
+    if (m_VtxDesc.GetVertexArrayStatus(i) & MASK_INDEXED)
+      m_has_indexed_attributes = true;
+  }
 }
 
 void VertexLoaderBase::SetVAT(const VAT& vat)
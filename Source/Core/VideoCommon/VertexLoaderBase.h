@@ -76,17 +76,20 @@ public:
   int m_VertexSize = 0;  // number of bytes of a raw GC vertex
   PortableVertexDeclaration m_native_vtx_decl{};
   u32 m_native_components = 0;
+  // If set, the output depends on the vertex arrays in RAM, not just the input data.
+  bool m_has_indexed_attributes = false;
 
   // used by VertexLoaderManager
   NativeVertexFormat* m_native_vertex_format = nullptr;
   int m_numLoadedVertices = 0;
 
+  // GC vertex format
+  TVtxDesc m_VtxDesc;
+  VAT m_vat;
+
 protected:
   VertexLoaderBase(const TVtxDesc& vtx_desc, const VAT& vtx_attr);
   void SetVAT(const VAT& vat);
 
-  // GC vertex format
   TVtxAttr m_VtxAttr;  // VAT decoded into easy format
-  TVtxDesc m_VtxDesc;  // Not really used currently - or well it is, but could be easily avoided.
-  VAT m_vat;
 };
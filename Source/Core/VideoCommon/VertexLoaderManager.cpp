@@ -5,6 +5,8 @@
 #include "VideoCommon/VertexLoaderManager.h"
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <mutex>
@@ -15,11 +17,19 @@
 
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "Common/MathUtil.h"
+#include "Core/ConfigManager.h"
 #include "Core/HW/Memmap.h"
 
+#include <xxhash.h>
+
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/NativeVertexFormat.h"
 #include "VideoCommon/RenderBase.h"
@@ -27,6 +37,7 @@
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
+#include "VideoCommon/VideoConfig.h"
 
 namespace VertexLoaderManager
 {
@@ -39,14 +50,209 @@ u32 position_matrix_index[4];
 static NativeVertexFormatMap s_native_vertex_map;
 static NativeVertexFormat* s_current_vtx_fmt;
 u32 g_current_components;
+bool g_skip_vertex_loading = false;
 
 typedef std::unordered_map<VertexLoaderUID, std::unique_ptr<VertexLoaderBase>> VertexLoaderMap;
 static std::mutex s_vertex_loader_map_lock;
 static VertexLoaderMap s_vertex_loader_map;
-// TODO - change into array of pointers. Keep a map of all seen so far.
+
+// Games switch between a handful of vertex formats all the time, so each of the main and
+// preprocessing CP states keeps the loaders it used recently, to avoid taking the map lock.
+namespace
+{
+struct RecentLoader
+{
+  VertexLoaderUID uid;
+  VertexLoaderBase* loader = nullptr;
+};
+constexpr size_t NUM_RECENT_LOADERS = 16;
+}  // Anonymous namespace
+static std::array<RecentLoader, NUM_RECENT_LOADERS> s_recent_loaders[2];
+
+// Vertex formats are stored as their raw VCD and VAT register values.
+namespace
+{
+struct SerializedVertexLoaderUID
+{
+  u32 vtx_desc[2];
+  u32 vat[3];
+};
+constexpr u32 VERTEX_LOADER_UID_CACHE_MAGIC = 0x4955564C;  // LVUI
+constexpr u32 VERTEX_LOADER_UID_CACHE_VERSION = 1;
+}  // Anonymous namespace
+static File::IOFile s_vertex_loader_uid_cache_file;
+static size_t s_num_precompiled_loaders;
 
 u8* cached_arraybases[12];
 
+// Games tend to call the same display lists every frame, so keep the converted vertices of the
+// primitives in them around instead of running the vertex loader again. Only primitives without
+// indexed attributes are cached, since their output only depends on the source data and the
+// loader. Entries are keyed by a hash of both, so modified display lists simply miss.
+namespace
+{
+struct CachedVertices
+{
+  VertexLoaderBase* loader = nullptr;
+  int source_size = 0;
+  // Empty until the primitive was seen a second time, so one-off data isn't copied around.
+  std::vector<u8> data;
+  int count = 0;
+  // The loader's side effects, used for zfreeze.
+  float position_cache[3][4];
+  u32 position_matrix_index[4];
+};
+
+// Smaller primitives aren't worth the lookup.
+constexpr int MIN_CACHED_VERTICES = 16;
+constexpr size_t MAX_CACHED_VERTEX_BYTES = 32 * 1024 * 1024;
+constexpr size_t MAX_CACHED_VERTEX_ENTRIES = 64 * 1024;
+}  // Anonymous namespace
+
+static std::unordered_map<u64, CachedVertices> s_display_list_vertex_cache;
+static size_t s_display_list_vertex_cache_bytes;
+
+static void ClearDisplayListVertexCache()
+{
+  s_display_list_vertex_cache.clear();
+  s_display_list_vertex_cache_bytes = 0;
+}
+
+static int RunVerticesCached(VertexLoaderBase* loader, DataReader src, DataReader dst, int count,
+                             int size)
+{
+  const u64 hash = XXH64(src.GetPointer(), size, reinterpret_cast<uintptr_t>(loader));
+  if (s_display_list_vertex_cache.size() >= MAX_CACHED_VERTEX_ENTRIES)
+    ClearDisplayListVertexCache();
+
+  auto [iter, inserted] = s_display_list_vertex_cache.try_emplace(hash);
+  CachedVertices& entry = iter->second;
+  const bool seen_before = !inserted && entry.loader == loader && entry.source_size == size;
+  if (seen_before && !entry.data.empty())
+  {
+    std::memcpy(dst.GetPointer(), entry.data.data(), entry.data.size());
+    std::memcpy(position_cache, entry.position_cache, sizeof(position_cache));
+    std::memcpy(position_matrix_index, entry.position_matrix_index, sizeof(position_matrix_index));
+    loader->m_numLoadedVertices += count;
+    return entry.count;
+  }
+
+  const size_t max_bytes = static_cast<size_t>(count) * loader->m_native_vtx_decl.stride;
+  if (!seen_before || s_display_list_vertex_cache_bytes + max_bytes > MAX_CACHED_VERTEX_BYTES)
+  {
+    if (!seen_before)
+    {
+      entry.loader = loader;
+      entry.source_size = size;
+      entry.data.clear();
+    }
+    return loader->RunVertices(src, dst, count);
+  }
+
+  // The destination is usually write-combined GPU memory, which is very slow to read back, so
+  // convert into the cache and copy from there instead. The loader may write up to 4 bytes past
+  // the end.
+  entry.data.resize(max_bytes + 4);
+  const DataReader cache_dst(entry.data.data(), entry.data.data() + entry.data.size());
+  const int loaded = loader->RunVertices(src, cache_dst, count);
+  const size_t bytes = static_cast<size_t>(loaded) * loader->m_native_vtx_decl.stride;
+  entry.data.resize(bytes);
+  std::memcpy(dst.GetPointer(), entry.data.data(), bytes);
+  entry.count = loaded;
+  std::memcpy(entry.position_cache, position_cache, sizeof(position_cache));
+  std::memcpy(entry.position_matrix_index, position_matrix_index, sizeof(position_matrix_index));
+  s_display_list_vertex_cache_bytes += bytes;
+  return loaded;
+}
+
+// GX has no index buffers, every vertex of a primitive holds its own set of indices into the
+// attribute arrays. Meshes drawn as lists share most of their vertices, so for large primitives with
+// indexed attributes, identical vertices are only loaded once and referenced through remapped
+// indices, which saves both vertex loading and vertex shader work.
+namespace
+{
+constexpr int MIN_DEDUPLICATED_VERTICES = 64;
+// zfreeze relies on the loader's side effects from the last vertices of a primitive, so they're
+// always loaded, in order.
+constexpr int NUM_TRAILING_VERTICES = 3;
+}  // Anonymous namespace
+
+static std::vector<u8> s_unique_vertex_data;
+static std::vector<u16> s_vertex_remap;
+static std::vector<u32> s_vertex_hash_table;
+
+static u32 HashVertex(const u8* data, u32 size)
+{
+  u64 hash = size;
+  u32 offset = 0;
+  for (; offset + sizeof(u64) <= size; offset += sizeof(u64))
+  {
+    u64 chunk;
+    std::memcpy(&chunk, data + offset, sizeof(chunk));
+    hash = (hash ^ chunk) * 0x9E3779B97F4A7C15ULL;
+  }
+  for (; offset < size; ++offset)
+    hash = (hash ^ data[offset]) * 0x9E3779B97F4A7C15ULL;
+  return static_cast<u32>(hash >> 32);
+}
+
+static int RunVerticesDeduplicated(VertexLoaderBase* loader, int primitive, DataReader src,
+                                   DataReader dst, int count)
+{
+  const u32 vertex_size = loader->m_VertexSize;
+  const u8* const source = src.GetPointer();
+
+  s_unique_vertex_data.resize(static_cast<size_t>(count) * vertex_size);
+  s_vertex_remap.resize(count);
+  const u32 table_mask = MathUtil::NextPowerOf2(static_cast<u32>(count) * 2) - 1;
+  s_vertex_hash_table.assign(table_mask + 1, 0);
+
+  // The hash table holds 1 + the unique index of each vertex, 0 marks empty slots.
+  u32 num_unique = 0;
+  const auto add_unique = [&](const u8* vertex) {
+    std::memcpy(&s_unique_vertex_data[num_unique * vertex_size], vertex, vertex_size);
+    return num_unique++;
+  };
+  for (int i = 0; i < count - NUM_TRAILING_VERTICES; ++i)
+  {
+    const u8* const vertex = source + i * vertex_size;
+    u32 slot = HashVertex(vertex, vertex_size) & table_mask;
+    while (true)
+    {
+      const u32 entry = s_vertex_hash_table[slot];
+      if (entry == 0)
+      {
+        s_vertex_remap[i] = add_unique(vertex);
+        s_vertex_hash_table[slot] = num_unique;
+        break;
+      }
+      if (std::memcmp(&s_unique_vertex_data[(entry - 1) * vertex_size], vertex, vertex_size) == 0)
+      {
+        s_vertex_remap[i] = entry - 1;
+        break;
+      }
+      slot = (slot + 1) & table_mask;
+    }
+  }
+  for (int i = std::max(count - NUM_TRAILING_VERTICES, 0); i < count; ++i)
+    s_vertex_remap[i] = add_unique(source + i * vertex_size);
+
+  u8* const unique_data = s_unique_vertex_data.data();
+  const int loaded =
+      loader->RunVertices(DataReader(unique_data, unique_data + num_unique * vertex_size), dst,
+                          static_cast<int>(num_unique));
+  if (loaded != static_cast<int>(num_unique))
+  {
+    // Vertices were skipped, which the remapping can't account for. Load them the usual way.
+    const int reloaded = loader->RunVertices(src, dst, count);
+    g_vertex_manager->AddIndices(primitive, reloaded);
+    return reloaded;
+  }
+
+  g_vertex_manager->AddRemappedIndices(primitive, count, s_vertex_remap.data(), num_unique);
+  return loaded;
+}
+
 void Init()
 {
   MarkAllDirty();
@@ -60,6 +266,9 @@ void Init()
 void Clear()
 {
   std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
+  for (auto& recent_loaders : s_recent_loaders)
+    recent_loaders = {};
+  ClearDisplayListVertexCache();
   s_vertex_loader_map.clear();
   s_native_vertex_map.clear();
 }
@@ -198,6 +407,117 @@ NativeVertexFormat* GetUberVertexFormat(const PortableVertexDeclaration& decl)
   return GetOrCreateMatchingFormat(new_decl);
 }
 
+static void AppendVertexLoaderUID(const TVtxDesc& vtx_desc, const VAT& vat)
+{
+  if (!s_vertex_loader_uid_cache_file.IsOpen())
+    return;
+
+  const SerializedVertexLoaderUID disk_uid = {
+      {static_cast<u32>(vtx_desc.Hex), static_cast<u32>(vtx_desc.Hex >> 32)},
+      {vat.g0.Hex, vat.g1.Hex, vat.g2.Hex}};
+  if (!s_vertex_loader_uid_cache_file.WriteBytes(&disk_uid, sizeof(disk_uid)))
+  {
+    WARN_LOG_FMT(VIDEO, "Writing vertex loader UID to cache failed, closing file.");
+    s_vertex_loader_uid_cache_file.Close();
+  }
+}
+
+// Must be called with s_vertex_loader_map_lock held.
+static VertexLoaderBase* GetOrCreateLoader(const VertexLoaderUID& uid, const TVtxDesc& vtx_desc,
+                                           const VAT& vat)
+{
+  std::unique_ptr<VertexLoaderBase>& loader = s_vertex_loader_map[uid];
+  if (!loader)
+  {
+    loader = VertexLoaderBase::CreateVertexLoader(vtx_desc, vat);
+    INCSTAT(g_stats.num_vertex_loaders);
+    AppendVertexLoaderUID(vtx_desc, vat);
+  }
+  return loader.get();
+}
+
+void LoadVertexLoaderUIDCache()
+{
+  const std::string filename =
+      File::GetUserPath(D_CACHE_IDX) + SConfig::GetInstance().GetGameID() + ".vtxuidcache";
+  std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
+
+  std::vector<SerializedVertexLoaderUID> disk_uids;
+  if (s_vertex_loader_uid_cache_file.Open(filename, "rb+"))
+  {
+    constexpr size_t header_size = 2 * sizeof(u32);
+    u32 magic;
+    u32 version;
+    const u64 file_size = s_vertex_loader_uid_cache_file.GetSize();
+    const size_t uid_count =
+        static_cast<size_t>(file_size - header_size) / sizeof(SerializedVertexLoaderUID);
+    const size_t expected_size = uid_count * sizeof(SerializedVertexLoaderUID) + header_size;
+    disk_uids.resize(uid_count);
+
+    // Treat a truncated or otherwise corrupted file as empty, and recreate it below.
+    const bool valid =
+        file_size == expected_size && s_vertex_loader_uid_cache_file.ReadBytes(&magic, 4) &&
+        s_vertex_loader_uid_cache_file.ReadBytes(&version, 4) &&
+        magic == VERTEX_LOADER_UID_CACHE_MAGIC && version == VERTEX_LOADER_UID_CACHE_VERSION &&
+        s_vertex_loader_uid_cache_file.ReadArray(disk_uids.data(), disk_uids.size()) &&
+        s_vertex_loader_uid_cache_file.Seek(expected_size, SEEK_SET);
+    if (!valid)
+    {
+      disk_uids.clear();
+      s_vertex_loader_uid_cache_file.Close();
+    }
+  }
+
+  // The file may get written to while creating the loaders, so open it first.
+  if (!s_vertex_loader_uid_cache_file.IsOpen() &&
+      s_vertex_loader_uid_cache_file.Open(filename, "wb"))
+  {
+    s_vertex_loader_uid_cache_file.WriteBytes(&VERTEX_LOADER_UID_CACHE_MAGIC, sizeof(u32));
+    s_vertex_loader_uid_cache_file.WriteBytes(&VERTEX_LOADER_UID_CACHE_VERSION, sizeof(u32));
+    for (const auto& [uid, loader] : s_vertex_loader_map)
+      AppendVertexLoaderUID(loader->m_VtxDesc, loader->m_vat);
+  }
+
+  for (const SerializedVertexLoaderUID& disk_uid : disk_uids)
+  {
+    TVtxDesc vtx_desc;
+    vtx_desc.Hex = disk_uid.vtx_desc[0] | (static_cast<u64>(disk_uid.vtx_desc[1]) << 32);
+    VAT vat;
+    vat.g0.Hex = disk_uid.vat[0];
+    vat.g1.Hex = disk_uid.vat[1];
+    vat.g2.Hex = disk_uid.vat[2];
+
+    const VertexLoaderUID uid(vtx_desc, vat);
+    if (s_vertex_loader_map.count(uid) != 0)
+      continue;
+
+    // Don't append what's already in the file.
+    std::unique_ptr<VertexLoaderBase>& loader = s_vertex_loader_map[uid];
+    loader = VertexLoaderBase::CreateVertexLoader(vtx_desc, vat);
+    INCSTAT(g_stats.num_vertex_loaders);
+    loader->m_native_vertex_format = GetOrCreateMatchingFormat(loader->m_native_vtx_decl);
+    s_num_precompiled_loaders++;
+  }
+
+  INFO_LOG_FMT(VIDEO, "Created {} vertex loaders from {}", s_num_precompiled_loaders, filename);
+}
+
+void CloseVertexLoaderUIDCache()
+{
+  std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
+  if (s_num_precompiled_loaders != 0)
+  {
+    const size_t used = std::count_if(s_vertex_loader_map.begin(), s_vertex_loader_map.end(),
+                                      [](const auto& entry) {
+                                        return entry.second->m_numLoadedVertices != 0;
+                                      });
+    INFO_LOG_FMT(VIDEO, "{} of {} vertex loaders were used, {} were created at boot", used,
+                 s_vertex_loader_map.size(), s_num_precompiled_loaders);
+  }
+  s_num_precompiled_loaders = 0;
+  s_vertex_loader_uid_cache_file.Close();
+}
+
 static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = false)
 {
   CPState* state = preprocess ? &g_preprocess_cp_state : &g_main_cp_state;
@@ -210,29 +530,27 @@ static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = fal
     // thread
     bool check_for_native_format = !preprocess;
 
-    VertexLoaderUID uid(state->vtx_desc, state->vtx_attr[vtx_attr_group]);
-    std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
-    VertexLoaderMap::iterator iter = s_vertex_loader_map.find(uid);
-    if (iter != s_vertex_loader_map.end())
+    const VertexLoaderUID uid(state->vtx_desc, state->vtx_attr[vtx_attr_group]);
+    RecentLoader& recent = s_recent_loaders[preprocess][uid.GetHash() % NUM_RECENT_LOADERS];
+    if (recent.loader && recent.uid == uid &&
+        (!check_for_native_format || recent.loader->m_native_vertex_format))
     {
-      loader = iter->second.get();
-      check_for_native_format &= !loader->m_native_vertex_format;
+      loader = recent.loader;
     }
     else
     {
-      s_vertex_loader_map[uid] =
-          VertexLoaderBase::CreateVertexLoader(state->vtx_desc, state->vtx_attr[vtx_attr_group]);
-      loader = s_vertex_loader_map[uid].get();
-      INCSTAT(g_stats.num_vertex_loaders);
-    }
-    if (check_for_native_format)
-    {
-      // search for a cached native vertex format
-      const PortableVertexDeclaration& format = loader->m_native_vtx_decl;
-      std::unique_ptr<NativeVertexFormat>& native = s_native_vertex_map[format];
-      if (!native)
-        native = g_renderer->CreateNativeVertexFormat(format);
-      loader->m_native_vertex_format = native.get();
+      std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
+      loader = GetOrCreateLoader(uid, state->vtx_desc, state->vtx_attr[vtx_attr_group]);
+      if (check_for_native_format && !loader->m_native_vertex_format)
+      {
+        // search for a cached native vertex format
+        const PortableVertexDeclaration& format = loader->m_native_vtx_decl;
+        std::unique_ptr<NativeVertexFormat>& native = s_native_vertex_map[format];
+        if (!native)
+          native = g_renderer->CreateNativeVertexFormat(format);
+        loader->m_native_vertex_format = native.get();
+      }
+      recent = {uid, loader};
     }
     state->vertex_loaders[vtx_attr_group] = loader;
     state->attr_dirty[vtx_attr_group] = false;
@@ -249,7 +567,8 @@ static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = fal
   return loader;
 }
 
-int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess)
+int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess,
+                bool in_display_list)
 {
   if (!count)
     return 0;
@@ -263,6 +582,15 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   if (is_preprocess)
     return size;
 
+  if (g_skip_vertex_loading)
+  {
+    ADDSTAT(g_stats.this_frame.num_prims, count);
+    INCSTAT(g_stats.this_frame.num_primitive_joins);
+    return size;
+  }
+
+  const FrameProfiler::ScopedSection profiler_section(FrameProfiler::Section::VertexLoading);
+
   // If the native vertex format changed, force a flush.
   if (loader->m_native_vertex_format != s_current_vtx_fmt ||
       loader->m_native_components != g_current_components)
@@ -281,9 +609,20 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   DataReader dst = g_vertex_manager->PrepareForAdditionalData(
       primitive, count, loader->m_native_vtx_decl.stride, cullall);
 
-  count = loader->RunVertices(src, dst, count);
+  if (loader->m_has_indexed_attributes && count >= MIN_DEDUPLICATED_VERTICES &&
+      g_ActiveConfig.bDeduplicateIndexedVertices)
+  {
+    count = RunVerticesDeduplicated(loader, primitive, src, dst, count);
+  }
+  else
+  {
+    if (in_display_list && count >= MIN_CACHED_VERTICES && !loader->m_has_indexed_attributes)
+      count = RunVerticesCached(loader, src, dst, count, size);
+    else
+      count = loader->RunVertices(src, dst, count);
 
-  g_vertex_manager->AddIndices(primitive, count);
+    g_vertex_manager->AddIndices(primitive, count);
+  }
   g_vertex_manager->FlushData(count, loader->m_native_vtx_decl.stride);
 
   ADDSTAT(g_stats.this_frame.num_prims, count);
@@ -302,6 +641,24 @@ void LoadCPReg(u32 sub_cmd, u32 value, bool is_preprocess)
 {
   bool update_global_state = !is_preprocess;
   CPState* state = is_preprocess ? &g_preprocess_cp_state : &g_main_cp_state;
+
+  // Games set up the vertex format before every draw, mostly without changing it. Only changes
+  // make the vertex loaders be looked up again.
+  const auto set_vtx_desc = [state](u64 vtx_desc) {
+    if (state->vtx_desc.Hex == vtx_desc)
+      return;
+    state->vtx_desc.Hex = vtx_desc;
+    state->attr_dirty = BitSet32::AllTrue(8);
+    state->bases_dirty = true;
+  };
+  const auto set_vtx_attr = [state, sub_cmd](u32& group, u32 new_value) {
+    ASSERT((sub_cmd & 0x0F) < 8);
+    if (group == new_value)
+      return;
+    group = new_value;
+    state->attr_dirty[sub_cmd & 7] = true;
+  };
+
   switch (sub_cmd & 0xF0)
   {
   case 0x30:
@@ -315,42 +672,38 @@ void LoadCPReg(u32 sub_cmd, u32 value, bool is_preprocess)
     break;
 
   case 0x50:
-    state->vtx_desc.Hex &= ~0x1FFFF;  // keep the Upper bits
-    state->vtx_desc.Hex |= value;
-    state->attr_dirty = BitSet32::AllTrue(8);
-    state->bases_dirty = true;
+    // keep the Upper bits
+    set_vtx_desc((state->vtx_desc.Hex & ~0x1FFFF) | value);
     break;
 
   case 0x60:
-    state->vtx_desc.Hex &= 0x1FFFF;  // keep the lower 17Bits
-    state->vtx_desc.Hex |= (u64)value << 17;
-    state->attr_dirty = BitSet32::AllTrue(8);
-    state->bases_dirty = true;
+    // keep the lower 17Bits
+    set_vtx_desc((state->vtx_desc.Hex & 0x1FFFF) | (u64)value << 17);
     break;
 
   case 0x70:
-    ASSERT((sub_cmd & 0x0F) < 8);
-    state->vtx_attr[sub_cmd & 7].g0.Hex = value;
-    state->attr_dirty[sub_cmd & 7] = true;
+    set_vtx_attr(state->vtx_attr[sub_cmd & 7].g0.Hex, value);
     break;
 
   case 0x80:
-    ASSERT((sub_cmd & 0x0F) < 8);
-    state->vtx_attr[sub_cmd & 7].g1.Hex = value;
-    state->attr_dirty[sub_cmd & 7] = true;
+    set_vtx_attr(state->vtx_attr[sub_cmd & 7].g1.Hex, value);
     break;
 
   case 0x90:
-    ASSERT((sub_cmd & 0x0F) < 8);
-    state->vtx_attr[sub_cmd & 7].g2.Hex = value;
-    state->attr_dirty[sub_cmd & 7] = true;
+    set_vtx_attr(state->vtx_attr[sub_cmd & 7].g2.Hex, value);
     break;
 
   // Pointers to vertex arrays in GC RAM
   case 0xA0:
-    state->array_bases[sub_cmd & 0xF] = value & CommandProcessor::GetPhysicalAddressMask();
-    state->bases_dirty = true;
+  {
+    const u32 base = value & CommandProcessor::GetPhysicalAddressMask();
+    if (state->array_bases[sub_cmd & 0xF] != base)
+    {
+      state->array_bases[sub_cmd & 0xF] = base;
+      state->bases_dirty = true;
+    }
     break;
+  }
 
   case 0xB0:
     state->array_strides[sub_cmd & 0xF] = value & 0xFF;
@@ -34,8 +34,14 @@ NativeVertexFormat* GetOrCreateMatchingFormat(const PortableVertexDeclaration& d
 // offsets set to the unused attributes.
 NativeVertexFormat* GetUberVertexFormat(const PortableVertexDeclaration& decl);
 
+// Loads the vertex formats the current game used in previous sessions and creates their loaders
+// and native vertex formats up front. New formats are appended to the file as they're seen.
+void LoadVertexLoaderUIDCache();
+void CloseVertexLoaderUIDCache();
+
 // Returns -1 if buf_size is insufficient, else the amount of bytes consumed
-int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess);
+int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess,
+                bool in_display_list);
 
 // For debugging
 std::string VertexLoadersToString();
@@ -51,6 +57,10 @@ void UpdateVertexArrayPointers();
 extern float position_cache[3][4];
 extern u32 position_matrix_index[4];
 
+// When set, vertices are only parsed, neither loaded nor drawn. Used by the parse-only benchmark
+// mode of the Null backend.
+extern bool g_skip_vertex_loading;
+
 // VB_HAS_X. Bitmask telling what vertex components are present.
 extern u32 g_current_components;
 }  // namespace VertexLoaderManager
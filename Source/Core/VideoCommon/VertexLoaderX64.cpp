@@ -55,6 +55,23 @@ VertexLoaderX64::VertexLoaderX64(const TVtxDesc& vtx_desc, const VAT& vtx_att)
   JitRegister::Register(region, GetCodePtr(), name.c_str());
 }
 
+OpArg VertexLoaderX64::GetConstant(const void* ptr)
+{
+  for (const auto& [constant, reg] : m_constant_regs)
+  {
+    if (constant == ptr)
+      return R(reg);
+  }
+
+  if (!m_free_constant_regs)
+    return MPIC(ptr);
+
+  const X64Reg reg = static_cast<X64Reg>(XMM0 + *m_free_constant_regs.begin() - 16);
+  m_free_constant_regs[16 + reg - XMM0] = false;
+  m_constant_regs.emplace_back(ptr, reg);
+  return R(reg);
+}
+
 OpArg VertexLoaderX64::GetVertexAddr(int array, u64 attribute)
 {
   OpArg data = MDisp(src_reg, m_src_ofs);
@@ -139,7 +156,7 @@ int VertexLoaderX64::ReadVertex(OpArg data, u64 attribute, int format, int count
     else
       MOVD_xmm(coords, data);
 
-    PSHUFB(coords, MPIC(&shuffle_lut[format][count_in - 1]));
+    PSHUFB(coords, GetConstant(&shuffle_lut[format][count_in - 1]));
 
     // Sign-extend.
     if (format == FORMAT_BYTE)
@@ -236,7 +253,7 @@ int VertexLoaderX64::ReadVertex(OpArg data, u64 attribute, int format, int count
     CVTDQ2PS(coords, R(coords));
 
     if (dequantize && scaling_exponent)
-      MULPS(coords, MPIC(&scale_factors[scaling_exponent]));
+      MULPS(coords, GetConstant(&scale_factors[scaling_exponent]));
   }
 
   switch (count_out)
@@ -402,7 +419,15 @@ void VertexLoaderX64::GenerateVertexLoader()
   if (m_VtxDesc.Position & MASK_INDEXED)
     XOR(32, R(skipped_reg), R(skipped_reg));
 
-  // TODO: load constants into registers outside the main loop
+  // Shuffle masks and scale factors are kept in registers during the main loop. Which ones are
+  // needed is only known once the loop has been generated, so they're loaded by a stub emitted
+  // after it. XMM0 and XMM1 are used as temporaries, and only caller saved registers are used so
+  // that nothing has to be preserved.
+  m_constant_regs.clear();
+  m_free_constant_regs = ABI_ALL_CALLER_SAVED & ABI_ALL_FPRS;
+  m_free_constant_regs[16 + XMM0] = false;
+  m_free_constant_regs[16 + XMM1] = false;
+  FixupBranch load_constants = J(true);
 
   const u8* loop_start = GetCodePtr();
 
@@ -551,6 +576,11 @@ void VertexLoaderX64::GenerateVertexLoader()
     RET();
   }
 
+  SetJumpTarget(load_constants);
+  for (const auto& [constant, reg] : m_constant_regs)
+    MOVAPS(reg, MPIC(constant));
+  JMP(loop_start, true);
+
   m_VertexSize = m_src_ofs;
   m_native_vtx_decl.stride = m_dst_ofs;
 }
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include "Common/CommonTypes.h"
 #include "Common/x64Emitter.h"
 #include "VideoCommon/VertexLoaderBase.h"
@@ -22,6 +25,10 @@ private:
   u32 m_src_ofs = 0;
   u32 m_dst_ofs = 0;
   Gen::FixupBranch m_skip_vertex;
+  // Constants which are kept in registers during the main loop, and the registers still free.
+  std::vector<std::pair<const void*, Gen::X64Reg>> m_constant_regs;
+  BitSet32 m_free_constant_regs;
+  Gen::OpArg GetConstant(const void* ptr);
   Gen::OpArg GetVertexAddr(int array, u64 attribute);
   int ReadVertex(Gen::OpArg data, u64 attribute, int format, int count_in, int count_out,
                  bool dequantize, u8 scaling_exponent, AttributeFormat* native_format);
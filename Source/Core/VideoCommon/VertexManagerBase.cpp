@@ -6,6 +6,7 @@
 
 #include <array>
 #include <cmath>
+#include <cstring>
 #include <memory>
 
 #include "Common/BitSet.h"
@@ -17,9 +18,12 @@
 #include "Core/ConfigManager.h"
 #include "Core/DolphinAnalytics.h"
 
+#include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/FrameProfiler.h"
+#include "VideoCommon/FrameTimeBreakdown.h"
 #include "VideoCommon/FramebufferManager.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/IndexGenerator.h"
@@ -114,11 +118,18 @@ void VertexManagerBase::AddIndices(int primitive, u32 num_vertices)
   m_index_generator.AddIndices(primitive, num_vertices);
 }
 
+void VertexManagerBase::AddRemappedIndices(int primitive, u32 num_vertices, const u16* remap,
+                                           u32 num_unique_vertices)
+{
+  m_index_generator.AddRemappedIndices(primitive, num_vertices, remap, num_unique_vertices);
+}
+
 DataReader VertexManagerBase::PrepareForAdditionalData(int primitive, u32 count, u32 stride,
                                                        bool cullall)
 {
-  // Flush all EFB pokes. Since the buffer is shared, we can't draw pokes+primitives concurrently.
-  g_framebuffer_manager->FlushEFBPokes();
+  // Flush EFB pokes which this draw could touch, so that it sees them. Pokes elsewhere in the EFB
+  // stay batched, and are drawn after the current batch is flushed when they are eventually drawn.
+  g_framebuffer_manager->FlushEFBPokesInRect(BPFunctions::GetNativeScissorRect());
 
   // The SSE vertex loader can write up to 4 bytes past the end
   u32 const needed_vertex_bytes = count * stride + 4;
@@ -279,17 +290,47 @@ void VertexManagerBase::DrawCurrentBatch(u32 base_index, u32 num_indices, u32 ba
   g_renderer->DrawIndexed(base_index, num_indices, base_vertex);
 }
 
+void VertexManagerBase::DiscardBuffer()
+{
+}
+
 void VertexManagerBase::UploadUniforms()
 {
 }
 
 void VertexManagerBase::InvalidateConstants()
 {
+  m_uploaded_constants.valid = false;
   VertexShaderManager::dirty = true;
   GeometryShaderManager::dirty = true;
   PixelShaderManager::dirty = true;
 }
 
+void VertexManagerBase::SkipUnchangedConstants()
+{
+  const auto skip_if_unchanged = [this](bool* dirty, auto& uploaded, const auto& constants) {
+    if (!*dirty)
+      return;
+
+    if (m_uploaded_constants.valid && std::memcmp(&uploaded, &constants, sizeof(constants)) == 0)
+      *dirty = false;
+    else
+      std::memcpy(&uploaded, &constants, sizeof(constants));
+  };
+
+  // Blocks which weren't dirty were uploaded earlier, and are already up to date.
+  if (!m_uploaded_constants.valid)
+    InvalidateConstants();
+
+  skip_if_unchanged(&PixelShaderManager::dirty, m_uploaded_constants.pixel,
+                    PixelShaderManager::constants);
+  skip_if_unchanged(&VertexShaderManager::dirty, m_uploaded_constants.vertex,
+                    VertexShaderManager::constants);
+  skip_if_unchanged(&GeometryShaderManager::dirty, m_uploaded_constants.geometry,
+                    GeometryShaderManager::constants);
+  m_uploaded_constants.valid = true;
+}
+
 void VertexManagerBase::UploadUtilityUniforms(const void* uniforms, u32 uniforms_size)
 {
 }
@@ -361,6 +402,9 @@ void VertexManagerBase::Flush()
 
   m_is_flushed = true;
 
+  // Flushes that happen while loading vertices don't count as vertex loading
+  const FrameProfiler::ScopedSection profiler_section(FrameProfiler::Section::OpcodeDecoding);
+
   if (xfmem.numTexGen.numTexGens != bpmem.genMode.numtexgens ||
       xfmem.numChan.numColorChans != bpmem.genMode.numcolchans)
   {
@@ -384,6 +428,7 @@ void VertexManagerBase::Flush()
           GameQuirk::MISMATCHED_GPU_COLORS_BETWEEN_XF_AND_BP);
     }
 
+    DiscardBuffer();
     return;
   }
 
@@ -480,9 +525,13 @@ void VertexManagerBase::Flush()
     // Same with GPU texture decoding, which uses compute shaders.
     LoadTextures();
 
+    const FrameTimeBreakdown::ScopedCategory breakdown_category(
+        FrameTimeBreakdown::Category::BackendSubmission);
+
     // Now we can upload uniforms, as nothing else will override them.
     GeometryShaderManager::SetConstants();
     PixelShaderManager::SetConstants();
+    SkipUnchangedConstants();
     UploadUniforms();
 
     // Update the pipeline, or compile one if needed.
@@ -496,6 +545,8 @@ void VertexManagerBase::Flush()
 
       DrawCurrentBatch(base_index, num_indices, base_vertex);
       INCSTAT(g_stats.this_frame.num_draw_calls);
+      if (m_current_pipeline_is_uber)
+        INCSTAT(g_stats.this_frame.num_uber_draw_calls);
 
       if (PerfQueryBase::ShouldEmulate())
         g_perf_query->DisableQuery(bpmem.zcontrol.early_ztest ? PQG_ZCOMP_ZCOMPLOC : PQG_ZCOMP);
@@ -506,6 +557,10 @@ void VertexManagerBase::Flush()
       g_framebuffer_manager->FlagPeekCacheAsOutOfDate();
     }
   }
+  else
+  {
+    DiscardBuffer();
+  }
 
   if (xfmem.numTexGen.numTexGens != bpmem.genMode.numtexgens)
   {
@@ -618,6 +673,7 @@ void VertexManagerBase::UpdatePipelineConfig()
   {
     m_current_pipeline_config.ps_uid = ps_uid;
     m_current_uber_pipeline_config.ps_uid = UberShader::GetPixelShaderUid();
+    m_current_specialized_uber_ps_uid = UberShader::GetSpecializedPixelShaderUid();
     m_pipeline_config_changed = true;
   }
 
@@ -678,6 +734,7 @@ void VertexManagerBase::UpdatePipelineObject()
     return;
 
   m_current_pipeline_object = nullptr;
+  m_current_pipeline_is_uber = false;
   m_pipeline_config_changed = false;
 
   switch (g_ActiveConfig.iShaderCompilationMode)
@@ -692,8 +749,8 @@ void VertexManagerBase::UpdatePipelineObject()
   case ShaderCompilationMode::SynchronousUberShaders:
   {
     // Exclusive ubershader mode, always use ubershaders.
-    m_current_pipeline_object =
-        g_shader_cache->GetUberPipelineForUid(m_current_uber_pipeline_config);
+    m_current_pipeline_object = GetUberPipeline();
+    m_current_pipeline_is_uber = true;
   }
   break;
 
@@ -712,8 +769,8 @@ void VertexManagerBase::UpdatePipelineObject()
     if (g_ActiveConfig.iShaderCompilationMode == ShaderCompilationMode::AsynchronousUberShaders)
     {
       // Specialized shaders not ready, use the ubershaders.
-      m_current_pipeline_object =
-          g_shader_cache->GetUberPipelineForUid(m_current_uber_pipeline_config);
+      m_current_pipeline_object = GetUberPipeline();
+      m_current_pipeline_is_uber = true;
     }
     else
     {
@@ -726,6 +783,22 @@ void VertexManagerBase::UpdatePipelineObject()
   }
 }
 
+const AbstractPipeline* VertexManagerBase::GetUberPipeline()
+{
+  if (g_ActiveConfig.bSpecializedUberShaders && g_ActiveConfig.GetShaderCompilerThreads() > 0)
+  {
+    // Prefer the ubershader specialized for the current TEV configuration once it's compiled in
+    // the background. There are few enough combinations for these to stay around.
+    VideoCommon::GXUberPipelineUid uid = m_current_uber_pipeline_config;
+    uid.ps_uid = m_current_specialized_uber_ps_uid;
+    auto res = g_shader_cache->GetUberPipelineForUidAsync(uid);
+    if (res && *res)
+      return *res;
+  }
+
+  return g_shader_cache->GetUberPipelineForUid(m_current_uber_pipeline_config);
+}
+
 void VertexManagerBase::OnDraw()
 {
   m_draw_counter++;
@@ -9,6 +9,7 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/MathUtil.h"
+#include "VideoCommon/ConstantManager.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/RenderState.h"
 #include "VideoCommon/ShaderCache.h"
@@ -95,6 +96,8 @@ public:
 
   PrimitiveType GetCurrentPrimitiveType() const { return m_current_primitive_type; }
   void AddIndices(int primitive, u32 num_vertices);
+  void AddRemappedIndices(int primitive, u32 num_vertices, const u16* remap,
+                          u32 num_unique_vertices);
   DataReader PrepareForAdditionalData(int primitive, u32 count, u32 stride, bool cullall);
   void FlushData(u32 count, u32 stride);
 
@@ -148,7 +151,7 @@ public:
 
 protected:
   // When utility uniforms are used, the GX uniforms need to be re-written afterwards.
-  static void InvalidateConstants();
+  void InvalidateConstants();
 
   // Prepares the buffer for the next batch of vertices.
   virtual void ResetBuffer(u32 vertex_stride);
@@ -157,6 +160,9 @@ protected:
   virtual void CommitBuffer(u32 num_vertices, u32 vertex_stride, u32 num_indices,
                             u32* out_base_vertex, u32* out_base_index);
 
+  // Called instead of CommitBuffer() when the current batch is dropped without being drawn.
+  virtual void DiscardBuffer();
+
   // Uploads uniform buffers for GX draws.
   virtual void UploadUniforms();
 
@@ -181,7 +187,9 @@ protected:
 
   VideoCommon::GXPipelineUid m_current_pipeline_config;
   VideoCommon::GXUberPipelineUid m_current_uber_pipeline_config;
+  UberShader::PixelShaderUid m_current_specialized_uber_ps_uid;
   const AbstractPipeline* m_current_pipeline_object = nullptr;
+  bool m_current_pipeline_is_uber = false;
   PrimitiveType m_current_primitive_type = PrimitiveType::Points;
   bool m_pipeline_config_changed = true;
   bool m_rasterization_state_changed = true;
@@ -197,8 +205,23 @@ private:
 
   void UpdatePipelineConfig();
   void UpdatePipelineObject();
+  const AbstractPipeline* GetUberPipeline();
+
+  // Clears the dirty flag of constant blocks which are identical to what was last uploaded.
+  void SkipUnchangedConstants();
 
   bool m_is_flushed = true;
+
+  // The GX constants as of the last upload. Many state changes mark a whole block dirty without
+  // actually changing its contents, and re-uploading means a new allocation and binding.
+  struct UploadedConstants
+  {
+    PixelShaderConstants pixel;
+    VertexShaderConstants vertex;
+    GeometryShaderConstants geometry;
+    bool valid = false;
+  };
+  UploadedConstants m_uploaded_constants = {};
   FlushStatistics m_flush_statistics = {};
 
   // CPU access tracking
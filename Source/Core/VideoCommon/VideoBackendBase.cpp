@@ -42,6 +42,8 @@
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/FrameProfiler.h"
+#include "VideoCommon/FrameTimeBreakdown.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/OpcodeDecoding.h"
@@ -99,6 +101,7 @@ void VideoBackendBase::Video_BeginField(u32 xfb_addr, u32 fb_width, u32 fb_strid
     e.swap_event.fbWidth = fb_width;
     e.swap_event.fbStride = fb_stride;
     e.swap_event.fbHeight = fb_height;
+    e.swap_event.present = !Core::IsPresentationSuppressed();
     AsyncRequests::GetInstance()->PushEvent(e, false);
   }
 }
@@ -144,6 +147,10 @@ u32 VideoBackendBase::Video_GetQueryResult(PerfQueryType type)
     return 0;
   }
 
+  // The counts of the previous period are already known, so there is nothing to wait for.
+  if (g_perf_query->IsLatencyTolerant())
+    return g_perf_query->GetQueryResult(type);
+
   Fifo::SyncGPU(Fifo::SyncGPUReason::PerfQuery);
 
   AsyncRequests::Event e;
@@ -320,6 +327,10 @@ void VideoBackendBase::ShutdownShared()
 {
   m_initialized = false;
 
+  // After the renderer is gone, so that it had the chance to collect all GPU times
+  FrameProfiler::Shutdown(GetDisplayName());
+  FrameTimeBreakdown::Shutdown();
+
   VertexLoaderManager::Clear();
   Fifo::Shutdown();
 }
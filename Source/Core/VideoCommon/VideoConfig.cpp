@@ -71,6 +71,7 @@ void VideoConfig::Refresh()
   }
 
   bVSync = Config::Get(Config::GFX_VSYNC);
+  iMaxFramesInFlight = Config::Get(Config::GFX_MAX_FRAMES_IN_FLIGHT);
   iAdapter = Config::Get(Config::GFX_ADAPTER);
 
   bWidescreenHack = Config::Get(Config::GFX_WIDESCREEN_HACK);
@@ -78,10 +79,14 @@ void VideoConfig::Refresh()
   suggested_aspect_mode = Config::Get(Config::GFX_SUGGESTED_ASPECT_RATIO);
   bCrop = Config::Get(Config::GFX_CROP);
   iSafeTextureCache_ColorSamples = Config::Get(Config::GFX_SAFE_TEXTURE_CACHE_COLOR_SAMPLES);
+  bTrackTextureWrites = Config::Get(Config::GFX_TRACK_TEXTURE_WRITES);
+  iTextureMemoryBudget = Config::Get(Config::GFX_TEXTURE_MEMORY_BUDGET);
   bShowFPS = Config::Get(Config::GFX_SHOW_FPS);
   bShowNetPlayPing = Config::Get(Config::GFX_SHOW_NETPLAY_PING);
   bShowNetPlayMessages = Config::Get(Config::GFX_SHOW_NETPLAY_MESSAGES);
   bLogRenderTimeToFile = Config::Get(Config::GFX_LOG_RENDER_TIME_TO_FILE);
+  bShowFrameTimeBreakdown = Config::Get(Config::GFX_SHOW_FRAME_TIME_BREAKDOWN);
+  bLogFrameTimeBreakdownToFile = Config::Get(Config::GFX_LOG_FRAME_TIME_BREAKDOWN_TO_FILE);
   bOverlayStats = Config::Get(Config::GFX_OVERLAY_STATS);
   bOverlayProjStats = Config::Get(Config::GFX_OVERLAY_PROJ_STATS);
   bDumpTextures = Config::Get(Config::GFX_DUMP_TEXTURES);
@@ -89,6 +94,8 @@ void VideoConfig::Refresh()
   bDumpBaseTextures = Config::Get(Config::GFX_DUMP_BASE_TEXTURES);
   bHiresTextures = Config::Get(Config::GFX_HIRES_TEXTURES);
   bCacheHiresTextures = Config::Get(Config::GFX_CACHE_HIRES_TEXTURES);
+  iHiresTextureCacheSize = Config::Get(Config::GFX_HIRES_TEXTURE_CACHE_SIZE);
+  bCompressHiresTextures = Config::Get(Config::GFX_COMPRESS_HIRES_TEXTURES);
   bDumpEFBTarget = Config::Get(Config::GFX_DUMP_EFB_TARGET);
   bDumpXFBTarget = Config::Get(Config::GFX_DUMP_XFB_TARGET);
   bDumpFramesAsImages = Config::Get(Config::GFX_DUMP_FRAMES_AS_IMAGES);
@@ -100,11 +107,15 @@ void VideoConfig::Refresh()
   iBitrateKbps = Config::Get(Config::GFX_BITRATE_KBPS);
   bInternalResolutionFrameDumps = Config::Get(Config::GFX_INTERNAL_RESOLUTION_FRAME_DUMPS);
   bEnableGPUTextureDecoding = Config::Get(Config::GFX_ENABLE_GPU_TEXTURE_DECODING);
+  iTextureDecodingThreads = Config::Get(Config::GFX_TEXTURE_DECODING_THREADS);
+  bDeduplicateIndexedVertices = Config::Get(Config::GFX_DEDUPLICATE_INDEXED_VERTICES);
   bEnablePixelLighting = Config::Get(Config::GFX_ENABLE_PIXEL_LIGHTING);
   bFastDepthCalc = Config::Get(Config::GFX_FAST_DEPTH_CALC);
   iMultisamples = Config::Get(Config::GFX_MSAA);
   bSSAA = Config::Get(Config::GFX_SSAA);
   iEFBScale = Config::Get(Config::GFX_EFB_SCALE);
+  bDynamicResolution = Config::Get(Config::GFX_DYNAMIC_RESOLUTION);
+  iDynamicResolutionMinScale = Config::Get(Config::GFX_DYNAMIC_RESOLUTION_MIN_SCALE);
   bTexFmtOverlayEnable = Config::Get(Config::GFX_TEXFMT_OVERLAY_ENABLE);
   bTexFmtOverlayCenter = Config::Get(Config::GFX_TEXFMT_OVERLAY_CENTER);
   bWireFrame = Config::Get(Config::GFX_ENABLE_WIREFRAME);
@@ -113,9 +124,15 @@ void VideoConfig::Refresh()
   bEnableValidationLayer = Config::Get(Config::GFX_ENABLE_VALIDATION_LAYER);
   bBackendMultithreading = Config::Get(Config::GFX_BACKEND_MULTITHREADING);
   iCommandBufferExecuteInterval = Config::Get(Config::GFX_COMMAND_BUFFER_EXECUTE_INTERVAL);
+  iCommandRecordingThreads = Config::Get(Config::GFX_COMMAND_RECORDING_THREADS);
+  bAsyncCompute = Config::Get(Config::GFX_ASYNC_COMPUTE);
+  bAsyncTextureUploads = Config::Get(Config::GFX_ASYNC_TEXTURE_UPLOADS);
   bShaderCache = Config::Get(Config::GFX_SHADER_CACHE);
   bWaitForShadersBeforeStarting = Config::Get(Config::GFX_WAIT_FOR_SHADERS_BEFORE_STARTING);
   iShaderCompilationMode = Config::Get(Config::GFX_SHADER_COMPILATION_MODE);
+  iHybridUberShaderCompileThreshold = Config::Get(Config::GFX_HYBRID_UBERSHADER_COMPILE_THRESHOLD);
+  iMaxSpecializedPipelines = Config::Get(Config::GFX_MAX_SPECIALIZED_PIPELINES);
+  bSpecializedUberShaders = Config::Get(Config::GFX_SPECIALIZED_UBERSHADERS);
   iShaderCompilerThreads = Config::Get(Config::GFX_SHADER_COMPILER_THREADS);
   iShaderPrecompilerThreads = Config::Get(Config::GFX_SHADER_PRECOMPILER_THREADS);
 
@@ -126,10 +143,13 @@ void VideoConfig::Refresh()
   bDumpTevTextureFetches = Config::Get(Config::GFX_SW_DUMP_TEV_TEX_FETCHES);
   drawStart = Config::Get(Config::GFX_SW_DRAW_START);
   drawEnd = Config::Get(Config::GFX_SW_DRAW_END);
+  iSWRasterizerThreads = Config::Get(Config::GFX_SW_RASTERIZER_THREADS);
+  null_benchmark_mode = Config::Get(Config::GFX_NULL_BENCHMARK_MODE);
 
   bForceFiltering = Config::Get(Config::GFX_ENHANCE_FORCE_FILTERING);
   iMaxAnisotropy = Config::Get(Config::GFX_ENHANCE_MAX_ANISOTROPY);
   sPostProcessingShader = Config::Get(Config::GFX_ENHANCE_POST_SHADER);
+  sPostProcessingShaderPasses = Config::Get(Config::GFX_ENHANCE_POST_SHADER_PASSES);
   bForceTrueColor = Config::Get(Config::GFX_ENHANCE_FORCE_TRUE_COLOR);
   bDisableCopyFilter = Config::Get(Config::GFX_ENHANCE_DISABLE_COPY_FILTER);
   bArbitraryMipmapDetection = Config::Get(Config::GFX_ENHANCE_ARBITRARY_MIPMAP_DETECTION);
@@ -147,6 +167,7 @@ void VideoConfig::Refresh()
   bEFBAccessEnable = Config::Get(Config::GFX_HACK_EFB_ACCESS_ENABLE);
   bEFBAccessDeferInvalidation = Config::Get(Config::GFX_HACK_EFB_DEFER_INVALIDATION);
   bBBoxEnable = Config::Get(Config::GFX_HACK_BBOX_ENABLE);
+  bbox_readback_mode = Config::Get(Config::GFX_HACK_BBOX_READBACK_MODE);
   bForceProgressive = Config::Get(Config::GFX_HACK_FORCE_PROGRESSIVE);
   bSkipEFBCopyToRam = Config::Get(Config::GFX_HACK_SKIP_EFB_COPY_TO_RAM);
   bSkipXFBCopyToRam = Config::Get(Config::GFX_HACK_SKIP_XFB_COPY_TO_RAM);
@@ -158,8 +179,10 @@ void VideoConfig::Refresh()
   bEFBEmulateFormatChanges = Config::Get(Config::GFX_HACK_EFB_EMULATE_FORMAT_CHANGES);
   bVertexRounding = Config::Get(Config::GFX_HACK_VERTEX_ROUDING);
   iEFBAccessTileSize = Config::Get(Config::GFX_HACK_EFB_ACCESS_TILE_SIZE);
+  iEFBAccessMaxStaleness = Config::Get(Config::GFX_HACK_EFB_ACCESS_MAX_STALENESS);
 
   bPerfQueriesEnable = Config::Get(Config::GFX_PERF_QUERIES_ENABLE);
+  bPerfQueriesLatencyTolerant = Config::Get(Config::GFX_PERF_QUERIES_LATENCY_TOLERANT);
 
   VerifyValidity();
 }
@@ -223,3 +246,23 @@ u32 VideoConfig::GetShaderPrecompilerThreads() const
   else
     return GetNumAutoShaderCompilerThreads();
 }
+
+u32 VideoConfig::GetTextureDecodingThreads() const
+{
+  if (iTextureDecodingThreads >= 0)
+    return static_cast<u32>(iTextureDecodingThreads);
+
+  // Automatic number. The video thread decodes as well, and the CPU thread is busy, so we use
+  // clamp(cpus - 2, 0, 3).
+  return static_cast<u32>(std::min(std::max(cpu_info.num_cores - 2, 0), 3));
+}
+
+u32 VideoConfig::GetSWRasterizerThreads() const
+{
+  if (iSWRasterizerThreads >= 0)
+    return static_cast<u32>(iSWRasterizerThreads);
+
+  // Automatic number. The video thread rasterizes tiles as well, and the CPU thread is busy, so
+  // we use clamp(cpus - 2, 0, 7).
+  return static_cast<u32>(std::min(std::max(cpu_info.num_cores - 2, 0), 7));
+}
@@ -51,6 +51,27 @@ enum class ShaderCompilationMode : int
   AsynchronousSkipRendering
 };
 
+// How the bounding box is read back from the GPU when the emulated CPU reads it. Only the Vulkan
+// and OpenGL backends support the deferred modes, the others always read back synchronously.
+enum class BBoxReadbackMode : int
+{
+  // Waits for all pending rendering, which is exact but stalls the whole GPU pipeline.
+  Synchronous,
+  // Returns the newest values which were copied in rendering that has already been submitted,
+  // waiting for the GPU to finish it if necessary.
+  DeferredWait,
+  // Returns the newest values which the GPU has finished copying, without ever waiting.
+  Deferred,
+};
+
+// Benchmark modes of the Null backend, see NullBackend.cpp.
+enum class NullBenchmarkMode : int
+{
+  Off,
+  ParseOnly,
+  VertexLoad,
+};
+
 // NEVER inherit from this class.
 struct VideoConfig final
 {
@@ -61,6 +82,7 @@ struct VideoConfig final
   // General
   bool bVSync;
   bool bVSyncActive;
+  int iMaxFramesInFlight;  // 0 leaves the number of queued frames up to the driver.
   bool bWidescreenHack;
   AspectMode aspect_mode;
   AspectMode suggested_aspect_mode;
@@ -71,9 +93,14 @@ struct VideoConfig final
   u32 iMultisamples;
   bool bSSAA;
   int iEFBScale;
+  // Lowers the internal resolution down to iDynamicResolutionMinScale while the GPU can't keep up.
+  bool bDynamicResolution;
+  int iDynamicResolutionMinScale;
   bool bForceFiltering;
   int iMaxAnisotropy;
   std::string sPostProcessingShader;
+  // Comma-separated shaders which run before sPostProcessingShader, each on the previous output.
+  std::string sPostProcessingShaderPasses;
   bool bForceTrueColor;
   bool bDisableCopyFilter;
   bool bArbitraryMipmapDetection;
@@ -88,6 +115,8 @@ struct VideoConfig final
   bool bTexFmtOverlayEnable;
   bool bTexFmtOverlayCenter;
   bool bLogRenderTimeToFile;
+  bool bShowFrameTimeBreakdown;
+  bool bLogFrameTimeBreakdownToFile;
 
   // Render
   bool bWireFrame;
@@ -99,6 +128,8 @@ struct VideoConfig final
   bool bDumpBaseTextures;
   bool bHiresTextures;
   bool bCacheHiresTextures;
+  int iHiresTextureCacheSize;  // MiB, 0 = automatic
+  bool bCompressHiresTextures;  // BC3 compress PNG custom textures, cached on disk
   bool bDumpEFBTarget;
   bool bDumpXFBTarget;
   bool bDumpFramesAsImages;
@@ -110,13 +141,17 @@ struct VideoConfig final
   bool bInternalResolutionFrameDumps;
   bool bBorderlessFullscreen;
   bool bEnableGPUTextureDecoding;
+  int iTextureDecodingThreads;
+  bool bDeduplicateIndexedVertices;
   int iBitrateKbps;
 
   // Hacks
   bool bEFBAccessEnable;
   bool bEFBAccessDeferInvalidation;
   bool bPerfQueriesEnable;
+  bool bPerfQueriesLatencyTolerant;
   bool bBBoxEnable;
+  BBoxReadbackMode bbox_readback_mode;
   bool bForceProgressive;
 
   bool bEFBEmulateFormatChanges;
@@ -128,11 +163,16 @@ struct VideoConfig final
   bool bSkipPresentingDuplicateXFBs;
   bool bCopyEFBScaled;
   int iSafeTextureCache_ColorSamples;
+  // Reuse texture hashes for as long as the memory behind them is write protected and unmodified.
+  bool bTrackTextureWrites;
+  int iTextureMemoryBudget;  // MiB of texture cache memory, 0 = unlimited
   float fAspectRatioHackW, fAspectRatioHackH;
   bool bEnablePixelLighting;
   bool bFastDepthCalc;
   bool bVertexRounding;
   int iEFBAccessTileSize;
+  // Frames a prefetched EFB peek cache tile may lag behind the EFB, 0 = no prefetching
+  int iEFBAccessMaxStaleness;
   int iLog;           // CONF_ bits
   int iSaveTargetId;  // TODO: Should be dropped
 
@@ -156,6 +196,10 @@ struct VideoConfig final
   bool bDumpObjects;
   bool bDumpTevStages;
   bool bDumpTevTextureFetches;
+  int iSWRasterizerThreads;
+
+  // Null backend
+  NullBenchmarkMode null_benchmark_mode;
 
   // Enable API validation layers, currently only supported with Vulkan.
   bool bEnableValidationLayer;
@@ -167,10 +211,34 @@ struct VideoConfig final
   // Currently only supported with Vulkan.
   int iCommandBufferExecuteInterval;
 
+  // Number of threads which record the draws of large render passes in parallel, in addition to
+  // the video thread. 0 records everything on the video thread. Currently only supported with
+  // Vulkan.
+  int iCommandRecordingThreads;
+
+  // Run GPU texture decoding on a separate compute queue, where the GPU has one, so that it can
+  // overlap with rendering. Currently only supported with Vulkan.
+  bool bAsyncCompute;
+
+  // Upload large textures on a separate transfer queue, where the GPU has one, so that the copies
+  // can overlap with rendering. Currently only supported with Vulkan.
+  bool bAsyncTextureUploads;
+
   // Shader compilation settings.
   bool bWaitForShadersBeforeStarting;
   ShaderCompilationMode iShaderCompilationMode;
 
+  // With hybrid ubershaders, the number of times a pipeline has to be used within a short time
+  // before its specialized shaders are compiled, 0 = compile them straight away. The number of
+  // specialized pipelines kept around is limited by iMaxSpecializedPipelines, 0 = unlimited, as
+  // the least recently used ones can fall back to the ubershaders again.
+  int iHybridUberShaderCompileThreshold;
+  int iMaxSpecializedPipelines;
+
+  // Compile ubershaders with the TEV stage count, alpha test and fog state baked in, in the
+  // background, and use them in place of the generic ubershaders once they are ready.
+  bool bSpecializedUberShaders;
+
   // Number of shader compiler threads.
   // 0 disables background compilation.
   // -1 uses an automatic number based on the CPU threads.
@@ -241,6 +309,8 @@ struct VideoConfig final
   bool UsingUberShaders() const;
   u32 GetShaderCompilerThreads() const;
   u32 GetShaderPrecompilerThreads() const;
+  u32 GetTextureDecodingThreads() const;
+  u32 GetSWRasterizerThreads() const;
 };
 
 extern VideoConfig g_Config;
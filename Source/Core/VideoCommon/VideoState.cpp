@@ -33,6 +33,14 @@ void VideoCommon_DoState(PointerWrap& p)
     p.SetMode(PointerWrap::MODE_VERIFY);
   }
 
+  // Start reading back the EFB and the EFB copies in the texture cache, so that the GPU copies
+  // them while the rest of the state is serialized, and they only have to be waited for once.
+  if (p.GetMode() == PointerWrap::MODE_WRITE)
+  {
+    g_framebuffer_manager->QueueSaveStateReadbacks();
+    g_texture_cache->QueueSaveStateReadbacks();
+  }
+
   // BP Memory
   p.Do(bpmem);
   p.DoMarker("BP Memory");
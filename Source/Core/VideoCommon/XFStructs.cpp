@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/Swap.h"
@@ -17,6 +19,20 @@
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/XFMemory.h"
 
+// Games tend to resend the same matrices, viewport and projection for every draw, so writes are
+// compared against the current contents to avoid flushing (and splitting the batch) needlessly.
+static bool XFMemChanged(u32 transferSize, u32 baseAddress, const DataReader& src,
+                         u32 dataIndex = 0)
+{
+  const u32* currData = reinterpret_cast<const u32*>(&xfmem) + baseAddress;
+  for (u32 i = 0; i < transferSize; ++i)
+  {
+    if (currData[i] != src.Peek<u32>((dataIndex + i) * sizeof(u32)))
+      return true;
+  }
+  return false;
+}
+
 static void XFMemWritten(u32 transferSize, u32 baseAddress)
 {
   g_vertex_manager->Flush();
@@ -33,6 +49,11 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
     u32 newValue = src.Peek<u32>(dataIndex * sizeof(u32));
     u32 nextAddress = address + 1;
 
+    // Whether any of the registers written from address up to (but excluding) end change.
+    const auto group_changed = [&](u32 end) {
+      return XFMemChanged(std::min<u32>(end - address, transferSize), address, src, dataIndex);
+    };
+
     switch (address)
     {
     case XFMEM_ERROR:
@@ -111,10 +132,13 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
     case XFMEM_SETVIEWPORT + 3:
     case XFMEM_SETVIEWPORT + 4:
     case XFMEM_SETVIEWPORT + 5:
-      g_vertex_manager->Flush();
-      VertexShaderManager::SetViewportChanged();
-      PixelShaderManager::SetViewportChanged();
-      GeometryShaderManager::SetViewportChanged();
+      if (group_changed(XFMEM_SETVIEWPORT + 6))
+      {
+        g_vertex_manager->Flush();
+        VertexShaderManager::SetViewportChanged();
+        PixelShaderManager::SetViewportChanged();
+        GeometryShaderManager::SetViewportChanged();
+      }
 
       nextAddress = XFMEM_SETVIEWPORT + 6;
       break;
@@ -126,9 +150,12 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
     case XFMEM_SETPROJECTION + 4:
     case XFMEM_SETPROJECTION + 5:
     case XFMEM_SETPROJECTION + 6:
-      g_vertex_manager->Flush();
-      VertexShaderManager::SetProjectionChanged();
-      GeometryShaderManager::SetProjectionChanged();
+      if (group_changed(XFMEM_SETPROJECTION + 7))
+      {
+        g_vertex_manager->Flush();
+        VertexShaderManager::SetProjectionChanged();
+        GeometryShaderManager::SetProjectionChanged();
+      }
 
       nextAddress = XFMEM_SETPROJECTION + 7;
       break;
@@ -146,8 +173,11 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
     case XFMEM_SETTEXMTXINFO + 5:
     case XFMEM_SETTEXMTXINFO + 6:
     case XFMEM_SETTEXMTXINFO + 7:
-      g_vertex_manager->Flush();
-      VertexShaderManager::SetTexMatrixInfoChanged(address - XFMEM_SETTEXMTXINFO);
+      if (group_changed(XFMEM_SETTEXMTXINFO + 8))
+      {
+        g_vertex_manager->Flush();
+        VertexShaderManager::SetTexMatrixInfoChanged(address - XFMEM_SETTEXMTXINFO);
+      }
 
       nextAddress = XFMEM_SETTEXMTXINFO + 8;
       break;
@@ -160,8 +190,11 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
     case XFMEM_SETPOSTMTXINFO + 5:
     case XFMEM_SETPOSTMTXINFO + 6:
     case XFMEM_SETPOSTMTXINFO + 7:
-      g_vertex_manager->Flush();
-      VertexShaderManager::SetTexMatrixInfoChanged(address - XFMEM_SETPOSTMTXINFO);
+      if (group_changed(XFMEM_SETPOSTMTXINFO + 8))
+      {
+        g_vertex_manager->Flush();
+        VertexShaderManager::SetTexMatrixInfoChanged(address - XFMEM_SETPOSTMTXINFO);
+      }
 
       nextAddress = XFMEM_SETPOSTMTXINFO + 8;
       break;
@@ -235,10 +268,17 @@ void LoadXFReg(u32 transferSize, u32 baseAddress, DataReader src)
       transferSize = 0;
     }
 
-    XFMemWritten(xfMemTransferSize, xfMemBase);
-    for (u32 i = 0; i < xfMemTransferSize; i++)
+    if (XFMemChanged(xfMemTransferSize, xfMemBase, src))
+    {
+      XFMemWritten(xfMemTransferSize, xfMemBase);
+      for (u32 i = 0; i < xfMemTransferSize; i++)
+      {
+        ((u32*)&xfmem)[xfMemBase + i] = src.Read<u32>();
+      }
+    }
+    else
     {
-      ((u32*)&xfmem)[xfMemBase + i] = src.Read<u32>();
+      src.Skip<u32>(xfMemTransferSize);
     }
   }
 
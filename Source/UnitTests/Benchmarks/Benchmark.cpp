@@ -0,0 +1,94 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string_view>
+#include <utility>
+
+#include <fmt/format.h>
+
+namespace Benchmark
+{
+static std::map<std::string, Function>& GetBenchmarks()
+{
+  static std::map<std::string, Function> benchmarks;
+  return benchmarks;
+}
+
+bool Register(std::string name, Function function)
+{
+  GetBenchmarks().emplace(std::move(name), std::move(function));
+  return true;
+}
+
+static State Run(const Function& function, double min_seconds)
+{
+  u64 iterations = 1;
+  while (true)
+  {
+    State state(iterations);
+    function(state);
+
+    const double seconds = state.GetSeconds();
+    if (seconds >= min_seconds || iterations >= (u64(1) << 40))
+      return state;
+
+    // Aim a bit past the minimum time so that we usually only need one more run.
+    const double estimate = seconds > 0.0 ? min_seconds * 1.4 / seconds * iterations : 0.0;
+    iterations = std::clamp(static_cast<u64>(estimate), iterations * 2, iterations * 100);
+  }
+}
+}  // namespace Benchmark
+
+int main(int argc, char** argv)
+{
+  std::string_view filter;
+  double min_seconds = 0.5;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string_view arg = argv[i];
+    if (arg.rfind("--filter=", 0) == 0)
+    {
+      filter = arg.substr(9);
+    }
+    else if (arg.rfind("--min-time=", 0) == 0)
+    {
+      min_seconds = std::atof(argv[i] + 11);
+    }
+    else
+    {
+      fmt::print(stderr,
+                 "Usage: {} [--filter=<substring>] [--min-time=<seconds>]\n"
+                 "Prints one tab separated line per benchmark: name, iterations, ns per "
+                 "iteration, MB/s, items/s\n",
+                 argv[0]);
+      return 1;
+    }
+  }
+
+  fmt::print("name\titerations\tns/iter\tMB/s\titems/s\n");
+  for (const auto& [name, function] : Benchmark::GetBenchmarks())
+  {
+    if (name.find(filter) == std::string::npos)
+      continue;
+
+    const Benchmark::State state = Benchmark::Run(function, min_seconds);
+    const double seconds = state.GetSeconds();
+    const u64 iterations = state.GetIterations();
+    const double mb_per_second =
+        state.GetBytesPerIteration() * iterations / seconds / (1024.0 * 1024.0);
+    const double items_per_second = state.GetItemsPerIteration() * iterations / seconds;
+    fmt::print("{}\t{}\t{:.1f}\t{:.1f}\t{:.0f}\n", name, iterations, seconds * 1e9 / iterations,
+               mb_per_second, items_per_second);
+    std::fflush(stdout);
+  }
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// A minimal benchmark runner. Each benchmark is run with a growing number of iterations until one
+// run takes long enough to be measured reliably, and the time per iteration of that run is
+// reported. The output is sorted by name, so that results from different versions can be diffed.
+namespace Benchmark
+{
+class State
+{
+public:
+  explicit State(u64 iterations) : m_iterations(iterations) {}
+
+  // Call as `while (state.KeepRunning())` around the code to measure.
+  bool KeepRunning()
+  {
+    if (m_iteration == 0)
+      m_start = Clock::now();
+    else if (m_iteration == m_iterations)
+      m_elapsed += Clock::now() - m_start;
+    return m_iteration++ < m_iterations;
+  }
+
+  // For setup work inside the loop which shouldn't be measured.
+  void PauseTiming() { m_elapsed += Clock::now() - m_start; }
+  void ResumeTiming() { m_start = Clock::now(); }
+
+  // Amount of work done by one iteration, for throughput numbers.
+  void SetBytesPerIteration(u64 bytes) { m_bytes_per_iteration = bytes; }
+  void SetItemsPerIteration(u64 items) { m_items_per_iteration = items; }
+
+  u64 GetIterations() const { return m_iterations; }
+  double GetSeconds() const { return std::chrono::duration<double>(m_elapsed).count(); }
+  u64 GetBytesPerIteration() const { return m_bytes_per_iteration; }
+  u64 GetItemsPerIteration() const { return m_items_per_iteration; }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  u64 m_iterations;
+  u64 m_iteration = 0;
+  Clock::time_point m_start;
+  Clock::duration m_elapsed{};
+  u64 m_bytes_per_iteration = 0;
+  u64 m_items_per_iteration = 0;
+};
+
+using Function = std::function<void(State& state)>;
+
+// Called from static initializers in the benchmark source files.
+bool Register(std::string name, Function function);
+
+// Keeps the compiler from optimizing away a result that isn't used otherwise.
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+#ifdef _MSC_VER
+  static_cast<void>(*reinterpret_cast<const volatile char*>(&value));
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+}  // namespace Benchmark
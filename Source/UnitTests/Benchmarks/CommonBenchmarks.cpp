@@ -0,0 +1,128 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Benchmark.h"
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
+#include "Common/Crypto/SHA1.h"
+#include "Common/Hash.h"
+
+namespace
+{
+std::vector<u8> MakeData(size_t size)
+{
+  std::vector<u8> data(size);
+  std::iota(data.begin(), data.end(), u8(0));
+  return data;
+}
+
+// Texture sized inputs, hashed with the sample counts that the texture cache uses
+void RegisterHashBenchmarks()
+{
+  for (const u32 size : {0x800u, 0x20000u})
+  {
+    for (const u32 samples : {0u, 1024u})
+    {
+      Benchmark::Register(fmt::format("Common/GetHash64/{}/samples:{}", size, samples),
+                          [size, samples](Benchmark::State& state) {
+                            // As done by the texture cache
+                            Common::SetHash64Function();
+                            const std::vector<u8> data = MakeData(size);
+                            state.SetBytesPerIteration(size);
+                            while (state.KeepRunning())
+                            {
+                              const u64 hash = Common::GetHash64(data.data(), size, samples);
+                              Benchmark::DoNotOptimize(hash);
+                            }
+                          });
+    }
+  }
+}
+
+// One Wii disc cluster, which is 0x8000 bytes
+constexpr size_t CLUSTER_SIZE = 0x8000;
+constexpr std::array<u8, 16> KEY = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                    0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+
+const bool s_aes_decrypt = Benchmark::Register("Common/AES/Decrypt/Cluster", [](auto& state) {
+  const std::unique_ptr<Common::AES::Context> context =
+      Common::AES::CreateContextDecrypt(KEY.data());
+  const std::vector<u8> in = MakeData(CLUSTER_SIZE);
+  std::vector<u8> out(CLUSTER_SIZE);
+  std::array<u8, 16> iv{};
+  state.SetBytesPerIteration(CLUSTER_SIZE);
+  while (state.KeepRunning())
+  {
+    context->Crypt(iv.data(), nullptr, in.data(), out.data(), CLUSTER_SIZE);
+    Benchmark::DoNotOptimize(out[0]);
+  }
+});
+
+const bool s_aes_encrypt = Benchmark::Register("Common/AES/Encrypt/Cluster", [](auto& state) {
+  const std::unique_ptr<Common::AES::Context> context =
+      Common::AES::CreateContextEncrypt(KEY.data());
+  const std::vector<u8> in = MakeData(CLUSTER_SIZE);
+  std::vector<u8> out(CLUSTER_SIZE);
+  std::array<u8, 16> iv{};
+  state.SetBytesPerIteration(CLUSTER_SIZE);
+  while (state.KeepRunning())
+  {
+    context->Crypt(iv.data(), nullptr, in.data(), out.data(), CLUSTER_SIZE);
+    Benchmark::DoNotOptimize(out[0]);
+  }
+});
+
+// A group of 64 clusters encrypted as independent streams, like when writing a Wii partition
+const bool s_aes_encrypt_multiple =
+    Benchmark::Register("Common/AES/EncryptMultiple/Group", [](auto& state) {
+      constexpr size_t COUNT = 64;
+      const std::unique_ptr<Common::AES::Context> context =
+          Common::AES::CreateContextEncrypt(KEY.data());
+      const std::vector<u8> in = MakeData(CLUSTER_SIZE * COUNT);
+      std::vector<u8> out(CLUSTER_SIZE * COUNT);
+      std::array<u8, 16> iv{};
+      std::array<Common::AES::CryptJob, COUNT> jobs;
+      for (size_t i = 0; i < COUNT; ++i)
+      {
+        jobs[i] = {iv.data(), in.data() + i * CLUSTER_SIZE, out.data() + i * CLUSTER_SIZE,
+                   CLUSTER_SIZE};
+      }
+      state.SetBytesPerIteration(CLUSTER_SIZE * COUNT);
+      while (state.KeepRunning())
+      {
+        context->CryptMultiple(jobs.data(), jobs.size());
+        Benchmark::DoNotOptimize(out[0]);
+      }
+    });
+
+// The H0 hashes of a cluster: 31 blocks of 0x400 bytes
+const bool s_sha1_digests = Benchmark::Register("Common/SHA1/H0Hashes", [](auto& state) {
+  constexpr size_t BLOCK_SIZE = 0x400;
+  constexpr size_t COUNT = 31;
+  const std::vector<u8> in = MakeData(BLOCK_SIZE * COUNT);
+  std::vector<u8> digests(Common::SHA1::DIGEST_LEN * COUNT);
+  state.SetBytesPerIteration(BLOCK_SIZE * COUNT);
+  while (state.KeepRunning())
+  {
+    Common::SHA1::CalculateDigests(in.data(), BLOCK_SIZE, COUNT, digests.data());
+    Benchmark::DoNotOptimize(digests[0]);
+  }
+});
+
+const bool s_sha1_digest = Benchmark::Register("Common/SHA1/Digest/Cluster", [](auto& state) {
+  const std::vector<u8> in = MakeData(CLUSTER_SIZE);
+  state.SetBytesPerIteration(CLUSTER_SIZE);
+  while (state.KeepRunning())
+    Benchmark::DoNotOptimize(Common::SHA1::CalculateDigest(in.data(), in.size()));
+});
+
+const bool s_hash_benchmarks = (RegisterHashBenchmarks(), true);
+}  // namespace
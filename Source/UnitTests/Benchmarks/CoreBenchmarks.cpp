@@ -0,0 +1,145 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <set>
+#include <string>
+
+#include "Benchmark.h"
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+// The same setup as in CoreTimingTest
+class CoreTimingScope final
+{
+public:
+  CoreTimingScope() : m_profile_path(File::CreateTempDir())
+  {
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    PowerPC::Init(PowerPC::CPUCore::Interpreter);
+    CoreTiming::Init();
+  }
+  ~CoreTimingScope()
+  {
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  CoreTimingScope(const CoreTimingScope&) = delete;
+  CoreTimingScope& operator=(const CoreTimingScope&) = delete;
+
+private:
+  std::string m_profile_path;
+};
+
+constexpr u32 NUM_EVENTS = 64;
+u64 s_events_run = 0;
+
+void CountingCallback(u64, s64)
+{
+  ++s_events_run;
+}
+
+// Schedules a batch of events the way the hardware modules do (several pending events with
+// different deadlines), then runs the CPU loop's slice handling until all of them have fired.
+const bool s_core_timing =
+    Benchmark::Register("Core/CoreTiming/ScheduleAndAdvance/64", [](auto& state) {
+      CoreTimingScope scope;
+      CoreTiming::EventType* event = CoreTiming::RegisterEvent("Benchmark", CountingCallback);
+      CoreTiming::Advance();
+
+      state.SetItemsPerIteration(NUM_EVENTS);
+      while (state.KeepRunning())
+      {
+        s_events_run = 0;
+        for (u32 i = 0; i < NUM_EVENTS; ++i)
+          CoreTiming::ScheduleEvent((i * 7919) % 5000 + 1, event, i);
+
+        while (s_events_run < NUM_EVENTS)
+        {
+          // Pretend that the whole slice was executed.
+          PowerPC::ppcState.downcount = 0;
+          CoreTiming::Advance();
+        }
+      }
+    });
+
+// The same block layout as in JitCacheTest
+constexpr u32 NUM_BLOCKS = 0x4000;
+constexpr u32 BLOCK_STRIDE = 0x40;
+constexpr u32 BLOCK_INSTRUCTIONS = 8;
+
+void FillBlockCache(JitBaseBlockCache* cache)
+{
+  for (u32 i = 0; i < NUM_BLOCKS; ++i)
+  {
+    const u32 address = i * BLOCK_STRIDE;
+    JitBlock* block = cache->AllocateBlock(address);
+    block->checkedEntry = nullptr;
+    block->normalEntry = nullptr;
+    block->codeSize = 0;
+    block->originalSize = BLOCK_INSTRUCTIONS;
+    block->linkData.push_back({nullptr, ((i + 1) % NUM_BLOCKS) * BLOCK_STRIDE, false, false});
+
+    std::set<u32> physical_addresses;
+    for (u32 j = 0; j < BLOCK_INSTRUCTIONS; ++j)
+      physical_addresses.insert(address + j * 4);
+
+    cache->FinalizeBlock(*block, true, physical_addresses);
+  }
+}
+
+const bool s_jit_cache_lookup = Benchmark::Register("Core/JitCache/Lookup", [](auto& state) {
+  // Address translation is disabled, so effective and physical addresses are identical.
+  MSR.Hex = 0;
+  CachedInterpreter jit;
+  JitBaseBlockCache* cache = jit.GetBlockCache();
+  cache->Clear();
+  FillBlockCache(cache);
+
+  state.SetItemsPerIteration(NUM_BLOCKS);
+  while (state.KeepRunning())
+  {
+    for (u32 i = 0; i < NUM_BLOCKS; ++i)
+      Benchmark::DoNotOptimize(cache->GetBlockFromStartAddress(i * BLOCK_STRIDE, 0));
+  }
+  cache->Clear();
+});
+
+const bool s_jit_cache_invalidate =
+    Benchmark::Register("Core/JitCache/InvalidateICache", [](auto& state) {
+      MSR.Hex = 0;
+      CachedInterpreter jit;
+      JitBaseBlockCache* cache = jit.GetBlockCache();
+      cache->Clear();
+
+      state.SetItemsPerIteration(NUM_BLOCKS);
+      while (state.KeepRunning())
+      {
+        state.PauseTiming();
+        FillBlockCache(cache);
+        state.ResumeTiming();
+
+        for (u32 i = 0; i < NUM_BLOCKS; ++i)
+          cache->InvalidateICache(i * BLOCK_STRIDE, 32, true);
+      }
+      cache->Clear();
+    });
+}  // namespace
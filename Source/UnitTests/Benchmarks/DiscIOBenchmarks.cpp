@@ -0,0 +1,153 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Benchmark.h"
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
+#include "DiscIO/VolumeWii.h"
+#include "DiscIO/WIACompression.h"
+
+namespace
+{
+// The default chunk size of the WIA and RVZ conversion
+constexpr size_t CHUNK_SIZE = 0x200000;
+
+// Somewhat compressible data: short runs of repeated bytes mixed with noise
+std::vector<u8> GenerateChunk()
+{
+  std::vector<u8> data(CHUNK_SIZE);
+  u32 state = 12345;
+  for (size_t i = 0; i < data.size();)
+  {
+    state = state * 1103515245 + 12345;
+    const u8 value = static_cast<u8>(state >> 16);
+    const size_t run = (state >> 28) + 1;
+    for (size_t j = 0; j < run && i < data.size(); ++j, ++i)
+      data[i] = value;
+  }
+  return data;
+}
+
+struct CompressionMethod
+{
+  const char* name;
+  std::unique_ptr<DiscIO::Compressor> (*create_compressor)(std::array<u8, 7>* data, u8* size);
+  std::unique_ptr<DiscIO::Decompressor> (*create_decompressor)(const u8* data, u8 size);
+};
+
+constexpr std::array<CompressionMethod, 3> COMPRESSION_METHODS = {{
+    {"bzip2",
+     [](std::array<u8, 7>*, u8*) -> std::unique_ptr<DiscIO::Compressor> {
+       return std::make_unique<DiscIO::Bzip2Compressor>(9);
+     },
+     [](const u8*, u8) -> std::unique_ptr<DiscIO::Decompressor> {
+       return std::make_unique<DiscIO::Bzip2Decompressor>();
+     }},
+    {"LZMA2",
+     [](std::array<u8, 7>* data, u8* size) -> std::unique_ptr<DiscIO::Compressor> {
+       return std::make_unique<DiscIO::LZMACompressor>(true, 5, data->data(), size);
+     },
+     [](const u8* data, u8 size) -> std::unique_ptr<DiscIO::Decompressor> {
+       return std::make_unique<DiscIO::LZMADecompressor>(true, data, size);
+     }},
+    {"Zstandard",
+     [](std::array<u8, 7>*, u8*) -> std::unique_ptr<DiscIO::Compressor> {
+       return std::make_unique<DiscIO::ZstdCompressor>(5);
+     },
+     [](const u8*, u8) -> std::unique_ptr<DiscIO::Decompressor> {
+       return std::make_unique<DiscIO::ZstdDecompressor>();
+     }},
+}};
+
+// Reading a compressed chunk is what limits the speed of playing from a WIA or RVZ file.
+void RegisterWIABenchmarks()
+{
+  for (const CompressionMethod& method : COMPRESSION_METHODS)
+  {
+    Benchmark::Register(
+        fmt::format("DiscIO/WIA/DecompressChunk/{}", method.name),
+        [&method](Benchmark::State& state) {
+          const std::vector<u8> chunk = GenerateChunk();
+          std::array<u8, 7> compressor_data{};
+          u8 compressor_data_size = 0;
+          const std::unique_ptr<DiscIO::Compressor> compressor =
+              method.create_compressor(&compressor_data, &compressor_data_size);
+          if (!compressor->Start(chunk.size()) ||
+              !compressor->Compress(chunk.data(), chunk.size()) || !compressor->End())
+          {
+            fmt::print(stderr, "Failed to compress with {}\n", method.name);
+            return;
+          }
+
+          DiscIO::DecompressionBuffer in;
+          in.data.assign(compressor->GetData(), compressor->GetData() + compressor->GetSize());
+          in.bytes_written = in.data.size();
+          DiscIO::DecompressionBuffer out;
+          out.data.resize(chunk.size());
+
+          state.SetBytesPerIteration(chunk.size());
+          while (state.KeepRunning())
+          {
+            const std::unique_ptr<DiscIO::Decompressor> decompressor =
+                method.create_decompressor(compressor_data.data(), compressor_data_size);
+            out.bytes_written = 0;
+            size_t in_bytes_read = 0;
+            while (!decompressor->Done())
+            {
+              if (!decompressor->Decompress(in, &out, &in_bytes_read))
+                break;
+            }
+            Benchmark::DoNotOptimize(out.data[0]);
+          }
+        });
+  }
+}
+
+using VolumeWii = DiscIO::VolumeWii;
+
+const bool s_hash_group = Benchmark::Register("DiscIO/VolumeWii/HashGroup", [](auto& state) {
+  auto in = std::make_unique<std::array<u8, VolumeWii::BLOCK_DATA_SIZE>[]>(
+      VolumeWii::BLOCKS_PER_GROUP);
+  for (size_t i = 0; i < VolumeWii::BLOCKS_PER_GROUP; ++i)
+    in[i].fill(static_cast<u8>(i));
+  auto out = std::make_unique<VolumeWii::HashBlock[]>(VolumeWii::BLOCKS_PER_GROUP);
+
+  state.SetBytesPerIteration(VolumeWii::GROUP_DATA_SIZE);
+  while (state.KeepRunning())
+  {
+    VolumeWii::HashGroup(in.get(), out.get());
+    Benchmark::DoNotOptimize(out[0]);
+  }
+});
+
+const bool s_decrypt_group = Benchmark::Register("DiscIO/VolumeWii/DecryptGroup", [](auto& state) {
+  constexpr std::array<u8, 16> key = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                      0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+  const std::unique_ptr<Common::AES::Context> context =
+      Common::AES::CreateContextDecrypt(key.data());
+  const std::vector<u8> in(VolumeWii::GROUP_TOTAL_SIZE, 0x5A);
+  std::vector<u8> out(VolumeWii::BLOCK_DATA_SIZE);
+  VolumeWii::HashBlock hashes;
+
+  state.SetBytesPerIteration(VolumeWii::GROUP_TOTAL_SIZE);
+  while (state.KeepRunning())
+  {
+    for (size_t i = 0; i < VolumeWii::BLOCKS_PER_GROUP; ++i)
+    {
+      const u8* block = in.data() + i * VolumeWii::BLOCK_TOTAL_SIZE;
+      VolumeWii::DecryptBlockHashes(block, &hashes, context.get());
+      VolumeWii::DecryptBlockData(block, out.data(), context.get());
+    }
+    Benchmark::DoNotOptimize(out[0]);
+  }
+});
+
+const bool s_wia_benchmarks = (RegisterWIABenchmarks(), true);
+}  // namespace
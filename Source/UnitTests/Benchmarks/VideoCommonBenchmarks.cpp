@@ -0,0 +1,221 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Benchmark.h"
+#include "Common/CommonTypes.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/DataReader.h"
+#include "VideoCommon/IndexGenerator.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/ShaderGenCommon.h"
+#include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/VertexLoaderBase.h"
+#include "VideoCommon/VertexShaderGen.h"
+#include "VideoCommon/VideoCommon.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace
+{
+std::vector<u8> GenerateData(size_t size)
+{
+  std::vector<u8> data(size);
+  u32 state = 12345;
+  for (u8& byte : data)
+  {
+    state = state * 1103515245 + 12345;
+    byte = static_cast<u8>(state >> 16);
+  }
+  return data;
+}
+
+void RegisterTextureDecoderBenchmarks()
+{
+  static constexpr struct
+  {
+    TextureFormat format;
+    const char* name;
+  } formats[] = {
+      {TextureFormat::I4, "I4"},         {TextureFormat::I8, "I8"},
+      {TextureFormat::IA4, "IA4"},       {TextureFormat::IA8, "IA8"},
+      {TextureFormat::RGB565, "RGB565"}, {TextureFormat::RGB5A3, "RGB5A3"},
+      {TextureFormat::RGBA8, "RGBA8"},   {TextureFormat::C4, "C4"},
+      {TextureFormat::C8, "C8"},         {TextureFormat::C14X2, "C14X2"},
+      {TextureFormat::CMPR, "CMPR"},
+  };
+
+  for (const auto& [format, name] : formats)
+  {
+    Benchmark::Register(fmt::format("VideoCommon/TexDecoder_Decode/{}/512x512", name),
+                        [format = format](Benchmark::State& state) {
+                          constexpr u32 width = 512;
+                          constexpr u32 height = 512;
+                          const std::vector<u8> tlut = GenerateData(16384 * sizeof(u16));
+                          const std::vector<u8> src = GenerateData(width * height * sizeof(u32));
+                          std::vector<u8> dst(width * height * sizeof(u32));
+                          state.SetItemsPerIteration(width * height);
+                          state.SetBytesPerIteration(dst.size());
+                          while (state.KeepRunning())
+                          {
+                            TexDecoder_Decode(dst.data(), src.data(), width, height, format,
+                                              tlut.data(), TLUTFormat::RGB5A3);
+                            Benchmark::DoNotOptimize(dst[0]);
+                          }
+                        });
+  }
+}
+
+// Direct positions in every format, which covers the bulk of the vertex data of most games
+void RegisterVertexLoaderBenchmarks()
+{
+  static constexpr const char* format_names[] = {"u8", "s8", "u16", "s16", "float"};
+  for (int format = FORMAT_UBYTE; format <= FORMAT_FLOAT; ++format)
+  {
+    for (int elements = 0; elements <= 1; ++elements)
+    {
+      Benchmark::Register(
+          fmt::format("VideoCommon/VertexLoader/Position/{}/{}", format_names[format],
+                      elements ? "xyz" : "xy"),
+          [format, elements](Benchmark::State& state) {
+            constexpr int COUNT = 10000;
+            TVtxDesc vtx_desc;
+            std::memset(&vtx_desc, 0, sizeof(vtx_desc));
+            VAT vtx_attr;
+            std::memset(&vtx_attr, 0, sizeof(vtx_attr));
+            vtx_desc.Position = DIRECT;
+            vtx_attr.g0.PosFormat = format;
+            vtx_attr.g0.PosElements = elements;
+            vtx_attr.g0.ByteDequant = true;
+
+            const std::unique_ptr<VertexLoaderBase> loader =
+                VertexLoaderBase::CreateVertexLoader(vtx_desc, vtx_attr);
+            std::vector<u8> src = GenerateData(loader->m_VertexSize * COUNT);
+            std::vector<u8> dst(loader->m_native_vtx_decl.stride * COUNT);
+
+            state.SetItemsPerIteration(COUNT);
+            state.SetBytesPerIteration(src.size());
+            while (state.KeepRunning())
+            {
+              loader->RunVertices(DataReader(src.data(), src.data() + src.size()),
+                                  DataReader(dst.data(), dst.data() + dst.size()), COUNT);
+              Benchmark::DoNotOptimize(dst[0]);
+            }
+          });
+    }
+  }
+}
+
+void RegisterIndexGeneratorBenchmarks()
+{
+  static constexpr const char* primitive_names[] = {
+      "Quads", "Quads2", "Triangles", "TriangleStrip", "Fan", "Lines", "LineStrip", "Points"};
+  for (int primitive = OpcodeDecoder::GX_DRAW_QUADS; primitive <= OpcodeDecoder::GX_DRAW_POINTS;
+       ++primitive)
+  {
+    for (const bool primitive_restart : {false, true})
+    {
+      Benchmark::Register(
+          fmt::format("VideoCommon/IndexGenerator/{}{}", primitive_names[primitive],
+                      primitive_restart ? "/PrimitiveRestart" : ""),
+          [primitive, primitive_restart](Benchmark::State& state) {
+            constexpr u32 VERTICES_PER_PRIMITIVE = 60;
+            constexpr u32 PRIMITIVES_PER_BATCH = 500;
+            g_Config.backend_info.bSupportsPrimitiveRestart = primitive_restart;
+            IndexGenerator generator;
+            generator.Init();
+            std::vector<u16> buffer(65536 * 3);
+
+            state.SetItemsPerIteration(VERTICES_PER_PRIMITIVE * PRIMITIVES_PER_BATCH);
+            while (state.KeepRunning())
+            {
+              generator.Start(buffer.data());
+              for (u32 i = 0; i < PRIMITIVES_PER_BATCH; ++i)
+                generator.AddIndices(primitive, VERTICES_PER_PRIMITIVE);
+              Benchmark::DoNotOptimize(buffer[0]);
+            }
+          });
+    }
+  }
+}
+
+// UID -> source generation, over a set of UIDs with varying TEV stage setups. Many of the stages
+// repeat between UIDs, as they do in games.
+void RegisterShaderGenBenchmarks()
+{
+  Benchmark::Register("VideoCommon/ShaderGen/PixelShader", [](Benchmark::State& state) {
+    constexpr u32 COUNT = 256;
+    u32 seed = 12345;
+    const auto next = [&seed](u32 range) {
+      seed = seed * 1103515245 + 12345;
+      return (seed >> 16) % range;
+    };
+
+    std::vector<pixel_shader_uid_data> uids(COUNT);
+    for (pixel_shader_uid_data& uid : uids)
+    {
+      std::memset(&uid, 0, sizeof(uid));
+      uid.num_values = sizeof(uid);
+      uid.genMode_numtexgens = next(9);
+      uid.genMode_numtevstages = next(16);
+      for (u32 i = 0; i <= uid.genMode_numtevstages; ++i)
+      {
+        // Pick from a small set of combiner setups, so that stages are shared between shaders.
+        auto& stage = uid.stagehash[i];
+        stage.cc = next(8) * 0x12345;
+        stage.ac = next(8) * 0x23456;
+        stage.tevorders_texmap = next(8);
+        stage.tevorders_texcoord = next(8);
+        stage.tevorders_enable = next(2);
+        stage.tevorders_colorchan = next(8);
+      }
+    }
+
+    const ShaderHostConfig host_config = {};
+    state.SetItemsPerIteration(COUNT);
+    while (state.KeepRunning())
+    {
+      for (const pixel_shader_uid_data& uid : uids)
+      {
+        const ShaderCode code = GeneratePixelShaderCode(APIType::OpenGL, host_config, &uid);
+        Benchmark::DoNotOptimize(code.GetBuffer().size());
+      }
+    }
+  });
+
+  Benchmark::Register("VideoCommon/ShaderGen/VertexShader", [](Benchmark::State& state) {
+    std::vector<vertex_shader_uid_data> uids;
+    for (u32 num_texgens = 0; num_texgens <= 8; ++num_texgens)
+    {
+      for (u32 num_color_chans = 0; num_color_chans <= 2; ++num_color_chans)
+      {
+        vertex_shader_uid_data uid;
+        std::memset(&uid, 0, sizeof(uid));
+        uid.numTexGens = num_texgens;
+        uid.numColorChans = num_color_chans;
+        uids.push_back(uid);
+      }
+    }
+
+    const ShaderHostConfig host_config = {};
+    state.SetItemsPerIteration(uids.size());
+    while (state.KeepRunning())
+    {
+      for (const vertex_shader_uid_data& uid : uids)
+      {
+        const ShaderCode code = GenerateVertexShaderCode(APIType::OpenGL, host_config, &uid);
+        Benchmark::DoNotOptimize(code.GetBuffer().size());
+      }
+    }
+  });
+}
+
+const bool s_registered = (RegisterTextureDecoderBenchmarks(), RegisterVertexLoaderBenchmarks(),
+                           RegisterIndexGeneratorBenchmarks(), RegisterShaderGenBenchmarks(), true);
+}  // namespace
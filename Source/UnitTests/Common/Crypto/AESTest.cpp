@@ -0,0 +1,81 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/Crypto/AES.h"
+
+// From NIST SP 800-38A, F.2.1 CBC-AES128.Encrypt
+constexpr std::array<u8, 16> KEY{{0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15,
+                                  0x88, 0x09, 0xcf, 0x4f, 0x3c}};
+constexpr std::array<u8, 16> IV{{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a,
+                                 0x0b, 0x0c, 0x0d, 0x0e, 0x0f}};
+constexpr std::array<u8, 64> PLAINTEXT{
+    {0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73,
+     0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7,
+     0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4,
+     0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef, 0xf6, 0x9f, 0x24, 0x45,
+     0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10}};
+constexpr std::array<u8, 64> CIPHERTEXT{
+    {0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46, 0xce, 0xe9, 0x8e, 0x9b, 0x12,
+     0xe9, 0x19, 0x7d, 0x50, 0x86, 0xcb, 0x9b, 0x50, 0x72, 0x19, 0xee, 0x95, 0xdb,
+     0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2, 0x73, 0xbe, 0xd6, 0xb8, 0xe3, 0xc1, 0x74,
+     0x3b, 0x71, 0x16, 0xe6, 0x9e, 0x22, 0x22, 0x95, 0x16, 0x3f, 0xf1, 0xca, 0xa1,
+     0x68, 0x1f, 0xac, 0x09, 0x12, 0x0e, 0xca, 0x30, 0x75, 0x86, 0xe1, 0xa7}};
+
+TEST(AES, CBCKnownAnswer)
+{
+  std::array<u8, 64> buffer;
+  std::array<u8, 16> iv_out;
+
+  Common::AES::CreateContextEncrypt(KEY.data())
+      ->Crypt(IV.data(), iv_out.data(), PLAINTEXT.data(), buffer.data(), buffer.size());
+  EXPECT_EQ(buffer, CIPHERTEXT);
+  EXPECT_TRUE(std::equal(iv_out.begin(), iv_out.end(), CIPHERTEXT.end() - 16));
+
+  Common::AES::CreateContextDecrypt(KEY.data())
+      ->Crypt(IV.data(), iv_out.data(), CIPHERTEXT.data(), buffer.data(), buffer.size());
+  EXPECT_EQ(buffer, PLAINTEXT);
+  EXPECT_TRUE(std::equal(iv_out.begin(), iv_out.end(), CIPHERTEXT.end() - 16));
+}
+
+TEST(AES, DecryptInPlace)
+{
+  // Large enough to go through the pipelined path of the hardware implementations
+  std::vector<u8> plaintext(0x7c00);
+  for (size_t i = 0; i < plaintext.size(); ++i)
+    plaintext[i] = static_cast<u8>(i * 13);
+
+  std::vector<u8> buffer(plaintext.size());
+  Common::AES::CreateContextEncrypt(KEY.data())
+      ->Crypt(IV.data(), nullptr, plaintext.data(), buffer.data(), buffer.size());
+  Common::AES::CreateContextDecrypt(KEY.data())
+      ->Crypt(IV.data(), nullptr, buffer.data(), buffer.data(), buffer.size());
+  EXPECT_EQ(buffer, plaintext);
+}
+
+TEST(AES, CryptMultiple)
+{
+  constexpr size_t STREAMS = 6;
+  constexpr size_t LEN = 0x400;
+
+  std::vector<u8> plaintext(LEN * STREAMS);
+  for (size_t i = 0; i < plaintext.size(); ++i)
+    plaintext[i] = static_cast<u8>(i * 31 + (i >> 10));
+
+  const auto context = Common::AES::CreateContextEncrypt(KEY.data());
+  std::vector<u8> multiple(plaintext.size());
+  std::vector<Common::AES::CryptJob> jobs;
+  for (size_t i = 0; i < STREAMS; ++i)
+    jobs.push_back({IV.data(), plaintext.data() + i * LEN, multiple.data() + i * LEN, LEN});
+  ASSERT_TRUE(context->CryptMultiple(jobs.data(), jobs.size()));
+
+  std::vector<u8> single(plaintext.size());
+  for (size_t i = 0; i < STREAMS; ++i)
+    context->Crypt(IV.data(), nullptr, plaintext.data() + i * LEN, single.data() + i * LEN, LEN);
+  EXPECT_EQ(multiple, single);
+}
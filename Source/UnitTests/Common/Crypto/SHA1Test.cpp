@@ -0,0 +1,77 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/Crypto/SHA1.h"
+
+static const u8* AsBytes(std::string_view str)
+{
+  return reinterpret_cast<const u8*>(str.data());
+}
+
+TEST(SHA1, KnownDigests)
+{
+  static constexpr Common::SHA1::Digest EMPTY = {
+      {0xda, 0x39, 0xa3, 0xee, 0x5e, 0x6b, 0x4b, 0x0d, 0x32, 0x55,
+       0xbf, 0xef, 0x95, 0x60, 0x18, 0x90, 0xaf, 0xd8, 0x07, 0x09}};
+  static constexpr Common::SHA1::Digest ABC = {{0xa9, 0x99, 0x3e, 0x36, 0x47, 0x06, 0x81,
+                                                0x6a, 0xba, 0x3e, 0x25, 0x71, 0x78, 0x50,
+                                                0xc2, 0x6c, 0x9c, 0xd0, 0xd8, 0x9d}};
+  static constexpr Common::SHA1::Digest TWO_BLOCKS = {
+      {0x84, 0x98, 0x3e, 0x44, 0x1c, 0x3b, 0xd2, 0x6e, 0xba, 0xae,
+       0x4a, 0xa1, 0xf9, 0x51, 0x29, 0xe5, 0xe5, 0x46, 0x70, 0xf1}};
+  constexpr std::string_view two_blocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+
+  EXPECT_EQ(Common::SHA1::CalculateDigest(AsBytes(""), 0), EMPTY);
+  EXPECT_EQ(Common::SHA1::CalculateDigest(AsBytes("abc"), 3), ABC);
+  EXPECT_EQ(Common::SHA1::CalculateDigest(AsBytes(two_blocks), two_blocks.size()), TWO_BLOCKS);
+}
+
+TEST(SHA1, ContextMatchesOneShot)
+{
+  std::vector<u8> data(1000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<u8>(i * 7 + 3);
+
+  // Feed the data in uneven pieces so that the context has to buffer partial blocks
+  auto context = Common::SHA1::CreateContext();
+  size_t offset = 0;
+  for (size_t piece = 1; offset < data.size(); piece = piece * 3 % 97)
+  {
+    const size_t len = std::min(piece, data.size() - offset);
+    context->Update(data.data() + offset, len);
+    offset += len;
+  }
+
+  EXPECT_EQ(context->Finish(), Common::SHA1::CalculateDigest(data));
+}
+
+TEST(SHA1, CalculateDigests)
+{
+  constexpr size_t MESSAGE_LEN = 0x400;
+  constexpr size_t COUNT = 31;
+
+  std::vector<u8> data(MESSAGE_LEN * COUNT);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<u8>(i ^ (i >> 8));
+
+  std::array<u8, COUNT * Common::SHA1::DIGEST_LEN> digests;
+  Common::SHA1::CalculateDigests(data.data(), MESSAGE_LEN, COUNT, digests.data());
+
+  for (size_t i = 0; i < COUNT; ++i)
+  {
+    const Common::SHA1::Digest expected =
+        Common::SHA1::CalculateDigest(data.data() + i * MESSAGE_LEN, MESSAGE_LEN);
+    EXPECT_EQ(std::memcmp(digests.data() + i * Common::SHA1::DIGEST_LEN, expected.data(),
+                          Common::SHA1::DIGEST_LEN),
+              0);
+  }
+}
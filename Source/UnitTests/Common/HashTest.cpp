@@ -0,0 +1,147 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include <xxhash.h>
+#include <zlib.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Hash.h"
+
+namespace
+{
+std::vector<u8> GenerateData(size_t size)
+{
+  std::vector<u8> data(size);
+  u32 state = 12345;
+  for (u8& byte : data)
+  {
+    state = state * 1103515245 + 12345;
+    byte = static_cast<u8>(state >> 16);
+  }
+  return data;
+}
+
+// Times hash(data, size) over enough iterations to hash about 256 MiB, in GiB/s.
+template <typename F>
+double MeasureThroughput(const std::vector<u8>& data, F hash)
+{
+  const size_t iterations = std::max<size_t>(1, (256 << 20) / data.size());
+  u64 sink = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    sink += hash(data.data(), static_cast<u32>(data.size()));
+  const auto end = std::chrono::steady_clock::now();
+  EXPECT_NE(0u, sink | 1);
+
+  const double seconds = std::chrono::duration<double>(end - start).count();
+  return double(data.size()) * iterations / seconds / (1 << 30);
+}
+}  // namespace
+
+TEST(Hash, FullHashKnownValues)
+{
+  Common::SetHash64Function();
+
+  // Every input size class: a single stripe, partial blocks and multiple blocks.
+  static constexpr std::pair<u32, u64> known_values[] = {
+      {0, 0x2D05E7C0B3590579},    {1, 0xDBB7AFE9F6C772BF},    {7, 0xA1819DCE82DB439B},
+      {8, 0x02B7D23BB3DFF6A6},    {63, 0x23BF0E413D45267E},   {64, 0x558B6F057CA6263C},
+      {65, 0xA2CB11D9CE34DD0D},   {127, 0xE9DDE9BDE96E364F},  {128, 0xD4349E787A884594},
+      {1023, 0x57592D169B338096}, {1024, 0x487599A27C6165C9}, {1025, 0x3746B6FF984D16E3},
+      {5000, 0xD245CBBD4BF7C235},
+  };
+
+  const std::vector<u8> data = GenerateData(5000);
+  for (const auto& [size, hash] : known_values)
+  {
+    EXPECT_EQ(hash, Common::GetHash64(data.data(), size, 0)) << size << " bytes";
+    // Sampling every word is the same as hashing everything.
+    EXPECT_EQ(hash, Common::GetHash64(data.data(), size, size / 8)) << size << " bytes";
+  }
+}
+
+TEST(Hash, FullHashDependsOnOrder)
+{
+  Common::SetHash64Function();
+
+  std::vector<u8> data = GenerateData(4096);
+  const u64 hash = Common::GetHash64(data.data(), static_cast<u32>(data.size()), 0);
+
+  // Swap two stripes within a block, and two blocks.
+  std::vector<u8> swapped = data;
+  std::swap_ranges(swapped.begin(), swapped.begin() + 64, swapped.begin() + 128);
+  EXPECT_NE(hash, Common::GetHash64(swapped.data(), static_cast<u32>(swapped.size()), 0));
+
+  swapped = data;
+  std::swap_ranges(swapped.begin(), swapped.begin() + 1024, swapped.begin() + 2048);
+  EXPECT_NE(hash, Common::GetHash64(swapped.data(), static_cast<u32>(swapped.size()), 0));
+
+  // Swap two words within a stripe.
+  swapped = data;
+  std::swap_ranges(swapped.begin() + 8, swapped.begin() + 16, swapped.begin() + 16);
+  EXPECT_NE(hash, Common::GetHash64(swapped.data(), static_cast<u32>(swapped.size()), 0));
+}
+
+TEST(Hash, CRC32KnownValues)
+{
+  static constexpr char check[] = "123456789";
+  EXPECT_EQ(0xCBF43926u, Common::ComputeCRC32(0, reinterpret_cast<const u8*>(check), 9));
+  EXPECT_EQ(0u, Common::ComputeCRC32(0, nullptr, 0));
+}
+
+TEST(Hash, CRC32MatchesZlib)
+{
+  const std::vector<u8> data = GenerateData(5000);
+
+  // Sizes on both sides of the 64-byte blocks that the hardware paths work in, and misalignment.
+  for (size_t offset = 0; offset < 4; ++offset)
+  {
+    for (size_t size : {0, 1, 7, 8, 15, 16, 63, 64, 65, 127, 128, 200, 1024, 4093})
+    {
+      const u8* src = data.data() + offset;
+      const u32 expected = crc32(0, src, static_cast<uInt>(size));
+      EXPECT_EQ(expected, Common::ComputeCRC32(0, src, size)) << size << " bytes at " << offset;
+
+      // Chaining gives the same result as doing everything at once.
+      const size_t split = size / 3;
+      const u32 first = Common::ComputeCRC32(0, src, split);
+      EXPECT_EQ(expected, Common::ComputeCRC32(first, src + split, size - split))
+          << size << " bytes at " << offset;
+    }
+  }
+}
+
+// Not a correctness test as such, but useful to compare the throughput of the texture hashes.
+TEST(Hash, Benchmark)
+{
+  Common::SetHash64Function();
+
+  for (const size_t size : {256, 4096, 65536, 1 << 20, 8 << 20})
+  {
+    const std::vector<u8> data = GenerateData(size);
+    const double full = MeasureThroughput(
+        data, [](const u8* src, u32 len) { return Common::GetHash64(src, len, 0); });
+    // One sample less than there are words still reads every word, but goes through the sampled
+    // hash, which is what hashing everything used to cost.
+    const double sampled_all = MeasureThroughput(
+        data, [](const u8* src, u32 len) { return Common::GetHash64(src, len, len / 8 - 1); });
+    const double sampled = MeasureThroughput(
+        data, [](const u8* src, u32 len) { return Common::GetHash64(src, len, 128); });
+    const double xxh64 =
+        MeasureThroughput(data, [](const u8* src, u32 len) { return XXH64(src, len, 0); });
+    const double crc = MeasureThroughput(
+        data, [](const u8* src, u32 len) { return Common::ComputeCRC32(0, src, len); });
+    printf("%8zu bytes: full %6.2f GiB/s, sampled (all words) %6.2f GiB/s, "
+           "128 samples %7.2f GiB/s, XXH64 %6.2f GiB/s, CRC-32 %6.2f GiB/s\n",
+           size, full, sampled_all, sampled, xxh64, crc);
+  }
+}
@@ -0,0 +1,89 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+#include "Common/SPSCRingQueue.h"
+
+TEST(SPSCRingQueue, Simple)
+{
+  Common::SPSCRingQueue<u32> q(4);
+
+  EXPECT_EQ(0u, q.Size());
+  EXPECT_TRUE(q.Empty());
+
+  q.Push(1);
+  EXPECT_EQ(1u, q.Size());
+  EXPECT_FALSE(q.Empty());
+  EXPECT_EQ(1u, q.Front());
+
+  u32 v;
+  EXPECT_TRUE(q.Pop(v));
+  EXPECT_EQ(1u, v);
+  EXPECT_EQ(0u, q.Size());
+  EXPECT_TRUE(q.Empty());
+  EXPECT_FALSE(q.Pop(v));
+
+  // Test the FIFO order, across several ring growths.
+  for (u32 i = 0; i < 1000; ++i)
+    q.Push(i);
+  EXPECT_EQ(1000u, q.Size());
+  for (u32 i = 0; i < 1000; ++i)
+  {
+    u32 v2;
+    EXPECT_TRUE(q.Pop(v2));
+    EXPECT_EQ(i, v2);
+  }
+  EXPECT_TRUE(q.Empty());
+
+  for (u32 i = 0; i < 1000; ++i)
+    q.Push(i);
+  EXPECT_FALSE(q.Empty());
+  q.Clear();
+  EXPECT_TRUE(q.Empty());
+  q.Push(5);
+  EXPECT_EQ(5u, q.Front());
+  q.Pop();
+  EXPECT_TRUE(q.Empty());
+}
+
+TEST(SPSCRingQueue, PopReleasesElement)
+{
+  Common::SPSCRingQueue<std::shared_ptr<int>> q;
+  auto value = std::make_shared<int>(1);
+
+  q.Push(value);
+  EXPECT_EQ(2, value.use_count());
+  q.Pop();
+  EXPECT_EQ(1, value.use_count());
+}
+
+TEST(SPSCRingQueue, MultiThreaded)
+{
+  Common::SPSCRingQueue<u32> q(16);
+
+  auto inserter = [&q]() {
+    for (u32 i = 0; i < 100000; ++i)
+      q.Push(i);
+  };
+
+  auto popper = [&q]() {
+    for (u32 i = 0; i < 100000; ++i)
+    {
+      while (q.Empty())
+        ;
+      u32 v;
+      q.Pop(v);
+      EXPECT_EQ(i, v);
+    }
+  };
+
+  std::thread popper_thread(popper);
+  std::thread inserter_thread(inserter);
+
+  popper_thread.join();
+  inserter_thread.join();
+}
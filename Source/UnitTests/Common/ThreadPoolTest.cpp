@@ -0,0 +1,74 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/ThreadPool.h"
+
+TEST(ThreadPool, Async)
+{
+  Common::ThreadPool pool(2);
+
+  std::vector<std::future<u32>> futures;
+  for (u32 i = 0; i < 100; ++i)
+    futures.push_back(pool.Async(Common::TaskPriority::Background, [i] { return i * 2; }));
+
+  for (u32 i = 0; i < 100; ++i)
+    EXPECT_EQ(i * 2, futures[i].get());
+}
+
+TEST(ThreadPool, ParallelFor)
+{
+  Common::ThreadPool pool(4);
+
+  std::vector<std::atomic<u32>> calls(1000);
+  pool.ParallelFor(static_cast<u32>(calls.size()), [&](u32 i) { ++calls[i]; });
+
+  for (const std::atomic<u32>& count : calls)
+    EXPECT_EQ(1u, count.load());
+}
+
+TEST(ThreadPool, NestedParallelFor)
+{
+  // Every worker blocks in a nested ParallelFor, which has to finish on the calling threads.
+  Common::ThreadPool pool(2);
+
+  std::atomic<u32> total{0};
+  pool.ParallelFor(8, [&](u32) { pool.ParallelFor(8, [&](u32) { ++total; }); });
+
+  EXPECT_EQ(64u, total.load());
+}
+
+TEST(ThreadPool, Priorities)
+{
+  Common::ThreadPool pool(1);
+
+  // Keep the only worker busy until all tasks are queued.
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  auto blocker = pool.Async(Common::TaskPriority::High, [released] { released.wait(); });
+
+  std::vector<int> order;
+  std::mutex order_lock;
+  const auto record = [&](int value) {
+    return [&order, &order_lock, value] {
+      std::lock_guard lk(order_lock);
+      order.push_back(value);
+    };
+  };
+  auto idle = pool.Async(Common::TaskPriority::Idle, record(2));
+  auto background = pool.Async(Common::TaskPriority::Background, record(1));
+  auto high = pool.Async(Common::TaskPriority::High, record(0));
+
+  release.set_value();
+  blocker.wait();
+  idle.wait();
+  background.wait();
+  high.wait();
+
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), order);
+}
@@ -10,6 +10,7 @@
 
 #include "Common/Config/Config.h"
 #include "Common/FileUtil.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -362,3 +363,76 @@ TEST(CoreTiming, Overclocking)
   SConfig::GetInstance().m_OCFactor = 1.0;
   AdvanceAndCheck(4, MAX_SLICE_LENGTH);
 }
+
+namespace AdaptiveSlicingTest
+{
+static s64 s_lateness_a = 1;
+static s64 s_lateness_b = 1;
+
+static void CallbackA(u64, s64 lateness)
+{
+  s_lateness_a = lateness;
+}
+
+static void CallbackB(u64, s64 lateness)
+{
+  s_lateness_b = lateness;
+}
+}  // namespace AdaptiveSlicingTest
+
+TEST(CoreTiming, AdaptiveSlicing)
+{
+  using namespace AdaptiveSlicingTest;
+
+  ScopeInit guard;
+  ASSERT_TRUE(guard.UserDirectoryExists());
+
+  // The setting is only read on init.
+  CoreTiming::Shutdown();
+  Config::SetCurrent(Config::MAIN_ADAPTIVE_TIMING_SLICES, true);
+  CoreTiming::Init();
+
+  CoreTiming::EventType* cb_a = CoreTiming::RegisterEvent("callbackA", CallbackA);
+  CoreTiming::EventType* cb_b = CoreTiming::RegisterEvent("callbackB", CallbackB);
+
+  // Nobody is scheduling events, so the slices keep growing up to a limit.
+  CoreTiming::Advance();
+  EXPECT_EQ(MAX_SLICE_LENGTH * 2, PowerPC::ppcState.downcount);
+  for (int i = 0; i < 4; ++i)
+  {
+    PowerPC::ppcState.downcount = 0;
+    CoreTiming::Advance();
+  }
+  EXPECT_EQ(MAX_SLICE_LENGTH * 8, PowerPC::ppcState.downcount);
+
+  // B is due shortly after A, so it runs early together with A.
+  CoreTiming::ScheduleEvent(100, cb_a);
+  CoreTiming::ScheduleEvent(250, cb_b);
+  EXPECT_EQ(100, PowerPC::ppcState.downcount);
+  PowerPC::ppcState.downcount = 0;
+  CoreTiming::Advance();
+  EXPECT_EQ(0, s_lateness_a);
+  EXPECT_EQ(-150, s_lateness_b);
+  EXPECT_EQ(1u, CoreTiming::GetSliceStatistics().coalesced_events);
+
+  // Events far enough apart still get their own slices.
+  CoreTiming::ScheduleEvent(100, cb_a);
+  CoreTiming::ScheduleEvent(1000, cb_b);
+  s_lateness_b = 1;
+  PowerPC::ppcState.downcount = 0;
+  CoreTiming::Advance();
+  EXPECT_EQ(0, s_lateness_a);
+  EXPECT_EQ(1, s_lateness_b);
+  EXPECT_EQ(900, PowerPC::ppcState.downcount);
+  PowerPC::ppcState.downcount = 0;
+  CoreTiming::Advance();
+  EXPECT_EQ(0, s_lateness_b);
+
+  // An event from another thread drops the slice length back to the default.
+  Core::UndeclareAsCPUThread();
+  CoreTiming::ScheduleEvent(0, cb_a, 0, CoreTiming::FromThread::NON_CPU);
+  Core::DeclareAsCPUThread();
+  PowerPC::ppcState.downcount = 0;
+  CoreTiming::Advance();
+  EXPECT_EQ(MAX_SLICE_LENGTH, PowerPC::ppcState.downcount);
+}
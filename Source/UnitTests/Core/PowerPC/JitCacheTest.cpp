@@ -0,0 +1,149 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <set>
+
+#include "Common/CommonTypes.h"
+#include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/PowerPC.h"
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr u32 NUM_BLOCKS = 0x4000;
+// Leave a gap between blocks, so that invalidating one block doesn't touch its neighbours.
+constexpr u32 BLOCK_STRIDE = 0x40;
+constexpr u32 BLOCK_INSTRUCTIONS = 8;
+
+u32 GetBlockAddress(u32 index)
+{
+  return index * BLOCK_STRIDE;
+}
+
+void FillBlockCache(JitBaseBlockCache* cache)
+{
+  for (u32 i = 0; i < NUM_BLOCKS; ++i)
+  {
+    const u32 address = GetBlockAddress(i);
+    JitBlock* block = cache->AllocateBlock(address);
+    block->checkedEntry = nullptr;
+    block->normalEntry = nullptr;
+    block->codeSize = 0;
+    block->originalSize = BLOCK_INSTRUCTIONS;
+
+    // Link every block to the next one and to a common call target.
+    block->linkData.push_back({nullptr, GetBlockAddress((i + 1) % NUM_BLOCKS), false, false});
+    block->linkData.push_back({nullptr, GetBlockAddress(0), false, true});
+
+    std::set<u32> physical_addresses;
+    for (u32 j = 0; j < BLOCK_INSTRUCTIONS; ++j)
+      physical_addresses.insert(address + j * 4);
+
+    cache->FinalizeBlock(*block, true, physical_addresses);
+  }
+}
+
+class JitCacheTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // Address translation is disabled, so effective and physical addresses are identical.
+    MSR.Hex = 0;
+    m_cache = m_jit.GetBlockCache();
+    m_cache->Clear();
+  }
+
+  void TearDown() override { m_cache->Clear(); }
+
+  CachedInterpreter m_jit;
+  JitBaseBlockCache* m_cache = nullptr;
+};
+}  // namespace
+
+TEST_F(JitCacheTest, LookupAfterFinalize)
+{
+  FillBlockCache(m_cache);
+
+  for (u32 i = 0; i < NUM_BLOCKS; ++i)
+  {
+    const JitBlock* block = m_cache->GetBlockFromStartAddress(GetBlockAddress(i), 0);
+    ASSERT_NE(nullptr, block);
+    EXPECT_EQ(GetBlockAddress(i), block->effectiveAddress);
+    EXPECT_TRUE(block->OverlapsPhysicalRange(GetBlockAddress(i) + 4, 4));
+    EXPECT_FALSE(block->OverlapsPhysicalRange(GetBlockAddress(i) + BLOCK_INSTRUCTIONS * 4, 4));
+  }
+}
+
+TEST_F(JitCacheTest, InvalidateSingleBlock)
+{
+  FillBlockCache(m_cache);
+
+  const u32 address = GetBlockAddress(NUM_BLOCKS / 2);
+  m_cache->InvalidateICache(address + 0x10, 0x20, true);
+
+  EXPECT_EQ(nullptr, m_cache->GetBlockFromStartAddress(address, 0));
+  EXPECT_NE(nullptr, m_cache->GetBlockFromStartAddress(GetBlockAddress(NUM_BLOCKS / 2 - 1), 0));
+  EXPECT_NE(nullptr, m_cache->GetBlockFromStartAddress(GetBlockAddress(NUM_BLOCKS / 2 + 1), 0));
+}
+
+TEST_F(JitCacheTest, InvalidateRange)
+{
+  FillBlockCache(m_cache);
+
+  m_cache->ErasePhysicalRange(GetBlockAddress(16), 16 * BLOCK_STRIDE);
+
+  for (u32 i = 0; i < NUM_BLOCKS; ++i)
+  {
+    const bool erased = i >= 16 && i < 32;
+    EXPECT_EQ(erased, m_cache->GetBlockFromStartAddress(GetBlockAddress(i), 0) == nullptr);
+  }
+}
+
+TEST_F(JitCacheTest, EvictLeastRecentlyUsedBlocks)
+{
+  FillBlockCache(m_cache);
+
+  // The blocks were all compiled in order, so the first ones are the least recently used.
+  EXPECT_EQ(NUM_BLOCKS / 4, m_cache->EvictLeastRecentlyUsedBlocks(NUM_BLOCKS / 4));
+  EXPECT_EQ(NUM_BLOCKS - NUM_BLOCKS / 4, m_cache->GetBlockCount());
+
+  for (u32 i = 0; i < NUM_BLOCKS; ++i)
+  {
+    const bool evicted = i < NUM_BLOCKS / 4;
+    EXPECT_EQ(evicted, m_cache->GetBlockFromStartAddress(GetBlockAddress(i), 0) == nullptr);
+  }
+
+  // Evicted blocks must be gone from the invalidation structures as well.
+  m_cache->ErasePhysicalRange(0, NUM_BLOCKS * BLOCK_STRIDE);
+  EXPECT_EQ(0u, m_cache->GetBlockCount());
+  EXPECT_EQ(0u, m_cache->EvictLeastRecentlyUsedBlocks(1));
+}
+
+// Not a correctness test as such, but useful to compare the cost of block creation, linking and
+// invalidation (as done by games which constantly use icbi) between block cache implementations.
+TEST_F(JitCacheTest, InvalidationBenchmark)
+{
+  constexpr int ITERATIONS = 4;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int iteration = 0; iteration < ITERATIONS; ++iteration)
+  {
+    FillBlockCache(m_cache);
+    for (u32 i = 0; i < NUM_BLOCKS; ++i)
+      m_cache->InvalidateICache(GetBlockAddress(i), 32, true);
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  for (u32 i = 0; i < NUM_BLOCKS; ++i)
+    EXPECT_EQ(nullptr, m_cache->GetBlockFromStartAddress(GetBlockAddress(i), 0));
+
+  const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+  fmt::print("{} blocks created, linked and invalidated {} times in {} us\n", NUM_BLOCKS,
+             ITERATIONS, duration.count());
+}
@@ -0,0 +1,115 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Common/MemoryUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
+#include "Core/MemTools.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+class WriteTrackingTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    ASSERT_FALSE(m_profile_path.empty());
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    Memory::Init();
+    EMM::InstallExceptionHandler();
+    Memory::SetWriteTrackingEnabled(true);
+    m_page_size = static_cast<u32>(Common::MemPageSize());
+  }
+
+  void TearDown() override
+  {
+    Memory::SetWriteTrackingEnabled(false);
+    EMM::UninstallExceptionHandler();
+    Memory::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  // A range over two pages, which doesn't start at a page boundary.
+  u32 Address() const { return 0x100000 + m_page_size / 2; }
+  u32 Size() const { return m_page_size; }
+
+  std::string m_profile_path;
+  u32 m_page_size = 0;
+};
+}  // namespace
+
+TEST_F(WriteTrackingTest, UnmodifiedUntilWritten)
+{
+  const u64 stamp = Memory::TrackWrites(Address(), Size());
+  ASSERT_NE(0u, stamp);
+  EXPECT_TRUE(Memory::IsUnmodifiedSince(Address(), Size(), stamp));
+
+  // Reading doesn't count as a modification.
+  EXPECT_EQ(0u, Memory::Read_U32(Address()));
+  EXPECT_TRUE(Memory::IsUnmodifiedSince(Address(), Size(), stamp));
+
+  Memory::Write_U32(0x12345678, Address() + Size() - 4);
+  EXPECT_EQ(0x12345678u, Memory::Read_U32(Address() + Size() - 4));
+  EXPECT_FALSE(Memory::IsUnmodifiedSince(Address(), Size(), stamp));
+
+  // Tracking the range again doesn't revive the old stamp.
+  const u64 new_stamp = Memory::TrackWrites(Address(), Size());
+  ASSERT_NE(0u, new_stamp);
+  EXPECT_TRUE(Memory::IsUnmodifiedSince(Address(), Size(), new_stamp));
+  EXPECT_FALSE(Memory::IsUnmodifiedSince(Address(), Size(), stamp));
+}
+
+TEST_F(WriteTrackingTest, WritesOutsideOfRange)
+{
+  const u64 stamp = Memory::TrackWrites(Address(), Size());
+  ASSERT_NE(0u, stamp);
+
+  Memory::Write_U32(0xDEADBEEF, Address() + 2 * m_page_size);
+  Memory::Write_U32(0xDEADBEEF, Address() - m_page_size);
+  EXPECT_TRUE(Memory::IsUnmodifiedSince(Address(), Size(), stamp));
+}
+
+TEST_F(WriteTrackingTest, HostWrites)
+{
+  const u64 stamp = Memory::TrackWrites(Address(), Size());
+  ASSERT_NE(0u, stamp);
+
+  const u8 data[16] = {1, 2, 3, 4};
+  Memory::CopyToEmu(Address() + 8, data, sizeof(data));
+  EXPECT_FALSE(Memory::IsUnmodifiedSince(Address(), Size(), stamp));
+  EXPECT_EQ(0, std::memcmp(Memory::GetPointer(Address() + 8), data, sizeof(data)));
+
+  const u64 new_stamp = Memory::TrackWrites(Address(), Size());
+  ASSERT_NE(0u, new_stamp);
+  Memory::UntrackWrites(Address(), 1);
+  EXPECT_FALSE(Memory::IsUnmodifiedSince(Address(), Size(), new_stamp));
+}
+
+TEST_F(WriteTrackingTest, Disabled)
+{
+  const u64 stamp = Memory::TrackWrites(Address(), Size());
+  ASSERT_NE(0u, stamp);
+
+  Memory::SetWriteTrackingEnabled(false);
+  EXPECT_FALSE(Memory::IsUnmodifiedSince(Address(), Size(), stamp));
+  EXPECT_EQ(0u, Memory::TrackWrites(Address(), Size()));
+
+  // Memory has to be writable again.
+  Memory::Write_U32(1, Address());
+  EXPECT_EQ(1u, Memory::Read_U32(Address()));
+}
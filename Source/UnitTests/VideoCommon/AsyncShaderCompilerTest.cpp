@@ -0,0 +1,121 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <mutex>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "VideoCommon/AsyncShaderCompiler.h"
+
+using VideoCommon::AsyncShaderCompiler;
+
+namespace
+{
+// Keeps the only worker thread busy until released, so that the other items stay queued.
+class BlockingWorkItem final : public AsyncShaderCompiler::WorkItem
+{
+public:
+  BlockingWorkItem(Common::Event* started, Common::Event* release)
+      : m_started(started), m_release(release)
+  {
+  }
+
+  bool Compile() override
+  {
+    m_started->Set();
+    m_release->Wait();
+    return true;
+  }
+
+  void Retrieve() override {}
+
+private:
+  Common::Event* m_started;
+  Common::Event* m_release;
+};
+
+class RecordingWorkItem final : public AsyncShaderCompiler::WorkItem
+{
+public:
+  RecordingWorkItem(std::vector<int>* order, std::mutex* lock, int id)
+      : m_order(order), m_lock(lock), m_id(id)
+  {
+  }
+
+  bool Compile() override
+  {
+    std::lock_guard<std::mutex> guard(*m_lock);
+    m_order->push_back(m_id);
+    return true;
+  }
+
+  void Retrieve() override {}
+
+private:
+  std::vector<int>* m_order;
+  std::mutex* m_lock;
+  int m_id;
+};
+
+class AsyncShaderCompilerTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_TRUE(m_compiler.StartWorkerThreads(1));
+    m_compiler.QueueWorkItem(
+        AsyncShaderCompiler::CreateWorkItem<BlockingWorkItem>(&m_started, &m_release), 0);
+    m_started.Wait();
+  }
+
+  void TearDown() override { m_compiler.StopWorkerThreads(); }
+
+  AsyncShaderCompiler::WorkItemID Queue(int id, u32 priority)
+  {
+    return m_compiler.QueueWorkItem(
+        AsyncShaderCompiler::CreateWorkItem<RecordingWorkItem>(&m_order, &m_order_lock, id),
+        priority);
+  }
+
+  void Finish()
+  {
+    m_release.Set();
+    m_compiler.WaitUntilCompletion();
+    m_compiler.RetrieveWorkItems();
+  }
+
+  AsyncShaderCompiler m_compiler;
+  Common::Event m_started;
+  Common::Event m_release;
+  std::vector<int> m_order;
+  std::mutex m_order_lock;
+};
+}  // namespace
+
+TEST_F(AsyncShaderCompilerTest, CompilesBumpedItemsFirst)
+{
+  Queue(1, 300);
+  Queue(2, 300);
+  const AsyncShaderCompiler::WorkItemID id = Queue(3, 300);
+  Queue(4, 100);
+  EXPECT_TRUE(m_compiler.BumpWorkItemPriority(id, 100));
+  Finish();
+
+  EXPECT_EQ((std::vector<int>{4, 3, 1, 2}), m_order);
+  EXPECT_FALSE(m_compiler.BumpWorkItemPriority(id, 0));
+}
+
+TEST_F(AsyncShaderCompilerTest, CancelsPendingWork)
+{
+  Queue(1, 100);
+  Queue(2, 200);
+  m_compiler.CancelPendingWork();
+  Queue(3, 300);
+  Finish();
+
+  EXPECT_EQ(std::vector<int>{3}, m_order);
+}
@@ -0,0 +1,82 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/DynamicResolution.h"
+
+namespace
+{
+constexpr u32 MIN_SCALE = 1;
+constexpr u32 MAX_SCALE = 4;
+
+// Runs frames taking frame_time_ms, of which the GPU is busy for gpu_time_ms, and returns the
+// number of scale changes.
+int RunFrames(DynamicResolution* dynamic_resolution, u64* frame, int count, double frame_time_ms,
+              double gpu_time_ms)
+{
+  int changes = 0;
+  for (int i = 0; i < count; i++, (*frame)++)
+  {
+    // Reported in two parts, like two command buffers.
+    dynamic_resolution->AddGPUTime(*frame, gpu_time_ms / 2);
+    dynamic_resolution->AddGPUTime(*frame, gpu_time_ms / 2);
+    if (dynamic_resolution->EndFrame(*frame, frame_time_ms, MIN_SCALE, MAX_SCALE))
+      changes++;
+  }
+  return changes;
+}
+}  // namespace
+
+TEST(DynamicResolution, StartsAtMaximum)
+{
+  DynamicResolution dynamic_resolution;
+  EXPECT_EQ(MAX_SCALE, dynamic_resolution.GetScale(MIN_SCALE, MAX_SCALE));
+  EXPECT_EQ(2u, dynamic_resolution.GetScale(MIN_SCALE, 2));
+}
+
+TEST(DynamicResolution, LowersScaleWhenGPUBound)
+{
+  DynamicResolution dynamic_resolution;
+  u64 frame = 0;
+  EXPECT_EQ(1, RunFrames(&dynamic_resolution, &frame, 60, 20.0, 19.5));
+  EXPECT_EQ(MAX_SCALE - 1, dynamic_resolution.GetScale(MIN_SCALE, MAX_SCALE));
+
+  // Never goes below the minimum.
+  RunFrames(&dynamic_resolution, &frame, 1000, 20.0, 19.5);
+  EXPECT_EQ(MIN_SCALE, dynamic_resolution.GetScale(MIN_SCALE, MAX_SCALE));
+}
+
+TEST(DynamicResolution, KeepsScaleWithHeadroom)
+{
+  DynamicResolution dynamic_resolution;
+  u64 frame = 0;
+  EXPECT_EQ(0, RunFrames(&dynamic_resolution, &frame, 300, 16.7, 10.0));
+  EXPECT_EQ(MAX_SCALE, dynamic_resolution.GetScale(MIN_SCALE, MAX_SCALE));
+}
+
+TEST(DynamicResolution, RaisesScaleWhenNextScaleFits)
+{
+  DynamicResolution dynamic_resolution;
+  u64 frame = 0;
+  RunFrames(&dynamic_resolution, &frame, 1000, 20.0, 19.5);
+  ASSERT_EQ(MIN_SCALE, dynamic_resolution.GetScale(MIN_SCALE, MAX_SCALE));
+
+  // The GPU time grows with the number of pixels. 2x takes 12 of the 16.7 ms, and 3x wouldn't fit.
+  for (int i = 0; i < 300; i++)
+  {
+    const u32 scale = dynamic_resolution.GetScale(MIN_SCALE, MAX_SCALE);
+    RunFrames(&dynamic_resolution, &frame, 1, 16.7, 3.0 * scale * scale);
+  }
+  EXPECT_EQ(2u, dynamic_resolution.GetScale(MIN_SCALE, MAX_SCALE));
+}
+
+TEST(DynamicResolution, IgnoresLongFrames)
+{
+  DynamicResolution dynamic_resolution;
+  u64 frame = 0;
+  EXPECT_EQ(0, RunFrames(&dynamic_resolution, &frame, 300, 1000.0, 999.0));
+  EXPECT_EQ(MAX_SCALE, dynamic_resolution.GetScale(MIN_SCALE, MAX_SCALE));
+}
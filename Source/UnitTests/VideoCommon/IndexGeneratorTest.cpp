@@ -0,0 +1,216 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/IndexGenerator.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace
+{
+constexpr u16 RESTART = UINT16_MAX;
+
+// Straightforward versions of the index patterns the generator is expected to produce.
+void ReferenceTriangle(std::vector<u16>* out, bool pr, u32 a, u32 b, u32 c)
+{
+  out->insert(out->end(), {u16(a), u16(b), u16(c)});
+  if (pr)
+    out->push_back(RESTART);
+}
+
+std::vector<u16> ReferenceIndices(int primitive, bool pr, u32 num_verts, u32 index)
+{
+  std::vector<u16> out;
+  switch (primitive)
+  {
+  case OpcodeDecoder::GX_DRAW_QUADS:
+  case OpcodeDecoder::GX_DRAW_QUADS_2:
+  {
+    u32 i = 3;
+    for (; i < num_verts; i += 4)
+    {
+      const u32 v = index + i - 3;
+      if (pr)
+        out.insert(out.end(), {u16(v + 1), u16(v + 2), u16(v), u16(v + 3), RESTART});
+      else
+        out.insert(out.end(), {u16(v), u16(v + 1), u16(v + 2), u16(v), u16(v + 2), u16(v + 3)});
+    }
+    if (i == num_verts)
+      ReferenceTriangle(&out, pr, index + i - 3, index + i - 2, index + i - 1);
+    break;
+  }
+  case OpcodeDecoder::GX_DRAW_TRIANGLES:
+    for (u32 i = 2; i < num_verts; i += 3)
+      ReferenceTriangle(&out, pr, index + i - 2, index + i - 1, index + i);
+    break;
+  case OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP:
+    if (pr)
+    {
+      for (u32 i = 0; i < num_verts; ++i)
+        out.push_back(u16(index + i));
+      out.push_back(RESTART);
+    }
+    else
+    {
+      for (u32 i = 2; i < num_verts; ++i)
+      {
+        const bool wind = i % 2 != 0;
+        ReferenceTriangle(&out, pr, index + i - 2, index + i - !wind, index + i - wind);
+      }
+    }
+    break;
+  case OpcodeDecoder::GX_DRAW_TRIANGLE_FAN:
+  {
+    u32 i = 2;
+    if (pr)
+    {
+      for (; i + 3 <= num_verts; i += 3)
+      {
+        out.insert(out.end(), {u16(index + i - 1), u16(index + i), u16(index), u16(index + i + 1),
+                               u16(index + i + 2), RESTART});
+      }
+      for (; i + 2 <= num_verts; i += 2)
+      {
+        out.insert(out.end(),
+                   {u16(index + i - 1), u16(index + i), u16(index), u16(index + i + 1), RESTART});
+      }
+    }
+    for (; i < num_verts; ++i)
+      ReferenceTriangle(&out, pr, index, index + i - 1, index + i);
+    break;
+  }
+  case OpcodeDecoder::GX_DRAW_LINES:
+    for (u32 i = 1; i < num_verts; i += 2)
+      out.insert(out.end(), {u16(index + i - 1), u16(index + i)});
+    break;
+  case OpcodeDecoder::GX_DRAW_LINE_STRIP:
+    for (u32 i = 1; i < num_verts; ++i)
+      out.insert(out.end(), {u16(index + i - 1), u16(index + i)});
+    break;
+  case OpcodeDecoder::GX_DRAW_POINTS:
+    for (u32 i = 0; i < num_verts; ++i)
+      out.push_back(u16(index + i));
+    break;
+  }
+  return out;
+}
+
+const char* GetPrimitiveName(int primitive)
+{
+  static constexpr const char* names[] = {"Quads",         "Quads2", "Triangles",
+                                          "TriangleStrip", "Fan",    "Lines",
+                                          "LineStrip",     "Points"};
+  return names[primitive];
+}
+
+class IndexGeneratorTest : public testing::TestWithParam<bool>
+{
+protected:
+  void SetUp() override
+  {
+    g_Config.backend_info.bSupportsPrimitiveRestart = GetParam();
+    m_generator.Init();
+    m_buffer.resize(BUFFER_SIZE);
+  }
+
+  // Enough for three indices per vertex (strips and fans without primitive restart) of a full
+  // vertex range.
+  static constexpr size_t BUFFER_SIZE = 65536 * 3;
+
+  IndexGenerator m_generator;
+  std::vector<u16> m_buffer;
+};
+}  // namespace
+
+TEST_P(IndexGeneratorTest, MatchesReference)
+{
+  const bool pr = GetParam();
+  for (int primitive = OpcodeDecoder::GX_DRAW_QUADS; primitive <= OpcodeDecoder::GX_DRAW_POINTS;
+       ++primitive)
+  {
+    for (u32 num_verts = 0; num_verts < 200; ++num_verts)
+    {
+      // Start at an odd offset, so that the patterns aren't aligned to the base index.
+      constexpr u32 first_verts = 7;
+      m_generator.Start(m_buffer.data());
+      m_generator.AddIndices(OpcodeDecoder::GX_DRAW_POINTS, first_verts);
+      m_generator.AddIndices(primitive, num_verts);
+
+      std::vector<u16> expected = ReferenceIndices(OpcodeDecoder::GX_DRAW_POINTS, pr,
+                                                   first_verts, 0);
+      const std::vector<u16> indices = ReferenceIndices(primitive, pr, num_verts, first_verts);
+      expected.insert(expected.end(), indices.begin(), indices.end());
+
+      ASSERT_EQ(expected.size(), m_generator.GetIndexLen())
+          << GetPrimitiveName(primitive) << " with " << num_verts << " vertices";
+      EXPECT_EQ(expected, std::vector<u16>(m_buffer.begin(), m_buffer.begin() + expected.size()))
+          << GetPrimitiveName(primitive) << " with " << num_verts << " vertices";
+      EXPECT_EQ(first_verts + num_verts, m_generator.GetNumVerts());
+    }
+  }
+}
+
+TEST_P(IndexGeneratorTest, RemappedIndices)
+{
+  const bool pr = GetParam();
+  for (int primitive = OpcodeDecoder::GX_DRAW_QUADS; primitive <= OpcodeDecoder::GX_DRAW_POINTS;
+       ++primitive)
+  {
+    // Every other vertex is a duplicate of the one before it.
+    constexpr u32 first_verts = 7;
+    constexpr u32 num_verts = 100;
+    std::vector<u16> remap(num_verts);
+    for (u32 i = 0; i < num_verts; ++i)
+      remap[i] = u16(i / 2);
+
+    m_generator.Start(m_buffer.data());
+    m_generator.AddIndices(OpcodeDecoder::GX_DRAW_POINTS, first_verts);
+    m_generator.AddRemappedIndices(primitive, num_verts, remap.data(), num_verts / 2);
+
+    std::vector<u16> expected =
+        ReferenceIndices(OpcodeDecoder::GX_DRAW_POINTS, pr, first_verts, 0);
+    for (u16 index : ReferenceIndices(primitive, pr, num_verts, 0))
+      expected.push_back(index == RESTART ? RESTART : u16(first_verts + remap[index]));
+
+    ASSERT_EQ(expected.size(), m_generator.GetIndexLen()) << GetPrimitiveName(primitive);
+    EXPECT_EQ(expected, std::vector<u16>(m_buffer.begin(), m_buffer.begin() + expected.size()))
+        << GetPrimitiveName(primitive);
+    EXPECT_EQ(first_verts + num_verts / 2, m_generator.GetNumVerts());
+  }
+}
+
+// Not a correctness test as such, but useful to compare the cost of index generation for each
+// primitive type.
+TEST_P(IndexGeneratorTest, Benchmark)
+{
+  constexpr u32 VERTICES_PER_PRIMITIVE = 60;
+  constexpr u32 PRIMITIVES_PER_BATCH = 500;
+  constexpr int ITERATIONS = 400;
+
+  for (int primitive = OpcodeDecoder::GX_DRAW_QUADS; primitive <= OpcodeDecoder::GX_DRAW_POINTS;
+       ++primitive)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < ITERATIONS; ++iteration)
+    {
+      m_generator.Start(m_buffer.data());
+      for (u32 i = 0; i < PRIMITIVES_PER_BATCH; ++i)
+        m_generator.AddIndices(primitive, VERTICES_PER_PRIMITIVE);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    const double vertices = double(VERTICES_PER_PRIMITIVE) * PRIMITIVES_PER_BATCH * ITERATIONS;
+    printf("%s%s: %.1f million vertices/s\n", GetPrimitiveName(primitive),
+           GetParam() ? " (primitive restart)" : "", vertices / seconds / 1000000);
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(PrimitiveRestart, IndexGeneratorTest, testing::Bool());
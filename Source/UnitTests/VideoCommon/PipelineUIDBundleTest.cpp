@@ -0,0 +1,75 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "VideoCommon/PipelineUIDBundle.h"
+
+using VideoCommon::SerializedGXPipelineUid;
+namespace PipelineUIDBundle = VideoCommon::PipelineUIDBundle;
+
+class PipelineUIDBundleTest : public testing::Test
+{
+protected:
+  PipelineUIDBundleTest()
+      : m_directory(File::CreateTempDir()), m_bundle_path(m_directory + "/GALE01.uidbundle")
+  {
+  }
+
+  ~PipelineUIDBundleTest() override
+  {
+    if (!m_directory.empty())
+      File::DeleteDirRecursively(m_directory);
+  }
+
+  void SetUp() override { ASSERT_FALSE(m_directory.empty()); }
+
+  static SerializedGXPipelineUid MakeUID(u8 value)
+  {
+    SerializedGXPipelineUid uid;
+    std::memset(static_cast<void*>(&uid), value, sizeof(uid));
+    return uid;
+  }
+
+  std::string m_directory;
+  std::string m_bundle_path;
+};
+
+TEST_F(PipelineUIDBundleTest, ReadsBackDeduplicatedUIDs)
+{
+  ASSERT_TRUE(PipelineUIDBundle::Write(m_bundle_path, "GALE01",
+                                       {MakeUID(3), MakeUID(1), MakeUID(3), MakeUID(2)}));
+
+  const auto uids = PipelineUIDBundle::Read(m_bundle_path, "GALE01");
+  ASSERT_TRUE(uids.has_value());
+  ASSERT_EQ(3u, uids->size());
+  for (u8 i = 0; i < 3; i++)
+  {
+    const SerializedGXPipelineUid expected = MakeUID(i + 1);
+    EXPECT_EQ(0, std::memcmp(&expected, &(*uids)[i], sizeof(expected)));
+  }
+}
+
+TEST_F(PipelineUIDBundleTest, RejectsOtherGames)
+{
+  ASSERT_TRUE(PipelineUIDBundle::Write(m_bundle_path, "GALE01", {MakeUID(1)}));
+  EXPECT_FALSE(PipelineUIDBundle::Read(m_bundle_path, "GALP01").has_value());
+}
+
+TEST_F(PipelineUIDBundleTest, RejectsTruncatedFiles)
+{
+  ASSERT_TRUE(PipelineUIDBundle::Write(m_bundle_path, "GALE01", {MakeUID(1), MakeUID(2)}));
+
+  std::string data;
+  ASSERT_TRUE(File::ReadFileToString(m_bundle_path, data));
+  data.pop_back();
+  ASSERT_TRUE(File::WriteStringToFile(m_bundle_path, data));
+  EXPECT_FALSE(PipelineUIDBundle::Read(m_bundle_path, "GALE01").has_value());
+}
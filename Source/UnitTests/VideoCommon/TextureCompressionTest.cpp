@@ -0,0 +1,143 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstdlib>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureCompression.h"
+
+namespace
+{
+// Decodes a BC3 image back to RGBA8, with rows width pixels apart.
+std::vector<u8> DecodeBC3(const std::vector<u8>& data, u32 width, u32 height)
+{
+  std::vector<u8> pixels(static_cast<size_t>(width) * height * 4);
+  const u8* block = data.data();
+  for (u32 block_y = 0; block_y < height; block_y += 4)
+  {
+    for (u32 block_x = 0; block_x < width; block_x += 4, block += 16)
+    {
+      std::array<int, 8> alpha;
+      alpha[0] = block[0];
+      alpha[1] = block[1];
+      for (int i = 2; i < 8; i++)
+      {
+        alpha[i] = alpha[0] > alpha[1] ? ((8 - i) * alpha[0] + (i - 1) * alpha[1]) / 7 :
+                                         (i < 6 ? ((6 - i) * alpha[0] + (i - 1) * alpha[1]) / 5 :
+                                                  (i == 6 ? 0 : 255));
+      }
+      u64 alpha_indices = 0;
+      for (int i = 0; i < 6; i++)
+        alpha_indices |= static_cast<u64>(block[2 + i]) << (i * 8);
+
+      std::array<std::array<int, 3>, 4> colors;
+      for (int i = 0; i < 2; i++)
+      {
+        const u16 c = static_cast<u16>(block[8 + i * 2] | (block[9 + i * 2] << 8));
+        colors[i] = {((c >> 11) & 0x1f) * 255 / 31, ((c >> 5) & 0x3f) * 255 / 63,
+                     (c & 0x1f) * 255 / 31};
+      }
+      for (int c = 0; c < 3; c++)
+      {
+        colors[2][c] = (2 * colors[0][c] + colors[1][c]) / 3;
+        colors[3][c] = (colors[0][c] + 2 * colors[1][c]) / 3;
+      }
+      const u32 color_indices =
+          block[12] | (block[13] << 8) | (block[14] << 16) | (static_cast<u32>(block[15]) << 24);
+
+      for (u32 i = 0; i < 16; i++)
+      {
+        const u32 x = block_x + i % 4;
+        const u32 y = block_y + i / 4;
+        if (x >= width || y >= height)
+          continue;
+
+        u8* pixel = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+        const auto& color = colors[(color_indices >> (i * 2)) & 3];
+        for (int c = 0; c < 3; c++)
+          pixel[c] = static_cast<u8>(color[c]);
+        pixel[3] = static_cast<u8>(alpha[(alpha_indices >> (i * 3)) & 7]);
+      }
+    }
+  }
+  return pixels;
+}
+
+int MaxError(const std::vector<u8>& a, const std::vector<u8>& b)
+{
+  int max_error = 0;
+  for (size_t i = 0; i < a.size(); i++)
+    max_error = std::max(max_error, std::abs(a[i] - b[i]));
+  return max_error;
+}
+}  // namespace
+
+TEST(TextureCompression, BC3Size)
+{
+  EXPECT_EQ(16u, TextureCompression::GetBC3Size(1, 1));
+  EXPECT_EQ(16u, TextureCompression::GetBC3Size(4, 4));
+  EXPECT_EQ(64u, TextureCompression::GetBC3Size(8, 5));
+  EXPECT_EQ(256u * 256u, TextureCompression::GetBC3Size(256, 256));
+}
+
+TEST(TextureCompression, SolidColor)
+{
+  constexpr u32 width = 8, height = 8;
+  std::vector<u8> pixels(width * height * 4);
+  for (size_t i = 0; i < pixels.size(); i += 4)
+  {
+    pixels[i] = 0xff;
+    pixels[i + 1] = 0x80;
+    pixels[i + 2] = 0x00;
+    pixels[i + 3] = 0x40;
+  }
+
+  std::vector<u8> compressed(TextureCompression::GetBC3Size(width, height));
+  TextureCompression::CompressBC3(pixels.data(), width, height, width, compressed.data());
+
+  const std::vector<u8> decoded = DecodeBC3(compressed, width, height);
+  for (size_t i = 0; i < decoded.size(); i += 4)
+    EXPECT_EQ(0x40, decoded[i + 3]);
+  // Only the precision of RGB565 is lost.
+  EXPECT_LE(MaxError(pixels, decoded), 4);
+}
+
+TEST(TextureCompression, Gradient)
+{
+  constexpr u32 width = 16, height = 16;
+  std::vector<u8> pixels(width * height * 4);
+  for (u32 y = 0; y < height; y++)
+  {
+    for (u32 x = 0; x < width; x++)
+    {
+      u8* pixel = &pixels[(y * width + x) * 4];
+      pixel[0] = static_cast<u8>(x * 16);
+      pixel[1] = static_cast<u8>(255 - x * 16);
+      pixel[2] = static_cast<u8>(0x40 + x * 8);
+      pixel[3] = static_cast<u8>(255 - y * 16);
+    }
+  }
+
+  std::vector<u8> compressed(TextureCompression::GetBC3Size(width, height));
+  TextureCompression::CompressBC3(pixels.data(), width, height, width, compressed.data());
+
+  // Within each block, the colors lie on a line between two corners of their bounding box, which
+  // the interpolated colors cover closely.
+  EXPECT_LE(MaxError(pixels, DecodeBC3(compressed, width, height)), 12);
+}
+
+TEST(TextureCompression, UnalignedSizeAndRowLength)
+{
+  constexpr u32 width = 6, height = 3, row_length = 8;
+  std::vector<u8> pixels(row_length * height * 4, 0x20);
+  std::vector<u8> compressed(TextureCompression::GetBC3Size(width, height), 0xcc);
+  TextureCompression::CompressBC3(pixels.data(), width, height, row_length, compressed.data());
+
+  std::vector<u8> expected(width * height * 4, 0x20);
+  EXPECT_LE(MaxError(expected, DecodeBC3(compressed, width, height)), 4);
+}
@@ -0,0 +1,101 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureDecodeQueue.h"
+#include "VideoCommon/TextureDecoder.h"
+
+namespace
+{
+std::vector<u8> GenerateData(size_t size)
+{
+  std::vector<u8> data(size);
+  u32 state = 12345;
+  for (u8& byte : data)
+  {
+    state = state * 1103515245 + 12345;
+    byte = static_cast<u8>(state >> 16);
+  }
+  return data;
+}
+
+void CheckDecodesLikeTexDecoder(TextureDecodeQueue* queue)
+{
+  static constexpr TextureFormat formats[] = {
+      TextureFormat::I4,     TextureFormat::I8,    TextureFormat::IA8, TextureFormat::RGB5A3,
+      TextureFormat::RGBA8,  TextureFormat::C4,    TextureFormat::C8,  TextureFormat::C14X2,
+      TextureFormat::CMPR,
+  };
+  // C14X2 indices can refer to any of 16384 palette entries.
+  const std::vector<u8> tlut = GenerateData(16384 * sizeof(u16));
+
+  for (const TextureFormat format : formats)
+  {
+    // Both a level that is split into bands and one that is too small for that.
+    for (const u32 size : {512u, 64u})
+    {
+      const std::vector<u8> src =
+          GenerateData(TexDecoder_GetTextureSizeInBytes(size, size, format));
+      std::vector<u8> expected(size * size * sizeof(u32));
+      TexDecoder_Decode(expected.data(), src.data(), size, size, format, tlut.data(),
+                        TLUTFormat::RGB565);
+
+      std::vector<u8> decoded(expected.size());
+      queue->QueueDecode(decoded.data(), src.data(), size, size, format, tlut.data(),
+                         TLUTFormat::RGB565);
+      queue->WaitForDecodes();
+      EXPECT_EQ(expected, decoded) << "format " << static_cast<int>(format) << ", size " << size;
+    }
+  }
+}
+}  // namespace
+
+TEST(TextureDecodeQueue, DecodesWithoutWorkerThreads)
+{
+  TextureDecodeQueue queue;
+  CheckDecodesLikeTexDecoder(&queue);
+}
+
+TEST(TextureDecodeQueue, DecodesWithWorkerThreads)
+{
+  TextureDecodeQueue queue;
+  queue.SetNumWorkerThreads(3);
+  CheckDecodesLikeTexDecoder(&queue);
+
+  // Resizing the pool in between must not lose any work.
+  queue.SetNumWorkerThreads(1);
+  CheckDecodesLikeTexDecoder(&queue);
+}
+
+TEST(TextureDecodeQueue, DecodesSeveralLevelsAtOnce)
+{
+  TextureDecodeQueue queue;
+  queue.SetNumWorkerThreads(2);
+
+  const std::vector<u8> tlut = GenerateData(512);
+  std::vector<std::vector<u8>> sources;
+  std::vector<std::vector<u8>> decoded;
+  for (u32 size = 1024; size >= 8; size /= 2)
+  {
+    sources.push_back(
+        GenerateData(TexDecoder_GetTextureSizeInBytes(size, size, TextureFormat::CMPR)));
+    decoded.emplace_back(size * size * sizeof(u32));
+    queue.QueueDecode(decoded.back().data(), sources.back().data(), size, size,
+                      TextureFormat::CMPR, tlut.data(), TLUTFormat::IA8);
+  }
+  queue.WaitForDecodes();
+
+  u32 size = 1024;
+  for (size_t i = 0; i < sources.size(); ++i, size /= 2)
+  {
+    std::vector<u8> expected(size * size * sizeof(u32));
+    TexDecoder_Decode(expected.data(), sources[i].data(), size, size, TextureFormat::CMPR,
+                      tlut.data(), TLUTFormat::IA8);
+    EXPECT_EQ(expected, decoded[i]) << "size " << size;
+  }
+}
@@ -0,0 +1,125 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureDecoder.h"
+
+namespace
+{
+std::vector<u8> GenerateData(size_t size)
+{
+  std::vector<u8> data(size);
+  u32 state = 12345;
+  for (u8& byte : data)
+  {
+    state = state * 1103515245 + 12345;
+    byte = static_cast<u8>(state >> 16);
+  }
+  return data;
+}
+
+constexpr TextureFormat s_formats[] = {
+    TextureFormat::I4,     TextureFormat::I8,    TextureFormat::IA4,   TextureFormat::IA8,
+    TextureFormat::RGB565, TextureFormat::RGB5A3, TextureFormat::RGBA8, TextureFormat::C4,
+    TextureFormat::C8,     TextureFormat::C14X2, TextureFormat::CMPR,
+};
+
+constexpr TLUTFormat s_tlut_formats[] = {TLUTFormat::IA8, TLUTFormat::RGB565, TLUTFormat::RGB5A3};
+}  // namespace
+
+TEST(TextureDecoder, DecodesLikeTexelDecoder)
+{
+  constexpr u32 width = 64;
+  constexpr u32 height = 32;
+  // C14X2 indices can refer to any of 16384 palette entries.
+  const std::vector<u8> tlut = GenerateData(16384 * sizeof(u16));
+  const std::vector<u8> src = GenerateData(width * height * sizeof(u32));
+
+  for (const TextureFormat format : s_formats)
+  {
+    for (const TLUTFormat tlut_format : s_tlut_formats)
+    {
+      // Only the palette formats depend on the palette.
+      if (!IsColorIndexed(format) && tlut_format != TLUTFormat::IA8)
+        continue;
+
+      std::vector<u8> decoded(width * height * sizeof(u32));
+      TexDecoder_Decode(decoded.data(), src.data(), width, height, format, tlut.data(),
+                        tlut_format);
+
+      u32 num_mismatches = 0;
+      for (u32 t = 0; t < height; ++t)
+      {
+        for (u32 s = 0; s < width; ++s)
+        {
+          u8 texel[4];
+          TexDecoder_DecodeTexel(texel, src.data(), s, t, width - 1, format, tlut.data(),
+                                 tlut_format);
+          if (std::memcmp(texel, &decoded[(t * width + s) * sizeof(u32)], sizeof(texel)) != 0)
+            num_mismatches++;
+        }
+      }
+      EXPECT_EQ(0u, num_mismatches) << "format " << static_cast<int>(format) << ", palette "
+                                    << static_cast<int>(tlut_format);
+    }
+  }
+}
+
+TEST(TextureDecoder, MergeRGBA8FromTmem)
+{
+  constexpr u32 width = 64;
+  constexpr u32 height = 32;
+  std::vector<u8> src_ar(width * height * 2);
+  std::vector<u8> src_gb(width * height * 2);
+  for (size_t i = 0; i < src_ar.size(); ++i)
+  {
+    src_ar[i] = static_cast<u8>(i * 7);
+    src_gb[i] = static_cast<u8>(i * 13 + 5);
+  }
+
+  std::vector<u8> expected(width * height * sizeof(u32));
+  TexDecoder_DecodeRGBA8FromTmem(expected.data(), src_ar.data(), src_gb.data(), width, height);
+
+  // Decoding the merged data as a texture from RAM has to give the same result.
+  std::vector<u8> merged(width * height * sizeof(u32));
+  TexDecoder_MergeRGBA8FromTmem(merged.data(), src_ar.data(), src_gb.data(), width, height);
+  std::vector<u8> decoded(width * height * sizeof(u32));
+  TexDecoder_Decode(decoded.data(), merged.data(), width, height, TextureFormat::RGBA8, nullptr,
+                    TLUTFormat::IA8);
+  EXPECT_EQ(expected, decoded);
+}
+
+// Not a correctness test as such, but useful to compare the decoders of different hosts.
+TEST(TextureDecoder, Benchmark)
+{
+  constexpr u32 size = 512;
+  const std::vector<u8> tlut = GenerateData(16384 * sizeof(u16));
+  const std::vector<u8> src = GenerateData(size * size * sizeof(u32));
+  std::vector<u8> dst(size * size * sizeof(u32));
+
+  for (const TextureFormat format : s_formats)
+  {
+    // Decode about 64 MiB of texels per format.
+    constexpr int iterations = (64 << 20) / (size * size);
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+      TexDecoder_Decode(dst.data(), src.data(), size, size, format, tlut.data(),
+                        TLUTFormat::RGB5A3);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    printf("format %2d: %7.1f Mtexels/s\n", static_cast<int>(format),
+           double(size) * size * iterations / seconds / 1e6);
+  }
+}
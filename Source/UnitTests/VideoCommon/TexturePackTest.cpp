@@ -0,0 +1,112 @@
+// Copyright 2021 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "VideoCommon/TexturePack.h"
+
+class TexturePackTest : public testing::Test
+{
+protected:
+  TexturePackTest()
+      : m_directory(File::CreateTempDir()), m_pack_path(m_directory + "/pack.texpack")
+  {
+  }
+
+  ~TexturePackTest() override
+  {
+    if (!m_directory.empty())
+      File::DeleteDirRecursively(m_directory);
+  }
+
+  void SetUp() override { ASSERT_FALSE(m_directory.empty()); }
+
+  std::string m_directory;
+  std::string m_pack_path;
+};
+
+TEST_F(TexturePackTest, ReadsBackWhatWasWritten)
+{
+  std::vector<u8> level0(64 * 32 * 4), level1(32 * 16 * 4), dxt1(8 * 8 / 2);
+  for (size_t i = 0; i < level0.size(); i++)
+    level0[i] = static_cast<u8>(i);
+  for (size_t i = 0; i < level1.size(); i++)
+    level1[i] = static_cast<u8>(i * 3);
+  for (size_t i = 0; i < dxt1.size(); i++)
+    dxt1[i] = static_cast<u8>(i * 5);
+
+  TexturePack::Writer writer;
+  ASSERT_TRUE(writer.Open(m_pack_path));
+  writer.BeginTexture("tex1_64x32_m_0123456789abcdef_6", false);
+  EXPECT_TRUE(writer.AddLevel(AbstractTextureFormat::RGBA8, 64, 32, 64, level0.data(),
+                              level0.size()));
+  EXPECT_TRUE(writer.AddLevel(AbstractTextureFormat::RGBA8, 32, 16, 32, level1.data(),
+                              level1.size()));
+  writer.BeginTexture("tex1_8x8_fedcba9876543210_14", true);
+  EXPECT_TRUE(writer.AddLevel(AbstractTextureFormat::DXT1, 8, 8, 8, dxt1.data(), dxt1.size()));
+  ASSERT_TRUE(writer.Finish());
+
+  const auto pack = TexturePack::Open(m_pack_path);
+  ASSERT_NE(nullptr, pack);
+  const std::vector<TexturePack::Texture>& textures = pack->GetTextures();
+  ASSERT_EQ(2u, textures.size());
+
+  EXPECT_EQ("tex1_64x32_m_0123456789abcdef_6", textures[0].name);
+  EXPECT_FALSE(textures[0].has_arbitrary_mipmaps);
+  ASSERT_EQ(2u, textures[0].levels.size());
+  EXPECT_EQ("tex1_8x8_fedcba9876543210_14", textures[1].name);
+  EXPECT_TRUE(textures[1].has_arbitrary_mipmaps);
+  ASSERT_EQ(1u, textures[1].levels.size());
+
+  const TexturePack::Level& mip = textures[0].levels[1];
+  EXPECT_EQ(AbstractTextureFormat::RGBA8, mip.format);
+  EXPECT_EQ(32u, mip.width);
+  EXPECT_EQ(16u, mip.height);
+  EXPECT_EQ(32u, mip.row_length);
+
+  const std::vector<const std::vector<u8>*> expected{&level0, &level1, &dxt1};
+  const TexturePack::Level* levels[] = {&textures[0].levels[0], &mip, &textures[1].levels[0]};
+  for (size_t i = 0; i < expected.size(); i++)
+  {
+    EXPECT_EQ(0u, levels[i]->offset % TexturePack::PAGE_ALIGNMENT);
+    ASSERT_EQ(expected[i]->size(), levels[i]->size);
+    EXPECT_EQ(0, std::memcmp(expected[i]->data(), pack->GetLevelData(*levels[i]), levels[i]->size));
+  }
+  EXPECT_EQ(AbstractTextureFormat::DXT1, textures[1].levels[0].format);
+}
+
+TEST_F(TexturePackTest, RejectsInvalidFiles)
+{
+  EXPECT_EQ(nullptr, TexturePack::Open(m_pack_path));
+
+  // A pack which was never finished has no header.
+  TexturePack::Writer writer;
+  ASSERT_TRUE(writer.Open(m_pack_path));
+  writer.BeginTexture("tex1_4x4_0123456789abcdef_6", false);
+  const std::vector<u8> data(4 * 4 * 4);
+  ASSERT_TRUE(writer.AddLevel(AbstractTextureFormat::RGBA8, 4, 4, 4, data.data(), data.size()));
+  writer.Discard();
+  EXPECT_FALSE(File::Exists(m_pack_path));
+
+  ASSERT_TRUE(writer.Open(m_pack_path));
+  writer.BeginTexture("tex1_4x4_0123456789abcdef_6", false);
+  ASSERT_TRUE(writer.AddLevel(AbstractTextureFormat::RGBA8, 4, 4, 4, data.data(), data.size()));
+  ASSERT_TRUE(writer.Finish());
+  ASSERT_NE(nullptr, TexturePack::Open(m_pack_path));
+
+  // Cutting off the index has to be detected.
+  const u64 size = File::GetSize(m_pack_path);
+  {
+    File::IOFile file(m_pack_path, "r+b");
+    ASSERT_TRUE(file.Resize(size - 1));
+  }
+  EXPECT_EQ(nullptr, TexturePack::Open(m_pack_path));
+}
@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <chrono>
+#include <cstdio>
 #include <limits>
 #include <memory>
 #include <tuple>
@@ -92,6 +94,17 @@ protected:
     EXPECT_EQ(actual_count, expected_count);
   }
 
+  // Runs count vertices the given number of times, and prints the resulting throughput.
+  void RunVerticesBenchmark(int count, int iterations)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+      RunVertices(count);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    printf("%s: %.1f million vertices/s\n", m_loader->GetName().c_str(),
+           static_cast<double>(count) * iterations / elapsed.count() / 1e6);
+  }
+
   void ResetPointers()
   {
     m_src = DataReader(input_memory, input_memory + sizeof(input_memory));
@@ -268,8 +281,7 @@ TEST_P(VertexLoaderSpeedTest, PositionDirectAll)
   elements += 2;
   size_t elem_size = static_cast<size_t>(1) << (format / 2);
   CreateAndCheckSizes(elements * elem_size, elements * sizeof(float));
-  for (int i = 0; i < 1000; ++i)
-    RunVertices(100000);
+  RunVerticesBenchmark(100000, 1000);
 }
 
 TEST_P(VertexLoaderSpeedTest, TexCoordSingleElement)
@@ -287,8 +299,7 @@ TEST_P(VertexLoaderSpeedTest, TexCoordSingleElement)
   size_t elem_size = static_cast<size_t>(1) << (format / 2);
   CreateAndCheckSizes(2 * sizeof(s8) + elements * elem_size,
                       2 * sizeof(float) + elements * sizeof(float));
-  for (int i = 0; i < 1000; ++i)
-    RunVertices(100000);
+  RunVerticesBenchmark(100000, 1000);
 }
 
 TEST_F(VertexLoaderTest, LargeFloatVertexSpeed)
@@ -351,6 +362,30 @@ TEST_F(VertexLoaderTest, LargeFloatVertexSpeed)
 
   // This test is only done 100x in a row since it's ~20x slower using the
   // current vertex loader implementation.
-  for (int i = 0; i < 100; ++i)
-    RunVertices(100000);
+  RunVerticesBenchmark(100000, 100);
+}
+
+TEST_F(VertexLoaderTest, TypicalVertexSpeed)
+{
+  // A common combination of direct attributes: s16 positions, s8 normals, RGBA8 colors and u16
+  // texture coordinates.
+  m_vtx_desc.Position = DIRECT;
+  m_vtx_desc.Normal = DIRECT;
+  m_vtx_desc.Color0 = DIRECT;
+  m_vtx_desc.Tex0Coord = DIRECT;
+
+  m_vtx_attr.g0.PosElements = 1;  // XYZ
+  m_vtx_attr.g0.PosFormat = FORMAT_SHORT;
+  m_vtx_attr.g0.PosFrac = 8;
+  m_vtx_attr.g0.NormalFormat = FORMAT_BYTE;
+  m_vtx_attr.g0.Color0Elements = 1;  // Has Alpha
+  m_vtx_attr.g0.Color0Comp = FORMAT_32B_8888;
+  m_vtx_attr.g0.Tex0CoordElements = 1;  // ST
+  m_vtx_attr.g0.Tex0CoordFormat = FORMAT_USHORT;
+  m_vtx_attr.g0.Tex0Frac = 10;
+
+  CreateAndCheckSizes(3 * sizeof(s16) + 3 * sizeof(s8) + sizeof(u32) + 2 * sizeof(u16),
+                      3 * sizeof(float) + 3 * sizeof(float) + sizeof(u32) + 2 * sizeof(float));
+
+  RunVerticesBenchmark(100000, 1000);
 }